@@ -71,6 +71,7 @@ static jmethodID method_oobDataReceivedCallback;
 static jmethodID method_stateChangeCallback;
 static jmethodID method_adapterPropertyChangedCallback;
 static jmethodID method_devicePropertyChangedCallback;
+static jmethodID method_devicePropertiesChangedBatchCallback;
 static jmethodID method_deviceFoundCallback;
 static jmethodID method_pinRequestCallback;
 static jmethodID method_sspRequestCallback;
@@ -276,6 +277,75 @@ static void remote_device_properties_callback(bt_status_t status,
                                types.get(), props.get());
 }
 
+static void remote_device_properties_batch_callback(int num_devices,
+                                                    RawAddress* bd_addrs,
+                                                    int* num_properties,
+                                                    bt_property_t* properties) {
+  std::shared_lock<std::shared_timed_mutex> lock(jniObjMutex);
+  if (!sJniCallbacksObj) {
+    log::error("JNI obj is null. Failed to call JNI callback");
+    return;
+  }
+
+  CallbackEnv sCallbackEnv(__func__);
+  if (!sCallbackEnv.valid()) return;
+
+  int total_properties = 0;
+  for (int i = 0; i < num_devices; i++) {
+    total_properties += num_properties[i];
+  }
+  log::verbose("Devices: {}, Properties: {}", num_devices, total_properties);
+
+  ScopedLocalRef<jbyteArray> addrs(
+      sCallbackEnv.get(),
+      sCallbackEnv->NewByteArray(num_devices * sizeof(RawAddress)));
+  if (!addrs.get()) {
+    log::error("Error while allocation byte array");
+    return;
+  }
+  for (int i = 0; i < num_devices; i++) {
+    sCallbackEnv->SetByteArrayRegion(addrs.get(), i * sizeof(RawAddress),
+                                     sizeof(RawAddress), (jbyte*)&bd_addrs[i]);
+  }
+
+  ScopedLocalRef<jintArray> counts(sCallbackEnv.get(),
+                                   sCallbackEnv->NewIntArray(num_devices));
+  if (!counts.get()) {
+    log::error("Error allocating int Array for property counts");
+    return;
+  }
+  sCallbackEnv->SetIntArrayRegion(counts.get(), 0, num_devices,
+                                  (jint*)num_properties);
+
+  ScopedLocalRef<jclass> mclass(sCallbackEnv.get(),
+                                sCallbackEnv->GetObjectClass(addrs.get()));
+
+  ScopedLocalRef<jobjectArray> props(
+      sCallbackEnv.get(),
+      sCallbackEnv->NewObjectArray(total_properties, mclass.get(), NULL));
+  if (!props.get()) {
+    log::error("Error allocating object Array for properties");
+    return;
+  }
+
+  ScopedLocalRef<jintArray> types(sCallbackEnv.get(),
+                                  sCallbackEnv->NewIntArray(total_properties));
+  if (!types.get()) {
+    log::error("Error allocating int Array for values");
+    return;
+  }
+
+  jintArray typesPtr = types.get();
+  jobjectArray propsPtr = props.get();
+  if (get_properties(total_properties, properties, &typesPtr, &propsPtr) < 0) {
+    return;
+  }
+
+  sCallbackEnv->CallVoidMethod(
+      sJniCallbacksObj, method_devicePropertiesChangedBatchCallback,
+      addrs.get(), counts.get(), types.get(), props.get());
+}
+
 static void device_found_callback(int num_properties,
                                   bt_property_t* properties) {
   std::shared_lock<std::shared_timed_mutex> lock(jniObjMutex);
@@ -849,28 +919,30 @@ static void energy_info_recv_callback(bt_activity_energy_info* p_energy_info,
       p_energy_info->idle_time, p_energy_info->energy_used, array.get());
 }
 
-static bt_callbacks_t sBluetoothCallbacks = {sizeof(sBluetoothCallbacks),
-                                             adapter_state_change_callback,
-                                             adapter_properties_callback,
-                                             remote_device_properties_callback,
-                                             device_found_callback,
-                                             discovery_state_changed_callback,
-                                             pin_request_callback,
-                                             ssp_request_callback,
-                                             bond_state_changed_callback,
-                                             address_consolidate_callback,
-                                             le_address_associate_callback,
-                                             acl_state_changed_callback,
-                                             callback_thread_event,
-                                             dut_mode_recv_callback,
-                                             le_test_mode_recv_callback,
-                                             energy_info_recv_callback,
-                                             link_quality_report_callback,
-                                             generate_local_oob_data_callback,
-                                             switch_buffer_size_callback,
-                                             switch_codec_callback,
-                                             le_rand_callback,
-                                             key_missing_callback};
+static bt_callbacks_t sBluetoothCallbacks = {
+    sizeof(sBluetoothCallbacks),
+    adapter_state_change_callback,
+    adapter_properties_callback,
+    remote_device_properties_callback,
+    device_found_callback,
+    discovery_state_changed_callback,
+    pin_request_callback,
+    ssp_request_callback,
+    bond_state_changed_callback,
+    address_consolidate_callback,
+    le_address_associate_callback,
+    acl_state_changed_callback,
+    callback_thread_event,
+    dut_mode_recv_callback,
+    le_test_mode_recv_callback,
+    energy_info_recv_callback,
+    link_quality_report_callback,
+    generate_local_oob_data_callback,
+    switch_buffer_size_callback,
+    switch_codec_callback,
+    le_rand_callback,
+    key_missing_callback,
+    remote_device_properties_batch_callback};
 
 class JNIThreadAttacher {
  public:
@@ -2227,6 +2299,8 @@ int register_com_android_bluetooth_btservice_AdapterService(JNIEnv* env) {
        &method_discoveryStateChangeCallback},
       {"devicePropertyChangedCallback", "([B[I[[B)V",
        &method_devicePropertyChangedCallback},
+      {"devicePropertiesChangedBatchCallback", "([B[I[I[[B)V",
+       &method_devicePropertiesChangedBatchCallback},
       {"deviceFoundCallback", "([B)V", &method_deviceFoundCallback},
       {"pinRequestCallback", "([B[BIZ)V", &method_pinRequestCallback},
       {"sspRequestCallback", "([BII)V", &method_sspRequestCallback},
@@ -26,6 +26,8 @@
 
 #include "com_android_bluetooth.h"
 #include "common/init_flags.h"
+#include "common/metrics_registry.h"
+#include "common/time_util.h"
 #include "hardware/bt_gatt.h"
 #include "hardware/bt_gatt_types.h"
 #include "main/shim/le_scanning_manager.h"
@@ -166,6 +168,7 @@ static jmethodID method_onPeriodicAdvertisingEnabled;
  */
 static jmethodID method_onScannerRegistered;
 static jmethodID method_onScanResult;
+static jmethodID method_onScanResultBatch;
 static jmethodID method_onScanFilterConfig;
 static jmethodID method_onScanFilterParamsConfigured;
 static jmethodID method_onScanFilterEnableDisabled;
@@ -290,6 +293,11 @@ void btgattc_register_for_notification_cb(int conn_id, int registered,
 }
 
 void btgattc_notify_cb(int conn_id, const btgatt_notify_params_t& p_data) {
+  // Time to hand each notification to Java, value copy included
+  static auto& jni_time = bluetooth::common::MetricsRegistry::GetHistogram(
+      "gatt.jni_notify_time");
+  const uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
+
   std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
   CallbackEnv sCallbackEnv(__func__);
   if (!sCallbackEnv.valid() || !mCallbacksObj) return;
@@ -304,6 +312,7 @@ void btgattc_notify_cb(int conn_id, const btgatt_notify_params_t& p_data) {
   sCallbackEnv->CallVoidMethod(mCallbacksObj, method_onNotify, conn_id,
                                address.get(), p_data.handle, p_data.is_notify,
                                jb.get());
+  jni_time.Add(bluetooth::common::time_get_os_boottime_us() - start_us);
 }
 
 void btgattc_read_characteristic_cb(int conn_id, int status,
@@ -1037,6 +1046,21 @@ class JniScanningCallbacks : ScanningCallbacks {
         rssi, periodic_adv_int, jb.get(), fake_address.get());
   }
 
+  void OnScanResultBatch(int num_results,
+                         std::vector<uint8_t> packed_results) {
+    std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
+    CallbackEnv sCallbackEnv(__func__);
+    if (!sCallbackEnv.valid() || !mScanCallbacksObj) return;
+
+    ScopedLocalRef<jbyteArray> jb(
+        sCallbackEnv.get(), sCallbackEnv->NewByteArray(packed_results.size()));
+    sCallbackEnv->SetByteArrayRegion(jb.get(), 0, packed_results.size(),
+                                     (jbyte*)packed_results.data());
+
+    sCallbackEnv->CallVoidMethod(mScanCallbacksObj, method_onScanResultBatch,
+                                 num_results, jb.get());
+  }
+
   void OnTrackAdvFoundLost(AdvertisingTrackInfo track_info) {
     std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
     CallbackEnv sCallbackEnv(__func__);
@@ -1482,15 +1506,16 @@ static void gattClientWriteCharacteristicNative(JNIEnv* env,
     return;
   }
 
+  // The stack copies the value before posting the write, so the array is
+  // only pinned for that copy, and never copied back
   uint16_t len = (uint16_t)env->GetArrayLength(value);
-  jbyte* p_value = env->GetByteArrayElements(value, NULL);
+  void* p_value = env->GetPrimitiveArrayCritical(value, NULL);
   if (p_value == NULL) return;
 
   sGattIf->client->write_characteristic(conn_id, handle, write_type, auth_req,
-                                        reinterpret_cast<uint8_t*>(p_value),
-                                        len);
+                                        static_cast<uint8_t*>(p_value), len);
 
-  env->ReleaseByteArrayElements(value, p_value, 0);
+  env->ReleasePrimitiveArrayCritical(value, p_value, JNI_ABORT);
 }
 
 static void gattClientExecuteWriteNative(JNIEnv* /* env */,
@@ -1510,14 +1535,15 @@ static void gattClientWriteDescriptorNative(JNIEnv* env, jobject /* object */,
     return;
   }
 
+  // See gattClientWriteCharacteristicNative()
   uint16_t len = (uint16_t)env->GetArrayLength(value);
-  jbyte* p_value = env->GetByteArrayElements(value, NULL);
+  void* p_value = env->GetPrimitiveArrayCritical(value, NULL);
   if (p_value == NULL) return;
 
   sGattIf->client->write_descriptor(conn_id, handle, auth_req,
-                                    reinterpret_cast<uint8_t*>(p_value), len);
+                                    static_cast<uint8_t*>(p_value), len);
 
-  env->ReleaseByteArrayElements(value, p_value, 0);
+  env->ReleasePrimitiveArrayCritical(value, p_value, JNI_ABORT);
 }
 
 static void gattClientRegisterForNotificationsNative(
@@ -2095,13 +2121,16 @@ static void gattServerSendNotificationNative(JNIEnv* env, jobject /* object */,
                                              jint conn_id, jbyteArray val) {
   if (!sGattIf) return;
 
-  jbyte* array = env->GetByteArrayElements(val, 0);
+  // The stack copies the value before posting it, as for the client writes
   int val_len = env->GetArrayLength(val);
+  void* array = env->GetPrimitiveArrayCritical(val, NULL);
+  if (array == NULL) return;
 
   sGattIf->server->send_indication(server_if, attr_handle, conn_id,
-                                   /*confirm*/ 0, (uint8_t*)array, val_len);
+                                   /*confirm*/ 0, static_cast<uint8_t*>(array),
+                                   val_len);
 
-  env->ReleaseByteArrayElements(val, array, JNI_ABORT);
+  env->ReleasePrimitiveArrayCritical(val, array, JNI_ABORT);
 }
 
 static void gattServerSendResponseNative(JNIEnv* env, jobject /* object */,
@@ -2125,11 +2154,9 @@ static void gattServerSendResponseNative(JNIEnv* env, jobject /* object */,
       response.attr_value.len = GATT_MAX_ATTR_LEN;
     }
 
-    jbyte* array = env->GetByteArrayElements(val, 0);
-
-    for (int i = 0; i != response.attr_value.len; ++i)
-      response.attr_value.value[i] = (uint8_t)array[i];
-    env->ReleaseByteArrayElements(val, array, JNI_ABORT);
+    env->GetByteArrayRegion(
+        val, 0, response.attr_value.len,
+        reinterpret_cast<jbyte*>(response.attr_value.value));
   }
 
   if (bluetooth::gatt::is_connection_isolated(conn_id)) {
@@ -2633,6 +2660,7 @@ static int register_com_android_bluetooth_gatt_scan(JNIEnv* env) {
       {"onScannerRegistered", "(IIJJ)V", &method_onScannerRegistered},
       {"onScanResult", "(IILjava/lang/String;IIIIII[BLjava/lang/String;)V",
        &method_onScanResult},
+      {"onScanResultBatch", "(I[B)V", &method_onScanResultBatch},
       {"onScanFilterConfig", "(IIIII)V", &method_onScanFilterConfig},
       {"onScanFilterParamsConfigured", "(IIII)V",
        &method_onScanFilterParamsConfigured},
@@ -19,8 +19,12 @@ package com.android.bluetooth.btservice;
 import android.bluetooth.OobData;
 import android.bluetooth.UidTraffic;
 
+import java.util.Arrays;
+
 class JniCallbacks {
 
+    private static final int BD_ADDR_LEN = 6; // bytes
+
     private RemoteDevices mRemoteDevices;
     private AdapterProperties mAdapterProperties;
     private AdapterService mAdapterService;
@@ -56,6 +60,25 @@ class JniCallbacks {
         mRemoteDevices.devicePropertyChangedCallback(address, types, val);
     }
 
+    /**
+     * Property updates of several devices, packed as the addresses back to back, the number of
+     * properties of each device, and the types and values of all properties in device order.
+     */
+    void devicePropertiesChangedBatchCallback(
+            byte[] addresses, int[] counts, int[] types, byte[][] val) {
+        int index = 0;
+        for (int i = 0; i < counts.length; i++) {
+            byte[] address =
+                    Arrays.copyOfRange(
+                            addresses, i * BD_ADDR_LEN, (i + 1) * BD_ADDR_LEN);
+            mRemoteDevices.devicePropertyChangedCallback(
+                    address,
+                    Arrays.copyOfRange(types, index, index + counts[i]),
+                    Arrays.copyOfRange(val, index, index + counts[i]));
+            index += counts[i];
+        }
+    }
+
     void deviceFoundCallback(byte[] address) {
         mRemoteDevices.deviceFoundCallback(address);
     }
@@ -20,9 +20,12 @@ import android.annotation.Nullable;
 import android.os.RemoteException;
 import android.util.Log;
 
+import com.android.bluetooth.Utils;
 import com.android.bluetooth.gatt.FilterParams;
 import com.android.internal.annotations.VisibleForTesting;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.concurrent.CountDownLatch;
 import java.util.concurrent.TimeUnit;
 
@@ -30,6 +33,11 @@ import java.util.concurrent.TimeUnit;
 public class ScanNativeInterface {
     private static final String TAG = ScanNativeInterface.class.getSimpleName();
 
+    // Size of the fixed fields of a result passed to onScanResultBatch.
+    private static final int SCAN_RESULT_BATCH_HEADER_SIZE = 18;
+    private static final int BD_ADDR_LEN = 6;
+    private static final String EMPTY_ADDRESS = "00:00:00:00:00:00";
+
     private static ScanNativeInterface sInterface;
 
     private CountDownLatch mLatch = new CountDownLatch(1);
@@ -253,6 +261,53 @@ public class ScanNativeInterface {
                 originalAddress);
     }
 
+    /**
+     * Scan results batched by the native stack, packed as described by
+     * kScanResultBatchHeaderSize in ble_scanner.h.
+     */
+    void onScanResultBatch(int numResults, byte[] packedResults) {
+        if (mScanHelper == null) {
+            Log.e(TAG, "Scan helper is null!");
+            return;
+        }
+        ByteBuffer buffer = ByteBuffer.wrap(packedResults).order(ByteOrder.LITTLE_ENDIAN);
+        byte[] address = new byte[BD_ADDR_LEN];
+        for (int i = 0; i < numResults; i++) {
+            if (buffer.remaining() < SCAN_RESULT_BATCH_HEADER_SIZE) {
+                Log.e(TAG, "onScanResultBatch() - truncated result " + i + "/" + numResults);
+                return;
+            }
+            int eventType = Short.toUnsignedInt(buffer.getShort());
+            int addressType = Byte.toUnsignedInt(buffer.get());
+            buffer.get(address);
+            int primaryPhy = Byte.toUnsignedInt(buffer.get());
+            int secondaryPhy = Byte.toUnsignedInt(buffer.get());
+            int advertisingSid = Byte.toUnsignedInt(buffer.get());
+            int txPower = buffer.get();
+            int rssi = buffer.get();
+            int periodicAdvInt = Short.toUnsignedInt(buffer.getShort());
+            int advDataLen = Short.toUnsignedInt(buffer.getShort());
+            if (buffer.remaining() < advDataLen) {
+                Log.e(TAG, "onScanResultBatch() - truncated result " + i + "/" + numResults);
+                return;
+            }
+            byte[] advData = new byte[advDataLen];
+            buffer.get(advData);
+            mScanHelper.onScanResult(
+                    eventType,
+                    addressType,
+                    Utils.getAddressStringFromByte(address),
+                    primaryPhy,
+                    secondaryPhy,
+                    advertisingSid,
+                    txPower,
+                    rssi,
+                    periodicAdvInt,
+                    advData,
+                    EMPTY_ADDRESS);
+        }
+    }
+
     void onScannerRegistered(int status, int scannerId, long uuidLsb, long uuidMsb)
             throws RemoteException {
         if (mScanHelper == null) {
@@ -22,6 +22,7 @@
 #include <bta.sysprop.h>
 #include <device_id.sysprop.h>
 #include <hfp.sysprop.h>
+#include <thread.sysprop.h>
 
 #define GET_SYSPROP(namespace, prop, default) \
   android::sysprop::bluetooth::namespace ::prop().value_or(default)
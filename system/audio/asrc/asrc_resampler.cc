@@ -202,7 +202,7 @@ class SourceAudioHalAsrc::ClockRecovery
   }
 
   ~ClockRecovery() override {
-    hal::LinkClocker::Unregister();
+    hal::LinkClocker::Unregister(this);
     read_clock_timer_.Cancel();
   }
 
@@ -408,6 +408,97 @@ inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x,
   return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
 }
 
+//
+// x86 AVX2 Resampler Filtering
+//
+
+#elif defined(__AVX2__)
+
+#include <immintrin.h>
+
+inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x,
+                                                     const int32_t* h,
+                                                     int16_t _mu,
+                                                     const int16_t* d) {
+  const __m256i mu = _mm256_set1_epi32(_mu);
+  const __m256i rnd = _mm256_set1_epi32(1 << 6);
+
+  // The signed 32x32 bits multiplications only run on the even lanes,
+  // the odd lanes are accumulated separately after a 32 bits shift.
+
+  __m256i sx_even = _mm256_setzero_si256();
+  __m256i sx_odd = _mm256_setzero_si256();
+
+  for (int i = 0; i < 2 * KERNEL_A; i += 8) {
+    __m256i d8 = _mm256_cvtepi16_epi32(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(d + i)));
+    __m256i h8 = _mm256_load_si256(reinterpret_cast<const __m256i*>(h + i));
+    __m256i x8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+
+    h8 = _mm256_add_epi32(
+        h8, _mm256_srai_epi32(
+                _mm256_add_epi32(_mm256_mullo_epi32(d8, mu), rnd), 7));
+
+    sx_even = _mm256_add_epi64(sx_even, _mm256_mul_epi32(x8, h8));
+    sx_odd = _mm256_add_epi64(
+        sx_odd, _mm256_mul_epi32(_mm256_srli_epi64(x8, 32),
+                                 _mm256_srli_epi64(h8, 32)));
+  }
+
+  __m256i sx4 = _mm256_add_epi64(sx_even, sx_odd);
+  __m128i sx2 = _mm_add_epi64(_mm256_castsi256_si128(sx4),
+                              _mm256_extracti128_si256(sx4, 1));
+  int64_t sx[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sx), sx2);
+
+  int64_t s = (sx[0] + sx[1] + (1 << 30)) >> 31;
+  return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
+}
+
+//
+// x86 SSE4.1 Resampler Filtering
+//
+
+#elif defined(__SSE4_1__)
+
+#include <smmintrin.h>
+
+inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x,
+                                                     const int32_t* h,
+                                                     int16_t _mu,
+                                                     const int16_t* d) {
+  const __m128i mu = _mm_set1_epi32(_mu);
+  const __m128i rnd = _mm_set1_epi32(1 << 6);
+
+  // The signed 32x32 bits multiplications only run on the even lanes,
+  // the odd lanes are accumulated separately after a 32 bits shift.
+
+  __m128i sx_even = _mm_setzero_si128();
+  __m128i sx_odd = _mm_setzero_si128();
+
+  for (int i = 0; i < 2 * KERNEL_A; i += 4) {
+    __m128i d4 = _mm_cvtepi16_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(d + i)));
+    __m128i h4 = _mm_load_si128(reinterpret_cast<const __m128i*>(h + i));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+
+    h4 = _mm_add_epi32(
+        h4, _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(d4, mu), rnd), 7));
+
+    sx_even = _mm_add_epi64(sx_even, _mm_mul_epi32(x4, h4));
+    sx_odd = _mm_add_epi64(
+        sx_odd,
+        _mm_mul_epi32(_mm_srli_epi64(x4, 32), _mm_srli_epi64(h4, 32)));
+  }
+
+  int64_t sx[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sx),
+                   _mm_add_epi64(sx_even, sx_odd));
+
+  int64_t s = (sx[0] + sx[1] + (1 << 30)) >> 31;
+  return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
+}
+
 //
 // Generic Resampler Filtering
 //
@@ -569,14 +660,23 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
                         (int64_t(sample_rate_) << 26));
 }
 
-__attribute__((no_sanitize("integer"))) std::vector<const std::vector<uint8_t>*>
-SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
+std::vector<const std::vector<uint8_t>*> SourceAudioHalAsrc::Run(
+    const std::vector<uint8_t>& in) {
   std::vector<const std::vector<uint8_t>*> out;
+  Run(in, &out);
+  return out;
+}
+
+__attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Run(
+    const std::vector<uint8_t>& in,
+    std::vector<const std::vector<uint8_t>*>* out_list) {
+  auto& out = *out_list;
+  out.clear();
 
   if (in.size() != buffers_size_) {
     log::error("Inconsistent input buffer size: {} ({} expected)", in.size(),
                buffers_size_);
-    return out;
+    return;
   }
 
   // The burst delay has expired, let's generate the burst.
@@ -627,8 +727,6 @@ SourceAudioHalAsrc::Run(const std::vector<uint8_t>& in) {
     log::info("[{:6}.{:06}]  Fs: {:.2f} Hz  drift: {} us",
               output_us / (1000 * 1000), output_us % (1000 * 1000),
               ratio * sample_rate_, int(output_us - local_us));
-
-  return out;
 }
 
 }  // namespace bluetooth::audio::asrc
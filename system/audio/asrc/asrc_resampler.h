@@ -54,6 +54,13 @@ class SourceAudioHalAsrc {
 
   std::vector<const std::vector<uint8_t>*> Run(const std::vector<uint8_t>& in);
 
+  // Same as above, the resampled buffers are returned in `out`, which is
+  // cleared first. Reusing the same list over the calls avoids to allocate
+  // it for each input buffer.
+
+  void Run(const std::vector<uint8_t>& in,
+           std::vector<const std::vector<uint8_t>*>* out);
+
  private:
   const int sample_rate_;
   const int bit_depth_;
@@ -89,6 +96,7 @@ class SourceAudioHalAsrc {
                 std::vector<const std::vector<uint8_t>*>*, uint32_t*);
 
   friend class SourceAudioHalAsrcTest;
+  friend class SourceAudioHalAsrcBenchmark;
 };
 
 }  // namespace bluetooth::audio::asrc
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "asrc_resampler.cc"
+
+using ::benchmark::State;
+
+bluetooth::common::MessageLoopThread message_loop_thread("main message loop");
+bluetooth::common::MessageLoopThread* get_main_thread() {
+  return &message_loop_thread;
+}
+
+namespace bluetooth::hal {
+void LinkClocker::Register(ReadClockHandler*) {}
+void LinkClocker::Unregister(ReadClockHandler*) {}
+}  // namespace bluetooth::hal
+
+namespace bluetooth::audio::asrc {
+
+// Same interval as the hearing aid source
+constexpr int kIntervalUs = 10000;
+// Drift corrected in each direction, a controller clock is usually within
+// a few tens of ppm of the audio clock
+constexpr double kDriftPpm = 100;
+
+class SourceAudioHalAsrcBenchmark : public SourceAudioHalAsrc {
+ public:
+  SourceAudioHalAsrcBenchmark(int channels, int sample_rate, int bit_depth)
+      : SourceAudioHalAsrc(&message_loop_thread, channels, sample_rate,
+                           bit_depth, kIntervalUs, 0, 0) {}
+
+  size_t BufferSize() const { return buffers_size_; }
+
+  // Resample one interval of interleaved PCM, like Run() does once the clock
+  // recovery has returned the ratio.
+  template <typename T>
+  void Resample(double ratio, const std::vector<uint8_t>& in,
+                std::vector<const std::vector<uint8_t>*>* out) {
+    uint32_t output_us;
+    out->clear();
+    SourceAudioHalAsrc::Resample<T>(ratio, in, out, &output_us);
+  }
+};
+
+}  // namespace bluetooth::audio::asrc
+
+namespace {
+
+using bluetooth::audio::asrc::kDriftPpm;
+using bluetooth::audio::asrc::kIntervalUs;
+using bluetooth::audio::asrc::SourceAudioHalAsrcBenchmark;
+
+// Fill an interval with a tone on each channel, at about half of the scale.
+template <typename T>
+void GeneratePcm(std::vector<uint8_t>& buffer, int channels, int sample_rate,
+                 int bit_depth) {
+  T* pcm = reinterpret_cast<T*>(buffer.data());
+  size_t num_samples = buffer.size() / sizeof(T) / channels;
+  double amplitude = ldexp(1., bit_depth - 2);
+  for (size_t i = 0; i < num_samples; i++) {
+    for (int ch = 0; ch < channels; ch++) {
+      pcm[i * channels + ch] = static_cast<T>(
+          amplitude * sin(2 * M_PI * (440 + 220 * ch) * i / sample_rate));
+    }
+  }
+}
+
+// Resample one second of audio per iteration, alternating upsampling and
+// downsampling from one interval to the other so that both loops of the
+// resampler are measured. The time per sample counts the samples of all the
+// channels.
+template <typename T>
+void ResamplePcm(State& state, int bit_depth) {
+  const int channels = state.range(0);
+  const int sample_rate = state.range(1);
+  SourceAudioHalAsrcBenchmark asrc(channels, sample_rate, bit_depth);
+
+  std::vector<uint8_t> in(asrc.BufferSize());
+  GeneratePcm<T>(in, channels, sample_rate, bit_depth);
+  std::vector<const std::vector<uint8_t>*> out;
+
+  const int num_intervals = 1000 * 1000 / kIntervalUs;
+  const double ratios[2] = {1 - kDriftPpm * 1e-6, 1 + kDriftPpm * 1e-6};
+
+  for (auto _ : state) {
+    for (int i = 0; i < num_intervals; i++) {
+      asrc.Resample<T>(ratios[i % 2], in, &out);
+      ::benchmark::DoNotOptimize(out.data());
+    }
+    ::benchmark::ClobberMemory();
+  }
+
+  state.counters["time_per_sample"] = ::benchmark::Counter(
+      channels * sample_rate,
+      ::benchmark::Counter::kIsIterationInvariantRate |
+          ::benchmark::Counter::kInvert);
+}
+
+}  // namespace
+
+static void BM_AsrcResampleInt16(State& state) {
+  ResamplePcm<int16_t>(state, 16);
+}
+BENCHMARK(BM_AsrcResampleInt16)
+    ->ArgNames({"channels", "sample_rate"})
+    ->ArgsProduct({{1, 2, 4}, {16000, 24000, 32000, 48000}});
+
+static void BM_AsrcResampleInt32(State& state) {
+  ResamplePcm<int32_t>(state, 24);
+}
+BENCHMARK(BM_AsrcResampleInt32)
+    ->ArgNames({"channels", "sample_rate"})
+    ->ArgsProduct({{1, 2, 4}, {16000, 24000, 32000, 48000}});
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -26,7 +26,7 @@ bluetooth::common::MessageLoopThread* get_main_thread() {
 
 namespace bluetooth::hal {
 void LinkClocker::Register(ReadClockHandler*) {}
-void LinkClocker::Unregister() {}
+void LinkClocker::Unregister(ReadClockHandler*) {}
 }  // namespace bluetooth::hal
 
 namespace bluetooth::audio::asrc {
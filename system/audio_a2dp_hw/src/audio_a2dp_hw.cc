@@ -34,6 +34,7 @@
 #include <inttypes.h>
 #include <log/log.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -361,7 +362,10 @@ static int a2dp_ctrl_receive(struct a2dp_stream_common* common, void* buffer,
   int i;
 
   for (i = 0;; i++) {
-    OSI_NO_INTR(ret = recv(common->ctrl_fd, buffer, length, MSG_NOSIGNAL));
+    // Wait for all of |length|, that the stack may have sent in one write
+    // with the following fields, up to the receive timeout of the socket
+    OSI_NO_INTR(ret = recv(common->ctrl_fd, buffer, length,
+                           MSG_NOSIGNAL | MSG_WAITALL));
     if (ret > 0) {
       break;
     }
@@ -764,23 +768,23 @@ static int a2dp_get_presentation_position_cmd(struct a2dp_stream_common* common,
     return -1;
   }
 
-  if (a2dp_ctrl_receive(common, bytes, sizeof(*bytes)) < 0) {
-    return -1;
-  }
-
-  if (a2dp_ctrl_receive(common, delay, sizeof(*delay)) < 0) {
+  // Received at once: bytes (8) | delay (2) | seconds (4) | nanoseconds (4)
+  uint8_t position[sizeof(*bytes) + sizeof(*delay) + 2 * sizeof(uint32_t)];
+  if (a2dp_ctrl_receive(common, position, sizeof(position)) <
+      static_cast<int>(sizeof(position))) {
     return -1;
   }
 
+  const uint8_t* p = position;
   uint32_t seconds;
-  if (a2dp_ctrl_receive(common, &seconds, sizeof(seconds)) < 0) {
-    return -1;
-  }
-
   uint32_t nsec;
-  if (a2dp_ctrl_receive(common, &nsec, sizeof(nsec)) < 0) {
-    return -1;
-  }
+  memcpy(bytes, p, sizeof(*bytes));
+  p += sizeof(*bytes);
+  memcpy(delay, p, sizeof(*delay));
+  p += sizeof(*delay);
+  memcpy(&seconds, p, sizeof(seconds));
+  p += sizeof(seconds);
+  memcpy(&nsec, p, sizeof(nsec));
 
   timestamp->tv_sec = seconds;
   timestamp->tv_nsec = nsec;
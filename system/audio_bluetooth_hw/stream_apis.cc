@@ -26,6 +26,7 @@
 #include <unistd.h>
 
 #include <memory>
+#include <sstream>
 
 #include "BluetoothAudioSession.h"
 #include "stream_apis.h"
@@ -106,14 +107,16 @@ void out_calculate_feeding_delay_ms(const BluetoothStreamOut* out,
   }
   if (frames != nullptr) {
     const uint64_t latency_frames = delay_report_ms * out->sample_rate_ / 1000;
+    // out_write() adds to it without the lock
+    const uint64_t frames_presented = out->frames_presented_;
     *frames = absorbed_bytes / audio_stream_out_frame_size(&out->stream_out_);
-    if (out->frames_presented_ < *frames) {
+    if (frames_presented < *frames) {
       // Are we (the audio HAL) reset?! The stack counter is obsoleted.
-      *frames = out->frames_presented_;
-    } else if ((out->frames_presented_ - *frames) > latency_frames) {
+      *frames = frames_presented;
+    } else if ((frames_presented - *frames) > latency_frames) {
       // Is the Bluetooth output reset / restarted by AVDTP reconfig?! Its
       // counter was reset but could not be used.
-      *frames = out->frames_presented_;
+      *frames = frames_presented;
     }
     // suppose frames would be queued in the headset buffer for delay_report
     // period, so those frames in buffers should not be included in the number
@@ -296,6 +299,15 @@ static int out_standby(struct audio_stream* stream) {
 static int out_dump(const struct audio_stream* stream, int fd) {
   const auto* out = reinterpret_cast<const BluetoothStreamOut*>(stream);
   LOG(VERBOSE) << __func__ << ": state=" << out->bluetooth_output_->GetState();
+  std::ostringstream state;
+  state << out->bluetooth_output_->GetState();
+  dprintf(fd,
+          "      Bluetooth output: state=%s, frames (rendered/presented)=%" PRIu64
+          "/%" PRIu64 "\n",
+          state.str().c_str(), out->frames_rendered_.load(),
+          out->frames_presented_.load());
+  dprintf(fd, "      Write latency (us): count: %zu, %s\n",
+          out->write_latency_.Count(), out->write_latency_.ToString().c_str());
   return 0;
 }
 
@@ -528,13 +540,14 @@ static int out_set_volume(struct audio_stream_out* stream, float left,
 static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
                          size_t bytes) {
   auto* out = reinterpret_cast<BluetoothStreamOut*>(stream);
-  std::unique_lock<std::mutex> lock(out->mutex_);
   size_t totalWritten = 0;
 
+  // The state only changes under the lock, in out_resume() / out_standby() and
+  // on the session callbacks; once STARTED, the write path does not take the
+  // lock so that it never waits behind those nor behind the getters
   if (out->bluetooth_output_->GetState() != BluetoothStreamState::STARTED) {
     LOG(INFO) << __func__ << ": state=" << out->bluetooth_output_->GetState()
               << " first time bytes=" << bytes;
-    lock.unlock();
     if (stream->resume(stream)) {
       LOG(ERROR) << __func__ << ": state=" << out->bluetooth_output_->GetState()
                  << " failed to resume";
@@ -546,21 +559,22 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
       usleep(out->preferred_data_interval_us);
       return totalWritten;
     }
-    lock.lock();
   }
-  lock.unlock();
-  totalWritten = out->bluetooth_output_->WriteData(buffer, bytes);
-  lock.lock();
 
   struct timespec ts = {.tv_sec = 0, .tv_nsec = 0};
   clock_gettime(CLOCK_MONOTONIC, &ts);
+  const int64_t write_start_us = (ts.tv_sec * 1000000000LL + ts.tv_nsec) / 1000;
+  totalWritten = out->bluetooth_output_->WriteData(buffer, bytes);
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  const int64_t now = (ts.tv_sec * 1000000000LL + ts.tv_nsec) / 1000;
+  out->write_latency_.Add(now - write_start_us);
+
   if (totalWritten) {
     const size_t frames = bytes / audio_stream_out_frame_size(stream);
     out->frames_rendered_ += frames;
     out->frames_presented_ += frames;
-    out->last_write_time_us_ = (ts.tv_sec * 1000000000LL + ts.tv_nsec) / 1000;
+    out->last_write_time_us_ = now;
   } else {
-    const int64_t now = (ts.tv_sec * 1000000000LL + ts.tv_nsec) / 1000;
     const int64_t elapsed_time_since_last_write =
         now - out->last_write_time_us_;
     // frames_count = written_data / frame_size
@@ -573,9 +587,7 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
     if (sleep_time > 0) {
       LOG(VERBOSE) << __func__ << ": sleep " << (sleep_time / 1000)
                    << " ms when writting FMQ datapath";
-      lock.unlock();
       usleep(sleep_time);
-      lock.lock();
     } else {
       // we don't sleep when we exit standby (this is typical for a real alsa
       // buffer).
@@ -594,8 +606,9 @@ static int out_get_render_position(const struct audio_stream_out* stream,
   // frames = (latency (ms) / 1000) * samples_per_second (sample_rate)
   const uint64_t latency_frames =
       (uint64_t)out_get_latency_ms(stream) * out->sample_rate_ / 1000;
-  if (out->frames_rendered_ >= latency_frames) {
-    *dsp_frames = (uint32_t)(out->frames_rendered_ - latency_frames);
+  const uint64_t frames_rendered = out->frames_rendered_;
+  if (frames_rendered >= latency_frames) {
+    *dsp_frames = (uint32_t)(frames_rendered - latency_frames);
   } else {
     *dsp_frames = 0;
   }
@@ -19,10 +19,12 @@
 #include <hardware/audio.h>
 #include <system/audio.h>
 
+#include <atomic>
 #include <list>
 
 #include "device_port_proxy.h"
 #include "device_port_proxy_hidl.h"
+#include "utils.h"
 
 constexpr unsigned int kBluetoothDefaultSampleRate = 44100;
 constexpr audio_format_t kBluetoothDefaultAudioFormatBitsPerSample =
@@ -57,7 +59,9 @@ struct BluetoothStreamOut {
   std::unique_ptr<::android::bluetooth::audio::BluetoothAudioPort>
       bluetooth_output_;
   bool is_aidl;
-  int64_t last_write_time_us_;
+  // The write time and the frame counters are atomic as out_write() updates
+  // them without holding |mutex_| once the stream is started
+  std::atomic<int64_t> last_write_time_us_;
   // Audio PCM Configs
   uint32_t sample_rate_;
   audio_channel_mask_t channel_mask_;
@@ -67,9 +71,11 @@ struct BluetoothStreamOut {
   // frames count per tick
   size_t frames_count_;
   // total frames written, reset on standby
-  uint64_t frames_rendered_;
+  std::atomic<uint64_t> frames_rendered_;
   // total frames written after opened, never reset
-  uint64_t frames_presented_;
+  std::atomic<uint64_t> frames_presented_;
+  // time spent in each BluetoothAudioPort::WriteData(), since opened
+  ::android::bluetooth::audio::utils::LatencyHistogram write_latency_;
   mutable std::mutex mutex_;
 };
 
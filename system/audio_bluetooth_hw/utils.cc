@@ -61,6 +61,47 @@ size_t FrameCount(uint64_t microseconds, uint32_t sample_rate) {
   return (microseconds * sample_rate) / 1000000;
 }
 
+void LatencyHistogram::Add(uint64_t value_us) {
+  size_t bucket = 0;
+  while (bucket < kNumBuckets - 1 && value_us >= BucketUpperBoundUs(bucket)) {
+    bucket++;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_us_.fetch_add(value_us, std::memory_order_relaxed);
+
+  uint64_t max_us = max_us_.load(std::memory_order_relaxed);
+  while (value_us > max_us &&
+         !max_us_.compare_exchange_weak(max_us, value_us,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  total_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::AverageUs() const {
+  size_t count = Count();
+  return count ? total_us_.load(std::memory_order_relaxed) / count : 0;
+}
+
+std::string LatencyHistogram::ToString() const {
+  std::ostringstream sout;
+  for (size_t i = 0; i < kNumBuckets - 1; i++) {
+    sout << "<" << BucketUpperBoundUs(i) << ":" << BucketCount(i) << " ";
+  }
+  sout << ">=" << BucketUpperBoundUs(kNumBuckets - 2) << ":"
+       << BucketCount(kNumBuckets - 1) << ", avg: " << AverageUs()
+       << ", max: " << MaxUs();
+  return sout.str();
+}
+
 }  // namespace utils
 }  // namespace audio
 }  // namespace bluetooth
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -43,6 +47,42 @@ std::string GetAudioParamString(
     std::unordered_map<std::string, std::string>& params_map);
 
 size_t FrameCount(uint64_t microseconds, uint32_t sample_rate);
+
+// Histogram of durations in microseconds, with buckets doubling from
+// kFirstBucketUs. Bucket i counts the values below BucketUpperBoundUs(i), the
+// last bucket counts everything else. Add() uses relaxed atomics only, so that
+// the audio thread may record without locking while another thread dumps it;
+// a dump taken during an Add() may be off by that value.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kNumBuckets = 9;
+  static constexpr uint64_t kFirstBucketUs = 125;
+
+  static uint64_t BucketUpperBoundUs(size_t bucket) {
+    return kFirstBucketUs << bucket;
+  }
+
+  void Add(uint64_t value_us);
+  void Reset();
+
+  size_t Count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t MaxUs() const { return max_us_.load(std::memory_order_relaxed); }
+  uint64_t AverageUs() const;
+  size_t BucketCount(size_t bucket) const {
+    return buckets_[bucket].load(std::memory_order_relaxed);
+  }
+
+  // Formats the buckets as "<125:3 <250:0 ... >=16000:1", followed by the
+  // average and the maximum.
+  std::string ToString() const;
+
+ private:
+  std::array<std::atomic<size_t>, kNumBuckets> buckets_{};
+  std::atomic<size_t> count_{0};
+  std::atomic<uint64_t> total_us_{0};
+  std::atomic<uint64_t> max_us_{0};
+};
+
 }  // namespace utils
 }  // namespace audio
 }  // namespace bluetooth
@@ -22,6 +22,7 @@
 namespace {
 
 using ::android::bluetooth::audio::utils::FrameCount;
+using ::android::bluetooth::audio::utils::LatencyHistogram;
 using ::android::bluetooth::audio::utils::ParseAudioParams;
 
 class UtilsTest : public testing::Test {
@@ -139,4 +140,22 @@ TEST_F(UtilsTest, FrameCountTest) {
   EXPECT_EQ(FrameCount(7500, 32000), 240);
 }
 
+TEST_F(UtilsTest, LatencyHistogramBuckets) {
+  LatencyHistogram histogram;
+  for (uint64_t value_us : {0, 124, 125, 999, 16000, 1000000}) {
+    histogram.Add(value_us);
+  }
+  EXPECT_EQ(histogram.Count(), 6u);
+  EXPECT_EQ(histogram.MaxUs(), 1000000u);
+  EXPECT_EQ(histogram.AverageUs(), 1017248u / 6);
+  EXPECT_EQ(histogram.ToString(),
+            "<125:2 <250:1 <500:0 <1000:1 <2000:0 <4000:0 <8000:0 <16000:0 "
+            ">=16000:2, avg: 169541, max: 1000000");
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.AverageUs(), 0u);
+  EXPECT_EQ(histogram.BucketCount(0), 0u);
+}
+
 }  // namespace
@@ -131,6 +131,34 @@ size_t read(uint8_t* p_buf, uint32_t len) {
   return aidl::a2dp::read(p_buf, len);
 }
 
+// Access the data of the FMQ of BluetoothAudio HAL in place
+size_t peek(const uint8_t** p_buf, uint32_t len) {
+  // The HIDL HAL only supports copying the data
+  if (HalVersionManager::GetHalTransport() ==
+      BluetoothAudioHalTransport::HIDL) {
+    return 0;
+  }
+  return aidl::a2dp::peek(p_buf, len);
+}
+
+// Release the data returned by peek()
+void consume(size_t len) {
+  if (HalVersionManager::GetHalTransport() ==
+      BluetoothAudioHalTransport::HIDL) {
+    return;
+  }
+  aidl::a2dp::consume(len);
+}
+
+// Number of octets waiting in the FMQ of BluetoothAudio HAL
+size_t available_to_read() {
+  if (HalVersionManager::GetHalTransport() ==
+      BluetoothAudioHalTransport::HIDL) {
+    return 0;
+  }
+  return aidl::a2dp::available_to_read();
+}
+
 // Update A2DP delay report to BluetoothAudio HAL
 void set_remote_delay(uint16_t delay_report) {
   if (HalVersionManager::GetHalTransport() ==
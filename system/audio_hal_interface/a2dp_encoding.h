@@ -61,6 +61,17 @@ void ack_stream_suspended(const tA2DP_CTRL_ACK& status);
 // Read from the FMQ of BluetoothAudio HAL
 size_t read(uint8_t* p_buf, uint32_t len);
 
+// Access the data of the FMQ of BluetoothAudio HAL in place. |*p_buf| is set
+// to up to |len| contiguous octets, which stay valid until consume() is called.
+// Returns the number of octets at |*p_buf|, 0 if the data must be read().
+size_t peek(const uint8_t** p_buf, uint32_t len);
+
+// Release |len| octets returned by peek()
+void consume(size_t len);
+
+// Number of octets waiting in the FMQ of BluetoothAudio HAL
+size_t available_to_read();
+
 // Update A2DP delay report to BluetoothAudio HAL
 void set_remote_delay(uint16_t delay_report);
 
@@ -288,6 +288,13 @@ size_t read(uint8_t* p_buf, uint32_t len) {
   return bytes_read;
 }
 
+// The data of the UIPC channel can only be copied
+size_t peek(const uint8_t** /* p_buf */, uint32_t /* len */) { return 0; }
+
+void consume(size_t /* len */) {}
+
+size_t available_to_read() { return 0; }
+
 // Check if OPUS codec is supported
 bool is_opus_supported() { return true; }
 
@@ -682,6 +682,25 @@ size_t read(uint8_t* p_buf, uint32_t len) {
   return active_hal_interface->ReadAudioData(p_buf, len);
 }
 
+// Access the data of the FMQ of BluetoothAudio HAL in place. The callers fall
+// back to read() when nothing is returned, which logs the errors.
+size_t peek(const uint8_t** p_buf, uint32_t len) {
+  if (!is_hal_enabled() || is_hal_offloading()) return 0;
+  return active_hal_interface->PeekAudioData(p_buf, len);
+}
+
+// Release the data returned by peek()
+void consume(size_t len) {
+  if (!is_hal_enabled() || is_hal_offloading()) return;
+  active_hal_interface->ConsumeAudioData(len);
+}
+
+// Number of octets waiting in the FMQ of BluetoothAudio HAL
+size_t available_to_read() {
+  if (!is_hal_enabled() || is_hal_offloading()) return 0;
+  return active_hal_interface->AvailableToRead();
+}
+
 // Update A2DP delay report to BluetoothAudio HAL
 void set_remote_delay(uint16_t delay_report) {
   if (!is_hal_enabled()) {
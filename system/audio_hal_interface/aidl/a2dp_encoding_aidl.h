@@ -78,6 +78,21 @@ void ack_stream_suspended(const tA2DP_CTRL_ACK& status);
  ***/
 size_t read(uint8_t* p_buf, uint32_t len);
 
+/***
+ * Access the data of the FMQ of BluetoothAudio HAL in place
+ ***/
+size_t peek(const uint8_t** p_buf, uint32_t len);
+
+/***
+ * Release the data returned by peek()
+ ***/
+void consume(size_t len);
+
+/***
+ * Number of octets waiting in the FMQ of BluetoothAudio HAL
+ ***/
+size_t available_to_read();
+
 /***
  * Update A2DP delay report to BluetoothAudio HAL
  ***/
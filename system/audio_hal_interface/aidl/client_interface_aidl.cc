@@ -22,6 +22,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <thread>
 #include <vector>
 
@@ -595,6 +596,51 @@ size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
   return total_read;
 }
 
+size_t BluetoothAudioSinkClientInterface::PeekAudioData(const uint8_t** p_buf,
+                                                        uint32_t len) {
+  if (!IsValid()) {
+    log::error("BluetoothAudioHal is not valid");
+    return 0;
+  }
+  if (p_buf == nullptr || len == 0) return 0;
+
+  std::lock_guard<std::mutex> guard(internal_mutex_);
+
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return 0;
+
+  size_t avail_to_read = std::min<size_t>(data_mq_->availableToRead(), len);
+  DataMQ::MemTransaction tx;
+  if (avail_to_read == 0 || !data_mq_->beginRead(avail_to_read, &tx)) {
+    return 0;
+  }
+  // The data that wraps around the end of the fmq is left to the next call
+  auto region = tx.getFirstRegion();
+  *p_buf = reinterpret_cast<const uint8_t*>(region.getAddress());
+  return std::min(region.getLength(), avail_to_read);
+}
+
+void BluetoothAudioSinkClientInterface::ConsumeAudioData(size_t len) {
+  if (len == 0) return;
+
+  std::lock_guard<std::mutex> guard(internal_mutex_);
+
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return;
+  if (!data_mq_->commitRead(len)) {
+    log::warn("len={} failed", len);
+    return;
+  }
+  sink_->LogBytesRead(len);
+}
+
+size_t BluetoothAudioSinkClientInterface::AvailableToRead() const {
+  if (!IsValid()) return 0;
+
+  std::lock_guard<std::mutex> guard(internal_mutex_);
+
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return 0;
+  return data_mq_->availableToRead();
+}
+
 void BluetoothAudioClientInterface::RenewAudioProviderAndSession() {
   // NOTE: must be invoked on the same thread where this
   // BluetoothAudioClientInterface is running
@@ -207,6 +207,24 @@ class BluetoothAudioSinkClientInterface : public BluetoothAudioClientInterface {
    ***/
   size_t ReadAudioData(uint8_t* p_buf, uint32_t len);
 
+  /***
+   * Access the data of the fmq in place. |*p_buf| is set to the first
+   * contiguous region of up to |len| bytes, which stays valid until
+   * ConsumeAudioData() is called on the same thread as the session.
+   * Returns the number of bytes at |*p_buf|.
+   ***/
+  size_t PeekAudioData(const uint8_t** p_buf, uint32_t len);
+
+  /***
+   * Release |len| bytes returned by PeekAudioData()
+   ***/
+  void ConsumeAudioData(size_t len);
+
+  /***
+   * Number of bytes waiting in the fmq
+   ***/
+  size_t AvailableToRead() const;
+
  private:
   IBluetoothSinkTransportInstance* sink_;
 
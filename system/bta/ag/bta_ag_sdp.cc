@@ -540,6 +540,14 @@ void bta_ag_do_disc(tBTA_AG_SCB* p_scb, tBTA_SERVICE_MASK service) {
   if (get_legacy_stack_sdp_api()->service.SDP_InitDiscoveryDb(
           p_scb->p_disc_db, BTA_AG_DISC_BUF_SIZE, num_uuid, uuid_list, num_attr,
           attr_list)) {
+    /* Bonded headsets and car kits reconnect often and rarely change their
+     * records, skip the SDP query when the last response is cached */
+    if (get_legacy_stack_sdp_api()->service.SDP_ServiceSearchAttributeFromCache(
+            p_scb->peer_addr, p_scb->p_disc_db)) {
+      bta_ag_sdp_cback_tbl[bta_ag_scb_to_idx(p_scb) - 1](p_scb->peer_addr,
+                                                         SDP_SUCCESS);
+      return;
+    }
     if (get_legacy_stack_sdp_api()->service.SDP_ServiceSearchAttributeRequest(
             p_scb->peer_addr, p_scb->p_disc_db,
             bta_ag_sdp_cback_tbl[bta_ag_scb_to_idx(p_scb) - 1])) {
@@ -291,6 +291,51 @@ void bta_av_st_rc_timer(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_av_get_all_cap
+ *
+ * Description      Whether the capabilities of the peer streams are gotten
+ *                  with AVDTP Get All Capabilities.
+ *
+ * Returns          true for Get All Capabilities, false for Get Capabilities.
+ *
+ ******************************************************************************/
+static bool bta_av_get_all_cap(const tBTA_AV_SCB* p_scb) {
+  return (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
+         (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_cached_getcap
+ *
+ * Description      Report the capabilities of stream |seid| from the SEP
+ *                  cache, as the response of the peer would have been.
+ *
+ * Returns          true if the capabilities were cached, false otherwise.
+ *
+ ******************************************************************************/
+static bool bta_av_cached_getcap(tBTA_AV_SCB* p_scb, uint8_t seid) {
+  const AvdtpSepConfig* p_cap =
+      bta_av_sep_cache_find(p_scb->PeerAddress(), seid);
+  if (p_cap == nullptr) return false;
+
+  log::verbose("peer {} seid {} capabilities from the cache",
+               p_scb->PeerAddress(), seid);
+  p_scb->peer_cap = *p_cap;
+
+  tBTA_AV_STR_MSG* p_msg =
+      (tBTA_AV_STR_MSG*)osi_calloc(sizeof(tBTA_AV_STR_MSG));
+  p_msg->hdr.event = BTA_AV_STR_GETCAP_OK_EVT;
+  p_msg->hdr.layer_specific = p_scb->hndl;
+  p_msg->bd_addr = p_scb->PeerAddress();
+  p_msg->scb_index = p_scb->hdi;
+  p_msg->avdt_event = AVDT_GETCAP_CFM_EVT;
+  bta_sys_sendmsg(p_msg);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_next_getcap
@@ -320,10 +365,11 @@ static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
       p_scb->sep_info_idx = i;
 
       /* we got a stream; get its capabilities */
-      bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
-                         (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
-      AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info[i].seid,
-                     &p_scb->peer_cap, &bta_av_proc_stream_evt, get_all_cap);
+      if (!bta_av_cached_getcap(p_scb, p_scb->sep_info[i].seid)) {
+        AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi,
+                       p_scb->sep_info[i].seid, &p_scb->peer_cap,
+                       &bta_av_proc_stream_evt, bta_av_get_all_cap(p_scb));
+      }
       sent_cmd = true;
       break;
     }
@@ -478,6 +524,9 @@ void bta_av_sink_data_cback(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     return;
   }
   p_pkt->event = BTA_AV_SINK_MEDIA_DATA_EVT;
+  /* The media header has been parsed and skipped by the offset, pass the RTP
+   * timestamp in the first bytes of the buffer */
+  *((uint32_t*)(p_pkt + 1)) = time_stamp;
   p_scb->seps[p_scb->sep_idx].p_app_sink_data_cback(
       p_scb->PeerAddress(), BTA_AV_SINK_MEDIA_DATA_EVT, (tBTA_AV_MEDIA*)p_pkt);
   /* Free the buffer: a copy of the packet has been delivered */
@@ -1231,6 +1280,8 @@ void bta_av_str_opened(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   memset(&p_scb->q_info, 0, sizeof(tBTA_AV_Q_INFO));
 
   p_scb->l2c_bufs = 0;
+  p_scb->media_packets_sent = 0;
+  p_scb->media_bytes_copied = 0;
   p_scb->p_cos->open(p_scb->hndl, p_scb->PeerAddress(), p_scb->stream_mtu);
 
   {
@@ -1456,6 +1507,8 @@ void bta_av_disc_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_sep_cache_discovered(p_scb->PeerAddress(), p_scb->sep_info,
+                              p_scb->num_seps, bta_av_get_all_cap(p_scb));
 
   if (btif_av_src_sink_coexist_enabled()) {
     for (i = 0; i < p_scb->num_seps; i++) {
@@ -1537,6 +1590,8 @@ void bta_av_disc_res_as_acp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_sep_cache_discovered(p_scb->PeerAddress(), p_scb->sep_info,
+                              p_scb->num_seps, bta_av_get_all_cap(p_scb));
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam is a sink, and is audio */
@@ -1587,6 +1642,10 @@ void bta_av_save_caps(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
       p_scb->wait);
   log::verbose("codec: {}", A2DP_CodecInfoString(p_scb->peer_cap.codec_info));
 
+  if (p_scb->peer_cap.num_codec != 0) {
+    bta_av_sep_cache_store(p_scb->PeerAddress(), p_info->seid,
+                           p_scb->peer_cap);
+  }
   cfg = p_scb->peer_cap;
   /* let application know the capability of the SNK */
   if (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -1666,6 +1725,9 @@ void bta_av_open_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   p_scb->open_status = BTA_AV_FAIL_STREAM;
   bta_av_cco_close(p_scb, p_data);
 
+  /* get the capabilities over the air next time, they may be stale */
+  bta_av_sep_cache_remove(p_scb->PeerAddress());
+
   /* check whether there is already an opened audio or video connection with the
    * same device */
   for (idx = 0; (idx < BTA_AV_NUM_STRS) && (!is_av_opened); idx++) {
@@ -1737,6 +1799,11 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   log::verbose("media type 0x{:x}, 0x{:x}", media_type, p_scb->media_type);
   log::verbose("codec: {}", A2DP_CodecInfoString(p_scb->cfg.codec_info));
 
+  if (p_scb->peer_cap.num_codec != 0) {
+    bta_av_sep_cache_store(p_scb->PeerAddress(), p_info->seid,
+                           p_scb->peer_cap);
+  }
+
   /* if codec present and we get a codec configuration */
   if ((p_scb->peer_cap.num_codec != 0) && (media_type == p_scb->media_type) &&
       (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -2221,6 +2288,7 @@ void bta_av_data_path(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
         uint8_t* packet2 =
             (uint8_t*)(p_buf2 + 1) + p_buf2->offset + p_buf2->len;
         memcpy(packet2, data_begin, fragment_len);
+        p_scb->media_bytes_copied += fragment_len;
         p_buf2->len += fragment_len;
         extra_fragments.push_back(p_buf2);
         p_buf->len -= fragment_len;
@@ -2231,6 +2299,7 @@ void bta_av_data_path(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
         m_pt &= ~AVDT_MARKER_SET;
       }
       AVDT_WriteReqOpt(p_scb->avdt_handle, p_buf, timestamp, m_pt, opt);
+      p_scb->media_packets_sent++;
       for (size_t i = 0; i < extra_fragments.size(); i++) {
         if (i + 1 == extra_fragments.size()) {
           // Set the RTP Marker bit for the last fragment
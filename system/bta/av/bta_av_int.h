@@ -546,6 +546,8 @@ struct tBTA_AV_SCB final {
   uint8_t num_recfg;          /* number of reconfigure sent */
   uint8_t role;
   uint8_t l2c_bufs;  /* the number of buffers queued to L2CAP */
+  size_t media_packets_sent;  /* media packets written to AVDTP */
+  size_t media_bytes_copied;  /* media bytes copied before reaching AVDTP */
   uint8_t rc_handle; /* connected AVRCP handle */
   bool use_rc;       /* true if AVRCP is allowed */
   bool started;      /* true if stream started */
@@ -844,6 +846,16 @@ void bta_av_vendor_offload_stop(void);
 void bta_av_st_rc_timer(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_api_set_peer_sep(tBTA_AV_DATA* p_data);
 
+/* SEP capability cache functions */
+void bta_av_sep_cache_discovered(const RawAddress& peer_address,
+                                 const tAVDT_SEP_INFO* sep_info,
+                                 uint8_t num_seps, bool get_all_cap);
+const AvdtpSepConfig* bta_av_sep_cache_find(const RawAddress& peer_address,
+                                            uint8_t seid);
+void bta_av_sep_cache_store(const RawAddress& peer_address, uint8_t seid,
+                            const AvdtpSepConfig& cap);
+void bta_av_sep_cache_remove(const RawAddress& peer_address);
+
 namespace fmt {
 template <>
 struct formatter<tBTA_AV_RS_RES> : enum_formatter<tBTA_AV_RS_RES> {};
@@ -1181,6 +1181,7 @@ void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, BT_HDR* p_buf) {
     /* Enqueue the data */
     BT_HDR* p_new = (BT_HDR*)osi_malloc(copy_size);
     memcpy(p_new, p_buf, copy_size);
+    p_scbi->media_bytes_copied += copy_size;
     list_append(p_scbi->a2dp_list, p_new);
 
     if (list_length(p_scbi->a2dp_list) > p_bta_av_cfg->audio_mqs) {
@@ -1600,6 +1601,11 @@ void bta_debug_av_dump(int fd) {
     dprintf(fd, "    Application ID: %d\n", p_scb->app_id);
     dprintf(fd, "    Role: 0x%x\n", p_scb->role);
     dprintf(fd, "    Queued L2CAP buffers: %d\n", p_scb->l2c_bufs);
+    dprintf(fd, "    Media packets (sent/bytes copied per packet): %zu / %zu\n",
+            p_scb->media_packets_sent,
+            p_scb->media_packets_sent > 0
+                ? p_scb->media_bytes_copied / p_scb->media_packets_sent
+                : 0);
     dprintf(fd, "    AVRCP allowed: %s\n", p_scb->use_rc ? "true" : "false");
     dprintf(fd, "    Stream started: %s\n", p_scb->started ? "true" : "false");
     dprintf(fd, "    Stream call-out started: %d\n", p_scb->co_started);
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/******************************************************************************
+ *
+ *  This file contains the cache of the stream endpoints (SEPs) found on the
+ *  peers, with the capabilities of each SEP. A peer whose discovery results
+ *  match the cached ones gets its capabilities from the cache instead of
+ *  over the air, one AVDTP Get (All) Capabilities per SEP.
+ *
+ *  The cache of each peer is kept in its device section of the config:
+ *
+ *    version (1) | get_all_cap | num_seps | num_seps * SEP
+ *
+ *  where each SEP is seid | tsep | media_type | has_cap, followed when
+ *  has_cap is set by the capabilities, multi-byte fields little endian.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bluetooth-a2dp"
+
+#include <bluetooth/log.h>
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "bta/av/bta_av_int.h"
+#include "btif/include/btif_config.h"
+#include "storage/config_keys.h"
+#include "types/raw_address.h"
+
+using namespace bluetooth;
+
+namespace {
+
+constexpr uint8_t kFormatVersion = 1;
+constexpr size_t kHeaderSize = 3;
+constexpr size_t kSepInfoSize = 4;
+constexpr size_t kCapSize = AVDT_CODEC_SIZE + AVDT_PROTECT_SIZE + 8;
+
+struct CachedSep {
+  uint8_t seid;
+  uint8_t tsep;
+  uint8_t media_type;
+  bool has_cap;
+  AvdtpSepConfig cap;
+};
+
+struct PeerSeps {
+  bool get_all_cap;
+  std::vector<CachedSep> seps;
+};
+
+/* Peers discovered since the stack started */
+std::map<RawAddress, PeerSeps> peer_seps;
+
+std::vector<uint8_t> Serialize(const PeerSeps& peer) {
+  std::vector<uint8_t> blob = {kFormatVersion, peer.get_all_cap,
+                               static_cast<uint8_t>(peer.seps.size())};
+  for (const CachedSep& sep : peer.seps) {
+    blob.insert(blob.end(), {sep.seid, sep.tsep, sep.media_type, sep.has_cap});
+    if (!sep.has_cap) continue;
+    const AvdtpSepConfig& cap = sep.cap;
+    blob.insert(blob.end(), cap.codec_info, cap.codec_info + AVDT_CODEC_SIZE);
+    blob.insert(blob.end(), cap.protect_info,
+                cap.protect_info + AVDT_PROTECT_SIZE);
+    blob.insert(blob.end(),
+                {cap.num_codec, cap.num_protect,
+                 static_cast<uint8_t>(cap.psc_mask & 0xff),
+                 static_cast<uint8_t>(cap.psc_mask >> 8), cap.recov_type,
+                 cap.recov_mrws, cap.recov_mnmp, cap.hdrcmp_mask});
+  }
+  return blob;
+}
+
+bool Deserialize(const std::vector<uint8_t>& blob, PeerSeps* peer) {
+  if (blob.size() < kHeaderSize || blob[0] != kFormatVersion) return false;
+  peer->get_all_cap = blob[1] != 0;
+  peer->seps.clear();
+
+  size_t offset = kHeaderSize;
+  for (uint8_t i = 0; i < blob[2]; i++) {
+    if (blob.size() - offset < kSepInfoSize) return false;
+    CachedSep sep = {
+        .seid = blob[offset],
+        .tsep = blob[offset + 1],
+        .media_type = blob[offset + 2],
+        .has_cap = blob[offset + 3] != 0,
+        .cap = {},
+    };
+    offset += kSepInfoSize;
+    if (sep.has_cap) {
+      if (blob.size() - offset < kCapSize) return false;
+      const uint8_t* p = blob.data() + offset;
+      memcpy(sep.cap.codec_info, p, AVDT_CODEC_SIZE);
+      p += AVDT_CODEC_SIZE;
+      memcpy(sep.cap.protect_info, p, AVDT_PROTECT_SIZE);
+      p += AVDT_PROTECT_SIZE;
+      sep.cap.num_codec = p[0];
+      sep.cap.num_protect = p[1];
+      sep.cap.psc_mask = p[2] | (p[3] << 8);
+      sep.cap.recov_type = p[4];
+      sep.cap.recov_mrws = p[5];
+      sep.cap.recov_mnmp = p[6];
+      sep.cap.hdrcmp_mask = p[7];
+      offset += kCapSize;
+    }
+    peer->seps.push_back(sep);
+  }
+  return offset == blob.size();
+}
+
+bool Load(const RawAddress& peer_address, PeerSeps* peer) {
+  std::string section = peer_address.ToString();
+  size_t length =
+      btif_config_get_bin_length(section, BTIF_STORAGE_KEY_AVDTP_SEP_CACHE);
+  if (length == 0) return false;
+  std::vector<uint8_t> blob(length);
+  if (!btif_config_get_bin(section, BTIF_STORAGE_KEY_AVDTP_SEP_CACHE,
+                           blob.data(), &length)) {
+    return false;
+  }
+  blob.resize(length);
+  return Deserialize(blob, peer);
+}
+
+void Save(const RawAddress& peer_address, const PeerSeps& peer) {
+  std::vector<uint8_t> blob = Serialize(peer);
+  if (!btif_config_set_bin(peer_address.ToString(),
+                           BTIF_STORAGE_KEY_AVDTP_SEP_CACHE, blob.data(),
+                           blob.size())) {
+    log::warn("Failed to store the SEP cache of {}", peer_address);
+  }
+}
+
+bool SameCap(const AvdtpSepConfig& a, const AvdtpSepConfig& b) {
+  return !memcmp(a.codec_info, b.codec_info, AVDT_CODEC_SIZE) &&
+         !memcmp(a.protect_info, b.protect_info, AVDT_PROTECT_SIZE) &&
+         a.num_codec == b.num_codec && a.num_protect == b.num_protect &&
+         a.psc_mask == b.psc_mask && a.recov_type == b.recov_type &&
+         a.recov_mrws == b.recov_mrws && a.recov_mnmp == b.recov_mnmp &&
+         a.hdrcmp_mask == b.hdrcmp_mask;
+}
+
+bool SameSeps(const PeerSeps& peer, const tAVDT_SEP_INFO* sep_info,
+              uint8_t num_seps) {
+  if (peer.seps.size() != num_seps) return false;
+  for (uint8_t i = 0; i < num_seps; i++) {
+    if (peer.seps[i].seid != sep_info[i].seid ||
+        peer.seps[i].tsep != sep_info[i].tsep ||
+        peer.seps[i].media_type != sep_info[i].media_type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void bta_av_sep_cache_discovered(const RawAddress& peer_address,
+                                 const tAVDT_SEP_INFO* sep_info,
+                                 uint8_t num_seps, bool get_all_cap) {
+  auto it = peer_seps.find(peer_address);
+  if (it == peer_seps.end()) {
+    PeerSeps loaded;
+    if (Load(peer_address, &loaded)) {
+      it = peer_seps.emplace(peer_address, std::move(loaded)).first;
+    }
+  }
+  if (it != peer_seps.end() && it->second.get_all_cap == get_all_cap &&
+      SameSeps(it->second, sep_info, num_seps)) {
+    log::verbose("peer {} has the {} cached SEPs", peer_address, num_seps);
+    return;
+  }
+
+  if (it != peer_seps.end()) {
+    log::info("peer {} SEPs changed, dropping the cached capabilities",
+              peer_address);
+  }
+  PeerSeps& peer = peer_seps[peer_address];
+  peer.get_all_cap = get_all_cap;
+  peer.seps.clear();
+  for (uint8_t i = 0; i < num_seps; i++) {
+    peer.seps.push_back({
+        .seid = sep_info[i].seid,
+        .tsep = sep_info[i].tsep,
+        .media_type = sep_info[i].media_type,
+        .has_cap = false,
+        .cap = {},
+    });
+  }
+}
+
+const AvdtpSepConfig* bta_av_sep_cache_find(const RawAddress& peer_address,
+                                            uint8_t seid) {
+  auto it = peer_seps.find(peer_address);
+  if (it == peer_seps.end()) return nullptr;
+  for (const CachedSep& sep : it->second.seps) {
+    if (sep.seid == seid) return sep.has_cap ? &sep.cap : nullptr;
+  }
+  return nullptr;
+}
+
+void bta_av_sep_cache_store(const RawAddress& peer_address, uint8_t seid,
+                            const AvdtpSepConfig& cap) {
+  auto it = peer_seps.find(peer_address);
+  if (it == peer_seps.end()) return;
+  for (CachedSep& sep : it->second.seps) {
+    if (sep.seid != seid) continue;
+    // Capabilities replayed from the cache come back here unchanged
+    if (sep.has_cap && SameCap(sep.cap, cap)) return;
+    sep.has_cap = true;
+    sep.cap = cap;
+    Save(peer_address, it->second);
+    return;
+  }
+}
+
+void bta_av_sep_cache_remove(const RawAddress& peer_address) {
+  peer_seps.erase(peer_address);
+  btif_config_remove(peer_address.ToString(), BTIF_STORAGE_KEY_AVDTP_SEP_CACHE);
+}
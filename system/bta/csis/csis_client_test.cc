@@ -1008,6 +1008,32 @@ TEST_F(CsisClientTest, test_is_device_in_the_group) {
   g_1->IsDeviceInTheGroup(d_1);
 }
 
+TEST_F(CsisClientTest, test_rsi_match_follows_sirk_change) {
+  auto g_1 = std::make_shared<CsisGroup>(666, bluetooth::Uuid::kEmpty);
+  Octet16 sirk;
+  sirk.fill(0x01);
+  g_1->SetSirk(sirk);
+
+  /* RSI hash = 3 LSO of E(SIRK, prand) */
+  Octet16 prand{};
+  prand[0] = 0x42;
+  Octet16 x = crypto_toolbox::aes_128(sirk, prand);
+  const uint8_t rsi_bytes[RawAddress::kLength] = {0x00, 0x00, 0x42,
+                                                  x[2], x[1],  x[0]};
+  RawAddress rsi(rsi_bytes);
+
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+
+  Octet16 other_sirk;
+  other_sirk.fill(0x02);
+  g_1->SetSirk(other_sirk);
+  ASSERT_FALSE(g_1->IsRsiMatching(rsi));
+
+  g_1->SetSirk(sirk);
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+}
+
 TEST_F(CsisClientTest, test_get_current_size) {
   const RawAddress test_address_1 = GetTestAddress(0);
   const RawAddress test_address_2 = GetTestAddress(1);
@@ -29,6 +29,7 @@
 #include "bta_groups.h"
 #include "btif/include/btif_storage.h"
 #include "common/init_flags.h"
+#include "common/lru.h"
 #include "common/strings.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "gap_api.h"
@@ -73,6 +74,8 @@ struct hdl_pair {
 static constexpr uint8_t kDefaultScanDurationS = 5;
 static constexpr uint8_t kDefaultCsisSetSize = 1;
 static constexpr uint8_t kUnknownRank = 0xff;
+/* RSIs, per group, whose match against the group SIRK is remembered */
+static constexpr size_t kRsiMatchCacheSize = 64;
 
 /* Enums */
 enum class CsisLockState : uint8_t {
@@ -366,8 +369,15 @@ class CsisGroup {
                       CsisDevice::MatchAddress(csis_device->addr));
     return (it != devices_.end());
   }
+  /* Devices advertise the same RSI until their address rotates, so the result
+   * of the AES based hash is kept for each RSI, matching or not, until the
+   * SIRK changes */
   bool IsRsiMatching(const RawAddress& rsi) const {
-    return is_rsi_match_sirk(rsi, GetSirk());
+    bool is_matching;
+    if (rsi_match_cache_.Get(rsi, &is_matching)) return is_matching;
+    is_matching = is_rsi_match_sirk(rsi, GetSirk());
+    rsi_match_cache_.Put(rsi, is_matching);
+    return is_matching;
   }
   bool IsSirkBelongsToGroup(Octet16 sirk) const {
     return (sirk_available_ && sirk_ == sirk);
@@ -379,6 +389,7 @@ class CsisGroup {
     }
     sirk_available_ = true;
     sirk_ = sirk;
+    rsi_match_cache_.Clear();
   }
 
   int GetNumOfConnectedDevices(void) {
@@ -543,6 +554,8 @@ class CsisGroup {
   int group_id_;
   Octet16 sirk_ = {0};
   bool sirk_available_ = false;
+  mutable bluetooth::common::LegacyLruCache<RawAddress, bool> rsi_match_cache_{
+      kRsiMatchCacheSize, "CsisRsiMatchCache"};
   int size_;
   bluetooth::Uuid uuid_;
 
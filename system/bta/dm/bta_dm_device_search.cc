@@ -24,6 +24,7 @@
 #include <com_android_bluetooth_flags.h>
 #include <stddef.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <variant>
@@ -38,6 +39,7 @@
 #include "common/circular_buffer.h"
 #include "common/init_flags.h"
 #include "common/strings.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "internal_include/bt_target.h"
 #include "main/shim/dumpsys.h"
@@ -66,6 +68,14 @@ namespace {
 constexpr char kBtmLogTag[] = "DEV_SEARCH";
 
 tBTA_DM_SEARCH_CB bta_dm_search_cb;
+
+/* Device discovery timing reported in dumpsys */
+struct {
+  uint64_t start_ms;
+  uint64_t last_duration_ms;
+  size_t names_requested;
+  size_t names_skipped;
+} search_stats_;
 }  // namespace
 
 static void bta_dm_inq_results_cb(tBTM_INQ_RESULTS* p_inq, const uint8_t* p_eir,
@@ -130,6 +140,11 @@ static void bta_dm_search_start(tBTA_DM_API_SEARCH& search) {
   }
   /* save search params */
   bta_dm_search_cb.p_device_search_cback = search.p_cback;
+  bta_dm_search_cb.name_discovery_queue.clear();
+
+  search_stats_.start_ms = bluetooth::common::time_get_os_boottime_ms();
+  search_stats_.names_requested = 0;
+  search_stats_.names_skipped = 0;
 
   const tBTM_STATUS btm_status =
       BTM_StartInquiry(bta_dm_inq_results_cb, bta_dm_inq_cmpl_cb);
@@ -340,6 +355,65 @@ static bool bta_dm_read_remote_device_name(const RawAddress& bd_addr,
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_build_name_discovery_queue
+ *
+ * Description      Orders the inquiry results for name discovery. Devices
+ *                  whose name is already known are left out, the rest are
+ *                  paged strongest first so the names users are most likely
+ *                  to pick from show up early. Devices of equal signal keep
+ *                  the inquiry database order.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_build_name_discovery_queue() {
+  std::vector<const tBTM_INQ_INFO*> candidates;
+  for (tBTM_INQ_INFO* p_inq = get_btm_client_interface().db.BTM_InqDbFirst();
+       p_inq != nullptr;
+       p_inq = get_btm_client_interface().db.BTM_InqDbNext(p_inq)) {
+    if (p_inq->appl_knows_rem_name ||
+        p_inq->results.device_type == BT_DEVICE_TYPE_BLE) {
+      /* Do not perform RNR for LE devices at inquiry complete */
+      search_stats_.names_skipped++;
+      continue;
+    }
+    candidates.push_back(p_inq);
+  }
+
+  auto rssi = [](const tBTM_INQ_INFO* p_inq) -> int {
+    return p_inq->results.rssi == BTM_INQ_RES_IGNORE_RSSI
+               ? INT8_MIN
+               : p_inq->results.rssi;
+  };
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [&rssi](const tBTM_INQ_INFO* a, const tBTM_INQ_INFO* b) {
+                     return rssi(a) > rssi(b);
+                   });
+
+  bta_dm_search_cb.name_discovery_queue.clear();
+  for (const tBTM_INQ_INFO* p_inq : candidates) {
+    bta_dm_search_cb.name_discovery_queue.push_back(
+        p_inq->results.remote_bd_addr);
+  }
+}
+
+/* Pops the next device to discover the name of, returns false when done */
+static bool bta_dm_pop_name_discovery_queue() {
+  while (!bta_dm_search_cb.name_discovery_queue.empty()) {
+    const RawAddress bd_addr = bta_dm_search_cb.name_discovery_queue.front();
+    bta_dm_search_cb.name_discovery_queue.pop_front();
+    bta_dm_search_cb.p_btm_inq_info =
+        get_btm_client_interface().db.BTM_InqDbRead(bd_addr);
+    if (bta_dm_search_cb.p_btm_inq_info != nullptr) {
+      return true;
+    }
+  }
+  bta_dm_search_cb.p_btm_inq_info = nullptr;
+  return false;
+}
+
 /*******************************************************************************
  *
  * Function         bta_dm_inq_cmpl
@@ -362,9 +436,8 @@ static void bta_dm_inq_cmpl() {
 
   log::verbose("bta_dm_inq_cmpl");
 
-  bta_dm_search_cb.p_btm_inq_info =
-      get_btm_client_interface().db.BTM_InqDbFirst();
-  if (bta_dm_search_cb.p_btm_inq_info != NULL) {
+  bta_dm_build_name_discovery_queue();
+  if (bta_dm_pop_name_discovery_queue()) {
     /* start name discovery from the first device on inquiry result
      */
     bta_dm_search_cb.name_discover_done = false;
@@ -418,6 +491,13 @@ static void bta_dm_remote_name_cmpl(
 
 static void bta_dm_search_cmpl() {
   bta_dm_search_set_state(BTA_DM_SEARCH_IDLE);
+  bta_dm_search_cb.name_discovery_queue.clear();
+
+  if (search_stats_.start_ms != 0) {
+    search_stats_.last_duration_ms =
+        bluetooth::common::time_get_os_boottime_ms() - search_stats_.start_ms;
+    search_stats_.start_ms = 0;
+  }
 
   if (bta_dm_search_cb.p_device_search_cback) {
     bta_dm_search_cb.p_device_search_cback(BTA_DM_DISC_CMPL_EVT, nullptr);
@@ -490,9 +570,7 @@ static void bta_dm_discover_next_device(void) {
   log::verbose("bta_dm_discover_next_device");
 
   /* searching next device on inquiry result */
-  bta_dm_search_cb.p_btm_inq_info = get_btm_client_interface().db.BTM_InqDbNext(
-      bta_dm_search_cb.p_btm_inq_info);
-  if (bta_dm_search_cb.p_btm_inq_info != NULL) {
+  if (bta_dm_pop_name_discovery_queue()) {
     bta_dm_search_cb.name_discover_done = false;
     bta_dm_search_cb.peer_name[0] = 0;
     bta_dm_discover_name(
@@ -558,6 +636,7 @@ static void bta_dm_discover_name(const RawAddress& remote_bd_addr) {
     log::debug(
         "Security record already known skipping read remote name peer:{}",
         remote_bd_addr);
+    if (!bta_dm_search_cb.name_discover_done) search_stats_.names_skipped++;
     bta_dm_search_cb.name_discover_done = true;
   }
 
@@ -568,6 +647,7 @@ static void bta_dm_discover_name(const RawAddress& remote_bd_addr) {
         (!bta_dm_search_cb.p_btm_inq_info->appl_knows_rem_name)))) {
     if (bta_dm_read_remote_device_name(bta_dm_search_cb.peer_bdaddr,
                                        transport)) {
+      search_stats_.names_requested++;
       BTM_LogHistory(kBtmLogTag, bta_dm_search_cb.peer_bdaddr,
                      "Read remote name",
                      base::StringPrintf("Transport:%s",
@@ -1005,6 +1085,12 @@ void DumpsysBtaDmSearch(int fd) {
   }
   LOG_DUMPSYS(fd, " current bta_dm_search_state:%s",
               bta_dm_state_text(bta_dm_search_get_state()).c_str());
+  LOG_DUMPSYS(fd,
+              " last discovery duration:%llu ms remote names requested:%zu "
+              "skipped:%zu pending:%zu",
+              (unsigned long long)search_stats_.last_duration_ms,
+              search_stats_.names_requested, search_stats_.names_skipped,
+              bta_dm_search_cb.name_discovery_queue.size());
 }
 #undef DUMPSYS_TAG
 
@@ -19,6 +19,7 @@
 #include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 
+#include <deque>
 #include <string>
 
 #include "bta/include/bta_api.h"
@@ -89,6 +90,8 @@ typedef struct {
   BD_NAME peer_name;
   std::unique_ptr<tBTA_DM_SEARCH_MSG> p_pending_search;
   tBTA_DM_SEARCH_CBACK* p_csis_scan_cback;
+  /* inquiry results still waiting for name discovery, in request order */
+  std::deque<RawAddress> name_discovery_queue;
 } tBTA_DM_SEARCH_CB;
 
 namespace fmt {
@@ -322,6 +322,7 @@ void bta_dm_ble_get_energy_info(tBTA_BLE_ENERGY_INFO_CBACK*);
 
 void bta_dm_init_pm(void);
 void bta_dm_disable_pm(void);
+void DumpsysBtaDmPm(int fd);
 
 uint8_t bta_dm_get_av_count(void);
 tBTA_DM_PEER_DEVICE* bta_dm_find_peer_device(const RawAddress& peer_addr);
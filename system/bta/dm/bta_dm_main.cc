@@ -43,5 +43,6 @@ void DumpsysBtaDm(int fd) {
   DumpsysBtaDmDisc(fd);
   DumpsysBtaDmSearch(fd);
   DumpsysBtaDmGattClient(fd);
+  DumpsysBtaDmPm(fd);
 }
 #undef DUMPSYS_TAG
@@ -26,8 +26,10 @@
 #include <base/functional/bind.h>
 #include <bluetooth/log.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "bta/dm/bta_dm_int.h"
@@ -36,6 +38,7 @@
 #include "bta/sys/bta_sys.h"
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager_t.h"
+#include "common/time_util.h"
 #include "hci/controller_interface.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/entry.h"
@@ -88,6 +91,46 @@ static const char kPropertySniffAttempts[] =
     "bluetooth.core.classic.sniff_attempts";
 static const char kPropertySniffTimeouts[] =
     "bluetooth.core.classic.sniff_timeouts";
+static const char kPropertyAdaptiveSniff[] =
+    "bluetooth.bta.dm.pm.adaptive_sniff.enabled";
+
+/* Adaptive sniff policy. The idle periods of a link, from the last service
+ * going idle to the next one going busy, are averaged. The idle timeout from
+ * the power mode tables is then stretched when traffic usually resumes
+ * shortly after the link would have entered sniff, and shortened when the
+ * link usually stays idle for much longer than the timeout. */
+namespace {
+constexpr uint32_t kPmMinIdleSamples = 4;
+constexpr uint64_t kPmMaxIdleSampleMs = 60000;
+/* Shortest stay in sniff worth the cost of exiting it again */
+constexpr uint64_t kPmMinSniffDwellMs = 2000;
+constexpr uint64_t kPmIdleMarginMs = 500;
+constexpr uint64_t kPmMinIdleTimeoutMs = 1000;
+
+struct PmLinkStats {
+  uint64_t idle_since_ms = 0;
+  uint64_t predicted_idle_ms = 0;
+  uint32_t idle_samples = 0;
+
+  bool in_sniff = false;
+  uint64_t sniff_entered_ms = 0;
+  uint32_t sniff_entries = 0;
+  uint32_t sniff_exits = 0;
+  /* Exits from sniff before kPmMinSniffDwellMs elapsed */
+  uint32_t short_sniffs = 0;
+  uint32_t timeouts_extended = 0;
+  uint32_t timeouts_shortened = 0;
+
+  /* From requesting active mode while in sniff to the mode change */
+  uint64_t wakeup_requested_ms = 0;
+  uint32_t wakeups = 0;
+  uint64_t wakeup_latency_sum_ms = 0;
+  uint64_t wakeup_latency_max_ms = 0;
+};
+
+bool pm_adaptive_sniff_enabled = false;
+std::unordered_map<RawAddress, PmLinkStats> pm_link_stats;
+}  // namespace
 
 /*******************************************************************************
  *
@@ -101,6 +144,9 @@ static const char kPropertySniffTimeouts[] =
  ******************************************************************************/
 void bta_dm_init_pm(void) {
   memset(&bta_dm_conn_srvcs, 0x00, sizeof(bta_dm_conn_srvcs));
+  pm_link_stats.clear();
+  pm_adaptive_sniff_enabled =
+      osi_property_get_bool(kPropertyAdaptiveSniff, false);
 
   /* if there are no power manger entries, so not register */
   if (p_bta_dm_pm_cfg[0].app_id != 0) {
@@ -424,6 +470,94 @@ static void bta_dm_sniff_cback(uint8_t id, uint8_t app_id,
  * Returns          void
  *
  ******************************************************************************/
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_track_traffic
+ *
+ * Description      Records the start and end of the idle periods of a link
+ *                  from the busy and idle reports of its services.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_pm_track_traffic(tBTA_SYS_CONN_STATUS status,
+                                    const RawAddress& peer_addr) {
+  const uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  PmLinkStats& stats = pm_link_stats[peer_addr];
+
+  switch (status) {
+    case BTA_SYS_CONN_IDLE:
+      if (stats.idle_since_ms == 0) stats.idle_since_ms = now_ms;
+      break;
+    case BTA_SYS_CONN_BUSY:
+    case BTA_SYS_SCO_OPEN:
+      if (stats.idle_since_ms != 0) {
+        const uint64_t idle_ms =
+            std::min(now_ms - stats.idle_since_ms, kPmMaxIdleSampleMs);
+        stats.predicted_idle_ms =
+            stats.idle_samples == 0
+                ? idle_ms
+                : (3 * stats.predicted_idle_ms + idle_ms) / 4;
+        stats.idle_samples++;
+        stats.idle_since_ms = 0;
+      }
+      break;
+    case BTA_SYS_CONN_CLOSE: {
+      /* Forget the link once its last service closes */
+      uint8_t open_services = 0;
+      for (uint8_t i = 0; i < bta_dm_conn_srvcs.count; i++) {
+        if (bta_dm_conn_srvcs.conn_srvc[i].peer_bdaddr == peer_addr) {
+          open_services++;
+        }
+      }
+      if (open_services <= 1) {
+        pm_link_stats.erase(peer_addr);
+      } else {
+        stats.idle_since_ms = 0;
+      }
+    } break;
+    default:
+      break;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_adapt_sniff_timeout
+ *
+ * Description      Adjusts the idle timeout before entering sniff mode with
+ *                  the idle period predicted for the link.
+ *
+ * Returns          timeout to use, in milliseconds
+ *
+ ******************************************************************************/
+static uint64_t bta_dm_pm_adapt_sniff_timeout(const RawAddress& peer_addr,
+                                              uint64_t timeout_ms) {
+  if (!pm_adaptive_sniff_enabled) return timeout_ms;
+
+  auto it = pm_link_stats.find(peer_addr);
+  if (it == pm_link_stats.end() ||
+      it->second.idle_samples < kPmMinIdleSamples) {
+    return timeout_ms;
+  }
+  PmLinkStats& stats = it->second;
+  const uint64_t predicted_ms = stats.predicted_idle_ms;
+
+  if (predicted_ms > timeout_ms &&
+      predicted_ms < timeout_ms + kPmMinSniffDwellMs) {
+    /* Traffic usually resumes right after sniff would be entered */
+    stats.timeouts_extended++;
+    return std::min(predicted_ms + kPmIdleMarginMs, 2 * timeout_ms);
+  }
+  if (predicted_ms >= 4 * timeout_ms) {
+    const uint64_t shortened_ms =
+        std::max(timeout_ms / 2, std::min(timeout_ms, kPmMinIdleTimeoutMs));
+    if (shortened_ms < timeout_ms) stats.timeouts_shortened++;
+    return shortened_ms;
+  }
+  return timeout_ms;
+}
+
 static void bta_dm_pm_cback(tBTA_SYS_CONN_STATUS status, const tBTA_SYS_ID id,
                             uint8_t app_id, const RawAddress& peer_addr) {
   uint8_t i, j;
@@ -450,6 +584,8 @@ static void bta_dm_pm_cback(tBTA_SYS_CONN_STATUS status, const tBTA_SYS_ID id,
     return;
   }
 
+  bta_dm_pm_track_traffic(status, peer_addr);
+
   log::verbose("Stopped all timers for service to device:{} id:{}[{}]",
                peer_addr, BtaIdSysText(id), id);
   bta_dm_pm_stop_timer_by_srvc_id(peer_addr, static_cast<uint8_t>(id));
@@ -688,6 +824,9 @@ static void bta_dm_pm_set_mode(const RawAddress& peer_addr,
   }
   /* if need to start a timer */
   if ((pm_req != BTA_DM_PM_EXECUTE) && (timeout_ms > 0)) {
+    if (pm_action & BTA_DM_PM_SNIFF) {
+      timeout_ms = bta_dm_pm_adapt_sniff_timeout(peer_addr, timeout_ms);
+    }
     for (i = 0; i < BTA_DM_NUM_PM_TIMER; i++) {
       if (bta_dm_cb.pm_timer[i].in_use &&
           bta_dm_cb.pm_timer[i].peer_bdaddr == peer_addr) {
@@ -1003,6 +1142,13 @@ void bta_dm_pm_active(const RawAddress& peer_addr) {
       .mode = BTM_PM_MD_ACTIVE,
   };
 
+  auto it = pm_link_stats.find(peer_addr);
+  if (it != pm_link_stats.end() && it->second.in_sniff &&
+      it->second.wakeup_requested_ms == 0) {
+    it->second.wakeup_requested_ms =
+        bluetooth::common::time_get_os_boottime_ms();
+  }
+
   /* switch to active mode */
   tBTM_STATUS status = get_btm_client_interface().link_policy.BTM_SetPowerMode(
       bta_dm_cb.pm_id, peer_addr, &pm);
@@ -1078,6 +1224,33 @@ static void bta_dm_pm_timer_cback(void* data) {
                      bta_dm_cb.pm_timer[i].pm_action[j]));
 }
 
+/* Counts the sniff transitions of a link and the time it takes to wake up */
+static void bta_dm_pm_track_mode(const RawAddress& bd_addr,
+                                 tBTM_PM_STATUS status) {
+  const uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  PmLinkStats& stats = pm_link_stats[bd_addr];
+
+  if (status == BTM_PM_STS_SNIFF && !stats.in_sniff) {
+    stats.in_sniff = true;
+    stats.sniff_entered_ms = now_ms;
+    stats.sniff_entries++;
+  } else if (status == BTM_PM_STS_ACTIVE && stats.in_sniff) {
+    stats.in_sniff = false;
+    stats.sniff_exits++;
+    if (now_ms - stats.sniff_entered_ms < kPmMinSniffDwellMs) {
+      stats.short_sniffs++;
+    }
+    if (stats.wakeup_requested_ms != 0) {
+      const uint64_t latency_ms = now_ms - stats.wakeup_requested_ms;
+      stats.wakeups++;
+      stats.wakeup_latency_sum_ms += latency_ms;
+      stats.wakeup_latency_max_ms =
+          std::max(stats.wakeup_latency_max_ms, latency_ms);
+      stats.wakeup_requested_ms = 0;
+    }
+  }
+}
+
 /** Process pm status event from btm */
 static void bta_dm_pm_btm_status(const RawAddress& bd_addr,
                                  tBTM_PM_STATUS status, uint16_t interval,
@@ -1094,6 +1267,10 @@ static void bta_dm_pm_btm_status(const RawAddress& bd_addr,
     return;
   }
 
+  if (hci_status == HCI_SUCCESS) {
+    bta_dm_pm_track_mode(bd_addr, status);
+  }
+
   /* check new mode */
   switch (status) {
     case BTM_PM_STS_ACTIVE:
@@ -1242,3 +1419,28 @@ tBTM_CONTRL_STATE bta_dm_pm_obtain_controller_state(void) {
   log::verbose("bta_dm_pm_obtain_controller_state: {}", cur_state);
   return cur_state;
 }
+
+#define DUMPSYS_TAG "shim::legacy::bta::dm::pm"
+void DumpsysBtaDmPm(int fd) {
+  LOG_DUMPSYS(fd, " adaptive sniff:%s links:%zu",
+              pm_adaptive_sniff_enabled ? "enabled" : "disabled",
+              pm_link_stats.size());
+  for (const auto& [bd_addr, stats] : pm_link_stats) {
+    LOG_DUMPSYS(fd,
+                "   peer:%s predicted_idle:%llums samples:%u sniff:%s "
+                "entries:%u exits:%u short:%u extended:%u shortened:%u",
+                ADDRESS_TO_LOGGABLE_CSTR(bd_addr),
+                (unsigned long long)stats.predicted_idle_ms,
+                stats.idle_samples, stats.in_sniff ? "true" : "false",
+                stats.sniff_entries, stats.sniff_exits, stats.short_sniffs,
+                stats.timeouts_extended, stats.timeouts_shortened);
+    if (stats.wakeups != 0) {
+      LOG_DUMPSYS(fd, "     wakeups:%u avg_latency:%llums max_latency:%llums",
+                  stats.wakeups,
+                  (unsigned long long)(stats.wakeup_latency_sum_ms /
+                                       stats.wakeups),
+                  (unsigned long long)stats.wakeup_latency_max_ms);
+    }
+  }
+}
+#undef DUMPSYS_TAG
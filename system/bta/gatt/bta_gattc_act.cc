@@ -1552,9 +1552,12 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
 }
 
 /** process all non-service change indication/notification */
+/* The event is filled in place and handed to the application as is, so the
+ * value is copied only once on its way from the stack */
 static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
                                             tGATT_CL_COMPLETE* p_data,
-                                            tBTA_GATTC_NOTIFY* p_notify) {
+                                            tBTA_GATTC* p_event) {
+  tBTA_GATTC_NOTIFY* p_notify = &p_event->notify;
   log::verbose("check p_data->att_value.handle={} p_data->handle={}",
                p_data->att_value.handle, p_data->handle);
   log::verbose("is_notify {}", p_notify->is_notify);
@@ -1566,9 +1569,7 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
   p_notify->conn_id = p_clcb->bta_conn_id;
 
   if (p_clcb->p_rcb->p_cback) {
-    tBTA_GATTC bta_gattc;
-    bta_gattc.notify = *p_notify;
-    (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, &bta_gattc);
+    (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, p_event);
   }
 }
 
@@ -1576,7 +1577,8 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
 static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
                                        tGATT_CL_COMPLETE* p_data) {
   uint16_t handle = p_data->att_value.handle;
-  tBTA_GATTC_NOTIFY notify;
+  tBTA_GATTC event;
+  tBTA_GATTC_NOTIFY& notify = event.notify;
   RawAddress remote_bda;
   tGATT_IF gatt_if;
   tBT_TRANSPORT transport;
@@ -1650,7 +1652,7 @@ static void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
     }
 
     if (p_clcb != NULL)
-      bta_gattc_proc_other_indication(p_clcb, op, p_data, &notify);
+      bta_gattc_proc_other_indication(p_clcb, op, p_data, &event);
   }
   /* no one intersted and need ack? */
   else if (op == GATTC_OPTYPE_INDICATION) {
@@ -304,6 +304,23 @@ const std::list<gatt::Service>* BTA_GATTC_GetServices(uint16_t conn_id) {
   return bta_gattc_get_services(conn_id);
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_GetDatabaseHash
+ *
+ * Description      This function is called to compute the hash of the GATT
+ *                  database discovered on the given server.
+ *
+ * Parameters       conn_id - connection ID which identify the server.
+ *                  p_hash - receives the database hash
+ *
+ * Returns          false if the server database is not discovered.
+ *
+ ******************************************************************************/
+bool BTA_GATTC_GetDatabaseHash(uint16_t conn_id, Octet16* p_hash) {
+  return bta_gattc_get_database_hash(conn_id, p_hash);
+}
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_GetCharacteristic
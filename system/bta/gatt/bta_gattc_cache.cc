@@ -42,6 +42,7 @@
 #include "internal_include/bt_trace.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/bt_uuid16.h"
@@ -83,6 +84,9 @@ static void bta_gattc_read_ext_prop_desc_cmpl(tBTA_GATTC_CLCB* p_clcb,
 
 #define BTA_GATT_SDP_DB_SIZE 4096
 
+constexpr char kPropertyMergeDescriptorRanges[] =
+    "bluetooth.gatt.discovery.merge_descriptor_ranges.enabled";
+
 /*****************************************************************************
  *  Constants and data types
  ****************************************************************************/
@@ -331,8 +335,14 @@ void bta_gattc_start_disc_char_dscp(uint16_t conn_id,
                                     tBTA_GATTC_SERV* p_srvc_cb) {
   log::verbose("starting discover characteristics descriptor");
 
+  // One Find Information procedure per service instead of one per
+  // characteristic saves most of the descriptor discovery round trips
+  static const bool merge_ranges =
+      osi_property_get_bool(kPropertyMergeDescriptorRanges, true);
   std::pair<uint16_t, uint16_t> range =
-      p_srvc_cb->pending_discovery.NextDescriptorRangeToExplore();
+      merge_ranges
+          ? p_srvc_cb->pending_discovery.NextMergedDescriptorRangeToExplore()
+          : p_srvc_cb->pending_discovery.NextDescriptorRangeToExplore();
   if (range == DatabaseBuilder::EXPLORE_END) {
     goto descriptor_discovery_done;
   }
@@ -627,33 +637,37 @@ const std::list<Service>* bta_gattc_get_services(uint16_t conn_id) {
   return bta_gattc_get_services_srcb(p_srcb);
 }
 
+bool bta_gattc_get_database_hash(uint16_t conn_id, Octet16* p_hash) {
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
+
+  if (p_clcb == NULL || p_clcb->p_srcb == NULL) return false;
+
+  tBTA_GATTC_SERV* p_srcb = p_clcb->p_srcb;
+  if (p_srcb->gatt_database.IsEmpty()) return false;
+
+  *p_hash = p_srcb->gatt_database.Hash();
+  return true;
+}
+
 const Service* bta_gattc_get_service_for_handle_srcb(tBTA_GATTC_SERV* p_srcb,
                                                      uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services_srcb(p_srcb);
-  if (services == NULL) return NULL;
-  return bta_gattc_find_matching_service(*services, handle);
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindServiceForHandle(handle);
 }
 
 const Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
                                                 uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services(conn_id);
-  if (services == NULL) return NULL;
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
 
-  return bta_gattc_find_matching_service(*services, handle);
+  if (p_clcb == NULL) return NULL;
+
+  return bta_gattc_get_service_for_handle_srcb(p_clcb->p_srcb, handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                         uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    if (handle == charac.value_handle) return &charac;
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
@@ -668,20 +682,8 @@ const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
 
 const Descriptor* bta_gattc_get_descriptor_srcb(tBTA_GATTC_SERV* p_srcb,
                                                 uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
-    return NULL;
-  }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &desc;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindDescriptor(handle);
 }
 
 const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
@@ -695,18 +697,8 @@ const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
 
 const Characteristic* bta_gattc_get_owning_characteristic_srcb(
     tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &charac;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindOwningCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id,
@@ -21,9 +21,14 @@
 #include <base/strings/string_number_conversions.h>
 #include <bluetooth/log.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "bta/gatt/bta_gattc_int.h"
@@ -34,13 +39,15 @@
 
 using namespace bluetooth;
 
+using bluetooth::Uuid;
 using gatt::StoredAttribute;
 using std::string;
 using std::vector;
 
 #ifdef TARGET_FLOSS
 #define GATT_CACHE_PREFIX "/var/lib/bluetooth/gatt/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
+#define GATT_CACHE_LEGACY_VERSION 6
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/var/lib/bluetooth/gatt/gatt_hash_"
@@ -48,7 +55,8 @@ using std::vector;
 #define GATT_HASH_FILE_PREFIX "gatt_hash_"
 #else
 #define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
+#define GATT_CACHE_LEGACY_VERSION 6
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/data/misc/bluetooth/gatt_hash_"
@@ -76,11 +84,40 @@ static void bta_gattc_generate_hash_file_name(char* buffer, size_t buffer_len,
 
 static gatt::Database EMPTY_DB;
 
+/*******************************************************************************
+ *
+ * Function         bta_gattc_parse_legacy_db
+ *
+ * Description      Parse GATT database stored as one StoredAttribute per
+ *                  record, as written before the compact format.
+ *
+ * Parameter        data: file content, starting with the cache version
+ *                  len: length of the file content
+ *                  attr: parsed attributes
+ *
+ * Returns          true on success, false otherwise
+ *
+ ******************************************************************************/
+static bool bta_gattc_parse_legacy_db(const uint8_t* data, size_t len,
+                                      std::vector<StoredAttribute>& attr) {
+  constexpr size_t header_size = 2 * sizeof(uint16_t);
+  if (len < header_size) return false;
+
+  uint16_t num_attr = 0;
+  memcpy(&num_attr, data + sizeof(uint16_t), sizeof(uint16_t));
+  if (len - header_size < num_attr * sizeof(StoredAttribute)) return false;
+
+  attr.resize(num_attr);
+  memcpy(attr.data(), data + header_size, num_attr * sizeof(StoredAttribute));
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_load_db
  *
- * Description      Load GATT database from storage.
+ * Description      Load GATT database from storage. The file is mapped and
+ *                  parsed in place, without an intermediate copy.
  *
  * Parameter        fname: input file name
  *
@@ -89,48 +126,51 @@ static gatt::Database EMPTY_DB;
  *
  ******************************************************************************/
 static gatt::Database bta_gattc_load_db(const char* fname) {
-  FILE* fd = fopen(fname, "rb");
-  if (!fd) {
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     log::error("can't open GATT cache file {} for reading, error: {}", fname,
                strerror(errno));
     return EMPTY_DB;
   }
 
-  uint16_t cache_ver = 0;
-  uint16_t num_attr = 0;
-
-  if (fread(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(uint16_t)) {
     log::error("can't read GATT cache version from: {}", fname);
-    goto done;
-  }
-
-  if (cache_ver != GATT_CACHE_VERSION) {
-    log::error("wrong GATT cache version: {}", fname);
-    goto done;
+    close(fd);
+    return EMPTY_DB;
   }
 
-  if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    log::error("can't read number of GATT attributes: {}", fname);
-    goto done;
+  size_t len = st.st_size;
+  void* map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    log::error("can't map GATT cache file {}, error: {}", fname,
+               strerror(errno));
+    return EMPTY_DB;
   }
 
-  {
-    std::vector<StoredAttribute> attr(num_attr);
+  const uint8_t* data = static_cast<const uint8_t*>(map);
+  uint16_t cache_ver = data[0] | (data[1] << 8);
 
-    if (fread(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-      log::error("can't read GATT attributes: {}", fname);
-      goto done;
-    }
-    fclose(fd);
+  std::vector<StoredAttribute> attr;
+  bool parsed = false;
+  if (cache_ver == GATT_CACHE_VERSION) {
+    parsed = StoredAttribute::DeserializeCompact(data, len, attr);
+  } else if (cache_ver == GATT_CACHE_LEGACY_VERSION) {
+    parsed = bta_gattc_parse_legacy_db(data, len, attr);
+  } else {
+    log::error("wrong GATT cache version: {}", fname);
+  }
+  munmap(map, len);
 
-    bool success = false;
-    gatt::Database result = gatt::Database::Deserialize(attr, &success);
-    return success ? result : EMPTY_DB;
+  if (!parsed) {
+    log::error("can't read GATT attributes: {}", fname);
+    return EMPTY_DB;
   }
 
-done:
-  fclose(fd);
-  return EMPTY_DB;
+  bool success = false;
+  gatt::Database result = gatt::Database::Deserialize(attr, &success);
+  return success ? result : EMPTY_DB;
 }
 
 /*******************************************************************************
@@ -224,11 +264,187 @@ void StoredAttribute::SerializeStoredAttribute(const StoredAttribute& attr,
   }
 }
 
+static void push_uint16(std::vector<uint8_t>& bytes, uint16_t value) {
+  bytes.push_back(value & 0xff);
+  bytes.push_back(value >> 8);
+}
+
+static uint16_t read_uint16(const uint8_t*& p) {
+  uint16_t value = p[0] | (p[1] << 8);
+  p += 2;
+  return value;
+}
+
+void StoredAttribute::SerializeCompact(
+    uint16_t version, const std::vector<StoredAttribute>& attrs,
+    std::vector<uint8_t>& bytes) {
+  // UUIDs are interned: most databases repeat a handful of declaration and
+  // descriptor types, so each record only keeps an index into the table.
+  std::vector<Uuid> uuids;
+  std::unordered_map<Uuid, uint16_t> uuid_index;
+  auto intern = [&](const Uuid& uuid) -> uint16_t {
+    auto [it, inserted] = uuid_index.try_emplace(uuid, uuids.size());
+    if (inserted) uuids.push_back(uuid);
+    return it->second;
+  };
+
+  std::vector<uint8_t> records;
+  records.reserve(attrs.size() * kCompactSizeOnDisk);
+  for (const StoredAttribute& attr : attrs) {
+    uint16_t fields[3] = {0, 0, 0};
+    push_uint16(records, attr.handle);
+    push_uint16(records, intern(attr.type));
+
+    if (attr.type.Is16Bit()) {
+      switch (attr.type.As16Bit()) {
+        case GATT_UUID_PRI_SERVICE:
+        case GATT_UUID_SEC_SERVICE:
+          fields[0] = intern(attr.value.service.uuid);
+          fields[1] = attr.value.service.end_handle;
+          break;
+        case GATT_UUID_INCLUDE_SERVICE:
+          fields[0] = attr.value.included_service.handle;
+          fields[1] = attr.value.included_service.end_handle;
+          fields[2] = intern(attr.value.included_service.uuid);
+          break;
+        case GATT_UUID_CHAR_DECLARE:
+          fields[0] = attr.value.characteristic.properties;
+          fields[1] = attr.value.characteristic.value_handle;
+          fields[2] = intern(attr.value.characteristic.uuid);
+          break;
+        case GATT_UUID_CHAR_EXT_PROP:
+          fields[0] = attr.value.characteristic_extended_properties;
+          break;
+        default:
+          break;
+      }
+    }
+
+    for (uint16_t field : fields) push_uint16(records, field);
+  }
+
+  bytes.reserve(bytes.size() + kCompactHeaderSize +
+                uuids.size() * Uuid::kNumBytes128 + records.size());
+  push_uint16(bytes, version);
+  push_uint16(bytes, attrs.size());
+  push_uint16(bytes, uuids.size());
+  push_uint16(bytes, 0);  // Reserved
+  for (const Uuid& uuid : uuids) {
+    const auto& uuid_bytes = uuid.To128BitBE();
+    bytes.insert(bytes.cend(), uuid_bytes.cbegin(), uuid_bytes.cend());
+  }
+  bytes.insert(bytes.cend(), records.cbegin(), records.cend());
+}
+
+bool StoredAttribute::DeserializeCompact(const uint8_t* data, size_t len,
+                                         std::vector<StoredAttribute>& attrs) {
+  if (len < kCompactHeaderSize) return false;
+
+  // The version is checked by the caller
+  const uint8_t* p = data + sizeof(uint16_t);
+  uint16_t num_attr = read_uint16(p);
+  uint16_t num_uuid = read_uint16(p);
+  if (len != kCompactHeaderSize + num_uuid * Uuid::kNumBytes128 +
+                 num_attr * kCompactSizeOnDisk) {
+    log::error("GATT cache size mismatch, len={}, attributes={}, uuids={}",
+               len, num_attr, num_uuid);
+    return false;
+  }
+
+  p = data + kCompactHeaderSize;
+  std::vector<Uuid> uuids;
+  uuids.reserve(num_uuid);
+  for (uint16_t i = 0; i < num_uuid; i++) {
+    uuids.push_back(Uuid::From128BitBE(p));
+    p += Uuid::kNumBytes128;
+  }
+
+  attrs.clear();
+  attrs.reserve(num_attr);
+  for (uint16_t i = 0; i < num_attr; i++) {
+    uint16_t handle = read_uint16(p);
+    uint16_t type = read_uint16(p);
+    uint16_t fields[3];
+    for (uint16_t& field : fields) field = read_uint16(p);
+
+    if (type >= num_uuid) return false;
+    StoredAttribute attr = {handle, uuids[type], {}};
+
+    if (attr.type.Is16Bit()) {
+      switch (attr.type.As16Bit()) {
+        case GATT_UUID_PRI_SERVICE:
+        case GATT_UUID_SEC_SERVICE:
+          if (fields[0] >= num_uuid) return false;
+          attr.value.service = {.uuid = uuids[fields[0]],
+                                .end_handle = fields[1]};
+          break;
+        case GATT_UUID_INCLUDE_SERVICE:
+          if (fields[2] >= num_uuid) return false;
+          attr.value.included_service = {.handle = fields[0],
+                                         .end_handle = fields[1],
+                                         .uuid = uuids[fields[2]]};
+          break;
+        case GATT_UUID_CHAR_DECLARE:
+          if (fields[2] >= num_uuid) return false;
+          attr.value.characteristic = {
+              .properties = static_cast<uint8_t>(fields[0]),
+              .value_handle = fields[1],
+              .uuid = uuids[fields[2]]};
+          break;
+        case GATT_UUID_CHAR_EXT_PROP:
+          attr.value.characteristic_extended_properties = fields[0];
+          break;
+        default:
+          break;
+      }
+    }
+
+    attrs.push_back(attr);
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_db_file_matches
+ *
+ * Description      Check whether a file already holds the given content.
+ *
+ * Parameter        fname: file name
+ *                  bytes: expected content
+ *
+ * Returns          true if the file content is identical, false otherwise
+ *
+ ******************************************************************************/
+static bool bta_gattc_db_file_matches(const char* fname,
+                                      const std::vector<uint8_t>& bytes) {
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || (size_t)st.st_size != bytes.size() ||
+      bytes.empty()) {
+    close(fd);
+    return false;
+  }
+
+  void* map = mmap(nullptr, bytes.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) return false;
+
+  bool matches = memcmp(map, bytes.data(), bytes.size()) == 0;
+  munmap(map, bytes.size());
+  return matches;
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_store_db
  *
- * Description      Storess GATT db.
+ * Description      Storess GATT db. Hash files are named after their content,
+ *                  so a file that already holds the same image only gets its
+ *                  modification time refreshed instead of being rewritten.
  *
  * Parameter        fname: output file name
  *                  attr: attributes to save.
@@ -238,32 +454,24 @@ void StoredAttribute::SerializeStoredAttribute(const StoredAttribute& attr,
  ******************************************************************************/
 static bool bta_gattc_store_db(const char* fname,
                                const std::vector<StoredAttribute>& attr) {
-  FILE* fd = fopen(fname, "wb");
-  if (!fd) {
-    log::error("can't open GATT cache file for writing: {}", fname);
-    return false;
-  }
+  std::vector<uint8_t> db_bytes;
+  StoredAttribute::SerializeCompact(GATT_CACHE_VERSION, attr, db_bytes);
 
-  uint16_t cache_ver = GATT_CACHE_VERSION;
-  if (fwrite(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    log::error("can't write GATT cache version: {}", fname);
-    fclose(fd);
-    return false;
+  if (bta_gattc_db_file_matches(fname, db_bytes)) {
+    // Keep the least recently used bookkeeping up to date
+    if (utimensat(AT_FDCWD, fname, nullptr, 0) == -1) {
+      log::warn("can't update GATT cache file time: {}, errno={}", fname,
+                errno);
+    }
+    return true;
   }
 
-  uint16_t num_attr = attr.size();
-  if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    log::error("can't write GATT cache attribute count: {}", fname);
-    fclose(fd);
+  FILE* fd = fopen(fname, "wb");
+  if (!fd) {
+    log::error("can't open GATT cache file for writing: {}", fname);
     return false;
   }
 
-  std::vector<uint8_t> db_bytes;
-  db_bytes.reserve(num_attr * StoredAttribute::kSizeOnDisk);
-  for (const auto attribute : attr) {
-    StoredAttribute::SerializeStoredAttribute(attribute, db_bytes);
-  }
-
   if (fwrite(db_bytes.data(), sizeof(uint8_t), db_bytes.size(), fd) !=
       db_bytes.size()) {
     log::error("can't write GATT cache attributes: {}", fname);
@@ -482,6 +482,7 @@ tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
                                             tGATT_DISC_TYPE disc_type);
 void bta_gattc_search_service(tBTA_GATTC_CLCB* p_clcb, bluetooth::Uuid* p_uuid);
 const std::list<gatt::Service>* bta_gattc_get_services(uint16_t conn_id);
+bool bta_gattc_get_database_hash(uint16_t conn_id, Octet16* p_hash);
 const gatt::Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
                                                       uint16_t handle);
 const gatt::Characteristic* bta_gattc_get_characteristic_srcb(
@@ -18,18 +18,24 @@
 
 #include <bluetooth/log.h>
 
+#include <cstdio>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "bta_gatt_queue.h"
+#include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
+#include "types/raw_address.h"
 
 using gatt_operation = BtaGattQueue::gatt_operation;
 using namespace bluetooth;
 
+bool gatt_profile_get_eatt_support(const RawAddress& remote_bda);
+
 constexpr uint8_t GATT_READ_CHAR = 1;
 constexpr uint8_t GATT_READ_DESC = 2;
 constexpr uint8_t GATT_WRITE_CHAR = 3;
@@ -37,14 +43,23 @@ constexpr uint8_t GATT_WRITE_DESC = 4;
 constexpr uint8_t GATT_CONFIG_MTU = 5;
 constexpr uint8_t GATT_READ_MULTI = 6;
 
+constexpr char kPropertyReadBatchingEnabled[] =
+    "bluetooth.gatt.queue.read_batching.enabled";
+
 struct gatt_read_op_data {
   GATT_READ_OP_CB cb;
   void* cb_data;
+  std::vector<std::pair<GATT_READ_OP_CB, void*>> coalesced;
 };
 
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
 std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+bluetooth::common::LatencyHistogram BtaGattQueue::gatt_op_queue_wait_us;
+size_t BtaGattQueue::gatt_op_coalesced_reads = 0;
+std::unordered_set<uint16_t> BtaGattQueue::gatt_op_read_multi_var_rejected;
+size_t BtaGattQueue::gatt_op_batched_reads = 0;
+size_t BtaGattQueue::gatt_op_read_batches = 0;
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
   gatt_op_queue_executing.erase(conn_id);
@@ -56,15 +71,22 @@ void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
   gatt_read_op_data* tmp = (gatt_read_op_data*)data;
   GATT_READ_OP_CB tmp_cb = tmp->cb;
   void* tmp_cb_data = tmp->cb_data;
+  std::vector<std::pair<GATT_READ_OP_CB, void*>> coalesced =
+      std::move(tmp->coalesced);
 
-  osi_free(data);
+  delete tmp;
 
   mark_as_not_executing(conn_id);
   gatt_execute_next_op(conn_id);
 
   if (tmp_cb) {
     tmp_cb(conn_id, status, handle, len, value, tmp_cb_data);
-    return;
+  }
+
+  for (auto& [cb, cb_data] : coalesced) {
+    if (cb) {
+      cb(conn_id, status, handle, len, value, cb_data);
+    }
   }
 }
 
@@ -139,6 +161,171 @@ void BtaGattQueue::gatt_read_multi_op_finished(uint16_t conn_id,
   }
 }
 
+struct gatt_batched_read_op_data {
+  std::vector<gatt_operation> reads;
+};
+
+static void gatt_deliver_read(const gatt_operation& op, uint16_t conn_id,
+                              tGATT_STATUS status, uint16_t len,
+                              uint8_t* value) {
+  if (op.read_cb) {
+    op.read_cb(conn_id, status, op.handle, len, value, op.read_cb_data);
+  }
+  for (auto& [cb, cb_data] : op.coalesced_reads) {
+    if (cb) {
+      cb(conn_id, status, op.handle, len, value, cb_data);
+    }
+  }
+}
+
+/* Errors which may come from a single attribute of the batch, the reads are
+ * sent again one by one so that each callback gets its own status. */
+static bool gatt_is_attribute_error(tGATT_STATUS status) {
+  switch (status) {
+    case GATT_INVALID_HANDLE:
+    case GATT_READ_NOT_PERMIT:
+    case GATT_INVALID_PDU:
+    case GATT_INSUF_AUTHENTICATION:
+    case GATT_REQ_NOT_SUPPORTED:
+    case GATT_INSUF_AUTHORIZATION:
+    case GATT_INSUF_KEY_SIZE:
+    case GATT_INVALID_ATTR_LEN:
+    case GATT_INSUF_ENCRYPTION:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void BtaGattQueue::gatt_batched_read_op_finished(
+    uint16_t conn_id, tGATT_STATUS status, tBTA_GATTC_MULTI& /* handles */,
+    uint16_t len, uint8_t* value, void* data) {
+  gatt_batched_read_op_data* tmp = (gatt_batched_read_op_data*)data;
+  std::vector<gatt_operation> reads = std::move(tmp->reads);
+
+  delete tmp;
+
+  /* Split the length value tuples of the response. The response is cut at the
+   * MTU, so the last values may be partial or missing. */
+  std::vector<std::pair<uint8_t*, uint16_t>> values(reads.size(),
+                                                    {nullptr, 0});
+  std::list<gatt_operation> retries;
+  bool retry_all = status != GATT_SUCCESS && gatt_is_attribute_error(status);
+  uint16_t offset = 0;
+  for (size_t i = 0; i < reads.size(); i++) {
+    if (status != GATT_SUCCESS) {
+      if (retry_all) retries.push_back(reads[i]);
+      continue;
+    }
+    if (len - offset < 2) {
+      retries.push_back(reads[i]);
+      continue;
+    }
+    uint16_t value_len = value[offset] | (value[offset + 1] << 8);
+    offset += 2;
+    if (value_len > len - offset) {
+      retries.push_back(reads[i]);
+      offset = len;
+      continue;
+    }
+    values[i] = {value + offset, value_len};
+    offset += value_len;
+  }
+
+  if (status == GATT_REQ_NOT_SUPPORTED) {
+    log::info("conn_id=0x{:x}, Read Multiple Variable Length rejected",
+              conn_id);
+    gatt_op_read_multi_var_rejected.insert(conn_id);
+  }
+
+  /* The queue is gone if the connection was cleaned meanwhile */
+  auto map_ptr = gatt_op_queue.find(conn_id);
+  if (!retries.empty() && map_ptr == gatt_op_queue.end()) {
+    retries.clear();
+    retry_all = false;
+  }
+  for (auto& op : retries) {
+    op.read_alone = true;
+  }
+  if (!retries.empty()) {
+    log::debug("conn_id=0x{:x}, reading {} of {} handles again one by one",
+               conn_id, retries.size(), reads.size());
+    map_ptr->second.splice(map_ptr->second.begin(), retries);
+  }
+
+  mark_as_not_executing(conn_id);
+  gatt_execute_next_op(conn_id);
+
+  for (size_t i = 0; i < reads.size(); i++) {
+    if (status == GATT_SUCCESS) {
+      if (values[i].first != nullptr) {
+        gatt_deliver_read(reads[i], conn_id, GATT_SUCCESS, values[i].second,
+                          values[i].first);
+      }
+    } else if (!retry_all) {
+      gatt_deliver_read(reads[i], conn_id, status, 0, nullptr);
+    }
+  }
+}
+
+bool BtaGattQueue::read_multi_var_supported(uint16_t conn_id) {
+  static const bool enabled =
+      osi_property_get_bool(kPropertyReadBatchingEnabled, true);
+  if (!enabled || gatt_op_read_multi_var_rejected.count(conn_id)) {
+    return false;
+  }
+
+  tGATT_IF gatt_if;
+  RawAddress remote_bda;
+  tBT_TRANSPORT transport;
+  if (!GATT_GetConnectionInfor(conn_id, &gatt_if, remote_bda, &transport)) {
+    return false;
+  }
+  return gatt_profile_get_eatt_support(remote_bda);
+}
+
+/* Send the reads at the head of the queue in a single request. Returns false
+ * when there are not at least two of them to batch. */
+bool BtaGattQueue::gatt_execute_batched_read(
+    uint16_t conn_id, std::list<gatt_operation>& gatt_ops) {
+  auto is_batchable = [](const gatt_operation& op) {
+    return (op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC) &&
+           !op.read_alone;
+  };
+
+  auto end = gatt_ops.begin();
+  size_t count = 0;
+  while (end != gatt_ops.end() && count < GATT_MAX_READ_MULTI_HANDLES &&
+         is_batchable(*end)) {
+    end++;
+    count++;
+  }
+  if (count < 2 || !read_multi_var_supported(conn_id)) {
+    return false;
+  }
+
+  tBTA_GATTC_MULTI handles = {.num_attr = 0};
+  gatt_batched_read_op_data* data = new gatt_batched_read_op_data();
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  for (auto it = gatt_ops.begin(); it != end; it++) {
+    /* The wait of the first one is counted by the caller */
+    if (it != gatt_ops.begin()) {
+      gatt_op_queue_wait_us.Add(now_us > it->queued_us ? now_us - it->queued_us
+                                                       : 0);
+    }
+    handles.handles[handles.num_attr++] = it->handle;
+    data->reads.push_back(std::move(*it));
+  }
+  gatt_ops.erase(gatt_ops.begin(), end);
+
+  gatt_op_batched_reads += count;
+  gatt_op_read_batches++;
+  log::verbose("conn_id=0x{:x}, reading {} handles at once", conn_id, count);
+  BTA_GATTC_ReadMultiple(conn_id, handles, true, GATT_AUTH_REQ_NONE,
+                         gatt_batched_read_op_finished, data);
+  return true;
+}
+
 void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
   log::verbose("conn_id=0x{:x}", conn_id);
   if (gatt_op_queue.empty()) {
@@ -163,19 +350,22 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 
   gatt_operation& op = gatt_ops.front();
 
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  gatt_op_queue_wait_us.Add(now_us > op.queued_us ? now_us - op.queued_us : 0);
+
+  if (gatt_execute_batched_read(conn_id, gatt_ops)) {
+    return;
+  }
+
   if (op.type == GATT_READ_CHAR) {
-    gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
-    data->cb = op.read_cb;
-    data->cb_data = op.read_cb_data;
+    gatt_read_op_data* data = new gatt_read_op_data{
+        op.read_cb, op.read_cb_data, std::move(op.coalesced_reads)};
     BTA_GATTC_ReadCharacteristic(conn_id, op.handle, GATT_AUTH_REQ_NONE,
                                  gatt_read_op_finished, data);
 
   } else if (op.type == GATT_READ_DESC) {
-    gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
-    data->cb = op.read_cb;
-    data->cb_data = op.read_cb_data;
+    gatt_read_op_data* data = new gatt_read_op_data{
+        op.read_cb, op.read_cb_data, std::move(op.coalesced_reads)};
     BTA_GATTC_ReadCharDescr(conn_id, op.handle, GATT_AUTH_REQ_NONE,
                             gatt_read_op_finished, data);
 
@@ -216,26 +406,62 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
   gatt_ops.pop_front();
 }
 
+/* Attach the callback to a read of the same attribute already queued, unless
+ * a write or an MTU exchange queued after that read could change the value. */
+bool BtaGattQueue::coalesce_read(std::list<gatt_operation>& gatt_ops,
+                                 uint8_t type, uint16_t handle,
+                                 GATT_READ_OP_CB cb, void* cb_data) {
+  for (auto it = gatt_ops.rbegin(); it != gatt_ops.rend(); it++) {
+    if (it->type != GATT_READ_CHAR && it->type != GATT_READ_DESC &&
+        it->type != GATT_READ_MULTI) {
+      return false;
+    }
+    if (it->type == type && it->handle == handle) {
+      it->coalesced_reads.emplace_back(cb, cb_data);
+      gatt_op_coalesced_reads++;
+      return true;
+    }
+  }
+  return false;
+}
+
 void BtaGattQueue::Clean(uint16_t conn_id) {
   gatt_op_queue.erase(conn_id);
   gatt_op_queue_executing.erase(conn_id);
+  gatt_op_read_multi_var_rejected.erase(conn_id);
 }
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_CHAR,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
+  std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+  if (coalesce_read(gatt_ops, GATT_READ_CHAR, handle, cb, cb_data)) {
+    log::verbose("conn_id=0x{:x}, read of handle 0x{:04x} already queued",
+                 conn_id, handle);
+    return;
+  }
+  gatt_ops.push_back(
+      {.type = GATT_READ_CHAR,
+       .handle = handle,
+       .read_cb = cb,
+       .read_cb_data = cb_data,
+       .queued_us = bluetooth::common::time_get_os_boottime_us()});
   gatt_execute_next_op(conn_id);
 }
 
 void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
                                   GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_DESC,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
+  std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+  if (coalesce_read(gatt_ops, GATT_READ_DESC, handle, cb, cb_data)) {
+    log::verbose("conn_id=0x{:x}, read of handle 0x{:04x} already queued",
+                 conn_id, handle);
+    return;
+  }
+  gatt_ops.push_back(
+      {.type = GATT_READ_DESC,
+       .handle = handle,
+       .read_cb = cb,
+       .read_cb_data = cb_data,
+       .queued_us = bluetooth::common::time_get_os_boottime_us()});
   gatt_execute_next_op(conn_id);
 }
 
@@ -243,12 +469,14 @@ void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
                                        std::vector<uint8_t> value,
                                        tGATT_WRITE_TYPE write_type,
                                        GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_CHAR,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
+  gatt_op_queue[conn_id].push_back(
+      {.type = GATT_WRITE_CHAR,
+       .handle = handle,
+       .write_cb = cb,
+       .write_cb_data = cb_data,
+       .write_type = write_type,
+       .value = std::move(value),
+       .queued_us = bluetooth::common::time_get_os_boottime_us()});
   gatt_execute_next_op(conn_id);
 }
 
@@ -256,12 +484,14 @@ void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
                                    std::vector<uint8_t> value,
                                    tGATT_WRITE_TYPE write_type,
                                    GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_DESC,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
+  gatt_op_queue[conn_id].push_back(
+      {.type = GATT_WRITE_DESC,
+       .handle = handle,
+       .write_cb = cb,
+       .write_cb_data = cb_data,
+       .write_type = write_type,
+       .value = std::move(value),
+       .queued_us = bluetooth::common::time_get_os_boottime_us()});
   gatt_execute_next_op(conn_id);
 }
 
@@ -269,8 +499,10 @@ void BtaGattQueue::ConfigureMtu(uint16_t conn_id, uint16_t mtu) {
   log::info("mtu: {}", static_cast<int>(mtu));
   std::vector<uint8_t> value = {static_cast<uint8_t>(mtu & 0xff),
                                 static_cast<uint8_t>(mtu >> 8)};
-  gatt_op_queue[conn_id].push_back({.type = GATT_CONFIG_MTU,
-                                    .value = std::move(value)});
+  gatt_op_queue[conn_id].push_back(
+      {.type = GATT_CONFIG_MTU,
+       .value = std::move(value),
+       .queued_us = bluetooth::common::time_get_os_boottime_us()});
   gatt_execute_next_op(conn_id);
 }
 
@@ -279,10 +511,28 @@ void BtaGattQueue::ReadMultiCharacteristic(uint16_t conn_id,
                                            bool variable_len,
                                            GATT_READ_MULTI_OP_CB cb,
                                            void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_MULTI,
-                                    .handles = handles,
-                                    .variable_len = variable_len,
-                                    .read_multi_cb = cb,
-                                    .read_cb_data = cb_data});
+  gatt_op_queue[conn_id].push_back(
+      {.type = GATT_READ_MULTI,
+       .handles = handles,
+       .variable_len = variable_len,
+       .read_multi_cb = cb,
+       .read_cb_data = cb_data,
+       .queued_us = bluetooth::common::time_get_os_boottime_us()});
   gatt_execute_next_op(conn_id);
 }
+
+void BtaGattQueue::DebugDump(int fd) {
+  size_t queued = 0;
+  for (const auto& [conn_id, gatt_ops] : gatt_op_queue) {
+    queued += gatt_ops.size();
+  }
+  dprintf(fd, "BTA GATT queue:\n");
+  dprintf(fd, "  Connections executing: %zu, operations queued: %zu\n",
+          gatt_op_queue_executing.size(), queued);
+  dprintf(fd, "  Reads coalesced: %zu\n", gatt_op_coalesced_reads);
+  dprintf(fd, "  Reads batched: %zu in %zu requests\n", gatt_op_batched_reads,
+          gatt_op_read_batches);
+  dprintf(fd, "  Queue wait (us): count: %zu, %s\n",
+          gatt_op_queue_wait_us.Count(),
+          gatt_op_queue_wait_us.ToString().c_str());
+}
@@ -62,6 +62,73 @@ Service* FindService(std::list<Service>& services, uint16_t handle) {
   return nullptr;
 }
 
+Database::Database(const Database& other) : services(other.services) {
+  BuildHandleIndex();
+}
+
+Database& Database::operator=(const Database& other) {
+  if (this != &other) {
+    services = other.services;
+    BuildHandleIndex();
+  }
+  return *this;
+}
+
+void Database::BuildHandleIndex() {
+  handle_index.clear();
+  for (const Service& service : services) {
+    handle_index[service.handle] = {&service, nullptr, nullptr};
+
+    for (const IncludedService& is : service.included_services) {
+      handle_index[is.handle] = {&service, nullptr, nullptr};
+    }
+
+    for (const Characteristic& c : service.characteristics) {
+      handle_index[c.declaration_handle] = {&service, nullptr, nullptr};
+      handle_index[c.value_handle] = {&service, &c, nullptr};
+
+      for (const Descriptor& d : c.descriptors) {
+        handle_index[d.handle] = {&service, &c, &d};
+      }
+    }
+  }
+}
+
+const Database::HandleIndexEntry* Database::FindHandle(uint16_t handle) const {
+  auto it = handle_index.find(handle);
+  return it == handle_index.end() ? nullptr : &it->second;
+}
+
+const Service* Database::FindServiceForHandle(uint16_t handle) const {
+  const HandleIndexEntry* entry = FindHandle(handle);
+  if (entry) return entry->service;
+
+  // Handles inside a service range are not all used by attributes
+  for (const Service& service : services) {
+    if (HandleInRange(service, handle)) return &service;
+  }
+
+  return nullptr;
+}
+
+const Characteristic* Database::FindCharacteristic(uint16_t handle) const {
+  const HandleIndexEntry* entry = FindHandle(handle);
+  if (!entry || entry->descriptor) return nullptr;
+  return entry->characteristic;
+}
+
+const Descriptor* Database::FindDescriptor(uint16_t handle) const {
+  const HandleIndexEntry* entry = FindHandle(handle);
+  return entry ? entry->descriptor : nullptr;
+}
+
+const Characteristic* Database::FindOwningCharacteristic(
+    uint16_t handle) const {
+  const HandleIndexEntry* entry = FindHandle(handle);
+  if (!entry || !entry->descriptor) return nullptr;
+  return entry->characteristic;
+}
+
 std::string Database::ToString() const {
   std::stringstream tmp;
 
@@ -217,6 +284,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
       }
     }
   }
+  result.BuildHandleIndex();
   *success = true;
   return result;
 }
@@ -20,6 +20,7 @@
 
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "stack/include/bt_octets.h"
@@ -63,6 +64,17 @@ struct StoredAttribute {
   } value;
   static void SerializeStoredAttribute(const StoredAttribute& attr,
                                        std::vector<uint8_t>& bytes);
+
+  /* Compact storage format: a header, a table of the distinct UUIDs used in
+   * the database, and one fixed size record per attribute that refers to the
+   * table by index. The image can be parsed straight from a mapped file. */
+  static constexpr size_t kCompactHeaderSize = 8;
+  static constexpr size_t kCompactSizeOnDisk = 10;
+  static void SerializeCompact(uint16_t version,
+                               const std::vector<StoredAttribute>& attrs,
+                               std::vector<uint8_t>& bytes);
+  static bool DeserializeCompact(const uint8_t* data, size_t len,
+                                 std::vector<StoredAttribute>& attrs);
 };
 
 struct IncludedService;
@@ -104,12 +116,23 @@ class DatabaseBuilder;
 
 class Database {
  public:
+  Database() = default;
+  /* The handle index points into |services|, so it is rebuilt on copy. Moving
+   * keeps the list nodes, and with them the index, valid. */
+  Database(const Database& other);
+  Database& operator=(const Database& other);
+  Database(Database&& other) = default;
+  Database& operator=(Database&& other) = default;
+
   /* Return true if there are no services in this database. */
   bool IsEmpty() const { return services.empty(); }
 
   /* Clear the GATT database. This method forces relocation to ensure no extra
    * space is used unnecesarly */
-  void Clear() { std::list<Service>().swap(services); }
+  void Clear() {
+    std::list<Service>().swap(services);
+    std::unordered_map<uint16_t, HandleIndexEntry>().swap(handle_index);
+  }
 
   /* Return list of services available in this database */
   const std::list<Service>& Services() const { return services; }
@@ -124,10 +147,36 @@ class Database {
   /* Return 128 bit unique identifier of this GATT database */
   Octet16 Hash() const;
 
+  /* Return the service that contains |handle|, or nullptr */
+  const Service* FindServiceForHandle(uint16_t handle) const;
+
+  /* Return the characteristic with value handle |handle|, or nullptr */
+  const Characteristic* FindCharacteristic(uint16_t handle) const;
+
+  /* Return the descriptor with handle |handle|, or nullptr */
+  const Descriptor* FindDescriptor(uint16_t handle) const;
+
+  /* Return the characteristic owning descriptor |handle|, or nullptr */
+  const Characteristic* FindOwningCharacteristic(uint16_t handle) const;
+
   friend class DatabaseBuilder;
 
  private:
+  struct HandleIndexEntry {
+    const Service* service;
+    /* Set for characteristic value and descriptor handles */
+    const Characteristic* characteristic;
+    /* Set for descriptor handles */
+    const Descriptor* descriptor;
+  };
+
+  /* Index every attribute handle of the finalized database, so that lookups
+   * on the notification, read and write paths don't walk the services. */
+  void BuildHandleIndex();
+  const HandleIndexEntry* FindHandle(uint16_t handle) const;
+
   std::list<Service> services;
+  std::unordered_map<uint16_t, HandleIndexEntry> handle_index;
 };
 
 /* Find a service that should contain handle. Helper method for internal use
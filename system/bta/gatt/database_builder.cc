@@ -134,6 +134,14 @@ void DatabaseBuilder::AddDescriptor(uint16_t handle, const Uuid& uuid) {
     char_node = &(*it);
   }
 
+  // Merged descriptor ranges also return the attributes of the characteristics
+  // in between
+  if (handle == char_node->declaration_handle ||
+      handle == char_node->value_handle) {
+    log::verbose("Skipping characteristic attribute handle=0x{:04x}", handle);
+    return;
+  }
+
   char_node->descriptors.emplace_back(
       gatt::Descriptor{.handle = handle, .uuid = uuid});
 
@@ -196,6 +204,40 @@ std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
   return {HANDLE_MAX, HANDLE_MAX};
 }
 
+std::pair<uint16_t, uint16_t>
+DatabaseBuilder::NextMergedDescriptorRangeToExplore() {
+  Service* service = FindService(database.services, pending_service.first);
+  if (!service || service->characteristics.empty() ||
+      pending_characteristic == HANDLE_MAX) {
+    return {HANDLE_MAX, HANDLE_MAX};
+  }
+
+  bool found = false;
+  std::pair<uint16_t, uint16_t> range;
+  for (auto it = service->characteristics.cbegin();
+       it != service->characteristics.cend(); it++) {
+    auto next = std::next(it);
+
+    uint16_t start = it->declaration_handle + 2;
+    uint16_t end;
+    if (next != service->characteristics.end())
+      end = next->declaration_handle - 1;
+    else
+      end = service->end_handle;
+
+    // No place for descriptor
+    if (start > end) continue;
+
+    if (!found) range.first = start;
+    range.second = end;
+    found = true;
+  }
+
+  pending_characteristic = HANDLE_MAX;
+  if (!found) return {HANDLE_MAX, HANDLE_MAX};
+  return range;
+}
+
 Descriptor* FindDescriptorByHandle(std::list<Service>& services,
                                    uint16_t handle) {
   Service* service = FindService(services, handle);
@@ -244,8 +286,9 @@ bool DatabaseBuilder::SetValueOfDescriptors(
 bool DatabaseBuilder::InProgress() const { return !database.services.empty(); }
 
 Database DatabaseBuilder::Build() {
-  Database tmp = database;
+  Database tmp = std::move(database);
   database.Clear();
+  tmp.BuildHandleIndex();
   return tmp;
 }
 
@@ -53,6 +53,13 @@ class DatabaseBuilder {
    */
   std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore();
 
+  /* Same as |NextDescriptorRangeToExplore()|, but return one range spanning
+   * the descriptors of all characteristics of the currently explored service,
+   * so that they are discovered in one go. Characteristic declarations and
+   * values found in this range are not added as descriptors.
+   */
+  std::pair<uint16_t, uint16_t> NextMergedDescriptorRangeToExplore();
+
   /* Return vector of "Characteristic Extended Properties" descriptors that must
    * be read as part of service discovery process */
   std::vector<uint16_t> DescriptorHandlesToRead() {
@@ -34,6 +34,8 @@
 #include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "btm_iso_api.h"
+#include "common/latency_histogram.h"
+#include "common/time_util.h"
 #include "embdrv/g722/g722_enc_dec.h"
 #include "hal/link_clocker.h"
 #include "hardware/bt_gatt_types.h"
@@ -279,6 +281,8 @@ class HearingAidImpl : public HearingAid {
   // from either the left or right connection, whichever is first
   // connected.
   std::unique_ptr<bluetooth::audio::asrc::SourceAudioHalAsrc> asrc;
+  // Resampled buffers of the last input, kept to reuse its allocation.
+  std::vector<const std::vector<uint8_t>*> asrc_output;
 
  public:
   ~HearingAidImpl() override = default;
@@ -436,11 +440,13 @@ class HearingAidImpl : public HearingAid {
     }
 
     log::info(
-        "L2CA_UpdateBleConnParams for device {} min_ce_len:{} max_ce_len:{}",
+        "L2CA_UpdateBleConnParamsForClient for device {} min_ce_len:{} "
+        "max_ce_len:{}",
         address, min_ce_len, max_ce_len);
-    if (!L2CA_UpdateBleConnParams(address, connection_interval,
-                                  connection_interval, 0x000A, 0x0064 /*1s*/,
-                                  min_ce_len, max_ce_len)) {
+    if (!L2CA_UpdateBleConnParamsForClient(
+            L2CAP_CONN_PARAMS_CLIENT_HEARING_AID, address, connection_interval,
+            connection_interval, 0x000A, 0x0064 /*1s*/, min_ce_len,
+            max_ce_len)) {
       log::warn("Unable to update L2CAP ble connection parameters peer:{}",
                 address);
     }
@@ -1415,7 +1421,8 @@ class HearingAidImpl : public HearingAid {
       return OnAudioDataReady(data);
     }
 
-    for (auto const resampled_data : asrc->Run(data)) {
+    asrc->Run(data, &asrc_output);
+    for (auto const resampled_data : asrc_output) {
       OnAudioDataReady(*resampled_data);
     }
   }
@@ -1449,8 +1456,12 @@ class HearingAidImpl : public HearingAid {
       return;
     }
 
-    std::vector<uint16_t> chan_left;
-    std::vector<uint16_t> chan_right;
+    const uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
+
+    // The channel and encoded buffers keep their capacity between audio
+    // ticks, so that a steady stream does not allocate them again.
+    chan_left.resize(num_samples);
+    chan_right.resize(num_samples);
     if (left == nullptr || right == nullptr) {
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
@@ -1461,19 +1472,19 @@ class HearingAidImpl : public HearingAid {
         int16_t right = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
 
         uint16_t mono_data = (int16_t)(((uint32_t)left + (uint32_t)right) >> 1);
-        chan_left.push_back(mono_data);
-        chan_right.push_back(mono_data);
+        chan_left[i] = mono_data;
+        chan_right[i] = mono_data;
       }
     } else {
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
 
         uint16_t left = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
-        chan_left.push_back(left);
+        chan_left[i] = left;
 
         sample += 2;
         uint16_t right = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
-        chan_right.push_back(right);
+        chan_right[i] = right;
       }
     }
 
@@ -1498,15 +1509,12 @@ class HearingAidImpl : public HearingAid {
 
     // divide encoded data into packets, add header, send.
 
-    // TODO: make those buffers static and global to prevent constant
-    // reallocations
-    // TODO: this should basically fit the encoded data, tune the size later
-    std::vector<uint8_t> encoded_data_left;
+    // G.722 at 64 kbit/s packs two samples per byte, one byte per sample is a
+    // safe upper bound.
+    encoded_data_left.clear();
     auto time_point = std::chrono::steady_clock::now();
     if (left) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_left.resize(4000);
+      encoded_data_left.resize(num_samples);
       int encoded_size =
           g722_encode(encoder_state_left, encoded_data_left.data(),
                       (const int16_t*)chan_left.data(), chan_left.size());
@@ -1540,11 +1548,9 @@ class HearingAidImpl : public HearingAid {
       check_and_do_rssi_read(left);
     }
 
-    std::vector<uint8_t> encoded_data_right;
+    encoded_data_right.clear();
     if (right) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_right.resize(4000);
+      encoded_data_right.resize(num_samples);
       int encoded_size =
           g722_encode(encoder_state_right, encoded_data_right.data(),
                       (const int16_t*)chan_right.data(), chan_right.size());
@@ -1581,6 +1587,9 @@ class HearingAidImpl : public HearingAid {
     size_t encoded_data_size =
         std::max(encoded_data_left.size(), encoded_data_right.size());
 
+    const uint64_t encoded_us = bluetooth::common::time_get_os_boottime_us();
+    encode_timing.Add(encoded_us - start_us);
+
     uint16_t packet_size =
         CalcCompressedAudioPacketSize(codec_in_use, default_data_interval_ms);
 
@@ -1608,6 +1617,8 @@ class HearingAidImpl : public HearingAid {
     }
     if (left) left->audio_stats.frame_send_count++;
     if (right) right->audio_stats.frame_send_count++;
+
+    send_timing.Add(bluetooth::common::time_get_os_boottime_us() - encoded_us);
   }
 
   void SendAudio(uint8_t* encoded_data, uint16_t packet_size,
@@ -1802,6 +1813,9 @@ class HearingAidImpl : public HearingAid {
 
       DumpRssi(fd, device);
     }
+    stream << "  Encode time (us)    : " << encode_timing.ToString()
+           << "\n  L2CAP send time (us): " << send_timing.ToString()
+           << std::endl;
     dprintf(fd, "%s", stream.str().c_str());
   }
 
@@ -1987,6 +2001,16 @@ class HearingAidImpl : public HearingAid {
 
   HearingDevices hearingDevices;
 
+  /* Deinterleaved PCM and encoded audio of the last audio tick */
+  std::vector<uint16_t> chan_left;
+  std::vector<uint16_t> chan_right;
+  std::vector<uint8_t> encoded_data_left;
+  std::vector<uint8_t> encoded_data_right;
+
+  /* Time spent encoding each audio tick, and handing it to L2CAP */
+  bluetooth::common::LatencyHistogram encode_timing;
+  bluetooth::common::LatencyHistogram send_timing;
+
   void find_server_changed_ccc_handle(uint16_t conn_id,
                                       const gatt::Service* service) {
     HearingDevice* hearingDevice = hearingDevices.FindByConnId(conn_id);
@@ -21,6 +21,9 @@
 
 #include <bluetooth/log.h>
 
+#include <iterator>
+#include <string_view>
+
 #include "bta/hf_client/bta_hf_client_int.h"
 #include "internal_include/bt_trace.h"
 #include "os/log.h"
@@ -1603,26 +1606,76 @@ static char* bta_hf_client_process_unknown(tBTA_HF_CLIENT_CB* client_cb,
  */
 typedef char* (*tBTA_HF_CLIENT_PARSER_CALLBACK)(tBTA_HF_CLIENT_CB*, char*);
 
-static const tBTA_HF_CLIENT_PARSER_CALLBACK bta_hf_client_parser_cb[] = {
-    bta_hf_client_parse_ok,        bta_hf_client_parse_error,
-    bta_hf_client_parse_ring,      bta_hf_client_parse_brsf,
-    bta_hf_client_parse_cind,      bta_hf_client_parse_ciev,
-    bta_hf_client_parse_chld,      bta_hf_client_parse_bcs,
-    bta_hf_client_parse_bsir,      bta_hf_client_parse_cmeerror,
-    bta_hf_client_parse_vgm,       bta_hf_client_parse_vgme,
-    bta_hf_client_parse_vgs,       bta_hf_client_parse_vgse,
-    bta_hf_client_parse_bvra,      bta_hf_client_parse_clip,
-    bta_hf_client_parse_ccwa,      bta_hf_client_parse_cops,
-    bta_hf_client_parse_binp,      bta_hf_client_parse_clcc,
-    bta_hf_client_parse_cnum,      bta_hf_client_parse_btrh,
-    bta_hf_client_parse_bind,      bta_hf_client_parse_busy,
-    bta_hf_client_parse_delayed,   bta_hf_client_parse_no_carrier,
-    bta_hf_client_parse_no_answer, bta_hf_client_parse_rejectlisted,
-    bta_hf_client_process_unknown};
-
-/* calculate supported event list length */
-static const uint16_t bta_hf_client_parser_cb_count =
-    sizeof(bta_hf_client_parser_cb) / sizeof(bta_hf_client_parser_cb[0]);
+typedef struct {
+  const char* event; /* event prefix following <cr><lf> */
+  tBTA_HF_CLIENT_PARSER_CALLBACK parser;
+} tBTA_HF_CLIENT_PARSER;
+
+/* Sorted by event so that bta_hf_client_find_parser can binary search it.
+ * No event is a prefix of another one, which makes the line prefix match at
+ * most one entry. */
+static constexpr tBTA_HF_CLIENT_PARSER bta_hf_client_parsers[] = {
+    {"+BCS:", bta_hf_client_parse_bcs},
+    {"+BIND:", bta_hf_client_parse_bind},
+    {"+BINP:", bta_hf_client_parse_binp},
+    {"+BRSF:", bta_hf_client_parse_brsf},
+    {"+BSIR:", bta_hf_client_parse_bsir},
+    {"+BTRH:", bta_hf_client_parse_btrh},
+    {"+BVRA:", bta_hf_client_parse_bvra},
+    {"+CCWA:", bta_hf_client_parse_ccwa},
+    {"+CHLD:", bta_hf_client_parse_chld},
+    {"+CIEV:", bta_hf_client_parse_ciev},
+    {"+CIND:", bta_hf_client_parse_cind},
+    {"+CLCC:", bta_hf_client_parse_clcc},
+    {"+CLIP:", bta_hf_client_parse_clip},
+    {"+CME ERROR:", bta_hf_client_parse_cmeerror},
+    {"+CNUM:", bta_hf_client_parse_cnum},
+    {"+COPS:", bta_hf_client_parse_cops},
+    {"+VGM:", bta_hf_client_parse_vgm},
+    {"+VGM=", bta_hf_client_parse_vgme},
+    {"+VGS:", bta_hf_client_parse_vgs},
+    {"+VGS=", bta_hf_client_parse_vgse},
+    {"BUSY", bta_hf_client_parse_busy},
+    {"DELAYED", bta_hf_client_parse_delayed},
+    {"ERROR", bta_hf_client_parse_error},
+    {"NO ANSWER", bta_hf_client_parse_no_answer},
+    {"NO CARRIER", bta_hf_client_parse_no_carrier},
+    {"OK", bta_hf_client_parse_ok},
+    {"REJECTLISTED", bta_hf_client_parse_rejectlisted},
+    {"RING", bta_hf_client_parse_ring},
+};
+
+static constexpr bool bta_hf_client_parsers_are_sorted() {
+  for (size_t i = 1; i < std::size(bta_hf_client_parsers); i++) {
+    std::string_view prev = bta_hf_client_parsers[i - 1].event;
+    std::string_view next = bta_hf_client_parsers[i].event;
+    if (prev >= next || next.substr(0, prev.size()) == prev) return false;
+  }
+  return true;
+}
+static_assert(bta_hf_client_parsers_are_sorted(),
+              "bta_hf_client_parsers must be sorted and prefix free");
+
+static const tBTA_HF_CLIENT_PARSER* bta_hf_client_find_parser(
+    const char* buf) {
+  if (strncmp("\r\n", buf, sizeof("\r\n") - 1) != 0) return NULL;
+  buf += sizeof("\r\n") - 1;
+
+  size_t lo = 0;
+  size_t hi = std::size(bta_hf_client_parsers);
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    const char* event = bta_hf_client_parsers[mid].event;
+    int cmp = strncmp(buf, event, strlen(event));
+    if (cmp == 0) return &bta_hf_client_parsers[mid];
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return NULL;
+}
 
 #ifdef BTA_HF_CLIENT_AT_DUMP
 static void bta_hf_client_dump_at(tBTA_HF_CLIENT_CB* client_cb) {
@@ -1662,23 +1715,15 @@ static void bta_hf_client_at_parse_start(tBTA_HF_CLIENT_CB* client_cb) {
 #endif
 
   while (*buf != '\0') {
-    int i;
-    char* tmp = NULL;
-
-    for (i = 0; i < bta_hf_client_parser_cb_count; i++) {
-      tmp = bta_hf_client_parser_cb[i](client_cb, buf);
-      if (tmp == NULL) {
-        log::error("HFPCient: AT event/reply parsing failed, skipping");
-        tmp = bta_hf_client_skip_unknown(client_cb, buf);
-        break;
-      }
+    char* tmp = buf;
 
-      /* matched or unknown skipped, if unknown failed tmp is NULL so
-         this is also handled */
-      if (tmp != buf) {
-        buf = tmp;
-        break;
-      }
+    const tBTA_HF_CLIENT_PARSER* p_parser = bta_hf_client_find_parser(buf);
+    if (p_parser != NULL) tmp = p_parser->parser(client_cb, buf);
+    if (tmp == buf) tmp = bta_hf_client_process_unknown(client_cb, buf);
+
+    if (tmp == NULL) {
+      log::error("HFPCient: AT event/reply parsing failed, skipping");
+      tmp = bta_hf_client_skip_unknown(client_cb, buf);
     }
 
     /* could not skip unknown (received garbage?)... disconnect */
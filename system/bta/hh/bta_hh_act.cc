@@ -1135,6 +1135,31 @@ void bta_hh_write_dev_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
 /*****************************************************************************
  *  Static Function
  ****************************************************************************/
+/*******************************************************************************
+ *
+ * Function         bta_hh_input_data
+ *
+ * Description      Hand an input report of a connected device to the call-out
+ *                  right away. The HID host callback already runs in the BTA
+ *                  context, going through the state machine would only queue
+ *                  the report behind the other events.
+ *
+ * Returns          true if the report was consumed.
+ *
+ ******************************************************************************/
+static bool bta_hh_input_data(uint8_t dev_handle, BT_HDR* pdata) {
+  uint8_t index = bta_hh_dev_handle_to_cb_idx(dev_handle);
+  if (index == BTA_HH_IDX_INVALID ||
+      bta_hh_cb.kdev[index].state != BTA_HH_CONN_ST) {
+    return false;
+  }
+
+  uint8_t* p_rpt = (uint8_t*)(pdata + 1) + pdata->offset;
+  bta_hh_co_data(dev_handle, p_rpt, pdata->len);
+  osi_free(pdata);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_cback
@@ -1160,6 +1185,9 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
       sm_event = BTA_HH_INT_CLOSE_EVT;
       break;
     case HID_HDEV_EVT_INTR_DATA:
+      if (bta_hh_input_data(dev_handle, pdata)) {
+        return;
+      }
       sm_event = BTA_HH_INT_DATA_EVT;
       break;
     case HID_HDEV_EVT_HANDSHAKE:
@@ -148,6 +148,17 @@ typedef struct {
 #define BTA_HH_LE_RPT_MAX 20
 #endif
 
+/* size of the open addressed table mapping a report value handle to its
+ * report entry, a power of 2 comfortably larger than BTA_HH_LE_RPT_MAX */
+#ifndef BTA_HH_LE_RPT_HANDLE_SLOTS
+#define BTA_HH_LE_RPT_HANDLE_SLOTS 32
+#endif
+
+typedef struct {
+  uint16_t handle; /* report value handle, 0 for an empty slot */
+  uint8_t rpt_idx; /* index of the report entry in tBTA_HH_LE_HID_SRVC */
+} tBTA_HH_LE_RPT_SLOT;
+
 enum tBTA_HH_SERVICE_STATE {
   BTA_HH_SERVICE_UNKNOWN,
   BTA_HH_SERVICE_CHANGED,
@@ -164,6 +175,7 @@ typedef struct {
   tBTA_HH_SERVICE_STATE state;
   uint8_t srvc_inst_id;
   tBTA_HH_LE_RPT report[BTA_HH_LE_RPT_MAX];
+  tBTA_HH_LE_RPT_SLOT rpt_by_handle[BTA_HH_LE_RPT_HANDLE_SLOTS];
 
   uint16_t proto_mode_handle;
   uint8_t control_point_handle;
@@ -215,6 +227,9 @@ typedef struct {
   tBTA_HH_STATUS status;
   tBTM_STATUS btm_status;
   tBTA_HH_LE_HID_SRVC hid_srvc;
+  tBTA_HH_LE_HID_SRVC changed_srvc; /* hid_srvc set aside on service change */
+  Octet16 db_hash;                  /* GATT database hash of hid_srvc */
+  bool db_hash_valid;
   uint16_t conn_id;
   bool in_bg_conn;
   uint8_t clt_cfg_idx;
@@ -84,6 +84,9 @@ static void bta_hh_le_add_dev_bg_conn(tBTA_HH_DEV_CB* p_cb);
 static void bta_hh_process_cache_rpt(tBTA_HH_DEV_CB* p_cb,
                                      tBTA_HH_RPT_CACHE_ENTRY* p_rpt_cache,
                                      uint8_t num_rpt);
+static void bta_hh_le_cache_report(tBTA_HH_DEV_CB* p_dev_cb,
+                                   const tBTA_HH_LE_RPT* p_rpt);
+static void bta_hh_le_drop_changed_srvc(tBTA_HH_DEV_CB* p_cb);
 static bool bta_hh_le_iso_data_callback(const RawAddress& addr,
                                         uint16_t cis_conn_hdl, uint8_t* data,
                                         uint16_t size, uint32_t timestamp);
@@ -360,6 +363,56 @@ static tBTA_HH_LE_RPT* bta_hh_le_find_report_entry(
   return NULL;
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_find_report_by_handle
+ *
+ * Description      find the report entry by its characteristic value handle,
+ *                  in constant time since it runs for every input report
+ *
+ ******************************************************************************/
+static tBTA_HH_LE_RPT* bta_hh_le_find_report_by_handle(tBTA_HH_DEV_CB* p_cb,
+                                                       uint16_t handle) {
+  tBTA_HH_LE_HID_SRVC* p_srvc = &p_cb->hid_srvc;
+  uint8_t slot = handle & (BTA_HH_LE_RPT_HANDLE_SLOTS - 1);
+
+  if (handle == 0) return NULL;
+
+  for (uint8_t i = 0; i < BTA_HH_LE_RPT_HANDLE_SLOTS; i++) {
+    const tBTA_HH_LE_RPT_SLOT* p_slot = &p_srvc->rpt_by_handle[slot];
+    if (p_slot->handle == 0) return NULL;
+    if (p_slot->handle == handle) return &p_srvc->report[p_slot->rpt_idx];
+    slot = (slot + 1) & (BTA_HH_LE_RPT_HANDLE_SLOTS - 1);
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_index_report
+ *
+ * Description      add a newly allocated report entry to the value handle
+ *                  table used by bta_hh_le_find_report_by_handle
+ *
+ ******************************************************************************/
+static void bta_hh_le_index_report(tBTA_HH_LE_HID_SRVC* p_srvc,
+                                   const tBTA_HH_LE_RPT* p_rpt) {
+  uint16_t handle = p_rpt->char_inst_id;
+  uint8_t slot = handle & (BTA_HH_LE_RPT_HANDLE_SLOTS - 1);
+
+  if (handle == 0) return;
+
+  for (uint8_t i = 0; i < BTA_HH_LE_RPT_HANDLE_SLOTS; i++) {
+    tBTA_HH_LE_RPT_SLOT* p_slot = &p_srvc->rpt_by_handle[slot];
+    if (p_slot->handle == 0 || p_slot->handle == handle) {
+      p_slot->handle = handle;
+      p_slot->rpt_idx = p_rpt->index;
+      return;
+    }
+    slot = (slot + 1) & (BTA_HH_LE_RPT_HANDLE_SLOTS - 1);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_le_find_rpt_by_idtype
@@ -444,6 +497,8 @@ tBTA_HH_LE_RPT* bta_hh_le_find_alloc_report_entry(tBTA_HH_DEV_CB* p_cb,
             break;
           }
         }
+
+        bta_hh_le_index_report(&p_cb->hid_srvc, p_rpt);
       }
       return p_rpt;
     }
@@ -506,6 +561,20 @@ void bta_hh_le_save_report_ref(tBTA_HH_DEV_CB* p_dev_cb, tBTA_HH_LE_RPT* p_rpt,
   if (p_rpt->rpt_type > BTA_HH_RPTT_FEATURE) /* invalid report type */
     p_rpt->rpt_type = BTA_HH_RPTT_RESRV;
 
+  bta_hh_le_cache_report(p_dev_cb, p_rpt);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_cache_report
+ *
+ * Description      save a report entry into the persistent report cache.
+ *
+ * Parameters:
+ *
+ ******************************************************************************/
+static void bta_hh_le_cache_report(tBTA_HH_DEV_CB* p_dev_cb,
+                                   const tBTA_HH_LE_RPT* p_rpt) {
   tBTA_HH_RPT_CACHE_ENTRY rpt_entry;
   rpt_entry.rpt_id = p_rpt->rpt_id;
   rpt_entry.rpt_type = p_rpt->rpt_type;
@@ -619,6 +688,9 @@ static void bta_hh_le_deregister_input_notif(tBTA_HH_DEV_CB* p_dev_cb) {
 static void bta_hh_le_open_cmpl(tBTA_HH_DEV_CB* p_cb) {
   if (p_cb->disc_active == BTA_HH_LE_DISC_NONE) {
     bta_hh_le_hid_report_dbg(p_cb);
+    bta_hh_le_drop_changed_srvc(p_cb);
+    p_cb->db_hash_valid =
+        BTA_GATTC_GetDatabaseHash(p_cb->conn_id, &p_cb->db_hash);
     bta_hh_le_register_input_notif(p_cb, p_cb->mode, true);
     bta_hh_sm_execute(p_cb, BTA_HH_OPEN_CMPL_EVT, NULL);
 
@@ -1091,6 +1163,20 @@ static void bta_hh_clear_service_cache(tBTA_HH_DEV_CB* p_cb) {
   memset(p_hid_srvc, 0, sizeof(tBTA_HH_LE_HID_SRVC));
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_drop_changed_srvc
+ *
+ * Description      free the HID service set aside on service change
+ *
+ * Parameters:
+ *
+ ******************************************************************************/
+static void bta_hh_le_drop_changed_srvc(tBTA_HH_DEV_CB* p_cb) {
+  osi_free_and_reset((void**)&p_cb->changed_srvc.rpt_map);
+  p_cb->changed_srvc = {};
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_start_security
@@ -1424,8 +1510,9 @@ static void read_pref_conn_params_cb(uint16_t conn_id, tGATT_STATUS status,
 
   BTM_BleSetPrefConnParams(p_dev_cb->link_spec.addrt.bda, min_interval,
                            max_interval, latency, timeout);
-  if (!L2CA_UpdateBleConnParams(p_dev_cb->link_spec.addrt.bda, min_interval,
-                                max_interval, latency, timeout, 0, 0)) {
+  if (!L2CA_UpdateBleConnParamsForClient(
+          L2CAP_CONN_PARAMS_CLIENT_HID, p_dev_cb->link_spec.addrt.bda,
+          min_interval, max_interval, latency, timeout, 0, 0)) {
     log::warn("Unable to update L2CAP ble connection params peer:{}",
               p_dev_cb->link_spec.addrt.bda);
   }
@@ -1641,36 +1728,20 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
     return;
   }
 
-  const gatt::Characteristic* p_char =
-      BTA_GATTC_GetCharacteristic(p_dev_cb->conn_id, p_data->handle);
-  if (p_char == NULL) {
-    log::error("Unknown Characteristic, conn_id:0x{:04x}, handle:0x{:04x}",
-               p_dev_cb->conn_id, p_data->handle);
-    return;
-  }
-
-  const gatt::Service* p_svc =
-      BTA_GATTC_GetOwningService(p_dev_cb->conn_id, p_char->value_handle);
-
-  if (!p_char->uuid.Is16Bit()) {
-    log::error("Unexpected characteristic len: {}", p_char->uuid.ToString());
-    return;
-  }
-
-  p_rpt = bta_hh_le_find_report_entry(p_dev_cb, p_svc->handle,
-                                      bta_hh_get_uuid16(p_dev_cb, p_char->uuid),
-                                      p_char->value_handle);
+  p_rpt = bta_hh_le_find_report_by_handle(p_dev_cb, p_data->handle);
   if (p_rpt == NULL) {
-    log::error("Unknown Report, uuid:{}, handle:0x{:04x}",
-               p_char->uuid.ToString(), p_char->value_handle);
+    log::error("Unknown Report, conn_id:0x{:04x}, handle:0x{:04x}",
+               p_dev_cb->conn_id, p_data->handle);
     return;
   }
 
   log::verbose("report ID: {}", p_rpt->rpt_id);
 
-  /* need to append report ID to the head of data */
+  /* need to append report ID to the head of data, the notification is copied
+   * on the stack rather than allocated since it happens for every report */
+  uint8_t rpt_buf[GATT_MAX_ATTR_LEN + 1];
   if (p_rpt->rpt_id != 0) {
-    p_buf = (uint8_t*)osi_malloc(p_data->len + 1);
+    p_buf = rpt_buf;
 
     p_buf[0] = p_rpt->rpt_id;
     memcpy(&p_buf[1], p_data->value, p_data->len);
@@ -1680,8 +1751,6 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
   }
 
   bta_hh_co_data((uint8_t)p_dev_cb->hid_handle, p_buf, p_data->len);
-
-  if (p_buf != p_data->value) osi_free(p_buf);
 }
 
 /*******************************************************************************
@@ -2177,10 +2246,18 @@ static void bta_hh_le_service_changed(tAclLinkSpec link_spec) {
     return;
   }
 
-  /* Forget the cached reports */
+  /* Forget the cached reports, but set the parsed HID service aside so that
+     it can be restored without reading the report map again if the
+     rediscovered database turns out to be unchanged */
   bta_hh_le_co_reset_rpt_cache(p_cb->link_spec, p_cb->app_id);
   p_cb->dscp_info.descriptor.dsc_list = NULL;
-  osi_free_and_reset((void**)&p_cb->hid_srvc.rpt_map);
+  bta_hh_le_drop_changed_srvc(p_cb);
+  if (p_cb->db_hash_valid &&
+      p_cb->hid_srvc.state >= BTA_HH_SERVICE_DISCOVERED) {
+    p_cb->changed_srvc = p_cb->hid_srvc;
+  } else {
+    osi_free_and_reset((void**)&p_cb->hid_srvc.rpt_map);
+  }
   p_cb->hid_srvc = {};
   p_cb->hid_srvc.state = BTA_HH_SERVICE_CHANGED;
   p_cb->status = BTA_HH_HS_SERVICE_CHANGED;
@@ -2212,7 +2289,20 @@ static void bta_hh_le_service_discovery_done(tAclLinkSpec link_spec) {
   if (p_cb->hid_srvc.state == BTA_HH_SERVICE_CHANGED) {
     /* Service rediscovery completed after service change.
        Pretend to have connected with a new HOGP device. */
-    p_cb->hid_srvc.state = BTA_HH_SERVICE_UNKNOWN;
+    Octet16 db_hash;
+    if (p_cb->changed_srvc.state >= BTA_HH_SERVICE_DISCOVERED &&
+        BTA_GATTC_GetDatabaseHash(p_cb->conn_id, &db_hash) &&
+        db_hash == p_cb->db_hash) {
+      log::info("GATT database unchanged, reusing HID service:{}", link_spec);
+      p_cb->hid_srvc = p_cb->changed_srvc;
+      p_cb->changed_srvc = {};
+      for (const tBTA_HH_LE_RPT& rpt : p_cb->hid_srvc.report) {
+        if (rpt.in_use) bta_hh_le_cache_report(p_cb, &rpt);
+      }
+    } else {
+      bta_hh_le_drop_changed_srvc(p_cb);
+      p_cb->hid_srvc.state = BTA_HH_SERVICE_UNKNOWN;
+    }
     const tBTA_GATTC_OPEN open = {
         .status = GATT_SUCCESS,
         .conn_id = p_cb->conn_id,
@@ -140,6 +140,7 @@ void bta_hh_clean_up_kdev(tBTA_HH_DEV_CB* p_cb) {
 
   /* Free buffer for report descriptor info */
   osi_free_and_reset((void**)&p_cb->dscp_info.descriptor.dsc_list);
+  osi_free_and_reset((void**)&p_cb->changed_srvc.rpt_map);
 
   memset(p_cb, 0, sizeof(tBTA_HH_DEV_CB)); /* Reset control block */
 
@@ -592,6 +592,21 @@ void BTA_GATTC_DiscoverServiceByUuid(uint16_t conn_id,
  ******************************************************************************/
 const std::list<gatt::Service>* BTA_GATTC_GetServices(uint16_t conn_id);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_GetDatabaseHash
+ *
+ * Description      This function is called to compute the hash of the GATT
+ *                  database discovered on the given server.
+ *
+ * Parameters       conn_id: connection ID which identify the server.
+ *                  p_hash: receives the database hash
+ *
+ * Returns          false if the server database is not discovered.
+ *
+ ******************************************************************************/
+bool BTA_GATTC_GetDatabaseHash(uint16_t conn_id, Octet16* p_hash);
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_GetCharacteristic
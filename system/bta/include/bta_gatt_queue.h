@@ -18,9 +18,11 @@
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bta/include/bta_gatt_api.h"
+#include "common/latency_histogram.h"
 
 /* BTA GATTC implementation does not allow for multiple commands queuing. So one
  * client making calls to BTA_GATTC_ReadCharacteristic, BTA_GATTC_ReadCharDescr,
@@ -32,6 +34,13 @@
  *
  * If you decide to use those methods in your app, make sure to not mix it with
  * existing BTA_GATTC_* API.
+ *
+ * A read queued behind another read of the same handle, with no write or MTU
+ * exchange in between, is not sent again: both callbacks get the same value.
+ *
+ * Consecutive reads are sent in a single Read Multiple Variable Length request
+ * when the server supports EATT, which makes that request mandatory. The reads
+ * it can't answer in full are sent again one by one.
  */
 class BtaGattQueue {
  public:
@@ -53,6 +62,7 @@ class BtaGattQueue {
                                       tBTA_GATTC_MULTI& p_read_multi,
                                       bool variable_len,
                                       GATT_READ_MULTI_OP_CB cb, void* cb_data);
+  static void DebugDump(int fd);
 
   /* Holds pending GATT operations */
   struct gatt_operation {
@@ -71,6 +81,15 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* read-specific fields, callbacks of the reads merged into this one */
+    std::vector<std::pair<GATT_READ_OP_CB, void*>> coalesced_reads;
+
+    /* time the operation was queued, to measure the time it waited */
+    uint64_t queued_us;
+
+    /* set for the reads sent again after a failed batch */
+    bool read_alone;
   };
 
  private:
@@ -84,6 +103,17 @@ class BtaGattQueue {
                                      const uint8_t* value, void* data);
   static void gatt_configure_mtu_op_finished(uint16_t conn_id,
                                              tGATT_STATUS status, void* data);
+  static bool coalesce_read(std::list<gatt_operation>& gatt_ops, uint8_t type,
+                            uint16_t handle, GATT_READ_OP_CB cb,
+                            void* cb_data);
+  static bool read_multi_var_supported(uint16_t conn_id);
+  static bool gatt_execute_batched_read(uint16_t conn_id,
+                                        std::list<gatt_operation>& gatt_ops);
+  static void gatt_batched_read_op_finished(uint16_t conn_id,
+                                            tGATT_STATUS status,
+                                            tBTA_GATTC_MULTI& handles,
+                                            uint16_t len, uint8_t* value,
+                                            void* data);
   static void gatt_read_multi_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                           tBTA_GATTC_MULTI& handle,
                                           uint16_t len, uint8_t* value,
@@ -92,4 +122,13 @@ class BtaGattQueue {
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
   // contain connection ids that currently execute operations
   static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // time spent by the operations in the queue before being sent
+  static bluetooth::common::LatencyHistogram gatt_op_queue_wait_us;
+  // number of reads answered with the value of another queued read
+  static size_t gatt_op_coalesced_reads;
+  // connection ids of the servers that rejected Read Multiple Variable Length
+  static std::unordered_set<uint16_t> gatt_op_read_multi_var_rejected;
+  // number of reads sent in batches, and of batches
+  static size_t gatt_op_batched_reads;
+  static size_t gatt_op_read_batches;
 };
@@ -18,8 +18,13 @@
  *
  ******************************************************************************/
 
+#define ATRACE_TAG ATRACE_TAG_AUDIO
+
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
+#ifdef __ANDROID__
+#include <cutils/trace.h>
+#endif
 
 #include <optional>
 
@@ -27,6 +32,7 @@
 #include "audio_hal_client.h"
 #include "audio_hal_interface/le_audio_software.h"
 #include "bta/le_audio/codec_manager.h"
+#include "common/latency_histogram.h"
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
 #include "gd/hal/link_clocker.h"
@@ -40,6 +46,13 @@ struct AudioHalStats {
   size_t media_read_total_underflow_bytes;
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
+  /* Time spent reading the audio HAL, and in the whole audio tick which also
+   * encodes and sends the data */
+  bluetooth::common::LatencyHistogram media_read_time;
+  bluetooth::common::LatencyHistogram media_tick_time;
+  /* Audio ticks which took longer than the data interval */
+  size_t media_tick_overrun_count;
+  uint64_t media_tick_last_overrun_us;
 
   AudioHalStats() { Reset(); }
 
@@ -47,6 +60,10 @@ struct AudioHalStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    media_read_time.Reset();
+    media_tick_time.Reset();
+    media_tick_overrun_count = 0;
+    media_tick_last_overrun_us = 0;
   }
 } sStats;
 
@@ -216,12 +233,17 @@ void SourceImpl::SendAudioData() {
       1000;
   std::vector<uint8_t> data(bytes_per_tick);
 
+  const uint64_t tick_start_us = bluetooth::common::time_get_os_boottime_us();
   uint32_t bytes_read = halSinkInterface_->Read(data.data(), bytes_per_tick);
+  const uint64_t read_end_us = bluetooth::common::time_get_os_boottime_us();
+  sStats.media_read_time.Add(read_end_us - tick_start_us);
+#ifdef __ANDROID__
+  ATRACE_INT("LE Audio HAL read us", read_end_us - tick_start_us);
+#endif
   if (bytes_read < bytes_per_tick) {
     sStats.media_read_total_underflow_bytes += bytes_per_tick - bytes_read;
     sStats.media_read_total_underflow_count++;
-    sStats.media_read_last_underflow_us =
-        bluetooth::common::time_get_os_boottime_us();
+    sStats.media_read_last_underflow_us = read_end_us;
   }
 
   if (com::android::bluetooth::flags::leaudio_hal_client_asrc()) {
@@ -239,6 +261,17 @@ void SourceImpl::SendAudioData() {
       audioSourceCallbacks_->OnAudioDataReady(data);
     }
   }
+
+  const uint64_t tick_end_us = bluetooth::common::time_get_os_boottime_us();
+  const uint64_t tick_us = tick_end_us - tick_start_us;
+  sStats.media_tick_time.Add(tick_us);
+#ifdef __ANDROID__
+  ATRACE_INT("LE Audio HAL tick us", tick_us);
+#endif
+  if (tick_us > source_codec_config_.data_interval_us) {
+    sStats.media_tick_overrun_count++;
+    sStats.media_tick_last_overrun_us = tick_end_us;
+  }
 }
 
 bool SourceImpl::InitAudioSinkThread() {
@@ -575,6 +608,18 @@ void LeAudioSourceAudioHalClient::DebugDump(int fd) {
                                         sStats.media_read_last_underflow_us) /
                        1000
                  : 0)
+         << "\n    Read time (us)                                          : "
+         << sStats.media_read_time.ToString()
+         << "\n    Read, encode and send time (us)                         : "
+         << sStats.media_tick_time.ToString()
+         << "\n    Counts (over data interval)                             : "
+         << sStats.media_tick_overrun_count
+         << "\n    Last update time ago in ms (over data interval)         : "
+         << (sStats.media_tick_last_overrun_us > 0
+                 ? (unsigned long long)(now_us -
+                                        sStats.media_tick_last_overrun_us) /
+                       1000
+                 : 0)
          << std::endl;
   dprintf(fd, "%s", stream.str().c_str());
 }
@@ -29,11 +29,14 @@
 #include "bta/le_audio/le_audio_utils.h"
 #include "bta/le_audio/metrics_collector.h"
 #include "bta_le_audio_api.h"
+#include "common/latency_histogram.h"
 #include "common/strings.h"
+#include "common/time_util.h"
 #include "hci/controller_interface.h"
 #include "internal_include/stack_config.h"
 #include "main/shim/entry.h"
 #include "os/log.h"
+#include "osi/include/alarm.h"
 #include "osi/include/properties.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/btm_api_types.h"
@@ -95,7 +98,8 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       : callbacks_(callbacks_),
         current_phy_(PHY_LE_2M),
         audio_data_path_state_(AudioDataPathState::INACTIVE),
-        le_audio_source_hal_client_(nullptr) {
+        le_audio_source_hal_client_(nullptr),
+        big_idle_timeout_(alarm_new("LeAudioBroadcastBigIdleTimeout")) {
     log::info("");
 
     /* Register State machine callbacks */
@@ -105,7 +109,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     GenerateBroadcastIds();
   }
 
-  ~LeAudioBroadcasterImpl() override = default;
+  ~LeAudioBroadcasterImpl() override { alarm_free(big_idle_timeout_); }
 
   void GenerateBroadcastIds(void) {
     btsnd_hcic_ble_rand(base::Bind([](BT_OCTET8 rand) {
@@ -661,14 +665,41 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     if (broadcasts_.count(broadcast_id) != 0) {
       log::info("Stopping AudioHalClient");
       if (le_audio_source_hal_client_) le_audio_source_hal_client_->Stop();
-      broadcasts_[broadcast_id]->SetMuted(true);
-      broadcasts_[broadcast_id]->ProcessMessage(
-          BroadcastStateMachine::Message::SUSPEND, nullptr);
+
+      /* Keep the BIG for a while, resuming the audio then skips its creation
+       * and the setup of the data paths */
+      auto timeout_ms = osi_property_get_int32(kBigIdleTimeoutMsProp,
+                                               kBigIdleTimeoutMsDefault);
+      auto& broadcast = broadcasts_[broadcast_id];
+      broadcast->SetKeepBigOnSuspend(timeout_ms > 0);
+      broadcast->SetMuted(true);
+      broadcast->ProcessMessage(BroadcastStateMachine::Message::SUSPEND,
+                                nullptr);
+
+      if (broadcast->IsBigKept()) {
+        alarm_set_on_mloop(
+            big_idle_timeout_, timeout_ms,
+            [](void* data) {
+              if (instance) instance->ReleaseKeptBig(PTR_TO_UINT(data));
+            },
+            UINT_TO_PTR(broadcast_id));
+      }
     } else {
       log::error("No such broadcast_id={}", broadcast_id);
     }
   }
 
+  void ReleaseKeptBig(uint32_t broadcast_id) {
+    if (broadcasts_.count(broadcast_id) == 0 ||
+        !broadcasts_[broadcast_id]->IsBigKept()) {
+      return;
+    }
+
+    log::info("Releasing the idle BIG of broadcast_id={}", broadcast_id);
+    broadcasts_[broadcast_id]->ProcessMessage(
+        BroadcastStateMachine::Message::SUSPEND, nullptr);
+  }
+
   static bool IsAnyoneStreaming() {
     if (!instance) return false;
 
@@ -689,7 +720,10 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       return;
     }
 
-    if (is_iso_running_) {
+    /* A kept BIG is the ISO traffic of this broadcast */
+    const bool is_big_kept = broadcasts_.count(broadcast_id) != 0 &&
+                             broadcasts_[broadcast_id]->IsBigKept();
+    if (is_iso_running_ && !is_big_kept) {
       queued_start_broadcast_request_ = broadcast_id;
       return;
     }
@@ -714,6 +748,10 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         log::assert_that(result, "Could not update session in codec manager");
       }
 
+      if (is_big_kept) alarm_cancel(big_idle_timeout_);
+      start_stats_.requested_us = bluetooth::common::time_get_os_boottime_us();
+      start_stats_.is_big_kept = is_big_kept;
+
       broadcasts_[broadcast_id]->ProcessMessage(
           BroadcastStateMachine::Message::START, nullptr);
       bluetooth::le_audio::MetricsCollector::Get()->OnBroadcastStateChanged(
@@ -731,6 +769,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
     log::info("Stopping AudioHalClient, broadcast_id={}", broadcast_id);
 
+    if (broadcasts_[broadcast_id]->IsBigKept()) alarm_cancel(big_idle_timeout_);
     if (le_audio_source_hal_client_) le_audio_source_hal_client_->Stop();
     broadcasts_[broadcast_id]->SetMuted(true);
     broadcasts_[broadcast_id]->ProcessMessage(
@@ -741,6 +780,10 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
   void DestroyAudioBroadcast(uint32_t broadcast_id) override {
     log::info("Destroying broadcast_id={}", broadcast_id);
+    if (broadcasts_.count(broadcast_id) != 0 &&
+        broadcasts_[broadcast_id]->IsBigKept()) {
+      alarm_cancel(big_idle_timeout_);
+    }
     broadcasts_.erase(broadcast_id);
 
     if (broadcasts_.empty() && le_audio_source_hal_client_) {
@@ -908,10 +951,31 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     }
   }
 
+  void UpdateStartStats(void) {
+    if (start_stats_.requested_us == 0) return;
+
+    auto latency_us =
+        bluetooth::common::time_get_os_boottime_us() - start_stats_.requested_us;
+    start_stats_.requested_us = 0;
+    if (start_stats_.is_big_kept) {
+      start_stats_.big_kept.Add(latency_us);
+    } else {
+      start_stats_.big_created.Add(latency_us);
+    }
+  }
+
   void Dump(int fd) {
     std::stringstream stream;
 
     stream << "    Number of broadcasts: " << broadcasts_.size() << "\n";
+    stream << "    Start latency with BIG creation (us): count: "
+           << start_stats_.big_created.Count()
+           << ", avg: " << start_stats_.big_created.AverageUs()
+           << ", max: " << start_stats_.big_created.MaxUs() << "\n";
+    stream << "    Start latency with kept BIG (us): count: "
+           << start_stats_.big_kept.Count()
+           << ", avg: " << start_stats_.big_kept.AverageUs()
+           << ", max: " << start_stats_.big_kept.MaxUs() << "\n";
     for (auto& broadcast_pair : broadcasts_) {
       auto& broadcast = broadcast_pair.second;
       if (broadcast) stream << *broadcast;
@@ -1006,6 +1070,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
               }
 
               instance->audio_data_path_state_ = AudioDataPathState::ACTIVE;
+              instance->UpdateStartStats();
             }
           }
           break;
@@ -1207,12 +1272,14 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       const auto bytes_per_sample = (subgroup_config.GetBitsPerSample() / 8);
 
       /* Prepare encoded data for all channels */
+      std::vector<bluetooth::le_audio::CodecInterface*> encoders;
+      std::vector<uint16_t> out_sizes;
       for (uint8_t bis_idx = 0; bis_idx < num_bis; ++bis_idx) {
-        auto initial_channel_offset = bis_idx * bytes_per_sample;
-        sw_enc_[bis_idx]->Encode(
-            data.data() + initial_channel_offset, num_bis,
-            subgroup_config.GetBisOctetsPerCodecFrame(bis_idx));
+        encoders.push_back(sw_enc_[bis_idx].get());
+        out_sizes.push_back(subgroup_config.GetBisOctetsPerCodecFrame(bis_idx));
       }
+      bluetooth::le_audio::CodecInterface::EncodeChannels(
+          encoders, data.data(), bytes_per_sample, out_sizes);
 
       /* Currently there is no way to broadcast multiple distinct streams.
        * We just receive all system sounds mixed into a one stream and each
@@ -1288,6 +1355,20 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
   // Flag to track iso state
   bool is_iso_running_ = false;
+
+  /* How long the BIG is kept once the audio is suspended, 0 disables it */
+  static constexpr int32_t kBigIdleTimeoutMsDefault = 0;
+  static constexpr char kBigIdleTimeoutMsProp[] =
+      "persist.bluetooth.leaudio.broadcast.big_idle_timeoutms";
+  alarm_t* big_idle_timeout_;
+
+  /* Time from the start request to the audio being started */
+  struct {
+    uint64_t requested_us = 0;
+    bool is_big_kept = false;
+    bluetooth::common::LatencyHistogram big_created;
+    bluetooth::common::LatencyHistogram big_kept;
+  } start_stats_;
 };
 
 /* Static members definitions */
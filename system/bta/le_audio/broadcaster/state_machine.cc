@@ -60,10 +60,11 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   BroadcastStateMachineImpl(BroadcastStateMachineConfig msg)
       : active_config_(std::nullopt),
         sm_config_(std::move(msg)),
-        suspending_(false) {}
+        suspending_(false),
+        releasing_kept_big_(false) {}
 
   ~BroadcastStateMachineImpl() {
-    if (GetState() == State::STREAMING) TerminateBig();
+    if (GetState() == State::STREAMING || big_kept_) TerminateBig();
     DestroyBroadcastAnnouncement();
     if (callbacks_) callbacks_->OnStateMachineDestroyed(GetBroadcastId());
   }
@@ -243,6 +244,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   std::optional<BigConfig> active_config_;
   BroadcastStateMachineConfig sm_config_;
   bool suspending_;
+  bool releasing_kept_big_;
 
   /* Message handlers for each possible state */
   typedef std::function<void(const void*)> msg_handler_t;
@@ -257,7 +259,13 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
           /* in CONFIGURING state */
           [](const void*) { /* Do nothing */ },
           /* in CONFIGURED state */
-          [this](const void*) { CreateBig(); },
+          [this](const void*) {
+            if (big_kept_) {
+              ResumeKeptBig();
+            } else {
+              CreateBig();
+            }
+          },
           /* in STOPPING state */
           [](const void*) { /* Do nothing */ },
           /* in STREAMING state */
@@ -273,7 +281,13 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
           [this](const void*) {
             SetState(State::STOPPING);
             callbacks_->OnStateMachineEvent(GetBroadcastId(), GetState());
-            DisableAnnouncement();
+            if (big_kept_) {
+              /* Announcement is disabled once the kept BIG is terminated */
+              big_kept_ = false;
+              TriggerIsoDatapathTeardown(active_config_->connection_handles[0]);
+            } else {
+              DisableAnnouncement();
+            }
           },
           /* in STOPPING state */
           [](const void*) { /* Do nothing */ },
@@ -294,12 +308,24 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
           /* in CONFIGURING state */
           [](const void*) { /* Do nothing */ },
           /* in CONFIGURED state */
-          [](const void*) { /* Already suspended */ },
+          [this](const void*) {
+            /* Already suspended, release the BIG kept alive if any */
+            if (big_kept_ && !suspending_) {
+              big_kept_ = false;
+              suspending_ = true;
+              releasing_kept_big_ = true;
+              TriggerIsoDatapathTeardown(active_config_->connection_handles[0]);
+            }
+          },
           /* in STOPPING state */
           [](const void*) { /* Do nothing */ },
           /* in STREAMING state */
           [this](const void*) {
             if ((active_config_ != std::nullopt) && !suspending_) {
+              if (keep_big_on_suspend_) {
+                KeepBig();
+                return;
+              }
               suspending_ = true;
               TriggerIsoDatapathTeardown(active_config_->connection_handles[0]);
             }
@@ -410,6 +436,23 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
                                          std::move(big_params));
   }
 
+  void KeepBig(void) {
+    log::info("broadcast_id={}, keeping BIG with {} BISes", GetBroadcastId(),
+              active_config_->connection_handles.size());
+    /* No SDUs are sent while muted, the controller fills the BIG events */
+    SetMuted(true);
+    big_kept_ = true;
+    SetState(State::CONFIGURED);
+    callbacks_->OnStateMachineEvent(GetBroadcastId(), GetState(), nullptr);
+  }
+
+  void ResumeKeptBig(void) {
+    log::info("broadcast_id={}, resuming kept BIG", GetBroadcastId());
+    big_kept_ = false;
+    SetState(State::STREAMING);
+    callbacks_->OnStateMachineEvent(GetBroadcastId(), GetState(), nullptr);
+  }
+
   void DisableAnnouncement(void) {
     log::info("broadcast_id={}", GetBroadcastId());
     // Callback is handled by OnAdvertisingEnabled() which returns the status
@@ -583,8 +626,12 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
 
         /* Check if we got this HCI event due to STOP or SUSPEND message. */
         if (suspending_) {
-          callbacks_->OnStateMachineEvent(GetBroadcastId(), GetState(), evt);
+          /* Suspension of a kept BIG was already reported */
+          if (!releasing_kept_big_) {
+            callbacks_->OnStateMachineEvent(GetBroadcastId(), GetState(), evt);
+          }
           suspending_ = false;
+          releasing_kept_big_ = false;
         } else {
           DisableAnnouncement();
         }
@@ -709,7 +756,9 @@ std::ostream& operator<<(
     const bluetooth::le_audio::broadcaster::BroadcastStateMachine& machine) {
   os << "    Broadcast state machine: {"
      << "      Advertising SID: " << +machine.GetAdvertisingSid() << "\n"
-     << "      State: " << machine.GetState() << "\n";
+     << "      State: " << machine.GetState() << "\n"
+     << "      BIG kept alive: " << (machine.IsBigKept() ? "yes" : "no")
+     << "\n";
   os << "      State Machine Config: " << machine.GetStateMachineConfig()
      << "\n";
 
@@ -183,6 +183,13 @@ class BroadcastStateMachine : public StateMachine<5> {
   void SetMuted(bool muted) { is_muted_ = muted; };
   bool IsMuted() const { return is_muted_; };
 
+  /* When set, SUSPEND keeps the BIG and its data paths while the announcement
+   * goes back to CONFIGURED, so that START resumes the audio without creating
+   * them again. SUSPEND in CONFIGURED then tears the kept BIG down.
+   */
+  void SetKeepBigOnSuspend(bool keep) { keep_big_on_suspend_ = keep; };
+  bool IsBigKept() const { return big_kept_; };
+
   virtual void HandleHciEvent(uint16_t event, void* data) = 0;
   virtual void OnSetupIsoDataPath(uint8_t status, uint16_t conn_handle) = 0;
   virtual void OnRemoveIsoDataPath(uint8_t status, uint16_t conn_handle) = 0;
@@ -200,6 +207,8 @@ class BroadcastStateMachine : public StateMachine<5> {
 
   uint8_t advertising_sid_ = kAdvSidUndefined;
   bool is_muted_ = false;
+  bool keep_big_on_suspend_ = false;
+  bool big_kept_ = false;
 
   RawAddress addr_ = RawAddress::kEmpty;
   uint8_t addr_type_ = 0;
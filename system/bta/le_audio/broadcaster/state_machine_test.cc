@@ -685,6 +685,68 @@ TEST_F(StateMachineTest, ProcessMessageSuspendWhenStreaming) {
             BroadcastStateMachine::State::CONFIGURED);
 }
 
+TEST_F(StateMachineTest, ProcessMessageSuspendWhenStreamingKeepsBig) {
+  auto broadcast_id = InstantiateStateMachine(
+      bluetooth::le_audio::types::LeAudioContextType::MEDIA);
+
+  broadcasts_[broadcast_id]->SetKeepBigOnSuspend(true);
+  broadcasts_[broadcast_id]->ProcessMessage(
+      BroadcastStateMachine::Message::START);
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::STREAMING);
+
+  /* BIG and data paths stay in place while suspended */
+  EXPECT_CALL(*mock_iso_manager_, RemoveIsoDataPath).Times(0);
+  EXPECT_CALL(*mock_iso_manager_, TerminateBig).Times(0);
+  EXPECT_CALL(*(sm_callbacks_.get()),
+              OnStateMachineEvent(broadcast_id,
+                                  BroadcastStateMachine::State::CONFIGURED, _))
+      .Times(1);
+  broadcasts_[broadcast_id]->ProcessMessage(
+      BroadcastStateMachine::Message::SUSPEND);
+
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::CONFIGURED);
+  ASSERT_TRUE(broadcasts_[broadcast_id]->IsBigKept());
+  ASSERT_TRUE(broadcasts_[broadcast_id]->IsMuted());
+  Mock::VerifyAndClearExpectations(mock_iso_manager_);
+  Mock::VerifyAndClearExpectations(sm_callbacks_.get());
+
+  /* Resuming does not create the BIG again */
+  EXPECT_CALL(*mock_iso_manager_, CreateBig).Times(0);
+  EXPECT_CALL(*mock_iso_manager_, SetupIsoDataPath).Times(0);
+  EXPECT_CALL(*(sm_callbacks_.get()),
+              OnStateMachineEvent(broadcast_id,
+                                  BroadcastStateMachine::State::STREAMING, _))
+      .Times(1);
+  broadcasts_[broadcast_id]->ProcessMessage(
+      BroadcastStateMachine::Message::START);
+
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::STREAMING);
+  ASSERT_FALSE(broadcasts_[broadcast_id]->IsBigKept());
+  Mock::VerifyAndClearExpectations(mock_iso_manager_);
+  Mock::VerifyAndClearExpectations(sm_callbacks_.get());
+
+  /* Suspending again in the configured state releases the kept BIG, without
+   * reporting the suspension twice */
+  broadcasts_[broadcast_id]->ProcessMessage(
+      BroadcastStateMachine::Message::SUSPEND);
+  ASSERT_TRUE(broadcasts_[broadcast_id]->IsBigKept());
+
+  EXPECT_CALL(*mock_iso_manager_, RemoveIsoDataPath).Times(2);
+  EXPECT_CALL(*mock_iso_manager_, TerminateBig).Times(1);
+  EXPECT_CALL(*(sm_callbacks_.get()), OnStateMachineEvent(broadcast_id, _, _))
+      .Times(0);
+  broadcasts_[broadcast_id]->ProcessMessage(
+      BroadcastStateMachine::Message::SUSPEND);
+
+  ASSERT_EQ(broadcasts_[broadcast_id]->GetState(),
+            BroadcastStateMachine::State::CONFIGURED);
+  ASSERT_FALSE(broadcasts_[broadcast_id]->IsBigKept());
+  ASSERT_FALSE(broadcasts_[broadcast_id]->GetBigConfig().has_value());
+}
+
 TEST_F(StateMachineTest, ProcessMessageStartWhenStopped) {
   auto broadcast_id = InstantiateStateMachine(
       bluetooth::le_audio::types::LeAudioContextType::MEDIA);
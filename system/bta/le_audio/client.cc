@@ -15,10 +15,15 @@
  * limitations under the License.
  */
 
+#define ATRACE_TAG ATRACE_TAG_AUDIO
+
 #include <base/functional/bind.h>
 #include <base/strings/string_number_conversions.h>
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
+#ifdef __ANDROID__
+#include <cutils/trace.h>
+#endif
 #include <lc3.h>
 
 #include <deque>
@@ -39,6 +44,7 @@
 #include "client_parser.h"
 #include "codec_interface.h"
 #include "codec_manager.h"
+#include "common/latency_histogram.h"
 #include "common/strings.h"
 #include "common/time_util.h"
 #include "content_control_id_keeper.h"
@@ -3408,9 +3414,11 @@ class LeAudioClientImpl : public LeAudioClient {
         sw_enc_left->Encode(mono.data(), 1, byte_count);
       }
     } else {
-      sw_enc_left->Encode(data.data(), 2, byte_count);
-      sw_enc_right->Encode(data.data() + bytes_per_sample, 2, byte_count);
+      bluetooth::le_audio::CodecInterface::EncodeChannels(
+          {sw_enc_left.get(), sw_enc_right.get()}, data.data(),
+          bytes_per_sample, {byte_count, byte_count});
     }
+    sw_enc_timing_.encoded_us = bluetooth::common::time_get_os_boottime_us();
 
     log::debug("left_cis_handle: {} right_cis_handle: {}", left_cis_handle,
                right_cis_handle);
@@ -3457,6 +3465,7 @@ class LeAudioClientImpl : public LeAudioClient {
       sw_enc_right->Encode((const uint8_t*)data.data() + 2, 2, byte_count,
                            &sw_enc_left->GetDecodedSamples(), byte_count);
     }
+    sw_enc_timing_.encoded_us = bluetooth::common::time_get_os_boottime_us();
 
     IsoManager::GetInstance()->SendIsoData(
         cis_handle, (const uint8_t*)sw_enc_left->GetDecodedSamples().data(),
@@ -3495,6 +3504,7 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
+    const uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
     if ((stream_conf.stream_params.sink.num_of_devices == 2) ||
         (stream_conf.stream_params.sink.stream_locations.size() == 2)) {
       /* Streaming to two devices or one device with 2 CISes */
@@ -3503,6 +3513,25 @@ class LeAudioClientImpl : public LeAudioClient {
       /* Streaming to one device and 1 CIS */
       PrepareAndSendToSingleCis(data, stream_conf.stream_params.sink);
     }
+
+    const uint64_t end_us = bluetooth::common::time_get_os_boottime_us();
+    /* Nothing was encoded when samples were missing */
+    if (sw_enc_timing_.encoded_us >= start_us) {
+      const uint64_t encode_us = sw_enc_timing_.encoded_us - start_us;
+      sw_enc_timing_.encode.Add(encode_us);
+      sw_enc_timing_.iso_send.Add(end_us - sw_enc_timing_.encoded_us);
+#ifdef __ANDROID__
+      ATRACE_INT("LE Audio encode us", encode_us);
+#endif
+      if (end_us - start_us > current_encoder_config_.data_interval_us) {
+        sw_enc_timing_.deadline_miss_count++;
+      }
+    }
+
+    if (leAudioHealthStatus_) {
+      leAudioHealthStatus_->AddEncodingStatisticForGroup(
+          group, end_us - start_us, current_encoder_config_.data_interval_us);
+    }
   }
 
   void CleanCachedMicrophoneData() {
@@ -3707,6 +3736,7 @@ class LeAudioClientImpl : public LeAudioClient {
       if (sw_enc_left || sw_enc_right) {
         log::warn("The encoder instance should have been already released.");
       }
+      sw_enc_timing_ = {};
       sw_enc_left = bluetooth::le_audio::CodecInterface::CreateInstance(
           stream_conf->codec_id);
       auto codec_status = sw_enc_left->InitEncoder(
@@ -3864,6 +3894,10 @@ class LeAudioClientImpl : public LeAudioClient {
 
     stream << " Speaker codec config (SW encoder)\n";
     config_printer(current_encoder_config_);
+    stream << "\tencode time (us): " << sw_enc_timing_.encode.ToString()
+           << "\n\tISO send time (us): " << sw_enc_timing_.iso_send.ToString()
+           << "\n\tover data interval: " << sw_enc_timing_.deadline_miss_count
+           << "\n";
 
     stream << " Microphone codec config (SW decoder)\n";
     config_printer(current_decoder_config_);
@@ -5907,6 +5941,16 @@ class LeAudioClientImpl : public LeAudioClient {
   std::unique_ptr<bluetooth::le_audio::CodecInterface> sw_enc_left;
   std::unique_ptr<bluetooth::le_audio::CodecInterface> sw_enc_right;
 
+  /* Timing of the SDU intervals sent since the encoders were set up */
+  struct {
+    bluetooth::common::LatencyHistogram encode;
+    bluetooth::common::LatencyHistogram iso_send;
+    /* SDU intervals which took longer than the data interval */
+    size_t deadline_miss_count = 0;
+    /* When the last PrepareAndSendTo* call was done encoding */
+    uint64_t encoded_us = 0;
+  } sw_enc_timing_;
+
   std::unique_ptr<bluetooth::le_audio::CodecInterface> sw_dec_left;
   std::unique_ptr<bluetooth::le_audio::CodecInterface> sw_dec_right;
 
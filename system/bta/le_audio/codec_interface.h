@@ -62,6 +62,12 @@ class CodecInterface {
   virtual CodecInterface::Status Encode(
       const uint8_t* data, int stride, uint16_t out_size,
       std::vector<int16_t>* out_buffer = nullptr, uint16_t out_offset = 0);
+  /* Encode one frame of every channel of the interleaved |data| in one call,
+   * the channel |i| with |encoders[i]| into |out_sizes[i]| bytes of its own
+   * output buffer. */
+  static CodecInterface::Status EncodeChannels(
+      const std::vector<CodecInterface*>& encoders, const uint8_t* data,
+      uint8_t bytes_per_sample, const std::vector<uint16_t>& out_sizes);
   virtual CodecInterface::Status Decode(uint8_t* data, uint16_t size);
   virtual void Cleanup();
   virtual bool IsReady();
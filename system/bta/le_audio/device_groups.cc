@@ -21,6 +21,7 @@
 #include <bluetooth/log.h>
 
 #include <optional>
+#include <string_view>
 
 #include "bta/include/bta_gatt_api.h"
 #include "bta_csis_api.h"
@@ -50,6 +51,29 @@ using types::DataPathState;
 using types::LeAudioContextType;
 using types::LeAudioCoreCodecConfig;
 
+namespace {
+void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+size_t GetPacsHash(const types::PublishedAudioCapabilities& pacs) {
+  size_t hash = 0;
+  for (auto const& [_, records] : pacs) {
+    for (auto const& record : records) {
+      HashCombine(hash, record.codec_id.coding_format);
+      HashCombine(hash, record.codec_id.vendor_company_id);
+      HashCombine(hash, record.codec_id.vendor_codec_id);
+      HashCombine(hash, record.codec_spec_caps.GetHash());
+      HashCombine(hash, std::hash<std::string_view>{}(
+                            {reinterpret_cast<const char*>(
+                                 record.codec_spec_caps_raw.data()),
+                             record.codec_spec_caps_raw.size()}));
+    }
+  }
+  return hash;
+}
+}  // namespace
+
 /* LeAudioDeviceGroup Class methods implementation */
 void LeAudioDeviceGroup::AddNode(
     const std::shared_ptr<LeAudioDevice>& leAudioDevice) {
@@ -879,13 +903,70 @@ LeAudioDeviceGroup::GetAudioSetConfigurationRequirements(
   return new_req;
 }
 
+LeAudioDeviceGroup::ConfigurationSelectionKey
+LeAudioDeviceGroup::GetConfigurationSelectionKey(
+    LeAudioContextType ctx_type) const {
+  ConfigurationSelectionKey key = {
+      .context_type = ctx_type,
+      .sink_strategy = GetGroupSinkStrategy(),
+      .desired_size = DesiredSize(),
+      .codec_location = CodecManager::GetInstance()->GetCodecLocation(),
+      .dual_bidir_swb_supported =
+          CodecManager::GetInstance()->IsDualBiDirSwbSupported(),
+  };
+
+  for (auto const& weak_dev_ptr : leAudioDevices_) {
+    auto device = weak_dev_ptr.lock();
+    if (!device) continue;
+
+    bool is_connected =
+        (device->conn_id_ != GATT_INVALID_CONN_ID) &&
+        (device->GetConnectionState() == DeviceConnectState::CONNECTED);
+    key.members.emplace_back(
+        device->address_, is_connected,
+        device->GetAseCount(types::kLeAudioDirectionSink),
+        device->GetAseCount(types::kLeAudioDirectionSource),
+        device->snk_audio_locations_.to_ulong(),
+        device->src_audio_locations_.to_ulong(),
+        GetPacsHash(device->snk_pacs_) ^ (GetPacsHash(device->src_pacs_) << 1));
+  }
+  return key;
+}
+
 bool LeAudioDeviceGroup::UpdateAudioSetConfigurationCache(
     LeAudioContextType ctx_type) const {
-  auto requirements = GetAudioSetConfigurationRequirements(ctx_type);
-  auto new_conf = CodecManager::GetInstance()->GetCodecConfig(
-      requirements,
-      std::bind(&LeAudioDeviceGroup::FindFirstSupportedConfiguration, this,
-                std::placeholders::_1, std::placeholders::_2));
+  /* The audio HAL may choose differently for the same group state */
+  bool use_memo = !CodecManager::GetInstance()->IsUsingCodecExtensibility();
+  std::optional<ConfigurationSelectionKey> key;
+  std::shared_ptr<set_configurations::AudioSetConfiguration> new_conf;
+  bool is_memoized = false;
+
+  if (use_memo) {
+    key = GetConfigurationSelectionKey(ctx_type);
+    auto memo_it = configuration_selection_memo_.find(*key);
+    if (memo_it != configuration_selection_memo_.end()) {
+      log::debug("Reusing the {} selection: {}", ToHexString(ctx_type),
+                 (memo_it->second ? memo_it->second->name.c_str() : "(none)"));
+      new_conf = memo_it->second;
+      is_memoized = true;
+    }
+  }
+
+  if (!is_memoized) {
+    auto requirements = GetAudioSetConfigurationRequirements(ctx_type);
+    new_conf = CodecManager::GetInstance()->GetCodecConfig(
+        requirements,
+        std::bind(&LeAudioDeviceGroup::FindFirstSupportedConfiguration, this,
+                  std::placeholders::_1, std::placeholders::_2));
+    if (key) {
+      if (configuration_selection_memo_.size() >=
+          kMaxConfigurationSelectionMemoSize) {
+        configuration_selection_memo_.clear();
+      }
+      configuration_selection_memo_.emplace(std::move(*key), new_conf);
+    }
+  }
+
   auto update_config = true;
 
   if (context_to_configuration_cache_map.count(ctx_type) != 0) {
@@ -28,6 +28,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <tuple>
 #include <utility>  // for std::pair
 #include <vector>
 
@@ -69,6 +70,10 @@ class LeAudioDeviceGroup {
 
     std::vector<struct types::cis> cises;
 
+    /* Parameters of the last CIG creation, to tell whether a CIG kept after
+     * the stream release can be reused */
+    std::optional<hci::iso_manager::cig_create_params> created_params;
+
    private:
     uint8_t GetFirstFreeCisId(types::CisType cis_type) const;
 
@@ -446,6 +451,33 @@ class LeAudioDeviceGroup {
   uint32_t GetTransportLatencyUs(uint8_t direction) const;
   bool IsCisPartOfCurrentStream(uint16_t cis_conn_hdl) const;
 
+  /* Everything the configuration selection for a context type depends on.
+   * The members are the address, whether the device is connected, its sink
+   * and source ASE counts, its sink and source audio locations and a hash of
+   * its PAC records.
+   */
+  struct ConfigurationSelectionKey {
+    types::LeAudioContextType context_type;
+    types::LeAudioConfigurationStrategy sink_strategy;
+    int desired_size;
+    types::CodecLocation codec_location;
+    bool dual_bidir_swb_supported;
+    std::vector<
+        std::tuple<RawAddress, bool, uint8_t, uint8_t, uint32_t, uint32_t,
+                   size_t>>
+        members;
+
+    bool operator<(const ConfigurationSelectionKey& other) const {
+      return std::tie(context_type, sink_strategy, desired_size,
+                      codec_location, dual_bidir_swb_supported, members) <
+             std::tie(other.context_type, other.sink_strategy,
+                      other.desired_size, other.codec_location,
+                      other.dual_bidir_swb_supported, other.members);
+    }
+  };
+  ConfigurationSelectionKey GetConfigurationSelectionKey(
+      types::LeAudioContextType ctx_type) const;
+
   /* Current configuration and metadata context types */
   types::LeAudioContextType configuration_context_type_;
   types::BidirectionalPair<types::AudioContexts> metadata_context_type_;
@@ -478,6 +510,15 @@ class LeAudioDeviceGroup {
                           set_configurations::AudioSetConfiguration>>>
       context_to_configuration_cache_map;
 
+  /* Configurations selected so far, kept across the cache invalidations so
+   * that the selection is not run again when the group returns to a state it
+   * was already in. Not used when the audio HAL selects the configurations.
+   */
+  static constexpr size_t kMaxConfigurationSelectionMemoSize = 32;
+  mutable std::map<ConfigurationSelectionKey,
+                   std::shared_ptr<set_configurations::AudioSetConfiguration>>
+      configuration_selection_memo_;
+
   types::AseState target_state_;
   types::AseState current_state_;
   bool in_transition_;
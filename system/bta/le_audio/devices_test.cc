@@ -57,6 +57,7 @@ using ::bluetooth::le_audio::types::CisType;
 using ::bluetooth::le_audio::types::LeAudioContextType;
 using testing::_;
 using testing::Invoke;
+using testing::Mock;
 using testing::NiceMock;
 using testing::Return;
 using testing::Test;
@@ -2447,6 +2448,46 @@ TEST_P(LeAudioAseConfigurationTest, test_config_support) {
   ASSERT_TRUE(right->IsAudioSetConfigurationSupported(test_config));
 }
 
+TEST_P(LeAudioAseConfigurationTest, test_configuration_selection_reused) {
+  LeAudioDevice* left = AddTestDevice(2, 1);
+  LeAudioDevice* right = AddTestDevice(2, 1);
+
+  left->snk_audio_locations_ =
+      ::bluetooth::le_audio::codec_spec_conf::kLeAudioLocationFrontLeft;
+  right->snk_audio_locations_ =
+      ::bluetooth::le_audio::codec_spec_conf::kLeAudioLocationFrontRight;
+  group_->ReloadAudioLocations();
+
+  /* Invalidating the cache does not run the selection again for the same
+   * group state */
+  EXPECT_CALL(*mock_codec_manager_, GetCodecConfig).Times(1);
+  auto conf = group_->GetConfiguration(LeAudioContextType::MEDIA);
+  group_->InvalidateCachedConfigurations();
+  ASSERT_EQ(conf, group_->GetConfiguration(LeAudioContextType::MEDIA));
+  Mock::VerifyAndClearExpectations(mock_codec_manager_);
+
+  /* A member disconnecting changes the group state */
+  EXPECT_CALL(*mock_codec_manager_, GetCodecConfig).Times(1);
+  right->SetConnectionState(DeviceConnectState::DISCONNECTED);
+  group_->InvalidateCachedConfigurations();
+  group_->GetConfiguration(LeAudioContextType::MEDIA);
+  Mock::VerifyAndClearExpectations(mock_codec_manager_);
+
+  /* So does a PAC update */
+  EXPECT_CALL(*mock_codec_manager_, GetCodecConfig).Times(1);
+  auto media_configuration =
+      getSpecificConfiguration("One-TwoChan-SnkAse-Lc3_48_4_High_Reliability",
+                               LeAudioContextType::MEDIA);
+  ASSERT_NE(nullptr, media_configuration);
+  PublishedAudioCapabilitiesBuilder snk_pac_builder;
+  for (const auto& entry : media_configuration->confs.sink) {
+    snk_pac_builder.Add(entry.codec, 1);
+  }
+  left->snk_pacs_ = snk_pac_builder.Get();
+  group_->InvalidateCachedConfigurations();
+  group_->GetConfiguration(LeAudioContextType::MEDIA);
+}
+
 TEST_P(LeAudioAseConfigurationTest,
        test_vendor_codec_configure_incomplete_group) {
   // A group of two earbuds
@@ -179,6 +179,36 @@ class LeAudioHealthStatusImpl : public LeAudioHealthStatus {
     }
   }
 
+  void AddEncodingStatisticForGroup(const LeAudioDeviceGroup* device_group,
+                                    uint64_t encoding_time_us,
+                                    uint32_t interval_us) override {
+    if (device_group == nullptr) {
+      log::error("device_group is null");
+      return;
+    }
+
+    /* Called every SDU interval, do not log here */
+    int group_id = device_group->group_id_;
+    auto group = find_group(group_id);
+    if (group == nullptr) {
+      add_group(group_id);
+      group = find_group(group_id);
+      if (group == nullptr) {
+        log::error("Could not add group {}", group_id);
+        return;
+      }
+    }
+
+    group->encoded_intervals_cnt_++;
+    group->encoding_time_total_us_ += encoding_time_us;
+    if (encoding_time_us > group->encoding_time_max_us_) {
+      group->encoding_time_max_us_ = encoding_time_us;
+    }
+    if (interval_us != 0 && encoding_time_us > interval_us) {
+      group->encoding_over_interval_cnt_++;
+    }
+  }
+
   void Dump(int fd) {
     dprintf(fd, "  LeAudioHealthStats: \n    groups:");
     for (const auto& g : group_stats_) {
@@ -210,6 +240,14 @@ class LeAudioHealthStatusImpl : public LeAudioHealthStatus {
            << ", fail signaling: " << group.stream_signaling_failures_cnt_
            << ", context not avail: " << group.stream_context_not_avail_cnt_;
 
+    if (group.encoded_intervals_cnt_ > 0) {
+      stream << ", encoded intervals: " << group.encoded_intervals_cnt_
+             << ", encoding avg (us): "
+             << group.encoding_time_total_us_ / group.encoded_intervals_cnt_
+             << ", max (us): " << group.encoding_time_max_us_
+             << ", over interval: " << group.encoding_over_interval_cnt_;
+    }
+
     dprintf(fd, "%s", stream.str().c_str());
   }
 
@@ -78,6 +78,10 @@ class LeAudioHealthStatus {
                                      LeAudioHealthDeviceStatType type) = 0;
   virtual void AddStatisticForGroup(const LeAudioDeviceGroup* group,
                                     LeAudioHealthGroupStatType type) = 0;
+  /* Time spent encoding and sending one SDU interval of the group audio */
+  virtual void AddEncodingStatisticForGroup(const LeAudioDeviceGroup* group,
+                                            uint64_t encoding_time_us,
+                                            uint32_t interval_us) = 0;
   virtual void RemoveStatistics(const RawAddress& address, int group) = 0;
 
   struct group_stats {
@@ -88,7 +92,11 @@ class LeAudioHealthStatus {
           stream_failures_cnt_(0),
           stream_cis_failures_cnt_(0),
           stream_signaling_failures_cnt_(0),
-          stream_context_not_avail_cnt_(0){};
+          stream_context_not_avail_cnt_(0),
+          encoded_intervals_cnt_(0),
+          encoding_over_interval_cnt_(0),
+          encoding_time_total_us_(0),
+          encoding_time_max_us_(0){};
 
     int group_id_;
     LeAudioHealthBasedAction latest_recommendation_;
@@ -98,6 +106,11 @@ class LeAudioHealthStatus {
     int stream_cis_failures_cnt_;
     int stream_signaling_failures_cnt_;
     int stream_context_not_avail_cnt_;
+
+    uint64_t encoded_intervals_cnt_;
+    uint64_t encoding_over_interval_cnt_;
+    uint64_t encoding_time_total_us_;
+    uint64_t encoding_time_max_us_;
   };
 
   struct device_stats {
@@ -16,6 +16,10 @@
  */
 
 #include <bluetooth/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <mutex>
 #include <string>
@@ -57,6 +61,12 @@ static const std::vector<
                              "le_audio/audio_set_scenarios.bfbs",
                              "/apex/com.android.btservices/etc/bluetooth/"
                              "le_audio/audio_set_scenarios.json"}};
+static const std::vector<const char* /*binary*/> kLeAudioSetConfigsBinary = {
+    "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+    "audio_set_configurations.bin"};
+static const std::vector<const char* /*binary*/> kLeAudioSetScenariosBinary = {
+    "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+    "audio_set_scenarios.bin"};
 #elif defined(TARGET_FLOSS)
 static const std::vector<
     std::pair<const char* /*schema*/, const char* /*content*/>>
@@ -68,6 +78,10 @@ static const std::vector<
     kLeAudioSetScenarios = {
         {"/etc/bluetooth/le_audio/audio_set_scenarios.bfbs",
          "/etc/bluetooth/le_audio/audio_set_scenarios.json"}};
+static const std::vector<const char* /*binary*/> kLeAudioSetConfigsBinary = {
+    "/etc/bluetooth/le_audio/audio_set_configurations.bin"};
+static const std::vector<const char* /*binary*/> kLeAudioSetScenariosBinary = {
+    "/etc/bluetooth/le_audio/audio_set_scenarios.bin"};
 #else
 static const std::vector<
     std::pair<const char* /*schema*/, const char* /*content*/>>
@@ -77,15 +91,50 @@ static const std::vector<
     std::pair<const char* /*schema*/, const char* /*content*/>>
     kLeAudioSetScenarios = {
         {"audio_set_scenarios.bfbs", "audio_set_scenarios.json"}};
+static const std::vector<const char* /*binary*/> kLeAudioSetConfigsBinary = {
+    "audio_set_configurations.bin"};
+static const std::vector<const char* /*binary*/> kLeAudioSetScenariosBinary = {
+    "audio_set_scenarios.bin"};
 #endif
 
+/** Read only mapping of a flatbuffer compiled from the JSON files at build
+ * time. The content is only valid while the mapping exists. */
+struct MappedFlatbuffer {
+  explicit MappedFlatbuffer(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data = static_cast<const uint8_t*>(addr);
+        size = st.st_size;
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFlatbuffer() {
+    if (data != nullptr) munmap(const_cast<uint8_t*>(data), size);
+  }
+
+  MappedFlatbuffer(const MappedFlatbuffer&) = delete;
+  MappedFlatbuffer& operator=(const MappedFlatbuffer&) = delete;
+
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
 /** Provides a set configurations for the given context type */
 struct AudioSetConfigurationProviderJson {
   static constexpr auto kDefaultScenario = "Media";
 
   AudioSetConfigurationProviderJson(types::CodecLocation location) {
     log::assert_that(
-        LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios, location),
+        LoadBinaryContent(kLeAudioSetConfigsBinary, kLeAudioSetScenariosBinary,
+                          location) ||
+            LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios, location),
         ": Unable to load le audio set configuration files.");
   }
 
@@ -416,8 +465,30 @@ struct AudioSetConfigurationProviderJson {
     if (!ok) return ok;
 
     /* Import from flatbuffers */
-    auto configurations_root = fbs::le_audio::GetAudioSetConfigurations(
-        configurations_parser_.builder_.GetBufferPointer());
+    return LoadConfigurations(
+        fbs::le_audio::GetAudioSetConfigurations(
+            configurations_parser_.builder_.GetBufferPointer()),
+        location);
+  }
+
+  bool LoadConfigurationsFromBinary(const char* binary_file,
+                                    types::CodecLocation location) {
+    MappedFlatbuffer binary(binary_file);
+    if (binary.data == nullptr) return false;
+
+    flatbuffers::Verifier verifier(binary.data, binary.size);
+    if (!fbs::le_audio::VerifyAudioSetConfigurationsBuffer(verifier)) {
+      log::warn("Invalid audio set configurations in {}", binary_file);
+      return false;
+    }
+
+    return LoadConfigurations(
+        fbs::le_audio::GetAudioSetConfigurations(binary.data), location);
+  }
+
+  bool LoadConfigurations(
+      const fbs::le_audio::AudioSetConfigurations* configurations_root,
+      types::CodecLocation location) {
     if (!configurations_root) return false;
 
     auto flat_qos_configs = configurations_root->qos_configurations();
@@ -496,8 +567,24 @@ struct AudioSetConfigurationProviderJson {
     if (!ok) return ok;
 
     /* Import from flatbuffers */
-    auto scenarios_root = fbs::le_audio::GetAudioSetScenarios(
-        scenarios_parser_.builder_.GetBufferPointer());
+    return LoadScenarios(fbs::le_audio::GetAudioSetScenarios(
+        scenarios_parser_.builder_.GetBufferPointer()));
+  }
+
+  bool LoadScenariosFromBinary(const char* binary_file) {
+    MappedFlatbuffer binary(binary_file);
+    if (binary.data == nullptr) return false;
+
+    flatbuffers::Verifier verifier(binary.data, binary.size);
+    if (!fbs::le_audio::VerifyAudioSetScenariosBuffer(verifier)) {
+      log::warn("Invalid audio set scenarios in {}", binary_file);
+      return false;
+    }
+
+    return LoadScenarios(fbs::le_audio::GetAudioSetScenarios(binary.data));
+  }
+
+  bool LoadScenarios(const fbs::le_audio::AudioSetScenarios* scenarios_root) {
     if (!scenarios_root) return false;
 
     auto flat_scenarios = scenarios_root->scenarios();
@@ -538,6 +625,29 @@ struct AudioSetConfigurationProviderJson {
     }
     return true;
   }
+
+  /* The binary flatbuffers are compiled from the JSON files at build time,
+   * which spares parsing the JSON at every start. Fall back to the JSON
+   * files when they are missing. */
+  bool LoadBinaryContent(std::vector<const char* /*binary*/> config_files,
+                         std::vector<const char* /*binary*/> scenario_files,
+                         types::CodecLocation location) {
+    bool ok = true;
+    for (auto binary : config_files) {
+      ok = ok && LoadConfigurationsFromBinary(binary, location);
+    }
+
+    for (auto binary : scenario_files) {
+      ok = ok && LoadScenariosFromBinary(binary);
+    }
+
+    if (!ok) {
+      log::info("Loading the audio set configurations from JSON");
+      context_configurations_.clear();
+      configurations_.clear();
+    }
+    return ok;
+  }
 };
 
 struct AudioSetConfigurationProvider::impl {
@@ -56,6 +56,22 @@ CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
                                               uint16_t out_offset) {
   return impl->Encode(data, stride, out_size, out_buffer, out_offset);
 }
+CodecInterface::Status CodecInterface::EncodeChannels(
+    const std::vector<CodecInterface*>& encoders, const uint8_t* data,
+    uint8_t bytes_per_sample, const std::vector<uint16_t>& out_sizes) {
+  if (encoders.size() != out_sizes.size()) {
+    return Status::STATUS_ERR_CODING_ERROR;
+  }
+
+  auto status = Status::STATUS_OK;
+  const int stride = encoders.size();
+  for (size_t ch = 0; ch < encoders.size(); ++ch) {
+    auto ch_status = encoders[ch]->Encode(data + ch * bytes_per_sample, stride,
+                                          out_sizes[ch]);
+    if (status == Status::STATUS_OK) status = ch_status;
+  }
+  return status;
+}
 void CodecInterface::Cleanup() { return impl->Cleanup(); }
 
 uint16_t CodecInterface::GetNumOfSamplesPerChannel() {
@@ -121,6 +121,33 @@ using namespace bluetooth;
 constexpr int linkQualityCheckInterval = 4000;
 constexpr int kAutonomousTransitionTimeoutMs = 5000;
 constexpr int kNumberOfCisRetries = 2;
+constexpr char kWarmRestartEnabledProp[] =
+    "persist.bluetooth.leaudio.warm_restart.enabled";
+
+static bool is_same_cig_params(
+    const bluetooth::hci::iso_manager::cig_create_params& a,
+    const bluetooth::hci::iso_manager::cig_create_params& b) {
+  if (a.sdu_itv_mtos != b.sdu_itv_mtos || a.sdu_itv_stom != b.sdu_itv_stom ||
+      a.sca != b.sca || a.packing != b.packing || a.framing != b.framing ||
+      a.max_trans_lat_stom != b.max_trans_lat_stom ||
+      a.max_trans_lat_mtos != b.max_trans_lat_mtos ||
+      a.cis_cfgs.size() != b.cis_cfgs.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.cis_cfgs.size(); i++) {
+    const EXT_CIS_CFG& cfg_a = a.cis_cfgs[i];
+    const EXT_CIS_CFG& cfg_b = b.cis_cfgs[i];
+    if (cfg_a.cis_id != cfg_b.cis_id ||
+        cfg_a.max_sdu_size_mtos != cfg_b.max_sdu_size_mtos ||
+        cfg_a.max_sdu_size_stom != cfg_b.max_sdu_size_stom ||
+        cfg_a.phy_mtos != cfg_b.phy_mtos || cfg_a.phy_stom != cfg_b.phy_stom ||
+        cfg_a.rtn_mtos != cfg_b.rtn_mtos || cfg_a.rtn_stom != cfg_b.rtn_stom) {
+      return false;
+    }
+  }
+  return true;
+}
 
 static void link_quality_cb(void* data) {
   // very ugly, but we need to pass just two bytes
@@ -203,7 +230,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
                               ccid_lists)) {
             SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
 
-            if (CigCreate(group)) {
+            if (CigReuseOrCreate(group)) {
               return true;
             }
           }
@@ -217,8 +244,10 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
          */
         group->Deactivate();
 
-        /* We are going to reconfigure whole group. Clear Cises.*/
+        /* We are going to reconfigure whole group. Clear Cises and the CIG
+         * possibly kept from the previous stream.*/
         ReleaseCisIds(group);
+        RemoveKeptCigForGroup(group);
 
         /* If configuration is needed */
         FALLTHROUGH_INTENDED;
@@ -294,6 +323,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
     group->Deactivate();
     ReleaseCisIds(group);
+    RemoveKeptCigForGroup(group);
 
     if (!group->Configure(context_type, metadata_context_types, ccid_lists)) {
       log::error("Could not configure ASEs for group {} content type {}",
@@ -776,6 +806,35 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
                                 RawAddress::kEmpty, kLogCigRemoveOp);
   }
 
+  void RemoveKeptCigForGroup(LeAudioDeviceGroup* group) {
+    if (group->cig.GetState() == CigState::CREATED &&
+        group->HaveAllCisesDisconnected()) {
+      RemoveCigForGroup(group);
+    }
+  }
+
+  /* With the warm restart, the CIG is kept once the CISes of a released group
+   * are disconnected, until the ASEs settle. It is removed if they go back to
+   * Idle, and reused by the next stream if the remote caches the Codec
+   * Configured state and the configuration does not change.
+   */
+  bool ShouldKeepCigOnRelease(LeAudioDeviceGroup* group) {
+    if (!osi_property_get_bool(kWarmRestartEnabledProp, false)) {
+      return false;
+    }
+
+    switch (group->GetState()) {
+      case AseState::BTA_LE_AUDIO_ASE_STATE_RELEASING:
+        return true;
+      case AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED:
+        return group->GetTargetState() ==
+                   AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED &&
+               !group->IsPendingConfiguration();
+      default:
+        return false;
+    }
+  }
+
   void ProcessHciNotifAclDisconnected(LeAudioDeviceGroup* group,
                                       LeAudioDevice* leAudioDevice) {
     FreeLinkQualityReports(leAudioDevice);
@@ -1273,7 +1332,13 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
                 group->group_id_, GroupStreamStatus::CONFIGURED_AUTONOMOUS);
           }
         }
-        RemoveCigForGroup(group);
+
+        if (ShouldKeepCigOnRelease(group)) {
+          log::info("Keeping CIG of group {} for the warm restart",
+                    group->group_id_);
+        } else {
+          RemoveCigForGroup(group);
+        }
       } break;
       default:
         break;
@@ -1503,21 +1568,13 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     }
   }
 
-  bool CigCreate(LeAudioDeviceGroup* group) {
+  bool PrepareCigParams(LeAudioDeviceGroup* group,
+                        bluetooth::hci::iso_manager::cig_create_params& param) {
     uint32_t sdu_interval_mtos, sdu_interval_stom;
     uint16_t max_trans_lat_mtos, max_trans_lat_stom;
     uint8_t packing, framing, sca;
     std::vector<EXT_CIS_CFG> cis_cfgs;
 
-    log::debug("Group: {}, id: {} cig state: {}", fmt::ptr(group),
-               group->group_id_, ToString(group->cig.GetState()));
-
-    if (group->cig.GetState() != CigState::NONE) {
-      log::warn("Group {}, id: {} has invalid cig state: {}", fmt::ptr(group),
-                group->group_id_, ToString(group->cig.GetState()));
-      return false;
-    }
-
     sdu_interval_mtos = group->GetSduInterval(
         bluetooth::le_audio::types::kLeAudioDirectionSink);
     sdu_interval_stom = group->GetSduInterval(
@@ -1623,7 +1680,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       return false;
     }
 
-    bluetooth::hci::iso_manager::cig_create_params param = {
+    param = {
         .sdu_itv_mtos = sdu_interval_mtos,
         .sdu_itv_stom = sdu_interval_stom,
         .sca = sca,
@@ -1635,6 +1692,24 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     };
 
     ApplyDsaParams(group, param);
+    return true;
+  }
+
+  bool CigCreate(LeAudioDeviceGroup* group) {
+    log::debug("Group: {}, id: {} cig state: {}", fmt::ptr(group),
+               group->group_id_, ToString(group->cig.GetState()));
+
+    if (group->cig.GetState() != CigState::NONE) {
+      log::warn("Group {}, id: {} has invalid cig state: {}", fmt::ptr(group),
+                group->group_id_, ToString(group->cig.GetState()));
+      return false;
+    }
+
+    bluetooth::hci::iso_manager::cig_create_params param;
+    if (!PrepareCigParams(group, param)) {
+      return false;
+    }
+    group->cig.created_params = param;
 
     log_history_->AddLogHistory(
         kLogStateMachineTag, group->group_id_, RawAddress::kEmpty,
@@ -1647,6 +1722,55 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     return true;
   }
 
+  /* Starts the stream of a group with the CIG kept from the previous stream
+   * if it matches the current configuration, or creates it otherwise.
+   */
+  bool CigReuseOrCreate(LeAudioDeviceGroup* group) {
+    if (group->cig.GetState() != CigState::CREATED ||
+        !group->HaveAllCisesDisconnected()) {
+      return CigCreate(group);
+    }
+
+    bluetooth::hci::iso_manager::cig_create_params param;
+    if (!PrepareCigParams(group, param)) {
+      return false;
+    }
+
+    /* CIS disconnection left the ASEs with their CIS assigned, reset them so
+     * that the handles of the CIG are assigned again */
+    for (LeAudioDevice* leAudioDevice = group->GetFirstActiveDevice();
+         leAudioDevice;
+         leAudioDevice = group->GetNextActiveDevice(leAudioDevice)) {
+      for (auto& ase : leAudioDevice->ases_) {
+        if (ase.cis_state == CisState::ASSIGNED) {
+          ase.cis_state = CisState::IDLE;
+        }
+      }
+    }
+
+    if (!group->cig.created_params ||
+        !is_same_cig_params(*group->cig.created_params, param)) {
+      /* CIG parameters changed. Remove the CIG and create it again once
+       * removed, like after a disallowed CIG creation. */
+      log::info("Group {} CIG parameters changed, recreating the CIG",
+                group->group_id_);
+      group->cig.SetState(CigState::RECOVERING);
+      IsoManager::GetInstance()->RemoveCig(group->group_id_);
+      return true;
+    }
+
+    log::info("Group {} reuses its CIG, number of cis handles: {}",
+              group->group_id_, static_cast<int>(group->cig.cises.size()));
+    log_history_->AddLogHistory(kLogStateMachineTag, group->group_id_,
+                                RawAddress::kEmpty,
+                                kLogCigCreateOp + "REUSED");
+
+    group->AssignCisConnHandlesToAses();
+    group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED);
+    PrepareAndSendQoSToTheGroup(group);
+    return true;
+  }
+
   static bool CisCreateForDevice(LeAudioDeviceGroup* group,
                                  LeAudioDevice* leAudioDevice) {
     std::vector<EXT_CIS_CREATE_CFG> conn_pairs;
@@ -1863,6 +1987,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
         cancel_watchdog_if_needed(group->group_id_);
         ReleaseCisIds(group);
+        RemoveKeptCigForGroup(group);
         state_machine_callbacks_->StatusReportCb(group->group_id_,
                                                  GroupStreamStatus::IDLE);
 
@@ -3111,7 +3236,8 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
         if (group->cig.GetState() == CigState::CREATED &&
             group->HaveAllCisesDisconnected() &&
-            getDeviceTryingToAttachTheStream(group) == nullptr) {
+            getDeviceTryingToAttachTheStream(group) == nullptr &&
+            !ShouldKeepCigOnRelease(group)) {
           RemoveCigForGroup(group);
         }
 
@@ -18,10 +18,14 @@
 #include <base/location.h>
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <vector>
+
 #include "bta/av/bta_av_int.h"
 #include "bta/hf_client/bta_hf_client_int.h"
 #include "common/init_flags.h"
 #include "test/common/mock_functions.h"
+#include "test/mock/mock_btif_config.h"
 #include "test/mock/mock_osi_alarm.h"
 #include "test/mock/mock_stack_acl.h"
 
@@ -72,3 +76,65 @@ TEST_F(BtaAvTest, bta_av_rc_opened) {
   };
   bta_av_rc_opened(&cb, &data);
 }
+
+TEST_F(BtaAvTest, bta_av_sep_cache) {
+  std::vector<uint8_t> stored;
+  test::mock::btif_config::btif_config_set_bin.body =
+      [&stored](const std::string&, const std::string&, const uint8_t* value,
+                size_t length) {
+        stored.assign(value, value + length);
+        return true;
+      };
+
+  tAVDT_SEP_INFO sep_info[] = {
+      {.in_use = false, .seid = 1, .media_type = 0, .tsep = AVDT_TSEP_SNK},
+      {.in_use = false, .seid = 2, .media_type = 0, .tsep = AVDT_TSEP_SNK},
+  };
+  AvdtpSepConfig cap;
+  cap.num_codec = 1;
+  cap.codec_info[0] = 6;
+  cap.psc_mask = 0x1234;
+
+  bta_av_sep_cache_discovered(kRawAddress, sep_info, 2, true);
+  ASSERT_EQ(nullptr, bta_av_sep_cache_find(kRawAddress, 1));
+  bta_av_sep_cache_store(kRawAddress, 1, cap);
+  ASSERT_EQ(1, get_func_call_count("btif_config_set_bin"));
+
+  // Replayed capabilities are not stored again
+  bta_av_sep_cache_discovered(kRawAddress, sep_info, 2, true);
+  const AvdtpSepConfig* p_cap = bta_av_sep_cache_find(kRawAddress, 1);
+  ASSERT_NE(nullptr, p_cap);
+  ASSERT_EQ(0x1234, p_cap->psc_mask);
+  bta_av_sep_cache_store(kRawAddress, 1, *p_cap);
+  ASSERT_EQ(1, get_func_call_count("btif_config_set_bin"));
+  ASSERT_EQ(nullptr, bta_av_sep_cache_find(kRawAddress, 2));
+
+  // Capabilities come back from the config
+  bta_av_sep_cache_remove(kRawAddress);
+  test::mock::btif_config::btif_config_get_bin_length.body =
+      [&stored](const std::string&, const std::string&) {
+        return stored.size();
+      };
+  test::mock::btif_config::btif_config_get_bin.body =
+      [&stored](const std::string&, const std::string&, uint8_t* value,
+                size_t* length) {
+        memcpy(value, stored.data(), stored.size());
+        *length = stored.size();
+        return true;
+      };
+  bta_av_sep_cache_discovered(kRawAddress, sep_info, 2, true);
+  p_cap = bta_av_sep_cache_find(kRawAddress, 1);
+  ASSERT_NE(nullptr, p_cap);
+  ASSERT_EQ(6, p_cap->codec_info[0]);
+  ASSERT_EQ(0x1234, p_cap->psc_mask);
+
+  // A different discovery drops the capabilities
+  sep_info[1].seid = 3;
+  bta_av_sep_cache_discovered(kRawAddress, sep_info, 2, true);
+  ASSERT_EQ(nullptr, bta_av_sep_cache_find(kRawAddress, 1));
+
+  bta_av_sep_cache_remove(kRawAddress);
+  test::mock::btif_config::btif_config_set_bin = {};
+  test::mock::btif_config::btif_config_get_bin_length = {};
+  test::mock::btif_config::btif_config_get_bin = {};
+}
@@ -466,6 +466,53 @@ TEST_F(BtaDmTest, bta_dm_disc_start__false) { bta_dm_disc_start(false); }
 
 TEST_F(BtaDmTest, bta_dm_disc_stop) { bta_dm_disc_stop(); }
 
+TEST_F(BtaDmTest, bta_dm_pm_adapt_sniff_timeout) {
+  constexpr uint64_t kTimeoutMs = 1000;
+  pm_adaptive_sniff_enabled = true;
+  pm_link_stats.clear();
+
+  // Not enough history
+  ASSERT_EQ(kTimeoutMs, bta_dm_pm_adapt_sniff_timeout(kRawAddress, kTimeoutMs));
+
+  // Traffic resumes shortly after sniff would be entered
+  pm_link_stats[kRawAddress].idle_samples = kPmMinIdleSamples;
+  pm_link_stats[kRawAddress].predicted_idle_ms = 1200;
+  ASSERT_EQ(1700u, bta_dm_pm_adapt_sniff_timeout(kRawAddress, kTimeoutMs));
+  ASSERT_EQ(1u, pm_link_stats[kRawAddress].timeouts_extended);
+
+  // Traffic resumes before the timeout anyway
+  pm_link_stats[kRawAddress].predicted_idle_ms = 800;
+  ASSERT_EQ(kTimeoutMs, bta_dm_pm_adapt_sniff_timeout(kRawAddress, kTimeoutMs));
+
+  // Long idle periods enter sniff sooner, but not below the floor
+  pm_link_stats[kRawAddress].predicted_idle_ms = 30000;
+  ASSERT_EQ(2500u, bta_dm_pm_adapt_sniff_timeout(kRawAddress, 5000));
+  ASSERT_EQ(kTimeoutMs, bta_dm_pm_adapt_sniff_timeout(kRawAddress, kTimeoutMs));
+  ASSERT_EQ(1u, pm_link_stats[kRawAddress].timeouts_shortened);
+
+  pm_adaptive_sniff_enabled = false;
+  ASSERT_EQ(kTimeoutMs, bta_dm_pm_adapt_sniff_timeout(kRawAddress, kTimeoutMs));
+  pm_link_stats.clear();
+}
+
+TEST_F(BtaDmTest, bta_dm_pm_track_mode) {
+  pm_link_stats.clear();
+
+  bta_dm_pm_track_mode(kRawAddress, BTM_PM_STS_SNIFF);
+  pm_link_stats[kRawAddress].wakeup_requested_ms =
+      bluetooth::common::time_get_os_boottime_ms();
+  bta_dm_pm_track_mode(kRawAddress, BTM_PM_STS_ACTIVE);
+
+  const PmLinkStats& stats = pm_link_stats[kRawAddress];
+  ASSERT_EQ(1u, stats.sniff_entries);
+  ASSERT_EQ(1u, stats.sniff_exits);
+  ASSERT_EQ(1u, stats.short_sniffs);
+  ASSERT_EQ(1u, stats.wakeups);
+  ASSERT_FALSE(stats.in_sniff);
+  ASSERT_EQ(0u, stats.wakeup_requested_ms);
+  pm_link_stats.clear();
+}
+
 TEST_F(BtaDmCustomAlarmTest, bta_dm_sniff_cback) {
   // Setup a connected device
   const tBT_TRANSPORT transport{BT_TRANSPORT_BR_EDR};
@@ -106,3 +106,28 @@ TEST_F(BtaHhTest, bta_hh_ctrl_dat_act__BTA_HH_GET_RPT_EVT) {
   bta_hh_ctrl_dat_act(&cb, &data);
   ASSERT_EQ(cb.w4_evt, BTA_HH_EMPTY_EVT);
 }
+
+TEST_F(BtaHhTest, bta_hh_le_find_alloc_report_entry__indexes_value_handle) {
+  tBTA_HH_DEV_CB cb = {};
+  cb.hid_srvc.state = BTA_HH_SERVICE_DISCOVERED;
+
+  /* value handles that collide in the table */
+  const uint16_t handles[] = {0x0012, 0x0012 + BTA_HH_LE_RPT_HANDLE_SLOTS,
+                              0x0012 + 2 * BTA_HH_LE_RPT_HANDLE_SLOTS};
+  for (uint16_t handle : handles) {
+    ASSERT_NE(nullptr, bta_hh_le_find_alloc_report_entry(
+                           &cb, 0x0010, GATT_UUID_HID_REPORT, handle));
+  }
+  /* finding an existing entry does not index it again */
+  ASSERT_EQ(&cb.hid_srvc.report[0],
+            bta_hh_le_find_alloc_report_entry(&cb, 0x0010, GATT_UUID_HID_REPORT,
+                                              handles[0]));
+
+  int num_slots = 0;
+  for (const tBTA_HH_LE_RPT_SLOT& slot : cb.hid_srvc.rpt_by_handle) {
+    if (slot.handle == 0) continue;
+    num_slots++;
+    ASSERT_EQ(slot.handle, cb.hid_srvc.report[slot.rpt_idx].char_inst_id);
+  }
+  ASSERT_EQ(3, num_slots);
+}
@@ -61,3 +61,5 @@ void BtaGattQueue::ReadMultiCharacteristic(uint16_t conn_id,
   gatt_queue->ReadMultiCharacteristic(conn_id, p_read_multi, variable_len, cb,
                                       cb_data);
 }
+
+void BtaGattQueue::DebugDump(int /* fd */) {}
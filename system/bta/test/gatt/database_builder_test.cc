@@ -98,6 +98,91 @@ TEST(DatabaseBuilderTest, DescriptorAddTest) {
   ASSERT_EQ(service->characteristics[0].descriptors[0].handle, 0x0004);
 }
 
+/* Verify that descriptors of all characteristics of a service are explored
+ * in one range, and that characteristic attributes returned within it are not
+ * taken for descriptors */
+TEST(DatabaseBuilderTest, MergedDescriptorRangeTest) {
+  DatabaseBuilder builder;
+
+  builder.AddService(0x0001, 0x000a, SERVICE_1_UUID, true);
+  builder.AddService(0x000b, 0x000f, SERVICE_2_UUID, true);
+
+  EXPECT_TRUE(builder.StartNextServiceExploration());
+  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0001, 0x000a));
+
+  builder.AddCharacteristic(0x0002, 0x0003, SERVICE_1_CHAR_1_UUID, 0x12);
+  builder.AddCharacteristic(0x0005, 0x0006, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0007, 0x0008, SERVICE_1_CHAR_1_UUID, 0x12);
+
+  ASSERT_EQ(builder.NextMergedDescriptorRangeToExplore(),
+            make_pair_u16(0x0004, 0x000a));
+
+  // Find Information over the merged range returns everything in it
+  builder.AddDescriptor(0x0004, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0005, Uuid::From16Bit(0x2803));
+  builder.AddDescriptor(0x0006, SERVICE_1_CHAR_1_UUID);
+  builder.AddDescriptor(0x0007, Uuid::From16Bit(0x2803));
+  builder.AddDescriptor(0x0008, SERVICE_1_CHAR_1_UUID);
+  builder.AddDescriptor(0x0009, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  ASSERT_EQ(builder.NextMergedDescriptorRangeToExplore(),
+            make_pair_u16(0xffff, 0xffff));
+
+  // No place for descriptors in this service
+  EXPECT_TRUE(builder.StartNextServiceExploration());
+  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x000b, 0x000f));
+  builder.AddCharacteristic(0x000c, 0x000d, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x000e, 0x000f, SERVICE_1_CHAR_1_UUID, 0x02);
+  ASSERT_EQ(builder.NextMergedDescriptorRangeToExplore(),
+            make_pair_u16(0xffff, 0xffff));
+
+  EXPECT_FALSE(builder.StartNextServiceExploration());
+  Database result = builder.Build();
+
+  auto service = result.Services().begin();
+  ASSERT_EQ(service->characteristics.size(), (size_t)3);
+  ASSERT_EQ(service->characteristics[0].descriptors.size(), (size_t)1);
+  ASSERT_EQ(service->characteristics[0].descriptors[0].handle, 0x0004);
+  ASSERT_TRUE(service->characteristics[1].descriptors.empty());
+  ASSERT_EQ(service->characteristics[2].descriptors.size(), (size_t)1);
+  ASSERT_EQ(service->characteristics[2].descriptors[0].handle, 0x0009);
+}
+
+/* Verify that handle based lookups work on the built database, and on its
+ * copies */
+TEST(DatabaseBuilderTest, HandleLookupTest) {
+  DatabaseBuilder builder;
+
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddCharacteristic(0x0002, 0x0003, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0004, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddService(0x0010, 0x0012, SERVICE_2_UUID, true);
+
+  Database result = builder.Build();
+  Database copy = result;
+  result.Clear();
+
+  const Service* service = copy.FindServiceForHandle(0x0003);
+  ASSERT_NE(service, nullptr);
+  ASSERT_EQ(service->uuid, SERVICE_1_UUID);
+  // Handle inside the range of a service, but not used by any attribute
+  ASSERT_EQ(copy.FindServiceForHandle(0x0011)->uuid, SERVICE_2_UUID);
+  ASSERT_EQ(copy.FindServiceForHandle(0x0020), nullptr);
+
+  const Characteristic* characteristic = copy.FindCharacteristic(0x0003);
+  ASSERT_EQ(characteristic, &service->characteristics[0]);
+  ASSERT_EQ(copy.FindCharacteristic(0x0002), nullptr);
+  ASSERT_EQ(copy.FindCharacteristic(0x0004), nullptr);
+
+  ASSERT_EQ(copy.FindDescriptor(0x0004),
+            &service->characteristics[0].descriptors[0]);
+  ASSERT_EQ(copy.FindDescriptor(0x0003), nullptr);
+  ASSERT_EQ(copy.FindOwningCharacteristic(0x0004), characteristic);
+  ASSERT_EQ(copy.FindOwningCharacteristic(0x0003), nullptr);
+
+  ASSERT_EQ(result.FindCharacteristic(0x0003), nullptr);
+}
+
 /* This test verifies that DatabaseBuilder properly handle discovery of
  * secondary service, that is added to the discovery queue from included service
  * definition. Such service might come out of order.  */
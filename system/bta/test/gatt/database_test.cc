@@ -553,4 +553,51 @@ TEST(GattDatabaseTest, serialized_hash_test) {
   EXPECT_EQ(db_from_disk.Hash(), db_from_serialized.Hash());
 }
 
+
+/* This test makes sure that a database survives the compact storage format,
+ * and that truncated or inconsistent images are rejected. */
+TEST(GattDatabaseTest, serialize_deserialize_compact_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, false);
+  builder.AddIncludedService(0x0002, SERVICE_2_UUID, 0x0010, 0x001f);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x82);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0006, CHARACTERISTIC_EXTENDED_PROPERTIES);
+  builder.SetValueOfDescriptors({0x0001});
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0013, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database db = builder.Build();
+  auto serialized = db.Serialize();
+
+  std::vector<uint8_t> bytes;
+  StoredAttribute::SerializeCompact(0x0007, serialized, bytes);
+  EXPECT_LT(bytes.size(), serialized.size() * StoredAttribute::kSizeOnDisk);
+
+  // version, attribute count, interned UUID count
+  EXPECT_EQ(bytes[0], 0x07);
+  EXPECT_EQ(bytes[2], serialized.size());
+  EXPECT_EQ(bytes[4], 0x09);
+
+  std::vector<StoredAttribute> attr_from_disk;
+  ASSERT_TRUE(StoredAttribute::DeserializeCompact(bytes.data(), bytes.size(),
+                                                  attr_from_disk));
+  bool is_successful = false;
+  Database db_from_disk =
+      gatt::Database::Deserialize(attr_from_disk, &is_successful);
+  ASSERT_TRUE(is_successful);
+  EXPECT_EQ(db_from_disk.Hash(), db.Hash());
+  EXPECT_EQ(db_from_disk.ToString(), db.ToString());
+
+  EXPECT_FALSE(StoredAttribute::DeserializeCompact(
+      bytes.data(), bytes.size() - 1, attr_from_disk));
+
+  // Point the first record type past the end of the UUID table
+  bytes[StoredAttribute::kCompactHeaderSize + 9 * Uuid::kNumBytes128 + 2] =
+      0x09;
+  EXPECT_FALSE(StoredAttribute::DeserializeCompact(bytes.data(), bytes.size(),
+                                                   attr_from_disk));
+}
+
 }  // namespace gatt
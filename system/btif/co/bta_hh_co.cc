@@ -18,20 +18,25 @@
 
 #include "bta_hh_co.h"
 
-#include <com_android_bluetooth_flags.h>
 #include <fcntl.h>
 #include <linux/uhid.h>
-#include <poll.h>
 #include <pthread.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 
+#include <array>
 #include <cerrno>
+#include <chrono>
+#include <mutex>
 
 #include "bta_hh_api.h"
 #include "btif_hh.h"
+#include "common/latency_histogram.h"
 #include "hci/controller_interface.h"
+#include "main/shim/dumpsys.h"
 #include "main/shim/entry.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
@@ -46,17 +51,46 @@ const char* dev_path = "/dev/uhid";
 static tBTA_HH_RPT_CACHE_ENTRY sReportCache[BTA_HH_NV_LOAD_MAX];
 #define BTA_HH_CACHE_REPORT_VERSION 1
 #define THREAD_NORMAL_PRIORITY 0
-#define BT_HH_THREAD_PREFIX "bt_hh_"
-#define BTA_HH_UHID_POLL_PERIOD_MS 50
-/* Max number of polling interrupt allowed */
-#define BTA_HH_UHID_INTERRUPT_COUNT_MAX 100
+#define BT_HH_THREAD_NAME "bt_hh_uhid"
 
 using namespace bluetooth;
 
 static const bthh_report_type_t map_rtype_uhid_hh[] = {
     BTHH_FEATURE_REPORT, BTHH_OUTPUT_REPORT, BTHH_INPUT_REPORT};
 
-static void* btif_hh_poll_event_thread(void* arg);
+/* A single thread polls the UHID drivers of all the connected devices, the
+ * mutex is held while it handles their events and while a device is attached
+ * or detached. */
+static struct {
+  std::mutex mutex;
+  bool running = false;
+  pthread_t thread_id = -1;
+  int epoll_fd = -1;
+  int wakeup_fd = -1;
+  size_t num_devices = 0;
+} uhid_loop;
+
+/* Input report statistics of each device, indexed like btif_hh_cb.devices */
+static struct {
+  uint64_t last_report_us;
+  /* From the report reaching bta_hh_co_data to its write to UHID */
+  bluetooth::common::LatencyHistogram latency;
+  /* Between two consecutive reports */
+  bluetooth::common::LatencyHistogram interval;
+} input_stats[BTIF_HH_MAX_HID];
+
+static uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void uhid_loop_close_fds() {
+  if (uhid_loop.epoll_fd >= 0) close(uhid_loop.epoll_fd);
+  if (uhid_loop.wakeup_fd >= 0) close(uhid_loop.wakeup_fd);
+  uhid_loop.epoll_fd = -1;
+  uhid_loop.wakeup_fd = -1;
+}
 
 void uhid_set_non_blocking(int fd) {
   int opts = fcntl(fd, F_GETFL);
@@ -276,130 +310,184 @@ static void uhid_fd_close(btif_hh_uhid_t* p_uhid) {
   }
 }
 
-/* Internal function to open the UHID driver*/
-static bool uhid_fd_open(btif_hh_device_t* p_dev) {
-  if (p_dev->uhid.fd < 0) {
-    p_dev->uhid.fd = open(dev_path, O_RDWR | O_CLOEXEC);
-    if (p_dev->uhid.fd < 0) {
-      log::error("Failed to open uhid, err:{}", strerror(errno));
-      return false;
-    }
+/* Internal function to stop polling the UHID driver of a device and close it,
+ * called with uhid_loop.mutex held */
+static void uhid_loop_detach(btif_hh_uhid_t* p_uhid) {
+  if (epoll_ctl(uhid_loop.epoll_fd, EPOLL_CTL_DEL, p_uhid->fd, nullptr) < 0) {
+    log::error("Cannot stop polling fd={}: {}", p_uhid->fd, strerror(errno));
   }
-
-  if (p_dev->uhid.hh_keep_polling == 0) {
-    p_dev->uhid.hh_keep_polling = 1;
-    p_dev->hh_poll_thread_id =
-        create_thread(btif_hh_poll_event_thread, &p_dev->uhid);
-  }
-  return true;
+  p_uhid->hh_keep_polling = 0;
+  uhid_fd_close(p_uhid);
+  uhid_loop.num_devices--;
 }
 
-static int uhid_fd_poll(btif_hh_uhid_t* p_uhid,
-                        std::array<struct pollfd, 1>& pfds) {
-  int ret = 0;
-  int counter = 0;
-
-  do {
-    if (com::android::bluetooth::flags::break_uhid_polling_early() &&
-        !p_uhid->hh_keep_polling) {
-      log::debug("Polling stopped");
-      return -1;
-    }
-
-    if (counter++ > BTA_HH_UHID_INTERRUPT_COUNT_MAX) {
-      log::error("Polling interrupted consecutively {} times",
-                 BTA_HH_UHID_INTERRUPT_COUNT_MAX);
-      return -1;
-    }
-
-    ret = poll(pfds.data(), pfds.size(), BTA_HH_UHID_POLL_PERIOD_MS);
-  } while (ret == -1 && errno == EINTR);
-
-  if (!com::android::bluetooth::flags::break_uhid_polling_early()) {
-    if (ret == 0) {
-      log::verbose("Polling timed out, attempt to read (old behavior)");
-      return 1;
-    }
+static void uhid_configure_thread() {
+  pid_t pid = gettid();
+  // This thread is created by bt_main_thread with RT priority. Lower the thread
+  // priority here since the tasks in this thread is not timing critical.
+  struct sched_param sched_params;
+  sched_params.sched_priority = THREAD_NORMAL_PRIORITY;
+  if (sched_setscheduler(pid, SCHED_OTHER, &sched_params)) {
+    log::error("Failed to set thread priority to normal: {}", strerror(errno));
   }
 
-  return ret;
+  pthread_setname_np(pthread_self(), BT_HH_THREAD_NAME);
+  log::debug("Host hid polling thread created name:{} pid:{}",
+             BT_HH_THREAD_NAME, pid);
 }
 
-static void uhid_start_polling(btif_hh_uhid_t* p_uhid) {
-  std::array<struct pollfd, 1> pfds = {};
-  pfds[0].fd = p_uhid->fd;
-  pfds[0].events = POLLIN;
-
-  while (p_uhid->hh_keep_polling) {
-    int ret = uhid_fd_poll(p_uhid, pfds);
-
+/*******************************************************************************
+ *
+ * Function btif_hh_poll_event_thread
+ *
+ * Description the polling thread which waits for the events of the UHID
+ *             drivers of all the connected devices
+ *
+ * Returns void
+ *
+ ******************************************************************************/
+static void* btif_hh_poll_event_thread(void* /* arg */) {
+  uhid_configure_thread();
+
+  std::array<struct epoll_event, BTIF_HH_MAX_HID + 1> events;
+  while (true) {
+    int ret;
+    OSI_NO_INTR(ret = epoll_wait(uhid_loop.epoll_fd, events.data(),
+                                 events.size(), -1));
     if (ret < 0) {
-      log::error("Cannot poll for fds: {}\n", strerror(errno));
+      log::error("Cannot poll for fds: {}", strerror(errno));
+      std::lock_guard<std::mutex> lock(uhid_loop.mutex);
+      for (btif_hh_device_t& dev : btif_hh_cb.devices) {
+        if (dev.uhid.hh_keep_polling) {
+          uhid_loop_detach(&dev.uhid);
+        }
+      }
       break;
-    } else if (ret == 0) {
-      /* Poll timeout, poll again */
-      continue;
     }
 
-    /* At least one of the fd is ready */
-    if (pfds[0].revents & POLLIN) {
-      log::verbose("POLLIN");
-      int result = uhid_read_event(p_uhid);
+    std::lock_guard<std::mutex> lock(uhid_loop.mutex);
+    for (int i = 0; i < ret; i++) {
+      btif_hh_uhid_t* p_uhid = (btif_hh_uhid_t*)events[i].data.ptr;
+      if (p_uhid == nullptr) {
+        eventfd_t value;
+        eventfd_read(uhid_loop.wakeup_fd, &value);
+        continue;
+      }
+
+      /* The device was closed after the events were collected */
+      if (!p_uhid->hh_keep_polling) {
+        continue;
+      }
+
+      int result = 0;
+      if (events[i].events & EPOLLIN) {
+        log::verbose("POLLIN");
+        result = uhid_read_event(p_uhid);
+        if (result == -EAGAIN) {
+          continue;
+        }
+      } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        result = -EFAULT;
+      }
+
+      /* Todo: Disconnect if polling stopped due to a failure */
       if (result != 0) {
         log::error("Unhandled UHID event, error: {}", result);
-        break;
+        log::info("Polling stopped for device {}", p_uhid->link_spec);
+        uhid_loop_detach(p_uhid);
       }
     }
+
+    if (!uhid_loop.running) {
+      break;
+    }
   }
+
+  log::info("Polling thread stopped");
+  return 0;
 }
 
-static bool uhid_configure_thread(btif_hh_uhid_t* p_uhid) {
-  pid_t pid = gettid();
-  // This thread is created by bt_main_thread with RT priority. Lower the thread
-  // priority here since the tasks in this thread is not timing critical.
-  struct sched_param sched_params;
-  sched_params.sched_priority = THREAD_NORMAL_PRIORITY;
-  if (sched_setscheduler(pid, SCHED_OTHER, &sched_params)) {
-    log::error("Failed to set thread priority to normal: {}", strerror(errno));
-    return false;
+/* Internal function to poll the UHID driver of a device from the shared
+ * polling thread, which is started with the first device */
+static bool uhid_loop_attach(btif_hh_uhid_t* p_uhid) {
+  std::lock_guard<std::mutex> lock(uhid_loop.mutex);
+  if (!uhid_loop.running) {
+    uhid_loop.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    uhid_loop.wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (uhid_loop.epoll_fd < 0 || uhid_loop.wakeup_fd < 0) {
+      log::error("Cannot create the polling fds: {}", strerror(errno));
+      uhid_loop_close_fds();
+      return false;
+    }
+    struct epoll_event wakeup_event = {};
+    wakeup_event.events = EPOLLIN;
+    wakeup_event.data.ptr = nullptr;
+    epoll_ctl(uhid_loop.epoll_fd, EPOLL_CTL_ADD, uhid_loop.wakeup_fd,
+              &wakeup_event);
+    uhid_loop.running = true;
+    uhid_loop.thread_id = create_thread(btif_hh_poll_event_thread, nullptr);
+    if (uhid_loop.thread_id == (pthread_t)-1) {
+      uhid_loop.running = false;
+      uhid_loop_close_fds();
+      return false;
+    }
   }
 
-  // Change the name of thread
-  char thread_name[16] = {};
-  sprintf(thread_name, BT_HH_THREAD_PREFIX "%02x:%02x",
-          p_uhid->link_spec.addrt.bda.address[4],
-          p_uhid->link_spec.addrt.bda.address[5]);
-  pthread_setname_np(pthread_self(), thread_name);
-  log::debug("Host hid polling thread created name:{} pid:{} fd:{}",
-             thread_name, pid, p_uhid->fd);
-
   // Set the uhid fd as non-blocking to ensure we never block the BTU thread
   uhid_set_non_blocking(p_uhid->fd);
 
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.ptr = p_uhid;
+  if (epoll_ctl(uhid_loop.epoll_fd, EPOLL_CTL_ADD, p_uhid->fd, &event) < 0) {
+    log::error("Cannot poll fd={}: {}", p_uhid->fd, strerror(errno));
+    return false;
+  }
+  p_uhid->hh_keep_polling = 1;
+  uhid_loop.num_devices++;
+  log::debug("Polling fd={} for device {}, {} devices polled", p_uhid->fd,
+             p_uhid->link_spec, uhid_loop.num_devices);
   return true;
 }
 
-/*******************************************************************************
- *
- * Function btif_hh_poll_event_thread
- *
- * Description the polling thread which polls for event from UHID driver
- *
- * Returns void
- *
- ******************************************************************************/
-static void* btif_hh_poll_event_thread(void* arg) {
-  btif_hh_uhid_t* p_uhid = (btif_hh_uhid_t*)arg;
+/* Internal function to stop polling the UHID driver of a device, and the
+ * shared polling thread with the last device. Once it returns, the polling
+ * thread does not use the device anymore. */
+static void uhid_loop_release(btif_hh_uhid_t* p_uhid) {
+  pthread_t thread_id;
+  {
+    std::lock_guard<std::mutex> lock(uhid_loop.mutex);
+    if (p_uhid->hh_keep_polling) {
+      uhid_loop_detach(p_uhid);
+    }
+    if (!uhid_loop.running || uhid_loop.num_devices > 0) {
+      return;
+    }
+    uhid_loop.running = false;
+    thread_id = uhid_loop.thread_id;
+    eventfd_write(uhid_loop.wakeup_fd, 1);
+  }
+
+  pthread_join(thread_id, NULL);
+  std::lock_guard<std::mutex> lock(uhid_loop.mutex);
+  uhid_loop.thread_id = -1;
+  uhid_loop_close_fds();
+}
 
-  if (uhid_configure_thread(p_uhid)) {
-    uhid_start_polling(p_uhid);
+/* Internal function to open the UHID driver*/
+static bool uhid_fd_open(btif_hh_device_t* p_dev) {
+  if (p_dev->uhid.fd < 0) {
+    p_dev->uhid.fd = open(dev_path, O_RDWR | O_CLOEXEC);
+    if (p_dev->uhid.fd < 0) {
+      log::error("Failed to open uhid, err:{}", strerror(errno));
+      return false;
+    }
   }
 
-  /* Todo: Disconnect if loop exited due to a failure */
-  log::info("Polling thread stopped for device {}", p_uhid->link_spec);
-  p_uhid->hh_keep_polling = 0;
-  uhid_fd_close(p_uhid);
-  return 0;
+  if (p_dev->uhid.hh_keep_polling == 0) {
+    return uhid_loop_attach(&p_dev->uhid);
+  }
+  return true;
 }
 
 int bta_hh_co_write(int fd, uint8_t* rpt, uint16_t len) {
@@ -464,6 +552,7 @@ bool bta_hh_co_open(uint8_t dev_handle, uint8_t sub_class,
     p_dev->sub_class = sub_class;
     p_dev->app_id = app_id;
     p_dev->local_vup = false;
+    input_stats[p_dev - btif_hh_cb.devices] = {};
   }
 
   if (!uhid_fd_open(p_dev)) {
@@ -514,13 +603,8 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) {
   p_dev->uhid.set_rpt_id_queue = nullptr;
 #endif  // ENABLE_UHID_SET_REPORT
 
-  /* Stop the polling thread */
-  if (p_dev->uhid.hh_keep_polling) {
-    p_dev->uhid.hh_keep_polling = 0;
-    pthread_join(p_dev->hh_poll_thread_id, NULL);
-    p_dev->hh_poll_thread_id = -1;
-  }
-  /* UHID file descriptor is closed by the polling thread */
+  /* Stop polling, this closes the UHID file descriptor */
+  uhid_loop_release(&p_dev->uhid);
 }
 
 /*******************************************************************************
@@ -537,6 +621,7 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) {
  * Returns          void
  ******************************************************************************/
 void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len) {
+  uint64_t received_us = now_us();
   btif_hh_device_t* p_dev;
 
   log::verbose("dev_handle = {}", dev_handle);
@@ -560,12 +645,40 @@ void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len) {
   // Send the HID data to the kernel.
   if ((p_dev->uhid.fd >= 0) && p_dev->uhid.ready_for_data) {
     bta_hh_co_write(p_dev->uhid.fd, p_rpt, len);
+    auto& stats = input_stats[p_dev - btif_hh_cb.devices];
+    uint64_t written_us = now_us();
+    stats.latency.Add(written_us - received_us);
+    if (stats.last_report_us != 0) {
+      stats.interval.Add(received_us - stats.last_report_us);
+    }
+    stats.last_report_us = received_us;
   } else {
     log::warn("Error: fd = {}, ready {}, len = {}", p_dev->uhid.fd,
               p_dev->uhid.ready_for_data, len);
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_co_dump
+ *
+ * Description      Dumps the input report statistics of a device.
+ *
+ * Parameters       fd     - file descriptor of the dump
+ *                  p_dev  - device
+ *
+ * Returns          void
+ ******************************************************************************/
+#define DUMPSYS_TAG "shim::legacy::hid"
+void bta_hh_co_dump(int fd, const btif_hh_device_t* p_dev) {
+  const auto& stats = input_stats[p_dev - btif_hh_cb.devices];
+  LOG_DUMPSYS(fd, "    input latency in us: %s",
+              stats.latency.ToString().c_str());
+  LOG_DUMPSYS(fd, "    input interval in us: %s",
+              stats.interval.ToString().c_str());
+}
+#undef DUMPSYS_TAG
+
 /*******************************************************************************
  *
  * Function         bta_hh_co_send_hid_info
@@ -140,6 +140,18 @@ static constexpr int8_t kCriWarnRssi = -80;
 static constexpr uint8_t kCriWarnUnusedCh = 55;
 // The queue size of recording the BQR events.
 static constexpr uint8_t kBqrEventQueueSize = 25;
+// Warning criteria of the average retransmission count per report.
+static constexpr uint32_t kCriWarnRetransmissions = 100;
+// Warning criteria of the average lost packet count per report.
+static constexpr uint32_t kCriWarnLostPackets = 20;
+// Number of links whose reports are aggregated at the same time.
+static constexpr size_t kBqrAggregatedLinks = 8;
+// Weight of the older reports in the rolling averages: each report moves the
+// averages by 1/kBqrAggregateWeight of its difference with them.
+static constexpr int kBqrAggregateWeight = 8;
+// Time (in ms) without reports after which the aggregates of a link are
+// dropped, so that a reused connection handle starts from scratch.
+static constexpr uint64_t kBqrAggregateExpiryMs = 30000;
 // The Property of BQR event mask configuration.
 static constexpr const char* kpPropertyEventMask =
     "persist.bluetooth.bqr.event_mask";
@@ -351,6 +363,34 @@ typedef struct {
   const uint8_t* vendor_specific_parameter;
 } BqrLogDumpEvent;
 
+// Bits of BqrLinkQualityAggregate::warnings, set while the matching average
+// is past its warning criteria.
+static constexpr uint8_t kLinkQualityWarningRssi = 0x1 << 0;
+static constexpr uint8_t kLinkQualityWarningRetransmissions = 0x1 << 1;
+static constexpr uint8_t kLinkQualityWarningLostPackets = 0x1 << 2;
+static constexpr uint8_t kLinkQualityWarningBufferOverflow = 0x1 << 3;
+
+// Rolling aggregates of the Link Quality related BQR events of a connection.
+// The averages are per report, and the counts of each report are the ones
+// since the previous report.
+typedef struct {
+  // Connection handle of the connection.
+  uint16_t connection_handle;
+  // Number of reports aggregated.
+  uint32_t report_count;
+  // Average RSSI.
+  int8_t rssi;
+  // Average count of retransmission.
+  uint32_t retransmission_count;
+  // Average count of lost packets: the packets not received, and the packets
+  // not sent out by their flush point.
+  uint32_t lost_packets;
+  // Average count of bytes of TX data dropped on buffer overflow.
+  uint32_t buffer_overflow_bytes;
+  // The kLinkQualityWarning* bits currently set.
+  uint8_t warnings;
+} BqrLinkQualityAggregate;
+
 // BQR sub-event of Vendor Specific Event
 class BqrVseSubEvt {
  public:
@@ -403,6 +443,15 @@ BluetoothQualityReportInterface* getBluetoothQualityReportInterface();
 // @param to_bind gives the postable for the callback, or null if disabling.
 void EnableBtQualityReport(common::PostableContext* to_bind);
 
+// Get the rolling aggregates of the link quality reports of a connection, for
+// the policies that adapt to the link quality. May be called from any thread.
+//
+// @param connection_handle The connection handle of the connection.
+// @param aggregate Set to the aggregates of the connection.
+// @return true if there are recent reports for the connection.
+bool GetLinkQualityAggregate(uint16_t connection_handle,
+                             BqrLinkQualityAggregate* aggregate);
+
 // Dump Bluetooth Quality Report information.
 //
 // @param fd The file descriptor to use for dumping information.
@@ -22,6 +22,8 @@
 
 void jni_thread_startup();
 void jni_thread_shutdown();
+// Dump the depth, batching and latency counters of the JNI thread queue
+void jni_thread_dump(int fd);
 
 /*******************************************************************************
  *
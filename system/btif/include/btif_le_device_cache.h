@@ -0,0 +1,104 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "stack/include/bt_name.h"
+#include "types/bluetooth/uuid.h"
+#include "types/raw_address.h"
+
+namespace bluetooth {
+namespace btif {
+
+/// Bounded cache of the LE devices recently found by discovery.
+///
+/// The cache is a fixed array of records in a memory mapped file, so an
+/// update only touches the record of the device, and the devices found
+/// before a restart are available as soon as the cache is opened. When
+/// the cache is full, the least recently seen device is replaced.
+///
+/// The cache is not thread safe, it is only used from the main thread.
+class LeDeviceCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 256;
+  static constexpr size_t kMaxUuids = 8;
+
+  struct Device {
+    RawAddress address;
+    uint8_t address_type;
+    std::string name;
+    uint16_t appearance;
+    std::vector<bluetooth::Uuid> uuids;
+    int8_t rssi;
+    std::chrono::system_clock::time_point last_seen;
+  };
+
+  LeDeviceCache() = default;
+  ~LeDeviceCache();
+
+  LeDeviceCache(const LeDeviceCache&) = delete;
+
+  LeDeviceCache& operator=(const LeDeviceCache&) = delete;
+
+  /// Map the cache file at |path|, creating it if needed. A file with an
+  /// unexpected layout is reset. Returns false if the file cannot be
+  /// mapped, in which case the cache stays closed.
+  bool Open(const std::string& path, size_t capacity = kDefaultCapacity);
+
+  /// Flush and unmap the cache file.
+  void Close();
+
+  bool IsOpen() const { return records_ != nullptr; }
+
+  /// Record that |address| was seen at |now|. An empty |name|, a zero
+  /// |appearance| or no |uuids| leave the cached value unchanged.
+  void Update(const RawAddress& address, uint8_t address_type, int8_t rssi,
+              const std::string& name, uint16_t appearance,
+              const std::vector<bluetooth::Uuid>& uuids,
+              std::chrono::system_clock::time_point now);
+
+  void Remove(const RawAddress& address);
+
+  /// Returns the devices seen within |max_age| of |now|, most recently
+  /// seen first.
+  std::vector<Device> GetRecentDevices(
+      std::chrono::seconds max_age,
+      std::chrono::system_clock::time_point now) const;
+
+  size_t Size() const { return index_.size(); }
+
+ private:
+  struct Header;
+  struct Record;
+
+  Record* Allocate(const RawAddress& address);
+
+  Header* header_{nullptr};
+  Record* records_{nullptr};
+  size_t capacity_{0};
+  size_t mapped_size_{0};
+  std::unordered_map<RawAddress, size_t> index_;
+};
+
+}  // namespace btif
+}  // namespace bluetooth
@@ -6,6 +6,7 @@
 #define BTIF_SOCK_L2CAP_H
 
 #include <hardware/bluetooth.h>
+#include <hardware/bt_sock.h>
 
 #include "btif_uid.h"
 #include "types/raw_address.h"
@@ -17,11 +18,14 @@ bt_status_t btsock_l2cap_listen(const char* name, int channel, int* sock_fd,
 bt_status_t btsock_l2cap_connect(const RawAddress* bd_addr, int channel,
                                  int* sock_fd, int flags, int app_uid);
 void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id);
+void btsock_l2cap_dump(int fd);
 void on_l2cap_psm_assigned(int id, int psm);
 bt_status_t btsock_l2cap_disconnect(const RawAddress* bd_addr);
 bt_status_t btsock_l2cap_get_l2cap_local_cid(bluetooth::Uuid& conn_uuid,
                                              uint16_t* cid);
 bt_status_t btsock_l2cap_get_l2cap_remote_cid(bluetooth::Uuid& conn_uuid,
                                               uint16_t* cid);
+bt_status_t btsock_l2cap_get_l2cap_tx_info(bluetooth::Uuid& conn_uuid,
+                                           btsock_tx_info_t* info);
 
 #endif
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "types/raw_address.h"
 
 void btif_sock_connection_logger(const RawAddress& address, int port, int type,
@@ -23,3 +26,10 @@ void btif_sock_connection_logger(const RawAddress& address, int port, int type,
                                  int64_t tx_bytes, int64_t rx_bytes,
                                  const char* server_name);
 void btif_sock_dump(int fd);
+// Dumps one active socket: traffic since |connected_time_ms| and data queued
+// for the app
+void btif_sock_dump_active_socket(int fd, int type, uint32_t id,
+                                  const RawAddress& address, int channel,
+                                  int64_t tx_bytes, int64_t rx_bytes,
+                                  uint64_t connected_time_ms,
+                                  size_t queued_buffers, size_t queued_bytes);
@@ -49,11 +49,19 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bta/hh/bta_hh_int.h"  // for HID HACK profile methods
 #include "bta/include/bta_api.h"
 #include "bta/include/bta_ar_api.h"
 #include "bta/include/bta_csis_api.h"
+#include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_has_api.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
@@ -61,6 +69,7 @@
 #include "bta/include/bta_le_audio_broadcaster_api.h"
 #include "bta/include/bta_vc_api.h"
 #include "btif/avrcp/avrcp_service.h"
+#include "btif/include/btif_jni_task.h"
 #include "btif/include/btif_sock.h"
 #include "btif/include/btif_sock_logging.h"
 #include "btif/include/core_callbacks.h"
@@ -85,8 +94,12 @@
 #include "btif_storage.h"
 #include "common/address_obfuscator.h"
 #include "common/init_flags.h"
+#include "common/latency_trace.h"
 #include "common/metrics.h"
+#include "common/metrics_registry.h"
 #include "common/os_utils.h"
+#include "common/scope_profiler.h"
+#include "common/task_profiler.h"
 #include "device/include/device_iot_config.h"
 #include "device/include/esco_parameters.h"
 #include "device/include/interop.h"
@@ -96,6 +109,8 @@
 #include "os/parameter_provider.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_budget.h"
+#include "osi/include/properties.h"
 #include "osi/include/stack_power_telemetry.h"
 #include "osi/include/wakelock.h"
 #include "stack/btm/btm_sco_hfp_hal.h"
@@ -111,6 +126,7 @@
 #include "stack/include/hidh_api.h"
 #include "stack/include/main_thread.h"
 #include "stack/include/pan_api.h"
+#include "stack/include/port_api.h"
 #include "storage/config_keys.h"
 #include "types/raw_address.h"
 
@@ -428,6 +444,34 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
 
   set_hal_cbacks(callbacks);
 
+  // The buffer pools have to be enabled before the stack threads start
+  // allocating.
+  if (osi_property_get_bool("persist.bluetooth.osi_buffer_pools.enabled",
+                            false)) {
+    osi_allocator_pool_enable();
+  }
+
+  // Budgets of the buffers held in the stack queues, in KiB, 0 for no budget
+  buffer_budget_set_total(
+      std::max(0, osi_property_get_int32(
+                      "persist.bluetooth.buffer_budget.total_kb", 0)) *
+      1024);
+  for (int owner = 0; owner < BUFFER_OWNER_COUNT; owner++) {
+    std::string property =
+        std::string("persist.bluetooth.buffer_budget.") +
+        buffer_budget_owner_name(static_cast<buffer_owner_t>(owner)) + "_kb";
+    buffer_budget_set(
+        static_cast<buffer_owner_t>(owner),
+        std::max(0, osi_property_get_int32(property.c_str(), 0)) * 1024);
+  }
+
+  bluetooth::common::LatencyTrace::SetEnabled(osi_property_get_bool(
+      "persist.bluetooth.latency_trace.enabled", false));
+  bluetooth::common::ScopeProfiler::SetEnabled(osi_property_get_bool(
+      "persist.bluetooth.scope_profiler.enabled", false));
+  bluetooth::common::TaskProfiler::SetEnabled(osi_property_get_bool(
+      "persist.bluetooth.task_profiler.enabled", false));
+
   restricted_mode = start_restricted;
 
   bluetooth::os::ParameterProvider::SetBtKeystoreInterface(
@@ -817,13 +861,20 @@ static void dump(int fd, const char** arguments) {
   bta_debug_av_dump(fd);
   stack_debug_avdtp_api_dump(fd);
   btif_sock_dump(fd);
+  RFCOMM_Dumpsys(fd);
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   gatt_tcb_dump(fd);
   bta_gatt_client_dump(fd);
+  BtaGattQueue::DebugDump(fd);
   device_debug_iot_config_dump(fd);
   BTA_HfClientDumpStatistics(fd);
   wakelock_debug_dump(fd);
   alarm_debug_dump(fd);
+  bluetooth::common::TaskProfiler::DebugDump(fd);
+  bluetooth::common::MetricsRegistry::DebugDump(fd);
+  jni_thread_dump(fd);
+  osi_allocator_debug_dump(fd);
+  buffer_budget_debug_dump(fd);
   bluetooth::csis::CsisClient::DebugDump(fd);
   ::bluetooth::le_audio::has::HasClient::DebugDump(fd);
   HearingAid::DebugDump(fd);
@@ -986,6 +1037,11 @@ int le_test_mode(uint16_t opcode, uint8_t* buf, uint8_t len) {
 
 static bt_os_callouts_t* wakelock_os_callouts_saved = nullptr;
 
+// Each wakelock callout is a hop to the JNI thread and a binder call to the
+// power manager: alarms set back to back keep the wakelock for this long
+// rather than releasing and acquiring it again in between.
+static constexpr uint64_t kWakelockReleaseDelayMs = 100;
+
 static int acquire_wake_lock_cb(const char* lock_name) {
   return do_in_jni_thread(base::BindOnce(
       base::IgnoreResult(wakelock_os_callouts_saved->acquire_wake_lock),
@@ -1007,6 +1063,7 @@ static bt_os_callouts_t wakelock_os_callouts_jni = {
 static int set_os_callouts(bt_os_callouts_t* callouts) {
   wakelock_os_callouts_saved = callouts;
   wakelock_set_os_callouts(&wakelock_os_callouts_jni);
+  wakelock_set_release_delay_ms(kWakelockReleaseDelayMs);
   return BT_STATUS_SUCCESS;
 }
 
@@ -1280,9 +1337,102 @@ void invoke_adapter_properties_cb(bt_status_t status, int num_properties,
       property_deep_copy_array(num_properties, properties)));
 }
 
+namespace {
+
+#ifndef PROPERTY_BATCH_REMOTE_PROPERTIES
+#define PROPERTY_BATCH_REMOTE_PROPERTIES \
+  "bluetooth.btif.batch_remote_properties.enabled"
+#endif
+
+/* Most devices delivered by one batched remote properties callback */
+constexpr size_t kMaxBatchedDevices = 64;
+
+struct RemotePropertiesUpdate {
+  RawAddress bd_addr;
+  int num_properties;
+  bt_property_t* properties; /* from property_deep_copy_array() */
+};
+using RemotePropertiesBatch = std::vector<RemotePropertiesUpdate>;
+
+/* Successful remote property updates are collected into the open batch, which
+ * is delivered once the jni thread reaches it. While discovery is running this
+ * turns a stream of name and RSSI updates into a few callbacks. Any other
+ * device event closes the batch, so that it can't be overtaken by updates
+ * reported after it. */
+std::mutex remote_properties_batch_mutex;
+std::shared_ptr<RemotePropertiesBatch> remote_properties_batch;
+
+bool remote_properties_batching_enabled() {
+  static const bool enabled =
+      osi_property_get_bool(PROPERTY_BATCH_REMOTE_PROPERTIES, true);
+  return enabled && bt_hal_cbacks != nullptr &&
+         bt_hal_cbacks->size >=
+             offsetof(bt_callbacks_t, remote_device_properties_batch_cb) +
+                 sizeof(bt_hal_cbacks->remote_device_properties_batch_cb) &&
+         bt_hal_cbacks->remote_device_properties_batch_cb != nullptr;
+}
+
+void close_remote_properties_batch() {
+  std::lock_guard<std::mutex> lock(remote_properties_batch_mutex);
+  remote_properties_batch.reset();
+}
+
+void deliver_remote_properties_batch(
+    std::shared_ptr<RemotePropertiesBatch> batch) {
+  {
+    std::lock_guard<std::mutex> lock(remote_properties_batch_mutex);
+    if (remote_properties_batch == batch) remote_properties_batch.reset();
+  }
+
+  std::vector<RawAddress> bd_addrs;
+  std::vector<int> num_properties;
+  std::vector<bt_property_t> properties;
+  bd_addrs.reserve(batch->size());
+  num_properties.reserve(batch->size());
+  for (const auto& update : *batch) {
+    bd_addrs.push_back(update.bd_addr);
+    num_properties.push_back(update.num_properties);
+    properties.insert(properties.end(), update.properties,
+                      update.properties + update.num_properties);
+  }
+
+  HAL_CBACK(bt_hal_cbacks, remote_device_properties_batch_cb,
+            static_cast<int>(bd_addrs.size()), bd_addrs.data(),
+            num_properties.data(), properties.data());
+
+  for (auto& update : *batch) {
+    osi_free(update.properties);
+  }
+}
+
+bool batch_remote_properties(const RawAddress& bd_addr, int num_properties,
+                             bt_property_t* properties) {
+  if (!remote_properties_batching_enabled()) return false;
+
+  std::lock_guard<std::mutex> lock(remote_properties_batch_mutex);
+  if (remote_properties_batch == nullptr ||
+      remote_properties_batch->size() >= kMaxBatchedDevices) {
+    remote_properties_batch = std::make_shared<RemotePropertiesBatch>();
+    remote_properties_batch->reserve(kMaxBatchedDevices);
+    do_in_jni_thread(base::BindOnce(deliver_remote_properties_batch,
+                                    remote_properties_batch));
+  }
+  remote_properties_batch->push_back(
+      {bd_addr, num_properties,
+       property_deep_copy_array(num_properties, properties)});
+  return true;
+}
+
+}  // namespace
+
 void invoke_remote_device_properties_cb(bt_status_t status, RawAddress bd_addr,
                                         int num_properties,
                                         bt_property_t* properties) {
+  if (status == BT_STATUS_SUCCESS &&
+      batch_remote_properties(bd_addr, num_properties, properties)) {
+    return;
+  }
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](bt_status_t status, RawAddress bd_addr, int num_properties,
          bt_property_t* properties) {
@@ -1297,6 +1447,7 @@ void invoke_remote_device_properties_cb(bt_status_t status, RawAddress bd_addr,
 }
 
 void invoke_device_found_cb(int num_properties, bt_property_t* properties) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](int num_properties, bt_property_t* properties) {
         HAL_CBACK(bt_hal_cbacks, device_found_cb, num_properties, properties);
@@ -1308,6 +1459,7 @@ void invoke_device_found_cb(int num_properties, bt_property_t* properties) {
 }
 
 void invoke_discovery_state_changed_cb(bt_discovery_state_t state) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](bt_discovery_state_t state) {
         HAL_CBACK(bt_hal_cbacks, discovery_state_changed_cb, state);
@@ -1317,6 +1469,7 @@ void invoke_discovery_state_changed_cb(bt_discovery_state_t state) {
 
 void invoke_pin_request_cb(RawAddress bd_addr, bt_bdname_t bd_name,
                            uint32_t cod, bool min_16_digit) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](RawAddress bd_addr, bt_bdname_t bd_name, uint32_t cod,
          bool min_16_digit) {
@@ -1328,6 +1481,7 @@ void invoke_pin_request_cb(RawAddress bd_addr, bt_bdname_t bd_name,
 
 void invoke_ssp_request_cb(RawAddress bd_addr, bt_ssp_variant_t pairing_variant,
                            uint32_t pass_key) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](RawAddress bd_addr, bt_ssp_variant_t pairing_variant,
          uint32_t pass_key) {
@@ -1385,6 +1539,7 @@ void invoke_oob_data_request_cb(tBT_TRANSPORT t, bool valid, Octet16 c,
 
 void invoke_bond_state_changed_cb(bt_status_t status, RawAddress bd_addr,
                                   bt_bond_state_t state, int fail_reason) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](bt_status_t status, RawAddress bd_addr, bt_bond_state_t state,
          int fail_reason) {
@@ -1396,6 +1551,7 @@ void invoke_bond_state_changed_cb(bt_status_t status, RawAddress bd_addr,
 
 void invoke_address_consolidate_cb(RawAddress main_bd_addr,
                                    RawAddress secondary_bd_addr) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](RawAddress main_bd_addr, RawAddress secondary_bd_addr) {
         HAL_CBACK(bt_hal_cbacks, address_consolidate_cb, &main_bd_addr,
@@ -1406,6 +1562,7 @@ void invoke_address_consolidate_cb(RawAddress main_bd_addr,
 
 void invoke_le_address_associate_cb(RawAddress main_bd_addr,
                                     RawAddress secondary_bd_addr) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](RawAddress main_bd_addr, RawAddress secondary_bd_addr) {
         HAL_CBACK(bt_hal_cbacks, le_address_associate_cb, &main_bd_addr,
@@ -1418,6 +1575,7 @@ void invoke_acl_state_changed_cb(bt_status_t status, RawAddress bd_addr,
                                  bt_hci_error_code_t hci_reason,
                                  bt_conn_direction_t direction,
                                  uint16_t acl_handle) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](bt_status_t status, RawAddress bd_addr, bt_acl_state_t state,
          int transport_link_type, bt_hci_error_code_t hci_reason,
@@ -1495,6 +1653,7 @@ void invoke_switch_codec_cb(bool is_low_latency_buffer_size) {
 }
 
 void invoke_key_missing_cb(RawAddress bd_addr) {
+  close_remote_properties_batch();
   do_in_jni_thread(base::BindOnce(
       [](RawAddress bd_addr) {
         HAL_CBACK(bt_hal_cbacks, key_missing_cb, bd_addr);
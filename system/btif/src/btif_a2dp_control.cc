@@ -24,6 +24,7 @@
 #include <bluetooth/log.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "btif_a2dp_sink.h"
@@ -237,17 +238,20 @@ static void btif_a2dp_control_on_set_output_audio_config() {
 static void btif_a2dp_control_on_get_presentation_position() {
   btif_a2dp_command_ack(A2DP_CTRL_ACK_SUCCESS);
 
-  UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0,
-            (uint8_t*)&(delay_report_stats.total_bytes_read), sizeof(uint64_t));
-  UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0,
-            (uint8_t*)&(delay_report_stats.audio_delay), sizeof(uint16_t));
-
+  // Sent with a single write as the audio HAL asks for it while streaming:
+  // total bytes read (8) | audio delay (2) | seconds (4) | nanoseconds (4)
+  uint8_t position[sizeof(uint64_t) + sizeof(uint16_t) + 2 * sizeof(uint32_t)];
+  uint8_t* p = position;
   uint32_t seconds = delay_report_stats.timestamp.tv_sec;
-  UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, (uint8_t*)&seconds,
-            sizeof(seconds));
-
   uint32_t nsec = delay_report_stats.timestamp.tv_nsec;
-  UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, (uint8_t*)&nsec, sizeof(nsec));
+  memcpy(p, &delay_report_stats.total_bytes_read, sizeof(uint64_t));
+  p += sizeof(uint64_t);
+  memcpy(p, &delay_report_stats.audio_delay, sizeof(uint16_t));
+  p += sizeof(uint16_t);
+  memcpy(p, &seconds, sizeof(seconds));
+  p += sizeof(seconds);
+  memcpy(p, &nsec, sizeof(nsec));
+  UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, position, sizeof(position));
 }
 
 static void btif_a2dp_recv_ctrl_data(void) {
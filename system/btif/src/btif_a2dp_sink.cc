@@ -25,7 +25,11 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <mutex>
 #include <string>
 
@@ -34,10 +38,12 @@
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "types/raw_address.h"
 
@@ -55,6 +61,22 @@ using namespace bluetooth;
 /* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
 #define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
 
+/**
+ * With the adaptive playout, the received packets are held in the queue until
+ * it holds a target duration of media, and each tick only decodes the media
+ * due since the previous one. The target follows the jitter of the arrival
+ * times against the RTP timestamps, grows on underruns, and shrinks back after
+ * a while without one.
+ */
+#define A2DP_SINK_ADAPTIVE_PLAYOUT_PROPERTY \
+  "persist.bluetooth.a2dp_sink.adaptive_playout.enabled"
+#define A2DP_SINK_JITTER_BUFFER_MIN_MS 40
+#define A2DP_SINK_JITTER_BUFFER_MAX_MS 240
+#define A2DP_SINK_JITTER_BUFFER_STEP_MS BTIF_SINK_MEDIA_TIME_TICK_MS
+#define A2DP_SINK_JITTER_BUFFER_DECAY_MS 10000
+/* Longer gaps in the sequence numbers are not concealed */
+#define A2DP_SINK_MAX_CONCEALED_PACKETS 8
+
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
   BTIF_A2DP_SINK_STATE_STARTING_UP,
@@ -82,6 +104,68 @@ typedef struct {
   btif_a2dp_sink_focus_state_t focus_state;
 } tBTIF_MEDIA_SINK_FOCUS_UPDATE;
 
+/* State of the adaptive playout, reset for each stream start */
+struct BtifA2dpSinkJitterBuffer {
+  void Reset() {
+    playing = false;
+    playout_credit_us = 0;
+    last_playout_us = 0;
+    has_last_rx = false;
+    last_rx_seq = 0;
+    last_rx_timestamp = 0;
+    last_rx_us = 0;
+    has_last_played = false;
+    last_played_seq = 0;
+  }
+
+  bool playing; /* false while (re)buffering up to the target */
+  int64_t playout_credit_us;
+  uint64_t last_playout_us;
+  bool has_last_rx;
+  uint16_t last_rx_seq;
+  uint32_t last_rx_timestamp;
+  uint64_t last_rx_us;
+  bool has_last_played;
+  uint16_t last_played_seq;
+};
+
+struct BtifA2dpSinkStats {
+  void Reset() {
+    jitter_us = 0;
+    packet_duration_us = 0;
+    margin_ms = 0;
+    last_margin_update_us = 0;
+    rx_packets = 0;
+    lost_packets = 0;
+    concealed_packets = 0;
+    overflow_dropped_packets = 0;
+    latency_dropped_packets = 0;
+    underruns = 0;
+    last_underrun_us = 0;
+    total_depth_us = 0;
+    max_depth_us = 0;
+    depth_updates = 0;
+  }
+
+  /* Estimated like the interarrival jitter of RFC 3550 */
+  uint32_t jitter_us;
+  uint32_t packet_duration_us;
+  /* Added to the target depth after the underruns */
+  uint32_t margin_ms;
+  uint64_t last_margin_update_us;
+  size_t rx_packets;
+  size_t lost_packets;
+  size_t concealed_packets;
+  size_t overflow_dropped_packets;
+  size_t latency_dropped_packets;
+  size_t underruns;
+  uint64_t last_underrun_us;
+  /* Media held by the queue at each playout tick */
+  uint64_t total_depth_us;
+  uint64_t max_depth_us;
+  size_t depth_updates;
+};
+
 /* BTIF A2DP Sink control block */
 class BtifA2dpSinkControlBlock {
  public:
@@ -89,6 +173,7 @@ class BtifA2dpSinkControlBlock {
       : worker_thread(thread_name),
         rx_audio_queue(nullptr),
         rx_flush(false),
+        adaptive_playout(false),
         decode_alarm(nullptr),
         sample_rate(0),
         channel_count(0),
@@ -107,6 +192,9 @@ class BtifA2dpSinkControlBlock {
     alarm_free(decode_alarm);
     decode_alarm = nullptr;
     rx_flush = false;
+    adaptive_playout = false;
+    jitter_buffer.Reset();
+    stats.Reset();
     rx_focus_state = BTIF_A2DP_SINK_FOCUS_NOT_GRANTED;
     sample_rate = 0;
     channel_count = 0;
@@ -116,6 +204,9 @@ class BtifA2dpSinkControlBlock {
   MessageLoopThread worker_thread;
   fixed_queue_t* rx_audio_queue;
   bool rx_flush; /* discards any incoming data when true */
+  bool adaptive_playout;
+  BtifA2dpSinkJitterBuffer jitter_buffer;
+  BtifA2dpSinkStats stats;
   alarm_t* decode_alarm;
   tA2DP_SAMPLE_RATE sample_rate;
   tA2DP_BITS_PER_SAMPLE bits_per_sample;
@@ -144,6 +235,7 @@ static void btif_a2dp_sink_audio_handle_stop_decoding();
 static void btif_decode_alarm_cb(void* context);
 static void btif_a2dp_sink_audio_handle_start_decoding();
 static void btif_a2dp_sink_avk_handle_timer();
+static void btif_a2dp_sink_adaptive_playout();
 static void btif_a2dp_sink_audio_rx_flush_req();
 /* Handle incoming media packets A2DP SINK streaming */
 static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg);
@@ -513,6 +605,7 @@ static void btif_a2dp_sink_audio_handle_start_decoding() {
   BtifAvrcpAudioTrackStart(btif_a2dp_sink_cb.audio_track);
 #endif
 
+  btif_a2dp_sink_cb.jitter_buffer.Reset();
   btif_a2dp_sink_cb.decode_alarm = alarm_new_periodic("btif.a2dp_sink_decode");
   if (btif_a2dp_sink_cb.decode_alarm == nullptr) {
     log::error("unable to allocate decode alarm");
@@ -545,11 +638,173 @@ static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg) {
   }
 }
 
+// The RTP timestamp is kept ahead of the payload by
+// btif_a2dp_sink_enqueue_buf().
+static uint32_t btif_a2dp_sink_packet_timestamp(const BT_HDR* p_msg) {
+  return *((const uint32_t*)p_msg->data);
+}
+
+static uint64_t btif_a2dp_sink_timestamp_to_us(uint32_t timestamp_delta) {
+  if (btif_a2dp_sink_cb.sample_rate == 0) return 0;
+  return (uint64_t)timestamp_delta * 1000000 / btif_a2dp_sink_cb.sample_rate;
+}
+
+// Must be called while locked.
+static void btif_a2dp_sink_update_jitter(uint16_t seq, uint32_t timestamp,
+                                         uint64_t now_us) {
+  BtifA2dpSinkJitterBuffer& jb = btif_a2dp_sink_cb.jitter_buffer;
+  BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+
+  if (jb.has_last_rx) {
+    int32_t timestamp_delta = (int32_t)(timestamp - jb.last_rx_timestamp);
+    int64_t media_delta_us =
+        timestamp_delta >= 0
+            ? (int64_t)btif_a2dp_sink_timestamp_to_us(timestamp_delta)
+            : -(int64_t)btif_a2dp_sink_timestamp_to_us(-timestamp_delta);
+    if (seq == (uint16_t)(jb.last_rx_seq + 1) && timestamp_delta > 0) {
+      stats.packet_duration_us = media_delta_us;
+    }
+
+    // Difference of the transit times of the two packets, a single late burst
+    // is capped so that it does not hold the target at its maximum.
+    int64_t transit_delta_us =
+        std::min<int64_t>(std::llabs((int64_t)(now_us - jb.last_rx_us) -
+                                     media_delta_us),
+                          A2DP_SINK_JITTER_BUFFER_MAX_MS * 1000);
+    stats.jitter_us += (transit_delta_us - (int64_t)stats.jitter_us) / 16;
+  }
+
+  jb.has_last_rx = true;
+  jb.last_rx_seq = seq;
+  jb.last_rx_timestamp = timestamp;
+  jb.last_rx_us = now_us;
+}
+
+// Must be called while locked.
+static uint64_t btif_a2dp_sink_queued_media_us() {
+  fixed_queue_t* queue = btif_a2dp_sink_cb.rx_audio_queue;
+  const BT_HDR* p_first = (const BT_HDR*)fixed_queue_try_peek_first(queue);
+  const BT_HDR* p_last = (const BT_HDR*)fixed_queue_try_peek_last(queue);
+  if (p_first == nullptr || p_last == nullptr) return 0;
+
+  int32_t timestamp_delta = (int32_t)(btif_a2dp_sink_packet_timestamp(p_last) -
+                                      btif_a2dp_sink_packet_timestamp(p_first));
+  return btif_a2dp_sink_timestamp_to_us(std::max(timestamp_delta, 0)) +
+         btif_a2dp_sink_cb.stats.packet_duration_us;
+}
+
+// Must be called while locked.
+static uint64_t btif_a2dp_sink_target_depth_us(uint64_t now_us) {
+  BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+
+  if (stats.margin_ms > 0 && now_us - stats.last_margin_update_us >=
+                                 A2DP_SINK_JITTER_BUFFER_DECAY_MS * 1000) {
+    stats.margin_ms -=
+        std::min<uint32_t>(stats.margin_ms, A2DP_SINK_JITTER_BUFFER_STEP_MS);
+    stats.last_margin_update_us = now_us;
+  }
+
+  uint64_t target_us =
+      4 * (uint64_t)stats.jitter_us + (uint64_t)stats.margin_ms * 1000;
+  return std::clamp<uint64_t>(target_us, A2DP_SINK_JITTER_BUFFER_MIN_MS * 1000,
+                              A2DP_SINK_JITTER_BUFFER_MAX_MS * 1000);
+}
+
+// Must be called while locked.
+static void btif_a2dp_sink_conceal_lost_packets(const BT_HDR* p_msg) {
+  BtifA2dpSinkJitterBuffer& jb = btif_a2dp_sink_cb.jitter_buffer;
+  BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+  uint16_t seq = p_msg->layer_specific;
+
+  if (jb.has_last_played) {
+    // Packets older than the last played one give a large difference and are
+    // not taken as losses.
+    uint16_t num_lost = (uint16_t)(seq - jb.last_played_seq - 1);
+    if (num_lost > 0 && num_lost <= A2DP_SINK_MAX_CONCEALED_PACKETS) {
+      stats.lost_packets += num_lost;
+      if (btif_a2dp_sink_cb.decoder_interface != nullptr &&
+          btif_a2dp_sink_cb.decoder_interface->decoder_conceal_packets !=
+              nullptr) {
+        btif_a2dp_sink_cb.decoder_interface->decoder_conceal_packets(num_lost);
+        stats.concealed_packets += num_lost;
+      }
+    }
+  }
+
+  jb.has_last_played = true;
+  jb.last_played_seq = seq;
+}
+
+// Must be called while locked.
+static void btif_a2dp_sink_adaptive_playout() {
+  BtifA2dpSinkJitterBuffer& jb = btif_a2dp_sink_cb.jitter_buffer;
+  BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+  const uint64_t tick_us = BTIF_SINK_MEDIA_TIME_TICK_MS * 1000;
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  uint64_t target_us = btif_a2dp_sink_target_depth_us(now_us);
+  uint64_t depth_us = btif_a2dp_sink_queued_media_us();
+
+  if (!jb.playing) {
+    if (depth_us < target_us) {
+      log::verbose("buffering {} us of {} us", depth_us, target_us);
+      return;
+    }
+    // Start with one tick of media ahead in the audio track
+    jb.playing = true;
+    jb.playout_credit_us = 0;
+    jb.last_playout_us = now_us - tick_us;
+  }
+
+  stats.total_depth_us += depth_us;
+  stats.max_depth_us = std::max(stats.max_depth_us, depth_us);
+  stats.depth_updates++;
+
+  // A burst after a stall of the link leaves more media than needed, drop the
+  // oldest packets to bring the latency back to the target.
+  while (depth_us > target_us + 2 * tick_us &&
+         fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) > 1) {
+    BT_HDR* p_msg =
+        (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue);
+    jb.has_last_played = true;
+    jb.last_played_seq = p_msg->layer_specific;
+    osi_free(p_msg);
+    stats.latency_dropped_packets++;
+    depth_us = btif_a2dp_sink_queued_media_us();
+  }
+
+  const uint32_t packet_duration_us =
+      stats.packet_duration_us > 0 ? stats.packet_duration_us : tick_us;
+  jb.playout_credit_us += now_us - jb.last_playout_us;
+  jb.last_playout_us = now_us;
+  while (jb.playout_credit_us > 0) {
+    BT_HDR* p_msg =
+        (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue);
+    if (p_msg == nullptr) {
+      log::verbose("underrun, buffering again");
+      stats.underruns++;
+      stats.last_underrun_us = now_us;
+      stats.margin_ms = std::min<uint32_t>(
+          stats.margin_ms + A2DP_SINK_JITTER_BUFFER_STEP_MS,
+          A2DP_SINK_JITTER_BUFFER_MAX_MS);
+      stats.last_margin_update_us = now_us;
+      jb.playing = false;
+      break;
+    }
+
+    btif_a2dp_sink_conceal_lost_packets(p_msg);
+    btif_a2dp_sink_handle_inc_media(p_msg);
+    osi_free(p_msg);
+    jb.playout_credit_us -= packet_duration_us;
+  }
+}
+
 static void btif_a2dp_sink_avk_handle_timer() {
   LockGuard lock(g_mutex);
 
   BT_HDR* p_msg;
-  if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
+  // An empty queue is an underrun once the adaptive playout has started
+  if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue) &&
+      !btif_a2dp_sink_cb.jitter_buffer.playing) {
     log::verbose("empty queue");
     return;
   }
@@ -562,6 +817,12 @@ static void btif_a2dp_sink_avk_handle_timer() {
   /* Play only in BTIF_A2DP_SINK_FOCUS_GRANTED case */
   if (btif_a2dp_sink_cb.rx_flush) {
     fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+    btif_a2dp_sink_cb.jitter_buffer.Reset();
+    return;
+  }
+
+  if (btif_a2dp_sink_cb.adaptive_playout) {
+    btif_a2dp_sink_adaptive_playout();
     return;
   }
 
@@ -594,6 +855,7 @@ static void btif_a2dp_sink_audio_rx_flush_event() {
   LockGuard lock(g_mutex);
   // Flush all received encoded audio buffers
   fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+  btif_a2dp_sink_cb.jitter_buffer.Reset();
 }
 
 static void btif_a2dp_sink_decoder_update_event(
@@ -630,6 +892,8 @@ static void btif_a2dp_sink_decoder_update_event(
   btif_a2dp_sink_cb.channel_count = channel_count;
 
   btif_a2dp_sink_cb.rx_flush = false;
+  btif_a2dp_sink_cb.adaptive_playout =
+      osi_property_get_bool(A2DP_SINK_ADAPTIVE_PLAYOUT_PROPERTY, false);
   log::verbose("reset to Sink role");
 
   bta_av_co_save_codec(p_buf->codec_info);
@@ -671,17 +935,28 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
     return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
 
   log::verbose("+");
-  /* Allocate and queue this buffer */
-  BT_HDR* p_msg =
-      reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
+  /* Allocate and queue this buffer, the RTP timestamp passed by BTA in the
+   * first bytes is kept ahead of the payload */
+  uint32_t timestamp;
+  memcpy(&timestamp, p_pkt->data, sizeof(timestamp));
+  BT_HDR* p_msg = reinterpret_cast<BT_HDR*>(
+      osi_malloc(sizeof(*p_msg) + sizeof(timestamp) + p_pkt->len));
   memcpy(p_msg, p_pkt, sizeof(*p_msg));
-  p_msg->offset = 0;
-  memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
+  p_msg->offset = sizeof(timestamp);
+  memcpy(p_msg->data, &timestamp, sizeof(timestamp));
+  memcpy(p_msg->data + p_msg->offset, p_pkt->data + p_pkt->offset, p_pkt->len);
   fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
 
+  btif_a2dp_sink_cb.stats.rx_packets++;
+  if (btif_a2dp_sink_cb.adaptive_playout) {
+    btif_a2dp_sink_update_jitter(p_msg->layer_specific, timestamp,
+                                 bluetooth::common::time_get_os_boottime_us());
+  }
+
   if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
       MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
     osi_free(fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue));
+    btif_a2dp_sink_cb.stats.overflow_dropped_packets++;
     uint8_t ret = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
     return ret;
   }
@@ -714,8 +989,46 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(int /* fd */) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  const BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+  dprintf(fd, "\nA2DP Sink State:\n");
+  dprintf(fd, "  Adaptive playout: %s\n",
+          btif_a2dp_sink_cb.adaptive_playout ? "true" : "false");
+  dprintf(fd,
+          "  Counts (received/lost/concealed)                        : %zu / "
+          "%zu / %zu\n",
+          stats.rx_packets, stats.lost_packets, stats.concealed_packets);
+  dprintf(fd,
+          "  Counts (dropped on overflow/dropped on latency)         : %zu / "
+          "%zu\n",
+          stats.overflow_dropped_packets, stats.latency_dropped_packets);
+  dprintf(fd,
+          "  Counts (underruns)                                      : %zu\n",
+          stats.underruns);
+  dprintf(fd,
+          "  Last underrun time ago in ms                            : %llu\n",
+          (stats.last_underrun_us > 0)
+              ? (unsigned long long)(now_us - stats.last_underrun_us) / 1000
+              : 0);
+  dprintf(fd,
+          "  Jitter and packet duration in ms                        : %u / "
+          "%u\n",
+          stats.jitter_us / 1000, stats.packet_duration_us / 1000);
+  dprintf(fd,
+          "  Jitter buffer margin in ms                              : %u\n",
+          stats.margin_ms);
+  dprintf(fd,
+          "  Jitter buffer depth in ms (max/ave)                     : %llu / "
+          "%llu\n",
+          (unsigned long long)stats.max_depth_us / 1000,
+          (stats.depth_updates > 0)
+              ? (unsigned long long)(stats.total_depth_us /
+                                     stats.depth_updates) /
+                    1000
+              : 0);
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
@@ -739,6 +1052,7 @@ static void btif_a2dp_sink_set_focus_state_event(
   btif_a2dp_sink_cb.rx_focus_state = state;
   if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED) {
     fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+    btif_a2dp_sink_cb.jitter_buffer.Reset();
     btif_a2dp_sink_cb.rx_flush = true;
   } else if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
     btif_a2dp_sink_cb.rx_flush = false;
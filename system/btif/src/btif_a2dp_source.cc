@@ -26,11 +26,13 @@
 #ifdef __ANDROID__
 #include <cutils/trace.h>
 #endif
+#include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <future>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
@@ -44,10 +46,14 @@
 #include "common/message_loop_thread.h"
 #include "common/metrics.h"
 #include "common/repeating_timer.h"
+#include "common/scope_profiler.h"
 #include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_budget.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/properties.h"
+#include "osi/include/thread_scheduler.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
@@ -69,6 +75,33 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * With the event driven pacing the encoder runs when the link asks for data,
+ * as long as the audio HAL keeps up, and the media timer only acts as a
+ * watchdog running at a multiple of the encoder interval.
+ */
+#define A2DP_SOURCE_EVENT_PACING_PROPERTY \
+  "persist.bluetooth.a2dp_source.event_pacing.enabled"
+#define A2DP_SOURCE_WATCHDOG_INTERVALS 2
+
+/**
+ * A codec change is timed from the request until the first packet encoded with
+ * the new codec. Longer gaps are not counted, streaming having been resumed
+ * for another reason than the switch.
+ */
+#define A2DP_SOURCE_CODEC_SWITCH_MAX_GAP_US (10 * 1000 * 1000)
+
+/**
+ * Scheduling of the thread running the encoder. A priority of 0 keeps the
+ * default SCHED_FIFO priority, and a CPU mask of 0 leaves the placement of the
+ * thread to the kernel, which lets a heavy codec be kept away from the cores
+ * already busy with the other audio threads.
+ */
+#define A2DP_SOURCE_RT_PRIORITY_PROPERTY \
+  "persist.bluetooth.a2dp_source.rt_priority"
+#define A2DP_SOURCE_CPU_AFFINITY_PROPERTY \
+  "persist.bluetooth.a2dp_source.cpu_affinity"
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -139,6 +172,16 @@ class BtifMediaStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    media_read_total_fill_level_bytes = 0;
+    media_read_max_fill_level_bytes = 0;
+    media_read_fill_level_count = 0;
+    media_timer_total_wakeups = 0;
+    media_timer_total_skipped_wakeups = 0;
+    link_credit_total_sends = 0;
+    codec_switch_count = 0;
+    codec_switch_total_gap_us = 0;
+    codec_switch_max_gap_us = 0;
+    codec_switch_last_gap_us = 0;
     codec_index = -1;
   }
 
@@ -169,6 +212,22 @@ class BtifMediaStats {
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  // Audio data waiting in the audio HAL when the encoder runs
+  uint64_t media_read_total_fill_level_bytes;
+  size_t media_read_max_fill_level_bytes;
+  size_t media_read_fill_level_count;
+
+  size_t media_timer_total_wakeups;
+  size_t media_timer_total_skipped_wakeups;
+  size_t link_credit_total_sends;
+
+  // Silence between a codec change request and the first packet encoded
+  // with the new codec
+  size_t codec_switch_count;
+  uint64_t codec_switch_total_gap_us;
+  uint64_t codec_switch_max_gap_us;
+  uint64_t codec_switch_last_gap_us;
+
   int codec_index = -1;
 };
 
@@ -187,6 +246,11 @@ class BtifA2dpSource {
         sw_audio_is_encoding(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
+        event_pacing(false),
+        audio_starved(false),
+        paced_send_pending(false),
+        last_send_us(0),
+        codec_switch_start_us(0),
         state_(kStateOff) {}
 
   void Reset() {
@@ -197,6 +261,11 @@ class BtifA2dpSource {
     wakelock_release();
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
+    event_pacing = false;
+    audio_starved = false;
+    paced_send_pending = false;
+    last_send_us = 0;
+    codec_switch_start_us = 0;
     stats.Reset();
     accumulated_stats.Reset();
     state_ = kStateOff;
@@ -224,6 +293,11 @@ class BtifA2dpSource {
   RepeatingTimer media_alarm;
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
+  bool event_pacing;  /* The link credits run the encoder, not the timer */
+  bool audio_starved; /* The last read from the audio HAL underflowed */
+  std::atomic<bool> paced_send_pending; /* A link credit is being handled */
+  uint64_t last_send_us; /* Audio server tick of the last encoder run */
+  uint64_t codec_switch_start_us; /* Pending codec change, 0 if none */
   BtifMediaStats stats;
   BtifMediaStats accumulated_stats;
 
@@ -265,9 +339,15 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static void btif_a2dp_source_audio_handle_link_credit(void);
+static void btif_a2dp_source_audio_send(uint64_t timestamp_us);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
+static uint32_t btif_a2dp_source_peek_callback(const uint8_t** p_buf,
+                                               uint32_t len);
+static void btif_a2dp_source_consume_callback(uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
+static void btif_a2dp_source_record_codec_switch_gap(uint64_t now_us);
 static void log_tstamps_us(const char* comment, uint64_t timestamp_us);
 static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
                                     uint64_t expected_delta);
@@ -320,6 +400,23 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
   dst->media_read_total_underflow_count +=
       src->media_read_total_underflow_count;
   dst->media_read_last_underflow_us = src->media_read_last_underflow_us;
+  dst->media_read_total_fill_level_bytes +=
+      src->media_read_total_fill_level_bytes;
+  dst->media_read_max_fill_level_bytes =
+      std::max(dst->media_read_max_fill_level_bytes,
+               src->media_read_max_fill_level_bytes);
+  dst->media_read_fill_level_count += src->media_read_fill_level_count;
+  dst->media_timer_total_wakeups += src->media_timer_total_wakeups;
+  dst->media_timer_total_skipped_wakeups +=
+      src->media_timer_total_skipped_wakeups;
+  dst->link_credit_total_sends += src->link_credit_total_sends;
+  dst->codec_switch_count += src->codec_switch_count;
+  dst->codec_switch_total_gap_us += src->codec_switch_total_gap_us;
+  dst->codec_switch_max_gap_us =
+      std::max(dst->codec_switch_max_gap_us, src->codec_switch_max_gap_us);
+  if (src->codec_switch_count > 0) {
+    dst->codec_switch_last_gap_us = src->codec_switch_last_gap_us;
+  }
   if (dst->codec_index < 0) dst->codec_index = src->codec_index;
   btif_a2dp_source_accumulate_scheduling_stats(&src->tx_queue_enqueue_stats,
                                                &dst->tx_queue_enqueue_stats);
@@ -360,6 +457,8 @@ bool btif_a2dp_source_startup(void) {
   btif_a2dp_source_cb.Reset();
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateStartingUp);
   btif_a2dp_source_cb.tx_audio_queue = fixed_queue_new(SIZE_MAX);
+  fixed_queue_set_buffer_owner(btif_a2dp_source_cb.tx_audio_queue,
+                               BUFFER_OWNER_A2DP_TX);
 
   // Schedule the rest of the operations
   btif_a2dp_source_thread.DoInThread(
@@ -368,9 +467,42 @@ bool btif_a2dp_source_startup(void) {
   return true;
 }
 
+// Runs on the source thread, the thread id 0 given to the scheduler stands for
+// the calling thread.
+static bool btif_a2dp_source_configure_scheduling() {
+  bool real_time_enabled;
+  int priority = osi_property_get_int32(A2DP_SOURCE_RT_PRIORITY_PROPERTY, 0);
+  if (priority <= 0) {
+    real_time_enabled = btif_a2dp_source_thread.EnableRealTimeScheduling();
+  } else {
+    int min_priority, max_priority;
+    if (thread_scheduler_get_priority_range(min_priority, max_priority)) {
+      priority = std::clamp(priority, min_priority, max_priority);
+    }
+    real_time_enabled =
+        thread_scheduler_enable_real_time_priority(0, priority);
+    if (!real_time_enabled) {
+      log::error("unable to set SCHED_FIFO priority {}: {}", priority,
+                 strerror(errno));
+    }
+  }
+
+  uint32_t cpu_mask = static_cast<uint32_t>(
+      osi_property_get_int32(A2DP_SOURCE_CPU_AFFINITY_PROPERTY, 0));
+  if (cpu_mask != 0) {
+    if (thread_scheduler_set_cpu_affinity(0, cpu_mask)) {
+      log::info("encoder thread bound to the CPU mask 0x{:x}", cpu_mask);
+    } else {
+      log::warn("unable to bind the encoder thread to the CPU mask 0x{:x}: {}",
+                cpu_mask, strerror(errno));
+    }
+  }
+  return real_time_enabled;
+}
+
 static void btif_a2dp_source_startup_delayed() {
   log::info("state={}", btif_a2dp_source_cb.StateStr());
-  if (!btif_a2dp_source_thread.EnableRealTimeScheduling()) {
+  if (!btif_a2dp_source_configure_scheduling()) {
 #if defined(__ANDROID__)
     log::fatal("unable to enable real time scheduling");
 #endif
@@ -603,6 +735,11 @@ static void btif_a2dp_source_setup_codec_delayed(
   btif_a2dp_source_cb.encoder_interface->encoder_init(
       &peer_params, a2dp_codec_config, btif_a2dp_source_read_callback,
       btif_a2dp_source_enqueue_callback);
+  if (btif_a2dp_source_cb.encoder_interface->set_in_place_read_callbacks !=
+      nullptr) {
+    btif_a2dp_source_cb.encoder_interface->set_in_place_read_callbacks(
+        btif_a2dp_source_peek_callback, btif_a2dp_source_consume_callback);
+  }
 
   // Save a local copy of the encoder_interval_ms
   btif_a2dp_source_cb.encoder_interval_ms =
@@ -677,6 +814,12 @@ static void btif_a2dp_source_encoder_user_config_update_event(
       break;
     }
   }
+  if (success && btif_a2dp_source_is_streaming()) {
+    // The gap is measured up to the first packet of the new codec, see
+    // btif_a2dp_source_record_codec_switch_gap()
+    btif_a2dp_source_cb.codec_switch_start_us =
+        bluetooth::common::time_get_os_boottime_us();
+  }
   if (success && restart_output) {
     // Codec reconfiguration is in progress, and it is safe to unlock since
     // remaining tasks like starting audio session and reporting new codec
@@ -807,9 +950,18 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
       "assert failed: btif_a2dp_source_cb.encoder_interface != nullptr");
   btif_a2dp_source_cb.encoder_interface->feeding_reset();
 
-  log::verbose(
-      "starting timer {} ms",
-      btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms());
+  btif_a2dp_source_cb.event_pacing =
+      osi_property_get_bool(A2DP_SOURCE_EVENT_PACING_PROPERTY, false);
+  btif_a2dp_source_cb.audio_starved = false;
+  btif_a2dp_source_cb.last_send_us = 0;
+
+  uint64_t timer_interval_ms =
+      btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms();
+  if (btif_a2dp_source_cb.event_pacing) {
+    timer_interval_ms *= A2DP_SOURCE_WATCHDOG_INTERVALS;
+  }
+  log::verbose("starting timer {} ms event_pacing={}", timer_interval_ms,
+               btif_a2dp_source_cb.event_pacing);
 
   /* audio engine starting, reset tx suspended flag */
   btif_a2dp_source_cb.tx_flush = false;
@@ -818,8 +970,7 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
   btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
       btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
       base::BindRepeating(&btif_a2dp_source_audio_handle_timer),
-      std::chrono::milliseconds(
-          btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+      std::chrono::milliseconds(timer_interval_ms));
   btif_a2dp_source_cb.sw_audio_is_encoding = true;
 
   btif_a2dp_source_cb.stats.Reset();
@@ -897,9 +1048,9 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
 static void btif_a2dp_source_audio_handle_timer(void) {
   if (btif_av_is_a2dp_offload_running()) return;
+  BT_PROFILE_SCOPE(A2DP_SOURCE_TICK);
 
   uint64_t timestamp_us = bluetooth::common::time_get_audio_server_tick_us();
-  uint64_t stats_timestamp_us = bluetooth::common::time_get_os_boottime_us();
 
   log_tstamps_us("A2DP Source tx scheduling timer", timestamp_us);
 
@@ -907,6 +1058,66 @@ static void btif_a2dp_source_audio_handle_timer(void) {
     log::error("ERROR Media task Scheduled after Suspend");
     return;
   }
+
+  btif_a2dp_source_cb.stats.media_timer_total_wakeups++;
+  // As a watchdog the timer only runs the encoder when the link credits did
+  // not during the last encoder interval. It keeps polling a starved audio HAL.
+  if (btif_a2dp_source_cb.event_pacing &&
+      timestamp_us - btif_a2dp_source_cb.last_send_us <
+          btif_a2dp_source_cb.encoder_interval_ms * 1000) {
+    btif_a2dp_source_cb.stats.media_timer_total_skipped_wakeups++;
+    return;
+  }
+
+  btif_a2dp_source_audio_send(timestamp_us);
+}
+
+// Time to wait between two encoder runs with the event driven pacing. The more
+// packets wait for the link, the later the encoder runs so that each run covers
+// more audio frames and the queue does not grow.
+static uint64_t btif_a2dp_source_pacing_interval_us(void) {
+  uint64_t intervals =
+      std::min<uint64_t>(
+          fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue),
+          A2DP_SOURCE_WATCHDOG_INTERVALS - 1) +
+      1;
+  return intervals * btif_a2dp_source_cb.encoder_interval_ms * 1000;
+}
+
+static void btif_a2dp_source_audio_handle_link_credit(void) {
+  btif_a2dp_source_cb.paced_send_pending = false;
+
+  if (btif_av_is_a2dp_offload_running()) return;
+  if (!btif_a2dp_source_cb.event_pacing || !btif_a2dp_source_is_streaming()) {
+    return;
+  }
+  // Leave it to the watchdog until the audio HAL has data again
+  if (btif_a2dp_source_cb.audio_starved) return;
+
+  uint64_t timestamp_us = bluetooth::common::time_get_audio_server_tick_us();
+  uint64_t elapsed_us = timestamp_us - btif_a2dp_source_cb.last_send_us;
+  uint64_t interval_us = btif_a2dp_source_pacing_interval_us();
+  if (elapsed_us < interval_us) {
+    btif_a2dp_source_cb.paced_send_pending = true;
+    if (!btif_a2dp_source_thread.DoInThreadDelayed(
+            FROM_HERE,
+            base::BindOnce(&btif_a2dp_source_audio_handle_link_credit),
+            std::chrono::microseconds(interval_us - elapsed_us))) {
+      btif_a2dp_source_cb.paced_send_pending = false;
+    }
+    return;
+  }
+
+  log_tstamps_us("A2DP Source tx scheduling link credit", timestamp_us);
+  btif_a2dp_source_cb.stats.link_credit_total_sends++;
+  btif_a2dp_source_audio_send(timestamp_us);
+}
+
+// Run the encoder for the audio received since the previous run, and let BTA
+// send the resulting packets.
+static void btif_a2dp_source_audio_send(uint64_t timestamp_us) {
+  uint64_t stats_timestamp_us = bluetooth::common::time_get_os_boottime_us();
+
   log::assert_that(
       btif_a2dp_source_cb.encoder_interface != nullptr,
       "assert failed: btif_a2dp_source_cb.encoder_interface != nullptr");
@@ -920,6 +1131,17 @@ static void btif_a2dp_source_audio_handle_timer(void) {
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
         transmit_queue_length);
   }
+  if (bluetooth::audio::a2dp::is_hal_enabled()) {
+    size_t fill_level = bluetooth::audio::a2dp::available_to_read();
+#ifdef __ANDROID__
+    ATRACE_INT("btif audio HAL fill level", fill_level);
+#endif
+    btif_a2dp_source_cb.stats.media_read_total_fill_level_bytes += fill_level;
+    btif_a2dp_source_cb.stats.media_read_max_fill_level_bytes = std::max(
+        btif_a2dp_source_cb.stats.media_read_max_fill_level_bytes, fill_level);
+    btif_a2dp_source_cb.stats.media_read_fill_level_count++;
+  }
+  btif_a2dp_source_cb.last_send_us = timestamp_us;
   btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
   bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
   update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
@@ -936,6 +1158,7 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
     bytes_read = UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, p_buf, len);
   }
 
+  btif_a2dp_source_cb.audio_starved = bytes_read < len;
   if (btif_a2dp_source_cb.sw_audio_is_encoding && bytes_read < len) {
     log::warn("UNDERFLOW: ONLY READ {} BYTES OUT OF {}", bytes_read, len);
     btif_a2dp_source_cb.stats.media_read_total_underflow_bytes +=
@@ -951,6 +1174,19 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
   return bytes_read;
 }
 
+static uint32_t btif_a2dp_source_peek_callback(const uint8_t** p_buf,
+                                               uint32_t len) {
+  // The data of the UIPC channel can only be copied
+  if (!bluetooth::audio::a2dp::is_hal_enabled()) return 0;
+
+  return bluetooth::audio::a2dp::peek(p_buf, len);
+}
+
+static void btif_a2dp_source_consume_callback(uint32_t len) {
+  bluetooth::audio::a2dp::consume(len);
+  btif_a2dp_source_cb.audio_starved = false;
+}
+
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read) {
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
@@ -975,10 +1211,13 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
     return false;
   }
 
-  // Check for TX queue overflow
+  // Check for TX queue overflow, or for queued audio while the A2DP buffers
+  // are over budget
   // TODO: Using frames_n here is probably wrong: should be "+ 1" instead.
   if (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue) + frames_n >
-      btif_a2dp_source_dynamic_audio_buffer_size) {
+          btif_a2dp_source_dynamic_audio_buffer_size ||
+      (!fixed_queue_is_empty(btif_a2dp_source_cb.tx_audio_queue) &&
+       buffer_budget_is_exceeded(BUFFER_OWNER_A2DP_TX))) {
     log::warn("TX queue buffer size now={} adding={} max={}",
               (uint32_t)fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue),
               (uint32_t)frames_n, btif_a2dp_source_dynamic_audio_buffer_size);
@@ -1036,6 +1275,7 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
   }
 
   /* Update the statistics */
+  btif_a2dp_source_record_codec_switch_gap(now_us);
   btif_a2dp_source_cb.stats.tx_queue_total_frames += frames_n;
   btif_a2dp_source_cb.stats.tx_queue_max_frames_per_packet = std::max(
       frames_n, btif_a2dp_source_cb.stats.tx_queue_max_frames_per_packet);
@@ -1048,6 +1288,23 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
   return true;
 }
 
+static void btif_a2dp_source_record_codec_switch_gap(uint64_t now_us) {
+  if (btif_a2dp_source_cb.codec_switch_start_us == 0) return;
+
+  uint64_t gap_us = now_us - btif_a2dp_source_cb.codec_switch_start_us;
+  btif_a2dp_source_cb.codec_switch_start_us = 0;
+  // Streaming resumed long after the switch: the silence was not the switch
+  if (gap_us > A2DP_SOURCE_CODEC_SWITCH_MAX_GAP_US) return;
+
+  log::info("codec switch gap {} ms", gap_us / 1000);
+  BtifMediaStats& stats = btif_a2dp_source_cb.stats;
+  stats.codec_switch_count++;
+  stats.codec_switch_total_gap_us += gap_us;
+  stats.codec_switch_max_gap_us =
+      std::max(gap_us, stats.codec_switch_max_gap_us);
+  stats.codec_switch_last_gap_us = gap_us;
+}
+
 static void btif_a2dp_source_audio_tx_flush_event(void) {
   /* Flush all enqueued audio buffers (encoded) */
   log::info("state={}", btif_a2dp_source_cb.StateStr());
@@ -1089,6 +1346,16 @@ BT_HDR* btif_a2dp_source_audio_readbuf(void) {
                             btif_a2dp_source_cb.encoder_interval_ms * 1000);
   }
 
+  // BTA reads the queue whenever the link can take more data
+  if (btif_a2dp_source_cb.event_pacing &&
+      !btif_a2dp_source_cb.paced_send_pending.exchange(true)) {
+    if (!btif_a2dp_source_thread.DoInThread(
+            FROM_HERE,
+            base::BindOnce(&btif_a2dp_source_audio_handle_link_credit))) {
+      btif_a2dp_source_cb.paced_send_pending = false;
+    }
+  }
+
   return p_buf;
 }
 
@@ -1227,6 +1494,39 @@ void btif_a2dp_source_debug_dump(int fd) {
                     1000
               : 0);
 
+  ave_size = 0;
+  if (accumulated_stats->media_read_fill_level_count != 0)
+    ave_size = accumulated_stats->media_read_total_fill_level_bytes /
+               accumulated_stats->media_read_fill_level_count;
+  dprintf(fd,
+          "  Audio HAL fill level in bytes (max/ave)                 : %zu / "
+          "%zu\n",
+          accumulated_stats->media_read_max_fill_level_bytes, ave_size);
+
+  dprintf(fd,
+          "  Media timer wakeups (total/skipped)                     : %zu / "
+          "%zu\n",
+          accumulated_stats->media_timer_total_wakeups,
+          accumulated_stats->media_timer_total_skipped_wakeups);
+
+  dprintf(fd,
+          "  Counts (link credit encoder runs)                       : %zu\n",
+          accumulated_stats->link_credit_total_sends);
+
+  ave_time_us = 0;
+  if (accumulated_stats->codec_switch_count != 0)
+    ave_time_us = accumulated_stats->codec_switch_total_gap_us /
+                  accumulated_stats->codec_switch_count;
+  dprintf(fd,
+          "  Codec switches (count)                                  : %zu\n",
+          accumulated_stats->codec_switch_count);
+  dprintf(fd,
+          "  Codec switch gap in ms (last/max/ave)                   : %llu / "
+          "%llu / %llu\n",
+          (unsigned long long)accumulated_stats->codec_switch_last_gap_us / 1000,
+          (unsigned long long)accumulated_stats->codec_switch_max_gap_us / 1000,
+          (unsigned long long)ave_time_us / 1000);
+
   //
   // TxQueue enqueue stats
   //
@@ -48,6 +48,7 @@
 #include "btif/include/btif_util.h"
 #include "btif/include/stack_manager_t.h"
 #include "btif_metrics_logging.h"
+#include "common/flat_map.h"
 #include "common/state_machine.h"
 #include "device/include/device_iot_config.h"
 #include "hardware/bt_av.h"
@@ -595,7 +596,9 @@ class BtifAvSource {
         peer_address, codec_preferences, std::move(peer_ready_promise));
   }
 
-  const std::map<RawAddress, BtifAvPeer*>& Peers() const { return peers_; }
+  const common::FlatMap<RawAddress, BtifAvPeer*>& Peers() const {
+    return peers_;
+  }
 
   void RegisterAllBtaHandles();
   void DeregisterAllBtaHandles();
@@ -611,7 +614,7 @@ class BtifAvSource {
   bool a2dp_offload_enabled_;
   bool invalid_peer_check_;  // pending to check at BTA_AV_OPEN_EVT
   int max_connected_peers_;
-  std::map<RawAddress, BtifAvPeer*> peers_;
+  common::FlatMap<RawAddress, BtifAvPeer*> peers_;
   std::set<RawAddress> silenced_peers_;
   RawAddress active_peer_;
   std::map<uint8_t, tBTA_AV_HNDL> peer_id2bta_handle_;
@@ -752,7 +755,9 @@ class BtifAvSink {
     active_peer_ = RawAddress::kEmpty;
   }
 
-  const std::map<RawAddress, BtifAvPeer*>& Peers() const { return peers_; }
+  const common::FlatMap<RawAddress, BtifAvPeer*>& Peers() const {
+    return peers_;
+  }
 
   void RegisterAllBtaHandles();
   void DeregisterAllBtaHandles();
@@ -767,7 +772,7 @@ class BtifAvSink {
   bool enabled_;
   bool invalid_peer_check_;  // pending to check at BTA_AV_OPEN_EVT
   int max_connected_peers_;
-  std::map<RawAddress, BtifAvPeer*> peers_;
+  common::FlatMap<RawAddress, BtifAvPeer*> peers_;
   RawAddress active_peer_;
   std::map<uint8_t, tBTA_AV_HNDL> peer_id2bta_handle_;
 };
@@ -1361,12 +1366,14 @@ bool BtifAvSource::AllowedToConnect(const RawAddress& peer_address) const {
 void BtifAvSource::DeleteIdlePeers() {
   for (auto it = peers_.begin(); it != peers_.end();) {
     BtifAvPeer* peer = it->second;
-    auto prev_it = it++;
-    if (!peer->CanBeDeleted()) continue;
+    if (!peer->CanBeDeleted()) {
+      ++it;
+      continue;
+    }
     log::info("peer={} bta_handle=0x{:x}", peer->PeerAddress(),
               peer->BtaHandle());
     peer->Cleanup();
-    peers_.erase(prev_it);
+    it = peers_.erase(it);
     delete peer;
   }
 }
@@ -1619,12 +1626,14 @@ bool BtifAvSink::AllowedToConnect(const RawAddress& peer_address) const {
 void BtifAvSink::DeleteIdlePeers() {
   for (auto it = peers_.begin(); it != peers_.end();) {
     BtifAvPeer* peer = it->second;
-    auto prev_it = it++;
-    if (!peer->CanBeDeleted()) continue;
+    if (!peer->CanBeDeleted()) {
+      ++it;
+      continue;
+    }
     log::info("Deleting idle peer: {} bta_handle=0x{:x}", peer->PeerAddress(),
               peer->BtaHandle());
     peer->Cleanup();
-    peers_.erase(prev_it);
+    it = peers_.erase(it);
     delete peer;
   }
 }
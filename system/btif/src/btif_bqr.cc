@@ -21,8 +21,10 @@
 #endif
 #include <sys/stat.h>
 
+#include <array>
 #include <cerrno>
 #include <cstdint>
+#include <mutex>
 
 #include "btif/include/stack_manager_t.h"
 #include "btif_bqr.h"
@@ -60,8 +62,133 @@ std::unique_ptr<BluetoothQualityReportInterface> bluetoothQualityReportInstance;
 
 namespace {
 common::PostableContext* to_bind_ = nullptr;
+
+// Rolling aggregates of the link quality reports of one link. The averages
+// are kept multiplied by kBqrAggregateWeight so that the updates keep their
+// fractional part.
+struct LinkQualityAggregator {
+  bool in_use;
+  uint64_t last_report_ms;
+  uint16_t connection_handle;
+  uint32_t report_count;
+  int32_t rssi;
+  uint64_t retransmission_count;
+  uint64_t lost_packets;
+  uint64_t buffer_overflow_bytes;
+  uint8_t warnings;
+};
+
+// The aggregates are updated on the main thread and read by the policies from
+// their own threads.
+std::mutex link_quality_mutex;
+std::array<LinkQualityAggregator, kBqrAggregatedLinks> link_quality_aggregators;
+
+template <typename T>
+void UpdateAverage(T* average, T sample, bool first_report) {
+  *average = first_report ? sample * kBqrAggregateWeight
+                          : *average + sample - *average / kBqrAggregateWeight;
+}
+
+BqrLinkQualityAggregate ToAggregate(const LinkQualityAggregator& aggregator) {
+  return {
+      .connection_handle = aggregator.connection_handle,
+      .report_count = aggregator.report_count,
+      .rssi = static_cast<int8_t>(aggregator.rssi / kBqrAggregateWeight),
+      .retransmission_count = static_cast<uint32_t>(
+          aggregator.retransmission_count / kBqrAggregateWeight),
+      .lost_packets =
+          static_cast<uint32_t>(aggregator.lost_packets / kBqrAggregateWeight),
+      .buffer_overflow_bytes = static_cast<uint32_t>(
+          aggregator.buffer_overflow_bytes / kBqrAggregateWeight),
+      .warnings = aggregator.warnings,
+  };
+}
+
+uint8_t ComputeWarnings(const BqrLinkQualityAggregate& aggregate) {
+  uint8_t warnings = 0;
+  if (aggregate.rssi < kCriWarnRssi) warnings |= kLinkQualityWarningRssi;
+  if (aggregate.retransmission_count > kCriWarnRetransmissions) {
+    warnings |= kLinkQualityWarningRetransmissions;
+  }
+  if (aggregate.lost_packets > kCriWarnLostPackets) {
+    warnings |= kLinkQualityWarningLostPackets;
+  }
+  if (aggregate.buffer_overflow_bytes > 0) {
+    warnings |= kLinkQualityWarningBufferOverflow;
+  }
+  return warnings;
 }
 
+// Returns the aggregator of |connection_handle|, reset if it is a new link,
+// from the slot of an expired link or else of the link reported the longest
+// time ago.
+LinkQualityAggregator& FindAggregator(uint16_t connection_handle,
+                                      uint64_t now_ms) {
+  LinkQualityAggregator* oldest = &link_quality_aggregators[0];
+  for (LinkQualityAggregator& aggregator : link_quality_aggregators) {
+    if (aggregator.in_use &&
+        now_ms - aggregator.last_report_ms >= kBqrAggregateExpiryMs) {
+      aggregator.in_use = false;
+    }
+    if (aggregator.in_use &&
+        aggregator.connection_handle == connection_handle) {
+      return aggregator;
+    }
+    if (!oldest->in_use) continue;
+    if (!aggregator.in_use ||
+        aggregator.last_report_ms < oldest->last_report_ms) {
+      oldest = &aggregator;
+    }
+  }
+  *oldest = {};
+  oldest->in_use = true;
+  oldest->connection_handle = connection_handle;
+  return *oldest;
+}
+
+// Adds a Link Quality related BQR event to the aggregates of its link, and
+// logs when the link crosses the warning criteria instead of on every event.
+void AggregateLinkQualityEvent(const BqrLinkQualityEvent& event) {
+  BqrLinkQualityAggregate aggregate;
+  uint8_t previous_warnings;
+  {
+    std::lock_guard<std::mutex> lock(link_quality_mutex);
+    uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+    LinkQualityAggregator& aggregator =
+        FindAggregator(event.connection_handle, now_ms);
+    bool first_report = aggregator.report_count == 0;
+    aggregator.last_report_ms = now_ms;
+    aggregator.report_count++;
+    UpdateAverage<int32_t>(&aggregator.rssi, event.rssi, first_report);
+    UpdateAverage<uint64_t>(&aggregator.retransmission_count,
+                            event.retransmission_count, first_report);
+    UpdateAverage<uint64_t>(
+        &aggregator.lost_packets,
+        uint64_t{event.no_rx_count} + event.tx_flushed_packets, first_report);
+    UpdateAverage<uint64_t>(&aggregator.buffer_overflow_bytes,
+                            event.buffer_overflow_bytes, first_report);
+    previous_warnings = aggregator.warnings;
+    aggregate = ToAggregate(aggregator);
+    aggregator.warnings = aggregate.warnings = ComputeWarnings(aggregate);
+  }
+
+  if (aggregate.warnings == previous_warnings) return;
+  if (aggregate.warnings & ~previous_warnings) {
+    log::warn(
+        "Handle: 0x{:04x} link quality warnings 0x{:02x} -> 0x{:02x}, RSSI: "
+        "{}, ReTx: {}, Lost: {}, OverFlow: {}",
+        aggregate.connection_handle, previous_warnings, aggregate.warnings,
+        aggregate.rssi, aggregate.retransmission_count, aggregate.lost_packets,
+        aggregate.buffer_overflow_bytes);
+  } else {
+    log::info("Handle: 0x{:04x} link quality warnings 0x{:02x} -> 0x{:02x}",
+              aggregate.connection_handle, previous_warnings,
+              aggregate.warnings);
+  }
+}
+
+}  // namespace
+
 void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length,
                                           const uint8_t* p_param_buf) {
   if (length < kLinkQualityParamTotalLen) {
@@ -658,6 +785,7 @@ static void AddLinkQualityEventToQueue(uint8_t length,
   RawAddress bd_addr;
 
   p_bqr_event->ParseBqrLinkQualityEvt(length, p_link_quality_event);
+  AggregateLinkQualityEvent(p_bqr_event->bqr_link_quality_event_);
 
   GetInterfaceToProfiles()->events->invoke_link_quality_report_cb(
       bluetooth::common::time_get_os_boottime_ms(),
@@ -813,12 +941,45 @@ static int OpenBtSchedulingTraceLogFile() {
   return logfile_fd;
 }
 
+bool GetLinkQualityAggregate(uint16_t connection_handle,
+                             BqrLinkQualityAggregate* aggregate) {
+  std::lock_guard<std::mutex> lock(link_quality_mutex);
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  for (const LinkQualityAggregator& aggregator : link_quality_aggregators) {
+    if (aggregator.in_use &&
+        aggregator.connection_handle == connection_handle &&
+        now_ms - aggregator.last_report_ms < kBqrAggregateExpiryMs) {
+      *aggregate = ToAggregate(aggregator);
+      return true;
+    }
+  }
+  return false;
+}
+
+static void DumpLinkQualityAggregates(int fd) {
+  std::lock_guard<std::mutex> lock(link_quality_mutex);
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  for (const LinkQualityAggregator& aggregator : link_quality_aggregators) {
+    if (!aggregator.in_use ||
+        now_ms - aggregator.last_report_ms >= kBqrAggregateExpiryMs) {
+      continue;
+    }
+    BqrLinkQualityAggregate aggregate = ToAggregate(aggregator);
+    dprintf(fd,
+            "  Handle: 0x%04x, Reports: %u, RSSI: %d, ReTx: %u, Lost: %u, "
+            "OverFlow: %u, Warnings: 0x%02x\n",
+            aggregate.connection_handle, aggregate.report_count,
+            aggregate.rssi, aggregate.retransmission_count,
+            aggregate.lost_packets, aggregate.buffer_overflow_bytes,
+            aggregate.warnings);
+  }
+}
+
 void DebugDump(int fd) {
   dprintf(fd, "\nBT Quality Report Events: \n");
 
   if (kpBqrEventQueue.Empty()) {
     dprintf(fd, "Event queue is empty.\n");
-    return;
   }
 
   while (!kpBqrEventQueue.Empty()) {
@@ -835,6 +996,8 @@ void DebugDump(int fd) {
             p_event->ToString().c_str());
   }
 
+  dprintf(fd, "\nBT Quality Report Link Aggregates: \n");
+  DumpLinkQualityAggregates(fd);
   dprintf(fd, "\n");
 }
 
@@ -972,7 +1135,9 @@ static void vendor_specific_event_callback(
       break;
 
     default:
-      log::info("Unhandled BQR subevent 0x{:02x}", quality_report_id);
+      // The link quality reports may come several times per second, and
+      // CategorizeBqrEvent() warns about the unknown ones.
+      break;
   }
 
   CategorizeBqrEvent(bytes.size(), bytes.data());
@@ -24,12 +24,16 @@
 #include <openssl/rand.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "btif_keystore.h"
 #include "btif_metrics_logging.h"
@@ -38,6 +42,7 @@
 #include "main/shim/config.h"
 #include "main/shim/shim.h"
 #include "os/log.h"
+#include "osi/include/properties.h"
 #include "raw_address.h"
 #include "storage/config_keys.h"
 
@@ -152,6 +157,174 @@ static void init_metric_id_allocator() {
 
 static std::recursive_mutex config_lock;  // protects operations on |config|.
 
+namespace {
+/* Keys that make a section persistent. Sections holding one of them are
+ * never evicted by the config, so cached values for them stay valid until
+ * they are changed through this file. */
+const std::unordered_set<std::string> kBondKeys = {
+    BTIF_STORAGE_KEY_LINK_KEY,     BTIF_STORAGE_KEY_LE_KEY_PENC,
+    BTIF_STORAGE_KEY_LE_KEY_PID,   BTIF_STORAGE_KEY_LE_KEY_LID,
+    BTIF_STORAGE_KEY_LE_KEY_PCSRK, BTIF_STORAGE_KEY_LE_KEY_LENC,
+    BTIF_STORAGE_KEY_LE_KEY_LCSRK,
+};
+
+/* Binary and integer properties looked up while connecting to a bonded
+ * device, in addition to kBondKeys */
+const std::unordered_set<std::string> kCachedBinKeys = {
+    BTIF_STORAGE_KEY_GATT_CLIENT_DB_HASH,
+};
+const std::unordered_set<std::string> kCachedIntKeys = {
+    BTIF_STORAGE_KEY_LINK_KEY_TYPE,
+    BTIF_STORAGE_KEY_ADDR_TYPE,
+    BTIF_STORAGE_KEY_GATT_CLIENT_SUPPORTED,
+    BTIF_STORAGE_KEY_GATT_SERVER_SUPPORTED,
+};
+
+/* Decoded properties of one bonded device. A missing value records that the
+ * property is not stored. */
+struct BondedDeviceProperties {
+  std::unordered_map<std::string, std::optional<std::vector<uint8_t>>> bin;
+  std::unordered_map<std::string, std::optional<int>> ints;
+};
+
+/* Typed cache in front of the string config for bonded devices, so lookups
+ * on the connection path neither parse hex strings nor take the storage
+ * lock. It is filled per device on first lookup and updated by every write
+ * that goes through btif_config. */
+class BondedDeviceCache {
+ public:
+  void Init() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = osi_property_get_bool(
+        "bluetooth.btif.config.bonded_device_cache.enabled", true);
+    devices_.clear();
+    not_bonded_.clear();
+  }
+
+  /* Returns nullopt when the device is not cached and storage must be read,
+   * otherwise the cached value, which is empty if the property is absent */
+  std::optional<std::optional<std::vector<uint8_t>>> GetBin(
+      const std::string& section, const std::string& key) {
+    if (kBondKeys.count(key) == 0 && kCachedBinKeys.count(key) == 0) {
+      return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const BondedDeviceProperties* device = Load(section);
+    if (device == nullptr) return std::nullopt;
+    return device->bin.at(key);
+  }
+
+  std::optional<std::optional<int>> GetInt(const std::string& section,
+                                           const std::string& key) {
+    if (kCachedIntKeys.count(key) == 0) return std::nullopt;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const BondedDeviceProperties* device = Load(section);
+    if (device == nullptr) return std::nullopt;
+    return device->ints.at(key);
+  }
+
+  void OnSetBin(const std::string& section, const std::string& key,
+                const uint8_t* value, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (kBondKeys.count(key) != 0) not_bonded_.erase(section);
+    auto it = devices_.find(section);
+    if (it == devices_.end()) return;
+    if (it->second.bin.count(key) != 0) {
+      it->second.bin[key] = std::vector<uint8_t>(value, value + length);
+    } else {
+      Invalidate(section, key);
+    }
+  }
+
+  void OnSetInt(const std::string& section, const std::string& key,
+                int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = devices_.find(section);
+    if (it == devices_.end()) return;
+    if (it->second.ints.count(key) != 0) {
+      it->second.ints[key] = value;
+    } else {
+      Invalidate(section, key);
+    }
+  }
+
+  /* Any other write, or a removal, of |key| in |section| */
+  void OnChange(const std::string& section, const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Invalidate(section, key);
+  }
+
+  void OnRemoveSection(const std::string& section) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_.erase(section);
+    not_bonded_.erase(section);
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_.clear();
+    not_bonded_.clear();
+  }
+
+ private:
+  void Invalidate(const std::string& section, const std::string& key) {
+    if (kBondKeys.count(key) != 0) {
+      /* The section may no longer be persistent */
+      devices_.erase(section);
+      not_bonded_.erase(section);
+      return;
+    }
+    auto it = devices_.find(section);
+    if (it == devices_.end()) return;
+    if (it->second.bin.count(key) != 0 || it->second.ints.count(key) != 0) {
+      devices_.erase(it);
+    }
+  }
+
+  const BondedDeviceProperties* Load(const std::string& section) {
+    if (!enabled_) return nullptr;
+    auto it = devices_.find(section);
+    if (it != devices_.end()) return &it->second;
+    if (not_bonded_.count(section) != 0) return nullptr;
+
+    BondedDeviceProperties device;
+    bool bonded = false;
+    for (const auto& key : kBondKeys) {
+      auto value = bluetooth::shim::BtifConfigInterface::GetBin(section, key);
+      bonded |= value.has_value();
+      device.bin[key] = std::move(value);
+    }
+    if (!bonded) {
+      if (not_bonded_.size() >= TEMPORARY_SECTION_CAPACITY) {
+        not_bonded_.clear();
+      }
+      not_bonded_.insert(section);
+      return nullptr;
+    }
+    for (const auto& key : kCachedBinKeys) {
+      device.bin[key] =
+          bluetooth::shim::BtifConfigInterface::GetBin(section, key);
+    }
+    for (const auto& key : kCachedIntKeys) {
+      int value;
+      device.ints[key] =
+          bluetooth::shim::BtifConfigInterface::GetInt(section, key, &value)
+              ? std::optional<int>(value)
+              : std::nullopt;
+    }
+    return &devices_.emplace(section, std::move(device)).first->second;
+  }
+
+  std::mutex mutex_;
+  bool enabled_ = false;
+  std::unordered_map<std::string, BondedDeviceProperties> devices_;
+  /* Sections known to hold no bond, read straight from storage */
+  std::unordered_set<std::string> not_bonded_;
+};
+
+BondedDeviceCache bonded_device_cache;
+}  // namespace
+
 // Module lifecycle functions
 
 static future_t* init(void) {
@@ -160,6 +333,7 @@ static future_t* init(void) {
   // TODO (b/158035889) Migrate metrics module to GD
   read_or_set_metrics_salt();
   init_metric_id_allocator();
+  bonded_device_cache.Init();
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
@@ -173,6 +347,7 @@ static future_t* clean_up(void) {
   // GD storage module cleanup by itself
   std::unique_lock<std::recursive_mutex> lock(config_lock);
   close_metric_id_allocator();
+  bonded_device_cache.Clear();
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
@@ -219,6 +394,12 @@ bool btif_config_get_int(const std::string& section, const std::string& key,
                          int* value) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  auto cached = bonded_device_cache.GetInt(section, key);
+  if (cached.has_value()) {
+    if (!cached->has_value()) return false;
+    *value = **cached;
+    return true;
+  }
   return bluetooth::shim::BtifConfigInterface::GetInt(section, key, value);
 }
 
@@ -226,6 +407,7 @@ bool btif_config_set_int(const std::string& section, const std::string& key,
                          int value) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.OnSetInt(section, key, value);
   return bluetooth::shim::BtifConfigInterface::SetInt(section, key, value);
 }
 
@@ -240,6 +422,7 @@ bool btif_config_set_uint64(const std::string& section, const std::string& key,
                             uint64_t value) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.OnChange(section, key);
   return bluetooth::shim::BtifConfigInterface::SetUint64(section, key, value);
 }
 
@@ -274,6 +457,7 @@ bool btif_config_set_str(const std::string& section, const std::string& key,
                          const std::string& value) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.OnChange(section, key);
   return bluetooth::shim::BtifConfigInterface::SetStr(section, key, value);
 }
 
@@ -281,6 +465,14 @@ bool btif_config_get_bin(const std::string& section, const std::string& key,
                          uint8_t* value, size_t* length) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  auto cached = bonded_device_cache.GetBin(section, key);
+  if (cached.has_value()) {
+    if (!cached->has_value()) return false;
+    const std::vector<uint8_t>& bytes = **cached;
+    *length = std::min(bytes.size(), *length);
+    std::memcpy(value, bytes.data(), *length);
+    return true;
+  }
   return bluetooth::shim::BtifConfigInterface::GetBin(section, key, value,
                                                       length);
 }
@@ -289,6 +481,10 @@ size_t btif_config_get_bin_length(const std::string& section,
                                   const std::string& key) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  auto cached = bonded_device_cache.GetBin(section, key);
+  if (cached.has_value()) {
+    return cached->has_value() ? (*cached)->size() : 0;
+  }
   return bluetooth::shim::BtifConfigInterface::GetBinLength(section, key);
 }
 
@@ -296,6 +492,7 @@ bool btif_config_set_bin(const std::string& section, const std::string& key,
                          const uint8_t* value, size_t length) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.OnSetBin(section, key, value, length);
   return bluetooth::shim::BtifConfigInterface::SetBin(section, key, value,
                                                       length);
 }
@@ -321,18 +518,21 @@ std::vector<RawAddress> btif_config_get_paired_devices() {
 bool btif_config_remove(const std::string& section, const std::string& key) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.OnChange(section, key);
   return bluetooth::shim::BtifConfigInterface::RemoveProperty(section, key);
 }
 
 void btif_config_remove_device(const std::string& section) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.OnRemoveSection(section);
   bluetooth::shim::BtifConfigInterface::RemoveSection(section);
 }
 
 bool btif_config_clear(void) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bonded_device_cache.Clear();
   bluetooth::shim::BtifConfigInterface::Clear();
   return true;
 }
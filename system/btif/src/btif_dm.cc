@@ -47,6 +47,8 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <optional>
 
@@ -61,6 +63,7 @@
 #include "btif_bqr.h"
 #include "btif_config.h"
 #include "btif_dm.h"
+#include "btif_le_device_cache.h"
 #include "btif_metrics_logging.h"
 #include "btif_profile_storage.h"
 #include "btif_storage.h"
@@ -79,6 +82,7 @@
 #include "main_thread.h"
 #include "os/log.h"
 #include "os/logging/log_adapter.h"
+#include "os/parameter_provider.h"
 #include "osi/include/allocator.h"
 #include "osi/include/properties.h"
 #include "osi/include/stack_power_telemetry.h"
@@ -157,6 +161,14 @@ const Uuid UUID_A2DP_SINK = Uuid::FromString("110B");
 #define PROPERTY_BLE_PRIVACY_ENABLED "bluetooth.core.gap.le.privacy.enabled"
 #endif
 
+/* LE devices found within this many seconds are reported from the cache as
+ * soon as discovery starts. Zero disables the cache. */
+#ifndef PROPERTY_LE_DEVICE_CACHE_MAX_AGE
+#define PROPERTY_LE_DEVICE_CACHE_MAX_AGE \
+  "bluetooth.btif.le_device_cache.max_age_s"
+#endif
+#define LE_DEVICE_CACHE_FILE_NAME "le_device_cache.bin"
+
 #define ENCRYPTED_BREDR 2
 #define ENCRYPTED_LE 4
 
@@ -246,6 +258,9 @@ typedef struct {
 static bluetooth::common::LruCache<RawAddress, std::set<Uuid>> eir_uuids_cache(
     MAX_NUM_DEVICES_IN_EIR_UUID_CACHE);
 
+static bluetooth::btif::LeDeviceCache le_device_cache;
+static std::chrono::seconds le_device_cache_max_age{0};
+
 static skip_sdp_entry_t sdp_rejectlist[] = {{76}};  // Apple Mouse and Keyboard
 
 /* This flag will be true if HCI_Inquiry is in progress */
@@ -347,34 +362,33 @@ bt_status_t btif_in_execute_service_request(tBTA_SERVICE_ID service_id,
 /**
  * Helper method to get asha advertising service data
  * @param inq_res {@code tBTA_DM_INQ_RES} inquiry result
+ * @param eir index of the EIR data of {@code inq_res}
  * @param asha_capability value will be updated as non-negative if found,
  * otherwise return -1
  * @param asha_truncated_hi_sync_id value will be updated if found, otherwise no
  * change
  */
 static void get_asha_service_data(const tBTA_DM_INQ_RES& inq_res,
+                                  const AdvertiseDataIndex& eir,
                                   int16_t& asha_capability,
                                   uint32_t& asha_truncated_hi_sync_id) {
   asha_capability = -1;
-  if (inq_res.p_eir) {
-    const RawAddress& bdaddr = inq_res.bd_addr;
-
-    // iterate through advertisement service data
-    const uint8_t* p_service_data = inq_res.p_eir;
-    uint8_t service_data_len = 0;
-    while ((p_service_data = AdvertiseDataParser::GetFieldByType(
-                p_service_data + service_data_len,
-                inq_res.eir_len - (p_service_data - inq_res.p_eir) -
-                    service_data_len,
-                BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE, &service_data_len))) {
-      if (service_data_len < 2) {
-        continue;
-      }
-      uint16_t uuid;
-      const uint8_t* p_uuid = p_service_data;
-      STREAM_TO_UINT16(uuid, p_uuid);
+  const RawAddress& bdaddr = inq_res.bd_addr;
+
+  // iterate through advertisement service data
+  eir.ForEachFieldOfType(
+      BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE,
+      [&](const uint8_t* p_service_data, uint8_t service_data_len) {
+        if (service_data_len < 2) {
+          return true;
+        }
+        uint16_t uuid;
+        const uint8_t* p_uuid = p_service_data;
+        STREAM_TO_UINT16(uuid, p_uuid);
 
-      if (uuid == 0xfdf0 /* ASHA service*/) {
+        if (uuid != 0xfdf0 /* ASHA service*/) {
+          return true;
+        }
         log::info("ASHA found in {}", bdaddr);
 
         // ASHA advertisement service data length should be at least 8
@@ -388,10 +402,8 @@ static void get_asha_service_data(const tBTA_DM_INQ_RES& inq_res,
           const uint8_t* p_truncated_hisyncid = &(p_service_data[4]);
           STREAM_TO_UINT32(asha_truncated_hi_sync_id, p_truncated_hisyncid);
         }
-        break;
-      }
-    }
-  }
+        return false;
+      });
 }
 
 /*******************************************************************************
@@ -404,34 +416,30 @@ static void get_asha_service_data(const tBTA_DM_INQ_RES& inq_res,
  *                  Populate p_remote_name, if provided and remote name found
  *
  ******************************************************************************/
-static bool check_eir_remote_name(tBTA_DM_SEARCH* p_search_data,
+static bool check_eir_remote_name(const AdvertiseDataIndex& eir,
                                   uint8_t* p_remote_name,
                                   uint8_t* p_remote_name_len) {
   const uint8_t* p_eir_remote_name = NULL;
   uint8_t remote_name_len = 0;
 
   /* Check EIR for remote name and services */
-  if (p_search_data->inq_res.p_eir) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
-        HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
-    if (!p_eir_remote_name) {
-      p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-          p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
-          HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
-    }
-
-    if (p_eir_remote_name) {
-      if (remote_name_len > BD_NAME_LEN) remote_name_len = BD_NAME_LEN;
+  p_eir_remote_name =
+      eir.GetFieldByType(HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
+  if (!p_eir_remote_name) {
+    p_eir_remote_name =
+        eir.GetFieldByType(HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
+  }
 
-      if (p_remote_name && p_remote_name_len) {
-        memcpy(p_remote_name, p_eir_remote_name, remote_name_len);
-        *(p_remote_name + remote_name_len) = 0;
-        *p_remote_name_len = remote_name_len;
-      }
+  if (p_eir_remote_name) {
+    if (remote_name_len > BD_NAME_LEN) remote_name_len = BD_NAME_LEN;
 
-      return true;
+    if (p_remote_name && p_remote_name_len) {
+      memcpy(p_remote_name, p_eir_remote_name, remote_name_len);
+      *(p_remote_name + remote_name_len) = 0;
+      *p_remote_name_len = remote_name_len;
     }
+
+    return true;
   }
 
   return false;
@@ -447,24 +455,21 @@ static bool check_eir_remote_name(tBTA_DM_SEARCH* p_search_data,
  *                  Populate p_appearance, if provided and appearance found
  *
  ******************************************************************************/
-static bool check_eir_appearance(tBTA_DM_SEARCH* p_search_data,
+static bool check_eir_appearance(const AdvertiseDataIndex& eir,
                                  uint16_t* p_appearance) {
   const uint8_t* p_eir_appearance = NULL;
   uint8_t appearance_len = 0;
 
   /* Check EIR for remote name and services */
-  if (p_search_data->inq_res.p_eir) {
-    p_eir_appearance = AdvertiseDataParser::GetFieldByType(
-        p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
-        HCI_EIR_APPEARANCE_TYPE, &appearance_len);
-
-    if (p_eir_appearance && appearance_len >= 2) {
-      if (p_appearance) {
-        *p_appearance = *((uint16_t*)p_eir_appearance);
-      }
+  p_eir_appearance =
+      eir.GetFieldByType(HCI_EIR_APPEARANCE_TYPE, &appearance_len);
 
-      return true;
+  if (p_eir_appearance && appearance_len >= 2) {
+    if (p_appearance) {
+      *p_appearance = *((uint16_t*)p_eir_appearance);
     }
+
+    return true;
   }
 
   return false;
@@ -1389,6 +1394,126 @@ static void btif_dm_auth_cmpl_evt(tBTA_DM_AUTH_CMPL* p_auth_cmpl) {
   }
 }
 
+/******************************************************************************
+ *
+ * Function         btif_dm_update_le_device_cache
+ *
+ * Description      Records a LE device found by discovery in the LE device
+ *                  cache, so it can be reported early by the next discovery
+ *
+ * Returns          void
+ *
+ *****************************************************************************/
+static void btif_dm_update_le_device_cache(const tBTA_DM_INQ_RES& inq_res,
+                                           const bt_bdname_t& bdname,
+                                           const uint8_t* uuid_list,
+                                           uint8_t num_uuids,
+                                           uint16_t appearance) {
+  if (!le_device_cache.IsOpen()) {
+    return;
+  }
+
+  std::vector<Uuid> uuids;
+  const uint16_t* p_uuid16 = (const uint16_t*)uuid_list;
+  for (int i = 0; i < num_uuids; ++i) {
+    uuids.push_back(Uuid::From16Bit(p_uuid16[i]));
+  }
+  le_device_cache.Update(inq_res.bd_addr, inq_res.ble_addr_type, inq_res.rssi,
+                         std::string((const char*)bdname.name), appearance,
+                         uuids, std::chrono::system_clock::now());
+}
+
+/******************************************************************************
+ *
+ * Function         btif_dm_report_cached_le_devices
+ *
+ * Description      Reports the LE devices recently found by discovery, before
+ *                  the controller finds them again
+ *
+ * Returns          void
+ *
+ *****************************************************************************/
+static void btif_dm_report_cached_le_devices() {
+  if (!le_device_cache.IsOpen()) {
+    return;
+  }
+
+#if TARGET_FLOSS
+  bool report_eir_uuids = true;
+#else
+  bool report_eir_uuids = false;
+#endif
+  auto devices = le_device_cache.GetRecentDevices(
+      le_device_cache_max_age, std::chrono::system_clock::now());
+  log::info("Reporting {} cached LE devices", devices.size());
+
+  for (auto& device : devices) {
+    std::vector<bt_property_t> bt_properties;
+    bt_bdname_t bdname = {};
+    uint32_t dev_type = BT_DEVICE_TYPE_BLE;
+    int stored_device_type = 0;
+    if (btif_get_device_type(device.address, &stored_device_type) &&
+        stored_device_type == BT_DEVICE_TYPE_DUMO) {
+      dev_type = BT_DEVICE_TYPE_DUMO;
+    }
+
+    bt_properties.push_back(bt_property_t{
+        BT_PROPERTY_BDADDR, sizeof(device.address), &device.address});
+    if (!device.name.empty()) {
+      strlcpy((char*)bdname.name, device.name.c_str(), sizeof(bdname.name));
+      bt_properties.push_back(
+          bt_property_t{BT_PROPERTY_BDNAME,
+                        static_cast<int>(strlen((char*)bdname.name)), &bdname});
+    }
+    bt_properties.push_back(
+        bt_property_t{BT_PROPERTY_TYPE_OF_DEVICE, sizeof(dev_type), &dev_type});
+    bt_properties.push_back(bt_property_t{BT_PROPERTY_REMOTE_RSSI,
+                                          sizeof(int8_t), &device.rssi});
+    if (device.appearance != 0) {
+      bt_properties.push_back(bt_property_t{BT_PROPERTY_APPEARANCE,
+                                            sizeof(device.appearance),
+                                            &device.appearance});
+    }
+
+    // Scope needs to persist until `invoke_device_found_cb` below.
+    std::vector<uint8_t> property_value;
+    if (!device.uuids.empty()) {
+      auto uuid_iter = eir_uuids_cache.find(device.address);
+      if (uuid_iter == eir_uuids_cache.end()) {
+        auto triple =
+            eir_uuids_cache.try_emplace(device.address, std::set<Uuid>{});
+        uuid_iter = std::get<0>(triple);
+      }
+      uuid_iter->second.insert(device.uuids.begin(), device.uuids.end());
+
+      if (report_eir_uuids) {
+        for (auto uuid : uuid_iter->second) {
+          auto uuid_128bit = uuid.To128BitBE();
+          property_value.insert(property_value.end(), uuid_128bit.begin(),
+                                uuid_128bit.end());
+        }
+        bt_properties.push_back(bt_property_t{
+            BT_PROPERTY_UUIDS,
+            static_cast<int>(uuid_iter->second.size() * Uuid::kNumBytes128),
+            (void*)property_value.data()});
+      }
+    }
+
+    if (btif_storage_add_remote_device(&device.address, bt_properties.size(),
+                                       bt_properties.data()) !=
+            BT_STATUS_SUCCESS ||
+        btif_storage_set_remote_addr_type(
+            &device.address, (tBLE_ADDR_TYPE)device.address_type) !=
+            BT_STATUS_SUCCESS) {
+      log::warn("Unable to save cached LE device {}", device.address);
+      continue;
+    }
+
+    GetInterfaceToProfiles()->events->invoke_device_found_cb(
+        bt_properties.size(), bt_properties.data());
+  }
+}
+
 /******************************************************************************
  *
  * Function         btif_dm_search_devices_evt
@@ -1415,10 +1540,22 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
       uint8_t remote_name_len;
       uint8_t num_uuids = 0, max_num_uuid = 32;
       uint8_t uuid_list[32 * Uuid::kNumBytes16];
+      /* Index the EIR once for all the lookups done on this result */
+      const AdvertiseDataIndex eir_index(
+          p_search_data->inq_res.p_eir,
+          p_search_data->inq_res.p_eir ? p_search_data->inq_res.eir_len : 0);
 
       if (p_search_data->inq_res.inq_result_type != BT_DEVICE_TYPE_BLE) {
         p_search_data->inq_res.remt_name_not_required =
-            check_eir_remote_name(p_search_data, NULL, NULL);
+            check_eir_remote_name(eir_index, NULL, NULL);
+        /* A name we already stored is reported below, don't page for it */
+        if (!p_search_data->inq_res.remt_name_not_required &&
+            bluetooth::common::init_flags::
+                sdp_skip_rnr_if_known_is_enabled()) {
+          p_search_data->inq_res.remt_name_not_required =
+              get_cached_remote_name(p_search_data->inq_res.bd_addr, NULL,
+                                     NULL);
+        }
       }
       RawAddress& bdaddr = p_search_data->inq_res.bd_addr;
 
@@ -1426,7 +1563,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
                    p_search_data->inq_res.device_type);
       bdname.name[0] = 0;
 
-      if (!check_eir_remote_name(p_search_data, bdname.name, &remote_name_len))
+      if (!check_eir_remote_name(eir_index, bdname.name, &remote_name_len))
         get_cached_remote_name(p_search_data->inq_res.bd_addr, bdname.name,
                                  &remote_name_len);
 
@@ -1526,8 +1663,8 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
         // contains ASHA truncated HiSyncId if asha_capability is non-negative
         uint32_t asha_truncated_hi_sync_id = 0;
 
-        get_asha_service_data(p_search_data->inq_res, asha_capability,
-                              asha_truncated_hi_sync_id);
+        get_asha_service_data(p_search_data->inq_res, eir_index,
+                              asha_capability, asha_truncated_hi_sync_id);
 
         bt_properties.push_back(
             bt_property_t{BT_PROPERTY_REMOTE_ASHA_CAPABILITY, sizeof(int16_t),
@@ -1580,7 +1717,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
 
         // Floss needs appearance for metrics purposes
         uint16_t appearance = 0;
-        if (check_eir_appearance(p_search_data, &appearance)) {
+        if (check_eir_appearance(eir_index, &appearance)) {
           bt_properties.push_back(bt_property_t{
               BT_PROPERTY_APPEARANCE, sizeof(appearance), &appearance});
         }
@@ -1602,6 +1739,11 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
           break;
         }
 
+        if (p_search_data->inq_res.device_type == BT_DEVICE_TYPE_BLE) {
+          btif_dm_update_le_device_cache(p_search_data->inq_res, bdname,
+                                         uuid_list, num_uuids, appearance);
+        }
+
         /* Callback to notify upper layer of device */
         GetInterfaceToProfiles()->events->invoke_device_found_cb(
             bt_properties.size(), bt_properties.data());
@@ -2118,6 +2260,7 @@ void BTIF_dm_report_inquiry_status_change(tBTM_INQUIRY_STATE status) {
   if (status == tBTM_INQUIRY_STATE::BTM_INQUIRY_STARTED) {
     GetInterfaceToProfiles()->events->invoke_discovery_state_changed_cb(
         BT_DISCOVERY_STARTED);
+    btif_dm_report_cached_le_devices();
   } else if (status == tBTM_INQUIRY_STATE::BTM_INQUIRY_CANCELLED) {
     GetInterfaceToProfiles()->events->invoke_discovery_state_changed_cb(
         BT_DISCOVERY_STOPPED);
@@ -2150,6 +2293,15 @@ void BTIF_dm_enable() {
   log::info("Local BLE Privacy enabled:{}", ble_privacy_enabled);
   BTA_DmBleConfigLocalPrivacy(ble_privacy_enabled);
 
+  le_device_cache_max_age = std::chrono::seconds(
+      std::max(0, osi_property_get_int32(PROPERTY_LE_DEVICE_CACHE_MAX_AGE, 0)));
+  if (le_device_cache_max_age.count() != 0) {
+    std::string config_path = bluetooth::os::ParameterProvider::ConfigFilePath();
+    le_device_cache.Open(
+        config_path.substr(0, config_path.find_last_of('/') + 1) +
+        LE_DEVICE_CACHE_FILE_NAME);
+  }
+
   if (com::android::bluetooth::flags::separate_service_and_device_discovery()) {
     BTM_SecAddRmtNameNotifyCallback(btif_on_name_read_from_btm);
   }
@@ -2191,6 +2343,7 @@ void BTIF_dm_disable() {
     }
   }
   bluetooth::bqr::EnableBtQualityReport(nullptr);
+  le_device_cache.Close();
   log::info("Stack device manager shutdown finished");
   future_ready(stack_manager_get_hack_future(), FUTURE_SUCCESS);
 }
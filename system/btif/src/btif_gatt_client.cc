@@ -35,7 +35,10 @@
 #include <hardware/bt_gatt_types.h>
 
 #include <cstdlib>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "bta/include/bta_sec_api.h"
 #include "bta_api.h"
@@ -49,6 +52,7 @@
 #include "internal_include/bte_appl.h"
 #include "main/shim/entry.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
 #include "stack/include/btm_ble_sec_api.h"
@@ -94,6 +98,7 @@ static btif_test_cb_t test_cb;
   do {                                                             \
     if (bt_gatt_callbacks && bt_gatt_callbacks->client->P_CBACK) { \
       log::verbose("HAL bt_gatt_callbacks->client->{}", #P_CBACK); \
+      open_notification_batch.reset();                             \
       do_in_jni_thread(P_CBACK_WRAP);                              \
     } else {                                                       \
       ASSERTC(0, "Callback is NULL", 0);                           \
@@ -104,6 +109,7 @@ static btif_test_cb_t test_cb;
   do {                                                                         \
     if (bt_gatt_callbacks && bt_gatt_callbacks->client->P_CBACK) {             \
       log::verbose("HAL bt_gatt_callbacks->client->{}", #P_CBACK);             \
+      open_notification_batch.reset();                                         \
       do_in_jni_thread(Bind(bt_gatt_callbacks->client->P_CBACK, __VA_ARGS__)); \
     } else {                                                                   \
       ASSERTC(0, "Callback is NULL", 0);                                       \
@@ -235,9 +241,88 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
   }
 }
 
+constexpr char kPropertyNotifyBatchingEnabled[] =
+    "bluetooth.gatt.client.notify_batching.enabled";
+
+struct PendingNotification {
+  uint16_t conn_id;
+  uint16_t cid;
+  btgatt_notify_params_t params;
+};
+
+/* Notifications waiting for the JNI thread. While a batch has not been
+ * delivered, further notifications on the same connection join it instead of
+ * posting a task each. */
+struct NotificationBatch {
+  std::mutex mutex;
+  bool delivered = false;
+  uint16_t conn_id;
+  std::vector<std::unique_ptr<PendingNotification>> notifications;
+};
+
+/* Batch the next notification may join. Only touched on the main thread, and
+ * reset by any other callback posted to the JNI thread, so that the order of
+ * events is kept. */
+std::shared_ptr<NotificationBatch> open_notification_batch;
+
+static void btif_gattc_deliver_notifications(
+    std::shared_ptr<NotificationBatch> batch) {
+  std::vector<std::unique_ptr<PendingNotification>> notifications;
+  {
+    std::lock_guard<std::mutex> lock(batch->mutex);
+    batch->delivered = true;
+    notifications.swap(batch->notifications);
+  }
+
+  for (const auto& notification : notifications) {
+    HAL_CBACK(bt_gatt_callbacks, client->notify_cb, notification->conn_id,
+              notification->params);
+
+    if (!notification->params.is_notify)
+      BTA_GATTC_SendIndConfirm(notification->conn_id, notification->cid);
+  }
+}
+
+static void btif_gattc_queue_notification(const tBTA_GATTC_NOTIFY& notify) {
+  // Not value initialized, only the used part of the value is copied
+  std::unique_ptr<PendingNotification> notification(new PendingNotification);
+  notification->conn_id = notify.conn_id;
+  notification->cid = notify.cid;
+  notification->params.bda = notify.bda;
+  notification->params.handle = notify.handle;
+  notification->params.is_notify = notify.is_notify;
+  notification->params.len = notify.len;
+  memcpy(notification->params.value, notify.value, notify.len);
+
+  if (open_notification_batch &&
+      open_notification_batch->conn_id == notify.conn_id) {
+    std::lock_guard<std::mutex> lock(open_notification_batch->mutex);
+    if (!open_notification_batch->delivered) {
+      open_notification_batch->notifications.push_back(
+          std::move(notification));
+      return;
+    }
+  }
+
+  open_notification_batch = std::make_shared<NotificationBatch>();
+  open_notification_batch->conn_id = notify.conn_id;
+  open_notification_batch->notifications.push_back(std::move(notification));
+  do_in_jni_thread(base::BindOnce(&btif_gattc_deliver_notifications,
+                                  open_notification_batch));
+}
+
 static void bta_gattc_cback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
   log::debug("gatt client callback event:{} [{}]",
              gatt_client_event_text(event), event);
+
+  static const bool notify_batching_enabled =
+      osi_property_get_bool(kPropertyNotifyBatchingEnabled, true);
+  if (event == BTA_GATTC_NOTIF_EVT && notify_batching_enabled) {
+    btif_gattc_queue_notification(p_data->notify);
+    return;
+  }
+  open_notification_batch.reset();
+
   bt_status_t status =
       btif_transfer_context(btif_gattc_upstreams_evt, (uint16_t)event,
                             (char*)p_data, sizeof(tBTA_GATTC), NULL);
@@ -152,6 +152,7 @@ bool check_cod(const RawAddress* remote_bdaddr, uint32_t cod);
 bool check_cod_hid(const RawAddress* remote_bdaddr);
 bool check_cod_hid_major(const RawAddress& bd_addr, uint32_t cod);
 void bta_hh_co_close(btif_hh_device_t* p_dev);
+void bta_hh_co_dump(int fd, const btif_hh_device_t* p_dev);
 void bta_hh_co_send_hid_info(btif_hh_device_t* p_dev, const char* dev_name,
                              uint16_t vendor_id, uint16_t product_id,
                              uint16_t version, uint8_t ctry_code, int dscp_len,
@@ -2221,12 +2222,13 @@ void DumpsysHid(int fd) {
   for (unsigned i = 0; i < BTIF_HH_MAX_HID; i++) {
     const btif_hh_device_t* p_dev = &btif_hh_cb.devices[i];
     if (p_dev->link_spec.addrt.bda != RawAddress::kEmpty) {
-      LOG_DUMPSYS(
-          fd, "  %u: addr:%s fd:%d state:%s ready:%s thread_id:%d handle:%d", i,
-          p_dev->link_spec.ToRedactedStringForLogging().c_str(), p_dev->uhid.fd,
-          bthh_connection_state_text(p_dev->dev_status).c_str(),
-          (p_dev->uhid.ready_for_data) ? ("T") : ("F"),
-          static_cast<int>(p_dev->hh_poll_thread_id), p_dev->dev_handle);
+      LOG_DUMPSYS(fd, "  %u: addr:%s fd:%d state:%s ready:%s handle:%d", i,
+                  p_dev->link_spec.ToRedactedStringForLogging().c_str(),
+                  p_dev->uhid.fd,
+                  bthh_connection_state_text(p_dev->dev_status).c_str(),
+                  (p_dev->uhid.ready_for_data) ? ("T") : ("F"),
+                  p_dev->dev_handle);
+      bta_hh_co_dump(fd, p_dev);
     }
   }
   for (unsigned i = 0; i < BTIF_HH_MAX_ADDED_DEV; i++) {
@@ -21,9 +21,15 @@
 #include <base/threading/platform_thread.h>
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <mutex>
 #include <utility>
+#include <vector>
 
+#include "common/inline_once_closure.h"
+#include "common/latency_histogram.h"
 #include "common/message_loop_thread.h"
 #include "common/postable_context.h"
 #include "include/hardware/bluetooth.h"
@@ -38,9 +44,126 @@ using namespace bluetooth;
 
 static bluetooth::common::MessageLoopThread jni_thread("bt_jni_thread");
 
-void jni_thread_startup() { jni_thread.StartUp(); }
+namespace {
+
+// The callbacks posted to the JNI thread wait in this queue, and a single task
+// posted to the message loop runs all of those that are pending when it
+// starts, so that a burst of callbacks costs one wakeup of the JNI thread.
+struct PendingCallback {
+  bluetooth::common::InlineOnceClosure callback;
+  uint64_t posted_us;
+};
+
+struct JniQueue {
+  std::mutex mutex;
+  std::vector<PendingCallback> pending;
+  // Whether a drain task is posted, always true while |pending| is not empty
+  bool drain_scheduled = false;
+
+  size_t max_depth = 0;
+  size_t callback_count = 0;
+  size_t batch_count = 0;
+  size_t max_batch_size = 0;
+  // From the post of a callback to the start of the batch that runs it
+  bluetooth::common::LatencyHistogram latency;
+};
+
+JniQueue jni_queue;
+
+uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void jni_queue_drain() {
+  // Only used on the JNI thread. Swapped with |pending|, so that both vectors
+  // keep their capacity from a batch to the next.
+  static std::vector<PendingCallback> batch;
+  {
+    std::lock_guard<std::mutex> lock(jni_queue.mutex);
+    batch.swap(jni_queue.pending);
+    jni_queue.drain_scheduled = false;
+    uint64_t drain_us = now_us();
+    for (const PendingCallback& pending : batch) {
+      jni_queue.latency.Add(drain_us - pending.posted_us);
+    }
+    jni_queue.callback_count += batch.size();
+    jni_queue.batch_count++;
+    jni_queue.max_batch_size = std::max(jni_queue.max_batch_size, batch.size());
+  }
+  for (PendingCallback& pending : batch) {
+    std::move(pending.callback).Run();
+  }
+  batch.clear();
+}
+
+bt_status_t jni_queue_post(bluetooth::common::InlineOnceClosure callback) {
+  std::lock_guard<std::mutex> lock(jni_queue.mutex);
+  jni_queue.pending.push_back({std::move(callback), now_us()});
+  jni_queue.max_depth =
+      std::max(jni_queue.max_depth, jni_queue.pending.size());
+  if (jni_queue.drain_scheduled) {
+    return BT_STATUS_SUCCESS;
+  }
+  if (!jni_thread.DoInThread(FROM_HERE, base::BindOnce(&jni_queue_drain))) {
+    // No drain is scheduled, so |callback| is the only pending one
+    jni_queue.pending.clear();
+    return BT_STATUS_JNI_THREAD_ATTACH_ERROR;
+  }
+  jni_queue.drain_scheduled = true;
+  return BT_STATUS_SUCCESS;
+}
+
+// Drop the callbacks that a stopped JNI thread will not run
+void jni_queue_reset() {
+  std::vector<PendingCallback> dropped;
+  std::lock_guard<std::mutex> lock(jni_queue.mutex);
+  dropped.swap(jni_queue.pending);
+  jni_queue.drain_scheduled = false;
+}
+
+// Posts through the queue, to keep the callbacks posted with get_jni() in
+// order with the others
+class JniQueueContext : public bluetooth::common::PostableContext {
+ public:
+  void Post(base::OnceClosure closure) override {
+    if (jni_queue_post(std::move(closure)) != BT_STATUS_SUCCESS) {
+      log::error("Post task to task runner failed!");
+    }
+  }
+  void PostInline(bluetooth::common::InlineOnceClosure closure) override {
+    if (jni_queue_post(std::move(closure)) != BT_STATUS_SUCCESS) {
+      log::error("Post task to task runner failed!");
+    }
+  }
+};
+
+JniQueueContext jni_queue_context;
+
+}  // namespace
+
+void jni_thread_startup() {
+  jni_queue_reset();
+  jni_thread.StartUp();
+}
+
+void jni_thread_shutdown() {
+  jni_thread.ShutDown();
+  jni_queue_reset();
+}
 
-void jni_thread_shutdown() { jni_thread.ShutDown(); }
+void jni_thread_dump(int fd) {
+  std::lock_guard<std::mutex> lock(jni_queue.mutex);
+  dprintf(fd, "\nJNI thread queue:\n");
+  dprintf(fd, "%-30s: %zu / %zu\n", "  Depth (current/max)",
+          jni_queue.pending.size(), jni_queue.max_depth);
+  dprintf(fd, "%-30s: %zu in %zu batches, max batch %zu\n", "  Callbacks",
+          jni_queue.callback_count, jni_queue.batch_count,
+          jni_queue.max_batch_size);
+  dprintf(fd, "%-30s: %s\n", "  Latency in us",
+          jni_queue.latency.ToString().c_str());
+}
 
 /*******************************************************************************
  *
@@ -96,7 +219,12 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
     memcpy(p_msg->p_param, p_params, param_len); /* callback parameter data */
   }
 
-  return do_in_jni_thread(base::BindOnce(&bt_jni_msg_ready, p_msg));
+  bt_status_t status = jni_queue_post([p_msg] { bt_jni_msg_ready(p_msg); });
+  if (status != BT_STATUS_SUCCESS) {
+    log::error("Post task to task runner failed!");
+    osi_free(p_msg);
+  }
+  return status;
 }
 
 /**
@@ -104,26 +232,21 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
  * the JNI message loop.
  **/
 bt_status_t do_in_jni_thread(base::OnceClosure task) {
-  if (!jni_thread.DoInThread(FROM_HERE, std::move(task))) {
+  bt_status_t status = jni_queue_post(std::move(task));
+  if (status != BT_STATUS_SUCCESS) {
     log::error("Post task to task runner failed!");
-    return BT_STATUS_JNI_THREAD_ATTACH_ERROR;
   }
-  return BT_STATUS_SUCCESS;
+  return status;
 }
 
 bool is_on_jni_thread() {
   return jni_thread.GetThreadId() == PlatformThread::CurrentId();
 }
 
-static void do_post_on_bt_jni(BtJniClosure closure) { closure(); }
-
 void post_on_bt_jni(BtJniClosure closure) {
-  log::assert_that(
-      do_in_jni_thread(base::BindOnce(do_post_on_bt_jni, std::move(closure))) ==
-          BT_STATUS_SUCCESS,
-      "assert failed: do_in_jni_thread("
-      "base::BindOnce(do_post_on_bt_jni, std::move(closure))) == "
-      "BT_STATUS_SUCCESS");
+  log::assert_that(jni_queue_post(std::move(closure)) == BT_STATUS_SUCCESS,
+                   "assert failed: jni_queue_post(std::move(closure)) == "
+                   "BT_STATUS_SUCCESS");
 }
 
-bluetooth::common::PostableContext* get_jni() { return jni_thread.Postable(); }
+bluetooth::common::PostableContext* get_jni() { return &jni_queue_context; }
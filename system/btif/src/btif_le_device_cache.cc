@@ -0,0 +1,241 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_btif_le_device_cache"
+
+#include "btif/include/btif_le_device_cache.h"
+
+#include <bluetooth/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace bluetooth {
+namespace btif {
+
+namespace {
+constexpr uint32_t kMagic = 0x4c454443;  // "LEDC"
+constexpr uint32_t kVersion = 1;
+}  // namespace
+
+struct LeDeviceCache::Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t record_size;
+};
+
+// Records are updated in place. A record torn by a crash is still safe to
+// read since the name and UUID count are bounded when read back.
+struct LeDeviceCache::Record {
+  uint8_t in_use;
+  uint8_t address[RawAddress::kLength];
+  uint8_t address_type;
+  int8_t rssi;
+  uint8_t num_uuids;
+  uint16_t appearance;
+  // Milliseconds since the epoch.
+  int64_t last_seen;
+  char name[BD_NAME_LEN + 1];
+  uint8_t uuids[kMaxUuids][bluetooth::Uuid::kNumBytes128];
+};
+
+static int64_t to_millis(std::chrono::system_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+LeDeviceCache::~LeDeviceCache() { Close(); }
+
+bool LeDeviceCache::Open(const std::string& path, size_t capacity) {
+  Close();
+
+  size_t size = sizeof(Header) + capacity * sizeof(Record);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    log::error("Unable to open {}: {}", path, strerror(errno));
+    return false;
+  }
+
+  struct stat st;
+  bool reset = fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != size;
+  if (reset && (ftruncate(fd, 0) != 0 || ftruncate(fd, size) != 0)) {
+    log::error("Unable to resize {}: {}", path, strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  void* mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    log::error("Unable to map {}: {}", path, strerror(errno));
+    return false;
+  }
+
+  header_ = static_cast<Header*>(mapping);
+  records_ = reinterpret_cast<Record*>(header_ + 1);
+  capacity_ = capacity;
+  mapped_size_ = size;
+
+  if (header_->magic != kMagic || header_->version != kVersion ||
+      header_->capacity != capacity || header_->record_size != sizeof(Record)) {
+    if (!reset) {
+      log::warn("Resetting {} with an unexpected layout", path);
+    }
+    memset(mapping, 0, size);
+    header_->magic = kMagic;
+    header_->version = kVersion;
+    header_->capacity = capacity;
+    header_->record_size = sizeof(Record);
+  }
+
+  for (size_t i = 0; i < capacity_; i++) {
+    if (records_[i].in_use) {
+      RawAddress address;
+      address.FromOctets(records_[i].address);
+      if (!index_.try_emplace(address, i).second) {
+        records_[i].in_use = 0;
+      }
+    }
+  }
+  log::info("Loaded {} LE devices from {}", index_.size(), path);
+  return true;
+}
+
+void LeDeviceCache::Close() {
+  if (header_ == nullptr) {
+    return;
+  }
+  msync(header_, mapped_size_, MS_ASYNC);
+  munmap(header_, mapped_size_);
+  header_ = nullptr;
+  records_ = nullptr;
+  capacity_ = 0;
+  mapped_size_ = 0;
+  index_.clear();
+}
+
+LeDeviceCache::Record* LeDeviceCache::Allocate(const RawAddress& address) {
+  size_t slot = capacity_;
+  if (index_.size() < capacity_) {
+    for (slot = 0; slot < capacity_ && records_[slot].in_use; slot++) {
+    }
+  } else {
+    // Replace the least recently seen device.
+    for (const auto& [cached_address, i] : index_) {
+      if (slot == capacity_ || records_[i].last_seen < records_[slot].last_seen) {
+        slot = i;
+      }
+    }
+    RawAddress evicted;
+    evicted.FromOctets(records_[slot].address);
+    index_.erase(evicted);
+  }
+
+  Record* record = &records_[slot];
+  memset(record, 0, sizeof(Record));
+  memcpy(record->address, address.address, RawAddress::kLength);
+  record->in_use = 1;
+  index_[address] = slot;
+  return record;
+}
+
+void LeDeviceCache::Update(const RawAddress& address, uint8_t address_type,
+                           int8_t rssi, const std::string& name,
+                           uint16_t appearance,
+                           const std::vector<bluetooth::Uuid>& uuids,
+                           std::chrono::system_clock::time_point now) {
+  if (!IsOpen() || capacity_ == 0) {
+    return;
+  }
+
+  auto iter = index_.find(address);
+  Record* record =
+      iter != index_.end() ? &records_[iter->second] : Allocate(address);
+
+  record->address_type = address_type;
+  record->rssi = rssi;
+  record->last_seen = to_millis(now);
+  if (!name.empty()) {
+    size_t length = std::min(name.size(), static_cast<size_t>(BD_NAME_LEN));
+    memcpy(record->name, name.data(), length);
+    record->name[length] = '\0';
+  }
+  if (appearance != 0) {
+    record->appearance = appearance;
+  }
+  if (!uuids.empty()) {
+    record->num_uuids = std::min(uuids.size(), kMaxUuids);
+    for (size_t i = 0; i < record->num_uuids; i++) {
+      const auto& bytes = uuids[i].To128BitBE();
+      memcpy(record->uuids[i], bytes.data(), bytes.size());
+    }
+  }
+}
+
+void LeDeviceCache::Remove(const RawAddress& address) {
+  auto iter = index_.find(address);
+  if (iter == index_.end()) {
+    return;
+  }
+  records_[iter->second].in_use = 0;
+  index_.erase(iter);
+}
+
+std::vector<LeDeviceCache::Device> LeDeviceCache::GetRecentDevices(
+    std::chrono::seconds max_age,
+    std::chrono::system_clock::time_point now) const {
+  std::vector<Device> devices;
+  int64_t oldest = to_millis(now - max_age);
+  for (const auto& [address, i] : index_) {
+    const Record& record = records_[i];
+    if (record.last_seen < oldest) {
+      continue;
+    }
+
+    Device device{
+        .address = address,
+        .address_type = record.address_type,
+        .name = std::string(record.name, strnlen(record.name, BD_NAME_LEN)),
+        .appearance = record.appearance,
+        .uuids = {},
+        .rssi = record.rssi,
+        .last_seen = std::chrono::system_clock::time_point(
+            std::chrono::milliseconds(record.last_seen)),
+    };
+    size_t num_uuids = std::min(static_cast<size_t>(record.num_uuids), kMaxUuids);
+    for (size_t u = 0; u < num_uuids; u++) {
+      device.uuids.push_back(bluetooth::Uuid::From128BitBE(record.uuids[u]));
+    }
+    devices.push_back(std::move(device));
+  }
+
+  std::sort(devices.begin(), devices.end(),
+            [](const Device& a, const Device& b) {
+              return a.last_seen > b.last_seen;
+            });
+  return devices;
+}
+
+}  // namespace btif
+}  // namespace bluetooth
@@ -36,8 +36,8 @@
 #include <linux/if_ether.h>
 #include <linux/if_tun.h>
 #include <net/if.h>
-#include <poll.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "bta/include/bta_pan_api.h"
@@ -71,8 +71,6 @@
     if (!(s)) log::error("btif_pan: ## assert {} failed ##", #s); \
   } while (0)
 
-#define MIN(x, y) (((x) < (y)) ? (x) : (y))
-
 using namespace bluetooth;
 
 btpan_cb_t btpan_cb;
@@ -401,17 +399,19 @@ int btpan_tap_send(int tap_fd, const RawAddress& src, const RawAddress& dst,
     eth_hdr.h_dest = dst;
     eth_hdr.h_src = src;
     eth_hdr.h_proto = htons(proto);
-    char packet[TAP_MAX_PKT_WRITE_LEN + sizeof(tETH_HDR)];
-    memcpy(packet, &eth_hdr, sizeof(tETH_HDR));
     if (len > TAP_MAX_PKT_WRITE_LEN) {
       log::error("btpan_tap_send eth packet size:{} is exceeded limit!", len);
       return -1;
     }
-    memcpy(packet + sizeof(tETH_HDR), buf, len);
 
-    /* Send data to network interface */
+    /* Send data to network interface, gathering the ethernet header and the
+     * payload rather than copying them together */
+    struct iovec iov[2] = {
+        {.iov_base = &eth_hdr, .iov_len = sizeof(tETH_HDR)},
+        {.iov_base = const_cast<char*>(buf), .iov_len = len},
+    };
     ssize_t ret;
-    OSI_NO_INTR(ret = write(tap_fd, packet, len + sizeof(tETH_HDR)));
+    OSI_NO_INTR(ret = writev(tap_fd, iov, 2));
     log::verbose("ret:{}", ret);
     return (int)ret;
   }
@@ -643,53 +643,46 @@ static void bta_pan_callback(tBTA_PAN_EVT event, tBTA_PAN* p_data) {
                         sizeof(tBTA_PAN), NULL);
 }
 
-#define IS_EXCEPTION(e) ((e) & (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL))
 static void btu_exec_tap_fd_read(int fd) {
-  struct pollfd ufd;
-
   if (fd == INVALID_FD || fd != btpan_cb.tap_fd) return;
 
   // Don't occupy BTU context too long, avoid buffer overruns and
   // give other profiles a chance to run by limiting the amount of memory
-  // PAN can use.
+  // PAN can use. The TAP fd is non blocking, so frames are read until the
+  // driver queue is drained instead of polling it between two reads.
   for (int i = 0; i < PAN_BUF_MAX && btif_is_enabled() && btpan_cb.flow; i++) {
+    // Read the frame straight into the buffer handed over to BNEP, past the
+    // headroom needed for the BNEP and L2CAP headers, so that it is never
+    // copied on its way to the controller.
     BT_HDR* buffer = (BT_HDR*)osi_malloc(PAN_BUF_SIZE);
     buffer->offset = PAN_MINIMUM_OFFSET;
-    buffer->len = PAN_BUF_SIZE - sizeof(BT_HDR) - buffer->offset;
 
     uint8_t* packet = (uint8_t*)buffer + sizeof(BT_HDR) + buffer->offset;
 
-    // If we don't have an undelivered packet left over, pull one from the TAP
-    // driver.
-    // We save it in the congest_packet right away in case we can't deliver it
-    // in this
-    // attempt.
-    if (!btpan_cb.congest_packet_size) {
-      ssize_t ret;
-      OSI_NO_INTR(ret = read(fd, btpan_cb.congest_packet,
-                             sizeof(btpan_cb.congest_packet)));
-      switch (ret) {
-        case -1:
-          log::error("unable to read from driver: {}", strerror(errno));
-          osi_free(buffer);
-          // add fd back to monitor thread to try it again later
-          btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
-          return;
-        case 0:
-          log::warn("end of file reached.");
-          osi_free(buffer);
-          // add fd back to monitor thread to process the exception
-          btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
-          return;
-        default:
-          btpan_cb.congest_packet_size = ret;
-          break;
-      }
+    ssize_t ret;
+    OSI_NO_INTR(ret = read(fd, packet,
+                           PAN_BUF_SIZE - sizeof(BT_HDR) - buffer->offset));
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      osi_free(buffer);
+      break;
+    }
+    switch (ret) {
+      case -1:
+        log::error("unable to read from driver: {}", strerror(errno));
+        osi_free(buffer);
+        // add fd back to monitor thread to try it again later
+        btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
+        return;
+      case 0:
+        log::warn("end of file reached.");
+        osi_free(buffer);
+        // add fd back to monitor thread to process the exception
+        btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
+        return;
+      default:
+        buffer->len = ret;
+        break;
     }
-
-    memcpy(packet, btpan_cb.congest_packet,
-           MIN(btpan_cb.congest_packet_size, buffer->len));
-    buffer->len = MIN(btpan_cb.congest_packet_size, buffer->len);
 
     if (buffer->len > sizeof(tETH_HDR) && should_forward((tETH_HDR*)packet)) {
       // Extract the ethernet header from the buffer since the PAN_WriteBuf
@@ -702,22 +695,17 @@ static void btu_exec_tap_fd_read(int fd) {
       // Skip the ethernet header.
       buffer->len -= sizeof(tETH_HDR);
       buffer->offset += sizeof(tETH_HDR);
-      if (forward_bnep(&hdr, buffer) != FORWARD_CONGEST)
-        btpan_cb.congest_packet_size = 0;
+
+      // BNEP drops the frame when its transmit queue is full. Leave the
+      // following frames queued in the driver until the next wakeup.
+      if (forward_bnep(&hdr, buffer) == FORWARD_CONGEST) {
+        log::warn("dropping packet, BNEP transmit queue is full");
+        break;
+      }
     } else {
       log::warn("dropping packet of length {}", buffer->len);
-      btpan_cb.congest_packet_size = 0;
       osi_free(buffer);
     }
-
-    // Bail out of the loop if reading from the TAP fd would block.
-    ufd.fd = fd;
-    ufd.events = POLLIN;
-    ufd.revents = 0;
-
-    int ret;
-    OSI_NO_INTR(ret = poll(&ufd, 1, 0));
-    if (ret <= 0 || IS_EXCEPTION(ufd.revents)) break;
   }
 
   if (btpan_cb.flow) {
@@ -62,6 +62,8 @@ static void btsock_signaled(int fd, int type, int flags, uint32_t user_id);
 static bt_status_t btsock_disconnect_all(const RawAddress* bd_addr);
 static bt_status_t btsock_get_l2cap_local_cid(Uuid& conn_uuid, uint16_t* cid);
 static bt_status_t btsock_get_l2cap_remote_cid(Uuid& conn_uuid, uint16_t* cid);
+static bt_status_t btsock_get_l2cap_tx_info(Uuid& conn_uuid,
+                                            btsock_tx_info_t* info);
 
 static std::atomic_int thread_handle{-1};
 static thread_t* thread;
@@ -76,6 +78,7 @@ const btsock_interface_t* btif_sock_get_interface(void) {
       btsock_disconnect_all,
       btsock_get_l2cap_local_cid,
       btsock_get_l2cap_remote_cid,
+      btsock_get_l2cap_tx_info,
   };
 
   return &interface;
@@ -300,3 +303,8 @@ static bt_status_t btsock_get_l2cap_local_cid(Uuid& conn_uuid, uint16_t* cid) {
 static bt_status_t btsock_get_l2cap_remote_cid(Uuid& conn_uuid, uint16_t* cid) {
   return btsock_l2cap_get_l2cap_remote_cid(conn_uuid, cid);
 }
+
+static bt_status_t btsock_get_l2cap_tx_info(Uuid& conn_uuid,
+                                            btsock_tx_info_t* info) {
+  return btsock_l2cap_get_l2cap_tx_info(conn_uuid, info);
+}
@@ -22,6 +22,7 @@
 #include <unistd.h>
 
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 
 #include "bta/include/bta_jv_api.h"
@@ -32,12 +33,14 @@
 #include "btif/include/btif_sock_thread.h"
 #include "btif/include/btif_sock_util.h"
 #include "btif/include/btif_uid.h"
+#include "common/time_util.h"
 #include "gd/os/rand.h"
 #include "include/hardware/bluetooth.h"
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
 #include "osi/include/osi.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/l2c_api.h"
 #include "stack/include/l2cdefs.h"
 #include "types/raw_address.h"
 
@@ -71,12 +74,21 @@ typedef struct l2cap_socket {
   unsigned outgoing_congest : 1;  // should we hold?
   unsigned server_psm_sent : 1;   // The server shall only send PSM once.
   bool is_le_coc;                 // is le connection oriented channel?
+  bool is_bulk;                   // uses kBulkErtmOptions?
   uint16_t rx_mtu;
   uint16_t tx_mtu;
+  // Peer credits as of the last write or congestion change (LE CoC only)
+  uint16_t tx_credits;
   // Cumulative number of bytes transmitted on this socket
   int64_t tx_bytes;
   // Cumulative number of bytes received on this socket
   int64_t rx_bytes;
+  // Boot time at which the socket was connected
+  uint64_t connected_time_ms;
+  // Bytes moved in the current one second window, and the highest rate seen
+  uint64_t rate_window_start_ms;
+  int64_t rate_window_bytes;
+  int64_t peak_rate;
   uint16_t local_cid;   // The local CID
   uint16_t remote_cid;  // The remote CID
   Uuid conn_uuid;       // The connection uuid
@@ -495,6 +507,16 @@ static void on_cl_l2cap_init(tBTA_JV_L2CAP_CL_INIT* p_init, uint32_t id) {
   sock->handle = p_init->handle;
 }
 
+static void btsock_l2cap_update_tx_credits_l(l2cap_socket* sock) {
+  // std::mutex locked by caller, on the main thread which owns L2CAP
+  if (!sock->is_le_coc) return;
+
+  tL2CAP_LE_CFG_INFO peer_cfg;
+  if (L2CA_GetPeerLECocConfig(sock->local_cid, &peer_cfg)) {
+    sock->tx_credits = peer_cfg.credits;
+  }
+}
+
 /**
  * Here we allocate a new sock instance to mimic the BluetoothSocket. The socket
  * will be a clone of the sock representing the BluetoothServerSocket.
@@ -505,6 +527,7 @@ static void on_srv_l2cap_psm_connect_l(tBTA_JV_L2CAP_OPEN* p_open,
   l2cap_socket* accept_rs =
       btsock_l2cap_alloc_l(sock->name, &p_open->rem_bda, false, 0);
   accept_rs->connected = true;
+  accept_rs->connected_time_ms = bluetooth::common::time_get_os_boottime_ms();
   accept_rs->security = sock->security;
   accept_rs->channel = sock->channel;
   accept_rs->handle = sock->handle;
@@ -512,9 +535,11 @@ static void on_srv_l2cap_psm_connect_l(tBTA_JV_L2CAP_OPEN* p_open,
   sock->handle =
       -1; /* We should no longer associate this handle with the server socket */
   accept_rs->is_le_coc = sock->is_le_coc;
+  accept_rs->is_bulk = sock->is_bulk;
   accept_rs->tx_mtu = sock->tx_mtu = p_open->tx_mtu;
   accept_rs->local_cid = p_open->local_cid;
   accept_rs->remote_cid = p_open->remote_cid;
+  btsock_l2cap_update_tx_credits_l(accept_rs);
   Uuid uuid =
       Uuid::From128BitBE(bluetooth::os::GenerateRandom<Uuid::kNumBytes128>());
   accept_rs->conn_uuid = uuid;
@@ -557,6 +582,7 @@ static void on_cl_l2cap_psm_connect_l(tBTA_JV_L2CAP_OPEN* p_open,
   sock->tx_mtu = p_open->tx_mtu;
   sock->local_cid = p_open->local_cid;
   sock->remote_cid = p_open->remote_cid;
+  btsock_l2cap_update_tx_credits_l(sock);
   Uuid uuid =
       Uuid::From128BitBE(bluetooth::os::GenerateRandom<Uuid::kNumBytes128>());
   sock->conn_uuid = uuid;
@@ -589,6 +615,7 @@ static void on_cl_l2cap_psm_connect_l(tBTA_JV_L2CAP_OPEN* p_open,
                        sock->id);
   log::info("Connected l2cap socket socket_id:{}", sock->id);
   sock->connected = true;
+  sock->connected_time_ms = bluetooth::common::time_get_os_boottime_ms();
 }
 
 static void on_l2cap_connect(tBTA_JV* p_data, uint32_t id) {
@@ -662,6 +689,7 @@ static void on_l2cap_outgoing_congest(tBTA_JV_L2CAP_CONG* p, uint32_t id) {
   }
 
   sock->outgoing_congest = p->cong ? 1 : 0;
+  btsock_l2cap_update_tx_credits_l(sock);
 
   if (!sock->outgoing_congest) {
     log::verbose("Monitoring l2cap socket for outgoing data socket_id:{}",
@@ -671,6 +699,19 @@ static void on_l2cap_outgoing_congest(tBTA_JV_L2CAP_CONG* p, uint32_t id) {
   }
 }
 
+static void btsock_l2cap_update_rate_l(l2cap_socket* sock, uint32_t bytes) {
+  // std::mutex locked by caller
+  if (!sock->is_bulk) return;
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (now_ms - sock->rate_window_start_ms >= 1000) {
+    sock->rate_window_start_ms = now_ms;
+    sock->rate_window_bytes = 0;
+  }
+  sock->rate_window_bytes += bytes;
+  sock->peak_rate = std::max(sock->peak_rate, sock->rate_window_bytes);
+}
+
 static void on_l2cap_write_done(uint16_t len, uint32_t id) {
   std::unique_lock<std::mutex> lock(state_lock);
   l2cap_socket* sock = btsock_l2cap_find_by_id_l(id);
@@ -688,6 +729,8 @@ static void on_l2cap_write_done(uint16_t len, uint32_t id) {
   }
 
   sock->tx_bytes += len;
+  btsock_l2cap_update_rate_l(sock, len);
+  btsock_l2cap_update_tx_credits_l(sock);
   uid_set_add_tx(uid_set, app_uid, len);
 }
 
@@ -728,6 +771,7 @@ static void on_l2cap_data_ind(tBTA_JV* evt, uint32_t id) {
   }
 
   sock->rx_bytes += bytes_read;
+  btsock_l2cap_update_rate_l(sock, bytes_read);
   uid_set_add_rx(uid_set, app_uid, bytes_read);
 }
 
@@ -811,8 +855,10 @@ static void btsock_l2cap_server_listen(l2cap_socket* sock) {
   }
 
   /* Setup ETM settings: mtu will be set below */
-  std::unique_ptr<tL2CAP_CFG_INFO> cfg = std::make_unique<tL2CAP_CFG_INFO>(
-      tL2CAP_CFG_INFO{.fcr_present = true, .fcr = kDefaultErtmOptions});
+  std::unique_ptr<tL2CAP_CFG_INFO> cfg =
+      std::make_unique<tL2CAP_CFG_INFO>(tL2CAP_CFG_INFO{
+          .fcr_present = true,
+          .fcr = sock->is_bulk ? kBulkErtmOptions : kDefaultErtmOptions});
 
   std::unique_ptr<tL2CAP_ERTM_INFO> ertm_info;
   if (!sock->is_le_coc) {
@@ -864,6 +910,8 @@ static bt_status_t btsock_l2cap_listen_or_connect(const char* name,
   sock->channel = channel;
   sock->app_uid = app_uid;
   sock->is_le_coc = is_le_coc;
+  /* Bulk mode only changes the ERTM options, which LE CoC does not use */
+  sock->is_bulk = !is_le_coc && (flags & BTSOCK_FLAG_L2CAP_BULK) != 0;
   sock->rx_mtu = is_le_coc ? L2CAP_SDU_LENGTH_LE_MAX : L2CAP_SDU_LENGTH_MAX;
 
   /* "role" is never initialized in rfcomm code */
@@ -875,8 +923,10 @@ static bt_status_t btsock_l2cap_listen_or_connect(const char* name,
                                             : tBTA_JV_CONN_TYPE::L2CAP;
 
     /* Setup ETM settings: mtu will be set below */
-    std::unique_ptr<tL2CAP_CFG_INFO> cfg = std::make_unique<tL2CAP_CFG_INFO>(
-        tL2CAP_CFG_INFO{.fcr_present = true, .fcr = kDefaultErtmOptions});
+    std::unique_ptr<tL2CAP_CFG_INFO> cfg =
+        std::make_unique<tL2CAP_CFG_INFO>(tL2CAP_CFG_INFO{
+            .fcr_present = true,
+            .fcr = sock->is_bulk ? kBulkErtmOptions : kDefaultErtmOptions});
 
     std::unique_ptr<tL2CAP_ERTM_INFO> ertm_info;
     if (!sock->is_le_coc) {
@@ -968,9 +1018,15 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
   if ((flags & SOCK_THREAD_FD_RD) && !sock->server) {
     // app sending data
     if (sock->connected) {
-      int size = 0;
-      bool ioctl_success = ioctl(sock->our_fd, FIONREAD, &size) == 0;
-      if (!(flags & SOCK_THREAD_FD_EXCEPTION) || (ioctl_success && size)) {
+      /* Bulk sockets read ahead up to a transmit window of messages per
+       * wakeup instead of one, so the ERTM window stays full. */
+      int max_reads = sock->is_bulk ? kBulkErtmOptions.tx_win_sz : 1;
+      for (int reads = 0; reads < max_reads; reads++) {
+        int size = 0;
+        bool ioctl_success = ioctl(sock->our_fd, FIONREAD, &size) == 0;
+        if (reads > 0 && !(ioctl_success && size)) break;
+        if ((flags & SOCK_THREAD_FD_EXCEPTION) && !(ioctl_success && size))
+          break;
         /* FIONREAD return number of bytes that are immediately available for
            reading, might be bigger than awaiting packet.
 
@@ -985,6 +1041,10 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
         ssize_t count;
         OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), size,
                                  MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
+        if (count == -1) {
+          osi_free(buffer);
+          break;
+        }
         if (count > sock->tx_mtu) {
           /* This can't happen thanks to check in BluetoothSocket.java but leave
            * this in case this socket is ever used anywhere else*/
@@ -1017,6 +1077,28 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
   }
 }
 
+void btsock_l2cap_dump(int fd) {
+  std::unique_lock<std::mutex> lock(state_lock);
+  for (const l2cap_socket* sock = socks; sock; sock = sock->next) {
+    if (!sock->connected) continue;
+
+    size_t queued_packets = 0;
+    for (const packet* p = sock->first_packet; p; p = p->next) {
+      queued_packets++;
+    }
+    btif_sock_dump_active_socket(
+        fd, sock->is_le_coc ? BTSOCK_L2CAP_LE : BTSOCK_L2CAP, sock->id,
+        sock->addr, sock->channel, sock->tx_bytes, sock->rx_bytes,
+        sock->connected_time_ms, queued_packets, sock->bytes_buffered);
+    if (sock->is_bulk) {
+      dprintf(fd,
+              "    bulk ERTM: tx window %u, MPS %u, peak %lld B/s\n",
+              kBulkErtmOptions.tx_win_sz, kBulkErtmOptions.mps,
+              (long long)sock->peak_rate);
+    }
+  }
+}
+
 bt_status_t btsock_l2cap_disconnect(const RawAddress* bd_addr) {
   if (!bd_addr) return BT_STATUS_PARM_INVALID;
   if (!is_inited()) return BT_STATUS_NOT_READY;
@@ -1062,3 +1144,20 @@ bt_status_t btsock_l2cap_get_l2cap_remote_cid(Uuid& conn_uuid, uint16_t* cid) {
   *cid = sock->remote_cid;
   return BT_STATUS_SUCCESS;
 }
+
+bt_status_t btsock_l2cap_get_l2cap_tx_info(Uuid& conn_uuid,
+                                           btsock_tx_info_t* info) {
+  l2cap_socket* sock;
+
+  std::unique_lock<std::mutex> lock(state_lock);
+  sock = btsock_l2cap_find_by_conn_uuid_l(conn_uuid);
+  if (!sock) {
+    log::error("Unable to find l2cap socket with conn_uuid:{}",
+               conn_uuid.ToString());
+    return BT_STATUS_SOCKET_ERROR;
+  }
+  info->optimal_write_size = sock->tx_mtu;
+  info->tx_credits = sock->tx_credits;
+  info->congested = sock->outgoing_congest;
+  return BT_STATUS_SUCCESS;
+}
@@ -25,6 +25,9 @@
 
 #include "btif/include/btif_metrics_logging.h"
 #include "btif/include/btif_sock.h"
+#include "btif/include/btif_sock_l2cap.h"
+#include "btif/include/btif_sock_rfc.h"
+#include "common/time_util.h"
 #include "os/log.h"
 #include "types/raw_address.h"
 
@@ -52,6 +55,7 @@ static SockConnectionEvent connection_logger[SOCK_LOGGER_SIZE_MAX];
 static android::bluetooth::SocketConnectionstateEnum toConnectionStateEnum(
     int state);
 static android::bluetooth::SocketRoleEnum toSocketRoleEnum(int role);
+static const char* toSocketTypeString(int type);
 
 void btif_sock_connection_logger(const RawAddress& address, int port, int type,
                                  int state, int role, int uid, int server_port,
@@ -96,6 +100,34 @@ void btif_sock_dump(int fd) {
     index %= SOCK_LOGGER_SIZE_MAX;
   } while (index != head);
   dprintf(fd, "\n");
+
+  dprintf(fd, "Active Sockets: \n");
+  dprintf(fd,
+          "  Type     \tId        \tAddress          \tChannel   \tTx bytes"
+          "  \tRx bytes  \tTx B/s    \tRx B/s    \tQueued\n");
+  btsock_rfc_dump(fd);
+  btsock_l2cap_dump(fd);
+  dprintf(fd, "\n");
+}
+
+void btif_sock_dump_active_socket(int fd, int type, uint32_t id,
+                                  const RawAddress& address, int channel,
+                                  int64_t tx_bytes, int64_t rx_bytes,
+                                  uint64_t connected_time_ms,
+                                  size_t queued_buffers, size_t queued_bytes) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint64_t elapsed_ms =
+      now_ms > connected_time_ms ? now_ms - connected_time_ms : 0;
+  int64_t tx_rate = elapsed_ms ? tx_bytes * 1000 / (int64_t)elapsed_ms : 0;
+  int64_t rx_rate = elapsed_ms ? rx_bytes * 1000 / (int64_t)elapsed_ms : 0;
+
+  dprintf(fd,
+          "  %-8s\t%-10u\t%s\t%-10d\t%-10lld\t%-10lld\t%-10lld\t%-10lld\t"
+          "%zu buffers, %zu bytes\n",
+          toSocketTypeString(type), id, ADDRESS_TO_LOGGABLE_CSTR(address),
+          channel, (long long)tx_bytes, (long long)rx_bytes,
+          (long long)tx_rate, (long long)rx_rate, queued_buffers,
+          queued_bytes);
 }
 
 void SockConnectionEvent::dump(const int fd) {
@@ -145,24 +177,7 @@ void SockConnectionEvent::dump(const int fd) {
       break;
   }
 
-  const char* str_type;
-  switch (type) {
-    case BTSOCK_RFCOMM:
-      str_type = "RFCOMM";
-      break;
-    case BTSOCK_L2CAP:
-      str_type = "L2CAP";
-      break;
-    case BTSOCK_L2CAP_LE:
-      str_type = "L2CAP_LE";
-      break;
-    case BTSOCK_SCO:
-      str_type = "SCO";
-      break;
-    default:
-      str_type = "UNKNOWN";
-      break;
-  }
+  const char* str_type = toSocketTypeString(type);
 
   dprintf(fd, "  %s\t%s\t%s   \t%s      \t%d         \t%s\t%s\n", eventtime,
           ADDRESS_TO_LOGGABLE_CSTR(addr), str_state, str_role, channel,
@@ -201,4 +216,18 @@ static android::bluetooth::SocketRoleEnum toSocketRoleEnum(int role) {
       return android::bluetooth::SOCKET_ROLE_CONNECTION;
   }
   return android::bluetooth::SOCKET_ROLE_UNKNOWN;
-}
\ No newline at end of file
+}
+
+static const char* toSocketTypeString(int type) {
+  switch (type) {
+    case BTSOCK_RFCOMM:
+      return "RFCOMM";
+    case BTSOCK_L2CAP:
+      return "L2CAP";
+    case BTSOCK_L2CAP_LE:
+      return "L2CAP_LE";
+    case BTSOCK_SCO:
+      return "SCO";
+  }
+  return "UNKNOWN";
+}
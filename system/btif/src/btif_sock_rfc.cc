@@ -22,6 +22,7 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <cstdint>
 #include <mutex>
@@ -35,6 +36,7 @@
 #include "btif/include/btif_sock_sdp.h"
 #include "btif/include/btif_sock_thread.h"
 #include "btif/include/btif_sock_util.h"
+#include "common/time_util.h"
 #include "include/hardware/bt_sock.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
@@ -55,6 +57,9 @@ using namespace bluetooth;
 // Maximum number of devices we can have an RFCOMM connection with.
 #define MAX_RFC_SESSION 7
 
+// Maximum number of queued buffers written back to the app with one sendmsg().
+#define MAX_RFC_IOV_PER_SEND 16
+
 typedef struct {
   int outgoing_congest : 1;
   int pending_sdp_request : 1;
@@ -89,6 +94,8 @@ typedef struct {
   int64_t tx_bytes;
   // Cumulative number of bytes received on this socket
   int64_t rx_bytes;
+  // Boot time at which the socket was connected
+  uint64_t connected_time_ms;
 } rfc_slot_t;
 
 static rfc_slot_t rfc_slots[MAX_RFC_CHANNEL];
@@ -249,6 +256,7 @@ static rfc_slot_t* create_srv_accept_rfc_slot(rfc_slot_t* srv_rs,
 
   accept_rs->f.server = false;
   accept_rs->f.connected = true;
+  accept_rs->connected_time_ms = bluetooth::common::time_get_os_boottime_ms();
   accept_rs->security = srv_rs->security;
   accept_rs->mtu = srv_rs->mtu;
   accept_rs->role = srv_rs->role;
@@ -622,6 +630,7 @@ static void on_cli_rfc_connect(tBTA_JV_RFCOMM_OPEN* p_open, uint32_t id) {
 
   if (send_app_connect_signal(slot->fd, &slot->addr, slot->scn, 0, -1)) {
     slot->f.connected = true;
+    slot->connected_time_ms = bluetooth::common::time_get_os_boottime_ms();
   } else {
     log::error("unable to send connect completion signal to caller.");
   }
@@ -915,10 +924,58 @@ static sent_status_t send_data_to_app(int fd, BT_HDR* p_buf) {
   return SENT_PARTIAL;
 }
 
+// Writes the buffers at the front of |queue| to the app with a single
+// sendmsg(), instead of one send() per received RFCOMM frame. Buffers that
+// were fully written are removed from the queue, a partially written one is
+// advanced. Returns SENT_ALL when every buffer of the batch was written, there
+// may still be buffers left in the queue.
+static sent_status_t send_queued_data_to_app(int fd, list_t* queue) {
+  struct iovec iov[MAX_RFC_IOV_PER_SEND];
+  size_t iov_count = 0;
+  size_t total = 0;
+  for (list_node_t* node = list_begin(queue);
+       node != list_end(queue) && iov_count < MAX_RFC_IOV_PER_SEND;
+       node = list_next(node)) {
+    BT_HDR* p_buf = (BT_HDR*)list_node(node);
+    iov[iov_count].iov_base = p_buf->data + p_buf->offset;
+    iov[iov_count].iov_len = p_buf->len;
+    total += p_buf->len;
+    iov_count++;
+  }
+
+  ssize_t sent = 0;
+  if (total != 0) {
+    struct msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    OSI_NO_INTR(sent = sendmsg(fd, &msg, MSG_DONTWAIT));
+
+    if (sent == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return SENT_NONE;
+      log::error("error writing RFCOMM data back to app: {}", strerror(errno));
+      return SENT_FAILED;
+    }
+
+    if (sent == 0) return SENT_FAILED;
+  }
+
+  size_t remaining = sent;
+  for (size_t i = 0; i < iov_count; i++) {
+    BT_HDR* p_buf = (BT_HDR*)list_front(queue);
+    if (remaining < p_buf->len) {
+      p_buf->offset += remaining;
+      p_buf->len -= remaining;
+      return SENT_PARTIAL;
+    }
+    remaining -= p_buf->len;
+    list_remove(queue, p_buf);
+  }
+  return SENT_ALL;
+}
+
 static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
   while (!list_is_empty(slot->incoming_queue)) {
-    BT_HDR* p_buf = (BT_HDR*)list_front(slot->incoming_queue);
-    switch (send_data_to_app(slot->fd, p_buf)) {
+    switch (send_queued_data_to_app(slot->fd, slot->incoming_queue)) {
       case SENT_NONE:
       case SENT_PARTIAL:
         // monitor the fd to get callback when app is ready to receive data
@@ -927,11 +984,9 @@ static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
         return true;
 
       case SENT_ALL:
-        list_remove(slot->incoming_queue, p_buf);
         break;
 
       case SENT_FAILED:
-        list_remove(slot->incoming_queue, p_buf);
         return false;
     }
   }
@@ -1074,6 +1129,25 @@ int bta_co_rfc_data_outgoing(uint32_t id, uint8_t* buf, uint16_t size) {
   return true;
 }
 
+void btsock_rfc_dump(int fd) {
+  std::unique_lock<std::recursive_mutex> lock(slot_lock);
+  for (size_t i = 0; i < ARRAY_SIZE(rfc_slots); ++i) {
+    const rfc_slot_t* slot = &rfc_slots[i];
+    if (!slot->id || !slot->f.connected) continue;
+
+    size_t queued_bytes = 0;
+    for (const list_node_t* node = list_begin(slot->incoming_queue);
+         node != list_end(slot->incoming_queue); node = list_next(node)) {
+      queued_bytes += ((BT_HDR*)list_node(node))->len;
+    }
+    btif_sock_dump_active_socket(fd, BTSOCK_RFCOMM, slot->id, slot->addr,
+                                 slot->scn, slot->tx_bytes, slot->rx_bytes,
+                                 slot->connected_time_ms,
+                                 list_length(slot->incoming_queue),
+                                 queued_bytes);
+  }
+}
+
 bt_status_t btsock_rfc_disconnect(const RawAddress* bd_addr) {
   log::assert_that(bd_addr != NULL, "assert failed: bd_addr != NULL");
   if (!is_init_done()) {
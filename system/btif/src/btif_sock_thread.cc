@@ -32,10 +32,10 @@
 #include <bluetooth/log.h>
 #include <fcntl.h>
 #include <features.h>
-#include <poll.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -57,10 +57,10 @@
 
 #define MAX_THREAD 8
 #define MAX_POLL 64
-#define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
+#define POLL_EXCEPTION_EVENTS (EPOLLHUP | EPOLLRDHUP | EPOLLERR)
 #define IS_EXCEPTION(e) ((e)&POLL_EXCEPTION_EVENTS)
-#define IS_READ(e) ((e)&POLLIN)
-#define IS_WRITE(e) ((e)&POLLOUT)
+#define IS_READ(e) ((e)&EPOLLIN)
+#define IS_WRITE(e) ((e)&EPOLLOUT)
 /*cmd executes in socket poll thread */
 #define CMD_WAKEUP 1
 #define CMD_EXIT 2
@@ -71,16 +71,21 @@
 using namespace bluetooth;
 
 struct poll_slot_t {
-  struct pollfd pfd;
+  int fd;
+  uint32_t events;  // epoll events monitored for fd
   uint32_t user_id;
   int type;
   int flags;
 };
+/* Sockets are monitored with epoll, so a wakeup only reports the sockets that
+ * are ready whatever the number of sockets in the set. The owner of a socket
+ * is signaled once per requested event: the event is then removed from the
+ * slot, and the owner adds it again when it can process more data. */
 struct thread_slot_t {
   int cmd_fdr, cmd_fdw;
+  int epoll_fd;
   int poll_count;
   poll_slot_t ps[MAX_POLL];
-  int psi[MAX_POLL];  // index of poll slot
   std::optional<pthread_t> thread_id;
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
@@ -138,6 +143,10 @@ static int alloc_thread_slot() {
 static void free_thread_slot(int h) {
   if (0 <= h && h < MAX_THREAD) {
     close_cmd_fd(h);
+    if (ts[h].epoll_fd != -1) {
+      close(ts[h].epoll_fd);
+      ts[h].epoll_fd = -1;
+    }
     ts[h].used = 0;
   } else
     log::error("invalid thread handle:{}", h);
@@ -149,6 +158,7 @@ void btsock_thread_init() {
     int h;
     for (h = 0; h < MAX_THREAD; h++) {
       ts[h].cmd_fdr = ts[h].cmd_fdw = -1;
+      ts[h].epoll_fd = -1;
       ts[h].used = 0;
       ts[h].thread_id = std::nullopt;
       ts[h].poll_count = 0;
@@ -279,31 +289,87 @@ static void init_poll(int h) {
   ts[h].callback = NULL;
   ts[h].cmd_callback = NULL;
   for (i = 0; i < MAX_POLL; i++) {
-    ts[h].ps[i].pfd.fd = -1;
-    ts[h].psi[i] = -1;
+    ts[h].ps[i].fd = -1;
+  }
+  ts[h].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (ts[h].epoll_fd == -1) {
+    log::error("epoll_create1 failed: {}", strerror(errno));
   }
   init_cmd_fd(h);
 }
-static inline unsigned int flags2pevents(int flags) {
-  unsigned int pevents = 0;
-  if (flags & SOCK_THREAD_FD_WR) pevents |= POLLOUT;
-  if (flags & SOCK_THREAD_FD_RD) pevents |= POLLIN;
+static inline uint32_t flags2pevents(int flags) {
+  uint32_t pevents = 0;
+  if (flags & SOCK_THREAD_FD_WR) pevents |= EPOLLOUT;
+  if (flags & SOCK_THREAD_FD_RD) pevents |= EPOLLIN;
   pevents |= POLL_EXCEPTION_EVENTS;
   return pevents;
 }
 
-static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags,
+/* The event data carries the fd along with the slot index, so that an event
+ * of a slot reused for another fd within the same wakeup can be told apart */
+static inline uint64_t slot_event_data(int fd, int ps_i) {
+  return ((uint64_t)(uint32_t)fd << 32) | (uint32_t)ps_i;
+}
+
+/* Apply the events of slot ps_i to the epoll set */
+static bool update_epoll(int h, int ps_i) {
+  poll_slot_t* ps = &ts[h].ps[ps_i];
+  struct epoll_event event = {};
+  event.events = ps->events;
+  event.data.u64 = slot_event_data(ps->fd, ps_i);
+  // The fd of a slot can be closed by its owner and then reused for another
+  // socket: the kernel drops a closed fd from the epoll set by itself
+  if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_MOD, ps->fd, &event) == 0) {
+    return true;
+  }
+  if (errno == ENOENT &&
+      epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_ADD, ps->fd, &event) == 0) {
+    return true;
+  }
+  log::error("epoll_ctl failed for fd:{}, errno:{}, err:{}", ps->fd, errno,
+             strerror(errno));
+  return false;
+}
+
+static inline void clear_poll_slot(int h, poll_slot_t* ps) {
+  --ts[h].poll_count;
+  memset(ps, 0, sizeof(*ps));
+  ps->fd = -1;
+}
+
+static inline void set_poll(int h, int ps_i, int fd, int type, int flags,
                             uint32_t user_id) {
-  ps->pfd.fd = fd;
+  poll_slot_t* ps = &ts[h].ps[ps_i];
+  ps->fd = fd;
   ps->user_id = user_id;
   if (ps->type != 0 && ps->type != type)
     log::error("poll socket type should not changed! type was:{}, type now:{}",
                ps->type, type);
   ps->type = type;
   ps->flags = flags;
-  ps->pfd.events = flags2pevents(flags);
-  ps->pfd.revents = 0;
+  ps->events = flags2pevents(flags);
+  if (!update_epoll(h, ps_i)) {
+    clear_poll_slot(h, ps);
+  }
 }
+
+/* poll() reported a socket closed without being removed from the set with
+ * POLLNVAL, epoll drops it silently. Free the slots of such sockets */
+static void reclaim_closed_poll_slots(int h) {
+  for (int i = 1; i < MAX_POLL; i++) {
+    poll_slot_t* ps = &ts[h].ps[i];
+    if (ps->fd == -1) continue;
+    struct epoll_event event = {};
+    event.events = ps->events;
+    event.data.u64 = slot_event_data(ps->fd, i);
+    if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_MOD, ps->fd, &event) == -1 &&
+        (errno == ENOENT || errno == EBADF)) {
+      log::info("Reclaiming poll slot of closed fd:{}", ps->fd);
+      clear_poll_slot(h, ps);
+    }
+  }
+}
+
 static inline void add_poll(int h, int fd, int type, int flags,
                             uint32_t user_id) {
   asrt(fd != -1);
@@ -312,18 +378,24 @@ static inline void add_poll(int h, int fd, int type, int flags,
   poll_slot_t* ps = ts[h].ps;
 
   for (i = 0; i < MAX_POLL; i++) {
-    if (ps[i].pfd.fd == fd) {
+    if (ps[i].fd == fd) {
       asrt(ts[h].poll_count < MAX_POLL);
 
-      set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
+      set_poll(h, i, fd, type, flags | ps[i].flags, user_id);
       return;
-    } else if (empty < 0 && ps[i].pfd.fd == -1)
+    } else if (empty < 0 && ps[i].fd == -1)
       empty = i;
   }
+  if (empty < 0) {
+    reclaim_closed_poll_slots(h);
+    for (i = 0; i < MAX_POLL && empty < 0; i++) {
+      if (ps[i].fd == -1) empty = i;
+    }
+  }
   if (empty >= 0) {
     asrt(ts[h].poll_count < MAX_POLL);
-    set_poll(&ps[empty], fd, type, flags, user_id);
     ++ts[h].poll_count;
+    set_poll(h, empty, fd, type, flags, user_id);
     return;
   }
   log::error("exceeded max poll slot:{}!", MAX_POLL);
@@ -331,14 +403,20 @@ static inline void add_poll(int h, int fd, int type, int flags,
 static inline void remove_poll(int h, poll_slot_t* ps, int flags) {
   if (flags == ps->flags) {
     // all monitored events signaled. To remove it, just clear the slot
-    --ts[h].poll_count;
-    memset(ps, 0, sizeof(*ps));
-    ps->pfd.fd = -1;
+    if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_DEL, ps->fd, nullptr) == -1 &&
+        errno != ENOENT && errno != EBADF) {
+      log::warn("epoll_ctl del failed for fd:{}, err:{}", ps->fd,
+                strerror(errno));
+    }
+    clear_poll_slot(h, ps);
   } else {
     // one read or one write monitor event signaled, removed the accordding bit
     ps->flags &= ~flags;
     // update the poll events mask
-    ps->pfd.events = flags2pevents(ps->flags);
+    ps->events = flags2pevents(ps->flags);
+    if (!update_epoll(h, ps - ts[h].ps)) {
+      clear_poll_slot(h, ps);
+    }
   }
 }
 static int process_cmd_sock(int h) {
@@ -359,7 +437,7 @@ static int process_cmd_sock(int h) {
     case CMD_REMOVE_FD:
       for (int i = 1; i < MAX_POLL; ++i) {
         poll_slot_t* poll_slot = &ts[h].ps[i];
-        if (poll_slot->pfd.fd == cmd.fd) {
+        if (poll_slot->fd == cmd.fd) {
           remove_poll(h, poll_slot, poll_slot->flags);
           break;
         }
@@ -382,94 +460,68 @@ static int process_cmd_sock(int h) {
   return true;
 }
 
-static void process_data_sock(int h, struct pollfd* pfds, int pfds_count,
+static void process_data_sock(int h, const struct epoll_event* events,
                               int event_count) {
-  asrt(event_count <= pfds_count);
-  int i;
-  for (i = 1; i < pfds_count; i++) {
-    if (pfds[i].revents) {
-      int ps_i = ts[h].psi[i];
-      if (ts[h].ps[ps_i].pfd.fd == -1) {
-        log::info("Socket has been removed from poll set");
-        continue;
-      }
-      asrt(pfds[i].fd == ts[h].ps[ps_i].pfd.fd);
-      uint32_t user_id = ts[h].ps[ps_i].user_id;
-      int type = ts[h].ps[ps_i].type;
-      int flags = 0;
-      if (IS_READ(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_RD;
-      }
-      if (IS_WRITE(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_WR;
-      }
-      if (IS_EXCEPTION(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_EXCEPTION;
-        // remove the whole slot not flags
-        remove_poll(h, &ts[h].ps[ps_i], ts[h].ps[ps_i].flags);
-      } else if (flags)
-        remove_poll(h, &ts[h].ps[ps_i],
-                    flags);  // remove the monitor flags that already processed
-      if (flags) ts[h].callback(pfds[i].fd, type, flags, user_id);
+  for (int i = 0; i < event_count; i++) {
+    int ps_i = (int)(events[i].data.u64 & 0xffffffff);
+    int fd = (int)(events[i].data.u64 >> 32);
+    if (ps_i == 0) continue;  // cmd fd, already processed
+    poll_slot_t* ps = &ts[h].ps[ps_i];
+    if (ps->fd != fd) {
+      log::info("Socket has been removed from poll set");
+      continue;
     }
-  }
-}
-
-static void prepare_poll_fds(int h, struct pollfd* pfds) {
-  int count = 0;
-  int ps_i = 0;
-  int pfd_i = 0;
-  asrt(ts[h].poll_count <= MAX_POLL);
-  while (count < ts[h].poll_count) {
-    if (ps_i >= MAX_POLL) {
-      log::error(
-          "exceed max poll range, ps_i:{}, MAX_POLL:{}, count:{}, "
-          "ts[h].poll_count:{}",
-          ps_i, MAX_POLL, count, ts[h].poll_count);
-      return;
+    uint32_t revents = events[i].events & ps->events;
+    uint32_t user_id = ps->user_id;
+    int type = ps->type;
+    int flags = 0;
+    if (IS_READ(revents)) {
+      flags |= SOCK_THREAD_FD_RD;
     }
-    if (ts[h].ps[ps_i].pfd.fd >= 0) {
-      pfds[pfd_i] = ts[h].ps[ps_i].pfd;
-      ts[h].psi[pfd_i] = ps_i;
-      count++;
-      pfd_i++;
+    if (IS_WRITE(revents)) {
+      flags |= SOCK_THREAD_FD_WR;
     }
-    ps_i++;
+    if (IS_EXCEPTION(events[i].events)) {
+      flags |= SOCK_THREAD_FD_EXCEPTION;
+      // remove the whole slot not flags
+      remove_poll(h, ps, ps->flags);
+    } else if (flags)
+      remove_poll(h, ps,
+                  flags);  // remove the monitor flags that already processed
+    if (flags) ts[h].callback(fd, type, flags, user_id);
   }
 }
+
 static void* sock_poll_thread(void* arg) {
-  std::array<struct pollfd, MAX_POLL> pfds;
+  std::array<struct epoll_event, MAX_POLL> events;
 
   int h = (intptr_t)arg;
   for (;;) {
-    pfds = {};
-    prepare_poll_fds(h, pfds.data());
     int ret;
-    OSI_NO_INTR(ret = poll(pfds.data(), ts[h].poll_count, -1));
+    OSI_NO_INTR(ret = epoll_wait(ts[h].epoll_fd, events.data(), events.size(),
+                                 -1));
     if (ret == -1) {
-      log::error("poll ret -1, exit the thread, errno:{}, err:{}", errno,
+      log::error("epoll_wait ret -1, exit the thread, errno:{}, err:{}", errno,
                  strerror(errno));
       break;
     }
     if (ret != 0) {
-      int need_process_data_fd = true;
-      int pfds_count = ts[h].poll_count;
-      if (pfds[0].revents)  // cmd fd always is the first one
-      {
-        asrt(pfds[0].fd == ts[h].cmd_fdr);
-        if (!process_cmd_sock(h)) {
-          log::info("h:{}, process_cmd_sock return false, exit...", h);
+      // Process the cmd fd first, as poll() did with it being the first fd
+      bool exit = false;
+      for (int i = 0; i < ret; i++) {
+        if ((events[i].data.u64 & 0xffffffff) == 0) {
+          asrt((int)(events[i].data.u64 >> 32) == ts[h].cmd_fdr);
+          if (!process_cmd_sock(h)) {
+            log::info("h:{}, process_cmd_sock return false, exit...", h);
+            exit = true;
+          }
           break;
         }
-        if (ret == 1)
-          need_process_data_fd = false;
-        else
-          ret--;  // exclude the cmd fd
       }
-      if (need_process_data_fd)
-        process_data_sock(h, pfds.data(), pfds_count, ret);
+      if (exit) break;
+      process_data_sock(h, events.data(), ret);
     } else {
-      log::info("no data, select ret: {}", ret);
+      log::info("no data, epoll_wait ret: {}", ret);
     };
   }
   log::info("socket poll thread exiting, h:{}", h);
@@ -53,6 +53,7 @@
 #include "main/shim/entry.h"
 #include "main/shim/helpers.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/bt_uuid16.h"
 #include "storage/config_keys.h"
@@ -62,6 +63,12 @@
 /* This is a local property to add a device found */
 #define BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP 0xFF
 
+/* When set, the enable path only loads what is needed to accept connections
+ * from bonded devices (keys and address types). Remote device properties are
+ * reported after the adapter is enabled. */
+#define PROPERTY_LAZY_BONDED_DEVICE_LOAD \
+  "bluetooth.btif.storage.lazy_bonded_device_load.enabled"
+
 using base::Bind;
 using bluetooth::Uuid;
 using namespace bluetooth;
@@ -955,6 +962,91 @@ void btif_storage_load_le_devices(void) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_report_bonded_device_properties
+ *
+ * Description      Reads the stored properties of a bonded device and invokes
+ *                  the remote_device_properties_cb with them.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void btif_storage_report_bonded_device_properties(
+    RawAddress remote_addr) {
+  RawAddress* p_remote_addr = &remote_addr;
+  bt_property_t remote_properties[10] = {};
+  uint32_t num_props = 0;
+  bt_bdname_t name, alias, model_name;
+  Uuid remote_uuids[BT_MAX_NUM_UUIDS];
+
+  /*
+   * TODO: improve handling of missing fields in NVRAM.
+   */
+  uint32_t cod = 0;
+  uint32_t devtype = 0;
+
+  btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_BDNAME, &name,
+                               sizeof(name), &remote_properties[num_props]);
+  num_props++;
+
+  btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_REMOTE_FRIENDLY_NAME,
+                               &alias, sizeof(alias),
+                               &remote_properties[num_props]);
+  num_props++;
+
+  btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_CLASS_OF_DEVICE, &cod,
+                               sizeof(cod), &remote_properties[num_props]);
+  num_props++;
+
+  btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_TYPE_OF_DEVICE,
+                               &devtype, sizeof(devtype),
+                               &remote_properties[num_props]);
+  num_props++;
+
+  btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_UUIDS, remote_uuids,
+                               sizeof(remote_uuids),
+                               &remote_properties[num_props]);
+  num_props++;
+
+  // Floss needs appearance for metrics purposes
+  uint16_t appearance = 0;
+  if (btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_APPEARANCE,
+                                   &appearance, sizeof(appearance),
+                                   &remote_properties[num_props]) ==
+      BT_STATUS_SUCCESS) {
+    num_props++;
+  }
+
+#if TARGET_FLOSS
+  // Floss needs VID:PID for metrics purposes
+  bt_vendor_product_info_t vp_info;
+  if (btif_storage_get_remote_prop(
+          p_remote_addr, BT_PROPERTY_VENDOR_PRODUCT_INFO, &vp_info,
+          sizeof(vp_info),
+          &remote_properties[num_props]) == BT_STATUS_SUCCESS) {
+    num_props++;
+  }
+
+  // Floss needs address type for diagnosis API
+  uint8_t addr_type;
+  if (btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_REMOTE_ADDR_TYPE,
+                                   &addr_type, sizeof(addr_type),
+                                   &remote_properties[num_props]) ==
+      BT_STATUS_SUCCESS) {
+    num_props++;
+  }
+#endif
+
+  btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_REMOTE_MODEL_NUM,
+                               &model_name, sizeof(model_name),
+                               &remote_properties[num_props]);
+  num_props++;
+
+  btif_remote_properties_evt(BT_STATUS_SUCCESS, p_remote_addr, num_props,
+                             remote_properties);
+}
+
 /*******************************************************************************
  *
  * Function         btif_storage_load_bonded_devices
@@ -973,18 +1065,20 @@ bt_status_t btif_storage_load_bonded_devices(void) {
   uint32_t i = 0;
   bt_property_t adapter_props[6];
   uint32_t num_props = 0;
-  bt_property_t remote_properties[10];
   RawAddress addr;
-  bt_bdname_t name, alias, model_name;
+  bt_bdname_t name;
   bt_scan_mode_t mode;
   uint32_t disc_timeout;
   Uuid local_uuids[BT_MAX_NUM_UUIDS];
-  Uuid remote_uuids[BT_MAX_NUM_UUIDS];
   bt_status_t status;
+  static const bool lazy_load =
+      osi_property_get_bool(PROPERTY_LAZY_BONDED_DEVICE_LOAD, false);
 
   remove_devices_with_sample_ltk();
 
-  btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  /* btif_storage_load_le_devices runs first on enable and already added the
+   * keys of every bonded device to the stack, a lazy load only lists them */
+  btif_in_fetch_bonded_devices(&bonded_devices, lazy_load ? 0 : 1);
 
   /* Now send the adapter_properties_cb with all adapter_properties */
   {
@@ -1046,79 +1140,14 @@ bt_status_t btif_storage_load_bonded_devices(void) {
 
   log::verbose("Number of bonded devices found={}", bonded_devices.num_devices);
 
-  {
-    for (i = 0; i < bonded_devices.num_devices; i++) {
-      RawAddress* p_remote_addr;
-
-      /*
-       * TODO: improve handling of missing fields in NVRAM.
-       */
-      uint32_t cod = 0;
-      uint32_t devtype = 0;
-
-      num_props = 0;
-      p_remote_addr = &bonded_devices.devices[i];
-      memset(remote_properties, 0, sizeof(remote_properties));
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_BDNAME, &name,
-                                   sizeof(name), &remote_properties[num_props]);
-      num_props++;
-
-      btif_storage_get_remote_prop(
-          p_remote_addr, BT_PROPERTY_REMOTE_FRIENDLY_NAME, &alias,
-          sizeof(alias), &remote_properties[num_props]);
-      num_props++;
-
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_CLASS_OF_DEVICE,
-                                   &cod, sizeof(cod),
-                                   &remote_properties[num_props]);
-      num_props++;
-
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_TYPE_OF_DEVICE,
-                                   &devtype, sizeof(devtype),
-                                   &remote_properties[num_props]);
-      num_props++;
-
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_UUIDS,
-                                   remote_uuids, sizeof(remote_uuids),
-                                   &remote_properties[num_props]);
-      num_props++;
-
-      // Floss needs appearance for metrics purposes
-      uint16_t appearance = 0;
-      if (btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_APPEARANCE,
-                                       &appearance, sizeof(appearance),
-                                       &remote_properties[num_props]) ==
-          BT_STATUS_SUCCESS) {
-        num_props++;
-      }
-
-#if TARGET_FLOSS
-      // Floss needs VID:PID for metrics purposes
-      bt_vendor_product_info_t vp_info;
-      if (btif_storage_get_remote_prop(
-              p_remote_addr, BT_PROPERTY_VENDOR_PRODUCT_INFO, &vp_info,
-              sizeof(vp_info),
-              &remote_properties[num_props]) == BT_STATUS_SUCCESS) {
-        num_props++;
-      }
-
-      // Floss needs address type for diagnosis API
-      uint8_t addr_type;
-      if (btif_storage_get_remote_prop(
-              p_remote_addr, BT_PROPERTY_REMOTE_ADDR_TYPE, &addr_type,
-              sizeof(addr_type),
-              &remote_properties[num_props]) == BT_STATUS_SUCCESS) {
-        num_props++;
-      }
-#endif
-
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_REMOTE_MODEL_NUM,
-                                   &model_name, sizeof(model_name),
-                                   &remote_properties[num_props]);
-      num_props++;
-
-      btif_remote_properties_evt(BT_STATUS_SUCCESS, p_remote_addr, num_props,
-                                 remote_properties);
+  for (i = 0; i < bonded_devices.num_devices; i++) {
+    if (lazy_load) {
+      /* Let the enabled callback go out first */
+      do_in_jni_thread(
+          base::BindOnce(btif_storage_report_bonded_device_properties,
+                         bonded_devices.devices[i]));
+    } else {
+      btif_storage_report_bonded_device_properties(bonded_devices.devices[i]);
     }
   }
   return BT_STATUS_SUCCESS;
@@ -978,6 +978,37 @@ TEST_F(BtifCoreWithVendorSupportTest, send_a2dp_audio_choppy) {
             event_reported.wait_for(std::chrono::seconds(1)));
 }
 
+TEST_F(BtifCoreWithVendorSupportTest, link_quality_aggregate) {
+  std::promise<void> a2dp_event_promise;
+  auto event_reported = a2dp_event_promise.get_future();
+  callback_map_["link_quality_report_callback"] = [&a2dp_event_promise]() {
+    a2dp_event_promise.set_value();
+  };
+  auto view = VendorSpecificEventView::Create(
+      EventView::Create(BuilderToView(BqrLinkQualityEventBuilder::Create(
+          QualityReportId::A2DP_AUDIO_CHOPPY, BqrPacketType::TYPE_3DH3, 0x456,
+          Role::CENTRAL, 1, static_cast<uint8_t>(-90) /* rssi */, 3, 4, 5, 6,
+          7, 8 /* retransmission_count */, 9 /* no_rx_count */, 10, 11, 12,
+          13, 14 /* buffer_overflow_bytes */, 15,
+          std::make_unique<RawBuilder>()))));
+  EXPECT_TRUE(view.IsValid());
+  vse_callback_(view);
+  ASSERT_EQ(std::future_status::ready,
+            event_reported.wait_for(std::chrono::seconds(1)));
+
+  bluetooth::bqr::BqrLinkQualityAggregate aggregate;
+  ASSERT_TRUE(bluetooth::bqr::GetLinkQualityAggregate(0x456, &aggregate));
+  EXPECT_EQ(aggregate.report_count, 1u);
+  EXPECT_EQ(aggregate.rssi, -90);
+  EXPECT_EQ(aggregate.retransmission_count, 8u);
+  EXPECT_EQ(aggregate.lost_packets, 9u);
+  EXPECT_EQ(aggregate.buffer_overflow_bytes, 14u);
+  EXPECT_EQ(aggregate.warnings,
+            bluetooth::bqr::kLinkQualityWarningRssi |
+                bluetooth::bqr::kLinkQualityWarningBufferOverflow);
+  EXPECT_FALSE(bluetooth::bqr::GetLinkQualityAggregate(0x789, &aggregate));
+}
+
 TEST_F(BtifCoreWithVendorSupportTest, send_lmp_ll_trace) {
   auto payload = std::make_unique<RawBuilder>();
   payload->AddOctets({'d', 'a', 't', 'a'});
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif/include/btif_le_device_cache.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+
+using bluetooth::Uuid;
+using bluetooth::btif::LeDeviceCache;
+using namespace std::chrono_literals;
+
+namespace {
+const RawAddress kAddress1 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+const RawAddress kAddress2 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x77}};
+const RawAddress kAddress3 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x88}};
+const std::chrono::system_clock::time_point kNow =
+    std::chrono::system_clock::time_point(1700000000s);
+}  // namespace
+
+class LeDeviceCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/le_device_cache_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    path_ = path;
+    ASSERT_TRUE(cache_.Open(path_, 2));
+  }
+
+  void TearDown() override {
+    cache_.Close();
+    unlink(path_.c_str());
+  }
+
+  std::string path_;
+  LeDeviceCache cache_;
+};
+
+TEST_F(LeDeviceCacheTest, update_merges_properties) {
+  cache_.Update(kAddress1, 1, -60, "name", 0, {}, kNow);
+  cache_.Update(kAddress1, 1, -50, "", 0x03c1, {Uuid::From16Bit(0x1812)},
+                kNow + 1s);
+
+  auto devices = cache_.GetRecentDevices(60s, kNow + 1s);
+  ASSERT_EQ(devices.size(), 1ul);
+  ASSERT_EQ(devices[0].address, kAddress1);
+  ASSERT_EQ(devices[0].address_type, 1);
+  ASSERT_EQ(devices[0].name, "name");
+  ASSERT_EQ(devices[0].appearance, 0x03c1);
+  ASSERT_EQ(devices[0].rssi, -50);
+  ASSERT_EQ(devices[0].uuids, std::vector<Uuid>{Uuid::From16Bit(0x1812)});
+  ASSERT_EQ(devices[0].last_seen, kNow + 1s);
+}
+
+TEST_F(LeDeviceCacheTest, recent_devices_are_sorted_and_aged) {
+  cache_.Update(kAddress1, 0, -60, "", 0, {}, kNow - 120s);
+  cache_.Update(kAddress2, 0, -60, "", 0, {}, kNow - 10s);
+
+  auto devices = cache_.GetRecentDevices(60s, kNow);
+  ASSERT_EQ(devices.size(), 1ul);
+  ASSERT_EQ(devices[0].address, kAddress2);
+
+  devices = cache_.GetRecentDevices(300s, kNow);
+  ASSERT_EQ(devices.size(), 2ul);
+  ASSERT_EQ(devices[0].address, kAddress2);
+  ASSERT_EQ(devices[1].address, kAddress1);
+}
+
+TEST_F(LeDeviceCacheTest, least_recently_seen_device_is_evicted) {
+  cache_.Update(kAddress1, 0, -60, "", 0, {}, kNow);
+  cache_.Update(kAddress2, 0, -60, "", 0, {}, kNow + 1s);
+  cache_.Update(kAddress1, 0, -60, "", 0, {}, kNow + 2s);
+  cache_.Update(kAddress3, 0, -60, "", 0, {}, kNow + 3s);
+
+  auto devices = cache_.GetRecentDevices(60s, kNow + 3s);
+  ASSERT_EQ(devices.size(), 2ul);
+  ASSERT_EQ(devices[0].address, kAddress3);
+  ASSERT_EQ(devices[1].address, kAddress1);
+}
+
+TEST_F(LeDeviceCacheTest, devices_persist_across_open) {
+  cache_.Update(kAddress1, 1, -60, "name", 0, {}, kNow);
+  cache_.Update(kAddress2, 1, -60, "", 0, {}, kNow);
+  cache_.Remove(kAddress2);
+  cache_.Close();
+
+  ASSERT_TRUE(cache_.Open(path_, 2));
+  auto devices = cache_.GetRecentDevices(60s, kNow);
+  ASSERT_EQ(devices.size(), 1ul);
+  ASSERT_EQ(devices[0].address, kAddress1);
+  ASSERT_EQ(devices[0].name, "name");
+}
+
+TEST_F(LeDeviceCacheTest, capacity_change_resets_the_cache) {
+  cache_.Update(kAddress1, 1, -60, "name", 0, {}, kNow);
+  cache_.Close();
+
+  ASSERT_TRUE(cache_.Open(path_, 4));
+  ASSERT_EQ(cache_.Size(), 0ul);
+}
@@ -36,6 +36,9 @@ bool AddressObfuscator::IsSaltValid(const Octet32& salt_256bit) {
 
 void AddressObfuscator::Initialize(const Octet32& salt_256bit) {
   std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
+  if (salt_256bit_ != salt_256bit) {
+    cache_.Clear();
+  }
   salt_256bit_ = salt_256bit;
 }
 
@@ -47,6 +50,12 @@ bool AddressObfuscator::IsInitialized() {
 std::string AddressObfuscator::Obfuscate(const RawAddress& address) {
   std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
   log::assert_that(IsInitialized(), "assert failed: IsInitialized()");
+  std::string obfuscated_address;
+  if (cache_.Get(address, &obfuscated_address)) {
+    cache_hits_.Add();
+    return obfuscated_address;
+  }
+
   std::array<uint8_t, EVP_MAX_MD_SIZE> result = {};
   unsigned int out_len = 0;
   log::assert_that(::HMAC(EVP_sha256(), salt_256bit_.data(),
@@ -58,7 +67,10 @@ std::string AddressObfuscator::Obfuscate(const RawAddress& address) {
   log::assert_that(
       out_len == static_cast<unsigned int>(kOctet32Length),
       "assert failed: out_len == static_cast<unsigned int>(kOctet32Length)");
-  return std::string(reinterpret_cast<const char*>(result.data()), out_len);
+  obfuscated_address.assign(reinterpret_cast<const char*>(result.data()),
+                            out_len);
+  cache_.Put(address, obfuscated_address);
+  return obfuscated_address;
 }
 
 }  // namespace common
@@ -21,6 +21,8 @@
 #include <mutex>
 #include <string>
 
+#include "common/lru.h"
+#include "common/metrics_registry.h"
 #include "hci/octets.h"
 #include "raw_address.h"
 
@@ -30,6 +32,9 @@ namespace common {
 class AddressObfuscator {
  public:
   static constexpr unsigned int kOctet32Length = hci::kOctet32Length;
+  // Number of addresses whose obfuscated ID is kept, so that the events of
+  // the connected devices are not hashed over and over
+  static constexpr size_t kCacheSize = 64;
   using Octet32 = hci::Octet32;
   static AddressObfuscator* GetInstance() {
     static auto instance = new AddressObfuscator();
@@ -59,7 +64,8 @@ class AddressObfuscator {
   bool IsInitialized();
 
   /**
-   * Obfuscate Bluetooth MAC address into an anonymous ID string
+   * Obfuscate Bluetooth MAC address into an anonymous ID string. The IDs of
+   * the last kCacheSize addresses are cached until the salt changes.
    *
    * @param address Bluetooth MAC address to be obfuscated
    * @return the obfuscated MAC address in 256 bit
@@ -69,6 +75,10 @@ class AddressObfuscator {
  private:
   AddressObfuscator() : salt_256bit_({0}) {}
   Octet32 salt_256bit_;
+  LegacyLruCache<RawAddress, std::string> cache_{kCacheSize,
+                                                 "AddressObfuscator"};
+  MetricsCounter& cache_hits_ =
+      MetricsRegistry::GetCounter("address_obfuscator.cache_hits");
   std::recursive_mutex instance_mutex_;
 };
 
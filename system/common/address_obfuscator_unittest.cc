@@ -120,3 +120,19 @@ TEST(AddressObfuscatorTest, test_obfuscate_address_key2_max_address) {
   EXPECT_EQ(result.size(), AddressObfuscator::kOctet32Length);
   EXPECT_EQ(result, kTestResult2_3);
 }
+
+TEST(AddressObfuscatorTest, test_obfuscate_address_cached_until_salt_change) {
+  auto& cache_hits = bluetooth::common::MetricsRegistry::GetCounter(
+      "address_obfuscator.cache_hits");
+  AddressObfuscator::GetInstance()->Initialize(kTestKey1);
+  AddressObfuscator::GetInstance()->Obfuscate(kTestData1);
+  uint64_t hits = cache_hits.Value();
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            kTestResult1);
+  EXPECT_EQ(cache_hits.Value(), hits + 1);
+
+  AddressObfuscator::GetInstance()->Initialize(kTestKey2);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_1),
+            kTestResult2_1);
+  EXPECT_EQ(cache_hits.Value(), hits + 1);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "common/flat_map.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+using bluetooth::common::FlatMap;
+
+namespace {
+
+// Addresses of one vendor, the worst case for a hash of the first bytes
+std::vector<RawAddress> MakeAddresses(size_t count) {
+  std::vector<RawAddress> addresses;
+  for (size_t i = 0; i < count; i++) {
+    uint8_t bytes[RawAddress::kLength] = {0x00,
+                                          0x1a,
+                                          0x7d,
+                                          0xda,
+                                          static_cast<uint8_t>(i >> 8),
+                                          static_cast<uint8_t>(i)};
+    addresses.push_back(RawAddress(bytes));
+  }
+  return addresses;
+}
+
+template <typename Map>
+void BM_FindAddress(State& state) {
+  std::vector<RawAddress> addresses = MakeAddresses(state.range(0));
+  Map map;
+  for (size_t i = 0; i < addresses.size(); i++) map[addresses[i]] = i;
+
+  size_t next = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(addresses[next]));
+    next = (next + 1) % addresses.size();
+  }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_FindAddress, std::map<RawAddress, size_t>)
+    ->Arg(4)
+    ->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(BM_FindAddress, std::unordered_map<RawAddress, size_t>)
+    ->Arg(4)
+    ->Arg(32)
+    ->Arg(256);
+BENCHMARK_TEMPLATE(BM_FindAddress, FlatMap<RawAddress, size_t>)
+    ->Arg(4)
+    ->Arg(32)
+    ->Arg(256);
+
+BENCHMARK_MAIN();
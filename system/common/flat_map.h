@@ -0,0 +1,118 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// A map kept as a vector of pairs sorted by key, for the per-device state of
+// which there are at most a few hundred entries: a lookup is a binary search
+// over contiguous memory instead of a walk through tree nodes, and iteration
+// goes in key order like std::map.
+//
+// Unlike std::map, inserting or erasing invalidates the iterators and the
+// references to the values, so loops that erase must use the iterator
+// returned by erase().
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  void clear() { entries_.clear(); }
+  void reserve(size_t capacity) { entries_.reserve(capacity); }
+
+  iterator find(const K& key) {
+    auto it = LowerBound(key);
+    return (it != entries_.end() && !compare_(key, it->first)) ? it
+                                                                : entries_.end();
+  }
+
+  const_iterator find(const K& key) const {
+    return const_cast<FlatMap*>(this)->find(key);
+  }
+
+  size_t count(const K& key) const { return find(key) != end() ? 1 : 0; }
+  bool contains(const K& key) const { return find(key) != end(); }
+
+  // Inserts |value| unless its key is already there, like std::map::insert.
+  std::pair<iterator, bool> insert(value_type value) {
+    auto it = LowerBound(value.first);
+    if (it != entries_.end() && !compare_(value.first, it->first)) {
+      return {it, false};
+    }
+    return {entries_.insert(it, std::move(value)), true};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    auto it = LowerBound(key);
+    if (it != entries_.end() && !compare_(key, it->first)) {
+      return {it, false};
+    }
+    it = entries_.emplace(it, std::piecewise_construct,
+                          std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+    return {it, true};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+    return try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  iterator erase(const_iterator it) { return entries_.erase(it); }
+  iterator erase(iterator it) { return entries_.erase(it); }
+
+  size_t erase(const K& key) {
+    auto it = find(key);
+    if (it == entries_.end()) return 0;
+    entries_.erase(it);
+    return 1;
+  }
+
+ private:
+  iterator LowerBound(const K& key) {
+    return std::lower_bound(entries_.begin(), entries_.end(), key,
+                            [this](const value_type& entry, const K& key) {
+                              return compare_(entry.first, key);
+                            });
+  }
+
+  std::vector<value_type> entries_;
+  [[no_unique_address]] Compare compare_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
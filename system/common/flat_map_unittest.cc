@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/flat_map.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <unordered_set>
+
+#include "types/raw_address.h"
+
+using bluetooth::common::FlatMap;
+
+TEST(FlatMapTest, InsertFindErase) {
+  FlatMap<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(1), map.end());
+
+  EXPECT_TRUE(map.insert({2, "two"}).second);
+  EXPECT_TRUE(map.emplace(1, "one").second);
+  EXPECT_FALSE(map.insert({2, "deux"}).second);
+  map[3] = "three";
+  EXPECT_EQ(map.size(), 3u);
+
+  ASSERT_NE(map.find(2), map.end());
+  EXPECT_EQ(map.find(2)->second, "two");
+  EXPECT_TRUE(map.contains(3));
+  EXPECT_EQ(map.count(4), 0u);
+
+  EXPECT_EQ(map.erase(2), 1u);
+  EXPECT_EQ(map.erase(2), 0u);
+  EXPECT_EQ(map.find(2), map.end());
+  EXPECT_EQ(map.size(), 2u);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(FlatMapTest, IteratesInKeyOrderLikeStdMap) {
+  FlatMap<RawAddress, int> map;
+  std::map<RawAddress, int> expected;
+  for (int i = 0; i < 200; i++) {
+    RawAddress address;
+    for (size_t j = 0; j < RawAddress::kLength; j++) {
+      address.address[j] = static_cast<uint8_t>((i * 37 + j * 101) % 251);
+    }
+    map[address] = i;
+    expected[address] = i;
+  }
+
+  ASSERT_EQ(map.size(), expected.size());
+  auto it = map.begin();
+  for (const auto& [address, value] : expected) {
+    EXPECT_EQ(it->first, address);
+    EXPECT_EQ(it->second, value);
+    ++it;
+  }
+}
+
+TEST(FlatMapTest, EraseWhileIterating) {
+  FlatMap<int, int> map;
+  for (int i = 0; i < 10; i++) map[i] = i;
+
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->second % 2) {
+      it = map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  EXPECT_EQ(map.size(), 5u);
+  for (const auto& [key, value] : map) EXPECT_EQ(key % 2, 0);
+}
+
+TEST(RawAddressHashTest, SpreadsAddressesOfOneVendor) {
+  // Addresses that only differ in the last bytes, under one OUI
+  std::unordered_set<size_t> low_bits;
+  for (int i = 0; i < 256; i++) {
+    uint8_t bytes[RawAddress::kLength] = {0x00, 0x1a, 0x7d, 0xda, 0x71,
+                                          static_cast<uint8_t>(i)};
+    RawAddress address(bytes);
+    low_bits.insert(std::hash<RawAddress>{}(address) & 0xff);
+  }
+  EXPECT_GT(low_bits.size(), 128u);
+}
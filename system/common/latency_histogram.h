@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * Histogram of durations in microseconds, with buckets doubling from
+ * kFirstBucketUs so that a few buckets cover both the sub millisecond
+ * processing times and the multi interval delays of the audio streams.
+ *
+ * Bucket i counts the values below BucketUpperBoundUs(i), the last bucket
+ * counts everything else. It does not lock, the owner serializes the calls.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t kNumBuckets = 9;
+  static constexpr uint64_t kFirstBucketUs = 125;
+
+  static uint64_t BucketUpperBoundUs(size_t bucket) {
+    return kFirstBucketUs << bucket;
+  }
+
+  using Buckets = std::array<size_t, kNumBuckets>;
+
+  static size_t BucketOf(uint64_t value_us) {
+    size_t bucket = 0;
+    while (bucket < kNumBuckets - 1 && value_us >= BucketUpperBoundUs(bucket)) {
+      bucket++;
+    }
+    return bucket;
+  }
+
+  /**
+   * Formats |buckets| as "<125:3 <250:0 ... >=16000:1", followed by the
+   * average and the maximum.
+   */
+  static std::string ToString(const Buckets& buckets, uint64_t average_us,
+                              uint64_t max_us) {
+    std::stringstream stream;
+    for (size_t i = 0; i < kNumBuckets - 1; i++) {
+      stream << "<" << BucketUpperBoundUs(i) << ":" << buckets[i] << " ";
+    }
+    stream << ">=" << BucketUpperBoundUs(kNumBuckets - 2) << ":"
+           << buckets[kNumBuckets - 1] << ", avg: " << average_us
+           << ", max: " << max_us;
+    return stream.str();
+  }
+
+  void Add(uint64_t value_us) {
+    buckets_[BucketOf(value_us)]++;
+    count_++;
+    total_us_ += value_us;
+    if (value_us > max_us_) max_us_ = value_us;
+  }
+
+  void Reset() { *this = LatencyHistogram(); }
+
+  size_t Count() const { return count_; }
+  uint64_t MaxUs() const { return max_us_; }
+  uint64_t AverageUs() const { return count_ ? total_us_ / count_ : 0; }
+  size_t BucketCount(size_t bucket) const { return buckets_[bucket]; }
+
+  std::string ToString() const {
+    return ToString(buckets_, AverageUs(), max_us_);
+  }
+
+ private:
+  Buckets buckets_{};
+  size_t count_ = 0;
+  uint64_t total_us_ = 0;
+  uint64_t max_us_ = 0;
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
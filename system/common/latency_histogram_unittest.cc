@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+using bluetooth::common::LatencyHistogram;
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.AverageUs(), 0u);
+  EXPECT_EQ(histogram.MaxUs(), 0u);
+  for (size_t i = 0; i < LatencyHistogram::kNumBuckets; i++) {
+    EXPECT_EQ(histogram.BucketCount(i), 0u);
+  }
+}
+
+TEST(LatencyHistogramTest, ValuesLandInDoublingBuckets) {
+  LatencyHistogram histogram;
+  histogram.Add(0);
+  histogram.Add(124);
+  histogram.Add(125);
+  histogram.Add(999);
+  histogram.Add(1000);
+  histogram.Add(15999);
+  histogram.Add(16000);
+  histogram.Add(1000000);
+
+  EXPECT_EQ(histogram.BucketCount(0), 2u);
+  EXPECT_EQ(histogram.BucketCount(1), 1u);
+  EXPECT_EQ(histogram.BucketCount(2), 0u);
+  EXPECT_EQ(histogram.BucketCount(3), 1u);
+  EXPECT_EQ(histogram.BucketCount(4), 1u);
+  EXPECT_EQ(histogram.BucketCount(7), 1u);
+  EXPECT_EQ(histogram.BucketCount(8), 2u);
+  EXPECT_EQ(histogram.Count(), 8u);
+  EXPECT_EQ(histogram.MaxUs(), 1000000u);
+}
+
+TEST(LatencyHistogramTest, AverageAndReset) {
+  LatencyHistogram histogram;
+  histogram.Add(100);
+  histogram.Add(300);
+  EXPECT_EQ(histogram.AverageUs(), 200u);
+  EXPECT_EQ(histogram.ToString(),
+            "<125:1 <250:0 <500:1 <1000:0 <2000:0 <4000:0 <8000:0 <16000:0 "
+            ">=16000:0, avg: 200, max: 300");
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.BucketCount(0), 0u);
+  EXPECT_EQ(histogram.MaxUs(), 0u);
+}
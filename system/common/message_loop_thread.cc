@@ -30,6 +30,7 @@
 #include <thread>
 
 #include "common/postable_context.h"
+#include "common/thread_policy.h"
 
 namespace bluetooth {
 namespace common {
@@ -52,7 +53,8 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name)
       thread_id_(-1),
       linux_tid_(-1),
       weak_ptr_factory_(this),
-      shutting_down_(false) {}
+      shutting_down_(false),
+      task_profiler_(thread_name) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -88,6 +90,10 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                from_here.ToString());
     return false;
   }
+  if (TaskProfiler::IsEnabled()) {
+    task = task_profiler_.Wrap(TaskProfiler::Site::FromLocation(from_here),
+                               delay, std::move(task));
+  }
   if (!message_loop_->task_runner()->PostDelayedTask(
           from_here, std::move(task), timeDeltaFromMicroseconds(delay))) {
     log::error("failed to post task to message loop for thread {}, from {}",
@@ -192,6 +198,7 @@ void MessageLoopThread::Run(std::promise<void> start_up_promise) {
     run_loop_ = new base::RunLoop();
     thread_id_ = base::PlatformThread::CurrentId();
     linux_tid_ = static_cast<pid_t>(syscall(SYS_gettid));
+    ApplyThreadPolicy(thread_name_);
     start_up_promise.set_value();
   }
 
@@ -29,6 +29,7 @@
 
 #include "abstract_message_loop.h"
 #include "common/postable_context.h"
+#include "common/task_profiler.h"
 
 namespace bluetooth {
 
@@ -209,6 +210,7 @@ class MessageLoopThread final : public PostableContext {
   pid_t linux_tid_;
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
+  TaskProfiler task_profiler_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/metrics_registry.h"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  // Sorted by name for the dumpsys; the metrics are never moved nor freed
+  std::map<std::string, std::unique_ptr<MetricsCounter>> counters;
+  std::map<std::string, std::unique_ptr<MetricsHistogram>> histograms;
+};
+
+// Never destroyed, so that metrics may still be recorded from static threads
+// at exit
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+}  // namespace
+
+size_t MetricsCounter::ShardIndex() {
+  static std::atomic<size_t> next_shard{0};
+  thread_local size_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  return shard;
+}
+
+uint64_t MetricsCounter::Value() const {
+  uint64_t value = 0;
+  for (const Shard& shard : shards_) {
+    value += shard.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+void MetricsCounter::Reset() {
+  for (Shard& shard : shards_) {
+    shard.value.store(0, std::memory_order_relaxed);
+  }
+}
+
+void MetricsHistogram::Add(uint64_t value_us) {
+  buckets_[LatencyHistogram::BucketOf(value_us)].fetch_add(
+      1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_us_.fetch_add(value_us, std::memory_order_relaxed);
+
+  uint64_t max_us = max_us_.load(std::memory_order_relaxed);
+  while (value_us > max_us &&
+         !max_us_.compare_exchange_weak(max_us, value_us,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t MetricsHistogram::AverageUs() const {
+  size_t count = Count();
+  return count ? total_us_.load(std::memory_order_relaxed) / count : 0;
+}
+
+void MetricsHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  total_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+std::string MetricsHistogram::ToString() const {
+  LatencyHistogram::Buckets buckets;
+  for (size_t i = 0; i < buckets.size(); i++) {
+    buckets[i] = BucketCount(i);
+  }
+  return LatencyHistogram::ToString(buckets, AverageUs(), MaxUs());
+}
+
+MetricsCounter& MetricsRegistry::GetCounter(const std::string& name) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto& counter = registry.counters[name];
+  if (counter == nullptr) counter = std::make_unique<MetricsCounter>();
+  return *counter;
+}
+
+MetricsHistogram& MetricsRegistry::GetHistogram(const std::string& name) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto& histogram = registry.histograms[name];
+  if (histogram == nullptr) histogram = std::make_unique<MetricsHistogram>();
+  return *histogram;
+}
+
+void MetricsRegistry::ResetAll() {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (auto& [name, counter] : registry.counters) {
+    counter->Reset();
+  }
+  for (auto& [name, histogram] : registry.histograms) {
+    histogram->Reset();
+  }
+}
+
+void MetricsRegistry::DebugDump(int fd) {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  dprintf(fd, "\nBluetooth Metrics Registry:\n");
+  for (const auto& [name, counter] : registry.counters) {
+    dprintf(fd, "  %s: %llu\n", name.c_str(),
+            static_cast<unsigned long long>(counter->Value()));
+  }
+  for (const auto& [name, histogram] : registry.histograms) {
+    dprintf(fd, "  %s (us): count: %zu, %s\n", name.c_str(),
+            histogram->Count(), histogram->ToString().c_str());
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
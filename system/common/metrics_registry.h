@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "common/latency_histogram.h"
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * Counter that any thread may add to. Each thread adds to one of kNumShards
+ * slots, picked once per thread, so that threads counting the same event do
+ * not all contend on a single cache line.
+ */
+class MetricsCounter {
+ public:
+  static constexpr size_t kNumShards = 8;
+
+  void Add(uint64_t value = 1) {
+    shards_[ShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  uint64_t Value() const;
+  void Reset();
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+
+  static size_t ShardIndex();
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+/**
+ * LatencyHistogram that any thread may add to, with relaxed atomics. The
+ * statistics read while values are added may be off by the values being
+ * added.
+ */
+class MetricsHistogram {
+ public:
+  void Add(uint64_t value_us);
+
+  size_t Count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t MaxUs() const { return max_us_.load(std::memory_order_relaxed); }
+  uint64_t AverageUs() const;
+  size_t BucketCount(size_t bucket) const {
+    return buckets_[bucket].load(std::memory_order_relaxed);
+  }
+
+  void Reset();
+  std::string ToString() const;
+
+ private:
+  std::array<std::atomic<size_t>, LatencyHistogram::kNumBuckets> buckets_{};
+  std::atomic<size_t> count_{0};
+  std::atomic<uint64_t> total_us_{0};
+  std::atomic<uint64_t> max_us_{0};
+};
+
+/**
+ * Process wide counters and histograms, registered by name and written to
+ * the dumpsys by DebugDump().
+ *
+ * Looking a metric up takes a lock: callers on hot paths keep the returned
+ * reference, usually in a function local static, after which recording does
+ * not lock nor allocate:
+ *
+ *   static auto& sent = MetricsRegistry::GetCounter("l2cap.packets_sent");
+ *   sent.Add();
+ */
+class MetricsRegistry {
+ public:
+  /**
+   * Returns the counter named |name|, registering it on first use. It lives
+   * until the process exits.
+   */
+  static MetricsCounter& GetCounter(const std::string& name);
+
+  /**
+   * Returns the histogram named |name|, registering it on first use. It lives
+   * until the process exits.
+   */
+  static MetricsHistogram& GetHistogram(const std::string& name);
+
+  /**
+   * Resets every registered metric, without unregistering it.
+   */
+  static void ResetAll();
+
+  /**
+   * Writes every registered metric to |fd|, sorted by name.
+   */
+  static void DebugDump(int fd);
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/metrics_registry.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using bluetooth::common::LatencyHistogram;
+using bluetooth::common::MetricsCounter;
+using bluetooth::common::MetricsHistogram;
+using bluetooth::common::MetricsRegistry;
+
+TEST(MetricsRegistryTest, SameNameSameMetric) {
+  MetricsCounter& counter = MetricsRegistry::GetCounter("test.same_name");
+  EXPECT_EQ(&counter, &MetricsRegistry::GetCounter("test.same_name"));
+  EXPECT_NE(&counter, &MetricsRegistry::GetCounter("test.other_name"));
+
+  MetricsHistogram& histogram =
+      MetricsRegistry::GetHistogram("test.same_name");
+  EXPECT_EQ(&histogram, &MetricsRegistry::GetHistogram("test.same_name"));
+}
+
+TEST(MetricsRegistryTest, CounterSumsTheThreads) {
+  MetricsCounter& counter = MetricsRegistry::GetCounter("test.threads");
+  counter.Reset();
+
+  constexpr int kNumThreads = 2 * MetricsCounter::kNumShards + 1;
+  constexpr int kNumAdds = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&counter]() {
+      for (int j = 0; j < kNumAdds; j++) counter.Add();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  counter.Add(5);
+
+  EXPECT_EQ(counter.Value(), uint64_t{kNumThreads} * kNumAdds + 5);
+  counter.Reset();
+  EXPECT_EQ(counter.Value(), 0u);
+}
+
+TEST(MetricsRegistryTest, HistogramMatchesLatencyHistogram) {
+  MetricsHistogram& histogram = MetricsRegistry::GetHistogram("test.latency");
+  histogram.Reset();
+  LatencyHistogram expected;
+  for (uint64_t value_us : {0, 124, 125, 999, 16000, 1000000}) {
+    histogram.Add(value_us);
+    expected.Add(value_us);
+  }
+
+  EXPECT_EQ(histogram.Count(), expected.Count());
+  EXPECT_EQ(histogram.MaxUs(), expected.MaxUs());
+  EXPECT_EQ(histogram.AverageUs(), expected.AverageUs());
+  EXPECT_EQ(histogram.ToString(), expected.ToString());
+
+  MetricsRegistry::ResetAll();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.ToString(), LatencyHistogram().ToString());
+}
+
+TEST(MetricsRegistryTest, DebugDumpListsTheMetrics) {
+  MetricsRegistry::GetCounter("test.dump_counter").Add(3);
+  MetricsRegistry::GetHistogram("test.dump_histogram").Add(200);
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  MetricsRegistry::DebugDump(fds[1]);
+  close(fds[1]);
+
+  std::string dump;
+  char buffer[256];
+  ssize_t length;
+  while ((length = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    dump.append(buffer, length);
+  }
+  close(fds[0]);
+
+  EXPECT_NE(dump.find("test.dump_counter: 3"), std::string::npos);
+  EXPECT_NE(dump.find("test.dump_histogram (us): count: 1"),
+            std::string::npos);
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/task_profiler.h"
+
+#include <base/functional/bind.h>
+#include <base/strings/stringprintf.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+namespace bluetooth {
+namespace common {
+
+std::atomic_bool TaskProfiler::enabled_{false};
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  std::set<TaskProfiler*> profilers;
+};
+
+// Never destroyed, so that profilers of static threads can unregister at exit
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+uint64_t ToUs(std::chrono::steady_clock::duration duration) {
+  if (duration.count() < 0) return 0;
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+
+}  // namespace
+
+TaskProfiler::Site TaskProfiler::Site::FromLocation(
+    const base::Location& location) {
+  return Site{location.function_name(), location.file_name(),
+              location.line_number(), location.program_counter()};
+}
+
+TaskProfiler::Site TaskProfiler::Site::FromProgramCounter(
+    const void* program_counter) {
+  return Site{nullptr, nullptr, 0, program_counter};
+}
+
+bool TaskProfiler::Site::operator==(const Site& other) const {
+  if (file_name != nullptr || other.file_name != nullptr) {
+    return file_name == other.file_name && line_number == other.line_number;
+  }
+  return program_counter == other.program_counter;
+}
+
+std::string TaskProfiler::Site::ToString() const {
+  if (file_name != nullptr) {
+    return base::StringPrintf("%s@%s:%d",
+                              function_name ? function_name : "<unknown>",
+                              file_name, line_number);
+  }
+  return base::StringPrintf("pc:%p", program_counter);
+}
+
+void TaskProfiler::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+TaskProfiler::TaskProfiler(std::string name) {
+  stats_.name = std::move(name);
+  stats_.posted_count = 0;
+  stats_.executed_count = 0;
+  stats_.max_pending_count = 0;
+
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.profilers.insert(this);
+}
+
+TaskProfiler::~TaskProfiler() {
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.profilers.erase(this);
+}
+
+base::OnceClosure TaskProfiler::Wrap(Site site,
+                                     std::chrono::microseconds delay,
+                                     base::OnceClosure task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.posted_count++;
+    // Tasks dropped without running, e.g. when a handler is cleared, stay
+    // counted as pending.
+    stats_.max_pending_count =
+        std::max(stats_.max_pending_count,
+                 stats_.posted_count - stats_.executed_count);
+  }
+  return base::BindOnce(&TaskProfiler::Run, base::Unretained(this), site,
+                        std::chrono::steady_clock::now() + delay,
+                        std::move(task));
+}
+
+void TaskProfiler::Run(Site site, std::chrono::steady_clock::time_point due,
+                       base::OnceClosure task) {
+  auto start = std::chrono::steady_clock::now();
+  std::move(task).Run();
+  auto end = std::chrono::steady_clock::now();
+
+  SlowTask slow_task{site, ToUs(end - start), ToUs(start - due)};
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.executed_count++;
+  stats_.queue_delay.Add(slow_task.queue_delay_us);
+  stats_.run_time.Add(slow_task.run_time_us);
+  RecordSlowTask(slow_task);
+}
+
+// Must be called with |mutex_| held
+void TaskProfiler::RecordSlowTask(const SlowTask& task) {
+  std::vector<SlowTask>& slowest = stats_.slowest;
+  auto same_site =
+      std::find_if(slowest.begin(), slowest.end(),
+                   [&task](const SlowTask& other) {
+                     return other.site == task.site;
+                   });
+  if (same_site != slowest.end()) {
+    if (same_site->run_time_us >= task.run_time_us) return;
+    slowest.erase(same_site);
+  } else if (slowest.size() == kSlowestSites) {
+    if (slowest.back().run_time_us >= task.run_time_us) return;
+    slowest.pop_back();
+  }
+  auto position =
+      std::find_if(slowest.begin(), slowest.end(),
+                   [&task](const SlowTask& other) {
+                     return other.run_time_us < task.run_time_us;
+                   });
+  slowest.insert(position, task);
+}
+
+TaskProfiler::Stats TaskProfiler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void TaskProfiler::DebugDump(int fd) {
+  dprintf(fd, "\nTask Profiler: %s\n",
+          IsEnabled() ? "enabled"
+                      : "disabled (persist.bluetooth.task_profiler.enabled)");
+
+  std::vector<Stats> all_stats;
+  {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const TaskProfiler* profiler : registry.profilers) {
+      all_stats.push_back(profiler->GetStats());
+    }
+  }
+  std::sort(all_stats.begin(), all_stats.end(),
+            [](const Stats& a, const Stats& b) { return a.name < b.name; });
+
+  for (const Stats& stats : all_stats) {
+    dprintf(fd, "  %s\n", stats.name.c_str());
+    dprintf(fd, "%-30s: %zu / %zu / %zu\n",
+            "    Tasks (posted/run/pending)", stats.posted_count,
+            stats.executed_count, stats.posted_count - stats.executed_count);
+    dprintf(fd, "%-30s: %zu\n", "    Max pending tasks",
+            stats.max_pending_count);
+    dprintf(fd, "%-30s: %s\n", "    Queue delay in us",
+            stats.queue_delay.ToString().c_str());
+    dprintf(fd, "%-30s: %s\n", "    Run time in us",
+            stats.run_time.ToString().c_str());
+    dprintf(fd, "    Slowest sites:\n");
+    for (const SlowTask& task : stats.slowest) {
+      dprintf(fd, "      run %llu us, waited %llu us: %s\n",
+              (unsigned long long)task.run_time_us,
+              (unsigned long long)task.queue_delay_us,
+              task.site.ToString().c_str());
+    }
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <base/functional/callback.h>
+#include <base/location.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/latency_histogram.h"
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * Per thread statistics of the tasks posted to a MessageLoopThread or to the
+ * handlers of an os::Thread: how many were posted and run, how long they
+ * waited in the queue, how long they ran, and which posting sites were the
+ * slowest.
+ *
+ * Profiling is disabled by default; when disabled, posting a task costs a
+ * single relaxed atomic load. When enabled, each posted task is wrapped so
+ * that it takes its timestamps when it runs.
+ */
+class TaskProfiler {
+ public:
+  static constexpr size_t kSlowestSites = 8;
+
+  /**
+   * Where a task was posted from: a base::Location when the caller gives one,
+   * otherwise only the program counter of the posting call.
+   */
+  struct Site {
+    const char* function_name = nullptr;
+    const char* file_name = nullptr;
+    int line_number = 0;
+    const void* program_counter = nullptr;
+
+    static Site FromLocation(const base::Location& location);
+    static Site FromProgramCounter(const void* program_counter);
+
+    bool operator==(const Site& other) const;
+    std::string ToString() const;
+  };
+
+  struct SlowTask {
+    Site site;
+    uint64_t run_time_us;
+    uint64_t queue_delay_us;
+  };
+
+  struct Stats {
+    std::string name;
+    size_t posted_count;
+    size_t executed_count;
+    size_t max_pending_count;
+    LatencyHistogram queue_delay;
+    LatencyHistogram run_time;
+    // Slowest run of each of the slowest sites, slowest first
+    std::vector<SlowTask> slowest;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Register a profiler named |name| for DebugDump(). The owner of the thread
+   * must outlive every task wrapped by this profiler.
+   */
+  explicit TaskProfiler(std::string name);
+  ~TaskProfiler();
+
+  TaskProfiler(const TaskProfiler&) = delete;
+  TaskProfiler& operator=(const TaskProfiler&) = delete;
+
+  /**
+   * Count |task| as posted, and return a task that runs it and records its
+   * queue delay and run time. |delay| is the delay it was posted with, which
+   * is not counted as queue delay.
+   */
+  base::OnceClosure Wrap(Site site, std::chrono::microseconds delay,
+                         base::OnceClosure task);
+
+  Stats GetStats() const;
+
+  /**
+   * Writes the statistics of every registered profiler to |fd|.
+   */
+  static void DebugDump(int fd);
+
+ private:
+  void Run(Site site, std::chrono::steady_clock::time_point due,
+           base::OnceClosure task);
+  void RecordSlowTask(const SlowTask& task);
+
+  static std::atomic_bool enabled_;
+
+  mutable std::mutex mutex_;
+  Stats stats_;
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
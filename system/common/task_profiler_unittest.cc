@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/task_profiler.h"
+
+#include <base/functional/bind.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using bluetooth::common::TaskProfiler;
+
+namespace {
+
+int sites[TaskProfiler::kSlowestSites + 2];
+
+TaskProfiler::Site SiteAt(int index) {
+  return TaskProfiler::Site::FromProgramCounter(&sites[index]);
+}
+
+base::OnceClosure Sleep(std::chrono::milliseconds duration) {
+  return base::BindOnce(
+      [](std::chrono::milliseconds duration) {
+        std::this_thread::sleep_for(duration);
+      },
+      duration);
+}
+
+}  // namespace
+
+TEST(TaskProfilerTest, CountsPostedAndRunTasks) {
+  TaskProfiler profiler("test_thread");
+  int runs = 0;
+  base::OnceClosure first = profiler.Wrap(
+      SiteAt(0), std::chrono::microseconds(0),
+      base::BindOnce([](int* runs) { (*runs)++; }, &runs));
+  base::OnceClosure dropped = profiler.Wrap(
+      SiteAt(1), std::chrono::microseconds(0), base::DoNothing());
+
+  std::move(first).Run();
+  dropped.Reset();
+
+  TaskProfiler::Stats stats = profiler.GetStats();
+  EXPECT_EQ(runs, 1);
+  EXPECT_EQ(stats.name, "test_thread");
+  EXPECT_EQ(stats.posted_count, 2u);
+  EXPECT_EQ(stats.executed_count, 1u);
+  EXPECT_EQ(stats.max_pending_count, 2u);
+  EXPECT_EQ(stats.queue_delay.Count(), 1u);
+  EXPECT_EQ(stats.run_time.Count(), 1u);
+  ASSERT_EQ(stats.slowest.size(), 1u);
+  EXPECT_EQ(stats.slowest[0].site, SiteAt(0));
+}
+
+TEST(TaskProfilerTest, PostingDelayIsNotQueueDelay) {
+  TaskProfiler profiler("test_thread");
+  base::OnceClosure task = profiler.Wrap(
+      SiteAt(0), std::chrono::seconds(10), base::DoNothing());
+  std::move(task).Run();
+
+  EXPECT_EQ(profiler.GetStats().queue_delay.MaxUs(), 0u);
+}
+
+TEST(TaskProfilerTest, SlowestSitesAreSortedAndUnique) {
+  TaskProfiler profiler("test_thread");
+  profiler.Wrap(SiteAt(0), std::chrono::microseconds(0),
+                Sleep(std::chrono::milliseconds(1)))
+      .Run();
+  profiler.Wrap(SiteAt(1), std::chrono::microseconds(0),
+                Sleep(std::chrono::milliseconds(20)))
+      .Run();
+  // A faster run of a site already listed does not replace it
+  profiler.Wrap(SiteAt(1), std::chrono::microseconds(0), base::DoNothing())
+      .Run();
+
+  TaskProfiler::Stats stats = profiler.GetStats();
+  ASSERT_EQ(stats.slowest.size(), 2u);
+  EXPECT_EQ(stats.slowest[0].site, SiteAt(1));
+  EXPECT_GE(stats.slowest[0].run_time_us, 20000u);
+  EXPECT_EQ(stats.slowest[1].site, SiteAt(0));
+}
+
+TEST(TaskProfilerTest, KeepsOnlyTheSlowestSites) {
+  TaskProfiler profiler("test_thread");
+  for (size_t i = 0; i < TaskProfiler::kSlowestSites + 2; i++) {
+    profiler.Wrap(SiteAt(i), std::chrono::microseconds(0), base::DoNothing())
+        .Run();
+  }
+
+  TaskProfiler::Stats stats = profiler.GetStats();
+  EXPECT_EQ(stats.executed_count, TaskProfiler::kSlowestSites + 2);
+  EXPECT_EQ(stats.slowest.size(), TaskProfiler::kSlowestSites);
+}
+
+TEST(TaskProfilerTest, SitesFromLocationsCompareByLine) {
+  TaskProfiler::Site site = TaskProfiler::Site::FromLocation(FROM_HERE);
+  TaskProfiler::Site same_line = site;
+  same_line.program_counter = nullptr;
+  TaskProfiler::Site other_line = site;
+  other_line.line_number++;
+
+  EXPECT_EQ(site, same_line);
+  EXPECT_FALSE(site == other_line);
+  EXPECT_FALSE(site == SiteAt(0));
+}
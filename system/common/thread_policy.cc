@@ -0,0 +1,221 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/thread_policy.h"
+
+#include <android_bluetooth_sysprop.h>
+#include <bluetooth/log.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace bluetooth {
+
+namespace common {
+
+namespace {
+
+constexpr int kRealTimeFifoSchedulingPriority = 1;
+// ANDROID_PRIORITY_AUDIO
+constexpr int kHighPriorityNiceValue = -16;
+
+struct ThreadRole {
+  const char* thread_name;
+  std::optional<std::string> (*policy)();
+};
+
+namespace sysprop = android::sysprop::bluetooth::Thread;
+
+// The legacy osi threads have their names truncated to THREAD_NAME_MAX
+const ThreadRole kThreadRoles[] = {
+    {"bt_main_thread", [] { return sysprop::main_thread_policy(); }},
+    {"gd_stack_thread", [] { return sysprop::stack_thread_policy(); }},
+    {"bt_a2dp_source_worker_thread",
+     [] { return sysprop::media_thread_policy(); }},
+    {"bt_a2dp_sink_worker_thread",
+     [] { return sysprop::media_thread_policy(); }},
+    {"bt_le_audio_unicast_sink_worker_thread",
+     [] { return sysprop::media_thread_policy(); }},
+    {"bt_le_audio_broadcast_sink_worker_thread",
+     [] { return sysprop::media_thread_policy(); }},
+    {"btif_sock", [] { return sysprop::socket_thread_policy(); }},
+    {"bt_jni_thread", [] { return sysprop::jni_thread_policy(); }},
+};
+
+bool ParseCpuMask(const std::string& value, uint64_t* cpu_mask) {
+  if (value.empty() || value[0] == '-') {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  *cpu_mask = std::strtoull(value.c_str(), &end, 0);
+  return errno == 0 && *end == '\0' && *cpu_mask != 0;
+}
+
+bool ParsePriorityClass(const std::string& value,
+                        ThreadPolicy::PriorityClass* priority_class) {
+  if (value == "normal") {
+    *priority_class = ThreadPolicy::PriorityClass::kNormal;
+  } else if (value == "high") {
+    *priority_class = ThreadPolicy::PriorityClass::kHigh;
+  } else if (value == "rt") {
+    *priority_class = ThreadPolicy::PriorityClass::kRealTime;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool SetCpuAffinity(uint64_t cpu_mask) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+    if (cpu_mask & (UINT64_C(1) << cpu)) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+bool SetPriorityClass(pid_t linux_tid,
+                      ThreadPolicy::PriorityClass priority_class) {
+  switch (priority_class) {
+    case ThreadPolicy::PriorityClass::kUnchanged:
+      return true;
+    case ThreadPolicy::PriorityClass::kNormal:
+    case ThreadPolicy::PriorityClass::kHigh: {
+      struct sched_param params = {.sched_priority = 0};
+      int nice_value =
+          priority_class == ThreadPolicy::PriorityClass::kHigh
+              ? kHighPriorityNiceValue
+              : 0;
+      return sched_setscheduler(linux_tid, SCHED_OTHER, &params) == 0 &&
+             setpriority(PRIO_PROCESS, linux_tid, nice_value) == 0;
+    }
+    case ThreadPolicy::PriorityClass::kRealTime: {
+      struct sched_param params = {.sched_priority =
+                                       kRealTimeFifoSchedulingPriority};
+      return sched_setscheduler(linux_tid, SCHED_FIFO, &params) == 0;
+    }
+  }
+  return false;
+}
+
+bool JoinCgroup(pid_t linux_tid, const std::string& cgroup) {
+  std::string tasks_path = cgroup + "/tasks";
+  int fd = open(tasks_path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+  std::string tid = std::to_string(linux_tid);
+  bool written = write(fd, tid.c_str(), tid.size()) ==
+                 static_cast<ssize_t>(tid.size());
+  close(fd);
+  return written;
+}
+
+}  // namespace
+
+std::optional<ThreadPolicy> ThreadPolicy::Parse(const std::string& policy) {
+  ThreadPolicy result;
+  std::stringstream stream(policy);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    size_t separator = field.find('=');
+    if (separator == std::string::npos) {
+      return std::nullopt;
+    }
+    std::string key = field.substr(0, separator);
+    std::string value = field.substr(separator + 1);
+    if (key == "cpus") {
+      if (!ParseCpuMask(value, &result.cpu_mask)) {
+        return std::nullopt;
+      }
+    } else if (key == "class") {
+      if (!ParsePriorityClass(value, &result.priority_class)) {
+        return std::nullopt;
+      }
+    } else if (key == "cgroup") {
+      if (value.empty() || value[0] != '/') {
+        return std::nullopt;
+      }
+      result.cgroup = value;
+    } else {
+      return std::nullopt;
+    }
+  }
+  return result;
+}
+
+std::optional<ThreadPolicy> ThreadPolicy::ForThread(
+    const std::string& thread_name) {
+  for (const ThreadRole& role : kThreadRoles) {
+    if (thread_name != role.thread_name) {
+      continue;
+    }
+    std::optional<std::string> policy = role.policy();
+    if (!policy.has_value() || policy->empty()) {
+      return std::nullopt;
+    }
+    std::optional<ThreadPolicy> result = Parse(*policy);
+    if (!result.has_value()) {
+      log::error("ignoring the malformed policy \"{}\" of thread {}", *policy,
+                 thread_name);
+    }
+    return result;
+  }
+  return std::nullopt;
+}
+
+bool ApplyThreadPolicy(const std::string& thread_name) {
+  std::optional<ThreadPolicy> policy = ThreadPolicy::ForThread(thread_name);
+  if (!policy.has_value()) {
+    return true;
+  }
+
+  auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
+  bool applied = true;
+  if (policy->cpu_mask != 0 && !SetCpuAffinity(policy->cpu_mask)) {
+    log::warn("unable to bind thread {} to the CPU mask 0x{:x}: {}",
+              thread_name, policy->cpu_mask, strerror(errno));
+    applied = false;
+  }
+  if (!SetPriorityClass(linux_tid, policy->priority_class)) {
+    log::warn("unable to set the priority class of thread {}: {}", thread_name,
+              strerror(errno));
+    applied = false;
+  }
+  if (!policy->cgroup.empty() && !JoinCgroup(linux_tid, policy->cgroup)) {
+    log::warn("unable to move thread {} to cgroup {}: {}", thread_name,
+              policy->cgroup, strerror(errno));
+    applied = false;
+  }
+  if (applied) {
+    log::info("applied the scheduling policy of thread {}", thread_name);
+  }
+  return applied;
+}
+
+}  // namespace common
+
+}  // namespace bluetooth
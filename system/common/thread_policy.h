@@ -0,0 +1,78 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * Where and how a stack thread is scheduled: the CPUs it may run on, its
+ * priority class and the cgroup it joins. Policies are configured per thread
+ * role through the bluetooth.thread.<role>.policy system properties, see
+ * sysprop/thread.sysprop, and applied by the thread itself when it starts.
+ */
+struct ThreadPolicy {
+  enum class PriorityClass {
+    // Keep the priority that the thread was created with
+    kUnchanged,
+    // SCHED_OTHER at the default nice value
+    kNormal,
+    // SCHED_OTHER at the nice value of the audio threads
+    kHigh,
+    // SCHED_FIFO at the lowest real time priority
+    kRealTime,
+  };
+
+  // Bit N stands for CPU N, 0 keeps the inherited affinity
+  uint64_t cpu_mask = 0;
+  PriorityClass priority_class = PriorityClass::kUnchanged;
+  // cgroup directory to join, empty to stay in the inherited cgroup
+  std::string cgroup;
+
+  /**
+   * Parse a policy such as "cpus=0xf0,class=rt,cgroup=/dev/cpuset/top-app".
+   * All the fields are optional.
+   *
+   * @return the policy, or std::nullopt when |policy| is malformed
+   */
+  static std::optional<ThreadPolicy> Parse(const std::string& policy);
+
+  /**
+   * Get the policy configured for the thread named |thread_name|
+   *
+   * @return the policy, or std::nullopt when none is configured or the
+   * configured one is malformed
+   */
+  static std::optional<ThreadPolicy> ForThread(const std::string& thread_name);
+};
+
+/**
+ * Apply the policy configured for |thread_name| to the calling thread, if
+ * any. Called by the stack threads when they start.
+ *
+ * @return false if part of the policy could not be applied
+ */
+bool ApplyThreadPolicy(const std::string& thread_name);
+
+}  // namespace common
+
+}  // namespace bluetooth
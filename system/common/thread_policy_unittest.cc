@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/thread_policy.h"
+
+#include <gtest/gtest.h>
+
+using bluetooth::common::ApplyThreadPolicy;
+using bluetooth::common::ThreadPolicy;
+
+TEST(ThreadPolicyTest, ParsesAllFields) {
+  std::optional<ThreadPolicy> policy =
+      ThreadPolicy::Parse("cpus=0xf0,class=rt,cgroup=/dev/cpuset/top-app");
+  ASSERT_TRUE(policy.has_value());
+  EXPECT_EQ(policy->cpu_mask, 0xf0u);
+  EXPECT_EQ(policy->priority_class, ThreadPolicy::PriorityClass::kRealTime);
+  EXPECT_EQ(policy->cgroup, "/dev/cpuset/top-app");
+}
+
+TEST(ThreadPolicyTest, FieldsAreOptional) {
+  std::optional<ThreadPolicy> policy = ThreadPolicy::Parse("class=high");
+  ASSERT_TRUE(policy.has_value());
+  EXPECT_EQ(policy->cpu_mask, 0u);
+  EXPECT_EQ(policy->priority_class, ThreadPolicy::PriorityClass::kHigh);
+  EXPECT_TRUE(policy->cgroup.empty());
+
+  policy = ThreadPolicy::Parse("cpus=12");
+  ASSERT_TRUE(policy.has_value());
+  EXPECT_EQ(policy->cpu_mask, 12u);
+  EXPECT_EQ(policy->priority_class, ThreadPolicy::PriorityClass::kUnchanged);
+}
+
+TEST(ThreadPolicyTest, RejectsMalformedPolicies) {
+  EXPECT_FALSE(ThreadPolicy::Parse("cpus").has_value());
+  EXPECT_FALSE(ThreadPolicy::Parse("cpus=0").has_value());
+  EXPECT_FALSE(ThreadPolicy::Parse("cpus=-1").has_value());
+  EXPECT_FALSE(ThreadPolicy::Parse("cpus=0xfg").has_value());
+  EXPECT_FALSE(ThreadPolicy::Parse("class=idle").has_value());
+  EXPECT_FALSE(ThreadPolicy::Parse("cgroup=top-app").has_value());
+  EXPECT_FALSE(ThreadPolicy::Parse("cpus=0xf0,nice=-10").has_value());
+}
+
+TEST(ThreadPolicyTest, UnknownThreadsHaveNoPolicy) {
+  EXPECT_FALSE(ThreadPolicy::ForThread("test_thread").has_value());
+  EXPECT_TRUE(ApplyThreadPolicy("test_thread"));
+}
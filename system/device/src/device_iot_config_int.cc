@@ -48,6 +48,10 @@ extern std::mutex config_lock;  // protects operations on |config|.
 extern std::unique_ptr<config_t> config;
 extern alarm_t* config_timer;
 
+// Serializes the writes of the config file, which happen without holding
+// |config_lock| so that the counter updates do not wait for the file system.
+static std::mutex config_file_lock;
+
 using namespace bluetooth;
 
 static void cleanup() {
@@ -194,16 +198,22 @@ void device_iot_config_write(uint16_t event, UNUSED_ATTR char* p_param) {
   log::assert_that(config_timer != NULL, "assert failed: config_timer != NULL");
 
   log::info("evt={}", event);
-  std::unique_lock<std::mutex> lock(config_lock);
-  if (event == IOT_CONFIG_SAVE_TIMER_FIRED_EVT) {
-    device_iot_config_set_modified_time();
+  std::unique_lock<std::mutex> file_lock(config_file_lock);
+  config_t snapshot;
+  {
+    std::unique_lock<std::mutex> lock(config_lock);
+    if (event == IOT_CONFIG_SAVE_TIMER_FIRED_EVT) {
+      device_iot_config_set_modified_time();
+    }
+
+    device_iot_config_restrict_device_num(*config);
+    device_iot_config_sections_sort_by_entry_key(*config,
+                                                 device_iot_config_compare_key);
+    snapshot = *config;
   }
 
   rename(IOT_CONFIG_FILE_PATH, IOT_CONFIG_BACKUP_PATH);
-  device_iot_config_restrict_device_num(*config);
-  device_iot_config_sections_sort_by_entry_key(*config,
-                                               device_iot_config_compare_key);
-  config_save(*config, IOT_CONFIG_FILE_PATH);
+  config_save(snapshot, IOT_CONFIG_FILE_PATH);
 }
 
 void device_iot_config_sections_sort_by_entry_key(config_t& config,
@@ -232,6 +242,11 @@ void device_iot_config_save_async(void) {
   log::assert_that(config != NULL, "assert failed: config != NULL");
   log::assert_that(config_timer != NULL, "assert failed: config_timer != NULL");
 
+  // Changes made while a save is scheduled are written by that save, rather
+  // than pushing it back: a busy link would otherwise keep rearming the timer
+  // with each counter update and never get its counters saved.
+  if (alarm_is_scheduled(config_timer)) return;
+
   log::verbose("");
   alarm_set(config_timer, CONFIG_SETTLE_PERIOD_MS,
             device_iot_config_timer_save_cb, NULL);
@@ -34,7 +34,9 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "btcore/include/module.h"
 #include "btif/include/btif_storage.h"
@@ -190,6 +192,12 @@ template <>
 struct formatter<interop_bl_type> : enum_formatter<interop_bl_type> {};
 }  // namespace fmt
 
+// The entries of |interop_list| grouped by feature and type, in list order.
+// A lookup only compares the few entries it can match instead of walking
+// the entries of every feature. Protected by |interop_list_lock|.
+static std::unordered_map<uint32_t, std::vector<interop_db_entry_t*>>
+    interop_index;
+
 static const char* interop_feature_string_(const interop_feature_t feature);
 static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
@@ -309,6 +317,7 @@ static future_t* interop_init(void) {
 
 static future_t* interop_clean_up(void) {
   pthread_mutex_lock(&interop_list_lock);
+  interop_index.clear();
   list_free(interop_list);
   interop_list = NULL;
   interop_is_initialized = false;
@@ -402,6 +411,58 @@ static const char* interop_feature_string_(const interop_feature_t feature) {
   return UNKNOWN_INTEROP_FEATURE;
 }
 
+static uint32_t interop_index_key_(const interop_db_entry_t* entry) {
+  interop_feature_t feature = END_OF_INTEROP_LIST;
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR:
+      feature = entry->entry_type.addr_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_NAME:
+      feature = entry->entry_type.name_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_MANUFACTURE:
+      feature = entry->entry_type.mnfr_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_VNDR_PRDT:
+      feature = entry->entry_type.vnr_pdt_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_SSR_MAX_LAT:
+      feature = entry->entry_type.ssr_max_lat_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_VERSION:
+      feature = entry->entry_type.version_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_LMP_VERSION:
+      feature = entry->entry_type.lmp_version_entry.feature;
+      break;
+    case INTEROP_BL_TYPE_ADDR_RANGE:
+      feature = entry->entry_type.addr_range_entry.feature;
+      break;
+  }
+  return ((uint32_t)feature << 8) | (uint32_t)entry->bl_type;
+}
+
+// Must be called with |interop_list_lock| held.
+static void interop_index_add_(interop_db_entry_t* entry) {
+  interop_index[interop_index_key_(entry)].push_back(entry);
+}
+
+// Must be called with |interop_list_lock| held, before |entry| is removed
+// from |interop_list|.
+static void interop_index_remove_(interop_db_entry_t* entry) {
+  auto it = interop_index.find(interop_index_key_(entry));
+  if (it == interop_index.end()) return;
+
+  std::vector<interop_db_entry_t*>& entries = it->second;
+  for (auto entry_it = entries.begin(); entry_it != entries.end(); ++entry_it) {
+    if (*entry_it == entry) {
+      entries.erase(entry_it);
+      break;
+    }
+  }
+  if (entries.empty()) interop_index.erase(it);
+}
+
 static void interop_free_entry_(void* data) {
   interop_db_entry_t* entry = (interop_db_entry_t*)data;
   osi_free(entry);
@@ -641,6 +702,7 @@ static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
 
   if (interop_list) {
     list_append(interop_list, db_entry);
+    interop_index_add_(db_entry);
   }
 
   pthread_mutex_unlock(&interop_list_lock);
@@ -664,21 +726,18 @@ static bool interop_database_match(interop_db_entry_t* entry,
     return false;
   }
 
-  const list_node_t* node = list_begin(interop_list);
+  const auto index_it = interop_index.find(interop_index_key_(entry));
+  if (index_it == interop_index.end()) {
+    pthread_mutex_unlock(&interop_list_lock);
+    return false;
+  }
 
-  while (node != list_end(interop_list)) {
-    interop_db_entry_t* db_entry = (interop_db_entry_t*)list_node(node);
+  for (interop_db_entry_t* db_entry : index_it->second) {
     log::assert_that(db_entry != nullptr, "assert failed: db_entry != nullptr");
 
-    if (entry->bl_type != db_entry->bl_type) {
-      node = list_next(node);
-      continue;
-    }
-
     if ((entry_type == INTEROP_ENTRY_TYPE_STATIC) ||
         (entry_type == INTEROP_ENTRY_TYPE_DYNAMIC)) {
       if (entry->bl_entry_type != db_entry->bl_entry_type) {
-        node = list_next(node);
         continue;
       }
     }
@@ -780,7 +839,6 @@ static bool interop_database_match(interop_db_entry_t* entry,
       *ret_entry = db_entry;
       break;
     }
-    node = list_next(node);
   }
   pthread_mutex_unlock(&interop_list_lock);
   return found;
@@ -798,6 +856,7 @@ static bool interop_database_remove_(interop_db_entry_t* entry) {
 
   // first remove it from linked list
   pthread_mutex_lock(&interop_list_lock);
+  interop_index_remove_(ret_entry);
   list_remove(interop_list, (void*)ret_entry);
   pthread_mutex_unlock(&interop_list_lock);
 
@@ -1588,6 +1647,7 @@ bool interop_database_remove_feature(const interop_feature_t feature) {
 
     if (entry_match) {
       pthread_mutex_lock(&interop_list_lock);
+      interop_index_remove_(entry);
       list_remove(interop_list, (void*)entry);
       pthread_mutex_unlock(&interop_list_lock);
     }
@@ -2997,6 +2997,20 @@ TEST_F_WITH_FLAGS(
 
     EXPECT_EQ(get_func_call_count("alarm_set"), 1);
   }
+
+  test::mock::osi_alarm::alarm_is_scheduled.body =
+      [&](const alarm_t* alarm) -> bool { return true; };
+
+  {
+    reset_mock_function_count_map();
+
+    // The save already scheduled writes the change, it is not pushed back
+    device_iot_config_save_async();
+
+    EXPECT_EQ(get_func_call_count("alarm_set"), 0);
+  }
+
+  test::mock::osi_alarm::alarm_is_scheduled.body = {};
 }
 
 TEST_F_WITH_FLAGS(
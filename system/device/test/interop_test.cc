@@ -683,6 +683,40 @@ TEST_F(InteropTest, test_dynamic_addr) {
   module_clean_up(&interop_module);
 }
 
+TEST_F(InteropTest, test_dynamic_addr_per_feature) {
+  module_init(&interop_module);
+
+  RawAddress test_address;
+
+  RawAddress::FromString("11:22:33:44:55:66", test_address);
+  interop_database_add_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                            &test_address, 3);
+  interop_database_add_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address, 3);
+  EXPECT_TRUE(
+      interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, &test_address));
+  EXPECT_TRUE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+
+  // Removing the entry of one feature keeps the other one
+  interop_database_remove_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                               &test_address);
+  EXPECT_FALSE(
+      interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, &test_address));
+  EXPECT_TRUE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+
+  // An entry added again after its removal is found again
+  interop_database_add_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                            &test_address, 3);
+  EXPECT_TRUE(
+      interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, &test_address));
+
+  interop_database_clear();
+  EXPECT_FALSE(
+      interop_match_addr(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, &test_address));
+  EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+
+  module_clean_up(&interop_module);
+}
+
 TEST_F(InteropTest, test_dynamic_name) {
   module_init(&interop_module);
 
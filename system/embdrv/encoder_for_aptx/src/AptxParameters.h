@@ -43,6 +43,12 @@
 #define _STDQMFOUTERCOEFF 1
 #endif
 
+/* Use the NEON versions of the QMF convolutions and of the LL quantiser
+ * search. They give the same codes as the C code. */
+#if defined(__ARM_NEON) && !defined(APTX_DISABLE_NEON)
+#define APTX_USE_NEON
+#endif
+
 /* Signed saturate to a 24bit value */
 XBT_INLINE_ int32_t ssat24(int32_t val) {
   if (val > 8388607) {
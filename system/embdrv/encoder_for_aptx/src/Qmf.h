@@ -77,6 +77,18 @@ void AsmQmfConvI(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
 void AsmQmfConvO(const int16_t* p1dl_buffPtr, const int16_t* p2dl_buffPtr,
                  const int32_t* coeffPtr, int32_t* convSumDiff);
 
+#ifdef APTX_USE_NEON
+void AsmQmfConvI_neon(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
+                      const int32_t* coeffPtr, int32_t* filterOutputs);
+void AsmQmfConvO_neon(const int16_t* p1dl_buffPtr, const int16_t* p2dl_buffPtr,
+                      const int32_t* coeffPtr, int32_t* convSumDiff);
+#define QmfConvI AsmQmfConvI_neon
+#define QmfConvO AsmQmfConvO_neon
+#else
+#define QmfConvI AsmQmfConvI
+#define QmfConvO AsmQmfConvO
+#endif
+
 XBT_INLINE_ void QmfAnalysisFilter(const int32_t pcm[4], Qmf_storage* Qmf_St,
                                    const int32_t predVals[4],
                                    int32_t* aqmfOutputs) {
@@ -98,8 +110,8 @@ XBT_INLINE_ void QmfAnalysisFilter(const int32_t pcm[4], Qmf_storage* Qmf_St,
   Qmf_St->QmfH_buf[lc_QmfO_pt++] = (int16_t)pcm[SecondPcm];
   lc_QmfO_pt &= 0xF;
 
-  AsmQmfConvO(&Qmf_St->QmfL_buf[lc_QmfO_pt + 15], &Qmf_St->QmfH_buf[lc_QmfO_pt],
-              Qmf_outerCoeffs, &convSumDiff[0]);
+  QmfConvO(&Qmf_St->QmfL_buf[lc_QmfO_pt + 15], &Qmf_St->QmfH_buf[lc_QmfO_pt],
+           Qmf_outerCoeffs, &convSumDiff[0]);
 
   /* Load outer filter phase1 and phase2 delay lines with the second 2 PCM
    * samples. Convolve the filter and get the 2 convolution results. */
@@ -109,8 +121,8 @@ XBT_INLINE_ void QmfAnalysisFilter(const int32_t pcm[4], Qmf_storage* Qmf_St,
   Qmf_St->QmfH_buf[lc_QmfO_pt++] = (int16_t)pcm[FourthPcm];
   lc_QmfO_pt &= 0xF;
 
-  AsmQmfConvO(&Qmf_St->QmfL_buf[lc_QmfO_pt + 15], &Qmf_St->QmfH_buf[lc_QmfO_pt],
-              Qmf_outerCoeffs, &convSumDiff[1]);
+  QmfConvO(&Qmf_St->QmfL_buf[lc_QmfO_pt + 15], &Qmf_St->QmfH_buf[lc_QmfO_pt],
+           Qmf_outerCoeffs, &convSumDiff[1]);
 
   /* Load the first inner filter phase1 and phase2 delay lines with the 2
    * convolution sum (low-pass) outer filter outputs. Convolve the filter and
@@ -121,9 +133,9 @@ XBT_INLINE_ void QmfAnalysisFilter(const int32_t pcm[4], Qmf_storage* Qmf_St,
   Qmf_St->QmfLH_buf[lc_QmfI_pt + 16] = convSumDiff[1];
   Qmf_St->QmfLH_buf[lc_QmfI_pt] = convSumDiff[1];
 
-  AsmQmfConvI(&Qmf_St->QmfLL_buf[lc_QmfI_pt + 16],
-              &Qmf_St->QmfLH_buf[lc_QmfI_pt + 1], &Qmf_innerCoeffs[0],
-              &filterOutputs[LL]);
+  QmfConvI(&Qmf_St->QmfLL_buf[lc_QmfI_pt + 16],
+           &Qmf_St->QmfLH_buf[lc_QmfI_pt + 1], &Qmf_innerCoeffs[0],
+           &filterOutputs[LL]);
 
   /* Load the second inner filter phase1 and phase2 delay lines with the 2
    * convolution difference (high-pass) outer filter outputs. Convolve the
@@ -136,9 +148,8 @@ XBT_INLINE_ void QmfAnalysisFilter(const int32_t pcm[4], Qmf_storage* Qmf_St,
   Qmf_St->QmfHH_buf[lc_QmfI_pt++] = convSumDiff[3];
   lc_QmfI_pt &= 0xF;
 
-  AsmQmfConvI(&Qmf_St->QmfHL_buf[lc_QmfI_pt + 15],
-              &Qmf_St->QmfHH_buf[lc_QmfI_pt], &Qmf_innerCoeffs[0],
-              &filterOutputs[HL]);
+  QmfConvI(&Qmf_St->QmfHL_buf[lc_QmfI_pt + 15], &Qmf_St->QmfHH_buf[lc_QmfI_pt],
+           &Qmf_innerCoeffs[0], &filterOutputs[HL]);
 
   /* Subtracted the previous predicted value from the filter output on a
    * per-subband basis. Ensure these values are saturated, if necessary.
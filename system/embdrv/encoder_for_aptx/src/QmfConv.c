@@ -358,3 +358,91 @@ void AsmQmfConvI(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
 
   *(filterOutputs + 1) = convDiff;
 }
+
+#ifdef APTX_USE_NEON
+
+#include <arm_neon.h>
+
+/* Reverse the 4 lanes of a vector */
+static inline int32x4_t QmfReverse(int32x4_t v) {
+  return vcombine_s32(vrev64_s32(vget_high_s32(v)),
+                      vrev64_s32(vget_low_s32(v)));
+}
+
+static inline int64x2_t QmfMac4(int64x2_t acc, int32x4_t coeffs,
+                                int32x4_t data) {
+  acc = vmlal_s32(acc, vget_low_s32(coeffs), vget_low_s32(data));
+  return vmlal_s32(acc, vget_high_s32(coeffs), vget_high_s32(data));
+}
+
+static inline int64_t QmfSum(int64x2_t acc) {
+  return vgetq_lane_s64(acc, 0) + vgetq_lane_s64(acc, 1);
+}
+
+/* Same rounding of the 64-bit accumulators as AsmQmfConvO() */
+static inline int32_t QmfRoundO(int64_t local_acc) {
+  int32_t tmp_round0 = (int32_t)local_acc & 0x00FFFFL;
+  int32_t acc = (int32_t)((local_acc + 0x004000L) >> 15);
+  if (tmp_round0 == 0x004000L) {
+    acc--;
+  }
+  return ssat24(acc);
+}
+
+/* Same rounding of the 64-bit accumulators as AsmQmfConvI() */
+static inline int32_t QmfRoundI(int64_t local_acc) {
+  uint32_t tmp_round0 = (uint32_t)local_acc;
+  int32_t acc = (int32_t)((local_acc + 0x00400000L) >> 23);
+  if ((tmp_round0 << 8) == 0x40000000) {
+    acc--;
+  }
+  return ssat24(acc);
+}
+
+/* NEON version of AsmQmfConvO(). The 16 taps are accumulated in 64 bits like
+ * the C code, so the outputs are the same. The first delay line is read
+ * backwards, the coefficients are reversed to load it in increasing order. */
+void AsmQmfConvO_neon(const int16_t* p1dl_buffPtr, const int16_t* p2dl_buffPtr,
+                      const int32_t* coeffPtr, int32_t* convSumDiff) {
+  int64x2_t acc0 = vdupq_n_s64(0);
+  int64x2_t acc1 = vdupq_n_s64(0);
+  int32_t phaseConv[2];
+
+  for (int i = 0; i < 16; i += 4) {
+    int32x4_t coeffs = vld1q_s32(coeffPtr + i);
+    int32x4_t data1 = vmovl_s16(vld1_s16(p1dl_buffPtr - 15 + i));
+    int32x4_t data2 = vmovl_s16(vld1_s16(p2dl_buffPtr + i));
+    acc0 = QmfMac4(acc0, QmfReverse(vld1q_s32(coeffPtr + 12 - i)), data1);
+    acc1 = QmfMac4(acc1, coeffs, data2);
+  }
+
+  phaseConv[0] = QmfRoundO(QmfSum(acc0));
+  phaseConv[1] = QmfRoundO(QmfSum(acc1));
+
+  *(convSumDiff) = ssat24(phaseConv[1] + phaseConv[0]);
+  *(convSumDiff + 2) = ssat24(phaseConv[1] - phaseConv[0]);
+}
+
+/* NEON version of AsmQmfConvI() */
+void AsmQmfConvI_neon(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
+                      const int32_t* coeffPtr, int32_t* filterOutputs) {
+  int64x2_t acc0 = vdupq_n_s64(0);
+  int64x2_t acc1 = vdupq_n_s64(0);
+  int32_t phaseConv[2];
+
+  for (int i = 0; i < 16; i += 4) {
+    int32x4_t coeffs = vld1q_s32(coeffPtr + i);
+    int32x4_t data1 = vld1q_s32(p1dl_buffPtr - 15 + i);
+    int32x4_t data2 = vld1q_s32(p2dl_buffPtr + i);
+    acc0 = QmfMac4(acc0, QmfReverse(vld1q_s32(coeffPtr + 12 - i)), data1);
+    acc1 = QmfMac4(acc1, coeffs, data2);
+  }
+
+  phaseConv[0] = QmfRoundI(QmfSum(acc0));
+  phaseConv[1] = QmfRoundI(QmfSum(acc1));
+
+  *(filterOutputs) = ssat24(phaseConv[1] + phaseConv[0]);
+  *(filterOutputs + 1) = ssat24(phaseConv[1] - phaseConv[0]);
+}
+
+#endif  // APTX_USE_NEON
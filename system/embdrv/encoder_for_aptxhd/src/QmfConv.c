@@ -365,3 +365,77 @@ void AsmQmfConvI_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
 
   *(filterOutputs + 1) = convDiff;
 }
+
+#ifdef APTX_USE_NEON
+
+#include <arm_neon.h>
+
+/* Reverse the 4 lanes of a vector */
+static inline int32x4_t QmfReverse(int32x4_t v) {
+  return vcombine_s32(vrev64_s32(vget_high_s32(v)),
+                      vrev64_s32(vget_low_s32(v)));
+}
+
+static inline int64x2_t QmfMac4(int64x2_t acc, int32x4_t coeffs,
+                                int32x4_t data) {
+  acc = vmlal_s32(acc, vget_low_s32(coeffs), vget_low_s32(data));
+  return vmlal_s32(acc, vget_high_s32(coeffs), vget_high_s32(data));
+}
+
+/* Same rounding of the 64-bit accumulators as the C convolutions */
+static inline int32_t QmfRound(int64x2_t local_acc) {
+  int64_t sum = vgetq_lane_s64(local_acc, 0) + vgetq_lane_s64(local_acc, 1);
+  uint32_t tmp_round0 = (uint32_t)sum;
+  int32_t acc = (int32_t)((sum + 0x00400000L) >> 23);
+  if ((tmp_round0 << 8) == 0x40000000) {
+    acc--;
+  }
+  return ssat24(acc);
+}
+
+/* Convolve the two delay lines with the 16 coefficients and round the two
+ * results. The taps are accumulated in 64 bits like the C code, so the results
+ * are the same. The first delay line is read backwards, the coefficients are
+ * reversed to load it in increasing order. */
+static inline void QmfConv_neon(const int32_t* p1dl_buffPtr,
+                                const int32_t* p2dl_buffPtr,
+                                const int32_t* coeffPtr,
+                                int32_t phaseConv[2]) {
+  int64x2_t acc0 = vdupq_n_s64(0);
+  int64x2_t acc1 = vdupq_n_s64(0);
+
+  for (int i = 0; i < 16; i += 4) {
+    int32x4_t coeffs = vld1q_s32(coeffPtr + i);
+    int32x4_t data1 = vld1q_s32(p1dl_buffPtr - 15 + i);
+    int32x4_t data2 = vld1q_s32(p2dl_buffPtr + i);
+    acc0 = QmfMac4(acc0, QmfReverse(vld1q_s32(coeffPtr + 12 - i)), data1);
+    acc1 = QmfMac4(acc1, coeffs, data2);
+  }
+
+  phaseConv[0] = QmfRound(acc0);
+  phaseConv[1] = QmfRound(acc1);
+}
+
+/* NEON version of AsmQmfConvO_HD() */
+void AsmQmfConvO_HD_neon(const int32_t* p1dl_buffPtr,
+                         const int32_t* p2dl_buffPtr, const int32_t* coeffPtr,
+                         int32_t* convSumDiff) {
+  int32_t phaseConv[2];
+
+  QmfConv_neon(p1dl_buffPtr, p2dl_buffPtr, coeffPtr, phaseConv);
+  *(convSumDiff) = ssat24(phaseConv[1] + phaseConv[0]);
+  *(convSumDiff + 2) = ssat24(phaseConv[1] - phaseConv[0]);
+}
+
+/* NEON version of AsmQmfConvI_HD() */
+void AsmQmfConvI_HD_neon(const int32_t* p1dl_buffPtr,
+                         const int32_t* p2dl_buffPtr, const int32_t* coeffPtr,
+                         int32_t* filterOutputs) {
+  int32_t phaseConv[2];
+
+  QmfConv_neon(p1dl_buffPtr, p2dl_buffPtr, coeffPtr, phaseConv);
+  *(filterOutputs) = ssat24(phaseConv[1] + phaseConv[0]);
+  *(filterOutputs + 1) = ssat24(phaseConv[1] - phaseConv[0]);
+}
+
+#endif  // APTX_USE_NEON
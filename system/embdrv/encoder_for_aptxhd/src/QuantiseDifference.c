@@ -16,6 +16,67 @@
 
 #include "Quantiser.h"
 
+#ifdef APTX_USE_NEON
+
+#include <arm_neon.h>
+
+/* Count the thresholds among the first |num| ones of |thresholds| for which
+ * the test of the binary searches holds, |num| being at most 16. The lanes are
+ * computed like the scalar test, up to 3 entries past |num| are read but not
+ * counted. */
+static inline int32_t BsearchCount_neon(const int32_t absDiffSignalShifted,
+                                        const int32_t lc_delta,
+                                        const int32_t* thresholds,
+                                        const int32_t num) {
+  static const int32_t lanes[4] = {0, 1, 2, 3};
+  const int32x2_t delta2 = vdup_n_s32(lc_delta);
+  const int32x4_t absDiff = vdupq_n_s32(absDiffSignalShifted);
+  int32x4_t index = vld1q_s32(lanes);
+  int32x4_t count = vdupq_n_s32(0);
+
+  for (int32_t i = 0; i < num; i += 4) {
+    int32x4_t t = vld1q_s32(thresholds + i);
+    int64x2_t lo = vmull_s32(vget_low_s32(t), delta2);
+    int64x2_t hi = vmull_s32(vget_high_s32(t), delta2);
+    int32x4_t h = vcombine_s32(vshrn_n_s64(lo, 32), vshrn_n_s64(hi, 32));
+    uint32x4_t l = vcombine_u32(vmovn_u64(vreinterpretq_u64_s64(lo)),
+                                vmovn_u64(vreinterpretq_u64_s64(hi)));
+    int32x4_t tmp = vorrq_s32(vsubq_s32(h, absDiff),
+                              vreinterpretq_s32_u32(vshrq_n_u32(l, 1)));
+    uint32x4_t hit = vandq_u32(vcleq_s32(tmp, vdupq_n_s32(0)),
+                               vcltq_s32(index, vdupq_n_s32(num)));
+    /* The lanes that hit are all ones, i.e. -1 */
+    count = vsubq_s32(count, vreinterpretq_s32_u32(hit));
+    index = vaddq_s32(index, vdupq_n_s32(4));
+  }
+
+  int32x2_t sum = vpadd_s32(vget_low_s32(count), vget_high_s32(count));
+  return vget_lane_s32(sum, 0) + vget_lane_s32(sum, 1);
+}
+
+/* NEON version of the BsearchLL() below. The thresholds increase with the
+ * index, so the code found by the binary search is the number of thresholds
+ * from index 1 for which the test holds. They are counted every 16 thresholds
+ * first, then within the 16 thresholds that follow. */
+static inline int32_t BsearchLL_neon(const int32_t absDiffSignalShifted,
+                                     const int32_t delta,
+                                     const int32_t* dqbitTablePrt) {
+  int32_t coarse[16] = {0};
+  int32_t lc_delta = delta << 8;
+  int32_t qCode;
+
+  for (int32_t i = 0; i < 15; i++) {
+    coarse[i] = dqbitTablePrt[(i + 1) * 16];
+  }
+  qCode = 16 * BsearchCount_neon(absDiffSignalShifted, lc_delta, coarse, 15);
+  qCode += BsearchCount_neon(absDiffSignalShifted, lc_delta,
+                             dqbitTablePrt + qCode + 1, 15);
+
+  return (qCode);
+}
+
+#else
+
 XBT_INLINE_ int32_t BsearchLL(const int32_t absDiffSignalShifted,
                               const int32_t delta,
                               const int32_t* dqbitTablePrt) {
@@ -82,6 +143,8 @@ XBT_INLINE_ int32_t BsearchLL(const int32_t absDiffSignalShifted,
   return (qCode);
 }
 
+#endif  // APTX_USE_NEON
+
 XBT_INLINE_ int32_t BsearchHL(const int32_t absDiffSignalShifted,
                               const int32_t delta,
                               const int32_t* dqbitTablePrt) {
@@ -493,8 +556,13 @@ void quantiseDifference_HDLL(const int32_t diffSignal, const int32_t ditherVal,
    * table index of the LARGEST threshold table value for which
    * absDiffSignalShifted >= (delta * threshold)
    */
+#ifdef APTX_USE_NEON
+  index = BsearchLL_neon(absDiffSignalShifted, delta,
+                         qdata_pt->thresholdTablePtr_sl1);
+#else
   index =
       BsearchLL(absDiffSignalShifted, delta, qdata_pt->thresholdTablePtr_sl1);
+#endif
 
   /* We actually wanted the SMALLEST magnitude quantised code for which
    * absDiffSignalShifted < (delta * threshold)
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// The bit rate picked by the A2DP source for EDR peers
+constexpr uint16_t kBitRateKbps = 328;
+constexpr int kSecondsOfAudio = 1;
+// Same sizes as the A2DP sink decoder
+constexpr size_t kMaxFrameSize = 512;
+constexpr size_t kMaxPcmSamples = 2 * 16 * 8;
+
+// Build the stream received by an A2DP sink from an SBC source: one second of
+// a tone with some noise on each channel, so that all the subbands carry
+// signal.
+std::vector<uint8_t> EncodeStream(int16_t channel_mode, int16_t num_subbands,
+                                  int16_t num_blocks) {
+  SBC_ENC_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = channel_mode;
+  params.s16NumOfSubBands = num_subbands;
+  params.s16NumOfBlocks = num_blocks;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = kBitRateKbps;
+  params.Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(&params);
+
+  const int num_channels = params.s16NumOfChannels;
+  const int frame_samples = num_subbands * num_blocks;
+  const int num_frames = 44100 * kSecondsOfAudio / frame_samples;
+  std::vector<int16_t> pcm(frame_samples * num_channels);
+  std::vector<uint8_t> stream;
+  uint8_t frame[kMaxFrameSize];
+  uint32_t noise = 1;
+  int t = 0;
+
+  for (int f = 0; f < num_frames; f++) {
+    for (int i = 0; i < frame_samples; i++, t++) {
+      for (int ch = 0; ch < num_channels; ch++) {
+        noise = noise * 1103515245 + 12345;
+        double tone = 16000 * sin(2 * M_PI * (440 + 220 * ch) * t / 44100);
+        pcm[i * num_channels + ch] = static_cast<int16_t>(
+            tone + static_cast<int16_t>(noise >> 16) / 8);
+      }
+    }
+    uint32_t length = SBC_Encode(&params, pcm.data(), frame);
+    stream.insert(stream.end(), frame, frame + length);
+  }
+  return stream;
+}
+
+// Decode the stream frame by frame like the A2DP sink does for each media
+// packet.
+void DecodeSbc(State& state, int16_t channel_mode, int16_t num_subbands,
+               int16_t num_blocks) {
+  const std::vector<uint8_t> stream =
+      EncodeStream(channel_mode, num_subbands, num_blocks);
+  static uint32_t
+      context_data[CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS)];
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  int16_t pcm[kMaxPcmSamples];
+  int64_t num_frames = 0;
+
+  for (auto _ : state) {
+    OI_CODEC_SBC_DecoderReset(&context, context_data, sizeof(context_data), 2,
+                              2, false);
+    const OI_BYTE* data = stream.data();
+    uint32_t length = stream.size();
+    while (length > 0) {
+      uint32_t pcm_bytes = sizeof(pcm);
+      if (OI_CODEC_SBC_DecodeFrame(&context, &data, &length, pcm,
+                                   &pcm_bytes) != OI_OK) {
+        state.SkipWithError("Unable to decode the stream");
+        return;
+      }
+      num_frames++;
+    }
+    ::benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(num_frames);
+  state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+}  // namespace
+
+static void BM_SbcDecodeJointStereo8Subbands(State& state) {
+  DecodeSbc(state, SBC_JOINT_STEREO, SUB_BANDS_8, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcDecodeJointStereo8Subbands);
+
+static void BM_SbcDecodeStereo8Subbands(State& state) {
+  DecodeSbc(state, SBC_STEREO, SUB_BANDS_8, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcDecodeStereo8Subbands);
+
+static void BM_SbcDecodeMono8Subbands(State& state) {
+  DecodeSbc(state, SBC_MONO, SUB_BANDS_8, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcDecodeMono8Subbands);
+
+static void BM_SbcDecodeJointStereo4Subbands(State& state) {
+  DecodeSbc(state, SBC_JOINT_STEREO, SUB_BANDS_4, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcDecodeJointStereo4Subbands);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
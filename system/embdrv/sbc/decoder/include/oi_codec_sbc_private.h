@@ -70,6 +70,12 @@ Function prototypes and macro definitions used internally by the codec.
 #define INLINE
 #endif
 
+/* Use the NEON versions of the synthesis window and of the dequantization. They
+ * give the same output as the C code. */
+#if defined(__ARM_NEON) && !defined(SBC_DISABLE_NEON)
+#define SBC_USE_NEON
+#endif
+
 #include "oi_assert.h"
 #include "oi_codec_sbc.h"
 
@@ -99,6 +105,16 @@ static const uint8_t band_values[] = {4, 8};
 #define TEST_MODE_SENTINEL "OINA"
 #define TEST_MODE_SENTINEL_LENGTH 4
 
+#ifdef SBC_USE_NEON
+/** Per frame constants of OI_SBC_DequantBlock(), for each channel and subband.
+ */
+typedef struct {
+  uint32_t scale[SBC_MAX_CHANNELS * SBC_MAX_BANDS];
+  uint32_t offset[SBC_MAX_CHANNELS * SBC_MAX_BANDS];
+  int32_t shift[SBC_MAX_CHANNELS * SBC_MAX_BANDS];
+} OI_SBC_DEQUANT_PARAMS;
+#endif
+
 /** Used internally. */
 typedef struct {
   union {
@@ -182,6 +198,14 @@ PRIVATE void cosineModulateSynth4(SBC_BUFFER_T* RESTRICT out,
                                   int32_t const* RESTRICT in);
 PRIVATE void SynthWindow40_int32_int32_symmetry_with_sum(
     int16_t* pcm, SBC_BUFFER_T buffer[80], OI_UINT strideShift);
+PRIVATE void SynthWindow80_generated(int16_t* pcm,
+                                     SBC_BUFFER_T const* RESTRICT buffer,
+                                     OI_UINT strideShift);
+#ifdef SBC_USE_NEON
+PRIVATE void SynthWindow80_neon(int16_t* pcm,
+                                SBC_BUFFER_T const* RESTRICT buffer,
+                                OI_UINT strideShift);
+#endif
 
 INLINE void dct3_4(int32_t* RESTRICT out, int32_t const* RESTRICT in);
 PRIVATE void analyze4_generated(SBC_BUFFER_T analysisBuffer[RESTRICT 40],
@@ -214,6 +238,13 @@ PRIVATE void OI_SBC_SynthFrame(OI_CODEC_SBC_DECODER_CONTEXT* context,
                                int16_t* pcm, OI_UINT start_block,
                                OI_UINT nrof_blocks);
 INLINE int32_t OI_SBC_Dequant(uint32_t raw, OI_UINT scale_factor, OI_UINT bits);
+#ifdef SBC_USE_NEON
+PRIVATE void OI_SBC_DequantPrepare(OI_CODEC_SBC_COMMON_CONTEXT const* common,
+                                   OI_SBC_DEQUANT_PARAMS* params);
+PRIVATE void OI_SBC_DequantBlock(int32_t* RESTRICT s,
+                                 OI_SBC_DEQUANT_PARAMS const* params,
+                                 OI_UINT count);
+#endif
 PRIVATE OI_BOOL OI_SBC_ExamineCommandPacket(
     OI_CODEC_SBC_DECODER_CONTEXT* context, const OI_BYTE* data, uint32_t len);
 PRIVATE void OI_SBC_GenerateTestSignal(int16_t pcmData[][2],
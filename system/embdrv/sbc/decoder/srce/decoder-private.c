@@ -184,6 +184,24 @@ PRIVATE void OI_SBC_ReadSamples(OI_CODEC_SBC_DECODER_CONTEXT* context,
   OI_UINT bitPtr = global_bs->bitPtr;
   const OI_UINT iter_count =
       common->frameInfo.nrof_channels * common->frameInfo.nrof_subbands;
+#ifdef SBC_USE_NEON
+  OI_SBC_DEQUANT_PARAMS params;
+
+  OI_SBC_DequantPrepare(common, &params);
+  do {
+    OI_UINT n;
+    for (n = 0; n < iter_count; ++n) {
+      uint32_t raw = 0;
+      OI_UINT bits = common->bits.uint8[n];
+      if (bits) {
+        OI_BITSTREAM_READUINT(raw, bits, ptr, value, bitPtr);
+      }
+      s[n] = raw;
+    }
+    OI_SBC_DequantBlock(s, &params, iter_count);
+    s += iter_count;
+  } while (--nrof_blocks);
+#else
   do {
     OI_UINT n;
     for (n = 0; n < iter_count; ++n) {
@@ -200,6 +218,7 @@ PRIVATE void OI_SBC_ReadSamples(OI_CODEC_SBC_DECODER_CONTEXT* context,
       *s++ = dequant;
     }
   } while (--nrof_blocks);
+#endif
 }
 
 /**
@@ -229,6 +229,57 @@ INLINE int32_t OI_SBC_Dequant(uint32_t raw, OI_UINT scale_factor,
   return result >> (15 - scale_factor);
 }
 
+#ifdef SBC_USE_NEON
+
+#include <arm_neon.h>
+
+/** Compute the constants of OI_SBC_Dequant() for each channel and subband of
+ * the current frame. */
+PRIVATE void OI_SBC_DequantPrepare(OI_CODEC_SBC_COMMON_CONTEXT const* common,
+                                   OI_SBC_DEQUANT_PARAMS* params) {
+  OI_UINT n = common->frameInfo.nrof_channels * common->frameInfo.nrof_subbands;
+  OI_UINT i;
+
+  for (i = 0; i < n; i++) {
+    OI_UINT bits = common->bits.uint8[i];
+    OI_INT sf = common->scale_factor[i];
+
+    OI_ASSERT(sf <= 15);
+    OI_ASSERT(bits <= 16);
+
+    if (bits <= 1) {
+      params->scale[i] = 0;
+      params->offset[i] = 0;
+    } else {
+      params->scale[i] = dequant_long_scaled[bits];
+      params->offset[i] = SBC_DEQUANT_LONG_SCALED_OFFSET;
+    }
+    /* vshlq_s32() shifts right for negative counts */
+    params->shift[i] = sf - 15;
+  }
+}
+
+/** Dequantize in place the |count| raw samples of one block, |count| being a
+ * multiple of 4. The result is the same as with OI_SBC_Dequant(). */
+PRIVATE void OI_SBC_DequantBlock(int32_t* RESTRICT s,
+                                 OI_SBC_DEQUANT_PARAMS const* params,
+                                 OI_UINT count) {
+  OI_UINT i;
+
+  OI_ASSERT((count & 3) == 0);
+
+  for (i = 0; i < count; i += 4) {
+    uint32x4_t d = vreinterpretq_u32_s32(vld1q_s32(s + i));
+    d = vorrq_u32(vshlq_n_u32(d, 1), vdupq_n_u32(1));
+    d = vmulq_u32(d, vld1q_u32(params->scale + i));
+    d = vsubq_u32(d, vld1q_u32(params->offset + i));
+    int32x4_t result = vreinterpretq_s32_u32(d);
+    vst1q_s32(s + i, vshlq_s32(result, vld1q_s32(params->shift + i)));
+  }
+}
+
+#endif /* SBC_USE_NEON */
+
 /* This version of Dequant does not incorporate the scaling factor of 1.38. It
  * is intended for use with implementations of the filterbank which are
  * hard-coded into a DSP. Output is Q16.4 format, so that after joint stereo
@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ @file
+
+ NEON version of SynthWindow80_generated() in synthesis-8-generated.c.
+
+ Every group of 16 values of the buffer contributes to output j through
+ buffer[4 + j] and buffer[12 - j] for j = 0..4, and outputs 5..7 use the
+ same values as outputs 3..1. Each lane of the vectors below computes one
+ output with the coefficients and shifts of the generated code, so the
+ result is bit exact.
+
+ @ingroup codec_internal
+ */
+
+#include <oi_codec_sbc_private.h>
+
+#ifdef SBC_USE_NEON
+
+#include <arm_neon.h>
+
+/* Coefficients and shifts of the terms of buffer[16 * row + 4 + k] for lane j,
+ * where k = min(j, 8 - j). A positive shift is to the left, a negative one to
+ * the right. */
+static const int16_t synth80_coef_a[5][8] = {
+    {0, -3263, -10385, -16457, 10445, 16913, 11167, 9293},
+    {-23167, -5229, -309, -23641, -5297, 3687, 1917, 1247},
+    {-17397, -27021, -23063, -12889, 22299, 15447, 8317, 23671},
+    {17397, 17319, 2309, 24211, 10603, -18233, 22117, 11537},
+    {23167, 4555, 6239, 21223, 9539, 1499, 7543, 685},
+};
+
+static const int32_t synth80_shift_a[5][8] = {
+    {0, -5, -6, -6, -4, -5, -4, -3}, {-3, 0, 4, -2, 1, 1, 2, 3},
+    {1, 1, 1, 2, 2, 2, 3, 2},        {1, 1, 3, -1, 0, -3, -4, -1},
+    {-3, -1, -3, -8, -4, -1, -3, 1},
+};
+
+/* Same for the terms of buffer[16 * row + 12 - k], lane 4 has no such term */
+static const int16_t synth80_coef_b[5][8] = {
+    {8235, 29293, 24995, 19083, 0, -8443, -10337, -6087},
+    {26479, 30835, 9161, -29015, 0, -301, -30605, -2893},
+    {9399, 31633, 27561, 6145, 0, 10255, 9553, 18055},
+    {26479, 26663, 12705, 23469, 0, 9405, 16383, 1747},
+    {8235, 12419, 9251, 26913, 0, 26189, 8603, 8721},
+};
+
+static const int32_t synth80_shift_b[5][8] = {
+    {-3, -5, -5, -5, 0, -7, -4, -2}, {-2, -3, -3, -4, 0, 5, -1, 3},
+    {3, 1, 1, 3, 0, 2, 2, 1},        {-2, -2, -1, -2, 0, -1, -2, 1},
+    {-3, -4, -4, -6, 0, -7, -6, -7},
+};
+
+static inline int32x4_t synth80_term(int32x4_t acc, int16x4_t x,
+                                     const int16_t* coef,
+                                     const int32_t* shift) {
+  int32x4_t product = vmull_s16(x, vld1_s16(coef));
+  return vaddq_s32(acc, vshlq_s32(product, vld1q_s32(shift)));
+}
+
+/* Divide by 32768 rounding toward zero like the C division, and saturate */
+static inline int16x4_t synth80_output(int32x4_t acc) {
+  /* 32767 for the negative sums, 0 otherwise */
+  int32x4_t bias = vreinterpretq_s32_u32(
+      vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(acc, 31)), 17));
+  return vqmovn_s32(vshrq_n_s32(vaddq_s32(acc, bias), 15));
+}
+
+PRIVATE void SynthWindow80_neon(int16_t* pcm,
+                                SBC_BUFFER_T const* RESTRICT buffer,
+                                OI_UINT strideShift) {
+  int32x4_t lo = vdupq_n_s32(0);
+  int32x4_t hi = vdupq_n_s32(0);
+  OI_UINT row;
+
+  for (row = 0; row < 5; row++) {
+    SBC_BUFFER_T const* b = buffer + 16 * row;
+    /* buffer[4..7] and buffer[8..5] */
+    int16x4_t a_lo = vld1_s16(b + 4);
+    int16x4_t a_hi = vrev64_s16(vld1_s16(b + 5));
+    /* buffer[12..9] and buffer[8..11], buffer[8] has no coefficient */
+    int16x4_t b_lo = vrev64_s16(vld1_s16(b + 9));
+    int16x4_t b_hi = vld1_s16(b + 8);
+
+    lo = synth80_term(lo, a_lo, synth80_coef_a[row], synth80_shift_a[row]);
+    hi = synth80_term(hi, a_hi, synth80_coef_a[row] + 4,
+                      synth80_shift_a[row] + 4);
+    lo = synth80_term(lo, b_lo, synth80_coef_b[row], synth80_shift_b[row]);
+    hi = synth80_term(hi, b_hi, synth80_coef_b[row] + 4,
+                      synth80_shift_b[row] + 4);
+  }
+
+  int16x8_t out = vcombine_s16(synth80_output(lo), synth80_output(hi));
+  if (strideShift == 0) {
+    vst1q_s16(pcm, out);
+  } else {
+    vst1q_lane_s16(pcm + (0 << 1), out, 0);
+    vst1q_lane_s16(pcm + (1 << 1), out, 1);
+    vst1q_lane_s16(pcm + (2 << 1), out, 2);
+    vst1q_lane_s16(pcm + (3 << 1), out, 3);
+    vst1q_lane_s16(pcm + (4 << 1), out, 4);
+    vst1q_lane_s16(pcm + (5 << 1), out, 5);
+    vst1q_lane_s16(pcm + (6 << 1), out, 6);
+    vst1q_lane_s16(pcm + (7 << 1), out, 7);
+  }
+}
+
+#endif /* SBC_USE_NEON */
@@ -243,9 +243,6 @@ INLINE int32_t default_mul_16s_32s_hi(int16_t u, int32_t v) {
 
 #define LONG_MULT_DCT(K, sample) (MUL_16S_32S_HI(K, sample) << 2)
 
-PRIVATE void SynthWindow80_generated(int16_t* pcm,
-                                     SBC_BUFFER_T const* RESTRICT buffer,
-                                     OI_UINT strideShift);
 PRIVATE void SynthWindow112_generated(int16_t* pcm,
                                       SBC_BUFFER_T const* RESTRICT buffer,
                                       OI_UINT strideShift);
@@ -266,8 +263,12 @@ typedef void (*SYNTH_FRAME)(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* pcm,
 #endif
 
 #ifndef SYNTH80
+#ifdef SBC_USE_NEON
+#define SYNTH80 SynthWindow80_neon
+#else
 #define SYNTH80 SynthWindow80_generated
 #endif
+#endif
 
 #ifndef SYNTH112
 #define SYNTH112 SynthWindow112_generated
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+extern "C" {
+#include "oi_codec_sbc_private.h"
+}
+
+// The NEON paths are only built for ARM targets
+#ifdef SBC_USE_NEON
+
+namespace {
+
+class SbcDecoderNeonTest : public ::testing::Test {
+ protected:
+  std::mt19937 rng_{42};
+};
+
+TEST_F(SbcDecoderNeonTest, synthesis_window_matches_generated) {
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  SBC_BUFFER_T buffer[80];
+
+  for (int iteration = 0; iteration < 10000; iteration++) {
+    for (auto& value : buffer) {
+      // Some full scale buffers to exercise the saturation of the output
+      value = sample(rng_);
+      if (iteration % 8 == 0) {
+        value = (value < 0) ? INT16_MIN : INT16_MAX;
+      }
+    }
+    for (OI_UINT stride_shift = 0; stride_shift < 2; stride_shift++) {
+      int16_t expected[16] = {0};
+      int16_t actual[16] = {0};
+      SynthWindow80_generated(expected, buffer, stride_shift);
+      SynthWindow80_neon(actual, buffer, stride_shift);
+      ASSERT_EQ(0, memcmp(expected, actual, sizeof(expected)))
+          << "iteration " << iteration << " stride " << stride_shift;
+    }
+  }
+}
+
+TEST_F(SbcDecoderNeonTest, dequant_block_matches_dequant) {
+  OI_CODEC_SBC_COMMON_CONTEXT common;
+  memset(&common, 0, sizeof(common));
+  common.frameInfo.nrof_channels = SBC_MAX_CHANNELS;
+  common.frameInfo.nrof_subbands = SBC_MAX_BANDS;
+  const OI_UINT count = SBC_MAX_CHANNELS * SBC_MAX_BANDS;
+
+  std::uniform_int_distribution<int> bits(0, 16);
+  std::uniform_int_distribution<int> scale_factor(0, 15);
+  for (int iteration = 0; iteration < 10000; iteration++) {
+    for (OI_UINT i = 0; i < count; i++) {
+      common.bits.uint8[i] = bits(rng_);
+      common.scale_factor[i] = scale_factor(rng_);
+    }
+    OI_SBC_DEQUANT_PARAMS params;
+    OI_SBC_DequantPrepare(&common, &params);
+
+    int32_t samples[count];
+    int32_t expected[count];
+    for (OI_UINT i = 0; i < count; i++) {
+      OI_UINT b = common.bits.uint8[i];
+      // All ones are forbidden, the largest raw value is 2^bits - 2
+      uint32_t max_raw = (b <= 1) ? b : (1u << b) - 2;
+      uint32_t raw = std::uniform_int_distribution<uint32_t>(0, max_raw)(rng_);
+      samples[i] = raw;
+      expected[i] = OI_SBC_Dequant(raw, common.scale_factor[i], b);
+    }
+    OI_SBC_DequantBlock(samples, &params, count);
+    for (OI_UINT i = 0; i < count; i++) {
+      ASSERT_EQ(expected[i], samples[i])
+          << "iteration " << iteration << " sample " << i;
+    }
+  }
+}
+
+}  // namespace
+
+#endif  // SBC_USE_NEON
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// The bit rate picked by the A2DP source for EDR peers
+constexpr uint16_t kBitRateKbps = 328;
+// Same size as the output buffer of an A2DP media packet
+constexpr size_t kOutputSize = 1024;
+constexpr int kSecondsOfAudio = 1;
+
+// Generate interleaved PCM with a tone and some noise on each channel, so that
+// all the subbands carry signal.
+std::vector<int16_t> GeneratePcm(int num_channels, int num_samples) {
+  std::vector<int16_t> pcm(num_channels * num_samples);
+  uint32_t noise = 1;
+  for (int i = 0; i < num_samples; i++) {
+    for (int ch = 0; ch < num_channels; ch++) {
+      noise = noise * 1103515245 + 12345;
+      double tone = 16000 * sin(2 * M_PI * (440 + 220 * ch) * i / 44100);
+      pcm[i * num_channels + ch] = static_cast<int16_t>(
+          tone + static_cast<int16_t>(noise >> 16) / 8);
+    }
+  }
+  return pcm;
+}
+
+// Encode one second of 44.1 kHz audio, frame by frame like the A2DP source
+// does when it fills a media packet.
+void EncodeSbc(State& state, int16_t channel_mode, int16_t num_subbands,
+               int16_t num_blocks) {
+  SBC_ENC_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = channel_mode;
+  params.s16NumOfSubBands = num_subbands;
+  params.s16NumOfBlocks = num_blocks;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = kBitRateKbps;
+  params.Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(&params);
+
+  const int frame_samples = num_subbands * num_blocks;
+  const int num_frames = 44100 * kSecondsOfAudio / frame_samples;
+  std::vector<int16_t> pcm =
+      GeneratePcm(params.s16NumOfChannels, num_frames * frame_samples);
+  std::vector<int16_t> input(frame_samples * params.s16NumOfChannels);
+  uint8_t output[kOutputSize];
+
+  for (auto _ : state) {
+    for (int frame = 0; frame < num_frames; frame++) {
+      // The A2DP source reads each frame into its PCM buffer before encoding
+      memcpy(input.data(), &pcm[frame * input.size()],
+             input.size() * sizeof(int16_t));
+      ::benchmark::DoNotOptimize(SBC_Encode(&params, input.data(), output));
+    }
+    ::benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * num_frames);
+}
+
+}  // namespace
+
+static void BM_SbcEncodeJointStereo8Subbands(State& state) {
+  EncodeSbc(state, SBC_JOINT_STEREO, SUB_BANDS_8, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcEncodeJointStereo8Subbands);
+
+static void BM_SbcEncodeDual8Subbands(State& state) {
+  EncodeSbc(state, SBC_DUAL, SUB_BANDS_8, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcEncodeDual8Subbands);
+
+static void BM_SbcEncodeMono8Subbands(State& state) {
+  EncodeSbc(state, SBC_MONO, SUB_BANDS_8, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcEncodeMono8Subbands);
+
+static void BM_SbcEncodeJointStereo4Subbands(State& state) {
+  EncodeSbc(state, SBC_JOINT_STEREO, SUB_BANDS_4, SBC_BLOCK_3);
+}
+BENCHMARK(BM_SbcEncodeJointStereo4Subbands);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -109,6 +109,18 @@
 #define SBC_IPAQ_OPT TRUE
 #endif
 
+/* Set SBC_SIMD_OPT to TRUE to compute the windowing of the analysis filter
+ * with SSE2 or NEON instructions. It only applies with SBC_IPAQ_OPT and the 16
+ * bit window, and gives the same result as the C code.
+ */
+#ifndef SBC_SIMD_OPT
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define SBC_SIMD_OPT TRUE
+#else
+#define SBC_SIMD_OPT FALSE
+#endif
+#endif
+
 /* Debug only: set SBC_IS_64_MULT_IN_WINDOW_ACCU to TRUE to use 64 bit
  * multiplication in the windowing
  */
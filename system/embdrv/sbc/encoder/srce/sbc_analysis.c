@@ -25,6 +25,20 @@
 #include <string.h>
 #include "sbc_enc_func_declare.h"
 #include "sbc_encoder.h"
+
+#if (SBC_SIMD_OPT == TRUE) && (SBC_ARM_ASM_OPT == FALSE) && \
+    (SBC_IPAQ_OPT == TRUE) && (SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE)
+#define SBC_SIMD_WINDOW_ACCU TRUE
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#else
+#error "SBC_SIMD_OPT requires NEON or SSE2"
+#endif
+#else
+#define SBC_SIMD_WINDOW_ACCU FALSE
+#endif
 /*#include <math.h>*/
 
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
@@ -1185,6 +1199,104 @@ static int16_t* s16X =
 #endif
 #endif
 
+#if (SBC_SIMD_WINDOW_ACCU == TRUE)
+/* Coefficients of the WINDOW_ACCU_4_* and WINDOW_ACCU_8_* macros, the one
+ * applied to s16X[ChOffset + i] is at index i. A row holds the coefficients of
+ * one output of s32DCTY for each of the 5 accumulations. */
+static const int16_t as16Window4[40] = {
+    0, WIND_4_SUBBANDS_1_0, WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_3_0,
+    WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_2_4,
+    WIND_4_SUBBANDS_1_4,
+    WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_1, WIND_4_SUBBANDS_2_1,
+    WIND_4_SUBBANDS_3_1, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_3,
+    WIND_4_SUBBANDS_2_3, WIND_4_SUBBANDS_1_3,
+    WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_2_2,
+    WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_4_2, WIND_4_SUBBANDS_3_2,
+    WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_1_2,
+    -WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_3, WIND_4_SUBBANDS_2_3,
+    WIND_4_SUBBANDS_3_3, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_1,
+    WIND_4_SUBBANDS_2_1, WIND_4_SUBBANDS_1_1,
+    -WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_4, WIND_4_SUBBANDS_2_4,
+    WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_0,
+    WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_1_0,
+};
+
+static const int16_t as16Window8[80] = {
+    0, WIND_8_SUBBANDS_1_0, WIND_8_SUBBANDS_2_0, WIND_8_SUBBANDS_3_0,
+    WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_5_0, WIND_8_SUBBANDS_6_0,
+    WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_8_0, WIND_8_SUBBANDS_7_4,
+    WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_5_4, WIND_8_SUBBANDS_4_4,
+    WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_2_4, WIND_8_SUBBANDS_1_4,
+    WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_1, WIND_8_SUBBANDS_2_1,
+    WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_5_1,
+    WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_8_1,
+    WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_5_3,
+    WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_2_3,
+    WIND_8_SUBBANDS_1_3,
+    WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_2_2,
+    WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_5_2,
+    WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_8_2,
+    WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_5_2,
+    WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_2_2,
+    WIND_8_SUBBANDS_1_2,
+    -WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_3, WIND_8_SUBBANDS_2_3,
+    WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_5_3,
+    WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_8_1,
+    WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_5_1,
+    WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_2_1,
+    WIND_8_SUBBANDS_1_1,
+    -WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_4, WIND_8_SUBBANDS_2_4,
+    WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_4_4, WIND_8_SUBBANDS_5_4,
+    WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_7_4, WIND_8_SUBBANDS_8_0,
+    WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_6_0, WIND_8_SUBBANDS_5_0,
+    WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_3_0, WIND_8_SUBBANDS_2_0,
+    WIND_8_SUBBANDS_1_0,
+};
+
+/* Compute the s32Len outputs of the windowing, 8 at a time. The products of 16
+ * bit samples and coefficients are exact in 32 bits and their sums never
+ * overflow, so the result is the same as the WINDOW_ACCU_* macros. */
+static inline void sbc_simd_window_accu(const int16_t* ps16X,
+                                        const int16_t* ps16Window,
+                                        int32_t s32Len, int32_t* ps32Y) {
+  int32_t i, j;
+  for (i = 0; i < s32Len; i += 8) {
+#if defined(__ARM_NEON)
+    int32x4_t s32Lo = vdupq_n_s32(0);
+    int32x4_t s32Hi = vdupq_n_s32(0);
+    for (j = 0; j < 5; j++) {
+      int16x8_t s16Smp = vld1q_s16(ps16X + j * s32Len + i);
+      int16x8_t s16W = vld1q_s16(ps16Window + j * s32Len + i);
+      s32Lo = vmlal_s16(s32Lo, vget_low_s16(s16Smp), vget_low_s16(s16W));
+      s32Hi = vmlal_s16(s32Hi, vget_high_s16(s16Smp), vget_high_s16(s16W));
+    }
+    vst1q_s32(ps32Y + i, s32Lo);
+    vst1q_s32(ps32Y + i + 4, s32Hi);
+#else
+    __m128i s32Lo = _mm_setzero_si128();
+    __m128i s32Hi = _mm_setzero_si128();
+    for (j = 0; j < 5; j++) {
+      __m128i s16Smp =
+          _mm_loadu_si128((const __m128i*)(ps16X + j * s32Len + i));
+      __m128i s16W =
+          _mm_loadu_si128((const __m128i*)(ps16Window + j * s32Len + i));
+      __m128i s16ProdLo = _mm_mullo_epi16(s16Smp, s16W);
+      __m128i s16ProdHi = _mm_mulhi_epi16(s16Smp, s16W);
+      s32Lo = _mm_add_epi32(s32Lo, _mm_unpacklo_epi16(s16ProdLo, s16ProdHi));
+      s32Hi = _mm_add_epi32(s32Hi, _mm_unpackhi_epi16(s16ProdLo, s16ProdHi));
+    }
+    _mm_storeu_si128((__m128i*)(ps32Y + i), s32Lo);
+    _mm_storeu_si128((__m128i*)(ps32Y + i + 4), s32Hi);
+#endif
+  }
+}
+
+#define WINDOW_SIMD_4 \
+  sbc_simd_window_accu(&s16X[ChOffset], as16Window4, 8, s32DCTY);
+#define WINDOW_SIMD_8 \
+  sbc_simd_window_accu(&s16X[ChOffset], as16Window8, 16, s32DCTY);
+#endif
+
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
 /****************************************************************************
@@ -1205,7 +1317,7 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 #if (SBC_IPAQ_OPT == TRUE)
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
   register int64_t s64Temp, s64Temp2;
-#else
+#elif (SBC_SIMD_WINDOW_ACCU == FALSE)
   register int32_t s32Temp, s32Temp2;
 #endif
 #else
@@ -1257,7 +1369,11 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
+#if (SBC_SIMD_WINDOW_ACCU == TRUE)
+      WINDOW_SIMD_4
+#else
       WINDOW_PARTIAL_4
+#endif
 
       SBC_FastIDCT4(s32DCTY, ps32SbBuf);
 
@@ -1296,7 +1412,7 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 #if (SBC_IPAQ_OPT == TRUE)
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
   register int64_t s64Temp, s64Temp2;
-#else
+#elif (SBC_SIMD_WINDOW_ACCU == FALSE)
   register int32_t s32Temp, s32Temp2;
 #endif
 #else
@@ -1370,7 +1486,11 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
+#if (SBC_SIMD_WINDOW_ACCU == TRUE)
+      WINDOW_SIMD_8
+#else
       WINDOW_PARTIAL_8
+#endif
 
       SBC_FastIDCT8(s32DCTY, ps32SbBuf);
 
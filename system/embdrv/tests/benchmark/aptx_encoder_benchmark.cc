@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "aptXHDbtenc.h"
+#include "aptXbtenc.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+
+// One second of 48 kHz stereo: a tone with some noise on each channel, so
+// that all the subbands carry signal. |bits| is the sample size of the codec.
+std::vector<int32_t> GeneratePcm(int bits) {
+  std::vector<int32_t> pcm(2 * kSampleRate);
+  const double amplitude = 0.5 * (1 << (bits - 1));
+  uint32_t noise = 1;
+  for (int i = 0; i < kSampleRate; i++) {
+    for (int ch = 0; ch < 2; ch++) {
+      noise = noise * 1103515245 + 12345;
+      double tone =
+          amplitude * sin(2 * M_PI * (440 + 220 * ch) * i / kSampleRate);
+      pcm[2 * i + ch] = static_cast<int32_t>(
+          tone + ((static_cast<int32_t>(noise) >> (40 - bits))));
+    }
+  }
+  return pcm;
+}
+
+// Each iteration encodes one second of audio like the A2DP source does, 4
+// samples of each channel at a time. The CPU time of an iteration is the CPU
+// cost of one second of audio.
+template <typename Encode>
+void EncodeAptx(State& state, int bits, int (*size_of)(void),
+                int (*init)(void*, short), Encode encode) {
+  const std::vector<int32_t> pcm = GeneratePcm(bits);
+  void* encoder = malloc(size_of());
+  init(encoder, 0);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < pcm.size(); i += 8) {
+      uint32_t pcmL[4];
+      uint32_t pcmR[4];
+      for (size_t j = 0; j < 4; j++) {
+        pcmL[j] = pcm[i + 2 * j];
+        pcmR[j] = pcm[i + 2 * j + 1];
+      }
+      encode(encoder, pcmL, pcmR);
+    }
+    ::benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kSampleRate);
+  free(encoder);
+}
+
+}  // namespace
+
+static void BM_AptxEncodeStereo48k(State& state) {
+  EncodeAptx(state, 16, SizeofAptxbtenc, aptxbtenc_init,
+             [](void* encoder, uint32_t* pcmL, uint32_t* pcmR) {
+               uint16_t codeword[2];
+               aptxbtenc_encodestereo(encoder, pcmL, pcmR, codeword);
+               ::benchmark::DoNotOptimize(codeword);
+             });
+}
+BENCHMARK(BM_AptxEncodeStereo48k);
+
+static void BM_AptxHdEncodeStereo48k(State& state) {
+  EncodeAptx(state, 24, SizeofAptxhdbtenc, aptxhdbtenc_init,
+             [](void* encoder, uint32_t* pcmL, uint32_t* pcmR) {
+               uint32_t codeword[2];
+               aptxhdbtenc_encodestereo(encoder, pcmL, pcmR, codeword);
+               ::benchmark::DoNotOptimize(codeword);
+             });
+}
+BENCHMARK(BM_AptxHdEncodeStereo48k);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -28,10 +28,9 @@
 #define BYTES_PER_CODEWORD 16
 
 class LibAptxEncTest : public ::testing::Test {
- private:
+ protected:
   void* aptxbtenc = nullptr;
 
- protected:
   void SetUp() override {
     aptxbtenc = malloc(SizeofAptxbtenc());
     ASSERT_NE(aptxbtenc, nullptr);
@@ -75,3 +74,28 @@ TEST_F(LibAptxEncTest, encode_fake_data) {
     ++idx;
   }
 }
+
+// Pin the codes of one second of stereo audio, the SIMD versions of the
+// encoder kernels must give the same stream as the C code.
+TEST_F(LibAptxEncTest, encode_long_stream) {
+  uint32_t noise = 1;
+  uint32_t hash = 2166136261u;
+
+  for (int i = 0; i < 48000 / 4; i++) {
+    uint32_t pcmL[4];
+    uint32_t pcmR[4];
+    for (size_t j = 0; j < 4; j++) {
+      noise = noise * 1103515245 + 12345;
+      // Alternate loud and quiet parts to use all the quantiser levels
+      int32_t sample = (int32_t)noise >> ((i / 1000) % 2 ? 22 : 16);
+      pcmL[j] = sample;
+      pcmR[j] = -sample / 2 + (int32_t)(noise >> 28);
+    }
+    uint16_t encoded_sample[2];
+    aptxbtenc_encodestereo(aptxbtenc, &pcmL, &pcmR, encoded_sample);
+    for (uint16_t code : encoded_sample) {
+      hash = (hash ^ code) * 16777619u;
+    }
+  }
+  ASSERT_EQ(hash, 2657086491u);
+}
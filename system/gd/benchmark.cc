@@ -16,6 +16,42 @@
 
 #include <benchmark/benchmark.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "benchmark_allocation_count.h"
+
+namespace {
+std::atomic<int64_t> allocation_count{0};
+}  // namespace
+
+// Count every allocation of the benchmark binary, so that the benchmarks can report the allocations they make
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /* size */) noexcept {
+  std::free(ptr);
+}
+
+namespace bluetooth {
+
+int64_t GetBenchmarkAllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace bluetooth
+
 int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
@@ -41,7 +41,9 @@ class ContextualOnceCallback<R(Args...)> {
   ContextualOnceCallback& operator=(ContextualOnceCallback&&) noexcept = default;
 
   void operator()(Args... args) {
-    context_->Post(common::BindOnce(std::move(callback_), std::forward<Args>(args)...));
+    context_->PostInline([callback = std::move(callback_), ... args = std::forward<Args>(args)]() mutable {
+      std::move(callback).Run(std::move(args)...);
+    });
   }
 
   operator bool() const {
@@ -75,7 +77,9 @@ class ContextualCallback<R(Args...)> {
   ContextualCallback& operator=(ContextualCallback&&) noexcept = default;
 
   void operator()(Args... args) {
-    context_->Post(common::BindOnce(callback_, std::forward<Args>(args)...));
+    context_->PostInline([callback = callback_, ... args = std::forward<Args>(args)]() mutable {
+      callback.Run(std::move(args)...);
+    });
   }
 
   operator bool() const {
@@ -0,0 +1,457 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// A ListMap that keeps its entries in one array instead of one heap node per entry and per index slot. Entries are
+// linked into a list by array index, and indexed by an open addressed hash table with linear probing.
+//
+// Same API as ListMap, with these differences:
+//   - Iterators stay valid until their element is erased, including across growth, but references and pointers to
+//     elements are invalidated when the map grows beyond the capacity given to reserve()
+//   - Iterators do not survive moving the map, and splice() from another map moves the element, so iterators to it
+//     must be looked up again in the destination map
+//
+// Performance:
+//   - Key look-up and modification is O(1), without allocation once reserve() was called
+//   - Memory consumption is:
+//     O(capacity*(sizeof(K)+sizeof(V)+2*sizeof(uint32_t)) + 4/3*capacity*2*sizeof(uint32_t))
+//   - NOT THREAD SAFE
+//
+// Template:
+//   - Key key
+//   - T value
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatListMap {
+  // Index of no node: the end of the list, and an empty slot of the hash table
+  static constexpr uint32_t kNil = UINT32_MAX;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  // different from c++17 node_type on purpose as we want node to be copyable
+  using node_type = std::pair<Key, T>;
+
+  template <bool kConst>
+  class Iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = FlatListMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<kConst, const value_type*, value_type*>;
+    using reference = std::conditional_t<kConst, const value_type&, value_type&>;
+
+    Iterator() = default;
+
+    // iterator converts to const_iterator
+    template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+    Iterator(const Iterator<kOtherConst>& other) : map_(other.map_), index_(other.index_) {}
+
+    reference operator*() const {
+      return *map_->nodes_[index_].entry;
+    }
+    pointer operator->() const {
+      return &*map_->nodes_[index_].entry;
+    }
+
+    Iterator& operator++() {
+      index_ = map_->nodes_[index_].next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+    Iterator& operator--() {
+      index_ = index_ == kNil ? map_->last_ : map_->nodes_[index_].prev;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator previous = *this;
+      --*this;
+      return previous;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.map_ == rhs.map_ && lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class FlatListMap;
+    template <bool>
+    friend class Iterator;
+    using Container = std::conditional_t<kConst, const FlatListMap, FlatListMap>;
+
+    Iterator(Container* map, uint32_t index) : map_(map), index_(index) {}
+
+    Container* map_ = nullptr;
+    uint32_t index_ = kNil;
+  };
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Constructor of the list map
+  FlatListMap() = default;
+
+  // for move
+  FlatListMap(FlatListMap&& other) noexcept {
+    swap(other);
+  }
+  FlatListMap& operator=(FlatListMap&& other) noexcept {
+    if (&other != this) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // copy-constructor
+  // node indexes are only meaningful in their own map, so entries are inserted again
+  FlatListMap(const FlatListMap& other) {
+    reserve(other.size());
+    for (const auto& [key, value] : other) {
+      try_emplace_back(key, value);
+    }
+  }
+
+  // copy-assignment
+  FlatListMap& operator=(const FlatListMap& other) {
+    if (&other == this) {
+      return *this;
+    }
+    clear();
+    reserve(other.size());
+    for (const auto& [key, value] : other) {
+      try_emplace_back(key, value);
+    }
+    return *this;
+  }
+
+  // comparison operators
+  bool operator==(const FlatListMap& rhs) const {
+    return std::equal(begin(), end(), rhs.begin(), rhs.end());
+  }
+  bool operator!=(const FlatListMap& rhs) const {
+    return !(*this == rhs);
+  }
+
+  ~FlatListMap() = default;
+
+  // Clear the list map. Keeps the memory for the entries put next.
+  void clear() {
+    nodes_.clear();
+    std::fill(index_.begin(), index_.end(), Slot{kNil, 0});
+    first_ = kNil;
+    last_ = kNil;
+    free_ = kNil;
+    size_ = 0;
+  }
+
+  // Allocate room for |capacity| entries, after which putting entries does not allocate until the map holds more
+  void reserve(size_t capacity) {
+    nodes_.reserve(capacity);
+    size_t slots = kMinSlots;
+    while (capacity * kMaxLoadDenominator > slots * kMaxLoadNumerator) {
+      slots *= 2;
+    }
+    if (slots > index_.size()) {
+      rehash(slots);
+    }
+  }
+
+  // const version of find()
+  const_iterator find(const Key& key) const {
+    return const_cast<FlatListMap*>(this)->find(key);
+  }
+
+  // Get the value of a key. Return iterator to the item if found, end() if not found
+  iterator find(const Key& key) {
+    if (size_ == 0) {
+      return end();
+    }
+    uint32_t node = index_[probe(key, hash(key))].node;
+    return node == kNil ? end() : iterator(this, node);
+  }
+
+  // Check if key exist in the map. Return true if key exist in map, false if not.
+  bool contains(const Key& key) const {
+    return find(key) != end();
+  }
+
+  // Try emplace an element before a specific position |pos| of the list map. If the |key| already exists, does nothing.
+  // Moved arguments won't be moved when key already exists. Return <iterator, true> when key does not exist, <end(),
+  // false> when key exist.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const_iterator pos, const Key& key, Args&&... args) {
+    uint32_t key_hash = hash(key);
+    size_t slot = find_or_prepare_slot(key, key_hash);
+    if (index_[slot].node != kNil) {
+      return std::make_pair(end(), false);
+    }
+    uint32_t node = insert_at(slot, pos.index_, key_hash, key, std::forward<Args>(args)...);
+    return std::make_pair(iterator(this, node), true);
+  }
+
+  // Try emplace an element before the end of the list map. If the key already exists, does nothing. Moved arguments
+  // won't be moved when key already exists
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace_back(const Key& key, Args&&... args) {
+    return try_emplace(end(), key, std::forward<Args>(args)...);
+  }
+
+  // Put a key-value pair to the map before position. If key already exist, |pos| will be ignored and existing value
+  // will be replaced
+  void insert_or_assign(const_iterator pos, const Key& key, T value) {
+    uint32_t key_hash = hash(key);
+    size_t slot = find_or_prepare_slot(key, key_hash);
+    if (index_[slot].node != kNil) {
+      nodes_[index_[slot].node].entry->second = std::move(value);
+      return;
+    }
+    insert_at(slot, pos.index_, key_hash, key, std::move(value));
+  }
+
+  // Put a key-value pair to the tail of the map or replace the current value without moving the key if key exists
+  void insert_or_assign(const Key& key, T value) {
+    insert_or_assign(end(), key, std::move(value));
+  }
+
+  // Move the element |it| of |other| before |pos|. Within the same map only the links change, so |it| stays valid.
+  void splice(const_iterator pos, FlatListMap& other, const_iterator it) {
+    if (&other != this) {
+      std::optional<node_type> moved = other.remove(other.slot_of(it.index_));
+      try_emplace(pos, moved->first, std::move(moved->second));
+      return;
+    }
+    if (it.index_ == pos.index_) {
+      return;
+    }
+    unlink(it.index_);
+    link_before(it.index_, pos.index_);
+  }
+
+  // Remove a key from the list map and return removed value if key exits, std::nullopt if not. The return value will be
+  // evaluated to true in a boolean context if a value is contained by std::optional, false otherwise.
+  std::optional<node_type> extract(const Key& key) {
+    if (size_ == 0) {
+      return std::nullopt;
+    }
+    size_t slot = probe(key, hash(key));
+    if (index_[slot].node == kNil) {
+      return std::nullopt;
+    }
+    return remove(slot);
+  }
+
+  // Remove an iterator pointed item from the list map and return the iterator immediately after the erased item
+  iterator erase(const_iterator iter) {
+    uint32_t next = nodes_[iter.index_].next;
+    remove(slot_of(iter.index_));
+    return iterator(this, next);
+  }
+
+  // Return size of the list map
+  inline size_t size() const {
+    return size_;
+  }
+
+  // Return iterator interface for begin
+  inline iterator begin() {
+    return iterator(this, first_);
+  }
+
+  // Iterator interface for begin, const
+  inline const_iterator begin() const {
+    return const_iterator(this, first_);
+  }
+
+  // Iterator interface for end
+  inline iterator end() {
+    return iterator(this, kNil);
+  }
+
+  // Iterator interface for end, const
+  inline const_iterator end() const {
+    return const_iterator(this, kNil);
+  }
+
+ private:
+  struct Node {
+    std::optional<value_type> entry;  // std::nullopt while the node is on the free list
+    uint32_t prev;
+    uint32_t next;  // Next free node while the node is on the free list
+  };
+
+  // A slot of the hash table keeps the hash of its key, so that probing, removing and rehashing do not read the nodes
+  // of the other keys
+  struct Slot {
+    uint32_t node;  // kNil when the slot is empty
+    uint32_t hash;
+  };
+
+  // The hash table is at most 3/4 full, so that probe sequences stay short
+  static constexpr size_t kMinSlots = 16;
+  static constexpr size_t kMaxLoadNumerator = 3;
+  static constexpr size_t kMaxLoadDenominator = 4;
+
+  // Spread the bits of the user hash, since std::hash is the identity for integers and slots use the low bits
+  static uint32_t hash(const Key& key) {
+    uint64_t h = Hash()(key);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<uint32_t>(h ^ (h >> 31));
+  }
+
+  // Return the slot holding |key|, or the empty slot where it would go. The hash table must not be empty.
+  size_t probe(const Key& key, uint32_t key_hash) const {
+    size_t mask = index_.size() - 1;
+    for (size_t slot = key_hash & mask;; slot = (slot + 1) & mask) {
+      const Slot& candidate = index_[slot];
+      if (candidate.node == kNil ||
+          (candidate.hash == key_hash && KeyEqual()(nodes_[candidate.node].entry->first, key))) {
+        return slot;
+      }
+    }
+  }
+
+  // Like probe(), but first grow the hash table if it could not take one more key
+  size_t find_or_prepare_slot(const Key& key, uint32_t key_hash) {
+    if ((size_ + 1) * kMaxLoadDenominator > index_.size() * kMaxLoadNumerator) {
+      size_t slot = index_.empty() ? kNil : probe(key, key_hash);
+      if (slot != kNil && index_[slot].node != kNil) {
+        return slot;
+      }
+      rehash(std::max(kMinSlots, index_.size() * 2));
+    }
+    return probe(key, key_hash);
+  }
+
+  void rehash(size_t slots) {
+    std::vector<Slot> old_index(slots, Slot{kNil, 0});
+    std::swap(index_, old_index);
+    size_t mask = slots - 1;
+    for (const Slot& old_slot : old_index) {
+      if (old_slot.node == kNil) {
+        continue;
+      }
+      size_t slot = old_slot.hash & mask;
+      while (index_[slot].node != kNil) {
+        slot = (slot + 1) & mask;
+      }
+      index_[slot] = old_slot;
+    }
+  }
+
+  template <class... Args>
+  uint32_t insert_at(size_t slot, uint32_t pos, uint32_t key_hash, const Key& key, Args&&... args) {
+    uint32_t node = free_;
+    if (node != kNil) {
+      free_ = nodes_[node].next;
+    } else {
+      node = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+    }
+    nodes_[node].entry.emplace(key, std::forward<Args>(args)...);
+    link_before(node, pos);
+    index_[slot] = Slot{node, key_hash};
+    size_++;
+    return node;
+  }
+
+  // Return the slot of |node|
+  size_t slot_of(uint32_t node) const {
+    const Key& key = nodes_[node].entry->first;
+    return probe(key, hash(key));
+  }
+
+  // Remove the node of |slot| from the hash table and the list, and return its entry
+  std::optional<node_type> remove(size_t slot) {
+    uint32_t node = index_[slot].node;
+    unindex(slot);
+    unlink(node);
+    std::optional<node_type> removed(std::move(*nodes_[node].entry));
+    nodes_[node].entry.reset();
+    nodes_[node].next = free_;
+    free_ = node;
+    size_--;
+    return removed;
+  }
+
+  // Empty |hole|, and shift back the entries after it that probed past it, so that no probe sequence has a hole
+  void unindex(size_t hole) {
+    size_t mask = index_.size() - 1;
+    for (size_t slot = (hole + 1) & mask; index_[slot].node != kNil; slot = (slot + 1) & mask) {
+      size_t home = index_[slot].hash & mask;
+      // The entry can move back unless its home slot is after the hole
+      if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+        index_[hole] = index_[slot];
+        hole = slot;
+      }
+    }
+    index_[hole] = Slot{kNil, 0};
+  }
+
+  void link_before(uint32_t node, uint32_t pos) {
+    uint32_t prev = pos == kNil ? last_ : nodes_[pos].prev;
+    nodes_[node].prev = prev;
+    nodes_[node].next = pos;
+    (prev == kNil ? first_ : nodes_[prev].next) = node;
+    (pos == kNil ? last_ : nodes_[pos].prev) = node;
+  }
+
+  void unlink(uint32_t node) {
+    uint32_t prev = nodes_[node].prev;
+    uint32_t next = nodes_[node].next;
+    (prev == kNil ? first_ : nodes_[prev].next) = next;
+    (next == kNil ? last_ : nodes_[next].prev) = prev;
+  }
+
+  void swap(FlatListMap& other) noexcept {
+    std::swap(nodes_, other.nodes_);
+    std::swap(index_, other.index_);
+    std::swap(first_, other.first_);
+    std::swap(last_, other.last_);
+    std::swap(free_, other.free_);
+    std::swap(size_, other.size_);
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<Slot> index_;
+  uint32_t first_ = kNil;
+  uint32_t last_ = kNil;
+  uint32_t free_ = kNil;  // Head of the list of nodes to reuse
+  size_t size_ = 0;
+};
+
+}  // namespace common
+}  // namespace bluetooth
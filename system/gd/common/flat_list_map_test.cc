@@ -0,0 +1,161 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/flat_list_map.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/list_map.h"
+
+namespace testing {
+
+using bluetooth::common::FlatListMap;
+using bluetooth::common::ListMap;
+
+TEST(FlatListMapTest, empty_test) {
+  FlatListMap<int, int> list_map;
+  EXPECT_EQ(list_map.size(), 0ul);
+  EXPECT_EQ(list_map.begin(), list_map.end());
+  EXPECT_EQ(list_map.find(42), list_map.end());
+  EXPECT_FALSE(list_map.contains(42));
+  EXPECT_FALSE(list_map.extract(42));
+}
+
+TEST(FlatListMapTest, keeps_insertion_order_test) {
+  FlatListMap<int, std::string> list_map;
+  list_map.insert_or_assign(3, "c");
+  list_map.insert_or_assign(1, "a");
+  list_map.try_emplace(list_map.find(1), 2, "b");
+  list_map.insert_or_assign(3, "C");
+  EXPECT_THAT(list_map, ElementsAre(Pair(3, "C"), Pair(2, "b"), Pair(1, "a")));
+  EXPECT_EQ(std::prev(list_map.end())->first, 1);
+}
+
+TEST(FlatListMapTest, iterators_survive_growth_test) {
+  FlatListMap<int, int> list_map;
+  list_map.insert_or_assign(0, 0);
+  auto first = list_map.begin();
+  for (int key = 1; key < 10000; key++) {
+    list_map.insert_or_assign(key, key);
+  }
+  EXPECT_EQ(first->first, 0);
+  EXPECT_EQ(++first, list_map.find(1));
+}
+
+TEST(FlatListMapTest, reserve_keeps_references_test) {
+  FlatListMap<int, int> list_map;
+  list_map.reserve(100);
+  list_map.insert_or_assign(0, 0);
+  const int* value = &list_map.begin()->second;
+  for (int key = 1; key < 100; key++) {
+    list_map.insert_or_assign(key, key);
+  }
+  EXPECT_EQ(value, &list_map.find(0)->second);
+}
+
+TEST(FlatListMapTest, erased_nodes_are_reused_test) {
+  FlatListMap<int, std::unique_ptr<int>> list_map;
+  for (int round = 0; round < 100; round++) {
+    list_map.try_emplace_back(round, std::make_unique<int>(round));
+    if (round >= 3) {
+      auto removed = list_map.extract(round - 3);
+      ASSERT_TRUE(removed);
+      EXPECT_EQ(*removed->second, round - 3);
+    }
+  }
+  EXPECT_EQ(list_map.size(), 3ul);
+  EXPECT_EQ(list_map.begin()->first, 97);
+}
+
+// Colliding hashes exercise the backward shift of the probe sequences on removal
+struct CollidingHash {
+  size_t operator()(int key) const {
+    return key % 4;
+  }
+};
+
+TEST(FlatListMapTest, colliding_keys_test) {
+  FlatListMap<int, int, CollidingHash> list_map;
+  for (int key = 0; key < 64; key++) {
+    list_map.insert_or_assign(key, key);
+  }
+  for (int key = 0; key < 64; key += 3) {
+    EXPECT_TRUE(list_map.extract(key));
+  }
+  for (int key = 0; key < 64; key++) {
+    EXPECT_EQ(list_map.contains(key), key % 3 != 0);
+  }
+}
+
+TEST(FlatListMapTest, splice_different_map_test) {
+  FlatListMap<int, int> list_map;
+  list_map.insert_or_assign(1, 10);
+  FlatListMap<int, int> list_map_2;
+  list_map_2.insert_or_assign(2, 20);
+  list_map_2.insert_or_assign(3, 30);
+  list_map.splice(list_map.begin(), list_map_2, list_map_2.find(3));
+  EXPECT_THAT(list_map, ElementsAre(Pair(3, 30), Pair(1, 10)));
+  EXPECT_THAT(list_map_2, ElementsAre(Pair(2, 20)));
+}
+
+TEST(FlatListMapTest, move_leaves_empty_map_test) {
+  FlatListMap<int, int> list_map;
+  list_map.insert_or_assign(1, 10);
+  FlatListMap<int, int> list_map_2(std::move(list_map));
+  EXPECT_THAT(list_map_2, ElementsAre(Pair(1, 10)));
+  EXPECT_EQ(list_map.size(), 0ul);  // NOLINT(bugprone-use-after-move)
+  list_map.insert_or_assign(2, 20);
+  EXPECT_THAT(list_map, ElementsAre(Pair(2, 20)));
+}
+
+TEST(FlatListMapTest, matches_list_map_test) {
+  srand(42);
+  ListMap<int, int> expected;
+  FlatListMap<int, int> list_map;
+  for (int i = 0; i < 20000; i++) {
+    int key = rand() % 500;
+    switch (rand() % 4) {
+      case 0:
+        expected.insert_or_assign(key, i);
+        list_map.insert_or_assign(key, i);
+        break;
+      case 1:
+        expected.try_emplace(expected.begin(), key, i);
+        list_map.try_emplace(list_map.begin(), key, i);
+        break;
+      case 2:
+        EXPECT_EQ(expected.extract(key), list_map.extract(key));
+        break;
+      case 3:
+        if (expected.contains(key)) {
+          expected.splice(expected.begin(), expected, expected.find(key));
+          list_map.splice(list_map.begin(), list_map, list_map.find(key));
+        }
+        break;
+    }
+  }
+  std::vector<std::pair<int, int>> expected_nodes(expected.begin(), expected.end());
+  std::vector<std::pair<int, int>> nodes(list_map.begin(), list_map.end());
+  EXPECT_EQ(expected_nodes, nodes);
+}
+
+}  // namespace testing
@@ -18,6 +18,8 @@
 
 #include <base/functional/bind.h>
 
+#include "common/inline_once_closure.h"
+
 namespace bluetooth {
 namespace common {
 
@@ -25,6 +27,11 @@ class IPostableContext {
  public:
   virtual ~IPostableContext(){};
   virtual void Post(base::OnceClosure closure) = 0;
+  // Like Post(), without allocating a base::BindState on contexts that store small closures inline, like os::Handler.
+  // Other contexts convert |closure| to a base::OnceClosure.
+  virtual void PostInline(InlineOnceClosure closure) {
+    Post(std::move(closure).ToOnceClosure());
+  }
 };
 
 }  // namespace common
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <base/functional/bind.h>
+#include <base/functional/callback.h>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bluetooth {
+namespace common {
+
+// A move-only closure that runs at most once, like common::OnceClosure, but that keeps functors of up to kInlineSize
+// bytes inside itself instead of allocating a base::BindState for each of them. Larger functors, and functors that may
+// throw when moved, are allocated on the heap.
+//
+// Usage:
+//   handler->PostInline([this, handle] { on_packet(handle); });
+//
+// Unlike common::BindOnce(), capturing a pointer does not check anything when the closure runs: the poster must make
+// sure that the pointee outlives the closure, as with common::Unretained().
+class InlineOnceClosure {
+ public:
+  static constexpr size_t kInlineSize = 48;
+
+  InlineOnceClosure() = default;
+  InlineOnceClosure(std::nullptr_t) {}
+
+  // Hold |closure|, which fits inline. A null |closure| gives a null InlineOnceClosure.
+  InlineOnceClosure(base::OnceClosure closure) {
+    if (!closure.is_null()) {
+      Emplace([closure = std::move(closure)]() mutable { std::move(closure).Run(); });
+    }
+  }
+
+  template <
+      typename Functor,
+      typename = std::enable_if_t<
+          !std::is_same_v<std::decay_t<Functor>, InlineOnceClosure> &&
+          !std::is_same_v<std::decay_t<Functor>, base::OnceClosure> && std::is_invocable_v<std::decay_t<Functor>&&>>>
+  InlineOnceClosure(Functor&& functor) {
+    Emplace(std::forward<Functor>(functor));
+  }
+
+  InlineOnceClosure(InlineOnceClosure&& other) noexcept {
+    MoveFrom(other);
+  }
+
+  InlineOnceClosure& operator=(InlineOnceClosure&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  InlineOnceClosure(const InlineOnceClosure&) = delete;
+  InlineOnceClosure& operator=(const InlineOnceClosure&) = delete;
+
+  ~InlineOnceClosure() {
+    Reset();
+  }
+
+  bool is_null() const {
+    return ops_ == nullptr;
+  }
+
+  explicit operator bool() const {
+    return !is_null();
+  }
+
+  // Run the functor and destroy it, which leaves this closure null. Must not be called on a null closure.
+  void Run() && {
+    const Ops* ops = ops_;
+    ops_ = nullptr;
+    ops->run_and_destroy(storage_);
+  }
+
+  // Destroy the functor without running it
+  void Reset() {
+    if (ops_ != nullptr) {
+      const Ops* ops = ops_;
+      ops_ = nullptr;
+      ops->destroy(storage_);
+    }
+  }
+
+  // Convert into a common::OnceClosure, for the contexts that only take those. Allocates a base::BindState.
+  base::OnceClosure ToOnceClosure() && {
+    if (is_null()) {
+      return base::OnceClosure();
+    }
+    return base::BindOnce([](InlineOnceClosure closure) { std::move(closure).Run(); }, std::move(*this));
+  }
+
+ private:
+  struct Ops {
+    void (*run_and_destroy)(void* storage);
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Functor>
+  static constexpr bool kFitsInline = sizeof(Functor) <= kInlineSize && alignof(Functor) <= alignof(std::max_align_t) &&
+                                      std::is_nothrow_move_constructible_v<Functor>;
+
+  template <typename Functor>
+  struct InlineOps {
+    static Functor* Get(void* storage) {
+      return std::launder(reinterpret_cast<Functor*>(storage));
+    }
+    static void RunAndDestroy(void* storage) {
+      Functor* functor = Get(storage);
+      std::move(*functor)();
+      functor->~Functor();
+    }
+    static void Move(void* from, void* to) {
+      Functor* functor = Get(from);
+      ::new (to) Functor(std::move(*functor));
+      functor->~Functor();
+    }
+    static void Destroy(void* storage) {
+      Get(storage)->~Functor();
+    }
+    static constexpr Ops kOps = {&RunAndDestroy, &Move, &Destroy};
+  };
+
+  template <typename Functor>
+  struct HeapOps {
+    static Functor*& Get(void* storage) {
+      return *std::launder(reinterpret_cast<Functor**>(storage));
+    }
+    static void RunAndDestroy(void* storage) {
+      Functor* functor = Get(storage);
+      std::move(*functor)();
+      delete functor;
+    }
+    static void Move(void* from, void* to) {
+      ::new (to) Functor*(Get(from));
+    }
+    static void Destroy(void* storage) {
+      delete Get(storage);
+    }
+    static constexpr Ops kOps = {&RunAndDestroy, &Move, &Destroy};
+  };
+
+  template <typename Functor>
+  void Emplace(Functor&& functor) {
+    using Stored = std::decay_t<Functor>;
+    if constexpr (kFitsInline<Stored>) {
+      ::new (static_cast<void*>(storage_)) Stored(std::forward<Functor>(functor));
+      ops_ = &InlineOps<Stored>::kOps;
+    } else {
+      ::new (static_cast<void*>(storage_)) Stored*(new Stored(std::forward<Functor>(functor)));
+      ops_ = &HeapOps<Stored>::kOps;
+    }
+  }
+
+  void MoveFrom(InlineOnceClosure& other) {
+    if (other.ops_ != nullptr) {
+      other.ops_->move(other.storage_, storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+  const Ops* ops_ = nullptr;
+};
+
+}  // namespace common
+}  // namespace bluetooth
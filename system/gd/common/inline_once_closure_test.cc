@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/inline_once_closure.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "common/bind.h"
+#include "common/callback.h"
+
+namespace testing {
+
+using bluetooth::common::InlineOnceClosure;
+
+namespace {
+
+// Counts the live instances of the functor that holds it
+struct Tracked {
+  explicit Tracked(int* live) : live(live) {
+    (*live)++;
+  }
+  Tracked(const Tracked& other) : live(other.live) {
+    (*live)++;
+  }
+  ~Tracked() {
+    (*live)--;
+  }
+  int* live;
+};
+
+}  // namespace
+
+TEST(InlineOnceClosureTest, null_test) {
+  InlineOnceClosure closure;
+  EXPECT_TRUE(closure.is_null());
+  EXPECT_FALSE(closure);
+  EXPECT_TRUE(InlineOnceClosure(nullptr).is_null());
+  EXPECT_TRUE(InlineOnceClosure(bluetooth::common::OnceClosure()).is_null());
+  EXPECT_TRUE(std::move(closure).ToOnceClosure().is_null());
+}
+
+TEST(InlineOnceClosureTest, run_inline_functor_test) {
+  int runs = 0;
+  auto counter = std::make_unique<int>(1);
+  InlineOnceClosure closure([&runs, counter = std::move(counter)] { runs += *counter; });
+  EXPECT_FALSE(closure.is_null());
+  std::move(closure).Run();
+  EXPECT_EQ(runs, 1);
+  EXPECT_TRUE(closure.is_null());
+}
+
+TEST(InlineOnceClosureTest, run_heap_functor_test) {
+  std::array<int, 32> values{};
+  values[31] = 42;
+  static_assert(sizeof(values) > InlineOnceClosure::kInlineSize);
+  int result = 0;
+  InlineOnceClosure closure([&result, values] { result = values[31]; });
+  InlineOnceClosure moved(std::move(closure));
+  EXPECT_TRUE(closure.is_null());  // NOLINT(bugprone-use-after-move)
+  std::move(moved).Run();
+  EXPECT_EQ(result, 42);
+}
+
+TEST(InlineOnceClosureTest, run_once_closure_test) {
+  int runs = 0;
+  InlineOnceClosure closure(bluetooth::common::BindOnce([](int* runs) { (*runs)++; }, &runs));
+  std::move(closure).Run();
+  EXPECT_EQ(runs, 1);
+}
+
+TEST(InlineOnceClosureTest, destroys_functor_once_test) {
+  int live = 0;
+  {
+    InlineOnceClosure closure([tracked = Tracked(&live)] {});
+    EXPECT_EQ(live, 1);
+    InlineOnceClosure moved;
+    moved = std::move(closure);
+    EXPECT_EQ(live, 1);
+    std::move(moved).Run();
+    EXPECT_EQ(live, 0);
+  }
+  {
+    InlineOnceClosure closure([tracked = Tracked(&live)] {});
+    closure.Reset();
+    EXPECT_EQ(live, 0);
+    InlineOnceClosure dropped([tracked = Tracked(&live)] {});
+  }
+  EXPECT_EQ(live, 0);
+}
+
+TEST(InlineOnceClosureTest, to_once_closure_test) {
+  int runs = 0;
+  InlineOnceClosure closure([&runs] { runs++; });
+  bluetooth::common::OnceClosure once_closure = std::move(closure).ToOnceClosure();
+  EXPECT_TRUE(closure.is_null());  // NOLINT(bugprone-use-after-move)
+  std::move(once_closure).Run();
+  EXPECT_EQ(runs, 1);
+}
+
+}  // namespace testing
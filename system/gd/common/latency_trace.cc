@@ -0,0 +1,178 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/latency_trace.h"
+
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+#define ATRACE_TAG ATRACE_TAG_AUDIO
+#include <cutils/trace.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "common/strings.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+constexpr size_t kNumStages = static_cast<size_t>(LatencyTraceStage::COUNT);
+constexpr size_t kDumpedEvents = 64;
+
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+constexpr std::array<const char*, kNumStages> kTrackNames = {
+    "BT HCI_ACL_RX",
+    "BT ACL_SCHEDULER_TX",
+    "BT L2CAP_SENDER_TX",
+    "BT L2CAP_RECEIVER_RX",
+    "BT LEGACY_L2CAP_TX",
+    "BT SHIM_ACL_TX",
+    "BT SHIM_ACL_RX",
+};
+#endif
+
+// Each slot is written by a single Record() call with relaxed atomics; |data| is published last so
+// a reader never sees a valid flag without the matching timestamp of some write to that slot.
+struct Slot {
+  std::atomic<int64_t> timestamp_ns{0};
+  std::atomic<uint64_t> data{0};
+};
+
+constexpr uint64_t kValidBit = uint64_t{1} << 63;
+
+uint64_t pack(LatencyTraceStage stage, uint16_t id, uint32_t size) {
+  return kValidBit | (uint64_t{static_cast<uint8_t>(stage)} << 48) | (uint64_t{id} << 32) | size;
+}
+
+std::array<Slot, LatencyTrace::kCapacity> slots_;
+std::atomic<uint64_t> next_slot_{0};
+
+}  // namespace
+
+std::atomic_bool LatencyTrace::enabled_{false};
+
+std::string LatencyTraceStageText(LatencyTraceStage stage) {
+  switch (stage) {
+    case LatencyTraceStage::HCI_ACL_RX:
+      return "HCI_ACL_RX";
+    case LatencyTraceStage::ACL_SCHEDULER_TX:
+      return "ACL_SCHEDULER_TX";
+    case LatencyTraceStage::L2CAP_SENDER_TX:
+      return "L2CAP_SENDER_TX";
+    case LatencyTraceStage::L2CAP_RECEIVER_RX:
+      return "L2CAP_RECEIVER_RX";
+    case LatencyTraceStage::LEGACY_L2CAP_TX:
+      return "LEGACY_L2CAP_TX";
+    case LatencyTraceStage::SHIM_ACL_TX:
+      return "SHIM_ACL_TX";
+    case LatencyTraceStage::SHIM_ACL_RX:
+      return "SHIM_ACL_RX";
+    case LatencyTraceStage::COUNT:
+      break;
+  }
+  return "UNKNOWN";
+}
+
+void LatencyTrace::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyTrace::Record(LatencyTraceStage stage, uint16_t id, size_t size) {
+  auto now = std::chrono::steady_clock::now();
+  uint32_t clamped_size = static_cast<uint32_t>(std::min<size_t>(size, std::numeric_limits<uint32_t>::max()));
+
+  Slot& slot = slots_[next_slot_.fetch_add(1, std::memory_order_relaxed) % kCapacity];
+  slot.data.store(0, std::memory_order_relaxed);
+  slot.timestamp_ns.store(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count(),
+      std::memory_order_relaxed);
+  slot.data.store(pack(stage, id, clamped_size), std::memory_order_release);
+
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+  if (ATRACE_ENABLED()) {
+    ATRACE_INSTANT_FOR_TRACK(
+        kTrackNames[static_cast<size_t>(stage)], StringFormat("0x%04x %u", id, clamped_size).c_str());
+  }
+#endif
+}
+
+std::vector<LatencyTrace::Event> LatencyTrace::GetEvents() {
+  uint64_t end = next_slot_.load(std::memory_order_relaxed);
+  uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+
+  std::vector<Event> events;
+  events.reserve(end - begin);
+  for (uint64_t i = begin; i < end; i++) {
+    const Slot& slot = slots_[i % kCapacity];
+    uint64_t data = slot.data.load(std::memory_order_acquire);
+    if ((data & kValidBit) == 0) {
+      continue;
+    }
+    auto stage = static_cast<LatencyTraceStage>((data >> 48) & 0xff);
+    if (stage >= LatencyTraceStage::COUNT) {
+      continue;
+    }
+    events.push_back(Event{
+        .timestamp = std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(slot.timestamp_ns.load(std::memory_order_relaxed))),
+        .stage = stage,
+        .id = static_cast<uint16_t>((data >> 32) & 0xffff),
+        .size = static_cast<uint32_t>(data & 0xffffffff),
+    });
+  }
+  return events;
+}
+
+void LatencyTrace::Clear() {
+  for (auto& slot : slots_) {
+    slot.data.store(0, std::memory_order_relaxed);
+  }
+  next_slot_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyTrace::Dump(std::ostream& os) {
+  os << "----- Latency Trace -----" << std::endl;
+  os << "enabled:" << (IsEnabled() ? "true" : "false") << std::endl;
+  auto events = GetEvents();
+  if (events.empty()) {
+    return;
+  }
+
+  std::array<size_t, kNumStages> counts{};
+  for (const auto& event : events) {
+    counts[static_cast<size_t>(event.stage)]++;
+  }
+  for (size_t i = 0; i < kNumStages; i++) {
+    os << "  " << LatencyTraceStageText(static_cast<LatencyTraceStage>(i)) << " events:" << counts[i]
+       << std::endl;
+  }
+
+  // Most recent events, with timestamps relative to the newest one.
+  auto newest = events.back().timestamp;
+  size_t first = events.size() > kDumpedEvents ? events.size() - kDumpedEvents : 0;
+  for (size_t i = first; i < events.size(); i++) {
+    const auto& event = events[i];
+    os << "  -" << std::chrono::duration_cast<std::chrono::microseconds>(newest - event.timestamp).count()
+       << "us " << LatencyTraceStageText(event.stage) << " id:" << StringFormat("0x%04x", event.id)
+       << " size:" << event.size << std::endl;
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
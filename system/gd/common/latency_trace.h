@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// Points in the data path where a packet is timestamped. |id| is the ACL handle for the HCI, ACL
+// and shim stages, and the local channel id for the gd L2CAP stages.
+enum class LatencyTraceStage : uint8_t {
+  HCI_ACL_RX,
+  ACL_SCHEDULER_TX,
+  L2CAP_SENDER_TX,
+  L2CAP_RECEIVER_RX,
+  LEGACY_L2CAP_TX,
+  SHIM_ACL_TX,
+  SHIM_ACL_RX,
+  COUNT,
+};
+
+std::string LatencyTraceStageText(LatencyTraceStage stage);
+
+// Process wide ring buffer of data path timestamps.
+//
+// Recording is disabled by default; when disabled a trace point costs a single relaxed atomic
+// load. When enabled, each event takes one slot of a fixed size ring without locking, and is also
+// emitted as an instant event on a per-stage atrace track so it shows up in Perfetto.
+class LatencyTrace {
+ public:
+  static constexpr size_t kCapacity = 1024;
+
+  struct Event {
+    std::chrono::steady_clock::time_point timestamp;
+    LatencyTraceStage stage;
+    uint16_t id;
+    uint32_t size;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  static void Record(LatencyTraceStage stage, uint16_t id, size_t size);
+
+  // Returns the recorded events, oldest first.
+  static std::vector<Event> GetEvents();
+  static void Clear();
+  static void Dump(std::ostream& os);
+
+ private:
+  static std::atomic_bool enabled_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
+
+#ifdef BLUETOOTH_DISABLE_LATENCY_TRACE
+#define BT_TRACE_LATENCY(stage, id, size) \
+  do {                                    \
+  } while (0)
+#else
+#define BT_TRACE_LATENCY(stage, id, size)                                                                     \
+  do {                                                                                                        \
+    if (::bluetooth::common::LatencyTrace::IsEnabled()) {                                                     \
+      ::bluetooth::common::LatencyTrace::Record(::bluetooth::common::LatencyTraceStage::stage, (id), (size)); \
+    }                                                                                                         \
+  } while (0)
+#endif
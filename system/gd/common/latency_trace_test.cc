@@ -0,0 +1,83 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/latency_trace.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+class LatencyTraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    LatencyTrace::Clear();
+    LatencyTrace::SetEnabled(true);
+  }
+
+  void TearDown() override {
+    LatencyTrace::SetEnabled(false);
+    LatencyTrace::Clear();
+  }
+};
+
+TEST_F(LatencyTraceTest, disabled_trace_points_record_nothing) {
+  LatencyTrace::SetEnabled(false);
+  BT_TRACE_LATENCY(HCI_ACL_RX, 0x0001, 10);
+  ASSERT_TRUE(LatencyTrace::GetEvents().empty());
+}
+
+TEST_F(LatencyTraceTest, events_are_returned_in_order) {
+  BT_TRACE_LATENCY(SHIM_ACL_TX, 0x0001, 10);
+  BT_TRACE_LATENCY(ACL_SCHEDULER_TX, 0x0002, 20);
+
+  auto events = LatencyTrace::GetEvents();
+  ASSERT_EQ(2ul, events.size());
+  ASSERT_EQ(LatencyTraceStage::SHIM_ACL_TX, events[0].stage);
+  ASSERT_EQ(0x0001, events[0].id);
+  ASSERT_EQ(10u, events[0].size);
+  ASSERT_EQ(LatencyTraceStage::ACL_SCHEDULER_TX, events[1].stage);
+  ASSERT_EQ(0x0002, events[1].id);
+  ASSERT_EQ(20u, events[1].size);
+  ASSERT_LE(events[0].timestamp, events[1].timestamp);
+}
+
+TEST_F(LatencyTraceTest, ring_keeps_most_recent_events) {
+  for (size_t i = 0; i < LatencyTrace::kCapacity + 10; i++) {
+    LatencyTrace::Record(LatencyTraceStage::L2CAP_SENDER_TX, 0x0040, i);
+  }
+
+  auto events = LatencyTrace::GetEvents();
+  ASSERT_EQ(LatencyTrace::kCapacity, events.size());
+  ASSERT_EQ(10u, events.front().size);
+  ASSERT_EQ(LatencyTrace::kCapacity + 9, events.back().size);
+}
+
+TEST_F(LatencyTraceTest, dump) {
+  BT_TRACE_LATENCY(HCI_ACL_RX, 0x0001, 10);
+
+  std::ostringstream oss;
+  LatencyTrace::Dump(oss);
+  ASSERT_NE(std::string::npos, oss.str().find("HCI_ACL_RX events:1"));
+  ASSERT_NE(std::string::npos, oss.str().find("id:0x0001 size:10"));
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
@@ -35,7 +35,8 @@ namespace common {
 //   - Key look-up and modification is O(1)
 //   - Value operated by replacement, no in-place modification
 //   - Memory consumption is:
-//     O(2*capacity*sizeof(K) + capacity*(sizeof(nullptr)+sizeof(V)))
+//     O(capacity*sizeof(K) + capacity*(2*sizeof(nullptr)+sizeof(V))), keys are only stored in the list and the index
+//     refers to them
 //   - NOT THREAD SAFE
 //
 // Template:
@@ -126,7 +127,7 @@ class ListMap {
       return std::make_pair(end(), false);
     }
     auto list_iterator = node_list_.emplace(pos, key, std::forward<Args>(args)...);
-    key_map_.emplace(key, list_iterator);
+    key_map_.emplace(list_iterator->first, list_iterator);
     return std::make_pair(list_iterator, true);
   }
 
@@ -147,7 +148,7 @@ class ListMap {
       return;
     }
     auto list_iterator = node_list_.emplace(pos, key, std::move(value));
-    key_map_.emplace(key, list_iterator);
+    key_map_.emplace(list_iterator->first, list_iterator);
   }
 
   // Put a key-value pair to the tail of the map or replace the current value without moving the key if key exists
@@ -174,9 +175,10 @@ class ListMap {
     if (map_iterator == key_map_.end()) {
       return std::nullopt;
     }
-    std::optional<node_type> removed_node(std::move(*map_iterator->second));
-    node_list_.erase(map_iterator->second);
+    auto list_iterator = map_iterator->second;
     key_map_.erase(map_iterator);
+    std::optional<node_type> removed_node(std::move(*list_iterator));
+    node_list_.erase(list_iterator);
     return removed_node;
   }
 
@@ -213,7 +215,8 @@ class ListMap {
 
  private:
   std::list<value_type> node_list_;
-  std::unordered_map<Key, iterator> key_map_;
+  // List nodes never move, including across splice() and move construction, so the index can refer to their keys
+  std::unordered_map<std::reference_wrapper<const Key>, iterator, std::hash<Key>, std::equal_to<Key>> key_map_;
 };
 
 }  // namespace common
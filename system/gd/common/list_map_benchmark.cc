@@ -0,0 +1,90 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "common/flat_list_map.h"
+#include "common/list_map.h"
+#include "common/lru_cache.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+// Same key as the LE scanning deduplicator: an address and advertising data hash packed into 64 bits
+static uint64_t KeyAt(int64_t index) {
+  return static_cast<uint64_t>(index) * 0x9e3779b97f4a7c15ull;
+}
+
+// Insert state.range(0) entries into an empty map
+template <typename Map>
+static void BM_Insert(State& state) {
+  int64_t count = state.range(0);
+  for (auto _ : state) {
+    Map map;
+    for (int64_t i = 0; i < count; i++) {
+      map.insert_or_assign(KeyAt(i), i);
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK_TEMPLATE(BM_Insert, ListMap<uint64_t, int64_t>)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_Insert, FlatListMap<uint64_t, int64_t>)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Look up present and absent keys, half of each, in a map of state.range(0) entries
+template <typename Map>
+static void BM_Find(State& state) {
+  int64_t count = state.range(0);
+  Map map;
+  for (int64_t i = 0; i < count; i++) {
+    map.insert_or_assign(KeyAt(i), i);
+  }
+  // Visit the keys out of insertion order, so that allocation order does not help the nodes of ListMap stay in cache
+  uint64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(KeyAt(static_cast<int64_t>((i * 7919) % (2 * count)))));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Find, ListMap<uint64_t, int64_t>)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_Find, FlatListMap<uint64_t, int64_t>)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Keep a full cache of state.range(0) entries, and per iteration refresh one entry and insert a new one, which evicts
+// the least recently used entry
+template <typename Cache>
+static void BM_LruEvict(State& state) {
+  int64_t count = state.range(0);
+  Cache cache(static_cast<size_t>(count));
+  int64_t inserted = 0;
+  for (; inserted < count; inserted++) {
+    cache.insert_or_assign(KeyAt(inserted), inserted);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.find(KeyAt(inserted - count / 2)));
+    benchmark::DoNotOptimize(cache.insert_or_assign(KeyAt(inserted), inserted));
+    inserted++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LruEvict, LruCache<uint64_t, int64_t>)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_LruEvict, FlatLruCache<uint64_t, int64_t>)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace common
+}  // namespace bluetooth
@@ -26,6 +26,7 @@
 #include <thread>
 #include <unordered_map>
 
+#include "common/flat_list_map.h"
 #include "common/list_map.h"
 #include "os/log.h"
 
@@ -50,19 +51,21 @@ namespace common {
 // Template:
 //   - Key key type
 //   - T value type
+//   - Map the ordered map holding the entries, ListMap or FlatListMap
 // */
-template <typename Key, typename T>
+template <typename Key, typename T, typename Map = ListMap<Key, T>>
 class LruCache {
  public:
-  using value_type = typename ListMap<Key, T>::value_type;
+  using value_type = typename Map::value_type;
   // different from c++17 node_type on purpose as we want node to be copyable
-  using node_type = typename ListMap<Key, T>::node_type;
-  using iterator = typename ListMap<Key, T>::iterator;
-  using const_iterator = typename ListMap<Key, T>::const_iterator;
+  using node_type = typename Map::node_type;
+  using iterator = typename Map::iterator;
+  using const_iterator = typename Map::const_iterator;
 
   // Constructor a LRU cache with |capacity|
   explicit LruCache(size_t capacity) : capacity_(capacity) {
     log::assert_that(capacity_ != 0, "Unable to have 0 LRU Cache capacity");
+    reserve_capacity();
   }
 
   // for move
@@ -71,7 +74,9 @@ class LruCache {
 
   // copy-constructor
   // iterators in key_map_ cannot be copied directly
-  LruCache(const LruCache& other) : capacity_(other.capacity_), list_map_(other.list_map_) {}
+  LruCache(const LruCache& other) : capacity_(other.capacity_), list_map_(other.list_map_) {
+    reserve_capacity();
+  }
 
   // copy-assignment
   // iterators in key_map_ cannot be copied directly
@@ -81,6 +86,7 @@ class LruCache {
     }
     capacity_ = other.capacity_;
     list_map_ = other.list_map_;
+    reserve_capacity();
     return *this;
   }
 
@@ -213,9 +219,20 @@ class LruCache {
   }
 
  private:
+  // A flat map holds all the entries up to the capacity without allocating, and without moving them
+  void reserve_capacity() {
+    if constexpr (requires(Map map) { map.reserve(size_t{}); }) {
+      list_map_.reserve(capacity_);
+    }
+  }
+
   size_t capacity_;
-  ListMap<Key, T> list_map_;
+  Map list_map_;
 };
 
+// An LruCache stored in a FlatListMap, which has better locality and does not allocate once constructed
+template <typename Key, typename T>
+using FlatLruCache = LruCache<Key, T, FlatListMap<Key, T>>;
+
 }  // namespace common
 }  // namespace bluetooth
@@ -23,6 +23,7 @@
 
 namespace testing {
 
+using bluetooth::common::FlatLruCache;
 using bluetooth::common::LruCache;
 
 TEST(LruCacheTest, empty_test) {
@@ -449,4 +450,27 @@ TEST(LruCacheTest, pressure_test) {
   EXPECT_EQ(cache.size(), 0ul);
 }
 
+TEST(FlatLruCacheTest, evicts_least_recently_used_test) {
+  FlatLruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  EXPECT_NE(cache.find(1), cache.end());
+  auto evicted = cache.insert_or_assign(3, 30);
+  ASSERT_TRUE(evicted);
+  EXPECT_EQ(evicted->first, 2);
+  EXPECT_THAT(cache, ElementsAre(Pair(3, 30), Pair(1, 10)));
+}
+
+TEST(FlatLruCacheTest, copy_keeps_order_test) {
+  FlatLruCache<int, int> cache(3);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  FlatLruCache<int, int> copy(cache);
+  EXPECT_EQ(copy, cache);
+  copy.insert_or_assign(3, 30);
+  copy.insert_or_assign(4, 40);
+  EXPECT_THAT(copy, ElementsAre(Pair(4, 40), Pair(3, 30), Pair(2, 20)));
+  EXPECT_THAT(cache, ElementsAre(Pair(2, 20), Pair(1, 10)));
+}
+
 }  // namespace testing
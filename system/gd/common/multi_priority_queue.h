@@ -18,8 +18,14 @@
 
 #pragma once
 
+#include <bluetooth/log.h>
+
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <queue>
+#include <utility>
 
 namespace bluetooth {
 namespace common {
@@ -71,5 +77,94 @@ class MultiPriorityQueue {
   std::priority_queue<int> next_to_dequeue_;
 };
 
+/**
+ * A MultiPriorityQueue holding up to CAPACITY items per priority level, which never allocates after construction.
+ * Each level is a ring buffer, and a bitmask of the non empty levels gives the level to dequeue from in one
+ * instruction. Pushing to a full level is not allowed, check full() first.
+ */
+template <typename T, int NUM_PRIORITY_LEVELS = 2, size_t CAPACITY = 64>
+class BoundedMultiPriorityQueue {
+  static_assert(NUM_PRIORITY_LEVELS > 1 && NUM_PRIORITY_LEVELS <= 32);
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+ public:
+  BoundedMultiPriorityQueue() = default;
+  BoundedMultiPriorityQueue(const BoundedMultiPriorityQueue&) = delete;
+  BoundedMultiPriorityQueue& operator=(const BoundedMultiPriorityQueue&) = delete;
+
+  ~BoundedMultiPriorityQueue() {
+    while (!empty()) {
+      pop();
+    }
+  }
+
+  // Get the front item with the highest priority.  Queue must be non-empty.
+  T& front() {
+    int priority = highest_non_empty();
+    return *slot(priority, heads_[priority]);
+  }
+
+  [[nodiscard]] bool empty() const {
+    return non_empty_ == 0;
+  }
+
+  [[nodiscard]] size_t size() const {
+    return size_;
+  }
+
+  // Whether the level of |priority| cannot take another item
+  [[nodiscard]] bool full(int priority = 0) const {
+    return counts_[priority] == CAPACITY;
+  }
+
+  // Push the item with specified priority
+  void push(const T& t, int priority = 0) {
+    emplace(priority, t);
+  }
+
+  // Push the item with specified priority
+  void push(T&& t, int priority = 0) {
+    emplace(priority, std::move(t));
+  }
+
+  // Pop the item in the front
+  void pop() {
+    int priority = highest_non_empty();
+    slot(priority, heads_[priority])->~T();
+    heads_[priority] = (heads_[priority] + 1) & (CAPACITY - 1);
+    if (--counts_[priority] == 0) {
+      non_empty_ &= ~(1u << priority);
+    }
+    size_--;
+  }
+
+ private:
+  template <typename U>
+  void emplace(int priority, U&& t) {
+    log::assert_that(!full(priority), "priority level {} is full", priority);
+    new (slot(priority, (heads_[priority] + counts_[priority]) & (CAPACITY - 1))) T(std::forward<U>(t));
+    counts_[priority]++;
+    non_empty_ |= 1u << priority;
+    size_++;
+  }
+
+  int highest_non_empty() const {
+    return 31 - __builtin_clz(non_empty_);
+  }
+
+  T* slot(int priority, size_t index) {
+    return std::launder(reinterpret_cast<T*>(&storage_[priority][index]));
+  }
+
+  struct alignas(T) Storage {
+    unsigned char bytes[sizeof(T)];
+  };
+  std::array<std::array<Storage, CAPACITY>, NUM_PRIORITY_LEVELS> storage_;
+  std::array<size_t, NUM_PRIORITY_LEVELS> heads_{};
+  std::array<size_t, NUM_PRIORITY_LEVELS> counts_{};
+  uint32_t non_empty_ = 0;  // Bit i is set when priority level i has items
+  size_t size_ = 0;
+};
+
 }  // namespace common
 }  // namespace bluetooth
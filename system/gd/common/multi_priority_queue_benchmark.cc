@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "common/multi_priority_queue.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+// Same item as the L2CAP Fifo scheduler: a channel id and a number of packets
+using Item = std::pair<uint16_t, int>;
+
+// Keep state.range(0) items queued, one in four of them high priority, and pop then push one item per iteration the
+// way the schedulers do
+template <typename Queue>
+static void BM_PushPop(State& state) {
+  Queue queue;
+  int64_t depth = state.range(0);
+  int64_t pushed = 0;
+  for (; pushed < depth; pushed++) {
+    queue.push(Item(static_cast<uint16_t>(pushed), 1), pushed % 4 == 0);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(queue.front());
+    queue.pop();
+    queue.push(Item(static_cast<uint16_t>(pushed), 1), pushed % 4 == 0);
+    pushed++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_PushPop, MultiPriorityQueue<Item, 2>)->Arg(1)->Arg(16)->Arg(48);
+BENCHMARK_TEMPLATE(BM_PushPop, BoundedMultiPriorityQueue<Item, 2, 64>)->Arg(1)->Arg(16)->Arg(48);
+
+// Fill the queue with state.range(0) items and drain it, as a burst of packets does
+template <typename Queue>
+static void BM_FillDrain(State& state) {
+  Queue queue;
+  int64_t count = state.range(0);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < count; i++) {
+      queue.push(Item(static_cast<uint16_t>(i), 1), i % 4 == 0);
+    }
+    while (!queue.empty()) {
+      benchmark::DoNotOptimize(queue.front());
+      queue.pop();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK_TEMPLATE(BM_FillDrain, MultiPriorityQueue<Item, 2>)->Arg(16)->Arg(48);
+BENCHMARK_TEMPLATE(BM_FillDrain, BoundedMultiPriorityQueue<Item, 2, 64>)->Arg(16)->Arg(48);
+
+}  // namespace common
+}  // namespace bluetooth
@@ -18,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+
 #include "common/multi_priority_queue.h"
 
 namespace bluetooth {
@@ -59,5 +61,56 @@ TEST(MultiPriorityQueueTest, with_multiple_priority_item) {
   }
 }
 
+TEST(BoundedMultiPriorityQueueTest, with_multiple_priority_item) {
+  common::BoundedMultiPriorityQueue<int, 3, 4> q;
+  ASSERT_TRUE(q.empty());
+  q.push(2, 1);
+  q.push(0, 2);
+  q.push(3, 0);
+  q.push(1, 2);
+  ASSERT_EQ(q.size(), 4ul);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(q.front(), i);
+    q.pop();
+  }
+  ASSERT_TRUE(q.empty());
+}
+
+TEST(BoundedMultiPriorityQueueTest, full_level_wraps_around) {
+  common::BoundedMultiPriorityQueue<int, 2, 4> q;
+  int next_push = 0;
+  int next_pop = 0;
+  for (int round = 0; round < 3; round++) {
+    while (!q.full()) {
+      q.push(next_push++);
+    }
+    ASSERT_EQ(q.size(), 4ul);
+    // The other level is independent
+    ASSERT_FALSE(q.full(1));
+    q.pop();
+    q.pop();
+    next_pop += 2;
+  }
+  while (!q.empty()) {
+    ASSERT_EQ(q.front(), next_pop++);
+    q.pop();
+  }
+  ASSERT_EQ(next_pop, next_push);
+}
+
+TEST(BoundedMultiPriorityQueueTest, move_only_items_are_released) {
+  auto item = std::make_shared<int>(0);
+  {
+    common::BoundedMultiPriorityQueue<std::unique_ptr<std::shared_ptr<int>>, 2, 2> q;
+    q.push(std::make_unique<std::shared_ptr<int>>(item));
+    q.push(std::make_unique<std::shared_ptr<int>>(item), 1);
+    q.push(std::make_unique<std::shared_ptr<int>>(item), 1);
+    ASSERT_EQ(item.use_count(), 4);
+    q.pop();
+    ASSERT_EQ(item.use_count(), 3);
+  }
+  ASSERT_EQ(item.use_count(), 1);
+}
+
 }  // namespace common
 }  // namespace bluetooth
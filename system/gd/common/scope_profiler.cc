@@ -0,0 +1,199 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/scope_profiler.h"
+
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+#define ATRACE_TAG ATRACE_TAG_APP
+#include <cutils/trace.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+constexpr size_t kNumScopes = static_cast<size_t>(ProfileScope::COUNT);
+
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+constexpr std::array<const char*, kNumScopes> kSliceNames = {
+    "BT HCI_EVENT",
+    "BT HCI_ACL_RX",
+    "BT L2CAP_ACL_RX",
+    "BT L2CAP_SEND_PKTS",
+    "BT A2DP_SOURCE_TICK",
+    "BT ISO_TX",
+    "BT ISO_RX",
+    "BT GATT_DATA_RX",
+    "BT GATT_SERVER_REQ",
+};
+#endif
+
+// Only written by the thread owning it, so updates are plain loads and stores; the counters are atomic
+// only so that GetStats() can read them from another thread.
+struct Counter {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total_ns{0};
+  std::atomic<uint64_t> max_ns{0};
+};
+
+struct Totals {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+
+  void Add(const Counter& counter) {
+    count += counter.count.load(std::memory_order_relaxed);
+    total_ns += counter.total_ns.load(std::memory_order_relaxed);
+    max_ns = std::max(max_ns, counter.max_ns.load(std::memory_order_relaxed));
+  }
+};
+
+struct ThreadCounters;
+
+// The counters of the running threads, and the totals of the threads that exited. Never destroyed, so
+// threads can still exit while the process is shutting down.
+struct Registry {
+  std::mutex mutex;
+  std::vector<const ThreadCounters*> threads;
+  std::array<Totals, kNumScopes> exited;
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+struct ThreadCounters {
+  ThreadCounters() {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(this);
+  }
+
+  ~ThreadCounters() {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (size_t i = 0; i < kNumScopes; i++) {
+      registry.exited[i].Add(scopes[i]);
+    }
+    registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+  }
+
+  std::array<Counter, kNumScopes> scopes;
+};
+
+ThreadCounters& GetThreadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+}  // namespace
+
+std::atomic_bool ScopeProfiler::enabled_{false};
+
+std::string ProfileScopeText(ProfileScope scope) {
+  switch (scope) {
+    case ProfileScope::HCI_EVENT:
+      return "HCI_EVENT";
+    case ProfileScope::HCI_ACL_RX:
+      return "HCI_ACL_RX";
+    case ProfileScope::L2CAP_ACL_RX:
+      return "L2CAP_ACL_RX";
+    case ProfileScope::L2CAP_SEND_PKTS:
+      return "L2CAP_SEND_PKTS";
+    case ProfileScope::A2DP_SOURCE_TICK:
+      return "A2DP_SOURCE_TICK";
+    case ProfileScope::ISO_TX:
+      return "ISO_TX";
+    case ProfileScope::ISO_RX:
+      return "ISO_RX";
+    case ProfileScope::GATT_DATA_RX:
+      return "GATT_DATA_RX";
+    case ProfileScope::GATT_SERVER_REQ:
+      return "GATT_SERVER_REQ";
+    case ProfileScope::COUNT:
+      break;
+  }
+  return "UNKNOWN";
+}
+
+void ScopeProfiler::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+std::chrono::steady_clock::time_point ScopeProfiler::Begin(ProfileScope scope) {
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+  ATRACE_BEGIN(kSliceNames[static_cast<size_t>(scope)]);
+#else
+  (void)scope;
+#endif
+  return std::chrono::steady_clock::now();
+}
+
+void ScopeProfiler::End(ProfileScope scope, std::chrono::steady_clock::time_point begin) {
+  uint64_t duration_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+  ATRACE_END();
+#endif
+
+  Counter& counter = GetThreadCounters().scopes[static_cast<size_t>(scope)];
+  counter.count.store(counter.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  counter.total_ns.store(counter.total_ns.load(std::memory_order_relaxed) + duration_ns, std::memory_order_relaxed);
+  if (duration_ns > counter.max_ns.load(std::memory_order_relaxed)) {
+    counter.max_ns.store(duration_ns, std::memory_order_relaxed);
+  }
+}
+
+ScopeProfiler::Stats ScopeProfiler::GetStats(ProfileScope scope) {
+  size_t index = static_cast<size_t>(scope);
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  Totals totals = registry.exited[index];
+  for (const ThreadCounters* thread : registry.threads) {
+    totals.Add(thread->scopes[index]);
+  }
+  return Stats{
+      .count = totals.count,
+      .total = std::chrono::nanoseconds(totals.total_ns),
+      .max = std::chrono::nanoseconds(totals.max_ns),
+  };
+}
+
+void ScopeProfiler::Dump(std::ostream& os) {
+  os << "----- Scope Profiler -----" << std::endl;
+  os << "enabled:" << (IsEnabled() ? "true" : "false") << std::endl;
+  for (size_t i = 0; i < kNumScopes; i++) {
+    auto scope = static_cast<ProfileScope>(i);
+    Stats stats = GetStats(scope);
+    if (stats.count == 0) {
+      continue;
+    }
+    auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(stats.total).count();
+    os << "  " << ProfileScopeText(scope) << " count:" << stats.count << " total_us:" << total_us
+       << " avg_us:" << total_us / static_cast<int64_t>(stats.count)
+       << " max_us:" << std::chrono::duration_cast<std::chrono::microseconds>(stats.max).count() << std::endl;
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace bluetooth {
+namespace common {
+
+// Hot path scopes timed by BT_PROFILE_SCOPE.
+enum class ProfileScope : uint8_t {
+  HCI_EVENT,
+  HCI_ACL_RX,
+  L2CAP_ACL_RX,
+  L2CAP_SEND_PKTS,
+  A2DP_SOURCE_TICK,
+  ISO_TX,
+  ISO_RX,
+  GATT_DATA_RX,
+  GATT_SERVER_REQ,
+  COUNT,
+};
+
+std::string ProfileScopeText(ProfileScope scope);
+
+// Process wide count, total and maximum duration of each profiled scope.
+//
+// Profiling is disabled by default; when disabled a profiled scope costs a single relaxed atomic load.
+// When enabled, each thread accumulates into its own counters without locking or atomic read-modify-write
+// operations, and the counters of all the threads are summed when read. Each scope run is also emitted as
+// an atrace slice named after the scope, so it shows up on the thread track in Perfetto.
+class ScopeProfiler {
+ public:
+  struct Stats {
+    uint64_t count;
+    std::chrono::nanoseconds total;
+    std::chrono::nanoseconds max;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  static std::chrono::steady_clock::time_point Begin(ProfileScope scope);
+  static void End(ProfileScope scope, std::chrono::steady_clock::time_point begin);
+
+  // Returns the stats of |scope| summed over all the threads, including the threads that exited.
+  static Stats GetStats(ProfileScope scope);
+  static void Dump(std::ostream& os);
+
+ private:
+  static std::atomic_bool enabled_;
+};
+
+// Times the enclosing scope when profiling was enabled as it was entered.
+class ScopedProfile {
+ public:
+  explicit ScopedProfile(ProfileScope scope) : scope_(scope), active_(ScopeProfiler::IsEnabled()) {
+    if (active_) {
+      begin_ = ScopeProfiler::Begin(scope_);
+    }
+  }
+
+  ~ScopedProfile() {
+    if (active_) {
+      ScopeProfiler::End(scope_, begin_);
+    }
+  }
+
+  ScopedProfile(const ScopedProfile&) = delete;
+  ScopedProfile& operator=(const ScopedProfile&) = delete;
+
+ private:
+  ProfileScope scope_;
+  bool active_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
+
+#define BT_PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define BT_PROFILE_SCOPE_NAME_(line) BT_PROFILE_SCOPE_CONCAT_(bt_profile_scope_, line)
+
+#ifdef BLUETOOTH_DISABLE_SCOPE_PROFILER
+#define BT_PROFILE_SCOPE(scope) \
+  do {                          \
+  } while (0)
+#else
+#define BT_PROFILE_SCOPE(scope) \
+  ::bluetooth::common::ScopedProfile BT_PROFILE_SCOPE_NAME_(__LINE__)(::bluetooth::common::ProfileScope::scope)
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/scope_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+class ScopeProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ScopeProfiler::SetEnabled(true);
+  }
+
+  void TearDown() override {
+    ScopeProfiler::SetEnabled(false);
+  }
+};
+
+void ProfiledSleep(std::chrono::milliseconds duration) {
+  BT_PROFILE_SCOPE(L2CAP_ACL_RX);
+  std::this_thread::sleep_for(duration);
+}
+
+TEST_F(ScopeProfilerTest, disabled_scopes_record_nothing) {
+  ScopeProfiler::SetEnabled(false);
+  auto before = ScopeProfiler::GetStats(ProfileScope::HCI_EVENT);
+  {
+    BT_PROFILE_SCOPE(HCI_EVENT);
+  }
+  ASSERT_EQ(before.count, ScopeProfiler::GetStats(ProfileScope::HCI_EVENT).count);
+}
+
+TEST_F(ScopeProfilerTest, scopes_are_counted_and_timed) {
+  auto before = ScopeProfiler::GetStats(ProfileScope::L2CAP_ACL_RX);
+  ProfiledSleep(std::chrono::milliseconds(2));
+  ProfiledSleep(std::chrono::milliseconds(5));
+
+  auto stats = ScopeProfiler::GetStats(ProfileScope::L2CAP_ACL_RX);
+  ASSERT_EQ(before.count + 2, stats.count);
+  ASSERT_GE(stats.total - before.total, std::chrono::milliseconds(7));
+  ASSERT_GE(stats.max, std::chrono::milliseconds(5));
+}
+
+TEST_F(ScopeProfilerTest, counts_of_exited_threads_are_kept) {
+  auto before = ScopeProfiler::GetStats(ProfileScope::ISO_TX);
+  std::thread first([] {
+    for (int i = 0; i < 10; i++) {
+      BT_PROFILE_SCOPE(ISO_TX);
+    }
+  });
+  std::thread second([] {
+    for (int i = 0; i < 5; i++) {
+      BT_PROFILE_SCOPE(ISO_TX);
+    }
+  });
+  first.join();
+  second.join();
+
+  ASSERT_EQ(before.count + 15, ScopeProfiler::GetStats(ProfileScope::ISO_TX).count);
+}
+
+TEST_F(ScopeProfilerTest, dump) {
+  {
+    BT_PROFILE_SCOPE(GATT_SERVER_REQ);
+  }
+
+  std::ostringstream oss;
+  ScopeProfiler::Dump(oss);
+  ASSERT_NE(std::string::npos, oss.str().find("enabled:true"));
+  ASSERT_NE(std::string::npos, oss.str().find("GATT_SERVER_REQ count:"));
+  ASSERT_EQ(std::string::npos, oss.str().find("A2DP_SOURCE_TICK"));
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
@@ -54,7 +54,7 @@ bool IsValidHexString(const std::string& str) {
   return std::find_if_not(str.begin(), str.end(), IsHexDigit{}) == str.end();
 }
 
-std::optional<std::vector<uint8_t>> FromHexString(const std::string& str) {
+std::optional<std::vector<uint8_t>> FromHexString(std::string_view str) {
   if (str.size() % 2 != 0) {
     log::info("str size is not divisible by 2, size is {}", str.size());
     return std::nullopt;
@@ -67,7 +67,7 @@ std::optional<std::vector<uint8_t>> FromHexString(const std::string& str) {
   value.reserve(str.size() / 2);
   for (size_t i = 0; i < str.size(); i += 2) {
     uint8_t v = 0;
-    auto ret = std::from_chars(str.c_str() + i, str.c_str() + i + 2, v, 16);
+    auto ret = std::from_chars(str.data() + i, str.data() + i + 2, v, 16);
     if (std::make_error_code(ret.ec)) {
       log::info("failed to parse hex char at index {}", i);
       return std::nullopt;
@@ -28,6 +28,7 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -95,7 +96,7 @@ std::string ToHexString(const std::vector<uint8_t>& value);
 bool IsValidHexString(const std::string& str);
 
 // Parse |str| into a vector of uint8_t, |str| must contains only hex decimal
-std::optional<std::vector<uint8_t>> FromHexString(const std::string& str);
+std::optional<std::vector<uint8_t>> FromHexString(std::string_view str);
 
 // Remove whitespace from both ends of the |str|, returning a copy
 std::string StringTrim(std::string str);
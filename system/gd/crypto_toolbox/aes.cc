@@ -64,6 +64,7 @@
 #endif
 
 #include "aes.h"
+#include "aes_hw.h"
 
 #if defined(HAVE_UINT_32T)
 typedef uint32_t uint_32t;
@@ -544,6 +545,15 @@ return_type aes_set_key(const unsigned char key[], length_type keylen, aes_conte
 /*  Encrypt a single block of 16 bytes */
 
 return_type aes_encrypt(const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]) {
+  if (ctx->rnd && aes_hw_is_supported()) {
+    aes_hw_encrypt(in, out, ctx);
+    return 0;
+  }
+  return aes_encrypt_software(in, out, ctx);
+}
+
+return_type aes_encrypt_software(
+    const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]) {
   if (ctx->rnd) {
     uint_8t s1[N_BLOCK], r;
     copy_and_key(s1, in, ctx->ksch);
@@ -85,8 +85,13 @@ return_type aes_set_key(const unsigned char key[], length_type keylen, aes_conte
 
 #if defined(AES_ENC_PREKEYED)
 
+/* Uses the CPU instructions when available, see aes_hw.h */
 return_type aes_encrypt(const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]);
 
+/* Portable table based implementation */
+return_type aes_encrypt_software(
+    const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]);
+
 return_type aes_cbc_encrypt(
     const unsigned char* in, unsigned char* out, int n_block, unsigned char iv[N_BLOCK], const aes_context ctx[1]);
 #endif
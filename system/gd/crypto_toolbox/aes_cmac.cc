@@ -62,23 +62,36 @@ static void xor_128(Octet16* a, const Octet16& b) {
 }
 }  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
+/** Expand |key|, in little endian order, into |ctx| */
+static void aes_128_set_key(const Octet16& key, aes_context* ctx) {
   Octet16 key_reversed;
+  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+  aes_set_key(key_reversed.data(), key_reversed.size(), ctx);
+  key_reversed.fill(0);
+}
+
+/** This function computes AES_128(key, message) with the key expanded by
+ * aes_128_set_key() */
+static Octet16 aes_128(const aes_context& ctx, const Octet16& message) {
   Octet16 message_reversed;
   Octet16 output;
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
   std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
-
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
   aes_encrypt(message_reversed.data(), output.data(), &ctx);
 
   std::reverse(output.begin(), output.end());
   return output;
 }
 
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+  Octet16 output = aes_128(ctx, message);
+  memset(&ctx, 0, sizeof(ctx));
+  return output;
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * kOctet16Length memory space; where include length bytes valid data. */
@@ -101,7 +114,7 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
 }
 
 /** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+static Octet16 cmac_aes_k_calculate(const aes_context& ctx) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -110,7 +123,7 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
     /* Mi' := Mi (+) X  */
     xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length], x);
 
-    output = aes_128(key, *(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length]);
+    output = aes_128(ctx, *(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length]);
     x = output;
     i++;
   }
@@ -139,11 +152,11 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 }
 
 /** This is the function to generate the two subkeys.
- * |key| is CMAC key, expect SRK when used by SMP.
+ * |ctx| is the expanded CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
+static void cmac_generate_subkey(const aes_context& ctx) {
   Octet16 zero{};
-  Octet16 p = aes_128(key, zero);
+  Octet16 p = aes_128(ctx, zero);
 
   Octet16 k1, k2;
   uint8_t* pp = p.data();
@@ -196,12 +209,17 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
     cmac_cb.len = 0;
   }
 
+  /* the key is expanded once for the subkey and all the blocks */
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+
   /* prepare calculation for subkey s and last block of data */
-  cmac_generate_subkey(key);
+  cmac_generate_subkey(ctx);
   /* start calculation */
-  Octet16 signature = cmac_aes_k_calculate(key);
+  Octet16 signature = cmac_aes_k_calculate(ctx);
 
   /* clean up */
+  memset(&ctx, 0, sizeof(ctx));
   memset(&cmac_cb, 0, sizeof(tCMAC_CB));
   // cmac_cb.text is auto-freed by alloca
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aes_hw.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <wmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#endif
+
+/* The key schedule of aes_set_key() holds the round keys in the byte order of
+ * FIPS-197, which is what the CPU instructions expect. */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+bool aes_hw_is_supported() {
+  static const bool supported = __builtin_cpu_supports("aes");
+  return supported;
+}
+
+__attribute__((target("aes"))) void aes_hw_encrypt(
+    const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]) {
+  const __m128i* round_keys = reinterpret_cast<const __m128i*>(ctx->ksch);
+  __m128i state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_loadu_si128(round_keys));
+  for (int r = 1; r < ctx->rnd; r++) {
+    state = _mm_aesenc_si128(state, _mm_loadu_si128(round_keys + r));
+  }
+  state = _mm_aesenclast_si128(state, _mm_loadu_si128(round_keys + ctx->rnd));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+#elif defined(__aarch64__)
+
+bool aes_hw_is_supported() {
+  static const bool supported = (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+  return supported;
+}
+
+#if defined(__clang__)
+__attribute__((target("aes")))
+#else
+__attribute__((target("+crypto")))
+#endif
+void aes_hw_encrypt(const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]) {
+  uint8x16_t state = vld1q_u8(in);
+  for (int r = 0; r < ctx->rnd - 1; r++) {
+    state = vaesmcq_u8(vaeseq_u8(state, vld1q_u8(ctx->ksch + r * N_BLOCK)));
+  }
+  state = vaeseq_u8(state, vld1q_u8(ctx->ksch + (ctx->rnd - 1) * N_BLOCK));
+  state = veorq_u8(state, vld1q_u8(ctx->ksch + ctx->rnd * N_BLOCK));
+  vst1q_u8(out, state);
+}
+
+#else
+
+bool aes_hw_is_supported() {
+  return false;
+}
+
+void aes_hw_encrypt(const unsigned char[N_BLOCK], unsigned char[N_BLOCK], const aes_context[1]) {}
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "aes.h"
+
+/* AES block encryption with the CPU instructions (AES-NI on x86, the ARMv8
+ * Cryptography Extension on arm64), using a key schedule expanded by
+ * aes_set_key(). Unlike the table based aes_encrypt_software(), it runs in
+ * constant time. */
+
+/* Returns true if the CPU supports the AES instructions, detected at the first
+ * call. */
+bool aes_hw_is_supported();
+
+/* Must only be called if aes_hw_is_supported() */
+void aes_hw_encrypt(const unsigned char in[N_BLOCK], unsigned char out[N_BLOCK], const aes_context ctx[1]);
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/aes_hw.h"
+#include "crypto_toolbox/crypto_toolbox.h"
+
+using ::benchmark::State;
+using bluetooth::hci::kOctet16Length;
+using bluetooth::hci::Octet16;
+
+namespace crypto_toolbox {
+
+static const uint8_t kKey[kOctet16Length] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+// state.range(0) selects the plaintext: all zeros or varying bytes. The table
+// based implementation indexes its tables with the state, so its timing
+// depends on the data and the cache, while the CPU instructions do not.
+static void FillBlock(uint8_t block[kOctet16Length], int64_t pattern, uint64_t iteration) {
+  for (size_t i = 0; i < kOctet16Length; i++) {
+    block[i] = pattern == 0 ? 0 : static_cast<uint8_t>(iteration * 0x9d + i * 0x3b);
+  }
+}
+
+static void BM_AesEncryptSoftware(State& state) {
+  aes_context ctx;
+  aes_set_key(kKey, sizeof(kKey), &ctx);
+  uint8_t block[kOctet16Length];
+  uint8_t output[kOctet16Length];
+  uint64_t iteration = 0;
+  for (auto _ : state) {
+    FillBlock(block, state.range(0), iteration++);
+    aes_encrypt_software(block, output, &ctx);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kOctet16Length);
+}
+BENCHMARK(BM_AesEncryptSoftware)->Arg(0)->Arg(1);
+
+static void BM_AesEncryptHardware(State& state) {
+  if (!aes_hw_is_supported()) {
+    state.SkipWithError("AES instructions are not supported");
+    return;
+  }
+  aes_context ctx;
+  aes_set_key(kKey, sizeof(kKey), &ctx);
+  uint8_t block[kOctet16Length];
+  uint8_t output[kOctet16Length];
+  uint64_t iteration = 0;
+  for (auto _ : state) {
+    FillBlock(block, state.range(0), iteration++);
+    aes_hw_encrypt(block, output, &ctx);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kOctet16Length);
+}
+BENCHMARK(BM_AesEncryptHardware)->Arg(0)->Arg(1);
+
+// aes_128() expands the key at every call
+static void BM_Aes128(State& state) {
+  Octet16 key;
+  std::copy(std::begin(kKey), std::end(kKey), key.begin());
+  Octet16 message{};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(aes_128(key, message));
+  }
+}
+BENCHMARK(BM_Aes128);
+
+// state.range(0) is the message length, 65 bytes is the input of f4()
+static void BM_AesCmac(State& state) {
+  Octet16 key;
+  std::copy(std::begin(kKey), std::end(kKey), key.begin());
+  std::vector<uint8_t> message(state.range(0), 0x5a);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(aes_cmac(key, message.data(), message.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_AesCmac)->Arg(16)->Arg(65)->Arg(256);
+
+}  // namespace crypto_toolbox
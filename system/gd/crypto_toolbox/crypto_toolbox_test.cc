@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/aes_hw.h"
 #include "hci/octets.h"
 
 namespace crypto_toolbox {
@@ -353,4 +354,26 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+// The CPU instructions must give the same result as the software implementation
+TEST(CryptoToolboxTest, aes_hw_matches_software_test) {
+  if (!aes_hw_is_supported()) {
+    GTEST_SKIP() << "AES instructions are not supported";
+  }
+  uint8_t key[kOctet16Length];
+  uint8_t block[kOctet16Length];
+  for (int i = 0; i < 256; i++) {
+    for (size_t j = 0; j < kOctet16Length; j++) {
+      key[j] = static_cast<uint8_t>(i * 31 + j * 7);
+      block[j] = static_cast<uint8_t>(i * 17 + j * 13 + 1);
+    }
+    aes_context ctx;
+    aes_set_key(key, sizeof(key), &ctx);
+    uint8_t software_output[kOctet16Length];
+    uint8_t hw_output[kOctet16Length];
+    aes_encrypt_software(block, software_output, &ctx);
+    aes_hw_encrypt(block, hw_output, &ctx);
+    EXPECT_EQ(memcmp(software_output, hw_output, kOctet16Length), 0);
+  }
+}
+
 }  // namespace crypto_toolbox
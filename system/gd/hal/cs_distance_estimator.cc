@@ -0,0 +1,232 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/cs_distance_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+constexpr double kSpeedOfLight = 299792458.0;
+constexpr double kPi = 3.14159265358979323846;
+// Tone quality indicator, bits 0-1: 0 high, 1 medium, 2 low, 3 unavailable
+constexpr uint8_t kToneQualityMask = 0x03;
+constexpr uint8_t kToneQualityLow = 0x02;
+
+constexpr size_t kIfftStages = 8;
+static_assert(CsDistanceEstimator::kIfftSize == (1u << kIfftStages));
+static_assert(CsDistanceEstimator::kIfftSize >= CsDistanceEstimator::kNumChannels);
+
+bool is_usable(const std::vector<uint8_t>& tone_quality_indicators, size_t step) {
+  return step >= tone_quality_indicators.size() ||
+         (tone_quality_indicators[step] & kToneQualityMask) < kToneQualityLow;
+}
+
+// The product of the initiator and reflector PCTs rotates by 2 pi f times the round trip delay
+double delay_to_meters(double delay_seconds) {
+  return delay_seconds * kSpeedOfLight / 2;
+}
+
+double meters_to_delay(double meters) {
+  return 2 * meters / kSpeedOfLight;
+}
+
+}  // namespace
+
+CsDistanceEstimator::CsDistanceEstimator() {
+  for (size_t half = 1; half < kIfftSize; half *= 2) {
+    for (size_t j = 0; j < half; j++) {
+      double angle = kPi * j / half;
+      twiddle_real_[half - 1 + j] = std::cos(angle);
+      twiddle_imag_[half - 1 + j] = std::sin(angle);
+    }
+  }
+  for (size_t i = 0; i < kIfftSize; i++) {
+    uint16_t reversed = 0;
+    for (size_t bit = 0; bit < kIfftStages; bit++) {
+      reversed |= ((i >> bit) & 1) << (kIfftStages - 1 - bit);
+    }
+    bit_reverse_[i] = reversed;
+  }
+}
+
+std::optional<CsDistanceEstimate> CsDistanceEstimator::Estimate(
+    const ChannelSoundingRawData& raw_data) {
+  accumulate_channel_response(raw_data);
+  size_t num_channels = 0;
+  for (size_t k = 0; k < kNumChannels; k++) {
+    num_channels += response_count_[k] != 0;
+  }
+  if (num_channels < kMinChannels) {
+    return std::nullopt;
+  }
+
+  CsDistanceEstimate estimate;
+  estimate.num_channels = num_channels;
+  estimate.ifft_meters = estimate_ifft_meters();
+  estimate.phase_slope_meters = estimate_phase_slope_meters(estimate.ifft_meters);
+  if (!std::isfinite(estimate.phase_slope_meters)) {
+    estimate.phase_slope_meters = estimate.ifft_meters;
+  }
+  estimate.ifft_meters = std::max(estimate.ifft_meters, 0.0);
+  estimate.phase_slope_meters = std::max(estimate.phase_slope_meters, 0.0);
+  return estimate;
+}
+
+void CsDistanceEstimator::accumulate_channel_response(const ChannelSoundingRawData& raw_data) {
+  response_real_.fill(0);
+  response_imag_.fill(0);
+  response_count_.fill(0);
+
+  const auto& channels = raw_data.step_channel_;
+  size_t num_paths = std::min<size_t>(
+      raw_data.num_antenna_paths_,
+      std::min(raw_data.tone_pct_initiator_.size(), raw_data.tone_pct_reflector_.size()));
+  for (size_t path = 0; path < num_paths; path++) {
+    const auto& initiator = raw_data.tone_pct_initiator_[path];
+    const auto& reflector = raw_data.tone_pct_reflector_[path];
+    static const std::vector<uint8_t> kNoIndicators;
+    const auto& initiator_quality = path < raw_data.tone_quality_indicator_initiator_.size()
+                                        ? raw_data.tone_quality_indicator_initiator_[path]
+                                        : kNoIndicators;
+    const auto& reflector_quality = path < raw_data.tone_quality_indicator_reflector_.size()
+                                        ? raw_data.tone_quality_indicator_reflector_[path]
+                                        : kNoIndicators;
+    size_t num_steps = std::min({channels.size(), initiator.size(), reflector.size()});
+    for (size_t step = 0; step < num_steps; step++) {
+      uint8_t channel = channels[step];
+      if (channel >= kNumChannels || !is_usable(initiator_quality, step) ||
+          !is_usable(reflector_quality, step)) {
+        continue;
+      }
+      std::complex<double> product = initiator[step] * reflector[step];
+      response_real_[channel] += product.real();
+      response_imag_[channel] += product.imag();
+      response_count_[channel]++;
+    }
+  }
+
+  for (size_t k = 0; k < kNumChannels; k++) {
+    double scale = response_count_[k] != 0 ? 1.0 / response_count_[k] : 0.0;
+    response_real_[k] *= scale;
+    response_imag_[k] *= scale;
+  }
+}
+
+double CsDistanceEstimator::estimate_ifft_meters() {
+  ifft_real_.fill(0);
+  ifft_imag_.fill(0);
+  std::copy(response_real_.begin(), response_real_.end(), ifft_real_.begin());
+  std::copy(response_imag_.begin(), response_imag_.end(), ifft_imag_.begin());
+  inverse_fft();
+
+  for (size_t n = 0; n < kIfftSize; n++) {
+    ifft_power_[n] = ifft_real_[n] * ifft_real_[n] + ifft_imag_[n] * ifft_imag_[n];
+  }
+  size_t peak = std::max_element(ifft_power_.begin(), ifft_power_.end()) - ifft_power_.begin();
+
+  // Parabolic interpolation of the magnitude around the peak
+  double before = std::sqrt(ifft_power_[(peak + kIfftSize - 1) % kIfftSize]);
+  double at = std::sqrt(ifft_power_[peak]);
+  double after = std::sqrt(ifft_power_[(peak + 1) % kIfftSize]);
+  double curvature = before - 2 * at + after;
+  double offset = curvature < 0 ? 0.5 * (before - after) / curvature : 0.0;
+
+  // Bins past the middle are negative delays
+  double bin = peak + offset;
+  if (bin > kIfftSize / 2) {
+    bin -= kIfftSize;
+  }
+  return delay_to_meters(bin / (kIfftSize * kChannelSpacingHz));
+}
+
+double CsDistanceEstimator::estimate_phase_slope_meters(double ifft_meters) {
+  // Remove the slope of the IFFT estimate first, so that the residual phase changes by far less
+  // than pi between the used channels and unwraps reliably across the gaps of the channel map
+  double coarse_delay = meters_to_delay(ifft_meters);
+  size_t num_points = 0;
+  double previous_phase = 0;
+  for (size_t k = 0; k < kNumChannels; k++) {
+    if (response_count_[k] == 0) {
+      continue;
+    }
+    std::complex<double> rotation = std::polar(1.0, 2 * kPi * k * kChannelSpacingHz * coarse_delay);
+    double phase = std::arg(std::complex<double>(response_real_[k], response_imag_[k]) * rotation);
+    if (num_points != 0) {
+      phase -= 2 * kPi * std::round((phase - previous_phase) / (2 * kPi));
+    }
+    previous_phase = phase;
+    fit_channel_[num_points] = k;
+    fit_phase_[num_points] = phase;
+    num_points++;
+  }
+
+  double mean_channel = 0;
+  double mean_phase = 0;
+  for (size_t i = 0; i < num_points; i++) {
+    mean_channel += fit_channel_[i];
+    mean_phase += fit_phase_[i];
+  }
+  mean_channel /= num_points;
+  mean_phase /= num_points;
+  double covariance = 0;
+  double variance = 0;
+  for (size_t i = 0; i < num_points; i++) {
+    double dx = fit_channel_[i] - mean_channel;
+    covariance += dx * (fit_phase_[i] - mean_phase);
+    variance += dx * dx;
+  }
+  // The phase decreases by 2 pi delta_f per second of residual delay
+  double slope = covariance / variance;
+  double residual_delay = -slope / (2 * kPi * kChannelSpacingHz);
+  return ifft_meters + delay_to_meters(residual_delay);
+}
+
+void CsDistanceEstimator::inverse_fft() {
+  for (size_t i = 0; i < kIfftSize; i++) {
+    size_t j = bit_reverse_[i];
+    if (i < j) {
+      std::swap(ifft_real_[i], ifft_real_[j]);
+      std::swap(ifft_imag_[i], ifft_imag_[j]);
+    }
+  }
+  // Radix-2 butterflies, the inner loop runs over unit stride data and twiddles
+  for (size_t half = 1; half < kIfftSize; half *= 2) {
+    const double* w_real = twiddle_real_.data() + half - 1;
+    const double* w_imag = twiddle_imag_.data() + half - 1;
+    for (size_t base = 0; base < kIfftSize; base += 2 * half) {
+      double* a_real = ifft_real_.data() + base;
+      double* a_imag = ifft_imag_.data() + base;
+      double* b_real = a_real + half;
+      double* b_imag = a_imag + half;
+      for (size_t j = 0; j < half; j++) {
+        double t_real = w_real[j] * b_real[j] - w_imag[j] * b_imag[j];
+        double t_imag = w_real[j] * b_imag[j] + w_imag[j] * b_real[j];
+        b_real[j] = a_real[j] - t_real;
+        b_imag[j] = a_imag[j] - t_imag;
+        a_real[j] += t_real;
+        a_imag[j] += t_imag;
+      }
+    }
+  }
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "hal/ranging_hal.h"
+
+namespace bluetooth {
+namespace hal {
+
+struct CsDistanceEstimate {
+  // Coarse distance of the strongest path of the IFFT of the channel response
+  double ifft_meters;
+  // Distance refined with the phase slope of the channel response around the IFFT estimate
+  double phase_slope_meters;
+  // Number of channels that had at least one usable tone
+  size_t num_channels;
+};
+
+/**
+ * Host side distance estimation for channel sounding procedures, used when the controller has no
+ * vendor ranging HAL.
+ *
+ * The PCTs of the initiator and of the reflector of each mode-2 step are multiplied, which cancels
+ * the phase offset of their local oscillators and leaves the phase rotation of the round trip, and
+ * averaged per channel into the channel frequency response. Its IFFT gives a coarse delay of the
+ * strongest path that is then refined by a least squares fit of the phase slope.
+ *
+ * The buffers are allocated once, which also keeps the kernels on plain arrays that the compiler
+ * vectorizes. Not thread safe, each worker owns its estimator.
+ */
+class CsDistanceEstimator {
+ public:
+  // CS channel k is at 2402 + k MHz
+  static constexpr size_t kNumChannels = 79;
+  static constexpr double kChannelSpacingHz = 1e6;
+  // Zero padded size of the IFFT, its bins are 0.59 m apart in distance
+  static constexpr size_t kIfftSize = 256;
+  // Procedures with fewer usable channels are not estimated
+  static constexpr size_t kMinChannels = 8;
+
+  CsDistanceEstimator();
+
+  /**
+   * Estimate the distance of a procedure from the PCTs of its mode-2 steps. Tones of low or
+   * unavailable quality are ignored.
+   *
+   * @return the estimate, or std::nullopt when the procedure has too few usable channels
+   */
+  std::optional<CsDistanceEstimate> Estimate(const ChannelSoundingRawData& raw_data);
+
+ private:
+  void accumulate_channel_response(const ChannelSoundingRawData& raw_data);
+  double estimate_ifft_meters();
+  double estimate_phase_slope_meters(double ifft_meters);
+  void inverse_fft();
+
+  // Channel frequency response, summed then averaged per channel
+  std::array<double, kNumChannels> response_real_;
+  std::array<double, kNumChannels> response_imag_;
+  std::array<uint16_t, kNumChannels> response_count_;
+  // IFFT working buffers
+  std::array<double, kIfftSize> ifft_real_;
+  std::array<double, kIfftSize> ifft_imag_;
+  std::array<double, kIfftSize> ifft_power_;
+  // Twiddle factors of each butterfly stage laid out contiguously, the stage of half size h uses
+  // the entries [h - 1, 2h - 1)
+  std::array<double, kIfftSize - 1> twiddle_real_;
+  std::array<double, kIfftSize - 1> twiddle_imag_;
+  std::array<uint16_t, kIfftSize> bit_reverse_;
+  // Channels with usable tones and their residual phase, for the phase slope fit
+  std::array<double, kNumChannels> fit_channel_;
+  std::array<double, kNumChannels> fit_phase_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hal/cs_distance_estimator.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hal {
+
+static constexpr double kSpeedOfLight = 299792458.0;
+static constexpr double kPi = 3.14159265358979323846;
+static constexpr size_t kNumProcedures = 64;
+
+// Procedures as a controller reports them indoors: every usable channel sounded once per
+// antenna path, a direct path, a weaker reflection with a 3 m longer round trip, and noise
+static std::vector<ChannelSoundingRawData> MakeProcedures(uint8_t num_antenna_paths) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distance(0.5, 20.0);
+  std::uniform_real_distribution<double> phase(-kPi, kPi);
+  std::normal_distribution<double> noise(0.0, 0.05);
+  std::vector<ChannelSoundingRawData> procedures;
+  for (size_t i = 0; i < kNumProcedures; i++) {
+    ChannelSoundingRawData raw_data;
+    raw_data.num_antenna_paths_ = num_antenna_paths;
+    raw_data.tone_pct_initiator_.resize(num_antenna_paths + 1);
+    raw_data.tone_pct_reflector_.resize(num_antenna_paths + 1);
+    raw_data.tone_quality_indicator_initiator_.resize(num_antenna_paths + 1);
+    raw_data.tone_quality_indicator_reflector_.resize(num_antenna_paths + 1);
+    double meters = distance(generator);
+    for (uint8_t channel = 2; channel <= 76; channel++) {
+      if (channel >= 23 && channel <= 25) {
+        continue;
+      }
+      raw_data.step_channel_.push_back(channel);
+      double wave_number = 2 * kPi * (2402e6 + channel * 1e6) / kSpeedOfLight;
+      double oscillator_offset = phase(generator);
+      for (uint8_t path = 0; path < num_antenna_paths; path++) {
+        std::complex<double> one_way = std::polar(1.0, -wave_number * meters) +
+                                       std::polar(0.3, -wave_number * (meters + 1.5));
+        std::complex<double> offset = std::polar(1.0, oscillator_offset);
+        raw_data.tone_pct_initiator_[path].push_back(
+            one_way * offset + std::complex<double>(noise(generator), noise(generator)));
+        raw_data.tone_pct_reflector_[path].push_back(
+            one_way / offset + std::complex<double>(noise(generator), noise(generator)));
+        raw_data.tone_quality_indicator_initiator_[path].push_back(0);
+        raw_data.tone_quality_indicator_reflector_[path].push_back(0);
+      }
+    }
+    procedures.push_back(std::move(raw_data));
+  }
+  return procedures;
+}
+
+// Estimate the distance of procedures with state.range(0) antenna paths, as the host ranging HAL
+// does for each completed procedure
+static void BM_EstimateCsDistance(State& state) {
+  auto procedures = MakeProcedures(static_cast<uint8_t>(state.range(0)));
+  CsDistanceEstimator estimator;
+  size_t processed = 0;
+  for (auto _ : state) {
+    auto estimate = estimator.Estimate(procedures[processed++ % procedures.size()]);
+    benchmark::DoNotOptimize(estimate);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(processed));
+}
+BENCHMARK(BM_EstimateCsDistance)->Arg(1)->Arg(2)->Arg(4);
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/cs_distance_estimator.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace bluetooth::hal {
+namespace {
+
+constexpr double kSpeedOfLight = 299792458.0;
+constexpr double kPi = 3.14159265358979323846;
+constexpr uint8_t kHighQuality = 0x00;
+constexpr uint8_t kUnavailableQuality = 0x03;
+
+// One mode-2 step per usable CS channel, each side measuring the one way phase rotation at
+// |meters| plus opposite local oscillator offsets
+ChannelSoundingRawData MakeProcedure(double meters, uint8_t num_antenna_paths = 1) {
+  ChannelSoundingRawData raw_data;
+  raw_data.num_antenna_paths_ = num_antenna_paths;
+  raw_data.tone_pct_initiator_.resize(num_antenna_paths + 1);
+  raw_data.tone_pct_reflector_.resize(num_antenna_paths + 1);
+  raw_data.tone_quality_indicator_initiator_.resize(num_antenna_paths + 1);
+  raw_data.tone_quality_indicator_reflector_.resize(num_antenna_paths + 1);
+  for (uint8_t channel = 2; channel <= 76; channel++) {
+    if (channel >= 23 && channel <= 25) {
+      continue;
+    }
+    raw_data.step_channel_.push_back(channel);
+    double frequency = 2402e6 + channel * 1e6;
+    double one_way = -2 * kPi * frequency * meters / kSpeedOfLight;
+    double oscillator_offset = 0.3 * channel;
+    for (uint8_t path = 0; path < num_antenna_paths; path++) {
+      raw_data.tone_pct_initiator_[path].push_back(std::polar(1.0, one_way + oscillator_offset));
+      raw_data.tone_pct_reflector_[path].push_back(std::polar(0.5, one_way - oscillator_offset));
+      raw_data.tone_quality_indicator_initiator_[path].push_back(kHighQuality);
+      raw_data.tone_quality_indicator_reflector_[path].push_back(kHighQuality);
+    }
+  }
+  return raw_data;
+}
+
+TEST(CsDistanceEstimatorTest, estimates_distance) {
+  CsDistanceEstimator estimator;
+  for (double meters : {0.5, 1.0, 3.7, 12.0, 40.0}) {
+    auto estimate = estimator.Estimate(MakeProcedure(meters));
+    ASSERT_TRUE(estimate.has_value());
+    EXPECT_EQ(72ul, estimate->num_channels);
+    EXPECT_NEAR(meters, estimate->ifft_meters, 0.5);
+    EXPECT_NEAR(meters, estimate->phase_slope_meters, 0.01);
+  }
+}
+
+TEST(CsDistanceEstimatorTest, averages_antenna_paths) {
+  CsDistanceEstimator estimator;
+  auto estimate = estimator.Estimate(MakeProcedure(2.5, 4));
+  ASSERT_TRUE(estimate.has_value());
+  EXPECT_NEAR(2.5, estimate->phase_slope_meters, 0.01);
+}
+
+TEST(CsDistanceEstimatorTest, ignores_unusable_tones) {
+  auto raw_data = MakeProcedure(6.0);
+  // Corrupt all but the first few channels and mark them as unavailable
+  for (size_t step = CsDistanceEstimator::kMinChannels; step < raw_data.step_channel_.size();
+       step++) {
+    raw_data.tone_pct_initiator_[0][step] = std::polar(1.0, 1.0 * step);
+    raw_data.tone_quality_indicator_reflector_[0][step] = kUnavailableQuality;
+  }
+  CsDistanceEstimator estimator;
+  auto estimate = estimator.Estimate(raw_data);
+  ASSERT_TRUE(estimate.has_value());
+  EXPECT_EQ(CsDistanceEstimator::kMinChannels, estimate->num_channels);
+  EXPECT_NEAR(6.0, estimate->phase_slope_meters, 0.01);
+}
+
+TEST(CsDistanceEstimatorTest, rejects_procedures_without_enough_channels) {
+  CsDistanceEstimator estimator;
+  ChannelSoundingRawData empty;
+  empty.num_antenna_paths_ = 1;
+  EXPECT_FALSE(estimator.Estimate(empty).has_value());
+
+  auto raw_data = MakeProcedure(1.0);
+  raw_data.step_channel_.resize(CsDistanceEstimator::kMinChannels - 1);
+  EXPECT_FALSE(estimator.Estimate(raw_data).has_value());
+}
+
+}  // namespace
+}  // namespace bluetooth::hal
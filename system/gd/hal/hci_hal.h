@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "module.h"
@@ -24,6 +25,7 @@ namespace bluetooth {
 namespace hal {
 
 using HciPacket = std::vector<uint8_t>;
+using SharedHciPacket = std::shared_ptr<const HciPacket>;
 
 enum class Status : int32_t { SUCCESS, TRANSPORT_ERROR, INITIALIZATION_ERROR, UNKNOWN };
 
@@ -51,6 +53,22 @@ class HciHalCallbacks {
   // Send an ISO data packet from the controller to the host
   // @param data the ISO HCI packet to be passed to the host stack
   virtual void isoDataReceived(HciPacket data) = 0;
+
+  // Variants of the callbacks above taking a reference-counted buffer, typically obtained from an
+  // HciPacketPool. Consumers that can keep a reference to the buffer should override them to avoid
+  // copying the packet; by default they forward a copy to the by-value callbacks.
+  virtual void hciEventReceivedShared(SharedHciPacket event) {
+    hciEventReceived(*event);
+  }
+  virtual void aclDataReceivedShared(SharedHciPacket data) {
+    aclDataReceived(*data);
+  }
+  virtual void scoDataReceivedShared(SharedHciPacket data) {
+    scoDataReceived(*data);
+  }
+  virtual void isoDataReceivedShared(SharedHciPacket data) {
+    isoDataReceived(*data);
+  }
 };
 
 // Mirrors hardware/interfaces/bluetooth/1.0/IBluetoothHci.hal in Android
@@ -23,6 +23,7 @@
 #include "common/strings.h"
 #include "hal/hci_backend.h"
 #include "hal/hci_hal.h"
+#include "hal/hci_packet_pool.h"
 #include "hal/link_clocker.h"
 #include "hal/snoop_logger.h"
 
@@ -85,7 +86,7 @@ class HciCallbacksImpl : public HciBackendCallbacks {
         packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      callback_->hciEventReceived(packet);
+      callback_->hciEventReceivedShared(packet_pool_.Acquire(packet.data(), packet.size()));
     }
   }
 
@@ -95,7 +96,7 @@ class HciCallbacksImpl : public HciBackendCallbacks {
         packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      callback_->aclDataReceived(packet);
+      callback_->aclDataReceivedShared(packet_pool_.Acquire(packet.data(), packet.size()));
     }
   }
 
@@ -105,7 +106,7 @@ class HciCallbacksImpl : public HciBackendCallbacks {
         packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      callback_->scoDataReceived(packet);
+      callback_->scoDataReceivedShared(packet_pool_.Acquire(packet.data(), packet.size()));
     }
   }
 
@@ -115,13 +116,14 @@ class HciCallbacksImpl : public HciBackendCallbacks {
         packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      callback_->isoDataReceived(packet);
+      callback_->isoDataReceivedShared(packet_pool_.Acquire(packet.data(), packet.size()));
     }
   }
 
  private:
   std::mutex mutex_;
   std::promise<void> init_promise_;
+  HciPacketPool packet_pool_;
   HciHalCallbacks* callback_ = &kNullCallbacks;
   LinkClocker* link_clocker_;
   SnoopLogger* btsnoop_logger_;
@@ -22,12 +22,15 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <csignal>
+#include <deque>
 #include <mutex>
-#include <queue>
 
 #include "common/init_flags.h"
 #include "hal/hci_hal.h"
@@ -54,6 +57,8 @@ constexpr uint8_t kHciScoHeaderSize = 3;
 constexpr uint8_t kHciEvtHeaderSize = 2;
 constexpr uint8_t kHciIsoHeaderSize = 4;
 constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
+// Packets read with one recvmmsg(), or written with one sendmmsg()
+constexpr size_t kMaxPacketsPerBatch = 8;
 
 constexpr uint8_t BTPROTO_HCI = 1;
 constexpr uint16_t HCI_CHANNEL_USER = 1;
@@ -350,61 +355,51 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  std::deque<std::vector<uint8_t>> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
   LinkClocker* link_clocker_ = nullptr;
+  // Receive buffers of one recvmmsg(), only touched on hci_incoming_thread_
+  std::array<std::array<uint8_t, kBufSize>, kMaxPacketsPerBatch> incoming_bufs_;
+
+  struct IncomingPacket {
+    uint8_t type;
+    HciPacket packet;
+  };
 
   void write_to_fd(HciPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
+    hci_outgoing_queue_.emplace_back(std::move(packet));
     if (hci_outgoing_queue_.size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_WRITE);
     }
   }
 
+  // Queued outgoing packets written with one sendmmsg(), each packet in its own datagram
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
-    hci_outgoing_queue_.pop();
-    if (bytes_written == -1) {
+    size_t num_packets = std::min(hci_outgoing_queue_.size(), kMaxPacketsPerBatch);
+    std::array<struct iovec, kMaxPacketsPerBatch> iovs;
+    std::array<struct mmsghdr, kMaxPacketsPerBatch> msgs = {};
+    for (size_t i = 0; i < num_packets; i++) {
+      auto& packet = hci_outgoing_queue_[i];
+      iovs[i] = {.iov_base = packet.data(), .iov_len = packet.size()};
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int packets_written;
+    RUN_NO_INTR(packets_written = sendmmsg(sock_fd_, msgs.data(), num_packets, 0));
+    if (packets_written == -1) {
       abort();
     }
+    hci_outgoing_queue_.erase(hci_outgoing_queue_.begin(), hci_outgoing_queue_.begin() + packets_written);
     if (hci_outgoing_queue_.empty()) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_ONLY);
     }
   }
 
-  void incoming_packet_received() {
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (incoming_packet_callback_ == nullptr) {
-        log::info("Dropping a packet");
-        return;
-      }
-    }
-    uint8_t buf[kBufSize] = {};
-
-    ssize_t received_size;
-    RUN_NO_INTR(received_size = read(sock_fd_, buf, kBufSize));
-
-    // we don't want crash when the chipset is broken.
-    if (received_size == -1) {
-      log::error("Can't receive from socket: {}", strerror(errno));
-      close(sock_fd_);
-      raise(SIGINT);
-      return;
-    }
-
-    if (received_size == 0) {
-      log::warn("Can't read H4 header. EOF received");
-      // First close sock fd before raising sigint
-      close(sock_fd_);
-      raise(SIGINT);
-      return;
-    }
-
+  // Checks the H4 packet in |buf| and appends its HCI packet to |packets|
+  void parse_packet(const uint8_t* buf, ssize_t received_size, std::vector<IncomingPacket>* packets) {
     if (buf[0] == kH4Event) {
       log::assert_that(
           received_size >= kH4HeaderSize + kHciEvtHeaderSize,
@@ -422,14 +417,7 @@ class HciHalHost : public HciHal {
       receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + payload_size);
       link_clocker_->OnHciEvent(receivedHciPacket);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
-      {
-        std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-        if (incoming_packet_callback_ == nullptr) {
-          log::info("Dropping an event after processing");
-          return;
-        }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
-      }
+      packets->push_back({kH4Event, std::move(receivedHciPacket)});
     }
 
     if (buf[0] == kH4Acl) {
@@ -452,14 +440,7 @@ class HciHalHost : public HciHal {
       receivedHciPacket.assign(
           buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + payload_size);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
-      {
-        std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-        if (incoming_packet_callback_ == nullptr) {
-          log::info("Dropping an ACL packet after processing");
-          return;
-        }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
-      }
+      packets->push_back({kH4Acl, std::move(receivedHciPacket)});
     }
 
     if (buf[0] == kH4Sco) {
@@ -478,14 +459,7 @@ class HciHalHost : public HciHal {
       HciPacket receivedHciPacket;
       receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + payload_size);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
-      {
-        std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-        if (incoming_packet_callback_ == nullptr) {
-          log::info("Dropping a SCO packet after processing");
-          return;
-        }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
-      }
+      packets->push_back({kH4Sco, std::move(receivedHciPacket)});
     }
 
     if (buf[0] == kH4Iso) {
@@ -504,16 +478,77 @@ class HciHalHost : public HciHal {
       HciPacket receivedHciPacket;
       receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + payload_size);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
-      {
-        std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-        if (incoming_packet_callback_ == nullptr) {
-          log::info("Dropping a ISO packet after processing");
-          return;
-        }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+      packets->push_back({kH4Iso, std::move(receivedHciPacket)});
+    }
+  }
+
+  // Drains up to kMaxPacketsPerBatch packets with one recvmmsg() per wakeup, and delivers them
+  // under a single hold of incoming_packet_callback_mutex_
+  void incoming_packet_received() {
+    {
+      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
+      if (incoming_packet_callback_ == nullptr) {
+        log::info("Dropping a packet");
+        return;
+      }
+    }
+
+    std::array<struct iovec, kMaxPacketsPerBatch> iovs;
+    std::array<struct mmsghdr, kMaxPacketsPerBatch> msgs = {};
+    for (size_t i = 0; i < kMaxPacketsPerBatch; i++) {
+      iovs[i] = {.iov_base = incoming_bufs_[i].data(), .iov_len = kBufSize};
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // The reactor saw the socket readable, so the first packet is there: only the ones after it
+    // are not waited for
+    int num_received;
+    RUN_NO_INTR(num_received = recvmmsg(sock_fd_, msgs.data(), kMaxPacketsPerBatch, MSG_WAITFORONE, nullptr));
+
+    // we don't want crash when the chipset is broken.
+    if (num_received == -1) {
+      log::error("Can't receive from socket: {}", strerror(errno));
+      close(sock_fd_);
+      raise(SIGINT);
+      return;
+    }
+
+    std::vector<IncomingPacket> packets;
+    packets.reserve(num_received);
+    for (int i = 0; i < num_received; i++) {
+      ssize_t received_size = msgs[i].msg_len;
+      if (received_size == 0) {
+        log::warn("Can't read H4 header. EOF received");
+        // First close sock fd before raising sigint
+        close(sock_fd_);
+        raise(SIGINT);
+        return;
+      }
+      parse_packet(incoming_bufs_[i].data(), received_size, &packets);
+    }
+
+    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
+    if (incoming_packet_callback_ == nullptr) {
+      log::info("Dropping {} packets after processing", packets.size());
+      return;
+    }
+    for (auto& [type, packet] : packets) {
+      switch (type) {
+        case kH4Event:
+          incoming_packet_callback_->hciEventReceived(packet);
+          break;
+        case kH4Acl:
+          incoming_packet_callback_->aclDataReceived(packet);
+          break;
+        case kH4Sco:
+          incoming_packet_callback_->scoDataReceived(packet);
+          break;
+        case kH4Iso:
+          incoming_packet_callback_->isoDataReceived(packet);
+          break;
       }
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
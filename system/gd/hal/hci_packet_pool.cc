@@ -0,0 +1,83 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_packet_pool.h"
+
+namespace bluetooth::hal {
+
+HciPacketPool::HciPacketPool(size_t max_cached_buffers)
+    : state_(std::make_shared<State>(max_cached_buffers)) {}
+
+HciPacketPool::~HciPacketPool() = default;
+
+HciPacketPool::State::~State() {
+  for (auto buffer : free_buffers) {
+    delete buffer;
+  }
+}
+
+std::shared_ptr<const HciPacket> HciPacketPool::Acquire(const uint8_t* data, size_t size) {
+  HciPacket* buffer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->free_buffers.empty()) {
+      buffer = state_->free_buffers.back();
+      state_->free_buffers.pop_back();
+    } else {
+      state_->allocation_count++;
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = new HciPacket();
+  }
+  buffer->assign(data, data + size);
+
+  // The deleter only holds a weak reference to the pool state, so buffers released after the pool
+  // has been destroyed are freed instead of cached.
+  std::weak_ptr<State> weak_state = state_;
+  return std::shared_ptr<const HciPacket>(buffer, [weak_state](const HciPacket* released) {
+    auto mutable_buffer = const_cast<HciPacket*>(released);
+    if (auto state = weak_state.lock()) {
+      state->Release(mutable_buffer);
+    } else {
+      delete mutable_buffer;
+    }
+  });
+}
+
+void HciPacketPool::State::Release(HciPacket* buffer) {
+  if (buffer->capacity() <= kMaxCachedCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free_buffers.size() < max_cached_buffers) {
+      buffer->clear();
+      free_buffers.push_back(buffer);
+      return;
+    }
+  }
+  delete buffer;
+}
+
+size_t HciPacketPool::GetCachedBufferCount() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->free_buffers.size();
+}
+
+size_t HciPacketPool::GetAllocationCount() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->allocation_count;
+}
+
+}  // namespace bluetooth::hal
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "hal/hci_hal.h"
+
+namespace bluetooth::hal {
+
+// Pool of reference-counted receive buffers for inbound HCI packets.
+//
+// The HAL fills a buffer obtained from Acquire() and hands it to the stack, where it is wrapped by
+// a packet::PacketView without copying. When the last view referencing the buffer goes away, the
+// underlying storage (and its capacity) is returned to the pool instead of being freed, so the
+// steady state receive path does not hit the allocator for packet payloads.
+//
+// Buffers may outlive the pool; in that case they are simply freed when released.
+class HciPacketPool {
+ public:
+  static constexpr size_t kDefaultMaxCachedBuffers = 32;
+  // Buffers that grew past this capacity (e.g. after a large ISO SDU) are not cached.
+  static constexpr size_t kMaxCachedCapacity = 2048;
+
+  explicit HciPacketPool(size_t max_cached_buffers = kDefaultMaxCachedBuffers);
+  HciPacketPool(const HciPacketPool&) = delete;
+  HciPacketPool& operator=(const HciPacketPool&) = delete;
+  ~HciPacketPool();
+
+  // Returns a buffer holding a copy of |size| bytes at |data|.
+  std::shared_ptr<const HciPacket> Acquire(const uint8_t* data, size_t size);
+
+  // Number of idle buffers currently cached by the pool.
+  size_t GetCachedBufferCount() const;
+
+  // Number of Acquire() calls that could not be served from the cache.
+  size_t GetAllocationCount() const;
+
+ private:
+  struct State {
+    explicit State(size_t max_cached_buffers) : max_cached_buffers(max_cached_buffers) {}
+    ~State();
+    void Release(HciPacket* buffer);
+
+    const size_t max_cached_buffers;
+    mutable std::mutex mutex;
+    std::vector<HciPacket*> free_buffers;
+    size_t allocation_count = 0;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace bluetooth::hal
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_packet_pool.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hal {
+namespace {
+
+const std::vector<uint8_t> kPacket = {0x0e, 0x04, 0x01, 0x03, 0x0c, 0x00};
+
+TEST(HciPacketPoolTest, acquire_copies_data) {
+  HciPacketPool pool;
+  auto buffer = pool.Acquire(kPacket.data(), kPacket.size());
+  ASSERT_EQ(kPacket, *buffer);
+  ASSERT_EQ(1ul, pool.GetAllocationCount());
+}
+
+TEST(HciPacketPoolTest, released_buffers_are_reused) {
+  HciPacketPool pool;
+  const HciPacket* first = nullptr;
+  {
+    auto buffer = pool.Acquire(kPacket.data(), kPacket.size());
+    first = buffer.get();
+    ASSERT_EQ(0ul, pool.GetCachedBufferCount());
+  }
+  ASSERT_EQ(1ul, pool.GetCachedBufferCount());
+
+  auto buffer = pool.Acquire(kPacket.data(), 2);
+  ASSERT_EQ(first, buffer.get());
+  ASSERT_EQ(2ul, buffer->size());
+  ASSERT_EQ(1ul, pool.GetAllocationCount());
+  ASSERT_EQ(0ul, pool.GetCachedBufferCount());
+}
+
+TEST(HciPacketPoolTest, cache_is_bounded) {
+  HciPacketPool pool(2);
+  {
+    auto a = pool.Acquire(kPacket.data(), kPacket.size());
+    auto b = pool.Acquire(kPacket.data(), kPacket.size());
+    auto c = pool.Acquire(kPacket.data(), kPacket.size());
+  }
+  ASSERT_EQ(2ul, pool.GetCachedBufferCount());
+  ASSERT_EQ(3ul, pool.GetAllocationCount());
+}
+
+TEST(HciPacketPoolTest, large_buffers_are_not_cached) {
+  HciPacketPool pool;
+  std::vector<uint8_t> large(HciPacketPool::kMaxCachedCapacity + 1);
+  pool.Acquire(large.data(), large.size());
+  ASSERT_EQ(0ul, pool.GetCachedBufferCount());
+}
+
+TEST(HciPacketPoolTest, buffer_outlives_pool) {
+  SharedHciPacket buffer;
+  {
+    HciPacketPool pool;
+    buffer = pool.Acquire(kPacket.data(), kPacket.size());
+  }
+  ASSERT_EQ(kPacket, *buffer);
+  buffer.reset();
+}
+
+}  // namespace
+}  // namespace bluetooth::hal
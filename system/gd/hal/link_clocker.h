@@ -38,8 +38,11 @@ class LinkClocker : public ::bluetooth::Module {
 
   void OnHciEvent(const HciPacket& packet);
 
+  /// Several handlers may be registered at the same time, one for each audio
+  /// stream recovering its clock, and each of them receives all the
+  /// measurements.
   static void Register(ReadClockHandler*);
-  static void Unregister();
+  static void Unregister(ReadClockHandler*);
 
  protected:
   LinkClocker() = default;
@@ -19,43 +19,148 @@
 #undef LOG_INFO
 #undef LOG_WARNING
 
+#include <bluetooth/log.h>
+
+#include <chrono>
+#include <memory>
+
+#include "common/bind.h"
+#include "common/latency_histogram.h"
+#include "hal/cs_distance_estimator.h"
+#include "os/handler.h"
+#include "os/system_properties.h"
+#include "os/thread.h"
 #include "ranging_hal.h"
 
 namespace bluetooth {
 namespace hal {
 
+// Estimate the distance of the channel sounding procedures on the host
+static constexpr char kHostRangingProperty[] = "bluetooth.core.cs.host_ranging.enabled";
+
+// Without a vendor ranging HAL, the procedures can be estimated on the host by the
+// CsDistanceEstimator. The estimation runs on its own thread so that it does not hold up the HCI
+// events handled on the stack thread, and the results are reported back on the stack thread.
 class RangingHalHost : public RangingHal {
  public:
   bool IsBound() override {
-    return false;
+    return worker_handler_ != nullptr;
+  }
+  void RegisterCallback(RangingHalCallback* callback) override {
+    ranging_hal_callback_ = callback;
   }
-  void RegisterCallback(RangingHalCallback* /* callback */) override {}
   std::vector<VendorSpecificCharacteristic> GetVendorSpecificCharacteristics() override {
     std::vector<VendorSpecificCharacteristic> vendor_specific_characteristics = {};
     return vendor_specific_characteristics;
   };
   void OpenSession(
-      uint16_t /* connection_handle */,
+      uint16_t connection_handle,
       uint16_t /* att_handle */,
-      const std::vector<hal::VendorSpecificCharacteristic>& /* vendor_specific_data */) override{};
+      const std::vector<hal::VendorSpecificCharacteristic>& /* vendor_specific_data */) override {
+    // The host estimator needs no session, report it opened once the caller returns
+    GetHandler()->Post(common::BindOnce(
+        &RangingHalHost::on_opened, common::Unretained(this), connection_handle));
+  };
 
   void HandleVendorSpecificReply(
       uint16_t /* connection_handle */,
       const std::vector<hal::VendorSpecificCharacteristic>& /* vendor_specific_reply */) override{};
 
-  void WriteRawData(
-      uint16_t /* connection_handle */, const ChannelSoundingRawData& /* raw_data */) override{};
+  void WriteRawData(uint16_t connection_handle, const ChannelSoundingRawData& raw_data) override {
+    if (worker_handler_ == nullptr) {
+      return;
+    }
+    worker_handler_->Post(common::BindOnce(
+        &RangingHalHost::estimate,
+        common::Unretained(this),
+        connection_handle,
+        raw_data,
+        std::chrono::steady_clock::now()));
+  };
 
  protected:
   void ListDependencies(ModuleList* /*list*/) const {}
 
-  void Start() override {}
+  void Start() override {
+    if (!os::GetSystemPropertyBool(kHostRangingProperty, false)) {
+      return;
+    }
+    worker_thread_ =
+        std::make_unique<os::Thread>("bt_ranging_thread", os::Thread::Priority::NORMAL);
+    worker_handler_ = std::make_unique<os::Handler>(worker_thread_.get());
+    log::info("Estimating channel sounding procedures on the host");
+  }
 
-  void Stop() override {}
+  void Stop() override {
+    if (worker_handler_ == nullptr) {
+      return;
+    }
+    worker_handler_->Clear();
+    worker_handler_->WaitUntilStopped(std::chrono::milliseconds(2000));
+    worker_handler_.reset();
+    worker_thread_.reset();
+    log::info(
+        "{} procedures estimated, {} dropped, latency (us) {}, estimation (us) {}",
+        procedure_latency_us_.Count(),
+        num_dropped_procedures_,
+        procedure_latency_us_.ToString(),
+        estimation_us_.ToString());
+  }
 
   std::string ToString() const override {
     return std::string("RangingHalHost");
   }
+
+ private:
+  // Runs on the worker thread
+  void estimate(
+      uint16_t connection_handle,
+      ChannelSoundingRawData raw_data,
+      std::chrono::steady_clock::time_point written) {
+    auto start = std::chrono::steady_clock::now();
+    std::optional<CsDistanceEstimate> estimate = estimator_.Estimate(raw_data);
+    auto end = std::chrono::steady_clock::now();
+    estimation_us_.Add(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    procedure_latency_us_.Add(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - written).count());
+    if (!estimate.has_value()) {
+      log::debug("Not enough usable tones for connection_handle 0x{:04x}", connection_handle);
+      num_dropped_procedures_++;
+      return;
+    }
+    log::verbose(
+        "connection_handle 0x{:04x}, ifft {:f} m, phase slope {:f} m, channels {}",
+        connection_handle,
+        estimate->ifft_meters,
+        estimate->phase_slope_meters,
+        estimate->num_channels);
+    RangingResult ranging_result;
+    ranging_result.result_meters_ = estimate->phase_slope_meters;
+    GetHandler()->Post(common::BindOnce(
+        &RangingHalHost::on_result, common::Unretained(this), connection_handle, ranging_result));
+  }
+
+  void on_opened(uint16_t connection_handle) {
+    if (ranging_hal_callback_ != nullptr) {
+      ranging_hal_callback_->OnOpened(connection_handle, {});
+    }
+  }
+
+  void on_result(uint16_t connection_handle, RangingResult ranging_result) {
+    if (ranging_hal_callback_ != nullptr) {
+      ranging_hal_callback_->OnResult(connection_handle, ranging_result);
+    }
+  }
+
+  RangingHalCallback* ranging_hal_callback_ = nullptr;
+  std::unique_ptr<os::Thread> worker_thread_;
+  std::unique_ptr<os::Handler> worker_handler_;
+  // Only used on the worker thread, then read once it is stopped
+  CsDistanceEstimator estimator_;
+  common::LatencyHistogram procedure_latency_us_;
+  common::LatencyHistogram estimation_us_;
+  size_t num_dropped_procedures_ = 0;
 };
 
 const ModuleFactory RangingHal::Factory = ModuleFactory([]() { return new RangingHalHost(); });
@@ -26,9 +26,7 @@ namespace hal {
 
 inline std::vector<uint8_t> SerializePacket(std::unique_ptr<packet::BasePacketBuilder> packet) {
   std::vector<uint8_t> packet_bytes;
-  packet_bytes.reserve(packet->size());
-  packet::BitInserter it(packet_bytes);
-  packet->Serialize(it);
+  packet->SerializeTo(packet_bytes);
   return packet_bytes;
 }
 
@@ -304,8 +304,14 @@ std::mutex filter_tracker_list_mutex;
 std::unordered_map<uint16_t, FilterTracker> filter_tracker_list;
 std::unordered_map<uint16_t, uint16_t> local_cid_to_acl;
 
+// A2DP media channels, keyed by A2dpChannelKey() so that each packet costs one hash lookup
 std::mutex a2dpMediaChannels_mutex;
-std::vector<SnoopLogger::A2dpMediaChannel> a2dpMediaChannels;
+std::unordered_map<uint32_t, uint16_t> a2dpMediaLocalCidToRemoteCid;
+std::unordered_set<uint32_t> a2dpMediaRemoteCids;
+
+uint32_t A2dpChannelKey(uint16_t conn_handle, uint16_t cid) {
+  return (static_cast<uint32_t>(conn_handle) << 16) | cid;
+}
 
 std::mutex snoop_log_filters_mutex;
 
@@ -592,6 +598,7 @@ void SnoopLogger::EnableFilters() {
     }
     log::info("{}: {}", itr->first, itr->second);
   }
+  UpdateFilterCache();
 }
 
 void SnoopLogger::DisableFilters() {
@@ -604,6 +611,18 @@ void SnoopLogger::DisableFilters() {
     itr->second = SnoopLogger::kBtSnoopLogFilterProfileModeDisabled;
     log::info("{}, {}", itr->first, itr->second);
   }
+  UpdateFilterCache();
+}
+
+void SnoopLogger::UpdateFilterCache() {
+  headers_filter_enabled_ = kBtSnoopLogFilterState[kBtSnoopLogFilterHeadersProperty];
+  a2dp_filter_enabled_ = kBtSnoopLogFilterState[kBtSnoopLogFilterProfileA2dpProperty];
+  rfcomm_filter_enabled_ = kBtSnoopLogFilterState[kBtSnoopLogFilterProfileRfcommProperty];
+  profiles_filter_enabled_ =
+      kBtSnoopLogFilterMode[kBtSnoopLogFilterProfilePbapModeProperty] !=
+          kBtSnoopLogFilterProfileModeDisabled ||
+      kBtSnoopLogFilterMode[kBtSnoopLogFilterProfileMapModeProperty] !=
+          kBtSnoopLogFilterProfileModeDisabled;
 }
 
 bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
@@ -621,7 +640,7 @@ bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
   return false;
 }
 
-bool SnoopLogger::ShouldFilterLog(bool is_received, uint8_t* packet) {
+bool SnoopLogger::ShouldFilterLog(bool is_received, const uint8_t* packet) {
   uint16_t conn_handle =
       ((((uint16_t)packet[ACL_CHANNEL_OFFSET + 1]) << 8) + packet[ACL_CHANNEL_OFFSET]) & 0x0fff;
   std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
@@ -645,7 +664,7 @@ bool SnoopLogger::ShouldFilterLog(bool is_received, uint8_t* packet) {
 }
 
 void SnoopLogger::CalculateAclPacketLength(
-    uint32_t& length, uint8_t* packet, bool /* is_received */) {
+    uint32_t& length, const uint8_t* packet, bool /* is_received */) {
   uint32_t def_len =
       ((((uint16_t)packet[ACL_LENGTH_OFFSET + 1]) << 8) + packet[ACL_LENGTH_OFFSET]) +
       ACL_HEADER_LENGTH + PACKET_TYPE_LENGTH;
@@ -874,8 +893,7 @@ uint32_t SnoopLogger::FilterProfiles(bool is_received, uint8_t* packet) {
 
 void SnoopLogger::AcceptlistL2capChannel(
     uint16_t conn_handle, uint16_t local_cid, uint16_t remote_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !rfcomm_filter_enabled_) {
     return;
   }
 
@@ -892,8 +910,7 @@ void SnoopLogger::AcceptlistL2capChannel(
 }
 
 void SnoopLogger::AcceptlistRfcommDlci(uint16_t conn_handle, uint16_t local_cid, uint8_t dlci) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !rfcomm_filter_enabled_) {
     return;
   }
 
@@ -905,8 +922,7 @@ void SnoopLogger::AcceptlistRfcommDlci(uint16_t conn_handle, uint16_t local_cid,
 
 void SnoopLogger::AddRfcommL2capChannel(
     uint16_t conn_handle, uint16_t local_cid, uint16_t remote_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !rfcomm_filter_enabled_) {
     return;
   }
 
@@ -923,8 +939,7 @@ void SnoopLogger::AddRfcommL2capChannel(
 
 void SnoopLogger::ClearL2capAcceptlist(
     uint16_t conn_handle, uint16_t local_cid, uint16_t remote_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !rfcomm_filter_enabled_) {
     return;
   }
 
@@ -939,27 +954,19 @@ void SnoopLogger::ClearL2capAcceptlist(
 }
 
 bool SnoopLogger::IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !a2dp_filter_enabled_) {
     return false;
   }
 
   std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-  auto iter = std::find_if(
-      a2dpMediaChannels.begin(),
-      a2dpMediaChannels.end(),
-      [conn_handle, cid, is_local_cid](auto& el) {
-        if (el.conn_handle != conn_handle) return false;
-
-        if (is_local_cid) return el.local_cid == cid;
-
-        return el.remote_cid == cid;
-      });
-
-  return iter != a2dpMediaChannels.end();
+  uint32_t key = A2dpChannelKey(conn_handle, cid);
+  if (is_local_cid) {
+    return a2dpMediaLocalCidToRemoteCid.count(key) != 0;
+  }
+  return a2dpMediaRemoteCids.count(key) != 0;
 }
 
-bool SnoopLogger::IsA2dpMediaPacket(bool is_received, uint8_t* packet) {
+bool SnoopLogger::IsA2dpMediaPacket(bool is_received, const uint8_t* packet) {
   uint16_t cid, conn_handle;
   bool is_local_cid = is_received;
   /*is_received signifies Rx packet so packet will have local_cid at offset 6
@@ -973,8 +980,7 @@ bool SnoopLogger::IsA2dpMediaPacket(bool is_received, uint8_t* packet) {
 
 void SnoopLogger::AddA2dpMediaChannel(
     uint16_t conn_handle, uint16_t local_cid, uint16_t remote_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !a2dp_filter_enabled_) {
     return;
   }
 
@@ -985,32 +991,28 @@ void SnoopLogger::AddA2dpMediaChannel(
         local_cid,
         remote_cid);
     std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-    a2dpMediaChannels.push_back({conn_handle, local_cid, remote_cid});
+    a2dpMediaLocalCidToRemoteCid[A2dpChannelKey(conn_handle, local_cid)] = remote_cid;
+    a2dpMediaRemoteCids.insert(A2dpChannelKey(conn_handle, remote_cid));
   }
 }
 
 void SnoopLogger::RemoveA2dpMediaChannel(uint16_t conn_handle, uint16_t local_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !a2dp_filter_enabled_) {
     return;
   }
 
   std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-  a2dpMediaChannels.erase(
-      std::remove_if(
-          a2dpMediaChannels.begin(),
-          a2dpMediaChannels.end(),
-          [conn_handle, local_cid](auto& el) {
-            return (el.conn_handle == conn_handle && el.local_cid == local_cid);
-          }),
-      a2dpMediaChannels.end());
+  auto iter = a2dpMediaLocalCidToRemoteCid.find(A2dpChannelKey(conn_handle, local_cid));
+  if (iter == a2dpMediaLocalCidToRemoteCid.end()) {
+    return;
+  }
+  a2dpMediaRemoteCids.erase(A2dpChannelKey(conn_handle, iter->second));
+  a2dpMediaLocalCidToRemoteCid.erase(iter);
 }
 
 void SnoopLogger::SetRfcommPortOpen(
     uint16_t conn_handle, uint16_t local_cid, uint8_t dlci, uint16_t uuid, bool flow) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      (!IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) &&
-       !IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty))) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !profiles_filter_enabled_) {
     return;
   }
 
@@ -1054,9 +1056,7 @@ void SnoopLogger::SetRfcommPortOpen(
 
 void SnoopLogger::SetRfcommPortClose(
     uint16_t handle, uint16_t local_cid, uint8_t dlci, uint16_t uuid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      (!IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) &&
-       !IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty))) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !profiles_filter_enabled_) {
     return;
   }
 
@@ -1079,9 +1079,7 @@ void SnoopLogger::SetRfcommPortClose(
 
 void SnoopLogger::SetL2capChannelOpen(
     uint16_t handle, uint16_t local_cid, uint16_t remote_cid, uint16_t psm, bool flow) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      (!IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) &&
-       !IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty))) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !profiles_filter_enabled_) {
     return;
   }
 
@@ -1120,9 +1118,7 @@ void SnoopLogger::SetL2capChannelOpen(
 }
 
 void SnoopLogger::SetL2capChannelClose(uint16_t handle, uint16_t local_cid, uint16_t remote_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      (!IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) &&
-       !IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty))) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !profiles_filter_enabled_) {
     return;
   }
 
@@ -1143,7 +1139,8 @@ void SnoopLogger::SetL2capChannelClose(uint16_t handle, uint16_t local_cid, uint
 }
 
 void SnoopLogger::FilterCapturedPacket(
-    HciPacket& packet,
+    const HciPacket& packet,
+    HciPacket& filtered_packet,
     Direction direction,
     PacketType type,
     uint32_t& length,
@@ -1152,46 +1149,43 @@ void SnoopLogger::FilterCapturedPacket(
     return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
-    if (IsA2dpMediaPacket(direction == Direction::INCOMING, (uint8_t*)packet.data())) {
+  const uint8_t* data = packet.data();
+  if (a2dp_filter_enabled_) {
+    if (IsA2dpMediaPacket(direction == Direction::INCOMING, data)) {
       length = 0;
       return;
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterHeadersProperty)) {
-    CalculateAclPacketLength(length, (uint8_t*)packet.data(), direction == Direction::INCOMING);
+  if (headers_filter_enabled_) {
+    CalculateAclPacketLength(length, data, direction == Direction::INCOMING);
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) ||
-      IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty)) {
+  if (profiles_filter_enabled_) {
     // If HeadersFiltered applied, do not use ProfilesFiltered
     if (length == ntohl(header.length_original)) {
-      if (packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
+      filtered_packet = packet;
+      if (filtered_packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
         // Add additional bytes for magic string in case
         // payload length is less than the length of magic string.
-        packet.resize((size_t)(packet.size() + EXTRA_BUF_SIZE));
+        filtered_packet.resize((size_t)(filtered_packet.size() + EXTRA_BUF_SIZE));
       }
 
-      length = FilterProfiles(direction == Direction::INCOMING, (uint8_t*)packet.data());
+      length = FilterProfiles(direction == Direction::INCOMING, filtered_packet.data());
       if (length == 0) return;
+      data = filtered_packet.data();
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
-    bool shouldFilter =
-        SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, (uint8_t*)packet.data());
+  if (rfcomm_filter_enabled_) {
+    bool shouldFilter = SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, data);
     if (shouldFilter) {
       length = L2CAP_HEADER_SIZE + PACKET_TYPE_LENGTH;
     }
   }
 }
 
-void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction, PacketType type) {
-  //// TODO(b/335520123) update FilterCapture to stop modifying packets ////
-  HciPacket mutable_packet(immutable_packet);
-  HciPacket& packet = mutable_packet;
-  //////////////////////////////////////////////////////////////////////////
+void SnoopLogger::Capture(const HciPacket& packet, Direction direction, PacketType type) {
   uint64_t timestamp_us =
       std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
           .count();
@@ -1236,7 +1230,9 @@ void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction
       return;
     }
 
-    FilterCapturedPacket(packet, direction, type, length, header);
+    HciPacket filtered_packet;
+    FilterCapturedPacket(packet, filtered_packet, direction, type, length, header);
+    const HciPacket& captured_packet = filtered_packet.empty() ? packet : filtered_packet;
 
     if (length == 0) {
       return;
@@ -1244,32 +1240,42 @@ void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction
       header.length_captured = htonl(length);
     }
 
+    header.dropped_packets = htonl(static_cast<uint32_t>(writer_.GetDroppedCount()));
+    std::string record;
+    record.reserve(sizeof(PacketHeaderType) + length - 1);
+    record.append(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType));
+    record.append(reinterpret_cast<const char*>(captured_packet.data()), length - 1);
+    writer_.Enqueue(std::move(record));
+  }
+}
+
+void SnoopLogger::WriteRecords(const std::vector<std::string>& records) {
+  for (const auto& record : records) {
     packet_counter_++;
     if (packet_counter_ > max_packets_per_file_) {
       OpenNextSnoopLogFile();
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-      log::error("Failed to write packet header for btsnoop, error: \"{}\"", strerror(errno));
-    }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), length - 1)) {
-      log::error("Failed to write packet payload for btsnoop, error: \"{}\"", strerror(errno));
-    }
-
-    if (socket_ != nullptr) {
-      socket_->Write(&header, sizeof(PacketHeaderType));
-      socket_->Write(packet.data(), (size_t)(length - 1));
+    if (!btsnoop_ostream_.write(record.data(), record.size())) {
+      log::error("Failed to write packet for btsnoop, error: \"{}\"", strerror(errno));
     }
+  }
+  if (auto socket = socket_.load(); socket != nullptr) {
+    socket->WriteRecords(records);
+  }
 
-    // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
-    // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
-    // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
-    //       as write() syscall dumps data into kernel memory directly
-    if (!btsnoop_ostream_.flush()) {
-      log::error("Failed to flush, error: \"{}\"", strerror(errno));
-    }
+  // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
+  // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
+  // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
+  //       as write() syscall dumps data into kernel memory directly
+  if (!btsnoop_ostream_.flush()) {
+    log::error("Failed to flush, error: \"{}\"", strerror(errno));
   }
 }
 
+void SnoopLogger::WaitForPendingWrites() {
+  writer_.Flush();
+}
+
 void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
@@ -1340,6 +1346,8 @@ void SnoopLogger::Start() {
       snoop_logger_socket_thread_.reset();
       snoop_logger_socket_thread_ = nullptr;
     }
+
+    writer_.Start();
   }
   alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler());
   alarm_->Schedule(
@@ -1347,6 +1355,9 @@ void SnoopLogger::Start() {
 }
 
 void SnoopLogger::Stop() {
+  // Drain pending records before the file and socket go away. The writer may take file_mutex_ to
+  // rotate files, so it has to be stopped before the lock is held.
+  writer_.Stop();
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   log::debug("Closing btsnoop log data at {}", snoop_log_path_);
   CloseCurrentSnoopLogFile();
@@ -18,6 +18,7 @@
 
 #include <bluetooth/log.h>
 
+#include <atomic>
 #include <fstream>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,7 @@
 #include "hal/hci_hal.h"
 #include "hal/snoop_logger_socket_interface.h"
 #include "hal/snoop_logger_socket_thread.h"
+#include "hal/snoop_logger_writer.h"
 #include "hal/syscall_wrapper_impl.h"
 #include "module.h"
 #include "os/repeating_alarm.h"
@@ -264,6 +266,9 @@ class SnoopLogger : public ::bluetooth::Module {
 
   void RegisterSocket(SnoopLoggerSocketInterface* socket);
 
+  // Blocks until all packets captured so far have been written to the btsnoop file and socket.
+  void WaitForPendingWrites();
+
  protected:
   // Packet type length
   static const size_t PACKET_TYPE_LENGTH;
@@ -293,6 +298,8 @@ class SnoopLogger : public ::bluetooth::Module {
       bool snoop_log_persists);
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
+  // Runs on the writer thread; appends serialized records to the btsnoop file and socket.
+  void WriteRecords(const std::vector<std::string>& records);
   void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
   // Enable filters according to their sysprops
   void EnableFilters();
@@ -300,17 +307,19 @@ class SnoopLogger : public ::bluetooth::Module {
   void DisableFilters();
   // Check if the filter is enabled. Pass filter name as a string.
   bool IsFilterEnabled(std::string filter_name);
+  // Refresh the cached filter states, with snoop_log_filters_mutex held
+  void UpdateFilterCache();
   // Check if packet should be filtered (rfcommchannelfiltered mode)
-  bool ShouldFilterLog(bool is_received, uint8_t* packet);
+  bool ShouldFilterLog(bool is_received, const uint8_t* packet);
   // Calculate packet length (snoopheadersfiltered mode)
-  void CalculateAclPacketLength(uint32_t& length, uint8_t* packet, bool is_received);
+  void CalculateAclPacketLength(uint32_t& length, const uint8_t* packet, bool is_received);
   // Strip packet's payload (profilesfiltered mode)
   uint32_t PayloadStrip(
       profile_type_t current_profile, uint8_t* packet, uint32_t hdr_len, uint32_t pl_len);
   // Filter profile packet according to its filtering mode
   uint32_t FilterProfiles(bool is_received, uint8_t* packet);
   // Check if packet is A2DP media packet (a2dppktsfiltered mode)
-  bool IsA2dpMediaPacket(bool is_received, uint8_t* packet);
+  bool IsA2dpMediaPacket(bool is_received, const uint8_t* packet);
   // Chec if channel is cached in snoop logger for filtering (a2dppktsfiltered mode)
   bool IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid);
   // Handle HFP filtering while profilesfiltered enabled
@@ -326,8 +335,10 @@ class SnoopLogger : public ::bluetooth::Module {
       uint16_t l2cap_channel,
       uint32_t& offset,
       uint32_t total_length);
+  // Only the profiles filter rewrites the payload, into a copy of packet left in filtered_packet
   void FilterCapturedPacket(
-      HciPacket& packet,
+      const HciPacket& packet,
+      HciPacket& filtered_packet,
       Direction direction,
       PacketType type,
       uint32_t& length,
@@ -339,6 +350,7 @@ class SnoopLogger : public ::bluetooth::Module {
   static std::string btsnoop_mode_;
   std::string snoop_log_path_;
   std::string snooz_log_path_;
+  // While writer_ is running, it is the only user of btsnoop_ostream_ and packet_counter_
   std::ofstream btsnoop_ostream_;
   size_t max_packets_per_file_;
   common::CircularBuffer<std::string> btsnooz_buffer_;
@@ -348,9 +360,16 @@ class SnoopLogger : public ::bluetooth::Module {
   std::unique_ptr<os::RepeatingAlarm> alarm_;
   std::chrono::milliseconds snooz_log_life_time_;
   std::chrono::milliseconds snooz_log_delete_alarm_interval_;
-  SnoopLoggerSocketInterface* socket_;
+  std::atomic<SnoopLoggerSocketInterface*> socket_;
   SyscallWrapperImpl syscall_if;
   bool snoop_log_persists = false;
+  // Copies of kBtSnoopLogFilterState and kBtSnoopLogFilterMode, so that filtering a packet neither
+  // locks nor looks the filters up by name
+  std::atomic<bool> headers_filter_enabled_{false};
+  std::atomic<bool> a2dp_filter_enabled_{false};
+  std::atomic<bool> rfcomm_filter_enabled_{false};
+  std::atomic<bool> profiles_filter_enabled_{false};
+  SnoopLoggerWriter writer_{[this](const std::vector<std::string>& records) { WriteRecords(records); }};
 };
 
 }  // namespace hal
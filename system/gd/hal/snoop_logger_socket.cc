@@ -32,6 +32,7 @@
 #include <unistd.h>
 
 #include <cerrno>
+#include <cstring>
 #include <mutex>
 
 #include "common/init_flags.h"
@@ -48,6 +49,12 @@ static constexpr int INVALID_FD = -1;
 
 constexpr int INCOMING_SOCKET_CONNECTIONS_QUEUE_SIZE_ = 10;
 
+// Offset of dropped_packets in SnoopLogger::PacketHeaderType, which starts every record.
+constexpr size_t kRecordDroppedPacketsOffset = 3 * sizeof(uint32_t);
+
+// How long the listen thread waits before retrying to send records the client has not read yet.
+constexpr suseconds_t kPendingRecordsRetryUs = 20 * 1000;
+
 SnoopLoggerSocket::SnoopLoggerSocket(SyscallWrapperInterface* syscall_if, int socket_address, int socket_port)
     : syscall_if_(syscall_if),
       socket_address_(socket_address),
@@ -84,6 +91,57 @@ void SnoopLoggerSocket::Write(const void* data, size_t length) {
   Write(client_socket_, data, length);
 }
 
+void SnoopLoggerSocket::WriteRecords(const std::vector<std::string>& records) {
+  std::lock_guard<std::mutex> lock(client_socket_mutex_);
+  if (client_socket_ == -1) {
+    return;
+  }
+
+  for (const auto& record : records) {
+    if (pending_records_.size() + record.size() > kMaxPendingBytes) {
+      if (dropped_records_++ == 0) {
+        log::warn("Dropping snoop pkts because the client is not reading them");
+      }
+      continue;
+    }
+    size_t offset = pending_records_.size();
+    pending_records_.append(record);
+    if (dropped_records_ != 0 && record.size() >= kRecordDroppedPacketsOffset + sizeof(uint32_t)) {
+      // The field is the number of packets dropped since the capture started: add ours to it.
+      uint32_t dropped_packets;
+      char* field = &pending_records_[offset + kRecordDroppedPacketsOffset];
+      memcpy(&dropped_packets, field, sizeof(dropped_packets));
+      dropped_packets = htonl(ntohl(dropped_packets) + static_cast<uint32_t>(dropped_records_));
+      memcpy(field, &dropped_packets, sizeof(dropped_packets));
+    }
+  }
+
+  FlushPendingRecords();
+}
+
+void SnoopLoggerSocket::FlushPendingRecords() {
+  if (client_socket_ == -1 || pending_records_.empty()) {
+    return;
+  }
+
+  ssize_t ret;
+  RUN_NO_INTR(
+      ret = syscall_if_->Send(client_socket_, pending_records_.data(), pending_records_.size(), MSG_DONTWAIT));
+
+  if (ret > 0) {
+    pending_records_.erase(0, ret);
+  } else if (ret == -1 && syscall_if_->GetErrno() != EAGAIN) {
+    log::warn("Closing snoop client socket: {}", strerror(syscall_if_->GetErrno()));
+    SafeCloseSocket(client_socket_);
+    pending_records_.clear();
+  }
+}
+
+size_t SnoopLoggerSocket::GetDroppedRecordCount() {
+  std::lock_guard<std::mutex> lock(client_socket_mutex_);
+  return dropped_records_;
+}
+
 int SnoopLoggerSocket::InitializeCommunications() {
   int self_pipe_fds[2];
   int ret;
@@ -120,7 +178,22 @@ bool SnoopLoggerSocket::ProcessIncomingRequest() {
   int ret;
   fd_set sock_fds = save_sock_fds_;
 
-  if ((syscall_if_->Select(fd_max_ + 1, &sock_fds, NULL, NULL, NULL)) == -1) {
+  // Wake up to retry sending the records the client has not read yet, if any.
+  struct timeval retry_timeout = {.tv_sec = 0, .tv_usec = kPendingRecordsRetryUs};
+  bool has_pending_records;
+  {
+    std::lock_guard<std::mutex> lock(client_socket_mutex_);
+    has_pending_records = !pending_records_.empty();
+  }
+
+  ret = syscall_if_->Select(fd_max_ + 1, &sock_fds, NULL, NULL, has_pending_records ? &retry_timeout : NULL);
+
+  if (has_pending_records) {
+    std::lock_guard<std::mutex> lock(client_socket_mutex_);
+    FlushPendingRecords();
+  }
+
+  if (ret == -1) {
     log::error("select failed {}", strerror(syscall_if_->GetErrno()));
     if (syscall_if_->GetErrno() == EINTR) return true;
     return false;
@@ -192,6 +265,8 @@ void SnoopLoggerSocket::ClientSocketConnected(int client_socket) {
   std::lock_guard<std::mutex> lock(client_socket_mutex_);
   SafeCloseSocket(client_socket_);
   client_socket_ = client_socket;
+  pending_records_.clear();
+  dropped_records_ = 0;
   client_socket_cv_.notify_one();
 }
 
@@ -21,7 +21,9 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "hal/snoop_logger_socket_interface.h"
 #include "hal/syscall_wrapper_interface.h"
@@ -33,6 +35,8 @@ class SnoopLoggerSocket {
  public:
   static constexpr int DEFAULT_LOCALHOST_ = 0x7F000001;
   static constexpr int DEFAULT_LISTEN_PORT_ = 8872;
+  // Records the client has not read yet are kept up to this size, then dropped.
+  static constexpr size_t kMaxPendingBytes = 1024 * 1024;
 
   SnoopLoggerSocket(
       SyscallWrapperInterface* syscall_if, int address = DEFAULT_LOCALHOST_, int port = DEFAULT_LISTEN_PORT_);
@@ -47,6 +51,11 @@ class SnoopLoggerSocket {
   bool WaitForClientSocketConnected();
   int NotifySocketListener();
   void Write(const void* data, size_t length);
+  // Queues the records for the client and sends as much of the queue as the socket takes, without
+  // blocking. Records that do not fit in kMaxPendingBytes are dropped, and the records sent after
+  // them carry the number of dropped records in their dropped_packets field.
+  void WriteRecords(const std::vector<std::string>& records);
+  size_t GetDroppedRecordCount();
 
   int AcceptIncomingConnection(int listen_socket, int& client_socket);
   int CreateSocket();
@@ -54,6 +63,8 @@ class SnoopLoggerSocket {
   void InitializeClientSocket(int client_socket);
   void SafeCloseSocket(int& fd);
   void Write(int& client_socket, const void* data, size_t length);
+  // Called with client_socket_mutex_ held.
+  void FlushPendingRecords();
 
   SyscallWrapperInterface* GetSyscallWrapperInterface() const;
 
@@ -81,6 +92,10 @@ class SnoopLoggerSocket {
   std::mutex client_socket_mutex_;
   int client_socket_;
   std::condition_variable client_socket_cv_;
+
+  // Records queued for client_socket_, the first one possibly partly sent already.
+  std::string pending_records_;
+  size_t dropped_records_ = 0;
 };
 
 }  // namespace hal
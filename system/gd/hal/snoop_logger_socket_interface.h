@@ -20,6 +20,9 @@
 
 #include <stddef.h>
 
+#include <string>
+#include <vector>
+
 namespace bluetooth {
 namespace hal {
 
@@ -28,6 +31,13 @@ class SnoopLoggerSocketInterface {
   virtual ~SnoopLoggerSocketInterface() = default;
 
   virtual void Write(const void* data, size_t length) = 0;
+
+  // Writes a batch of btsnoop records, each a PacketHeaderType followed by the packet.
+  virtual void WriteRecords(const std::vector<std::string>& records) {
+    for (const auto& record : records) {
+      Write(record.data(), record.size());
+    }
+  }
 };
 
 }  // namespace hal
@@ -16,12 +16,16 @@
 
 #include "hal/snoop_logger_socket.h"
 
+#include <arpa/inet.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
+#include <string>
 
 #include "common/init_flags.h"
 #include "hal/snoop_logger_common.h"
@@ -219,6 +223,84 @@ TEST_F(SnoopLoggerSocketModuleTest, test_Write_success) {
   EXPECT_CALL(mock, FDClr(Eq(client_fd), _));
 }
 
+TEST_F(SnoopLoggerSocketModuleTest, test_WriteRecords_resends_what_the_client_did_not_read) {
+  int client_fd = 33;
+  size_t accepted_bytes = 3;
+  std::string sent;
+
+  ON_CALL(mock, Send(client_fd, _, _, _))
+      .WillByDefault(Invoke([&](int, const void* buf, size_t n, int) -> ssize_t {
+        if (accepted_bytes == 0) return -1;
+        size_t length = std::min(n, accepted_bytes);
+        sent.append(static_cast<const char*>(buf), length);
+        return length;
+      }));
+  ON_CALL(mock, GetErrno()).WillByDefault(Return(EAGAIN));
+  EXPECT_CALL(mock, Send(client_fd, _, _, _)).Times(3);
+  EXPECT_CALL(mock, GetErrno).Times(AnyNumber());
+  EXPECT_CALL(mock, Close(client_fd)).Times(1);
+  EXPECT_CALL(mock, FDClr(Eq(client_fd), _));
+
+  sls.ClientSocketConnected(client_fd);
+
+  sls.WriteRecords({"first", "second"});
+  ASSERT_EQ(sent, "fir");
+
+  accepted_bytes = 0;
+  sls.WriteRecords({"third"});
+  ASSERT_EQ(sent, "fir");
+
+  accepted_bytes = SnoopLoggerSocket::kMaxPendingBytes;
+  sls.WriteRecords({});
+  ASSERT_EQ(sent, "firstsecondthird");
+  ASSERT_EQ(sls.GetDroppedRecordCount(), 0u);
+}
+
+TEST_F(SnoopLoggerSocketModuleTest, test_WriteRecords_drops_records_and_reports_them) {
+  int client_fd = 33;
+  bool client_reads = false;
+  std::string sent;
+
+  ON_CALL(mock, Send(client_fd, _, _, _))
+      .WillByDefault(Invoke([&](int, const void* buf, size_t n, int) -> ssize_t {
+        if (!client_reads) return -1;
+        sent.append(static_cast<const char*>(buf), n);
+        return n;
+      }));
+  ON_CALL(mock, GetErrno()).WillByDefault(Return(EAGAIN));
+  EXPECT_CALL(mock, Send(client_fd, _, _, _)).Times(3);
+  EXPECT_CALL(mock, GetErrno).Times(AnyNumber());
+  EXPECT_CALL(mock, Close(client_fd)).Times(1);
+  EXPECT_CALL(mock, FDClr(Eq(client_fd), _));
+
+  sls.ClientSocketConnected(client_fd);
+
+  // Records start with a btsnoop packet header, dropped_packets at offset 12 in network order.
+  constexpr size_t kDroppedPacketsOffset = 12;
+  std::string large_record(SnoopLoggerSocket::kMaxPendingBytes / 4, '\0');
+  std::string small_record(32, '\0');
+  uint32_t dropped_packets = htonl(2);
+  memcpy(&small_record[kDroppedPacketsOffset], &dropped_packets, sizeof(dropped_packets));
+
+  // The client does not read: one record too many does not fit.
+  sls.WriteRecords({large_record, large_record, large_record, large_record, large_record});
+  ASSERT_EQ(sls.GetDroppedRecordCount(), 1u);
+
+  // The client reads again, after the backlog is full.
+  client_reads = true;
+  sls.WriteRecords({small_record});
+  ASSERT_EQ(sls.GetDroppedRecordCount(), 2u);
+  ASSERT_EQ(sent.size(), SnoopLoggerSocket::kMaxPendingBytes);
+
+  sls.WriteRecords({small_record});
+  ASSERT_EQ(sent.size(), SnoopLoggerSocket::kMaxPendingBytes + small_record.size());
+  memcpy(
+      &dropped_packets,
+      &sent[SnoopLoggerSocket::kMaxPendingBytes + kDroppedPacketsOffset],
+      sizeof(dropped_packets));
+  ASSERT_EQ(ntohl(dropped_packets), 2u + 2u);
+}
+
 TEST_F(SnoopLoggerSocketModuleTest, test_Write_fd_fail_on_Send_EINTR) {
   char data[10];
   int intr_count = 5;
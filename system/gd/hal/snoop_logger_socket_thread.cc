@@ -73,6 +73,10 @@ void SnoopLoggerSocketThread::Write(const void* data, size_t length) {
   socket_->Write(data, length);
 }
 
+void SnoopLoggerSocketThread::WriteRecords(const std::vector<std::string>& records) {
+  socket_->WriteRecords(records);
+}
+
 bool SnoopLoggerSocketThread::ThreadIsRunning() const {
   return listen_thread_running_;
 }
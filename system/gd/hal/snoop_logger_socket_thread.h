@@ -40,6 +40,7 @@ class SnoopLoggerSocketThread : public SnoopLoggerSocketInterface {
   std::future<bool> Start();
   void Stop();
   void Write(const void* data, size_t length) override;
+  void WriteRecords(const std::vector<std::string>& records) override;
   bool ThreadIsRunning() const;
 
   SnoopLoggerSocket* GetSocket();
@@ -743,6 +743,50 @@ TEST_F(SnoopLoggerModuleTest, a2dp_packets_filtered_negative_test) {
   ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_filtered));
 }
 
+TEST_F(SnoopLoggerModuleTest, a2dp_packets_filtered_by_direction_and_connection_test) {
+  uint16_t conn_handle = 0x000b;
+  uint16_t local_cid = 0x0041;
+  uint16_t remote_cid = 0xa040;
+
+  ASSERT_TRUE(
+      bluetooth::os::SetSystemProperty(SnoopLogger::kBtSnoopLogFilterProfileA2dpProperty, "true"));
+
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFiltered,
+      false,
+      false);
+
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  // The same CIDs on another connection, removed again, must not affect this one
+  snoop_logger->AddA2dpMediaChannel(conn_handle, local_cid, remote_cid);
+  snoop_logger->AddA2dpMediaChannel(conn_handle + 1, local_cid, remote_cid);
+  snoop_logger->RemoveA2dpMediaChannel(conn_handle + 1, local_cid);
+
+  // Outgoing, the packet carries the remote CID of the media channel: filtered
+  snoop_logger->Capture(
+      kA2dpMediaPacket, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+  // Incoming, the same CID is not a local CID of a media channel: not filtered
+  snoop_logger->Capture(
+      kA2dpMediaPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
+
+  test_registry.StopAll();
+
+  ASSERT_TRUE(
+      bluetooth::os::SetSystemProperty(SnoopLogger::kBtSnoopLogFilterProfileA2dpProperty, "false"));
+
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_filtered));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_filtered),
+      sizeof(SnoopLoggerCommon::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType) +
+          kA2dpMediaPacket.size());
+  ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_filtered));
+}
+
 TEST_F(SnoopLoggerModuleTest, headers_filtered_test) {
   ASSERT_TRUE(
       bluetooth::os::SetSystemProperty(SnoopLogger::kBtSnoopLogFilterHeadersProperty, "true"));
@@ -1575,6 +1619,7 @@ TEST_F(SnoopLoggerModuleTest, custom_socket_interface_register_logging_enabled_t
 
   snoop_logger->RegisterSocket(&mock);
   snoop_logger->Capture(kQualcommConnectionRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+  snoop_logger->WaitForPendingWrites();
 
   ASSERT_TRUE(mock.write_called);
 
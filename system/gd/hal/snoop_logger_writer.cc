@@ -0,0 +1,116 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_writer.h"
+
+#include <bluetooth/log.h>
+#include <sys/prctl.h>
+
+namespace bluetooth {
+namespace hal {
+
+SnoopLoggerWriter::SnoopLoggerWriter(Sink sink, size_t max_backlog_bytes)
+    : sink_(std::move(sink)), max_backlog_bytes_(max_backlog_bytes) {}
+
+SnoopLoggerWriter::~SnoopLoggerWriter() {
+  Stop();
+}
+
+void SnoopLoggerWriter::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (thread_.joinable()) {
+    return;
+  }
+  stop_ = false;
+  thread_ = std::thread(&SnoopLoggerWriter::run, this);
+}
+
+void SnoopLoggerWriter::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+void SnoopLoggerWriter::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  drained_cv_.wait(lock, [this] { return pending_records_.load(std::memory_order_acquire) == 0; });
+}
+
+bool SnoopLoggerWriter::Enqueue(std::string record) {
+  size_t size = record.size();
+  if (backlog_bytes_.fetch_add(size, std::memory_order_relaxed) + size > max_backlog_bytes_) {
+    backlog_bytes_.fetch_sub(size, std::memory_order_relaxed);
+    if (dropped_records_.fetch_add(1, std::memory_order_relaxed) % 1000 == 0) {
+      log::warn("btsnoop writer backlog full, dropped {} records", GetDroppedCount());
+    }
+    return false;
+  }
+
+  queue_.Push(std::move(record));
+  if (pending_records_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    // Taking the lock orders this notification after the writer checked its wait predicate.
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_one();
+  }
+  return true;
+}
+
+size_t SnoopLoggerWriter::GetDroppedCount() const {
+  return dropped_records_.load(std::memory_order_relaxed);
+}
+
+size_t SnoopLoggerWriter::GetBacklogBytes() const {
+  return backlog_bytes_.load(std::memory_order_relaxed);
+}
+
+void SnoopLoggerWriter::run() {
+  prctl(PR_SET_NAME, "bt_snoop_writer");
+  std::vector<std::string> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || pending_records_.load(std::memory_order_acquire) > 0; });
+      if (stop_ && pending_records_.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+    }
+
+    size_t count = pending_records_.load(std::memory_order_acquire);
+    size_t bytes = 0;
+    batch.resize(count);
+    for (auto& record : batch) {
+      // A counted record can sit behind one that another producer is still linking into the queue
+      queue_.Pop(&record);
+      bytes += record.size();
+    }
+    sink_(batch);
+    backlog_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    batch.clear();
+    if (pending_records_.fetch_sub(count, std::memory_order_acq_rel) == count) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      drained_cv_.notify_all();
+    }
+  }
+}
+
+}  // namespace hal
+}  // namespace bluetooth
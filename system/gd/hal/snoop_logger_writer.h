@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "os/mpsc_queue.h"
+
+namespace bluetooth {
+namespace hal {
+
+// Moves btsnoop record writes off the HCI path.
+//
+// Capture threads serialize a record and hand it over with Enqueue(), which does not block: records
+// go through a lock-free queue and the writer thread is only signalled when the queue goes from
+// empty to non-empty. The writer passes everything queued since its last wakeup to |sink| as one
+// batch. The amount of queued data is bounded; records that do not fit are dropped and counted.
+class SnoopLoggerWriter {
+ public:
+  static constexpr size_t kDefaultMaxBacklogBytes = 4 * 1024 * 1024;
+
+  using Sink = std::function<void(const std::vector<std::string>& records)>;
+
+  SnoopLoggerWriter(Sink sink, size_t max_backlog_bytes = kDefaultMaxBacklogBytes);
+  SnoopLoggerWriter(const SnoopLoggerWriter&) = delete;
+  SnoopLoggerWriter& operator=(const SnoopLoggerWriter&) = delete;
+  ~SnoopLoggerWriter();
+
+  void Start();
+  // Writes out everything enqueued so far, then joins the writer thread.
+  void Stop();
+  // Blocks until every record enqueued so far has been passed to the sink. Only valid while the
+  // writer is running.
+  void Flush();
+
+  // Returns false if the record was dropped because the backlog is full.
+  bool Enqueue(std::string record);
+
+  size_t GetDroppedCount() const;
+  size_t GetBacklogBytes() const;
+
+ private:
+  void run();
+
+  Sink sink_;
+  const size_t max_backlog_bytes_;
+  os::MpscQueue<std::string> queue_;
+  std::atomic<size_t> pending_records_ = 0;
+  std::atomic<size_t> backlog_bytes_ = 0;
+  std::atomic<size_t> dropped_records_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable drained_cv_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+class SnoopLoggerWriterTest : public ::testing::Test {
+ protected:
+  SnoopLoggerWriter::Sink Sink() {
+    return [this](const std::vector<std::string>& records) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batches_++;
+      written_.insert(written_.end(), records.begin(), records.end());
+    };
+  }
+
+  std::mutex mutex_;
+  size_t batches_ = 0;
+  std::vector<std::string> written_;
+};
+
+TEST_F(SnoopLoggerWriterTest, stop_writes_everything_in_order) {
+  SnoopLoggerWriter writer(Sink());
+  writer.Start();
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(writer.Enqueue(std::to_string(i)));
+  }
+  writer.Stop();
+
+  ASSERT_EQ(1000ul, written_.size());
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(std::to_string(i), written_[i]);
+  }
+  ASSERT_LE(batches_, 1000ul);
+  ASSERT_EQ(0ul, writer.GetBacklogBytes());
+  ASSERT_EQ(0ul, writer.GetDroppedCount());
+}
+
+TEST_F(SnoopLoggerWriterTest, flush_waits_for_sink) {
+  SnoopLoggerWriter writer(Sink());
+  writer.Start();
+  ASSERT_TRUE(writer.Enqueue("record"));
+  writer.Flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_EQ(1ul, written_.size());
+  }
+  writer.Stop();
+}
+
+TEST_F(SnoopLoggerWriterTest, records_over_backlog_are_dropped) {
+  // Not started, so nothing drains the backlog
+  SnoopLoggerWriter writer(Sink(), 10);
+  ASSERT_TRUE(writer.Enqueue("12345"));
+  ASSERT_TRUE(writer.Enqueue("12345"));
+  ASSERT_FALSE(writer.Enqueue("1"));
+  ASSERT_EQ(1ul, writer.GetDroppedCount());
+  ASSERT_EQ(10ul, writer.GetBacklogBytes());
+
+  writer.Start();
+  writer.Stop();
+  ASSERT_EQ(2ul, written_.size());
+  ASSERT_EQ(0ul, writer.GetBacklogBytes());
+}
+
+TEST_F(SnoopLoggerWriterTest, concurrent_producers) {
+  constexpr int kProducers = 4;
+  constexpr int kRecordsPerProducer = 10000;
+  SnoopLoggerWriter writer(Sink());
+  writer.Start();
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.emplace_back([&writer, p] {
+      for (int i = 0; i < kRecordsPerProducer; i++) {
+        writer.Enqueue(std::to_string(p) + ":" + std::to_string(i));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  writer.Stop();
+
+  ASSERT_EQ(static_cast<size_t>(kProducers * kRecordsPerProducer), written_.size() + writer.GetDroppedCount());
+  // Records of a single producer keep their order
+  std::vector<int> next(kProducers, 0);
+  for (const auto& record : written_) {
+    int p = record[0] - '0';
+    int i = std::stoi(record.substr(2));
+    ASSERT_LE(next[p], i);
+    next[p] = i + 1;
+  }
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
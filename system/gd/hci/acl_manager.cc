@@ -154,8 +154,15 @@ struct AclManager::impl {
       retry_unknown_acl(/* timed_out = */ false);
     }
 
-    auto packet = hci_queue_end_->TryDequeue();
-    log::assert_that(packet != nullptr, "assert failed: packet != nullptr");
+    // Route everything that is ready with one reactor wake up
+    auto packets = hci_queue_end_->TryDequeueBatch(kMaxAclPacketsPerDequeue);
+    log::assert_that(!packets.empty(), "assert failed: !packets.empty()");
+    for (auto& packet : packets) {
+      route_acl_packet_to_connection(std::move(packet));
+    }
+  }
+
+  void route_acl_packet_to_connection(std::unique_ptr<AclView> packet) {
     if (!packet->IsValid()) {
       log::info("Dropping invalid packet of size {}", packet->size());
       return;
@@ -200,6 +207,8 @@ struct AclManager::impl {
   std::unique_ptr<os::Alarm> unknown_acl_alarm_;
   std::vector<AclView> waiting_packets_;
   static constexpr std::chrono::seconds kWaitBeforeDroppingUnknownAcl{1};
+  // Maximum number of packets routed per dequeue callback
+  static constexpr size_t kMaxAclPacketsPerDequeue = 16;
 };
 
 AclManager::AclManager() : pimpl_(std::make_unique<impl>(*this)) {}
@@ -16,6 +16,9 @@
 
 #include "hci/acl_manager/acl_fragmenter.h"
 
+#include <algorithm>
+
+#include "packet/bit_inserter.h"
 #include "packet/fragmenting_inserter.h"
 
 namespace bluetooth {
@@ -33,6 +36,24 @@ std::vector<std::unique_ptr<packet::RawBuilder>> AclFragmenter::GetFragments() {
   return to_return;
 }
 
+std::vector<std::unique_ptr<packet::SliceBuilder>> AclFragmenter::GetFragmentSlices() {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(packet_->size());
+  {
+    packet::BitInserter it(*bytes);
+    packet_->Serialize(it);
+  }
+  std::shared_ptr<const std::vector<uint8_t>> buffer = std::move(bytes);
+
+  std::vector<std::unique_ptr<packet::SliceBuilder>> to_return;
+  to_return.reserve((buffer->size() + mtu_ - 1) / mtu_);
+  for (size_t begin = 0; begin < buffer->size(); begin += mtu_) {
+    to_return.push_back(
+        std::make_unique<packet::SliceBuilder>(buffer, begin, std::min(begin + mtu_, buffer->size())));
+  }
+  return to_return;
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
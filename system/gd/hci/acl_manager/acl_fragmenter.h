@@ -21,6 +21,7 @@
 
 #include "packet/base_packet_builder.h"
 #include "packet/raw_builder.h"
+#include "packet/slice_builder.h"
 
 namespace bluetooth {
 namespace hci {
@@ -33,6 +34,10 @@ class AclFragmenter {
 
   std::vector<std::unique_ptr<packet::RawBuilder>> GetFragments();
 
+  // Serialize the packet once and return fragments of at most |mtu| bytes that refer to ranges of
+  // that single buffer, instead of copying each fragment into its own RawBuilder.
+  std::vector<std::unique_ptr<packet::SliceBuilder>> GetFragmentSlices();
+
  private:
   size_t mtu_;
   std::unique_ptr<packet::BasePacketBuilder> packet_;
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_fragmenter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+std::unique_ptr<packet::RawBuilder> MakePayload(size_t size) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; i++) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  return std::make_unique<packet::RawBuilder>(bytes);
+}
+
+template <typename Builder>
+std::vector<uint8_t> Concatenate(const std::vector<std::unique_ptr<Builder>>& fragments) {
+  std::vector<uint8_t> bytes;
+  packet::BitInserter it(bytes);
+  for (const auto& fragment : fragments) {
+    fragment->Serialize(it);
+  }
+  return bytes;
+}
+
+TEST(AclFragmenterTest, slices_match_copied_fragments) {
+  constexpr size_t kMtu = 27;
+  auto copied = AclFragmenter(kMtu, MakePayload(100)).GetFragments();
+  auto sliced = AclFragmenter(kMtu, MakePayload(100)).GetFragmentSlices();
+
+  ASSERT_EQ(copied.size(), sliced.size());
+  for (size_t i = 0; i < copied.size(); i++) {
+    ASSERT_EQ(copied[i]->size(), sliced[i]->size());
+  }
+  ASSERT_EQ(Concatenate(copied), Concatenate(sliced));
+}
+
+TEST(AclFragmenterTest, slices_share_one_buffer) {
+  constexpr size_t kMtu = 10;
+  auto sliced = AclFragmenter(kMtu, MakePayload(25)).GetFragmentSlices();
+  ASSERT_EQ(3u, sliced.size());
+  ASSERT_EQ(sliced[0]->data() + kMtu, sliced[1]->data());
+  ASSERT_EQ(sliced[1]->data() + kMtu, sliced[2]->data());
+  ASSERT_EQ(5u, sliced[2]->size());
+}
+
+TEST(AclFragmenterTest, exact_multiple_of_mtu) {
+  constexpr size_t kMtu = 10;
+  auto sliced = AclFragmenter(kMtu, MakePayload(20)).GetFragmentSlices();
+  ASSERT_EQ(2u, sliced.size());
+  ASSERT_EQ(kMtu, sliced[1]->size());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -102,6 +102,22 @@ inline std::string connectability_state_machine_text(const ConnectabilityState&
   }
 }
 
+// Scan parameters the create connection is armed with: fast while a direct connection is pending,
+// slow for background connections only.
+enum class ConnectionScanPhase {
+  SLOW = 0,
+  FAST = 1,
+  SYSTEM_SUSPEND = 2,
+};
+
+inline std::string connection_scan_phase_text(const ConnectionScanPhase& phase) {
+  switch (phase) {
+    CASE_RETURN_TEXT(ConnectionScanPhase::SLOW);
+    CASE_RETURN_TEXT(ConnectionScanPhase::FAST);
+    CASE_RETURN_TEXT(ConnectionScanPhase::SYSTEM_SUSPEND);
+  }
+}
+
 struct le_acl_connection {
   le_acl_connection(
       AddressWithType remote_address,
@@ -714,8 +730,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
     accept_list.insert(address_with_type);
     register_with_address_manager();
-    le_address_manager_->AddDeviceToFilterAcceptList(
-        address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    schedule_accept_list_update();
   }
 
   bool is_device_in_accept_list(AddressWithType address_with_type) {
@@ -730,16 +745,53 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     accept_list.erase(address_with_type);
     connecting_le_.erase(address_with_type);
     register_with_address_manager();
-    le_address_manager_->RemoveDeviceFromFilterAcceptList(
-        address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    schedule_accept_list_update();
   }
 
   void clear_filter_accept_list() {
     accept_list.clear();
+    controller_accept_list_.clear();
     register_with_address_manager();
     le_address_manager_->ClearFilterAcceptList();
   }
 
+  // Changes made within one handler iteration (e.g. many apps registering background connections at boot)
+  // are folded into a single diff against the controller, sent in one pause/resume window.
+  void schedule_accept_list_update() {
+    accept_list_changes_requested_++;
+    if (accept_list_update_scheduled_) {
+      return;
+    }
+    accept_list_update_scheduled_ = true;
+    handler_->CallOn(this, &le_impl::apply_accept_list_update);
+  }
+
+  void apply_accept_list_update() {
+    accept_list_update_scheduled_ = false;
+
+    std::vector<AddressWithType> to_remove;
+    for (const auto& address_with_type : controller_accept_list_) {
+      if (accept_list.find(address_with_type) == accept_list.end()) {
+        to_remove.push_back(address_with_type);
+      }
+    }
+    std::vector<AddressWithType> to_add;
+    for (const auto& address_with_type : accept_list) {
+      if (controller_accept_list_.find(address_with_type) == controller_accept_list_.end()) {
+        to_add.push_back(address_with_type);
+      }
+    }
+
+    controller_accept_list_ = accept_list;
+    accept_list_commands_sent_ += to_remove.size() + to_add.size();
+    log::debug(
+        "Filter accept list update: {} removed, {} added, {} commands saved so far",
+        to_remove.size(),
+        to_add.size(),
+        accept_list_changes_requested_ - accept_list_commands_sent_);
+    le_address_manager_->UpdateFilterAcceptList(to_remove, to_add);
+  }
+
   void add_device_to_resolving_list(
       AddressWithType address_with_type,
       const std::array<uint8_t, 16>& peer_irk,
@@ -819,20 +871,21 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     AddressWithType empty(Address::kEmpty, AddressType::RANDOM_DEVICE_ADDRESS);
     connectability_state_ = ConnectabilityState::ARMING;
     connecting_le_ = accept_list;
+    armed_scan_phase_ = wanted_scan_phase();
 
     uint16_t le_scan_interval = os::GetSystemPropertyUint32(kPropertyConnScanIntervalSlow, kScanIntervalSlow);
     uint16_t le_scan_window = os::GetSystemPropertyUint32(kPropertyConnScanWindowSlow, kScanWindowSlow);
     uint16_t le_scan_window_2m = le_scan_window;
     uint16_t le_scan_window_coded = le_scan_window;
     // If there is any direct connection in the connection list, use the fast parameter
-    if (!direct_connections_.empty()) {
+    if (armed_scan_phase_ == ConnectionScanPhase::FAST) {
       le_scan_interval = os::GetSystemPropertyUint32(kPropertyConnScanIntervalFast, kScanIntervalFast);
       le_scan_window = os::GetSystemPropertyUint32(kPropertyConnScanWindowFast, kScanWindowFast);
       le_scan_window_2m = os::GetSystemPropertyUint32(kPropertyConnScanWindow2mFast, kScanWindow2mFast);
       le_scan_window_coded = os::GetSystemPropertyUint32(kPropertyConnScanWindowCodedFast, kScanWindowCodedFast);
     }
     // Use specific parameters when in system suspend.
-    if (system_suspend_) {
+    if (armed_scan_phase_ == ConnectionScanPhase::SYSTEM_SUSPEND) {
       le_scan_interval = os::GetSystemPropertyUint32(
           kPropertyConnScanIntervalSystemSuspend, kScanIntervalSystemSuspend);
       le_scan_window = os::GetSystemPropertyUint32(
@@ -929,6 +982,25 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
   }
 
+  ConnectionScanPhase wanted_scan_phase() const {
+    if (system_suspend_) {
+      return ConnectionScanPhase::SYSTEM_SUSPEND;
+    }
+    return direct_connections_.empty() ? ConnectionScanPhase::SLOW : ConnectionScanPhase::FAST;
+  }
+
+  // Whether the create connection being armed, or armed, already initiates to every device of the
+  // accept list with the scan parameters they need. Cancelling it to re-arm would then only send the
+  // same command again, and lose the connections that could be made in between.
+  bool armed_for_accept_list() const {
+    if (connectability_state_ != ConnectabilityState::ARMING &&
+        connectability_state_ != ConnectabilityState::ARMED) {
+      return false;
+    }
+    return !disarmed_while_arming_ && connecting_le_ == accept_list &&
+           armed_scan_phase_ == wanted_scan_phase();
+  }
+
   void disarm_connectability() {
 
     switch (connectability_state_) {
@@ -995,7 +1067,14 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     switch (connectability_state_) {
       case ConnectabilityState::ARMED:
       case ConnectabilityState::ARMING:
-        if (already_in_accept_list) {
+        if (armed_for_accept_list()) {
+          rearms_avoided_++;
+          log::info(
+              "Already connecting to {} with the {} scan parameters, {} re-arms avoided so far",
+              address_with_type,
+              connection_scan_phase_text(armed_scan_phase_),
+              rearms_avoided_);
+        } else if (already_in_accept_list) {
           arm_on_disarm_ = true;
           disarm_connectability();
         } else {
@@ -1024,7 +1103,16 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     direct_connect_remove(address_with_type);
 
     if (background_connections_.find(address_with_type) != background_connections_.end()) {
-      disarm_connectability();
+      // Other direct connections still pending keep the fast scan parameters
+      if (armed_for_accept_list()) {
+        rearms_avoided_++;
+        log::info(
+            "Keeping {} in the {} create connection",
+            address_with_type,
+            connection_scan_phase_text(armed_scan_phase_));
+      } else {
+        disarm_connectability();
+      }
     } else {
       remove_device_from_accept_list(address_with_type);
     }
@@ -1239,8 +1327,13 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   std::unordered_set<AddressWithType> direct_connections_{};
   // Set of devices that will not be removed from accept list after direct connect timeout
   std::unordered_set<AddressWithType> background_connections_;
-  /* This is content of controller "Filter Accept List"*/
+  /* This is the requested content of controller "Filter Accept List"*/
   std::unordered_set<AddressWithType> accept_list;
+  /* This is what was last sent to the controller, |accept_list| is diffed against it */
+  std::unordered_set<AddressWithType> controller_accept_list_;
+  bool accept_list_update_scheduled_ = false;
+  uint64_t accept_list_changes_requested_ = 0;
+  uint64_t accept_list_commands_sent_ = 0;
   AddressWithType connection_peer_address_with_type_;  // Direct peer address UNSUPPORTEDD
   bool address_manager_registered = false;
   bool ready_to_unregister = false;
@@ -1248,6 +1341,8 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   bool disarmed_while_arming_ = false;
   bool system_suspend_ = false;
   ConnectabilityState connectability_state_{ConnectabilityState::DISARMED};
+  ConnectionScanPhase armed_scan_phase_{ConnectionScanPhase::SLOW};
+  uint64_t rearms_avoided_ = 0;
   std::map<AddressWithType, os::Alarm> create_connection_timeout_alarms_{};
 };
 
@@ -499,6 +499,31 @@ TEST_F(LeImplTest, remove_device_from_accept_list) {
   ASSERT_EQ(0UL, le_impl_->accept_list.size());
 }
 
+TEST_F(LeImplTest, accept_list_changes_are_batched) {
+  le_impl_->add_device_to_accept_list({{0x01, 0x02, 0x03, 0x04, 0x05, 0x06}, AddressType::PUBLIC_DEVICE_ADDRESS});
+  le_impl_->add_device_to_accept_list({{0x11, 0x12, 0x13, 0x14, 0x15, 0x16}, AddressType::PUBLIC_DEVICE_ADDRESS});
+  le_impl_->add_device_to_accept_list({{0x21, 0x22, 0x23, 0x24, 0x25, 0x26}, AddressType::PUBLIC_DEVICE_ADDRESS});
+  le_impl_->remove_device_from_accept_list({{0x11, 0x12, 0x13, 0x14, 0x15, 0x16}, AddressType::PUBLIC_DEVICE_ADDRESS});
+  ASSERT_TRUE(le_impl_->accept_list_update_scheduled_);
+  ASSERT_EQ(0UL, le_impl_->controller_accept_list_.size());
+
+  sync_handler();
+
+  // Only the two devices left in the accept list are sent to the controller
+  ASSERT_FALSE(le_impl_->accept_list_update_scheduled_);
+  ASSERT_EQ(2UL, le_impl_->controller_accept_list_.size());
+  ASSERT_EQ(4UL, le_impl_->accept_list_changes_requested_);
+  ASSERT_EQ(2UL, le_impl_->accept_list_commands_sent_);
+
+  // Removing and re-adding a device before the update runs sends nothing
+  le_impl_->remove_device_from_accept_list({{0x01, 0x02, 0x03, 0x04, 0x05, 0x06}, AddressType::PUBLIC_DEVICE_ADDRESS});
+  le_impl_->add_device_to_accept_list({{0x01, 0x02, 0x03, 0x04, 0x05, 0x06}, AddressType::PUBLIC_DEVICE_ADDRESS});
+  sync_handler();
+  ASSERT_EQ(2UL, le_impl_->controller_accept_list_.size());
+  ASSERT_EQ(6UL, le_impl_->accept_list_changes_requested_);
+  ASSERT_EQ(2UL, le_impl_->accept_list_commands_sent_);
+}
+
 TEST_F(LeImplTest, connection_complete_with_periperal_role) {
   set_random_device_address_policy();
 
@@ -992,6 +1017,88 @@ TEST_F(LeImplTest, add_device_to_resolving_list__SupportsBlePrivacy) {
   ASSERT_FALSE(le_impl_->pause_connection);
 }
 
+TEST_F(LeImplTest, resolving_list_changes_share_one_address_resolution_pause) {
+  controller_->supports_ble_privacy_ = true;
+
+  // Some kind of privacy policy must be set for LeAddressManager to operate properly
+  set_privacy_policy_for_initiator_address(fixed_address_, LeAddressManager::AddressPolicy::USE_PUBLIC_ADDRESS);
+  // Let LeAddressManager::resume_registered_clients execute
+  sync_handler();
+
+  hci_layer_->AssertNoQueuedCommand();
+
+  ASSERT_EQ(0UL, le_impl_->le_address_manager_->NumberCachedCommands());
+  le_impl_->add_device_to_resolving_list(
+      remote_public_address_with_type_, kPeerIdentityResolvingKey, kLocalIdentityResolvingKey);
+  ASSERT_EQ(4UL, le_impl_->le_address_manager_->NumberCachedCommands());
+  // Address resolution is not enabled in between: only the removal is added
+  le_impl_->remove_device_from_resolving_list(remote_public_address_with_type_);
+  ASSERT_EQ(5UL, le_impl_->le_address_manager_->NumberCachedCommands());
+
+  sync_handler();  // Let |LeAddressManager::register_client| execute on handler
+  ASSERT_TRUE(le_impl_->address_manager_registered);
+
+  le_impl_->le_address_manager_->AckPause(le_impl_);
+  sync_handler();  // Allow |LeAddressManager::ack_pause| to complete
+
+  {
+    auto command =
+        CreateLeSecurityCommandView<LeSetAddressResolutionEnableView>(hci_layer_->GetCommand());
+    ASSERT_TRUE(command.IsValid());
+    ASSERT_EQ(Enable::DISABLED, command.GetAddressResolutionEnable());
+    le_impl_->le_address_manager_->OnCommandComplete(
+        ReturnCommandComplete(OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE, ErrorCode::SUCCESS));
+  }
+  sync_handler();  // |LeAddressManager::check_cached_commands|
+
+  {
+    auto command =
+        CreateLeSecurityCommandView<LeAddDeviceToResolvingListView>(hci_layer_->GetCommand());
+    ASSERT_TRUE(command.IsValid());
+    le_impl_->le_address_manager_->OnCommandComplete(
+        ReturnCommandComplete(OpCode::LE_ADD_DEVICE_TO_RESOLVING_LIST, ErrorCode::SUCCESS));
+  }
+  sync_handler();  // |LeAddressManager::check_cached_commands|
+
+  {
+    auto command = CreateLeSecurityCommandView<LeSetPrivacyModeView>(hci_layer_->GetCommand());
+    ASSERT_TRUE(command.IsValid());
+    le_impl_->le_address_manager_->OnCommandComplete(
+        ReturnCommandComplete(OpCode::LE_SET_PRIVACY_MODE, ErrorCode::SUCCESS));
+  }
+  sync_handler();  // |LeAddressManager::check_cached_commands|
+
+  {
+    auto command =
+        CreateLeSecurityCommandView<LeRemoveDeviceFromResolvingListView>(hci_layer_->GetCommand());
+    ASSERT_TRUE(command.IsValid());
+    ASSERT_EQ(remote_public_address_with_type_.GetAddress(), command.GetPeerIdentityAddress());
+    le_impl_->le_address_manager_->OnCommandComplete(
+        ReturnCommandComplete(OpCode::LE_REMOVE_DEVICE_FROM_RESOLVING_LIST, ErrorCode::SUCCESS));
+  }
+  sync_handler();  // |LeAddressManager::check_cached_commands|
+
+  {
+    auto command =
+        CreateLeSecurityCommandView<LeSetAddressResolutionEnableView>(hci_layer_->GetCommand());
+    ASSERT_TRUE(command.IsValid());
+    ASSERT_EQ(Enable::ENABLED, command.GetAddressResolutionEnable());
+    le_impl_->le_address_manager_->OnCommandComplete(
+        ReturnCommandComplete(OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE, ErrorCode::SUCCESS));
+  }
+  sync_handler();  // |LeAddressManager::check_cached_commands|
+
+  hci_layer_->AssertNoQueuedCommand();
+  ASSERT_EQ(0UL, le_impl_->le_address_manager_->NumberCachedCommands());
+
+  le_impl_->ready_to_unregister = true;
+
+  le_impl_->check_for_unregister();
+  sync_handler();
+  ASSERT_FALSE(le_impl_->address_manager_registered);
+  ASSERT_FALSE(le_impl_->pause_connection);
+}
+
 TEST_F(LeImplTest, connectability_state_machine_text) {
   ASSERT_STREQ(
       "ConnectabilityState::DISARMED", connectability_state_machine_text(ConnectabilityState::DISARMED).c_str());
@@ -1607,6 +1714,33 @@ TEST_F(LeImplTest, direct_connection_after_background_connection) {
   ASSERT_NE(direct_create_connection.GetLeScanInterval(), bg_create_connection.GetLeScanInterval());
 }
 
+TEST_F(LeImplTest, direct_connection_again_does_not_rearm) {
+  set_random_device_address_policy();
+
+  hci::AddressWithType address(
+      {0x21, 0x22, 0x23, 0x24, 0x25, 0x26}, AddressType::PUBLIC_DEVICE_ADDRESS);
+
+  // arrange: Create direct connection
+  le_impl_->create_le_connection(address, true, /* is_direct */ true);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  hci_layer_->IncomingEvent(
+      LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  hci_layer_->GetCommand(OpCode::LE_CREATE_CONNECTION);
+  hci_layer_->IncomingEvent(LeCreateConnectionStatusBuilder::Create(ErrorCode::SUCCESS, 0x01));
+  sync_handler();
+  ASSERT_EQ(ConnectabilityState::ARMED, le_impl_->connectability_state_);
+  ASSERT_EQ(ConnectionScanPhase::FAST, le_impl_->armed_scan_phase_);
+
+  // act: Another client connects to the same device
+  le_impl_->create_le_connection(address, true, /* is_direct */ true);
+  sync_handler();
+
+  // assert: The create connection in progress is kept
+  hci_layer_->AssertNoQueuedCommand();
+  ASSERT_EQ(ConnectabilityState::ARMED, le_impl_->connectability_state_);
+  ASSERT_EQ(1u, le_impl_->rearms_avoided_);
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
@@ -18,6 +18,9 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
+#include "common/latency_trace.h"
 #include "hci/acl_manager/acl_fragmenter.h"
 namespace bluetooth {
 namespace hci {
@@ -91,12 +94,21 @@ uint16_t RoundRobinScheduler::GetLeCredits() {
   return le_acl_packet_credits_;
 }
 
+std::optional<RoundRobinScheduler::QueueingDelayStats> RoundRobinScheduler::GetQueueingDelayStats(uint16_t handle) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    return std::nullopt;
+  }
+  return acl_queue_handler->second.queueing_delay_stats_;
+}
+
 void RoundRobinScheduler::start_round_robin() {
   if (acl_packet_credits_ == 0 && le_acl_packet_credits_ == 0) {
     return;
   }
   if (!fragments_to_send_.empty()) {
-    auto connection_type = fragments_to_send_.front().first;
+    register_high_priority_connections();
+    auto connection_type = fragments_to_send_.front().connection_type_;
     bool classic_buffer_full = acl_packet_credits_ == 0 && connection_type == ConnectionType::CLASSIC;
     bool le_buffer_full = le_acl_packet_credits_ == 0 && connection_type == ConnectionType::LE;
     if (classic_buffer_full || le_buffer_full) {
@@ -156,27 +168,45 @@ void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
                                                 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE
                                                 : PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE;
 
-  int acl_priority = acl_queue_handler->second.high_priority_ ? 1 : 0;
+  bool high_priority = acl_queue_handler->second.high_priority_;
+  int acl_priority = high_priority ? 1 : 0;
+  auto enqueue_time = std::chrono::steady_clock::now();
+  size_t number_of_fragments = 0;
   if (packet->size() <= mtu) {
     fragments_to_send_.push(
-        std::make_pair(
-            connection_type, AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))),
+        fragment{
+            connection_type, handle, high_priority, enqueue_time,
+            AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))},
         acl_priority);
+    number_of_fragments = 1;
   } else {
-    auto fragments = AclFragmenter(mtu, std::move(packet)).GetFragments();
+    auto fragments = AclFragmenter(mtu, std::move(packet)).GetFragmentSlices();
     for (size_t i = 0; i < fragments.size(); i++) {
       fragments_to_send_.push(
-          std::make_pair(
-              connection_type,
-              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))),
+          fragment{
+              connection_type, handle, high_priority, enqueue_time,
+              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))},
           acl_priority);
       packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
     }
+    number_of_fragments = fragments.size();
   }
   log::assert_that(fragments_to_send_.size() > 0, "assert failed: fragments_to_send_.size() > 0");
-  unregister_all_connections();
+  if (high_priority) {
+    high_priority_fragments_to_send_ += number_of_fragments;
+  }
+
+  // High priority links stay registered while only lower priority fragments are pending, so an A2DP
+  // packet can overtake the remaining fragments of a large SDU instead of waiting for all of them.
+  // Fragments of different handles may be interleaved on the HCI transport.
+  if (high_priority_fragments_to_send_ == 0) {
+    unregister_low_priority_connections();
+    register_high_priority_connections();
+  } else {
+    unregister_all_connections();
+  }
 
-  acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
+  acl_queue_handler->second.number_of_sent_packets_ += number_of_fragments;
   send_next_fragment();
 }
 
@@ -190,6 +220,35 @@ void RoundRobinScheduler::unregister_all_connections() {
   }
 }
 
+void RoundRobinScheduler::unregister_low_priority_connections() {
+  for (auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    if (acl_queue_handler.dequeue_is_registered_ && !acl_queue_handler.high_priority_) {
+      acl_queue_handler.dequeue_is_registered_ = false;
+      acl_queue_handler.queue_->GetDownEnd()->UnregisterDequeue();
+    }
+  }
+}
+
+void RoundRobinScheduler::register_high_priority_connections() {
+  if (high_priority_fragments_to_send_ > 0) {
+    return;
+  }
+  for (auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    if (!acl_queue_handler.high_priority_ || acl_queue_handler.dequeue_is_registered_) {
+      continue;
+    }
+    // A fragment without credits at the front of the queue would also block every fragment behind it
+    bool classic_buffer_full = acl_packet_credits_ == 0 && acl_queue_handler.connection_type_ == ConnectionType::CLASSIC;
+    bool le_buffer_full = le_acl_packet_credits_ == 0 && acl_queue_handler.connection_type_ == ConnectionType::LE;
+    if (classic_buffer_full || le_buffer_full) {
+      continue;
+    }
+    acl_queue_handler.dequeue_is_registered_ = true;
+    acl_queue_handler.queue_->GetDownEnd()->RegisterDequeue(
+        handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), handle));
+  }
+}
+
 void RoundRobinScheduler::send_next_fragment() {
   if (!enqueue_registered_.exchange(true)) {
     hci_queue_end_->RegisterEnqueue(
@@ -199,7 +258,8 @@ void RoundRobinScheduler::send_next_fragment() {
 
 // Invoked from some external Queue Reactable context 1
 std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment() {
-  ConnectionType connection_type = fragments_to_send_.front().first;
+  auto& next_fragment = fragments_to_send_.front();
+  ConnectionType connection_type = next_fragment.connection_type_;
   if (connection_type == ConnectionType::CLASSIC) {
     log::assert_that(acl_packet_credits_ > 0, "assert failed: acl_packet_credits_ > 0");
     acl_packet_credits_ -= 1;
@@ -208,7 +268,19 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     le_acl_packet_credits_ -= 1;
   }
 
-  auto raw_pointer = fragments_to_send_.front().second.release();
+  BT_TRACE_LATENCY(ACL_SCHEDULER_TX, next_fragment.handle_, next_fragment.packet_->size());
+  auto acl_queue_handler = acl_queue_handlers_.find(next_fragment.handle_);
+  if (acl_queue_handler != acl_queue_handlers_.end()) {
+    auto delay = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - next_fragment.enqueue_time_);
+    auto& stats = acl_queue_handler->second.queueing_delay_stats_;
+    stats.fragments_sent++;
+    stats.total_delay += delay;
+    stats.max_delay = std::max(stats.max_delay, delay);
+  }
+  bool resume_high_priority = next_fragment.high_priority_ && --high_priority_fragments_to_send_ == 0;
+
+  auto raw_pointer = next_fragment.packet_.release();
   fragments_to_send_.pop();
   if (fragments_to_send_.empty()) {
     if (enqueue_registered_.exchange(false)) {
@@ -216,7 +288,11 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     }
     handler_->Post(common::BindOnce(&RoundRobinScheduler::start_round_robin, common::Unretained(this)));
   } else {
-    ConnectionType next_connection_type = fragments_to_send_.front().first;
+    if (resume_high_priority) {
+      handler_->Post(
+          common::BindOnce(&RoundRobinScheduler::register_high_priority_connections, common::Unretained(this)));
+    }
+    ConnectionType next_connection_type = fragments_to_send_.front().connection_type_;
     bool classic_buffer_full = next_connection_type == ConnectionType::CLASSIC && acl_packet_credits_ == 0;
     bool le_buffer_full = next_connection_type == ConnectionType::LE && le_acl_packet_credits_ == 0;
     if ((classic_buffer_full || le_buffer_full) && enqueue_registered_.exchange(false)) {
@@ -19,6 +19,9 @@
 #include <bluetooth/log.h>
 #include <stdint.h>
 
+#include <chrono>
+#include <optional>
+
 #include "common/bidi_queue.h"
 #include "common/multi_priority_queue.h"
 #include "hci/acl_manager/acl_connection.h"
@@ -38,12 +41,21 @@ class RoundRobinScheduler {
 
   enum ConnectionType { CLASSIC, LE };
 
+  // Time fragments of a connection spent in the scheduler, from leaving the connection queue until
+  // they were handed to the HCI layer.
+  struct QueueingDelayStats {
+    uint64_t fragments_sent = 0;
+    std::chrono::microseconds total_delay{0};
+    std::chrono::microseconds max_delay{0};
+  };
+
   struct acl_queue_handler {
     ConnectionType connection_type_;
     std::shared_ptr<acl_manager::AclConnection::Queue> queue_;
     bool dequeue_is_registered_ = false;
     uint16_t number_of_sent_packets_ = 0;  // Track credits
     bool high_priority_ = false;           // For A2dp use
+    QueueingDelayStats queueing_delay_stats_;
   };
 
   void Register(ConnectionType connection_type, uint16_t handle,
@@ -52,11 +64,22 @@ class RoundRobinScheduler {
   void SetLinkPriority(uint16_t handle, bool high_priority);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
+  std::optional<QueueingDelayStats> GetQueueingDelayStats(uint16_t handle);
 
  private:
+  struct fragment {
+    ConnectionType connection_type_;
+    uint16_t handle_;
+    bool high_priority_;
+    std::chrono::steady_clock::time_point enqueue_time_;
+    std::unique_ptr<AclBuilder> packet_;
+  };
+
   void start_round_robin();
   void buffer_packet(uint16_t acl_handle);
   void unregister_all_connections();
+  void unregister_low_priority_connections();
+  void register_high_priority_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
   void incoming_acl_credits(uint16_t handle, uint16_t credits);
@@ -64,7 +87,8 @@ class RoundRobinScheduler {
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
-  common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
+  common::MultiPriorityQueue<fragment, 2> fragments_to_send_;
+  size_t high_priority_fragments_to_send_ = 0;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
   uint16_t le_max_acl_packet_credits_ = 0;
@@ -413,6 +413,57 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, high_priority_packet_overtakes_pending_fragments) {
+  uint16_t handle = 0x01;
+  uint16_t le_handle = 0x02;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto le_connection_queue = std::make_shared<AclConnection::Queue>(10);
+
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, le_handle, le_connection_queue);
+  round_robin_scheduler_->SetLinkPriority(handle, true);
+
+  // Two more fragments than LE credits, so the tail of the SDU waits for completed packets
+  uint16_t number_of_le_fragments = controller_->le_max_acl_packet_credits_ + 2;
+  std::vector<uint8_t> le_packet(number_of_le_fragments * controller_->le_hci_mtu_, 0x04);
+  std::vector<uint8_t> le_fragment(controller_->le_hci_mtu_, 0x04);
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->le_max_acl_packet_credits_));
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), le_packet);
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), 0);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(1));
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+  packet_future_->wait();
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(2));
+  controller_->SendCompletedAclPacketsCallback(le_handle, 2);
+  packet_future_->wait();
+
+  for (uint16_t i = 0; i < controller_->le_max_acl_packet_credits_; i++) {
+    VerifyPacket(le_handle, le_fragment);
+  }
+  VerifyPacket(handle, packet);
+  VerifyPacket(le_handle, le_fragment);
+  VerifyPacket(le_handle, le_fragment);
+
+  sync_handler();
+  auto stats = round_robin_scheduler_->GetQueueingDelayStats(le_handle);
+  ASSERT_TRUE(stats.has_value());
+  ASSERT_EQ(stats->fragments_sent, number_of_le_fragments);
+  ASSERT_LE(stats->max_delay, stats->total_delay);
+  stats = round_robin_scheduler_->GetQueueingDelayStats(handle);
+  ASSERT_TRUE(stats.has_value());
+  ASSERT_EQ(stats->fragments_sent, 1u);
+  ASSERT_FALSE(round_robin_scheduler_->GetQueueingDelayStats(0x03).has_value());
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(le_handle);
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
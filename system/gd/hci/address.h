@@ -124,7 +124,11 @@ struct hash<bluetooth::hci::Address> {
     static_assert(sizeof(uint64_t) >= bluetooth::hci::Address::kLength);
     uint64_t int_addr = 0;
     memcpy(reinterpret_cast<uint8_t*>(&int_addr), val.data(), bluetooth::hci::Address::kLength);
-    return std::hash<uint64_t>{}(int_addr);
+    // Same mix as std::hash<RawAddress>, the identity std::hash<uint64_t> leaves most of the address out of the
+    // low bits
+    int_addr = (int_addr ^ (int_addr >> 30)) * 0xbf58476d1ce4e5b9ull;
+    int_addr = (int_addr ^ (int_addr >> 27)) * 0x94d049bb133111ebull;
+    return static_cast<std::size_t>(int_addr ^ (int_addr >> 31));
   }
 };
 }  // namespace std
@@ -83,24 +83,9 @@ struct Controller::impl {
                                              std::move(features_promise)));
     features_future.wait();
 
-    if (com::android::bluetooth::flags::channel_sounding_in_stack() &&
-        module_.SupportsBleChannelSounding()) {
-      le_set_event_mask(MaskLeEventMask(
-          local_version_information_.hci_version_, kDefaultLeEventMask | kLeCSEventMask));
-    } else {
-      le_set_event_mask(
-          MaskLeEventMask(local_version_information_.hci_version_, kDefaultLeEventMask));
-    }
-
     hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(),
                          handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
 
-    if (common::init_flags::set_min_encryption_is_enabled() && is_supported(OpCode::SET_MIN_ENCRYPTION_KEY_SIZE)) {
-      hci_->EnqueueCommand(
-          SetMinEncryptionKeySizeBuilder::Create(kMinEncryptionKeySize),
-          handler->BindOnceOn(this, &Controller::impl::set_min_encryption_key_size_handler));
-    }
-
     if (is_supported(OpCode::LE_READ_BUFFER_SIZE_V2)) {
       hci_->EnqueueCommand(
           LeReadBufferSizeV2Builder::Create(),
@@ -141,14 +126,6 @@ struct Controller::impl {
       le_maximum_data_length_.supported_max_tx_time_ = 0;
     }
 
-    // SSP is managed by security layer once enabled
-    write_simple_pairing_mode(Enable::ENABLED);
-    if (module_.SupportsSecureConnections()) {
-      hci_->EnqueueCommand(
-          WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
-          handler->BindOnceOn(
-              this, &Controller::impl::write_secure_connections_host_support_complete_handler));
-    }
     if (is_supported(OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
       hci_->EnqueueCommand(
           LeReadSuggestedDefaultDataLengthBuilder::Create(),
@@ -186,6 +163,33 @@ struct Controller::impl {
       log::info("LE_READ_PERIODIC_ADVERTISER_LIST_SIZE not supported, defaulting to 0");
       le_periodic_advertiser_list_size_ = 0;
     }
+
+    // The reads above are independent of each other and, with HCI command pipelining, are all
+    // outstanding at once. Writes are only sent when nothing is outstanding, so keep them after.
+    if (com::android::bluetooth::flags::channel_sounding_in_stack() &&
+        module_.SupportsBleChannelSounding()) {
+      le_set_event_mask(MaskLeEventMask(
+          local_version_information_.hci_version_, kDefaultLeEventMask | kLeCSEventMask));
+    } else {
+      le_set_event_mask(
+          MaskLeEventMask(local_version_information_.hci_version_, kDefaultLeEventMask));
+    }
+
+    if (common::init_flags::set_min_encryption_is_enabled() && is_supported(OpCode::SET_MIN_ENCRYPTION_KEY_SIZE)) {
+      hci_->EnqueueCommand(
+          SetMinEncryptionKeySizeBuilder::Create(kMinEncryptionKeySize),
+          handler->BindOnceOn(this, &Controller::impl::set_min_encryption_key_size_handler));
+    }
+
+    // SSP is managed by security layer once enabled
+    write_simple_pairing_mode(Enable::ENABLED);
+    if (module_.SupportsSecureConnections()) {
+      hci_->EnqueueCommand(
+          WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
+          handler->BindOnceOn(
+              this, &Controller::impl::write_secure_connections_host_support_complete_handler));
+    }
+
     if (is_supported(OpCode::LE_SET_HOST_FEATURE) && module_.SupportsBleConnectedIsochronousStreamCentral()) {
       hci_->EnqueueCommand(
           LeSetHostFeatureBuilder::Create(LeHostFeatureBits::CONNECTED_ISO_STREAM_HOST_SUPPORT, Enable::ENABLED),
@@ -19,7 +19,10 @@
 #include <com_android_bluetooth_flags.h>
 #include <math.h>
 
+#include <algorithm>
+#include <chrono>
 #include <complex>
+#include <iterator>
 #include <unordered_map>
 
 #include "acl_manager/assembler.h"
@@ -27,12 +30,13 @@
 #include "hal/ranging_hal.h"
 #include "hci/acl_manager.h"
 #include "hci/distance_measurement_interface.h"
+#include "hci/distance_measurement_scheduler.h"
 #include "hci/event_checkers.h"
 #include "hci/hci_layer.h"
 #include "module.h"
 #include "os/handler.h"
+#include "os/alarm.h"
 #include "os/log.h"
-#include "os/repeating_alarm.h"
 #include "packet/packet_view.h"
 #include "ras/ras_packets.h"
 
@@ -68,6 +72,16 @@ static constexpr uint8_t kTxPwrDelta = 0x00;
 static constexpr uint8_t kProcedureDataBufferSize = 0x10;  // Buffer size of Procedure data
 static constexpr uint16_t kMtuForRasData = 507;            // 512 - 5
 static constexpr uint16_t kRangingCounterMask = 0x0FFF;
+// How often the achieved measurement rate of each peer is logged
+static constexpr std::chrono::seconds kRateReportInterval{30};
+// Offset of the result data structures in the LE CS Subevent Result and LE CS Subevent Result
+// Continue events, after the event header, the subevent code and the fixed size fields
+static constexpr size_t kCsSubeventResultStepsOffset = 18;
+static constexpr size_t kCsSubeventResultContinueStepsOffset = 11;
+// Step mode, step channel and step data length of each result data structure
+static constexpr size_t kCsStepHeaderSize = 3;
+// I and Q samples of 12 bits each and the tone quality indicator of each tone of a mode-2 step
+static constexpr size_t kCsToneDataSize = 4;
 
 struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   struct CsProcedureData {
@@ -75,19 +89,41 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         uint16_t procedure_counter,
         uint8_t num_antenna_paths,
         uint8_t configuration_id,
-        uint8_t selected_tx_power)
-        : counter(procedure_counter), num_antenna_paths(num_antenna_paths) {
+        uint8_t selected_tx_power) {
+      Reset(procedure_counter, num_antenna_paths, configuration_id, selected_tx_power);
+    }
+
+    // Start over for a new procedure. The buffers keep their capacity, so that the procedures of
+    // a tracker reuse them instead of allocating their own.
+    void Reset(
+        uint16_t procedure_counter,
+        uint8_t num_antenna_paths,
+        uint8_t configuration_id,
+        uint8_t selected_tx_power) {
+      counter = procedure_counter;
+      this->num_antenna_paths = num_antenna_paths;
+      frequency_compensation.clear();
+      measured_freq_offset.clear();
       local_status = CsProcedureDoneStatus::PARTIAL_RESULTS;
       remote_status = CsProcedureDoneStatus::PARTIAL_RESULTS;
+      aborted = false;
+      raw_data.num_antenna_paths_ = num_antenna_paths;
+      raw_data.step_channel_.clear();
       // In ascending order of antenna position with tone extension data at the end
       uint16_t num_tone_data = num_antenna_paths + 1;
-      for (uint8_t i = 0; i < num_tone_data; i++) {
-        std::vector<std::complex<double>> empty_complex_vector;
-        tone_pct_initiator.push_back(empty_complex_vector);
-        tone_pct_reflector.push_back(empty_complex_vector);
-        std::vector<uint8_t> empty_vector;
-        tone_quality_indicator_initiator.push_back(empty_vector);
-        tone_quality_indicator_reflector.push_back(empty_vector);
+      for (auto* tone_pct : {&raw_data.tone_pct_initiator_, &raw_data.tone_pct_reflector_}) {
+        tone_pct->resize(num_tone_data);
+        for (auto& tones : *tone_pct) {
+          tones.clear();
+        }
+      }
+      for (auto* tone_quality_indicator :
+           {&raw_data.tone_quality_indicator_initiator_,
+            &raw_data.tone_quality_indicator_reflector_}) {
+        tone_quality_indicator->resize(num_tone_data);
+        for (auto& indicators : *tone_quality_indicator) {
+          indicators.clear();
+        }
       }
       // RAS data
       segmentation_header_.first_segment_ = 1;
@@ -101,6 +137,11 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         ranging_header_.antenna_paths_mask_ |= (1 << i);
       }
       ranging_header_.pct_format_ = PctFormat::IQ;
+      ras_raw_data_.clear();
+      ras_raw_data_index_ = 0;
+      ras_subevent_header_ = RasSubeventHeader();
+      ras_subevent_data_.clear();
+      ras_subevent_counter_ = 0;
     }
     // Procedure counter
     uint16_t counter;
@@ -109,18 +150,14 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     // Frequency Compensation indicates fractional frequency offset (FFO) value of initiator, in
     // 0.01ppm
     std::vector<uint16_t> frequency_compensation;
-    // The channel indices of every step in a CS procedure (in time order)
-    std::vector<uint8_t> step_channel;
     // Measured Frequency Offset from mode 0, relative to the remote device, in 0.01ppm
     std::vector<uint16_t> measured_freq_offset;
-    // Initiator's PCT (complex value) measured from mode-2 or mode-3 steps in a CS procedure (in
-    // time order)
-    std::vector<std::vector<std::complex<double>>> tone_pct_initiator;
-    // Reflector's PCT (complex value) measured from mode-2 or mode-3 steps in a CS procedure (in
-    // time order)
-    std::vector<std::vector<std::complex<double>>> tone_pct_reflector;
-    std::vector<std::vector<uint8_t>> tone_quality_indicator_initiator;
-    std::vector<std::vector<uint8_t>> tone_quality_indicator_reflector;
+    // Decoded straight into the layout of the ranging HAL, which takes it without a copy:
+    // - step_channel_: the channel indices of every step in a CS procedure (in time order)
+    // - tone_pct_initiator_, tone_pct_reflector_: the PCT (complex value) of each side, measured
+    //   from mode-2 or mode-3 steps in a CS procedure (in time order), per antenna path
+    // - tone_quality_indicator_initiator_, tone_quality_indicator_reflector_: their quality
+    hal::ChannelSoundingRawData raw_data;
     CsProcedureDoneStatus local_status;
     CsProcedureDoneStatus remote_status;
     // If the procedure is aborted by either the local or remote side.
@@ -208,6 +245,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     ranging_hal_ = ranging_hal;
     hci_layer_ = hci_layer;
     acl_manager_ = acl_manager;
+    scheduler_alarm_ = std::make_unique<os::Alarm>(handler_);
     hci_layer_->RegisterLeEventHandler(
         hci::SubeventCode::TRANSMIT_POWER_REPORTING,
         handler_->BindOn(this, &impl::on_transmit_power_reporting));
@@ -227,6 +265,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
 
   void stop() {
     hci_layer_->UnregisterLeEventHandler(hci::SubeventCode::TRANSMIT_POWER_REPORTING);
+    scheduler_alarm_->Cancel();
+    scheduler_alarm_.reset();
   }
 
   void register_distance_measurement_callbacks(DistanceMeasurementCallbacks* callbacks) {
@@ -258,7 +298,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
           rssi_trackers[address].interval_ms = interval;
           rssi_trackers[address].remote_tx_power = kTxPowerNotAvailable;
           rssi_trackers[address].started = false;
-          rssi_trackers[address].repeating_alarm = std::make_unique<os::RepeatingAlarm>(handler_);
           hci_layer_->EnqueueCommand(
               LeReadRemoteTransmitPowerLevelBuilder::Create(
                   acl_manager_->HACK_GetLeHandle(address), 0x01),
@@ -266,6 +305,9 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
                   this, &impl::on_read_remote_transmit_power_level_status, address));
         } else {
           rssi_trackers[address].interval_ms = interval;
+          if (rssi_trackers[address].started) {
+            schedule_measurement(address, DistanceMeasurementScheduler::Kind::RSSI, interval);
+          }
         }
       } break;
       case METHOD_CS: {
@@ -287,6 +329,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     if (cs_trackers_.find(connection_handle) != cs_trackers_.end() &&
         cs_trackers_[connection_handle].address != cs_remote_address) {
       log::warn("Remove old tracker for {}", cs_remote_address);
+      unschedule_measurement(
+          cs_trackers_[connection_handle].address, DistanceMeasurementScheduler::Kind::CS);
       cs_trackers_.erase(connection_handle);
     }
 
@@ -295,8 +339,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       cs_trackers_[connection_handle].address = cs_remote_address;
       // TODO: Check ROLE via CS config. (b/304295768)
       cs_trackers_[connection_handle].role = CsRole::INITIATOR;
-      cs_trackers_[connection_handle].repeating_alarm =
-          std::make_unique<os::RepeatingAlarm>(handler_);
     }
     cs_trackers_[connection_handle].interval_ms = interval;
     cs_trackers_[connection_handle].waiting_for_start_callback = true;
@@ -317,15 +359,10 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     log::info(
         "enable cs procedure regularly with interval: {} ms",
         cs_trackers_[connection_handle].interval_ms);
-    cs_trackers_[connection_handle].repeating_alarm->Cancel();
-    send_le_cs_procedure_enable(connection_handle, Enable::ENABLED);
-    cs_trackers_[connection_handle].repeating_alarm->Schedule(
-        common::Bind(
-            &impl::send_le_cs_procedure_enable,
-            common::Unretained(this),
-            connection_handle,
-            Enable::ENABLED),
-        std::chrono::milliseconds(cs_trackers_[connection_handle].interval_ms));
+    schedule_measurement(
+        cs_remote_address,
+        DistanceMeasurementScheduler::Kind::CS,
+        cs_trackers_[connection_handle].interval_ms);
   }
 
   void stop_distance_measurement(const Address& address, DistanceMeasurementMethod method) {
@@ -340,8 +377,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
               LeSetTransmitPowerReportingEnableBuilder::Create(
                   rssi_trackers[address].handle, 0x00, 0x00),
               handler_->BindOnce(check_complete<LeSetTransmitPowerReportingEnableCompleteView>));
-          rssi_trackers[address].repeating_alarm->Cancel();
-          rssi_trackers[address].repeating_alarm.reset();
+          unschedule_measurement(address, DistanceMeasurementScheduler::Kind::RSSI);
           rssi_trackers.erase(address);
         }
       } break;
@@ -350,8 +386,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         if (cs_trackers_.find(connection_handle) == cs_trackers_.end()) {
           log::warn("Can't find CS tracker for {}", address);
         } else {
-          cs_trackers_[connection_handle].repeating_alarm->Cancel();
-          cs_trackers_[connection_handle].repeating_alarm.reset();
+          unschedule_measurement(address, DistanceMeasurementScheduler::Kind::CS);
           send_le_cs_procedure_enable(connection_handle, Enable::DISABLED);
           cs_trackers_.erase(connection_handle);
         }
@@ -422,6 +457,79 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     start_distance_measurement_with_cs(tracker.address, connection_handle, tracker.interval_ms);
   }
 
+  // Measure |address| with |kind| every |interval_ms|. RSSI reads start after one interval and CS
+  // procedures as soon as a slot is free.
+  void schedule_measurement(
+      const Address& address, DistanceMeasurementScheduler::Kind kind, uint16_t interval_ms) {
+    auto now = DistanceMeasurementScheduler::Clock::now();
+    std::chrono::milliseconds interval(interval_ms);
+    scheduler_.AddPeer(
+        address,
+        kind,
+        interval,
+        kind == DistanceMeasurementScheduler::Kind::RSSI ? now + interval : now);
+    reschedule_measurements();
+  }
+
+  void unschedule_measurement(const Address& address, DistanceMeasurementScheduler::Kind kind) {
+    scheduler_.RemovePeer(address, kind);
+    reschedule_measurements();
+  }
+
+  void reschedule_measurements() {
+    if (scheduler_alarm_ == nullptr) {
+      return;
+    }
+    scheduler_alarm_->Cancel();
+    auto wakeup = scheduler_.NextWakeup();
+    if (!wakeup.has_value()) {
+      return;
+    }
+    // Round up, the measurement is not due yet if the alarm fires early
+    auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+        *wakeup - DistanceMeasurementScheduler::Clock::now());
+    scheduler_alarm_->Schedule(
+        common::BindOnce(&impl::on_scheduler_alarm, common::Unretained(this)),
+        std::max(delay, std::chrono::milliseconds(0)));
+  }
+
+  void on_scheduler_alarm() {
+    auto now = DistanceMeasurementScheduler::Clock::now();
+    DistanceMeasurementScheduler::Batch batch = scheduler_.Poll(now);
+    // There is no HCI command reading the RSSI of several connections, the reads of a batch are
+    // queued back to back instead
+    for (const auto& address : batch.rssi) {
+      send_read_rssi(address);
+    }
+    for (const auto& address : batch.cs) {
+      send_scheduled_cs_procedure_enable(address);
+    }
+    if (now - last_rate_report_ >= kRateReportInterval) {
+      last_rate_report_ = now;
+      for (const auto& report : scheduler_.GetRateReports()) {
+        log::info(
+            "address:{}, method:{}, requested {:.2f} Hz, achieved {:.2f} Hz over {} measurements",
+            report.address,
+            report.kind == DistanceMeasurementScheduler::Kind::CS ? "CS" : "RSSI",
+            report.requested_hz,
+            report.achieved_hz,
+            report.num_measurements);
+      }
+    }
+    reschedule_measurements();
+  }
+
+  void send_scheduled_cs_procedure_enable(const Address& address) {
+    for (const auto& [connection_handle, tracker] : cs_trackers_) {
+      if (tracker.address == address) {
+        send_le_cs_procedure_enable(connection_handle, Enable::ENABLED);
+        return;
+      }
+    }
+    log::warn("Can't find CS tracker for {}", address);
+    scheduler_.RemovePeer(address, DistanceMeasurementScheduler::Kind::CS);
+  }
+
   void send_read_rssi(const Address& address) {
     if (rssi_trackers.find(address) == rssi_trackers.end()) {
       log::warn("Can't find rssi tracker for {}", address);
@@ -433,8 +541,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       if (rssi_trackers.find(address) != rssi_trackers.end()) {
         distance_measurement_callbacks_->OnDistanceMeasurementStopped(
             address, REASON_NO_LE_CONNECTION, METHOD_RSSI);
-        rssi_trackers[address].repeating_alarm->Cancel();
-        rssi_trackers[address].repeating_alarm.reset();
+        unschedule_measurement(address, DistanceMeasurementScheduler::Kind::RSSI);
         rssi_trackers.erase(address);
       }
       return;
@@ -560,8 +667,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       log::warn("Can't find connection for {}", address);
       distance_measurement_callbacks_->OnDistanceMeasurementStopped(
           address, REASON_NO_LE_CONNECTION, METHOD_CS);
-      cs_trackers_[connection_handle].repeating_alarm->Cancel();
-      cs_trackers_[connection_handle].repeating_alarm.reset();
+      unschedule_measurement(address, DistanceMeasurementScheduler::Kind::CS);
       cs_trackers_.erase(connection_handle);
       return;
     }
@@ -705,15 +811,10 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       log::info(
           "enable cs procedure regularly with interval: {} ms",
           cs_trackers_[connection_handle].interval_ms);
-      cs_trackers_[connection_handle].repeating_alarm->Cancel();
-      send_le_cs_procedure_enable(connection_handle, Enable::ENABLED);
-      cs_trackers_[connection_handle].repeating_alarm->Schedule(
-          common::Bind(
-              &impl::send_le_cs_procedure_enable,
-              common::Unretained(this),
-              connection_handle,
-              Enable::ENABLED),
-          std::chrono::milliseconds(cs_trackers_[connection_handle].interval_ms));
+      schedule_measurement(
+          cs_trackers_[connection_handle].address,
+          DistanceMeasurementScheduler::Kind::CS,
+          cs_trackers_[connection_handle].interval_ms);
     }
   }
 
@@ -761,7 +862,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     CsSubeventDoneStatus subevent_done_status;
     ProcedureAbortReason procedure_abort_reason;
     SubeventAbortReason subevent_abort_reason;
-    std::vector<LeCsResultDataStructure> result_data_structures;
+    // Parsed in place by parse_cs_result_data()
+    size_t steps_offset;
     if (event.GetSubeventCode() == SubeventCode::LE_CS_SUBEVENT_RESULT) {
       auto cs_event_result = LeCsSubeventResultView::Create(event);
       if (!cs_event_result.IsValid()) {
@@ -773,7 +875,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       subevent_done_status = cs_event_result.GetSubeventDoneStatus();
       procedure_abort_reason = cs_event_result.GetProcedureAbortReason();
       subevent_abort_reason = cs_event_result.GetSubeventAbortReason();
-      result_data_structures = cs_event_result.GetResultDataStructures();
+      steps_offset = kCsSubeventResultStepsOffset;
       if (cs_trackers_.find(connection_handle) == cs_trackers_.end()) {
         log::warn("Can't find any tracker for {}", connection_handle);
         return;
@@ -805,7 +907,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       subevent_done_status = cs_event_result.GetSubeventDoneStatus();
       procedure_abort_reason = cs_event_result.GetProcedureAbortReason();
       subevent_abort_reason = cs_event_result.GetSubeventAbortReason();
-      result_data_structures = cs_event_result.GetResultDataStructures();
+      steps_offset = kCsSubeventResultContinueStepsOffset;
       if (cs_trackers_.find(connection_handle) == cs_trackers_.end()) {
         log::warn("Can't find any tracker for {}", connection_handle);
         return;
@@ -835,7 +937,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     if (procedure_data == nullptr) {
       return;
     }
-    procedure_data->ras_subevent_header_.num_steps_reported_ += result_data_structures.size();
 
     if (procedure_abort_reason != ProcedureAbortReason::NO_ABORT ||
         subevent_abort_reason != SubeventAbortReason::NO_ABORT) {
@@ -847,8 +948,10 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       procedure_data->ras_subevent_header_.subevent_abort_reason_ =
           static_cast<bluetooth::ras::SubeventAbortReason>(subevent_abort_reason);
     }
-    parse_cs_result_data(
-        result_data_structures, *procedure_data, cs_trackers_[connection_handle].role);
+    procedure_data->ras_subevent_header_.num_steps_reported_ += parse_cs_result_data(
+        event.GetLittleEndianSubview(steps_offset, event.size()),
+        *procedure_data,
+        cs_trackers_[connection_handle].role);
     // Update procedure status
     procedure_data->local_status = procedure_done_status;
     check_cs_procedure_complete(procedure_data, connection_handle);
@@ -864,10 +967,11 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
           static_cast<RangingDoneStatus>(procedure_done_status);
       procedure_data->ras_subevent_header_.subevent_done_status_ =
           static_cast<SubeventDoneStatus>(subevent_done_status);
-      auto builder = RasSubeventBuilder::Create(
-          procedure_data->ras_subevent_header_, procedure_data->ras_subevent_data_);
-      auto subevent_raw = builder_to_bytes(std::move(builder));
-      append_vector(procedure_data->ras_raw_data_, subevent_raw);
+      // Serialize the RasSubevent straight into the raw data of the procedure
+      BitInserter bi(procedure_data->ras_raw_data_);
+      procedure_data->ras_subevent_header_.Serialize(bi);
+      bi.insert_bytes(
+          procedure_data->ras_subevent_data_.data(), procedure_data->ras_subevent_data_.size());
       // erase buffer
       procedure_data->ras_subevent_data_.clear();
       send_on_demand_data(cs_trackers_[connection_handle].address, procedure_data);
@@ -886,23 +990,22 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       return;
     }
 
-    // Create raw data for segment_data;
+    // Serialize the RangingDataSegment with a single copy of its part of the raw data
     uint16_t copy_size = unsent_data_size < kMtuForRasData ? unsent_data_size : kMtuForRasData;
-    auto copy_start = procedure_data->ras_raw_data_.begin() + procedure_data->ras_raw_data_index_;
-    auto copy_end = copy_start + copy_size;
-    std::vector<uint8_t> subevent_data(copy_start, copy_end);
+    std::vector<uint8_t> segment_data;
+    segment_data.reserve(procedure_data->segmentation_header_.size() + copy_size);
+    BitInserter bi(segment_data);
+    procedure_data->segmentation_header_.Serialize(bi);
+    bi.insert_bytes(
+        procedure_data->ras_raw_data_.data() + procedure_data->ras_raw_data_index_, copy_size);
     procedure_data->ras_raw_data_index_ += copy_size;
 
-    auto builder =
-        RangingDataSegmentBuilder::Create(procedure_data->segmentation_header_, subevent_data);
-    auto segment_data = builder_to_bytes(std::move(builder));
-
     log::debug("counter: {}, size:{}", procedure_data->counter, (uint16_t)segment_data.size());
     distance_measurement_callbacks_->OnRasFragmentReady(
         address,
         procedure_data->counter,
         procedure_data->segmentation_header_.last_segment_,
-        segment_data);
+        std::move(segment_data));
 
     procedure_data->segmentation_header_.first_segment_ = 0;
     procedure_data->segmentation_header_.rolling_segment_counter_++;
@@ -1053,44 +1156,13 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
                   remaining_data_size);
               return;
             }
-            std::vector<uint8_t> vector_for_num_tone_data = {num_tone_data};
-            PacketView<kLittleEndian> packet_view_for_num_tone_data(
-                std::make_shared<std::vector<uint8_t>>(vector_for_num_tone_data));
-            PacketViewForRecombination packet_bytes_view =
-                PacketViewForRecombination(packet_view_for_num_tone_data);
-            auto subview_begin = std::distance(segment_data.begin(), parse_index);
-            packet_bytes_view.AppendPacketView(
-                segment_data.GetLittleEndianSubview(subview_begin, subview_begin + data_len));
-            LeCsMode2Data tone_data;
-            after = LeCsMode2Data::Parse(&tone_data, packet_bytes_view.begin());
-            if (after == packet_bytes_view.begin()) {
+            if (!parse_mode_2_tones(
+                    parse_index.Subrange(0, data_len), num_antenna_paths, *procedure_data, role)) {
               log::warn(
                   "Error invalid mode {} data, role:{}", step_mode.mode_type_, CsRoleText(role));
               return;
             }
             parse_index += data_len;
-            uint8_t permutation_index = tone_data.antenna_permutation_index_;
-
-            // Parse in ascending order of antenna position with tone extension data at the end
-            for (uint8_t k = 0; k < num_tone_data; k++) {
-              uint8_t antenna_path = k == num_antenna_paths
-                                         ? num_antenna_paths
-                                         : cs_antenna_permutation_array_[permutation_index][k] - 1;
-              double i_value = get_iq_value(tone_data.tone_data_[k].i_sample_);
-              double q_value = get_iq_value(tone_data.tone_data_[k].q_sample_);
-              uint8_t tone_quality_indicator = tone_data.tone_data_[k].tone_quality_indicator_;
-              log::verbose(
-                  "antenna_path {}, {:f}, {:f}", (uint16_t)(antenna_path + 1), i_value, q_value);
-              if (role == CsRole::INITIATOR) {
-                procedure_data->tone_pct_initiator[antenna_path].emplace_back(i_value, q_value);
-                procedure_data->tone_quality_indicator_initiator[antenna_path].emplace_back(
-                    tone_quality_indicator);
-              } else {
-                procedure_data->tone_pct_reflector[antenna_path].emplace_back(i_value, q_value);
-                procedure_data->tone_quality_indicator_reflector[antenna_path].emplace_back(
-                    tone_quality_indicator);
-              }
-            }
           } break;
           default:
             log::error("Unexpect mode: {}", step_mode.mode_type_);
@@ -1124,29 +1196,42 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       }
     }
     log::info("Create data for procedure_counter: {}", procedure_counter);
-    data_list.emplace_back(
-        procedure_counter,
-        num_antenna_paths,
-        cs_trackers_[connection_handle].config_id,
-        cs_trackers_[connection_handle].selected_tx_power);
+    auto& tracker = cs_trackers_[connection_handle];
+    if (tracker.unused_procedure_data.empty()) {
+      data_list.emplace_back(
+          procedure_counter, num_antenna_paths, tracker.config_id, tracker.selected_tx_power);
+    } else {
+      data_list.push_back(std::move(tracker.unused_procedure_data.back()));
+      tracker.unused_procedure_data.pop_back();
+      data_list.back().Reset(
+          procedure_counter, num_antenna_paths, tracker.config_id, tracker.selected_tx_power);
+    }
 
     // Append ranging header raw data
-    std::vector<uint8_t> ranging_header_raw = {};
-    BitInserter bi(ranging_header_raw);
+    BitInserter bi(data_list.back().ras_raw_data_);
     data_list.back().ranging_header_.Serialize(bi);
-    append_vector(data_list.back().ras_raw_data_, ranging_header_raw);
 
     if (data_list.size() > kProcedureDataBufferSize) {
       log::warn("buffer full, drop procedure data with counter: {}", data_list.front().counter);
-      data_list.erase(data_list.begin());
+      recycle_procedure_data(connection_handle, data_list.begin());
     }
     return &data_list.back();
   }
 
+  // Move the data of a finished procedure to the unused data of the tracker
+  void recycle_procedure_data(
+      uint16_t connection_handle, std::vector<CsProcedureData>::iterator procedure_data) {
+    auto& tracker = cs_trackers_[connection_handle];
+    if (tracker.unused_procedure_data.size() < kProcedureDataBufferSize) {
+      tracker.unused_procedure_data.push_back(std::move(*procedure_data));
+    }
+    tracker.procedure_data_list.erase(procedure_data);
+  }
+
   void cs_delete_obsolete_data(uint16_t connection_handle) {
     std::vector<CsProcedureData>& data_list = cs_trackers_[connection_handle].procedure_data_list;
     while (!data_list.empty()) {
-      data_list.erase(data_list.begin());
+      recycle_procedure_data(connection_handle, data_list.begin());
     }
   }
 
@@ -1192,22 +1277,13 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       log::debug(
           "Procedure complete counter:{} data size:{}, main_mode_type:{}, sub_mode_type:{}",
           (uint16_t)procedure_data->counter,
-          (uint16_t)procedure_data->step_channel.size(),
+          (uint16_t)procedure_data->raw_data.step_channel_.size(),
           (uint16_t)cs_trackers_[connection_handle].main_mode_type,
           (uint16_t)cs_trackers_[connection_handle].sub_mode_type);
 
       if (ranging_hal_->IsBound()) {
         // Use algorithm in the HAL
-        bluetooth::hal::ChannelSoundingRawData raw_data;
-        raw_data.num_antenna_paths_ = procedure_data->num_antenna_paths;
-        raw_data.step_channel_ = procedure_data->step_channel;
-        raw_data.tone_pct_initiator_ = procedure_data->tone_pct_initiator;
-        raw_data.tone_quality_indicator_initiator_ =
-            procedure_data->tone_quality_indicator_initiator;
-        raw_data.tone_pct_reflector_ = procedure_data->tone_pct_reflector;
-        raw_data.tone_quality_indicator_reflector_ =
-            procedure_data->tone_quality_indicator_reflector;
-        ranging_hal_->WriteRawData(connection_handle, raw_data);
+        ranging_hal_->WriteRawData(connection_handle, procedure_data->raw_data);
         return;
       }
     }
@@ -1219,102 +1295,73 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       uint16_t counter = procedure_data->counter;  // Get value from pointer first.
       while (data_list.begin()->counter < counter) {
         log::debug("Delete obsolete procedure data, counter:{}", data_list.begin()->counter);
-        data_list.erase(data_list.begin());
+        recycle_procedure_data(connection_handle, data_list.begin());
       }
     }
   }
 
-  void parse_cs_result_data(
-      std::vector<LeCsResultDataStructure> result_data_structures,
-      CsProcedureData& procedure_data,
-      CsRole role) {
-    uint8_t num_antenna_paths = procedure_data.num_antenna_paths;
+  // Parse the result data structures of a CS subevent, {step_mode, step_channel, step_data_length,
+  // step_data}, in place: the step data is appended to the RAS subevent data and decoded into the
+  // buffers of |procedure_data| without materializing a LeCsResultDataStructure for each step.
+  // Returns the number of steps parsed.
+  uint8_t parse_cs_result_data(
+      PacketView<kLittleEndian> steps, CsProcedureData& procedure_data, CsRole role) {
     auto& ras_data = procedure_data.ras_subevent_data_;
-    for (auto result_data_structure : result_data_structures) {
-      uint16_t mode = result_data_structure.step_mode_;
-      uint16_t step_channel = result_data_structure.step_channel_;
-      uint16_t data_length = result_data_structure.step_data_.size();
-      log::verbose(
-          "mode: {}, channel: {}, data_length: {}",
-          mode,
-          step_channel,
-          (uint16_t)result_data_structure.step_data_.size());
+    uint8_t num_steps = 0;
+    auto iterator = steps.begin();
+    while (iterator.NumBytesRemaining() >= kCsStepHeaderSize) {
+      uint8_t mode = iterator.extract<uint8_t>();
+      uint8_t step_channel = iterator.extract<uint8_t>();
+      uint8_t data_length = iterator.extract<uint8_t>();
+      if (iterator.NumBytesRemaining() < data_length) {
+        log::warn("Truncated step data, mode: {}, data_length: {}", mode, data_length);
+        break;
+      }
+      num_steps++;
+      log::verbose("mode: {}, channel: {}, data_length: {}", mode, step_channel, data_length);
       ras_data.emplace_back(mode);
       if (data_length == 0) {
         ras_data.back() |= (1 << 7);  // set step aborted
         continue;
       }
-      append_vector(ras_data, result_data_structure.step_data_);
-
-      // Parse data into structs from an iterator
-      auto bytes = std::make_shared<std::vector<uint8_t>>();
-      if (mode == 0x02 || mode == 0x03) {
-        // Add one byte for the length of Tone_PCT[k], Tone_Quality_Indicator[k]
-        bytes->emplace_back(num_antenna_paths + 1);
+      auto step_data = iterator.Subrange(0, data_length);
+      iterator += data_length;
+      for (auto byte = step_data; byte.NumBytesRemaining() > 0; ++byte) {
+        ras_data.push_back(*byte);
       }
-      bytes->reserve(bytes->size() + result_data_structure.step_data_.size());
-      bytes->insert(
-          bytes->end(),
-          result_data_structure.step_data_.begin(),
-          result_data_structure.step_data_.end());
-      Iterator<packet::kLittleEndian> iterator(bytes);
+
       switch (mode) {
         case 0: {
           if (role == CsRole::INITIATOR) {
             LeCsMode0InitatorData tone_data_view;
-            auto after = LeCsMode0InitatorData::Parse(&tone_data_view, iterator);
-            if (after == iterator) {
+            auto after = LeCsMode0InitatorData::Parse(&tone_data_view, step_data);
+            if (after == step_data) {
               log::warn("Received invalid mode {} data, role:{}", mode, CsRoleText(role));
-              print_raw_data(result_data_structure.step_data_);
+              print_raw_data(std::vector<uint8_t>(ras_data.end() - data_length, ras_data.end()));
               continue;
             }
             log::verbose("step_data: {}", tone_data_view.ToString());
             procedure_data.measured_freq_offset.push_back(tone_data_view.measured_freq_offset_);
           } else {
             LeCsMode0ReflectorData tone_data_view;
-            auto after = LeCsMode0ReflectorData::Parse(&tone_data_view, iterator);
-            if (after == iterator) {
+            auto after = LeCsMode0ReflectorData::Parse(&tone_data_view, step_data);
+            if (after == step_data) {
               log::warn("Received invalid mode {} data, role:{}", mode, CsRoleText(role));
-              print_raw_data(result_data_structure.step_data_);
+              print_raw_data(std::vector<uint8_t>(ras_data.end() - data_length, ras_data.end()));
               continue;
             }
             log::verbose("step_data: {}", tone_data_view.ToString());
           }
         } break;
         case 2: {
-          LeCsMode2Data tone_data_view;
-          auto after = LeCsMode2Data::Parse(&tone_data_view, iterator);
-          if (after == iterator) {
+          if (!parse_mode_2_tones(
+                  step_data, procedure_data.num_antenna_paths, procedure_data, role)) {
             log::warn("Received invalid mode {} data, role:{}", mode, CsRoleText(role));
-            print_raw_data(result_data_structure.step_data_);
+            print_raw_data(std::vector<uint8_t>(ras_data.end() - data_length, ras_data.end()));
             continue;
           }
-          log::verbose("step_data: {}", tone_data_view.ToString());
           if (role == CsRole::INITIATOR) {
-            procedure_data.step_channel.push_back(step_channel);
-          }
-          auto tone_data = tone_data_view.tone_data_;
-          uint8_t permutation_index = tone_data_view.antenna_permutation_index_;
-          // Parse in ascending order of antenna position with tone extension data at the end
-          uint16_t num_tone_data = num_antenna_paths + 1;
-          for (uint16_t k = 0; k < num_tone_data; k++) {
-            uint8_t antenna_path = k == num_antenna_paths
-                                       ? num_antenna_paths
-                                       : cs_antenna_permutation_array_[permutation_index][k] - 1;
-            double i_value = get_iq_value(tone_data[k].i_sample_);
-            double q_value = get_iq_value(tone_data[k].q_sample_);
-            uint8_t tone_quality_indicator = tone_data[k].tone_quality_indicator_;
-            log::verbose(
-                "antenna_path {}, {:f}, {:f}", (uint16_t)(antenna_path + 1), i_value, q_value);
-            if (role == CsRole::INITIATOR) {
-              procedure_data.tone_pct_initiator[antenna_path].emplace_back(i_value, q_value);
-              procedure_data.tone_quality_indicator_initiator[antenna_path].emplace_back(
-                  tone_quality_indicator);
-            } else {
-              procedure_data.tone_pct_reflector[antenna_path].emplace_back(i_value, q_value);
-              procedure_data.tone_quality_indicator_reflector[antenna_path].emplace_back(
-                  tone_quality_indicator);
-            }
+            procedure_data.raw_data.step_channel_.push_back(step_channel);
           }
         } break;
         case 1:
@@ -1326,6 +1373,49 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         }
       }
     }
+    return num_steps;
+  }
+
+  // Decode the tones of a mode-2 step, {antenna_permutation_index, {i_sample : 12, q_sample : 12,
+  // tone_quality_indicator : 8}[num_antenna_paths + 1]}, in ascending order of antenna position
+  // with the tone extension data at the end. Returns false when |step_data| is too short or the
+  // permutation index is invalid.
+  bool parse_mode_2_tones(
+      Iterator<packet::kLittleEndian> step_data,
+      uint8_t num_antenna_paths,
+      CsProcedureData& procedure_data,
+      CsRole role) {
+    uint16_t num_tone_data = num_antenna_paths + 1;
+    if (step_data.NumBytesRemaining() < 1 + kCsToneDataSize * num_tone_data) {
+      return false;
+    }
+    uint8_t permutation_index = step_data.extract<uint8_t>();
+    if (permutation_index >= std::size(cs_antenna_permutation_array_)) {
+      return false;
+    }
+    auto& tone_pct = role == CsRole::INITIATOR ? procedure_data.raw_data.tone_pct_initiator_
+                                               : procedure_data.raw_data.tone_pct_reflector_;
+    auto& tone_quality_indicators =
+        role == CsRole::INITIATOR ? procedure_data.raw_data.tone_quality_indicator_initiator_
+                                  : procedure_data.raw_data.tone_quality_indicator_reflector_;
+    for (uint16_t k = 0; k < num_tone_data; k++) {
+      uint32_t samples = step_data.extract<uint8_t>();
+      samples |= static_cast<uint32_t>(step_data.extract<uint8_t>()) << 8;
+      samples |= static_cast<uint32_t>(step_data.extract<uint8_t>()) << 16;
+      uint8_t tone_quality_indicator = step_data.extract<uint8_t>();
+      uint8_t antenna_path = k == num_antenna_paths
+                                 ? num_antenna_paths
+                                 : cs_antenna_permutation_array_[permutation_index][k] - 1;
+      if (antenna_path >= tone_pct.size()) {
+        continue;
+      }
+      double i_value = get_iq_value(samples & 0xFFF);
+      double q_value = get_iq_value((samples >> 12) & 0xFFF);
+      log::verbose("antenna_path {}, {:f}, {:f}", (uint16_t)(antenna_path + 1), i_value, q_value);
+      tone_pct[antenna_path].emplace_back(i_value, q_value);
+      tone_quality_indicators[antenna_path].emplace_back(tone_quality_indicator);
+    }
+    return true;
   }
 
   double get_iq_value(uint16_t sample) {
@@ -1454,9 +1544,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       log::info("Track rssi for address {}", address);
       rssi_trackers[address].started = true;
       distance_measurement_callbacks_->OnDistanceMeasurementStarted(address, METHOD_RSSI);
-      rssi_trackers[address].repeating_alarm->Schedule(
-          common::Bind(&impl::send_read_rssi, common::Unretained(this), address),
-          std::chrono::milliseconds(rssi_trackers[address].interval_ms));
+      schedule_measurement(
+          address, DistanceMeasurementScheduler::Kind::RSSI, rssi_trackers[address].interval_ms);
     }
   }
 
@@ -1485,24 +1574,11 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         DistanceMeasurementMethod::METHOD_RSSI);
   }
 
-  std::vector<uint8_t> builder_to_bytes(std::unique_ptr<PacketBuilder<true>> builder) {
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    builder->Serialize(bi);
-    return *bytes;
-  }
-
-  void append_vector(std::vector<uint8_t>& v1, const std::vector<uint8_t>& v2) {
-    v1.reserve(v2.size());
-    v1.insert(v1.end(), v2.begin(), v2.end());
-  }
-
   struct RSSITracker {
     uint16_t handle;
     uint16_t interval_ms;
     uint8_t remote_tx_power;
     bool started;
-    std::unique_ptr<os::RepeatingAlarm> repeating_alarm;
   };
 
   struct CsTracker {
@@ -1520,9 +1596,10 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     uint8_t config_id = 0;
     uint8_t selected_tx_power = 0;
     std::vector<CsProcedureData> procedure_data_list;
+    // Finished procedure data kept for the next procedures, so that their buffers are reused
+    std::vector<CsProcedureData> unused_procedure_data;
     uint16_t interval_ms;
     bool waiting_for_start_callback = false;
-    std::unique_ptr<os::RepeatingAlarm> repeating_alarm;
     // RAS data
     RangingHeader ranging_header_;
     PacketViewForRecombination segment_data_;
@@ -1535,6 +1612,10 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   hci::DistanceMeasurementInterface* distance_measurement_interface_;
   std::unordered_map<Address, RSSITracker> rssi_trackers;
   std::unordered_map<uint16_t, CsTracker> cs_trackers_;
+  // Time multiplexes the RSSI reads and CS procedures of all the peers on a single alarm
+  DistanceMeasurementScheduler scheduler_;
+  std::unique_ptr<os::Alarm> scheduler_alarm_;
+  DistanceMeasurementScheduler::Clock::time_point last_rate_report_;
   DistanceMeasurementCallbacks* distance_measurement_callbacks_;
   CsOptionalSubfeaturesSupported cs_subfeature_supported_;
   // Antenna path permutations. See Channel Sounding CR_PR for the details.
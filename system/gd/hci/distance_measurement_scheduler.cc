@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/distance_measurement_scheduler.h"
+
+#include <algorithm>
+
+namespace bluetooth::hci {
+
+void DistanceMeasurementScheduler::AddPeer(
+    const Address& address,
+    Kind kind,
+    std::chrono::milliseconds interval,
+    Clock::time_point first_due) {
+  Peer& peer = peers_[{address, kind}];
+  peer.interval = std::max(interval, std::chrono::milliseconds(1));
+  peer.next_due = first_due;
+}
+
+void DistanceMeasurementScheduler::RemovePeer(const Address& address, Kind kind) {
+  peers_.erase({address, kind});
+}
+
+DistanceMeasurementScheduler::Batch DistanceMeasurementScheduler::Poll(Clock::time_point now) {
+  Batch batch;
+  Peer* next_cs_peer = nullptr;
+  const Address* next_cs_address = nullptr;
+  for (auto& [key, peer] : peers_) {
+    if (key.second == Kind::RSSI) {
+      if (peer.next_due <= now + kRssiBatchWindow) {
+        dispatch(peer, Kind::RSSI, now);
+        batch.rssi.push_back(key.first);
+      }
+    } else if (
+        peer.next_due <= now &&
+        (next_cs_peer == nullptr || peer.next_due < next_cs_peer->next_due)) {
+      next_cs_peer = &peer;
+      next_cs_address = &key.first;
+    }
+  }
+  if (next_cs_peer != nullptr && now >= cs_slot_free_) {
+    dispatch(*next_cs_peer, Kind::CS, now);
+    batch.cs.push_back(*next_cs_address);
+    cs_slot_free_ = now + cs_slot_;
+  }
+  return batch;
+}
+
+std::optional<DistanceMeasurementScheduler::Clock::time_point>
+DistanceMeasurementScheduler::NextWakeup() const {
+  std::optional<Clock::time_point> wakeup;
+  for (const auto& [key, peer] : peers_) {
+    Clock::time_point due = peer.next_due;
+    if (key.second == Kind::CS) {
+      due = std::max(due, cs_slot_free_);
+    }
+    if (!wakeup.has_value() || due < *wakeup) {
+      wakeup = due;
+    }
+  }
+  return wakeup;
+}
+
+std::vector<DistanceMeasurementScheduler::RateReport> DistanceMeasurementScheduler::GetRateReports()
+    const {
+  std::vector<RateReport> reports;
+  for (const auto& [key, peer] : peers_) {
+    RateReport report;
+    report.address = key.first;
+    report.kind = key.second;
+    report.requested_hz = 1000.0 / peer.interval.count();
+    report.num_measurements = peer.num_measurements;
+    report.achieved_hz = 0;
+    std::chrono::duration<double> elapsed = peer.last_measurement - peer.first_measurement;
+    if (peer.num_measurements > 1 && elapsed.count() > 0) {
+      report.achieved_hz = (peer.num_measurements - 1) / elapsed.count();
+    }
+    reports.push_back(report);
+  }
+  return reports;
+}
+
+void DistanceMeasurementScheduler::dispatch(Peer& peer, Kind kind, Clock::time_point now) {
+  if (peer.num_measurements == 0) {
+    peer.first_measurement = now;
+  }
+  peer.last_measurement = now;
+  peer.num_measurements++;
+  peer.next_due += peer.interval;
+  if (kind == Kind::CS) {
+    // A peer that waited for the slots stays due, behind the peers that waited longer, so that
+    // the slots are shared evenly when the peers ask for more than they allow
+    peer.next_due = std::max(peer.next_due, now);
+  } else if (peer.next_due <= now) {
+    // Keep the phase of the peer, unless it fell behind by a whole interval: the missed reads are
+    // skipped rather than issued back to back
+    peer.next_due = now + peer.interval;
+  }
+}
+
+}  // namespace bluetooth::hci
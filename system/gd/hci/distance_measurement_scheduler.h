@@ -0,0 +1,110 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth::hci {
+
+/// Decides when each peer of the distance measurement manager is measured, so that many peers
+/// share one alarm instead of polling from an alarm each.
+///
+/// RSSI reads that come due within kRssiBatchWindow of each other are issued together, which
+/// keeps the number of wakeups close to that of the fastest peer. Channel sounding procedures
+/// occupy the radio, so at most one procedure is started per CS slot and the most overdue peer
+/// goes first; when the peers request more procedures than the slots allow, each of them gets a
+/// fair share and its achieved rate drops below the requested one.
+///
+/// The scheduler does not own an alarm or a clock: the owner calls Poll() at NextWakeup() and
+/// dispatches the returned peers.
+class DistanceMeasurementScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Kind { RSSI, CS };
+
+  static constexpr std::chrono::milliseconds kRssiBatchWindow{20};
+  static constexpr std::chrono::milliseconds kDefaultCsSlot{50};
+
+  struct Batch {
+    std::vector<Address> rssi;
+    std::vector<Address> cs;
+  };
+
+  struct RateReport {
+    Address address;
+    Kind kind;
+    double requested_hz;
+    double achieved_hz;
+    size_t num_measurements;
+  };
+
+  explicit DistanceMeasurementScheduler(std::chrono::milliseconds cs_slot = kDefaultCsSlot)
+      : cs_slot_(cs_slot) {}
+
+  DistanceMeasurementScheduler(const DistanceMeasurementScheduler&) = delete;
+
+  DistanceMeasurementScheduler& operator=(const DistanceMeasurementScheduler&) = delete;
+
+  /// Measure |address| with |kind| every |interval|, starting at |first_due|. Updates the interval
+  /// of a peer that is already scheduled, keeping its statistics.
+  void AddPeer(
+      const Address& address,
+      Kind kind,
+      std::chrono::milliseconds interval,
+      Clock::time_point first_due);
+
+  void RemovePeer(const Address& address, Kind kind);
+
+  bool IsEmpty() const {
+    return peers_.empty();
+  }
+
+  /// Returns the peers to measure at |now| and advances their deadlines.
+  Batch Poll(Clock::time_point now);
+
+  /// Returns when Poll() has to be called next, or std::nullopt when there is no peer.
+  std::optional<Clock::time_point> NextWakeup() const;
+
+  /// Requested and achieved measurement rate of each peer, the latter computed over the
+  /// measurements dispatched so far.
+  std::vector<RateReport> GetRateReports() const;
+
+ private:
+  struct Peer {
+    std::chrono::milliseconds interval;
+    Clock::time_point next_due;
+    size_t num_measurements = 0;
+    Clock::time_point first_measurement;
+    Clock::time_point last_measurement;
+  };
+
+  void dispatch(Peer& peer, Kind kind, Clock::time_point now);
+
+  std::chrono::milliseconds cs_slot_;
+  Clock::time_point cs_slot_free_;
+  std::map<std::pair<Address, Kind>, Peer> peers_;
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/distance_measurement_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+namespace bluetooth::hci {
+namespace {
+
+using std::chrono::milliseconds;
+using Kind = DistanceMeasurementScheduler::Kind;
+
+const Address kAddress1({0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+const Address kAddress2({0x11, 0x12, 0x13, 0x14, 0x15, 0x16});
+const Address kAddress3({0x21, 0x22, 0x23, 0x24, 0x25, 0x26});
+
+class DistanceMeasurementSchedulerTest : public ::testing::Test {
+ protected:
+  // Run the scheduler for |duration| as its owner does, polling at each wakeup, and count the
+  // wakeups and the measurements of each peer
+  void Run(milliseconds duration) {
+    auto end = now_ + duration;
+    while (true) {
+      auto wakeup = scheduler_.NextWakeup();
+      if (!wakeup.has_value() || *wakeup > end) {
+        break;
+      }
+      now_ = std::max(now_, *wakeup);
+      auto batch = scheduler_.Poll(now_);
+      num_wakeups_++;
+      for (const auto& address : batch.rssi) {
+        rssi_reads_[address]++;
+      }
+      for (const auto& address : batch.cs) {
+        cs_procedures_[address]++;
+      }
+    }
+    now_ = end;
+  }
+
+  DistanceMeasurementScheduler::RateReport Report(const Address& address, Kind kind) {
+    for (const auto& report : scheduler_.GetRateReports()) {
+      if (report.address == address && report.kind == kind) {
+        return report;
+      }
+    }
+    ADD_FAILURE() << "no report for " << address;
+    return {};
+  }
+
+  DistanceMeasurementScheduler scheduler_;
+  DistanceMeasurementScheduler::Clock::time_point now_;
+  size_t num_wakeups_ = 0;
+  std::map<Address, size_t> rssi_reads_;
+  std::map<Address, size_t> cs_procedures_;
+};
+
+TEST_F(DistanceMeasurementSchedulerTest, no_peer_no_wakeup) {
+  EXPECT_TRUE(scheduler_.IsEmpty());
+  EXPECT_FALSE(scheduler_.NextWakeup().has_value());
+  scheduler_.AddPeer(kAddress1, Kind::RSSI, milliseconds(100), now_);
+  scheduler_.RemovePeer(kAddress1, Kind::RSSI);
+  EXPECT_FALSE(scheduler_.NextWakeup().has_value());
+}
+
+TEST_F(DistanceMeasurementSchedulerTest, rssi_reads_follow_requested_interval) {
+  scheduler_.AddPeer(kAddress1, Kind::RSSI, milliseconds(100), now_ + milliseconds(100));
+  Run(milliseconds(1000));
+  EXPECT_EQ(10ul, rssi_reads_[kAddress1]);
+  auto report = Report(kAddress1, Kind::RSSI);
+  EXPECT_DOUBLE_EQ(10.0, report.requested_hz);
+  EXPECT_NEAR(10.0, report.achieved_hz, 0.01);
+}
+
+TEST_F(DistanceMeasurementSchedulerTest, rssi_reads_due_together_are_batched) {
+  // The peers are 10 ms apart, within the batch window, so each wakeup reads all of them
+  scheduler_.AddPeer(kAddress1, Kind::RSSI, milliseconds(200), now_ + milliseconds(200));
+  scheduler_.AddPeer(kAddress2, Kind::RSSI, milliseconds(200), now_ + milliseconds(210));
+  scheduler_.AddPeer(kAddress3, Kind::RSSI, milliseconds(200), now_ + milliseconds(205));
+  Run(milliseconds(1000));
+  EXPECT_EQ(5ul, num_wakeups_);
+  EXPECT_EQ(5ul, rssi_reads_[kAddress1]);
+  EXPECT_EQ(5ul, rssi_reads_[kAddress2]);
+  EXPECT_EQ(5ul, rssi_reads_[kAddress3]);
+}
+
+TEST_F(DistanceMeasurementSchedulerTest, cs_procedures_are_time_multiplexed) {
+  // Three peers at 10 Hz need 30 procedures per second, the 50 ms slots allow 20
+  scheduler_.AddPeer(kAddress1, Kind::CS, milliseconds(100), now_);
+  scheduler_.AddPeer(kAddress2, Kind::CS, milliseconds(100), now_);
+  scheduler_.AddPeer(kAddress3, Kind::CS, milliseconds(100), now_);
+  Run(milliseconds(3000));
+  size_t total = 0;
+  for (const auto& address : {kAddress1, kAddress2, kAddress3}) {
+    EXPECT_NEAR(20.0, cs_procedures_[address], 1.0);
+    total += cs_procedures_[address];
+    auto report = Report(address, Kind::CS);
+    EXPECT_DOUBLE_EQ(10.0, report.requested_hz);
+    EXPECT_NEAR(20.0 / 3, report.achieved_hz, 0.5);
+  }
+  EXPECT_EQ(61ul, total);
+}
+
+TEST_F(DistanceMeasurementSchedulerTest, cs_procedures_within_capacity_keep_their_rate) {
+  scheduler_.AddPeer(kAddress1, Kind::CS, milliseconds(200), now_);
+  scheduler_.AddPeer(kAddress2, Kind::CS, milliseconds(400), now_);
+  Run(milliseconds(2000));
+  EXPECT_NEAR(5.0, Report(kAddress1, Kind::CS).achieved_hz, 0.2);
+  EXPECT_NEAR(2.5, Report(kAddress2, Kind::CS).achieved_hz, 0.2);
+}
+
+TEST_F(DistanceMeasurementSchedulerTest, update_interval_keeps_statistics) {
+  scheduler_.AddPeer(kAddress1, Kind::RSSI, milliseconds(100), now_ + milliseconds(100));
+  Run(milliseconds(500));
+  scheduler_.AddPeer(kAddress1, Kind::RSSI, milliseconds(50), now_ + milliseconds(50));
+  Run(milliseconds(500));
+  EXPECT_EQ(15ul, rssi_reads_[kAddress1]);
+  auto report = Report(kAddress1, Kind::RSSI);
+  EXPECT_DOUBLE_EQ(20.0, report.requested_hz);
+  EXPECT_EQ(15ul, report.num_measurements);
+}
+
+TEST_F(DistanceMeasurementSchedulerTest, rssi_and_cs_peers_are_independent) {
+  scheduler_.AddPeer(kAddress1, Kind::RSSI, milliseconds(100), now_ + milliseconds(100));
+  scheduler_.AddPeer(kAddress1, Kind::CS, milliseconds(100), now_);
+  Run(milliseconds(1000));
+  EXPECT_EQ(10ul, rssi_reads_[kAddress1]);
+  EXPECT_EQ(11ul, cs_procedures_[kAddress1]);
+  scheduler_.RemovePeer(kAddress1, Kind::CS);
+  EXPECT_EQ(1ul, scheduler_.GetRateReports().size());
+}
+
+}  // namespace
+}  // namespace bluetooth::hci
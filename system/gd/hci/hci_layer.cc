@@ -21,11 +21,16 @@
 #endif
 #include <bluetooth/log.h>
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <type_traits>
 #include <utility>
 
 #include "common/bind.h"
 #include "common/init_flags.h"
+#include "common/latency_trace.h"
+#include "common/scope_profiler.h"
 #include "common/stop_watch.h"
 #include "hal/hci_hal.h"
 #include "hci/class_of_device.h"
@@ -33,6 +38,7 @@
 #include "os/alarm.h"
 #include "os/metrics.h"
 #include "os/queue.h"
+#include "os/system_properties.h"
 #include "osi/include/stack_power_telemetry.h"
 #include "packet/raw_builder.h"
 #include "storage/storage_module.h"
@@ -70,6 +76,49 @@ static void abort_after_time_out(OpCode op_code) {
   log::fatal("Done waiting for debug information after HCI timeout ({})", OpCodeText(op_code));
 }
 
+static const std::string kCommandPipeliningProperty = "bluetooth.hci.command_pipelining.enabled";
+
+// Commands that only read local controller state. They have no side effects a
+// later command could depend on, so several of them may be outstanding at once.
+static bool is_pipelinable_command(OpCode op_code) {
+  constexpr uint16_t kInformationalParametersOgf = 0x04;
+  if ((static_cast<uint16_t>(op_code) >> 10) == kInformationalParametersOgf) {
+    return true;
+  }
+  switch (op_code) {
+    case OpCode::READ_LOCAL_NAME:
+    case OpCode::LE_READ_BUFFER_SIZE_V1:
+    case OpCode::LE_READ_BUFFER_SIZE_V2:
+    case OpCode::LE_READ_LOCAL_SUPPORTED_FEATURES:
+    case OpCode::LE_READ_ADVERTISING_PHYSICAL_CHANNEL_TX_POWER:
+    case OpCode::LE_READ_FILTER_ACCEPT_LIST_SIZE:
+    case OpCode::LE_READ_SUPPORTED_STATES:
+    case OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH:
+    case OpCode::LE_READ_RESOLVING_LIST_SIZE:
+    case OpCode::LE_READ_MAXIMUM_DATA_LENGTH:
+    case OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH:
+    case OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS:
+    case OpCode::LE_READ_PERIODIC_ADVERTISER_LIST_SIZE:
+    case OpCode::LE_READ_TRANSMIT_POWER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The opcode a Command Complete or Command Status event answers, NONE otherwise.
+static OpCode get_response_op_code(EventView event) {
+  if (event.GetEventCode() == EventCode::COMMAND_COMPLETE) {
+    auto view = CommandCompleteView::Create(event);
+    return view.IsValid() ? view.GetCommandOpCode() : OpCode::NONE;
+  }
+  if (event.GetEventCode() == EventCode::COMMAND_STATUS) {
+    auto view = CommandStatusView::Create(event);
+    return view.IsValid() ? view.GetCommandOpCode() : OpCode::NONE;
+  }
+  return OpCode::NONE;
+}
+
 class CommandQueueEntry {
  public:
   CommandQueueEntry(
@@ -87,6 +136,8 @@ class CommandQueueEntry {
         on_status(std::move(on_status_function)) {}
 
   unique_ptr<CommandBuilder> command;
+  // Set once the command is serialized, which happens before it is sent
+  std::shared_ptr<std::vector<uint8_t>> bytes;
   unique_ptr<CommandView> command_view;
 
   bool waiting_for_status_;
@@ -109,8 +160,46 @@ class CommandQueueEntry {
   }
 };
 
+// Handlers indexed by their 8 bit PDL event code, so that dispatching an event
+// is a single array lookup with no allocation or tree walk.
+template <typename TCode, typename TView>
+class EventHandlerTable {
+ public:
+  bool Contains(TCode code) const {
+    return static_cast<bool>(handlers_[Index(code)]);
+  }
+
+  void Register(TCode code, ContextualCallback<void(TView)> handler) {
+    handlers_[Index(code)] = std::move(handler);
+  }
+
+  void Unregister(TCode code) {
+    handlers_[Index(code)] = {};
+  }
+
+  // Returns nullptr when no handler is registered for |code|.
+  ContextualCallback<void(TView)>* Find(TCode code) {
+    auto& handler = handlers_[Index(code)];
+    return handler ? &handler : nullptr;
+  }
+
+ private:
+  using Underlying = std::underlying_type_t<TCode>;
+  static_assert(sizeof(Underlying) == 1, "Event codes are expected to be 8 bits wide");
+
+  static size_t Index(TCode code) {
+    return static_cast<size_t>(static_cast<Underlying>(code));
+  }
+
+  std::array<ContextualCallback<void(TView)>, 1 << (8 * sizeof(Underlying))> handlers_{};
+};
+
 struct HciLayer::impl {
-  impl(hal::HciHal* hal, HciLayer& module) : hal_(hal), module_(module) {
+  impl(hal::HciHal* hal, storage::StorageModule* storage, HciLayer& module)
+      : hal_(hal),
+        storage_(storage),
+        module_(module),
+        pipelining_enabled_(os::GetSystemPropertyBool(kCommandPipeliningProperty, false)) {
     hci_timeout_alarm_ = new Alarm(module.GetHandler());
   }
 
@@ -134,24 +223,21 @@ struct HciLayer::impl {
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
+    packet->SerializeTo(bytes);
     hal_->sendAclData(bytes);
   }
 
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
+    packet->SerializeTo(bytes);
     hal_->sendScoData(bytes);
   }
 
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
+    packet->SerializeTo(bytes);
     hal_->sendIsoData(bytes);
   }
 
@@ -196,20 +282,22 @@ struct HciLayer::impl {
         "Unexpected {} event with OpCode {}",
         logging_id,
         OpCodeText(op_code));
-    if (waiting_command_ == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
+    OpCode oldest_op_code = outstanding_commands_ > 0 ? command_queue_.front().command_view->GetOpCode() : OpCode::NONE;
+    if (oldest_op_code == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
       log::error("Discarding event that came after timeout {}", OpCodeText(op_code));
       common::StopWatch::DumpStopWatchLog();
       return;
     }
+    auto command = find_outstanding_command(op_code);
     log::assert_that(
-        waiting_command_ == op_code,
+        command != outstanding_commands_end(),
         "Waiting for {}, got {}",
-        OpCodeText(waiting_command_),
+        OpCodeText(oldest_op_code),
         OpCodeText(op_code));
 
     bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
     CommandStatusView status_view = CommandStatusView::Create(event);
-    if (is_vendor_specific && (is_status && !command_queue_.front().waiting_for_status_) &&
+    if (is_vendor_specific && (is_status && !command->waiting_for_status_) &&
         (status_view.IsValid() && status_view.GetStatus() == ErrorCode::UNKNOWN_HCI_COMMAND)) {
       // If this is a command status of a vendor specific command, and command complete is expected,
       // we can't treat this as hard failure since we have no way of probing this lack of support at
@@ -228,15 +316,15 @@ struct HciLayer::impl {
           CommandCompleteView::Create(EventView::Create(PacketView<kLittleEndian>(complete)));
       log::assert_that(
           command_complete_view.IsValid(), "assert failed: command_complete_view.IsValid()");
-      (*command_queue_.front().GetCallback<CommandCompleteView>())(command_complete_view);
+      (*command->GetCallback<CommandCompleteView>())(command_complete_view);
     } else {
       log::assert_that(
-          command_queue_.front().waiting_for_status_ == is_status,
+          command->waiting_for_status_ == is_status,
           "{} was not expecting {} event",
           OpCodeText(op_code),
           logging_id);
 
-      (*command_queue_.front().GetCallback<TResponse>())(std::move(response_view));
+      (*command->GetCallback<TResponse>())(std::move(response_view));
     }
 
 #ifdef TARGET_FLOSS
@@ -247,7 +335,7 @@ struct HciLayer::impl {
     // would return UNKNOWN_CONNECTION in some cases.
     if (op_code == OpCode::LE_READ_REMOTE_FEATURES && is_status && status_view.IsValid() &&
         status_view.GetStatus() == ErrorCode::UNKNOWN_CONNECTION) {
-      auto& command_view = *command_queue_.front().command_view;
+      auto& command_view = *command->command_view;
       auto le_read_features_view = bluetooth::hci::LeReadRemoteFeaturesView::Create(
           LeConnectionManagementCommandView::Create(AclCommandView::Create(command_view)));
       if (le_read_features_view.IsValid()) {
@@ -257,14 +345,29 @@ struct HciLayer::impl {
     }
 #endif
 
-    command_queue_.pop_front();
-    waiting_command_ = OpCode::NONE;
+    command_queue_.erase(command);
+    outstanding_commands_--;
     if (hci_timeout_alarm_ != nullptr) {
       hci_timeout_alarm_->Cancel();
+      if (outstanding_commands_ > 0) {
+        schedule_command_timeout(command_queue_.front().command_view->GetOpCode());
+      }
       send_next_command();
     }
   }
 
+  std::deque<CommandQueueEntry>::iterator outstanding_commands_end() {
+    return command_queue_.begin() + outstanding_commands_;
+  }
+
+  // Responses to one opcode come back in order, so a response answers the
+  // oldest outstanding command with its opcode.
+  std::deque<CommandQueueEntry>::iterator find_outstanding_command(OpCode op_code) {
+    return std::find_if(command_queue_.begin(), outstanding_commands_end(), [op_code](const CommandQueueEntry& entry) {
+      return entry.command_view->GetOpCode() == op_code;
+    });
+  }
+
   void on_hci_timeout(OpCode op_code) {
     common::StopWatch::DumpStopWatchLog();
     log::error("Timed out waiting for {}", OpCodeText(op_code));
@@ -274,8 +377,8 @@ struct HciLayer::impl {
     log::error("Flushing {} waiting commands", command_queue_.size());
     // Clear any waiting commands (there is an abort coming anyway)
     command_queue_.clear();
+    outstanding_commands_ = 0;
     command_credits_ = 1;
-    waiting_command_ = OpCode::NONE;
     // Ignore the response, since we don't know what might come back.
     enqueue_command(ControllerDebugInfoBuilder::Create(), module_.GetHandler()->BindOnce([](CommandCompleteView) {}));
     // Don't time out for this one;
@@ -292,30 +395,66 @@ struct HciLayer::impl {
     }
   }
 
-  void send_next_command() {
-    if (command_credits_ == 0) {
+  // Serializes |entry| once, so that its opcode is known before it is sent.
+  void prepare_command(CommandQueueEntry& entry) {
+    if (entry.command_view != nullptr) {
       return;
     }
-    if (waiting_command_ != OpCode::NONE) {
-      return;
+    entry.bytes = std::make_shared<std::vector<uint8_t>>();
+    entry.command->SerializeTo(*entry.bytes);
+    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(entry.bytes));
+    log::assert_that(cmd_view.IsValid(), "assert failed: cmd_view.IsValid()");
+    entry.command_view = std::make_unique<CommandView>(std::move(cmd_view));
+  }
+
+  // Without pipelining only one command is outstanding. With it, more commands
+  // are sent while the controller grants credits, as long as the next one and
+  // all outstanding ones are pipelinable reads, and no two share an opcode.
+  // Anything else waits for the outstanding commands, preserving its order.
+  bool can_send_next_command() {
+    if (outstanding_commands_ == 0) {
+      return true;
     }
-    if (command_queue_.size() == 0) {
-      return;
+    if (!pipelining_enabled_) {
+      return false;
+    }
+    auto& next = command_queue_[outstanding_commands_];
+    prepare_command(next);
+    OpCode op_code = next.command_view->GetOpCode();
+    if (!is_pipelinable_command(op_code) || find_outstanding_command(op_code) != outstanding_commands_end()) {
+      return false;
     }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
-    hal_->sendHciCommand(*bytes);
+    return std::all_of(command_queue_.begin(), outstanding_commands_end(), [](const CommandQueueEntry& entry) {
+      return is_pipelinable_command(entry.command_view->GetOpCode());
+    });
+  }
 
-    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
-    log::assert_that(cmd_view.IsValid(), "assert failed: cmd_view.IsValid()");
-    OpCode op_code = cmd_view.GetOpCode();
+  void send_next_command() {
+    while (command_credits_ > 0 && outstanding_commands_ < command_queue_.size() && can_send_next_command()) {
+      send_command(command_queue_[outstanding_commands_]);
+    }
+  }
+
+  void send_command(CommandQueueEntry& entry) {
+    prepare_command(entry);
+    hal_->sendHciCommand(*entry.bytes);
+
+    OpCode op_code = entry.command_view->GetOpCode();
     power_telemetry::GetInstance().LogHciCmdDetail();
-    command_queue_.front().command_view = std::make_unique<CommandView>(std::move(cmd_view));
-    log_link_layer_connection_command(command_queue_.front().command_view);
-    log_classic_pairing_command_status(command_queue_.front().command_view, ErrorCode::STATUS_UNKNOWN);
-    waiting_command_ = op_code;
-    command_credits_ = 0;  // Only allow one outstanding command
+    log_link_layer_connection_command(entry.command_view);
+    log_classic_pairing_command_status(entry.command_view, ErrorCode::STATUS_UNKNOWN);
+    if (pipelining_enabled_) {
+      command_credits_--;
+    } else {
+      command_credits_ = 0;  // Only allow one outstanding command
+    }
+    // The timeout follows the oldest outstanding command
+    if (outstanding_commands_++ == 0) {
+      schedule_command_timeout(op_code);
+    }
+  }
+
+  void schedule_command_timeout(OpCode op_code) {
     if (hci_timeout_alarm_ != nullptr) {
       hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
     } else {
@@ -331,42 +470,42 @@ struct HciLayer::impl {
     // Allow GD Cert tests to register for CONNECTION_REQUEST
     if (event == EventCode::CONNECTION_REQUEST && !module_.on_acl_connection_request_) {
       log::info("Registering test for CONNECTION_REQUEST, since there's no ACL");
-      event_handlers_.erase(event);
+      event_handlers_.Unregister(event);
     }
     log::assert_that(
-        event_handlers_.count(event) == 0,
+        !event_handlers_.Contains(event),
         "Can not register a second handler for {}",
         EventCodeText(event));
-    event_handlers_[event] = handler;
+    event_handlers_.Register(event, handler);
   }
 
   void unregister_event(EventCode event) {
-    event_handlers_.erase(event);
+    event_handlers_.Unregister(event);
   }
 
   void register_le_event(SubeventCode event, ContextualCallback<void(LeMetaEventView)> handler) {
     log::assert_that(
-        le_event_handlers_.count(event) == 0,
+        !le_event_handlers_.Contains(event),
         "Can not register a second handler for {}",
         SubeventCodeText(event));
-    le_event_handlers_[event] = handler;
+    le_event_handlers_.Register(event, handler);
   }
 
   void unregister_le_event(SubeventCode event) {
-    le_event_handlers_.erase(le_event_handlers_.find(event));
+    le_event_handlers_.Unregister(event);
   }
 
   void register_vs_event(
       VseSubeventCode event, ContextualCallback<void(VendorSpecificEventView)> handler) {
     log::assert_that(
-        vs_event_handlers_.count(event) == 0,
+        !vs_event_handlers_.Contains(event),
         "Can not register a second handler for {}",
         VseSubeventCodeText(event));
-    vs_event_handlers_[event] = handler;
+    vs_event_handlers_.Register(event, handler);
   }
 
   void unregister_vs_event(VseSubeventCode event) {
-    vs_event_handlers_.erase(vs_event_handlers_.find(event));
+    vs_event_handlers_.Unregister(event);
   }
 
   static void abort_after_root_inflammation(uint8_t vse_error) {
@@ -393,6 +532,7 @@ struct HciLayer::impl {
   }
 
   void on_hci_event(EventView event) {
+    BT_PROFILE_SCOPE(HCI_EVENT);
     log::assert_that(event.IsValid(), "assert failed: event.IsValid()");
     if (command_queue_.empty()) {
       auto event_code = event.GetEventCode();
@@ -421,9 +561,16 @@ struct HciLayer::impl {
             OpCodeText(op_code));
       }
       std::unique_ptr<CommandView> no_waiting_command{nullptr};
-      log_hci_event(no_waiting_command, event, module_.GetDependency<storage::StorageModule>());
+      log_hci_event(no_waiting_command, event, storage_);
     } else {
-      log_hci_event(command_queue_.front().command_view, event, module_.GetDependency<storage::StorageModule>());
+      auto command = command_queue_.begin();
+      if (outstanding_commands_ > 1) {
+        auto answered = find_outstanding_command(get_response_op_code(event));
+        if (answered != outstanding_commands_end()) {
+          command = answered;
+        }
+      }
+      log_hci_event(command->command_view, event, storage_);
     }
     power_telemetry::GetInstance().LogHciEvtDetail();
     EventCode event_code = event.GetEventCode();
@@ -457,10 +604,10 @@ struct HciLayer::impl {
         on_vs_event(event);
         break;
       default:
-        if (event_handlers_.find(event_code) == event_handlers_.end()) {
-          log::warn("Unhandled event of type {}", EventCodeText(event_code));
+        if (auto* handler = event_handlers_.Find(event_code)) {
+          (*handler)(event);
         } else {
-          event_handlers_[event_code](event);
+          log::warn("Unhandled event of type {}", EventCodeText(event_code));
         }
     }
   }
@@ -483,36 +630,43 @@ struct HciLayer::impl {
     LeMetaEventView meta_event_view = LeMetaEventView::Create(event);
     log::assert_that(meta_event_view.IsValid(), "assert failed: meta_event_view.IsValid()");
     SubeventCode subevent_code = meta_event_view.GetSubeventCode();
-    if (le_event_handlers_.find(subevent_code) == le_event_handlers_.end()) {
+    auto* handler = le_event_handlers_.Find(subevent_code);
+    if (handler == nullptr) {
       log::warn("Unhandled le subevent of type {}", SubeventCodeText(subevent_code));
       return;
     }
-    le_event_handlers_[subevent_code](meta_event_view);
+    (*handler)(meta_event_view);
   }
 
   void on_vs_event(EventView event) {
     VendorSpecificEventView vs_event_view = VendorSpecificEventView::Create(event);
     log::assert_that(vs_event_view.IsValid(), "assert failed: vs_event_view.IsValid()");
     VseSubeventCode subevent_code = vs_event_view.GetSubeventCode();
-    if (vs_event_handlers_.find(subevent_code) == vs_event_handlers_.end()) {
+    auto* handler = vs_event_handlers_.Find(subevent_code);
+    if (handler == nullptr) {
       log::warn("Unhandled vendor specific event of type {}", VseSubeventCodeText(subevent_code));
       return;
     }
-    vs_event_handlers_[subevent_code](vs_event_view);
+    (*handler)(vs_event_view);
   }
 
   hal::HciHal* hal_;
+  // Looked up once, it is needed for every event
+  storage::StorageModule* storage_;
   HciLayer& module_;
 
-  // Command Handling
-  std::list<CommandQueueEntry> command_queue_;
+  // Command Handling. A deque keeps the entries in blocks, instead of one
+  // allocation per queued command.
+  std::deque<CommandQueueEntry> command_queue_;
 
-  std::map<EventCode, ContextualCallback<void(EventView)>> event_handlers_;
-  std::map<SubeventCode, ContextualCallback<void(LeMetaEventView)>> le_event_handlers_;
-  std::map<VseSubeventCode, ContextualCallback<void(VendorSpecificEventView)>> vs_event_handlers_;
+  EventHandlerTable<EventCode, EventView> event_handlers_;
+  EventHandlerTable<SubeventCode, LeMetaEventView> le_event_handlers_;
+  EventHandlerTable<VseSubeventCode, VendorSpecificEventView> vs_event_handlers_;
 
-  OpCode waiting_command_{OpCode::NONE};
+  // Number of commands at the front of |command_queue_| sent to the controller
+  size_t outstanding_commands_{0};
   uint8_t command_credits_{1};  // Send reset first
+  const bool pipelining_enabled_;
   Alarm* hci_timeout_alarm_{nullptr};
   Alarm* hci_abort_alarm_{nullptr};
 
@@ -534,28 +688,44 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   hal_callbacks(HciLayer& module) : module_(module) {}
 
   void hciEventReceived(hal::HciPacket event_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(event_bytes));
+    hciEventReceivedShared(std::make_shared<const std::vector<uint8_t>>(std::move(event_bytes)));
+  }
+
+  void aclDataReceived(hal::HciPacket data_bytes) override {
+    aclDataReceivedShared(std::make_shared<const std::vector<uint8_t>>(std::move(data_bytes)));
+  }
+
+  void scoDataReceived(hal::HciPacket data_bytes) override {
+    scoDataReceivedShared(std::make_shared<const std::vector<uint8_t>>(std::move(data_bytes)));
+  }
+
+  void isoDataReceived(hal::HciPacket data_bytes) override {
+    isoDataReceivedShared(std::make_shared<const std::vector<uint8_t>>(std::move(data_bytes)));
+  }
+
+  // The shared variants wrap the HAL buffer directly; no copy is made on the way to the views.
+  void hciEventReceivedShared(hal::SharedHciPacket event_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>(std::move(event_bytes));
     EventView event = EventView::Create(packet);
     module_.CallOn(module_.impl_, &impl::on_hci_event, std::move(event));
   }
 
-  void aclDataReceived(hal::HciPacket data_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(
-        std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
+  void aclDataReceivedShared(hal::SharedHciPacket data_bytes) override {
+    BT_PROFILE_SCOPE(HCI_ACL_RX);
+    auto packet = packet::PacketView<packet::kLittleEndian>(std::move(data_bytes));
     auto acl = std::make_unique<AclView>(AclView::Create(packet));
+    BT_TRACE_LATENCY(HCI_ACL_RX, acl->IsValid() ? acl->GetHandle() : 0, packet.size());
     module_.impl_->incoming_acl_buffer_.Enqueue(std::move(acl), module_.GetHandler());
   }
 
-  void scoDataReceived(hal::HciPacket data_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(
-        std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
+  void scoDataReceivedShared(hal::SharedHciPacket data_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>(std::move(data_bytes));
     auto sco = std::make_unique<ScoView>(ScoView::Create(packet));
     module_.impl_->incoming_sco_buffer_.Enqueue(std::move(sco), module_.GetHandler());
   }
 
-  void isoDataReceived(hal::HciPacket data_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(
-        std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
+  void isoDataReceivedShared(hal::SharedHciPacket data_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>(std::move(data_bytes));
     auto iso = std::make_unique<IsoView>(IsoView::Create(packet));
     module_.impl_->incoming_iso_buffer_.Enqueue(std::move(iso), module_.GetHandler());
   }
@@ -811,7 +981,7 @@ void HciLayer::ListDependencies(ModuleList* list) const {
 
 void HciLayer::Start() {
   auto hal = GetDependency<hal::HciHal>();
-  impl_ = new impl(hal, *this);
+  impl_ = new impl(hal, GetDependency<storage::StorageModule>(), *this);
   hal_callbacks_ = new hal_callbacks(*this);
 
   Handler* handler = GetHandler();
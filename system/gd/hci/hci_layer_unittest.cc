@@ -33,6 +33,7 @@
 #include "module.h"
 #include "os/fake_timer/fake_timerfd.h"
 #include "os/handler.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -124,6 +125,19 @@ class HciLayerTest : public ::testing::Test {
 
 class HciLayerDeathTest : public HciLayerTest {};
 
+class HciLayerPipeliningTest : public HciLayerTest {
+ protected:
+  void SetUp() override {
+    os::SetSystemProperty("bluetooth.hci.command_pipelining.enabled", "true");
+    HciLayerTest::SetUp();
+  }
+
+  void TearDown() override {
+    HciLayerTest::TearDown();
+    os::ClearSystemPropertiesForHost();
+  }
+};
+
 TEST_F(HciLayerTest, setup_teardown) {}
 
 TEST_F(HciLayerTest, reset_command_sent_on_start) {
@@ -267,6 +281,21 @@ TEST_F(HciLayerDeathTest, abort_on_second_register_event_handler) {
       "");
 }
 
+TEST_F(HciLayerTest, register_event_handler_after_unregister) {
+  FailIfResetNotSent();
+  hci_->RegisterEventHandler(
+      EventCode::SIMPLE_PAIRING_COMPLETE, hci_handler_->Bind([](EventView /* view */) {}));
+  hci_->UnregisterEventHandler(EventCode::SIMPLE_PAIRING_COMPLETE);
+  hci_->RegisterEventHandler(
+      EventCode::SIMPLE_PAIRING_COMPLETE, hci_handler_->Bind([](EventView /* view */) {}));
+  hci_->RegisterLeEventHandler(
+      SubeventCode::ENHANCED_CONNECTION_COMPLETE, hci_handler_->Bind([](LeMetaEventView /* view */) {}));
+  hci_->UnregisterLeEventHandler(SubeventCode::ENHANCED_CONNECTION_COMPLETE);
+  hci_->RegisterLeEventHandler(
+      SubeventCode::ENHANCED_CONNECTION_COMPLETE, hci_handler_->Bind([](LeMetaEventView /* view */) {}));
+  sync_handler();
+}
+
 TEST_F(HciLayerDeathTest, abort_on_second_register_le_event_handler) {
   ASSERT_DEATH(
       {
@@ -521,5 +550,62 @@ TEST_F(HciLayerTest, command_status_callback_is_invoked_with_failure_status) {
   sync_handler();
 }
 
+TEST_F(HciLayerPipeliningTest, reads_are_sent_without_waiting) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadBdAddrBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {
+    ASSERT_TRUE(ReadBdAddrCompleteView::Create(view).IsValid());
+  }));
+  hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {
+    ASSERT_TRUE(ReadBufferSizeCompleteView::Create(view).IsValid());
+  }));
+  // Depends on nothing, but is not a read, so it waits for both reads
+  hci_->EnqueueCommand(
+      WriteScanEnableBuilder::Create(ScanEnable::NO_SCANS), hci_handler_->BindOnce([](CommandCompleteView) {}));
+  sync_handler();
+
+  auto first = hal_->GetSentCommand();
+  ASSERT_TRUE(first.has_value());
+  ASSERT_EQ(OpCode::READ_BD_ADDR, first->GetOpCode());
+  auto second = hal_->GetSentCommand();
+  ASSERT_TRUE(second.has_value());
+  ASSERT_EQ(OpCode::READ_BUFFER_SIZE, second->GetOpCode());
+  ASSERT_FALSE(hal_->GetSentCommand(std::chrono::milliseconds(10)).has_value());
+
+  // Completions may come back in any order
+  hal_->InjectEvent(ReadBufferSizeCompleteBuilder::Create(2, ErrorCode::SUCCESS, 1021, 60, 8, 4));
+  sync_handler();
+  ASSERT_FALSE(hal_->GetSentCommand(std::chrono::milliseconds(10)).has_value());
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(2, ErrorCode::SUCCESS, Address::kEmpty));
+  sync_handler();
+
+  auto third = hal_->GetSentCommand();
+  ASSERT_TRUE(third.has_value());
+  ASSERT_EQ(OpCode::WRITE_SCAN_ENABLE, third->GetOpCode());
+  hal_->InjectEvent(WriteScanEnableCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  sync_handler();
+}
+
+TEST_F(HciLayerPipeliningTest, reads_wait_for_credits) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(1, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadBdAddrBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView) {}));
+  hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView) {}));
+  sync_handler();
+
+  auto first = hal_->GetSentCommand();
+  ASSERT_TRUE(first.has_value());
+  ASSERT_EQ(OpCode::READ_BD_ADDR, first->GetOpCode());
+  ASSERT_FALSE(hal_->GetSentCommand(std::chrono::milliseconds(10)).has_value());
+
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(1, ErrorCode::SUCCESS, Address::kEmpty));
+  sync_handler();
+  auto second = hal_->GetSentCommand();
+  ASSERT_TRUE(second.has_value());
+  ASSERT_EQ(OpCode::READ_BUFFER_SIZE, second->GetOpCode());
+  hal_->InjectEvent(ReadBufferSizeCompleteBuilder::Create(1, ErrorCode::SUCCESS, 1021, 60, 8, 4));
+  sync_handler();
+}
+
 }  // namespace hci
 }  // namespace bluetooth
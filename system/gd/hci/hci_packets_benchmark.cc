@@ -0,0 +1,125 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <forward_list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+using ::bluetooth::packet::kLittleEndian;
+using ::bluetooth::packet::PacketView;
+using ::bluetooth::packet::View;
+
+namespace bluetooth {
+namespace hci {
+
+static constexpr size_t kAdvertisingDataLength = 31;
+
+// HCI_Read_BD_ADDR command complete, as sent by the controller at start up.
+static const std::vector<uint8_t> kReadBdAddrComplete = {
+    0x0e, 0x0a, 0x01, 0x09, 0x10, 0x00, 0x14, 0x8e, 0x61, 0x5f, 0x36, 0x88};
+
+// HCI LE Extended Advertising Report holding one connectable advertisement.
+static std::vector<uint8_t> MakeExtendedAdvertisingReport() {
+  std::vector<uint8_t> report = {
+      0x3e, 0x00,                          // LE meta event, length set below
+      0x0d, 0x01,                          // Extended advertising report, one response
+      0x01, 0x00,                          // Connectable, complete
+      0x01,                                // Random device address
+      0x11, 0x22, 0x33, 0x44, 0x55, 0xc0,  // Address
+      0x01, 0x00,                          // LE 1M, no secondary PHY
+      0xff, 0x7f, 0xc8,                    // No ADI, no TX power, RSSI
+      0x00, 0x00,                          // No periodic advertising
+      0x00,                                // Direct address type
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Direct address
+      static_cast<uint8_t>(kAdvertisingDataLength),
+  };
+  for (size_t i = 0; i < kAdvertisingDataLength; i++) {
+    report.push_back(static_cast<uint8_t>(i * 31));
+  }
+  report[1] = static_cast<uint8_t>(report.size() - 2);
+  return report;
+}
+
+// ACL data packet with |payload_length| bytes of payload.
+static std::vector<uint8_t> MakeAclPacket(size_t payload_length) {
+  std::vector<uint8_t> packet = {0x01, 0x20, static_cast<uint8_t>(payload_length),
+                                 static_cast<uint8_t>(payload_length >> 8)};
+  packet.resize(packet.size() + payload_length, 0x5a);
+  return packet;
+}
+
+// Split |bytes| in two fragments, as reassembled packets are.
+static PacketView<kLittleEndian> MakeFragmentedView(const std::vector<uint8_t>& bytes) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(bytes);
+  size_t half = bytes.size() / 2;
+  return PacketView<kLittleEndian>(
+      std::forward_list<View>({View(buffer, 0, half), View(buffer, half, bytes.size())}));
+}
+
+static void BM_ParseReadBdAddrComplete(State& state) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>(kReadBdAddrComplete);
+  for (auto _ : state) {
+    auto view = ReadBdAddrCompleteView::Create(
+        CommandCompleteView::Create(EventView::Create(PacketView<kLittleEndian>(bytes))));
+    benchmark::DoNotOptimize(view.IsValid());
+    benchmark::DoNotOptimize(view.GetBdAddr());
+  }
+}
+BENCHMARK(BM_ParseReadBdAddrComplete);
+
+static void BM_ParseExtendedAdvertisingReport(State& state) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>(MakeExtendedAdvertisingReport());
+  for (auto _ : state) {
+    auto view = LeExtendedAdvertisingReportRawView::Create(
+        LeMetaEventView::Create(EventView::Create(PacketView<kLittleEndian>(bytes))));
+    benchmark::DoNotOptimize(view.IsValid());
+    benchmark::DoNotOptimize(view.GetResponses());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes->size()));
+}
+BENCHMARK(BM_ParseExtendedAdvertisingReport);
+
+static void BM_ParseExtendedAdvertisingReportFragmented(State& state) {
+  auto bytes = MakeExtendedAdvertisingReport();
+  auto packet = MakeFragmentedView(bytes);
+  for (auto _ : state) {
+    auto view = LeExtendedAdvertisingReportRawView::Create(LeMetaEventView::Create(EventView::Create(packet)));
+    benchmark::DoNotOptimize(view.IsValid());
+    benchmark::DoNotOptimize(view.GetResponses());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes.size()));
+}
+BENCHMARK(BM_ParseExtendedAdvertisingReportFragmented);
+
+static void BM_ParseAcl(State& state) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>(MakeAclPacket(state.range(0)));
+  for (auto _ : state) {
+    auto view = AclView::Create(PacketView<kLittleEndian>(bytes));
+    benchmark::DoNotOptimize(view.IsValid());
+    benchmark::DoNotOptimize(view.GetHandle());
+    benchmark::DoNotOptimize(view.GetPayload().size());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes->size()));
+}
+BENCHMARK(BM_ParseAcl)->Arg(27)->Arg(251)->Arg(1021);
+
+}  // namespace hci
+}  // namespace bluetooth
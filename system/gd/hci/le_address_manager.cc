@@ -20,6 +20,7 @@
 #include <com_android_bluetooth_flags.h>
 
 #include "common/init_flags.h"
+#include "common/metrics_registry.h"
 #include "hci/octets.h"
 #include "include/macros.h"
 #include "os/rand.h"
@@ -288,24 +289,118 @@ AddressWithType LeAddressManager::NewNonResolvableAddress() {
   return random_address;
 }
 
+uint8_t LeAddressManager::command_uses(CommandType command_type) {
+  switch (command_type) {
+    case CommandType::ROTATE_RANDOM_ADDRESS:
+    case CommandType::UPDATE_IRK:
+      return LeAddressManagerCallback::kUsesRandomAddress;
+    case CommandType::ADD_DEVICE_TO_ACCEPT_LIST:
+    case CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST:
+    case CommandType::CLEAR_ACCEPT_LIST:
+      return LeAddressManagerCallback::kUsesFilterAcceptList;
+    case CommandType::ADD_DEVICE_TO_RESOLVING_LIST:
+    case CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST:
+    case CommandType::CLEAR_RESOLVING_LIST:
+    case CommandType::SET_ADDRESS_RESOLUTION_ENABLE:
+    case CommandType::LE_SET_PRIVACY_MODE:
+      return LeAddressManagerCallback::kUsesResolvingList;
+  }
+  return LeAddressManagerCallback::kUsesAll;
+}
+
+// What the cached commands change, hence which clients they must wait for. Until the address policy
+// is set every client waits.
+uint8_t LeAddressManager::cached_commands_uses() {
+  if (address_policy_ == AddressPolicy::POLICY_NOT_SET || cached_commands_.empty()) {
+    return LeAddressManagerCallback::kUsesAll;
+  }
+  uint8_t uses = 0;
+  for (const auto& command : cached_commands_) {
+    uses |= command_uses(command.command_type);
+  }
+  return uses;
+}
+
+bool LeAddressManager::must_pause(LeAddressManagerCallback* callback, uint8_t uses) {
+  return (callback->GetAddressManagerUses() & uses) != 0;
+}
+
+void LeAddressManager::pause_client(LeAddressManagerCallback* callback, ClientState& state) {
+  static auto& pauses = common::MetricsRegistry::GetCounter("le_address_manager.pauses");
+  static auto& client_pauses = common::MetricsRegistry::GetCounter("le_address_manager.client_pauses");
+  if (!pausing_) {
+    pausing_ = true;
+    pause_start_ = std::chrono::steady_clock::now();
+    pauses.Add();
+  }
+  client_pauses.Add();
+  state = ClientState::WAITING_FOR_PAUSE;
+  callback->OnPause();
+}
+
 void LeAddressManager::pause_registered_clients() {
+  uint8_t uses = cached_commands_uses();
+  bool waiting_for_pause = false;
   for (auto& client : registered_clients_) {
     switch (client.second) {
       case ClientState::PAUSED:
+        break;
       case ClientState::WAITING_FOR_PAUSE:
+        waiting_for_pause = true;
         break;
       case ClientState::WAITING_FOR_RESUME:
       case ClientState::RESUMED:
-        client.second = ClientState::WAITING_FOR_PAUSE;
-        client.first->OnPause();
+        if (must_pause(client.first, uses)) {
+          waiting_for_pause = true;
+          pause_client(client.first, client.second);
+        }
         break;
     }
   }
+
+  // No client uses what the commands change, there will be no ack_pause() to send them
+  if (!waiting_for_pause && !command_in_flight_ && !cached_commands_.empty() &&
+      address_policy_ != AddressPolicy::POLICY_NOT_SET) {
+    handle_next_command();
+  }
 }
 
+// The commands are queued first, for pause_registered_clients() to pause the clients they affect
 void LeAddressManager::push_command(Command command) {
+  queue_command(std::move(command));
+  pause_registered_clients();
+}
+
+void LeAddressManager::push_commands(std::vector<Command> commands) {
+  for (auto& command : commands) {
+    queue_command(std::move(command));
+  }
   pause_registered_clients();
-  cached_commands_.push(std::move(command));
+}
+
+void LeAddressManager::queue_command(Command command) {
+  address_resolution_enable_queued_last_ = false;
+  window_uses_ |= command_uses(command.command_type);
+  cached_commands_.push_back(std::move(command));
+}
+
+void LeAddressManager::queue_resolving_list_commands(std::vector<Command> commands) {
+  // The resolving list may only change while address resolution is disabled. Changes queued back to
+  // back share one disabled window, instead of each disabling and re-enabling address resolution.
+  if (address_resolution_enable_queued_last_) {
+    cached_commands_.pop_back();
+  } else {
+    auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
+    queue_command({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}});
+  }
+
+  for (auto& command : commands) {
+    queue_command(std::move(command));
+  }
+
+  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
+  queue_command({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}});
+  address_resolution_enable_queued_last_ = true;
 }
 
 void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
@@ -314,7 +409,8 @@ void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
     return;
   }
   registered_clients_.find(callback)->second = ClientState::PAUSED;
-  for (auto client : registered_clients_) {
+  uint8_t uses = cached_commands_uses();
+  for (auto& client : registered_clients_) {
     switch (client.second) {
       case ClientState::PAUSED:
         log::verbose("Client already in paused state");
@@ -325,9 +421,11 @@ void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
         return;
       case ClientState::WAITING_FOR_RESUME:
       case ClientState::RESUMED:
+        if (!must_pause(client.first, uses)) {
+          break;
+        }
         log::warn("Trigger OnPause for client {}", ClientStateText(client.second));
-        client.second = ClientState::WAITING_FOR_PAUSE;
-        client.first->OnPause();
+        pause_client(client.first, client.second);
         return;
     }
   }
@@ -345,13 +443,30 @@ void LeAddressManager::resume_registered_clients() {
   }
 
   log::info("Resuming registered clients");
+  static auto& clients_not_paused =
+      common::MetricsRegistry::GetCounter("le_address_manager.clients_not_paused");
   for (auto& client : registered_clients_) {
+    if (client.second == ClientState::RESUMED && window_uses_ != 0 && !must_pause(client.first, window_uses_)) {
+      // Kept running, the commands changed nothing it uses
+      clients_not_paused.Add();
+      continue;
+    }
     if (client.second != ClientState::PAUSED) {
       log::warn("client is not paused {}", ClientStateText(client.second));
     }
     client.second = ClientState::WAITING_FOR_RESUME;
     client.first->OnResume();
   }
+
+  window_uses_ = 0;
+  if (pausing_) {
+    static auto& pause_durations =
+        common::MetricsRegistry::GetHistogram("le_address_manager.pause_duration");
+    pausing_ = false;
+    pause_durations.Add(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - pause_start_)
+                            .count());
+  }
 }
 
 void LeAddressManager::ack_resume(LeAddressManagerCallback* callback) {
@@ -364,7 +479,7 @@ void LeAddressManager::ack_resume(LeAddressManagerCallback* callback) {
 
 void LeAddressManager::prepare_to_rotate() {
   Command command = {CommandType::ROTATE_RANDOM_ADDRESS, RotateRandomAddressCommand{}};
-  cached_commands_.push(std::move(command));
+  queue_command(std::move(command));
   pause_registered_clients();
 }
 
@@ -405,7 +520,7 @@ void LeAddressManager::rotate_random_address() {
 
 void LeAddressManager::prepare_to_update_irk(UpdateIRKCommand update_irk_command) {
   Command command = {CommandType::UPDATE_IRK, update_irk_command};
-  cached_commands_.push(std::move(command));
+  queue_command(std::move(command));
   if (registered_clients_.empty()) {
     handle_next_command();
   } else {
@@ -496,8 +611,15 @@ uint8_t LeAddressManager::GetResolvingListSize() {
 }
 
 void LeAddressManager::handle_next_command() {
+  if (command_in_flight_) {
+    // the next command is sent by check_cached_commands() when this one completes
+    log::info("waiting for command complete, return");
+    return;
+  }
+
+  uint8_t uses = cached_commands_uses();
   for (auto client : registered_clients_) {
-    if (client.second != ClientState::PAUSED) {
+    if (client.second != ClientState::PAUSED && must_pause(client.first, uses)) {
       // make sure all client paused, if not, this function will be trigger again by ack_pause
       log::info("waiting for ack_pause, return");
       return;
@@ -506,7 +628,11 @@ void LeAddressManager::handle_next_command() {
 
   log::assert_that(!cached_commands_.empty(), "assert failed: !cached_commands_.empty()");
   auto command = std::move(cached_commands_.front());
-  cached_commands_.pop();
+  cached_commands_.pop_front();
+  if (cached_commands_.empty()) {
+    address_resolution_enable_queued_last_ = false;
+  }
+  command_in_flight_ = true;
 
   std::visit(
       [this](auto&& command) {
@@ -540,27 +666,18 @@ void LeAddressManager::AddDeviceToResolvingList(
     return;
   }
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
-
+  std::vector<Command> commands;
   auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
       peer_identity_address_type, peer_identity_address, peer_irk, local_irk);
-  Command command = {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+  commands.push_back({CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
 
   if (supports_ble_privacy_) {
     auto packet_builder =
         hci::LeSetPrivacyModeBuilder::Create(peer_identity_address_type, peer_identity_address, PrivacyMode::DEVICE);
-    Command command = {CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(packet_builder)}};
-    cached_commands_.push(std::move(command));
+    commands.push_back({CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(packet_builder)}});
   }
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+  queue_resolving_list_commands(std::move(commands));
 
   if (registered_clients_.empty()) {
     handler_->BindOnceOn(this, &LeAddressManager::handle_next_command)();
@@ -576,26 +693,38 @@ void LeAddressManager::RemoveDeviceFromFilterAcceptList(
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command))();
 }
 
+void LeAddressManager::UpdateFilterAcceptList(
+    const std::vector<AddressWithType>& to_remove, const std::vector<AddressWithType>& to_add) {
+  std::vector<Command> commands;
+  commands.reserve(to_remove.size() + to_add.size());
+  for (const auto& address_with_type : to_remove) {
+    auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(
+        address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    commands.push_back({CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+  }
+  for (const auto& address_with_type : to_add) {
+    auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(
+        address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    commands.push_back({CommandType::ADD_DEVICE_TO_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+  }
+  if (commands.empty()) {
+    return;
+  }
+  handler_->BindOnceOn(this, &LeAddressManager::push_commands, std::move(commands))();
+}
+
 void LeAddressManager::RemoveDeviceFromResolvingList(
     PeerAddressType peer_identity_address_type, Address peer_identity_address) {
   if (!supports_ble_privacy_) {
     return;
   }
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
-
+  std::vector<Command> commands;
   auto packet_builder =
       hci::LeRemoveDeviceFromResolvingListBuilder::Create(peer_identity_address_type, peer_identity_address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+  commands.push_back({CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+  queue_resolving_list_commands(std::move(commands));
 
   if (registered_clients_.empty()) {
     handler_->BindOnceOn(this, &LeAddressManager::handle_next_command)();
@@ -615,19 +744,11 @@ void LeAddressManager::ClearResolvingList() {
     return;
   }
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
-
+  std::vector<Command> commands;
   auto packet_builder = hci::LeClearResolvingListBuilder::Create();
-  Command command = {CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+  commands.push_back({CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+  queue_resolving_list_commands(std::move(commands));
 
   handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients)();
 }
@@ -657,6 +778,7 @@ void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView vie
   }
   auto op_code = view.GetCommandOpCode();
   log::info("Received command complete with op_code {}", OpCodeText(op_code));
+  command_in_flight_ = false;
 
   switch (op_code) {
     case OpCode::LE_SET_RANDOM_ADDRESS: {
@@ -724,8 +846,10 @@ void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView vie
 }
 
 void LeAddressManager::check_cached_commands() {
+  uint8_t uses = cached_commands_uses();
   for (auto client : registered_clients_) {
-    if (client.second != ClientState::PAUSED && !cached_commands_.empty()) {
+    if (client.second != ClientState::PAUSED && !cached_commands_.empty() &&
+        must_pause(client.first, uses)) {
       pause_registered_clients();
       return;
     }
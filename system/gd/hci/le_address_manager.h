@@ -17,8 +17,11 @@
 
 #include <bluetooth/log.h>
 
+#include <chrono>
+#include <deque>
 #include <map>
 #include <variant>
+#include <vector>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -32,10 +35,21 @@ constexpr std::chrono::milliseconds kUnregisterSyncTimeoutInMs = std::chrono::mi
 
 class LeAddressManagerCallback {
  public:
+  // What a client uses of the controller state the LeAddressManager changes. A client is only paused
+  // for the commands that change something it uses.
+  static constexpr uint8_t kUsesRandomAddress = 1 << 0;     // LE Set Random Address
+  static constexpr uint8_t kUsesFilterAcceptList = 1 << 1;  // Filter accept list
+  static constexpr uint8_t kUsesResolvingList = 1 << 2;     // Resolving list and address resolution
+  static constexpr uint8_t kUsesAll = kUsesRandomAddress | kUsesFilterAcceptList | kUsesResolvingList;
+
   virtual ~LeAddressManagerCallback() = default;
   virtual void OnPause() = 0;
   virtual void OnResume() = 0;
   virtual void NotifyOnIRKChange(){};
+  // Checked each time a command is queued, so the answer may change with the state of the client.
+  virtual uint8_t GetAddressManagerUses() {
+    return kUsesAll;
+  }
 };
 
 class LeAddressManager {
@@ -93,6 +107,10 @@ class LeAddressManager {
       const std::array<uint8_t, 16>& peer_irk,
       const std::array<uint8_t, 16>& local_irk);
   void RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType accept_list_address_type, Address address);
+  // Apply several filter accept list changes in a single pause/resume window. Removals are sent first, so
+  // that they free up controller entries for the additions.
+  void UpdateFilterAcceptList(
+      const std::vector<AddressWithType>& to_remove, const std::vector<AddressWithType>& to_add);
   void RemoveDeviceFromResolvingList(PeerAddressType peer_identity_address_type, Address peer_identity_address);
   void ClearFilterAcceptList();
   void ClearResolvingList();
@@ -139,12 +157,19 @@ class LeAddressManager {
   };
 
   struct Command {
-    CommandType command_type;  // Note that this field is only intended for logging, not control flow
+    CommandType command_type;  // For logging, and to find the clients that must pause for the command
     std::variant<RotateRandomAddressCommand, UpdateIRKCommand, HCICommand> contents;
   };
 
+  static uint8_t command_uses(CommandType command_type);
+  uint8_t cached_commands_uses();
+  bool must_pause(LeAddressManagerCallback* callback, uint8_t uses);
+  void pause_client(LeAddressManagerCallback* callback, ClientState& state);
   void pause_registered_clients();
   void push_command(Command command);
+  void push_commands(std::vector<Command> commands);
+  void queue_command(Command command);
+  void queue_resolving_list_commands(std::vector<Command> commands);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
   void ack_resume(LeAddressManagerCallback* callback);
@@ -174,8 +199,18 @@ class LeAddressManager {
   Octet16 rotation_irk_;
   uint8_t accept_list_size_;
   uint8_t resolving_list_size_;
-  std::queue<Command> cached_commands_;
+  std::deque<Command> cached_commands_;
+  // Whether the last command of cached_commands_ re-enables address resolution after resolving list
+  // changes, which the next resolving list change can then be queued before.
+  bool address_resolution_enable_queued_last_{false};
   bool supports_ble_privacy_{false};
+  // Whether a cached command was sent and its command complete has not been received yet
+  bool command_in_flight_{false};
+  // What the commands queued since the clients were last resumed change
+  uint8_t window_uses_{0};
+  // When the first client of the current pause was asked to pause
+  std::chrono::steady_clock::time_point pause_start_;
+  bool pausing_{false};
 };
 
 }  // namespace hci
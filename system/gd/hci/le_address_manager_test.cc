@@ -43,6 +43,7 @@ class RotatorClient : public LeAddressManagerCallback {
 
   void OnPause() {
     paused = true;
+    pause_count++;
     le_address_manager_->AckPause(this);
   }
 
@@ -65,7 +66,13 @@ class RotatorClient : public LeAddressManagerCallback {
     }
   }
 
+  uint8_t GetAddressManagerUses() override {
+    return uses;
+  }
+
   bool paused{false};
+  size_t pause_count{0};
+  uint8_t uses{kUsesAll};
   LeAddressManager* le_address_manager_;
   size_t id_;
   std::unique_ptr<std::promise<void>> resume_promise_;
@@ -174,6 +181,39 @@ TEST_F(LeAddressManagerTest, rotator_non_resolvable_address_for_single_client) {
   sync_handler(handler_);
 }
 
+TEST_F(LeAddressManagerTest, commands_not_used_by_any_client_are_sent_without_pause) {
+  Octet16 irk = {0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05, 0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b};
+  auto minimum_rotation_time = std::chrono::milliseconds(1000);
+  auto maximum_rotation_time = std::chrono::milliseconds(3000);
+  AddressWithType remote_address(Address::kEmpty, AddressType::RANDOM_DEVICE_ADDRESS);
+  le_address_manager_->SetPrivacyPolicyForInitiatorAddress(
+      LeAddressManager::AddressPolicy::USE_RESOLVABLE_ADDRESS,
+      remote_address,
+      irk,
+      false,
+      minimum_rotation_time,
+      maximum_rotation_time);
+
+  clients[0]->uses = LeAddressManagerCallback::kUsesResolvingList;
+  le_address_manager_->Register(clients[0].get());
+  sync_handler(handler_);
+  hci_layer_->GetCommand(OpCode::LE_SET_RANDOM_ADDRESS);
+  hci_layer_->IncomingEvent(LeSetRandomAddressCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0]->WaitForResume();
+
+  Address address;
+  Address::FromString("01:02:03:04:05:06", address);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  hci_layer_->IncomingEvent(
+      LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  sync_handler(handler_);
+  ASSERT_EQ(0u, clients[0]->pause_count);
+
+  le_address_manager_->Unregister(clients[0].get());
+  sync_handler(handler_);
+}
+
 // TODO handle the case "register during rotate_random_address" and enable this
 TEST_F(LeAddressManagerTest, DISABLED_rotator_address_for_multiple_clients) {
   AllocateClients(2);
@@ -485,6 +525,26 @@ TEST_F(LeAddressManagerWithSingleClientTest, register_during_command_complete) {
   clients[1].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, only_clients_using_the_accept_list_pause_for_it) {
+  AllocateClients(1);
+  clients[1]->uses = LeAddressManagerCallback::kUsesRandomAddress;
+  le_address_manager_->Register(clients[1].get());
+  sync_handler(handler_);
+
+  Address address;
+  Address::FromString("01:02:03:04:05:06", address);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_TRUE(clients[0]->paused);
+  hci_layer_->IncomingEvent(
+      LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0]->WaitForResume();
+  ASSERT_EQ(0u, clients[1]->pause_count);
+
+  le_address_manager_->Unregister(clients[1].get());
+  sync_handler(handler_);
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
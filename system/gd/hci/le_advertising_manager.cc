@@ -21,6 +21,7 @@
 #include <iterator>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include "common/init_flags.h"
 #include "common/strings.h"
@@ -35,6 +36,7 @@
 #include "os/handler.h"
 #include "os/log.h"
 #include "os/system_properties.h"
+#include "packet/bit_inserter.h"
 #include "packet/fragmenting_inserter.h"
 
 namespace bluetooth {
@@ -65,6 +67,13 @@ enum class AdvertisingFlag : uint8_t {
   SIMULTANEOUS_LE_AND_BR_EDR_HOST = 0x10,
 };
 
+/// The kinds of data an advertising set holds in the controller.
+enum class AdvertisingDataKind {
+  ADVERTISING,
+  SCAN_RESPONSE,
+  PERIODIC,
+};
+
 struct Advertiser {
   os::Handler* handler;
   AddressWithType current_address;
@@ -85,8 +94,41 @@ struct Advertiser {
   bool in_use = false;
   bool is_periodic = false;
   std::unique_ptr<os::Alarm> address_rotation_alarm;
+  // Serialized advertising, scan response and periodic advertising data
+  // last queued to the controller, used to skip updates that would not
+  // change it.
+  std::optional<std::vector<uint8_t>> advertising_data;
+  std::optional<std::vector<uint8_t>> scan_response_data;
+  std::optional<std::vector<uint8_t>> periodic_data;
+  // Number of data updates queued to the controller and not yet completed.
+  uint16_t pending_data_updates = 0;
+  // Data bytes sent to the controller, and not sent because they were
+  // unchanged, over the lifetime of the set.
+  uint64_t data_bytes_sent = 0;
+  uint64_t data_bytes_skipped = 0;
+
+  std::optional<std::vector<uint8_t>>& last_data(AdvertisingDataKind kind) {
+    switch (kind) {
+      case AdvertisingDataKind::SCAN_RESPONSE:
+        return scan_response_data;
+      case AdvertisingDataKind::PERIODIC:
+        return periodic_data;
+      case AdvertisingDataKind::ADVERTISING:
+      default:
+        return advertising_data;
+    }
+  }
 };
 
+static std::vector<uint8_t> serialize_gap_data(const std::vector<GapData>& data) {
+  std::vector<uint8_t> bytes;
+  packet::BitInserter it(bytes);
+  for (const auto& gap_data : data) {
+    gap_data.Serialize(it);
+  }
+  return bytes;
+}
+
 /**
  * Determines the address type to use, based on the requested type and the address manager policy,
  * by selecting the "strictest" of the two. Strictness is defined in ascending order as
@@ -395,6 +437,11 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
         advertising_sets_[advertiser_id].address_rotation_alarm.reset();
       }
     }
+    log::info(
+        "Advertiser {} sent {} bytes of data, skipped {} unchanged bytes",
+        advertiser_id,
+        advertising_sets_[advertiser_id].data_bytes_sent,
+        advertising_sets_[advertiser_id].data_bytes_skipped);
     advertising_sets_.erase(advertiser_id);
     if (advertising_sets_.empty() && address_manager_registered) {
       le_address_manager_->Unregister(this);
@@ -803,6 +850,10 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     advertising_sets_[advertiser_id].tx_power = config.tx_power;
     advertising_sets_[advertiser_id].directed = config.directed;
     advertising_sets_[advertiser_id].is_periodic = config.periodic_advertising_parameters.enable;
+    // The data is sent again after a parameter change, as the advertising
+    // type and TX power it depends on may have changed.
+    advertising_sets_[advertiser_id].advertising_data.reset();
+    advertising_sets_[advertiser_id].scan_response_data.reset();
 
     // based on logic in new_advertiser_address
     auto own_address_type = static_cast<OwnAddressType>(
@@ -1018,8 +1069,16 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       return;
     }
 
+    AdvertisingDataKind kind =
+        set_scan_rsp ? AdvertisingDataKind::SCAN_RESPONSE : AdvertisingDataKind::ADVERTISING;
+    std::vector<uint8_t> serialized_data = serialize_gap_data(data);
+    if (skip_unchanged_data(advertiser_id, kind, serialized_data)) {
+      return;
+    }
+
     switch (advertising_api_type_) {
       case (AdvertisingApiType::LEGACY): {
+        on_data_update_queued(advertiser_id, kind, std::move(serialized_data));
         if (set_scan_rsp) {
           le_advertising_interface_->EnqueueCommand(
               hci::LeSetScanResponseDataBuilder::Create(data),
@@ -1039,6 +1098,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
         }
       } break;
       case (AdvertisingApiType::ANDROID_HCI): {
+        on_data_update_queued(advertiser_id, kind, std::move(serialized_data));
         if (set_scan_rsp) {
           le_advertising_interface_->EnqueueCommand(
               hci::LeMultiAdvtSetScanRespBuilder::Create(data, advertiser_id),
@@ -1094,6 +1154,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
           return;
         }
 
+        on_data_update_queued(advertiser_id, kind, std::move(serialized_data));
         if (data_len <= kLeMaximumFragmentLength) {
           send_data_fragment(advertiser_id, set_scan_rsp, data, Operation::COMPLETE_ADVERTISEMENT);
         } else {
@@ -1136,6 +1197,59 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
+  /// Skip the update when the controller already has the same data, and no
+  /// other update is still in flight. Returns true if the update was skipped.
+  bool skip_unchanged_data(
+      AdvertiserId advertiser_id, AdvertisingDataKind kind, const std::vector<uint8_t>& data) {
+    auto& advertiser = advertising_sets_[advertiser_id];
+    if (advertiser.pending_data_updates != 0 || advertiser.last_data(kind) != data) {
+      return false;
+    }
+
+    log::debug("Skipping unchanged data for advertiser {}", advertiser_id);
+    advertiser.data_bytes_skipped += data.size();
+    if (advertising_callbacks_ == nullptr || !advertiser.started || id_map_[advertiser_id] == kIdLocal) {
+      return true;
+    }
+    switch (kind) {
+      case AdvertisingDataKind::ADVERTISING:
+        advertising_callbacks_->OnAdvertisingDataSet(
+            advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS);
+        break;
+      case AdvertisingDataKind::SCAN_RESPONSE:
+        advertising_callbacks_->OnScanResponseDataSet(
+            advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS);
+        break;
+      case AdvertisingDataKind::PERIODIC:
+        advertising_callbacks_->OnPeriodicAdvertisingDataSet(
+            advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS);
+        break;
+    }
+    return true;
+  }
+
+  void on_data_update_queued(AdvertiserId advertiser_id, AdvertisingDataKind kind, std::vector<uint8_t> data) {
+    auto& advertiser = advertising_sets_[advertiser_id];
+    advertiser.data_bytes_sent += data.size();
+    advertiser.last_data(kind) = std::move(data);
+    advertiser.pending_data_updates++;
+  }
+
+  void on_data_update_complete(AdvertiserId advertiser_id, AdvertisingDataKind kind, ErrorCode status) {
+    auto advertising_iter = advertising_sets_.find(advertiser_id);
+    if (advertising_iter == advertising_sets_.end()) {
+      return;
+    }
+    auto& advertiser = advertising_iter->second;
+    if (advertiser.pending_data_updates > 0) {
+      advertiser.pending_data_updates--;
+    }
+    // The controller state is unknown after a failure, always send the next update.
+    if (status != ErrorCode::SUCCESS) {
+      advertiser.last_data(kind).reset();
+    }
+  }
+
   void send_data_fragment(
       AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data, Operation operation) {
     if (com::android::bluetooth::flags::divide_long_single_gap_data()) {
@@ -1299,6 +1413,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       AdvertiserId advertiser_id, PeriodicAdvertisingParameters periodic_advertising_parameters) {
     uint8_t include_tx_power = periodic_advertising_parameters.properties >>
                                PeriodicAdvertisingParameters::AdvertisingProperty::INCLUDE_TX_POWER;
+    advertising_sets_[advertiser_id].periodic_data.reset();
 
     le_advertising_interface_->EnqueueCommand(
         hci::LeSetPeriodicAdvertisingParametersBuilder::Create(
@@ -1341,6 +1456,12 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       return;
     }
 
+    std::vector<uint8_t> serialized_data = serialize_gap_data(data);
+    if (skip_unchanged_data(advertiser_id, AdvertisingDataKind::PERIODIC, serialized_data)) {
+      return;
+    }
+    on_data_update_queued(advertiser_id, AdvertisingDataKind::PERIODIC, std::move(serialized_data));
+
     uint16_t data_fragment_limit =
         divide_gap_flag ? kLeMaximumPeriodicDataFragmentLength : kLeMaximumFragmentLength;
     if (data_len <= data_fragment_limit) {
@@ -1488,6 +1609,14 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     le_address_manager_->AckPause(this);
   }
 
+  uint8_t GetAddressManagerUses() override {
+    // Extended advertising sets have random addresses of their own
+    if (advertising_api_type_ == AdvertisingApiType::EXTENDED) {
+      return kUsesFilterAcceptList | kUsesResolvingList;
+    }
+    return kUsesAll;
+  }
+
   void OnResume() override {
     if (!address_manager_registered) {
       log::warn("Unregistered!");
@@ -1766,6 +1895,33 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       advertising_status = AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR;
     }
 
+    // Only the last command of a data update sends the callback.
+    if (send_callback) {
+      switch (view.GetCommandOpCode()) {
+        case OpCode::LE_SET_ADVERTISING_DATA:
+        case OpCode::LE_SET_EXTENDED_ADVERTISING_DATA:
+          on_data_update_complete(id, AdvertisingDataKind::ADVERTISING, status_view.GetStatus());
+          break;
+        case OpCode::LE_SET_SCAN_RESPONSE_DATA:
+        case OpCode::LE_SET_EXTENDED_SCAN_RESPONSE_DATA:
+          on_data_update_complete(id, AdvertisingDataKind::SCAN_RESPONSE, status_view.GetStatus());
+          break;
+        case OpCode::LE_SET_PERIODIC_ADVERTISING_DATA:
+          on_data_update_complete(id, AdvertisingDataKind::PERIODIC, status_view.GetStatus());
+          break;
+        case OpCode::LE_MULTI_ADVT: {
+          auto command_view = LeMultiAdvtCompleteView::Create(view);
+          if (command_view.IsValid() && command_view.GetSubCmd() == SubOcf::SET_DATA) {
+            on_data_update_complete(id, AdvertisingDataKind::ADVERTISING, status_view.GetStatus());
+          } else if (command_view.IsValid() && command_view.GetSubCmd() == SubOcf::SET_SCAN_RESP) {
+            on_data_update_complete(id, AdvertisingDataKind::SCAN_RESPONSE, status_view.GetStatus());
+          }
+        } break;
+        default:
+          break;
+      }
+    }
+
     // Do not trigger callback if the advertiser not stated yet, or the advertiser is not register
     // from Java layer
     if (advertising_callbacks_ == nullptr || !advertising_sets_[id].started || id_map_[id] == kIdLocal) {
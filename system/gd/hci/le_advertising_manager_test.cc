@@ -1157,6 +1157,57 @@ TEST_F(LeExtendedAdvertisingAPITest, set_data_test) {
   test_hci_layer_->IncomingEvent(LeSetExtendedScanResponseDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
 }
 
+TEST_F(LeExtendedAdvertisingAPITest, set_unchanged_data_test) {
+  std::vector<GapData> advertising_data{};
+  GapData data_item{};
+  data_item.data_type_ = GapDataType::COMPLETE_LOCAL_NAME;
+  data_item.data_ = {'t', 'e', 's', 't'};
+  advertising_data.push_back(data_item);
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS))
+      .Times(3);
+
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // The controller already has this data, it is not sent again.
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data);
+  sync_client_handler();
+  test_hci_layer_->AssertNoQueuedCommand();
+
+  // Changed data is sent.
+  advertising_data[0].data_.push_back('2');
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+}
+
+TEST_F(LeExtendedAdvertisingAPITest, set_data_after_failure_test) {
+  std::vector<GapData> advertising_data{};
+  GapData data_item{};
+  data_item.data_type_ = GapDataType::COMPLETE_LOCAL_NAME;
+  data_item.data_ = {'t', 'e', 's', 't'};
+  advertising_data.push_back(data_item);
+
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR));
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(
+      LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::UNSPECIFIED_ERROR));
+
+  // The same data is sent again after a failure.
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  le_advertising_manager_->SetData(advertiser_id_, false, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+}
+
 TEST_F(LeAndroidHciAdvertisingAPITest, set_data_test) {
   // Set advertising data
   std::vector<GapData> advertising_data{};
@@ -1556,6 +1607,34 @@ TEST_F(LeExtendedAdvertisingAPITest, set_periodic_data_test) {
   sync_client_handler();
 }
 
+TEST_F(LeExtendedAdvertisingAPITest, set_unchanged_periodic_data_test) {
+  std::vector<GapData> advertising_data{};
+  GapData data_item{};
+  data_item.data_type_ = GapDataType::TX_POWER_LEVEL;
+  data_item.data_ = {0x00};
+  advertising_data.push_back(data_item);
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnPeriodicAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS))
+      .Times(3);
+
+  le_advertising_manager_->SetPeriodicData(advertiser_id_, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_PERIODIC_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetPeriodicAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // The controller already has this data, it is not sent again.
+  le_advertising_manager_->SetPeriodicData(advertiser_id_, advertising_data);
+  sync_client_handler();
+  test_hci_layer_->AssertNoQueuedCommand();
+
+  // Changed data is sent.
+  advertising_data[0].data_ = {0x01};
+  le_advertising_manager_->SetPeriodicData(advertiser_id_, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_PERIODIC_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetPeriodicAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  sync_client_handler();
+}
+
 TEST_F(LeExtendedAdvertisingAPITest, set_periodic_data_fragments_test) {
   // Set advertising data
   std::vector<GapData> advertising_data{};
@@ -18,7 +18,9 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <chrono>
+#include <map>
 #include <memory>
 #include <utility>
 
@@ -40,6 +42,7 @@ namespace hci {
 
 constexpr std::chrono::duration kPeriodicSyncTimeout = std::chrono::seconds(5);
 constexpr int kMaxSyncTransactions = 16;
+constexpr size_t kMaxPeriodicAdvertiserHints = 64;
 
 enum PeriodicSyncState : int {
   PERIODIC_SYNC_STATE_IDLE = 0,
@@ -61,6 +64,12 @@ struct PeriodicSyncStates {
   PeriodicSyncState sync_state;
 };
 
+// Last values seen in the extended advertising reports of a periodic advertiser
+struct PeriodicAdvertiserHint {
+  uint16_t periodic_advertising_interval;
+  int8_t rssi;
+};
+
 struct PendingPeriodicSyncRequest {
   PendingPeriodicSyncRequest(
       uint8_t advertiser_sid,
@@ -115,6 +124,31 @@ class PeriodicSyncManager {
     HandleNextRequest();
   }
 
+  // Called for the extended advertising reports announcing a periodic advertising train, the
+  // interval and the RSSI are used to order the pending sync requests.
+  void OnPeriodicAdvertiserSeen(
+      const Address& address, uint8_t advertiser_sid, int8_t rssi, uint16_t periodic_advertising_interval) {
+    if (periodic_advertising_interval == 0) {
+      return;
+    }
+    auto key = std::make_pair(address, advertiser_sid);
+    auto it = advertiser_hints_.find(key);
+    if (it == advertiser_hints_.end()) {
+      if (advertiser_hints_.size() >= kMaxPeriodicAdvertiserHints) {
+        // Prefer the hints of the pending requests, any other one can go
+        auto victim = std::find_if(advertiser_hints_.begin(), advertiser_hints_.end(), [this](const auto& hint) {
+          return GetPendingSyncFromAddressAndSid(hint.first.first, hint.first.second) ==
+                 pending_sync_requests_.end();
+        });
+        advertiser_hints_.erase(victim != advertiser_hints_.end() ? victim : advertiser_hints_.begin());
+      }
+      advertiser_hints_.emplace(key, PeriodicAdvertiserHint{periodic_advertising_interval, rssi});
+      return;
+    }
+    it->second.periodic_advertising_interval = periodic_advertising_interval;
+    it->second.rssi = rssi;
+  }
+
   void StopSync(uint16_t handle) {
     log::debug("[PSync]: handle = {}", handle);
     auto periodic_sync = GetEstablishedSyncFromHandle(handle);
@@ -315,6 +349,14 @@ class PeriodicSyncManager {
       pending_sync_request->sync_timeout_alarm.Cancel();
     }
 
+    if (event_view.GetStatus() == ErrorCode::SUCCESS) {
+      auto hint =
+          advertiser_hints_.find(std::make_pair(event_view.GetAdvertiserAddress(), event_view.GetAdvertisingSid()));
+      if (hint != advertiser_hints_.end()) {
+        hint->second.periodic_advertising_interval = event_view.GetPeriodicAdvertisingInterval();
+      }
+    }
+
     auto address_with_type = AddressWithType(event_view.GetAdvertiserAddress(), event_view.GetAdvertiserAddressType());
     auto peer_address_type = address_with_type.GetAddressType();
     AddressType temp_address_type;
@@ -567,11 +609,42 @@ class PeriodicSyncManager {
                 LePeriodicAdvertisingCreateSyncStatusView>));
   }
 
+  // The controller takes a single create sync at a time, so the requests are served one after
+  // the other. The advertisers with the shortest periodic advertising interval go first since
+  // they sync the fastest, then the ones heard with the strongest signal. The requests without
+  // hint keep their order, after the others.
+  bool HasPriorityOver(const PendingPeriodicSyncRequest& a, const PendingPeriodicSyncRequest& b) const {
+    auto hint_a = advertiser_hints_.find(std::make_pair(a.address_with_type.GetAddress(), a.advertiser_sid));
+    auto hint_b = advertiser_hints_.find(std::make_pair(b.address_with_type.GetAddress(), b.advertiser_sid));
+    if (hint_a == advertiser_hints_.end()) {
+      return false;
+    }
+    if (hint_b == advertiser_hints_.end()) {
+      return true;
+    }
+    if (hint_a->second.periodic_advertising_interval != hint_b->second.periodic_advertising_interval) {
+      return hint_a->second.periodic_advertising_interval < hint_b->second.periodic_advertising_interval;
+    }
+    return hint_a->second.rssi > hint_b->second.rssi;
+  }
+
   void HandleNextRequest() {
     if (pending_sync_requests_.empty()) {
       log::debug("pending_sync_requests_ empty");
       return;
     }
+    // The request in progress is always the front one, pick the next one otherwise
+    if (!pending_sync_requests_.front().busy) {
+      auto next = std::min_element(
+          pending_sync_requests_.begin(),
+          pending_sync_requests_.end(),
+          [this](const PendingPeriodicSyncRequest& a, const PendingPeriodicSyncRequest& b) {
+            return HasPriorityOver(a, b);
+          });
+      if (next != pending_sync_requests_.begin()) {
+        pending_sync_requests_.splice(pending_sync_requests_.begin(), pending_sync_requests_, next);
+      }
+    }
     auto& request = pending_sync_requests_.front();
     log::info(
         "executing sync request SID={:04X}, bd_addr={}",
@@ -621,6 +694,7 @@ class PeriodicSyncManager {
   std::list<PendingPeriodicSyncRequest> pending_sync_requests_;
   std::list<PeriodicSyncStates> periodic_syncs_;
   std::list<PeriodicSyncTransferStates> periodic_sync_transfers_;
+  std::map<std::pair<Address, uint8_t>, PeriodicAdvertiserHint> advertiser_hints_;
   LeScanningReassembler scanning_reassembler_;
   bool sync_received_callback_registered_ = false;
   int sync_received_callback_id{};
@@ -420,6 +420,83 @@ TEST_F(PeriodicSyncManagerTest, cancel_create_sync_test) {
   sync_handler();
 }
 
+TEST_F(PeriodicSyncManagerTest, start_sync_order_test) {
+  Address address_1, address_2, address_3;
+  Address::FromString("00:11:22:33:44:55", address_1);
+  Address::FromString("00:11:22:33:44:66", address_2);
+  Address::FromString("00:11:22:33:44:77", address_3);
+  uint8_t advertiser_sid = 0x02;
+  AddressWithType address_with_type_1 = AddressWithType(address_1, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType address_with_type_2 = AddressWithType(address_2, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType address_with_type_3 = AddressWithType(address_3, AddressType::PUBLIC_DEVICE_ADDRESS);
+
+  // The third advertiser has the shortest interval, the second one is heard the loudest
+  periodic_sync_manager_->OnPeriodicAdvertiserSeen(address_2, advertiser_sid, -40, 0x0100);
+  periodic_sync_manager_->OnPeriodicAdvertiserSeen(address_3, advertiser_sid, -80, 0x0040);
+
+  // The first request goes out right away
+  ASSERT_NO_FATAL_FAILURE(test_le_scanning_interface_->SetCommandFuture());
+  periodic_sync_manager_->StartSync(
+      PeriodicSyncStates{
+          .request_id = 0x01,
+          .advertiser_sid = advertiser_sid,
+          .address_with_type = address_with_type_1,
+          .sync_handle = 0x11,
+          .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+      },
+      0x04,
+      0x0A);
+  auto packet = test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  auto packet_view = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address_1, packet_view.GetAdvertiserAddress());
+  test_le_scanning_interface_->CommandStatusCallback(
+      LePeriodicAdvertisingCreateSyncStatusBuilder::Create(ErrorCode::SUCCESS, 0x00));
+
+  // The next ones wait for the first one to complete
+  periodic_sync_manager_->StartSync(
+      PeriodicSyncStates{
+          .request_id = 0x02,
+          .advertiser_sid = advertiser_sid,
+          .address_with_type = address_with_type_2,
+          .sync_handle = 0x12,
+          .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+      },
+      0x04,
+      0x0A);
+  periodic_sync_manager_->StartSync(
+      PeriodicSyncStates{
+          .request_id = 0x03,
+          .advertiser_sid = advertiser_sid,
+          .address_with_type = address_with_type_3,
+          .sync_handle = 0x13,
+          .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+      },
+      0x04,
+      0x0A);
+
+  // Once the first sync is established, the advertiser with the shortest interval comes next
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted);
+  ASSERT_NO_FATAL_FAILURE(test_le_scanning_interface_->SetCommandFuture());
+  auto builder = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      ErrorCode::SUCCESS,
+      0x11,
+      advertiser_sid,
+      address_with_type_1.GetAddressType(),
+      address_1,
+      SecondaryPhyType::LE_1M,
+      0xFF,
+      ClockAccuracy::PPM_250);
+  auto event_view = LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder)))));
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(event_view);
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  packet_view = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address_3, packet_view.GetAdvertiserAddress());
+  sync_handler();
+}
+
 TEST_F(PeriodicSyncManagerTest, transfer_sync_test) {
   Address address;
   Address::FromString("00:11:22:33:44:55", address);
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_deduplicator.h"
+
+#include <cstdlib>
+#include <functional>
+#include <string_view>
+
+namespace bluetooth::hci {
+
+namespace {
+
+uint64_t hash_combine(uint64_t seed, uint64_t value) {
+  return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+uint64_t report_key(
+    uint16_t event_type,
+    uint8_t address_type,
+    const Address& address,
+    uint8_t advertising_sid,
+    std::span<const uint8_t> advertising_data) {
+  uint64_t key = 0;
+  for (uint8_t byte : address.address) {
+    key = (key << 8) | byte;
+  }
+  key = hash_combine(key, (uint64_t{event_type} << 16) | (uint64_t{address_type} << 8) | advertising_sid);
+  return hash_combine(
+      key,
+      std::hash<std::string_view>{}(std::string_view(
+          reinterpret_cast<const char*>(advertising_data.data()), advertising_data.size())));
+}
+
+}  // namespace
+
+void LeScanningDeduplicator::SetEnabled(bool enabled) {
+  enabled_ = enabled;
+  if (!enabled_) {
+    cache_.clear();
+  }
+}
+
+bool LeScanningDeduplicator::ShouldReport(
+    uint16_t event_type,
+    uint8_t address_type,
+    const Address& address,
+    uint8_t advertising_sid,
+    int8_t rssi,
+    std::span<const uint8_t> advertising_data,
+    std::chrono::steady_clock::time_point now) {
+  if (!enabled_) {
+    return true;
+  }
+
+  uint64_t key = report_key(event_type, address_type, address, advertising_sid, advertising_data);
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
+    cache_.insert_or_assign(key, LastReport{.time = now, .rssi = rssi});
+    return true;
+  }
+
+  LastReport& last = it->second;
+  bool interval_elapsed =
+      policy_.report_interval.count() != 0 && now - last.time >= policy_.report_interval;
+  bool rssi_changed = policy_.rssi_delta != 0 && std::abs(rssi - last.rssi) >= policy_.rssi_delta;
+  if (!interval_elapsed && !rssi_changed) {
+    suppressed_count_++;
+    return false;
+  }
+
+  last = LastReport{.time = now, .rssi = rssi};
+  return true;
+}
+
+}  // namespace bluetooth::hci
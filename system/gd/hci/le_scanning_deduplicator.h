@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "common/lru_cache.h"
+#include "hci/address.h"
+
+namespace bluetooth::hci {
+
+/// Suppresses repeated scan results from the same advertiser.
+///
+/// Reports are keyed on the advertiser address, address type, SID, event
+/// type and a hash of the complete advertising data, so a change of the
+/// advertised content is always reported. An unchanged advertisement is
+/// reported again only as allowed by the Policy.
+///
+/// Upper layers that detect lost advertisers from the absence of reports
+/// need a non zero report interval shorter than their timeout.
+class LeScanningDeduplicator {
+ public:
+  struct Policy {
+    /// Report an unchanged advertisement again once this much time has
+    /// passed since it was last reported. Zero never reports it again.
+    std::chrono::milliseconds report_interval{0};
+    /// Report an unchanged advertisement again when its RSSI moved by at
+    /// least this many dB since it was last reported. Zero disables this.
+    uint8_t rssi_delta{0};
+  };
+
+  static constexpr size_t kDefaultCapacity = 256;
+
+  explicit LeScanningDeduplicator(size_t capacity = kDefaultCapacity) : cache_(capacity) {}
+
+  LeScanningDeduplicator(const LeScanningDeduplicator&) = delete;
+
+  LeScanningDeduplicator& operator=(const LeScanningDeduplicator&) = delete;
+
+  /// Enable or disable suppression. When disabled, all reports are
+  /// delivered and nothing is cached.
+  void SetEnabled(bool enabled);
+
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  void SetPolicy(Policy policy) {
+    policy_ = policy;
+  }
+
+  /// Forget all advertisers, e.g. when a new scan is started.
+  void Clear() {
+    cache_.clear();
+  }
+
+  /// Returns true if the report should be delivered to the upper layers.
+  bool ShouldReport(
+      uint16_t event_type,
+      uint8_t address_type,
+      const Address& address,
+      uint8_t advertising_sid,
+      int8_t rssi,
+      std::span<const uint8_t> advertising_data,
+      std::chrono::steady_clock::time_point now);
+
+  /// Number of reports suppressed since creation.
+  uint64_t GetSuppressedCount() const {
+    return suppressed_count_;
+  }
+
+ private:
+  struct LastReport {
+    std::chrono::steady_clock::time_point time;
+    int8_t rssi;
+  };
+
+  bool enabled_{false};
+  Policy policy_;
+  common::FlatLruCache<uint64_t, LastReport> cache_;
+  uint64_t suppressed_count_{0};
+};
+
+}  // namespace bluetooth::hci
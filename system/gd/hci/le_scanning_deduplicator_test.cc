@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_deduplicator.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+static constexpr uint16_t kEventType = 0x13;
+static constexpr uint8_t kAddressType = 0x00;
+static constexpr uint8_t kSidNotPresent = 0xff;
+static const std::vector<uint8_t> kAdvertisingData = {0x02, 0x01, 0x06};
+static const std::vector<uint8_t> kOtherAdvertisingData = {0x02, 0x01, 0x04};
+
+class LeScanningDeduplicatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    deduplicator_.SetEnabled(true);
+  }
+
+  bool report(
+      const Address& address,
+      const std::vector<uint8_t>& data,
+      int8_t rssi = -60,
+      std::chrono::milliseconds elapsed = 0ms) {
+    return deduplicator_.ShouldReport(
+        kEventType, kAddressType, address, kSidNotPresent, rssi, data, start_ + elapsed);
+  }
+
+  LeScanningDeduplicator deduplicator_{4};
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+TEST_F(LeScanningDeduplicatorTest, disabled_reports_everything) {
+  deduplicator_.SetEnabled(false);
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData));
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData));
+  ASSERT_EQ(deduplicator_.GetSuppressedCount(), 0u);
+}
+
+TEST_F(LeScanningDeduplicatorTest, report_on_change) {
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData));
+  ASSERT_FALSE(report(kTestAddress, kAdvertisingData));
+  ASSERT_TRUE(report(kTestAddress, kOtherAdvertisingData));
+  ASSERT_TRUE(report(kOtherAddress, kAdvertisingData));
+  ASSERT_EQ(deduplicator_.GetSuppressedCount(), 1u);
+}
+
+TEST_F(LeScanningDeduplicatorTest, report_interval) {
+  deduplicator_.SetPolicy({.report_interval = 100ms, .rssi_delta = 0});
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData));
+  ASSERT_FALSE(report(kTestAddress, kAdvertisingData, -60, 50ms));
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData, -60, 100ms));
+  ASSERT_FALSE(report(kTestAddress, kAdvertisingData, -60, 150ms));
+}
+
+TEST_F(LeScanningDeduplicatorTest, report_on_rssi_delta) {
+  deduplicator_.SetPolicy({.report_interval = 0ms, .rssi_delta = 10});
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData, -60));
+  ASSERT_FALSE(report(kTestAddress, kAdvertisingData, -65));
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData, -70));
+  ASSERT_FALSE(report(kTestAddress, kAdvertisingData, -61));
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData, -60));
+}
+
+TEST_F(LeScanningDeduplicatorTest, clear) {
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData));
+  deduplicator_.Clear();
+  ASSERT_TRUE(report(kTestAddress, kAdvertisingData));
+}
+
+TEST_F(LeScanningDeduplicatorTest, cache_is_bounded) {
+  for (uint8_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(report(kTestAddress, {0x02, 0x01, i}));
+  }
+  // The first advertisement was evicted.
+  ASSERT_TRUE(report(kTestAddress, {0x02, 0x01, 0x00}));
+  ASSERT_FALSE(report(kTestAddress, {0x02, 0x01, 0x04}));
+}
+
+}  // namespace bluetooth::hci
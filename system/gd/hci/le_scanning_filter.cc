@@ -0,0 +1,375 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_filter.h"
+
+#include <bluetooth/log.h>
+
+#include <algorithm>
+
+namespace bluetooth::hci {
+
+namespace {
+
+// GAP Data types, Assigned Numbers 2.3.
+constexpr uint8_t kIncomplete16BitUuids = 0x02;
+constexpr uint8_t kComplete16BitUuids = 0x03;
+constexpr uint8_t kIncomplete32BitUuids = 0x04;
+constexpr uint8_t kComplete32BitUuids = 0x05;
+constexpr uint8_t kIncomplete128BitUuids = 0x06;
+constexpr uint8_t kComplete128BitUuids = 0x07;
+constexpr uint8_t kShortenedLocalName = 0x08;
+constexpr uint8_t kCompleteLocalName = 0x09;
+constexpr uint8_t kSolicitation16BitUuids = 0x14;
+constexpr uint8_t kSolicitation128BitUuids = 0x15;
+constexpr uint8_t kServiceData16BitUuid = 0x16;
+constexpr uint8_t kSolicitation32BitUuids = 0x1f;
+constexpr uint8_t kServiceData32BitUuid = 0x20;
+constexpr uint8_t kServiceData128BitUuid = 0x21;
+constexpr uint8_t kTransportDiscoveryData = 0x26;
+constexpr uint8_t kManufacturerSpecificData = 0xff;
+
+// Offset of the 16 and 32 bit UUID values in the little endian 128 bit
+// representation of a UUID derived from the Bluetooth base UUID.
+constexpr size_t kShortUuidOffsetIn128Bit = 12;
+
+std::vector<uint8_t> uuid_to_le_bytes(const Uuid& uuid, size_t length) {
+  std::vector<uint8_t> bytes;
+  if (length == Uuid::kNumBytes16) {
+    uint16_t value = uuid.As16Bit();
+    bytes = {(uint8_t)value, (uint8_t)(value >> 8)};
+  } else if (length == Uuid::kNumBytes32) {
+    uint32_t value = uuid.As32Bit();
+    bytes = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  } else {
+    auto value = uuid.To128BitLE();
+    bytes.assign(value.begin(), value.end());
+  }
+  return bytes;
+}
+
+bool is_empty_irk(const std::array<uint8_t, 16>& irk) {
+  return std::all_of(irk.begin(), irk.end(), [](uint8_t byte) { return byte == 0; });
+}
+
+// Default to an exact match when no mask was given.
+std::vector<uint8_t> mask_or_default(const std::vector<uint8_t>& mask, size_t length) {
+  return mask.empty() ? std::vector<uint8_t>(length, 0xff) : mask;
+}
+
+bool masked_prefix_match(
+    const uint8_t* data, size_t length, const std::vector<uint8_t>& value, const std::vector<uint8_t>& mask) {
+  if (length < value.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < value.size(); i++) {
+    if ((data[i] & mask[i]) != (value[i] & mask[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+void LeScanningFilter::AddFilterIndex(uint8_t filter_index, int8_t rssi_threshold) {
+  filters_[filter_index] = Filter{.rssi_threshold = rssi_threshold, .conditions = {}};
+}
+
+void LeScanningFilter::RemoveFilterIndex(uint8_t filter_index) {
+  filters_.erase(filter_index);
+}
+
+void LeScanningFilter::ClearFilterIndices() {
+  filters_.clear();
+}
+
+void LeScanningFilter::AddFilters(
+    uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& filters) {
+  auto it = filters_.find(filter_index);
+  if (it == filters_.end()) {
+    log::warn("Filter index {} was not set up", filter_index);
+    return;
+  }
+
+  for (const auto& filter : filters) {
+    if (filter.data.size() != filter.data_mask.size() && !filter.data.empty() && !filter.data_mask.empty()) {
+      log::error("data and data_mask are of different size");
+      continue;
+    }
+
+    FilterTypeCondition& condition = it->second.conditions[filter.filter_type];
+    switch (filter.filter_type) {
+      case ApcfFilterType::BROADCASTER_ADDRESS:
+        // Resolvable private addresses can not be matched without
+        // resolving them, so let them through.
+        if (!is_empty_irk(filter.irk)) {
+          condition.match_any_address = true;
+        } else {
+          condition.addresses.push_back(filter.address);
+        }
+        break;
+      case ApcfFilterType::SERVICE_UUID:
+      case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+        CompileUuidFilter(condition, filter.filter_type, filter.uuid, filter.uuid_mask);
+        break;
+      case ApcfFilterType::LOCAL_NAME:
+        AddPattern(
+            condition,
+            {kShortenedLocalName, kCompleteLocalName},
+            0,
+            filter.name,
+            std::vector<uint8_t>(filter.name.size(), 0xff));
+        break;
+      case ApcfFilterType::MANUFACTURER_DATA: {
+        uint16_t company_mask = filter.company_mask != 0 ? filter.company_mask : 0xffff;
+        std::vector<uint8_t> value = {(uint8_t)filter.company, (uint8_t)(filter.company >> 8)};
+        std::vector<uint8_t> mask = {(uint8_t)company_mask, (uint8_t)(company_mask >> 8)};
+        auto data_mask = mask_or_default(filter.data_mask, filter.data.size());
+        value.insert(value.end(), filter.data.begin(), filter.data.end());
+        mask.insert(mask.end(), data_mask.begin(), data_mask.begin() + filter.data.size());
+        AddPattern(condition, {kManufacturerSpecificData}, 0, value, mask);
+        break;
+      }
+      case ApcfFilterType::SERVICE_DATA:
+        AddPattern(
+            condition,
+            {kServiceData16BitUuid, kServiceData32BitUuid, kServiceData128BitUuid},
+            0,
+            filter.data,
+            mask_or_default(filter.data_mask, filter.data.size()));
+        break;
+      case ApcfFilterType::TRANSPORT_DISCOVERY_DATA:
+        // Only the organization id and flags are compared; the transport
+        // data is left to the application.
+        AddPattern(
+            condition,
+            {kTransportDiscoveryData},
+            0,
+            {filter.org_id, filter.tds_flags},
+            {0xff, filter.tds_flags_mask});
+        break;
+      case ApcfFilterType::AD_TYPE:
+        AddPattern(
+            condition, {filter.ad_type}, 0, filter.data, mask_or_default(filter.data_mask, filter.data.size()));
+        break;
+      default:
+        log::error("Unknown filter type: {}", (uint16_t)filter.filter_type);
+        it->second.conditions.erase(filter.filter_type);
+        break;
+    }
+  }
+}
+
+void LeScanningFilter::CompileUuidFilter(
+    FilterTypeCondition& condition, ApcfFilterType filter_type, Uuid uuid, Uuid uuid_mask) {
+  size_t uuid_len = uuid.GetShortestRepresentationSize();
+  if (uuid_len != Uuid::kNumBytes16 && uuid_len != Uuid::kNumBytes32 && uuid_len != Uuid::kNumBytes128) {
+    log::error("illegal UUID length: {}", (uint16_t)uuid_len);
+    return;
+  }
+
+  bool solicitation = filter_type == ApcfFilterType::SERVICE_SOLICITATION_UUID;
+  std::vector<uint8_t> list_16 = {kIncomplete16BitUuids, kComplete16BitUuids};
+  std::vector<uint8_t> list_32 = {kIncomplete32BitUuids, kComplete32BitUuids};
+  std::vector<uint8_t> list_128 = {kIncomplete128BitUuids, kComplete128BitUuids};
+  if (solicitation) {
+    list_16 = {kSolicitation16BitUuids};
+    list_32 = {kSolicitation32BitUuids};
+    list_128 = {kSolicitation128BitUuids};
+  }
+
+  std::vector<uint8_t> value = uuid_to_le_bytes(uuid, uuid_len);
+  std::vector<uint8_t> mask =
+      uuid_mask.IsEmpty() ? std::vector<uint8_t>(uuid_len, 0xff) : uuid_to_le_bytes(uuid_mask, uuid_len);
+
+  // The advertiser may use a longer representation than the filter, so
+  // match the filter against every list that can hold the UUID.
+  if (uuid_len == Uuid::kNumBytes16) {
+    AddPattern(condition, list_16, Uuid::kNumBytes16, value, mask);
+
+    std::vector<uint8_t> value_32 = value;
+    std::vector<uint8_t> mask_32 = mask;
+    value_32.insert(value_32.end(), {0x00, 0x00});
+    mask_32.insert(mask_32.end(), {0xff, 0xff});
+    AddPattern(condition, list_32, Uuid::kNumBytes32, value_32, mask_32);
+  } else if (uuid_len == Uuid::kNumBytes32) {
+    AddPattern(condition, list_32, Uuid::kNumBytes32, value, mask);
+  }
+
+  std::vector<uint8_t> value_128 = uuid_to_le_bytes(uuid, Uuid::kNumBytes128);
+  std::vector<uint8_t> mask_128(Uuid::kNumBytes128, 0xff);
+  size_t offset = uuid_len == Uuid::kNumBytes128 ? 0 : kShortUuidOffsetIn128Bit;
+  std::copy(mask.begin(), mask.end(), mask_128.begin() + offset);
+  AddPattern(condition, list_128, Uuid::kNumBytes128, value_128, mask_128);
+}
+
+void LeScanningFilter::AddPattern(
+    FilterTypeCondition& condition,
+    std::vector<uint8_t> ad_types,
+    size_t stride,
+    std::vector<uint8_t> value,
+    std::vector<uint8_t> mask) {
+  Pattern pattern{.ad_types = {}, .stride = stride, .value = std::move(value), .mask = std::move(mask)};
+  for (uint8_t ad_type : ad_types) {
+    pattern.ad_types.set(ad_type);
+  }
+  condition.ad_types |= pattern.ad_types;
+  condition.patterns.push_back(std::move(pattern));
+}
+
+LeScanningFilter::AdIndex LeScanningFilter::IndexAdvertisingData(std::span<const uint8_t> advertising_data) {
+  AdIndex index;
+  size_t offset = 0;
+  while (offset < advertising_data.size()) {
+    size_t length = advertising_data[offset];
+    if (length == 0 || offset + 1 + length > advertising_data.size()) {
+      break;
+    }
+    uint8_t type = advertising_data[offset + 1];
+    index.present.set(type);
+    index.structures.push_back(
+        AdStructure{.type = type, .data = advertising_data.data() + offset + 2, .length = length - 1});
+    offset += 1 + length;
+  }
+  return index;
+}
+
+bool LeScanningFilter::Pattern::Matches(const AdIndex& index) const {
+  for (const auto& structure : index.structures) {
+    if (!ad_types.test(structure.type)) {
+      continue;
+    }
+    if (stride == 0) {
+      if (masked_prefix_match(structure.data, structure.length, value, mask)) {
+        return true;
+      }
+      continue;
+    }
+    for (size_t offset = 0; offset + stride <= structure.length; offset += stride) {
+      if (masked_prefix_match(structure.data + offset, stride, value, mask)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool LeScanningFilter::FilterTypeCondition::Matches(const Address& address, const AdIndex& index) const {
+  if (match_any_address || std::find(addresses.begin(), addresses.end(), address) != addresses.end()) {
+    return true;
+  }
+  if ((ad_types & index.present).none()) {
+    return false;
+  }
+  for (const auto& pattern : patterns) {
+    if (pattern.Matches(index)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LeScanningFilter::Filter::Matches(const Address& address, int8_t rssi, const AdIndex& index) const {
+  if (rssi < rssi_threshold) {
+    return false;
+  }
+  for (const auto& [filter_type, condition] : conditions) {
+    if (!condition.Matches(address, index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint8_t> LeScanningFilter::GetFilterIndices() const {
+  std::vector<uint8_t> filter_indices;
+  for (const auto& [filter_index, filter] : filters_) {
+    filter_indices.push_back(filter_index);
+  }
+  return filter_indices;
+}
+
+std::optional<LeScanningFilter::Monitor> LeScanningFilter::CompileMonitor(
+    uint8_t filter_index, size_t max_patterns) const {
+  auto it = filters_.find(filter_index);
+  if (it == filters_.end()) {
+    return std::nullopt;
+  }
+
+  // A report must match every filter type of the index, so the patterns of
+  // any one of them are enough: keep the shortest list.
+  std::optional<Monitor> monitor;
+  for (const auto& [filter_type, condition] : it->second.conditions) {
+    auto patterns = CompileMonitorPatterns(condition);
+    if (!patterns.has_value() || patterns->size() > max_patterns) {
+      continue;
+    }
+    if (!monitor.has_value() || patterns->size() < monitor->patterns.size()) {
+      monitor = Monitor{.rssi_threshold = it->second.rssi_threshold, .patterns = std::move(*patterns)};
+    }
+  }
+  return monitor;
+}
+
+std::optional<std::vector<LeScanningFilter::MonitorPattern>> LeScanningFilter::CompileMonitorPatterns(
+    const FilterTypeCondition& condition) {
+  if (condition.match_any_address || !condition.addresses.empty() || condition.patterns.empty()) {
+    return std::nullopt;
+  }
+
+  std::vector<MonitorPattern> monitor_patterns;
+  for (const auto& pattern : condition.patterns) {
+    // Monitor patterns compare exact bytes at a fixed offset: list patterns
+    // can match at any offset, and only the leading unmasked bytes of a
+    // pattern can be compared, which matches at least the same structures.
+    size_t exact_length =
+        std::find_if(pattern.mask.begin(), pattern.mask.end(), [](uint8_t mask) { return mask != 0xff; }) -
+        pattern.mask.begin();
+    if (pattern.stride != 0 || exact_length == 0) {
+      return std::nullopt;
+    }
+    for (size_t ad_type = 0; ad_type < pattern.ad_types.size(); ad_type++) {
+      if (pattern.ad_types.test(ad_type)) {
+        monitor_patterns.push_back(MonitorPattern{
+            .ad_type = static_cast<uint8_t>(ad_type),
+            .start_byte = 0,
+            .value = std::vector<uint8_t>(pattern.value.begin(), pattern.value.begin() + exact_length)});
+      }
+    }
+  }
+  return monitor_patterns;
+}
+
+bool LeScanningFilter::Matches(
+    const Address& address, int8_t rssi, std::span<const uint8_t> advertising_data) const {
+  if (!enabled_) {
+    return true;
+  }
+  if (filters_.empty()) {
+    return false;
+  }
+
+  AdIndex index = IndexAdvertisingData(advertising_data);
+  for (const auto& [filter_index, filter] : filters_) {
+    if (filter.Matches(address, rssi, index)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <gtest/gtest_prod.h>
+
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/le_scanning_callback.h"
+
+namespace bluetooth::hci {
+
+/// Host side implementation of the advertising packet content filter
+/// (APCF), used when the controller does not support LE_ADV_FILTER.
+///
+/// Filters are programmed with the same model as the vendor commands:
+/// a filter index is created with a filter parameter setup, then
+/// populated with content filters. Each content filter is compiled into
+/// masked prefix patterns over the AD structures that can carry it, so
+/// that a report is parsed once and only the relevant AD structures are
+/// compared.
+///
+/// A report matches a filter index when, for every filter type present
+/// in the index, at least one of its content filters matches. A filter
+/// index without content filters matches all reports. The filter is
+/// deliberately permissive where the host cannot decide (e.g. RPA
+/// resolution for IRK filters), since applications still apply their
+/// own filters to the reports.
+class LeScanningFilter {
+ public:
+  LeScanningFilter() = default;
+
+  LeScanningFilter(const LeScanningFilter&) = delete;
+
+  LeScanningFilter& operator=(const LeScanningFilter&) = delete;
+
+  /// Enable or disable filtering. When disabled, all reports match.
+  void SetEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  /// Create (or reset) the filter index |filter_index|. Reports with a
+  /// RSSI below |rssi_threshold| never match this index.
+  void AddFilterIndex(uint8_t filter_index, int8_t rssi_threshold);
+
+  void RemoveFilterIndex(uint8_t filter_index);
+
+  void ClearFilterIndices();
+
+  /// Add content filters to an existing filter index.
+  void AddFilters(uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& filters);
+
+  /// Returns true if the complete advertising data |advertising_data|
+  /// received from |address| should be delivered.
+  bool Matches(const Address& address, int8_t rssi, std::span<const uint8_t> advertising_data) const;
+
+  /// One pattern of a controller advertisement monitor, as in the MSFT LE
+  /// Monitor Advertisement command: it matches an AD structure of type
+  /// |ad_type| whose payload holds |value| from |start_byte|.
+  struct MonitorPattern {
+    uint8_t ad_type;
+    uint8_t start_byte;
+    std::vector<uint8_t> value;
+
+    bool operator==(const MonitorPattern& other) const = default;
+  };
+
+  /// A controller advertisement monitor, matching the reports with a RSSI
+  /// of at least |rssi_threshold| that match any of |patterns|.
+  struct Monitor {
+    int8_t rssi_threshold;
+    std::vector<MonitorPattern> patterns;
+
+    bool operator==(const Monitor& other) const = default;
+  };
+
+  /// Returns the filter indices, in increasing order.
+  std::vector<uint8_t> GetFilterIndices() const;
+
+  /// Compiles the filter index |filter_index| into a controller monitor
+  /// that matches at least every report the index matches, so that the
+  /// controller can drop the other reports before they wake the host.
+  /// Returns nothing when the index can not be expressed with at most
+  /// |max_patterns| exact patterns, e.g. when it only has UUID list,
+  /// address or empty content filters.
+  std::optional<Monitor> CompileMonitor(uint8_t filter_index, size_t max_patterns) const;
+
+ private:
+  using AdTypeSet = std::bitset<256>;
+
+  /// Location of the AD structures of a report, built once per report.
+  struct AdStructure {
+    uint8_t type;
+    const uint8_t* data;
+    size_t length;
+  };
+
+  struct AdIndex {
+    AdTypeSet present;
+    std::vector<AdStructure> structures;
+  };
+
+  static AdIndex IndexAdvertisingData(std::span<const uint8_t> advertising_data);
+
+  /// A single compiled pattern. The pattern matches an AD structure whose
+  /// type is in |ad_types| and whose payload starts with |value| under
+  /// |mask|. If |stride| is not zero, the payload is a list of elements
+  /// of |stride| bytes and any element can match.
+  struct Pattern {
+    AdTypeSet ad_types;
+    size_t stride;
+    std::vector<uint8_t> value;
+    std::vector<uint8_t> mask;
+
+    bool Matches(const AdIndex& index) const;
+  };
+
+  /// All the patterns compiled for one filter type within a filter index.
+  struct FilterTypeCondition {
+    /// Union of the AD types of |patterns|, used to reject a report
+    /// without looking at its payload.
+    AdTypeSet ad_types;
+    std::vector<Pattern> patterns;
+    std::vector<Address> addresses;
+    bool match_any_address = false;
+
+    bool Matches(const Address& address, const AdIndex& index) const;
+  };
+
+  struct Filter {
+    int8_t rssi_threshold;
+    std::map<ApcfFilterType, FilterTypeCondition> conditions;
+
+    bool Matches(const Address& address, int8_t rssi, const AdIndex& index) const;
+  };
+
+  static std::optional<std::vector<MonitorPattern>> CompileMonitorPatterns(const FilterTypeCondition& condition);
+  static void CompileUuidFilter(FilterTypeCondition& condition, ApcfFilterType filter_type, Uuid uuid, Uuid uuid_mask);
+  static void AddPattern(
+      FilterTypeCondition& condition,
+      std::vector<uint8_t> ad_types,
+      size_t stride,
+      std::vector<uint8_t> value,
+      std::vector<uint8_t> mask);
+
+  bool enabled_{false};
+  std::map<uint8_t, Filter> filters_;
+
+  FRIEND_TEST(LeScanningFilterTest, index_advertising_data);
+};
+
+}  // namespace bluetooth::hci
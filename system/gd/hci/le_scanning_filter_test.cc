@@ -0,0 +1,182 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_filter.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hci {
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+static constexpr uint8_t kFilterIndex = 1;
+static constexpr int8_t kRssi = -60;
+
+// Flags, complete list of 16 bit UUIDs {0x180d, 0x180f}, manufacturer data
+// for company 0x00e0.
+static const std::vector<uint8_t> kAdvertisingData = {
+    0x02, 0x01, 0x06, 0x05, 0x03, 0x0d, 0x18, 0x0f, 0x18, 0x05, 0xff, 0xe0, 0x00, 0x12, 0x34};
+
+static AdvertisingPacketContentFilterCommand uuid_filter(Uuid uuid) {
+  AdvertisingPacketContentFilterCommand filter{};
+  filter.filter_type = ApcfFilterType::SERVICE_UUID;
+  filter.uuid = uuid;
+  filter.uuid_mask = Uuid::kEmpty;
+  return filter;
+}
+
+static AdvertisingPacketContentFilterCommand manufacturer_filter(uint16_t company, std::vector<uint8_t> data) {
+  AdvertisingPacketContentFilterCommand filter{};
+  filter.filter_type = ApcfFilterType::MANUFACTURER_DATA;
+  filter.company = company;
+  filter.data = data;
+  return filter;
+}
+
+class LeScanningFilterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    filter_.SetEnabled(true);
+    filter_.AddFilterIndex(kFilterIndex, -127);
+  }
+
+  LeScanningFilter filter_;
+};
+
+TEST_F(LeScanningFilterTest, index_advertising_data) {
+  std::vector<uint8_t> data = {0x02, 0x01, 0x06, 0x03, 0xff, 0xe0, 0x00, 0x09, 0x09};
+  auto index = LeScanningFilter::IndexAdvertisingData(data);
+  ASSERT_EQ(index.structures.size(), 2ul);
+  ASSERT_TRUE(index.present.test(0x01));
+  ASSERT_TRUE(index.present.test(0xff));
+  ASSERT_FALSE(index.present.test(0x09));
+  ASSERT_EQ(index.structures[1].length, 2ul);
+}
+
+TEST_F(LeScanningFilterTest, disabled_filter_matches_everything) {
+  filter_.SetEnabled(false);
+  filter_.AddFilters(kFilterIndex, {uuid_filter(Uuid::From16Bit(0x1234))});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, empty_filter_index_matches_everything) {
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+
+  filter_.ClearFilterIndices();
+  ASSERT_FALSE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, rssi_threshold) {
+  filter_.AddFilterIndex(kFilterIndex, -50);
+  ASSERT_FALSE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, service_uuid) {
+  filter_.AddFilters(kFilterIndex, {uuid_filter(Uuid::From16Bit(0x180f))});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+
+  filter_.AddFilterIndex(kFilterIndex, -127);
+  filter_.AddFilters(kFilterIndex, {uuid_filter(Uuid::From16Bit(0x1810))});
+  ASSERT_FALSE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, service_uuid_in_128_bit_list) {
+  auto uuid = Uuid::From16Bit(0x180f);
+  std::vector<uint8_t> data = {0x11, 0x07};
+  auto bytes = uuid.To128BitLE();
+  data.insert(data.end(), bytes.begin(), bytes.end());
+
+  filter_.AddFilters(kFilterIndex, {uuid_filter(uuid)});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, data));
+}
+
+TEST_F(LeScanningFilterTest, manufacturer_data_prefix) {
+  filter_.AddFilters(kFilterIndex, {manufacturer_filter(0x00e0, {0x12})});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+
+  filter_.AddFilterIndex(kFilterIndex, -127);
+  filter_.AddFilters(kFilterIndex, {manufacturer_filter(0x00e0, {0x12, 0x35})});
+  ASSERT_FALSE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, filter_types_are_and_ed) {
+  filter_.AddFilters(
+      kFilterIndex, {uuid_filter(Uuid::From16Bit(0x180d)), manufacturer_filter(0x0075, {})});
+  ASSERT_FALSE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+
+  filter_.AddFilters(kFilterIndex, {manufacturer_filter(0x00e0, {})});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, filter_indices_are_or_ed) {
+  filter_.AddFilters(kFilterIndex, {uuid_filter(Uuid::From16Bit(0x1234))});
+  filter_.AddFilterIndex(kFilterIndex + 1, -127);
+  filter_.AddFilters(kFilterIndex + 1, {uuid_filter(Uuid::From16Bit(0x180d))});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+
+  filter_.RemoveFilterIndex(kFilterIndex + 1);
+  ASSERT_FALSE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, broadcaster_address) {
+  AdvertisingPacketContentFilterCommand filter{};
+  filter.filter_type = ApcfFilterType::BROADCASTER_ADDRESS;
+  filter.address = kTestAddress;
+  filter_.AddFilters(kFilterIndex, {filter});
+  ASSERT_TRUE(filter_.Matches(kTestAddress, kRssi, kAdvertisingData));
+  ASSERT_FALSE(filter_.Matches(kOtherAddress, kRssi, kAdvertisingData));
+}
+
+TEST_F(LeScanningFilterTest, compile_monitor) {
+  filter_.AddFilterIndex(kFilterIndex, -70);
+  filter_.AddFilters(kFilterIndex, {manufacturer_filter(0x00e0, {0x12})});
+  auto monitor = filter_.CompileMonitor(kFilterIndex, 61);
+  ASSERT_TRUE(monitor.has_value());
+  ASSERT_EQ(monitor->rssi_threshold, -70);
+  std::vector<LeScanningFilter::MonitorPattern> patterns = {{0xff, 0, {0xe0, 0x00, 0x12}}};
+  ASSERT_EQ(monitor->patterns, patterns);
+
+  ASSERT_FALSE(filter_.CompileMonitor(kFilterIndex, 0).has_value());
+  ASSERT_FALSE(filter_.CompileMonitor(kFilterIndex + 1, 61).has_value());
+}
+
+TEST_F(LeScanningFilterTest, compile_monitor_keeps_exact_prefix) {
+  AdvertisingPacketContentFilterCommand filter = manufacturer_filter(0x00e0, {0x12, 0x34});
+  filter.data_mask = {0xff, 0x0f};
+  filter_.AddFilters(kFilterIndex, {filter});
+  auto monitor = filter_.CompileMonitor(kFilterIndex, 61);
+  ASSERT_TRUE(monitor.has_value());
+  std::vector<LeScanningFilter::MonitorPattern> patterns = {{0xff, 0, {0xe0, 0x00, 0x12}}};
+  ASSERT_EQ(monitor->patterns, patterns);
+}
+
+TEST_F(LeScanningFilterTest, compile_monitor_uses_one_filter_type) {
+  filter_.AddFilters(kFilterIndex, {uuid_filter(Uuid::From16Bit(0x180d))});
+  ASSERT_FALSE(filter_.CompileMonitor(kFilterIndex, 61).has_value());
+
+  filter_.AddFilters(kFilterIndex, {manufacturer_filter(0x00e0, {})});
+  auto monitor = filter_.CompileMonitor(kFilterIndex, 61);
+  ASSERT_TRUE(monitor.has_value());
+  ASSERT_EQ(monitor->patterns.size(), 1ul);
+  ASSERT_EQ(monitor->patterns[0].ad_type, 0xff);
+}
+
+TEST_F(LeScanningFilterTest, empty_filter_index_has_no_monitor) {
+  ASSERT_FALSE(filter_.CompileMonitor(kFilterIndex, 61).has_value());
+  ASSERT_EQ(filter_.GetFilterIndices(), std::vector<uint8_t>{kFilterIndex});
+}
+
+}  // namespace bluetooth::hci
@@ -18,6 +18,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 
@@ -27,8 +28,14 @@
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "hci/le_periodic_sync_manager.h"
+#include "hci/le_scanning_filter.h"
 #include "hci/le_scanning_interface.h"
 #include "hci/le_scanning_reassembler.h"
+#if TARGET_FLOSS
+#include <hardware/bt_common_types.h>
+
+#include "hci/msft.h"
+#endif
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -60,6 +67,20 @@ constexpr uint8_t kDataStatusBits = 5;
 
 // system properties
 const std::string kLeRxPathLossCompProperty = "bluetooth.hardware.radio.le_rx_path_loss_comp_db";
+const std::string kLeScanDedupEnabledProperty = "bluetooth.le_scanning.dedup.enabled";
+const std::string kLeScanDedupReportIntervalProperty = "bluetooth.le_scanning.dedup.report_interval_ms";
+const std::string kLeScanDedupRssiDeltaProperty = "bluetooth.le_scanning.dedup.rssi_delta_db";
+
+#if TARGET_FLOSS
+// MSFT LE Monitor Advertisement parameters of the monitors compiled from the host filters: the
+// filter RSSI threshold is applied by the host filter as well, so report every advertisement of a
+// device in range for as long as the controller is allowed to.
+constexpr size_t kMsftMaxPatterns = 61;
+constexpr size_t kMsftMaxPatternLength = 0x1f - 2;
+constexpr int8_t kMsftRssiThresholdLow = -127;
+constexpr uint8_t kMsftRssiThresholdLowTimeInterval = 0x3c;
+constexpr uint8_t kMsftRssiSamplingPeriodAll = 0x00;
+#endif
 
 const ModuleFactory LeScanningManager::Factory = ModuleFactory([]() { return new LeScanningManager(); });
 
@@ -242,6 +263,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
     batch_scan_config_.ref_value = kInvalidScannerId;
     le_rx_path_loss_comp_ = get_rx_path_loss_compensation();
+    scan_result_deduplicator_.SetPolicy(LeScanningDeduplicator::Policy{
+        .report_interval = std::chrono::milliseconds(
+            os::GetSystemPropertyUint32(kLeScanDedupReportIntervalProperty, 0)),
+        .rssi_delta = static_cast<uint8_t>(
+            std::min<uint32_t>(os::GetSystemPropertyUint32(kLeScanDedupRssiDeltaProperty, 0), UINT8_MAX)),
+    });
+    scan_result_deduplicator_.SetEnabled(os::GetSystemPropertyBool(kLeScanDedupEnabledProperty, false));
   }
 
   void stop() {
@@ -425,6 +453,10 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       uint16_t event_type = report.connectable_ | (report.scannable_ << kScannableBit) |
                             (report.directed_ << kDirectedBit) | (report.scan_response_ << kScanResponseBit) |
                             (report.legacy_ << kLegacyBit) | ((uint16_t)report.data_status_ << kDataStatusBits);
+      if (report.periodic_advertising_interval_ != 0) {
+        periodic_sync_manager_.OnPeriodicAdvertiserSeen(
+            report.address_, report.advertising_sid_, report.rssi_, report.periodic_advertising_interval_);
+      }
       process_advertising_package_content(
           event_type,
           (uint8_t)report.address_type_,
@@ -465,6 +497,23 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
         scanning_reassembler_.ProcessAdvertisingReport(
             event_type, address_type, address, advertising_sid, advertising_data);
 
+    // Without controller filtering, drop unmatched reports here rather than in the upper layers.
+    if (processed_report.has_value() && !host_filter_.Matches(address, rssi, processed_report->data)) {
+      return;
+    }
+
+    if (processed_report.has_value() &&
+        !scan_result_deduplicator_.ShouldReport(
+            processed_report->extended_event_type,
+            address_type,
+            address,
+            advertising_sid,
+            rssi,
+            processed_report->data,
+            std::chrono::steady_clock::now())) {
+      return;
+    }
+
     if (processed_report.has_value()) {
       switch (address_type) {
         case (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS:
@@ -492,7 +541,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
           tx_power,
           get_rssi_after_calibration(rssi),
           periodic_advertising_interval,
-          std::move(processed_report->data));
+          std::vector<uint8_t>(processed_report->data.begin(), processed_report->data.end()));
     }
   }
 
@@ -584,6 +633,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     // On-resume flag should always be reset if there is an explicit start/stop call.
     scan_on_resume_ = false;
     if (start) {
+      // A new scan reports every advertiser at least once.
+      scan_result_deduplicator_.Clear();
       configure_scan();
       start_scan();
     } else {
@@ -705,9 +756,16 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     filter_policy_ = filter_policy;
   }
 
+  void set_scan_result_deduplication(bool enable, LeScanningDeduplicator::Policy policy) {
+    scan_result_deduplicator_.SetPolicy(policy);
+    scan_result_deduplicator_.SetEnabled(enable);
+  }
+
   void scan_filter_enable(bool enable) {
     if (!is_filter_supported_) {
-      log::warn("Advertising filter is not supported");
+      log::info("Advertising filter is not supported, filtering on the host");
+      host_filter_.SetEnabled(enable);
+      sync_msft_monitors();
       return;
     }
 
@@ -731,7 +789,21 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   void scan_filter_parameter_setup(
       ApcfAction action, uint8_t filter_index, AdvertisingFilterParameter advertising_filter_parameter) {
     if (!is_filter_supported_) {
-      log::warn("Advertising filter is not supported");
+      switch (action) {
+        case ApcfAction::ADD:
+          host_filter_.AddFilterIndex(filter_index, (int8_t)advertising_filter_parameter.rssi_high_thresh);
+          break;
+        case ApcfAction::DELETE:
+          host_filter_.RemoveFilterIndex(filter_index);
+          break;
+        case ApcfAction::CLEAR:
+          host_filter_.ClearFilterIndices();
+          break;
+        default:
+          log::error("Unknown action type: {}", (uint16_t)action);
+          break;
+      }
+      sync_msft_monitors();
       return;
     }
 
@@ -794,7 +866,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
 
   void scan_filter_add(uint8_t filter_index, std::vector<AdvertisingPacketContentFilterCommand> filters) {
     if (!is_filter_supported_) {
-      log::warn("Advertising filter is not supported");
+      host_filter_.AddFilters(filter_index, filters);
+      sync_msft_monitors();
       return;
     }
 
@@ -1681,6 +1754,15 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     le_address_manager_->AckPause(this);
   }
 
+  uint8_t GetAddressManagerUses() override {
+    uint8_t uses = kUsesRandomAddress | kUsesResolvingList;
+    if (filter_policy_ == LeScanningFilterPolicy::FILTER_ACCEPT_LIST_ONLY ||
+        filter_policy_ == LeScanningFilterPolicy::FILTER_ACCEPT_LIST_AND_INITIATORS_IDENTITY) {
+      uses |= kUsesFilterAcceptList;
+    }
+    return uses;
+  }
+
   void OnResume() override {
     if (!address_manager_registered_) {
       log::warn("Unregistered!");
@@ -1694,6 +1776,161 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     le_address_manager_->AckResume(this);
   }
 
+#if TARGET_FLOSS
+  void set_msft_extension_manager(MsftExtensionManager* msft_extension_manager) {
+    msft_extension_manager_ = msft_extension_manager;
+    sync_msft_monitors();
+  }
+
+  // Adapts a callback of this module to the MSFT API, so that it is dropped once this module stops.
+  template <typename... Args>
+  static base::Callback<void(Args...)> to_msft_callback(common::ContextualCallback<void(Args...)> callback) {
+    return base::Bind(
+        [](common::ContextualCallback<void(Args...)> callback, Args... args) { callback(args...); }, callback);
+  }
+
+  // Compiles the host filter indices that fit a MSFT advertisement monitor.
+  std::map<uint8_t, LeScanningFilter::Monitor> compile_msft_monitors(bool* all_compiled) const {
+    std::map<uint8_t, LeScanningFilter::Monitor> monitors;
+    *all_compiled = true;
+    for (uint8_t filter_index : host_filter_.GetFilterIndices()) {
+      auto monitor = host_filter_.CompileMonitor(filter_index, kMsftMaxPatterns);
+      if (!monitor.has_value()) {
+        *all_compiled = false;
+        continue;
+      }
+      for (auto& pattern : monitor->patterns) {
+        // A shorter prefix matches at least the same advertisements
+        if (pattern.value.size() > kMsftMaxPatternLength) pattern.value.resize(kMsftMaxPatternLength);
+      }
+      monitors.emplace(filter_index, std::move(*monitor));
+    }
+    return monitors;
+  }
+
+  // Mirrors the host filter indices to MSFT advertisement monitors on controllers without APCF, so
+  // that the controller drops the advertisements no filter accepts instead of waking the host. The
+  // monitors are changed one command at a time, and the controller filtering is only turned on
+  // while every filter index has its monitor: the remaining advertisements still go through the
+  // host filter, which is left on, but those of an index the controller can not monitor, because
+  // its filters do not fit a monitor or the controller is out of monitors, must all reach it.
+  void sync_msft_monitors() {
+    if (msft_extension_manager_ == nullptr || is_filter_supported_ ||
+        !msft_extension_manager_->SupportsMsftExtensions()) {
+      return;
+    }
+    if (msft_sync_ongoing_) {
+      msft_sync_pending_ = true;
+      return;
+    }
+    msft_sync_ongoing_ = true;
+    msft_sync_next();
+  }
+
+  void msft_sync_next() {
+    bool all_compiled;
+    auto monitors = compile_msft_monitors(&all_compiled);
+    bool in_sync = monitors.size() == msft_monitors_.size() &&
+                   std::all_of(monitors.begin(), monitors.end(), [this](const auto& entry) {
+                     auto it = msft_monitors_.find(entry.first);
+                     return it != msft_monitors_.end() && it->second.monitor == entry.second;
+                   });
+    bool filter_in_controller = in_sync && all_compiled && !monitors.empty() && host_filter_.IsEnabled();
+
+    // Stop dropping advertisements before the monitors change
+    if (msft_filter_enabled_ && !filter_in_controller) {
+      msft_extension_manager_->MsftAdvMonitorEnable(
+          false, to_msft_callback(module_handler_->BindOn(this, &impl::on_msft_filter_enabled, false)));
+      return;
+    }
+
+    for (const auto& [filter_index, msft_monitor] : msft_monitors_) {
+      auto it = monitors.find(filter_index);
+      if (it == monitors.end() || it->second != msft_monitor.monitor) {
+        msft_extension_manager_->MsftAdvMonitorRemove(
+            msft_monitor.handle,
+            to_msft_callback(module_handler_->BindOn(this, &impl::on_msft_monitor_removed, filter_index)));
+        return;
+      }
+    }
+
+    for (const auto& [filter_index, monitor] : monitors) {
+      if (msft_monitor_capacity_reached_) break;
+      if (msft_monitors_.count(filter_index) != 0) continue;
+
+      MsftAdvMonitor msft_monitor{
+          .rssi_threshold_high =
+              static_cast<uint8_t>(std::clamp<int8_t>(monitor.rssi_threshold, kLeScanRssiMin, kLeScanRssiMax)),
+          .rssi_threshold_low = static_cast<uint8_t>(kMsftRssiThresholdLow),
+          .rssi_threshold_low_time_interval = kMsftRssiThresholdLowTimeInterval,
+          .rssi_sampling_period = kMsftRssiSamplingPeriodAll,
+          .condition_type = MSFT_CONDITION_TYPE_PATTERNS,
+          .patterns = {},
+          .addr_info = {},
+      };
+      for (const auto& pattern : monitor.patterns) {
+        msft_monitor.patterns.push_back(
+            {.ad_type = pattern.ad_type, .start_byte = pattern.start_byte, .pattern = pattern.value});
+      }
+      msft_extension_manager_->MsftAdvMonitorAdd(
+          msft_monitor,
+          to_msft_callback(module_handler_->BindOn(this, &impl::on_msft_monitor_added, filter_index, monitor)));
+      return;
+    }
+
+    if (filter_in_controller && !msft_filter_enabled_) {
+      msft_extension_manager_->MsftAdvMonitorEnable(
+          true, to_msft_callback(module_handler_->BindOn(this, &impl::on_msft_filter_enabled, true)));
+      return;
+    }
+
+    msft_sync_ongoing_ = false;
+    if (msft_sync_pending_) {
+      msft_sync_pending_ = false;
+      sync_msft_monitors();
+    }
+  }
+
+  void on_msft_monitor_added(
+      uint8_t filter_index, LeScanningFilter::Monitor monitor, uint8_t monitor_handle, ErrorCode status) {
+    if (status == ErrorCode::SUCCESS) {
+      msft_monitors_[filter_index] = MsftMonitor{.monitor = std::move(monitor), .handle = monitor_handle};
+    } else {
+      // The MSFT extension does not tell the number of monitors: take a failure for it
+      log::info(
+          "No MSFT monitor for filter index {} ({}), {} monitors in use, filtering on the host",
+          filter_index,
+          ErrorCodeText(status),
+          msft_monitors_.size());
+      msft_monitor_capacity_reached_ = true;
+    }
+    msft_sync_next();
+  }
+
+  void on_msft_monitor_removed(uint8_t filter_index, ErrorCode status) {
+    if (status != ErrorCode::SUCCESS) {
+      log::warn("Failed to remove the MSFT monitor of filter index {}: {}", filter_index, ErrorCodeText(status));
+    }
+    msft_monitors_.erase(filter_index);
+    msft_monitor_capacity_reached_ = false;
+    msft_sync_next();
+  }
+
+  void on_msft_filter_enabled(bool enable, ErrorCode status) {
+    if (status == ErrorCode::SUCCESS) {
+      log::info("MSFT advertisement filtering {}", enable ? "enabled" : "disabled");
+      msft_filter_enabled_ = enable;
+    } else {
+      log::warn("Failed to {} MSFT advertisement filtering: {}", enable ? "enable" : "disable", ErrorCodeText(status));
+      // Leave the controller as it is rather than retrying
+      msft_sync_ongoing_ = false;
+      msft_sync_pending_ = false;
+      return;
+    }
+    msft_sync_next();
+  }
+#endif
+
   ScanApiType api_type_;
 
   Module* module_;
@@ -1713,6 +1950,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   bool scan_on_resume_ = false;
   bool paused_ = false;
   LeScanningReassembler scanning_reassembler_;
+  LeScanningFilter host_filter_;
+  LeScanningDeduplicator scan_result_deduplicator_;
   bool is_filter_supported_ = false;
   bool is_ad_type_filter_supported_ = false;
   bool is_batch_scan_supported_ = false;
@@ -1730,6 +1969,21 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   std::unordered_map<uint8_t, ScannerId> tracker_id_map_;
   uint16_t total_num_of_advt_tracked_ = 0x00;
   int8_t le_rx_path_loss_comp_ = 0;
+
+#if TARGET_FLOSS
+  struct MsftMonitor {
+    LeScanningFilter::Monitor monitor;
+    uint8_t handle;
+  };
+
+  MsftExtensionManager* msft_extension_manager_ = nullptr;
+  // Host filter indices with a MSFT advertisement monitor
+  std::map<uint8_t, MsftMonitor> msft_monitors_;
+  bool msft_monitor_capacity_reached_ = false;
+  bool msft_filter_enabled_ = false;
+  bool msft_sync_ongoing_ = false;
+  bool msft_sync_pending_ = false;
+#endif
 };
 
 LeScanningManager::LeScanningManager() {
@@ -1793,6 +2047,10 @@ void LeScanningManager::SetScanFilterPolicy(LeScanningFilterPolicy filter_policy
   CallOn(pimpl_.get(), &impl::set_scan_filter_policy, filter_policy);
 }
 
+void LeScanningManager::SetScanResultDeduplication(bool enable, LeScanningDeduplicator::Policy policy) {
+  CallOn(pimpl_.get(), &impl::set_scan_result_deduplication, enable, policy);
+}
+
 void LeScanningManager::ScanFilterEnable(bool enable) {
   CallOn(pimpl_.get(), &impl::scan_filter_enable, enable);
 }
@@ -1888,6 +2146,12 @@ void LeScanningManager::RegisterScanningCallback(ScanningCallback* scanning_call
   CallOn(pimpl_.get(), &impl::register_scanning_callback, scanning_callback);
 }
 
+#if TARGET_FLOSS
+void LeScanningManager::SetMsftExtensionManager(MsftExtensionManager* msft_extension_manager) {
+  CallOn(pimpl_.get(), &impl::set_msft_extension_manager, msft_extension_manager);
+}
+#endif
+
 bool LeScanningManager::IsAdTypeFilterSupported() const {
   return pimpl_->is_ad_type_filter_supported();
 }
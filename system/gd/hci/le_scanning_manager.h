@@ -22,12 +22,17 @@
 #include "hci/address_with_type.h"
 #include "hci/hci_packets.h"
 #include "hci/le_scanning_callback.h"
+#include "hci/le_scanning_deduplicator.h"
 #include "hci/uuid.h"
 #include "module.h"
 
 namespace bluetooth {
 namespace hci {
 
+#if TARGET_FLOSS
+class MsftExtensionManager;
+#endif
+
 enum class BatchScanMode : uint8_t {
   DISABLE = 0,
   TRUNCATED = 1,
@@ -61,6 +66,9 @@ class LeScanningManager : public bluetooth::Module {
 
   virtual void SetScanFilterPolicy(LeScanningFilterPolicy filter_policy);
 
+  /* Suppress repeated scan results from the same advertiser, see LeScanningDeduplicator */
+  virtual void SetScanResultDeduplication(bool enable, LeScanningDeduplicator::Policy policy);
+
   /* Scan filter */
   virtual void ScanFilterEnable(bool enable);
 
@@ -111,6 +119,11 @@ class LeScanningManager : public bluetooth::Module {
 
   virtual bool IsAdTypeFilterSupported() const;
 
+#if TARGET_FLOSS
+  /* Promote the host scan filters to MSFT advertisement monitors, on controllers without APCF */
+  void SetMsftExtensionManager(MsftExtensionManager* msft_extension_manager);
+#endif
+
   static const ModuleFactory Factory;
 
  protected:
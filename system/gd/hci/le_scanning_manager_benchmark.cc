@@ -0,0 +1,651 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Scanning stress benchmarks: a corpus of raw LE Meta events, as a controller reports them in a
+// crowded venue, is replayed through the HCI layer and the LE scanning manager to a sink that
+// hands the results to a JNI thread, as the shim does. Each benchmark reports the reports per
+// second, the CPU time and the allocations of the stack per report, the share of the
+// advertisers that reached the sink and the latency from the HAL to the JNI thread.
+
+#include <bluetooth/log.h>
+#include <gmock/gmock.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_allocation_count.h"
+#include "common/bind.h"
+#include "hal/hci_hal.h"
+#include "hci/controller_mock.h"
+#include "hci/hci_packets.h"
+#include "hci/le_scanning_manager.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+static constexpr auto kTimeout = std::chrono::seconds(5);
+
+// Mix of the corpus, one kind per advertiser in turn
+enum class AdvertiserKind {
+  NAMED_DEVICE,           // Legacy ADV_IND followed by a scan response with the name
+  IBEACON,                // Legacy ADV_NONCONN_IND with iBeacon manufacturer data
+  EXPOSURE_NOTIFICATION,  // Legacy ADV_NONCONN_IND with exposure notification service data
+  EXTENDED,               // Extended connectable advertising reported in several fragments
+  COUNT,
+};
+
+static constexpr uint8_t kLeMetaEvent = 0x3e;
+static constexpr uint8_t kAdvertisingReport = 0x02;
+static constexpr uint8_t kExtendedAdvertisingReport = 0x0d;
+static constexpr uint8_t kRandomDeviceAddress = 0x01;
+static constexpr uint8_t kAdvInd = 0x00;
+static constexpr uint8_t kAdvNonconnInd = 0x03;
+static constexpr uint8_t kScanResponse = 0x04;
+static constexpr uint16_t kExtendedConnectable = 0x01;
+static constexpr uint16_t kExtendedContinuing = 0x20;
+// Maximum advertising data length of a single HCI LE Extended Advertising Report
+static constexpr size_t kFragmentLength = 229;
+static constexpr size_t kExtendedDataLength = 600;
+// Position of the RSSI in an LE Extended Advertising Report event with one report
+static constexpr size_t kExtendedRssiOffset = 17;
+static constexpr uint16_t kAppleCompanyId = 0x004c;
+static constexpr uint16_t kGoogleCompanyId = 0x00e0;
+static constexpr uint16_t kExposureNotificationUuid = 0xfd6f;
+static constexpr size_t kNumWatchedAdvertisers = 16;
+static constexpr size_t kNumWatchedNames = 32;
+
+// The advertiser index is carried in the two low bytes of its random static address
+static Address AdvertiserAddress(size_t index) {
+  return Address({static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8), 0x5c, 0x3a, 0x7e, 0xc2});
+}
+
+static size_t AdvertiserIndex(const Address& address) {
+  return address.address[0] | (address.address[1] << 8);
+}
+
+static std::string AdvertiserName(size_t index) {
+  return "Device-" + std::to_string(index);
+}
+
+static void AppendAdStructure(std::vector<uint8_t>& data, uint8_t type, const std::vector<uint8_t>& payload) {
+  data.push_back(payload.size() + 1);
+  data.push_back(type);
+  data.insert(data.end(), payload.begin(), payload.end());
+}
+
+static std::vector<uint8_t> AdvertisingData(AdvertiserKind kind, size_t index) {
+  std::vector<uint8_t> data;
+  uint8_t seed = static_cast<uint8_t>(index * 37);
+  switch (kind) {
+    case AdvertiserKind::NAMED_DEVICE:
+      AppendAdStructure(data, 0x01, {0x06});
+      AppendAdStructure(data, 0x03, {0x0f, 0x18, 0x0a, 0x18});
+      break;
+    case AdvertiserKind::IBEACON: {
+      std::vector<uint8_t> beacon = {(uint8_t)kAppleCompanyId, (uint8_t)(kAppleCompanyId >> 8), 0x02, 0x15};
+      for (size_t i = 0; i < 16; i++) {
+        beacon.push_back(seed + i);
+      }
+      beacon.insert(beacon.end(), {0x00, 0x01, (uint8_t)(index >> 8), (uint8_t)index, 0xc5});
+      AppendAdStructure(data, 0x01, {0x04});
+      AppendAdStructure(data, 0xff, beacon);
+      break;
+    }
+    case AdvertiserKind::EXPOSURE_NOTIFICATION: {
+      std::vector<uint8_t> service_data = {
+          (uint8_t)kExposureNotificationUuid, (uint8_t)(kExposureNotificationUuid >> 8)};
+      for (size_t i = 0; i < 20; i++) {
+        service_data.push_back(seed + i * 13);
+      }
+      AppendAdStructure(data, 0x01, {0x1a});
+      AppendAdStructure(data, 0x03, {(uint8_t)kExposureNotificationUuid, (uint8_t)(kExposureNotificationUuid >> 8)});
+      AppendAdStructure(data, 0x16, service_data);
+      break;
+    }
+    case AdvertiserKind::EXTENDED:
+      AppendAdStructure(data, 0x01, {0x06});
+      while (data.size() < kExtendedDataLength) {
+        std::vector<uint8_t> manufacturer = {(uint8_t)kGoogleCompanyId, (uint8_t)(kGoogleCompanyId >> 8)};
+        size_t length = std::min<size_t>(kExtendedDataLength - data.size(), 200);
+        for (size_t i = 0; i < length; i++) {
+          manufacturer.push_back(seed + i);
+        }
+        AppendAdStructure(data, 0xff, manufacturer);
+      }
+      break;
+    case AdvertiserKind::COUNT:
+      break;
+  }
+  return data;
+}
+
+static std::vector<uint8_t> LegacyReport(
+    uint8_t event_type, const Address& address, const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> event = {kLeMetaEvent, 0, kAdvertisingReport, 1, event_type, kRandomDeviceAddress};
+  event.insert(event.end(), address.address.begin(), address.address.end());
+  event.push_back(data.size());
+  event.insert(event.end(), data.begin(), data.end());
+  event.push_back(0);  // RSSI, set at each replay
+  event[1] = event.size() - 2;
+  return event;
+}
+
+static std::vector<uint8_t> ExtendedReport(
+    uint16_t event_type, const Address& address, std::vector<uint8_t>::const_iterator begin, size_t length) {
+  std::vector<uint8_t> event = {
+      kLeMetaEvent,
+      0,
+      kExtendedAdvertisingReport,
+      1,
+      (uint8_t)event_type,
+      (uint8_t)(event_type >> 8),
+      kRandomDeviceAddress};
+  event.insert(event.end(), address.address.begin(), address.address.end());
+  // LE 1M primary and secondary PHYs, SID, no TX power, RSSI set at each replay, not periodic
+  event.insert(event.end(), {0x01, 0x01, 0x01, 0x7f, 0x00, 0x00, 0x00});
+  // No direct address
+  event.insert(event.end(), {0xff, 0, 0, 0, 0, 0, 0});
+  event.push_back(length);
+  event.insert(event.end(), begin, begin + length);
+  event[1] = event.size() - 2;
+  return event;
+}
+
+// One round of advertising of a crowded venue: every advertiser is seen once, in the order a
+// controller reports them.
+class AdvertisingCorpus {
+ public:
+  struct Event {
+    hal::HciPacket bytes;
+    size_t advertiser;
+    size_t rssi_offset;
+  };
+
+  explicit AdvertisingCorpus(size_t num_advertisers) : num_advertisers_(num_advertisers) {
+    for (size_t i = 0; i < num_advertisers; i++) {
+      auto kind = static_cast<AdvertiserKind>(i % static_cast<size_t>(AdvertiserKind::COUNT));
+      Address address = AdvertiserAddress(i);
+      auto data = AdvertisingData(kind, i);
+      switch (kind) {
+        case AdvertiserKind::NAMED_DEVICE: {
+          add_legacy(i, LegacyReport(kAdvInd, address, data));
+          std::vector<uint8_t> scan_response;
+          auto name = AdvertiserName(i);
+          AppendAdStructure(scan_response, 0x09, std::vector<uint8_t>(name.begin(), name.end()));
+          add_legacy(i, LegacyReport(kScanResponse, address, scan_response));
+          break;
+        }
+        case AdvertiserKind::IBEACON:
+        case AdvertiserKind::EXPOSURE_NOTIFICATION:
+          add_legacy(i, LegacyReport(kAdvNonconnInd, address, data));
+          break;
+        case AdvertiserKind::EXTENDED:
+          for (size_t offset = 0; offset < data.size(); offset += kFragmentLength) {
+            size_t length = std::min(kFragmentLength, data.size() - offset);
+            uint16_t event_type =
+                kExtendedConnectable | (offset + length < data.size() ? kExtendedContinuing : 0);
+            events_.push_back(
+                {ExtendedReport(event_type, address, data.cbegin() + offset, length), i, kExtendedRssiOffset});
+          }
+          break;
+        case AdvertiserKind::COUNT:
+          break;
+      }
+    }
+  }
+
+  // Vary the RSSI of the advertisers from one round to the next, as they move around
+  void SetRound(size_t round) {
+    for (auto& event : events_) {
+      event.bytes[event.rssi_offset] = static_cast<uint8_t>(-50 - (int)((event.advertiser * 7 + round * 5) % 40));
+    }
+  }
+
+  const std::vector<Event>& GetEvents() const {
+    return events_;
+  }
+
+  size_t GetNumAdvertisers() const {
+    return num_advertisers_;
+  }
+
+ private:
+  void add_legacy(size_t advertiser, std::vector<uint8_t> bytes) {
+    size_t rssi_offset = bytes.size() - 1;
+    events_.push_back({std::move(bytes), advertiser, rssi_offset});
+  }
+
+  size_t num_advertisers_;
+  std::vector<Event> events_;
+};
+
+// Controller that scans with the extended commands and leaves the advertising packet content
+// filtering to the host.
+class ScanningController : public testing::MockController {
+ public:
+  bool IsSupported(OpCode op_code) const override {
+    return op_code == OpCode::LE_SET_EXTENDED_SCAN_PARAMETERS || op_code == OpCode::LE_SET_EXTENDED_SCAN_ENABLE;
+  }
+
+  bool SupportsBleExtendedAdvertising() const override {
+    return true;
+  }
+
+  uint16_t GetAclPacketLength() const override {
+    return 1021;
+  }
+
+  uint16_t GetNumAclPacketBuffers() const override {
+    return 8;
+  }
+
+  LeBufferSize GetLeBufferSize() const override {
+    LeBufferSize le_buffer_size;
+    le_buffer_size.total_num_le_packets_ = 8;
+    le_buffer_size.le_data_packet_length_ = 251;
+    return le_buffer_size;
+  }
+
+ protected:
+  void Start() override {}
+  void Stop() override {}
+  void ListDependencies(ModuleList* /* list */) const override {}
+};
+
+// HAL completing the commands at once on its own thread, and passing the replayed events up as
+// a transport would.
+class ReplayHciHal : public hal::HciHal {
+ public:
+  void registerIncomingPacketCallback(hal::HciHalCallbacks* callbacks) override {
+    callbacks_ = callbacks;
+  }
+
+  void unregisterIncomingPacketCallback() override {
+    callbacks_ = nullptr;
+  }
+
+  void sendHciCommand(hal::HciPacket command) override {
+    handler_->CallOn(this, &ReplayHciHal::on_command, std::move(command));
+  }
+
+  void sendAclData(hal::HciPacket /* data */) override {}
+
+  void sendScoData(hal::HciPacket /* data */) override {}
+
+  void sendIsoData(hal::HciPacket /* data */) override {}
+
+  void InjectEvent(hal::HciPacket event) {
+    auto callbacks = callbacks_.load();
+    if (callbacks != nullptr) {
+      callbacks->hciEventReceived(std::move(event));
+    }
+  }
+
+  void WaitForIdle() {
+    thread_->GetReactor()->WaitForIdle(kTimeout);
+  }
+
+  std::string ToString() const override {
+    return std::string("ReplayHciHal");
+  }
+
+ protected:
+  void Start() override {
+    thread_ = new os::Thread("replay_hal", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+  }
+
+  void Stop() override {
+    handler_->Clear();
+    handler_->WaitUntilStopped(kTimeout);
+    delete handler_;
+    delete thread_;
+  }
+
+  void ListDependencies(ModuleList* /* list */) const override {}
+
+ private:
+  void on_command(hal::HciPacket bytes) {
+    auto command = CommandView::Create(
+        packet::PacketView<packet::kLittleEndian>(std::make_shared<hal::HciPacket>(std::move(bytes))));
+    log::assert_that(command.IsValid(), "assert failed: command.IsValid()");
+    // The commands of the scanning path only return a status
+    auto event = CommandCompleteBuilder::Create(
+        1,
+        command.GetOpCode(),
+        std::make_unique<packet::RawBuilder>(std::vector<uint8_t>{static_cast<uint8_t>(ErrorCode::SUCCESS)}));
+    hal::HciPacket event_bytes;
+    event->SerializeTo(event_bytes);
+    InjectEvent(std::move(event_bytes));
+  }
+
+  std::atomic<hal::HciHalCallbacks*> callbacks_ = nullptr;
+  os::Thread* thread_ = nullptr;
+  os::Handler* handler_ = nullptr;
+};
+
+// Stands for the shim and the JNI layer: the results are copied and handed to the JNI thread,
+// which measures the delay since the last event of the advertiser left the HAL.
+class JniScanningSink : public ScanningCallback {
+ public:
+  explicit JniScanningSink(size_t num_advertisers)
+      : send_times_(new std::atomic<std::chrono::steady_clock::rep>[num_advertisers]),
+        handler_(new os::Handler(&thread_)) {}
+
+  ~JniScanningSink() {
+    handler_->Clear();
+    handler_->WaitUntilStopped(kTimeout);
+    delete handler_;
+  }
+
+  void OnSent(size_t advertiser) {
+    send_times_[advertiser].store(
+        std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+  }
+
+  void WaitForIdle() {
+    thread_.GetReactor()->WaitForIdle(kTimeout);
+  }
+
+  void Report(
+      State& state,
+      size_t num_reports,
+      size_t num_advertisers,
+      std::chrono::microseconds cpu_time,
+      int64_t allocations) {
+    state.SetItemsProcessed(static_cast<int64_t>(num_reports));
+    if (num_reports > 0) {
+      state.counters["cpu_us_per_report"] = static_cast<double>(cpu_time.count()) / num_reports;
+      state.counters["allocs_per_report"] = static_cast<double>(allocations) / num_reports;
+    }
+    if (num_advertisers > 0) {
+      state.counters["delivered"] = static_cast<double>(latencies_.size()) / num_advertisers;
+    }
+    if (!latencies_.empty()) {
+      std::sort(latencies_.begin(), latencies_.end());
+      state.counters["p50_us"] = percentile(0.50).count();
+      state.counters["p99_us"] = percentile(0.99).count();
+    }
+  }
+
+  void OnScanResult(
+      uint16_t event_type,
+      uint8_t address_type,
+      Address address,
+      uint8_t primary_phy,
+      uint8_t secondary_phy,
+      uint8_t advertising_sid,
+      int8_t tx_power,
+      int8_t rssi,
+      uint16_t periodic_advertising_interval,
+      std::vector<uint8_t> advertising_data) override {
+    handler_->Post(common::BindOnce(
+        &JniScanningSink::on_jni_scan_result,
+        common::Unretained(this),
+        event_type,
+        address_type,
+        address,
+        primary_phy,
+        secondary_phy,
+        advertising_sid,
+        tx_power,
+        rssi,
+        periodic_advertising_interval,
+        std::move(advertising_data)));
+  }
+
+  void OnScannerRegistered(const Uuid /* app_uuid */, ScannerId /* scanner_id */, ScanningStatus /* status */)
+      override {}
+  void OnSetScannerParameterComplete(ScannerId /* scanner_id */, ScanningStatus /* status */) override {}
+  void OnTrackAdvFoundLost(AdvertisingFilterOnFoundOnLostInfo /* on_found_on_lost_info */) override {}
+  void OnBatchScanReports(
+      int /* client_if */,
+      int /* status */,
+      int /* report_format */,
+      int /* num_records */,
+      std::vector<uint8_t> /* data */) override {}
+  void OnBatchScanThresholdCrossed(int /* client_if */) override {}
+  void OnTimeout() override {}
+  void OnFilterEnable(Enable /* enable */, uint8_t /* status */) override {}
+  void OnFilterParamSetup(uint8_t /* available_spaces */, ApcfAction /* action */, uint8_t /* status */) override {}
+  void OnFilterConfigCallback(
+      ApcfFilterType /* filter_type */,
+      uint8_t /* available_spaces */,
+      ApcfAction /* action */,
+      uint8_t /* status */) override {}
+  void OnPeriodicSyncStarted(
+      int /* request_id */,
+      uint8_t /* status */,
+      uint16_t /* sync_handle */,
+      uint8_t /* advertising_sid */,
+      AddressWithType /* address_with_type */,
+      uint8_t /* phy */,
+      uint16_t /* interval */) override {}
+  void OnPeriodicSyncReport(
+      uint16_t /* sync_handle */,
+      int8_t /* tx_power */,
+      int8_t /* rssi */,
+      uint8_t /* status */,
+      std::vector<uint8_t> /* data */) override {}
+  void OnPeriodicSyncLost(uint16_t /* sync_handle */) override {}
+  void OnPeriodicSyncTransferred(int /* pa_source */, uint8_t /* status */, Address /* address */) override {}
+  void OnBigInfoReport(uint16_t /* sync_handle */, bool /* encrypted */) override {}
+
+ private:
+  void on_jni_scan_result(
+      uint16_t /* event_type */,
+      uint8_t /* address_type */,
+      Address address,
+      uint8_t /* primary_phy */,
+      uint8_t /* secondary_phy */,
+      uint8_t /* advertising_sid */,
+      int8_t /* tx_power */,
+      int8_t /* rssi */,
+      uint16_t /* periodic_advertising_interval */,
+      std::vector<uint8_t> advertising_data) {
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto sent = send_times_[AdvertiserIndex(address)].load(std::memory_order_relaxed);
+    latencies_.push_back(std::chrono::steady_clock::duration(now - sent));
+    benchmark::DoNotOptimize(advertising_data.data());
+  }
+
+  std::chrono::duration<double, std::micro> percentile(double fraction) const {
+    return latencies_[static_cast<size_t>(fraction * (latencies_.size() - 1))];
+  }
+
+  std::unique_ptr<std::atomic<std::chrono::steady_clock::rep>[]> send_times_;
+  std::vector<std::chrono::steady_clock::duration> latencies_;
+  os::Thread thread_{"jni", os::Thread::Priority::NORMAL};
+  os::Handler* handler_;
+};
+
+// User and system time of all the threads of the process
+static std::chrono::microseconds ProcessCpuTime() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+// Configuration of the scanning manager the corpus goes through
+enum class ScanFilter {
+  NONE,
+  BROADCASTER_ADDRESS,
+  SERVICE_UUID,
+  MANUFACTURER_DATA,
+  LOCAL_NAMES,
+  DEDUPLICATION,
+};
+
+// The gd stack from the HCI layer to the LE scanning manager on top of the replay HAL
+class ScanningStack {
+ public:
+  explicit ScanningStack(size_t num_advertisers) : sink_(num_advertisers) {
+    controller_ = new ::testing::NiceMock<ScanningController>;  // Ownership is transferred to registry
+    hal_ = new ReplayHciHal;                                   // Ownership is transferred to registry
+    registry_.InjectTestModule(&hal::HciHal::Factory, hal_);
+    registry_.InjectTestModule(&Controller::Factory, controller_);
+    registry_.Start<LeScanningManager>(&registry_.GetTestThread());
+    scanning_manager_ = registry_.GetModuleUnderTest<LeScanningManager>();
+    scanning_manager_->RegisterScanningCallback(&sink_);
+    WaitForIdle();
+  }
+
+  ~ScanningStack() {
+    WaitForIdle();
+    registry_.StopAll();
+  }
+
+  void Configure(ScanFilter filter, size_t num_advertisers) {
+    if (filter == ScanFilter::DEDUPLICATION) {
+      scanning_manager_->SetScanResultDeduplication(true, LeScanningDeduplicator::Policy{.rssi_delta = 10});
+      WaitForIdle();
+      return;
+    }
+    if (filter == ScanFilter::NONE) {
+      return;
+    }
+
+    std::vector<AdvertisingPacketContentFilterCommand> filters;
+    switch (filter) {
+      case ScanFilter::BROADCASTER_ADDRESS:
+        for (size_t i = 0; i < kNumWatchedAdvertisers; i++) {
+          AdvertisingPacketContentFilterCommand command{};
+          command.filter_type = ApcfFilterType::BROADCASTER_ADDRESS;
+          command.address = AdvertiserAddress(i * num_advertisers / kNumWatchedAdvertisers);
+          filters.push_back(command);
+        }
+        break;
+      case ScanFilter::SERVICE_UUID: {
+        AdvertisingPacketContentFilterCommand command{};
+        command.filter_type = ApcfFilterType::SERVICE_UUID;
+        command.uuid = Uuid::From16Bit(kExposureNotificationUuid);
+        filters.push_back(command);
+        break;
+      }
+      case ScanFilter::MANUFACTURER_DATA: {
+        AdvertisingPacketContentFilterCommand command{};
+        command.filter_type = ApcfFilterType::MANUFACTURER_DATA;
+        command.company = kAppleCompanyId;
+        command.data = {0x02, 0x15};
+        filters.push_back(command);
+        break;
+      }
+      case ScanFilter::LOCAL_NAMES:
+        // Half of the names are in the venue
+        for (size_t i = 0; i < kNumWatchedNames; i++) {
+          AdvertisingPacketContentFilterCommand command{};
+          command.filter_type = ApcfFilterType::LOCAL_NAME;
+          auto name = AdvertiserName(i % 2 == 0 ? i * static_cast<size_t>(AdvertiserKind::COUNT)
+                                                : num_advertisers + i);
+          command.name = std::vector<uint8_t>(name.begin(), name.end());
+          filters.push_back(command);
+        }
+        break;
+      default:
+        break;
+    }
+
+    AdvertisingFilterParameter parameter{};
+    parameter.rssi_high_thresh = static_cast<uint8_t>(-128);
+    scanning_manager_->ScanFilterEnable(true);
+    scanning_manager_->ScanFilterParameterSetup(ApcfAction::ADD, 0, parameter);
+    scanning_manager_->ScanFilterAdd(0, filters);
+    WaitForIdle();
+  }
+
+  // Replay one round of the corpus and wait until the JNI thread got all the results
+  void Replay(const AdvertisingCorpus& corpus) {
+    for (const auto& event : corpus.GetEvents()) {
+      sink_.OnSent(event.advertiser);
+      hal_->InjectEvent(event.bytes);
+    }
+    WaitForIdle();
+  }
+
+  void WaitForIdle() {
+    hal_->WaitForIdle();
+    registry_.GetTestThread().GetReactor()->WaitForIdle(kTimeout);
+    sink_.WaitForIdle();
+  }
+
+  JniScanningSink& GetSink() {
+    return sink_;
+  }
+
+ private:
+  TestModuleRegistry registry_;
+  ReplayHciHal* hal_;
+  ScanningController* controller_;
+  LeScanningManager* scanning_manager_;
+  JniScanningSink sink_;
+};
+
+static void BM_ScanCrowdedVenue(State& state, ScanFilter filter) {
+  size_t num_advertisers = state.range(0);
+  AdvertisingCorpus corpus(num_advertisers);
+  ScanningStack stack(num_advertisers);
+  stack.Configure(filter, num_advertisers);
+
+  size_t num_reports = 0;
+  size_t num_rounds = 0;
+  auto cpu_start = ProcessCpuTime();
+  int64_t allocations_start = GetBenchmarkAllocationCount();
+  for (auto _ : state) {
+    state.PauseTiming();
+    corpus.SetRound(num_rounds++);
+    state.ResumeTiming();
+    stack.Replay(corpus);
+    num_reports += corpus.GetEvents().size();
+  }
+  stack.GetSink().Report(
+      state,
+      num_reports,
+      num_rounds * num_advertisers,
+      ProcessCpuTime() - cpu_start,
+      GetBenchmarkAllocationCount() - allocations_start);
+}
+BENCHMARK_CAPTURE(BM_ScanCrowdedVenue, no_filter, ScanFilter::NONE)->Arg(200)->Arg(1000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ScanCrowdedVenue, broadcaster_address, ScanFilter::BROADCASTER_ADDRESS)
+    ->Arg(200)
+    ->Arg(1000)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ScanCrowdedVenue, service_uuid, ScanFilter::SERVICE_UUID)->Arg(200)->Arg(1000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ScanCrowdedVenue, manufacturer_data, ScanFilter::MANUFACTURER_DATA)
+    ->Arg(200)
+    ->Arg(1000)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ScanCrowdedVenue, local_names, ScanFilter::LOCAL_NAMES)->Arg(200)->Arg(1000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ScanCrowdedVenue, deduplication, ScanFilter::DEDUPLICATION)
+    ->Arg(200)
+    ->Arg(1000)
+    ->UseRealTime();
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -17,6 +17,9 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 
@@ -33,6 +36,15 @@
 
 namespace bluetooth::hci {
 
+LeScanningReassembler::LeScanningReassembler()
+    : fragments_(std::make_unique<std::array<AdvertisingFragment, kMaximumCacheSize>>()) {
+  buckets_.fill(kEmptyBucket);
+  free_fragments_.reserve(kMaximumCacheSize);
+  for (size_t slot = kMaximumCacheSize; slot > 0; slot--) {
+    free_fragments_.push_back(slot - 1);
+  }
+}
+
 std::optional<LeScanningReassembler::CompleteAdvertisingData>
 LeScanningReassembler::ProcessAdvertisingReport(
     uint16_t event_type,
@@ -68,12 +80,12 @@ LeScanningReassembler::ProcessAdvertisingReport(
   }
 
   // Concatenate the data with existing fragments.
-  std::list<AdvertisingFragment>::iterator advertising_fragment =
-      AppendFragment(key, event_type, advertising_data);
+  AdvertisingFragment* advertising_fragment = AppendFragment(key, event_type, advertising_data);
 
   // Trim the advertising data when the complete payload is received.
   if (data_status != DataStatus::CONTINUING) {
-    advertising_fragment->data = TrimAdvertisingData(advertising_fragment->data);
+    advertising_fragment->length =
+        TrimAdvertisingData(advertising_fragment->data.data(), advertising_fragment->length);
   }
 
   // TODO(b/272120114) waiting for a scan response here is prone to failure as the
@@ -91,10 +103,12 @@ LeScanningReassembler::ProcessAdvertisingReport(
 
   // Otherwise the full advertising report has been reassembled,
   // removed the cache entry and return the complete advertising data.
+  // The slot is not reused before the next report, so the data remains
+  // valid until then.
   CompleteAdvertisingData result{
       .extended_event_type = advertising_fragment->extended_event_type,
-      .data = std::move(advertising_fragment->data)};
-  cache_.erase(advertising_fragment);
+      .data = std::span<const uint8_t>(advertising_fragment->data.data(), advertising_fragment->length)};
+  RemoveFragment(key);
   return result;
 }
 
@@ -112,33 +126,32 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessPeriodicAdvert
 
   // The complete payload has been received; trim the advertising data,
   // remove the cache entry and return the complete advertising data.
-  std::vector<uint8_t> result = TrimAdvertisingData(advertising_fragment->data);
+  std::vector<uint8_t> result = std::move(advertising_fragment->data);
+  result.resize(TrimAdvertisingData(result.data(), result.size()));
   periodic_cache_.erase(advertising_fragment);
   return result;
 }
 
-/// Trim the advertising data by removing empty or overflowing
+/// Trim the advertising data in place by removing empty or overflowing
 /// GAP Data entries.
-std::vector<uint8_t> LeScanningReassembler::TrimAdvertisingData(
-    const std::vector<uint8_t>& advertising_data) {
+size_t LeScanningReassembler::TrimAdvertisingData(uint8_t* advertising_data, size_t length) {
   // Remove empty and overflowing entries from the advertising data.
-  std::vector<uint8_t> significant_advertising_data;
-  for (size_t offset = 0; offset < advertising_data.size();) {
-    size_t remaining_size = advertising_data.size() - offset;
+  // Entries are only ever moved towards the front, so the trimmed data
+  // can overwrite the input.
+  size_t significant_length = 0;
+  for (size_t offset = 0; offset < length;) {
+    size_t remaining_size = length - offset;
     uint8_t entry_size = advertising_data[offset];
 
     if (entry_size != 0 && entry_size < remaining_size) {
-      significant_advertising_data.push_back(entry_size);
-      significant_advertising_data.insert(
-          significant_advertising_data.end(),
-          advertising_data.begin() + offset + 1,
-          advertising_data.begin() + offset + 1 + entry_size);
+      std::memmove(advertising_data + significant_length, advertising_data + offset, entry_size + 1);
+      significant_length += entry_size + 1;
     }
 
     offset += entry_size + 1;
   }
 
-  return significant_advertising_data;
+  return significant_length;
 }
 
 LeScanningReassembler::AdvertisingKey::AdvertisingKey(
@@ -155,58 +168,108 @@ LeScanningReassembler::AdvertisingKey::AdvertisingKey(
   }
 }
 
-bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) {
+bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) const {
   return address == other.address && sid == other.sid;
 }
 
+size_t LeScanningReassembler::AdvertisingKey::Hash() const {
+  size_t hash = sid.has_value() ? (size_t{1} << 8) | sid.value() : 0;
+  if (address.has_value()) {
+    hash ^= std::hash<Address>{}(address->GetAddress()) + (size_t)address->GetAddressType();
+  }
+  return hash;
+}
+
 /// Append to the current advertising data of the selected advertiser.
 /// If the advertiser is unknown a new entry is added, optionally by
 /// dropping the oldest advertiser.
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator
-LeScanningReassembler::AppendFragment(
+LeScanningReassembler::AdvertisingFragment* LeScanningReassembler::AppendFragment(
     const AdvertisingKey& key, uint16_t extended_event_type, const std::vector<uint8_t>& data) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
+  AdvertisingFragment* fragment = nullptr;
+  size_t bucket = FindBucket(key);
+  if (bucket != kNumBuckets) {
+    fragment = &(*fragments_)[buckets_[bucket]];
     // Legacy scan responses don't contain a 'connectable' bit, so this adds the
     // 'connectable' bit from the initial report.
     if ((extended_event_type & (1 << kLegacyBit)) &&
         (extended_event_type & (1 << kScanResponseBit))) {
-      it->extended_event_type =
-          extended_event_type | (it->extended_event_type & (1 << kConnectableBit));
+      fragment->extended_event_type =
+          extended_event_type | (fragment->extended_event_type & (1 << kConnectableBit));
     } else {
-      it->extended_event_type = extended_event_type;
+      fragment->extended_event_type = extended_event_type;
     }
-    it->data.insert(it->data.end(), data.cbegin(), data.cend());
-    return it;
-  }
+  } else {
+    if (free_fragments_.empty()) {
+      // Drop the least recently updated advertiser.
+      auto oldest = std::min_element(
+          fragments_->begin(), fragments_->end(), [](const auto& a, const auto& b) {
+            return a.last_update < b.last_update;
+          });
+      EraseBucket(FindBucket(oldest->key));
+    }
+
+    uint8_t slot = free_fragments_.back();
+    free_fragments_.pop_back();
+    fragment = &(*fragments_)[slot];
+    fragment->key = key;
+    fragment->extended_event_type = extended_event_type;
+    fragment->length = 0;
 
-  if (cache_.size() > kMaximumCacheSize) {
-    cache_.pop_back();
+    bucket = key.Hash() % kNumBuckets;
+    while (buckets_[bucket] != kEmptyBucket) {
+      bucket = (bucket + 1) % kNumBuckets;
+    }
+    buckets_[bucket] = slot;
   }
 
-  cache_.emplace_front(key, extended_event_type, data);
-  return cache_.begin();
+  size_t copied = std::min(data.size(), kMaximumAdvertisingDataLength - fragment->length);
+  if (copied < data.size()) {
+    log::warn("Dropping {} bytes of advertising data past the maximum length", data.size() - copied);
+  }
+  std::copy_n(data.begin(), copied, fragment->data.begin() + fragment->length);
+  fragment->length += copied;
+  fragment->last_update = sequence_number_++;
+  return fragment;
 }
 
 void LeScanningReassembler::RemoveFragment(const AdvertisingKey& key) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
-    cache_.erase(it);
+  size_t bucket = FindBucket(key);
+  if (bucket != kNumBuckets) {
+    EraseBucket(bucket);
   }
 }
 
 bool LeScanningReassembler::ContainsFragment(const AdvertisingKey& key) {
-  return FindFragment(key) != cache_.end();
+  return FindBucket(key) != kNumBuckets;
 }
 
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator LeScanningReassembler::FindFragment(
-    const AdvertisingKey& key) {
-  for (auto it = cache_.begin(); it != cache_.end(); it++) {
-    if (it->key == key) {
-      return it;
+size_t LeScanningReassembler::FindBucket(const AdvertisingKey& key) const {
+  // The table is never more than half full, so the probe stops at an empty bucket.
+  for (size_t bucket = key.Hash() % kNumBuckets; buckets_[bucket] != kEmptyBucket;
+       bucket = (bucket + 1) % kNumBuckets) {
+    if ((*fragments_)[buckets_[bucket]].key == key) {
+      return bucket;
+    }
+  }
+  return kNumBuckets;
+}
+
+void LeScanningReassembler::EraseBucket(size_t bucket) {
+  free_fragments_.push_back(buckets_[bucket]);
+  buckets_[bucket] = kEmptyBucket;
+
+  // Shift back the following entries of the probe sequence that can
+  // take the freed bucket, so that lookups never stop early.
+  size_t hole = bucket;
+  for (size_t next = (hole + 1) % kNumBuckets; buckets_[next] != kEmptyBucket;
+       next = (next + 1) % kNumBuckets) {
+    size_t home = (*fragments_)[buckets_[next]].key.Hash() % kNumBuckets;
+    if ((next + kNumBuckets - home) % kNumBuckets >= (next + kNumBuckets - hole) % kNumBuckets) {
+      buckets_[hole] = buckets_[next];
+      buckets_[next] = kEmptyBucket;
+      hole = next;
     }
   }
-  return cache_.end();
 }
 
 /// Append to the current advertising data of the selected periodic advertiser.
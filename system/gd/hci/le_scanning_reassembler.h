@@ -17,9 +17,12 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <array>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <optional>
+#include <span>
 #include <vector>
 
 #include "hci/address_with_type.h"
@@ -32,15 +35,20 @@ namespace bluetooth::hci {
 /// and were fragmented by the controller.
 /// The reassembler also joins scan response data with the
 /// matching advertising data.
+///
+/// Advertising fragments are reassembled in place in a fixed set of
+/// preallocated slots, so processing a report does not allocate.
 
 class LeScanningReassembler {
  public:
+  /// The complete advertising data points into the reassembler storage,
+  /// and is only valid until the next call to ProcessAdvertisingReport.
   struct CompleteAdvertisingData {
     uint16_t extended_event_type;
-    std::vector<uint8_t> data;
+    std::span<const uint8_t> data;
   };
 
-  LeScanningReassembler(){};
+  LeScanningReassembler();
 
   LeScanningReassembler(const LeScanningReassembler&) = delete;
 
@@ -97,19 +105,24 @@ class LeScanningReassembler {
     std::optional<AddressWithType> address;
     std::optional<uint8_t> sid;
 
+    AdvertisingKey() = default;
     AdvertisingKey(Address address, DirectAdvertisingAddressType address_type, uint8_t sid);
-    bool operator==(const AdvertisingKey& other);
+    bool operator==(const AdvertisingKey& other) const;
+    size_t Hash() const;
   };
 
-  /// Packs incomplete advertising data.
+  /// Maximum length of the complete advertising data of an
+  /// extended advertising event, including the scan response.
+  static constexpr size_t kMaximumAdvertisingDataLength = 1650;
+
+  /// Reassembly slot for incomplete advertising data.
   struct AdvertisingFragment {
     AdvertisingKey key;
     uint16_t extended_event_type;
-    std::vector<uint8_t> data;
-
-    AdvertisingFragment(
-        const AdvertisingKey& key, uint16_t extended_event_type, const std::vector<uint8_t>& data)
-        : key(key), extended_event_type(extended_event_type), data(data.begin(), data.end()) {}
+    /// Sequence number of the last update, used to evict the oldest slot.
+    uint64_t last_update;
+    size_t length;
+    std::array<uint8_t, kMaximumAdvertisingDataLength> data;
   };
 
   /// Packs incomplete periodic advertising data.
@@ -127,17 +140,31 @@ class LeScanningReassembler {
   /// The cached advertising data is removed as soon as the complete
   /// advertisement is got (including the scan response).
   static constexpr size_t kMaximumCacheSize = 16;
-  std::list<AdvertisingFragment> cache_;
+  std::unique_ptr<std::array<AdvertisingFragment, kMaximumCacheSize>> fragments_;
+  std::vector<uint8_t> free_fragments_;
+  uint64_t sequence_number_{0};
+
+  /// Open addressed index from advertising key to fragment slot, with
+  /// linear probing. Twice as many buckets as slots keeps the probe
+  /// sequences short.
+  static constexpr size_t kNumBuckets = 2 * kMaximumCacheSize;
+  static constexpr uint8_t kEmptyBucket = 0xff;
+  std::array<uint8_t, kNumBuckets> buckets_;
 
   /// Advertising cache management methods.
-  std::list<AdvertisingFragment>::iterator AppendFragment(
+  AdvertisingFragment* AppendFragment(
       const AdvertisingKey& key, uint16_t extended_event_type, const std::vector<uint8_t>& data);
 
   void RemoveFragment(const AdvertisingKey& key);
 
   bool ContainsFragment(const AdvertisingKey& key);
 
-  std::list<AdvertisingFragment>::iterator FindFragment(const AdvertisingKey& key);
+  /// Returns the bucket holding |key|, or kNumBuckets if not found.
+  size_t FindBucket(const AdvertisingKey& key) const;
+
+  /// Release the fragment slot referenced by |bucket|. The slot data is
+  /// left untouched until the slot is reused.
+  void EraseBucket(size_t bucket);
 
   /// Advertising cache for de-fragmenting periodic advertising reports.
   static constexpr size_t kMaximumPeriodicCacheSize = 16;
@@ -148,9 +175,9 @@ class LeScanningReassembler {
 
   std::list<PeriodicAdvertisingFragment>::iterator FindPeriodicFragment(uint16_t sync_handle);
 
-  /// Trim the advertising data by removing empty or overflowing
-  /// GAP Data entries.
-  static std::vector<uint8_t> TrimAdvertisingData(const std::vector<uint8_t>& advertising_data);
+  /// Trim the advertising data in place by removing empty or overflowing
+  /// GAP Data entries. Returns the trimmed length.
+  static size_t TrimAdvertisingData(uint8_t* advertising_data, size_t length);
 
   FRIEND_TEST(LeScanningReassemblerTest, trim_advertising_data);
 };
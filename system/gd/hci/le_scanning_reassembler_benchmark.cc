@@ -0,0 +1,97 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/le_scanning_reassembler.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+// Event type fields.
+static constexpr uint16_t kConnectable = 0x1;
+static constexpr uint16_t kComplete = 0x0;
+static constexpr uint16_t kContinuation = 0x20;
+
+// Maximum advertising data length of a single HCI LE Extended
+// Advertising Report.
+static constexpr size_t kFragmentLength = 229;
+static constexpr size_t kFragmentsPerAdvertisement = 7;
+
+static std::vector<uint8_t> MakeFragment(uint8_t seed) {
+  std::vector<uint8_t> fragment(kFragmentLength);
+  fragment[0] = kFragmentLength - 1;
+  for (size_t i = 1; i < kFragmentLength; i++) {
+    fragment[i] = static_cast<uint8_t>(seed + i * 31);
+  }
+  return fragment;
+}
+
+// Replay bursts of extended advertising where the fragments of
+// state.range(0) advertisers are interleaved, as the controller
+// reports them when several advertisers are in range.
+static void BM_ReassembleExtendedAdvertising(State& state) {
+  size_t num_advertisers = state.range(0);
+  std::vector<Address> addresses;
+  for (size_t i = 0; i < num_advertisers; i++) {
+    addresses.push_back(Address({static_cast<uint8_t>(i), 0x11, 0x22, 0x33, 0x44, 0x55}));
+  }
+  auto fragment = MakeFragment(0x42);
+
+  LeScanningReassembler reassembler;
+  size_t bytes_reassembled = 0;
+  for (auto _ : state) {
+    for (size_t n = 0; n < kFragmentsPerAdvertisement; n++) {
+      uint16_t event_type = kConnectable | (n + 1 < kFragmentsPerAdvertisement ? kContinuation : kComplete);
+      for (size_t i = 0; i < num_advertisers; i++) {
+        auto report = reassembler.ProcessAdvertisingReport(
+            event_type, (uint8_t)AddressType::RANDOM_DEVICE_ADDRESS, addresses[i], 0x1, fragment);
+        if (report.has_value()) {
+          bytes_reassembled += report->data.size();
+          benchmark::DoNotOptimize(report->data.data());
+        }
+      }
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes_reassembled));
+}
+BENCHMARK(BM_ReassembleExtendedAdvertising)->Arg(1)->Arg(4)->Arg(16);
+
+// Replay legacy advertising with scan responses, which goes through
+// the reassembler for every advertising event.
+static void BM_ReassembleLegacyAdvertising(State& state) {
+  static constexpr uint16_t kScannableLegacy = 0x12;
+  static constexpr uint16_t kScanResponseLegacy = 0x1a;
+  Address address({0x00, 0x11, 0x22, 0x33, 0x44, 0x55});
+  std::vector<uint8_t> advertising_data = {0x02, 0x01, 0x06, 0x05, 0x03, 0x0d, 0x18, 0x0f, 0x18};
+  std::vector<uint8_t> scan_response = {0x05, 0x09, 'T', 'e', 's', 't'};
+
+  LeScanningReassembler reassembler;
+  for (auto _ : state) {
+    reassembler.ProcessAdvertisingReport(
+        kScannableLegacy, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, address, 0xff, advertising_data);
+    auto report = reassembler.ProcessAdvertisingReport(
+        kScanResponseLegacy, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, address, 0xff, scan_response);
+    benchmark::DoNotOptimize(report);
+  }
+}
+BENCHMARK(BM_ReassembleLegacyAdvertising);
+
+}  // namespace hci
+}  // namespace bluetooth
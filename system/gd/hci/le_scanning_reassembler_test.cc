@@ -51,35 +51,38 @@ class LeScanningReassemblerTest : public ::testing::Test {
   LeScanningReassembler reassembler_;
 };
 
+static std::vector<uint8_t> to_vector(std::span<const uint8_t> data) {
+  return std::vector<uint8_t>(data.begin(), data.end());
+}
+
 TEST_F(LeScanningReassemblerTest, trim_advertising_data) {
+  auto trim = [](std::vector<uint8_t> data) {
+    data.resize(LeScanningReassembler::TrimAdvertisingData(data.data(), data.size()));
+    return data;
+  };
+
   // TrimAdvertisingData should filter out empty entries.
-  ASSERT_EQ(
-      LeScanningReassembler::TrimAdvertisingData({0x1, 0x2, 0x0, 0x0, 0x3, 0x4, 0x5, 0x6}),
-      std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
+  ASSERT_EQ(trim({0x1, 0x2, 0x0, 0x0, 0x3, 0x4, 0x5, 0x6}), std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 
   // TrimAdvertisingData should remove trailing zeros.
-  ASSERT_EQ(
-      LeScanningReassembler::TrimAdvertisingData({0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x0, 0x0}),
-      std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
+  ASSERT_EQ(trim({0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x0, 0x0}), std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 
   // TrimAdvertisingData should remove overflowing entries.
-  ASSERT_EQ(
-      LeScanningReassembler::TrimAdvertisingData({0x1, 0x2, 0x3, 0x4, 0x5}),
-      std::vector<uint8_t>({0x1, 0x2}));
+  ASSERT_EQ(trim({0x1, 0x2, 0x3, 0x4, 0x5}), std::vector<uint8_t>({0x1, 0x2}));
 }
 
 TEST_F(LeScanningReassemblerTest, non_scannable_legacy_advertising) {
   // Test non scannable legacy advertising.
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kLegacy | kComplete,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x1, 0x2})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kLegacy | kComplete,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x1, 0x2})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2}));
 }
 
@@ -103,7 +106,7 @@ TEST_F(LeScanningReassemblerTest, scannable_non_connectable_legacy_advertising)
       {0x3, 0x4, 0x5, 0x6});
   ASSERT_TRUE(processed_report.has_value());
   ASSERT_EQ(processed_report.value().extended_event_type, kLegacy | kScannable | kScanResponse);
-  ASSERT_EQ(processed_report.value().data, std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
+  ASSERT_EQ(to_vector(processed_report.value().data), std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 
   // Test scannable legacy advertising with padding after the
   // advertising and scan response data.
@@ -117,15 +120,15 @@ TEST_F(LeScanningReassemblerTest, scannable_non_connectable_legacy_advertising)
                    .has_value());
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kLegacy | kScannable | kScanResponse | kComplete,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x3, 0x4, 0x5, 0x6, 0x0, 0x0})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kLegacy | kScannable | kScanResponse | kComplete,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x3, 0x4, 0x5, 0x6, 0x0, 0x0})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 }
 
@@ -149,7 +152,7 @@ TEST_F(LeScanningReassemblerTest, scannable_connectable_legacy_advertising) {
   ASSERT_EQ(
       processed_report.value().extended_event_type,
       kLegacy | kScannable | kScanResponse | kConnectable);
-  ASSERT_EQ(processed_report.value().data, std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
+  ASSERT_EQ(to_vector(processed_report.value().data), std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 }
 
 TEST_F(LeScanningReassemblerTest, non_scannable_extended_advertising) {
@@ -172,7 +175,7 @@ TEST_F(LeScanningReassemblerTest, non_scannable_extended_advertising) {
       {0x4, 0x5, 0x6});
   ASSERT_TRUE(processed_report.has_value());
   ASSERT_EQ(processed_report.value().extended_event_type, kComplete);
-  ASSERT_EQ(processed_report.value().data, std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
+  ASSERT_EQ(to_vector(processed_report.value().data), std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 
   // Test fragmented and truncated non scannable extended advertising.
   // The split may occur in the middle of a GAP entry.
@@ -186,15 +189,15 @@ TEST_F(LeScanningReassemblerTest, non_scannable_extended_advertising) {
                    .has_value());
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kTruncated,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x4, 0x5, 0x6, 0x7})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kTruncated,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x4, 0x5, 0x6, 0x7})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 
   // Test fragmented and truncated anonymous, non scannable
@@ -209,15 +212,15 @@ TEST_F(LeScanningReassemblerTest, non_scannable_extended_advertising) {
                    .has_value());
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kTruncated,
-              (uint8_t)DirectAdvertisingAddressType::NO_ADDRESS_PROVIDED,
-              Address::kEmpty,
-              kSidNotPresent,
-              {0x4, 0x5, 0x6, 0x7})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kTruncated,
+                        (uint8_t)DirectAdvertisingAddressType::NO_ADDRESS_PROVIDED,
+                        Address::kEmpty,
+                        kSidNotPresent,
+                        {0x4, 0x5, 0x6, 0x7})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 }
 
@@ -253,15 +256,15 @@ TEST_F(LeScanningReassemblerTest, scannable_extended_advertising) {
                    .has_value());
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kTruncated,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0xb, 0xc, 0xd, 0xe, 0x0})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kTruncated,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0xb, 0xc, 0xd, 0xe, 0x0})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xa, 0xb, 0xc, 0xd, 0xe}));
 }
 
@@ -277,29 +280,29 @@ TEST_F(LeScanningReassemblerTest, ignore_scan_responses) {
                    .has_value());
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kComplete,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x1, 0x2})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kComplete,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x1, 0x2})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2}));
 
   // The option ignore_scan_responses forces scan responses to be dropped.
   reassembler_.SetIgnoreScanResponses(true);
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kScannable | kComplete,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x1, 0x2})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kScannable | kComplete,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x1, 0x2})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x1, 0x2}));
 }
 
@@ -343,50 +346,113 @@ TEST_F(LeScanningReassemblerTest, interleaved_advertising) {
                    .has_value());
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kComplete,
-              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x0})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kComplete,
+                        (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x0})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x2, 0x0, 0x0}));
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kComplete,
-              (uint8_t)AddressType::RANDOM_DEVICE_ADDRESS,
-              kTestAddress,
-              kSidNotPresent,
-              {0x1})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kComplete,
+                        (uint8_t)AddressType::RANDOM_DEVICE_ADDRESS,
+                        kTestAddress,
+                        kSidNotPresent,
+                        {0x1})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x2, 0x1, 0x1}));
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, {0x2})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, {0x2})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x2, 0x2, 0x2}));
 
   ASSERT_EQ(
-      reassembler_
-          .ProcessAdvertisingReport(
-              kComplete,
-              (uint8_t)DirectAdvertisingAddressType::NO_ADDRESS_PROVIDED,
-              Address::kEmpty,
-              0x1,
-              {0x3})
-          .value()
-          .data,
+      to_vector(reassembler_
+                    .ProcessAdvertisingReport(
+                        kComplete,
+                        (uint8_t)DirectAdvertisingAddressType::NO_ADDRESS_PROVIDED,
+                        Address::kEmpty,
+                        0x1,
+                        {0x3})
+                    .value()
+                    .data),
       std::vector<uint8_t>({0x2, 0x3, 0x3}));
 }
 
+TEST_F(LeScanningReassemblerTest, many_interleaved_advertisers) {
+  // Start more fragmented advertisements than the reassembler can track;
+  // the least recently updated advertisers are dropped.
+  static constexpr uint8_t kNumAdvertisers = 24;
+  for (uint8_t i = 0; i < kNumAdvertisers; i++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessAdvertisingReport(
+                         kContinuation,
+                         (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                         Address({i, 1, 2, 3, 4, 5}),
+                         0x1,
+                         {0x2, i})
+                     .has_value());
+  }
+
+  // The first advertisers were evicted, so their fragments start over.
+  for (uint8_t i = 0; i < kNumAdvertisers - 16; i++) {
+    ASSERT_EQ(
+        to_vector(reassembler_
+                      .ProcessAdvertisingReport(
+                          kComplete,
+                          (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                          Address({i, 1, 2, 3, 4, 5}),
+                          0x1,
+                          {0x1, i})
+                      .value()
+                      .data),
+        std::vector<uint8_t>({0x1, i}));
+  }
+
+  // The most recent advertisers are all completed, in any order.
+  for (uint8_t i = kNumAdvertisers - 1; i >= kNumAdvertisers - 8; i--) {
+    ASSERT_EQ(
+        to_vector(reassembler_
+                      .ProcessAdvertisingReport(
+                          kComplete,
+                          (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                          Address({i, 1, 2, 3, 4, 5}),
+                          0x1,
+                          {i})
+                      .value()
+                      .data),
+        std::vector<uint8_t>({0x2, i, i}));
+  }
+}
+
+TEST_F(LeScanningReassemblerTest, oversized_advertising_data) {
+  // Data past the maximum advertising data length is dropped.
+  std::vector<uint8_t> fragment(251, 0x0);
+  fragment[0] = 250;
+  for (int i = 0; i < 7; i++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessAdvertisingReport(
+                         kContinuation, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, fragment)
+                     .has_value());
+  }
+
+  auto processed_report = reassembler_.ProcessAdvertisingReport(
+      kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, fragment);
+  ASSERT_TRUE(processed_report.has_value());
+  ASSERT_EQ(processed_report.value().data.size(), 6u * 251u);
+}
+
 TEST_F(LeScanningReassemblerTest, periodic_advertising) {
   // Test periodic advertising.
   ASSERT_FALSE(
@@ -20,6 +20,8 @@
 #include <com_android_bluetooth_flags.h>
 #include <hardware/bt_common_types.h>
 
+#include <queue>
+
 #include "hal/hci_hal.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
@@ -148,7 +150,7 @@ struct MsftExtensionManager::impl {
       }
 
       if (monitor.condition_type == MSFT_CONDITION_TYPE_ADDRESS) {
-        msft_adv_monitor_add_cb_ = cb;
+        msft_adv_monitor_add_cbs_.push(cb);
         Address addr;
         Address::FromString(monitor.addr_info.bd_addr.ToString(), addr);
         hci_layer_->EnqueueCommand(
@@ -182,7 +184,7 @@ struct MsftExtensionManager::impl {
       patterns.push_back(pattern);
     }
 
-    msft_adv_monitor_add_cb_ = cb;
+    msft_adv_monitor_add_cbs_.push(cb);
     hci_layer_->EnqueueCommand(
         MsftLeMonitorAdvConditionPatternsBuilder::Create(
             static_cast<OpCode>(msft_.opcode.value()),
@@ -200,7 +202,7 @@ struct MsftExtensionManager::impl {
       return;
     }
 
-    msft_adv_monitor_remove_cb_ = cb;
+    msft_adv_monitor_remove_cbs_.push(cb);
     hci_layer_->EnqueueCommand(
         MsftLeCancelMonitorAdvBuilder::Create(
             static_cast<OpCode>(msft_.opcode.value()), monitor_handle),
@@ -213,7 +215,7 @@ struct MsftExtensionManager::impl {
       return;
     }
 
-    msft_adv_monitor_enable_cb_ = cb;
+    msft_adv_monitor_enable_cbs_.push(cb);
     hci_layer_->EnqueueCommand(
         MsftLeSetAdvFilterEnableBuilder::Create(static_cast<OpCode>(msft_.opcode.value()), enable),
         module_handler_->BindOnceOn(this, &impl::on_msft_adv_monitor_enable_complete));
@@ -270,6 +272,8 @@ struct MsftExtensionManager::impl {
     auto status_view =
         MsftLeMonitorAdvCommandCompleteView::Create(MsftCommandCompleteView::Create(view));
     log::assert_that(status_view.IsValid(), "assert failed: status_view.IsValid()");
+    auto cb = std::move(msft_adv_monitor_add_cbs_.front());
+    msft_adv_monitor_add_cbs_.pop();
 
     MsftSubcommandOpcode sub_opcode = status_view.GetSubcommandOpcode();
     if (sub_opcode != MsftSubcommandOpcode::MSFT_LE_MONITOR_ADV) {
@@ -277,7 +281,7 @@ struct MsftExtensionManager::impl {
       return;
     }
 
-    msft_adv_monitor_add_cb_.Run(status_view.GetMonitorHandle(), status_view.GetStatus());
+    cb.Run(status_view.GetMonitorHandle(), status_view.GetStatus());
   }
 
   void on_msft_adv_monitor_remove_complete(CommandCompleteView view) {
@@ -285,6 +289,8 @@ struct MsftExtensionManager::impl {
     auto status_view =
         MsftLeCancelMonitorAdvCommandCompleteView::Create(MsftCommandCompleteView::Create(view));
     log::assert_that(status_view.IsValid(), "assert failed: status_view.IsValid()");
+    auto cb = std::move(msft_adv_monitor_remove_cbs_.front());
+    msft_adv_monitor_remove_cbs_.pop();
 
     MsftSubcommandOpcode sub_opcode = status_view.GetSubcommandOpcode();
     if (sub_opcode != MsftSubcommandOpcode::MSFT_LE_CANCEL_MONITOR_ADV) {
@@ -292,7 +298,7 @@ struct MsftExtensionManager::impl {
       return;
     }
 
-    msft_adv_monitor_remove_cb_.Run(status_view.GetStatus());
+    cb.Run(status_view.GetStatus());
   }
 
   void on_msft_adv_monitor_enable_complete(CommandCompleteView view) {
@@ -300,6 +306,8 @@ struct MsftExtensionManager::impl {
     auto status_view =
         MsftLeSetAdvFilterEnableCommandCompleteView::Create(MsftCommandCompleteView::Create(view));
     log::assert_that(status_view.IsValid(), "assert failed: status_view.IsValid()");
+    auto cb = std::move(msft_adv_monitor_enable_cbs_.front());
+    msft_adv_monitor_enable_cbs_.pop();
 
     MsftSubcommandOpcode sub_opcode = status_view.GetSubcommandOpcode();
     if (sub_opcode != MsftSubcommandOpcode::MSFT_LE_SET_ADV_FILTER_ENABLE) {
@@ -307,7 +315,7 @@ struct MsftExtensionManager::impl {
       return;
     }
 
-    msft_adv_monitor_enable_cb_.Run(status_view.GetStatus());
+    cb.Run(status_view.GetStatus());
   }
 
   Module* module_;
@@ -315,9 +323,10 @@ struct MsftExtensionManager::impl {
   hal::HciHal* hal_;
   hci::HciLayer* hci_layer_;
   Msft msft_;
-  MsftAdvMonitorAddCallback msft_adv_monitor_add_cb_;
-  MsftAdvMonitorRemoveCallback msft_adv_monitor_remove_cb_;
-  MsftAdvMonitorEnableCallback msft_adv_monitor_enable_cb_;
+  // Commands complete in the order they are sent, so do their callbacks
+  std::queue<MsftAdvMonitorAddCallback> msft_adv_monitor_add_cbs_;
+  std::queue<MsftAdvMonitorRemoveCallback> msft_adv_monitor_remove_cbs_;
+  std::queue<MsftAdvMonitorEnableCallback> msft_adv_monitor_enable_cbs_;
   ScanningCallback* scanning_callbacks_;
 };
 
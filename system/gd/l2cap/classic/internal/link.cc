@@ -47,7 +47,13 @@ Link::Link(
     LinkManager* link_manager)
     : l2cap_handler_(l2cap_handler),
       acl_connection_(std::move(acl_connection)),
-      data_pipeline_manager_(l2cap_handler, this, acl_connection_->GetAclQueueEnd()),
+      data_pipeline_manager_(
+          l2cap_handler,
+          this,
+          acl_connection_->GetAclQueueEnd(),
+          parameter_provider->IsClassicWeightedSchedulerEnabled()
+              ? l2cap::internal::DataPipelineManager::SchedulerType::DEFICIT_ROUND_ROBIN
+              : l2cap::internal::DataPipelineManager::SchedulerType::FIFO),
       parameter_provider_(parameter_provider),
       dynamic_service_manager_(dynamic_service_manager),
       fixed_service_manager_(fixed_service_manager),
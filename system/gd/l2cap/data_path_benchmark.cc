@@ -0,0 +1,692 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// End to end data path benchmarks: SDUs go down from a channel through L2CAP, the ACL manager and
+// the HCI layer to a loopback HAL, which plays the remote device and sends every packet back up.
+// Each benchmark reports the throughput, the CPU time the stack spent per MB on all of its threads
+// and the round trip latency of the SDUs.
+
+#include <bluetooth/log.h>
+#include <gmock/gmock.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "hal/hci_hal.h"
+#include "hci/acl_manager.h"
+#include "hci/controller_mock.h"
+#include "hci/hci_layer.h"
+#include "hci/hci_packets.h"
+#include "l2cap/classic/internal/channel_configuration_state.h"
+#include "l2cap/internal/channel_impl.h"
+#include "l2cap/internal/data_pipeline_manager.h"
+#include "l2cap/internal/ilink.h"
+#include "l2cap/internal/le_credit_based_channel_data_controller.h"
+#include "l2cap/l2cap_packets.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/queue.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+
+static constexpr auto kTimeout = std::chrono::seconds(5);
+static constexpr uint16_t kClassicHandle = 0x0001;
+static constexpr uint16_t kLeHandle = 0x0002;
+static constexpr uint16_t kIsoHandle = 0x0060;
+static constexpr Cid kCid = 0x0040;
+static constexpr uint16_t kAclPacketLength = 1021;
+static constexpr uint16_t kNumAclPackets = 8;
+static constexpr uint16_t kLePacketLength = 251;
+static constexpr uint16_t kNumLePackets = 8;
+static constexpr uint16_t kErtmMps = 1010;
+static constexpr uint8_t kErtmTxWindow = 10;
+static constexpr uint16_t kLeMps = kLePacketLength - 4;
+static constexpr uint16_t kLeInitialCredits = 10;
+// SDUs sent but not looped back yet, as an application streaming with a bounded queue would have
+static constexpr size_t kMaxInFlight = 8;
+
+static const hci::Address kRemote({0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6});
+
+// Controller of the loopback: reports the buffer sizes, and returns the ACL credit of each packet
+// as soon as the HAL looped it back.
+class LoopbackController : public hci::testing::MockController {
+ public:
+  void RegisterCompletedAclPacketsCallback(
+      common::ContextualCallback<void(uint16_t /* handle */, uint16_t /* packets */)> cb) override {
+    acl_cb_ = cb;
+  }
+
+  void UnregisterCompletedAclPacketsCallback() override {
+    acl_cb_ = {};
+  }
+
+  uint16_t GetAclPacketLength() const override {
+    return kAclPacketLength;
+  }
+
+  uint16_t GetNumAclPacketBuffers() const override {
+    return kNumAclPackets;
+  }
+
+  bool IsSupported(hci::OpCode /* op_code */) const override {
+    return false;
+  }
+
+  hci::LeBufferSize GetLeBufferSize() const override {
+    hci::LeBufferSize le_buffer_size;
+    le_buffer_size.total_num_le_packets_ = kNumLePackets;
+    le_buffer_size.le_data_packet_length_ = kLePacketLength;
+    return le_buffer_size;
+  }
+
+  void CompletePackets(uint16_t handle, uint16_t packets) {
+    acl_cb_(handle, packets);
+  }
+
+ protected:
+  void Start() override {}
+  void Stop() override {}
+  void ListDependencies(ModuleList* /* list */) const override {}
+
+ private:
+  common::ContextualCallback<void(uint16_t /* handle */, uint16_t /* packets */)> acl_cb_;
+};
+
+// HAL playing the remote device on its own thread, as a transport would: commands complete at
+// once, connection requests succeed, and ACL and ISO data comes back on the same handle.
+class LoopbackHciHal : public hal::HciHal {
+ public:
+  explicit LoopbackHciHal(LoopbackController* controller) : controller_(controller) {}
+
+  void registerIncomingPacketCallback(hal::HciHalCallbacks* callbacks) override {
+    callbacks_ = callbacks;
+  }
+
+  void unregisterIncomingPacketCallback() override {
+    callbacks_ = nullptr;
+  }
+
+  void sendHciCommand(hal::HciPacket command) override {
+    handler_->CallOn(this, &LoopbackHciHal::on_command, std::move(command));
+  }
+
+  void sendAclData(hal::HciPacket data) override {
+    handler_->CallOn(this, &LoopbackHciHal::on_acl, std::move(data));
+  }
+
+  void sendScoData(hal::HciPacket /* data */) override {}
+
+  void sendIsoData(hal::HciPacket data) override {
+    handler_->CallOn(this, &LoopbackHciHal::on_iso, std::move(data));
+  }
+
+  // Act as the ERTM peer of |cid|: the looped back I-frames acknowledge themselves and the
+  // S-frames of the host are consumed, so that both ends agree on the sequence numbers.
+  void SetErtmPeer(Cid cid) {
+    ertm_cid_ = cid;
+  }
+
+  void WaitForIdle() {
+    thread_->GetReactor()->WaitForIdle(kTimeout);
+  }
+
+  std::string ToString() const override {
+    return std::string("LoopbackHciHal");
+  }
+
+ protected:
+  void Start() override {
+    thread_ = new os::Thread("loopback_hal", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+  }
+
+  void Stop() override {
+    handler_->Clear();
+    handler_->WaitUntilStopped(kTimeout);
+    delete handler_;
+    delete thread_;
+  }
+
+  void ListDependencies(ModuleList* /* list */) const override {}
+
+ private:
+  // Positions in an ACL packet carrying the start of an L2CAP frame
+  static constexpr size_t kAclFlagsOffset = 1;
+  static constexpr size_t kCidOffset = 6;
+  static constexpr size_t kControlOffset = 8;
+  static constexpr uint8_t kPacketBoundaryMask = 0x30;
+  static constexpr uint8_t kContinuingFragment = 0x10;
+  static constexpr uint8_t kFirstAutomaticallyFlushable = 0x20;
+  static constexpr uint8_t kSupervisoryFrame = 0x01;
+  static constexpr uint8_t kSequenceMask = 0x3f;
+
+  void send_event(std::unique_ptr<packet::BasePacketBuilder> event) {
+    hal::HciPacket bytes;
+    event->SerializeTo(bytes);
+    auto callbacks = callbacks_.load();
+    if (callbacks != nullptr) {
+      callbacks->hciEventReceived(std::move(bytes));
+    }
+  }
+
+  void on_command(hal::HciPacket bytes) {
+    auto command = hci::CommandView::Create(
+        packet::PacketView<packet::kLittleEndian>(std::make_shared<hal::HciPacket>(std::move(bytes))));
+    log::assert_that(command.IsValid(), "assert failed: command.IsValid()");
+    hci::OpCode op_code = command.GetOpCode();
+    switch (op_code) {
+      case hci::OpCode::CREATE_CONNECTION:
+        send_event(hci::CommandStatusBuilder::Create(
+            hci::ErrorCode::SUCCESS, 1, op_code, std::make_unique<packet::RawBuilder>()));
+        send_event(hci::ConnectionCompleteBuilder::Create(
+            hci::ErrorCode::SUCCESS, kClassicHandle, kRemote, hci::LinkType::ACL, hci::Enable::DISABLED));
+        break;
+      case hci::OpCode::LE_CREATE_CONNECTION:
+        send_event(hci::CommandStatusBuilder::Create(
+            hci::ErrorCode::SUCCESS, 1, op_code, std::make_unique<packet::RawBuilder>()));
+        send_event(hci::LeConnectionCompleteBuilder::Create(
+            hci::ErrorCode::SUCCESS,
+            kLeHandle,
+            hci::Role::CENTRAL,
+            hci::AddressType::PUBLIC_DEVICE_ADDRESS,
+            kRemote,
+            0x0018,
+            0x0000,
+            0x01f4,
+            hci::ClockAccuracy::PPM_30));
+        break;
+      default:
+        // The commands the data path issues only return a status
+        send_event(hci::CommandCompleteBuilder::Create(
+            1,
+            op_code,
+            std::make_unique<packet::RawBuilder>(
+                std::vector<uint8_t>{static_cast<uint8_t>(hci::ErrorCode::SUCCESS)})));
+        break;
+    }
+  }
+
+  void on_acl(hal::HciPacket packet) {
+    uint16_t handle = (packet[0] | (packet[1] << 8)) & 0x0fff;
+    if ((packet[kAclFlagsOffset] & kPacketBoundaryMask) != kContinuingFragment) {
+      // The host only accepts automatically flushable starts from a controller
+      packet[kAclFlagsOffset] =
+          (packet[kAclFlagsOffset] & ~kPacketBoundaryMask) | kFirstAutomaticallyFlushable;
+      if (ertm_cid_ != 0 && packet.size() > kControlOffset + 1 &&
+          (packet[kCidOffset] | (packet[kCidOffset + 1] << 8)) == ertm_cid_) {
+        if (packet[kControlOffset] & kSupervisoryFrame) {
+          controller_->CompletePackets(handle, 1);
+          return;
+        }
+        uint8_t tx_seq = (packet[kControlOffset] >> 1) & kSequenceMask;
+        packet[kControlOffset + 1] =
+            (packet[kControlOffset + 1] & ~kSequenceMask) | ((tx_seq + 1) & kSequenceMask);
+      }
+    }
+    auto callbacks = callbacks_.load();
+    if (callbacks != nullptr) {
+      callbacks->aclDataReceived(std::move(packet));
+    }
+    controller_->CompletePackets(handle, 1);
+  }
+
+  void on_iso(hal::HciPacket packet) {
+    auto callbacks = callbacks_.load();
+    if (callbacks != nullptr) {
+      callbacks->isoDataReceived(std::move(packet));
+    }
+  }
+
+  LoopbackController* controller_;
+  std::atomic<hal::HciHalCallbacks*> callbacks_ = nullptr;
+  Cid ertm_cid_ = 0;
+  os::Thread* thread_ = nullptr;
+  os::Handler* handler_ = nullptr;
+};
+
+// Stamps the SDUs with a sequence number, keeps at most kMaxInFlight of them outstanding and
+// measures how long each took to come back.
+class LoopbackFlow {
+ public:
+  // Returns the next SDU of |size| bytes, once the window has room for it
+  std::vector<uint8_t> NextSdu(size_t size) {
+    std::vector<uint8_t> sdu(std::max<size_t>(size, sizeof(uint32_t)), 0x5a);
+    std::unique_lock<std::mutex> lock(mutex_);
+    log::assert_that(
+        cv_.wait_for(lock, kTimeout, [this] { return sent_times_.size() - received_ < kMaxInFlight; }),
+        "SDU {} was not looped back",
+        received_);
+    uint32_t sequence = sent_times_.size();
+    std::copy_n(reinterpret_cast<uint8_t*>(&sequence), sizeof(sequence), sdu.begin());
+    sent_times_.push_back(std::chrono::steady_clock::now());
+    return sdu;
+  }
+
+  void OnReceived(packet::PacketView<packet::kLittleEndian> sdu) {
+    auto now = std::chrono::steady_clock::now();
+    auto it = sdu.begin();
+    uint32_t sequence = it.extract<uint32_t>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    log::assert_that(sequence < sent_times_.size(), "unexpected SDU {}", sequence);
+    latencies_.push_back(now - sent_times_[sequence]);
+    received_++;
+    bytes_received_ += sdu.size();
+    cv_.notify_all();
+  }
+
+  void WaitForAll() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    log::assert_that(
+        cv_.wait_for(lock, kTimeout, [this] { return received_ == sent_times_.size(); }),
+        "{} SDUs were not looped back",
+        sent_times_.size() - received_);
+  }
+
+  void Report(State& state, std::chrono::microseconds cpu_time) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state.SetBytesProcessed(static_cast<int64_t>(bytes_received_));
+    state.SetItemsProcessed(static_cast<int64_t>(received_));
+    if (bytes_received_ > 0) {
+      state.counters["cpu_us_per_MB"] = cpu_time.count() / (bytes_received_ / 1e6);
+    }
+    if (!latencies_.empty()) {
+      std::sort(latencies_.begin(), latencies_.end());
+      state.counters["p50_us"] = percentile(0.50).count();
+      state.counters["p99_us"] = percentile(0.99).count();
+    }
+  }
+
+ private:
+  std::chrono::duration<double, std::micro> percentile(double fraction) const {
+    return latencies_[static_cast<size_t>(fraction * (latencies_.size() - 1))];
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::chrono::steady_clock::time_point> sent_times_;
+  std::vector<std::chrono::steady_clock::duration> latencies_;
+  size_t received_ = 0;
+  size_t bytes_received_ = 0;
+};
+
+// User and system time of all the threads of the process
+static std::chrono::microseconds ProcessCpuTime() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+class LoopbackChannel : public internal::ChannelImpl {
+ public:
+  common::BidiQueueEnd<packet::BasePacketBuilder, packet::PacketView<packet::kLittleEndian>>* GetQueueUpEnd()
+      override {
+    return queue_.GetUpEnd();
+  }
+
+  common::BidiQueueEnd<packet::PacketView<packet::kLittleEndian>, packet::BasePacketBuilder>* GetQueueDownEnd()
+      override {
+    return queue_.GetDownEnd();
+  }
+
+  Cid GetCid() const override {
+    return kCid;
+  }
+
+  // The loopback sends the frames back on the channel they were sent to
+  Cid GetRemoteCid() const override {
+    return kCid;
+  }
+
+ private:
+  common::BidiQueue<packet::PacketView<packet::kLittleEndian>, packet::BasePacketBuilder> queue_{10};
+};
+
+// Link of the L2CAP pipeline. As the looped back K-frames stand for the remote sending, the
+// credits the host returns to the remote are also the credits the remote grants the host.
+class LoopbackLink : public internal::ILink {
+ public:
+  explicit LoopbackLink(os::Handler* handler) : handler_(handler) {}
+
+  void SendDisconnectionRequest(Cid local_cid, Cid /* remote_cid */) override {
+    log::fatal("Channel {} closed by the data controller", local_cid);
+  }
+
+  hci::AddressWithType GetDevice() const override {
+    return hci::AddressWithType(kRemote, hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+  }
+
+  void SendLeCredit(Cid /* local_cid */, uint16_t credit) override {
+    handler_->CallOn(le_controller_, &internal::LeCreditBasedDataController::OnCredit, credit);
+  }
+
+  internal::LeCreditBasedDataController* le_controller_ = nullptr;
+
+ private:
+  os::Handler* handler_;
+};
+
+// The gd stack from the HCI layer to the ACL manager on top of the loopback HAL, with helpers to
+// open each kind of data path over it.
+class DataPathStack : public hci::acl_manager::ConnectionCallbacks,
+                      public hci::acl_manager::LeConnectionCallbacks {
+ public:
+  DataPathStack() {
+    controller_ = new ::testing::NiceMock<LoopbackController>;  // Ownership is transferred to registry
+    hal_ = new LoopbackHciHal(controller_);                    // Ownership is transferred to registry
+    registry_.InjectTestModule(&hal::HciHal::Factory, hal_);
+    registry_.InjectTestModule(&hci::Controller::Factory, controller_);
+    registry_.Start<hci::AclManager>(&registry_.GetTestThread());
+    acl_manager_ = registry_.GetModuleUnderTest<hci::AclManager>();
+    hci_layer_ = registry_.GetModuleUnderTest<hci::HciLayer>();
+    l2cap_handler_ = new os::Handler(&registry_.GetTestThread());
+    client_handler_ = new os::Handler(&client_thread_);
+    link_ = std::make_unique<LoopbackLink>(l2cap_handler_);
+
+    acl_manager_->RegisterCallbacks(this, client_handler_);
+    acl_manager_->RegisterLeCallbacks(this, client_handler_);
+    acl_manager_->SetPrivacyPolicyForInitiatorAddress(
+        hci::LeAddressManager::AddressPolicy::USE_STATIC_ADDRESS,
+        hci::AddressWithType(
+            hci::Address({0x01, 0x02, 0x03, 0x04, 0x05, 0xc6}), hci::AddressType::RANDOM_DEVICE_ADDRESS),
+        std::chrono::minutes(7),
+        std::chrono::minutes(15));
+  }
+
+  ~DataPathStack() {
+    hal_->WaitForIdle();
+    registry_.GetTestThread().GetReactor()->WaitForIdle(kTimeout);
+    client_thread_.GetReactor()->WaitForIdle(kTimeout);
+    if (up_end_ != nullptr) {
+      up_end_->UnregisterDequeue();
+    }
+    if (iso_up_end_ != nullptr) {
+      iso_up_end_->UnregisterDequeue();
+    }
+    enqueue_buffer_.reset();
+    iso_enqueue_buffer_.reset();
+    l2cap_handler_->Clear();
+    l2cap_handler_->WaitUntilStopped(kTimeout);
+    pipeline_.reset();
+    channel_.reset();
+    classic_connection_.reset();
+    le_connection_.reset();
+    client_handler_->Clear();
+    client_handler_->WaitUntilStopped(kTimeout);
+    registry_.StopAll();
+    delete l2cap_handler_;
+    delete client_handler_;
+  }
+
+  // Send and receive L2CAP frames directly on a classic ACL connection
+  void OpenAcl() {
+    connect_classic();
+    open(classic_connection_->GetAclQueueEnd());
+  }
+
+  // Send and receive SDUs on a classic channel in basic or enhanced retransmission mode
+  void OpenClassicChannel(RetransmissionAndFlowControlModeOption mode) {
+    connect_classic();
+    attach_channel(classic_connection_->GetAclQueueEnd(), internal::DataPipelineManager::ChannelMode::BASIC);
+    if (mode == RetransmissionAndFlowControlModeOption::ENHANCED_RETRANSMISSION) {
+      hal_->SetErtmPeer(kCid);
+      RetransmissionAndFlowControlConfigurationOption option;
+      option.mode_ = mode;
+      option.tx_window_size_ = kErtmTxWindow;
+      option.max_transmit_ = 3;
+      option.retransmission_time_out_ = 2000;
+      option.monitor_time_out_ = 12000;
+      option.maximum_pdu_size_ = kErtmMps;
+      classic::internal::ChannelConfigurationState config;
+      config.retransmission_and_flow_control_mode_ = mode;
+      config.local_retransmission_and_flow_control_ = option;
+      config.remote_retransmission_and_flow_control_ = option;
+      config.fcs_type_ = FcsType::NO_FCS;
+      std::promise<void> configured;
+      l2cap_handler_->Post(common::BindOnce(
+          [](internal::DataPipelineManager* pipeline,
+             classic::internal::ChannelConfigurationState config,
+             std::promise<void> configured) {
+            pipeline->UpdateClassicConfiguration(kCid, config);
+            configured.set_value();
+          },
+          pipeline_.get(),
+          config,
+          std::move(configured)));
+      wait(configured.get_future(), "ERTM configuration");
+    }
+  }
+
+  // Send and receive SDUs on an LE credit based channel
+  void OpenLeChannel(Mtu mtu) {
+    connect_le();
+    attach_channel(le_connection_->GetAclQueueEnd(), internal::DataPipelineManager::ChannelMode::LE_CREDIT_BASED);
+    std::promise<void> configured;
+    l2cap_handler_->Post(common::BindOnce(
+        [](internal::DataPipelineManager* pipeline, LoopbackLink* link, Mtu mtu, std::promise<void> configured) {
+          auto controller =
+              static_cast<internal::LeCreditBasedDataController*>(pipeline->GetDataController(kCid));
+          controller->SetMtu(mtu);
+          controller->SetMps(kLeMps);
+          controller->OnCredit(kLeInitialCredits);
+          link->le_controller_ = controller;
+          configured.set_value();
+        },
+        pipeline_.get(),
+        link_.get(),
+        mtu,
+        std::move(configured)));
+    wait(configured.get_future(), "LE channel configuration");
+  }
+
+  // Send and receive complete SDUs on an ISO data path
+  void OpenIso() {
+    iso_up_end_ = hci_layer_->GetIsoQueueEnd();
+    iso_enqueue_buffer_ = std::make_unique<os::EnqueueBuffer<hci::IsoBuilder>>(iso_up_end_);
+    iso_up_end_->RegisterDequeue(client_handler_, common::Bind(&DataPathStack::on_iso_ready, common::Unretained(this)));
+  }
+
+  // Send one SDU on the open data path
+  void Send(std::vector<uint8_t> sdu) {
+    if (iso_enqueue_buffer_ != nullptr) {
+      uint16_t length = sdu.size();
+      iso_enqueue_buffer_->Enqueue(
+          hci::IsoWithoutTimestampBuilder::Create(
+              kIsoHandle,
+              hci::IsoPacketBoundaryFlag::COMPLETE_SDU,
+              iso_sequence_number_++,
+              length,
+              hci::IsoPacketStatusFlag::VALID,
+              std::make_unique<packet::RawBuilder>(std::move(sdu))),
+          client_handler_);
+    } else if (raw_acl_) {
+      enqueue_buffer_->Enqueue(
+          BasicFrameBuilder::Create(kCid, std::make_unique<packet::RawBuilder>(std::move(sdu))), client_handler_);
+    } else {
+      enqueue_buffer_->Enqueue(std::make_unique<packet::RawBuilder>(std::move(sdu)), client_handler_);
+    }
+  }
+
+  LoopbackFlow flow_;
+
+ private:
+  using QueueUpEnd = common::BidiQueueEnd<packet::BasePacketBuilder, packet::PacketView<packet::kLittleEndian>>;
+
+  void OnConnectSuccess(std::unique_ptr<hci::acl_manager::ClassicAclConnection> connection) override {
+    classic_connection_ = std::move(connection);
+    classic_connected_.set_value();
+  }
+
+  void OnConnectRequest(hci::Address /* address */, hci::ClassOfDevice /* cod */) override {}
+
+  void OnConnectFail(hci::Address address, hci::ErrorCode reason, bool /* locally_initiated */) override {
+    log::fatal("Connection to {} failed: {}", address, hci::ErrorCodeText(reason));
+  }
+
+  void OnLeConnectSuccess(
+      hci::AddressWithType /* address_with_type */,
+      std::unique_ptr<hci::acl_manager::LeAclConnection> connection) override {
+    le_connection_ = std::move(connection);
+    le_connected_.set_value();
+  }
+
+  void OnLeConnectFail(hci::AddressWithType address_with_type, hci::ErrorCode reason) override {
+    log::fatal("LE connection to {} failed: {}", address_with_type, hci::ErrorCodeText(reason));
+  }
+
+  void wait(std::future<void> future, const char* what) {
+    log::assert_that(future.wait_for(kTimeout) == std::future_status::ready, "{} timed out", what);
+  }
+
+  void connect_classic() {
+    acl_manager_->CreateConnection(kRemote);
+    wait(classic_connected_.get_future(), "Classic connection");
+  }
+
+  void connect_le() {
+    acl_manager_->CreateLeConnection(
+        hci::AddressWithType(kRemote, hci::AddressType::PUBLIC_DEVICE_ADDRESS), true /* is_direct */);
+    wait(le_connected_.get_future(), "LE connection");
+  }
+
+  void open(QueueUpEnd* up_end) {
+    raw_acl_ = true;
+    up_end_ = up_end;
+    enqueue_buffer_ = std::make_unique<os::EnqueueBuffer<packet::BasePacketBuilder>>(up_end_);
+    up_end_->RegisterDequeue(client_handler_, common::Bind(&DataPathStack::on_data_ready, common::Unretained(this)));
+  }
+
+  void attach_channel(QueueUpEnd* link_queue_up_end, internal::DataPipelineManager::ChannelMode mode) {
+    channel_ = std::make_shared<LoopbackChannel>();
+    std::promise<void> attached;
+    l2cap_handler_->Post(common::BindOnce(
+        [](DataPathStack* stack,
+           QueueUpEnd* link_queue_up_end,
+           internal::DataPipelineManager::ChannelMode mode,
+           std::promise<void> attached) {
+          stack->pipeline_ = std::make_unique<internal::DataPipelineManager>(
+              stack->l2cap_handler_, stack->link_.get(), link_queue_up_end);
+          stack->pipeline_->AttachChannel(kCid, stack->channel_, mode);
+          attached.set_value();
+        },
+        common::Unretained(this),
+        link_queue_up_end,
+        mode,
+        std::move(attached)));
+    wait(attached.get_future(), "Channel attachment");
+    up_end_ = channel_->GetQueueUpEnd();
+    enqueue_buffer_ = std::make_unique<os::EnqueueBuffer<packet::BasePacketBuilder>>(up_end_);
+    up_end_->RegisterDequeue(client_handler_, common::Bind(&DataPathStack::on_data_ready, common::Unretained(this)));
+  }
+
+  void on_data_ready() {
+    auto packet = up_end_->TryDequeue();
+    if (raw_acl_) {
+      flow_.OnReceived(BasicFrameView::Create(*packet).GetPayload());
+    } else {
+      flow_.OnReceived(*packet);
+    }
+  }
+
+  void on_iso_ready() {
+    auto packet = iso_up_end_->TryDequeue();
+    flow_.OnReceived(hci::IsoWithoutTimestampView::Create(*packet).GetPayload());
+  }
+
+  TestModuleRegistry registry_;
+  os::Thread client_thread_{"benchmark_client", os::Thread::Priority::NORMAL};
+  LoopbackController* controller_ = nullptr;
+  LoopbackHciHal* hal_ = nullptr;
+  hci::AclManager* acl_manager_ = nullptr;
+  hci::HciLayer* hci_layer_ = nullptr;
+  os::Handler* l2cap_handler_ = nullptr;
+  os::Handler* client_handler_ = nullptr;
+  std::unique_ptr<LoopbackLink> link_;
+  std::promise<void> classic_connected_;
+  std::promise<void> le_connected_;
+  std::unique_ptr<hci::acl_manager::ClassicAclConnection> classic_connection_;
+  std::unique_ptr<hci::acl_manager::LeAclConnection> le_connection_;
+  std::shared_ptr<LoopbackChannel> channel_;
+  std::unique_ptr<internal::DataPipelineManager> pipeline_;
+  bool raw_acl_ = false;
+  QueueUpEnd* up_end_ = nullptr;
+  std::unique_ptr<os::EnqueueBuffer<packet::BasePacketBuilder>> enqueue_buffer_;
+  common::BidiQueueEnd<hci::IsoBuilder, hci::IsoView>* iso_up_end_ = nullptr;
+  std::unique_ptr<os::EnqueueBuffer<hci::IsoBuilder>> iso_enqueue_buffer_;
+  uint16_t iso_sequence_number_ = 0;
+};
+
+// Loop SDUs of state.range(0) bytes through the open data path of |stack|
+static void RunDataPath(State& state, DataPathStack& stack) {
+  auto cpu_start = ProcessCpuTime();
+  for (auto _ : state) {
+    stack.Send(stack.flow_.NextSdu(state.range(0)));
+  }
+  stack.flow_.WaitForAll();
+  stack.flow_.Report(state, ProcessCpuTime() - cpu_start);
+}
+
+static void BM_AclLoopback(State& state) {
+  DataPathStack stack;
+  stack.OpenAcl();
+  RunDataPath(state, stack);
+}
+BENCHMARK(BM_AclLoopback)->Arg(64)->Arg(kAclPacketLength - 4)->Arg(4096)->UseRealTime();
+
+static void BM_BasicChannelLoopback(State& state) {
+  DataPathStack stack;
+  stack.OpenClassicChannel(RetransmissionAndFlowControlModeOption::L2CAP_BASIC);
+  RunDataPath(state, stack);
+}
+BENCHMARK(BM_BasicChannelLoopback)->Arg(64)->Arg(672)->Arg(4096)->UseRealTime();
+
+static void BM_ErtmChannelLoopback(State& state) {
+  DataPathStack stack;
+  stack.OpenClassicChannel(RetransmissionAndFlowControlModeOption::ENHANCED_RETRANSMISSION);
+  RunDataPath(state, stack);
+}
+BENCHMARK(BM_ErtmChannelLoopback)->Arg(64)->Arg(kErtmMps)->Arg(4096)->UseRealTime();
+
+static void BM_LeCreditBasedChannelLoopback(State& state) {
+  DataPathStack stack;
+  stack.OpenLeChannel(static_cast<Mtu>(state.range(0)));
+  RunDataPath(state, stack);
+}
+BENCHMARK(BM_LeCreditBasedChannelLoopback)->Arg(64)->Arg(kLeMps - 2)->Arg(2048)->UseRealTime();
+
+static void BM_IsoLoopback(State& state) {
+  DataPathStack stack;
+  stack.OpenIso();
+  RunDataPath(state, stack);
+}
+BENCHMARK(BM_IsoLoopback)->Arg(40)->Arg(120)->Arg(251)->UseRealTime();
+
+}  // namespace l2cap
+}  // namespace bluetooth
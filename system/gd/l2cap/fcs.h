@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace bluetooth {
@@ -28,8 +29,13 @@ class Fcs {
 
   void AddByte(uint8_t byte);
 
+  void AddBytes(const uint8_t* data, size_t length);
+
   uint16_t GetChecksum() const;
 
+  // Continues |fcs| over |length| bytes at |data|. Shared with the legacy stack's ERTM code.
+  static uint16_t Update(uint16_t fcs, const uint8_t* data, size_t length);
+
  private:
   uint16_t crc;
 };
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "l2cap/fcs.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+
+static std::vector<uint8_t> MakeFrame(size_t length) {
+  std::vector<uint8_t> frame(length);
+  for (size_t i = 0; i < length; i++) {
+    frame[i] = static_cast<uint8_t>(i * 31);
+  }
+  return frame;
+}
+
+static void BM_FcsAddByte(State& state) {
+  auto frame = MakeFrame(state.range(0));
+  Fcs fcs;
+  for (auto _ : state) {
+    fcs.Initialize();
+    for (auto byte : frame) {
+      fcs.AddByte(byte);
+    }
+    benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_FcsAddByte)->Arg(48)->Arg(672)->Arg(1021);
+
+static void BM_FcsUpdate(State& state) {
+  auto frame = MakeFrame(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Fcs::Update(0, frame.data(), frame.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_FcsUpdate)->Arg(48)->Arg(672)->Arg(1021);
+
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/fcs.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace l2cap {
+namespace {
+
+uint16_t bytewise_fcs(const std::vector<uint8_t>& data) {
+  Fcs fcs;
+  fcs.Initialize();
+  for (auto byte : data) {
+    fcs.AddByte(byte);
+  }
+  return fcs.GetChecksum();
+}
+
+TEST(FcsTest, known_value) {
+  // I-frame from the L2CAP test specification, FCS 0x6138
+  std::vector<uint8_t> frame = {0x0e, 0x00, 0x40, 0x00, 0x02, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                0x07, 0x08, 0x09};
+  ASSERT_EQ(0x6138, bytewise_fcs(frame));
+  ASSERT_EQ(0x6138, Fcs::Update(0, frame.data(), frame.size()));
+}
+
+TEST(FcsTest, sliced_matches_bytewise_for_all_lengths) {
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < 100; i++) {
+    ASSERT_EQ(bytewise_fcs(data), Fcs::Update(0, data.data(), data.size())) << "length " << data.size();
+    data.push_back(static_cast<uint8_t>(i * 37 + 11));
+  }
+}
+
+TEST(FcsTest, add_bytes_can_be_split) {
+  std::vector<uint8_t> data(77);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 13);
+  }
+  for (size_t split = 0; split <= data.size(); split++) {
+    Fcs fcs;
+    fcs.Initialize();
+    fcs.AddBytes(data.data(), split);
+    fcs.AddBytes(data.data() + split, data.size() - split);
+    ASSERT_EQ(bytewise_fcs(data), fcs.GetChecksum()) << "split " << split;
+  }
+}
+
+}  // namespace
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -72,6 +72,25 @@ void DataPipelineManager::SetChannelTxPriority(Cid cid, bool high_priority) {
   scheduler_->SetChannelTxPriority(cid, high_priority);
 }
 
+void DataPipelineManager::SetChannelWeight(Cid cid, uint16_t weight) {
+  log::assert_that(
+      sender_map_.find(cid) != sender_map_.end(),
+      "assert failed: sender_map_.find(cid) != sender_map_.end()");
+  scheduler_->SetChannelWeight(cid, weight);
+}
+
+std::unique_ptr<Scheduler> DataPipelineManager::CreateScheduler(SchedulerType scheduler_type,
+                                                                 LowerQueueUpEnd* link_queue_up_end,
+                                                                 os::Handler* handler) {
+  switch (scheduler_type) {
+    case SchedulerType::DEFICIT_ROUND_ROBIN:
+      return std::make_unique<DeficitRoundRobin>(this, link_queue_up_end, handler);
+    case SchedulerType::FIFO:
+      break;
+  }
+  return std::make_unique<Fifo>(this, link_queue_up_end, handler);
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -27,6 +27,7 @@
 #include "l2cap/internal/channel_impl.h"
 #include "l2cap/internal/receiver.h"
 #include "l2cap/internal/scheduler.h"
+#include "l2cap/internal/scheduler_drr.h"
 #include "l2cap/internal/scheduler_fifo.h"
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/mtu.h"
@@ -55,8 +56,15 @@ class DataPipelineManager {
   using LowerDequeue = UpperEnqueue;
   using LowerQueueUpEnd = common::BidiQueueEnd<LowerEnqueue, LowerDequeue>;
 
-  DataPipelineManager(os::Handler* handler, ILink* link, LowerQueueUpEnd* link_queue_up_end)
-      : handler_(handler), link_(link), scheduler_(std::make_unique<Fifo>(this, link_queue_up_end, handler)),
+  enum class SchedulerType {
+    FIFO,
+    // Weighted, byte based fair sharing of the link between channels, see DeficitRoundRobin
+    DEFICIT_ROUND_ROBIN,
+  };
+
+  DataPipelineManager(os::Handler* handler, ILink* link, LowerQueueUpEnd* link_queue_up_end,
+                      SchedulerType scheduler_type = SchedulerType::FIFO)
+      : handler_(handler), link_(link), scheduler_(CreateScheduler(scheduler_type, link_queue_up_end, handler)),
         receiver_(link_queue_up_end, handler, this) {}
 
   using ChannelMode = Sender::ChannelMode;
@@ -67,6 +75,7 @@ class DataPipelineManager {
   virtual void OnPacketSent(Cid cid);
   virtual void UpdateClassicConfiguration(Cid cid, classic::internal::ChannelConfigurationState config);
   virtual void SetChannelTxPriority(Cid cid, bool high_priority);
+  virtual void SetChannelWeight(Cid cid, uint16_t weight);
   virtual ~DataPipelineManager() = default;
 
  private:
@@ -75,6 +84,9 @@ class DataPipelineManager {
   std::unordered_map<Cid, Sender> sender_map_;
   std::unique_ptr<Scheduler> scheduler_;
   Receiver receiver_;
+
+  std::unique_ptr<Scheduler> CreateScheduler(SchedulerType scheduler_type, LowerQueueUpEnd* link_queue_up_end,
+                                             os::Handler* handler);
 };
 }  // namespace internal
 }  // namespace l2cap
@@ -18,10 +18,11 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/le/internal/link.h"
-#include "packet/fragmenting_inserter.h"
-#include "packet/raw_builder.h"
+#include "packet/slice_builder.h"
 
 namespace bluetooth {
 namespace l2cap {
@@ -42,28 +43,23 @@ void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilde
   if (sdu_size > mtu_) {
     log::warn("Received sdu_size {} > mtu {}", static_cast<int>(sdu_size), mtu_);
   }
-  std::vector<std::unique_ptr<packet::RawBuilder>> segments;
-  // TODO: We don't need to waste 2 bytes for continuation segment.
-  packet::FragmentingInserter fragmenting_inserter(mps_ - 2, std::back_insert_iterator(segments));
-  sdu->Serialize(fragmenting_inserter);
-  fragmenting_inserter.finalize();
-  std::unique_ptr<BasicFrameBuilder> builder;
-  builder = FirstLeInformationFrameBuilder::Create(remote_cid_, sdu_size, std::move(segments[0]));
-  pdu_queue_.emplace(std::move(builder));
-  for (size_t i = 1; i < segments.size(); i++) {
-    builder = BasicFrameBuilder::Create(remote_cid_, std::move(segments[i]));
-    pdu_queue_.emplace(std::move(builder));
-  }
-  if (credits_ >= segments.size()) {
-    scheduler_->OnPacketsReady(cid_, segments.size());
-    credits_ -= segments.size();
-  } else if (credits_ > 0) {
-    scheduler_->OnPacketsReady(cid_, credits_);
-    pending_frames_count_ += (segments.size() - credits_);
-    credits_ = 0;
-  } else {
-    pending_frames_count_ += segments.size();
+  // Serialize the SDU once and send its K-frames as slices of that buffer. Only the first K-frame
+  // carries the 2 byte SDU length, continuation K-frames use the full MPS.
+  auto buffer = std::make_shared<std::vector<uint8_t>>();
+  sdu->SerializeTo(*buffer);
+  std::shared_ptr<const std::vector<uint8_t>> sdu_bytes = std::move(buffer);
+  size_t end = std::min<size_t>(sdu_size, mps_ - 2);
+  pdu_queue_.emplace(FirstLeInformationFrameBuilder::Create(
+      remote_cid_, sdu_size, std::make_unique<packet::SliceBuilder>(sdu_bytes, 0, end)));
+  uint16_t segment_count = 1;
+  for (size_t begin = end; begin < sdu_size; begin = end) {
+    end = std::min<size_t>(sdu_size, begin + mps_);
+    pdu_queue_.emplace(
+        BasicFrameBuilder::Create(remote_cid_, std::make_unique<packet::SliceBuilder>(sdu_bytes, begin, end)));
+    segment_count++;
   }
+  pending_frames_count_ += segment_count;
+  release_pending_frames();
 }
 
 void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
@@ -103,7 +99,11 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
     link_->SendDisconnectionRequest(cid_, remote_cid_);
   }
   // TODO: Improve the logic by sending credit only after user dequeued the SDU
-  link_->SendLeCredit(cid_, 1);
+  credits_to_return_++;
+  if (credits_to_return_ >= credit_return_threshold_) {
+    link_->SendLeCredit(cid_, credits_to_return_);
+    credits_to_return_ = 0;
+  }
 }
 
 std::unique_ptr<packet::BasePacketBuilder> LeCreditBasedDataController::GetNextPacket() {
@@ -127,15 +127,21 @@ void LeCreditBasedDataController::OnCredit(uint16_t credits) {
     link_->SendDisconnectionRequest(cid_, remote_cid_);
   }
   credits_ = total_credits;
-  if (pending_frames_count_ > 0 && credits_ >= pending_frames_count_) {
-    scheduler_->OnPacketsReady(cid_, pending_frames_count_);
-    pending_frames_count_ = 0;
-    credits_ -= pending_frames_count_;
-  } else if (pending_frames_count_ > 0) {
-    scheduler_->OnPacketsReady(cid_, credits_);
-    pending_frames_count_ -= credits_;
-    credits_ = 0;
+  release_pending_frames();
+}
+
+void LeCreditBasedDataController::SetCreditReturnThreshold(uint16_t threshold) {
+  credit_return_threshold_ = std::max<uint16_t>(threshold, 1);
+}
+
+void LeCreditBasedDataController::release_pending_frames() {
+  uint16_t ready = std::min(credits_, pending_frames_count_);
+  if (ready == 0) {
+    return;
   }
+  credits_ -= ready;
+  pending_frames_count_ -= ready;
+  scheduler_->OnPacketsReady(cid_, ready);
 }
 
 }  // namespace internal
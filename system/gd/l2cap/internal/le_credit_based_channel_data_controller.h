@@ -58,6 +58,8 @@ class LeCreditBasedDataController : public DataController {
   void SetMps(uint16_t mps);
   // TODO: Handle credits
   void OnCredit(uint16_t credits);
+  // Return credits to the remote once |threshold| K-frames were received, instead of one per K-frame
+  void SetCreditReturnThreshold(uint16_t threshold);
 
  private:
   Cid cid_;
@@ -71,6 +73,11 @@ class LeCreditBasedDataController : public DataController {
   uint16_t mps_ = 251;
   uint16_t credits_ = 0;
   uint16_t pending_frames_count_ = 0;
+  uint16_t credit_return_threshold_ = 1;
+  uint16_t credits_to_return_ = 0;
+
+  // Hand as many pending K-frames to the scheduler as we have credits for
+  void release_pending_frames();
 
   class PacketViewForReassembly : public packet::PacketView<kLittleEndian> {
    public:
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "l2cap/internal/ilink.h"
+#include "l2cap/internal/le_credit_based_channel_data_controller.h"
+#include "l2cap/internal/scheduler.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+static constexpr Cid kCid = 0x41;
+static constexpr uint16_t kMps = 247;
+
+class FakeLink : public ILink {
+ public:
+  void SendDisconnectionRequest(Cid /* local_cid */, Cid /* remote_cid */) override {}
+  hci::AddressWithType GetDevice() const override {
+    return hci::AddressWithType();
+  }
+  void SendLeCredit(Cid /* local_cid */, uint16_t credit) override {
+    credits_sent_ += credit;
+  }
+  size_t credits_sent_ = 0;
+};
+
+// Counts the K-frames the controller hands over, as the ACL scheduler would.
+class CountingScheduler : public Scheduler {
+ public:
+  void OnPacketsReady(Cid /* cid */, int number_packets) override {
+    ready_ += number_packets;
+  }
+  int ready_ = 0;
+};
+
+// Segment SDUs of |state.range(0)| bytes and serialize every K-frame, as sent to the ACL queue.
+static void BM_LeCreditBasedTransmit(State& state) {
+  os::Thread thread("benchmark_thread", os::Thread::Priority::NORMAL);
+  os::Handler handler(&thread);
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  FakeLink link;
+  CountingScheduler scheduler;
+  LeCreditBasedDataController controller{&link, kCid, kCid, channel_queue.GetDownEnd(), &handler, &scheduler};
+  controller.SetMtu(state.range(0));
+  controller.SetMps(kMps);
+  std::vector<uint8_t> sdu(state.range(0), 0x5a);
+  // The first K-frame carries the SDU length
+  uint16_t frames = 1 + (sdu.size() - (kMps - 2) + kMps - 1) / kMps;
+  std::vector<uint8_t> frame;
+  for (auto _ : state) {
+    controller.OnSdu(std::make_unique<packet::RawBuilder>(sdu));
+    controller.OnCredit(frames);
+    for (; scheduler.ready_ > 0; scheduler.ready_--) {
+      frame.clear();
+      controller.GetNextPacket()->SerializeTo(frame);
+      benchmark::DoNotOptimize(frame.data());
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+  handler.Clear();
+}
+BENCHMARK(BM_LeCreditBasedTransmit)->Arg(kMps - 2)->Arg(2048)->Arg(65535);
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
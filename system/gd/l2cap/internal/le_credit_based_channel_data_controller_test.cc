@@ -121,6 +121,47 @@ TEST_F(LeCreditBasedDataControllerTest, transmit_segmented) {
   EXPECT_EQ(data, "cd");
 }
 
+TEST_F(LeCreditBasedDataControllerTest, transmit_segmented_continuation_uses_full_mps) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.OnCredit(10);
+  controller.SetMps(4);
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 3));
+  // Should be divided into 'ab', 'cdef' and 'g'
+  controller.OnSdu(CreateSdu({'a', 'b', 'c', 'd', 'e', 'f', 'g'}));
+  std::vector<std::string> expected = {"ab", "cdef", "g"};
+  for (size_t i = 0; i < expected.size(); i++) {
+    auto pdu_view = BasicFrameView::Create(GetPacketView(controller.GetNextPacket()));
+    EXPECT_TRUE(pdu_view.IsValid());
+    auto payload = pdu_view.GetPayload();
+    if (i == 0) {
+      auto first_le_info_view = FirstLeInformationFrameView::Create(pdu_view);
+      EXPECT_TRUE(first_le_info_view.IsValid());
+      EXPECT_EQ(first_le_info_view.GetL2capSduLength(), 7);
+      payload = first_le_info_view.GetPayload();
+    }
+    EXPECT_EQ(std::string(payload.begin(), payload.end()), expected[i]);
+  }
+}
+
+TEST_F(LeCreditBasedDataControllerTest, transmit_waits_for_credits) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetMps(4);
+  controller.OnCredit(1);
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 1));
+  controller.OnSdu(CreateSdu({'a', 'b', 'c', 'd', 'e', 'f', 'g'}));
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 2));
+  controller.OnCredit(5);
+  // The 3 credits left over are used by the next SDU
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 1));
+  controller.OnSdu(CreateSdu({'h'}));
+}
+
 TEST_F(LeCreditBasedDataControllerTest, receive_unsegmented) {
   common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
   testing::MockScheduler scheduler;
@@ -160,6 +201,22 @@ TEST_F(LeCreditBasedDataControllerTest, receive_segmented) {
   EXPECT_EQ(data, "abcdefg");
 }
 
+TEST_F(LeCreditBasedDataControllerTest, receive_returns_credits_at_threshold) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.OnCredit(10);
+  controller.SetCreditReturnThreshold(3);
+  EXPECT_CALL(link, SendLeCredit(0x41, ::testing::_)).Times(0);
+  for (int i = 0; i < 2; i++) {
+    controller.OnPdu(GetPacketView(FirstLeInformationFrameBuilder::Create(0x41, 1, CreateSdu({'a'}))));
+  }
+  ::testing::Mock::VerifyAndClearExpectations(&link);
+  EXPECT_CALL(link, SendLeCredit(0x41, 3)).Times(1);
+  controller.OnPdu(GetPacketView(FirstLeInformationFrameBuilder::Create(0x41, 1, CreateSdu({'a'}))));
+}
+
 TEST_F(LeCreditBasedDataControllerTest, receive_segmented_with_wrong_sdu_length) {
   common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
   testing::MockScheduler scheduler;
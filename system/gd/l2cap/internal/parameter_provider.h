@@ -18,6 +18,8 @@
 
 #include <chrono>
 
+#include "os/system_properties.h"
+
 namespace bluetooth {
 namespace l2cap {
 namespace internal {
@@ -42,6 +44,16 @@ class ParameterProvider {
   virtual uint16_t GetLeInitialCredit() {
     return 100;
   }
+  // Number of received K-frames after which credits are returned to the remote in a single LE Flow Control
+  // Credit packet. Must stay below the initial credits so that the remote never runs dry.
+  virtual uint16_t GetLeCreditReturnThreshold() {
+    return GetLeInitialCredit() / 4;
+  }
+  // Whether classic links share the ACL link between their channels with the deficit round robin scheduler
+  // instead of the FIFO one
+  virtual bool IsClassicWeightedSchedulerEnabled() {
+    return os::GetSystemPropertyBool("bluetooth.l2cap.classic.weighted_scheduler.enabled", false);
+  }
 };
 
 }  // namespace internal
@@ -19,6 +19,7 @@
 #include <bluetooth/log.h>
 
 #include "common/bidi_queue.h"
+#include "common/latency_trace.h"
 #include "l2cap/cid.h"
 #include "l2cap/internal/data_pipeline_manager.h"
 #include "l2cap/l2cap_packets.h"
@@ -54,6 +55,7 @@ void Receiver::link_queue_dequeue_callback() {
     return;
   }
   Cid cid = static_cast<Cid>(basic_frame_view.GetChannelId());
+  BT_TRACE_LATENCY(L2CAP_RECEIVER_RX, cid, packet->size());
   auto* data_controller = data_pipeline_manager_->GetDataController(cid);
   if (data_controller == nullptr) {
     // TODO(b/150170271): Buffer a few packets before data controller is attached
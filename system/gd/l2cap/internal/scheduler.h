@@ -61,6 +61,12 @@ class Scheduler {
    */
   virtual void SetChannelTxPriority(Cid /* cid */, bool /* high_priority */) {}
 
+  /**
+   * Set the share of the link a channel gets relative to the other channels of
+   * the same priority. Ignored by schedulers that don't weigh channels.
+   */
+  virtual void SetChannelWeight(Cid /* cid */, uint16_t /* weight */) {}
+
   /**
    * Called by data controller to indicate that a channel is closed and packets
    * should be dropped
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_drr.h"
+
+#include "l2cap/internal/data_pipeline_manager.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+DeficitRoundRobin::DeficitRoundRobin(DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end,
+                                     os::Handler* handler)
+    : data_pipeline_manager_(data_pipeline_manager), link_queue_up_end_(link_queue_up_end), handler_(handler) {
+  log::assert_that(
+      link_queue_up_end_ != nullptr && handler_ != nullptr,
+      "assert failed: link_queue_up_end_ != nullptr && handler_ != nullptr");
+}
+
+// Invoked from some external Handler context
+DeficitRoundRobin::~DeficitRoundRobin() {
+  if (link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+// Invoked within L2CAP Handler context
+void DeficitRoundRobin::OnPacketsReady(Cid cid, int number_packets) {
+  if (number_packets == 0) {
+    return;
+  }
+  auto& channel = channels_[cid];
+  if (channel.pending_packets == 0 && channel.head_packet == nullptr) {
+    channel.priority = high_priority_cids_.count(cid) != 0;
+    active_[channel.priority].cids.push_back(cid);
+  }
+  channel.pending_packets += number_packets;
+  try_register_link_queue_enqueue();
+}
+
+// Invoked within L2CAP Handler context
+void DeficitRoundRobin::SetChannelTxPriority(Cid cid, bool high_priority) {
+  if (high_priority) {
+    high_priority_cids_.emplace(cid);
+  } else {
+    high_priority_cids_.erase(cid);
+  }
+}
+
+// Invoked within L2CAP Handler context
+void DeficitRoundRobin::SetChannelWeight(Cid cid, uint16_t weight) {
+  if (weight == 0) {
+    log::warn("Ignoring weight 0 for cid {}", cid);
+    return;
+  }
+  weights_[cid] = weight;
+}
+
+void DeficitRoundRobin::RemoveChannel(Cid cid) {
+  auto channel = channels_.find(cid);
+  if (channel != channels_.end()) {
+    auto& active = active_[channel->second.priority];
+    if (!active.cids.empty() && active.cids.front() == cid) {
+      active.front_granted = false;
+    }
+    active.cids.remove(cid);
+    channels_.erase(channel);
+  }
+  weights_.erase(cid);
+  try_unregister_link_queue_enqueue();
+}
+
+bool DeficitRoundRobin::has_packets() const {
+  return !active_[0].cids.empty() || !active_[1].cids.empty();
+}
+
+uint16_t DeficitRoundRobin::get_weight(Cid cid) const {
+  auto weight = weights_.find(cid);
+  return weight == weights_.end() ? kDefaultWeight : weight->second;
+}
+
+// Invoked from some external Queue Reactable context
+std::unique_ptr<DeficitRoundRobin::LowerEnqueue> DeficitRoundRobin::link_queue_enqueue_callback() {
+  log::assert_that(has_packets(), "assert failed: has_packets()");
+  auto& active = active_[1].cids.empty() ? active_[0] : active_[1];
+  // Each pass adds a quantum to a channel that can't send yet, so this ends
+  while (true) {
+    auto cid = active.cids.front();
+    auto& channel = channels_[cid];
+    if (channel.head_packet == nullptr) {
+      channel.head_packet = data_pipeline_manager_->GetDataController(cid)->GetNextPacket();
+      channel.pending_packets--;
+    }
+    if (!active.front_granted) {
+      channel.deficit += kQuantum * get_weight(cid);
+      active.front_granted = true;
+    }
+    auto packet_size = channel.head_packet->size();
+    if (channel.deficit < packet_size) {
+      // Turn is over, the allowance is kept for the next one
+      active.cids.splice(active.cids.end(), active.cids, active.cids.begin());
+      active.front_granted = false;
+      continue;
+    }
+    channel.deficit -= packet_size;
+    auto packet = std::move(channel.head_packet);
+    if (channel.pending_packets == 0) {
+      // An idle channel doesn't bank allowance
+      channels_.erase(cid);
+      active.cids.pop_front();
+      active.front_granted = false;
+    }
+    data_pipeline_manager_->OnPacketSent(cid);
+    try_unregister_link_queue_enqueue();
+    return packet;
+  }
+}
+
+void DeficitRoundRobin::try_register_link_queue_enqueue() {
+  if (link_queue_enqueue_registered_.exchange(true)) {
+    return;
+  }
+  link_queue_up_end_->RegisterEnqueue(
+      handler_, common::Bind(&DeficitRoundRobin::link_queue_enqueue_callback, common::Unretained(this)));
+}
+
+void DeficitRoundRobin::try_unregister_link_queue_enqueue() {
+  if (!has_packets() && link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
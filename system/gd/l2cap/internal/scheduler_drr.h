@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/bidi_queue.h"
+#include "common/bind.h"
+#include "l2cap/cid.h"
+#include "l2cap/internal/scheduler.h"
+#include "os/handler.h"
+#include "os/queue.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+class DataPipelineManager;
+
+/**
+ * Deficit round robin scheduler. Channels with packets ready take turns on the
+ * link; on each turn a channel may send up to its weight times kQuantum bytes,
+ * and unused allowance carries over to its next turn while it stays busy. A
+ * bulk channel hence can't starve the other channels of the link, whatever
+ * the size of its packets.
+ *
+ * High priority channels (SetChannelTxPriority) are still served before all
+ * the others, and share the link between themselves the same way.
+ */
+class DeficitRoundRobin : public Scheduler {
+ public:
+  // Bytes granted per turn to a channel of weight 1
+  static constexpr size_t kQuantum = 1024;
+  static constexpr uint16_t kDefaultWeight = 1;
+
+  DeficitRoundRobin(DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end,
+                    os::Handler* handler);
+  ~DeficitRoundRobin();
+  void OnPacketsReady(Cid cid, int number_packets) override;
+  void SetChannelTxPriority(Cid cid, bool high_priority) override;
+  void SetChannelWeight(Cid cid, uint16_t weight) override;
+  void RemoveChannel(Cid cid) override;
+
+ private:
+  struct Channel {
+    int pending_packets = 0;
+    size_t deficit = 0;
+    // Packet taken from the data controller that didn't fit in the deficit of the last turn
+    std::unique_ptr<LowerEnqueue> head_packet;
+    int priority = 0;
+  };
+
+  // Busy channels of one priority, in round robin order. The front channel has the turn.
+  struct ActiveList {
+    std::list<Cid> cids;
+    bool front_granted = false;
+  };
+
+  DataPipelineManager* data_pipeline_manager_;
+  LowerQueueUpEnd* link_queue_up_end_;
+  os::Handler* handler_;
+  std::unordered_map<Cid, Channel> channels_;
+  std::unordered_map<Cid, uint16_t> weights_;
+  std::unordered_set<Cid> high_priority_cids_;
+  // Index 1 holds the high priority channels
+  ActiveList active_[2];
+  std::atomic_bool link_queue_enqueue_registered_ = false;
+
+  bool has_packets() const;
+  uint16_t get_weight(Cid cid) const;
+  void try_register_link_queue_enqueue();
+  void try_unregister_link_queue_enqueue();
+  std::unique_ptr<LowerEnqueue> link_queue_enqueue_callback();
+};
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_drr.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "l2cap/internal/data_controller_mock.h"
+#include "l2cap/internal/data_pipeline_manager_mock.h"
+#include "os/handler.h"
+#include "os/mock_queue.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+using ::testing::_;
+using ::testing::Return;
+
+std::unique_ptr<packet::BasePacketBuilder> CreateSdu(size_t size) {
+  return std::make_unique<packet::RawBuilder>(std::vector<uint8_t>(size, 0x5a));
+}
+
+PacketView<kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet->SerializeTo(*bytes);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+class MyDataController : public testing::MockDataController {
+ public:
+  std::unique_ptr<BasePacketBuilder> GetNextPacket() override {
+    auto next = std::move(next_packets.front());
+    next_packets.pop();
+    return next;
+  }
+
+  void Push(Cid cid, size_t count, size_t size) {
+    for (size_t i = 0; i < count; i++) {
+      next_packets.push(BasicFrameBuilder::Create(cid, CreateSdu(size)));
+    }
+  }
+
+  std::queue<std::unique_ptr<BasePacketBuilder>> next_packets;
+};
+
+class L2capSchedulerDrrTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    queue_handler_ = new os::Handler(thread_);
+    mock_data_pipeline_manager_ = new testing::MockDataPipelineManager(queue_handler_, &queue_end_);
+    drr_ = new DeficitRoundRobin(mock_data_pipeline_manager_, &queue_end_, queue_handler_);
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(1)).WillRepeatedly(Return(&data_controller_1_));
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(2)).WillRepeatedly(Return(&data_controller_2_));
+    EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(::testing::AnyNumber());
+  }
+
+  void TearDown() override {
+    delete drr_;
+    delete mock_data_pipeline_manager_;
+    queue_handler_->Clear();
+    delete queue_handler_;
+    delete thread_;
+  }
+
+  // Return the channels of the enqueued packets, in order
+  std::vector<Cid> DequeueChannels() {
+    std::vector<Cid> channels;
+    while (!enqueue_.enqueued.empty()) {
+      auto basic_frame_view = BasicFrameView::Create(GetPacketView(std::move(enqueue_.enqueued.front())));
+      EXPECT_TRUE(basic_frame_view.IsValid());
+      channels.push_back(basic_frame_view.GetChannelId());
+      enqueue_.enqueued.pop();
+    }
+    return channels;
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* queue_handler_ = nullptr;
+  os::MockIQueueDequeue<Scheduler::LowerDequeue> dequeue_;
+  os::MockIQueueEnqueue<Scheduler::LowerEnqueue> enqueue_;
+  common::BidiQueueEnd<Scheduler::LowerEnqueue, Scheduler::LowerDequeue> queue_end_{&enqueue_, &dequeue_};
+  testing::MockDataPipelineManager* mock_data_pipeline_manager_ = nullptr;
+  MyDataController data_controller_1_;
+  MyDataController data_controller_2_;
+  DeficitRoundRobin* drr_ = nullptr;
+};
+
+TEST_F(L2capSchedulerDrrTest, bulk_channel_does_not_starve_others) {
+  data_controller_1_.Push(1, 4, 1000);
+  data_controller_2_.Push(2, 2, 3);
+  drr_->OnPacketsReady(1, 4);
+  drr_->OnPacketsReady(2, 2);
+  enqueue_.run_enqueue(6);
+  EXPECT_THAT(DequeueChannels(), ::testing::ElementsAre(1, 2, 2, 1, 1, 1));
+  EXPECT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+TEST_F(L2capSchedulerDrrTest, weighted_channels) {
+  data_controller_1_.Push(1, 4, 1000);
+  data_controller_2_.Push(2, 4, 1000);
+  drr_->SetChannelWeight(1, 2);
+  drr_->OnPacketsReady(1, 4);
+  drr_->OnPacketsReady(2, 4);
+  enqueue_.run_enqueue(8);
+  EXPECT_THAT(DequeueChannels(), ::testing::ElementsAre(1, 1, 2, 1, 1, 2, 2, 2));
+}
+
+TEST_F(L2capSchedulerDrrTest, prioritize_channel) {
+  data_controller_1_.Push(1, 2, 1000);
+  data_controller_2_.Push(2, 1, 3);
+  drr_->SetChannelTxPriority(1, true);
+  drr_->OnPacketsReady(2, 1);
+  drr_->OnPacketsReady(1, 2);
+  enqueue_.run_enqueue(3);
+  EXPECT_THAT(DequeueChannels(), ::testing::ElementsAre(1, 1, 2));
+}
+
+TEST_F(L2capSchedulerDrrTest, remove_channel) {
+  data_controller_1_.Push(1, 1, 3);
+  data_controller_2_.Push(2, 1, 3);
+  drr_->OnPacketsReady(1, 1);
+  drr_->OnPacketsReady(2, 1);
+  drr_->RemoveChannel(1);
+  enqueue_.run_enqueue(2);
+  EXPECT_THAT(DequeueChannels(), ::testing::ElementsAre(2));
+  EXPECT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -17,6 +17,7 @@
 #include <unordered_map>
 
 #include "common/bind.h"
+#include "common/latency_trace.h"
 #include "l2cap/internal/basic_mode_channel_data_controller.h"
 #include "l2cap/internal/enhanced_retransmission_mode_channel_data_controller.h"
 #include "l2cap/internal/le_credit_based_channel_data_controller.h"
@@ -84,6 +85,7 @@ void Sender::try_register_dequeue() {
 void Sender::dequeue_callback() {
   auto packet = queue_end_->TryDequeue();
   log::assert_that(packet != nullptr, "assert failed: packet != nullptr");
+  BT_TRACE_LATENCY(L2CAP_SENDER_TX, channel_id_, packet->size());
   handler_->Post(
       common::BindOnce(&DataController::OnSdu, common::Unretained(data_controller_.get()), std::move(packet)));
   if (is_dequeue_registered_.exchange(false)) {
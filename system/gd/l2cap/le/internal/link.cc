@@ -323,6 +323,10 @@ uint16_t Link::GetInitialCredit() const {
   return parameter_provider_->GetLeInitialCredit();
 }
 
+uint16_t Link::GetCreditReturnThreshold() const {
+  return parameter_provider_->GetLeCreditReturnThreshold();
+}
+
 void Link::SendLeCredit(Cid local_cid, uint16_t credit) {
   signalling_manager_.SendCredit(local_cid, credit);
 }
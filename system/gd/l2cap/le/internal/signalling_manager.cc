@@ -263,6 +263,7 @@ void LeSignallingManager::on_security_result_for_incoming(Psm psm, PendingConnec
   auto actual_mtu = std::min(request.mtu, local_mtu);
   data_controller->SetMtu(actual_mtu);
   data_controller->SetMps(std::min(request.max_pdu_size, local_mps));
+  data_controller->SetCreditReturnThreshold(link_->GetCreditReturnThreshold());
   data_controller->OnCredit(request.initial_credits);
   auto user_channel = std::make_unique<DynamicChannel>(new_channel, handler_, link_, actual_mtu);
   dynamic_service_manager_->GetService(psm)->NotifyChannelCreation(std::move(user_channel));
@@ -300,6 +301,7 @@ void LeSignallingManager::OnConnectionResponse(SignalId signal_id, Cid remote_ci
   auto actual_mtu = std::min(mtu, command_just_sent_.mtu_);
   data_controller->SetMtu(actual_mtu);
   data_controller->SetMps(std::min(mps, command_just_sent_.mps_));
+  data_controller->SetCreditReturnThreshold(link_->GetCreditReturnThreshold());
   data_controller->OnCredit(initial_credits);
   std::unique_ptr<DynamicChannel> user_channel =
       std::make_unique<DynamicChannel>(new_channel, handler_, link_, actual_mtu);
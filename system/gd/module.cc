@@ -17,6 +17,12 @@
 
 #include "module.h"
 
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+// The stack runs in the Bluetooth app process, where app tracing is enabled
+#define ATRACE_TAG ATRACE_TAG_APP
+#include <cutils/trace.h>
+#endif
+
 #include <bluetooth/log.h>
 
 #include "common/init_flags.h"
@@ -41,8 +47,11 @@ const ModuleRegistry* Module::GetModuleRegistry() const {
 }
 
 Module* Module::GetDependency(const ModuleFactory* module) const {
-  for (auto& dependency : dependencies_.list_) {
-    if (dependency == module) {
+  for (size_t i = 0; i < dependencies_.list_.size(); i++) {
+    if (dependencies_.list_[i] == module) {
+      if (i < dependency_instances_.size()) {
+        return dependency_instances_[i];
+      }
       return registry_->Get(module);
     }
   }
@@ -78,6 +87,7 @@ void ModuleRegistry::Start(ModuleList* modules, Thread* thread) {
 void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread) const {
   instance->registry_ = this;
   instance->handler_ = new Handler(thread);
+  instance->handler_->SetName(instance->ToString());
 }
 
 Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
@@ -92,15 +102,29 @@ Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
 
   log::info("Starting dependencies of {}", instance->ToString());
   instance->ListDependencies(&instance->dependencies_);
-  Start(&instance->dependencies_, thread);
+  for (const ModuleFactory* dependency : instance->dependencies_.list_) {
+    instance->dependency_instances_.push_back(Start(dependency, thread));
+  }
 
   log::info("Finished starting dependencies and calling Start() of {}", instance->ToString());
 
   last_instance_ = "starting " + instance->ToString();
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+  ATRACE_BEGIN(last_instance_.c_str());
+#endif
+  const auto start = std::chrono::steady_clock::now();
   instance->Start();
+  const auto duration = std::chrono::steady_clock::now() - start;
+#if defined(__ANDROID__) && !defined(FUZZ_TARGET)
+  ATRACE_END();
+#endif
   start_order_.push_back(module);
   started_modules_[module] = instance;
-  log::info("Started {}", instance->ToString());
+  start_durations_[module] = duration;
+  log::info(
+      "Started {} in {} us",
+      instance->ToString(),
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
   return instance;
 }
 
@@ -130,6 +154,7 @@ void ModuleRegistry::StopAll() {
 
   log::assert_that(started_modules_.empty(), "assert failed: started_modules_.empty()");
   start_order_.clear();
+  start_durations_.clear();
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
@@ -130,6 +130,9 @@ class Module {
 
   ::bluetooth::os::Handler* handler_ = nullptr;
   ModuleList dependencies_;
+  // Started instances of |dependencies_|, in the same order, so that
+  // GetDependency() does not go through the registry map
+  std::vector<Module*> dependency_instances_;
   const ModuleRegistry* registry_;
 };
 
@@ -168,6 +171,8 @@ class ModuleRegistry {
 
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
+  // Time spent in the Start() of each module, its dependencies excluded
+  std::map<const ModuleFactory*, std::chrono::steady_clock::duration> start_durations_;
   std::string last_instance_;
 };
 
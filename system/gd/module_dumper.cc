@@ -17,18 +17,26 @@
 
 #include "module_dumper.h"
 
+#include <set>
 #include <sstream>
 
 #include "common/init_flags.h"
+#include "common/latency_trace.h"
+#include "common/scope_profiler.h"
 #include "dumpsys_data_generated.h"
 #include "module.h"
+#include "os/handler.h"
+#include "os/reactor.h"
+#include "os/thread.h"
 #include "os/wakelock_manager.h"
 
+using ::bluetooth::os::Reactor;
+using ::bluetooth::os::Thread;
 using ::bluetooth::os::WakelockManager;
 
 namespace bluetooth {
 
-void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) const {
+void ModuleDumper::DumpState(std::string* output, std::ostringstream& oss) const {
   log::assert_that(output != nullptr, "assert failed: output != nullptr");
 
   flatbuffers::FlatBufferBuilder builder(1024);
@@ -49,15 +57,22 @@ void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) c
   auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
 
   std::queue<DumpsysDataFinisher> queue;
+  std::vector<ModuleTiming> timings;
   for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend();
        it++) {
     auto instance = module_registry_.started_modules_.find(*it);
     log::assert_that(
         instance != module_registry_.started_modules_.end(),
         "assert failed: instance != module_registry_.started_modules_.end()");
-    log::verbose("Starting dumpsys module:{}", instance->second->ToString());
+    const std::string name = instance->second->ToString();
+    if (!modules_.empty() && modules_.count(name) == 0) {
+      continue;
+    }
+    log::verbose("Starting dumpsys module:{}", name);
+    const auto start = std::chrono::steady_clock::now();
     queue.push(instance->second->GetDumpsysData(&builder));
-    log::verbose("Finished dumpsys module:{}", instance->second->ToString());
+    timings.emplace_back(name, std::chrono::steady_clock::now() - start);
+    log::verbose("Finished dumpsys module:{}", name);
   }
 
   DumpsysDataBuilder data_builder(builder);
@@ -72,6 +87,74 @@ void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) c
 
   builder.Finish(data_builder.Finish());
   *output = std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+
+  DumpReactorStats(oss);
+  DumpModuleStartTimings(oss);
+  DumpModuleTimings(timings, oss);
+  common::LatencyTrace::Dump(oss);
+  common::ScopeProfiler::Dump(oss);
+}
+
+void ModuleDumper::DumpModuleTimings(
+    const std::vector<ModuleTiming>& timings, std::ostringstream& oss) const {
+  oss << "----- Module Dumpsys Timing -----" << std::endl;
+  for (const auto& [name, duration] : timings) {
+    oss << "  " << name
+        << " us:" << std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (duration > kModuleBudget) {
+      log::warn(
+          "Dumpsys of module:{} took {} ms",
+          name,
+          std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+      oss << " over budget";
+    }
+    oss << std::endl;
+  }
+}
+
+void ModuleDumper::DumpModuleStartTimings(std::ostringstream& oss) const {
+  oss << "----- Module Start Timing -----" << std::endl;
+  std::chrono::steady_clock::duration total{};
+  for (const auto* factory : module_registry_.start_order_) {
+    auto instance = module_registry_.started_modules_.find(factory);
+    auto duration = module_registry_.start_durations_.find(factory);
+    if (instance == module_registry_.started_modules_.end() ||
+        duration == module_registry_.start_durations_.end()) {
+      continue;
+    }
+    total += duration->second;
+    const std::string name = instance->second->ToString();
+    if (!modules_.empty() && modules_.count(name) == 0) {
+      continue;
+    }
+    oss << "  " << name << " us:"
+        << std::chrono::duration_cast<std::chrono::microseconds>(duration->second).count()
+        << std::endl;
+  }
+  oss << "  Total us:" << std::chrono::duration_cast<std::chrono::microseconds>(total).count()
+      << std::endl;
+}
+
+void ModuleDumper::DumpReactorStats(std::ostringstream& oss) const {
+  std::set<Thread*> threads;
+  for (const auto& [factory, instance] : module_registry_.started_modules_) {
+    if (instance->handler_ != nullptr) {
+      threads.insert(instance->handler_->GetThread());
+    }
+  }
+
+  oss << "----- Reactor Statistics -----" << std::endl;
+  for (auto thread : threads) {
+    oss << thread->ToString() << " dispatch budget:" << thread->GetReactor()->GetDispatchBudget()
+        << std::endl;
+    for (const auto& stats : thread->GetReactor()->GetReactableStats()) {
+      oss << "  " << stats.name << " dispatched:" << stats.dispatch_count
+          << " total_ms:" << std::chrono::duration_cast<std::chrono::milliseconds>(stats.total_time).count()
+          << " max_us:" << std::chrono::duration_cast<std::chrono::microseconds>(stats.max_time).count()
+          << " max_delay_us:" << std::chrono::duration_cast<std::chrono::microseconds>(stats.max_delay).count()
+          << std::endl;
+    }
+  }
 }
 
 }  // namespace bluetooth
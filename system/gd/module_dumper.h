@@ -16,8 +16,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <set>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "module.h"
 
@@ -27,13 +31,32 @@ class ModuleRegistry;
 
 class ModuleDumper {
  public:
-  ModuleDumper(int /*fd*/, const ModuleRegistry& module_registry, const char* title)
-      : module_registry_(module_registry), title_(title) {}
+  // A module taking longer than this to serialize its dumpsys data is reported, since it stalls
+  // the dumpsys thread and whatever else the module state it reads
+  static constexpr std::chrono::milliseconds kModuleBudget = std::chrono::milliseconds(20);
+
+  // Dumps the modules named in |modules|, or all the started modules when it is empty
+  ModuleDumper(
+      int /*fd*/,
+      const ModuleRegistry& module_registry,
+      const char* title,
+      std::set<std::string> modules = {})
+      : module_registry_(module_registry), title_(title), modules_(std::move(modules)) {}
+  // Serializes the module dumpsys data into |output| and writes text-only sections, such as the
+  // reactor statistics of the module threads and the time taken by each module to start and to
+  // dump, to |oss|.
   void DumpState(std::string* output, std::ostringstream& oss) const;
 
  private:
+  using ModuleTiming = std::pair<std::string, std::chrono::steady_clock::duration>;
+
+  void DumpReactorStats(std::ostringstream& oss) const;
+  void DumpModuleTimings(const std::vector<ModuleTiming>& timings, std::ostringstream& oss) const;
+  void DumpModuleStartTimings(std::ostringstream& oss) const;
+
   const ModuleRegistry& module_registry_;
   const std::string title_;
+  const std::set<std::string> modules_;
 };
 
 }  // namespace bluetooth
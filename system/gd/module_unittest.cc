@@ -51,6 +51,7 @@ class ModuleTest : public ::testing::Test {
 };
 
 os::Handler* test_module_no_dependency_handler = nullptr;
+Module* test_module_no_dependency_instance = nullptr;
 
 class TestModuleNoDependency : public Module {
  public:
@@ -63,6 +64,7 @@ class TestModuleNoDependency : public Module {
     // A module is not considered started until Start() finishes
     EXPECT_FALSE(GetModuleRegistry()->IsStarted<TestModuleNoDependency>());
     test_module_no_dependency_handler = GetHandler();
+    test_module_no_dependency_instance = this;
   }
 
   void Stop() override {
@@ -96,10 +98,12 @@ class TestModuleOneDependency : public Module {
     // A module is not considered started until Start() finishes
     EXPECT_FALSE(GetModuleRegistry()->IsStarted<TestModuleOneDependency>());
     test_module_one_dependency_handler = GetHandler();
+    EXPECT_EQ(test_module_no_dependency_instance, GetDependency<TestModuleNoDependency>());
   }
 
   void Stop() override {
     EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleNoDependency>());
+    EXPECT_EQ(test_module_no_dependency_instance, GetDependency<TestModuleNoDependency>());
 
     // A module is not considered stopped until after Stop() finishes
     EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleOneDependency>());
@@ -321,5 +325,57 @@ TEST_F(ModuleTest, dump_state) {
   registry_->StopAll();
 }
 
+TEST_F(ModuleTest, dump_state_lists_start_timings) {
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->Start(&list, thread_);
+
+  std::string output;
+  std::ostringstream oss;
+  ModuleDumper dumper(STDOUT_FILENO, *registry_, "Test Dump Title");
+  dumper.DumpState(&output, oss);
+
+  const std::string text = oss.str();
+  const size_t section = text.find("----- Module Start Timing -----");
+  ASSERT_NE(std::string::npos, section);
+  // Listed in start order, dependencies first
+  const size_t first = text.find("TestModuleNoDependency us:", section);
+  const size_t last = text.find("TestModuleTwoDependencies us:", section);
+  ASSERT_NE(std::string::npos, first);
+  ASSERT_NE(std::string::npos, last);
+  EXPECT_LT(first, last);
+  EXPECT_NE(std::string::npos, text.find("Total us:", last));
+
+  registry_->StopAll();
+}
+
+TEST_F(ModuleTest, dump_state_of_selected_modules) {
+  static const char* title = "Test Dump Title";
+  ModuleList list;
+  list.add<TestModuleDumpState>();
+  registry_->Start(&list, thread_);
+
+  std::string output;
+  std::ostringstream oss;
+  ModuleDumper dumper(STDOUT_FILENO, *registry_, title, {"TestModuleDumpState"});
+  dumper.DumpState(&output, oss);
+
+  auto data = flatbuffers::GetRoot<DumpsysData>(output.data());
+  ASSERT_NE(nullptr, data->module_unittest_data());
+  EXPECT_NE(std::string::npos, oss.str().find("TestModuleDumpState us:"));
+
+  output.clear();
+  std::ostringstream other_oss;
+  ModuleDumper other_dumper(STDOUT_FILENO, *registry_, title, {"OtherModule"});
+  other_dumper.DumpState(&output, other_oss);
+
+  data = flatbuffers::GetRoot<DumpsysData>(output.data());
+  EXPECT_STREQ(title, data->title()->c_str());
+  EXPECT_EQ(nullptr, data->module_unittest_data());
+  EXPECT_EQ(std::string::npos, other_oss.str().find("TestModuleDumpState us:"));
+
+  registry_->StopAll();
+}
+
 }  // namespace
 }  // namespace bluetooth
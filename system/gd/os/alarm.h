@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -28,33 +29,34 @@
 namespace bluetooth {
 namespace os {
 
-// A single-shot alarm for reactor-based thread, implemented by Linux timerfd.
-// When it's constructed, it will register a reactable on the specified thread; when it's destroyed, it will unregister
-// itself from the thread.
+class AlarmMultiplexer;
+
+// A single-shot alarm for reactor-based thread. All the alarms of a thread share the timerfd of its AlarmMultiplexer.
 class Alarm {
  public:
-  // Create and register a single-shot alarm on a given handler
+  // Create a single-shot alarm on a given handler
   explicit Alarm(Handler* handler);
 
   Alarm(const Alarm&) = delete;
   Alarm& operator=(const Alarm&) = delete;
 
-  // Unregister this alarm from the thread and release resource
+  // Cancel this alarm
   ~Alarm();
 
-  // Schedule the alarm with given delay
-  void Schedule(common::OnceClosure task, std::chrono::milliseconds delay);
+  // Schedule the alarm with given delay. With a non zero |slack|, the alarm may run up to |slack| late, so that it
+  // shares a wakeup with the other alarms of the thread.
+  void Schedule(
+      common::OnceClosure task,
+      std::chrono::milliseconds delay,
+      std::chrono::milliseconds slack = std::chrono::milliseconds(0));
 
   // Cancel the alarm. No-op if it's not armed.
   void Cancel();
 
  private:
-  common::OnceClosure task_;
   Handler* handler_;
-  int fd_ = 0;
-  Reactor::Reactable* token_;
-  mutable std::mutex mutex_;
-  void on_fire();
+  AlarmMultiplexer* multiplexer_;
+  uint64_t id_;
 };
 
 }  // namespace os
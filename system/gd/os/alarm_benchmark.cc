@@ -17,6 +17,7 @@
 #include <chrono>
 #include <future>
 #include <unordered_map>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "common/bind.h"
@@ -26,6 +27,7 @@
 
 using ::benchmark::State;
 using ::bluetooth::common::Bind;
+using ::bluetooth::common::BindOnce;
 using ::bluetooth::os::Alarm;
 using ::bluetooth::os::Handler;
 using ::bluetooth::os::RepeatingAlarm;
@@ -50,6 +52,7 @@ class BM_ReactableAlarm : public ::benchmark::Fixture {
   void TearDown(State& st) override {
     alarm_ = nullptr;
     repeating_alarm_ = nullptr;
+    handler_->Clear();
     handler_ = nullptr;
     thread_->Stop();
     thread_ = nullptr;
@@ -140,3 +143,25 @@ BENCHMARK_REGISTER_F(BM_ReactableAlarm, periodic_accuracy)
     ->Args({2000, 15, 20})
     ->Iterations(1)
     ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_ReactableAlarm, schedule_cancel)(State& state) {
+  // Keep other alarms pending on the same thread, due in 100 s and later
+  std::vector<std::unique_ptr<Alarm>> pending;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    pending.push_back(std::make_unique<Alarm>(handler_.get()));
+    pending.back()->Schedule(BindOnce([]() {}), std::chrono::seconds(100 + i));
+  }
+  // Alarms set before the pending ones re-arm the shared timer, the ones set after them don't
+  auto delay = std::chrono::seconds(state.range(1));
+  for (auto _ : state) {
+    alarm_->Schedule(BindOnce([]() {}), delay);
+    alarm_->Cancel();
+  }
+  pending.clear();
+};
+
+BENCHMARK_REGISTER_F(BM_ReactableAlarm, schedule_cancel)
+    ->Args({0, 10})
+    ->Args({16, 10})
+    ->Args({256, 10})
+    ->Args({256, 1000});
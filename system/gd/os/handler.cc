@@ -18,8 +18,11 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/task_profiler.h"
 #include "os/log.h"
 #include "os/reactor.h"
 
@@ -27,40 +30,51 @@ namespace bluetooth {
 namespace os {
 using common::OnceClosure;
 
-Handler::Handler(Thread* thread) : tasks_(new std::queue<OnceClosure>()), thread_(thread) {
+Handler::Handler(Thread* thread) : thread_(thread) {
   event_ = thread_->GetReactor()->NewEvent();
   reactable_ = thread_->GetReactor()->Register(
       event_->Id(), common::Bind(&Handler::handle_next_event, common::Unretained(this)), common::Closure());
 }
 
 Handler::~Handler() {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    log::assert_that(was_cleared(), "Handlers must be cleared before they are destroyed");
-  }
+  log::assert_that(was_cleared(), "Handlers must be cleared before they are destroyed");
+  // Drop tasks from posts that raced with Clear()
+  drain_tasks();
   event_->Close();
 }
 
 void Handler::Post(OnceClosure closure) {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (was_cleared()) {
-      log::warn("Posting to a handler which has been cleared");
-      return;
-    }
-    tasks_->emplace(std::move(closure));
+  // Without a location, the posting site is the caller of Post()
+  push_task(std::move(closure), __builtin_return_address(0));
+}
+
+void Handler::PostInline(common::InlineOnceClosure closure) {
+  push_task(std::move(closure), __builtin_return_address(0));
+}
+
+void Handler::push_task(common::InlineOnceClosure closure, const void* program_counter) {
+  if (was_cleared()) {
+    log::warn("Posting to a handler which has been cleared");
+    return;
+  }
+  if (common::TaskProfiler::IsEnabled()) {
+    closure = thread_->GetTaskProfiler()->Wrap(
+        common::TaskProfiler::Site::FromProgramCounter(program_counter),
+        std::chrono::microseconds(0),
+        std::move(closure).ToOnceClosure());
+  }
+  tasks_.Push(std::move(closure));
+  if (pending_tasks_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    event_->Notify();
   }
-  event_->Notify();
 }
 
 void Handler::Clear() {
-  std::queue<OnceClosure>* tmp = nullptr;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    log::assert_that(!was_cleared(), "Handlers must only be cleared once");
-    std::swap(tasks_, tmp);
+    log::assert_that(!cleared_->exchange(true, std::memory_order_acq_rel), "Handlers must only be cleared once");
+    drain_tasks();
   }
-  delete tmp;
 
   event_->Clear();
 
@@ -68,6 +82,22 @@ void Handler::Clear() {
   reactable_ = nullptr;
 }
 
+void Handler::SetName(std::string name) {
+  log::assert_that(reactable_ != nullptr, "assert failed: reactable_ != nullptr");
+  thread_->GetReactor()->SetReactableName(reactable_, std::move(name));
+}
+
+Thread* Handler::GetThread() const {
+  return thread_;
+}
+
+void Handler::drain_tasks() {
+  common::InlineOnceClosure closure;
+  while (tasks_.TryPop(&closure)) {
+    closure.Reset();
+  }
+}
+
 void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
   log::assert_that(reactable_ == nullptr, "assert failed: reactable_ == nullptr");
   log::assert_that(
@@ -76,7 +106,10 @@ void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
 }
 
 void Handler::handle_next_event() {
-  common::OnceClosure closure;
+  common::InlineOnceClosure closures[Reactor::kMaxDispatchBudget];
+  size_t count = 0;
+  // A task may clear and destroy this handler, so the running batch only holds on to the flag.
+  std::shared_ptr<std::atomic<bool>> cleared = cleared_;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     bool has_data = event_->Read();
@@ -86,10 +119,19 @@ void Handler::handle_next_event() {
     }
     log::assert_that(has_data, "Notified for work but no work available");
 
-    closure = std::move(tasks_->front());
-    tasks_->pop();
+    count = std::min(pending_tasks_.load(std::memory_order_acquire), thread_->GetReactor()->GetDispatchBudget());
+    for (size_t i = 0; i < count; i++) {
+      tasks_.Pop(&closures[i]);
+    }
+    // Re-arm the event before running the tasks, so the remaining ones run after the other
+    // reactables that are ready on this thread.
+    if (pending_tasks_.fetch_sub(count, std::memory_order_acq_rel) > count) {
+      event_->Notify();
+    }
+  }
+  for (size_t i = 0; i < count && !cleared->load(std::memory_order_acquire); i++) {
+    std::move(closures[i]).Run();
   }
-  std::move(closure).Run();
 }
 
 }  // namespace os
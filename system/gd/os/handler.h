@@ -16,13 +16,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <string>
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/inline_once_closure.h"
 #include "common/postable_context.h"
+#include "os/mpsc_queue.h"
 #include "os/thread.h"
 
 namespace bluetooth {
@@ -45,9 +48,18 @@ class Handler : public common::PostableContext {
   // Enqueue a closure to the queue of this handler
   virtual void Post(common::OnceClosure closure) override;
 
+  // Enqueue a closure to the queue of this handler, without allocating for closures that fit inline
+  virtual void PostInline(common::InlineOnceClosure closure) override;
+
   // Remove all pending events from the queue of this handler
   void Clear();
 
+  // Name this handler in the reactor statistics of its thread
+  void SetName(std::string name);
+
+  // Return the thread this handler runs on. The ownership is NOT transferred.
+  Thread* GetThread() const;
+
   // Die if the current reactable doesn't stop before the timeout.  Must be called after Clear()
   void WaitUntilStopped(std::chrono::milliseconds timeout);
 
@@ -70,12 +82,20 @@ class Handler : public common::PostableContext {
 
  private:
   inline bool was_cleared() const {
-    return tasks_ == nullptr;
+    return cleared_->load(std::memory_order_acquire);
   };
-  std::queue<common::OnceClosure>* tasks_;
+  void drain_tasks();
+  void push_task(common::InlineOnceClosure closure, const void* program_counter);
+  // Posting is lock-free. The event is only notified when the queue goes from empty to non-empty;
+  // while tasks remain, the handler re-arms the event itself after each batch of tasks.
+  MpscQueue<common::InlineOnceClosure> tasks_;
+  std::atomic<size_t> pending_tasks_{0};
+  // Shared with running batches of tasks, which must stop if a task clears the handler.
+  std::shared_ptr<std::atomic<bool>> cleared_ = std::make_shared<std::atomic<bool>>(false);
   Thread* thread_;
   std::unique_ptr<Reactor::Event> event_;
   Reactor::Reactable* reactable_;
+  // Serializes the consumer side of |tasks_| between the handler thread and Clear().
   mutable std::mutex mutex_;
   void handle_next_event();
 };
@@ -17,10 +17,12 @@
 #include "os/handler.h"
 
 #include <future>
+#include <memory>
 #include <thread>
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/task_profiler.h"
 #include "gtest/gtest.h"
 #include "os/log.h"
 
@@ -116,6 +118,92 @@ TEST_F(HandlerTest, callback_with_promise) {
   handler_->Clear();
 }
 
+TEST_F(HandlerTest, tasks_after_clear_in_same_batch_are_dropped) {
+  // Block the handler so that the following tasks end up in one batch.
+  std::promise<void> can_continue;
+  auto can_continue_future = can_continue.get_future();
+  handler_->Post(common::BindOnce([](std::future<void> future) { future.wait(); }, std::move(can_continue_future)));
+
+  int val = 0;
+  handler_->Post(common::BindOnce([](Handler* handler) { handler->Clear(); }, common::Unretained(handler_)));
+  handler_->Post(common::BindOnce([](int* val) { *val = 1; }, common::Unretained(&val)));
+  can_continue.set_value();
+
+  ASSERT_TRUE(thread_->GetReactor()->WaitForIdle(std::chrono::milliseconds(100)));
+  ASSERT_EQ(val, 0);
+}
+
+TEST_F(HandlerTest, dispatch_budget_is_clamped) {
+  Reactor* reactor = thread_->GetReactor();
+  ASSERT_EQ(reactor->GetDispatchBudget(), Reactor::kDefaultDispatchBudget);
+  reactor->SetDispatchBudget(0);
+  ASSERT_EQ(reactor->GetDispatchBudget(), 1ul);
+  reactor->SetDispatchBudget(Reactor::kMaxDispatchBudget + 1);
+  ASSERT_EQ(reactor->GetDispatchBudget(), Reactor::kMaxDispatchBudget);
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, named_in_reactor_stats) {
+  handler_->SetName("test_handler");
+  std::promise<void> closure_ran;
+  auto future = closure_ran.get_future();
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&closure_ran)));
+  future.wait();
+  ASSERT_TRUE(thread_->GetReactor()->WaitForIdle(std::chrono::milliseconds(100)));
+
+  bool found = false;
+  for (const auto& stats : thread_->GetReactor()->GetReactableStats()) {
+    if (stats.name == "test_handler") {
+      found = true;
+      ASSERT_EQ(stats.dispatch_count, 1u);
+      ASSERT_GE(stats.total_time, stats.max_time);
+    }
+  }
+  ASSERT_TRUE(found);
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, profiled_tasks_are_counted) {
+  common::TaskProfiler::SetEnabled(true);
+  std::promise<void> closure_ran;
+  auto future = closure_ran.get_future();
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&closure_ran)));
+  future.wait();
+  ASSERT_TRUE(thread_->GetReactor()->WaitForIdle(std::chrono::milliseconds(100)));
+  common::TaskProfiler::SetEnabled(false);
+
+  auto stats = thread_->GetTaskProfiler()->GetStats();
+  ASSERT_EQ(stats.name, "test_thread");
+  ASSERT_EQ(stats.posted_count, 1u);
+  ASSERT_EQ(stats.executed_count, 1u);
+  ASSERT_EQ(stats.slowest.size(), 1u);
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, post_inline_task_invoked) {
+  std::promise<int> closure_ran;
+  auto future = closure_ran.get_future();
+  auto value = std::make_unique<int>(1);
+  handler_->PostInline(
+      [&closure_ran, value = std::move(value)]() { closure_ran.set_value(*value); });
+  ASSERT_EQ(future.get(), 1);
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, contextual_callback_runs_on_handler) {
+  std::promise<std::thread::id> callback_ran;
+  auto future = callback_ran.get_future();
+  auto callback = handler_->BindOnce(
+      [](std::promise<std::thread::id>* promise, std::unique_ptr<int> value) {
+        ASSERT_EQ(*value, 2);
+        promise->set_value(std::this_thread::get_id());
+      },
+      common::Unretained(&callback_ran));
+  callback(std::make_unique<int>(2));
+  ASSERT_NE(future.get(), std::this_thread::get_id());
+  handler_->Clear();
+}
+
 // For Death tests, all the threading needs to be done in the ASSERT_DEATH call
 class HandlerDeathTest : public ::testing::Test {
  protected:
@@ -16,75 +16,27 @@
 
 #include "os/alarm.h"
 
-#include <bluetooth/log.h>
-#include <sys/timerfd.h>
-#include <unistd.h>
-
-#include <cstring>
-
-#include "common/bind.h"
-#include "os/linux_generic/linux.h"
-#include "os/log.h"
-#include "os/utils.h"
-
-#ifdef __ANDROID__
-#define ALARM_CLOCK CLOCK_BOOTTIME_ALARM
-#else
-#define ALARM_CLOCK CLOCK_BOOTTIME
-#endif
+#include "os/linux_generic/alarm_multiplexer.h"
 
 namespace bluetooth {
 namespace os {
-using common::Closure;
 using common::OnceClosure;
 
-Alarm::Alarm(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, 0)) {
-  log::assert_that(fd_ != -1, "cannot create timerfd: {}", strerror(errno));
-
-  token_ = handler_->thread_->GetReactor()->Register(
-      fd_, common::Bind(&Alarm::on_fire, common::Unretained(this)), Closure());
-}
+Alarm::Alarm(Handler* handler)
+    : handler_(handler),
+      multiplexer_(handler_->thread_->GetAlarmMultiplexer()),
+      id_(multiplexer_->NewAlarmId()) {}
 
 Alarm::~Alarm() {
-  handler_->thread_->GetReactor()->Unregister(token_);
-
-  int close_status;
-  RUN_NO_INTR(close_status = TIMERFD_CLOSE(fd_));
-  log::assert_that(close_status != -1, "assert failed: close_status != -1");
+  multiplexer_->Cancel(id_);
 }
 
-void Alarm::Schedule(OnceClosure task, std::chrono::milliseconds delay) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  long delay_ms = delay.count();
-  itimerspec timer_itimerspec{{/* interval for periodic timer */}, {delay_ms / 1000, delay_ms % 1000 * 1000000}};
-  int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
-  log::assert_that(result == 0, "assert failed: result == 0");
-
-  task_ = std::move(task);
+void Alarm::Schedule(OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack) {
+  multiplexer_->Schedule(id_, std::move(task), delay, slack);
 }
 
 void Alarm::Cancel() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  itimerspec disarm_itimerspec{/* disarm timer */};
-  int result = TIMERFD_SETTIME(fd_, 0, &disarm_itimerspec, nullptr);
-  log::assert_that(result == 0, "assert failed: result == 0");
-}
-
-void Alarm::on_fire() {
-  std::unique_lock<std::mutex> lock(mutex_);
-  auto task = std::move(task_);
-  uint64_t times_invoked;
-  auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
-  lock.unlock();
-  log::assert_that(
-      bytes_read == static_cast<ssize_t>(sizeof(uint64_t)),
-      "assert failed: bytes_read == static_cast<ssize_t>(sizeof(uint64_t))");
-  log::assert_that(
-      times_invoked == static_cast<uint64_t>(1),
-      "Invoked number of times:{} fd:{}",
-      (unsigned long)times_invoked,
-      fd_);
-  std::move(task).Run();
+  multiplexer_->Cancel(id_);
 }
 
 }  // namespace os
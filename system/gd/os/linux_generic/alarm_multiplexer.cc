@@ -0,0 +1,223 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/linux_generic/alarm_multiplexer.h"
+
+#include <bluetooth/log.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "common/bind.h"
+#include "os/linux_generic/linux.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+#ifdef __ANDROID__
+#define ALARM_CLOCK CLOCK_BOOTTIME_ALARM
+#else
+#define ALARM_CLOCK CLOCK_BOOTTIME
+#endif
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+// Current time on the clock used by the timerfd, in ms
+uint64_t now_ms() {
+#ifdef USE_FAKE_TIMERS
+  return fake_timer::fake_timerfd_get_clock();
+#else
+  timespec ts;
+  int result = clock_gettime(CLOCK_BOOTTIME, &ts);
+  log::assert_that(result == 0, "cannot read clock: {}", strerror(errno));
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+// Round |deadline_ms| up to a multiple of the largest power of two that is not above |slack_ms|
+uint64_t align_deadline(uint64_t deadline_ms, int64_t slack_ms) {
+  if (slack_ms <= 0) {
+    return deadline_ms;
+  }
+  uint64_t granularity = uint64_t{1} << (63 - __builtin_clzll(static_cast<uint64_t>(slack_ms)));
+  return (deadline_ms + granularity - 1) & ~(granularity - 1);
+}
+
+}  // namespace
+
+AlarmMultiplexer::AlarmMultiplexer(Reactor* reactor, std::chrono::milliseconds slack)
+    : reactor_(reactor), slack_ms_(slack.count() > 0 ? slack.count() : 0), fd_(TIMERFD_CREATE(ALARM_CLOCK, TFD_NONBLOCK)) {
+  log::assert_that(fd_ != -1, "cannot create timerfd: {}", strerror(errno));
+
+  token_ = reactor_->Register(
+      fd_, common::Bind(&AlarmMultiplexer::on_timer, common::Unretained(this)), common::Closure());
+  reactor_->SetReactableName(token_, "alarm_multiplexer");
+}
+
+AlarmMultiplexer::~AlarmMultiplexer() {
+  reactor_->Unregister(token_);
+
+  int close_status;
+  RUN_NO_INTR(close_status = TIMERFD_CLOSE(fd_));
+  log::assert_that(close_status != -1, "assert failed: close_status != -1");
+}
+
+AlarmMultiplexer::AlarmId AlarmMultiplexer::NewAlarmId() {
+  return next_id_++;
+}
+
+void AlarmMultiplexer::Schedule(
+    AlarmId id, common::OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(id);
+  uint64_t now = now_ms();
+  insert_locked(align_deadline(now + delay.count(), slack.count()), Entry{id, 0, std::move(task), common::Closure()});
+  arm_locked(now);
+}
+
+void AlarmMultiplexer::ScheduleRepeating(AlarmId id, common::Closure task, std::chrono::milliseconds period) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(id);
+  uint64_t now = now_ms();
+  if (period.count() <= 0) {
+    // Like a timerfd with a zero interval, this leaves the alarm disarmed
+    arm_locked(now);
+    return;
+  }
+  insert_locked(now + period.count(), Entry{id, static_cast<uint64_t>(period.count()), common::OnceClosure(), task});
+  arm_locked(now);
+}
+
+void AlarmMultiplexer::Cancel(AlarmId id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(id);
+  // Only touches the timerfd if |id| was the next one to wake up for
+  arm_locked(now_ms());
+}
+
+uint64_t AlarmMultiplexer::GetWakeupCount() const {
+  return wakeup_count_;
+}
+
+void AlarmMultiplexer::insert_locked(uint64_t deadline_ms, Entry entry) {
+  Key key{deadline_ms, next_sequence_++};
+  keys_[entry.id] = key;
+  timeline_.emplace(key, std::move(entry));
+}
+
+void AlarmMultiplexer::cancel_locked(AlarmId id) {
+  auto key = keys_.find(id);
+  if (key == keys_.end()) {
+    return;
+  }
+  timeline_.erase(key->second);
+  keys_.erase(key);
+}
+
+void AlarmMultiplexer::arm_locked(uint64_t now) {
+  if (timeline_.empty()) {
+    if (armed_ms_ != kDisarmed) {
+      itimerspec disarm_itimerspec{/* disarm timer */};
+      int result = TIMERFD_SETTIME(fd_, 0, &disarm_itimerspec, nullptr);
+      log::assert_that(result == 0, "assert failed: result == 0");
+      armed_ms_ = kDisarmed;
+    }
+    return;
+  }
+
+  // Wake up for the last deadline within the slack of the earliest one, so that all of them run together
+  uint64_t window_end_ms = timeline_.begin()->first.first + slack_ms_;
+  uint64_t target_ms = timeline_.begin()->first.first;
+  for (auto it = timeline_.begin(); it != timeline_.end() && it->first.first <= window_end_ms; it++) {
+    target_ms = it->first.first;
+  }
+  if (target_ms == armed_ms_) {
+    return;
+  }
+
+  // A zero it_value disarms the timer, so alarms that are already due wake up after 1 ms
+  long delay_ms = target_ms > now ? static_cast<long>(target_ms - now) : 1;
+  itimerspec timer_itimerspec{{/* interval for periodic timer */}, {delay_ms / 1000, delay_ms % 1000 * 1000000}};
+  int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
+  log::assert_that(result == 0, "assert failed: result == 0");
+  armed_ms_ = target_ms;
+}
+
+void AlarmMultiplexer::on_timer() {
+  uint64_t times_invoked;
+  // The timerfd is non-blocking: re-arming it from another thread after the reactor woke up clears the expiration
+  // count, in which case there is nothing to read
+  auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
+  log::assert_that(
+      bytes_read == static_cast<ssize_t>(sizeof(uint64_t)) || errno == EAGAIN,
+      "cannot read timerfd: {}",
+      strerror(errno));
+  wakeup_count_++;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  armed_ms_ = kDisarmed;
+  uint64_t now = now_ms();
+  // Alarms set by the tasks below wait for the next wakeup, so that an alarm re-scheduling itself without delay
+  // cannot keep this loop busy. Periodic alarms keep their place and catch up within the same wakeup.
+  uint64_t sequence_end = next_sequence_;
+
+  // Run the due alarms one at a time without holding the lock, so their tasks can schedule and cancel alarms,
+  // including the ones that are due next
+  while (true) {
+    auto first = timeline_.begin();
+    if (first == timeline_.end() || first->first.first > now || first->first.second >= sequence_end) {
+      arm_locked(now_ms());
+      return;
+    }
+
+    Key key = first->first;
+    Entry entry = std::move(first->second);
+    timeline_.erase(first);
+    keys_.erase(entry.id);
+
+    common::OnceClosure task;
+    common::Closure repeating_task;
+    if (entry.period_ms == 0) {
+      task = std::move(entry.task);
+    } else {
+      uint64_t next_deadline_ms = key.first + entry.period_ms;
+      if (next_deadline_ms <= now && (now - next_deadline_ms) / entry.period_ms >= kMaxCatchUpPeriods) {
+        next_deadline_ms = now + entry.period_ms - (now - key.first) % entry.period_ms;
+      }
+      repeating_task = entry.repeating_task;
+      keys_[entry.id] = Key{next_deadline_ms, key.second};
+      timeline_.emplace(Key{next_deadline_ms, key.second}, std::move(entry));
+    }
+
+    lock.unlock();
+    if (!task.is_null()) {
+      std::move(task).Run();
+    } else {
+      repeating_task.Run();
+    }
+    // What the tasks hold may own alarms of this multiplexer, so release it before taking the lock again
+    task = common::OnceClosure();
+    repeating_task = common::Closure();
+    lock.lock();
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "common/callback.h"
+#include "os/reactor.h"
+
+namespace bluetooth {
+namespace os {
+
+// Drives all the alarms of a reactor thread from a single timerfd. Pending alarms are kept ordered by deadline, and
+// the timerfd is only re-armed when the earliest wakeup changes. Alarms due within |slack| of the earliest one are run
+// in the same wakeup instead of arming the timer again; no alarm ever runs before its deadline.
+class AlarmMultiplexer {
+ public:
+  using AlarmId = uint64_t;
+
+  // Create a timerfd and register it on |reactor|
+  AlarmMultiplexer(Reactor* reactor, std::chrono::milliseconds slack);
+
+  AlarmMultiplexer(const AlarmMultiplexer&) = delete;
+  AlarmMultiplexer& operator=(const AlarmMultiplexer&) = delete;
+
+  // Unregister from the reactor and release the timerfd. Pending alarms are dropped.
+  ~AlarmMultiplexer();
+
+  // Return a new identifier for an alarm of this multiplexer
+  AlarmId NewAlarmId();
+
+  // Run |task| on the reactor thread after |delay|. Replaces whatever was scheduled for |id|. A non zero |slack| lets
+  // the deadline move up to a multiple of the largest power of two ms within |slack|, so that alarms with similar
+  // delays land on the same wakeup.
+  void Schedule(
+      AlarmId id,
+      common::OnceClosure task,
+      std::chrono::milliseconds delay,
+      std::chrono::milliseconds slack = std::chrono::milliseconds(0));
+
+  // Run |task| on the reactor thread every |period|. Replaces whatever was scheduled for |id|.
+  void ScheduleRepeating(AlarmId id, common::Closure task, std::chrono::milliseconds period);
+
+  // Cancel what was scheduled for |id|. No-op if nothing is.
+  void Cancel(AlarmId id);
+
+  // Number of times the timerfd woke up the reactor thread
+  uint64_t GetWakeupCount() const;
+
+ private:
+  struct Entry {
+    AlarmId id;
+    uint64_t period_ms;  // 0 for single-shot alarms
+    common::OnceClosure task;
+    common::Closure repeating_task;
+  };
+  // Deadline in ms, then scheduling order so that alarms with the same deadline run in the order they were set
+  using Key = std::pair<uint64_t, uint64_t>;
+
+  void insert_locked(uint64_t deadline_ms, Entry entry);
+  void cancel_locked(AlarmId id);
+  void arm_locked(uint64_t now_ms);
+  void on_timer();
+
+  // Periodic alarms that fell behind, e.g. across a suspend, run once for each missed period up to this many times
+  // and then skip to the next period
+  static constexpr uint64_t kMaxCatchUpPeriods = 128;
+  static constexpr uint64_t kDisarmed = UINT64_MAX;
+
+  Reactor* reactor_;
+  const uint64_t slack_ms_;
+  int fd_;
+  Reactor::Reactable* token_;
+  std::atomic<AlarmId> next_id_{1};
+  std::atomic<uint64_t> wakeup_count_{0};
+
+  mutable std::mutex mutex_;
+  std::map<Key, Entry> timeline_;
+  std::unordered_map<AlarmId, Key> keys_;
+  uint64_t next_sequence_ = 0;
+  uint64_t armed_ms_ = kDisarmed;  // Absolute time the timerfd is armed for
+};
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/linux_generic/alarm_multiplexer.h"
+
+#include <memory>
+#include <vector>
+
+#include "common/bind.h"
+#include "gtest/gtest.h"
+#include "os/fake_timer/fake_timerfd.h"
+#include "os/handler.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+using common::BindOnce;
+using fake_timer::fake_timerfd_advance;
+using fake_timer::fake_timerfd_reset;
+using std::chrono::milliseconds;
+
+class AlarmMultiplexerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_);
+  }
+
+  void TearDown() override {
+    multiplexer_.reset();
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    fake_timerfd_reset();
+  }
+
+  void CreateMultiplexer(milliseconds slack) {
+    multiplexer_ = std::make_unique<AlarmMultiplexer>(thread_->GetReactor(), slack);
+  }
+
+  // Advance the fake clock on the thread, and wait for the alarms that became due to run
+  void AdvanceAndWaitForIdle(uint64_t ms) {
+    handler_->Post(BindOnce(fake_timerfd_advance, ms));
+    ASSERT_TRUE(thread_->GetReactor()->WaitForIdle(std::chrono::seconds(1)));
+  }
+
+  common::OnceClosure Record(int value) {
+    return BindOnce(&AlarmMultiplexerTest::record, common::Unretained(this), value);
+  }
+
+  common::Closure RecordRepeating(int value) {
+    return common::Bind(&AlarmMultiplexerTest::record, common::Unretained(this), value);
+  }
+
+  // Records |first| and schedules |id| again without delay, to record |second|
+  common::OnceClosure RecordAndReschedule(AlarmMultiplexer::AlarmId id, int first, int second) {
+    return BindOnce(
+        [](AlarmMultiplexerTest* test, AlarmMultiplexer::AlarmId id, int first, int second) {
+          test->record(first);
+          test->multiplexer_->Schedule(id, test->Record(second), milliseconds(0));
+        },
+        common::Unretained(this),
+        id,
+        first,
+        second);
+  }
+
+  void record(int value) {
+    fired_.push_back(value);
+  }
+
+  std::unique_ptr<AlarmMultiplexer> multiplexer_;
+  std::vector<int> fired_;
+
+ private:
+  Thread* thread_;
+  Handler* handler_;
+};
+
+TEST_F(AlarmMultiplexerTest, alarms_run_in_deadline_order_from_one_wakeup) {
+  CreateMultiplexer(milliseconds(0));
+  auto first = multiplexer_->NewAlarmId();
+  auto second = multiplexer_->NewAlarmId();
+  auto third = multiplexer_->NewAlarmId();
+  multiplexer_->Schedule(first, Record(1), milliseconds(30));
+  multiplexer_->Schedule(second, Record(2), milliseconds(10));
+  multiplexer_->Schedule(third, Record(3), milliseconds(20));
+
+  AdvanceAndWaitForIdle(30);
+  ASSERT_EQ(fired_, std::vector<int>({2, 3, 1}));
+  ASSERT_EQ(multiplexer_->GetWakeupCount(), 1u);
+}
+
+TEST_F(AlarmMultiplexerTest, schedule_replaces_pending_alarm) {
+  CreateMultiplexer(milliseconds(0));
+  auto id = multiplexer_->NewAlarmId();
+  multiplexer_->Schedule(id, Record(1), milliseconds(10));
+  multiplexer_->Schedule(id, Record(2), milliseconds(20));
+
+  AdvanceAndWaitForIdle(20);
+  ASSERT_EQ(fired_, std::vector<int>({2}));
+}
+
+TEST_F(AlarmMultiplexerTest, cancel_earliest_alarm) {
+  CreateMultiplexer(milliseconds(0));
+  auto first = multiplexer_->NewAlarmId();
+  auto second = multiplexer_->NewAlarmId();
+  multiplexer_->Schedule(first, Record(1), milliseconds(10));
+  multiplexer_->Schedule(second, Record(2), milliseconds(20));
+  multiplexer_->Cancel(first);
+
+  AdvanceAndWaitForIdle(10);
+  ASSERT_TRUE(fired_.empty());
+  ASSERT_EQ(multiplexer_->GetWakeupCount(), 0u);
+
+  AdvanceAndWaitForIdle(10);
+  ASSERT_EQ(fired_, std::vector<int>({2}));
+}
+
+TEST_F(AlarmMultiplexerTest, alarms_within_slack_share_a_wakeup) {
+  CreateMultiplexer(milliseconds(5));
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(1), milliseconds(10));
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(2), milliseconds(12));
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(3), milliseconds(20));
+
+  // The first alarm waits for the second one, but never runs early
+  AdvanceAndWaitForIdle(10);
+  ASSERT_TRUE(fired_.empty());
+
+  AdvanceAndWaitForIdle(2);
+  ASSERT_EQ(fired_, std::vector<int>({1, 2}));
+  ASSERT_EQ(multiplexer_->GetWakeupCount(), 1u);
+
+  AdvanceAndWaitForIdle(8);
+  ASSERT_EQ(fired_, std::vector<int>({1, 2, 3}));
+  ASSERT_EQ(multiplexer_->GetWakeupCount(), 2u);
+}
+
+TEST_F(AlarmMultiplexerTest, alarms_without_slack_wake_up_separately) {
+  CreateMultiplexer(milliseconds(0));
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(1), milliseconds(10));
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(2), milliseconds(12));
+
+  AdvanceAndWaitForIdle(10);
+  ASSERT_EQ(fired_, std::vector<int>({1}));
+
+  AdvanceAndWaitForIdle(2);
+  ASSERT_EQ(fired_, std::vector<int>({1, 2}));
+  ASSERT_EQ(multiplexer_->GetWakeupCount(), 2u);
+}
+
+TEST_F(AlarmMultiplexerTest, alarms_with_slack_align_to_the_same_wakeup) {
+  CreateMultiplexer(milliseconds(0));
+  // With 8 ms of slack, both deadlines move up to the next multiple of 8 ms
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(1), milliseconds(10), milliseconds(8));
+  multiplexer_->Schedule(multiplexer_->NewAlarmId(), Record(2), milliseconds(13), milliseconds(8));
+
+  AdvanceAndWaitForIdle(10);
+  ASSERT_TRUE(fired_.empty());
+
+  AdvanceAndWaitForIdle(6);
+  ASSERT_EQ(fired_, std::vector<int>({1, 2}));
+  ASSERT_EQ(multiplexer_->GetWakeupCount(), 1u);
+}
+
+TEST_F(AlarmMultiplexerTest, repeating_alarm_runs_for_each_period) {
+  CreateMultiplexer(milliseconds(0));
+  auto id = multiplexer_->NewAlarmId();
+  multiplexer_->ScheduleRepeating(id, RecordRepeating(1), milliseconds(10));
+
+  AdvanceAndWaitForIdle(50);
+  ASSERT_EQ(fired_.size(), 5u);
+
+  multiplexer_->Cancel(id);
+  AdvanceAndWaitForIdle(50);
+  ASSERT_EQ(fired_.size(), 5u);
+}
+
+TEST_F(AlarmMultiplexerTest, alarm_scheduled_from_task_waits_for_next_wakeup) {
+  CreateMultiplexer(milliseconds(0));
+  auto id = multiplexer_->NewAlarmId();
+  multiplexer_->Schedule(id, RecordAndReschedule(id, 1, 2), milliseconds(10));
+
+  AdvanceAndWaitForIdle(10);
+  ASSERT_EQ(fired_, std::vector<int>({1}));
+
+  AdvanceAndWaitForIdle(1);
+  ASSERT_EQ(fired_, std::vector<int>({1, 2}));
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
@@ -812,6 +812,49 @@ TEST_F(QueueTest, unregister_dequeue_and_wait) {
   delete indicator;
 }
 
+// TryDequeueBatch returns the data in order, at most |max| at a time, and frees the room it took
+TEST_F(QueueTest, try_dequeue_batch) {
+  Queue<std::string> queue(kQueueSize);
+  TestEnqueueEnd test_enqueue_end(&queue, enqueue_handler_);
+
+  // make Queue full
+  for (int i = 0; i < kQueueSize; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+  std::unordered_map<int, std::promise<int>> enqueue_promise_map;
+  enqueue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(0), std::forward_as_tuple());
+  auto enqueue_future = enqueue_promise_map[0].get_future();
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+  enqueue_future.wait();
+  sync_enqueue_handler();
+
+  auto batch = queue.TryDequeueBatch(kHalfOfQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kHalfOfQueueSize);
+  for (int i = 0; i < kHalfOfQueueSize; i++) {
+    EXPECT_EQ(*batch[i], std::to_string(i));
+  }
+
+  // Room for the dequeued data is back
+  for (int i = 0; i < kHalfOfQueueSize; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(kQueueSize + i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+  enqueue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(0), std::forward_as_tuple());
+  enqueue_future = enqueue_promise_map[0].get_future();
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+  enqueue_future.wait();
+  sync_enqueue_handler();
+
+  batch = queue.TryDequeueBatch(kDoubleOfQueueSize);
+  ASSERT_EQ(batch.size(), (size_t)kQueueSize);
+  for (int i = 0; i < kQueueSize; i++) {
+    EXPECT_EQ(*batch[i], std::to_string(kHalfOfQueueSize + i));
+  }
+  EXPECT_TRUE(queue.TryDequeueBatch(kQueueSize).empty());
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
 // Create all threads for death tests in the function that dies
 class QueueDeathTest : public ::testing::Test {
  public:
@@ -910,6 +953,21 @@ TEST_F(EnqueueBufferTest, enqueue) {
   ASSERT_FALSE(enqueue_.registered_);
 }
 
+TEST_F(EnqueueBufferTest, enqueue_batch) {
+  int num_items = 10;
+  std::vector<std::unique_ptr<int>> items;
+  for (int i = 0; i < num_items; i++) {
+    items.push_back(std::make_unique<int>(i));
+  }
+  enqueue_buffer_.Enqueue(std::move(items), handler_);
+  SynchronizeHandler();
+  for (int i = 0; i < num_items; i++) {
+    ASSERT_EQ(enqueue_.queue_.front(), i);
+    enqueue_.queue_.pop();
+  }
+  ASSERT_FALSE(enqueue_.registered_);
+}
+
 TEST_F(EnqueueBufferTest, clear) {
   enqueue_.dont_handle_register_enqueue_ = true;
   int num_items = 10;
@@ -45,9 +45,8 @@ void ReactiveSemaphore::Decrease() {
   log::assert_that(read_result != -1, "decrease failed: {}", strerror(errno));
 }
 
-void ReactiveSemaphore::Increase() {
-  uint64_t val = 1;
-  auto write_result = eventfd_write(fd_, val);
+void ReactiveSemaphore::Increase(uint64_t count) {
+  auto write_result = eventfd_write(fd_, count);
   log::assert_that(write_result != -1, "increase failed: {}", strerror(errno));
 }
 
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
 
@@ -98,6 +99,24 @@ class Reactor::Reactable {
   bool removed_;
   std::mutex mutex_;
   std::unique_ptr<std::promise<void>> finished_promise_;
+
+  // Statistics are only written by the reactor thread; name_ is protected by Reactor::mutex_.
+  std::string name_;
+  std::atomic<uint64_t> dispatch_count_{0};
+  std::atomic<int64_t> total_time_ns_{0};
+  std::atomic<int64_t> max_time_ns_{0};
+  std::atomic<int64_t> max_delay_ns_{0};
+
+  void UpdateStats(std::chrono::nanoseconds delay, std::chrono::nanoseconds time) {
+    dispatch_count_.store(dispatch_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total_time_ns_.store(total_time_ns_.load(std::memory_order_relaxed) + time.count(), std::memory_order_relaxed);
+    if (time.count() > max_time_ns_.load(std::memory_order_relaxed)) {
+      max_time_ns_.store(time.count(), std::memory_order_relaxed);
+    }
+    if (delay.count() > max_delay_ns_.load(std::memory_order_relaxed)) {
+      max_delay_ns_.store(delay.count(), std::memory_order_relaxed);
+    }
+  }
 };
 
 Reactor::Reactor() : epoll_fd_(0), control_fd_(0), is_running_(false) {
@@ -140,6 +159,7 @@ void Reactor::Run() {
     int count;
     RUN_NO_INTR(count = epoll_wait(epoll_fd_, events, kEpollMaxEvents, timeout_ms));
     log::assert_that(count != -1, "epoll_wait failed: fd={}, err={}", epoll_fd_, strerror(errno));
+    const auto wakeup_time = std::chrono::steady_clock::now();
     if (waiting_for_idle && count == 0) {
       timeout_ms = -1;
       waiting_for_idle = false;
@@ -181,12 +201,14 @@ void Reactor::Run() {
         lock.unlock();
         reactable->is_executing_ = true;
       }
+      const auto dispatch_time = std::chrono::steady_clock::now();
       if (event.events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP | EPOLLERR) && !reactable->on_read_ready_.is_null()) {
         reactable->on_read_ready_.Run();
       }
       if (event.events & EPOLLOUT && !reactable->on_write_ready_.is_null()) {
         reactable->on_write_ready_.Run();
       }
+      reactable->UpdateStats(dispatch_time - wakeup_time, std::chrono::steady_clock::now() - dispatch_time);
       {
         std::unique_lock<std::mutex> reactable_lock(reactable->mutex_);
         reactable->is_executing_ = false;
@@ -221,6 +243,10 @@ Reactor::Reactable* Reactor::Register(int fd, Closure on_read_ready, Closure on_
     poll_event_type |= EPOLLOUT;
   }
   auto* reactable = new Reactable(fd, on_read_ready, on_write_ready);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    registered_list_.push_back(reactable);
+  }
   epoll_event event = {
       .events = poll_event_type,
       .data = {.ptr = reactable},
@@ -236,6 +262,7 @@ void Reactor::Unregister(Reactor::Reactable* reactable) {
   {
     std::lock_guard<std::mutex> lock(mutex_);
     invalidation_list_.push_back(reactable);
+    registered_list_.remove(reactable);
   }
   bool delaying_delete_until_callback_finished = false;
   {
@@ -309,5 +336,35 @@ void Reactor::ModifyRegistration(Reactor::Reactable* reactable, ReactOn react_on
   log::assert_that(modify_fd != -1, "assert failed: modify_fd != -1");
 }
 
+void Reactor::SetReactableName(Reactor::Reactable* reactable, std::string name) {
+  log::assert_that(reactable != nullptr, "assert failed: reactable != nullptr");
+  std::lock_guard<std::mutex> lock(mutex_);
+  reactable->name_ = std::move(name);
+}
+
+void Reactor::SetDispatchBudget(size_t budget) {
+  dispatch_budget_ = std::clamp<size_t>(budget, 1, kMaxDispatchBudget);
+}
+
+size_t Reactor::GetDispatchBudget() const {
+  return dispatch_budget_;
+}
+
+std::vector<Reactor::ReactableStats> Reactor::GetReactableStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ReactableStats> stats;
+  stats.reserve(registered_list_.size());
+  for (const auto* reactable : registered_list_) {
+    stats.push_back({
+        .name = reactable->name_.empty() ? "fd:" + std::to_string(reactable->fd_) : reactable->name_,
+        .dispatch_count = reactable->dispatch_count_.load(std::memory_order_relaxed),
+        .total_time = std::chrono::nanoseconds(reactable->total_time_ns_.load(std::memory_order_relaxed)),
+        .max_time = std::chrono::nanoseconds(reactable->max_time_ns_.load(std::memory_order_relaxed)),
+        .max_delay = std::chrono::nanoseconds(reactable->max_delay_ns_.load(std::memory_order_relaxed)),
+    });
+  }
+  return stats;
+}
+
 }  // namespace os
 }  // namespace bluetooth
@@ -24,17 +24,22 @@
 #include <cerrno>
 #include <cstring>
 
+#include "common/thread_policy.h"
+#include "os/linux_generic/alarm_multiplexer.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace os {
 
 namespace {
 constexpr int kRealTimeFifoSchedulingPriority = 1;
+// Alarms of a thread due within this many ms of each other share a wakeup
+constexpr char kAlarmSlackProperty[] = "bluetooth.os.alarm.slack_ms";
 }
 
 Thread::Thread(const std::string& name, const Priority priority)
-    : name_(name), reactor_(), running_thread_(&Thread::run, this, priority) {}
+    : name_(name), reactor_(), task_profiler_(name), running_thread_(&Thread::run, this, priority) {}
 
 void Thread::run(Priority priority) {
   if (priority == Priority::REAL_TIME) {
@@ -46,6 +51,7 @@ void Thread::run(Priority priority) {
       log::error("unable to set SCHED_FIFO priority: {}", strerror(errno));
     }
   }
+  common::ApplyThreadPolicy(name_);
   reactor_.Run();
 }
 
@@ -75,6 +81,18 @@ Reactor* Thread::GetReactor() const {
   return &reactor_;
 }
 
+common::TaskProfiler* Thread::GetTaskProfiler() const {
+  return &task_profiler_;
+}
+
+AlarmMultiplexer* Thread::GetAlarmMultiplexer() const {
+  std::call_once(alarm_multiplexer_once_, [this]() {
+    auto slack = std::chrono::milliseconds(GetSystemPropertyUint32(kAlarmSlackProperty, 0));
+    alarm_multiplexer_ = std::make_unique<AlarmMultiplexer>(&reactor_, slack);
+  });
+  return alarm_multiplexer_.get();
+}
+
 std::string Thread::GetThreadName() const {
   return name_;
 }
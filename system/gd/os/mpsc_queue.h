@@ -0,0 +1,92 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <utility>
+
+namespace bluetooth {
+namespace os {
+
+// Unbounded multi-producer / single-consumer queue.
+//
+// Push() is lock-free and may be called from any thread. TryPop() and Pop() must only be called by
+// one consumer at a time. Based on Dmitry Vyukov's intrusive MPSC node queue: a producer first
+// swaps itself in as the new head and then links the previous head to it, so a consumer can
+// briefly observe a queue whose newest elements are not linked yet.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue() {
+    Node* node = tail_;
+    while (node != nullptr) {
+      Node* next = node->next.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  void Push(T value) {
+    Node* node = new Node(std::move(value));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Moves the oldest linked element into |value| and returns true, or returns false if there is
+  // none. May return false while a concurrent Push() is still linking its element.
+  bool TryPop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    *value = std::move(next->value);
+    tail_ = next;
+    delete tail;
+    return true;
+  }
+
+  // Like TryPop(), but waits for the element to be linked. Must only be called when the caller
+  // knows an element has been pushed, e.g. through a separate counter.
+  void Pop(T* value) {
+    while (!TryPop(value)) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T value) : value(std::move(value)) {}
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  // Most recently pushed node, shared by the producers.
+  std::atomic<Node*> head_;
+  // Already consumed node preceding the oldest element, owned by the consumer.
+  Node* tail_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
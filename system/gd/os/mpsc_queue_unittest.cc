@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/mpsc_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+TEST(MpscQueueTest, empty) {
+  MpscQueue<int> queue;
+  int value = 0;
+  ASSERT_FALSE(queue.TryPop(&value));
+}
+
+TEST(MpscQueueTest, fifo_order) {
+  MpscQueue<int> queue;
+  for (int i = 0; i < 10; i++) {
+    queue.Push(i);
+  }
+  for (int i = 0; i < 10; i++) {
+    int value = -1;
+    ASSERT_TRUE(queue.TryPop(&value));
+    ASSERT_EQ(i, value);
+  }
+  int value = -1;
+  ASSERT_FALSE(queue.TryPop(&value));
+}
+
+TEST(MpscQueueTest, move_only_values) {
+  MpscQueue<std::unique_ptr<int>> queue;
+  queue.Push(std::make_unique<int>(42));
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(queue.TryPop(&value));
+  ASSERT_EQ(42, *value);
+}
+
+TEST(MpscQueueTest, destroy_non_empty) {
+  MpscQueue<std::unique_ptr<int>> queue;
+  queue.Push(std::make_unique<int>(1));
+  queue.Push(std::make_unique<int>(2));
+}
+
+TEST(MpscQueueTest, multiple_producers) {
+  constexpr int kNumProducers = 4;
+  constexpr int kNumValuesPerProducer = 10000;
+  MpscQueue<std::pair<int, int>> queue;
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kNumProducers; producer++) {
+    producers.emplace_back([&queue, producer]() {
+      for (int i = 0; i < kNumValuesPerProducer; i++) {
+        queue.Push({producer, i});
+      }
+    });
+  }
+
+  // Values of each producer must come out in the order they were pushed.
+  std::vector<int> next_value(kNumProducers, 0);
+  for (int received = 0; received < kNumProducers * kNumValuesPerProducer; received++) {
+    std::pair<int, int> value;
+    queue.Pop(&value);
+    ASSERT_EQ(next_value[value.first], value.second);
+    next_value[value.first]++;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  std::pair<int, int> value;
+  ASSERT_FALSE(queue.TryPop(&value));
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
@@ -19,9 +19,11 @@
 #include <bluetooth/log.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -51,6 +53,18 @@ class IQueueDequeue {
   virtual void RegisterDequeue(Handler* handler, DequeueCallback callback) = 0;
   virtual void UnregisterDequeue() = 0;
   virtual std::unique_ptr<T> TryDequeue() = 0;
+  // Dequeue up to |max| items, stopping early when TryDequeue returns nullptr.
+  virtual std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max) {
+    std::vector<std::unique_ptr<T>> items;
+    while (items.size() < max) {
+      std::unique_ptr<T> item = TryDequeue();
+      if (item == nullptr) {
+        break;
+      }
+      items.push_back(std::move(item));
+    }
+    return items;
+  }
 };
 
 template <typename T>
@@ -79,6 +93,10 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
   // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
   std::unique_ptr<T> TryDequeue() override;
 
+  // Try to dequeue up to |max| items from this queue with a single lock of the queue, so that a dequeue callback
+  // can drain everything that is ready at once. Return an empty vector when there is nothing in the queue.
+  std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max) override;
+
  private:
   void EnqueueCallbackInternal(EnqueueCallback callback);
   // An internal queue that holds at most |capacity| pieces of data
@@ -118,6 +136,20 @@ class EnqueueBuffer {
     }
   }
 
+  // Same as Enqueue for each of |ts|, in order, taking the buffer lock once.
+  void Enqueue(std::vector<std::unique_ptr<T>> ts, os::Handler* handler) {
+    if (ts.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& t : ts) {
+      buffer_.push(std::move(t));
+    }
+    if (!enqueue_registered_.exchange(true)) {
+      queue_->RegisterEnqueue(handler, common::Bind(&EnqueueBuffer<T>::enqueue_callback, common::Unretained(this)));
+    }
+  }
+
   void Clear() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (enqueue_registered_.exchange(false)) {
@@ -249,6 +281,29 @@ std::unique_ptr<T> Queue<T>::TryDequeue() {
   return data;
 }
 
+template <typename T>
+std::vector<std::unique_ptr<T>> Queue<T>::TryDequeueBatch(size_t max) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<std::unique_ptr<T>> items;
+  size_t count = std::min(max, queue_.size());
+  if (count == 0) {
+    return items;
+  }
+  items.reserve(count);
+
+  // The semaphore is in semaphore mode, each read only takes one
+  for (size_t i = 0; i < count; i++) {
+    dequeue_.reactive_semaphore_.Decrease();
+    items.push_back(std::move(queue_.front()));
+    queue_.pop();
+  }
+
+  enqueue_.reactive_semaphore_.Increase(count);
+
+  return items;
+}
+
 template <typename T>
 void Queue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
   std::unique_ptr<T> data = callback.Run();
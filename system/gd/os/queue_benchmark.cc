@@ -137,6 +137,42 @@ class TestDequeueEnd {
   }
 };
 
+class TestBatchDequeueEnd {
+ public:
+  explicit TestBatchDequeueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+      : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
+
+  void RegisterDequeue() {
+    handler_->Post(common::BindOnce(&TestBatchDequeueEnd::handle_register_dequeue, common::Unretained(this)));
+  }
+
+  void DequeueCallbackForTest() {
+    for (auto& data : queue_->TryDequeueBatch(kMaxBatchSize)) {
+      buffer_.push(std::move(*data));
+      count_--;
+    }
+
+    if (count_ == 0) {
+      queue_->UnregisterDequeue();
+      promise_->set_value();
+    }
+  }
+
+  static constexpr size_t kMaxBatchSize = 16;
+  std::queue<std::string> buffer_;
+  int64_t count_;
+
+ private:
+  Handler* handler_;
+  Queue<std::string>* queue_;
+  std::promise<void>* promise_;
+
+  void handle_register_dequeue() {
+    queue_->RegisterDequeue(
+        handler_, common::Bind(&TestBatchDequeueEnd::DequeueCallbackForTest, common::Unretained(this)));
+  }
+};
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_vary_by_packet_num)(State& state) {
   for (auto _ : state) {
     int64_t num_data_to_send_ = state.range(0);
@@ -202,5 +238,38 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)
     ->Iterations(100)
     ->UseRealTime();
 
+BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_batch_dequeue_vary_by_packet_num)(State& state) {
+  for (auto _ : state) {
+    int64_t num_data_to_send_ = state.range(0);
+    Queue<std::string> queue(num_data_to_send_);
+
+    // register dequeue
+    std::promise<void> dequeue_promise;
+    auto dequeue_future = dequeue_promise.get_future();
+    TestBatchDequeueEnd test_dequeue_end(num_data_to_send_, &queue, dequeue_handler_, &dequeue_promise);
+    test_dequeue_end.RegisterDequeue();
+
+    // Push data to enqueue end buffer and register enqueue
+    std::promise<void> enqueue_promise;
+    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
+    for (int i = 0; i < num_data_to_send_; i++) {
+      std::string data = std::to_string(1);
+      test_enqueue_end.push(std::move(data));
+    }
+    dequeue_future.wait();
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, send_packet_batch_dequeue_vary_by_packet_num)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Iterations(100)
+    ->UseRealTime();
+
 }  // namespace os
 }  // namespace bluetooth
@@ -19,12 +19,15 @@
 #include <sys/epoll.h>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "common/callback.h"
 #include "os/utils.h"
@@ -79,6 +82,32 @@ class Reactor {
   // Modify subscribed poll events on the fly
   void ModifyRegistration(Reactable* reactable, ReactOn react_on);
 
+  // Name a reactable in the statistics returned by GetReactableStats()
+  void SetReactableName(Reactable* reactable, std::string name);
+
+  // Number of queued tasks a Handler may run per readiness notification before yielding back to
+  // the reactor, so that one busy handler cannot starve the other reactables of the thread.
+  static constexpr size_t kDefaultDispatchBudget = 8;
+  static constexpr size_t kMaxDispatchBudget = 64;
+
+  // Set the dispatch budget, clamped to [1, kMaxDispatchBudget]
+  void SetDispatchBudget(size_t budget);
+  size_t GetDispatchBudget() const;
+
+  struct ReactableStats {
+    std::string name;
+    uint64_t dispatch_count;
+    // Total and longest time spent in the callbacks of the reactable
+    std::chrono::nanoseconds total_time;
+    std::chrono::nanoseconds max_time;
+    // Longest time between epoll_wait() returning and the reactable being dispatched, i.e. how
+    // long the reactable waited for the others that became ready in the same iteration
+    std::chrono::nanoseconds max_delay;
+  };
+
+  // Return the statistics of all the currently registered reactables
+  std::vector<ReactableStats> GetReactableStats() const;
+
   class Event {
    public:
     Event();
@@ -102,6 +131,8 @@ class Reactor {
   int control_fd_;
   std::atomic<bool> is_running_;
   std::list<Reactable*> invalidation_list_;
+  std::list<Reactable*> registered_list_;
+  std::atomic<size_t> dispatch_budget_{kDefaultDispatchBudget};
   std::shared_ptr<std::future<void>> executing_reactable_finished_;
   std::shared_ptr<std::promise<void>> idle_promise_;
 };
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -28,18 +29,18 @@
 namespace bluetooth {
 namespace os {
 
-// A repeating alarm for reactor-based thread, implemented by Linux timerfd.
-// When it's constructed, it will register a reactable on the specified thread; when it's destroyed, it will unregister
-// itself from the thread.
+class AlarmMultiplexer;
+
+// A repeating alarm for reactor-based thread. All the alarms of a thread share the timerfd of its AlarmMultiplexer.
 class RepeatingAlarm {
  public:
-  // Create and register a repeating alarm on a given handler
+  // Create a repeating alarm on a given handler
   explicit RepeatingAlarm(Handler* handler);
 
   RepeatingAlarm(const RepeatingAlarm&) = delete;
   RepeatingAlarm& operator=(const RepeatingAlarm&) = delete;
 
-  // Unregister this alarm from the thread and release resource
+  // Cancel this alarm
   ~RepeatingAlarm();
 
   // Schedule a repeating alarm with given period
@@ -49,12 +50,9 @@ class RepeatingAlarm {
   void Cancel();
 
  private:
-  common::Closure task_;
   Handler* handler_;
-  int fd_ = 0;
-  Reactor::Reactable* token_;
-  mutable std::mutex mutex_;
-  void on_fire();
+  AlarmMultiplexer* multiplexer_;
+  uint64_t id_;
 };
 
 }  // namespace os
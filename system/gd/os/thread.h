@@ -16,16 +16,20 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "common/task_profiler.h"
 #include "os/reactor.h"
 #include "os/utils.h"
 
 namespace bluetooth {
 namespace os {
 
+class AlarmMultiplexer;
+
 // Reactor-based looper thread implementation. The thread runs immediately after it is constructed, and stops after
 // Stop() is invoked. To assign task to this thread, user needs to register a reactable object to the underlying
 // reactor.
@@ -64,11 +68,21 @@ class Thread {
   // Return the pointer of underlying reactor. The ownership is NOT transferred.
   Reactor* GetReactor() const;
 
+  // Return the multiplexer driving all the alarms of this thread, created on first use. The ownership is NOT
+  // transferred.
+  AlarmMultiplexer* GetAlarmMultiplexer() const;
+
+  // Return the profiler of the tasks posted to the handlers of this thread. The ownership is NOT transferred.
+  common::TaskProfiler* GetTaskProfiler() const;
+
  private:
   void run(Priority priority);
   mutable std::mutex mutex_;
   const std::string name_;
   mutable Reactor reactor_;
+  mutable std::once_flag alarm_multiplexer_once_;
+  mutable std::unique_ptr<AlarmMultiplexer> alarm_multiplexer_;
+  mutable common::TaskProfiler task_profiler_;
   std::thread running_thread_;
 };
 
@@ -17,8 +17,10 @@
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "benchmark/benchmark.h"
+#include "benchmark_allocation_count.h"
 #include "common/bind.h"
 #include "os/handler.h"
 #include "os/thread.h"
@@ -64,6 +66,7 @@ class BM_ReactorThread : public BM_ThreadPerformance {
     handler_ = std::make_unique<Handler>(thread_.get());
   }
   void TearDown(State& st) override {
+    handler_->Clear();
     handler_ = nullptr;
     thread_->Stop();
     thread_ = nullptr;
@@ -115,3 +118,82 @@ BENCHMARK_REGISTER_F(BM_ReactorThread, sequential_execution)
     ->Arg(100000)
     ->Iterations(1)
     ->UseRealTime();
+
+// Measures the cost of Post() when several threads post to the same handler at once, which is
+// where the handler queue used to contend on a mutex and every post paid for an eventfd write.
+BENCHMARK_DEFINE_F(BM_ReactorThread, concurrent_post)(State& state) {
+  const int num_producers = state.range(0);
+  const int64_t messages_per_producer = state.range(1) / num_producers;
+  for (auto _ : state) {
+    num_messages_to_send_ = messages_per_producer * num_producers;
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < num_producers; producer++) {
+      producers.emplace_back([this, messages_per_producer]() {
+        for (int64_t i = 0; i < messages_per_producer; i++) {
+          handler_->Post(BindOnce(
+              &BM_ReactorThread_concurrent_post_Benchmark::callback_batch,
+              bluetooth::common::Unretained(this)));
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    counter_future.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * messages_per_producer * num_producers);
+};
+
+BENCHMARK_REGISTER_F(BM_ReactorThread, concurrent_post)
+    ->Args({1, 100000})
+    ->Args({2, 100000})
+    ->Args({4, 100000})
+    ->Args({8, 100000})
+    ->Iterations(1)
+    ->UseRealTime();
+
+// Compares the allocations made by each post of a task bound with common::BindOnce(), which allocates a BindState, to
+// those made by each post of a lambda that common::InlineOnceClosure keeps inline.
+BENCHMARK_DEFINE_F(BM_ReactorThread, post_bind_once_allocations)(State& state) {
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    num_messages_to_send_ = state.range(0);
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    int64_t allocations_before = bluetooth::GetBenchmarkAllocationCount();
+    for (int i = 0; i < num_messages_to_send_; i++) {
+      handler_->Post(BindOnce(
+          &BM_ReactorThread_post_bind_once_allocations_Benchmark::callback_batch, bluetooth::common::Unretained(this)));
+    }
+    counter_future.wait();
+    allocations += bluetooth::GetBenchmarkAllocationCount() - allocations_before;
+  }
+  state.counters["allocs_per_post"] =
+      static_cast<double>(allocations) / static_cast<double>(state.iterations() * num_messages_to_send_);
+};
+
+BENCHMARK_REGISTER_F(BM_ReactorThread, post_bind_once_allocations)->Arg(100000)->Iterations(1)->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_ReactorThread, post_inline_allocations)(State& state) {
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    num_messages_to_send_ = state.range(0);
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    int64_t allocations_before = bluetooth::GetBenchmarkAllocationCount();
+    for (int i = 0; i < num_messages_to_send_; i++) {
+      handler_->PostInline([this] { callback_batch(); });
+    }
+    counter_future.wait();
+    allocations += bluetooth::GetBenchmarkAllocationCount() - allocations_before;
+  }
+  state.counters["allocs_per_post"] =
+      static_cast<double>(allocations) / static_cast<double>(state.iterations() * num_messages_to_send_);
+};
+
+BENCHMARK_REGISTER_F(BM_ReactorThread, post_inline_allocations)->Arg(100000)->Iterations(1)->UseRealTime();
@@ -35,6 +35,10 @@ class BitInserter : public ByteInserter {
 
   void insert_byte(uint8_t byte) override;
 
+  // Insert |length| whole bytes. When the inserter is byte-aligned they are
+  // appended in one step instead of going through insert_bits() one by one.
+  void insert_bytes(const uint8_t* bytes, size_t length) override;
+
  protected:
   size_t num_saved_bits_{0};
   uint8_t saved_bits_{0};
@@ -78,5 +78,24 @@ TEST(BitInserterTest, observerTest) {
   ASSERT_EQ(result.size(), copy.size());
 }
 
+TEST(BitInserterTest, insertBytes) {
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  std::vector<uint8_t> copy;
+  it.RegisterObserver(ByteObserver([&copy](uint8_t byte) { copy.push_back(byte); }, []() { return 0; }));
+
+  const uint8_t aligned[] = {0x01, 0x02, 0x03};
+  it.insert_bytes(aligned, sizeof(aligned));
+  it.insert_bits(0x0a, 4);
+  const uint8_t unaligned[] = {0xcb, 0xed};
+  it.insert_bytes(unaligned, sizeof(unaligned));
+  it.insert_bits(0x0f, 4);
+  it.UnregisterObserver();
+
+  std::vector<uint8_t> result = {0x01, 0x02, 0x03, 0xba, 0xdc, 0xfe};
+  ASSERT_EQ(result, bytes);
+  ASSERT_EQ(result, copy);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
@@ -33,6 +33,9 @@ class ByteInserter : public std::back_insert_iterator<std::vector<uint8_t>> {
 
   virtual void insert_byte(uint8_t byte);
 
+  // Append |length| bytes at once.
+  virtual void insert_bytes(const uint8_t* bytes, size_t length);
+
   void RegisterObserver(const ByteObserver& observer);
 
   ByteObserver UnregisterObserver();
@@ -42,6 +42,10 @@ class EndianInserter {
   template <typename T, typename std::enable_if<std::is_trivial<T>::value, int>::type = 0>
   void insert(T value, BitInserter& it) const {
     uint8_t* raw_bytes = (uint8_t*)&value;
+    if (little_endian == true) {
+      it.insert_bytes(raw_bytes, sizeof(T));
+      return;
+    }
     for (size_t i = 0; i < sizeof(T); i++) {
       if (little_endian == true) {
         it.insert_byte(raw_bytes[i]);
@@ -57,6 +61,10 @@ class EndianInserter {
       typename std::enable_if<std::is_base_of<CustomFieldFixedSizeInterface<T>, T>::value, int>::type = 0>
   void insert(const T& value, BitInserter& it) const {
     auto* raw_bytes = value.data();
+    if (little_endian == true) {
+      it.insert_bytes(raw_bytes, CustomFieldFixedSizeInterface<T>::length());
+      return;
+    }
     for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
       if (little_endian == true) {
         it.insert_byte(raw_bytes[i]);
@@ -71,6 +79,17 @@ class EndianInserter {
   void insert(T value, BitInserter& it, size_t num_bits) const {
     assert(num_bits <= (sizeof(T) * 8));
 
+    if (little_endian == true) {
+      uint8_t raw_bytes[sizeof(T)];
+      for (size_t i = 0; i < num_bits / 8; i++) {
+        raw_bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
+      }
+      it.insert_bytes(raw_bytes, num_bits / 8);
+      if (num_bits % 8) {
+        it.insert_bits(static_cast<uint8_t>(static_cast<uint64_t>(value) >> ((num_bits / 8) * 8)), num_bits % 8);
+      }
+      return;
+    }
     for (size_t i = 0; i < num_bits / 8; i++) {
       if (little_endian == true) {
         it.insert_byte(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8)));
@@ -97,6 +116,10 @@ class EndianInserter {
     static_assert(
         std::is_trivial<T>::value,
         "EndianInserter::insert requires a vector with elements of a fixed-size.");
+    if (little_endian == true || sizeof(T) == 1) {
+      it.insert_bytes(reinterpret_cast<const uint8_t*>(vec.data()), vec.size() * sizeof(T));
+      return;
+    }
     for (const auto& element : vec) {
       insert(element, it);
     }
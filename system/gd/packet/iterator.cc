@@ -18,13 +18,20 @@
 
 #undef NDEBUG
 #include <cassert>
+#include <cstdlib>
+#include <iterator>
 
 namespace bluetooth {
 namespace packet {
 
 template <bool little_endian>
 Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t offset) {
-  data_ = data;
+  if (!data.empty() && std::next(data.begin()) == data.end()) {
+    single_.emplace(data.front());
+    contiguous_ = single_->data();
+  } else {
+    data_ = data;
+  }
   index_ = offset;
   begin_ = 0;
   end_ = 0;
@@ -35,10 +42,11 @@ Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t of
 
 template <bool little_endian>
 Iterator<little_endian>::Iterator(std::shared_ptr<std::vector<uint8_t>> data) {
-  data_.emplace_front(data, 0, data->size());
+  single_.emplace(data, 0, data->size());
+  contiguous_ = single_->data();
   index_ = 0;
   begin_ = 0;
-  end_ = data_.front().size();
+  end_ = single_->size();
 }
 
 template <bool little_endian>
@@ -92,6 +100,8 @@ Iterator<little_endian>& Iterator<little_endian>::operator=(const Iterator<littl
   if (this == &itr) {
     return *this;
   }
+  this->single_ = itr.single_;
+  this->contiguous_ = itr.contiguous_;
   this->data_ = itr.data_;
   this->begin_ = itr.begin_;
   this->end_ = itr.end_;
@@ -132,9 +142,12 @@ bool Iterator<little_endian>::operator>=(const Iterator<little_endian>& itr) con
 template <bool little_endian>
 uint8_t Iterator<little_endian>::operator*() const {
   assert(NumBytesRemaining() > 0);
+  if (contiguous_ != nullptr) {
+    return contiguous_[index_];
+  }
   size_t index = index_;
 
-  for (auto view : data_) {
+  for (const auto& view : data_) {
     if (index < view.size()) {
       return view[index];
     }
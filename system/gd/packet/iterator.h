@@ -17,8 +17,10 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <forward_list>
 #include <memory>
+#include <optional>
 #include <type_traits>
 
 #include "packet/custom_field_fixed_size_interface.h"
@@ -84,6 +86,9 @@ class Iterator : public IteratorTraits {
     T extracted_value{};
     uint8_t* value_ptr = (uint8_t*)&extracted_value;
 
+    if (ExtractContiguous(value_ptr, sizeof(T))) {
+      return extracted_value;
+    }
     for (size_t i = 0; i < sizeof(T); i++) {
       size_t index = (little_endian ? i : sizeof(T) - i - 1);
       value_ptr[index] = this->operator*();
@@ -95,6 +100,9 @@ class Iterator : public IteratorTraits {
   template <typename T, typename std::enable_if<std::is_base_of_v<CustomFieldFixedSizeInterface<T>, T>, int>::type = 0>
   T extract() {
     T extracted_value{};
+    if (ExtractContiguous(extracted_value.data(), CustomFieldFixedSizeInterface<T>::length())) {
+      return extracted_value;
+    }
     for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
       size_t index = (little_endian ? i : CustomFieldFixedSizeInterface<T>::length() - i - 1);
       extracted_value.data()[index] = this->operator*();
@@ -104,6 +112,27 @@ class Iterator : public IteratorTraits {
   }
 
  private:
+  // Copy |length| bytes into |value| in one step when the data is contiguous and holds them all.
+  // Return false to have the caller go byte by byte.
+  bool ExtractContiguous(uint8_t* value, size_t length) {
+    if (contiguous_ == nullptr || NumBytesRemaining() < length) {
+      return false;
+    }
+    if (little_endian) {
+      std::memcpy(value, contiguous_ + index_, length);
+    } else {
+      for (size_t i = 0; i < length; i++) {
+        value[length - i - 1] = contiguous_[index_ + i];
+      }
+    }
+    index_ += length;
+    return true;
+  }
+
+  // Nearly all packets are a single fragment. Those are held as one view, with |contiguous_|
+  // pointing at its bytes, and |data_| is only filled for packets made of several fragments.
+  std::optional<View> single_;
+  const uint8_t* contiguous_{nullptr};
   std::forward_list<View> data_;
   size_t index_;
   size_t begin_;
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <forward_list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace packet {
+
+static constexpr size_t kPacketLength = 256;
+
+static std::shared_ptr<const std::vector<uint8_t>> MakeBuffer() {
+  auto buffer = std::make_shared<std::vector<uint8_t>>(kPacketLength);
+  for (size_t i = 0; i < kPacketLength; i++) {
+    (*buffer)[i] = static_cast<uint8_t>(i * 31);
+  }
+  return buffer;
+}
+
+// Read the packet as a sequence of 16 and 32 bit fields, as generated views do.
+static void ExtractFields(State& state, const PacketView<kLittleEndian>& packet) {
+  for (auto _ : state) {
+    auto it = packet.begin();
+    uint32_t sum = 0;
+    while (it.NumBytesRemaining() >= sizeof(uint16_t) + sizeof(uint32_t)) {
+      sum += it.extract<uint16_t>();
+      sum += it.extract<uint32_t>();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packet.size()));
+}
+
+static void BM_ExtractContiguous(State& state) {
+  ExtractFields(state, PacketView<kLittleEndian>(MakeBuffer()));
+}
+BENCHMARK(BM_ExtractContiguous);
+
+static void BM_ExtractFragmented(State& state) {
+  auto buffer = MakeBuffer();
+  std::forward_list<View> fragments;
+  for (size_t begin = kPacketLength; begin > 0; begin -= kPacketLength / 4) {
+    fragments.emplace_front(buffer, begin - kPacketLength / 4, begin);
+  }
+  ExtractFields(state, PacketView<kLittleEndian>(fragments));
+}
+BENCHMARK(BM_ExtractFragmented);
+
+}  // namespace packet
+}  // namespace bluetooth
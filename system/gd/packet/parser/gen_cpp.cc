@@ -22,6 +22,7 @@
 #include <iostream>
 #include <queue>
 #include <regex>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -54,6 +55,7 @@ bool generate_cpp_headers_one_file(
     const Declarations& decls,
     bool generate_fuzzing,
     bool generate_tests,
+    const std::set<std::string>& validate_once,
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
@@ -221,7 +223,7 @@ using ::bluetooth::packet::RawBuilder;
   }
 
   for (const auto& packet_def : decls.packet_defs_queue_) {
-    packet_def.second->GenParserDefinition(out_file, generate_fuzzing, generate_tests);
+    packet_def.second->GenParserDefinition(out_file, generate_fuzzing, generate_tests, validate_once);
     out_file << "\n\n";
   }
 
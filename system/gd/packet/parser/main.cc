@@ -25,6 +25,7 @@
 #include <iostream>
 #include <queue>
 #include <regex>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -41,6 +42,7 @@ bool generate_cpp_headers_one_file(
     const Declarations& decls,
     bool generate_fuzzing,
     bool generate_tests,
+    const std::set<std::string>& validate_once,
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
@@ -107,6 +109,9 @@ void usage(const char* prog) {
 
   ofs << std::setw(24) << "--source_root= ";
   ofs << "Root path to the source directory. Find input files relative to this." << std::endl;
+
+  ofs << std::setw(24) << "--validate_once= ";
+  ofs << "Comma separated root packets whose views don't validate their ancestors twice." << std::endl;
 }
 
 int main(int argc, const char** argv) {
@@ -117,6 +122,7 @@ int main(int argc, const char** argv) {
   std::string root_namespace = "bluetooth";
   bool generate_fuzzing = false;
   bool generate_tests = false;
+  std::set<std::string> validate_once;
   std::queue<std::filesystem::path> input_files;
 
   const std::string arg_out = "--out=";
@@ -125,6 +131,7 @@ int main(int argc, const char** argv) {
   const std::string arg_fuzzing = "--fuzzing";
   const std::string arg_testing = "--testing";
   const std::string arg_source_root = "--source_root=";
+  const std::string arg_validate_once = "--validate_once=";
 
   // Parse the source root first (if it exists) since it will be used for other
   // paths.
@@ -149,6 +156,12 @@ int main(int argc, const char** argv) {
       generate_tests = true;
     } else if (arg.find(arg_source_root) == 0) {
       // Do nothing (just don't treat it as input_files)
+    } else if (arg.find(arg_validate_once) == 0) {
+      std::stringstream packets(arg.substr(arg_validate_once.size()));
+      std::string packet;
+      while (std::getline(packets, packet, ',')) {
+        validate_once.insert(packet);
+      }
     } else {
       input_files.emplace(source_root / std::filesystem::path(arg));
     }
@@ -172,6 +185,7 @@ int main(int argc, const char** argv) {
             declarations,
             generate_fuzzing,
             generate_tests,
+            validate_once,
             input_files.front(),
             include_dir,
             out_dir,
@@ -31,7 +31,16 @@ PacketField* PacketDef::GetNewField(const std::string&, ParseLocation) const {
   return nullptr;  // Packets can't be fields
 }
 
-void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const {
+size_t PacketDef::GetDepth() const {
+  return GetAncestors().size() + 1;
+}
+
+void PacketDef::GenParserDefinition(
+    std::ostream& s, bool generate_fuzzing, bool generate_tests, const std::set<std::string>& validate_once) const {
+  auto ancestors = GetAncestors();
+  const std::string& root_name = ancestors.empty() ? name_ : ancestors.front()->name_;
+  bool is_validate_once = validate_once.count(root_name) != 0;
+
   s << "class " << name_ << "View";
   if (parent_ != nullptr) {
     s << " : public " << parent_->name_ << "View {";
@@ -78,7 +87,7 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
     GenParserFieldGetter(s, field);
     s << "\n";
   }
-  GenValidator(s);
+  GenValidator(s, is_validate_once);
   s << "\n";
 
   s << " public:";
@@ -89,7 +98,12 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
   // Constructor from a View
   if (parent_ != nullptr) {
     s << "explicit " << name_ << "View(" << parent_->name_ << "View parent)";
-    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false; }";
+    s << " : " << parent_->name_ << "View(std::move(parent)) {";
+    if (is_validate_once) {
+      // Everything up to the parent is known to be valid once the parent was validated.
+      s << "if (was_validated_) { validated_depth_ = " << GetDepth() - 1 << "; }";
+    }
+    s << "was_validated_ = false; }";
   } else {
     s << "explicit " << name_ << "View(PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian> packet) ";
     s << " : PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian>(packet) { was_validated_ = false;}";
@@ -183,7 +197,7 @@ TypeDef::Type PacketDef::GetDefinitionType() const {
   return TypeDef::Type::PACKET;
 }
 
-void PacketDef::GenValidator(std::ostream& s) const {
+void PacketDef::GenValidator(std::ostream& s, bool validate_once) const {
   // Get the static offset for all of our fields.
   int bits_size = 0;
   for (const auto& field : fields_) {
@@ -212,7 +226,12 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "virtual bool Validate() const {" << std::endl;
   } else {
     s << "bool Validate() const override {" << std::endl;
-    s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
+    if (validate_once) {
+      s << "  if (validated_depth_ < " << GetDepth() - 1 << " && !" << parent_->name_ << "View::Validate()) {"
+        << std::endl;
+    } else {
+      s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
+    }
     s << "    return false;" << std::endl;
     s << "  }" << std::endl;
   }
@@ -343,6 +362,10 @@ void PacketDef::GenValidator(std::ostream& s) const {
   s << "}\n";
   if (parent_ == nullptr) {
     s << "bool was_validated_{false};\n";
+    if (validate_once) {
+      s << "// Number of packet levels, from this one down, that were validated by a parent view.\n";
+      s << "size_t validated_depth_{0};\n";
+    }
   }
 }
 
@@ -471,8 +494,7 @@ void PacketDef::GenBuilderDefinitionPybind11(std::ostream& s) const {
   }
   s << ".def(\"Serialize\", [](" << name_ << "Builder& builder){";
   s << "std::vector<uint8_t> bytes;";
-  s << "BitInserter bi(bytes);";
-  s << "builder.Serialize(bi);";
+  s << "builder.SerializeTo(bytes);";
   s << "return bytes;})";
   s << ";\n";
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <variant>
 
 #include "enum_def.h"
@@ -31,7 +32,10 @@ class PacketDef : public ParentDef {
 
   PacketField* GetNewField(const std::string& name, ParseLocation loc) const;
 
-  void GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const;
+  // Views of the packet families rooted in |validate_once| remember which of their ancestor levels
+  // were validated, so that IsValid() on a child view only validates the child's own fields.
+  void GenParserDefinition(
+      std::ostream& s, bool generate_fuzzing, bool generate_tests, const std::set<std::string>& validate_once) const;
 
   void GenTestingParserFromBytes(std::ostream& s) const;
 
@@ -39,7 +43,10 @@ class PacketDef : public ParentDef {
 
   void GenParserFieldGetter(std::ostream& s, const PacketField* field) const;
 
-  void GenValidator(std::ostream& s) const;
+  void GenValidator(std::ostream& s, bool validate_once) const;
+
+  // Return the number of packets from the root of the family to this one, which is 1 for the root.
+  size_t GetDepth() const;
 
   void GenParserToString(std::ostream& s) const;
 
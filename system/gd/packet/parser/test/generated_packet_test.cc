@@ -1995,6 +1995,27 @@ TEST(GeneratedPacketTest, testCreateOptional) {
   ASSERT_TRUE(grandchild_view.has_value());
 }
 
+TEST(GeneratedPacketTest, testValidateOnceChildConstraints) {
+  auto packet = ChildTwoTwoThreeBuilder::Create();
+
+  std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*packet_bytes);
+  packet->Serialize(it);
+
+  PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
+  ParentTwoView parent_view = ParentTwoView::Create(packet_bytes_view);
+  ASSERT_TRUE(parent_view.IsValid());
+
+  // The parent being valid doesn't make the constraints of the child hold.
+  ChildTwoThreeView wrong_child_view = ChildTwoThreeView::Create(parent_view);
+  ASSERT_FALSE(wrong_child_view.IsValid());
+
+  // A grandchild of a validated parent validates without its own parent being validated first.
+  ChildTwoTwoThreeView grandchild_view = ChildTwoTwoThreeView::Create(ChildTwoTwoView::Create(parent_view));
+  ASSERT_TRUE(grandchild_view.IsValid());
+  ASSERT_EQ(FourBits::THREE, grandchild_view.GetMoreBits());
+}
+
 TEST(GeneratedPacketTest, testStructWithShadowedNames) {
   uint32_t four_bytes = 0x01020304;
   StructType struct_type = StructType::TWO_BYTE;
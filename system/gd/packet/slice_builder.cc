@@ -0,0 +1,42 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/slice_builder.h"
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace packet {
+
+SliceBuilder::SliceBuilder(std::shared_ptr<const std::vector<uint8_t>> buffer, size_t begin, size_t end)
+    : buffer_(std::move(buffer)),
+      begin_(std::min(begin, buffer_->size())),
+      end_(std::clamp(end, begin_, buffer_->size())) {}
+
+size_t SliceBuilder::size() const {
+  return end_ - begin_;
+}
+
+void SliceBuilder::Serialize(BitInserter& it) const {
+  it.insert_bytes(data(), size());
+}
+
+const uint8_t* SliceBuilder::data() const {
+  return buffer_->data() + begin_;
+}
+
+}  // namespace packet
+}  // namespace bluetooth
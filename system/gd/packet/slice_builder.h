@@ -0,0 +1,50 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/packet_builder.h"
+
+namespace bluetooth {
+namespace packet {
+
+// Builder for a range of bytes of a shared, already serialized buffer. Several slices can refer to
+// the same buffer, e.g. the fragments of a large packet, without copying it.
+class SliceBuilder : public PacketBuilder<true> {
+ public:
+  SliceBuilder(std::shared_ptr<const std::vector<uint8_t>> buffer, size_t begin, size_t end);
+  virtual ~SliceBuilder() = default;
+
+  virtual size_t size() const override;
+
+  virtual void Serialize(BitInserter& it) const override;
+
+  // Return the start of the slice in the shared buffer.
+  const uint8_t* data() const;
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> buffer_;
+  size_t begin_;
+  size_t end_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
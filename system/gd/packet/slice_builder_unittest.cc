@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/slice_builder.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace bluetooth {
+namespace packet {
+namespace {
+
+const std::vector<uint8_t> kCount = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+
+TEST(SliceBuilderTest, serializeSlice) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(kCount);
+  SliceBuilder slice(buffer, 2, 6);
+  ASSERT_EQ(4u, slice.size());
+  ASSERT_EQ(buffer->data() + 2, slice.data());
+
+  std::vector<uint8_t> packet;
+  BitInserter it(packet);
+  slice.Serialize(it);
+  ASSERT_EQ(std::vector<uint8_t>(kCount.begin() + 2, kCount.begin() + 6), packet);
+}
+
+TEST(SliceBuilderTest, slicesShareBuffer) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(kCount);
+  auto first = std::make_unique<SliceBuilder>(buffer, 0, 5);
+  auto second = std::make_unique<SliceBuilder>(buffer, 5, 10);
+  buffer.reset();
+
+  std::vector<uint8_t> packet;
+  BitInserter it(packet);
+  first->Serialize(it);
+  second->Serialize(it);
+  ASSERT_EQ(kCount, packet);
+}
+
+TEST(SliceBuilderTest, boundsAreClamped) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(kCount);
+  ASSERT_EQ(2u, SliceBuilder(buffer, 8, 20).size());
+  ASSERT_EQ(0u, SliceBuilder(buffer, 12, 20).size());
+  ASSERT_EQ(0u, SliceBuilder(buffer, 6, 4).size());
+}
+
+}  // namespace
+}  // namespace packet
+}  // namespace bluetooth
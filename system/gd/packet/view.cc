@@ -41,5 +41,9 @@ uint8_t View::operator[](size_t i) const {
 size_t View::size() const {
   return end_ - begin_;
 }
+
+const uint8_t* View::data() const {
+  return data_->data() + begin_;
+}
 }  // namespace packet
 }  // namespace bluetooth
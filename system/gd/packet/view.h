@@ -35,6 +35,9 @@ class View {
 
   size_t size() const;
 
+  // Return the first byte of the view, which is followed by size() - 1 more.
+  const uint8_t* data() const;
+
  private:
   std::shared_ptr<const std::vector<uint8_t>> data_;
   size_t begin_;
@@ -1060,6 +1060,7 @@ pub enum BaseCallbacks {
     GenerateLocalOobData(u8, OobData),
     LeRandCallback(u64),
     // key_missing_cb
+    // remote_device_properties_batch_cb
 }
 
 pub struct BaseCallbacksDispatcher {
@@ -1250,6 +1251,7 @@ impl BluetoothInterface {
             switch_codec_cb: None,
             le_rand_cb: Some(le_rand_cb),
             key_missing_cb: None,
+            remote_device_properties_batch_cb: None,
         });
 
         let cb_ptr = LTCheckedPtrMut::from(&mut callbacks);
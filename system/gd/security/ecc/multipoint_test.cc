@@ -18,6 +18,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <random>
+
 #include "security/ecc/p_256_ecc_pp.h"
 
 namespace bluetooth {
@@ -107,6 +110,33 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+// The fixed-base comb must compute the same public keys as the generic point multiplication
+TEST(SmpEccPointMultTest, test_base_matches_generic) {
+  std::mt19937 rng(0x5eed);
+  for (int i = 0; i < 64; i++) {
+    uint32_t n[KEY_LENGTH_DWORDS_P256];
+    for (auto& word : n) word = rng();
+    if (i == 0) {
+      multiprecision_init(n);
+      n[0] = 1;
+    } else if (i == 1) {
+      multiprecision_init(n);
+      n[7] = 0x80000000;
+    }
+    uint32_t n_copy[KEY_LENGTH_DWORDS_P256];
+    multiprecision_copy(n_copy, n);
+
+    Point base;
+    Point generic;
+    ECC_PointMult_Base(&base, n);
+    ECC_PointMult(&generic, &curve_p256.G, n_copy);
+
+    EXPECT_EQ(memcmp(base.x, generic.x, sizeof(base.x)), 0) << "scalar " << i;
+    EXPECT_EQ(memcmp(base.y, generic.y, sizeof(base.y)), 0) << "scalar " << i;
+    EXPECT_TRUE(ECC_ValidatePoint(base)) << "scalar " << i;
+  }
+}
+
 }  // namespace ecc
 }  // namespace security
 }  // namespace bluetooth
@@ -189,29 +189,18 @@ uint32_t multiprecision_lshift(uint32_t* c, const uint32_t* a) {
 
 // c=a*b; c must have a buffer of 2*Key_LENGTH_uint32_tS, c != a != b
 void multiprecision_mult(uint32_t* c, const uint32_t* a, const uint32_t* b) {
-  uint32_t W;
-  uint32_t U;
-  uint32_t V;
-
-  U = V = W = 0;
   multiprecision_init(c);
 
   // assume little endian right now
   for (uint32_t i = 0; i < KEY_LENGTH_DWORDS_P256; i++) {
-    U = 0;
+    // a[i] * b[j] + c[i + j] + carry is at most 2^64 - 1, so one 64 bit accumulator holds the word and its carry
+    uint64_t carry = 0;
     for (uint32_t j = 0; j < KEY_LENGTH_DWORDS_P256; j++) {
-      uint64_t result;
-      result = ((uint64_t)a[i]) * ((uint64_t)b[j]);
-      W = result >> 32;
-      V = a[i] * b[j];
-      V = V + U;
-      U = (V < U);
-      U += W;
-      V = V + c[i + j];
-      U += (V < c[i + j]);
-      c[i + j] = V;
+      uint64_t result = (uint64_t)a[i] * b[j] + c[i + j] + carry;
+      c[i + j] = (uint32_t)result;
+      carry = result >> 32;
     }
-    c[i + KEY_LENGTH_DWORDS_P256] = U;
+    c[i + KEY_LENGTH_DWORDS_P256] = (uint32_t)carry;
   }
 }
 
@@ -27,6 +27,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <array>
+
 #include "security/ecc/multprecision.h"
 
 namespace bluetooth {
@@ -43,6 +45,17 @@ static void p_256_copy_point(Point* q, const Point* p) {
   memcpy(q, p, sizeof(Point));
 }
 
+// Convert q from Jacobian to affine coordinates: x = x / z^2, y = y / z^3. q->z is left undefined
+static void p_256_to_affine(Point* q) {
+  uint32_t z_inv[KEY_LENGTH_DWORDS_P256];
+
+  multiprecision_inv_mod(z_inv, q->z, modp);
+  multiprecision_mersenns_squa_mod(q->z, z_inv, modp);
+  multiprecision_mersenns_mult_mod(q->x, q->x, q->z, modp);
+  multiprecision_mersenns_mult_mod(q->z, q->z, z_inv, modp);
+  multiprecision_mersenns_mult_mod(q->y, q->y, q->z, modp);
+}
+
 // q=2q
 static void ECC_Double(Point* q, const Point* p) {
   uint32_t t1[KEY_LENGTH_DWORDS_P256];
@@ -234,11 +247,133 @@ void ECC_PointMult_Bin_NAF(Point* q, const Point* p, uint32_t* n) {
     }
   }
 
-  multiprecision_inv_mod(minus_p.x, q->z, modp);
-  multiprecision_mersenns_squa_mod(q->z, minus_p.x, modp);
-  multiprecision_mersenns_mult_mod(q->x, q->x, q->z, modp);
-  multiprecision_mersenns_mult_mod(q->z, q->z, minus_p.x, modp);
-  multiprecision_mersenns_mult_mod(q->y, q->y, q->z, modp);
+  p_256_to_affine(q);
+}
+
+// Fixed-base comb for the generator. The scalar is read as kCombTeeth words of kCombSpacing bits, and entry j - 1 of
+// the table holds the sum of 2^(kCombSpacing * t) * G over the bits t set in j. Bit i of every word of the scalar
+// then selects the entry added before the i-th doubling, so n * G costs kCombSpacing doublings and additions instead
+// of 256 doublings and about 85 additions for the NAF.
+static constexpr uint32_t kCombTeeth = 8;
+static constexpr uint32_t kCombSpacing = 256 / kCombTeeth;
+static constexpr uint32_t kCombTableSize = (1 << kCombTeeth) - 1;
+static_assert(kCombSpacing == 32, "the teeth of the comb are the bits of the 32 bit words of the scalar");
+
+struct AffinePoint {
+  uint32_t x[KEY_LENGTH_DWORDS_P256];
+  uint32_t y[KEY_LENGTH_DWORDS_P256];
+};
+
+using CombTable = std::array<AffinePoint, kCombTableSize>;
+
+// Convert points[0..count) to affine coordinates with a single inversion: with z_0..z_i the product of the first i + 1
+// z coordinates, 1 / z_i = (1 / (z_0..z_i)) * (z_0..z_(i-1)). The z coordinates must not be zero, and count must be
+// at most kCombTableSize
+static void p_256_batch_to_affine(Point* points, size_t count) {
+  uint32_t prefix[kCombTableSize][KEY_LENGTH_DWORDS_P256];
+  uint32_t inv[KEY_LENGTH_DWORDS_P256];
+  uint32_t z_inv[KEY_LENGTH_DWORDS_P256];
+  uint32_t z_inv2[KEY_LENGTH_DWORDS_P256];
+
+  multiprecision_copy(prefix[0], points[0].z);
+  for (size_t i = 1; i < count; i++) {
+    multiprecision_mersenns_mult_mod(prefix[i], prefix[i - 1], points[i].z, modp);
+  }
+  multiprecision_inv_mod(inv, prefix[count - 1], modp);
+
+  for (size_t i = count; i-- > 0;) {
+    if (i > 0) {
+      multiprecision_mersenns_mult_mod(z_inv, inv, prefix[i - 1], modp);
+      multiprecision_mersenns_mult_mod(inv, inv, points[i].z, modp);
+    } else {
+      multiprecision_copy(z_inv, inv);
+    }
+    multiprecision_mersenns_squa_mod(z_inv2, z_inv, modp);
+    multiprecision_mersenns_mult_mod(points[i].x, points[i].x, z_inv2, modp);
+    multiprecision_mersenns_mult_mod(z_inv2, z_inv2, z_inv, modp);
+    multiprecision_mersenns_mult_mod(points[i].y, points[i].y, z_inv2, modp);
+    multiprecision_init(points[i].z);
+    points[i].z[0] = 1;
+  }
+}
+
+static CombTable p_256_build_base_comb_table() {
+  CombTable table;
+  Point r;
+  Point tooth[kCombTeeth];
+  Point entries[kCombTableSize];
+
+  // tooth[t] = 2^(kCombSpacing * t) * G, in affine coordinates as ECC_Add expects for its second operand
+  p_256_copy_point(&tooth[0], &curve_p256.G);
+  for (uint32_t t = 1; t < kCombTeeth; t++) {
+    p_256_copy_point(&tooth[t], &tooth[t - 1]);
+    for (uint32_t i = 0; i < kCombSpacing; i++) {
+      p_256_copy_point(&r, &tooth[t]);
+      ECC_Double(&tooth[t], &r);
+    }
+  }
+  p_256_batch_to_affine(&tooth[1], kCombTeeth - 1);
+
+  for (uint32_t j = 1; j <= kCombTableSize; j++) {
+    // j = rest + 2^t with t the lowest bit set in j, and the entry of rest is already computed
+    uint32_t t = __builtin_ctz(j);
+    uint32_t rest = j & (j - 1);
+    if (rest == 0) {
+      p_256_copy_point(&entries[j - 1], &tooth[t]);
+    } else {
+      p_256_copy_point(&r, &entries[rest - 1]);
+      ECC_Add(&entries[j - 1], &r, &tooth[t]);
+    }
+  }
+  p_256_batch_to_affine(entries, kCombTableSize);
+
+  for (uint32_t j = 0; j < kCombTableSize; j++) {
+    multiprecision_copy(table[j].x, entries[j].x);
+    multiprecision_copy(table[j].y, entries[j].y);
+  }
+  return table;
+}
+
+// q = table entry |index|, 1 <= index <= kCombTableSize. Every entry is read so that the memory access pattern does
+// not depend on the private key
+static void p_256_select_base_point(Point* q, const CombTable& table, uint32_t index) {
+  multiprecision_init(q->x);
+  multiprecision_init(q->y);
+  for (uint32_t j = 0; j < kCombTableSize; j++) {
+    uint32_t diff = (j + 1) ^ index;
+    uint32_t mask = ((diff | (0 - diff)) >> 31) - 1;  // all ones if j + 1 == index, 0 otherwise
+    for (uint32_t k = 0; k < KEY_LENGTH_DWORDS_P256; k++) {
+      q->x[k] |= table[j].x[k] & mask;
+      q->y[k] |= table[j].y[k] & mask;
+    }
+  }
+  multiprecision_init(q->z);
+  q->z[0] = 1;
+}
+
+void ECC_PointMult_Base(Point* q, const uint32_t* n) {
+  static const CombTable table = p_256_build_base_comb_table();
+  Point r;
+  Point selected;
+
+  p_256_init_point(q);
+
+  for (int i = kCombSpacing - 1; i >= 0; i--) {
+    p_256_copy_point(&r, q);
+    ECC_Double(q, &r);
+
+    uint32_t index = 0;
+    for (uint32_t t = 0; t < kCombTeeth; t++) {
+      index |= ((n[t] >> i) & 0x01) << t;
+    }
+    if (index != 0) {
+      p_256_select_base_point(&selected, table, index);
+      p_256_copy_point(&r, q);
+      ECC_Add(q, &r, &selected);
+    }
+  }
+
+  p_256_to_affine(q);
 }
 
 bool ECC_ValidatePoint(const Point& pt) {
@@ -71,6 +71,10 @@ void ECC_PointMult_Bin_NAF(Point* q, const Point* p, uint32_t* n);
 
 #define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
 
+// q = n * G for the generator G of curve_p256, using a table of precomputed multiples of G. Much faster than
+// ECC_PointMult(q, &curve_p256.G, n) and does not modify n.
+void ECC_PointMult_Base(Point* q, const uint32_t* n);
+
 }  // namespace ecc
 }  // namespace security
 }  // namespace bluetooth
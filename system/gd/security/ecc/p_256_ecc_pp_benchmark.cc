@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "security/ecc/p_256_ecc_pp.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace security {
+namespace ecc {
+
+static const uint32_t kPrivateKey[KEY_LENGTH_DWORDS_P256] = {
+    0x3f49f6d4, 0xa3c55f38, 0x74c9b3e3, 0xd2103f50, 0x4aff607b, 0xeb40b799, 0x5899b8a6, 0xcd3c1abf};
+
+static void BM_MultprecisionMersennsMultMod(State& state) {
+  uint32_t c[KEY_LENGTH_DWORDS_P256];
+  multiprecision_copy(c, curve_p256.G.x);
+  for (auto _ : state) {
+    multiprecision_mersenns_mult_mod(c, c, curve_p256.G.y, curve_p256.p);
+    benchmark::DoNotOptimize(c);
+  }
+}
+BENCHMARK(BM_MultprecisionMersennsMultMod);
+
+// Local key generation, the first call also builds the table
+static void BM_PointMultBase(State& state) {
+  Point q;
+  for (auto _ : state) {
+    ECC_PointMult_Base(&q, kPrivateKey);
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK(BM_PointMultBase);
+
+// The same multiplication through the generic path, as used for the DHKey
+static void BM_PointMultGeneric(State& state) {
+  Point q;
+  uint32_t n[KEY_LENGTH_DWORDS_P256];
+  for (auto _ : state) {
+    multiprecision_copy(n, kPrivateKey);
+    ECC_PointMult(&q, &curve_p256.G, n);
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK(BM_PointMultGeneric);
+
+}  // namespace ecc
+}  // namespace security
+}  // namespace bluetooth
@@ -18,46 +18,36 @@
 
 #include "security/ecdh_keys.h"
 
-/**********************************************************************************************************************
- TODO: We should have random number management in separate file, and we
-       should honour all the random number requirements from the spec!!
-**********************************************************************************************************************/
+#include <bluetooth/log.h>
 #include <string.h>
 
-#include <cstdlib>
-#include <ctime>
+#include <future>
+#include <mutex>
 
+#include "os/rand.h"
 #include "security/ecc/p_256_ecc_pp.h"
 
 namespace {
 
-static bool srand_initiated = false;
+using KeyPair = std::pair<std::array<uint8_t, 32>, bluetooth::security::EcdhPublicKey>;
 
-template <size_t SIZE>
-static std::array<uint8_t, SIZE> GenerateRandom() {
-  if (!srand_initiated) {
-    srand_initiated = true;
-    // TODO:  We need a proper  random number generator here.
-    // use current time as seed for random generator
-    std::srand(std::time(nullptr));
-  }
+std::mutex next_key_pair_mutex;
+// Key pair for the next pairing, generated while the previous one goes on.
+std::future<KeyPair> next_key_pair;
 
-  std::array<uint8_t, SIZE> r;
-  for (size_t i = 0; i < SIZE; i++) r[i] = std::rand();
-  return r;
-}
 }  // namespace
-/*********************************************************************************************************************/
 
 namespace bluetooth {
 namespace security {
 
 std::pair<std::array<uint8_t, 32>, EcdhPublicKey> GenerateECDHKeyPair() {
-  std::array<uint8_t, 32> private_key = GenerateRandom<32>();
-  std::array<uint8_t, 32> private_key_copy = private_key;
+  // Pairings run on threads of their own, so this must not use std::rand()
+  std::array<uint8_t, 32> private_key = os::GenerateRandom<32>();
+  uint32_t private_key_words[8];
+  memcpy(private_key_words, private_key.data(), 32);
   ecc::Point public_key;
 
-  ECC_PointMult(&public_key, &(ecc::curve_p256.G), (uint32_t*)private_key_copy.data());
+  ecc::ECC_PointMult_Base(&public_key, private_key_words);
 
   EcdhPublicKey pk;
   memcpy(pk.x.data(), public_key.x, 32);
@@ -67,6 +57,23 @@ std::pair<std::array<uint8_t, 32>, EcdhPublicKey> GenerateECDHKeyPair() {
   return std::make_pair<std::array<uint8_t, 32>, EcdhPublicKey>(std::move(private_key), std::move(pk));
 }
 
+void PrepareECDHKeyPair() {
+  std::lock_guard<std::mutex> lock(next_key_pair_mutex);
+  if (!next_key_pair.valid()) {
+    next_key_pair = std::async(std::launch::async, GenerateECDHKeyPair);
+  }
+}
+
+std::pair<std::array<uint8_t, 32>, EcdhPublicKey> TakeECDHKeyPair() {
+  std::future<KeyPair> key_pair;
+  {
+    std::lock_guard<std::mutex> lock(next_key_pair_mutex);
+    key_pair = std::move(next_key_pair);
+    next_key_pair = std::async(std::launch::async, GenerateECDHKeyPair);
+  }
+  return key_pair.valid() ? key_pair.get() : GenerateECDHKeyPair();
+}
+
 bool ValidateECDHPoint(EcdhPublicKey pk) {
   ecc::Point public_key;
   memcpy(public_key.x, pk.x.data(), 32);
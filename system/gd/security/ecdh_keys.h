@@ -31,6 +31,15 @@ struct EcdhPublicKey {
 /* this generates private and public Eliptic Curve Diffie Helman keys */
 std::pair<std::array<uint8_t, 32>, EcdhPublicKey> GenerateECDHKeyPair();
 
+/* Starts generating, on a separate thread, the key pair returned by the next
+ * TakeECDHKeyPair(), unless one is already generated or being generated */
+void PrepareECDHKeyPair();
+
+/* Returns the key pair prepared ahead of time, waiting for it if it is still
+ * being generated or generating one if none was prepared, and starts preparing
+ * the next one. Each key pair is returned once. */
+std::pair<std::array<uint8_t, 32>, EcdhPublicKey> TakeECDHKeyPair();
+
 /* This function validates that the given public key (point) lays on the special
  * Bluetooth curve */
 bool ValidateECDHPoint(EcdhPublicKey pk);
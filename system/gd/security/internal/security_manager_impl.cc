@@ -25,6 +25,7 @@
 #include "hci/octets.h"
 #include "os/log.h"
 #include "os/rand.h"
+#include "security/ecdh_keys.h"
 #include "security/initial_informations.h"
 #include "security/internal/security_manager_impl.h"
 #include "security/pairing_handler_le.h"
@@ -83,6 +84,8 @@ void SecurityManagerImpl::Init() {
 
   log::assert_that(storage_module_ != nullptr, "Storage module must not be null!");
   security_database_.LoadRecordsFromStorage();
+  // Generate the key pair of the first LE Secure Connections pairing before it starts
+  PrepareECDHKeyPair();
 
   auto irk_prop =
       storage_module_->GetBin(BTIF_STORAGE_SECTION_ADAPTER, BTIF_STORAGE_KEY_LE_LOCAL_KEY_IRK);
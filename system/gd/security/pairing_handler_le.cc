@@ -20,6 +20,9 @@
 
 #include <bluetooth/log.h>
 
+#include <chrono>
+
+#include "common/metrics_registry.h"
 #include "hci/octets.h"
 #include "os/rand.h"
 
@@ -28,9 +31,20 @@ namespace security {
 
 using hci::Octet16;
 
+namespace {
+
+// Adds the time since |phase_start| to |histogram|, and restarts |phase_start| for the next phase.
+void RecordPhaseLatency(common::MetricsHistogram& histogram, std::chrono::steady_clock::time_point& phase_start) {
+  auto now = std::chrono::steady_clock::now();
+  histogram.Add(std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start).count());
+  phase_start = now;
+}
+
+}  // namespace
+
 MyOobData PairingHandlerLe::GenerateOobData() {
   MyOobData data{};
-  std::tie(data.private_key, data.public_key) = GenerateECDHKeyPair();
+  std::tie(data.private_key, data.public_key) = TakeECDHKeyPair();
 
   data.r = bluetooth::os::GenerateRandom<16>();
   data.c = crypto_toolbox::f4(data.public_key.x.data(), data.public_key.x.data(), data.r, 0);
@@ -40,6 +54,14 @@ MyOobData PairingHandlerLe::GenerateOobData() {
 void PairingHandlerLe::PairingMain(InitialInformations i) {
   log::info("Pairing Started");
 
+  static auto& accept_prompt_latency = common::MetricsRegistry::GetHistogram("security.pairing.accept_prompt");
+  static auto& phase_1_latency = common::MetricsRegistry::GetHistogram("security.pairing.phase_1");
+  static auto& phase_2_latency = common::MetricsRegistry::GetHistogram("security.pairing.phase_2");
+  static auto& encryption_latency = common::MetricsRegistry::GetHistogram("security.pairing.encryption");
+  static auto& key_distribution_latency = common::MetricsRegistry::GetHistogram("security.pairing.key_distribution");
+  static auto& total_latency = common::MetricsRegistry::GetHistogram("security.pairing.total");
+  auto phase_start = std::chrono::steady_clock::now();
+
   if (i.remotely_initiated) {
     log::info("Was remotely initiated, presenting user with the accept prompt");
     i.user_interface_handler->Post(common::BindOnce(&UI::DisplayPairingPrompt, common::Unretained(i.user_interface),
@@ -58,7 +80,10 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
     }
 
     log::info("Pairing prompt accepted");
+    RecordPhaseLatency(accept_prompt_latency, phase_start);
   }
+  // The user's answer to the prompt is left out of the total
+  const auto pairing_start = phase_start;
 
   /************************************************ PHASE 1 *********************************************************/
   Phase1ResultOrFailure phase_1_result = ExchangePairingFeature(i);
@@ -72,6 +97,7 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
   }
 
   auto [pairing_request, pairing_response] = std::get<Phase1Result>(phase_1_result);
+  RecordPhaseLatency(phase_1_latency, phase_start);
 
   uint8_t key_size =
       std::min(pairing_request.GetMaximumEncryptionKeySize(), pairing_response.GetMaximumEncryptionKeySize());
@@ -168,6 +194,8 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
     }
   }
 
+  RecordPhaseLatency(phase_2_latency, phase_start);
+
   /************************************************ PHASE 3 *********************************************************/
   log::info("Waiting for encryption changed");
   auto encryption_change_result = WaitEncryptionChanged();
@@ -193,6 +221,7 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
     return;
   }
   log::info("Encryption change finished successfully");
+  RecordPhaseLatency(encryption_latency, phase_start);
 
   DistributedKeysOrFailure keyExchangeStatus = DistributeKeys(i, pairing_response, isSecureConnections);
   if (std::holds_alternative<PairingFailure>(keyExchangeStatus)) {
@@ -203,6 +232,8 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
 
   // If it's secure connections pairing, do cross-transport key derivation
   DistributedKeys distributed_keys = std::get<DistributedKeys>(keyExchangeStatus);
+  RecordPhaseLatency(key_distribution_latency, phase_start);
+  total_latency.Add(std::chrono::duration_cast<std::chrono::microseconds>(phase_start - pairing_start).count());
   if ((pairing_response.GetAuthReq() & AuthReqMaskSc) && distributed_keys.remote_ltk.has_value()) {
     bool use_h7 = (pairing_response.GetAuthReq() & AuthReqMaskCt2);
     Octet16 link_key = crypto_toolbox::ltk_to_link_key(*(distributed_keys.remote_ltk), use_h7);
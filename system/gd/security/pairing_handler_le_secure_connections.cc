@@ -31,9 +31,9 @@ using hci::Octet16;
 
 std::variant<PairingFailure, KeyExchangeResult> PairingHandlerLe::ExchangePublicKeys(const InitialInformations& i,
                                                                                      OobDataFlag remote_have_oob_data) {
-  // Generate ECDH, or use one that was used for OOB data
+  // Take the ECDH key pair generated ahead of time, or use one that was used for OOB data
   const auto [private_key, public_key] = (remote_have_oob_data == OobDataFlag::NOT_PRESENT || !i.my_oob_data)
-                                             ? GenerateECDHKeyPair()
+                                             ? TakeECDHKeyPair()
                                              : std::make_pair(i.my_oob_data->private_key, i.my_oob_data->public_key);
 
   log::info("Public key exchange start");
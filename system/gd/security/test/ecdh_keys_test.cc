@@ -115,5 +115,18 @@ TEST_F(EcdhKeysTest, test_static) {
   EXPECT_EQ(dhkey_b, dhkey);
 }
 
+/* This test takes two prepared pairs of keys, verifies that they differ, and that they agree on the Diffie–Hellman key */
+TEST_F(EcdhKeysTest, test_prepared) {
+  PrepareECDHKeyPair();
+
+  auto [private_key_a, public_key_a] = TakeECDHKeyPair();
+  auto [private_key_b, public_key_b] = TakeECDHKeyPair();
+
+  EXPECT_NE(private_key_a, private_key_b);
+  EXPECT_TRUE(ValidateECDHPoint(public_key_a));
+  EXPECT_TRUE(ValidateECDHPoint(public_key_b));
+  EXPECT_EQ(ComputeDHKey(private_key_a, public_key_b), ComputeDHKey(private_key_b, public_key_a));
+}
+
 }  // namespace security
 }  // namespace bluetooth
@@ -135,7 +135,10 @@ void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) const {
   ParsedDumpsysArgs parsed_dumpsys_args(args);
   const auto registry = dumpsys_module_.GetModuleRegistry();
 
-  ModuleDumper dumper(fd, *registry, kDumpsysTitle);
+  ModuleDumper dumper(fd, *registry, kDumpsysTitle, parsed_dumpsys_args.GetModules());
+  for (const auto& module : parsed_dumpsys_args.GetModules()) {
+    dprintf(fd, " ----- Dumping module:%s -----\n", module.c_str());
+  }
   std::string dumpsys_data;
   std::ostringstream oss;
   dumper.DumpState(&dumpsys_data, oss);
@@ -144,6 +147,7 @@ void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) const {
   FilterSchema(&dumpsys_data);
 
   dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
+  dprintf(fd, "%s", oss.str().c_str());
 }
 
 void Dumpsys::impl::DumpWithArgsSync(int fd, const char** args, std::promise<void> promise) {
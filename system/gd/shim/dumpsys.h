@@ -26,6 +26,8 @@ namespace bluetooth {
 namespace shim {
 
 constexpr char kArgumentDeveloper[] = "--dev";
+// Restricts the dump to the modules named in a comma separated list, e.g. "--modules=shim::Dumpsys"
+constexpr char kArgumentModules[] = "--modules=";
 
 class Dumpsys : public bluetooth::Module {
  public:
@@ -18,6 +18,7 @@
 #include "shim/dumpsys.h"
 
 #include <cstring>
+#include <sstream>
 
 using namespace bluetooth;
 
@@ -28,6 +29,12 @@ shim::ParsedDumpsysArgs::ParsedDumpsysArgs(const char** args) {
     num_args_++;
     if (!std::strcmp(p, kArgumentDeveloper)) {
       dev_arg_ = true;
+    } else if (!std::strncmp(p, kArgumentModules, std::strlen(kArgumentModules))) {
+      std::istringstream modules(p + std::strlen(kArgumentModules));
+      std::string module;
+      while (std::getline(modules, module, ',')) {
+        if (!module.empty()) modules_.insert(module);
+      }
     } else {
       // silently ignore unexpected option
     }
@@ -39,3 +46,7 @@ shim::ParsedDumpsysArgs::ParsedDumpsysArgs(const char** args) {
 bool shim::ParsedDumpsysArgs::IsDeveloper() const {
   return dev_arg_;
 }
+
+const std::set<std::string>& shim::ParsedDumpsysArgs::GetModules() const {
+  return modules_;
+}
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <set>
+#include <string>
+
 namespace bluetooth {
 namespace shim {
 
@@ -23,10 +26,13 @@ class ParsedDumpsysArgs {
  public:
   ParsedDumpsysArgs(const char** args);
   bool IsDeveloper() const;
+  // The names of the modules to dump, or an empty set to dump all of them.
+  const std::set<std::string>& GetModules() const;
 
  private:
   unsigned num_args_{0};
   bool dev_arg_{false};
+  std::set<std::string> modules_;
 };
 
 }  // namespace shim
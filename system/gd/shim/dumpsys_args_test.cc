@@ -43,6 +43,19 @@ TEST(DumpsysArgsTest, parsed_args_with_dev) {
   };
   shim::ParsedDumpsysArgs parsed_dumpsys_args(args);
   ASSERT_TRUE(parsed_dumpsys_args.IsDeveloper());
+  ASSERT_TRUE(parsed_dumpsys_args.GetModules().empty());
+}
+
+TEST(DumpsysArgsTest, parsed_args_with_modules) {
+  const char* args[]{
+      "--modules=shim::Dumpsys,,Acl Manager",
+      bluetooth::shim::kArgumentDeveloper,
+      nullptr,
+  };
+  shim::ParsedDumpsysArgs parsed_dumpsys_args(args);
+  ASSERT_TRUE(parsed_dumpsys_args.IsDeveloper());
+  ASSERT_EQ(
+      parsed_dumpsys_args.GetModules(), std::set<std::string>({"shim::Dumpsys", "Acl Manager"}));
 }
 
 }  // namespace testing
@@ -71,14 +71,62 @@ void ConfigCache::SetPersistentConfigChangedCallback(std::function<void()> persi
   persistent_config_changed_callback_ = std::move(persistent_config_changed_callback);
 }
 
+void ConfigCache::SetCriticalConfigChangedCallback(std::function<void()> critical_config_changed_callback) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  critical_config_changed_callback_ = std::move(critical_config_changed_callback);
+}
+
+void ConfigCache::SetTrackPersistentChanges(bool track) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  track_persistent_changes_ = track;
+  all_persistent_sections_changed_ = false;
+  changed_persistent_sections_.clear();
+}
+
+std::optional<std::vector<MutationEntry>> ConfigCache::TakePersistentChanges() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::optional<std::vector<MutationEntry>> entries;
+  if (track_persistent_changes_ && !all_persistent_sections_changed_) {
+    entries.emplace();
+    // Each changed section is written again as a whole, since a section can move in and out of the persistent
+    // sections with all its properties
+    for (const auto& section : changed_persistent_sections_) {
+      entries->push_back(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, section));
+      auto section_iter = information_sections_.find(section);
+      if (section_iter == information_sections_.end()) {
+        section_iter = persistent_devices_.find(section);
+        if (section_iter == persistent_devices_.end()) {
+          continue;
+        }
+      }
+      for (const auto& [property, value] : section_iter->second) {
+        if (value.empty()) {
+          // Mutation entries cannot carry an empty value
+          entries.reset();
+          break;
+        }
+        entries->push_back(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, section, property, value));
+      }
+      if (!entries) {
+        break;
+      }
+    }
+  }
+  all_persistent_sections_changed_ = false;
+  changed_persistent_sections_.clear();
+  return entries;
+}
+
 ConfigCache::ConfigCache(ConfigCache&& other) noexcept
     : persistent_config_changed_callback_(nullptr),
+      critical_config_changed_callback_(nullptr),
       persistent_property_names_(std::move(other.persistent_property_names_)),
       information_sections_(std::move(other.information_sections_)),
       persistent_devices_(std::move(other.persistent_devices_)),
       temporary_devices_(std::move(other.temporary_devices_)) {
   log::assert_that(
-      other.persistent_config_changed_callback_ == nullptr,
+      other.persistent_config_changed_callback_ == nullptr &&
+          other.critical_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
 }
 
@@ -89,9 +137,11 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   std::lock_guard<std::recursive_mutex> my_lock(mutex_);
   std::lock_guard<std::recursive_mutex> others_lock(other.mutex_);
   log::assert_that(
-      other.persistent_config_changed_callback_ == nullptr,
+      other.persistent_config_changed_callback_ == nullptr &&
+          other.critical_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
   persistent_config_changed_callback_ = {};
+  critical_config_changed_callback_ = {};
   persistent_property_names_ = std::move(other.persistent_property_names_);
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
@@ -113,13 +163,17 @@ bool ConfigCache::operator!=(const ConfigCache& rhs) const {
 
 void ConfigCache::Clear() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (information_sections_.size() > 0 || persistent_devices_.size() > 0) {
+    all_persistent_sections_changed_ = track_persistent_changes_;
+    changed_persistent_sections_.clear();
+  }
   if (information_sections_.size() > 0) {
     information_sections_.clear();
     PersistentConfigChangedCallback();
   }
   if (persistent_devices_.size() > 0) {
     persistent_devices_.clear();
-    PersistentConfigChangedCallback();
+    CriticalConfigChangedCallback();
   }
   if (temporary_devices_.size() > 0) {
     temporary_devices_.clear();
@@ -150,33 +204,46 @@ bool ConfigCache::HasProperty(const std::string& section, const std::string& pro
 }
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
+  std::optional<std::string> value;
+  ReadProperty(section, property, [&value](std::string_view view) { value.emplace(view); });
+  return value;
+}
+
+bool ConfigCache::ReadProperty(
+    const std::string& section,
+    const std::string& property,
+    const std::function<void(std::string_view)>& reader) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto property_iter = section_iter->second.find(property);
     if (property_iter != section_iter->second.end()) {
-      return property_iter->second;
+      reader(property_iter->second);
+      return true;
     }
   }
   section_iter = persistent_devices_.find(section);
   if (section_iter != persistent_devices_.end()) {
     auto property_iter = section_iter->second.find(property);
     if (property_iter != section_iter->second.end()) {
-      std::string value = property_iter->second;
+      const std::string& value = property_iter->second;
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && value == kEncryptedStr) {
-        return os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + property);
+        reader(os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + property));
+      } else {
+        reader(value);
       }
-      return value;
+      return true;
     }
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter != temporary_devices_.end()) {
     auto property_iter = section_iter->second.find(property);
     if (property_iter != section_iter->second.end()) {
-      return property_iter->second;
+      reader(property_iter->second);
+      return true;
     }
   }
-  return std::nullopt;
+  return false;
 }
 
 void ConfigCache::SetProperty(std::string section, std::string property, std::string value) {
@@ -192,6 +259,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
       section_iter = information_sections_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
     }
     section_iter->second.insert_or_assign(property, std::move(value));
+    PersistentSectionChanged(section);
     PersistentConfigChangedCallback();
     return;
   }
@@ -215,7 +283,12 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
       }
     }
     section_iter->second.insert_or_assign(property, std::move(value));
-    PersistentConfigChangedCallback();
+    PersistentSectionChanged(section);
+    if (IsPersistentProperty(property)) {
+      CriticalConfigChangedCallback();
+    } else {
+      PersistentConfigChangedCallback();
+    }
     return;
   }
   section_iter = temporary_devices_.find(section);
@@ -229,9 +302,14 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
 bool ConfigCache::RemoveSection(const std::string& section) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   // sections are unique among all three maps, hence removing from one of them is enough
-  if (information_sections_.extract(section) || persistent_devices_.extract(section)) {
+  if (information_sections_.extract(section)) {
+    PersistentSectionChanged(section);
     PersistentConfigChangedCallback();
     return true;
+  } else if (persistent_devices_.extract(section)) {
+    PersistentSectionChanged(section);
+    CriticalConfigChangedCallback();
+    return true;
   } else {
     return temporary_devices_.extract(section).has_value();
   }
@@ -247,6 +325,7 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       information_sections_.erase(section_iter);
     }
     if (value.has_value()) {
+      PersistentSectionChanged(section);
       PersistentConfigChangedCallback();
       return true;
     } else {
@@ -265,7 +344,12 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       temporary_devices_.insert_or_assign(section, std::move(section_properties->second));
     }
     if (value.has_value()) {
-      PersistentConfigChangedCallback();
+      PersistentSectionChanged(section);
+      if (IsPersistentProperty(property)) {
+        CriticalConfigChangedCallback();
+      } else {
+        PersistentConfigChangedCallback();
+      }
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && os::ParameterProvider::IsCommonCriteriaMode() &&
           InEncryptKeyNameList(property)) {
         os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(section + "-" + property, "");
@@ -330,6 +414,7 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
     for (auto it = config_section->begin(); it != config_section->end();) {
       if (it->second.contains(property)) {
         log::info("Removing persistent section {} with property {}", it->first, property);
+        PersistentSectionChanged(it->first);
         it = config_section->erase(it);
         num_persistent_removed++;
         continue;
@@ -346,7 +431,7 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
     it++;
   }
   if (num_persistent_removed > 0) {
-    PersistentConfigChangedCallback();
+    CriticalConfigChangedCallback();
   }
 }
 
@@ -360,6 +445,26 @@ std::vector<std::string> ConfigCache::GetPersistentSections() const {
   return paired_devices;
 }
 
+void ConfigCache::ForEachPersistentSection(const std::function<void(const std::string&)>& visitor) const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (const auto& elem : persistent_devices_) {
+    visitor(elem.first);
+  }
+}
+
+void ConfigCache::ForEachPersistentProperty(
+    const std::function<void(const std::string& section, const std::string& property, const std::string& value)>&
+        visitor) const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
+    for (const auto& section : *config_section) {
+      for (const auto& property : section.second) {
+        visitor(section.first, property.first, property.second);
+      }
+    }
+  }
+}
+
 void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   while (!mutation_entries.empty()) {
@@ -501,6 +606,7 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto& elem : *config_section) {
       if (FixDeviceTypeInconsistencyInSection(elem.first, elem.second)) {
+        PersistentSectionChanged(elem.first);
         persistent_device_changed = true;
       }
     }
@@ -73,8 +73,20 @@ class ConfigCache {
   virtual bool HasProperty(const std::string& section, const std::string& property) const;
   // Get property, return std::nullopt if section or property does not exist
   virtual std::optional<std::string> GetProperty(const std::string& section, const std::string& property) const;
+  // Call |reader| with a view of the property value while holding the config mutex, without copying the value. The view
+  // is only valid until |reader| returns. Return false without calling |reader| if section or property does not exist
+  virtual bool ReadProperty(
+      const std::string& section,
+      const std::string& property,
+      const std::function<void(std::string_view)>& reader) const;
   // Returns a copy of persistent device MAC addresses
   virtual std::vector<std::string> GetPersistentSections() const;
+  // Call |visitor| with each persistent device MAC address while holding the config mutex, without copying them
+  virtual void ForEachPersistentSection(const std::function<void(const std::string&)>& visitor) const;
+  // Call |visitor| with each property that is saved to disk, in the order of SerializeToLegacyFormat()
+  virtual void ForEachPersistentProperty(
+      const std::function<void(const std::string& section, const std::string& property, const std::string& value)>&
+          visitor) const;
   // Return true if a section is persistent
   virtual bool IsPersistentSection(const std::string& section) const;
   // Return true if a section has one of the properties in |property_names|
@@ -113,6 +125,15 @@ class ConfigCache {
   virtual void Clear();
   // Set a callback to notify interested party that a persistent config change has just happened
   virtual void SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback);
+  // Set a callback to notify interested party that a bond changed: a property in persistent_property_names_ was set or
+  // removed or a persistent device was removed. These changes go to the persistent config changed callback when empty
+  virtual void SetCriticalConfigChangedCallback(std::function<void()> critical_config_changed_callback);
+  // Start or stop recording which persistent sections change, so that they can be saved incrementally
+  virtual void SetTrackPersistentChanges(bool track);
+  // Return the mutation entries that bring a saved config up to date with the persistent changes made since tracking
+  // started or since the last call, or std::nullopt if the whole config must be saved again. Tracking restarts from the
+  // current state
+  virtual std::optional<std::vector<MutationEntry>> TakePersistentChanges();
 
   // Device config specific methods
   // TODO: methods here should be moved to a device specific config cache if this config cache is supposed to be generic
@@ -130,6 +151,8 @@ class ConfigCache {
   mutable std::recursive_mutex mutex_;
   // A callback to notify interested party that a persistent config change has just happened, empty by default
   std::function<void()> persistent_config_changed_callback_;
+  // A callback to notify interested party that a bond has just changed, empty by default
+  std::function<void()> critical_config_changed_callback_;
   // A set of property names that if set would make a section persistent and if non of these properties are set, a
   // section would become temporary again
   std::unordered_set<std::string_view> persistent_property_names_;
@@ -140,6 +163,17 @@ class ConfigCache {
   // Information about temporary devices, normally unpaired, will not be written to disk, will be evicted automatically
   // if capacity exceeds given value during initialization
   common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
+  // Persistent sections changed since the last TakePersistentChanges(), when tracking is enabled
+  bool track_persistent_changes_ = false;
+  bool all_persistent_sections_changed_ = false;
+  std::unordered_set<std::string> changed_persistent_sections_;
+
+  // Record that persistent |section| has changed
+  inline void PersistentSectionChanged(const std::string& section) {
+    if (track_persistent_changes_ && !all_persistent_sections_changed_) {
+      changed_persistent_sections_.insert(section);
+    }
+  }
 
   // Convenience method to check if the callback is valid before calling it
   inline void PersistentConfigChangedCallback() const {
@@ -147,6 +181,15 @@ class ConfigCache {
       persistent_config_changed_callback_();
     }
   }
+
+  // Notify a bond change, falling back to the persistent config changed callback
+  inline void CriticalConfigChangedCallback() const {
+    if (critical_config_changed_callback_) {
+      critical_config_changed_callback_();
+    } else {
+      PersistentConfigChangedCallback();
+    }
+  }
 };
 
 }  // namespace storage
@@ -29,17 +29,15 @@ void ConfigCacheHelper::SetBool(const std::string& section, const std::string& p
 }
 
 std::optional<bool> ConfigCacheHelper::GetBool(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
-  if (*value_str == "true") {
-    return true;
-  } else if (*value_str == "false") {
-    return false;
-  } else {
-    return std::nullopt;
-  }
+  std::optional<bool> value;
+  config_cache_.ReadProperty(section, property, [&value](std::string_view value_str) {
+    if (value_str == "true") {
+      value = true;
+    } else if (value_str == "false") {
+      value = false;
+    }
+  });
+  return value;
 }
 
 void ConfigCacheHelper::SetUint64(const std::string& section, const std::string& property, uint64_t value) {
@@ -47,11 +45,11 @@ void ConfigCacheHelper::SetUint64(const std::string& section, const std::string&
 }
 
 std::optional<uint64_t> ConfigCacheHelper::GetUint64(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
-  return common::Uint64FromString(*value_str);
+  std::optional<uint64_t> value;
+  config_cache_.ReadProperty(section, property, [&value](std::string_view value_str) {
+    value = common::Uint64FromString(std::string(value_str));
+  });
+  return value;
 }
 
 void ConfigCacheHelper::SetUint32(const std::string& section, const std::string& property, uint32_t value) {
@@ -59,10 +57,6 @@ void ConfigCacheHelper::SetUint32(const std::string& section, const std::string&
 }
 
 std::optional<uint32_t> ConfigCacheHelper::GetUint32(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
   auto large_value = GetUint64(section, property);
   if (!large_value) {
     return std::nullopt;
@@ -78,11 +72,11 @@ void ConfigCacheHelper::SetInt64(const std::string& section, const std::string&
 }
 
 std::optional<int64_t> ConfigCacheHelper::GetInt64(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
-  return common::Int64FromString(*value_str);
+  std::optional<int64_t> value;
+  config_cache_.ReadProperty(section, property, [&value](std::string_view value_str) {
+    value = common::Int64FromString(std::string(value_str));
+  });
+  return value;
 }
 
 void ConfigCacheHelper::SetInt(const std::string& section, const std::string& property, int value) {
@@ -90,10 +84,6 @@ void ConfigCacheHelper::SetInt(const std::string& section, const std::string& pr
 }
 
 std::optional<int> ConfigCacheHelper::GetInt(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
   auto large_value = GetInt64(section, property);
   if (!large_value) {
     return std::nullopt;
@@ -111,14 +101,13 @@ void ConfigCacheHelper::SetBin(
 
 std::optional<std::vector<uint8_t>> ConfigCacheHelper::GetBin(
     const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
-  auto value = common::FromHexString(*value_str);
-  if (!value) {
-    log::warn("value_str cannot be parsed to std::vector<uint8_t>");
-  }
+  std::optional<std::vector<uint8_t>> value;
+  config_cache_.ReadProperty(section, property, [&value](std::string_view value_str) {
+    value = common::FromHexString(value_str);
+    if (!value) {
+      log::warn("value_str cannot be parsed to std::vector<uint8_t>");
+    }
+  });
   return value;
 }
 
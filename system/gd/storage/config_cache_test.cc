@@ -48,6 +48,22 @@ TEST(ConfigCacheTest, simple_set_get_test) {
   ASSERT_EQ(*value, "C");
 }
 
+TEST(ConfigCacheTest, read_property_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE");
+  std::string value;
+  auto reader = [&value](std::string_view view) { value = view; };
+  ASSERT_TRUE(config.ReadProperty("A", "B", reader));
+  ASSERT_EQ(value, "C");
+  ASSERT_TRUE(config.ReadProperty("AA:BB:CC:DD:EE:FF", BTIF_STORAGE_KEY_LINK_KEY, reader));
+  ASSERT_EQ(value, "AABBAABBCCDDEE");
+  value.clear();
+  ASSERT_FALSE(config.ReadProperty("A", "C", reader));
+  ASSERT_FALSE(config.ReadProperty("B", "B", reader));
+  ASSERT_EQ(value, "");
+}
+
 TEST(ConfigCacheTest, empty_values_test) {
   ConfigCache config(100, Device::kLinkKeyProperties);
   ASSERT_DEATH({ config.SetProperty("", "B", "C"); }, "Empty section name not allowed");
@@ -218,6 +234,17 @@ TEST(ConfigCacheTest, get_persistent_devices_test) {
   ASSERT_THAT(config.GetPersistentSections(), ElementsAre("AA:BB:CC:DD:EE:FF"));
 }
 
+TEST(ConfigCacheTest, for_each_persistent_section_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", BTIF_STORAGE_KEY_LINK_KEY, "DEERDEERDEER");
+  std::vector<std::string> sections;
+  config.ForEachPersistentSection([&sections](const std::string& section) { sections.push_back(section); });
+  ASSERT_THAT(sections, ElementsAre("CC:DD:EE:FF:00:11", "AA:BB:CC:DD:EE:FF"));
+}
+
 TEST(ConfigCacheTest, appoaching_temporary_config_limit_test) {
   ConfigCache config(2, Device::kLinkKeyProperties);
   for (int i = 0; i < 10; ++i) {
@@ -454,4 +481,26 @@ TEST(ConfigCacheTest, test_get_section_property_names) {
   ASSERT_THAT(config.GetPropertyNames("D"), ElementsAre());
 }
 
+TEST(ConfigCacheTest, take_persistent_changes_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  ASSERT_FALSE(config.TakePersistentChanges());
+  config.SetTrackPersistentChanges(true);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  auto changes = config.TakePersistentChanges();
+  ASSERT_TRUE(changes);
+  ASSERT_EQ(changes->size(), 2u);
+  ASSERT_THAT(config.TakePersistentChanges(), Optional(IsEmpty()));
+
+  // The whole section is saved again when a device becomes persistent
+  config.SetProperty("AA:BB:CC:DD:EE:FF", BTIF_STORAGE_KEY_LINK_KEY, "D");
+  changes = config.TakePersistentChanges();
+  ASSERT_TRUE(changes);
+  ASSERT_EQ(changes->size(), 3u);
+
+  config.Clear();
+  ASSERT_FALSE(config.TakePersistentChanges());
+  ASSERT_THAT(config.TakePersistentChanges(), Optional(IsEmpty()));
+}
+
 }  // namespace testing
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <bluetooth/log.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <queue>
+#include <sstream>
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "storage/legacy_config_file.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+// Journal lines, fields are separated by tabs and a value takes the rest of the line
+constexpr char kRemoveSectionEntry = 'R';
+constexpr char kRemovePropertyEntry = 'P';
+constexpr char kSetEntry = 'S';
+constexpr char kCommitLine[] = "C";
+
+std::string Header(const std::string& base) {
+  return fmt::format("# bt_config journal v1 base={:016x}", LegacyConfigFile::ContentHash(base));
+}
+
+}  // namespace
+
+ConfigJournal::ConfigJournal(std::string path) : path_(std::move(path)) {
+  log::assert_that(!path_.empty(), "assert failed: !path_.empty()");
+}
+
+size_t ConfigJournal::Replay(const std::string& base, ConfigCache& cache) const {
+  auto content = os::ReadSmallFile(path_);
+  if (!content) {
+    return 0;
+  }
+  std::istringstream journal(*content);
+  std::string line;
+  if (!std::getline(journal, line) || line != Header(base)) {
+    log::warn("Ignoring journal {} that does not match the config file", path_);
+    return 0;
+  }
+
+  size_t batches = 0;
+  std::queue<MutationEntry> batch;
+  while (std::getline(journal, line)) {
+    if (line == kCommitLine) {
+      cache.Commit(batch);
+      batches++;
+      continue;
+    }
+    auto fields = common::StringSplit(line, "\t", 4);
+    for (const auto& field : fields) {
+      if (field.empty()) {
+        fields.clear();
+        break;
+      }
+    }
+    if (fields.size() == 2 && fields[0].size() == 1 && fields[0][0] == kRemoveSectionEntry) {
+      batch.push(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, std::move(fields[1])));
+    } else if (fields.size() == 3 && fields[0].size() == 1 && fields[0][0] == kRemovePropertyEntry) {
+      batch.push(
+          MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, std::move(fields[1]), std::move(fields[2])));
+    } else if (fields.size() == 4 && fields[0].size() == 1 && fields[0][0] == kSetEntry) {
+      batch.push(MutationEntry::Set(
+          MutationEntry::PropertyType::NORMAL, std::move(fields[1]), std::move(fields[2]), std::move(fields[3])));
+    } else {
+      // Only the last batch can be incomplete, if the stack stopped while appending it
+      break;
+    }
+  }
+  if (!batch.empty()) {
+    log::warn("Dropping {} uncommitted entries from journal {}", batch.size(), path_);
+  }
+  log::info("Replayed {} batches from journal {}", batches, path_);
+  return batches;
+}
+
+bool ConfigJournal::Reset(const std::string& base) {
+  return os::WriteToFile(path_, Header(base) + "\n");
+}
+
+bool ConfigJournal::Append(const std::vector<MutationEntry>& entries) {
+  std::string data;
+  for (const auto& entry : entries) {
+    switch (entry.entry_type) {
+      case MutationEntry::EntryType::SET:
+        data += fmt::format("{}\t{}\t{}\t{}\n", kSetEntry, entry.section, entry.property, entry.value);
+        break;
+      case MutationEntry::EntryType::REMOVE_PROPERTY:
+        data += fmt::format("{}\t{}\t{}\n", kRemovePropertyEntry, entry.section, entry.property);
+        break;
+      case MutationEntry::EntryType::REMOVE_SECTION:
+        data += fmt::format("{}\t{}\n", kRemoveSectionEntry, entry.section);
+        break;
+    }
+  }
+  data += kCommitLine;
+  data += '\n';
+
+  int fd = open(path_.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+  if (fd < 0) {
+    log::error("unable to open journal '{}', error: {}", path_, strerror(errno));
+    return false;
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t result = write(fd, data.data() + written, data.size() - written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      log::error("unable to write to journal '{}', error: {}", path_, strerror(errno));
+      close(fd);
+      return false;
+    }
+    written += result;
+  }
+  bool synced = fdatasync(fd) == 0;
+  if (!synced) {
+    log::error("unable to sync journal '{}', error: {}", path_, strerror(errno));
+  }
+  close(fd);
+  return synced;
+}
+
+size_t ConfigJournal::Size() const {
+  struct stat st {};
+  if (stat(path_.c_str(), &st) != 0) {
+    return 0;
+  }
+  return st.st_size;
+}
+
+bool ConfigJournal::Delete() {
+  if (!os::FileExists(path_)) {
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/config_cache.h"
+#include "storage/mutation_entry.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Append-only log of the mutations made on top of a config file saved by LegacyConfigFile, so that a change can be
+// persisted without writing the whole config again.
+//
+// The journal starts with a header holding a hash of the config file it applies to, followed by batches of mutation
+// entries, each terminated by a commit line and synced to disk before Append() returns. A journal whose header does
+// not match the config file is stale (e.g. the config was rewritten just before a crash) and is ignored, as is a batch
+// that was not fully written.
+class ConfigJournal {
+ public:
+  static ConfigJournal FromPath(std::string path) {
+    return ConfigJournal(std::move(path));
+  }
+  explicit ConfigJournal(std::string path);
+  // Apply the committed batches of the journal to |cache| if the journal was started for a config file with content
+  // |base|. Returns the number of batches applied
+  size_t Replay(const std::string& base, ConfigCache& cache) const;
+  // Start an empty journal for a config file with content |base|
+  bool Reset(const std::string& base);
+  // Append and sync a batch of entries. Fails if the journal has not been started with Reset()
+  bool Append(const std::vector<MutationEntry>& entries);
+  // Size of the journal in bytes, 0 if it does not exist
+  size_t Size() const;
+  bool Delete();
+
+ private:
+  std::string path_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
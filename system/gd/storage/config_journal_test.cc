@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "storage/config_keys.h"
+#include "storage/device.h"
+
+namespace testing {
+
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
+using bluetooth::storage::Device;
+using bluetooth::storage::MutationEntry;
+
+class ConfigJournalTest : public Test {
+ protected:
+  void SetUp() override {
+    journal_path_ = std::filesystem::temp_directory_path() / "temp_config_journal.txt";
+    std::filesystem::remove(journal_path_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(journal_path_);
+  }
+
+  std::filesystem::path journal_path_;
+};
+
+TEST_F(ConfigJournalTest, replay_committed_changes_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  const std::string base = config.SerializeToLegacyFormat();
+  auto journal = ConfigJournal::FromPath(journal_path_.string());
+  ASSERT_TRUE(journal.Reset(base));
+
+  config.SetTrackPersistentChanges(true);
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "temporary");
+  config.SetProperty("CC:DD:EE:FF:00:11", BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE");
+  config.SetProperty("CC:DD:EE:FF:00:11", "Name", "a\tname");
+  auto changes = config.TakePersistentChanges();
+  ASSERT_TRUE(changes.has_value());
+  ASSERT_TRUE(journal.Append(*changes));
+
+  config.RemoveSection("A");
+  changes = config.TakePersistentChanges();
+  ASSERT_TRUE(changes.has_value());
+  ASSERT_TRUE(journal.Append(*changes));
+
+  ConfigCache replayed(100, Device::kLinkKeyProperties);
+  replayed.SetProperty("A", "B", "C");
+  EXPECT_EQ(journal.Replay(base, replayed), 2u);
+  EXPECT_FALSE(replayed.HasSection("A"));
+  EXPECT_FALSE(replayed.HasSection("AA:BB:CC:DD:EE:FF"));
+  EXPECT_THAT(replayed.GetPersistentSections(), ElementsAre("CC:DD:EE:FF:00:11"));
+  EXPECT_THAT(replayed.GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("a\tname")));
+}
+
+TEST_F(ConfigJournalTest, ignore_journal_of_other_config_test) {
+  auto journal = ConfigJournal::FromPath(journal_path_.string());
+  ASSERT_TRUE(journal.Reset("[A]\nB = C\n"));
+  ASSERT_TRUE(journal.Append({MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, "A")}));
+
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "D");
+  EXPECT_EQ(journal.Replay("[A]\nB = D\n", config), 0u);
+  EXPECT_THAT(config.GetProperty("A", "B"), Optional(StrEq("D")));
+}
+
+TEST_F(ConfigJournalTest, drop_uncommitted_batch_test) {
+  auto journal = ConfigJournal::FromPath(journal_path_.string());
+  ASSERT_TRUE(journal.Reset(""));
+  ASSERT_TRUE(journal.Append({MutationEntry::Set(MutationEntry::PropertyType::NORMAL, "A", "B", "C")}));
+  {
+    std::ofstream file(journal_path_, std::ios::app);
+    file << "S\tA\tB\tD\nR\tA";
+  }
+
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  EXPECT_EQ(journal.Replay("", config), 1u);
+  EXPECT_THAT(config.GetProperty("A", "B"), Optional(StrEq("C")));
+}
+
+TEST_F(ConfigJournalTest, append_requires_reset_test) {
+  auto journal = ConfigJournal::FromPath(journal_path_.string());
+  EXPECT_EQ(journal.Size(), 0u);
+  EXPECT_FALSE(journal.Append({MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, "A")}));
+  ASSERT_TRUE(journal.Reset(""));
+  EXPECT_GT(journal.Size(), 0u);
+  EXPECT_TRUE(journal.Delete());
+  EXPECT_EQ(journal.Size(), 0u);
+}
+
+}  // namespace testing
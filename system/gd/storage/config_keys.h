@@ -25,6 +25,7 @@
 #define BTIF_STORAGE_KEY_ALIAS "Aliase"
 #define BTIF_STORAGE_KEY_APPEARANCE "Appearance"
 #define BTIF_STORAGE_KEY_AV_REM_CTRL_FEATURES "AvrcpPeerFeatures"
+#define BTIF_STORAGE_KEY_AVDTP_SEP_CACHE "AvdtpSepCache"
 #define BTIF_STORAGE_KEY_AVDTP_VERSION "AvdtpVersion"
 #define BTIF_STORAGE_KEY_AVRCP_CONTROLLER_VERSION "AvrcpControllerVersion"
 #define BTIF_STORAGE_KEY_CLOCK_OFFSET "ClockOffset"
@@ -115,6 +116,7 @@
 #define BTIF_STORAGE_KEY_REMOTE_VER_VER "LmpVer"
 #define BTIF_STORAGE_KEY_RESTRICTED "Restricted"
 #define BTIF_STORAGE_KEY_SCANMODE "ScanMode"
+#define BTIF_STORAGE_KEY_SDP_CACHE "SdpCache"
 #define BTIF_STORAGE_KEY_SDP_DI_HW_VERSION "SdpDiHardwareVersion"
 #define BTIF_STORAGE_KEY_SDP_DI_MANUFACTURER "SdpDiManufacturer"
 #define BTIF_STORAGE_KEY_SDP_DI_MODEL "SdpDiModel"
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_snapshot.h"
+
+#include <bluetooth/log.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "storage/device.h"
+#include "storage/legacy_config_file.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x53434742;  // "BGCS"
+constexpr uint32_t kVersion = 1;
+
+// The payload is a list of sections, each one is its name followed by the number of properties and the property
+// names and values. Strings are prefixed with their length. Integers use the host byte order since the snapshot is
+// never moved to another device.
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t base_hash;
+  uint64_t payload_hash;
+  uint64_t payload_size;
+};
+
+void AppendUint32(std::string& data, uint32_t value) {
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(std::string& data, const std::string& value) {
+  AppendUint32(data, value.size());
+  data.append(value);
+}
+
+class PayloadReader {
+ public:
+  explicit PayloadReader(std::string_view payload) : payload_(payload) {}
+
+  bool ReadUint32(uint32_t& value) {
+    if (payload_.size() < sizeof(value)) {
+      return false;
+    }
+    memcpy(&value, payload_.data(), sizeof(value));
+    payload_.remove_prefix(sizeof(value));
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint32_t size;
+    if (!ReadUint32(size) || payload_.size() < size) {
+      return false;
+    }
+    value.assign(payload_.data(), size);
+    payload_.remove_prefix(size);
+    return true;
+  }
+
+  bool IsEmpty() const {
+    return payload_.empty();
+  }
+
+ private:
+  std::string_view payload_;
+};
+
+}  // namespace
+
+ConfigSnapshot::ConfigSnapshot(std::string path) : path_(std::move(path)) {
+  log::assert_that(!path_.empty(), "assert failed: !path_.empty()");
+}
+
+std::optional<ConfigCache> ConfigSnapshot::Read(const std::string& base, size_t temp_devices_capacity) const {
+  auto content = os::ReadSmallFile(path_);
+  if (!content) {
+    return std::nullopt;
+  }
+  Header header;
+  if (content->size() < sizeof(header)) {
+    log::warn("Ignoring truncated config snapshot {}", path_);
+    return std::nullopt;
+  }
+  memcpy(&header, content->data(), sizeof(header));
+  std::string_view payload = std::string_view(*content).substr(sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion) {
+    log::warn("Ignoring config snapshot {} with an unknown format", path_);
+    return std::nullopt;
+  }
+  if (header.base_hash != LegacyConfigFile::ContentHash(base)) {
+    log::info("Ignoring config snapshot {} that does not match the config file", path_);
+    return std::nullopt;
+  }
+  if (header.payload_size != payload.size() || header.payload_hash != LegacyConfigFile::ContentHash(payload)) {
+    log::warn("Ignoring corrupted config snapshot {}", path_);
+    return std::nullopt;
+  }
+
+  ConfigCache cache(temp_devices_capacity, Device::kLinkKeyProperties);
+  PayloadReader reader(payload);
+  std::string section;
+  std::string property;
+  std::string value;
+  while (!reader.IsEmpty()) {
+    uint32_t num_properties;
+    if (!reader.ReadString(section) || !reader.ReadUint32(num_properties)) {
+      return std::nullopt;
+    }
+    for (uint32_t i = 0; i < num_properties; i++) {
+      if (!reader.ReadString(property) || !reader.ReadString(value)) {
+        return std::nullopt;
+      }
+      cache.SetProperty(section, property, value);
+    }
+  }
+  return cache;
+}
+
+bool ConfigSnapshot::Write(const std::string& base, const ConfigCache& cache) {
+  std::string payload;
+  std::string current_section;
+  size_t num_properties_offset = 0;
+  uint32_t num_properties = 0;
+  cache.ForEachPersistentProperty(
+      [&](const std::string& section, const std::string& property, const std::string& value) {
+        if (num_properties == 0 || section != current_section) {
+          if (num_properties > 0) {
+            memcpy(payload.data() + num_properties_offset, &num_properties, sizeof(num_properties));
+          }
+          current_section = section;
+          num_properties = 0;
+          AppendString(payload, common::StringTrim(section));
+          num_properties_offset = payload.size();
+          AppendUint32(payload, 0);
+        }
+        // Store what LegacyConfigFile::Read() would read back from the config file
+        AppendString(payload, common::StringTrim(property));
+        AppendString(payload, common::StringTrim(value));
+        num_properties++;
+      });
+  if (num_properties > 0) {
+    memcpy(payload.data() + num_properties_offset, &num_properties, sizeof(num_properties));
+  }
+
+  Header header{
+      .magic = kMagic,
+      .version = kVersion,
+      .base_hash = LegacyConfigFile::ContentHash(base),
+      .payload_hash = LegacyConfigFile::ContentHash(payload),
+      .payload_size = payload.size(),
+  };
+  std::string content(reinterpret_cast<const char*>(&header), sizeof(header));
+  content.append(payload);
+  return os::WriteToFile(path_, content);
+}
+
+bool ConfigSnapshot::Delete() {
+  if (!os::FileExists(path_)) {
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
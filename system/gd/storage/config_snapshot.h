@@ -0,0 +1,49 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "storage/config_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Binary copy of a config file saved by LegacyConfigFile, which is loaded without tokenizing and trimming every line.
+//
+// The snapshot records the hash of the config file it was written for and a checksum of its own content. It is only
+// used when both match, otherwise the config file is parsed as usual. The config file stays the source of truth.
+class ConfigSnapshot {
+ public:
+  static ConfigSnapshot FromPath(std::string path) {
+    return ConfigSnapshot(std::move(path));
+  }
+  explicit ConfigSnapshot(std::string path);
+  // Read the snapshot if it was written for a config file with content |base|
+  std::optional<ConfigCache> Read(const std::string& base, size_t temp_devices_capacity) const;
+  // Write a snapshot of |cache| for a config file with content |base|
+  bool Write(const std::string& base, const ConfigCache& cache);
+  bool Delete();
+
+ private:
+  std::string path_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
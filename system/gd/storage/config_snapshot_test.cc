@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_snapshot.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "os/files.h"
+#include "storage/config_keys.h"
+#include "storage/device.h"
+#include "storage/legacy_config_file.h"
+
+namespace testing {
+
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigSnapshot;
+using bluetooth::storage::Device;
+using bluetooth::storage::LegacyConfigFile;
+
+class ConfigSnapshotTest : public Test {
+ protected:
+  void SetUp() override {
+    auto temp_dir = std::filesystem::temp_directory_path();
+    config_path_ = temp_dir / "temp_config.txt";
+    snapshot_path_ = temp_dir / "temp_config_snapshot.bin";
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(config_path_);
+    std::filesystem::remove(snapshot_path_);
+  }
+
+  std::filesystem::path config_path_;
+  std::filesystem::path snapshot_path_;
+};
+
+TEST_F(ConfigSnapshotTest, read_matches_config_file_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("Info", "FileSource", "Empty");
+  config.SetProperty("Adapter", "Address", "01:02:03:ab:cd:ef");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "temporary");
+  config.SetProperty("CC:DD:EE:FF:00:11", BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE");
+  config.SetProperty("CC:DD:EE:FF:00:11", "Name", " spaces ");
+  config.SetProperty("CC:DD:EE:FF:00:11", "Empty", "");
+  ASSERT_TRUE(LegacyConfigFile::FromPath(config_path_.string()).Write(config));
+  auto base = bluetooth::os::ReadSmallFile(config_path_.string());
+  ASSERT_TRUE(base);
+
+  auto snapshot = ConfigSnapshot::FromPath(snapshot_path_.string());
+  ASSERT_TRUE(snapshot.Write(*base, config));
+  auto from_snapshot = snapshot.Read(*base, 100);
+  auto from_config = LegacyConfigFile::FromPath(config_path_.string()).Read(100);
+  ASSERT_TRUE(from_snapshot);
+  ASSERT_TRUE(from_config);
+  EXPECT_EQ(*from_snapshot, *from_config);
+  EXPECT_EQ(from_snapshot->SerializeToLegacyFormat(), from_config->SerializeToLegacyFormat());
+  EXPECT_THAT(from_snapshot->GetPersistentSections(), ElementsAre("CC:DD:EE:FF:00:11"));
+}
+
+TEST_F(ConfigSnapshotTest, ignore_stale_snapshot_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  auto snapshot = ConfigSnapshot::FromPath(snapshot_path_.string());
+  ASSERT_TRUE(snapshot.Write("[A]\nB = C\n", config));
+  EXPECT_TRUE(snapshot.Read("[A]\nB = C\n", 100));
+  EXPECT_FALSE(snapshot.Read("[A]\nB = D\n", 100));
+}
+
+TEST_F(ConfigSnapshotTest, ignore_corrupted_snapshot_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  auto snapshot = ConfigSnapshot::FromPath(snapshot_path_.string());
+  ASSERT_TRUE(snapshot.Write("", config));
+  {
+    std::fstream file(snapshot_path_, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('D');
+  }
+  EXPECT_FALSE(snapshot.Read("", 100));
+  EXPECT_TRUE(snapshot.Delete());
+  EXPECT_FALSE(snapshot.Read("", 100));
+}
+
+}  // namespace testing
@@ -77,7 +77,11 @@ std::optional<ConfigCache> LegacyConfigFile::Read(size_t temp_devices_capacity)
 }
 
 bool LegacyConfigFile::Write(const ConfigCache& cache) {
-  return os::WriteToFile(path_, cache.SerializeToLegacyFormat());
+  return Write(cache.SerializeToLegacyFormat());
+}
+
+bool LegacyConfigFile::Write(const std::string& serialized_config) {
+  return os::WriteToFile(path_, serialized_config);
 }
 
 bool LegacyConfigFile::Delete() {
@@ -88,5 +92,15 @@ bool LegacyConfigFile::Delete() {
   return os::RemoveFile(path_);
 }
 
+uint64_t LegacyConfigFile::ContentHash(std::string_view content) {
+  // 64-bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325;
+  for (unsigned char c : content) {
+    hash ^= c;
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
 }  // namespace storage
 }  // namespace bluetooth
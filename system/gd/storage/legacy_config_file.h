@@ -15,7 +15,9 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "storage/config_cache.h"
@@ -32,7 +34,11 @@ class LegacyConfigFile {
   explicit LegacyConfigFile(std::string path);
   std::optional<ConfigCache> Read(size_t temp_devices_capacity);
   bool Write(const ConfigCache& cache);
+  // Write a config already serialized with ConfigCache::SerializeToLegacyFormat()
+  bool Write(const std::string& serialized_config);
   bool Delete();
+  // Hash of the content of a config file, used to tell whether files derived from it are up to date
+  static uint64_t ContentHash(std::string_view content);
 
  private:
   std::string path_;
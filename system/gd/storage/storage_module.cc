@@ -18,6 +18,7 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -25,6 +26,7 @@
 #include <utility>
 
 #include "common/bind.h"
+#include "common/metrics_registry.h"
 #include "metrics/counter_metrics.h"
 #include "os/alarm.h"
 #include "os/files.h"
@@ -32,7 +34,9 @@
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
 #include "storage/config_keys.h"
+#include "storage/config_snapshot.h"
 #include "storage/legacy_config_file.h"
 #include "storage/mutation.h"
 
@@ -43,6 +47,14 @@ using os::Alarm;
 using os::Handler;
 
 static const std::string kFactoryResetProperty = "persist.bluetooth.factoryreset";
+// Save changes incrementally to a journal next to the config file instead of rewriting the whole config
+static const std::string kConfigJournalProperty = "bluetooth.storage.journal.enabled";
+static const std::string kConfigJournalSuffix = ".journal";
+// Rewrite the config file and start a new journal once the journal grows past this size
+static const size_t kConfigJournalCompactionSize = 64 * 1024;
+// Keep a binary copy of the config file next to it, which is faster to load than the config file
+static const std::string kConfigSnapshotProperty = "bluetooth.storage.snapshot.enabled";
+static const std::string kConfigSnapshotSuffix = ".snapshot";
 
 static const size_t kDefaultTempDeviceCapacity = 10000;
 // Save config whenever there is a change, but delay it by this value so that burst config change won't overwhelm disk
@@ -50,6 +62,15 @@ static const std::chrono::milliseconds kDefaultConfigSaveDelay = std::chrono::mi
 // Writing a config to disk takes a minimum 10 ms on a decent x86_64 machine
 // The config saving delay must be bigger than this value to avoid overwhelming the disk
 static const std::chrono::milliseconds kMinConfigSaveDelay = std::chrono::milliseconds(20);
+// Changes other than bonds are saved later when the config keeps changing, e.g. while the GATT caches or the IoT
+// telemetry of several devices are updated: the save delay doubles whenever more than kMaxConfigSavesPerWindow saves
+// happen within kConfigSaveRateWindow, up to kMaxConfigSaveDelay, and goes back to the configured delay after a
+// window with at most half as many saves. Bond changes are always saved after the configured delay
+static const std::chrono::seconds kConfigSaveRateWindow = std::chrono::seconds(60);
+static const int kMaxConfigSavesPerWindow = 6;
+static const std::chrono::milliseconds kMaxConfigSaveDelay = std::chrono::milliseconds(60000);
+// Log the bytes written to disk at most this often
+static const std::chrono::hours kConfigWriteReportPeriod = std::chrono::hours(1);
 
 const int kConfigFileComparePass = 1;
 const std::string kConfigFilePrefix = "bt_config-origin";
@@ -97,6 +118,16 @@ struct StorageModule::impl {
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
   bool has_pending_config_save_ = false;
+  std::chrono::steady_clock::time_point pending_config_save_time_;
+  // Delay of the saves of the changes other than bonds
+  std::chrono::milliseconds lazy_config_save_delay_{};
+  std::chrono::steady_clock::time_point save_window_start_;
+  int saves_in_window_ = 0;
+  std::chrono::steady_clock::time_point write_report_start_;
+  size_t bytes_written_since_report_ = 0;
+  int saves_since_report_ = 0;
+  bool journal_enabled_ = false;
+  bool snapshot_enabled_ = false;
 };
 
 Mutation StorageModule::Modify() {
@@ -106,12 +137,63 @@ Mutation StorageModule::Modify() {
 
 void StorageModule::SaveDelayed() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  ScheduleSave(pimpl_->lazy_config_save_delay_);
+}
+
+void StorageModule::SaveCritical() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  ScheduleSave(config_save_delay_);
+}
+
+void StorageModule::ScheduleSave(std::chrono::milliseconds delay) {
+  auto save_time = std::chrono::steady_clock::now() + delay;
   if (pimpl_->has_pending_config_save_) {
-    return;
+    if (pimpl_->pending_config_save_time_ <= save_time) {
+      return;
+    }
+    // Bring a lazy save forward
+    pimpl_->config_save_alarm_.Cancel();
   }
   pimpl_->config_save_alarm_.Schedule(
-      common::BindOnce(&StorageModule::SaveImmediately, common::Unretained(this)), config_save_delay_);
+      common::BindOnce(&StorageModule::SaveImmediately, common::Unretained(this)), delay);
   pimpl_->has_pending_config_save_ = true;
+  pimpl_->pending_config_save_time_ = save_time;
+}
+
+void StorageModule::AccountSave(size_t bytes_written) {
+  static auto& config_bytes_written = common::MetricsRegistry::GetCounter("storage.config_bytes_written");
+  static auto& config_saves = common::MetricsRegistry::GetCounter("storage.config_saves");
+  config_bytes_written.Add(bytes_written);
+  config_saves.Add();
+
+  auto now = std::chrono::steady_clock::now();
+  if (now - pimpl_->save_window_start_ >= kConfigSaveRateWindow) {
+    if (pimpl_->saves_in_window_ <= kMaxConfigSavesPerWindow / 2) {
+      pimpl_->lazy_config_save_delay_ = config_save_delay_;
+    }
+    pimpl_->save_window_start_ = now;
+    pimpl_->saves_in_window_ = 0;
+  }
+  if (++pimpl_->saves_in_window_ > kMaxConfigSavesPerWindow &&
+      pimpl_->lazy_config_save_delay_ < kMaxConfigSaveDelay) {
+    pimpl_->lazy_config_save_delay_ = std::min(2 * pimpl_->lazy_config_save_delay_, kMaxConfigSaveDelay);
+    log::info("Config keeps changing, saving it every {} ms", pimpl_->lazy_config_save_delay_.count());
+    pimpl_->save_window_start_ = now;
+    pimpl_->saves_in_window_ = 0;
+  }
+
+  pimpl_->bytes_written_since_report_ += bytes_written;
+  pimpl_->saves_since_report_++;
+  if (now - pimpl_->write_report_start_ >= kConfigWriteReportPeriod) {
+    log::info(
+        "Wrote {} bytes of config in {} saves over the last {} minutes",
+        pimpl_->bytes_written_since_report_,
+        pimpl_->saves_since_report_,
+        std::chrono::duration_cast<std::chrono::minutes>(now - pimpl_->write_report_start_).count());
+    pimpl_->write_report_start_ = now;
+    pimpl_->bytes_written_since_report_ = 0;
+    pimpl_->saves_since_report_ = 0;
+  }
 }
 
 void StorageModule::SaveImmediately() {
@@ -120,15 +202,40 @@ void StorageModule::SaveImmediately() {
     pimpl_->config_save_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
+  auto journal = ConfigJournal::FromPath(config_file_path_ + kConfigJournalSuffix);
+  if (pimpl_->journal_enabled_) {
+    auto changes = pimpl_->cache_.TakePersistentChanges();
+    if (changes.has_value() && changes->empty()) {
+      return;
+    }
+    size_t journal_size = journal.Size();
+    if (changes.has_value() && journal_size < kConfigJournalCompactionSize && journal.Append(*changes)) {
+      AccountSave(journal.Size() - journal_size);
+      return;
+    }
+  }
+  std::string config = pimpl_->cache_.SerializeToLegacyFormat();
 #ifndef TARGET_FLOSS
   log::assert_that(
-      LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_),
-      "assert failed: LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_)");
+      LegacyConfigFile::FromPath(config_file_path_).Write(config),
+      "assert failed: LegacyConfigFile::FromPath(config_file_path_).Write(config)");
 #else
-  if (!LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_)) {
+  if (!LegacyConfigFile::FromPath(config_file_path_).Write(config)) {
     log::error("Unable to write config file to disk");
   }
 #endif
+  AccountSave(config.size());
+  if (pimpl_->snapshot_enabled_) {
+    ConfigSnapshot::FromPath(config_file_path_ + kConfigSnapshotSuffix).Write(config, pimpl_->cache_);
+  }
+  // The journal must not be applied on top of the new config file
+  if (pimpl_->journal_enabled_ && !journal.Reset(config)) {
+    log::error("Unable to start a new config journal, saving the whole config from now on");
+    pimpl_->journal_enabled_ = false;
+  }
+  if (!pimpl_->journal_enabled_) {
+    journal.Delete();
+  }
   // save checksum if it is running in common criteria mode
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
       bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
@@ -148,16 +255,48 @@ void StorageModule::ListDependencies(ModuleList* list) const {
 
 void StorageModule::Start() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto journal = ConfigJournal::FromPath(config_file_path_ + kConfigJournalSuffix);
+  auto snapshot = ConfigSnapshot::FromPath(config_file_path_ + kConfigSnapshotSuffix);
   if (os::GetSystemProperty(kFactoryResetProperty) == "true") {
     log::info("{} is true, delete config files", kFactoryResetProperty);
     LegacyConfigFile::FromPath(config_file_path_).Delete();
+    journal.Delete();
+    snapshot.Delete();
     os::SetSystemProperty(kFactoryResetProperty, "false");
   }
   if (!is_config_checksum_pass(kConfigFileComparePass)) {
     LegacyConfigFile::FromPath(config_file_path_).Delete();
+    journal.Delete();
+    snapshot.Delete();
+  }
+  // The checksum checked in common criteria mode only covers the config file
+  bool journal_enabled = os::GetSystemPropertyBool(kConfigJournalProperty, false) &&
+                         !bluetooth::os::ParameterProvider::IsCommonCriteriaMode();
+  bool snapshot_enabled = os::GetSystemPropertyBool(kConfigSnapshotProperty, false);
+  std::optional<std::string> base;
+  if (journal_enabled || snapshot_enabled || journal.Size() > 0) {
+    base = os::ReadSmallFile(config_file_path_);
+  }
+  std::optional<ConfigCache> config;
+  if (base && snapshot_enabled) {
+    config = snapshot.Read(*base, temp_devices_capacity_);
+  }
+  if (!config) {
+    config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+    if (config && base && snapshot_enabled) {
+      snapshot.Write(*base, *config);
+    }
   }
-  auto config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
   bool save_needed = false;
+  if (config && config->HasSection(kAdapterSection)) {
+    size_t batches = base ? journal.Replay(*base, *config) : 0;
+    if (batches > 0 && !journal_enabled) {
+      // Fold the journal into the config file
+      save_needed = true;
+    } else if (batches == 0 && journal_enabled && !(base && journal.Reset(*base))) {
+      journal_enabled = false;
+    }
+  }
   if (!config || !config->HasSection(kAdapterSection)) {
     log::warn("Failed to load config at {}; creating new empty ones", config_file_path_);
     config.emplace(temp_devices_capacity_, Device::kLinkKeyProperties);
@@ -171,8 +310,16 @@ void StorageModule::Start() {
     save_needed = true;
   }
   pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_);
+  pimpl_->journal_enabled_ = journal_enabled;
+  pimpl_->snapshot_enabled_ = snapshot_enabled;
+  pimpl_->cache_.SetTrackPersistentChanges(journal_enabled);
+  pimpl_->lazy_config_save_delay_ = config_save_delay_;
+  pimpl_->save_window_start_ = std::chrono::steady_clock::now();
+  pimpl_->write_report_start_ = pimpl_->save_window_start_;
   pimpl_->cache_.SetPersistentConfigChangedCallback(
       [this] { this->CallOn(this, &StorageModule::SaveDelayed); });
+  pimpl_->cache_.SetCriticalConfigChangedCallback(
+      [this] { this->CallOn(this, &StorageModule::SaveCritical); });
 
   // Cleanup temporary pairings if we have left guest mode
   if (!is_restricted_mode_) {
@@ -234,12 +381,10 @@ Device StorageModule::GetDeviceByLeIdentityAddress(hci::Address le_identity_addr
 
 std::vector<Device> StorageModule::GetBondedDevices() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  auto persistent_sections = pimpl_->cache_.GetPersistentSections();
   std::vector<Device> result;
-  result.reserve(persistent_sections.size());
-  for (const auto& section : persistent_sections) {
+  pimpl_->cache_.ForEachPersistentSection([this, &result](const std::string& section) {
     result.emplace_back(&pimpl_->cache_, &pimpl_->memory_only_cache_, section);
-  }
+  });
   return result;
 }
 
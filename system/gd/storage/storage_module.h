@@ -125,8 +125,11 @@ class StorageModule : public bluetooth::Module {
   // For unit test only
   ConfigCache* GetMemoryOnlyConfigCache();
   // Normally, underlying config will be saved at most 3 seconds after the first config change in a series of changes
-  // This method triggers the delayed saving automatically, the delay is equal to |config_save_delay_|
+  // This method triggers the delayed saving automatically, the delay is equal to |config_save_delay_| unless the config
+  // has been saved often recently, in which case it grows up to a minute
   void SaveDelayed();
+  // Same as SaveDelayed() for bond changes, the delay is always |config_save_delay_|
+  void SaveCritical();
   // In some cases, one may want to save the config immediately to disk. Call this method with caution as it runs
   // immediately on the calling thread
   void SaveImmediately();
@@ -187,6 +190,10 @@ class StorageModule : public bluetooth::Module {
   size_t temp_devices_capacity_;
   bool is_restricted_mode_;
   bool is_single_user_mode_;
+  // Save after |delay| unless a save is already scheduled sooner
+  void ScheduleSave(std::chrono::milliseconds delay);
+  // Account a save of |bytes_written| bytes in the save rate and write statistics
+  void AccountSave(size_t bytes_written);
   static bool is_config_checksum_pass(int check_bit);
 };
 
@@ -257,6 +257,48 @@ TEST_F(StorageModuleTest, save_config_test) {
   ASSERT_TRUE(std::filesystem::exists(temp_config_));
 }
 
+TEST_F(StorageModuleTest, frequent_changes_delay_saves_but_not_bonds_test) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  // Test
+  // Save often enough for the save delay to double
+  for (int i = 0; i < 7; i++) {
+    storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, std::to_string(i));
+    ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  }
+  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(
+      config->GetProperty("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME), Optional(StrEq("6")));
+
+  // A name change is not saved after the configured delay anymore
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "foo");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay / 2));
+  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(
+      config->GetProperty("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME), Optional(StrEq("6")));
+
+  // A bond change is, and brings the pending name change along
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_LINK_KEY, "fedcba9876543210fedcba9876543210");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(
+      config->GetProperty("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME), Optional(StrEq("foo")));
+  ASSERT_THAT(
+      config->GetProperty("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_LINK_KEY),
+      Optional(StrEq("fedcba9876543210fedcba9876543210")));
+
+  // Tear down
+  test_registry_.StopAll();
+}
+
 TEST_F(StorageModuleTest, get_bonded_devices_test) {
   // Prepare config file
   ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
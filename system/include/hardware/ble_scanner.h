@@ -21,6 +21,7 @@
 #include <raw_address.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -75,6 +76,16 @@ class AdvertisingTrackInfo {
   std::vector<uint8_t> scan_response;
 };
 
+/**
+ * Layout of a scan result in the buffer of
+ * ScanningCallbacks::OnScanResultBatch. Multi-byte fields are little endian,
+ * and the address is in RawAddress byte order:
+ *   event_type (2) | addr_type (1) | bda (6) | primary_phy (1) |
+ *   secondary_phy (1) | advertising_sid (1) | tx_power (1) | rssi (1) |
+ *   periodic_adv_int (2) | adv_data_len (2) | adv_data (adv_data_len)
+ */
+constexpr size_t kScanResultBatchHeaderSize = 18;
+
 /**
  * LE Scanning related callbacks invoked from from the Bluetooth native stack
  * All callbacks are invoked on the JNI thread
@@ -92,6 +103,38 @@ class ScanningCallbacks {
                             int8_t tx_power, int8_t rssi,
                             uint16_t periodic_adv_int,
                             std::vector<uint8_t> adv_data) = 0;
+
+  /**
+   * Invoked instead of OnScanResult when scan result batching is enabled,
+   * with |num_results| scan results packed in |packed_results|.
+   * The default implementation unpacks the results to OnScanResult.
+   */
+  virtual void OnScanResultBatch(int num_results,
+                                 std::vector<uint8_t> packed_results) {
+    const uint8_t* p = packed_results.data();
+    const uint8_t* end = p + packed_results.size();
+    for (int i = 0; i < num_results; i++) {
+      if ((size_t)(end - p) < kScanResultBatchHeaderSize) return;
+      uint16_t event_type = p[0] | (p[1] << 8);
+      uint8_t addr_type = p[2];
+      RawAddress bda;
+      std::copy(p + 3, p + 9, bda.address);
+      uint8_t primary_phy = p[9];
+      uint8_t secondary_phy = p[10];
+      uint8_t advertising_sid = p[11];
+      int8_t tx_power = (int8_t)p[12];
+      int8_t rssi = (int8_t)p[13];
+      uint16_t periodic_adv_int = p[14] | (p[15] << 8);
+      size_t adv_data_len = p[16] | (p[17] << 8);
+      p += kScanResultBatchHeaderSize;
+      if ((size_t)(end - p) < adv_data_len) return;
+      OnScanResult(event_type, addr_type, bda, primary_phy, secondary_phy,
+                   advertising_sid, tx_power, rssi, periodic_adv_int,
+                   std::vector<uint8_t>(p, p + adv_data_len));
+      p += adv_data_len;
+    }
+  }
+
   virtual void OnTrackAdvFoundLost(
       AdvertisingTrackInfo advertising_track_info) = 0;
   virtual void OnBatchScanReports(int client_if, int status, int report_format,
@@ -518,6 +518,15 @@ typedef void (*remote_device_properties_callback)(bt_status_t status,
                                                   int num_properties,
                                                   bt_property_t* properties);
 
+/** Batched Remote Device Properties callback */
+/** Successful property updates for |num_devices| devices, in the order they
+ * were reported. |properties| holds the properties of all devices back to
+ * back, |num_properties[i]| of them for |bd_addrs[i]|. Only called when set,
+ * otherwise each update goes to remote_device_properties_cb. */
+typedef void (*remote_device_properties_batch_callback)(
+    int num_devices, RawAddress* bd_addrs, int* num_properties,
+    bt_property_t* properties);
+
 /** New device discovered callback */
 /** If EIR data is not present, then BD_NAME and RSSI shall be NULL and -1
  * respectively */
@@ -644,6 +653,7 @@ typedef struct {
   switch_codec_callback switch_codec_cb;
   le_rand_callback le_rand_cb;
   key_missing_callback key_missing_cb;
+  remote_device_properties_batch_callback remote_device_properties_batch_cb;
 } bt_callbacks_t;
 
 typedef int (*acquire_wake_lock_callout)(const char* lock_name);
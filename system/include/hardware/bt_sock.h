@@ -30,6 +30,8 @@ __BEGIN_DECLS
 #define BTSOCK_FLAG_AUTH_MITM (1 << 3)
 #define BTSOCK_FLAG_AUTH_16_DIGIT (1 << 4)
 #define BTSOCK_FLAG_LE_COC (1 << 5)
+/* Classic L2CAP socket carrying bulk transfers, e.g. OBEX file push */
+#define BTSOCK_FLAG_L2CAP_BULK (1 << 6)
 
 typedef enum {
   BTSOCK_RFCOMM = 1,
@@ -58,6 +60,21 @@ typedef struct {
   uint64_t conn_uuid_msb;
 } __attribute__((packed)) sock_connect_signal_t;
 
+/** Transmit state of a connected socket, for the apps sizing their writes. */
+typedef struct {
+  // Writes of this size fill the outgoing packets: larger writes are split,
+  // and smaller ones leave room unused.
+  unsigned short optimal_write_size;
+
+  // Packets the peer does not yet allow to be sent are held back. This is the
+  // number of packets it allows, as of the last write or congestion change.
+  // (L2CAP LE only)
+  unsigned short tx_credits;
+
+  // The app writes are not being read until the congestion clears.
+  bool congested;
+} btsock_tx_info_t;
+
 typedef struct {
   /** set to size of this struct*/
   size_t size;
@@ -122,6 +139,12 @@ typedef struct {
   bt_status_t (*get_l2cap_remote_cid)(bluetooth::Uuid& conn_uuid,
                                       uint16_t* cid);
 
+  /**
+   * Get L2CAP transmit state with the associated connection uuid.
+   */
+  bt_status_t (*get_l2cap_tx_info)(bluetooth::Uuid& conn_uuid,
+                                   btsock_tx_info_t* info);
+
 } btsock_interface_t;
 
 __END_DECLS
@@ -24,6 +24,15 @@
 #define LOG_TAG "bluetooth"
 #endif  // LOG_TAG
 
+// Logs below this level compile to nothing, arguments formatting included.
+// Like LOG_TAG, it can be defined before including this header, to take the
+// verbose logs out of a hot path:
+//
+//   #define LOG_MIN_LEVEL kInfo
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL kVerbose
+#endif  // LOG_MIN_LEVEL
+
 namespace bluetooth::log_internal {
 
 /// Android framework log priority levels.
@@ -82,10 +91,13 @@ char*& format_replace(char*& arg) {
 
 template <Level level, typename... T>
 struct log {
-  log(fmt::format_string<T...> fmt, T&&... args,
-      source_location location = source_location()) {
-    vlog(level, LOG_TAG, location, static_cast<fmt::string_view>(fmt),
-         fmt::make_format_args(format_replace(args)...));
+  log([[maybe_unused]] fmt::format_string<T...> fmt,
+      [[maybe_unused]] T&&... args,
+      [[maybe_unused]] source_location location = source_location()) {
+    if constexpr (level >= LOG_MIN_LEVEL) {
+      vlog(level, LOG_TAG, location, static_cast<fmt::string_view>(fmt),
+           fmt::make_format_args(format_replace(args)...));
+    }
   }
 };
 
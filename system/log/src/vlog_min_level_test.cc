@@ -0,0 +1,47 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "test"
+#define LOG_MIN_LEVEL kInfo
+
+#include <gtest/gtest.h>
+
+#include "bluetooth/log.h"
+
+/// Counts the times it is formatted.
+struct Formatted {
+  int* count;
+};
+
+template <>
+struct fmt::formatter<Formatted> : fmt::formatter<int> {
+  auto format(const Formatted& formatted, fmt::format_context& ctx) const {
+    return fmt::formatter<int>::format(++*formatted.count, ctx);
+  }
+};
+
+using namespace bluetooth;
+
+TEST(BluetoothLogMinLevelTest, logs_below_min_level_are_not_formatted) {
+  int count = 0;
+
+  log::verbose("verbose test {}", Formatted{&count});
+  log::debug("debug test {}", Formatted{&count});
+  EXPECT_EQ(count, 0);
+
+  log::info("info test {}", Formatted{&count});
+  EXPECT_EQ(count, 1);
+}
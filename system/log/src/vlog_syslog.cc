@@ -34,7 +34,7 @@ std::unordered_map<std::string, Level>& GetTagMap() {
 Level gDefaultLogLevel = Level::kInfo;
 
 Level GetLogLevelForTag(char const* tag) {
-  auto tag_map = GetTagMap();
+  auto& tag_map = GetTagMap();
   auto find = tag_map.find(tag);
   if (find != tag_map.end()) {
     return find->second;
@@ -23,16 +23,21 @@
 
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/interfaces/ILoggable.h"
+#include "common/latency_trace.h"
 #include "common/strings.h"
 #include "common/sync_map_count.h"
 #include "hci/acl_manager.h"
@@ -52,6 +57,7 @@
 #include "main/shim/stack.h"
 #include "os/handler.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/acl/acl.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/btm/btm_sec_cb.h"
@@ -349,6 +355,119 @@ class FixedQueue {
 
 constexpr size_t kConnectionHistorySize = 40;
 
+/* Sysprop enabling the fast reconnect path for classic links */
+constexpr char kPropertyFastReconnect[] =
+    "bluetooth.core.classic.fast_reconnect.enabled";
+constexpr size_t kRemoteFeaturesCacheSize = 32;
+
+/* Remote LMP feature pages read on earlier classic connections in this
+ * session. Features only change with a remote firmware update, which also
+ * takes the link down, so pages of a reconnecting device are replayed
+ * instead of read again when fast reconnect is enabled. */
+class RemoteFeaturesCache {
+ public:
+  struct Entry {
+    /* Page 0 from Read Remote Supported Features, then extended pages */
+    std::vector<uint64_t> pages;
+    uint8_t max_page_number{0};
+  };
+
+  std::optional<Entry> Get(const hci::Address& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(address);
+    if (it == entries_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  void Put(const hci::Address& address, Entry entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= kRemoteFeaturesCacheSize &&
+        entries_.find(address) == entries_.end()) {
+      entries_.erase(entries_.begin());
+    }
+    entries_[address] = std::move(entry);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<hci::Address, Entry> entries_;
+};
+
+RemoteFeaturesCache remote_features_cache_;
+
+bool IsFastReconnectEnabled() {
+  static const bool enabled =
+      osi_property_get_bool(kPropertyFastReconnect, false);
+  return enabled;
+}
+
+/* Time spent in each phase of bringing up a classic link */
+struct ClassicLinkSetupTiming {
+  hci::Address address;
+  bool locally_initiated;
+  std::optional<std::chrono::milliseconds> page;
+  std::optional<std::chrono::milliseconds> features;
+  bool features_cached{false};
+  std::optional<std::chrono::milliseconds> encryption;
+
+  std::string ToString() const {
+    auto text = [](const std::optional<std::chrono::milliseconds>& phase) {
+      return phase.has_value() ? std::to_string(phase->count()) + "ms"
+                               : std::string("-");
+    };
+    return base::StringPrintf(
+        "peer:%s initiator:%s page:%s features:%s%s encryption:%s",
+        ADDRESS_TO_LOGGABLE_CSTR(address),
+        locally_initiated ? "local" : "remote",
+        text(page).c_str(), text(features).c_str(),
+        features_cached ? "(cached)" : "", text(encryption).c_str());
+  }
+};
+
+/* Start of outgoing classic pages, and the setup timing of recent links */
+class ClassicLinkSetupHistory {
+ public:
+  void OnPageStarted(const hci::Address& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    page_started_[address] = std::chrono::steady_clock::now();
+  }
+
+  std::optional<std::chrono::milliseconds> TakePageDuration(
+      const hci::Address& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = page_started_.find(address);
+    if (it == page_started_.end()) return std::nullopt;
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - it->second);
+    page_started_.erase(it);
+    return duration;
+  }
+
+  void OnPageEnded(const hci::Address& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    page_started_.erase(address);
+  }
+
+  void Push(const ClassicLinkSetupTiming& timing) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (history_.size() == kConnectionHistorySize) history_.pop_front();
+    history_.push_back(timing.ToString());
+  }
+
+  std::vector<std::string> Read() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::string>(history_.begin(), history_.end());
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<hci::Address, std::chrono::steady_clock::time_point>
+      page_started_;
+  std::deque<std::string> history_;
+};
+
+ClassicLinkSetupHistory classic_link_setup_history_;
+
 inline uint8_t LowByte(uint16_t val) { return val & 0xff; }
 inline uint8_t HighByte(uint16_t val) { return val >> 8; }
 
@@ -428,12 +547,14 @@ class ShimAclConnection {
     if (queue_.empty()) {
       UnregisterEnqueue();
     }
+    BT_TRACE_LATENCY(SHIM_ACL_TX, handle_, packet->size());
     return packet;
   }
 
   void data_ready_callback() {
     auto packet = queue_up_end_->TryDequeue();
     uint16_t length = packet->size();
+    BT_TRACE_LATENCY(SHIM_ACL_RX, handle_, length);
     std::vector<uint8_t> preamble;
     preamble.push_back(LowByte(handle_));
     preamble.push_back(HighByte(handle_));
@@ -540,9 +661,33 @@ class ClassicShimAclConnection
 
   void ReadRemoteControllerInformation() override {
     connection_->ReadRemoteVersionInformation();
+
+    if (IsFastReconnectEnabled()) {
+      auto cached = remote_features_cache_.Get(connection_->GetAddress());
+      if (cached.has_value() && !cached->pages.empty()) {
+        log::debug("Using cached remote features for:{}",
+                   connection_->GetAddress());
+        setup_timing_.features_cached = true;
+        TRY_POSTING_ON_MAIN(
+            interface_.on_read_remote_supported_features_complete, handle_,
+            cached->pages[0]);
+        for (size_t page = 1; page < cached->pages.size(); page++) {
+          TRY_POSTING_ON_MAIN(
+              interface_.on_read_remote_extended_features_complete, handle_,
+              static_cast<uint8_t>(page), cached->max_page_number,
+              cached->pages[page]);
+        }
+        OnRemoteFeaturesComplete();
+        return;
+      }
+    }
     connection_->ReadRemoteSupportedFeatures();
   }
 
+  void SetSetupTiming(ClassicLinkSetupTiming timing) {
+    setup_timing_ = std::move(timing);
+  }
+
   void OnConnectionPacketTypeChanged(uint16_t packet_type) override {
     TRY_POSTING_ON_MAIN(interface_.on_packet_type_changed, packet_type);
   }
@@ -556,6 +701,11 @@ class ClassicShimAclConnection
     bool is_enabled = (enabled == hci::EncryptionEnabled::ON ||
                        enabled == hci::EncryptionEnabled::BR_EDR_AES_CCM);
     TRY_POSTING_ON_MAIN(interface_.on_encryption_change, is_enabled);
+
+    if (is_enabled && !setup_timing_.encryption.has_value()) {
+      setup_timing_.encryption = SinceConnected();
+      RecordSetupTiming();
+    }
   }
 
   void OnChangeConnectionLinkKeyComplete() override {
@@ -665,6 +815,7 @@ class ClassicShimAclConnection
   }
 
   void OnDisconnection(hci::ErrorCode reason) override {
+    RecordSetupTiming();
     Disconnect();
     on_disconnect_(handle_, reason);
   }
@@ -681,12 +832,14 @@ class ClassicShimAclConnection
   void OnReadRemoteSupportedFeaturesComplete(uint64_t features) override {
     TRY_POSTING_ON_MAIN(interface_.on_read_remote_supported_features_complete,
                         handle_, features);
+    feature_pages_.pages = {features};
 
     if (features & ((uint64_t(1) << 63))) {
       connection_->ReadRemoteExtendedFeatures(1);
       return;
     }
     log::debug("Device does not support extended features");
+    CacheRemoteFeatures();
   }
 
   void OnReadRemoteExtendedFeaturesComplete(uint8_t page_number,
@@ -694,6 +847,10 @@ class ClassicShimAclConnection
                                             uint64_t features) override {
     TRY_POSTING_ON_MAIN(interface_.on_read_remote_extended_features_complete,
                         handle_, page_number, max_page_number, features);
+    if (page_number != 0 && page_number == feature_pages_.pages.size()) {
+      feature_pages_.pages.push_back(features);
+      feature_pages_.max_page_number = max_page_number;
+    }
 
     // Supported features aliases to extended features page 0
     if (page_number == 0 && !(features & ((uint64_t(1) << 63)))) {
@@ -701,8 +858,11 @@ class ClassicShimAclConnection
       return;
     }
 
-    if (max_page_number != 0 && page_number != max_page_number)
+    if (max_page_number != 0 && page_number != max_page_number) {
       connection_->ReadRemoteExtendedFeatures(page_number + 1);
+      return;
+    }
+    CacheRemoteFeatures();
   }
 
   hci::Address GetRemoteAddress() const { return connection_->GetAddress(); }
@@ -711,6 +871,37 @@ class ClassicShimAclConnection
     connection_->Disconnect(reason);
   }
 
+ private:
+  std::chrono::milliseconds SinceConnected() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - connected_);
+  }
+
+  void OnRemoteFeaturesComplete() {
+    if (!setup_timing_.features.has_value()) {
+      setup_timing_.features = SinceConnected();
+    }
+  }
+
+  void CacheRemoteFeatures() {
+    OnRemoteFeaturesComplete();
+    if (feature_pages_.pages.empty()) return;
+    remote_features_cache_.Put(connection_->GetAddress(), feature_pages_);
+  }
+
+  void RecordSetupTiming() {
+    if (setup_timing_recorded_) return;
+    setup_timing_recorded_ = true;
+    classic_link_setup_history_.Push(setup_timing_);
+  }
+
+  const std::chrono::steady_clock::time_point connected_ =
+      std::chrono::steady_clock::now();
+  RemoteFeaturesCache::Entry feature_pages_;
+  ClassicLinkSetupTiming setup_timing_;
+  bool setup_timing_recorded_{false};
+
+ public:
   void HoldMode(uint16_t max_interval, uint16_t min_interval) {
     log::assert_that(
         connection_->HoldMode(max_interval, min_interval),
@@ -1250,6 +1441,12 @@ struct shim::legacy::Acl::impl {
         LOG_DUMPSYS(fd, "  %s:%zu", item.item.c_str(), item.count);
       }
     }
+    const auto setup_history = classic_link_setup_history_.Read();
+    LOG_DUMPSYS(fd, "Classic link setup timing fast_reconnect:%s",
+                IsFastReconnectEnabled() ? "enabled" : "disabled");
+    for (const auto& entry : setup_history) {
+      LOG_DUMPSYS(fd, "  %s", entry.c_str());
+    }
 
     auto acceptlist = shadow_acceptlist_.GetCopy();
     LOG_DUMPSYS(fd,
@@ -1358,6 +1555,12 @@ void DumpsysRecord(int fd) {
     return;
   }
 
+  LOG_DUMPSYS(fd, "Records active:%zu max:%d evictions:%llu bonded:%llu",
+              list_length(btm_sec_cb.sec_dev_rec), BTM_SEC_MAX_DEVICE_RECORDS,
+              static_cast<unsigned long long>(btm_sec_cb.dev_rec_evictions),
+              static_cast<unsigned long long>(
+                  btm_sec_cb.bonded_dev_rec_evictions));
+
   unsigned cnt = 0;
   list_node_t* end = list_end(btm_sec_cb.sec_dev_rec);
   for (list_node_t* node = list_begin(btm_sec_cb.sec_dev_rec); node != end;
@@ -1504,6 +1707,7 @@ void shim::legacy::Acl::Flush(HciHandle handle) {
 }
 
 void shim::legacy::Acl::CreateClassicConnection(const hci::Address& address) {
+  classic_link_setup_history_.OnPageStarted(address);
   GetAclManager()->CreateConnection(address);
   log::debug("Connection initiated for classic to remote:{}", address);
   BTM_LogHistory(kBtmLogTag, ToRawAddress(address), "Initiated connection",
@@ -1511,6 +1715,7 @@ void shim::legacy::Acl::CreateClassicConnection(const hci::Address& address) {
 }
 
 void shim::legacy::Acl::CancelClassicConnection(const hci::Address& address) {
+  classic_link_setup_history_.OnPageEnded(address);
   GetAclManager()->CancelConnect(address);
   log::debug("Connection cancelled for classic to remote:{}", address);
   BTM_LogHistory(kBtmLogTag, ToRawAddress(address), "Cancelled connection",
@@ -1562,15 +1767,12 @@ bluetooth::hci::AddressWithType shim::legacy::Acl::GetConnectionLocalAddress(
     uint16_t handle, bool ota_address) {
   bluetooth::hci::AddressWithType address_with_type;
 
-  for (auto& [acl_handle, connection] : pimpl_->handle_to_le_connection_map_) {
-    if (acl_handle != handle) {
-      continue;
-    }
-
+  auto connection = pimpl_->handle_to_le_connection_map_.find(handle);
+  if (connection != pimpl_->handle_to_le_connection_map_.end()) {
     if (ota_address) {
-      return connection->GetLocalOtaAddressWithType();
+      return connection->second->GetLocalOtaAddressWithType();
     }
-    return connection->GetLocalAddressWithType();
+    return connection->second->GetLocalAddressWithType();
   }
   log::warn("address not found!");
   return address_with_type;
@@ -1579,15 +1781,12 @@ bluetooth::hci::AddressWithType shim::legacy::Acl::GetConnectionLocalAddress(
 bluetooth::hci::AddressWithType shim::legacy::Acl::GetConnectionPeerAddress(
     uint16_t handle, bool ota_address) {
   bluetooth::hci::AddressWithType address_with_type;
-  for (auto& [acl_handle, connection] : pimpl_->handle_to_le_connection_map_) {
-    if (acl_handle != handle) {
-      continue;
-    }
-
+  auto connection = pimpl_->handle_to_le_connection_map_.find(handle);
+  if (connection != pimpl_->handle_to_le_connection_map_.end()) {
     if (ota_address) {
-      return connection->GetPeerOtaAddressWithType();
+      return connection->second->GetPeerOtaAddressWithType();
     }
-    return connection->GetPeerAddressWithType();
+    return connection->second->GetPeerAddressWithType();
   }
   log::warn("address not found!");
   return address_with_type;
@@ -1647,12 +1846,19 @@ void shim::legacy::Acl::OnConnectSuccess(
                             std::placeholders::_1, std::placeholders::_2),
                   acl_interface_.link.classic, handler_, std::move(connection),
                   std::chrono::system_clock::now()));
+  pimpl_->handle_to_classic_connection_map_[handle]->SetSetupTiming({
+      .address = remote_address,
+      .locally_initiated = locally_initiated,
+      .page = classic_link_setup_history_.TakePageDuration(remote_address),
+  });
   pimpl_->handle_to_classic_connection_map_[handle]->RegisterCallbacks();
-  pimpl_->handle_to_classic_connection_map_[handle]
-      ->ReadRemoteControllerInformation();
 
   TRY_POSTING_ON_MAIN(acl_interface_.connection.classic.on_connected, bd_addr,
                       handle, false, locally_initiated);
+  // Cached remote features are posted right away, so they must follow the
+  // connection event
+  pimpl_->handle_to_classic_connection_map_[handle]
+      ->ReadRemoteControllerInformation();
   log::debug("Connection successful classic remote:{} handle:{} initiator:{}",
              remote_address, handle, (locally_initiated) ? "local" : "remote");
   BTM_LogHistory(kBtmLogTag, ToRawAddress(remote_address),
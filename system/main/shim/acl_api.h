@@ -36,6 +36,8 @@ void ACL_IgnoreLeConnectionFrom(const tBLE_BD_ADDR& legacy_address_with_type);
 void ACL_Disconnect(uint16_t handle, bool is_classic, tHCI_STATUS reason,
                     std::string comment);
 void ACL_WriteData(uint16_t handle, BT_HDR* p_buf);
+// Same as ACL_WriteData() for a buffer that stays owned by the caller
+void ACL_WriteRetainedData(uint16_t handle, const BT_HDR* p_buf);
 void ACL_Flush(uint16_t handle);
 void ACL_ConfigureLePrivacy(bool is_le_privacy_enabled);
 void ACL_Shutdown();
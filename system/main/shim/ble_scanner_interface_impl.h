@@ -19,12 +19,15 @@
  */
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <queue>
 #include <set>
 #include <vector>
 
 #include "hci/le_scanning_callback.h"
 #include "include/hardware/ble_scanner.h"
+#include "os/alarm.h"
 #include "types/ble_address_with_type.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
@@ -153,6 +156,24 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
       ApcfCommand apcf_command);
   void handle_remote_properties(RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
                                 std::vector<uint8_t> advertising_data);
+  void append_to_scan_result_batch(
+      uint16_t event_type, uint8_t address_type, const RawAddress& raw_address,
+      tBLE_ADDR_TYPE ble_addr_type, uint8_t primary_phy, uint8_t secondary_phy,
+      uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+      uint16_t periodic_advertising_interval,
+      const std::vector<uint8_t>& advertising_data);
+  void flush_scan_result_batch();
+  void deliver_scan_result_batch(std::vector<uint8_t> packed_results,
+                                 std::vector<tBLE_ADDR_TYPE> ble_addr_types);
+
+  // Scan results are packed and handed to the JNI thread in batches when
+  // the batch window is not zero. Only accessed on the gd stack thread.
+  std::chrono::milliseconds scan_result_batch_window_{0};
+  size_t scan_result_batch_max_results_{0};
+  std::vector<uint8_t> scan_result_batch_;
+  // Address type of each batched result, after address resolution.
+  std::vector<tBLE_ADDR_TYPE> scan_result_batch_addr_types_;
+  std::unique_ptr<os::Alarm> scan_result_batch_alarm_;
 
   class AddressCache {
    public:
@@ -122,6 +122,10 @@ bool BtifConfigInterface::GetBin(const std::string& section,
   std::memcpy(value, value_vec->data(), *length);
   return true;
 }
+std::optional<std::vector<uint8_t>> BtifConfigInterface::GetBin(
+    const std::string& section, const std::string& property) {
+  return GetStorage()->GetBin(section, property);
+}
 size_t BtifConfigInterface::GetBinLength(const std::string& section,
                                          const std::string& property) {
   auto value_vec = GetStorage()->GetBin(section, property);
@@ -46,6 +46,8 @@ class BtifConfigInterface {
                      const std::string& value);
   static bool GetBin(const std::string& section, const std::string& key,
                      uint8_t* value, size_t* length);
+  static std::optional<std::vector<uint8_t>> GetBin(const std::string& section,
+                                                    const std::string& key);
   static size_t GetBinLength(const std::string& section,
                              const std::string& key);
   static bool SetBin(const std::string& section, const std::string& key,
@@ -119,13 +119,9 @@ static bluetooth::os::EnqueueBuffer<bluetooth::hci::IsoBuilder>*
 
 static std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
-
-  return payload;
+  // Copy the payload once, straight into the builder
+  return std::make_unique<bluetooth::packet::RawBuilder>(
+      std::vector<uint8_t>(data, data + len));
 }
 
 static BT_HDR* WrapPacketAndCopy(
@@ -23,7 +23,10 @@
 #include <bluetooth/log.h>
 #include <hardware/bluetooth.h>
 
+#include <algorithm>
+
 #include "btif/include/btif_common.h"
+#include "common/bind.h"
 #include "hci/address.h"
 #include "hci/le_scanning_manager.h"
 #if TARGET_FLOSS
@@ -36,6 +39,7 @@
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
 #include "os/log.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/advertise_data_parser.h"
 #include "stack/include/bt_dev_class.h"
@@ -64,6 +68,15 @@ constexpr uint8_t kLowestRssiValue = 129;
 constexpr uint16_t kAllowAllFilter = 0x00;
 constexpr uint16_t kListLogicOr = 0x01;
 
+// Deliver scan results to the JNI thread in batches collected over this
+// window. Zero disables batching.
+constexpr char kPropertyScanResultBatchWindowMs[] =
+    "bluetooth.le_scanning.batch.window_ms";
+// Deliver a batch early once it holds this many scan results.
+constexpr char kPropertyScanResultBatchMaxResults[] =
+    "bluetooth.le_scanning.batch.max_results";
+constexpr int kDefaultScanResultBatchMaxResults = 32;
+
 class DefaultScanningCallback : public ::ScanningCallbacks {
   void OnScannerRegistered(const bluetooth::Uuid /* app_uuid */,
                            uint8_t /* scanner_id */,
@@ -144,8 +157,7 @@ extern void btif_dm_update_ble_remote_properties(const RawAddress& bd_addr,
 void btm_ble_process_adv_addr(RawAddress& raw_address,
                               tBLE_ADDR_TYPE* address_type);
 
-extern DEV_CLASS btm_ble_get_appearance_as_cod(
-    std::vector<uint8_t> const& data);
+extern DEV_CLASS btm_ble_get_appearance_as_cod(const AdvertiseDataIndex& data);
 
 using bluetooth::shim::BleScannerInterfaceImpl;
 
@@ -153,9 +165,24 @@ void BleScannerInterfaceImpl::Init() {
   log::info("init BleScannerInterfaceImpl");
   bluetooth::shim::GetScanning()->RegisterScanningCallback(this);
 
+  scan_result_batch_window_ = std::chrono::milliseconds(
+      std::max(0, osi_property_get_int32(kPropertyScanResultBatchWindowMs, 0)));
+  scan_result_batch_max_results_ = std::max(
+      1, osi_property_get_int32(kPropertyScanResultBatchMaxResults,
+                                kDefaultScanResultBatchMaxResults));
+  if (scan_result_batch_window_.count() != 0) {
+    log::info("Batching scan results over {} ms, up to {} results",
+              scan_result_batch_window_.count(),
+              scan_result_batch_max_results_);
+    scan_result_batch_alarm_ =
+        std::make_unique<os::Alarm>(bluetooth::shim::GetGdShimHandler());
+  }
+
 #if TARGET_FLOSS
   if (bluetooth::shim::GetMsftExtensionManager()) {
     bluetooth::shim::GetMsftExtensionManager()->SetScanningCallback(this);
+    bluetooth::shim::GetScanning()->SetMsftExtensionManager(
+        bluetooth::shim::GetMsftExtensionManager());
   }
 #endif
 }
@@ -202,6 +229,12 @@ void BleScannerInterfaceImpl::Scan(bool start) {
     return;
   }
 
+  if (!start && scan_result_batch_alarm_ != nullptr) {
+    bluetooth::shim::GetGdShimHandler()->Post(
+        common::BindOnce(&BleScannerInterfaceImpl::flush_scan_result_batch,
+                         common::Unretained(this)));
+  }
+
   do_in_jni_thread(base::BindOnce(&BleScannerInterfaceImpl::AddressCache::init,
                                   base::Unretained(&address_cache_)));
 }
@@ -528,15 +561,23 @@ void BleScannerInterfaceImpl::OnScanResult(
     btm_ble_process_adv_addr(raw_address, &ble_addr_type);
   }
 
-  do_in_jni_thread(base::BindOnce(
-      &BleScannerInterfaceImpl::handle_remote_properties,
-      base::Unretained(this), raw_address, ble_addr_type, advertising_data));
-
-  do_in_jni_thread(base::BindOnce(
-      &ScanningCallbacks::OnScanResult, base::Unretained(scanning_callbacks_),
-      event_type, static_cast<uint8_t>(address_type), raw_address, primary_phy,
-      secondary_phy, advertising_sid, tx_power, rssi,
-      periodic_advertising_interval, advertising_data));
+  if (scan_result_batch_window_.count() != 0) {
+    append_to_scan_result_batch(event_type, address_type, raw_address,
+                                ble_addr_type, primary_phy, secondary_phy,
+                                advertising_sid, tx_power, rssi,
+                                periodic_advertising_interval,
+                                advertising_data);
+  } else {
+    do_in_jni_thread(base::BindOnce(
+        &BleScannerInterfaceImpl::handle_remote_properties,
+        base::Unretained(this), raw_address, ble_addr_type, advertising_data));
+
+    do_in_jni_thread(base::BindOnce(
+        &ScanningCallbacks::OnScanResult, base::Unretained(scanning_callbacks_),
+        event_type, static_cast<uint8_t>(address_type), raw_address,
+        primary_phy, secondary_phy, advertising_sid, tx_power, rssi,
+        periodic_advertising_interval, advertising_data));
+  }
 
   // TODO: Remove when StartInquiry in GD part implemented
   btm_ble_process_adv_pkt_cont_for_inquiry(
@@ -545,6 +586,83 @@ void BleScannerInterfaceImpl::OnScanResult(
       advertising_data);
 }
 
+void BleScannerInterfaceImpl::append_to_scan_result_batch(
+    uint16_t event_type, uint8_t address_type, const RawAddress& raw_address,
+    tBLE_ADDR_TYPE ble_addr_type, uint8_t primary_phy, uint8_t secondary_phy,
+    uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+    uint16_t periodic_advertising_interval,
+    const std::vector<uint8_t>& advertising_data) {
+  uint16_t adv_data_len = advertising_data.size();
+  const uint8_t header[kScanResultBatchHeaderSize] = {
+      (uint8_t)event_type,
+      (uint8_t)(event_type >> 8),
+      address_type,
+      raw_address.address[0],
+      raw_address.address[1],
+      raw_address.address[2],
+      raw_address.address[3],
+      raw_address.address[4],
+      raw_address.address[5],
+      primary_phy,
+      secondary_phy,
+      advertising_sid,
+      (uint8_t)tx_power,
+      (uint8_t)rssi,
+      (uint8_t)periodic_advertising_interval,
+      (uint8_t)(periodic_advertising_interval >> 8),
+      (uint8_t)adv_data_len,
+      (uint8_t)(adv_data_len >> 8),
+  };
+  scan_result_batch_.insert(scan_result_batch_.end(), header,
+                            header + kScanResultBatchHeaderSize);
+  scan_result_batch_.insert(scan_result_batch_.end(), advertising_data.begin(),
+                            advertising_data.end());
+  scan_result_batch_addr_types_.push_back(ble_addr_type);
+
+  if (scan_result_batch_addr_types_.size() >= scan_result_batch_max_results_) {
+    flush_scan_result_batch();
+  } else if (scan_result_batch_addr_types_.size() == 1) {
+    scan_result_batch_alarm_->Schedule(
+        common::BindOnce(&BleScannerInterfaceImpl::flush_scan_result_batch,
+                         common::Unretained(this)),
+        scan_result_batch_window_);
+  }
+}
+
+void BleScannerInterfaceImpl::flush_scan_result_batch() {
+  scan_result_batch_alarm_->Cancel();
+  if (scan_result_batch_addr_types_.empty()) {
+    return;
+  }
+
+  do_in_jni_thread(
+      base::BindOnce(&BleScannerInterfaceImpl::deliver_scan_result_batch,
+                     base::Unretained(this), std::move(scan_result_batch_),
+                     std::move(scan_result_batch_addr_types_)));
+  scan_result_batch_.clear();
+  scan_result_batch_addr_types_.clear();
+}
+
+void BleScannerInterfaceImpl::deliver_scan_result_batch(
+    std::vector<uint8_t> packed_results,
+    std::vector<tBLE_ADDR_TYPE> ble_addr_types) {
+  // Update the remote device properties from each result, as is done for
+  // results delivered one by one.
+  const uint8_t* p = packed_results.data();
+  for (tBLE_ADDR_TYPE ble_addr_type : ble_addr_types) {
+    RawAddress raw_address;
+    std::copy(p + 3, p + 9, raw_address.address);
+    size_t adv_data_len = p[16] | (p[17] << 8);
+    p += kScanResultBatchHeaderSize;
+    handle_remote_properties(raw_address, ble_addr_type,
+                             std::vector<uint8_t>(p, p + adv_data_len));
+    p += adv_data_len;
+  }
+
+  scanning_callbacks_->OnScanResultBatch(ble_addr_types.size(),
+                                         std::move(packed_results));
+}
+
 void BleScannerInterfaceImpl::OnTrackAdvFoundLost(
     bluetooth::hci::AdvertisingFilterOnFoundOnLostInfo on_found_on_lost_info) {
   AdvertisingTrackInfo track_info = {};
@@ -751,10 +869,13 @@ void BleScannerInterfaceImpl::handle_remote_properties(
     return;
   }
 
+  /* Index the fields once for all the lookups done on this report */
+  const AdvertiseDataIndex ad_index(advertising_data);
+
   auto device_type = bluetooth::hci::DeviceType::LE;
   uint8_t flag_len;
-  const uint8_t* p_flag = AdvertiseDataParser::GetFieldByType(
-      advertising_data, BTM_BLE_AD_TYPE_FLAG, &flag_len);
+  const uint8_t* p_flag =
+      ad_index.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &flag_len);
 
   if (p_flag != NULL && flag_len != 0) {
     if ((BTM_BLE_BREDR_NOT_SPT & *p_flag) == 0) {
@@ -763,12 +884,12 @@ void BleScannerInterfaceImpl::handle_remote_properties(
   }
 
   uint8_t remote_name_len;
-  const uint8_t* p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-      advertising_data, HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
+  const uint8_t* p_eir_remote_name = ad_index.GetFieldByType(
+      HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
 
   if (p_eir_remote_name == NULL) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        advertising_data, HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
+    p_eir_remote_name = ad_index.GetFieldByType(
+        HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
   }
 
   bt_bdname_t bdname = {0};
@@ -794,7 +915,7 @@ void BleScannerInterfaceImpl::handle_remote_properties(
     }
   }
 
-  DEV_CLASS dev_class = btm_ble_get_appearance_as_cod(advertising_data);
+  DEV_CLASS dev_class = btm_ble_get_appearance_as_cod(ad_index);
   if (dev_class != kDevClassUnclassified) {
     btif_dm_update_ble_remote_properties(bd_addr, bdname.name, dev_class,
                                          device_type);
@@ -646,6 +646,59 @@ TEST_F(MainShimTest, DISABLED_BleScannerInterfaceImpl_OnScanResult) {
   run_all_jni_thread_task();
 }
 
+TEST_F(MainShimTest, ScanningCallbacks_OnScanResultBatch) {
+  class RecordingScanningCallbacks : public TestScanningCallbacks {
+   public:
+    void OnScanResult(uint16_t event_type, uint8_t addr_type, RawAddress bda,
+                      uint8_t primary_phy, uint8_t secondary_phy,
+                      uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+                      uint16_t periodic_adv_int,
+                      std::vector<uint8_t> adv_data) override {
+      event_types.push_back(event_type);
+      addresses.push_back(bda);
+      rssis.push_back(rssi);
+      periodic_adv_ints.push_back(periodic_adv_int);
+      adv_datas.push_back(adv_data);
+    }
+    std::vector<uint16_t> event_types;
+    std::vector<RawAddress> addresses;
+    std::vector<int8_t> rssis;
+    std::vector<uint16_t> periodic_adv_ints;
+    std::vector<std::vector<uint8_t>> adv_datas;
+  } cb;
+
+  std::vector<uint8_t> packed_results = {
+      // event_type, addr_type, bda
+      0x13, 0x00, 0x01, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66,
+      // phys, sid, tx_power, rssi, periodic_adv_int
+      0x01, 0x00, 0xff, 0x7f, 0xc4, 0x00, 0x00,
+      // adv_data_len, adv_data
+      0x03, 0x00, 0x02, 0x01, 0x06,
+      // event_type, addr_type, bda
+      0x01, 0x00, 0x00, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11,
+      // phys, sid, tx_power, rssi, periodic_adv_int
+      0x01, 0x02, 0x01, 0x7f, 0xb0, 0x40, 0x01,
+      // adv_data_len
+      0x00, 0x00,
+  };
+  ASSERT_EQ(2 * kScanResultBatchHeaderSize + 3, packed_results.size());
+
+  // A truncated trailing result is dropped.
+  packed_results.push_back(0x00);
+  cb.OnScanResultBatch(3, packed_results);
+
+  ASSERT_EQ(2UL, cb.event_types.size());
+  ASSERT_EQ(0x13, cb.event_types[0]);
+  ASSERT_EQ(0x01, cb.event_types[1]);
+  ASSERT_EQ(RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66}), cb.addresses[0]);
+  ASSERT_EQ(RawAddress({0x66, 0x55, 0x44, 0x33, 0x22, 0x11}), cb.addresses[1]);
+  ASSERT_EQ(-60, cb.rssis[0]);
+  ASSERT_EQ(-80, cb.rssis[1]);
+  ASSERT_EQ(0x0140, cb.periodic_adv_ints[1]);
+  ASSERT_EQ(std::vector<uint8_t>({0x02, 0x01, 0x06}), cb.adv_datas[0]);
+  ASSERT_TRUE(cb.adv_datas[1].empty());
+}
+
 TEST_F(MainShimTest, DISABLED_LeShimAclConnection_local_disconnect) {
   auto acl = MakeAcl();
   EXPECT_CALL(*test::mock_acl_manager_, CreateLeConnection(_, _)).Times(1);
@@ -79,6 +79,19 @@ void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data);
 
+// Sets an |alarm| like |alarm_set|, but allows it to fire up to |slack_ms|
+// late. The expiry is aligned so that alarms with a similar slack expire
+// together and share a CPU wakeup. A |slack_ms| of 0 is the same as
+// |alarm_set|. Use it for timers that don't need millisecond precision.
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data);
+
+// Same as |alarm_set_with_slack| except that the |cb| callback is scheduled
+// for execution in the context of the main message loop.
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data);
+
 // This function cancels the |alarm| if it was previously set.
 // When this call returns, the caller has a guarantee that the
 // callback is not in progress and will not be called if it
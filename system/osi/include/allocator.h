@@ -41,12 +41,48 @@ void* osi_malloc(size_t size);
 void* osi_calloc(size_t size);
 void osi_free(void* ptr);
 
+// Returns the number of bytes |ptr|, allocated with |osi_malloc| or
+// |osi_calloc|, holds: the size of its pool block, or the usable size of the
+// system allocation, which can be larger than the size that was requested.
+size_t osi_allocation_size(const void* ptr);
+
 // Free a buffer that was previously allocated with function |osi_malloc|
 // or |osi_calloc| and reset the pointer to that buffer to NULL.
 // |p_ptr| is a pointer to the buffer pointer to be reset.
 // |p_ptr| cannot be NULL.
 void osi_free_and_reset(void** p_ptr);
 
+// Enables the size-class buffer pools behind |osi_malloc| and |osi_calloc|.
+// Once enabled, requests small enough for one of the pool size classes are
+// served from preallocated slabs through per-thread caches and lock-free
+// free lists; larger requests, or requests made while a size class is
+// exhausted, still go to the system allocator. The pools cannot be disabled
+// again. Buffers allocated before the pools were enabled can still be released
+// with |osi_free|. Returns true if the pools are enabled.
+bool osi_allocator_pool_enable(void);
+
+// Returns true if the buffer pools have been enabled.
+bool osi_allocator_pool_is_enabled(void);
+
+typedef struct {
+  size_t block_size;
+  size_t block_count;
+  size_t in_use;
+  size_t high_watermark;
+  size_t allocations;
+  size_t exhausted;
+} osi_allocator_pool_stats_t;
+
+// Copies the counters of up to |max_stats| size classes into |stats| and
+// returns the number of size classes. Counters are all zero if the pools are
+// not enabled.
+size_t osi_allocator_pool_get_stats(osi_allocator_pool_stats_t* stats,
+                                    size_t max_stats);
+
+// Dump buffer pool occupancy to the |fd| file descriptor.
+// The caller is responsible for closing the |fd|.
+void osi_allocator_debug_dump(int fd);
+
 class OsiObject {
  public:
   OsiObject(void* ptr);
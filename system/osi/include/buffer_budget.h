@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Accounting of the buffers held by the queues of the stack, by owner.
+//
+// A queue tagged with an owner through |fixed_queue_set_buffer_owner| charges
+// the owner with the allocation size of each buffer while the buffer is
+// queued. Each owner can be given a budget, and all of them together a total
+// budget: an owner over its budget, or any owner while the total is over
+// budget, is expected to stop taking in more data until its queue drains.
+// Budgets are only enforced by the owners themselves, nothing fails to
+// allocate.
+
+typedef enum {
+  BUFFER_OWNER_L2CAP_TX,   // L2CAP channel transmit hold queues
+  BUFFER_OWNER_RFCOMM_TX,  // RFCOMM port transmit queues
+  BUFFER_OWNER_RFCOMM_RX,  // RFCOMM port receive queues
+  BUFFER_OWNER_A2DP_TX,    // A2DP source encoded audio queue
+  BUFFER_OWNER_COUNT,
+} buffer_owner_t;
+
+typedef struct {
+  size_t in_use;          // Bytes of the buffers held
+  size_t high_watermark;  // Highest |in_use|
+  size_t buffers;         // Number of buffers held
+  size_t budget;          // 0 if unlimited
+  size_t exceeded;        // Number of times a buffer took |in_use| over budget
+} buffer_budget_stats_t;
+
+// Returns the short name of |owner|, e.g. "l2cap_tx".
+const char* buffer_budget_owner_name(buffer_owner_t owner);
+
+// Sets the budget of |owner| to |budget| bytes, 0 for no budget.
+void buffer_budget_set(buffer_owner_t owner, size_t budget);
+
+// Sets the budget of all the owners together to |budget| bytes, 0 for no
+// budget.
+void buffer_budget_set_total(size_t budget);
+
+// Charges |owner| with the allocation size of |buffer|, which must have been
+// allocated with |osi_malloc| or |osi_calloc|.
+void buffer_budget_charge(buffer_owner_t owner, const void* buffer);
+
+// Releases the charge |buffer_budget_charge| made for |buffer|.
+void buffer_budget_release(buffer_owner_t owner, const void* buffer);
+
+// Returns true if |owner| is over its budget or the owners together are over
+// the total budget.
+bool buffer_budget_is_exceeded(buffer_owner_t owner);
+
+// Copies the counters of |owner| into |stats|.
+void buffer_budget_get_stats(buffer_owner_t owner,
+                             buffer_budget_stats_t* stats);
+
+// Dump the buffer memory held by each owner to the |fd| file descriptor.
+// The caller is responsible for closing the |fd|.
+void buffer_budget_debug_dump(int fd);
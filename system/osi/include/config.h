@@ -15,11 +15,18 @@
 //   empty sections.
 // - Duplicate keys in a section will overwrite previous values.
 // - All strings are case sensitive.
+// - Sections and keys are looked up through a hash index kept next to the
+//   lists. Clients may iterate, sort, append to and erase from the lists
+//   directly: the index is rebuilt on the next lookup once the list no
+//   longer has as many items as the index. Since config_t lookups may
+//   rebuild it, concurrent readers of a config need the same lock as its
+//   writers; the names of the items must not be changed in place.
 
 #include <stdbool.h>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 // The default section name to use if a key/value pair is not defined within
 // a section.
@@ -30,9 +37,24 @@ struct entry_t {
   std::string value;
 };
 
+// Index of the items of a |std::list|, by name. It is not copied along with
+// the list it indexes, since its iterators would point into the source one.
+template <typename T>
+struct config_index_t {
+  config_index_t() = default;
+  config_index_t(const config_index_t&) {}
+  config_index_t& operator=(const config_index_t&) {
+    items.clear();
+    return *this;
+  }
+
+  std::unordered_map<std::string, typename std::list<T>::iterator> items;
+};
+
 struct section_t {
   std::string name;
   std::list<entry_t> entries;
+  mutable config_index_t<entry_t> index;
   void Set(std::string key, std::string value);
   std::list<entry_t>::iterator Find(const std::string& key);
   bool Has(const std::string& key);
@@ -40,6 +62,7 @@ struct section_t {
 
 struct config_t {
   std::list<section_t> sections;
+  mutable config_index_t<section_t> index;
   std::list<section_t>::iterator Find(const std::string& section);
   bool Has(const std::string& section);
 };
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include "osi/include/buffer_budget.h"
 #include "osi/include/list.h"
 
 struct fixed_queue_t;
@@ -30,12 +31,34 @@ typedef struct reactor_t reactor_t;
 typedef void (*fixed_queue_free_cb)(void* data);
 typedef void (*fixed_queue_cb)(fixed_queue_t* queue, void* context);
 
+typedef enum {
+  // A list guarded by a mutex. Supports every function below.
+  FIXED_QUEUE_LIST,
+  // A lock-free ring for one producer thread and one consumer thread.
+  FIXED_QUEUE_RING_SPSC,
+  // A lock-free ring for any number of producer and consumer threads.
+  FIXED_QUEUE_RING_MPMC,
+} fixed_queue_type_t;
+
+// Largest capacity of a ring queue, whose slots are allocated upfront.
+#define FIXED_QUEUE_RING_MAX_CAPACITY 4096
+
 // Creates a new fixed queue with the given |capacity|. If more elements than
 // |capacity| are added to the queue, the caller is blocked until space is
 // made available in the queue. Returns NULL on failure. The caller must free
 // the returned queue with |fixed_queue_free|.
 fixed_queue_t* fixed_queue_new(size_t capacity);
 
+// Creates a new fixed queue of the given |type|, that behaves as one created
+// by |fixed_queue_new|. Ring queues enqueue and dequeue without a lock or an
+// allocation, and only touch their file descriptors when they stop being
+// empty or full. Their |capacity| must be between 1 and
+// FIXED_QUEUE_RING_MAX_CAPACITY, and they do not support
+// |fixed_queue_try_remove_from_queue| and |fixed_queue_get_list|. Returns NULL
+// on failure.
+fixed_queue_t* fixed_queue_new_with_type(size_t capacity,
+                                         fixed_queue_type_t type);
+
 // Frees a queue and (optionally) the enqueued elements.
 // |queue| is the queue to free. If the |free_cb| callback is not null,
 // it is called on each queue element to free it.
@@ -60,6 +83,12 @@ size_t fixed_queue_length(fixed_queue_t* queue);
 // not be NULL.
 size_t fixed_queue_capacity(fixed_queue_t* queue);
 
+// Charges the buffers held by |queue| to |owner| in the buffer budget
+// accounting, from when they are enqueued to when they are dequeued, removed
+// or freed with the queue. The buffers must have been allocated with
+// |osi_malloc| or |osi_calloc|. |queue| may not be NULL and must be empty.
+void fixed_queue_set_buffer_owner(fixed_queue_t* queue, buffer_owner_t owner);
+
 // Enqueues the given |data| into the |queue|. The caller will be blocked
 // if no more space is available in the queue. Neither |queue| nor |data|
 // may be NULL.
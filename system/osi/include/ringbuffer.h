@@ -48,6 +48,16 @@ size_t ringbuffer_size(const ringbuffer_t* rb);
 // is full.
 size_t ringbuffer_insert(ringbuffer_t* rb, const uint8_t* p, size_t length);
 
+// Sets |*p| to the free space at the tail of the buffer, and returns how many
+// bytes can be written there contiguously. This can be less than
+// |ringbuffer_available| when the free space wraps around the end of the
+// buffer. The bytes written are added with |ringbuffer_commit|.
+size_t ringbuffer_reserve(ringbuffer_t* rb, uint8_t** p);
+
+// Adds |length| bytes written in place after |ringbuffer_reserve| to the
+// buffer. Return actual number of bytes added.
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length);
+
 // Peek |length| number of bytes from the ringbuffer, starting at |offset|,
 // into the buffer |p|. Return the actual number of bytes peeked. Can be less
 // than |length| if there is less than |length| data available. |offset| must
@@ -55,6 +65,12 @@ size_t ringbuffer_insert(ringbuffer_t* rb, const uint8_t* p, size_t length);
 size_t ringbuffer_peek(const ringbuffer_t* rb, off_t offset, uint8_t* p,
                        size_t length);
 
+// Sets |*p| to the data at the head of the buffer, and returns how many bytes
+// can be read there contiguously. This can be less than |ringbuffer_size| when
+// the data wraps around the end of the buffer. The bytes read are removed with
+// |ringbuffer_delete|.
+size_t ringbuffer_peek_contiguous(const ringbuffer_t* rb, const uint8_t** p);
+
 // Does the same as |ringbuffer_peek|, but also advances the ring buffer head
 size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length);
 
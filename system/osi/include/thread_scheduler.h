@@ -16,5 +16,14 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <sys/types.h>
+
 bool thread_scheduler_enable_real_time(pid_t pid);
+// Same as above with a SCHED_FIFO |priority| taken in the range returned by
+// thread_scheduler_get_priority_range().
+bool thread_scheduler_enable_real_time_priority(pid_t pid, int priority);
 bool thread_scheduler_get_priority_range(int& min, int& max);
+// Restrict |pid| to the CPUs of |cpu_mask|, bit N standing for CPU N. A |pid|
+// of 0 is the calling thread.
+bool thread_scheduler_set_cpu_affinity(pid_t pid, uint64_t cpu_mask);
@@ -20,6 +20,7 @@
 
 #include <hardware/bluetooth.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Set the Bluetooth OS callouts to |callouts|.
 // This function should be called when native kernel wakelocks are not used
@@ -28,15 +29,23 @@
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts);
 
 // Acquire the Bluetooth wakelock.
+// Acquires nest: the wakelock is held until each of them has been released.
 // The function is thread safe.
 // Return true on success, otherwise false.
 bool wakelock_acquire(void);
 
 // Release the Bluetooth wakelock.
+// The wakelock is released once the last acquire is released, after the
+// delay set with |wakelock_set_release_delay_ms|.
 // The function is thread safe.
 // Return true on success, otherwise false.
 bool wakelock_release(void);
 
+// Set the delay after which the wakelock is released, to |delay_ms|. An
+// acquire within that delay keeps the wakelock held instead of releasing and
+// acquiring it again. The default of 0 releases the wakelock right away.
+void wakelock_set_release_delay_ms(uint64_t delay_ms);
+
 // Cleanup the wakelock internal state.
 // This function should be called by the OSI module cleanup during
 // graceful shutdown.
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifndef LIB_OSI_INTERNAL
+#error "Please do not include this outside of osi."
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size-class buffer pools backing osi_malloc/osi_calloc once
+// |osi_allocator_pool_enable| has been called.
+
+// Maps the slabs of all size classes. Returns true on success or if the pools
+// were already enabled.
+bool allocation_pool_enable(void);
+
+bool allocation_pool_is_enabled(void);
+
+// Returns a block of at least |size| bytes, or NULL if the pools are disabled,
+// |size| is larger than the largest size class or the size class is exhausted.
+void* allocation_pool_alloc(size_t size);
+
+// Returns |ptr| to its pool and returns true if it was allocated from one,
+// otherwise leaves it alone and returns false.
+bool allocation_pool_free(void* ptr);
+
+// Returns the size of the block |ptr| points to if it was allocated from one
+// of the pools, otherwise 0.
+size_t allocation_pool_block_size(const void* ptr);
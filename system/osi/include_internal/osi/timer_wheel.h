@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#ifndef LIB_OSI_INTERNAL
+#error "Please do not include this outside of osi."
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A hierarchical timing wheel holding deadlines in milliseconds. Adding and
+// removing an entry is O(1); finding the earliest deadline looks at one slot
+// per level and is cached until that entry is removed.
+//
+// Entries are intrusive: the caller embeds a |timer_wheel_node_t| in its own
+// structure and owns its memory. The wheel is not thread safe.
+
+typedef struct timer_wheel_node_t {
+  struct timer_wheel_node_t* next;  // NULL when the node is not in a wheel
+  struct timer_wheel_node_t* prev;
+  uint64_t deadline_ms;
+  void* owner;  // Structure embedding this node, set by the caller
+  uint8_t level;
+  uint8_t slot;
+} timer_wheel_node_t;
+
+struct timer_wheel_t;
+typedef struct timer_wheel_t timer_wheel_t;
+
+// Iterator callback prototype used for |timer_wheel_foreach|. Return true to
+// keep iterating.
+typedef bool (*timer_wheel_iter_cb)(timer_wheel_node_t* node, void* context);
+
+// Creates a new, empty wheel whose clock starts at |now_ms|. Returns NULL on
+// failure. The returned wheel must be freed with |timer_wheel_free|.
+timer_wheel_t* timer_wheel_new(uint64_t now_ms);
+
+// Frees |wheel|. Nodes still in it are unlinked. |wheel| may be NULL.
+void timer_wheel_free(timer_wheel_t* wheel);
+
+// Adds |node| with its current |deadline_ms|. |node| must not be in a wheel.
+// Deadlines in the past are allowed and are returned first.
+void timer_wheel_add(timer_wheel_t* wheel, timer_wheel_node_t* node);
+
+// Removes |node| from |wheel|. Does nothing if |node| is not in a wheel.
+void timer_wheel_remove(timer_wheel_t* wheel, timer_wheel_node_t* node);
+
+// Returns true if |node| is currently in a wheel.
+bool timer_wheel_contains(const timer_wheel_node_t* node);
+
+// Returns the node with the earliest deadline, or NULL if |wheel| is empty.
+timer_wheel_node_t* timer_wheel_peek(timer_wheel_t* wheel);
+
+// Removes and returns the node with the earliest deadline if that deadline is
+// at or before |now_ms|, moving the wheel clock forward to that deadline.
+// Otherwise returns NULL and moves the wheel clock forward to |now_ms|.
+timer_wheel_node_t* timer_wheel_pop_expired(timer_wheel_t* wheel,
+                                            uint64_t now_ms);
+
+// Returns the number of nodes in |wheel|.
+size_t timer_wheel_size(const timer_wheel_t* wheel);
+
+// Calls |callback| for each node in |wheel|, in no particular order, until
+// |callback| returns false. |callback| must not modify |wheel|.
+void timer_wheel_foreach(timer_wheel_t* wheel, timer_wheel_iter_cb callback,
+                         void* context);
@@ -35,10 +35,10 @@
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
-#include "osi/include/list.h"
 #include "osi/include/thread.h"
 #include "osi/include/wakelock.h"
 #include "osi/semaphore.h"
+#include "osi/timer_wheel.h"
 #include "stack/include/main_thread.h"
 
 using base::Bind;
@@ -62,6 +62,7 @@ typedef struct {
   size_t canceled_count;
   size_t rescheduled_count;
   size_t total_updates;
+  size_t wakeup_count;  // Dispatcher wakeups this alarm did not share
   uint64_t last_update_ms;
   stat_t overdue_scheduling;
   stat_t premature_scheduling;
@@ -90,6 +91,7 @@ struct alarm_t {
   uint64_t deadline_ms;
   uint64_t prev_deadline_ms;  // Previous deadline - used for accounting of
                               // periodic timers
+  uint64_t slack_ms;          // How late the alarm is allowed to fire
   bool is_periodic;
   fixed_queue_t* queue;  // The processing queue to add this alarm to
   alarm_callback_t callback;
@@ -98,6 +100,8 @@ struct alarm_t {
 
   bool for_msg_loop;  // True, if the alarm should be processed on message loop
   CancelableClosureInStruct closure;  // posted to message loop for processing
+
+  timer_wheel_node_t wheel_node;  // Entry in |alarms| while pending
 };
 
 // If the next wakeup time is less than this threshold, we should acquire
@@ -109,12 +113,15 @@ static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 
 // This mutex ensures that the |alarm_set|, |alarm_cancel|, and alarm callback
 // functions execute serially and not concurrently. As a result, this mutex
-// also protects the |alarms| list.
+// also protects the |alarms| wheel.
 static std::mutex alarms_mutex;
-static list_t* alarms;
+static timer_wheel_t* alarms;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
+// When |callback_dispatch| last took an alarm; alarms already due by then
+// shared that wakeup.
+static uint64_t last_dispatch_ms;
 
 // All alarm callbacks are dispatched from |dispatcher_thread|
 static thread_t* dispatcher_thread;
@@ -128,9 +135,12 @@ static fixed_queue_t* default_callback_queue;
 static alarm_t* alarm_new_internal(const char* name, bool is_periodic);
 static bool lazy_initialize(void);
 static uint64_t now_ms(void);
+static uint64_t clock_now_ms(void);
+static bool is_root_alarm(const alarm_t* alarm);
 static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
-                               alarm_callback_t cb, void* data,
-                               fixed_queue_t* queue, bool for_msg_loop);
+                               uint64_t slack_ms, alarm_callback_t cb,
+                               void* data, fixed_queue_t* queue,
+                               bool for_msg_loop);
 static void alarm_cancel_internal(alarm_t* alarm);
 static void remove_pending_alarm(alarm_t* alarm);
 static void schedule_next_instance(alarm_t* alarm);
@@ -159,7 +169,7 @@ alarm_t* alarm_new_periodic(const char* name) {
 }
 
 static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
-  // Make sure we have a list we can insert alarms into.
+  // Make sure we have a wheel we can insert alarms into.
   if (!alarms && !lazy_initialize()) {
     log::fatal("initialization failed");  // if initialization failed, we
                                           // should not continue
@@ -176,6 +186,7 @@ static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
   ret->for_msg_loop = false;
   // placement new
   new (&ret->closure) CancelableClosureInStruct();
+  ret->wheel_node.owner = ret;
 
   // NOTE: The stats were reset by osi_calloc() above
 
@@ -207,19 +218,32 @@ uint64_t alarm_get_remaining_ms(const alarm_t* alarm) {
 
 void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
                void* data) {
-  alarm_set_internal(alarm, interval_ms, cb, data, default_callback_queue,
+  alarm_set_internal(alarm, interval_ms, 0, cb, data, default_callback_queue,
                      false);
 }
 
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data) {
-  alarm_set_internal(alarm, interval_ms, cb, data, NULL, true);
+  alarm_set_internal(alarm, interval_ms, 0, cb, data, NULL, true);
+}
+
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data) {
+  alarm_set_internal(alarm, interval_ms, slack_ms, cb, data,
+                     default_callback_queue, false);
+}
+
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data) {
+  alarm_set_internal(alarm, interval_ms, slack_ms, cb, data, NULL, true);
 }
 
 // Runs in exclusion with alarm_cancel and timer_callback.
 static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
-                               alarm_callback_t cb, void* data,
-                               fixed_queue_t* queue, bool for_msg_loop) {
+                               uint64_t slack_ms, alarm_callback_t cb,
+                               void* data, fixed_queue_t* queue,
+                               bool for_msg_loop) {
   log::assert_that(alarms != NULL, "assert failed: alarms != NULL");
   log::assert_that(alarm != NULL, "assert failed: alarm != NULL");
   log::assert_that(cb != NULL, "assert failed: cb != NULL");
@@ -228,6 +252,7 @@ static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
 
   alarm->creation_time_ms = now_ms();
   alarm->period_ms = period_ms;
+  alarm->slack_ms = slack_ms;
   alarm->queue = queue;
   alarm->callback = cb;
   alarm->data = data;
@@ -255,8 +280,7 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = is_root_alarm(alarm);
 
   remove_pending_alarm(alarm);
 
@@ -296,7 +320,7 @@ void alarm_cleanup(void) {
   semaphore_free(alarm_expired);
   alarm_expired = NULL;
 
-  list_free(alarms);
+  timer_wheel_free(alarms);
   alarms = NULL;
 }
 
@@ -310,9 +334,9 @@ static bool lazy_initialize(void) {
 
   std::lock_guard<std::mutex> lock(alarms_mutex);
 
-  alarms = list_new(NULL);
+  alarms = timer_wheel_new(clock_now_ms());
   if (!alarms) {
-    log::error("unable to allocate alarm list.");
+    log::error("unable to allocate alarm wheel.");
     goto error;
   }
 
@@ -375,7 +399,7 @@ error:
 
   if (timer_initialized) timer_delete(timer);
 
-  list_free(alarms);
+  timer_wheel_free(alarms);
   alarms = NULL;
 
   return false;
@@ -383,7 +407,10 @@ error:
 
 static uint64_t now_ms(void) {
   log::assert_that(alarms != NULL, "assert failed: alarms != NULL");
+  return clock_now_ms();
+}
 
+static uint64_t clock_now_ms(void) {
   struct timespec ts;
   if (clock_gettime(CLOCK_ID, &ts) == -1) {
     log::error("unable to get current time: {}", strerror(errno));
@@ -393,10 +420,17 @@ static uint64_t now_ms(void) {
   return (ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL);
 }
 
-// Remove alarm from internal alarm list and the processing queue
+// Returns true if |alarm| has the earliest deadline of all pending alarms.
+// The caller must hold the |alarms_mutex|
+static bool is_root_alarm(const alarm_t* alarm) {
+  return timer_wheel_contains(&alarm->wheel_node) &&
+         timer_wheel_peek(alarms) == &alarm->wheel_node;
+}
+
+// Remove alarm from internal alarm wheel and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  timer_wheel_remove(alarms, &alarm->wheel_node);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -409,12 +443,21 @@ static void remove_pending_alarm(alarm_t* alarm) {
   }
 }
 
+// Rounds |deadline_ms| up to a multiple of the largest power of two that is
+// not above |slack_ms|. Alarms with a similar slack then expire on the same
+// boundaries of the clock and share a wakeup, and none is late by more than
+// its slack.
+static uint64_t align_deadline(uint64_t deadline_ms, uint64_t slack_ms) {
+  if (slack_ms == 0) return deadline_ms;
+  uint64_t granularity = 1ULL << (63 - __builtin_clzll(slack_ms));
+  return (deadline_ms + granularity - 1) & ~(granularity - 1);
+}
+
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
-  // If the alarm is currently set and it's at the start of the list,
+  // If the alarm is currently set and it has the earliest deadline,
   // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = is_root_alarm(alarm);
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -423,28 +466,16 @@ static void schedule_next_instance(alarm_t* alarm) {
   if ((alarm->is_periodic) && (alarm->period_ms != 0))
     ms_into_period =
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
-  alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
+  alarm->deadline_ms = align_deadline(
+      just_now_ms + (alarm->period_ms - ms_into_period), alarm->slack_ms);
 
-  // Add it into the timer list sorted by deadline (earliest deadline first).
-  if (list_is_empty(alarms) ||
-      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
-    list_prepend(alarms, alarm);
-  } else {
-    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-         node = list_next(node)) {
-      list_node_t* next = list_next(node);
-      if (next == list_end(alarms) ||
-          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
-        list_insert_after(alarms, node, alarm);
-        break;
-      }
-    }
-  }
+  // Add it into the timer wheel, which keeps track of the earliest deadline.
+  alarm->wheel_node.deadline_ms = alarm->deadline_ms;
+  timer_wheel_add(alarms, &alarm->wheel_node);
 
   // If the new alarm has the earliest deadline, we need to re-evaluate our
   // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
+  if (needs_reschedule || is_root_alarm(alarm)) {
     reschedule_root_alarm();
   }
 }
@@ -454,6 +485,7 @@ static void reschedule_root_alarm(void) {
   log::assert_that(alarms != NULL, "assert failed: alarms != NULL");
 
   const bool timer_was_set = timer_set;
+  timer_wheel_node_t* root;
   alarm_t* next;
   int64_t next_expiration;
 
@@ -461,9 +493,10 @@ static void reschedule_root_alarm(void) {
   struct itimerspec timer_time;
   memset(&timer_time, 0, sizeof(timer_time));
 
-  if (list_is_empty(alarms)) goto done;
+  root = timer_wheel_peek(alarms);
+  if (root == NULL) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
+  next = static_cast<alarm_t*>(root->owner);
   next_expiration = next->deadline_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
@@ -613,19 +646,22 @@ static void callback_dispatch(void* /* context */) {
     if (!dispatcher_thread_active) break;
 
     std::lock_guard<std::mutex> lock(alarms_mutex);
-    alarm_t* alarm;
 
     // Take into account that the alarm may get cancelled before we get to it.
-    // We're done here if there are no alarms or the alarm at the front is in
-    // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
+    // We're done here if there are no alarms or the earliest alarm is in the
+    // future. Exit right away since there's nothing left to do.
+    timer_wheel_node_t* expired = timer_wheel_pop_expired(alarms, now_ms());
+    if (expired == NULL) {
       reschedule_root_alarm();
       continue;
     }
 
-    list_remove(alarms, alarm);
+    alarm_t* alarm = static_cast<alarm_t*>(expired->owner);
+
+    // Alarms that were not due yet when the previous one was taken needed a
+    // wakeup of their own.
+    if (alarm->deadline_ms > last_dispatch_ms) alarm->stats.wakeup_count++;
+    last_dispatch_ms = now_ms();
 
     if (alarm->is_periodic) {
       alarm->prev_deadline_ms = alarm->deadline_ms;
@@ -711,50 +747,62 @@ static void dump_stat(int fd, stat_t* stat, const char* description) {
           (unsigned long long)average_time_ms);
 }
 
-void alarm_debug_dump(int fd) {
-  dprintf(fd, "\nBluetooth Alarms Statistics:\n");
+typedef struct {
+  int fd;
+  uint64_t just_now_ms;
+} alarm_dump_context_t;
 
-  std::lock_guard<std::mutex> lock(alarms_mutex);
+static bool dump_alarm(timer_wheel_node_t* node, void* context) {
+  const alarm_dump_context_t* dump = (const alarm_dump_context_t*)context;
+  int fd = dump->fd;
+  uint64_t just_now_ms = dump->just_now_ms;
+  alarm_t* alarm = (alarm_t*)node->owner;
+  alarm_stats_t* stats = &alarm->stats;
 
-  if (alarms == NULL) {
-    dprintf(fd, "  None\n");
-    return;
-  }
+  dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
+          (alarm->is_periodic) ? "PERIODIC" : "SINGLE");
 
-  uint64_t just_now_ms = now_ms();
+  dprintf(fd, "%-51s: %zu / %zu / %zu / %zu\n",
+          "    Action counts (sched/resched/exec/cancel)",
+          stats->scheduled_count, stats->rescheduled_count,
+          stats->total_updates, stats->canceled_count);
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  dprintf(fd, "%-51s: %zu / %zu\n", "    Deviation counts (overdue/premature)",
+          stats->overdue_scheduling.count, stats->premature_scheduling.count);
 
-  // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
-    alarm_stats_t* stats = &alarm->stats;
+  dprintf(fd, "%-51s: %zu / %llu\n", "    Wakeups / slack in ms",
+          stats->wakeup_count, (unsigned long long)alarm->slack_ms);
 
-    dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
-            (alarm->is_periodic) ? "PERIODIC" : "SINGLE");
+  dprintf(fd, "%-51s: %llu / %llu / %lld\n",
+          "    Time in ms (since creation/interval/remaining)",
+          (unsigned long long)(just_now_ms - alarm->creation_time_ms),
+          (unsigned long long)alarm->period_ms,
+          (long long)(alarm->deadline_ms - just_now_ms));
 
-    dprintf(fd, "%-51s: %zu / %zu / %zu / %zu\n",
-            "    Action counts (sched/resched/exec/cancel)",
-            stats->scheduled_count, stats->rescheduled_count,
-            stats->total_updates, stats->canceled_count);
+  dump_stat(fd, &stats->overdue_scheduling,
+            "    Overdue scheduling time in ms (total/max/avg)");
 
-    dprintf(fd, "%-51s: %zu / %zu\n",
-            "    Deviation counts (overdue/premature)",
-            stats->overdue_scheduling.count, stats->premature_scheduling.count);
+  dump_stat(fd, &stats->premature_scheduling,
+            "    Premature scheduling time in ms (total/max/avg)");
 
-    dprintf(fd, "%-51s: %llu / %llu / %lld\n",
-            "    Time in ms (since creation/interval/remaining)",
-            (unsigned long long)(just_now_ms - alarm->creation_time_ms),
-            (unsigned long long)alarm->period_ms,
-            (long long)(alarm->deadline_ms - just_now_ms));
+  dprintf(fd, "\n");
+  return true;
+}
 
-    dump_stat(fd, &stats->overdue_scheduling,
-              "    Overdue scheduling time in ms (total/max/avg)");
+void alarm_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Alarms Statistics:\n");
 
-    dump_stat(fd, &stats->premature_scheduling,
-              "    Premature scheduling time in ms (total/max/avg)");
+  std::lock_guard<std::mutex> lock(alarms_mutex);
 
-    dprintf(fd, "\n");
+  if (alarms == NULL) {
+    dprintf(fd, "  None\n");
+    return;
   }
+
+  alarm_dump_context_t context = {fd, now_ms()};
+
+  dprintf(fd, "  Total Alarms: %zu\n\n", timer_wheel_size(alarms));
+
+  // Dump info for each pending alarm
+  timer_wheel_foreach(alarms, dump_alarm, &context);
 }
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_osi_allocation_pool"
+
+#include "osi/allocation_pool.h"
+
+#include <bluetooth/log.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "osi/include/allocator.h"
+
+using namespace bluetooth;
+
+namespace {
+
+struct size_class_config_t {
+  size_t block_size;
+  size_t block_count;
+};
+
+// Sized for the BT_HDR buffers of the legacy stack: small HCI events and
+// commands, BT_SMALL_BUFFER_SIZE control buffers, ACL sized L2CAP buffers and
+// BT_DEFAULT_BUFFER_SIZE buffers used by RFCOMM, AVDTP and the A2DP media path.
+constexpr size_class_config_t kSizeClasses[] = {
+    {64, 512}, {256, 256}, {768, 128}, {1280, 128}, {2048, 64}, {4160, 64},
+};
+constexpr size_t kNumSizeClasses =
+    sizeof(kSizeClasses) / sizeof(kSizeClasses[0]);
+
+// Number of blocks each thread keeps aside per size class before returning
+// them to the shared free list.
+constexpr size_t kThreadCacheSize = 8;
+
+// Marks an empty free list or the end of a free list.
+constexpr uint32_t kNoBlock = UINT32_MAX;
+
+struct size_class_t {
+  size_t block_size;
+  size_t block_count;
+  uint8_t* begin;
+  uint8_t* end;
+
+  // Treiber stack of free block indices. The upper 32 bits hold a tag which is
+  // bumped on every update to protect against ABA; the lower 32 bits hold the
+  // index of the first free block.
+  std::atomic<uint64_t> free_head;
+  std::atomic<uint32_t>* next;
+
+  std::atomic<size_t> in_use;
+  std::atomic<size_t> high_watermark;
+  std::atomic<size_t> allocations;
+  std::atomic<size_t> exhausted;
+};
+
+size_class_t size_classes[kNumSizeClasses];
+uint8_t* arena_begin;
+uint8_t* arena_end;
+std::atomic<bool> pool_enabled;
+
+uint64_t make_head(uint64_t tag, uint32_t index) {
+  return (tag << 32) | index;
+}
+
+uint32_t head_index(uint64_t head) { return static_cast<uint32_t>(head); }
+
+uint64_t head_tag(uint64_t head) { return head >> 32; }
+
+uint32_t pop_block(size_class_t& pool) {
+  uint64_t head = pool.free_head.load(std::memory_order_acquire);
+  while (head_index(head) != kNoBlock) {
+    uint32_t next = pool.next[head_index(head)].load(std::memory_order_relaxed);
+    if (pool.free_head.compare_exchange_weak(
+            head, make_head(head_tag(head) + 1, next),
+            std::memory_order_acquire, std::memory_order_acquire)) {
+      return head_index(head);
+    }
+  }
+  return kNoBlock;
+}
+
+void push_block(size_class_t& pool, uint32_t index) {
+  uint64_t head = pool.free_head.load(std::memory_order_relaxed);
+  do {
+    pool.next[index].store(head_index(head), std::memory_order_relaxed);
+  } while (!pool.free_head.compare_exchange_weak(
+      head, make_head(head_tag(head) + 1, index), std::memory_order_release,
+      std::memory_order_relaxed));
+}
+
+// Per-thread block caches, so that a thread repeatedly allocating and freeing
+// buffers of the same size class does not touch the shared free list.
+struct thread_cache_t {
+  uint32_t count[kNumSizeClasses] = {};
+  uint32_t blocks[kNumSizeClasses][kThreadCacheSize];
+
+  ~thread_cache_t() {
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+      while (count[i] > 0) {
+        push_block(size_classes[i], blocks[i][--count[i]]);
+      }
+    }
+  }
+};
+
+thread_local thread_cache_t thread_cache;
+
+size_t size_class_index(size_t size) {
+  for (size_t i = 0; i < kNumSizeClasses; i++) {
+    if (size <= kSizeClasses[i].block_size) return i;
+  }
+  return kNumSizeClasses;
+}
+
+void update_high_watermark(size_class_t& pool, size_t in_use) {
+  size_t high_watermark = pool.high_watermark.load(std::memory_order_relaxed);
+  while (in_use > high_watermark &&
+         !pool.high_watermark.compare_exchange_weak(
+             high_watermark, in_use, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+bool allocation_pool_enable(void) {
+  static std::mutex enable_mutex;
+  std::lock_guard<std::mutex> lock(enable_mutex);
+  if (pool_enabled.load(std::memory_order_acquire)) return true;
+
+  size_t arena_size = 0;
+  size_t next_size = 0;
+  for (const auto& config : kSizeClasses) {
+    arena_size += config.block_size * config.block_count;
+    next_size += sizeof(std::atomic<uint32_t>) * config.block_count;
+  }
+
+  void* arena = mmap(nullptr, arena_size + next_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arena == MAP_FAILED) {
+    log::error("Unable to map {} bytes for buffer pools", arena_size);
+    return false;
+  }
+
+  arena_begin = static_cast<uint8_t*>(arena);
+  arena_end = arena_begin + arena_size;
+  uint8_t* block = arena_begin;
+  auto next = reinterpret_cast<std::atomic<uint32_t>*>(arena_end);
+  for (size_t i = 0; i < kNumSizeClasses; i++) {
+    size_class_t& pool = size_classes[i];
+    pool.block_size = kSizeClasses[i].block_size;
+    pool.block_count = kSizeClasses[i].block_count;
+    pool.begin = block;
+    pool.end = block + pool.block_size * pool.block_count;
+    pool.next = next;
+    for (uint32_t index = 0; index < pool.block_count; index++) {
+      pool.next[index].store(index + 1 < pool.block_count ? index + 1 : kNoBlock,
+                             std::memory_order_relaxed);
+    }
+    pool.free_head.store(make_head(0, 0), std::memory_order_relaxed);
+    block = pool.end;
+    next += pool.block_count;
+  }
+
+  pool_enabled.store(true, std::memory_order_release);
+  log::info("Enabled buffer pools, {} bytes in {} size classes", arena_size,
+            kNumSizeClasses);
+  return true;
+}
+
+bool allocation_pool_is_enabled(void) {
+  return pool_enabled.load(std::memory_order_acquire);
+}
+
+void* allocation_pool_alloc(size_t size) {
+  if (!pool_enabled.load(std::memory_order_acquire)) return nullptr;
+
+  size_t class_index = size_class_index(size);
+  if (class_index == kNumSizeClasses) return nullptr;
+  size_class_t& pool = size_classes[class_index];
+
+  uint32_t index;
+  if (thread_cache.count[class_index] > 0) {
+    index = thread_cache.blocks[class_index][--thread_cache.count[class_index]];
+  } else {
+    index = pop_block(pool);
+    if (index == kNoBlock) {
+      pool.exhausted.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+
+  pool.allocations.fetch_add(1, std::memory_order_relaxed);
+  update_high_watermark(
+      pool, pool.in_use.fetch_add(1, std::memory_order_relaxed) + 1);
+  return pool.begin + index * pool.block_size;
+}
+
+bool allocation_pool_free(void* ptr) {
+  // Pointers allocated by the pools can only be observed by threads that have
+  // synchronized with the thread enabling them, so the arena bounds need no
+  // further synchronization here.
+  uint8_t* block = static_cast<uint8_t*>(ptr);
+  if (block < arena_begin || block >= arena_end) return false;
+
+  size_t class_index = 0;
+  while (block >= size_classes[class_index].end) class_index++;
+  size_class_t& pool = size_classes[class_index];
+  uint32_t index = (block - pool.begin) / pool.block_size;
+
+  pool.in_use.fetch_sub(1, std::memory_order_relaxed);
+  if (thread_cache.count[class_index] < kThreadCacheSize) {
+    thread_cache.blocks[class_index][thread_cache.count[class_index]++] = index;
+  } else {
+    push_block(pool, index);
+  }
+  return true;
+}
+
+size_t allocation_pool_block_size(const void* ptr) {
+  const uint8_t* block = static_cast<const uint8_t*>(ptr);
+  if (block < arena_begin || block >= arena_end) return 0;
+
+  size_t class_index = 0;
+  while (block >= size_classes[class_index].end) class_index++;
+  return size_classes[class_index].block_size;
+}
+
+bool osi_allocator_pool_enable(void) { return allocation_pool_enable(); }
+
+bool osi_allocator_pool_is_enabled(void) {
+  return allocation_pool_is_enabled();
+}
+
+size_t osi_allocator_pool_get_stats(osi_allocator_pool_stats_t* stats,
+                                    size_t max_stats) {
+  bool enabled = allocation_pool_is_enabled();
+  for (size_t i = 0; i < kNumSizeClasses && i < max_stats; i++) {
+    const size_class_t& pool = size_classes[i];
+    stats[i] = {
+        .block_size = kSizeClasses[i].block_size,
+        .block_count = enabled ? kSizeClasses[i].block_count : 0,
+        .in_use = pool.in_use.load(std::memory_order_relaxed),
+        .high_watermark = pool.high_watermark.load(std::memory_order_relaxed),
+        .allocations = pool.allocations.load(std::memory_order_relaxed),
+        .exhausted = pool.exhausted.load(std::memory_order_relaxed),
+    };
+  }
+  return kNumSizeClasses;
+}
+
+void osi_allocator_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Buffer Pools:\n");
+  if (!allocation_pool_is_enabled()) {
+    dprintf(fd, "  Disabled\n");
+    return;
+  }
+
+  osi_allocator_pool_stats_t stats[kNumSizeClasses];
+  osi_allocator_pool_get_stats(stats, kNumSizeClasses);
+  dprintf(fd,
+          "  Block size  Blocks  In use  High watermark  Allocations  "
+          "Exhausted\n");
+  for (const auto& pool : stats) {
+    dprintf(fd, "  %10zu  %6zu  %6zu  %14zu  %11zu  %9zu\n", pool.block_size,
+            pool.block_count, pool.in_use, pool.high_watermark,
+            pool.allocations, pool.exhausted);
+  }
+}
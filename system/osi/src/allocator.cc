@@ -18,9 +18,12 @@
 #include "osi/include/allocator.h"
 
 #include <bluetooth/log.h>
+#include <malloc.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "osi/allocation_pool.h"
+
 using namespace bluetooth;
 
 char* osi_strdup(const char* str) {
@@ -53,7 +56,8 @@ char* osi_strndup(const char* str, size_t len) {
 void* osi_malloc(size_t size) {
   log::assert_that(static_cast<ssize_t>(size) >= 0,
                    "assert failed: static_cast<ssize_t>(size) >= 0");
-  void* ptr = malloc(size);
+  void* ptr = allocation_pool_alloc(size);
+  if (ptr == nullptr) ptr = malloc(size);
   log::assert_that(ptr != nullptr, "assert failed: ptr != nullptr");
   return ptr;
 }
@@ -61,12 +65,26 @@ void* osi_malloc(size_t size) {
 void* osi_calloc(size_t size) {
   log::assert_that(static_cast<ssize_t>(size) >= 0,
                    "assert failed: static_cast<ssize_t>(size) >= 0");
-  void* ptr = calloc(1, size);
+  void* ptr = allocation_pool_alloc(size);
+  if (ptr != nullptr) {
+    memset(ptr, 0, size);
+  } else {
+    ptr = calloc(1, size);
+  }
   log::assert_that(ptr != nullptr, "assert failed: ptr != nullptr");
   return ptr;
 }
 
-void osi_free(void* ptr) { free(ptr); }
+void osi_free(void* ptr) {
+  if (!allocation_pool_free(ptr)) free(ptr);
+}
+
+size_t osi_allocation_size(const void* ptr) {
+  if (ptr == nullptr) return 0;
+  size_t size = allocation_pool_block_size(ptr);
+  if (size == 0) size = malloc_usable_size(const_cast<void*>(ptr));
+  return size;
+}
 
 void osi_free_and_reset(void** p_ptr) {
   log::assert_that(p_ptr != NULL, "assert failed: p_ptr != NULL");
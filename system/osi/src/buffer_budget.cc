@@ -0,0 +1,153 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_osi_buffer_budget"
+
+#include "osi/include/buffer_budget.h"
+
+#include <bluetooth/log.h>
+#include <stdio.h>
+
+#include <atomic>
+
+#include "osi/include/allocator.h"
+
+using namespace bluetooth;
+
+namespace {
+
+struct owner_account_t {
+  std::atomic<size_t> in_use;
+  std::atomic<size_t> high_watermark;
+  std::atomic<size_t> buffers;
+  std::atomic<size_t> budget;
+  std::atomic<size_t> exceeded;
+};
+
+const char* const kOwnerNames[BUFFER_OWNER_COUNT] = {
+    "l2cap_tx",
+    "rfcomm_tx",
+    "rfcomm_rx",
+    "a2dp_tx",
+};
+
+owner_account_t accounts[BUFFER_OWNER_COUNT];
+std::atomic<size_t> total_in_use;
+std::atomic<size_t> total_high_watermark;
+std::atomic<size_t> total_budget;
+
+void update_high_watermark(std::atomic<size_t>& high_watermark,
+                           size_t in_use) {
+  size_t current = high_watermark.load(std::memory_order_relaxed);
+  while (in_use > current && !high_watermark.compare_exchange_weak(
+                                 current, in_use, std::memory_order_relaxed)) {
+  }
+}
+
+bool over_budget(size_t in_use, size_t budget) {
+  return budget != 0 && in_use > budget;
+}
+
+}  // namespace
+
+const char* buffer_budget_owner_name(buffer_owner_t owner) {
+  log::assert_that(owner < BUFFER_OWNER_COUNT, "invalid buffer owner {}",
+                   static_cast<int>(owner));
+  return kOwnerNames[owner];
+}
+
+void buffer_budget_set(buffer_owner_t owner, size_t budget) {
+  log::assert_that(owner < BUFFER_OWNER_COUNT, "invalid buffer owner {}",
+                   static_cast<int>(owner));
+  accounts[owner].budget.store(budget, std::memory_order_relaxed);
+}
+
+void buffer_budget_set_total(size_t budget) {
+  total_budget.store(budget, std::memory_order_relaxed);
+}
+
+void buffer_budget_charge(buffer_owner_t owner, const void* buffer) {
+  log::assert_that(owner < BUFFER_OWNER_COUNT, "invalid buffer owner {}",
+                   static_cast<int>(owner));
+  owner_account_t& account = accounts[owner];
+  size_t size = osi_allocation_size(buffer);
+  size_t in_use =
+      account.in_use.fetch_add(size, std::memory_order_relaxed) + size;
+  size_t total = total_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+  account.buffers.fetch_add(1, std::memory_order_relaxed);
+  update_high_watermark(account.high_watermark, in_use);
+  update_high_watermark(total_high_watermark, total);
+
+  if (over_budget(in_use, account.budget.load(std::memory_order_relaxed)) &&
+      !over_budget(in_use - size,
+                   account.budget.load(std::memory_order_relaxed))) {
+    account.exceeded.fetch_add(1, std::memory_order_relaxed);
+    log::warn("{} buffers over budget: {} bytes", kOwnerNames[owner], in_use);
+  }
+}
+
+void buffer_budget_release(buffer_owner_t owner, const void* buffer) {
+  log::assert_that(owner < BUFFER_OWNER_COUNT, "invalid buffer owner {}",
+                   static_cast<int>(owner));
+  owner_account_t& account = accounts[owner];
+  size_t size = osi_allocation_size(buffer);
+  account.in_use.fetch_sub(size, std::memory_order_relaxed);
+  total_in_use.fetch_sub(size, std::memory_order_relaxed);
+  account.buffers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool buffer_budget_is_exceeded(buffer_owner_t owner) {
+  log::assert_that(owner < BUFFER_OWNER_COUNT, "invalid buffer owner {}",
+                   static_cast<int>(owner));
+  const owner_account_t& account = accounts[owner];
+  return over_budget(account.in_use.load(std::memory_order_relaxed),
+                     account.budget.load(std::memory_order_relaxed)) ||
+         over_budget(total_in_use.load(std::memory_order_relaxed),
+                     total_budget.load(std::memory_order_relaxed));
+}
+
+void buffer_budget_get_stats(buffer_owner_t owner,
+                             buffer_budget_stats_t* stats) {
+  log::assert_that(owner < BUFFER_OWNER_COUNT, "invalid buffer owner {}",
+                   static_cast<int>(owner));
+  log::assert_that(stats != nullptr, "assert failed: stats != nullptr");
+  const owner_account_t& account = accounts[owner];
+  *stats = {
+      .in_use = account.in_use.load(std::memory_order_relaxed),
+      .high_watermark = account.high_watermark.load(std::memory_order_relaxed),
+      .buffers = account.buffers.load(std::memory_order_relaxed),
+      .budget = account.budget.load(std::memory_order_relaxed),
+      .exceeded = account.exceeded.load(std::memory_order_relaxed),
+  };
+}
+
+void buffer_budget_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Buffer Memory:\n");
+  dprintf(fd,
+          "  Owner      Buffers  In use (bytes)  High watermark      Budget  "
+          "Exceeded\n");
+  for (int owner = 0; owner < BUFFER_OWNER_COUNT; owner++) {
+    buffer_budget_stats_t stats;
+    buffer_budget_get_stats(static_cast<buffer_owner_t>(owner), &stats);
+    dprintf(fd, "  %-9s  %7zu  %14zu  %14zu  %10zu  %8zu\n",
+            kOwnerNames[owner], stats.buffers, stats.in_use,
+            stats.high_watermark, stats.budget, stats.exceeded);
+  }
+  dprintf(fd, "  %-9s  %7s  %14zu  %14zu  %10zu\n", "total", "",
+          total_in_use.load(std::memory_order_relaxed),
+          total_high_watermark.load(std::memory_order_relaxed),
+          total_budget.load(std::memory_order_relaxed));
+}
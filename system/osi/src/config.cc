@@ -29,27 +29,67 @@
 #include <unistd.h>
 
 #include <cerrno>
-#include <sstream>
-#include <type_traits>
 
 using namespace bluetooth;
 
+static const std::string& item_name(const entry_t& entry) {
+  return entry.key;
+}
+
+static const std::string& item_name(const section_t& section) {
+  return section.name;
+}
+
+template <typename T>
+static void index_rebuild(std::list<T>& items, config_index_t<T>& index) {
+  index.items.clear();
+  index.items.reserve(items.size());
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    // The first of several items with the same name wins, as it would with a
+    // linear search of the list.
+    index.items.emplace(item_name(*it), it);
+  }
+}
+
+// Returns the first item of |items| named |name|, or |items.end()|.
+template <typename T>
+static typename std::list<T>::iterator index_find(std::list<T>& items,
+                                                  config_index_t<T>& index,
+                                                  const std::string& name) {
+  if (index.items.size() != items.size()) index_rebuild(items, index);
+
+  auto found = index.items.find(name);
+  if (found == index.items.end()) return items.end();
+  return found->second;
+}
+
+template <typename T>
+static void index_add(config_index_t<T>& index,
+                      typename std::list<T>::iterator item) {
+  index.items.emplace(item_name(*item), item);
+}
+
+template <typename T>
+static void index_erase(std::list<T>& items, config_index_t<T>& index,
+                        typename std::list<T>::iterator item) {
+  index.items.erase(item_name(*item));
+  items.erase(item);
+}
+
 void section_t::Set(std::string key, std::string value) {
-  for (entry_t& entry : entries) {
-    if (entry.key == key) {
-      entry.value = value;
-      return;
-    }
+  auto entry = Find(key);
+  if (entry != entries.end()) {
+    entry->value = std::move(value);
+    return;
   }
   // add a new key to the section
   entries.emplace_back(
       entry_t{.key = std::move(key), .value = std::move(value)});
+  index_add(index, std::prev(entries.end()));
 }
 
 std::list<entry_t>::iterator section_t::Find(const std::string& key) {
-  return std::find_if(
-      entries.begin(), entries.end(),
-      [&key](const entry_t& entry) { return entry.key == key; });
+  return index_find(entries, index, key);
 }
 
 bool section_t::Has(const std::string& key) {
@@ -57,9 +97,7 @@ bool section_t::Has(const std::string& key) {
 }
 
 std::list<section_t>::iterator config_t::Find(const std::string& section) {
-  return std::find_if(
-      sections.begin(), sections.end(),
-      [&section](const section_t& sec) { return sec.name == section; });
+  return index_find(sections, index, section);
 }
 
 bool config_t::Has(const std::string& key) {
@@ -68,13 +106,27 @@ bool config_t::Has(const std::string& key) {
 
 static bool config_parse(FILE* fp, config_t* config);
 
-template <typename T,
-          class = typename std::enable_if<std::is_same<
-              config_t, typename std::remove_const<T>::type>::value>>
-static auto section_find(T& config, const std::string& section) {
-  return std::find_if(
-      config.sections.begin(), config.sections.end(),
-      [&section](const section_t& sec) { return sec.name == section; });
+// The index is mutable so that lookups on a const config can rebuild it; the
+// lists themselves are left untouched.
+static std::list<section_t>::const_iterator section_find(
+    const config_t& config, const std::string& section) {
+  return const_cast<config_t&>(config).Find(section);
+}
+
+static std::list<section_t>::iterator section_find(config_t& config,
+                                                   const std::string& section) {
+  return config.Find(section);
+}
+
+static std::list<section_t>::iterator section_find_or_add(
+    config_t& config, const std::string& section) {
+  auto sec = config.Find(section);
+  if (sec == config.sections.end()) {
+    config.sections.emplace_back(section_t{.name = section});
+    sec = std::prev(config.sections.end());
+    index_add(config.index, sec);
+  }
+  return sec;
 }
 
 static const entry_t* entry_find(const config_t& config,
@@ -83,11 +135,10 @@ static const entry_t* entry_find(const config_t& config,
   auto sec = section_find(config, section);
   if (sec == config.sections.end()) return nullptr;
 
-  for (const entry_t& entry : sec->entries) {
-    if (entry.key == key) return &entry;
-  }
+  auto entry = const_cast<section_t&>(*sec).Find(key);
+  if (entry == sec->entries.end()) return nullptr;
 
-  return nullptr;
+  return &*entry;
 }
 
 std::unique_ptr<config_t> config_new_empty(void) {
@@ -207,28 +258,14 @@ void config_set_string(config_t* config, const std::string& section,
                        const std::string& key, const std::string& value) {
   log::assert_that(config != nullptr, "assert failed: config != nullptr");
 
-  auto sec = section_find(*config, section);
-  if (sec == config->sections.end()) {
-    config->sections.emplace_back(section_t{.name = section});
-    sec = std::prev(config->sections.end());
-  }
+  auto sec = section_find_or_add(*config, section);
 
-  std::string value_no_newline;
   size_t newline_position = value.find('\n');
   if (newline_position != std::string::npos) {
-    value_no_newline = value.substr(0, newline_position);
+    sec->Set(key, value.substr(0, newline_position));
   } else {
-    value_no_newline = value;
+    sec->Set(key, value);
   }
-
-  for (entry_t& entry : sec->entries) {
-    if (entry.key == key) {
-      entry.value = value_no_newline;
-      return;
-    }
-  }
-
-  sec->entries.emplace_back(entry_t{.key = key, .value = value_no_newline});
 }
 
 bool config_remove_section(config_t* config, const std::string& section) {
@@ -237,7 +274,7 @@ bool config_remove_section(config_t* config, const std::string& section) {
   auto sec = section_find(*config, section);
   if (sec == config->sections.end()) return false;
 
-  config->sections.erase(sec);
+  index_erase(config->sections, config->index, sec);
   return true;
 }
 
@@ -247,15 +284,24 @@ bool config_remove_key(config_t* config, const std::string& section,
   auto sec = section_find(*config, section);
   if (sec == config->sections.end()) return false;
 
-  for (auto entry = sec->entries.begin(); entry != sec->entries.end();
-       ++entry) {
-    if (entry->key == key) {
-      sec->entries.erase(entry);
-      return true;
+  auto entry = sec->Find(key);
+  if (entry == sec->entries.end()) return false;
+
+  index_erase(sec->entries, sec->index, entry);
+  return true;
+}
+
+// Returns the size of |config| once serialized by |config_save|, so that it
+// can be built in a single allocation.
+static size_t config_serialized_size(const config_t& config) {
+  size_t size = 0;
+  for (const section_t& section : config.sections) {
+    size += section.name.size() + strlen("[]\n\n");
+    for (const entry_t& entry : section.entries) {
+      size += entry.key.size() + entry.value.size() + strlen(" = \n");
     }
   }
-
-  return false;
+  return size;
 }
 
 bool config_save(const config_t& config, const std::string& filename) {
@@ -272,7 +318,7 @@ bool config_save(const config_t& config, const std::string& filename) {
   //    This ensures directory entries are up-to-date.
   int dir_fd = -1;
   FILE* fp = nullptr;
-  std::stringstream serialized;
+  std::string serialized;
 
   // Build temp config file based on config file (e.g. bt_config.conf.new).
   const std::string temp_filename = filename + ".new";
@@ -298,16 +344,20 @@ bool config_save(const config_t& config, const std::string& filename) {
     goto error;
   }
 
+  serialized.reserve(config_serialized_size(config));
   for (const section_t& section : config.sections) {
-    serialized << "[" << section.name << "]" << std::endl;
+    serialized.append("[").append(section.name).append("]\n");
 
-    for (const entry_t& entry : section.entries)
-      serialized << entry.key << " = " << entry.value << std::endl;
+    for (const entry_t& entry : section.entries) {
+      serialized.append(entry.key).append(" = ").append(entry.value);
+      serialized.append("\n");
+    }
 
-    serialized << std::endl;
+    serialized.append("\n");
   }
 
-  if (fprintf(fp, "%s", serialized.str().c_str()) < 0) {
+  if (fwrite(serialized.data(), 1, serialized.size(), fp) !=
+      serialized.size()) {
     log::error("unable to write to file '{}': {}", temp_filename,
                strerror(errno));
     goto error;
@@ -482,6 +532,9 @@ static bool config_parse(FILE* fp, config_t* config) {
   char line[4096];
   char section[4096];
   strcpy(section, CONFIG_DEFAULT_SECTION);
+  // The section the following keys go to, looked up on its first key only:
+  // sections without any key are not added.
+  auto sec = config->sections.end();
 
   while (fgets(line, sizeof(line), fp)) {
     char* line_ptr = trim(line);
@@ -498,6 +551,7 @@ static bool config_parse(FILE* fp, config_t* config) {
       }
       strncpy(section, line_ptr + 1, len - 2);  // NOLINT (len < 4096)
       section[len - 2] = '\0';
+      sec = config->sections.end();
     } else {
       char* split = strchr(line_ptr, '=');
       if (!split) {
@@ -506,7 +560,11 @@ static bool config_parse(FILE* fp, config_t* config) {
       }
 
       *split = '\0';
-      config_set_string(config, section, trim(line_ptr), trim(split + 1));
+      if (sec == config->sections.end()) {
+        sec = section_find_or_add(*config, section);
+      }
+      // The line was read up to its newline, and trimmed of it.
+      sec->Set(trim(line_ptr), trim(split + 1));
     }
   }
   return true;
@@ -19,11 +19,20 @@
 #include "osi/include/fixed_queue.h"
 
 #include <bluetooth/log.h>
+#include <errno.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
 #include <mutex>
+#include <vector>
 
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_budget.h"
 #include "osi/include/list.h"
 #include "osi/include/osi.h"
 #include "osi/include/reactor.h"
@@ -31,6 +40,46 @@
 
 using namespace bluetooth;
 
+namespace {
+
+// An eventfd that is readable while |count| is positive. |count| is only
+// written to the eventfd when it goes from 0 to 1, so that the common case of
+// a ring queue that is neither empty nor full makes no system call.
+struct doorbell_t {
+  std::atomic<int64_t> count;
+  int fd;
+};
+
+// A cell of a ring queue. |sequence| tells which lap of the ring the cell is
+// in: the position of the next enqueue in it while empty, that position plus
+// one while full.
+struct ring_cell_t {
+  std::atomic<size_t> sequence;
+  std::atomic<void*> data;
+};
+
+// The bounded queue of Dmitry Vyukov: producers and consumers claim a
+// position with a compare-and-swap (a plain store with a single producer or
+// consumer), then publish the cell through its sequence.
+struct ring_t {
+  ring_t(size_t capacity, bool multi_thread)
+      : cells(capacity), multi_thread(multi_thread) {
+    for (size_t i = 0; i < capacity; i++) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+      cells[i].data.store(NULL, std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<ring_cell_t> cells;
+  const bool multi_thread;
+  alignas(64) std::atomic<size_t> enqueue_pos{0};
+  alignas(64) std::atomic<size_t> dequeue_pos{0};
+  doorbell_t items;  // Dequeue side: number of elements in the queue
+  doorbell_t space;  // Enqueue side: number of free cells
+};
+
+}  // namespace
+
 typedef struct fixed_queue_t {
   list_t* list;
   semaphore_t* enqueue_sem;
@@ -38,20 +87,60 @@ typedef struct fixed_queue_t {
   std::mutex* mutex;
   size_t capacity;
 
+  ring_t* ring;  // Instead of all of the above but |capacity| for ring queues
+
+  bool has_buffer_owner;  // The queued buffers are charged to |buffer_owner|
+  buffer_owner_t buffer_owner;
+
   reactor_object_t* dequeue_object;
   fixed_queue_cb dequeue_ready;
   void* dequeue_context;
 } fixed_queue_t;
 
 static void internal_dequeue_ready(void* context);
+static void charge(fixed_queue_t* queue, void* data);
+static void release(fixed_queue_t* queue, void* data);
+static void doorbell_settle(doorbell_t* doorbell);
+static void doorbell_wait(doorbell_t* doorbell);
+static bool ring_try_enqueue(ring_t* ring, void* data);
+static void* ring_try_dequeue(ring_t* ring);
+static size_t ring_length(const ring_t* ring);
+static void ring_free(ring_t* ring);
 
 fixed_queue_t* fixed_queue_new(size_t capacity) {
+  return fixed_queue_new_with_type(capacity, FIXED_QUEUE_LIST);
+}
+
+fixed_queue_t* fixed_queue_new_with_type(size_t capacity,
+                                         fixed_queue_type_t type) {
+  if (type != FIXED_QUEUE_LIST &&
+      (capacity == 0 || capacity > FIXED_QUEUE_RING_MAX_CAPACITY)) {
+    log::error("invalid ring queue capacity {}", capacity);
+    return NULL;
+  }
+
   fixed_queue_t* ret =
       static_cast<fixed_queue_t*>(osi_calloc(sizeof(fixed_queue_t)));
 
-  ret->mutex = new std::mutex;
   ret->capacity = capacity;
 
+  if (type != FIXED_QUEUE_LIST) {
+    ret->ring = new ring_t(capacity, type == FIXED_QUEUE_RING_MPMC);
+    ret->ring->items.count.store(0);
+    ret->ring->items.fd = eventfd(0, EFD_NONBLOCK);
+    ret->ring->space.count.store(capacity);
+    ret->ring->space.fd = eventfd(1, EFD_NONBLOCK);
+    if (ret->ring->items.fd == INVALID_FD ||
+        ret->ring->space.fd == INVALID_FD) {
+      log::error("unable to allocate ring queue eventfd: {}",
+                 strerror(errno));
+      goto error;
+    }
+    return ret;
+  }
+
+  ret->mutex = new std::mutex;
+
   ret->list = list_new(NULL);
   if (!ret->list) goto error;
 
@@ -73,10 +162,22 @@ void fixed_queue_free(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
 
   fixed_queue_unregister_dequeue(queue);
 
-  if (free_cb)
-    for (const list_node_t* node = list_begin(queue->list);
-         node != list_end(queue->list); node = list_next(node))
-      free_cb(list_node(node));
+  if (queue->ring) {
+    for (void* data = ring_try_dequeue(queue->ring); data != NULL;
+         data = ring_try_dequeue(queue->ring)) {
+      release(queue, data);
+      if (free_cb) free_cb(data);
+    }
+    ring_free(queue->ring);
+    osi_free(queue);
+    return;
+  }
+
+  for (const list_node_t* node = list_begin(queue->list);
+       node != list_end(queue->list); node = list_next(node)) {
+    release(queue, list_node(node));
+    if (free_cb) free_cb(list_node(node));
+  }
 
   list_free(queue->list);
   semaphore_free(queue->enqueue_sem);
@@ -98,6 +199,7 @@ void fixed_queue_flush(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
 
 bool fixed_queue_is_empty(fixed_queue_t* queue) {
   if (queue == NULL) return true;
+  if (queue->ring) return ring_length(queue->ring) == 0;
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list);
@@ -105,6 +207,7 @@ bool fixed_queue_is_empty(fixed_queue_t* queue) {
 
 size_t fixed_queue_length(fixed_queue_t* queue) {
   if (queue == NULL) return 0;
+  if (queue->ring) return ring_length(queue->ring);
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_length(queue->list);
@@ -116,10 +219,29 @@ size_t fixed_queue_capacity(fixed_queue_t* queue) {
   return queue->capacity;
 }
 
+void fixed_queue_set_buffer_owner(fixed_queue_t* queue, buffer_owner_t owner) {
+  log::assert_that(queue != NULL, "assert failed: queue != NULL");
+  log::assert_that(fixed_queue_is_empty(queue),
+                   "assert failed: fixed_queue_is_empty(queue)");
+
+  queue->has_buffer_owner = true;
+  queue->buffer_owner = owner;
+}
+
 void fixed_queue_enqueue(fixed_queue_t* queue, void* data) {
   log::assert_that(queue != NULL, "assert failed: queue != NULL");
   log::assert_that(data != NULL, "assert failed: data != NULL");
 
+  // Charged before it can be dequeued and released
+  charge(queue, data);
+
+  if (queue->ring) {
+    while (!ring_try_enqueue(queue->ring, data)) {
+      doorbell_wait(&queue->ring->space);
+    }
+    return;
+  }
+
   semaphore_wait(queue->enqueue_sem);
 
   {
@@ -133,6 +255,15 @@ void fixed_queue_enqueue(fixed_queue_t* queue, void* data) {
 void* fixed_queue_dequeue(fixed_queue_t* queue) {
   log::assert_that(queue != NULL, "assert failed: queue != NULL");
 
+  if (queue->ring) {
+    void* data;
+    while ((data = ring_try_dequeue(queue->ring)) == NULL) {
+      doorbell_wait(&queue->ring->items);
+    }
+    release(queue, data);
+    return data;
+  }
+
   semaphore_wait(queue->dequeue_sem);
 
   void* ret = NULL;
@@ -144,6 +275,7 @@ void* fixed_queue_dequeue(fixed_queue_t* queue) {
 
   semaphore_post(queue->enqueue_sem);
 
+  release(queue, ret);
   return ret;
 }
 
@@ -151,7 +283,18 @@ bool fixed_queue_try_enqueue(fixed_queue_t* queue, void* data) {
   log::assert_that(queue != NULL, "assert failed: queue != NULL");
   log::assert_that(data != NULL, "assert failed: data != NULL");
 
-  if (!semaphore_try_wait(queue->enqueue_sem)) return false;
+  charge(queue, data);
+
+  if (queue->ring) {
+    if (ring_try_enqueue(queue->ring, data)) return true;
+    release(queue, data);
+    return false;
+  }
+
+  if (!semaphore_try_wait(queue->enqueue_sem)) {
+    release(queue, data);
+    return false;
+  }
 
   {
     std::lock_guard<std::mutex> lock(*queue->mutex);
@@ -165,6 +308,12 @@ bool fixed_queue_try_enqueue(fixed_queue_t* queue, void* data) {
 void* fixed_queue_try_dequeue(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
 
+  if (queue->ring) {
+    void* data = ring_try_dequeue(queue->ring);
+    if (data != NULL) release(queue, data);
+    return data;
+  }
+
   if (!semaphore_try_wait(queue->dequeue_sem)) return NULL;
 
   void* ret = NULL;
@@ -176,12 +325,21 @@ void* fixed_queue_try_dequeue(fixed_queue_t* queue) {
 
   semaphore_post(queue->enqueue_sem);
 
+  release(queue, ret);
   return ret;
 }
 
 void* fixed_queue_try_peek_first(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
 
+  if (queue->ring) {
+    const ring_t* ring = queue->ring;
+    size_t pos = ring->dequeue_pos.load(std::memory_order_acquire);
+    const ring_cell_t& cell = ring->cells[pos % ring->cells.size()];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) return NULL;
+    return cell.data.load(std::memory_order_relaxed);
+  }
+
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list) ? NULL : list_front(queue->list);
 }
@@ -189,12 +347,23 @@ void* fixed_queue_try_peek_first(fixed_queue_t* queue) {
 void* fixed_queue_try_peek_last(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
 
+  if (queue->ring) {
+    const ring_t* ring = queue->ring;
+    size_t pos = ring->enqueue_pos.load(std::memory_order_acquire);
+    if (pos == ring->dequeue_pos.load(std::memory_order_acquire)) return NULL;
+    const ring_cell_t& cell = ring->cells[(pos - 1) % ring->cells.size()];
+    if (cell.sequence.load(std::memory_order_acquire) != pos) return NULL;
+    return cell.data.load(std::memory_order_relaxed);
+  }
+
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list) ? NULL : list_back(queue->list);
 }
 
 void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
   if (queue == NULL) return NULL;
+  log::assert_that(queue->ring == NULL,
+                   "assert failed: not supported by ring queues");
 
   bool removed = false;
   {
@@ -208,6 +377,7 @@ void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
 
   if (removed) {
     semaphore_post(queue->enqueue_sem);
+    release(queue, data);
     return data;
   }
   return NULL;
@@ -215,6 +385,8 @@ void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
 
 list_t* fixed_queue_get_list(fixed_queue_t* queue) {
   log::assert_that(queue != NULL, "assert failed: queue != NULL");
+  log::assert_that(queue->ring == NULL,
+                   "assert failed: not supported by ring queues");
 
   // NOTE: Using the list in this way is not thread-safe.
   // Using this list in any context where threads can call other functions
@@ -224,11 +396,13 @@ list_t* fixed_queue_get_list(fixed_queue_t* queue) {
 
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   log::assert_that(queue != NULL, "assert failed: queue != NULL");
+  if (queue->ring) return queue->ring->items.fd;
   return semaphore_get_fd(queue->dequeue_sem);
 }
 
 int fixed_queue_get_enqueue_fd(const fixed_queue_t* queue) {
   log::assert_that(queue != NULL, "assert failed: queue != NULL");
+  if (queue->ring) return queue->ring->space.fd;
   return semaphore_get_fd(queue->enqueue_sem);
 }
 
@@ -257,9 +431,130 @@ void fixed_queue_unregister_dequeue(fixed_queue_t* queue) {
   }
 }
 
+static void charge(fixed_queue_t* queue, void* data) {
+  if (queue->has_buffer_owner) buffer_budget_charge(queue->buffer_owner, data);
+}
+
+static void release(fixed_queue_t* queue, void* data) {
+  if (queue->has_buffer_owner) {
+    buffer_budget_release(queue->buffer_owner, data);
+  }
+}
+
 static void internal_dequeue_ready(void* context) {
   log::assert_that(context != NULL, "assert failed: context != NULL");
 
   fixed_queue_t* queue = static_cast<fixed_queue_t*>(context);
+  // With several consumers the eventfd of a ring can be left readable after
+  // the queue was emptied: settle it rather than spin the reactor.
+  if (queue->ring && ring_length(queue->ring) == 0) {
+    doorbell_settle(&queue->ring->items);
+    return;
+  }
   queue->dequeue_ready(queue, queue->dequeue_context);
 }
+
+// Wakes the waiters of |doorbell| if |count| goes from 0 to 1.
+static void doorbell_add(doorbell_t* doorbell) {
+  if (doorbell->count.fetch_add(1) == 0) {
+    if (eventfd_write(doorbell->fd, 1) == -1)
+      log::error("unable to write doorbell eventfd: {}", strerror(errno));
+  }
+}
+
+// Makes the eventfd of |doorbell| readable if and only if |count| is
+// positive, re-checking after the read so that a concurrent doorbell_add() is
+// not lost.
+static void doorbell_settle(doorbell_t* doorbell) {
+  eventfd_t value;
+  eventfd_read(doorbell->fd, &value);
+  if (doorbell->count.load() > 0) {
+    if (eventfd_write(doorbell->fd, 1) == -1)
+      log::error("unable to write doorbell eventfd: {}", strerror(errno));
+  }
+}
+
+static void doorbell_take(doorbell_t* doorbell) {
+  if (doorbell->count.fetch_sub(1) == 1) doorbell_settle(doorbell);
+}
+
+// Blocks until |doorbell| may have gone positive.
+static void doorbell_wait(doorbell_t* doorbell) {
+  doorbell_settle(doorbell);
+  struct pollfd pfd = {.fd = doorbell->fd, .events = POLLIN, .revents = 0};
+  int ret;
+  OSI_NO_INTR(ret = poll(&pfd, 1, -1));
+  if (ret == -1) log::error("unable to poll doorbell: {}", strerror(errno));
+}
+
+static bool ring_try_enqueue(ring_t* ring, void* data) {
+  size_t capacity = ring->cells.size();
+  size_t pos = ring->enqueue_pos.load(std::memory_order_relaxed);
+  ring_cell_t* cell;
+  for (;;) {
+    cell = &ring->cells[pos % capacity];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+    if (diff < 0) return false;  // The cell still holds the previous lap
+    if (diff > 0) {
+      pos = ring->enqueue_pos.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (!ring->multi_thread) {
+      ring->enqueue_pos.store(pos + 1, std::memory_order_relaxed);
+      break;
+    }
+    if (ring->enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+      break;
+  }
+  cell->data.store(data, std::memory_order_relaxed);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+
+  doorbell_take(&ring->space);
+  doorbell_add(&ring->items);
+  return true;
+}
+
+static void* ring_try_dequeue(ring_t* ring) {
+  size_t capacity = ring->cells.size();
+  size_t pos = ring->dequeue_pos.load(std::memory_order_relaxed);
+  ring_cell_t* cell;
+  for (;;) {
+    cell = &ring->cells[pos % capacity];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+    if (diff < 0) return NULL;  // The cell was not filled yet
+    if (diff > 0) {
+      pos = ring->dequeue_pos.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (!ring->multi_thread) {
+      ring->dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+      break;
+    }
+    if (ring->dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+      break;
+  }
+  void* data = cell->data.load(std::memory_order_relaxed);
+  cell->sequence.store(pos + capacity, std::memory_order_release);
+
+  doorbell_take(&ring->items);
+  doorbell_add(&ring->space);
+  return data;
+}
+
+// Counts the cells claimed by producers and not yet claimed by consumers.
+static size_t ring_length(const ring_t* ring) {
+  // Loading the dequeue position first keeps the difference positive
+  size_t dequeue_pos = ring->dequeue_pos.load(std::memory_order_acquire);
+  size_t enqueue_pos = ring->enqueue_pos.load(std::memory_order_acquire);
+  return std::min(enqueue_pos - dequeue_pos, ring->cells.size());
+}
+
+static void ring_free(ring_t* ring) {
+  if (ring->items.fd != INVALID_FD) close(ring->items.fd);
+  if (ring->space.fd != INVALID_FD) close(ring->space.fd);
+  delete ring;
+}
@@ -0,0 +1,218 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_timer_wheel"
+
+#include "osi/timer_wheel.h"
+
+#include <bluetooth/log.h>
+
+#include "osi/include/allocator.h"
+
+using namespace bluetooth;
+
+// Each level has 64 slots and is 64 times coarser than the level below it:
+// level 0 slots are 1 ms wide, level 1 slots 64 ms, and so on. Five levels
+// cover 2^30 ms (about 12 days) ahead of the wheel clock; later deadlines are
+// kept in an overflow list.
+static const int kSlotBits = 6;
+static const int kSlots = 1 << kSlotBits;
+static const int kLevels = 5;
+
+struct timer_wheel_t {
+  // Every node was placed relative to a clock at or before the current one,
+  // and no node has a deadline before it except those added since the clock
+  // last moved. Together this keeps slot order equal to deadline order.
+  uint64_t clock_ms;
+  size_t size;
+  uint64_t occupied[kLevels];  // One bit per non empty slot
+  timer_wheel_node_t slots[kLevels][kSlots];
+  timer_wheel_node_t overflow;
+  timer_wheel_node_t* earliest;  // NULL when not known yet or empty
+};
+
+static void slot_init(timer_wheel_node_t* head) {
+  head->next = head;
+  head->prev = head;
+}
+
+static bool slot_is_empty(const timer_wheel_node_t* head) {
+  return head->next == head;
+}
+
+static timer_wheel_node_t* slot_head(timer_wheel_t* wheel, int level,
+                                     int slot) {
+  return level == kLevels ? &wheel->overflow : &wheel->slots[level][slot];
+}
+
+// Returns whichever of |best| and the nodes of slot |head| is due first.
+// Earlier nodes win ties, which keeps equal deadlines in insertion order.
+static timer_wheel_node_t* slot_min(timer_wheel_node_t* head,
+                                    timer_wheel_node_t* best) {
+  for (timer_wheel_node_t* node = head->next; node != head; node = node->next) {
+    if (best == NULL || node->deadline_ms < best->deadline_ms) best = node;
+  }
+  return best;
+}
+
+timer_wheel_t* timer_wheel_new(uint64_t now_ms) {
+  timer_wheel_t* wheel =
+      static_cast<timer_wheel_t*>(osi_calloc(sizeof(timer_wheel_t)));
+  wheel->clock_ms = now_ms;
+  for (int level = 0; level < kLevels; level++) {
+    for (int slot = 0; slot < kSlots; slot++) {
+      slot_init(&wheel->slots[level][slot]);
+    }
+  }
+  slot_init(&wheel->overflow);
+  return wheel;
+}
+
+void timer_wheel_free(timer_wheel_t* wheel) {
+  if (!wheel) return;
+
+  // Unlink the remaining nodes, so their owners see them as not scheduled
+  while (wheel->size) {
+    timer_wheel_remove(wheel, timer_wheel_peek(wheel));
+  }
+  osi_free(wheel);
+}
+
+void timer_wheel_add(timer_wheel_t* wheel, timer_wheel_node_t* node) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  log::assert_that(node != NULL, "assert failed: node != NULL");
+  log::assert_that(node->next == NULL, "assert failed: node->next == NULL");
+
+  // Past deadlines are placed at the current clock, so they come out first.
+  uint64_t deadline_ms = node->deadline_ms > wheel->clock_ms
+                             ? node->deadline_ms
+                             : wheel->clock_ms;
+
+  // Use the finest level whose 64 slots, starting at the clock, reach the
+  // deadline.
+  int level = 0;
+  int slot = 0;
+  for (; level < kLevels; level++) {
+    int shift = level * kSlotBits;
+    uint64_t blocks_ahead = (deadline_ms >> shift) - (wheel->clock_ms >> shift);
+    if (blocks_ahead < (uint64_t)kSlots) {
+      slot = (deadline_ms >> shift) & (kSlots - 1);
+      wheel->occupied[level] |= 1ULL << slot;
+      break;
+    }
+  }
+
+  timer_wheel_node_t* head = slot_head(wheel, level, slot);
+  node->level = level;
+  node->slot = slot;
+  node->prev = head->prev;
+  node->next = head;
+  head->prev->next = node;
+  head->prev = node;
+  wheel->size++;
+
+  if (wheel->size == 1 || (wheel->earliest != NULL &&
+                           node->deadline_ms < wheel->earliest->deadline_ms)) {
+    wheel->earliest = node;
+  }
+}
+
+void timer_wheel_remove(timer_wheel_t* wheel, timer_wheel_node_t* node) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  if (node == NULL || node->next == NULL) return;
+
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+  node->next = NULL;
+  node->prev = NULL;
+
+  if (node->level < kLevels &&
+      slot_is_empty(slot_head(wheel, node->level, node->slot))) {
+    wheel->occupied[node->level] &= ~(1ULL << node->slot);
+  }
+  wheel->size--;
+  if (wheel->earliest == node) wheel->earliest = NULL;
+}
+
+bool timer_wheel_contains(const timer_wheel_node_t* node) {
+  return node != NULL && node->next != NULL;
+}
+
+timer_wheel_node_t* timer_wheel_peek(timer_wheel_t* wheel) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  if (wheel->earliest != NULL || wheel->size == 0) return wheel->earliest;
+
+  // Within a level, the first occupied slot after the clock holds the
+  // earliest deadlines of that level. Compare those across levels.
+  timer_wheel_node_t* best = NULL;
+  for (int level = 0; level < kLevels; level++) {
+    uint64_t occupied = wheel->occupied[level];
+    if (occupied == 0) continue;
+
+    int base = (wheel->clock_ms >> (level * kSlotBits)) & (kSlots - 1);
+    uint64_t rotated =
+        (occupied >> base) | (occupied << ((kSlots - base) & (kSlots - 1)));
+    int slot = (base + __builtin_ctzll(rotated)) & (kSlots - 1);
+    best = slot_min(&wheel->slots[level][slot], best);
+  }
+  best = slot_min(&wheel->overflow, best);
+
+  wheel->earliest = best;
+  return best;
+}
+
+timer_wheel_node_t* timer_wheel_pop_expired(timer_wheel_t* wheel,
+                                            uint64_t now_ms) {
+  timer_wheel_node_t* node = timer_wheel_peek(wheel);
+  if (node != NULL && node->deadline_ms <= now_ms) {
+    timer_wheel_remove(wheel, node);
+    // Nothing left is due before |node|, so the clock can move up to it.
+    if (node->deadline_ms > wheel->clock_ms) {
+      wheel->clock_ms = node->deadline_ms;
+    }
+    return node;
+  }
+
+  // Every deadline is after |now_ms|, so the clock can move up to it.
+  if (now_ms > wheel->clock_ms) wheel->clock_ms = now_ms;
+  return NULL;
+}
+
+size_t timer_wheel_size(const timer_wheel_t* wheel) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  return wheel->size;
+}
+
+void timer_wheel_foreach(timer_wheel_t* wheel, timer_wheel_iter_cb callback,
+                         void* context) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  log::assert_that(callback != NULL, "assert failed: callback != NULL");
+
+  for (int level = 0; level <= kLevels; level++) {
+    for (int slot = 0; slot < (level == kLevels ? 1 : kSlots); slot++) {
+      if (level < kLevels && !(wheel->occupied[level] & (1ULL << slot))) {
+        continue;
+      }
+      timer_wheel_node_t* head = slot_head(wheel, level, slot);
+      for (timer_wheel_node_t* node = head->next; node != head;
+           node = node->next) {
+        if (!callback(node, context)) return;
+      }
+    }
+  }
+}
@@ -20,6 +20,9 @@
 
 #include <bluetooth/log.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "osi/include/allocator.h"
 
@@ -65,10 +68,31 @@ size_t ringbuffer_insert(ringbuffer_t* rb, const uint8_t* p, size_t length) {
 
   if (length > ringbuffer_available(rb)) length = ringbuffer_available(rb);
 
-  for (size_t i = 0; i != length; ++i) {
-    *rb->tail++ = *p++;
-    if (rb->tail >= (rb->base + rb->total)) rb->tail = rb->base;
-  }
+  // The data goes in at most two segments: up to the end of the buffer, then
+  // from its start.
+  const size_t first =
+      std::min(length, (size_t)(rb->base + rb->total - rb->tail));
+  memcpy(rb->tail, p, first);
+  memcpy(rb->base, p + first, length - first);
+
+  return ringbuffer_commit(rb, length);
+}
+
+size_t ringbuffer_reserve(ringbuffer_t* rb, uint8_t** p) {
+  log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
+  log::assert_that(p != nullptr, "assert failed: p != nullptr");
+
+  *p = rb->tail;
+  return std::min(rb->available, (size_t)(rb->base + rb->total - rb->tail));
+}
+
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
+
+  if (length > ringbuffer_available(rb)) length = ringbuffer_available(rb);
+
+  rb->tail += length;
+  if (rb->tail >= (rb->base + rb->total)) rb->tail -= rb->total;
 
   rb->available -= length;
   return length;
@@ -94,19 +118,28 @@ size_t ringbuffer_peek(const ringbuffer_t* rb, off_t offset, uint8_t* p,
   log::assert_that((size_t)offset <= ringbuffer_size(rb),
                    "assert failed: (size_t)offset <= ringbuffer_size(rb)");
 
-  uint8_t* b = ((rb->head - rb->base + offset) % rb->total) + rb->base;
+  const uint8_t* b = ((rb->head - rb->base + offset) % rb->total) + rb->base;
   const size_t bytes_to_copy = (offset + length > ringbuffer_size(rb))
                                    ? ringbuffer_size(rb) - offset
                                    : length;
 
-  for (size_t copied = 0; copied < bytes_to_copy; ++copied) {
-    *p++ = *b++;
-    if (b >= (rb->base + rb->total)) b = rb->base;
-  }
+  const size_t first =
+      std::min(bytes_to_copy, (size_t)(rb->base + rb->total - b));
+  memcpy(p, b, first);
+  memcpy(p + first, rb->base, bytes_to_copy - first);
 
   return bytes_to_copy;
 }
 
+size_t ringbuffer_peek_contiguous(const ringbuffer_t* rb, const uint8_t** p) {
+  log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
+  log::assert_that(p != nullptr, "assert failed: p != nullptr");
+
+  *p = rb->head;
+  return std::min(ringbuffer_size(rb),
+                  (size_t)(rb->base + rb->total - rb->head));
+}
+
 size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length) {
   log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
   log::assert_that(p != nullptr, "assert failed: p != nullptr");
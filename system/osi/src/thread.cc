@@ -32,6 +32,7 @@
 #include <atomic>
 #include <cerrno>
 
+#include "common/thread_policy.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
@@ -76,7 +77,11 @@ thread_t* thread_new_sized(const char* name, size_t work_queue_capacity) {
   ret->reactor = reactor_new();
   if (!ret->reactor) goto error;
 
-  ret->work_queue = fixed_queue_new(work_queue_capacity);
+  // Any thread posts, only |ret| dequeues. Unbounded queues stay lists.
+  ret->work_queue = fixed_queue_new_with_type(
+      work_queue_capacity, work_queue_capacity <= FIXED_QUEUE_RING_MAX_CAPACITY
+                               ? FIXED_QUEUE_RING_MPMC
+                               : FIXED_QUEUE_LIST);
   if (!ret->work_queue) goto error;
 
   // Start is on the stack, but we use a semaphore, so it's safe
@@ -207,6 +212,7 @@ static void* run_thread(void* start_arg) {
     return NULL;
   }
   thread->tid = gettid();
+  bluetooth::common::ApplyThreadPolicy(thread->name);
 
   log::info("thread id {}, thread name {} started", thread->tid, thread->name);
 
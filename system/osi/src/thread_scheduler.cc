@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include "osi/include/thread_scheduler.h"
+
 #include <sched.h>
 #include <sys/types.h>
 
@@ -22,8 +24,13 @@ constexpr int kRealTimeFifoSchedulingPriority = 1;
 }  // namespace
 
 bool thread_scheduler_enable_real_time(pid_t linux_tid) {
-  struct sched_param rt_params = {.sched_priority =
-                                      kRealTimeFifoSchedulingPriority};
+  return thread_scheduler_enable_real_time_priority(
+      linux_tid, kRealTimeFifoSchedulingPriority);
+}
+
+bool thread_scheduler_enable_real_time_priority(pid_t linux_tid,
+                                                int priority) {
+  struct sched_param rt_params = {.sched_priority = priority};
   return sched_setscheduler(linux_tid, SCHED_FIFO, &rt_params) == 0;
 }
 
@@ -32,3 +39,17 @@ bool thread_scheduler_get_priority_range(int& min, int& max) {
   max = sched_get_priority_max(SCHED_FIFO);
   return (min != -1 && max != -1) ? true : false;
 }
+
+bool thread_scheduler_set_cpu_affinity(pid_t linux_tid, uint64_t cpu_mask) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+    if (cpu_mask & (UINT64_C(1) << cpu)) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  if (CPU_COUNT(&cpu_set) == 0) {
+    return false;
+  }
+  return sched_setaffinity(linux_tid, sizeof(cpu_set), &cpu_set) == 0;
+}
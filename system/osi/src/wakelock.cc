@@ -30,8 +30,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "common/metrics.h"
 #include "os/log.h"
@@ -54,6 +57,22 @@ static pthread_once_t initialized = PTHREAD_ONCE_INIT;
 static int wake_lock_fd = INVALID_FD;
 static int wake_unlock_fd = INVALID_FD;
 
+// The wakelock is held while |acquire_count| is non-zero, and released
+// |release_delay_ms| after it drops back to zero by |release_thread|: an
+// acquire within that window keeps the wakelock held rather than paying for
+// a release and an acquire. These are protected by |wakelock_mutex|.
+static std::mutex wakelock_mutex;
+static std::condition_variable release_cv;
+static size_t acquire_count = 0;
+static bool is_held = false;
+static bool release_pending = false;
+static std::chrono::steady_clock::time_point release_deadline;
+static uint64_t release_delay_ms = 0;
+// Not a plain static, which would terminate the process at exit if the
+// thread is still running.
+static std::thread* release_thread = nullptr;
+static bool release_thread_stop = false;
+
 // Wakelock statistics for the "bluetooth_timer"
 typedef struct {
   bool is_acquired;
@@ -70,6 +89,9 @@ typedef struct {
   uint64_t last_reset_timestamp_ms;
   int last_acquired_error;
   int last_released_error;
+  size_t nested_acquired_count;
+  size_t nested_released_count;
+  size_t cancelled_release_count;
 } wakelock_stats_t;
 
 static wakelock_stats_t wakelock_stats;
@@ -82,11 +104,14 @@ static bt_status_t wakelock_acquire_callout(void);
 static bt_status_t wakelock_acquire_native(void);
 static bt_status_t wakelock_release_callout(void);
 static bt_status_t wakelock_release_native(void);
+static bool wakelock_release_locked(void);
+static void wakelock_release_run(void);
 static void wakelock_initialize(void);
 static void wakelock_initialize_native(void);
 static void reset_wakelock_stats(void);
 static void update_wakelock_acquired_stats(bt_status_t acquired_status);
 static void update_wakelock_released_stats(bt_status_t released_status);
+static void update_wakelock_avoided_stats(bool acquired, bool cancelled);
 
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
   wakelock_os_callouts = callouts;
@@ -97,6 +122,14 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 bool wakelock_acquire(void) {
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  acquire_count++;
+  if (is_held) {
+    update_wakelock_avoided_stats(true, release_pending);
+    release_pending = false;
+    return true;
+  }
+
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -104,6 +137,7 @@ bool wakelock_acquire(void) {
   else
     status = wakelock_acquire_callout();
 
+  is_held = (status == BT_STATUS_SUCCESS);
   update_wakelock_acquired_stats(status);
 
   if (status != BT_STATUS_SUCCESS)
@@ -143,6 +177,28 @@ static bt_status_t wakelock_acquire_native(void) {
 bool wakelock_release(void) {
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  if (acquire_count > 0) acquire_count--;
+  if (acquire_count > 0) {
+    update_wakelock_avoided_stats(false, false);
+    return true;
+  }
+  if (!is_held) return true;
+
+  if (release_delay_ms == 0) return wakelock_release_locked();
+
+  release_pending = true;
+  release_deadline = std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(release_delay_ms);
+  if (release_thread == nullptr) {
+    release_thread = new std::thread(wakelock_release_run);
+  }
+  release_cv.notify_one();
+  return true;
+}
+
+// Releases the wakelock now. |wakelock_mutex| must be held.
+static bool wakelock_release_locked(void) {
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -150,11 +206,28 @@ bool wakelock_release(void) {
   else
     status = wakelock_release_callout();
 
+  is_held = false;
+  release_pending = false;
   update_wakelock_released_stats(status);
 
   return (status == BT_STATUS_SUCCESS);
 }
 
+// Releases the wakelock once the release delay has run out without another
+// acquire, until |wakelock_cleanup| stops it.
+static void wakelock_release_run(void) {
+  std::unique_lock<std::mutex> lock(wakelock_mutex);
+  while (!release_thread_stop) {
+    if (!release_pending) {
+      release_cv.wait(lock);
+    } else if (std::chrono::steady_clock::now() < release_deadline) {
+      release_cv.wait_until(lock, release_deadline);
+    } else {
+      wakelock_release_locked();
+    }
+  }
+}
+
 static bt_status_t wakelock_release_callout(void) {
   return static_cast<bt_status_t>(
       wakelock_os_callouts->release_wake_lock(WAKE_LOCK_ID));
@@ -201,15 +274,36 @@ static void wakelock_initialize_native(void) {
 }
 
 void wakelock_cleanup(void) {
-  if (wakelock_stats.is_acquired) {
-    log::error("releasing wake lock as part of cleanup");
-    wakelock_release();
+  {
+    std::lock_guard<std::mutex> lock(wakelock_mutex);
+    release_thread_stop = true;
+  }
+  release_cv.notify_one();
+  if (release_thread != nullptr) {
+    release_thread->join();
+    delete release_thread;
+    release_thread = nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(wakelock_mutex);
+    release_thread_stop = false;
+    if (acquire_count > 0) {
+      log::error("releasing wake lock as part of cleanup");
+      acquire_count = 0;
+    }
+    if (is_held) wakelock_release_locked();
   }
   wake_lock_path.clear();
   wake_unlock_path.clear();
   initialized = PTHREAD_ONCE_INIT;
 }
 
+void wakelock_set_release_delay_ms(uint64_t delay_ms) {
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  release_delay_ms = delay_ms;
+}
+
 void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   if (lock_path) wake_lock_path = lock_path;
 
@@ -243,6 +337,9 @@ static void reset_wakelock_stats(void) {
   wakelock_stats.last_acquired_timestamp_ms = 0;
   wakelock_stats.last_released_timestamp_ms = 0;
   wakelock_stats.last_reset_timestamp_ms = now_ms();
+  wakelock_stats.nested_acquired_count = 0;
+  wakelock_stats.nested_released_count = 0;
+  wakelock_stats.cancelled_release_count = 0;
 }
 
 //
@@ -317,6 +414,26 @@ static void update_wakelock_released_stats(bt_status_t released_status) {
       bluetooth::common::WAKE_EVENT_RELEASED, "", "", just_now_ms);
 }
 
+//
+// Update the Bluetooth wakelock statistics of the acquires and releases that
+// did not need to reach the wakelock.
+//
+// |acquired| tells whether it was an acquire or a release, and |cancelled|
+// whether the acquire cancelled a delayed release.
+// This function is thread-safe.
+//
+static void update_wakelock_avoided_stats(bool acquired, bool cancelled) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+
+  if (cancelled) {
+    wakelock_stats.cancelled_release_count++;
+  } else if (acquired) {
+    wakelock_stats.nested_acquired_count++;
+  } else {
+    wakelock_stats.nested_released_count++;
+  }
+}
+
 void wakelock_debug_dump(int fd) {
   const uint64_t just_now_ms = now_ms();
 
@@ -362,4 +479,14 @@ void wakelock_debug_dump(int fd) {
   dprintf(fd, "  Total run time (ms)            : %llu\n",
           (unsigned long long)(just_now_ms -
                                wakelock_stats.last_reset_timestamp_ms));
+  dprintf(fd, "  Nested acquired/released count : %zu / %zu\n",
+          wakelock_stats.nested_acquired_count,
+          wakelock_stats.nested_released_count);
+  dprintf(fd, "  Cancelled delayed releases     : %zu\n",
+          wakelock_stats.cancelled_release_count);
+  // A cancelled release saves both the release and the next acquire
+  dprintf(fd, "  Wakelock calls avoided         : %zu\n",
+          wakelock_stats.nested_acquired_count +
+              wakelock_stats.nested_released_count +
+              2 * wakelock_stats.cancelled_release_count);
 }
@@ -144,6 +144,23 @@ TEST_F(AlarmTest, test_set_short) {
   alarm_free(alarm);
 }
 
+TEST_F(AlarmTest, test_set_with_slack) {
+  alarm_t* alarm = alarm_new("alarm_test.test_set_with_slack");
+
+  alarm_set_with_slack(alarm, 10, 8, cb, NULL);
+
+  // The deadline may move up to the slack later, never earlier
+  uint64_t remaining_ms = alarm_get_remaining_ms(alarm);
+  EXPECT_LE(remaining_ms, 18u);
+  EXPECT_EQ(cb_counter, 0);
+
+  semaphore_wait(semaphore);
+
+  EXPECT_EQ(cb_counter, 1);
+
+  alarm_free(alarm);
+}
+
 TEST_F(AlarmTest, test_set_short_periodic) {
   alarm_t* alarm = alarm_new_periodic("alarm_test.test_set_short_periodic");
 
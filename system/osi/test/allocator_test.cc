@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include <cstring>
+#include <thread>
 
 class AllocatorTest : public ::testing::Test {};
 
@@ -48,3 +49,66 @@ TEST_F(AllocatorTest, test_osi_strndup) {
   EXPECT_EQ(0, strcmp(str, copy_str));
   osi_free(copy_str);
 }
+
+static osi_allocator_pool_stats_t get_pool_stats(size_t size) {
+  osi_allocator_pool_stats_t stats[16];
+  size_t count = osi_allocator_pool_get_stats(stats, 16);
+  for (size_t i = 0; i < count; i++) {
+    if (size <= stats[i].block_size) return stats[i];
+  }
+  return {};
+}
+
+TEST_F(AllocatorTest, test_pool_alloc_and_free) {
+  ASSERT_TRUE(osi_allocator_pool_enable());
+  ASSERT_TRUE(osi_allocator_pool_is_enabled());
+
+  size_t in_use = get_pool_stats(100).in_use;
+  void* ptr = osi_malloc(100);
+  EXPECT_EQ(in_use + 1, get_pool_stats(100).in_use);
+  EXPECT_GE(get_pool_stats(100).high_watermark, in_use + 1);
+  memset(ptr, 0xff, 100);
+  osi_free(ptr);
+  EXPECT_EQ(in_use, get_pool_stats(100).in_use);
+
+  // A freed block is cached by the thread and handed out again.
+  uint8_t* zeroed = static_cast<uint8_t*>(osi_calloc(100));
+  EXPECT_EQ(ptr, zeroed);
+  for (size_t i = 0; i < 100; i++) EXPECT_EQ(0, zeroed[i]);
+  osi_free(zeroed);
+}
+
+TEST_F(AllocatorTest, test_pool_large_alloc_falls_back) {
+  ASSERT_TRUE(osi_allocator_pool_enable());
+
+  osi_allocator_pool_stats_t before[16];
+  size_t count = osi_allocator_pool_get_stats(before, 16);
+  void* ptr = osi_malloc(64 * 1024);
+  osi_allocator_pool_stats_t after[16];
+  osi_allocator_pool_get_stats(after, 16);
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(before[i].allocations, after[i].allocations);
+  }
+  osi_free(ptr);
+}
+
+TEST_F(AllocatorTest, test_pool_allocation_size) {
+  ASSERT_TRUE(osi_allocator_pool_enable());
+
+  void* ptr = osi_malloc(100);
+  EXPECT_EQ(get_pool_stats(100).block_size, osi_allocation_size(ptr));
+  osi_free(ptr);
+
+  ptr = osi_malloc(64 * 1024);
+  EXPECT_GE(osi_allocation_size(ptr), 64u * 1024);
+  osi_free(ptr);
+}
+
+TEST_F(AllocatorTest, test_pool_free_from_other_thread) {
+  ASSERT_TRUE(osi_allocator_pool_enable());
+
+  size_t in_use = get_pool_stats(1000).in_use;
+  void* ptr = osi_malloc(1000);
+  std::thread([ptr]() { osi_free(ptr); }).join();
+  EXPECT_EQ(in_use, get_pool_stats(1000).in_use);
+}
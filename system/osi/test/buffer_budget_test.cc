@@ -0,0 +1,120 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "osi/include/buffer_budget.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "osi/include/allocator.h"
+#include "osi/include/fixed_queue.h"
+
+class BufferBudgetTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    buffer_budget_set(BUFFER_OWNER_RFCOMM_TX, 0);
+    buffer_budget_set_total(0);
+  }
+};
+
+TEST_F(BufferBudgetTest, queue_charges_its_owner) {
+  buffer_budget_stats_t before;
+  buffer_budget_get_stats(BUFFER_OWNER_RFCOMM_TX, &before);
+
+  fixed_queue_t* queue = fixed_queue_new(SIZE_MAX);
+  fixed_queue_set_buffer_owner(queue, BUFFER_OWNER_RFCOMM_TX);
+  void* first = osi_malloc(100);
+  void* second = osi_malloc(1000);
+  fixed_queue_enqueue(queue, first);
+  ASSERT_TRUE(fixed_queue_try_enqueue(queue, second));
+
+  buffer_budget_stats_t stats;
+  buffer_budget_get_stats(BUFFER_OWNER_RFCOMM_TX, &stats);
+  EXPECT_EQ(stats.buffers, before.buffers + 2);
+  EXPECT_EQ(stats.in_use, before.in_use + osi_allocation_size(first) +
+                              osi_allocation_size(second));
+  EXPECT_GE(osi_allocation_size(second), 1000u);
+
+  osi_free(fixed_queue_try_dequeue(queue));
+  buffer_budget_get_stats(BUFFER_OWNER_RFCOMM_TX, &stats);
+  EXPECT_EQ(stats.buffers, before.buffers + 1);
+  EXPECT_EQ(stats.in_use, before.in_use + osi_allocation_size(second));
+
+  // Buffers left in the queue are released with it
+  fixed_queue_free(queue, osi_free);
+  buffer_budget_get_stats(BUFFER_OWNER_RFCOMM_TX, &stats);
+  EXPECT_EQ(stats.buffers, before.buffers);
+  EXPECT_EQ(stats.in_use, before.in_use);
+}
+
+TEST_F(BufferBudgetTest, owner_budget) {
+  fixed_queue_t* queue = fixed_queue_new(SIZE_MAX);
+  fixed_queue_set_buffer_owner(queue, BUFFER_OWNER_RFCOMM_TX);
+  void* buffer = osi_malloc(1000);
+  buffer_budget_stats_t stats;
+  buffer_budget_get_stats(BUFFER_OWNER_RFCOMM_TX, &stats);
+  buffer_budget_set(BUFFER_OWNER_RFCOMM_TX, stats.in_use + 500);
+  EXPECT_FALSE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_TX));
+
+  fixed_queue_enqueue(queue, buffer);
+  EXPECT_TRUE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_TX));
+  EXPECT_FALSE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_RX));
+  buffer_budget_get_stats(BUFFER_OWNER_RFCOMM_TX, &stats);
+  EXPECT_GE(stats.exceeded, 1u);
+
+  osi_free(fixed_queue_try_dequeue(queue));
+  EXPECT_FALSE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_TX));
+  fixed_queue_free(queue, osi_free);
+}
+
+TEST_F(BufferBudgetTest, total_budget_applies_to_all_owners) {
+  fixed_queue_t* queue = fixed_queue_new(SIZE_MAX);
+  fixed_queue_set_buffer_owner(queue, BUFFER_OWNER_RFCOMM_TX);
+  void* buffer = osi_malloc(1000);
+  buffer_budget_set_total(1);
+  EXPECT_FALSE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_RX));
+
+  fixed_queue_enqueue(queue, buffer);
+  EXPECT_TRUE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_TX));
+  EXPECT_TRUE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_RX));
+
+  fixed_queue_free(queue, osi_free);
+  EXPECT_FALSE(buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_RX));
+}
+
+TEST_F(BufferBudgetTest, debug_dump_lists_the_owners) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  buffer_budget_debug_dump(fds[1]);
+  close(fds[1]);
+
+  std::string dump;
+  char buffer[256];
+  ssize_t length;
+  while ((length = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    dump.append(buffer, length);
+  }
+  close(fds[0]);
+
+  for (int owner = 0; owner < BUFFER_OWNER_COUNT; owner++) {
+    EXPECT_NE(
+        dump.find(buffer_budget_owner_name(static_cast<buffer_owner_t>(owner))),
+        std::string::npos);
+  }
+  EXPECT_NE(dump.find("total"), std::string::npos);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "osi/include/config.h"
+
+using ::benchmark::State;
+
+namespace {
+
+const std::filesystem::path kConfigFile =
+    std::filesystem::temp_directory_path() / "config_benchmark.conf";
+
+// As many devices as the IoT config keeps, with the keys it logs for each.
+constexpr int kNumDevices = 500;
+const std::vector<std::string> kDeviceKeys = {
+    "Manufacturer", "Name", "DevClass", "DevType", "LinkKeyType", "PinLength",
+    "SdpDiManufacturer", "SdpDiModel", "SdpDiHardwareVersion",
+    "SdpDiVendorIdSource", "Profile/A2dp/Ver", "Profile/A2dp/SsrcCodec",
+    "Profile/Avrcp/Ver", "Profile/Avrcp/Features", "Profile/Hfp/Ver",
+    "Profile/Hfp/Features", "Profile/Hid/Ver", "Profile/Pan/Ver",
+    "ConnectCount", "DisconnectCount", "ConnectFailCount", "RoleSwitchCount",
+    "SniffModeCount", "LastConnectTime",
+};
+
+std::string DeviceAddress(int device) {
+  char address[18];
+  snprintf(address, sizeof(address), "aa:bb:cc:dd:%02x:%02x",
+           (device >> 8) & 0xff, device & 0xff);
+  return address;
+}
+
+// Writes a config of |kNumDevices| devices after a global section, and
+// returns its size in bytes.
+size_t WriteConfigFile() {
+  std::string content = "[Info]\nFileSource = Empty\nTimeCreated = 0\n\n";
+  for (int device = 0; device < kNumDevices; ++device) {
+    content += "[" + DeviceAddress(device) + "]\n";
+    for (const std::string& key : kDeviceKeys) {
+      content += key + " = " + std::to_string(device * 7 + key.size()) + "\n";
+    }
+    content += "\n";
+  }
+
+  FILE* fp = fopen(kConfigFile.c_str(), "wt");
+  fwrite(content.data(), 1, content.size(), fp);
+  fclose(fp);
+  return content.size();
+}
+
+void BM_ConfigParse(State& state) {
+  size_t size = WriteConfigFile();
+
+  for (auto _ : state) {
+    std::unique_ptr<config_t> config = config_new(kConfigFile.c_str());
+    benchmark::DoNotOptimize(config);
+  }
+
+  state.SetBytesProcessed(state.iterations() * size);
+  std::filesystem::remove(kConfigFile);
+}
+
+// Reads a key from each device, the last device being the worst case of a
+// linear search.
+void BM_ConfigGet(State& state) {
+  WriteConfigFile();
+  std::unique_ptr<config_t> config = config_new(kConfigFile.c_str());
+  std::vector<std::string> addresses;
+  for (int device = 0; device < kNumDevices; ++device) {
+    addresses.push_back(DeviceAddress(device));
+  }
+
+  for (auto _ : state) {
+    for (const std::string& address : addresses) {
+      benchmark::DoNotOptimize(
+          config_get_int(*config, address, "LastConnectTime", 0));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumDevices);
+  std::filesystem::remove(kConfigFile);
+}
+
+// Bumps a counter of each device, as the IoT config does on each event.
+void BM_ConfigSet(State& state) {
+  WriteConfigFile();
+  std::unique_ptr<config_t> config = config_new(kConfigFile.c_str());
+  std::vector<std::string> addresses;
+  for (int device = 0; device < kNumDevices; ++device) {
+    addresses.push_back(DeviceAddress(device));
+  }
+
+  int count = 0;
+  for (auto _ : state) {
+    for (const std::string& address : addresses) {
+      config_set_int(config.get(), address, "ConnectCount", ++count);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumDevices);
+  std::filesystem::remove(kConfigFile);
+}
+
+void BM_ConfigSave(State& state) {
+  size_t size = WriteConfigFile();
+  std::unique_ptr<config_t> config = config_new(kConfigFile.c_str());
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(config_save(*config, kConfigFile));
+  }
+
+  state.SetBytesProcessed(state.iterations() * size);
+  std::filesystem::remove(kConfigFile);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ConfigParse);
+BENCHMARK(BM_ConfigGet);
+BENCHMARK(BM_ConfigSet);
+BENCHMARK(BM_ConfigSave);
+
+BENCHMARK_MAIN();
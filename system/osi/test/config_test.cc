@@ -240,6 +240,35 @@ TEST_F(ConfigTest, config_remove_key_missing) {
   EXPECT_EQ(config_get_int(*config, "DID", "productId", 999), 999);
 }
 
+TEST_F(ConfigTest, config_lookup_after_list_changes) {
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_NE(config, nullptr);
+  EXPECT_TRUE(config_has_section(*config, "DID"));
+
+  config->sections.push_back(section_t{
+      .name = "Added", .entries = {entry_t{.key = "key", .value = "1"}}});
+  EXPECT_EQ(config_get_int(*config, "Added", "key", 0), 1);
+
+  config->sections.erase(config->Find("DID"));
+  EXPECT_FALSE(config_has_section(*config, "DID"));
+  EXPECT_TRUE(config_has_section(*config, "Added"));
+  EXPECT_TRUE(config_has_key(*config, CONFIG_DEFAULT_SECTION, "first_key"));
+
+  auto section_iter = config->Find("Added");
+  ASSERT_NE(section_iter, config->sections.end());
+  section_iter->entries.push_front(entry_t{.key = "first", .value = "2"});
+  EXPECT_EQ(config_get_int(*config, "Added", "first", 0), 2);
+  section_iter->entries.pop_back();
+  EXPECT_FALSE(config_has_key(*config, "Added", "key"));
+
+  config_t copy = *config;
+  config.reset();
+  EXPECT_EQ(config_get_int(copy, "Added", "first", 0), 2);
+  EXPECT_TRUE(config_remove_section(&copy, "Added"));
+  EXPECT_FALSE(config_has_section(copy, "Added"));
+  EXPECT_TRUE(config_has_key(copy, CONFIG_DEFAULT_SECTION, "first_key"));
+}
+
 TEST_F(ConfigTest, config_save_basic) {
   std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
   EXPECT_TRUE(config_save(*config, CONFIG_FILE));
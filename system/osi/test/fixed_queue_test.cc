@@ -3,6 +3,9 @@
 #include <gtest/gtest.h>
 
 #include <climits>
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 #include "osi/include/allocator.h"
 #include "osi/include/future.h"
@@ -346,3 +349,122 @@ TEST_F(FixedQueueTest, test_fixed_queue_register_dequeue) {
   thread_free(worker_thread);
   fixed_queue_free(queue, NULL);
 }
+
+TEST_F(FixedQueueTest, test_fixed_queue_ring_new_free) {
+  // Ring queues preallocate their cells, so their capacity is bounded
+  EXPECT_EQ(NULL, fixed_queue_new_with_type(0, FIXED_QUEUE_RING_SPSC));
+  EXPECT_EQ(NULL, fixed_queue_new_with_type(FIXED_QUEUE_RING_MAX_CAPACITY + 1,
+                                            FIXED_QUEUE_RING_MPMC));
+
+  fixed_queue_t* queue = fixed_queue_new_with_type(
+      FIXED_QUEUE_RING_MAX_CAPACITY, FIXED_QUEUE_RING_MPMC);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_EQ((size_t)FIXED_QUEUE_RING_MAX_CAPACITY,
+            fixed_queue_capacity(queue));
+
+  // The remaining elements are freed with the queue
+  test_queue_entry_free_counter = 0;
+  fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING1);
+  fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING2);
+  fixed_queue_free(queue, test_queue_entry_free_cb);
+  EXPECT_EQ(2, test_queue_entry_free_counter);
+}
+
+TEST_F(FixedQueueTest, test_fixed_queue_ring_enqueue_dequeue) {
+  for (fixed_queue_type_t type :
+       {FIXED_QUEUE_RING_SPSC, FIXED_QUEUE_RING_MPMC}) {
+    fixed_queue_t* queue = fixed_queue_new_with_type(TEST_QUEUE_SIZE, type);
+    ASSERT_TRUE(queue != NULL);
+    int enqueue_fd = fixed_queue_get_enqueue_fd(queue);
+    int dequeue_fd = fixed_queue_get_dequeue_fd(queue);
+    EXPECT_TRUE(is_fd_readable(enqueue_fd));
+    EXPECT_FALSE(is_fd_readable(dequeue_fd));
+
+    // Go around the ring a few times, filling it up each time
+    for (int lap = 0; lap < 3; lap++) {
+      for (size_t i = 0; i < TEST_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(fixed_queue_try_enqueue(queue, (void*)(i + 1)));
+      }
+      EXPECT_FALSE(fixed_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+      EXPECT_EQ(TEST_QUEUE_SIZE, fixed_queue_length(queue));
+      EXPECT_EQ((void*)1, fixed_queue_try_peek_first(queue));
+      EXPECT_EQ((void*)TEST_QUEUE_SIZE, fixed_queue_try_peek_last(queue));
+      EXPECT_FALSE(is_fd_readable(enqueue_fd));
+      EXPECT_TRUE(is_fd_readable(dequeue_fd));
+
+      for (size_t i = 0; i < TEST_QUEUE_SIZE; i++) {
+        EXPECT_EQ((void*)(i + 1), fixed_queue_dequeue(queue));
+        EXPECT_TRUE(is_fd_readable(enqueue_fd));
+      }
+      EXPECT_TRUE(fixed_queue_is_empty(queue));
+      EXPECT_EQ(NULL, fixed_queue_try_dequeue(queue));
+      EXPECT_EQ(NULL, fixed_queue_try_peek_first(queue));
+      EXPECT_EQ(NULL, fixed_queue_try_peek_last(queue));
+      EXPECT_FALSE(is_fd_readable(dequeue_fd));
+    }
+
+    fixed_queue_free(queue, NULL);
+  }
+}
+
+TEST_F(FixedQueueTest, test_fixed_queue_ring_register_dequeue) {
+  fixed_queue_t* queue =
+      fixed_queue_new_with_type(TEST_QUEUE_SIZE, FIXED_QUEUE_RING_SPSC);
+  ASSERT_TRUE(queue != NULL);
+
+  received_message_future = future_new();
+  ASSERT_TRUE(received_message_future != NULL);
+
+  thread_t* worker_thread = thread_new("test_fixed_queue_worker_thread");
+  ASSERT_TRUE(worker_thread != NULL);
+
+  fixed_queue_register_dequeue(queue, thread_get_reactor(worker_thread),
+                               fixed_queue_ready, NULL);
+
+  // Add a message to the queue, and expect to receive it
+  fixed_queue_enqueue(queue, (void*)DUMMY_DATA_STRING);
+  const char* msg = (const char*)future_await(received_message_future);
+  EXPECT_EQ(DUMMY_DATA_STRING, msg);
+
+  fixed_queue_unregister_dequeue(queue);
+  thread_free(worker_thread);
+  fixed_queue_free(queue, NULL);
+}
+
+TEST_F(FixedQueueTest, test_fixed_queue_ring_threads) {
+  static const size_t kThreads = 4;
+  static const uintptr_t kElementsPerThread = 10000;
+
+  for (fixed_queue_type_t type :
+       {FIXED_QUEUE_RING_SPSC, FIXED_QUEUE_RING_MPMC}) {
+    size_t threads = type == FIXED_QUEUE_RING_SPSC ? 1 : kThreads;
+    // A small ring makes both sides block
+    fixed_queue_t* queue = fixed_queue_new_with_type(2, type);
+    ASSERT_TRUE(queue != NULL);
+
+    std::vector<std::thread> producers;
+    std::vector<std::thread> consumers;
+    std::vector<uintptr_t> sums(threads, 0);
+    for (size_t t = 0; t < threads; t++) {
+      producers.emplace_back([queue] {
+        for (uintptr_t i = 1; i <= kElementsPerThread; i++) {
+          fixed_queue_enqueue(queue, (void*)i);
+        }
+      });
+      consumers.emplace_back([queue, &sums, t] {
+        for (uintptr_t i = 1; i <= kElementsPerThread; i++) {
+          sums[t] += (uintptr_t)fixed_queue_dequeue(queue);
+        }
+      });
+    }
+    for (auto& producer : producers) producer.join();
+    for (auto& consumer : consumers) consumer.join();
+
+    uintptr_t sum = 0;
+    for (uintptr_t thread_sum : sums) sum += thread_sum;
+    EXPECT_EQ(threads * kElementsPerThread * (kElementsPerThread + 1) / 2,
+              sum);
+    EXPECT_TRUE(fixed_queue_is_empty(queue));
+    fixed_queue_free(queue, NULL);
+  }
+}
@@ -0,0 +1,150 @@
+#include "osi/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  void SetUp() override { wheel_ = timer_wheel_new(kStartMs); }
+  void TearDown() override { timer_wheel_free(wheel_); }
+
+  void Add(timer_wheel_node_t* node, uint64_t deadline_ms) {
+    node->deadline_ms = deadline_ms;
+    timer_wheel_add(wheel_, node);
+  }
+
+  static constexpr uint64_t kStartMs = 1000;
+  timer_wheel_t* wheel_ = nullptr;
+  // Outlives |wheel_|, which unlinks the nodes still in it when freed
+  timer_wheel_node_t nodes_[500] = {};
+};
+
+bool count_node(timer_wheel_node_t* /* node */, void* context) {
+  (*static_cast<size_t*>(context))++;
+  return true;
+}
+
+}  // namespace
+
+TEST_F(TimerWheelTest, test_new_is_empty) {
+  EXPECT_EQ(timer_wheel_size(wheel_), 0u);
+  EXPECT_EQ(timer_wheel_peek(wheel_), nullptr);
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 1000000), nullptr);
+}
+
+TEST_F(TimerWheelTest, test_add_remove) {
+  timer_wheel_node_t& node = nodes_[0];
+  EXPECT_FALSE(timer_wheel_contains(&node));
+
+  Add(&node, kStartMs + 10);
+  EXPECT_TRUE(timer_wheel_contains(&node));
+  EXPECT_EQ(timer_wheel_size(wheel_), 1u);
+  EXPECT_EQ(timer_wheel_peek(wheel_), &node);
+
+  timer_wheel_remove(wheel_, &node);
+  EXPECT_FALSE(timer_wheel_contains(&node));
+  EXPECT_EQ(timer_wheel_size(wheel_), 0u);
+  EXPECT_EQ(timer_wheel_peek(wheel_), nullptr);
+
+  // Removing twice is allowed
+  timer_wheel_remove(wheel_, &node);
+}
+
+TEST_F(TimerWheelTest, test_peek_across_levels) {
+  timer_wheel_node_t& far = nodes_[0];
+  timer_wheel_node_t& middle = nodes_[1];
+  timer_wheel_node_t& near = nodes_[2];
+  Add(&far, kStartMs + 20ULL * 24 * 60 * 60 * 1000);  // Overflow list
+  Add(&middle, kStartMs + 5000);
+  Add(&near, kStartMs + 3);
+
+  EXPECT_EQ(timer_wheel_peek(wheel_), &near);
+  timer_wheel_remove(wheel_, &near);
+  EXPECT_EQ(timer_wheel_peek(wheel_), &middle);
+  timer_wheel_remove(wheel_, &middle);
+  EXPECT_EQ(timer_wheel_peek(wheel_), &far);
+}
+
+TEST_F(TimerWheelTest, test_pop_expired) {
+  timer_wheel_node_t& first = nodes_[0];
+  timer_wheel_node_t& second = nodes_[1];
+  Add(&second, kStartMs + 200);
+  Add(&first, kStartMs + 100);
+
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 99), nullptr);
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 150), &first);
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 150), nullptr);
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 200), &second);
+  EXPECT_EQ(timer_wheel_size(wheel_), 0u);
+}
+
+TEST_F(TimerWheelTest, test_past_deadline_comes_first) {
+  timer_wheel_node_t& future = nodes_[0];
+  timer_wheel_node_t& past = nodes_[1];
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 500), nullptr);
+  Add(&future, kStartMs + 501);
+  Add(&past, kStartMs);
+
+  EXPECT_EQ(timer_wheel_peek(wheel_), &past);
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 500), &past);
+  EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 500), nullptr);
+  EXPECT_EQ(timer_wheel_peek(wheel_), &future);
+}
+
+TEST_F(TimerWheelTest, test_equal_deadlines_keep_insertion_order) {
+  for (int i = 0; i < 3; i++) Add(&nodes_[i], kStartMs + 70);
+
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(timer_wheel_pop_expired(wheel_, kStartMs + 70), &nodes_[i]);
+  }
+}
+
+TEST_F(TimerWheelTest, test_foreach) {
+  Add(&nodes_[0], kStartMs + 1);
+  Add(&nodes_[1], kStartMs + 100);
+  Add(&nodes_[2], kStartMs + 100000);
+  Add(&nodes_[3], kStartMs + 20ULL * 24 * 60 * 60 * 1000);
+
+  size_t count = 0;
+  timer_wheel_foreach(wheel_, count_node, &count);
+  EXPECT_EQ(count, 4u);
+}
+
+TEST_F(TimerWheelTest, test_matches_sorted_order) {
+  srand(42);
+  uint64_t now_ms = kStartMs;
+  std::vector<uint64_t> expected;
+
+  for (int round = 0; round < 20; round++) {
+    // Schedule, cancel and reschedule a mix of short and long deadlines.
+    for (auto& node : nodes_) {
+      if (rand() % 3 == 0) {
+        timer_wheel_remove(wheel_, &node);
+        continue;
+      }
+      if (timer_wheel_contains(&node)) continue;
+      uint64_t range_ms = (rand() % 2) ? 100 : 1000000;
+      Add(&node, now_ms + rand() % range_ms);
+    }
+
+    now_ms += rand() % 5000;
+    expected.clear();
+    for (auto& node : nodes_) {
+      if (timer_wheel_contains(&node) && node.deadline_ms <= now_ms) {
+        expected.push_back(node.deadline_ms);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<uint64_t> popped;
+    while (timer_wheel_node_t* node = timer_wheel_pop_expired(wheel_, now_ms)) {
+      popped.push_back(node->deadline_ms);
+    }
+    EXPECT_EQ(popped, expected);
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "osi/include/ringbuffer.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// Large enough for a few SCO or A2DP frames in flight, and not a multiple of
+// the chunk sizes so that the copies keep wrapping at different offsets.
+constexpr size_t kRingbufferSize = 7 * 1024 + 13;
+
+// Copies each chunk in and out of the ring buffer.
+void BM_InsertPop(State& state) {
+  const size_t chunk = state.range(0);
+  ringbuffer_t* rb = ringbuffer_init(kRingbufferSize);
+  std::vector<uint8_t> in(chunk, 0xAA);
+  std::vector<uint8_t> out(chunk);
+
+  for (auto _ : state) {
+    ringbuffer_insert(rb, in.data(), chunk);
+    benchmark::DoNotOptimize(ringbuffer_pop(rb, out.data(), chunk));
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * chunk);
+  ringbuffer_free(rb);
+}
+
+// Produces and consumes each chunk in place, in one or two segments.
+void BM_ReserveCommitPeekContiguous(State& state) {
+  const size_t chunk = state.range(0);
+  ringbuffer_t* rb = ringbuffer_init(kRingbufferSize);
+
+  for (auto _ : state) {
+    size_t written = 0;
+    while (written < chunk) {
+      uint8_t* tail = nullptr;
+      size_t length = ringbuffer_reserve(rb, &tail);
+      if (length > chunk - written) length = chunk - written;
+      memset(tail, 0xAA, length);
+      written += ringbuffer_commit(rb, length);
+    }
+
+    size_t read = 0;
+    while (read < chunk) {
+      const uint8_t* head = nullptr;
+      size_t length = ringbuffer_peek_contiguous(rb, &head);
+      if (length > chunk - read) length = chunk - read;
+      benchmark::DoNotOptimize(head[length - 1]);
+      read += ringbuffer_delete(rb, length);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * chunk);
+  ringbuffer_free(rb);
+}
+
+}  // namespace
+
+// SCO packet payloads, an mSBC frame of PCM and an A2DP media packet.
+BENCHMARK(BM_InsertPop)->Arg(60)->Arg(240)->Arg(1024);
+BENCHMARK(BM_ReserveCommitPeekContiguous)->Arg(60)->Arg(240)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -137,3 +137,64 @@ TEST(RingbufferTest, test_multi_insert_delete) {
 
   ringbuffer_free(rb);
 }
+
+TEST(RingbufferTest, test_reserve_commit_wrap) {
+  ringbuffer_t* rb = ringbuffer_init(8);
+
+  uint8_t aa[] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+  ringbuffer_insert(rb, aa, sizeof(aa));
+  ringbuffer_delete(rb, 4);
+
+  // The free space wraps, only the part up to the end is contiguous
+  uint8_t* tail = nullptr;
+  size_t reserved = ringbuffer_reserve(rb, &tail);
+  EXPECT_EQ((size_t)2, reserved);
+  memset(tail, 0xBB, reserved);
+  EXPECT_EQ((size_t)2, ringbuffer_commit(rb, reserved));
+
+  reserved = ringbuffer_reserve(rb, &tail);
+  EXPECT_EQ((size_t)4, reserved);
+  memset(tail, 0xCC, reserved);
+  EXPECT_EQ((size_t)4, ringbuffer_commit(rb, reserved));
+  EXPECT_EQ((size_t)0, ringbuffer_available(rb));
+
+  // Nothing can be reserved or committed past a full buffer
+  EXPECT_EQ((size_t)0, ringbuffer_reserve(rb, &tail));
+  EXPECT_EQ((size_t)0, ringbuffer_commit(rb, 1));
+
+  uint8_t expected[] = {0xAA, 0xAA, 0xBB, 0xBB, 0xCC, 0xCC, 0xCC, 0xCC};
+  uint8_t peek[8] = {0};
+  EXPECT_EQ((size_t)8, ringbuffer_peek(rb, 0, peek, sizeof(peek)));
+  ASSERT_TRUE(0 == memcmp(expected, peek, sizeof(expected)));
+
+  ringbuffer_free(rb);
+}
+
+TEST(RingbufferTest, test_peek_contiguous_wrap) {
+  ringbuffer_t* rb = ringbuffer_init(8);
+
+  const uint8_t* head = nullptr;
+  EXPECT_EQ((size_t)0, ringbuffer_peek_contiguous(rb, &head));
+
+  uint8_t aa[] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+  ringbuffer_insert(rb, aa, sizeof(aa));
+  ringbuffer_delete(rb, 5);
+  uint8_t bb[] = {0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
+  ringbuffer_insert(rb, bb, sizeof(bb));
+
+  // The data wraps, only the part up to the end is contiguous
+  size_t contiguous = ringbuffer_peek_contiguous(rb, &head);
+  EXPECT_EQ((size_t)3, contiguous);
+  EXPECT_EQ(0xAA, head[0]);
+  EXPECT_EQ(0xBB, head[1]);
+  EXPECT_EQ(0xBB, head[2]);
+  ringbuffer_delete(rb, contiguous);
+
+  contiguous = ringbuffer_peek_contiguous(rb, &head);
+  EXPECT_EQ((size_t)3, contiguous);
+  EXPECT_EQ(0xBB, head[0]);
+  ringbuffer_delete(rb, contiguous);
+  EXPECT_EQ((size_t)0, ringbuffer_size(rb));
+
+  ringbuffer_free(rb);
+}
@@ -24,15 +24,22 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
-static bool is_wake_lock_acquired = false;
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<bool> is_wake_lock_acquired = false;
+static std::atomic<int> wake_lock_callout_count = 0;
 
 static int acquire_wake_lock_cb(const char* lock_name) {
   is_wake_lock_acquired = true;
+  wake_lock_callout_count++;
   return BT_STATUS_SUCCESS;
 }
 
 static int release_wake_lock_cb(const char* lock_name) {
   is_wake_lock_acquired = false;
+  wake_lock_callout_count++;
   return BT_STATUS_SUCCESS;
 }
 
@@ -64,9 +71,11 @@ class WakelockTest : public ::testing::Test {
   int unlock_path_fd{-1};
 
   void TearDown() override {
-    is_wake_lock_acquired = false;
     wakelock_cleanup();
+    is_wake_lock_acquired = false;
+    wake_lock_callout_count = 0;
     wakelock_set_os_callouts(NULL);
+    wakelock_set_release_delay_ms(0);
 
     // Clean up the temp wake lock directory
     unlink(lock_path_.c_str());
@@ -150,3 +159,48 @@ TEST_F(WakelockTest, test_set_paths) {
     ASSERT_FALSE(IsFileWakeLockAcquired());
   }
 }
+
+TEST_F(WakelockTest, test_nested_acquire) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+
+  ASSERT_TRUE(wakelock_acquire());
+  ASSERT_TRUE(wakelock_acquire());
+  ASSERT_TRUE(is_wake_lock_acquired);
+  ASSERT_TRUE(wakelock_release());
+  ASSERT_TRUE(is_wake_lock_acquired);
+  ASSERT_TRUE(wakelock_release());
+  ASSERT_FALSE(is_wake_lock_acquired);
+  ASSERT_EQ(wake_lock_callout_count, 2);
+}
+
+TEST_F(WakelockTest, test_delayed_release) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+  wakelock_set_release_delay_ms(50);
+
+  // Acquires within the release delay keep the wakelock held
+  for (size_t i = 0; i < 100; i++) {
+    ASSERT_TRUE(wakelock_acquire());
+    ASSERT_TRUE(wakelock_release());
+    ASSERT_TRUE(is_wake_lock_acquired);
+  }
+  ASSERT_EQ(wake_lock_callout_count, 1);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (is_wake_lock_acquired && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_FALSE(is_wake_lock_acquired);
+  ASSERT_EQ(wake_lock_callout_count, 2);
+}
+
+TEST_F(WakelockTest, test_cleanup_releases_delayed_release) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+  wakelock_set_release_delay_ms(60 * 1000);
+
+  ASSERT_TRUE(wakelock_acquire());
+  ASSERT_TRUE(wakelock_release());
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  wakelock_cleanup();
+  ASSERT_FALSE(is_wake_lock_acquired);
+}
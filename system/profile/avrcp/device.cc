@@ -191,9 +191,7 @@ void Device::VendorPacketHandler(uint8_t label,
         send_message(label, false, std::move(response));
         return;
       }
-      media_interface_->GetSongInfo(base::Bind(
-          &Device::GetElementAttributesResponse, weak_ptr_factory_.GetWeakPtr(),
-          label, get_element_attributes_request_pkt));
+      GetCurrentSongInfo(label, get_element_attributes_request_pkt);
     } break;
 
     case CommandPdu::GET_PLAY_STATUS: {
@@ -851,6 +849,45 @@ void Device::GetElementAttributesResponse(
   send_message(label, false, std::move(response));
 }
 
+void Device::GetCurrentSongInfo(
+    uint8_t label, std::shared_ptr<GetElementAttributesRequest> pkt) {
+  if (song_info_cache_.has_value()) {
+    GetElementAttributesResponse(label, pkt, *song_info_cache_);
+    return;
+  }
+
+  pending_element_attributes_.emplace_back(label, pkt);
+  if (!song_info_fetch_pending_) FetchSongInfo();
+}
+
+void Device::FetchSongInfo() {
+  song_info_fetch_pending_ = true;
+  media_interface_->GetSongInfo(base::Bind(&Device::SongInfoFetched,
+                                           weak_ptr_factory_.GetWeakPtr(),
+                                           song_info_generation_));
+}
+
+void Device::SongInfoFetched(uint32_t generation, SongInfo info) {
+  // The song changed while this fetch was in flight, and a newer fetch was
+  // already issued for any pending request.
+  if (generation != song_info_generation_) return;
+
+  song_info_fetch_pending_ = false;
+  song_info_cache_ = std::move(info);
+
+  auto pending = std::move(pending_element_attributes_);
+  pending_element_attributes_.clear();
+  for (const auto& [label, pkt] : pending) {
+    GetElementAttributesResponse(label, pkt, *song_info_cache_);
+  }
+}
+
+void Device::InvalidateSongInfoCache() {
+  song_info_generation_++;
+  song_info_fetch_pending_ = false;
+  song_info_cache_.reset();
+}
+
 void Device::MessageReceived(uint8_t label, std::shared_ptr<Packet> pkt) {
   if (!pkt->IsValid()) {
     log::warn("{}: Request packet is not valid", address_);
@@ -1124,10 +1161,9 @@ void Device::HandleGetFolderItems(uint8_t label,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     case Scope::VFS:
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetVFSListResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+      GetCurrentFolderItems(base::Bind(&Device::GetVFSListResponse,
+                                       weak_ptr_factory_.GetWeakPtr(), label,
+                                       pkt));
       break;
     case Scope::NOW_PLAYING:
       media_interface_->GetNowPlayingList(
@@ -1163,8 +1199,7 @@ void Device::HandleGetTotalNumberOfItems(
       break;
     }
     case Scope::VFS:
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
+      GetCurrentFolderItems(
           base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
                      weak_ptr_factory_.GetWeakPtr(), label));
       break;
@@ -1188,8 +1223,8 @@ void Device::GetTotalNumberOfItemsMediaPlayersResponse(
   send_message(label, true, std::move(builder));
 }
 
-void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label,
-                                              std::vector<ListItem> list) {
+void Device::GetTotalNumberOfItemsVFSResponse(
+    uint8_t label, const std::vector<ListItem>& list) {
   log::verbose("num_items={}", list.size());
 
   auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
@@ -1245,17 +1280,14 @@ void Device::HandleChangePath(uint8_t label,
     log::verbose("Popping Path from stack: new path=\"{}\"", CurrentFolder());
   }
 
-  media_interface_->GetFolderItems(
-      curr_browsed_player_id_, CurrentFolder(),
-      base::Bind(&Device::ChangePathResponse, weak_ptr_factory_.GetWeakPtr(),
-                 label, pkt));
+  GetCurrentFolderItems(base::Bind(&Device::ChangePathResponse,
+                                   weak_ptr_factory_.GetWeakPtr(), label,
+                                   pkt));
 }
 
 void Device::ChangePathResponse(uint8_t label,
                                 std::shared_ptr<ChangePathRequest> pkt,
-                                std::vector<ListItem> list) {
-  // TODO (apanicke): Reconstruct the VFS ID's here. Right now it gets
-  // reconstructed in GetFolderItemsVFS
+                                const std::vector<ListItem>& list) {
   auto builder =
       ChangePathResponseBuilder::MakeBuilder(Status::NO_ERROR, list.size());
   send_message(label, true, std::move(builder));
@@ -1292,8 +1324,7 @@ void Device::HandleGetItemAttributes(
       // then we can auto send the error without calling up. We do this check
       // later right now though in order to prevent race conditions with updates
       // on the media layer.
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
+      GetCurrentFolderItems(
           base::Bind(&Device::GetItemAttributesVFSResponse,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
@@ -1354,7 +1385,7 @@ void Device::GetItemAttributesNowPlayingResponse(
 
 void Device::GetItemAttributesVFSResponse(
     uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-    std::vector<ListItem> item_list) {
+    const std::vector<ListItem>& item_list) {
   log::verbose("uid=0x{:x}", pkt->GetUid());
 
   auto media_id = vfs_ids_.get_media_id(pkt->GetUid());
@@ -1470,7 +1501,7 @@ std::set<AttributeEntry> filter_attributes_requested(
 
 void Device::GetVFSListResponse(uint8_t label,
                                 std::shared_ptr<GetFolderItemsRequest> pkt,
-                                std::vector<ListItem> items) {
+                                const std::vector<ListItem>& items) {
   log::verbose("start_item={} end_item={}", pkt->GetStartItem(),
                pkt->GetEndItem());
 
@@ -1478,25 +1509,14 @@ void Device::GetVFSListResponse(uint8_t label,
   auto builder = GetFolderItemsResponseBuilder::MakeVFSBuilder(
       Status::NO_ERROR, 0x0000, browse_mtu_);
 
-  // TODO (apanicke): Add test that checks if vfs_ids_ is the correct size after
-  // an operation.
-  for (const auto& item : items) {
-    if (item.type == ListItem::FOLDER) {
-      vfs_ids_.insert(item.folder.media_id);
-    } else if (item.type == ListItem::SONG) {
-      vfs_ids_.insert(item.song.media_id);
-    }
-  }
-
-  // Add the elements retrieved in the last get folder items request and map
-  // them to UIDs The maps will be cleared every time a directory change
-  // happens. These items do not need to correspond with the now playing list as
-  // the UID's only need to be unique in the context of the current scope and
-  // the current folder
+  // The items were mapped to UIDs when the folder was fetched, see
+  // CurrentFolderItemsFetched. These items do not need to correspond with the
+  // now playing list as the UID's only need to be unique in the context of the
+  // current scope and the current folder
   for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size();
        i++) {
     if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+      const auto& folder = items[i].folder;
       // right now we always use folders of mixed type
       FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00,
                              folder.is_playable, folder.name);
@@ -1532,6 +1552,48 @@ void Device::GetVFSListResponse(uint8_t label,
   send_message(label, true, std::move(builder));
 }
 
+void Device::GetCurrentFolderItems(FolderItemsCacheCallback cb) {
+  if (folder_items_cache_valid_ &&
+      folder_items_cache_player_id_ == curr_browsed_player_id_ &&
+      folder_items_cache_folder_ == CurrentFolder()) {
+    cb.Run(folder_items_cache_);
+    return;
+  }
+
+  media_interface_->GetFolderItems(
+      curr_browsed_player_id_, CurrentFolder(),
+      base::Bind(&Device::CurrentFolderItemsFetched,
+                 weak_ptr_factory_.GetWeakPtr(), curr_browsed_player_id_,
+                 CurrentFolder(), cb));
+}
+
+void Device::CurrentFolderItemsFetched(int player_id, std::string folder,
+                                       FolderItemsCacheCallback cb,
+                                       std::vector<ListItem> items) {
+  log::verbose("player_id={} folder=\"{}\" num_items={}", player_id, folder,
+               items.size());
+
+  // Map the items to UIDs once per fetch, rather than once per page.
+  for (const auto& item : items) {
+    if (item.type == ListItem::FOLDER) {
+      vfs_ids_.insert(item.folder.media_id);
+    } else if (item.type == ListItem::SONG) {
+      vfs_ids_.insert(item.song.media_id);
+    }
+  }
+
+  folder_items_cache_valid_ = true;
+  folder_items_cache_player_id_ = player_id;
+  folder_items_cache_folder_ = std::move(folder);
+  folder_items_cache_ = std::move(items);
+  cb.Run(folder_items_cache_);
+}
+
+void Device::InvalidateFolderItemsCache() {
+  folder_items_cache_valid_ = false;
+  folder_items_cache_.clear();
+}
+
 void Device::GetNowPlayingListResponse(
     uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
     std::string /* unused curr_song_id */, std::vector<SongInfo> song_list) {
@@ -1612,6 +1674,7 @@ void Device::SetBrowsedPlayerResponse(
   }
 
   curr_browsed_player_id_ = pkt->GetPlayerId();
+  InvalidateFolderItemsCache();
 
   // Clear the path and push the new root.
   current_path_ = std::stack<std::string>();
@@ -1641,7 +1704,15 @@ void Device::SendMediaUpdate(bool metadata, bool play_status, bool queue) {
     }
   }
 
-  if (metadata) HandleTrackUpdate();
+  if (metadata) {
+    InvalidateSongInfoCache();
+    // A registered remote device reads the new attributes as soon as it gets
+    // the track changed notification, so start fetching them first.
+    if (track_changed_.first || !pending_element_attributes_.empty()) {
+      FetchSongInfo();
+    }
+    HandleTrackUpdate();
+  }
 }
 
 void Device::SendFolderUpdate(bool available_players, bool addressed_player,
@@ -1650,6 +1721,16 @@ void Device::SendFolderUpdate(bool available_players, bool addressed_player,
                    "assert failed: media_interface_ != nullptr");
   log::verbose("");
 
+  // Any of these may change what the browsed folders contain.
+  if (available_players || addressed_player || uids) {
+    InvalidateFolderItemsCache();
+  }
+
+  if (addressed_player) {
+    InvalidateSongInfoCache();
+    if (!pending_element_attributes_.empty()) FetchSongInfo();
+  }
+
   if (available_players) {
     HandleAvailablePlayerUpdate();
   }
@@ -1825,6 +1906,8 @@ void Device::HandleAddressedPlayerUpdate() {
 void Device::DeviceDisconnected() {
   log::info("{} : Device was disconnected", address_);
   play_pos_update_cb_.Cancel();
+  InvalidateSongInfoCache();
+  pending_element_attributes_.clear();
 
   // TODO (apanicke): Once the interfaces are set in the Device construction,
   // remove these conditionals.
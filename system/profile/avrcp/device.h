@@ -21,7 +21,9 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <stack>
+#include <string>
 #include <vector>
 
 #include "avrcp_internal.h"
@@ -223,7 +225,7 @@ class Device {
       uint16_t curr_player, std::vector<MediaPlayerInfo> players);
   virtual void GetVFSListResponse(uint8_t label,
                                   std::shared_ptr<GetFolderItemsRequest> pkt,
-                                  std::vector<ListItem> items);
+                                  const std::vector<ListItem>& items);
   virtual void GetNowPlayingListResponse(
       uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
       std::string curr_song_id, std::vector<SongInfo> song_list);
@@ -233,8 +235,8 @@ class Device {
       uint8_t label, std::shared_ptr<GetTotalNumberOfItemsRequest> pkt);
   virtual void GetTotalNumberOfItemsMediaPlayersResponse(
       uint8_t label, uint16_t curr_player, std::vector<MediaPlayerInfo> list);
-  virtual void GetTotalNumberOfItemsVFSResponse(uint8_t label,
-                                                std::vector<ListItem> items);
+  virtual void GetTotalNumberOfItemsVFSResponse(
+      uint8_t label, const std::vector<ListItem>& items);
   virtual void GetTotalNumberOfItemsNowPlayingResponse(
       uint8_t label, std::string curr_song_id, std::vector<SongInfo> song_list);
 
@@ -246,7 +248,7 @@ class Device {
       std::string curr_media_id, std::vector<SongInfo> song_list);
   virtual void GetItemAttributesVFSResponse(
       uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-      std::vector<ListItem> item_list);
+      const std::vector<ListItem>& item_list);
 
   // SET BROWSED PLAYER
   virtual void HandleSetBrowsedPlayer(
@@ -260,7 +262,7 @@ class Device {
                                 std::shared_ptr<ChangePathRequest> request);
   virtual void ChangePathResponse(uint8_t label,
                                   std::shared_ptr<ChangePathRequest> request,
-                                  std::vector<ListItem> list);
+                                  const std::vector<ListItem>& list);
 
   // PLAY ITEM
   virtual void HandlePlayItem(uint8_t label,
@@ -322,6 +324,25 @@ class Device {
     return current_path_.top();
   }
 
+  using FolderItemsCacheCallback =
+      base::Callback<void(const std::vector<ListItem>& items)>;
+
+  // Runs |cb| with the items of the current folder, fetching them from the
+  // media layer only if the cached listing is for a different folder.
+  void GetCurrentFolderItems(FolderItemsCacheCallback cb);
+  void CurrentFolderItemsFetched(int player_id, std::string folder,
+                                 FolderItemsCacheCallback cb,
+                                 std::vector<ListItem> items);
+  void InvalidateFolderItemsCache();
+
+  // Answers |pkt| from the attributes of the current song, fetching them from
+  // the media layer if no fetch for the current song is cached or in flight.
+  void GetCurrentSongInfo(uint8_t label,
+                          std::shared_ptr<GetElementAttributesRequest> pkt);
+  void FetchSongInfo();
+  void SongInfoFetched(uint32_t generation, SongInfo info);
+  void InvalidateSongInfoCache();
+
   void send_message(uint8_t label, bool browse,
                     std::unique_ptr<::bluetooth::PacketBuilder> message) {
     active_labels_.erase(label);
@@ -358,6 +379,14 @@ class Device {
 
   std::stack<std::string> current_path_;
 
+  // Listing of the last folder fetched from the media layer. Remote devices
+  // page through a folder with one request per page, so keeping the listing
+  // makes each page cost its own size rather than that of the whole folder.
+  bool folder_items_cache_valid_ = false;
+  int folder_items_cache_player_id_ = -1;
+  std::string folder_items_cache_folder_;
+  std::vector<ListItem> folder_items_cache_;
+
   // Notification Trackers
   using Notification = std::pair<bool, uint8_t>;
   Notification track_changed_ = Notification(false, 0);
@@ -374,6 +403,15 @@ class Device {
 
   uint32_t play_pos_interval_ = 0;
 
+  // Attributes of the current song, kept until the media layer reports a
+  // metadata change. Remote devices usually read them several times per
+  // track, with a different attribute set each time.
+  std::optional<SongInfo> song_info_cache_;
+  uint32_t song_info_generation_ = 0;
+  bool song_info_fetch_pending_ = false;
+  std::vector<std::pair<uint8_t, std::shared_ptr<GetElementAttributesRequest>>>
+      pending_element_attributes_;
+
   SongInfo last_song_info_;
   PlayStatus last_play_status_;
 
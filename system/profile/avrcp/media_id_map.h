@@ -16,7 +16,8 @@
 
 #pragma once
 
-#include <map>
+#include <string>
+#include <unordered_map>
 
 namespace bluetooth {
 namespace avrcp {
@@ -44,19 +45,22 @@ class MediaIdMap {
   }
 
   uint64_t insert(std::string media_id) {
-    if (media_id_to_uid_.find(media_id) != media_id_to_uid_.end()) {
-      return media_id_to_uid_[media_id];
-    }
+    // A single lookup both finds an existing UID and reserves the next one.
+    auto [media_id_it, inserted] =
+        media_id_to_uid_.try_emplace(std::move(media_id), 0);
+    if (!inserted) return media_id_it->second;
 
-    uint64_t uid = media_id_to_uid_.size() + 1;
-    media_id_to_uid_.insert(std::pair<std::string, uint64_t>(media_id, uid));
-    uid_to_media_id_.insert(std::pair<uint64_t, std::string>(uid, media_id));
+    uint64_t uid = media_id_to_uid_.size();
+    media_id_it->second = uid;
+    uid_to_media_id_.emplace(uid, media_id_it->first);
     return uid;
   }
 
  private:
-  std::map<std::string, uint64_t> media_id_to_uid_;
-  std::map<uint64_t, std::string> uid_to_media_id_;
+  // Lookups happen for every item of every browsed page, and the UIDs carry
+  // no ordering, so hashed maps are used.
+  std::unordered_map<std::string, uint64_t> media_id_to_uid_;
+  std::unordered_map<uint64_t, std::string> uid_to_media_id_;
 };
 
 }  // namespace avrcp
@@ -741,6 +741,51 @@ TEST_F(AvrcpDeviceTest, getElementAttributesTest) {
   SendMessage(3, TestAvrcpPacket::Make(get_element_attributes_request_full));
 }
 
+TEST_F(AvrcpDeviceTest, getElementAttributesCacheTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr,
+                                  nullptr);
+
+  SongInfo info = {"test_id",
+                   {AttributeEntry(Attribute::TITLE, "Test Song"),
+                    AttributeEntry(Attribute::ARTIST_NAME, "Test Artist")}};
+
+  // The attributes are fetched once per song, however many times they are
+  // read.
+  EXPECT_CALL(interface, GetSongInfo(_))
+      .Times(2)
+      .WillRepeatedly(InvokeCb<0>(info));
+
+  auto compare_to_partial =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_partial->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  EXPECT_CALL(response_cb,
+              Call(1, false, matchPacket(std::move(compare_to_partial))))
+      .Times(1);
+  SendMessage(1, TestAvrcpPacket::Make(get_element_attributes_request_partial));
+
+  auto compare_to_full =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_full->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  compare_to_full->AddAttributeEntry(Attribute::ARTIST_NAME, "Test Artist");
+  EXPECT_CALL(response_cb,
+              Call(2, false, matchPacket(std::move(compare_to_full))))
+      .Times(1);
+  SendMessage(2, TestAvrcpPacket::Make(get_element_attributes_request_full));
+
+  // A metadata update means the next read fetches the attributes again.
+  test_device->SendMediaUpdate(true, false, false);
+
+  compare_to_partial = GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_partial->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  EXPECT_CALL(response_cb,
+              Call(3, false, matchPacket(std::move(compare_to_partial))))
+      .Times(1);
+  SendMessage(3, TestAvrcpPacket::Make(get_element_attributes_request_partial));
+}
+
 TEST_F(AvrcpDeviceTest, getElementAttributesWithCoverArtTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
@@ -1061,6 +1106,57 @@ TEST_F(AvrcpDeviceTest, getFolderItemsMtuTest) {
       1, TestBrowsePacket::Make(get_folder_items_request_vfs));
 }
 
+TEST_F(AvrcpDeviceTest, getFolderItemsVFSPagingTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr,
+                                  nullptr);
+
+  FolderInfo info0 = {"test_id0", true, "Test Folder0"};
+  FolderInfo info1 = {"test_id1", true, "Test Folder1"};
+  ListItem item0 = {ListItem::FOLDER, info0, SongInfo()};
+  ListItem item1 = {ListItem::FOLDER, info1, SongInfo()};
+  std::vector<ListItem> list = {item0, item1};
+
+  // Both pages are served from a single fetch of the folder, until the media
+  // layer reports that the UIDs changed.
+  EXPECT_CALL(interface, GetFolderItems(_, "", _))
+      .Times(2)
+      .WillRepeatedly(InvokeCb<2>(list));
+
+  auto first_page = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  first_page->AddFolder(FolderItem(1, 0, true, "Test Folder0"));
+  EXPECT_CALL(response_cb, Call(1, true, matchPacket(std::move(first_page))))
+      .Times(1);
+  auto request_builder =
+      GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 0, 0, {});
+  auto request = TestBrowsePacket::Make();
+  request_builder->Serialize(request);
+  SendBrowseMessage(1, request);
+
+  auto second_page = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  second_page->AddFolder(FolderItem(2, 0, true, "Test Folder1"));
+  EXPECT_CALL(response_cb, Call(2, true, matchPacket(std::move(second_page))))
+      .Times(1);
+  request_builder =
+      GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 1, 1, {});
+  request = TestBrowsePacket::Make();
+  request_builder->Serialize(request);
+  SendBrowseMessage(2, request);
+
+  test_device->SendFolderUpdate(false, false, true);
+
+  auto total_items = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
+      Status::NO_ERROR, 0, list.size());
+  EXPECT_CALL(response_cb, Call(3, true, matchPacket(std::move(total_items))))
+      .Times(1);
+  SendBrowseMessage(
+      3, TestBrowsePacket::Make(get_total_number_of_items_request_vfs));
+}
+
 TEST_F(AvrcpDeviceTest, changePathTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
@@ -1084,8 +1180,10 @@ TEST_F(AvrcpDeviceTest, changePathTest) {
   ListItem item3 = {ListItem::FOLDER, info3, SongInfo()};
   ListItem item4 = {ListItem::FOLDER, info4, SongInfo()};
   std::vector<ListItem> list1 = {item2, item3, item4};
+  // Listing Test Folder1 right after changing into it reuses the listing
+  // fetched for the change path response.
   EXPECT_CALL(interface, GetFolderItems(_, "test_id1", _))
-      .Times(3)
+      .Times(2)
       .WillRepeatedly(InvokeCb<2>(list1));
 
   std::vector<ListItem> list2 = {};
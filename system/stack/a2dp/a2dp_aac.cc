@@ -120,7 +120,8 @@ static const tA2DP_ENCODER_INTERFACE a2dp_encoder_interface_aac = {
     a2dp_aac_get_encoder_interval_ms,
     a2dp_aac_get_effective_frame_size,
     a2dp_aac_send_frames,
-    nullptr  // set_transmit_queue_length
+    nullptr,  // set_transmit_queue_length
+    nullptr   // set_in_place_read_callbacks
 };
 
 static const tA2DP_DECODER_INTERFACE a2dp_decoder_interface_aac = {
@@ -130,6 +131,7 @@ static const tA2DP_DECODER_INTERFACE a2dp_decoder_interface_aac = {
     nullptr,  // decoder_start
     nullptr,  // decoder_suspend
     nullptr,  // decoder_configure
+    nullptr,  // decoder_conceal_packets
 };
 
 static tA2DP_STATUS A2DP_CodecInfoMatchesCapabilityAac(
@@ -23,7 +23,10 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "a2dp_aac.h"
+#include "common/latency_histogram.h"
 #include "common/time_util.h"
 #include "internal_include/bt_target.h"
 #include "os/log.h"
@@ -95,6 +98,10 @@ typedef struct {
 
 static tA2DP_AAC_ENCODER_CB a2dp_aac_encoder_cb;
 
+// Time spent in aacEncEncode() per frame, kept out of the control block
+// which is cleared with memset
+static bluetooth::common::LatencyHistogram a2dp_aac_encode_timing;
+
 static uint32_t a2dp_aac_encoder_interval_ms = A2DP_AAC_ENCODER_INTERVAL_MS;
 
 static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
@@ -128,6 +135,7 @@ void a2dp_aac_encoder_init(const tA2DP_ENCODER_INIT_PEER_PARAMS* p_peer_params,
   if (a2dp_aac_encoder_cb.has_aac_handle)
     aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
   memset(&a2dp_aac_encoder_cb, 0, sizeof(a2dp_aac_encoder_cb));
+  a2dp_aac_encode_timing.Reset();
 
   a2dp_aac_encoder_cb.stats.session_start_us =
       bluetooth::common::time_get_os_boottime_us();
@@ -593,9 +601,13 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
         }
         in_buf_vector[0] = read_buffer;
         out_buf_vector[0] = packet + count;
+        const uint64_t encode_start_us =
+            bluetooth::common::time_get_os_boottime_us();
         AACENC_ERROR aac_error =
             aacEncEncode(a2dp_aac_encoder_cb.aac_handle, &in_buf_desc,
                          &out_buf_desc, &aac_in_args, &aac_out_args);
+        a2dp_aac_encode_timing.Add(
+            bluetooth::common::time_get_os_boottime_us() - encode_start_us);
         if (aac_error != AACENC_OK) {
           log::error("AAC encoding error: 0x{:x}", aac_error);
           a2dp_aac_encoder_cb.stats.media_read_total_dropped_packets++;
@@ -697,6 +709,25 @@ static uint16_t adjust_effective_mtu(
   return mtu_size;
 }
 
+// Returns the upper bound of the encode time histogram bucket that holds the
+// |percent| percentile, capped to the maximum, or 0 if nothing was encoded.
+static uint64_t a2dp_aac_encode_time_percentile_us(size_t percent) {
+  using bluetooth::common::LatencyHistogram;
+  size_t count = a2dp_aac_encode_timing.Count();
+  if (count == 0) return 0;
+
+  size_t rank = (count * percent + 99) / 100;
+  size_t seen = 0;
+  for (size_t i = 0; i < LatencyHistogram::kNumBuckets - 1; i++) {
+    seen += a2dp_aac_encode_timing.BucketCount(i);
+    if (seen >= rank) {
+      return std::min(LatencyHistogram::BucketUpperBoundUs(i),
+                      a2dp_aac_encode_timing.MaxUs());
+    }
+  }
+  return a2dp_aac_encode_timing.MaxUs();
+}
+
 void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
   a2dp_aac_encoder_stats_t* stats = &a2dp_aac_encoder_cb.stats;
 
@@ -730,4 +761,14 @@ void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
           "%zu\n",
           stats->media_read_total_expected_read_bytes,
           stats->media_read_total_actual_read_bytes);
+
+  dprintf(fd,
+          "  Encode time in us (p50/p90/p99/max)                     : %" PRIu64
+          " / %" PRIu64 " / %" PRIu64 " / %" PRIu64 "\n",
+          a2dp_aac_encode_time_percentile_us(50),
+          a2dp_aac_encode_time_percentile_us(90),
+          a2dp_aac_encode_time_percentile_us(99),
+          a2dp_aac_encode_timing.MaxUs());
+  dprintf(fd, "  Encode time histogram (us): %s\n",
+          a2dp_aac_encode_timing.ToString().c_str());
 }
@@ -100,8 +100,8 @@ static const tA2DP_ENCODER_INTERFACE a2dp_encoder_interface_sbc = {
     a2dp_sbc_get_encoder_interval_ms,
     a2dp_sbc_get_effective_frame_size,
     a2dp_sbc_send_frames,
-    nullptr  // set_transmit_queue_length
-};
+    a2dp_sbc_set_transmit_queue_length,
+    a2dp_sbc_set_in_place_read_callbacks};
 
 static const tA2DP_DECODER_INTERFACE a2dp_decoder_interface_sbc = {
     a2dp_sbc_decoder_init,
@@ -110,6 +110,7 @@ static const tA2DP_DECODER_INTERFACE a2dp_decoder_interface_sbc = {
     nullptr,  // decoder_start
     nullptr,  // decoder_suspend
     nullptr,  // decoder_configure
+    a2dp_sbc_decoder_conceal_packets,
 };
 
 static tA2DP_STATUS A2DP_CodecInfoMatchesCapabilitySbc(
@@ -35,6 +35,7 @@ typedef struct {
   OI_CODEC_SBC_DECODER_CONTEXT decoder_context;
   uint32_t context_data[CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS)];
   int16_t decode_buf[15 * SBC_MAX_SAMPLES_PER_FRAME * SBC_MAX_CHANNELS];
+  size_t decoded_size;  // Octets of |decode_buf| of the last packet
   decoded_data_callback_t decode_callback;
 } tA2DP_SBC_DECODER_CB;
 
@@ -56,6 +57,7 @@ bool a2dp_sbc_decoder_init(decoded_data_callback_t decode_callback) {
     return false;
   }
 
+  a2dp_sbc_decoder_cb.decoded_size = 0;
   a2dp_sbc_decoder_cb.decode_callback = decode_callback;
   return true;
 }
@@ -96,7 +98,23 @@ bool a2dp_sbc_decoder_decode_packet(BT_HDR* p_buf) {
 
   size_t out_used =
       (out_ptr - a2dp_sbc_decoder_cb.decode_buf) * sizeof(*out_ptr);
+  a2dp_sbc_decoder_cb.decoded_size = out_used;
   a2dp_sbc_decoder_cb.decode_callback(
       reinterpret_cast<uint8_t*>(a2dp_sbc_decoder_cb.decode_buf), out_used);
   return true;
 }
+
+void a2dp_sbc_decoder_conceal_packets(size_t num_packets) {
+  size_t num_samples = a2dp_sbc_decoder_cb.decoded_size / sizeof(int16_t);
+
+  // The level is halved for each packet, the repetition fades out instead of
+  // leaving a gap in the playback.
+  for (size_t i = 0; i < num_packets && num_samples > 0; i++) {
+    for (size_t j = 0; j < num_samples; j++) {
+      a2dp_sbc_decoder_cb.decode_buf[j] /= 2;
+    }
+    a2dp_sbc_decoder_cb.decode_callback(
+        reinterpret_cast<uint8_t*>(a2dp_sbc_decoder_cb.decode_buf),
+        a2dp_sbc_decoder_cb.decoded_size);
+  }
+}
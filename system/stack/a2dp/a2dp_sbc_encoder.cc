@@ -25,6 +25,9 @@
 #include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "a2dp_bitrate_controller.h"
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "common/time_util.h"
@@ -81,6 +84,7 @@ typedef struct {
   size_t media_read_total_dropped_packets;
   size_t media_read_total_actual_reads_count;
   size_t media_read_total_actual_read_bytes;
+  size_t media_read_total_in_place_reads_count;
 
   size_t media_read_total_expected_frames;
   size_t media_read_total_dropped_frames;
@@ -89,11 +93,16 @@ typedef struct {
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
+  a2dp_source_peek_callback_t peek_callback;
+  a2dp_source_consume_callback_t consume_callback;
   uint16_t TxAaMtuSize;
   uint8_t tx_sbc_frames;
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
   uint32_t timestamp;       /* Timestamp for the A2DP frames */
   SBC_ENC_PARAMS sbc_encoder_params;
+  A2dpBitrateController bitrate_controller;
+  int16_t configured_bitpool; /* Bitpool for the target bitrate */
+  int16_t lowest_bitpool;     /* Lowest bitpool the link adaptation uses */
   tA2DP_FEEDING_PARAMS feeding_params;
   tA2DP_SBC_FEEDING_STATE feeding_state;
   int16_t pcmBuffer[SBC_MAX_PCM_BUFFER_SIZE];
@@ -107,7 +116,8 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
                                     bool* p_restart_input,
                                     bool* p_restart_output,
                                     bool* p_config_updated);
-static bool a2dp_sbc_read_feeding(uint32_t* bytes);
+static bool a2dp_sbc_read_feeding(uint32_t* bytes, int16_t** p_input);
+static bool a2dp_sbc_peek_feeding(uint32_t read_size, int16_t** p_input);
 static void a2dp_sbc_encode_frames(uint8_t nb_frame);
 static void a2dp_sbc_get_num_frame_iteration(uint8_t* num_of_iterations,
                                              uint8_t* num_of_frames,
@@ -330,6 +340,15 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   /* Reset the SBC encoder */
   SBC_Encoder_Init(&a2dp_sbc_encoder_cb.sbc_encoder_params);
   a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+
+  /* The link adaptation goes down to half the bitrate, within the bitpool
+   * range of the peer. The frames per packet stay those of the configured
+   * bitpool, so that the packets get shorter. */
+  a2dp_sbc_encoder_cb.configured_bitpool = p_encoder_params->s16BitPool;
+  a2dp_sbc_encoder_cb.lowest_bitpool = std::min<int16_t>(
+      p_encoder_params->s16BitPool,
+      std::max<int16_t>(min_bitpool, p_encoder_params->s16BitPool / 2));
+  a2dp_sbc_encoder_cb.bitrate_controller.Reset();
 }
 
 void a2dp_sbc_encoder_cleanup(void) {
@@ -365,6 +384,26 @@ int a2dp_sbc_get_effective_frame_size() {
   return a2dp_sbc_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_sbc_set_in_place_read_callbacks(
+    a2dp_source_peek_callback_t peek_callback,
+    a2dp_source_consume_callback_t consume_callback) {
+  a2dp_sbc_encoder_cb.peek_callback = peek_callback;
+  a2dp_sbc_encoder_cb.consume_callback = consume_callback;
+}
+
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length) {
+  A2dpBitrateController& controller = a2dp_sbc_encoder_cb.bitrate_controller;
+  if (!controller.OnTransmitQueueLength(transmit_queue_length)) return;
+
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+  int16_t bitpool = controller.Scale(a2dp_sbc_encoder_cb.lowest_bitpool,
+                                     a2dp_sbc_encoder_cb.configured_bitpool);
+  log::info("transmit queue length {}: bitpool {} -> {} (step {}/{})",
+            transmit_queue_length, p_encoder_params->s16BitPool, bitpool,
+            controller.step, A2dpBitrateController::kNumSteps);
+  p_encoder_params->s16BitPool = bitpool;
+}
+
 void a2dp_sbc_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
@@ -504,11 +543,14 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
       // Read the PCM data and encode it. If necessary, upsample the data.
       //
       uint32_t num_bytes = 0;
-      if (a2dp_sbc_read_feeding(&num_bytes)) {
+      int16_t* input = a2dp_sbc_encoder_cb.pcmBuffer;
+      if (a2dp_sbc_read_feeding(&num_bytes, &input)) {
         uint8_t* output = (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len;
-        int16_t* input = a2dp_sbc_encoder_cb.pcmBuffer;
         uint16_t output_len = SBC_Encode(p_encoder_params, input, output);
         last_frame_len = output_len;
+        if (input != a2dp_sbc_encoder_cb.pcmBuffer) {
+          a2dp_sbc_encoder_cb.consume_callback(num_bytes);
+        }
 
         /* Update SBC frame length */
         p_buf->len += output_len;
@@ -557,7 +599,28 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
   }
 }
 
-static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
+// Encode the frame straight from the buffer of the audio source when it holds
+// the whole frame and no partial read is pending in the PCM buffer.
+// |p_input| is set to the audio data, which is consumed after the encoding.
+static bool a2dp_sbc_peek_feeding(uint32_t read_size, int16_t** p_input) {
+  if (a2dp_sbc_encoder_cb.peek_callback == nullptr ||
+      a2dp_sbc_encoder_cb.consume_callback == nullptr ||
+      a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue != 0) {
+    return false;
+  }
+
+  const uint8_t* p_data = nullptr;
+  if (a2dp_sbc_encoder_cb.peek_callback(&p_data, read_size) != read_size ||
+      reinterpret_cast<uintptr_t>(p_data) % alignof(int16_t) != 0) {
+    return false;
+  }
+
+  // SBC_Encode() only reads its input
+  *p_input = reinterpret_cast<int16_t*>(const_cast<uint8_t*>(p_data));
+  return true;
+}
+
+static bool a2dp_sbc_read_feeding(uint32_t* bytes_read, int16_t** p_input) {
   SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
   uint16_t blocm_x_subband =
       p_encoder_params->s16NumOfSubBands * p_encoder_params->s16NumOfBlocks;
@@ -601,6 +664,13 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
     read_size =
         bytes_needed - a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue;
     a2dp_sbc_encoder_cb.stats.media_read_total_expected_read_bytes += read_size;
+    if (a2dp_sbc_peek_feeding(read_size, p_input)) {
+      a2dp_sbc_encoder_cb.stats.media_read_total_actual_read_bytes += read_size;
+      a2dp_sbc_encoder_cb.stats.media_read_total_actual_reads_count++;
+      a2dp_sbc_encoder_cb.stats.media_read_total_in_place_reads_count++;
+      *bytes_read = read_size;
+      return true;
+    }
     nb_byte_read = a2dp_sbc_encoder_cb.read_callback(
         ((uint8_t*)a2dp_sbc_encoder_cb.pcmBuffer) +
             a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
@@ -886,6 +956,12 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
         "  SBC Bitpool (min/max)                                   : %d / %d\n",
         A2DP_GetMinBitpoolSbc(codec_info), A2DP_GetMaxBitpoolSbc(codec_info));
   }
+  dprintf(fd,
+          "  SBC Bitpool (current/configured/lowest)                 : %d / "
+          "%d / %d\n",
+          a2dp_sbc_encoder_cb.sbc_encoder_params.s16BitPool,
+          a2dp_sbc_encoder_cb.configured_bitpool,
+          a2dp_sbc_encoder_cb.lowest_bitpool);
 
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_sbc_get_encoder_interval_ms());
@@ -902,6 +978,10 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
           stats->media_read_total_expected_reads_count,
           stats->media_read_total_actual_reads_count);
 
+  dprintf(fd,
+          "  PCM read counts (in place)                              : %zu\n",
+          stats->media_read_total_in_place_reads_count);
+
   dprintf(fd,
           "  PCM read bytes (expected/actual)                        : %zu / "
           "%zu\n",
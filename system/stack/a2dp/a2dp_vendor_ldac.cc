@@ -92,12 +92,15 @@ static const tA2DP_ENCODER_INTERFACE a2dp_encoder_interface_ldac = {
     a2dp_vendor_ldac_get_encoder_interval_ms,
     a2dp_vendor_ldac_get_effective_frame_size,
     a2dp_vendor_ldac_send_frames,
-    a2dp_vendor_ldac_set_transmit_queue_length};
+    a2dp_vendor_ldac_set_transmit_queue_length,
+    nullptr  // set_in_place_read_callbacks
+};
 
 static const tA2DP_DECODER_INTERFACE a2dp_decoder_interface_ldac = {
     a2dp_vendor_ldac_decoder_init,          a2dp_vendor_ldac_decoder_cleanup,
     a2dp_vendor_ldac_decoder_decode_packet, a2dp_vendor_ldac_decoder_start,
     a2dp_vendor_ldac_decoder_suspend,       a2dp_vendor_ldac_decoder_configure,
+    nullptr,  // decoder_conceal_packets
 };
 
 static tA2DP_STATUS A2DP_CodecInfoMatchesCapabilityLdac(
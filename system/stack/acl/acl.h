@@ -25,6 +25,7 @@
 #include "stack/acl/peer_packet_types.h"
 #include "stack/btm/power_mode.h"
 #include "stack/include/btm_status.h"
+#include "stack/include/hcidefs.h"
 #include "stack/include/hcimsgs.h"
 #include "types/bt_transport.h"
 #include "types/hci_role.h"
@@ -328,6 +329,12 @@ struct tACL_CB {
   friend struct StackAclBtmAcl;
 
   tACL_CONN acl_db[MAX_L2CAP_LINKS];
+  // Where in acl_db each HCI handle, and each transport's last looked up
+  // address, were last found. These are hints only: each lookup checks the
+  // entry first and scans acl_db on a mismatch, so connections may be set up
+  // and torn down without updating them.
+  uint8_t handle_to_index_hint[HCI_HANDLE_MAX + 1] = {};
+  uint8_t bda_index_hint[BT_TRANSPORT_LE + 1] = {};
   tBTM_ROLE_SWITCH_CMPL switch_role_ref_data;
   uint16_t btm_acl_pkt_types_supported = kDefaultPacketTypeMask;
   uint16_t btm_def_link_policy;
@@ -357,6 +364,14 @@ struct tACL_CB {
     }
     return cnt;
   }
+
+  unsigned NumberOfActiveLinks(tBT_TRANSPORT transport) const {
+    unsigned cnt = 0;
+    for (int i = 0; i < MAX_L2CAP_LINKS; i++) {
+      if (acl_db[i].InUse() && acl_db[i].transport == transport) ++cnt;
+    }
+    return cnt;
+  }
 };
 
 tACL_CONN* btm_acl_for_bda(const RawAddress& bd_addr, tBT_TRANSPORT transport);
@@ -74,6 +74,7 @@
 #include "stack/include/btm_iso_api.h"
 #include "stack/include/hci_error_code.h"
 #include "stack/include/hcimsgs.h"
+#include "stack/include/inq_hci_link_interface.h"
 #include "stack/include/l2cap_acl_interface.h"
 #include "stack/include/l2cdefs.h"
 #include "stack/include/main_thread.h"
@@ -137,6 +138,9 @@ typedef struct {
 
 constexpr uint8_t BTM_MAX_SW_ROLE_FAILED_ATTEMPTS = 3;
 
+/* Time a bonded peer lost to a supervision timeout is expected to page back */
+constexpr uint64_t kLinkLossReconnectWindowMs = 30000;
+
 /* Define masks for supported and exception 2.0 ACL packet types
  */
 constexpr uint16_t BTM_ACL_SUPPORTED_PKTS_MASK =
@@ -300,10 +304,24 @@ void BTM_acl_after_controller_started() {
  ******************************************************************************/
 tACL_CONN* StackAclBtmAcl::btm_bda_to_acl(const RawAddress& bda,
                                           tBT_TRANSPORT transport) {
-  tACL_CONN* p_acl = &btm_cb.acl_cb_.acl_db[0];
+  tACL_CB& acl_cb = btm_cb.acl_cb_;
+  // Lookups come in bursts for the same device: try where it was last found
+  uint8_t* hint = (transport <= BT_TRANSPORT_LE)
+                      ? &acl_cb.bda_index_hint[transport]
+                      : nullptr;
+  if (hint != nullptr) {
+    tACL_CONN* p_acl = &acl_cb.acl_db[*hint];
+    if (p_acl->in_use && p_acl->remote_addr == bda &&
+        p_acl->transport == transport) {
+      return p_acl;
+    }
+  }
+
+  tACL_CONN* p_acl = &acl_cb.acl_db[0];
   for (uint8_t index = 0; index < MAX_L2CAP_LINKS; index++, p_acl++) {
     if ((p_acl->in_use) && p_acl->remote_addr == bda &&
         p_acl->transport == transport) {
+      if (hint != nullptr) *hint = index;
       return p_acl;
     }
   }
@@ -345,10 +363,22 @@ void btm_acl_consolidate(const RawAddress& identity_addr,
  *
  ******************************************************************************/
 uint8_t btm_handle_to_acl_index(uint16_t hci_handle) {
-  tACL_CONN* p = &btm_cb.acl_cb_.acl_db[0];
+  tACL_CB& acl_cb = btm_cb.acl_cb_;
+  if (hci_handle <= HCI_HANDLE_MAX) {
+    uint8_t hint = acl_cb.handle_to_index_hint[hci_handle];
+    const tACL_CONN& acl = acl_cb.acl_db[hint];
+    if (acl.in_use && acl.hci_handle == hci_handle) {
+      return hint;
+    }
+  }
+
+  tACL_CONN* p = &acl_cb.acl_db[0];
   uint8_t xx;
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p++) {
     if ((p->in_use) && (p->hci_handle == hci_handle)) {
+      if (hci_handle <= HCI_HANDLE_MAX) {
+        acl_cb.handle_to_index_hint[hci_handle] = xx;
+      }
       break;
     }
   }
@@ -469,6 +499,8 @@ void btm_acl_created(const RawAddress& bda, uint16_t hci_handle,
       internal_.btm_establish_continue(p_acl);
     }
   }
+
+  btm_scan_policy_update();
 }
 
 void btm_acl_create_failed(const RawAddress& bda, tBT_TRANSPORT transport,
@@ -499,6 +531,7 @@ void btm_acl_removed(uint16_t handle) {
     BTM_PM_OnDisconnected(handle);
   }
   p_acl->Reset();
+  btm_scan_policy_update();
 }
 
 /*******************************************************************************
@@ -2342,6 +2375,7 @@ bool acl_set_peer_le_features_from_handle(uint16_t hci_handle,
 void on_acl_br_edr_connected(const RawAddress& bda, uint16_t handle,
                              uint8_t enc_mode, bool locally_initiated) {
   power_telemetry::GetInstance().LogLinkDetails(handle, bda, true, true);
+  BTM_CancelExpectedReconnect(bda);
   if (delayed_role_change_ != nullptr && delayed_role_change_->bd_addr == bda) {
     btm_sec_connected(bda, handle, HCI_SUCCESS, enc_mode,
                       delayed_role_change_->new_role);
@@ -2413,6 +2447,15 @@ void btm_acl_disconnected(tHCI_STATUS status, uint16_t handle,
     acl_set_disconnect_reason(static_cast<tHCI_STATUS>(reason));
   }
 
+  /* A bonded peer that went out of range usually pages back when it returns */
+  const tACL_CONN* p_acl = internal_.acl_get_connection_from_handle(handle);
+  if (p_acl != nullptr && p_acl->is_transport_br_edr() &&
+      reason == HCI_ERR_CONNECTION_TOUT &&
+      btm_sec_is_a_bonded_dev(p_acl->remote_addr)) {
+    BTM_RegisterExpectedReconnect(p_acl->remote_addr,
+                                  kLinkLossReconnectWindowMs);
+  }
+
   /* Let L2CAP know about it */
   l2c_link_hci_disc_comp(handle, reason);
 
@@ -2506,6 +2549,17 @@ void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf) {
     return bluetooth::shim::ACL_WriteData(p_acl->hci_handle, p_buf);
 }
 
+void acl_send_retained_data_packet_br_edr(const RawAddress& bd_addr,
+                                          const BT_HDR* p_buf) {
+    tACL_CONN* p_acl = internal_.btm_bda_to_acl(bd_addr, BT_TRANSPORT_BR_EDR);
+    if (p_acl == nullptr) {
+      log::warn("Acl br_edr data write for unknown device:{}", bd_addr);
+      return;
+    }
+    power_telemetry::GetInstance().LogTxAclPktData(p_buf->len);
+    return bluetooth::shim::ACL_WriteRetainedData(p_acl->hci_handle, p_buf);
+}
+
 void acl_send_data_packet_ble(const RawAddress& bd_addr, BT_HDR* p_buf) {
     tACL_CONN* p_acl = internal_.btm_bda_to_acl(bd_addr, BT_TRANSPORT_LE);
     if (p_acl == nullptr) {
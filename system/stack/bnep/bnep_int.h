@@ -119,13 +119,15 @@ typedef struct {
   RawAddress sent_mcast_filter_start[BNEP_MAX_MULTI_FILTERS];
   RawAddress sent_mcast_filter_end[BNEP_MAX_MULTI_FILTERS];
 
+  /* Filters set by the peer, sorted and merged into disjoint ranges. The
+   * multicast ranges hold the addresses as big endian 48 bit integers */
   uint16_t rcvd_num_filters;
   uint16_t rcvd_prot_filter_start[BNEP_MAX_PROT_FILTERS];
   uint16_t rcvd_prot_filter_end[BNEP_MAX_PROT_FILTERS];
 
   uint16_t rcvd_mcast_filters;
-  RawAddress rcvd_mcast_filter_start[BNEP_MAX_MULTI_FILTERS];
-  RawAddress rcvd_mcast_filter_end[BNEP_MAX_MULTI_FILTERS];
+  uint64_t rcvd_mcast_filter_start[BNEP_MAX_MULTI_FILTERS];
+  uint64_t rcvd_mcast_filter_end[BNEP_MAX_MULTI_FILTERS];
 
   uint16_t bad_pkts_rcvd;
   uint8_t re_transmits;
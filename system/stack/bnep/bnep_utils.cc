@@ -25,6 +25,9 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
+#include <utility>
+
 #include "bnep_int.h"
 #include "hci/controller_interface.h"
 #include "internal_include/bt_target.h"
@@ -861,6 +864,75 @@ bad_packet_length:
   return NULL;
 }
 
+/*******************************************************************************
+ *
+ * Function         bnepu_merge_filter_ranges
+ *
+ * Description      This function sorts filter ranges by their start and
+ *                  merges the ones that overlap or are adjacent, so that
+ *                  bnepu_in_filter_ranges can stop at the first range past
+ *                  the value.
+ *
+ * Returns          the number of ranges left
+ *
+ ******************************************************************************/
+template <typename T>
+static uint16_t bnepu_merge_filter_ranges(T* p_start, T* p_end,
+                                          uint16_t num_ranges) {
+  for (uint16_t xx = 1; xx < num_ranges; xx++) {
+    for (uint16_t yy = xx; yy > 0 && p_start[yy] < p_start[yy - 1]; yy--) {
+      std::swap(p_start[yy], p_start[yy - 1]);
+      std::swap(p_end[yy], p_end[yy - 1]);
+    }
+  }
+
+  uint16_t num_merged = 0;
+  for (uint16_t xx = 0; xx < num_ranges; xx++) {
+    if (num_merged > 0 && p_start[xx] <= p_end[num_merged - 1] + 1) {
+      p_end[num_merged - 1] = std::max(p_end[num_merged - 1], p_end[xx]);
+    } else {
+      p_start[num_merged] = p_start[xx];
+      p_end[num_merged] = p_end[xx];
+      num_merged++;
+    }
+  }
+  return num_merged;
+}
+
+/*******************************************************************************
+ *
+ * Function         bnepu_in_filter_ranges
+ *
+ * Description      This function checks a value against ranges merged by
+ *                  bnepu_merge_filter_ranges.
+ *
+ * Returns          true if one of the ranges contains the value
+ *
+ ******************************************************************************/
+template <typename T>
+static bool bnepu_in_filter_ranges(const T* p_start, const T* p_end,
+                                   uint16_t num_ranges, T value) {
+  for (uint16_t xx = 0; xx < num_ranges; xx++) {
+    if (value < p_start[xx]) return false;
+    if (value <= p_end[xx]) return true;
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bnepu_mcast_filter_key
+ *
+ * Description      This function converts a multicast address to the big
+ *                  endian 48 bit integer the multicast ranges are kept as.
+ *
+ ******************************************************************************/
+static uint64_t bnepu_mcast_filter_key(const uint8_t* p_addr) {
+  uint64_t key = 0;
+  for (int xx = 0; xx < BD_ADDR_LEN; xx++) key = (key << 8) | p_addr[xx];
+  return key;
+}
+
 /*******************************************************************************
  *
  * Function         bnepu_process_peer_filter_set
@@ -927,6 +999,14 @@ void bnepu_process_peer_filter_set(tBNEP_CONN* p_bcb, uint8_t* p_filters,
     p_bcb->rcvd_prot_filter_start[xx] = start;
     p_bcb->rcvd_prot_filter_end[xx] = end;
   }
+  p_bcb->rcvd_num_filters =
+      bnepu_merge_filter_ranges(p_bcb->rcvd_prot_filter_start,
+                                p_bcb->rcvd_prot_filter_end, num_filters);
+
+  /* Ranges covering every protocol are the same as no filter at all */
+  if (p_bcb->rcvd_num_filters == 1 && p_bcb->rcvd_prot_filter_start[0] == 0 &&
+      p_bcb->rcvd_prot_filter_end[0] == 0xFFFF)
+    p_bcb->rcvd_num_filters = 0;
 
   bnepu_send_peer_filter_rsp(p_bcb, resp_code);
 }
@@ -1031,7 +1111,7 @@ void bnepu_process_peer_multicast_filter_set(tBNEP_CONN* p_bcb,
                                              uint8_t* p_filters, uint16_t len) {
   uint16_t resp_code = BNEP_FILTER_CRL_OK;
   uint16_t num_filters, xx;
-  uint8_t *p_temp_filters, null_bda[BD_ADDR_LEN] = {0, 0, 0, 0, 0, 0};
+  uint8_t* p_temp_filters;
 
   if ((p_bcb->con_state != BNEP_STATE_CONNECTED) &&
       (!(p_bcb->con_flags & BNEP_FLAGS_CONN_COMPLETED))) {
@@ -1073,21 +1153,23 @@ void bnepu_process_peer_multicast_filter_set(tBNEP_CONN* p_bcb,
   p_bcb->rcvd_mcast_filters = num_filters;
   p_temp_filters = p_filters;
   for (xx = 0; xx < num_filters; xx++) {
-    memcpy(p_bcb->rcvd_mcast_filter_start[xx].address, p_temp_filters, BD_ADDR_LEN);
-    memcpy(p_bcb->rcvd_mcast_filter_end[xx].address, p_temp_filters + BD_ADDR_LEN,
-           BD_ADDR_LEN);
+    p_bcb->rcvd_mcast_filter_start[xx] = bnepu_mcast_filter_key(p_temp_filters);
+    p_bcb->rcvd_mcast_filter_end[xx] =
+        bnepu_mcast_filter_key(p_temp_filters + BD_ADDR_LEN);
     p_temp_filters += (BD_ADDR_LEN * 2);
 
     /* Check if any of the ranges have all zeros as both starting and ending
      * addresses */
-    if ((memcmp(null_bda, p_bcb->rcvd_mcast_filter_start[xx].address,
-                BD_ADDR_LEN) == 0) &&
-        (memcmp(null_bda, p_bcb->rcvd_mcast_filter_end[xx].address,
-                BD_ADDR_LEN) == 0)) {
+    if (p_bcb->rcvd_mcast_filter_start[xx] == 0 &&
+        p_bcb->rcvd_mcast_filter_end[xx] == 0) {
       p_bcb->rcvd_mcast_filters = 0xFFFF;
       break;
     }
   }
+  if (p_bcb->rcvd_mcast_filters != 0xFFFF)
+    p_bcb->rcvd_mcast_filters =
+        bnepu_merge_filter_ranges(p_bcb->rcvd_mcast_filter_start,
+                                  p_bcb->rcvd_mcast_filter_end, num_filters);
 
   log::verbose("BNEP multicast filters {}", p_bcb->rcvd_mcast_filters);
   bnepu_send_peer_multicast_filter_rsp(p_bcb, resp_code);
@@ -1195,7 +1277,7 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
                                     uint16_t protocol, bool fw_ext_present,
                                     uint8_t* p_data, uint16_t org_len) {
   if (p_bcb->rcvd_num_filters) {
-    uint16_t i, proto;
+    uint16_t proto;
 
     /* Findout the actual protocol to check for the filtering */
     proto = protocol;
@@ -1224,13 +1306,9 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
       BE_STREAM_TO_UINT16(proto, p_data);
     }
 
-    for (i = 0; i < p_bcb->rcvd_num_filters; i++) {
-      if ((p_bcb->rcvd_prot_filter_start[i] <= proto) &&
-          (proto <= p_bcb->rcvd_prot_filter_end[i]))
-        break;
-    }
-
-    if (i == p_bcb->rcvd_num_filters) {
+    if (!bnepu_in_filter_ranges(p_bcb->rcvd_prot_filter_start,
+                                p_bcb->rcvd_prot_filter_end,
+                                p_bcb->rcvd_num_filters, proto)) {
       log::verbose("Ignoring protocol 0x{:x} in BNEP data write", proto);
       return BNEP_IGNORE_CMD;
     }
@@ -1238,27 +1316,16 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
 
   /* Ckeck for multicast address filtering */
   if ((dest_addr.address[0] & 0x01) && p_bcb->rcvd_mcast_filters) {
-    uint16_t i;
-
-    /* Check if every multicast should be filtered */
-    if (p_bcb->rcvd_mcast_filters != 0xFFFF) {
-      /* Check if the address is mentioned in the filter range */
-      for (i = 0; i < p_bcb->rcvd_mcast_filters; i++) {
-        if ((memcmp(p_bcb->rcvd_mcast_filter_start[i].address,
-                    dest_addr.address, BD_ADDR_LEN) <= 0) &&
-            (memcmp(p_bcb->rcvd_mcast_filter_end[i].address, dest_addr.address,
-                    BD_ADDR_LEN) >= 0))
-          break;
-      }
-    }
-
     /*
     ** If every multicast should be filtered or the address is not in the filter
     *range
     ** drop the packet
     */
     if ((p_bcb->rcvd_mcast_filters == 0xFFFF) ||
-        (i == p_bcb->rcvd_mcast_filters)) {
+        !bnepu_in_filter_ranges(p_bcb->rcvd_mcast_filter_start,
+                                p_bcb->rcvd_mcast_filter_end,
+                                p_bcb->rcvd_mcast_filters,
+                                bnepu_mcast_filter_key(dest_addr.address))) {
       log::verbose("Ignoring multicast address {} in BNEP data write",
                    dest_addr);
       return BNEP_IGNORE_CMD;
@@ -30,9 +30,16 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
+#include <optional>
+#include <vector>
+
 #include "btm_ble_int.h"
 #include "btm_dev.h"
 #include "btm_sec_cb.h"
+#include "common/lru_cache.h"
+#include "common/time_util.h"
+#include "crypto_toolbox/aes.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/controller_interface.h"
 #include "main/shim/entry.h"
@@ -48,6 +55,100 @@ using namespace bluetooth;
 
 extern tBTM_CB btm_cb;
 
+namespace {
+
+/* Resolving a RPA takes one AES-128 per bonded LE device, and the same RPA is
+ * reported again at every advertising event. The result is kept until the
+ * peer is expected to have rotated its RPA. */
+constexpr size_t kRpaCacheCapacity = 64;
+constexpr uint64_t kRpaCacheTimeoutMs = 15 * 60 * 1000;
+
+struct RpaCacheEntry {
+  /* IRK the RPA was resolved with, std::nullopt if no IRK resolves it */
+  std::optional<Octet16> irk;
+  /* Number of devices with an IRK when no IRK resolved the RPA */
+  size_t num_irks;
+  uint64_t expiry_ms;
+};
+
+bluetooth::common::LruCache<RawAddress, RpaCacheEntry> rpa_cache(
+    kRpaCacheCapacity);
+
+/* AES key schedule of the IRK of each device, so that resolving a RPA does
+ * not expand every IRK again. */
+struct IrkKeySchedule {
+  Octet16 irk;
+  aes_context ctx;
+};
+
+std::vector<IrkKeySchedule> irk_key_schedules;
+bool irk_key_schedules_valid = false;
+
+bool has_irk(const tBTM_SEC_DEV_REC* p_dev_rec) {
+  return (p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) &&
+         (p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_PID);
+}
+
+/* The device type is updated without invalidating the cache, count the
+ * devices that can resolve a RPA to tell if a negative result is stale. */
+size_t count_devs_with_irk() {
+  size_t count = 0;
+  list_node_t* end = list_end(btm_sec_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_sec_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    if (has_irk(static_cast<tBTM_SEC_DEV_REC*>(list_node(node)))) count++;
+  }
+  return count;
+}
+
+void build_irk_key_schedules() {
+  irk_key_schedules.clear();
+  list_node_t* end = list_end(btm_sec_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_sec_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (!(p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_PID)) continue;
+    IrkKeySchedule& schedule = irk_key_schedules.emplace_back();
+    schedule.irk = p_dev_rec->sec_rec.ble_keys.irk;
+    /* aes_128() takes keys in little endian */
+    Octet16 key_reversed;
+    std::reverse_copy(schedule.irk.begin(), schedule.irk.end(),
+                      key_reversed.begin());
+    aes_set_key(key_reversed.data(), key_reversed.size(), &schedule.ctx);
+  }
+  irk_key_schedules_valid = true;
+}
+
+/* Return true if the hash of |rpa| is the AES-128 of its prand with the
+ * expanded IRK |ctx|. Same as rpa_matches_irk(), in big endian. */
+bool rpa_matches_key_schedule(const RawAddress& rpa, const aes_context& ctx) {
+  uint8_t prand[N_BLOCK] = {};
+  prand[N_BLOCK - 3] = rpa.address[0];
+  prand[N_BLOCK - 2] = rpa.address[1];
+  prand[N_BLOCK - 1] = rpa.address[2];
+  uint8_t x[N_BLOCK];
+  aes_encrypt(prand, x, &ctx);
+  return memcmp(&x[N_BLOCK - 3], &rpa.address[3], 3) == 0;
+}
+
+/* Return the first device record holding |irk|, in the order of
+ * sec_dev_rec. */
+tBTM_SEC_DEV_REC* find_dev_by_irk(const Octet16& irk) {
+  list_node_t* end = list_end(btm_sec_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_sec_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (has_irk(p_dev_rec) && p_dev_rec->sec_rec.ble_keys.irk == irk) {
+      return p_dev_rec;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 /*******************************************************************************
  *  Utility functions for Random address resolving
  ******************************************************************************/
@@ -66,6 +167,7 @@ bool btm_ble_init_pseudo_addr(tBTM_SEC_DEV_REC* p_dev_rec,
                               const RawAddress& new_pseudo_addr) {
   if (p_dev_rec->ble.pseudo_addr.IsEmpty()) {
     p_dev_rec->ble.pseudo_addr = new_pseudo_addr;
+    btm_sec_cb.ClearDevRecIndexes();
     return true;
   }
 
@@ -113,37 +215,55 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa,
   return false;
 }
 
-/** This function match the random address to the appointed device record,
- * starting from calculating IRK. If the record index exceeds the maximum record
- * number, matching failed and send a callback. */
-static bool btm_ble_match_random_bda(void* data, void* context) {
-  tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
-  RawAddress* random_bda = static_cast<RawAddress*>(context);
-
-  if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
-      !(p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_PID))
-    // Match fails preconditions
-    return true;
-
-  if (rpa_matches_irk(*random_bda, p_dev_rec->sec_rec.ble_keys.irk)) {
-    // Matched
-    return false;
-  }
-
-  // This item not a match, continue iteration
-  return true;
-}
-
 /** This function is called to resolve a random address.
  * Returns pointer to the security record of the device whom a random address is
  * matched to.
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
-  list_node_t* n = list_foreach(btm_sec_cb.sec_dev_rec,
-                                btm_ble_match_random_bda, (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  auto cached = rpa_cache.find(random_bda);
+  if (cached != rpa_cache.end()) {
+    if (now_ms < cached->second.expiry_ms) {
+      if (!cached->second.irk.has_value()) {
+        if (cached->second.num_irks == count_devs_with_irk()) return nullptr;
+      } else {
+        /* The device may have been removed since */
+        tBTM_SEC_DEV_REC* p_dev_rec = find_dev_by_irk(*cached->second.irk);
+        if (p_dev_rec != nullptr) return p_dev_rec;
+      }
+    }
+    rpa_cache.extract(random_bda);
+  }
+
+  if (!irk_key_schedules_valid) build_irk_key_schedules();
+
+  RpaCacheEntry entry{.irk = std::nullopt,
+                      .num_irks = 0,
+                      .expiry_ms = now_ms + kRpaCacheTimeoutMs};
+  tBTM_SEC_DEV_REC* p_dev_rec = nullptr;
+  for (const auto& schedule : irk_key_schedules) {
+    if (!rpa_matches_key_schedule(random_bda, schedule.ctx)) continue;
+    p_dev_rec = find_dev_by_irk(schedule.irk);
+    if (p_dev_rec != nullptr) {
+      entry.irk = schedule.irk;
+      break;
+    }
+  }
+  if (!entry.irk.has_value()) entry.num_irks = count_devs_with_irk();
+  rpa_cache.insert_or_assign(random_bda, std::move(entry));
+  return p_dev_rec;
+}
+
+void btm_ble_invalidate_rpa_cache() {
+  rpa_cache.clear();
+  for (auto& schedule : irk_key_schedules) {
+    schedule.irk.fill(0);
+    memset(&schedule.ctx, 0, sizeof(schedule.ctx));
+  }
+  irk_key_schedules.clear();
+  irk_key_schedules_valid = false;
 }
 
 /*******************************************************************************
@@ -154,6 +274,12 @@ static tBTM_SEC_DEV_REC* btm_find_dev_by_identity_addr(
     const RawAddress& bd_addr, uint8_t addr_type) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  auto it = btm_sec_cb.dev_rec_by_identity_addr.find(bd_addr);
+  if (it != btm_sec_cb.dev_rec_by_identity_addr.end() &&
+      it->second->ble.identity_address_with_type.bda == bd_addr) {
+    return it->second;
+  }
+
   list_node_t* end = list_end(btm_sec_cb.sec_dev_rec);
   for (list_node_t* node = list_begin(btm_sec_cb.sec_dev_rec); node != end;
        node = list_next(node)) {
@@ -166,6 +292,9 @@ static tBTM_SEC_DEV_REC* btm_find_dev_by_identity_addr(
                   p_dev_rec->ble.identity_address_with_type.type, addr_type);
 
       /* found the match */
+      if (!bd_addr.IsEmpty()) {
+        btm_sec_cb.dev_rec_by_identity_addr[bd_addr] = p_dev_rec;
+      }
       return p_dev_rec;
     }
   }
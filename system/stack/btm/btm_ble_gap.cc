@@ -621,6 +621,7 @@ tBTM_STATUS BTM_BleObserve(bool start, uint8_t duration,
 
     if (status == BTM_CMD_STARTED) {
       btm_cb.ble_ctr_cb.set_ble_observe_active();
+      btm_scan_policy_update();
       if (duration != 0) {
         /* start observer timer */
         uint64_t duration_ms = duration * 1000;
@@ -1629,6 +1630,7 @@ tBTM_STATUS btm_ble_start_inquiry(uint8_t duration) {
 
   btm_cb.btm_inq_vars.inq_active |= BTM_BLE_GENERAL_INQUIRY;
   btm_cb.ble_ctr_cb.set_ble_inquiry_active();
+  btm_scan_policy_update();
 
   log::verbose("btm_ble_start_inquiry inq_active = 0x{:02x}",
                btm_cb.btm_inq_vars.inq_active);
@@ -1789,18 +1791,18 @@ static void btm_ble_update_adv_flag(uint8_t flag) {
  * condition
  */
 static uint8_t btm_ble_is_discoverable(const RawAddress& /* bda */,
-                                       std::vector<uint8_t> const& adv_data) {
+                                       const AdvertiseDataIndex& adv_data) {
   uint8_t scan_state = BTM_BLE_NOT_SCANNING;
 
   /* for observer, always "discoverable */
   if (btm_cb.ble_ctr_cb.is_ble_observe_active())
     scan_state |= BTM_BLE_OBS_RESULT;
 
-  if (!adv_data.empty()) {
+  if (!adv_data.IsEmpty()) {
     uint8_t flag = 0;
     uint8_t data_len;
-    const uint8_t* p_flag = AdvertiseDataParser::GetFieldByType(
-        adv_data, BTM_BLE_AD_TYPE_FLAG, &data_len);
+    const uint8_t* p_flag =
+        adv_data.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &data_len);
     if (p_flag != NULL && data_len != 0) {
       flag = *p_flag;
 
@@ -1948,22 +1950,21 @@ static DEV_CLASS btm_ble_appearance_to_cod(uint16_t appearance) {
   return dev_class;
 }
 
-DEV_CLASS btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data) {
+DEV_CLASS btm_ble_get_appearance_as_cod(const AdvertiseDataIndex& data) {
   /* Check to see the BLE device has the Appearance UUID in the advertising
    * data. If it does then try to convert the appearance value to a class of
    * device value Fluoride can use. Otherwise fall back to trying to infer if
    * it is a HID device based on the service class.
    */
   uint8_t len;
-  const uint8_t* p_uuid16 = AdvertiseDataParser::GetFieldByType(
-      data, BTM_BLE_AD_TYPE_APPEARANCE, &len);
+  const uint8_t* p_uuid16 =
+      data.GetFieldByType(BTM_BLE_AD_TYPE_APPEARANCE, &len);
   if (p_uuid16 && len == 2) {
     return btm_ble_appearance_to_cod((uint16_t)p_uuid16[0] |
                                      (p_uuid16[1] << 8));
   }
 
-  p_uuid16 = AdvertiseDataParser::GetFieldByType(
-      data, BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
+  p_uuid16 = data.GetFieldByType(BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
   if (p_uuid16 == NULL) {
     return kDevClassUnclassified;
   }
@@ -1983,6 +1984,10 @@ DEV_CLASS btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data) {
   return kDevClassUnclassified;
 }
 
+DEV_CLASS btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data) {
+  return btm_ble_get_appearance_as_cod(AdvertiseDataIndex(data));
+}
+
 /**
  * Update adv packet information into inquiry result.
  */
@@ -1992,7 +1997,7 @@ static void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
                                       uint8_t secondary_phy,
                                       uint8_t advertising_sid, int8_t tx_power,
                                       int8_t rssi, uint16_t periodic_adv_int,
-                                      std::vector<uint8_t> const& data) {
+                                      const AdvertiseDataIndex& data) {
   tBTM_INQ_RESULTS* p_cur = &p_i->inq_info.results;
   uint8_t len;
 
@@ -2024,10 +2029,9 @@ static void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
       btm_cb.btm_inq_vars.inq_counter; /* Mark entry for current inquiry */
 
   bool has_advertising_flags = false;
-  if (!data.empty()) {
+  if (!data.IsEmpty()) {
     uint8_t local_flag = 0;
-    const uint8_t* p_flag =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_FLAG, &len);
+    const uint8_t* p_flag = data.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &len);
     if (p_flag != NULL && len != 0) {
       has_advertising_flags = true;
       p_cur->flag = *p_flag;
@@ -2036,34 +2040,30 @@ static void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
 
     p_cur->dev_class = btm_ble_get_appearance_as_cod(data);
 
-    const uint8_t* p_rsi =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_RSI, &len);
+    const uint8_t* p_rsi = data.GetFieldByType(BTM_BLE_AD_TYPE_RSI, &len);
     if (p_rsi != nullptr && len == 6) {
       STREAM_TO_BDADDR(p_cur->ble_ad_rsi, p_rsi);
     }
 
-    const uint8_t* p_service_data = data.data();
-    uint8_t service_data_len = 0;
-
-    while ((p_service_data = AdvertiseDataParser::GetFieldByType(
-                p_service_data + service_data_len,
-                data.size() - (p_service_data - data.data()) - service_data_len,
-                BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE, &service_data_len))) {
-      uint16_t uuid;
-      const uint8_t* p_uuid = p_service_data;
-      if (service_data_len < 2) {
-        continue;
-      }
-      STREAM_TO_UINT16(uuid, p_uuid);
-
-      if (uuid == 0x184E /* Audio Stream Control service */ ||
-          uuid == 0x184F /* Broadcast Audio Scan service */ ||
-          uuid == 0x1850 /* Published Audio Capabilities service */ ||
-          uuid == 0x1853 /* Common Audio service */) {
-        p_cur->ble_ad_is_le_audio_capable = true;
-        break;
-      }
-    }
+    data.ForEachFieldOfType(
+        BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE,
+        [p_cur](const uint8_t* p_service_data, uint8_t service_data_len) {
+          uint16_t uuid;
+          const uint8_t* p_uuid = p_service_data;
+          if (service_data_len < 2) {
+            return true;
+          }
+          STREAM_TO_UINT16(uuid, p_uuid);
+
+          if (uuid == 0x184E /* Audio Stream Control service */ ||
+              uuid == 0x184F /* Broadcast Audio Scan service */ ||
+              uuid == 0x1850 /* Published Audio Capabilities service */ ||
+              uuid == 0x1853 /* Common Audio service */) {
+            p_cur->ble_ad_is_le_audio_capable = true;
+            return false;
+          }
+          return true;
+        });
     if (com::android::bluetooth::flags::ensure_valid_adv_flag()) {
       // Non-connectable packets may omit flags entirely, in which case nothing
       // should be assumed about their values (CSSv10, 1.3.1). Thus, do not
@@ -2192,12 +2192,9 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
     return;
   }
 
-  bool include_rsi = false;
-  uint8_t len;
-  if (AdvertiseDataParser::GetFieldByType(adv_data, BTM_BLE_AD_TYPE_RSI,
-                                          &len)) {
-    include_rsi = true;
-  }
+  /* Index the fields once for all the lookups done on this report */
+  const AdvertiseDataIndex ad_index(adv_data);
+  bool include_rsi = ad_index.HasField(BTM_BLE_AD_TYPE_RSI);
 
   tINQ_DB_ENT* p_i = btm_inq_db_find(bda);
 
@@ -2237,7 +2234,7 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
   /* update the LE device information in inquiry database */
   btm_ble_update_inq_result(p_i, addr_type, bda, evt_type, primary_phy,
                             secondary_phy, advertising_sid, tx_power, rssi,
-                            periodic_adv_int, adv_data);
+                            periodic_adv_int, ad_index);
 
   if (include_rsi) {
     (&p_i->inq_info.results)->include_rsi = true;
@@ -2259,7 +2256,7 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
         const_cast<uint8_t*>(adv_data.data()), adv_data.size());
   }
 
-  uint8_t result = btm_ble_is_discoverable(bda, adv_data);
+  uint8_t result = btm_ble_is_discoverable(bda, ad_index);
   if (result == 0) {
     // Device no longer discoverable so discard outstanding advertising packet
     cache.Clear(addr_type, bda);
@@ -2297,15 +2294,12 @@ void btm_ble_process_adv_pkt_cont_for_inquiry(
     std::vector<uint8_t> advertising_data) {
   bool update = true;
 
-  bool include_rsi = false;
-  uint8_t len;
-  if (AdvertiseDataParser::GetFieldByType(advertising_data, BTM_BLE_AD_TYPE_RSI,
-                                          &len)) {
-    include_rsi = true;
-  }
+  /* Index the fields once for all the lookups done on this report */
+  const AdvertiseDataIndex ad_index(advertising_data);
+  bool include_rsi = ad_index.HasField(BTM_BLE_AD_TYPE_RSI);
 
-  const uint8_t* p_flag = AdvertiseDataParser::GetFieldByType(
-      advertising_data, BTM_BLE_AD_TYPE_FLAG, &len);
+  uint8_t len;
+  const uint8_t* p_flag = ad_index.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &len);
 
   tINQ_DB_ENT* p_i = btm_inq_db_find(bda);
 
@@ -2353,7 +2347,7 @@ void btm_ble_process_adv_pkt_cont_for_inquiry(
   /* update the LE device information in inquiry database */
   btm_ble_update_inq_result(p_i, addr_type, bda, evt_type, primary_phy,
                             secondary_phy, advertising_sid, tx_power, rssi,
-                            periodic_adv_int, advertising_data);
+                            periodic_adv_int, ad_index);
 
   if (include_rsi) {
     (&p_i->inq_info.results)->include_rsi = true;
@@ -2375,7 +2369,7 @@ void btm_ble_process_adv_pkt_cont_for_inquiry(
         const_cast<uint8_t*>(advertising_data.data()), advertising_data.size());
   }
 
-  uint8_t result = btm_ble_is_discoverable(bda, advertising_data);
+  uint8_t result = btm_ble_is_discoverable(bda, ad_index);
   if (result == 0) {
     return;
   }
@@ -2466,6 +2460,7 @@ void btm_ble_stop_inquiry(void) {
                                     (double)duration_timestamp / 1000.0,
                                     btm_cb.neighbor.le_inquiry.results));
   btm_cb.ble_ctr_cb.reset_ble_inquiry();
+  btm_scan_policy_update();
 
   /* Cleanup anything remaining on index 0 */
   BTM_BleAdvFilterParamSetup(BTM_BLE_SCAN_COND_DELETE,
@@ -2509,6 +2504,7 @@ static void btm_ble_stop_observe(void) {
   alarm_cancel(btm_cb.ble_ctr_cb.observer_timer);
 
   btm_cb.ble_ctr_cb.reset_ble_observe();
+  btm_scan_policy_update();
 
   btm_cb.ble_ctr_cb.p_obs_results_cb = NULL;
   btm_cb.ble_ctr_cb.p_obs_cmpl_cb = NULL;
@@ -2875,6 +2871,7 @@ void btm_ble_init(void) {
 // Clean up btm ble control block
 void btm_ble_free() {
   alarm_free(btm_cb.ble_ctr_cb.addr_mgnt_cb.refresh_raddr_timer);
+  btm_ble_invalidate_rpa_cache();
 }
 
 /*******************************************************************************
@@ -913,6 +913,7 @@ void btm_sec_save_le_key(const RawAddress& bd_addr, tBTM_LE_KEY_TYPE key_type,
         p_rec->ble.identity_address_with_type.type =
             p_keys->pid_key.identity_addr_type;
         p_rec->sec_rec.ble_keys.key_type |= BTM_LE_KEY_PID;
+        btm_ble_invalidate_rpa_cache();
         log::verbose(
             "BTM_LE_KEY_PID key_type=0x{:x} save peer IRK, change bd_addr={} "
             "to id_addr={} id_addr_type=0x{:x}",
@@ -920,6 +921,7 @@ void btm_sec_save_le_key(const RawAddress& bd_addr, tBTM_LE_KEY_TYPE key_type,
             p_keys->pid_key.identity_addr, p_keys->pid_key.identity_addr_type);
         /* update device record address as identity address */
         p_rec->bd_addr = p_keys->pid_key.identity_addr;
+        btm_sec_cb.ClearDevRecIndexes();
         /* combine DUMO device security record if needed */
         btm_consolidate_dev(p_rec);
         break;
@@ -1522,7 +1524,7 @@ void btm_ble_connected(const RawAddress& bda, uint16_t handle,
 
   log::info("Update timestamp for ble connection:{}", bda);
   // TODO() Why is timestamp a counter ?
-  p_dev_rec->timestamp = btm_sec_cb.dev_rec_count++;
+  btm_sec_cb.TouchDevRec(p_dev_rec);
 
   if (is_ble_addr_type_known(addr_type))
     p_dev_rec->ble.SetAddressType(addr_type);
@@ -1530,7 +1532,10 @@ void btm_ble_connected(const RawAddress& bda, uint16_t handle,
     log::warn(
         "Please do not update device record from anonymous le advertisement");
 
-  p_dev_rec->ble.pseudo_addr = bda;
+  if (p_dev_rec->ble.pseudo_addr != bda) {
+    p_dev_rec->ble.pseudo_addr = bda;
+    btm_sec_cb.ClearDevRecIndexes();
+  }
   p_dev_rec->ble_hci_handle = handle;
   p_dev_rec->device_type |= BT_DEVICE_TYPE_BLE;
   p_dev_rec->role_central = (role == HCI_ROLE_CENTRAL) ? true : false;
@@ -45,6 +45,7 @@
 #include "rust/src/connection/ffi/connection_shim.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/acl_api.h"
+#include "stack/include/btm_ble_addr.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/btm_ble_privacy.h"
 #include "stack/include/btm_log_history.h"
@@ -64,7 +65,10 @@ constexpr char kBtmLogTag[] = "BOND";
 static void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->sec_rec.link_key.fill(0);
   memset(&p_dev_rec->sec_rec.ble_keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_sec_cb.ClearDevRecIndexes();
+  btm_sec_cb.ForgetDevRecAge(p_dev_rec);
   list_remove(btm_sec_cb.sec_dev_rec, p_dev_rec);
+  btm_ble_invalidate_rpa_cache();
 }
 
 /*******************************************************************************
@@ -105,7 +109,7 @@ void BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
         bd_addr, fmt::join(dev_class, ""), key_type);
 
     /* "Bump" timestamp for existing record */
-    p_dev_rec->timestamp = btm_sec_cb.dev_rec_count++;
+    btm_sec_cb.TouchDevRec(p_dev_rec);
 
     /* TODO(eisenbach):
      * Small refactor, but leaving original logic for now.
@@ -306,25 +310,61 @@ static bool is_handle_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  auto it = btm_sec_cb.dev_rec_by_handle.find(handle);
+  if (it != btm_sec_cb.dev_rec_by_handle.end() &&
+      !is_handle_equal(it->second, &handle)) {
+    return it->second;
+  }
+
   list_node_t* n =
       list_foreach(btm_sec_cb.sec_dev_rec, is_handle_equal, &handle);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (handle != HCI_INVALID_HANDLE) {
+      btm_sec_cb.dev_rec_by_handle[handle] = p_dev_rec;
+    }
+    return p_dev_rec;
+  }
 
   return NULL;
 }
 
+static bool is_address_literally_equal(const tBTM_SEC_DEV_REC* p_dev_rec,
+                                       const RawAddress& bd_addr) {
+  // If a LE random address is looking for device record
+  return p_dev_rec->bd_addr == bd_addr || p_dev_rec->ble.pseudo_addr == bd_addr;
+}
+
 static bool is_address_equal(void* data, void* context) {
   tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
   const RawAddress* bd_addr = ((RawAddress*)context);
 
-  if (p_dev_rec->bd_addr == *bd_addr) return false;
-  // If a LE random address is looking for device record
-  if (p_dev_rec->ble.pseudo_addr == *bd_addr) return false;
+  if (is_address_literally_equal(p_dev_rec, *bd_addr)) return false;
 
   if (btm_ble_addr_resolvable(*bd_addr, p_dev_rec)) return false;
   return true;
 }
 
+/* Record previously found with |bd_addr| as its address or pseudo address, if
+ * it still has it */
+static tBTM_SEC_DEV_REC* btm_find_dev_from_index(const RawAddress& bd_addr) {
+  auto it = btm_sec_cb.dev_rec_by_addr.find(bd_addr);
+  if (it != btm_sec_cb.dev_rec_by_addr.end() &&
+      is_address_literally_equal(it->second, bd_addr)) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+/* Only remember literal matches, a resolvable private address matches the
+ * record through its IRK and changes over time */
+static void btm_index_dev(const RawAddress& bd_addr,
+                          tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!bd_addr.IsEmpty() && is_address_literally_equal(p_dev_rec, bd_addr)) {
+    btm_sec_cb.dev_rec_by_addr[bd_addr] = p_dev_rec;
+  }
+}
+
 /*******************************************************************************
  *
  * Function         btm_find_dev
@@ -338,9 +378,16 @@ static bool is_address_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev_from_index(bd_addr);
+  if (p_dev_rec != nullptr) return p_dev_rec;
+
   list_node_t* n =
       list_foreach(btm_sec_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    btm_index_dev(bd_addr, p_dev_rec);
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -365,6 +412,12 @@ static bool has_lenc_and_address_is_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev_with_lenc(const RawAddress& bd_addr) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev_from_index(bd_addr);
+  if (p_dev_rec != nullptr &&
+      (p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_LENC)) {
+    return p_dev_rec;
+  }
+
   list_node_t* n = list_foreach(btm_sec_cb.sec_dev_rec,
                                 has_lenc_and_address_is_equal, (void*)&bd_addr);
   if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
@@ -532,6 +585,22 @@ tBTM_SEC_DEV_REC* btm_find_or_alloc_dev(const RawAddress& bd_addr) {
  *
  ******************************************************************************/
 static tBTM_SEC_DEV_REC* btm_find_oldest_dev_rec(void) {
+  /* Records are visited oldest first, so only the bonded records older than
+   * the oldest non-paired one are stepped over. Pairing state is read here
+   * rather than tracked, as the key flags are written from many places. */
+  if (btm_sec_cb.dev_rec_by_age.size() == list_length(btm_sec_cb.sec_dev_rec)) {
+    tBTM_SEC_DEV_REC* p_oldest_paired = NULL;
+    for (const auto& [timestamp, p_dev_rec] : btm_sec_cb.dev_rec_by_age) {
+      if ((p_dev_rec->sec_rec.sec_flags &
+           (BTM_SEC_LINK_KEY_KNOWN | BTM_SEC_LE_LINK_KEY_KNOWN)) == 0) {
+        return p_dev_rec;
+      }
+      if (p_oldest_paired == NULL) p_oldest_paired = p_dev_rec;
+    }
+    return p_oldest_paired;
+  }
+
+  /* Records were added to the list directly, walk all of them */
   tBTM_SEC_DEV_REC* p_oldest = NULL;
   uint32_t ts_oldest = 0xFFFFFFFF;
   tBTM_SEC_DEV_REC* p_oldest_paired = NULL;
@@ -588,6 +657,13 @@ tBTM_SEC_DEV_REC* btm_sec_allocate_dev_rec(void) {
 
   if (list_length(btm_sec_cb.sec_dev_rec) > BTM_SEC_MAX_DEVICE_RECORDS) {
     p_dev_rec = btm_find_oldest_dev_rec();
+    btm_sec_cb.dev_rec_evictions++;
+    if (p_dev_rec->sec_rec.sec_flags &
+        (BTM_SEC_LINK_KEY_KNOWN | BTM_SEC_LE_LINK_KEY_KNOWN)) {
+      btm_sec_cb.bonded_dev_rec_evictions++;
+      log::warn("Evicting bonded device record {} to make room",
+                p_dev_rec->bd_addr);
+    }
     wipe_secrets_and_remove(p_dev_rec);
   }
 
@@ -598,7 +674,7 @@ tBTM_SEC_DEV_REC* btm_sec_allocate_dev_rec(void) {
   // Initialize defaults
   p_dev_rec->sec_rec.sec_flags = BTM_SEC_IN_USE;
   p_dev_rec->sec_rec.bond_type = BOND_TYPE_UNKNOWN;
-  p_dev_rec->timestamp = btm_sec_cb.dev_rec_count++;
+  btm_sec_cb.TouchDevRec(p_dev_rec);
   p_dev_rec->sec_rec.rmt_io_caps = BTM_IO_CAP_UNKNOWN;
   p_dev_rec->suggested_tx_octets = 0;
 
@@ -33,7 +33,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <mutex>
+#include <unordered_map>
 
 #include "advertise_data_parser.h"
 #include "bt_name.h"
@@ -108,6 +110,22 @@ void btm_log_history_scan_mode(uint8_t scan_mode) {
 std::mutex inq_db_lock_;
 // Inquiry database
 tINQ_DB_ENT inq_db_[BTM_INQ_DB_SIZE];
+// In use inquiry database entries by address, so that lookups done for every
+// inquiry result and name/EIR update do not scan the whole database. Guarded by
+// |inq_db_lock_|.
+std::unordered_map<RawAddress, tINQ_DB_ENT*> inq_db_index_;
+
+void inq_db_index_erase(const tINQ_DB_ENT* p_ent) {
+  auto it = inq_db_index_.find(p_ent->inq_info.results.remote_bd_addr);
+  if (it != inq_db_index_.end() && it->second == p_ent) inq_db_index_.erase(it);
+}
+
+void inq_db_index_rebuild() {
+  inq_db_index_.clear();
+  for (tINQ_DB_ENT& ent : inq_db_) {
+    if (ent.in_use) inq_db_index_[ent.inq_info.results.remote_bd_addr] = &ent;
+  }
+}
 
 // Inquiry bluetooth device database lock
 std::mutex bd_db_lock_;
@@ -129,6 +147,134 @@ tBTM_STATUS btm_ble_set_connectability(uint16_t combined_mode);
 tBTM_STATUS btm_ble_start_inquiry(uint8_t duration);
 void btm_ble_stop_inquiry(void);
 
+namespace {
+/* Number of LE links from which LE connection events crowd out classic scans */
+constexpr unsigned kScanPolicyBusyLeLinks = 2;
+/* Shortest page scan interval allowed by the specification (11.25 ms) */
+constexpr uint32_t kMinPageScanInterval = 0x0012;
+
+/* Activity the page and inquiry scan parameters are scheduled around */
+struct ScanLoad {
+  bool le_scan_active;
+  unsigned le_links;
+  unsigned br_edr_links;
+  bool reconnect_expected;
+};
+
+/* Devices expected to reconnect, with the boot time closing their window */
+std::unordered_map<RawAddress, uint64_t> expected_reconnects_;
+
+bool is_adaptive_scan_enabled() {
+  static const bool enabled =
+      osi_property_get_bool(PROPERTY_ADAPTIVE_SCAN, false);
+  return enabled;
+}
+
+/* Adjust the configured scan |interval| and |window| to |load|:
+ * - while a reconnect is expected, page scan runs twice as often with a
+ *   window twice as long, so the peer gets through on its first page train;
+ * - under LE load the window is doubled to make up for the scan slots the
+ *   controller gives to LE connection events and scanning;
+ * - with no link and no LE activity the interval is doubled, up to the spec
+ *   default, to save duty cycle while nothing is expected. */
+void btm_scan_policy_adjust(const ScanLoad& load, bool page_scan,
+                            uint16_t* interval, uint16_t* window) {
+  const uint32_t base_interval = *interval;
+  const uint32_t base_window = *window;
+
+  if (page_scan && load.reconnect_expected) {
+    const uint32_t boosted_interval =
+        std::max<uint32_t>(base_interval / 2, kMinPageScanInterval);
+    *interval = static_cast<uint16_t>(boosted_interval);
+    *window = static_cast<uint16_t>(
+        std::min<uint32_t>(base_window * 2, boosted_interval));
+  } else if (load.le_scan_active || load.le_links >= kScanPolicyBusyLeLinks) {
+    *window = static_cast<uint16_t>(
+        std::min<uint32_t>(base_window * 2, base_interval));
+  } else if (load.br_edr_links == 0 && load.le_links == 0 &&
+             !load.reconnect_expected) {
+    const uint32_t max_interval =
+        page_scan ? HCI_DEF_PAGESCAN_INTERVAL : HCI_DEF_INQUIRYSCAN_INTERVAL;
+    *interval = static_cast<uint16_t>(std::max<uint32_t>(
+        base_interval, std::min<uint32_t>(base_interval * 2, max_interval)));
+  }
+}
+
+void btm_expected_reconnect_timer_timeout(void* /* data */) {
+  btm_scan_policy_update();
+}
+
+/* Drop closed reconnect windows and arm the timer for the next one to close.
+ * Returns true if any window is still open. */
+bool btm_expected_reconnect_refresh() {
+  const uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint64_t next_ms = UINT64_MAX;
+  for (auto it = expected_reconnects_.begin();
+       it != expected_reconnects_.end();) {
+    if (it->second <= now_ms) {
+      it = expected_reconnects_.erase(it);
+      continue;
+    }
+    next_ms = std::min(next_ms, it->second);
+    ++it;
+  }
+
+  alarm_cancel(btm_cb.btm_inq_vars.expected_reconnect_timer);
+  if (next_ms == UINT64_MAX) return false;
+  alarm_set_on_mloop(btm_cb.btm_inq_vars.expected_reconnect_timer,
+                     next_ms - now_ms, btm_expected_reconnect_timer_timeout,
+                     nullptr);
+  return true;
+}
+
+ScanLoad btm_scan_policy_current_load() {
+  return ScanLoad{
+      .le_scan_active = btm_cb.ble_ctr_cb.is_ble_scan_active(),
+      .le_links = btm_cb.acl_cb_.NumberOfActiveLinks(BT_TRANSPORT_LE),
+      .br_edr_links = btm_cb.acl_cb_.NumberOfActiveLinks(BT_TRANSPORT_BR_EDR),
+      .reconnect_expected = btm_expected_reconnect_refresh(),
+  };
+}
+
+/* Program the page scan parameters, adjusted to the current load */
+void btm_write_page_scan_cfg() {
+  uint16_t window = osi_property_get_int32(PROPERTY_PAGE_SCAN_WINDOW,
+                                           BTM_DEFAULT_CONN_WINDOW);
+  uint16_t interval = osi_property_get_int32(PROPERTY_PAGE_SCAN_INTERVAL,
+                                             BTM_DEFAULT_CONN_INTERVAL);
+  if (is_adaptive_scan_enabled()) {
+    btm_scan_policy_adjust(btm_scan_policy_current_load(), true, &interval,
+                           &window);
+  }
+
+  if ((window != btm_cb.btm_inq_vars.page_scan_window) ||
+      (interval != btm_cb.btm_inq_vars.page_scan_period)) {
+    btm_cb.btm_inq_vars.page_scan_window = window;
+    btm_cb.btm_inq_vars.page_scan_period = interval;
+    btsnd_hcic_write_pagescan_cfg(interval, window);
+  }
+}
+
+/* Program the inquiry scan parameters, adjusted to the current load */
+void btm_write_inq_scan_cfg() {
+  uint16_t window =
+      osi_property_get_int32(PROPERTY_INQ_SCAN_WINDOW, BTM_DEFAULT_DISC_WINDOW);
+  uint16_t interval = osi_property_get_int32(PROPERTY_INQ_SCAN_INTERVAL,
+                                             BTM_DEFAULT_DISC_INTERVAL);
+  if (is_adaptive_scan_enabled()) {
+    btm_scan_policy_adjust(btm_scan_policy_current_load(), false, &interval,
+                           &window);
+  }
+
+  if ((window != btm_cb.btm_inq_vars.inq_scan_window) ||
+      (interval != btm_cb.btm_inq_vars.inq_scan_period)) {
+    btsnd_hcic_write_inqscan_cfg(interval, window);
+    btm_cb.btm_inq_vars.inq_scan_window = window;
+    btm_cb.btm_inq_vars.inq_scan_period = interval;
+  }
+}
+}  // namespace
+
 using namespace bluetooth;
 using bluetooth::Uuid;
 
@@ -168,6 +314,10 @@ using bluetooth::Uuid;
 #define PROPERTY_INQ_BY_RSSI "persist.bluetooth.inq_by_rssi"
 #endif
 
+#ifndef PROPERTY_ADAPTIVE_SCAN
+#define PROPERTY_ADAPTIVE_SCAN "bluetooth.core.classic.adaptive_scan.enabled"
+#endif
+
 #define BTIF_DM_DEFAULT_INQ_MAX_DURATION 10
 
 #ifndef PROPERTY_INQ_LENGTH
@@ -312,18 +462,8 @@ tBTM_STATUS BTM_SetDiscoverability(uint16_t inq_mode) {
     scan_mode |= HCI_INQUIRY_SCAN_ENABLED;
   }
 
-  const uint16_t window =
-      osi_property_get_int32(PROPERTY_INQ_SCAN_WINDOW, BTM_DEFAULT_DISC_WINDOW);
-  const uint16_t interval = osi_property_get_int32(PROPERTY_INQ_SCAN_INTERVAL,
-                                                   BTM_DEFAULT_DISC_INTERVAL);
-
   /* Send down the inquiry scan window and period if changed */
-  if ((window != btm_cb.btm_inq_vars.inq_scan_window) ||
-      (interval != btm_cb.btm_inq_vars.inq_scan_period)) {
-    btsnd_hcic_write_inqscan_cfg(interval, window);
-    btm_cb.btm_inq_vars.inq_scan_window = window;
-    btm_cb.btm_inq_vars.inq_scan_period = interval;
-  }
+  btm_write_inq_scan_cfg();
 
   if (btm_cb.btm_inq_vars.connectable_mode & BTM_CONNECTABLE_MASK)
     scan_mode |= HCI_PAGE_SCAN_ENABLED;
@@ -403,6 +543,70 @@ void BTM_EnableInterlacedPageScan() {
   btm_cb.btm_inq_vars.page_scan_type = BTM_SCAN_TYPE_INTERLACED;
 }
 
+/*******************************************************************************
+ *
+ * Function         BTM_RegisterExpectedReconnect
+ *
+ * Description      This function is called by a profile that expects
+ *                  |bd_addr| to page us within |duration_ms|. Page scan is
+ *                  favoured while any such window is open.
+ *
+ ******************************************************************************/
+void BTM_RegisterExpectedReconnect(const RawAddress& bd_addr,
+                                   uint64_t duration_ms) {
+  const uint64_t until_ms =
+      bluetooth::common::time_get_os_boottime_ms() + duration_ms;
+  uint64_t& entry = expected_reconnects_[bd_addr];
+  entry = std::max(entry, until_ms);
+  log::debug("Expecting reconnect from {} for {}ms", bd_addr, duration_ms);
+  btm_scan_policy_update();
+}
+
+/*******************************************************************************
+ *
+ * Function         BTM_CancelExpectedReconnect
+ *
+ * Description      This function closes the reconnect window of |bd_addr|,
+ *                  typically once it has connected.
+ *
+ ******************************************************************************/
+void BTM_CancelExpectedReconnect(const RawAddress& bd_addr) {
+  if (expected_reconnects_.erase(bd_addr) == 0) return;
+  btm_scan_policy_update();
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_scan_policy_update
+ *
+ * Description      This function re-programs the page and inquiry scan
+ *                  parameters after LE activity, the number of links or the
+ *                  expected reconnects changed.
+ *
+ ******************************************************************************/
+void btm_scan_policy_update(void) {
+  if (!is_adaptive_scan_enabled() || !BTM_IsDeviceUp()) return;
+
+  const uint16_t page_scan_window = btm_cb.btm_inq_vars.page_scan_window;
+  const uint16_t page_scan_period = btm_cb.btm_inq_vars.page_scan_period;
+  if (btm_cb.btm_inq_vars.connectable_mode & BTM_CONNECTABLE_MASK) {
+    btm_write_page_scan_cfg();
+  }
+  if (btm_cb.btm_inq_vars.discoverable_mode & BTM_DISCOVERABLE_MASK) {
+    btm_write_inq_scan_cfg();
+  }
+
+  if (page_scan_window != btm_cb.btm_inq_vars.page_scan_window ||
+      page_scan_period != btm_cb.btm_inq_vars.page_scan_period) {
+    BTM_LogHistory(
+        kBtmLogTag, RawAddress::kEmpty, "Classic page scan adjusted",
+        base::StringPrintf("interval:%hu window:%hu expected_reconnects:%zu",
+                           btm_cb.btm_inq_vars.page_scan_period,
+                           btm_cb.btm_inq_vars.page_scan_window,
+                           expected_reconnects_.size()));
+  }
+}
+
 /*******************************************************************************
  *
  * Function         BTM_SetInquiryMode
@@ -474,20 +678,10 @@ tBTM_STATUS BTM_SetConnectability(uint16_t page_mode) {
     scan_mode |= HCI_PAGE_SCAN_ENABLED;
   }
 
-  const uint16_t window = osi_property_get_int32(PROPERTY_PAGE_SCAN_WINDOW,
-                                                 BTM_DEFAULT_CONN_WINDOW);
-  const uint16_t interval = osi_property_get_int32(PROPERTY_PAGE_SCAN_INTERVAL,
-                                                   BTM_DEFAULT_CONN_INTERVAL);
+  btm_write_page_scan_cfg();
 
   log::verbose("mode={} [NonConn-0, Conn-1], page scan interval=({} * 0.625)ms",
-               page_mode, interval);
-
-  if ((window != btm_cb.btm_inq_vars.page_scan_window) ||
-      (interval != btm_cb.btm_inq_vars.page_scan_period)) {
-    btm_cb.btm_inq_vars.page_scan_window = window;
-    btm_cb.btm_inq_vars.page_scan_period = interval;
-    btsnd_hcic_write_pagescan_cfg(interval, window);
-  }
+               page_mode, btm_cb.btm_inq_vars.page_scan_period);
 
   /* Keep the inquiry scan as previouosly set */
   if (btm_cb.btm_inq_vars.discoverable_mode & BTM_DISCOVERABLE_MASK)
@@ -1001,8 +1195,10 @@ void btm_clear_all_pending_le_entry(void) {
      * response outstanding */
     if ((p_ent->in_use) &&
         (p_ent->inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
-        !p_ent->scan_rsp)
+        !p_ent->scan_rsp) {
+      inq_db_index_erase(p_ent);
       p_ent->in_use = false;
+    }
   }
 }
 
@@ -1109,6 +1305,11 @@ void btm_clr_inq_db(const RawAddress* p_bda) {
       }
     }
   }
+  if (p_bda == NULL) {
+    inq_db_index_.clear();
+  } else {
+    inq_db_index_.erase(*p_bda);
+  }
 #if (BTM_INQ_DEBUG == TRUE)
   log::verbose("inq_active:0x{:x} state:{}", btm_cb.btm_inq_vars.inq_active,
                btm_cb.btm_inq_vars.state);
@@ -1193,14 +1394,9 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
-  }
+  auto it = inq_db_index_.find(p_bda);
+  if (it != inq_db_index_.end()) return (it->second);
 
   /* If here, not found */
   return (NULL);
@@ -1234,6 +1430,7 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda, bool is_ble) {
       memset(p_ent, 0, sizeof(tINQ_DB_ENT));
       p_ent->inq_info.results.remote_bd_addr = p_bda;
       p_ent->in_use = true;
+      inq_db_index_[p_bda] = p_ent;
 
       return (p_ent);
     }
@@ -1253,9 +1450,11 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda, bool is_ble) {
 
   /* If here, no free entry found. Return the oldest. */
 
+  inq_db_index_erase(p_old);
   memset(p_old, 0, sizeof(tINQ_DB_ENT));
   p_old->inq_info.results.remote_bd_addr = p_bda;
   p_old->in_use = true;
+  inq_db_index_[p_bda] = p_old;
 
   return (p_old);
 }
@@ -1727,6 +1926,9 @@ void btm_sort_inq_result(void) {
     }
   }
 
+  /* Entries moved around, point the index at their new places */
+  inq_db_index_rebuild();
+
   osi_free(p_tmp);
 }
 
@@ -2472,6 +2674,19 @@ namespace legacy {
 namespace testing {
 void btm_clr_inq_db(const RawAddress* p_bda) { ::btm_clr_inq_db(p_bda); }
 uint16_t btm_get_num_bd_entries() { return num_bd_entries_; }
+void btm_scan_policy_adjust(bool le_scan_active, unsigned le_links,
+                            unsigned br_edr_links, bool reconnect_expected,
+                            bool page_scan, uint16_t* interval,
+                            uint16_t* window) {
+  ::btm_scan_policy_adjust(
+      ScanLoad{
+          .le_scan_active = le_scan_active,
+          .le_links = le_links,
+          .br_edr_links = br_edr_links,
+          .reconnect_expected = reconnect_expected,
+      },
+      page_scan, interval, window);
+}
 }  // namespace testing
 }  // namespace legacy
 }  // namespace bluetooth
@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 
+#define ATRACE_TAG ATRACE_TAG_AUDIO
+
 #include <memory>
 
 #include "btm_iso_api.h"
@@ -17,15 +17,26 @@
 
 #pragma once
 
+#ifdef __ANDROID__
+#include <cutils/trace.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "btm_dev.h"
 #include "btm_iso_api.h"
+#include "common/latency_histogram.h"
+#include "common/scope_profiler.h"
 #include "common/time_util.h"
 #include "hci/controller_interface.h"
 #include "hci/include/hci_layer.h"
@@ -60,7 +71,25 @@ struct iso_sync_info {
   uint16_t seq_nb;
 };
 
+struct iso_tx_sdu {
+  BT_HDR* packet;
+  uint64_t enqueued_us;
+  uint64_t deadline_us;
+};
+
 struct iso_base {
+  ~iso_base() { flush_tx_queue(); }
+
+  /* Free the SDUs waiting for credits, returns the number of dropped SDUs.
+   * The stream stops there, the gap to its next SDU is not measured. */
+  size_t flush_tx_queue() {
+    size_t num_dropped = tx_queue.size();
+    for (auto& sdu : tx_queue) osi_free(sdu.packet);
+    tx_queue.clear();
+    tx_stats.last_sdu_us = 0;
+    return num_dropped;
+  }
+
   union {
     uint8_t cig_id;
     uint8_t big_handle;
@@ -70,11 +99,25 @@ struct iso_base {
   std::atomic_uint8_t state_flags;
   uint32_t sdu_itv;
   std::atomic_uint16_t used_credits;
+  /* Transport latency toward the peer, from the CIS or BIG establishment */
+  uint32_t tx_latency_us;
+  std::deque<iso_tx_sdu> tx_queue;
+
+  /* Names of the atrace counters of the stream */
+  std::string trace_queue_name;
+  std::string trace_delay_name;
+
+  void set_trace_names(uint16_t conn_handle) {
+    trace_queue_name = fmt::format("ISO 0x{:04x} TX queue", conn_handle);
+    trace_delay_name = fmt::format("ISO 0x{:04x} TX delay us", conn_handle);
+  }
 
   struct credits_stats {
     size_t credits_underflow_bytes = 0;
     size_t credits_underflow_count = 0;
     uint64_t credits_last_underflow_us = 0;
+    size_t queued_count = 0;
+    size_t stale_dropped_count = 0;
   };
 
   struct event_stats {
@@ -83,8 +126,21 @@ struct iso_base {
     uint64_t evt_last_lost_us = 0;
   };
 
+  struct transmit_stats {
+    /* Time between two SDUs handed over by the audio path */
+    bluetooth::common::LatencyHistogram sdu_gap;
+    /* Time from an SDU being handed over to reaching the HCI layer */
+    bluetooth::common::LatencyHistogram tx_delay;
+    /* SDUs handed over too late for their interval, or dropped before
+     * reaching the controller */
+    size_t deadline_miss_count = 0;
+    uint64_t deadline_miss_last_us = 0;
+    uint64_t last_sdu_us = 0;
+  };
+
   credits_stats cr_stats;
   event_stats evt_stats;
+  transmit_stats tx_stats;
 };
 
 typedef iso_base iso_cis;
@@ -152,10 +208,12 @@ struct iso_impl {
       if (evt_code == kIsoEventCigOnReconfigureCmpl) {
         auto cis_it = conn_hdl_to_cis_map_.cbegin();
         while (cis_it != conn_hdl_to_cis_map_.cend()) {
-          if (cis_it->second->cig_id == evt.cig_id)
+          if (cis_it->second->cig_id == evt.cig_id) {
+            iso_by_handle_[cis_it->first] = nullptr;
             cis_it = conn_hdl_to_cis_map_.erase(cis_it);
-          else
+          } else {
             ++cis_it;
+          }
         }
       }
 
@@ -171,6 +229,8 @@ struct iso_impl {
         cis->sync_info = {.seq_nb = 0};
         cis->used_credits = 0;
         cis->state_flags = kStateFlagsNone;
+        cis->set_trace_names(conn_handle);
+        index_iso(conn_handle, cis.get());
         conn_hdl_to_cis_map_[conn_handle] = std::move(cis);
       }
     }
@@ -236,10 +296,12 @@ struct iso_impl {
     if (evt.status == HCI_SUCCESS) {
       auto cis_it = conn_hdl_to_cis_map_.cbegin();
       while (cis_it != conn_hdl_to_cis_map_.cend()) {
-        if (cis_it->second->cig_id == evt.cig_id)
+        if (cis_it->second->cig_id == evt.cig_id) {
+          iso_by_handle_[cis_it->first] = nullptr;
           cis_it = conn_hdl_to_cis_map_.erase(cis_it);
-        else
+        } else {
           ++cis_it;
+        }
       }
     }
 
@@ -424,7 +486,10 @@ struct iso_impl {
                        "handle:0x%04x, status:%s", conn_handle,
                        hci_status_code_text((tHCI_STATUS)(status)).c_str()));
 
-    if (status == HCI_SUCCESS) iso->state_flags &= ~kStateFlagHasDataPathSet;
+    if (status == HCI_SUCCESS) {
+      iso->state_flags &= ~kStateFlagHasDataPathSet;
+      iso->flush_tx_queue();
+    }
 
     if (iso->state_flags & kStateFlagIsBroadcast) {
       log::assert_that(big_callbacks_ != nullptr, "Invalid BIG callbacks");
@@ -539,6 +604,7 @@ struct iso_impl {
 
   void send_iso_data(uint16_t iso_handle, const uint8_t* data,
                      uint16_t data_len) {
+    BT_PROFILE_SCOPE(ISO_TX);
     iso_base* iso = GetIsoIfKnown(iso_handle);
     log::assert_that(iso != nullptr, "No such iso connection handle: {}",
                      loghex(iso_handle));
@@ -561,29 +627,147 @@ struct iso_impl {
     uint16_t seq_nb = iso->sync_info.seq_nb;
     iso->sync_info.seq_nb = (seq_nb + 1) & 0xffff;
 
-    if (iso_credits_ == 0 || data_len > iso_buffer_size_) {
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+    update_sdu_gap_stats(iso, now_us);
+
+    if (data_len > iso_buffer_size_) {
       iso->cr_stats.credits_underflow_bytes += data_len;
       iso->cr_stats.credits_underflow_count++;
-      iso->cr_stats.credits_last_underflow_us =
-          bluetooth::common::time_get_os_boottime_us();
+      iso->cr_stats.credits_last_underflow_us = now_us;
 
       log::warn(
-          ", dropping ISO packet, len: {}, iso credits: {}, iso handle: 0x{:x}",
-          static_cast<int>(data_len), static_cast<int>(iso_credits_),
+          ", dropping ISO packet, len: {}, iso buffer size: {}, iso handle: "
+          "0x{:x}",
+          static_cast<int>(data_len), static_cast<int>(iso_buffer_size_),
           iso_handle);
       return;
     }
 
+    BT_HDR* packet = prepare_hci_packet(iso_handle, seq_nb, data_len);
+    memcpy(packet->data + kIsoHeaderWithoutTsLen, data, data_len);
+    packet->event = MSG_STACK_TO_HC_HCI_ISO | 0x0001;
+
+    /* Keep the order of the SDUs, send directly only when nothing is waiting
+     * for credits */
+    if (iso_credits_ > 0 && iso->tx_queue.empty()) {
+      transmit_iso_packet(iso, packet, 0);
+      return;
+    }
+
+    drop_stale_sdus(iso, now_us);
+    if (iso->tx_queue.size() >= kIsoTxQueueMaxSdus) {
+      osi_free(iso->tx_queue.front().packet);
+      iso->tx_queue.pop_front();
+      iso->cr_stats.credits_underflow_bytes += data_len;
+      iso->cr_stats.credits_underflow_count++;
+      iso->cr_stats.credits_last_underflow_us = now_us;
+      count_deadline_miss(iso, now_us);
+
+      log::warn(
+          ", dropping oldest ISO packet, iso credits: {}, iso handle: 0x{:x}",
+          static_cast<int>(iso_credits_), iso_handle);
+    }
+
+    /* The SDU still makes it if it reaches the controller before the next
+     * SDU interval plus the transport latency */
+    iso->tx_queue.push_back(
+        {packet, now_us, now_us + iso->sdu_itv + iso->tx_latency_us});
+    iso->cr_stats.queued_count++;
+    trace_tx_queue(iso);
+  }
+
+  void transmit_iso_packet(iso_base* iso, BT_HDR* packet, uint64_t delay_us) {
     iso_credits_--;
     iso->used_credits++;
+    iso->tx_stats.tx_delay.Add(delay_us);
+#ifdef __ANDROID__
+    ATRACE_INT(iso->trace_delay_name.c_str(), delay_us);
+#endif
 
-    BT_HDR* packet = prepare_hci_packet(iso_handle, seq_nb, data_len);
-    memcpy(packet->data + kIsoHeaderWithoutTsLen, data, data_len);
     auto hci = bluetooth::shim::hci_layer_get_interface();
-    packet->event = MSG_STACK_TO_HC_HCI_ISO | 0x0001;
     hci->transmit_downward(packet, iso_buffer_size_);
   }
 
+  static void trace_tx_queue(const iso_base* iso) {
+#ifdef __ANDROID__
+    ATRACE_INT(iso->trace_queue_name.c_str(), iso->tx_queue.size());
+#endif
+  }
+
+  static void count_deadline_miss(iso_base* iso, uint64_t now_us) {
+    iso->tx_stats.deadline_miss_count++;
+    iso->tx_stats.deadline_miss_last_us = now_us;
+  }
+
+  /* An SDU is late when it comes after the previous one by more than the
+   * headroom that the deadline of the queued SDUs allows for */
+  static void update_sdu_gap_stats(iso_base* iso, uint64_t now_us) {
+    if (iso->tx_stats.last_sdu_us != 0) {
+      uint64_t gap_us = now_us - iso->tx_stats.last_sdu_us;
+      iso->tx_stats.sdu_gap.Add(gap_us);
+      if (gap_us > (uint64_t)iso->sdu_itv + iso->tx_latency_us) {
+        count_deadline_miss(iso, now_us);
+      }
+    }
+    iso->tx_stats.last_sdu_us = now_us;
+  }
+
+  /* Drop the SDUs which can not reach the peer in time anymore, sending them
+   * would only delay the fresh ones */
+  static void drop_stale_sdus(iso_base* iso, uint64_t now_us) {
+    while (!iso->tx_queue.empty() &&
+           iso->tx_queue.front().deadline_us < now_us) {
+      osi_free(iso->tx_queue.front().packet);
+      iso->tx_queue.pop_front();
+      iso->cr_stats.stale_dropped_count++;
+      iso->cr_stats.credits_underflow_count++;
+      iso->cr_stats.credits_last_underflow_us = now_us;
+      count_deadline_miss(iso, now_us);
+    }
+  }
+
+  /* Send the SDUs waiting for credits, one SDU per stream in turn, so that
+   * the CISes of a CIG and the BISes of a BIG share the returned credits.
+   * The turns resume after the last served stream.
+   */
+  void drain_tx_queues() {
+    std::vector<std::pair<uint16_t, iso_base*>> pending;
+    for (auto const& [handle, iso] : conn_hdl_to_cis_map_) {
+      if (!iso->tx_queue.empty()) pending.push_back({handle, iso.get()});
+    }
+    for (auto const& [handle, iso] : conn_hdl_to_bis_map_) {
+      if (!iso->tx_queue.empty()) pending.push_back({handle, iso.get()});
+    }
+    if (pending.empty()) return;
+
+    std::sort(pending.begin(), pending.end(),
+              [](auto const& a, auto const& b) { return a.first < b.first; });
+    auto first = std::find_if(pending.begin(), pending.end(), [this](auto& p) {
+      return p.first > last_drained_handle_;
+    });
+    std::rotate(pending.begin(), first, pending.end());
+
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+    bool sent = true;
+    while (iso_credits_ > 0 && sent) {
+      sent = false;
+      for (auto& [handle, iso] : pending) {
+        if (iso_credits_ == 0) break;
+
+        drop_stale_sdus(iso, now_us);
+        if (iso->tx_queue.empty()) continue;
+
+        iso_tx_sdu sdu = iso->tx_queue.front();
+        iso->tx_queue.pop_front();
+        transmit_iso_packet(iso, sdu.packet, now_us - sdu.enqueued_us);
+        last_drained_handle_ = handle;
+        sent = true;
+      }
+    }
+
+    for (auto& [handle, iso] : pending) trace_tx_queue(iso);
+  }
+
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
     cis_establish_cmpl_evt evt;
 
@@ -619,6 +803,7 @@ struct iso_impl {
 
     if (evt.status == HCI_SUCCESS) {
       cis->state_flags |= kStateFlagIsConnected;
+      cis->tx_latency_us = evt.trans_lat_mtos;
     } else {
       cis_hdl_to_addr.erase(evt.cis_conn_hdl);
     }
@@ -657,6 +842,8 @@ struct iso_impl {
       /* return used credits */
       iso_credits_ += cis->used_credits;
       cis->used_credits = 0;
+      cis->flush_tx_queue();
+      drain_tx_queues();
 
       /* Data path is considered still valid, but can be reconfigured only once
        * CIS is reestablished.
@@ -665,17 +852,11 @@ struct iso_impl {
   }
 
   void handle_gd_num_completed_pkts(uint16_t handle, uint16_t credits) {
-    auto iter = conn_hdl_to_cis_map_.find(handle);
-    if (iter != conn_hdl_to_cis_map_.end()) {
-      iter->second->used_credits -= credits;
-      iso_credits_ += credits;
-      return;
-    }
-
-    iter = conn_hdl_to_bis_map_.find(handle);
-    if (iter != conn_hdl_to_bis_map_.end()) {
-      iter->second->used_credits -= credits;
+    iso_base* iso = GetIsoIfKnown(handle);
+    if (iso != nullptr) {
+      iso->used_credits -= credits;
       iso_credits_ += credits;
+      drain_tx_queues();
     }
   }
 
@@ -717,7 +898,10 @@ struct iso_impl {
         bis->sdu_itv = last_big_create_req_sdu_itv_;
         bis->sync_info = {.seq_nb = 0};
         bis->used_credits = 0;
+        bis->tx_latency_us = evt.transport_latency_big;
         bis->state_flags = kStateFlagIsBroadcast;
+        bis->set_trace_names(conn_handle);
+        index_iso(conn_handle, bis.get());
         conn_hdl_to_bis_map_[conn_handle] = std::move(bis);
       }
     }
@@ -746,6 +930,7 @@ struct iso_impl {
     auto bis_it = conn_hdl_to_bis_map_.cbegin();
     while (bis_it != conn_hdl_to_bis_map_.cend()) {
       if (bis_it->second->big_handle == evt.big_id) {
+        iso_by_handle_[bis_it->first] = nullptr;
         bis_it = conn_hdl_to_bis_map_.erase(bis_it);
         is_known_handle = true;
       } else {
@@ -815,6 +1000,7 @@ struct iso_impl {
   }
 
   void handle_iso_data(BT_HDR* p_msg) {
+    BT_PROFILE_SCOPE(ISO_RX);
     const uint8_t* stream = p_msg->data;
     cis_data_evt evt;
     uint16_t handle, seq_nb;
@@ -863,21 +1049,22 @@ struct iso_impl {
     cig_callbacks_->OnCisEvent(kIsoEventCisDataAvailable, &evt);
   }
 
-  iso_cis* GetCisIfKnown(uint16_t cis_conn_handle) {
-    auto cis_it = conn_hdl_to_cis_map_.find(cis_conn_handle);
-    return (cis_it != conn_hdl_to_cis_map_.end()) ? cis_it->second.get()
-                                                  : nullptr;
+  void index_iso(uint16_t iso_handle, iso_base* iso) {
+    log::assert_that(iso_handle <= HCI_HANDLE_MAX, "Invalid ISO handle: {}",
+                     loghex(iso_handle));
+    iso_by_handle_[iso_handle] = iso;
   }
 
-  iso_bis* GetBisIfKnown(uint16_t bis_conn_handle) {
-    auto bis_it = conn_hdl_to_bis_map_.find(bis_conn_handle);
-    return (bis_it != conn_hdl_to_bis_map_.end()) ? bis_it->second.get()
-                                                  : nullptr;
+  iso_base* GetIsoIfKnown(uint16_t iso_handle) {
+    return (iso_handle <= HCI_HANDLE_MAX) ? iso_by_handle_[iso_handle]
+                                          : nullptr;
   }
 
-  iso_base* GetIsoIfKnown(uint16_t iso_handle) {
-    struct iso_base* iso = GetCisIfKnown(iso_handle);
-    return (iso != nullptr) ? iso : GetBisIfKnown(iso_handle);
+  iso_cis* GetCisIfKnown(uint16_t cis_conn_handle) {
+    iso_base* iso = GetIsoIfKnown(cis_conn_handle);
+    return (iso != nullptr && !(iso->state_flags & kStateFlagIsBroadcast))
+               ? iso
+               : nullptr;
   }
 
   bool IsCigKnown(uint8_t cig_id) const {
@@ -912,6 +1099,10 @@ struct iso_impl {
              ? (unsigned long long)(now_us - stats.credits_last_underflow_us) /
                    1000
              : 0llu));
+    dprintf(fd, "          Queued waiting for credits (count): %zu\n",
+            stats.queued_count);
+    dprintf(fd, "          Dropped stale (count): %zu\n",
+            stats.stale_dropped_count);
   }
 
   static void dump_event_stats(int fd, const iso_base::event_stats& stats) {
@@ -927,6 +1118,23 @@ struct iso_impl {
                  : 0llu));
   }
 
+  static void dump_tx_stats(int fd, const iso_base::transmit_stats& stats) {
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+    dprintf(fd, "        TX Stats:\n");
+    dprintf(fd, "          SDU gap (us): %s\n",
+            stats.sdu_gap.ToString().c_str());
+    dprintf(fd, "          SDU to HCI delay (us): %s\n",
+            stats.tx_delay.ToString().c_str());
+    dprintf(fd, "          Deadline miss (count): %zu\n",
+            stats.deadline_miss_count);
+    dprintf(fd, "          Last deadline miss time ago (ms): %llu\n",
+            (stats.deadline_miss_last_us > 0
+                 ? (unsigned long long)(now_us - stats.deadline_miss_last_us) /
+                       1000
+                 : 0llu));
+  }
+
   void dump(int fd) const {
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  ISO Manager:\n");
@@ -941,11 +1149,14 @@ struct iso_impl {
       dprintf(fd, "        CIG ID: %d\n", cis_pair.second->cig_id);
       dprintf(fd, "        Used Credits: %d\n",
               cis_pair.second->used_credits.load());
+      dprintf(fd, "        Queued SDUs: %zu\n",
+              cis_pair.second->tx_queue.size());
       dprintf(fd, "        SDU Interval: %d\n", cis_pair.second->sdu_itv);
       dprintf(fd, "        State Flags: 0x%02hx\n",
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_tx_stats(fd, cis_pair.second->tx_stats);
     }
     dprintf(fd, "    BISes:\n");
     for (auto const& cis_pair : conn_hdl_to_bis_map_) {
@@ -953,11 +1164,14 @@ struct iso_impl {
       dprintf(fd, "        BIG Handle: %d\n", cis_pair.second->big_handle);
       dprintf(fd, "        Used Credits: %d\n",
               cis_pair.second->used_credits.load());
+      dprintf(fd, "        Queued SDUs: %zu\n",
+              cis_pair.second->tx_queue.size());
       dprintf(fd, "        SDU Interval: %d\n", cis_pair.second->sdu_itv);
       dprintf(fd, "        State Flags: 0x%02hx\n",
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_tx_stats(fd, cis_pair.second->tx_stats);
     }
     dprintf(fd, "  ----------------\n ");
   }
@@ -965,10 +1179,14 @@ struct iso_impl {
   std::map<uint16_t, std::unique_ptr<iso_cis>> conn_hdl_to_cis_map_;
   std::map<uint16_t, std::unique_ptr<iso_bis>> conn_hdl_to_bis_map_;
   std::map<uint16_t, RawAddress> cis_hdl_to_addr;
+  /* The maps above own the CISes and BISes and keep them ordered, the data
+   * path finds them by handle with this index */
+  std::array<iso_base*, HCI_HANDLE_MAX + 1> iso_by_handle_{};
 
   std::atomic_uint16_t iso_credits_;
   uint16_t iso_buffer_size_;
   uint32_t last_big_create_req_sdu_itv_;
+  uint16_t last_drained_handle_ = 0;
 
   CigCallbacks* cig_callbacks_ = nullptr;
   BigCallbacks* big_callbacks_ = nullptr;
@@ -32,10 +32,12 @@
 
 #include <cstdint>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "common/bidi_queue.h"
+#include "common/time_util.h"
 #include "device/include/device_iot_config.h"
 #include "hci/class_of_device.h"
 #include "hci/controller_interface.h"
@@ -104,6 +106,37 @@ bluetooth::common::BidiQueueEnd<bluetooth::hci::ScoBuilder,
 static bluetooth::os::EnqueueBuffer<bluetooth::hci::ScoBuilder>*
     pending_sco_data = nullptr;
 
+/* Received packets are handed from the HCI thread to the main thread in
+ * batches: a packet that arrives while a hand over is already posted joins
+ * it instead of posting a task of its own. The two vectors are swapped on
+ * each hand over, so that they keep their capacity. */
+struct tSCO_RX_PACKET {
+  bluetooth::hci::ScoView packet;
+  uint64_t received_us;
+};
+static std::mutex rx_mutex;
+static std::vector<tSCO_RX_PACKET> rx_pending;
+static std::vector<tSCO_RX_PACKET> rx_routing;
+static bool rx_route_posted = false;
+
+/* Time from the HCI layer to btm_route_sco_data, on the main thread only */
+static tBTM_SCO_FRAME_TIME_STATS rx_handover_time = {};
+
+static void route_pending_sco_data() {
+  {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    rx_routing.swap(rx_pending);
+    rx_route_posted = false;
+  }
+
+  const uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  for (auto& rx : rx_routing) {
+    rx_handover_time.update(now_us - rx.received_us);
+    btm_route_sco_data(std::move(rx.packet));
+  }
+  rx_routing.clear();
+}
+
 static void sco_data_callback() {
   if (hci_sco_queue_end == nullptr) {
     return;
@@ -114,9 +147,21 @@ static void sco_data_callback() {
     log::info("Dropping invalid packet of size {}", packet->size());
     return;
   }
-  if (do_in_main_thread(FROM_HERE, base::Bind(&btm_route_sco_data, *packet)) !=
+
+  {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    rx_pending.push_back(
+        {*packet, bluetooth::common::time_get_os_boottime_us()});
+    if (rx_route_posted) return;
+    rx_route_posted = true;
+  }
+
+  if (do_in_main_thread(FROM_HERE, base::Bind(&route_pending_sco_data)) !=
       BT_STATUS_SUCCESS) {
     log::error("do_in_main_thread failed from sco_data_callback");
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    rx_pending.clear();
+    rx_route_posted = false;
   }
 }
 static void register_for_sco() {
@@ -163,6 +208,9 @@ static void shut_down_sco() {
     hci_sco_queue_end->UnregisterDequeue();
     hci_sco_queue_end = nullptr;
   }
+
+  std::lock_guard<std::mutex> lock(rx_mutex);
+  rx_pending.clear();
 }
 };  // namespace cpp
 
@@ -498,11 +546,19 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
                     packet_buf + bytes_remaining);
         }
 
-        rc = encode((int16_t*)packet_buf, data_len);
+        /* Encode all the complete frames while there is room for their
+         * packets, rather than one frame per received packet */
+        size_t encoded_len = 0;
+        while (encoded_len < data_len) {
+          rc = encode((int16_t*)(packet_buf + encoded_len),
+                      data_len - encoded_len);
+          if (!rc) break;
+          encoded_len += rc;
+        }
         incr_btm_pcm_buf_offset(btm_pcm_buf_read_offset,
-                                btm_pcm_buf_read_mirror, rc);
+                                btm_pcm_buf_read_mirror, encoded_len);
 
-        if (!rc)
+        if (!encoded_len)
           log::debug(
               "Failed to encode {} data starting at ReadOffset:{} to "
               "WriteOffset:{}",
@@ -1336,6 +1392,15 @@ void btm_sco_on_disconnected(uint16_t hci_handle, tHCI_REASON reason) {
 
   if (p_sco->is_inband()) {
     const auto codec_type = p_sco->get_codec_type();
+
+    log::debug(
+        "Stopped SCO codec:{}, received packets:{} hand over avg_us:{} "
+        "max_us:{} over_budget:{}",
+        sco_codec_type_text(codec_type), cpp::rx_handover_time.num_frames,
+        cpp::rx_handover_time.average_us(), cpp::rx_handover_time.max_us,
+        cpp::rx_handover_time.num_over_budget);
+    cpp::rx_handover_time = {};
+
     if (codec_type == BTM_SCO_CODEC_MSBC || codec_type == BTM_SCO_CODEC_LC3) {
       auto fill_plc_stats = codec_type == BTM_SCO_CODEC_LC3
                                 ? bluetooth::audio::sco::swb::fill_plc_stats
@@ -1356,6 +1421,24 @@ void btm_sco_on_disconnected(uint16_t hci_handle, tHCI_REASON reason) {
         log::warn("Failed to get the packet loss stats");
       }
 
+      auto fill_frame_time_stats =
+          codec_type == BTM_SCO_CODEC_LC3
+              ? bluetooth::audio::sco::swb::fill_frame_time_stats
+              : bluetooth::audio::sco::wbs::fill_frame_time_stats;
+
+      tBTM_SCO_FRAME_TIME_STATS decode_time, encode_time;
+      if (fill_frame_time_stats(&decode_time, &encode_time)) {
+        log::debug(
+            "Stopped SCO codec:{}, decoded frames:{} avg_us:{} max_us:{} "
+            "over_budget:{}, encoded frames:{} avg_us:{} max_us:{} "
+            "over_budget:{}",
+            sco_codec_type_text(codec_type), decode_time.num_frames,
+            decode_time.average_us(), decode_time.max_us,
+            decode_time.num_over_budget, encode_time.num_frames,
+            encode_time.average_us(), encode_time.max_us,
+            encode_time.num_over_budget);
+      }
+
       auto cleanup = codec_type == BTM_SCO_CODEC_LC3
                          ? bluetooth::audio::sco::swb::cleanup
                          : bluetooth::audio::sco::wbs::cleanup;
@@ -32,8 +32,31 @@
 #define BTM_MSBC_CODE_SIZE 240
 #define BTM_LC3_CODE_SIZE 480
 
+/* Both the mSBC and the LC3 SWB frames carry 7.5 ms of audio, a frame that
+ * takes longer than that to encode or decode delays all the following ones. */
+#define BTM_SCO_FRAME_BUDGET_US 7500
+
 constexpr uint16_t kMaxScoLinks = static_cast<uint16_t>(BTM_MAX_SCO_LINKS);
 
+/* Time spent by a SCO-over-HCI codec to process its frames */
+struct tBTM_SCO_FRAME_TIME_STATS {
+  size_t num_frames;      /* Number of processed frames */
+  uint64_t total_us;      /* Total processing time */
+  uint64_t max_us;        /* Longest processing time of a frame */
+  size_t num_over_budget; /* Frames longer than BTM_SCO_FRAME_BUDGET_US */
+
+  void update(uint64_t duration_us) {
+    num_frames++;
+    total_us += duration_us;
+    if (duration_us > max_us) max_us = duration_us;
+    if (duration_us > BTM_SCO_FRAME_BUDGET_US) num_over_budget++;
+  }
+
+  uint64_t average_us() const {
+    return num_frames ? total_us / num_frames : 0;
+  }
+};
+
 /* SCO-over-HCI audio related definitions */
 namespace bluetooth::audio::sco {
 
@@ -80,6 +103,17 @@ void cleanup();
  */
 bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio);
 
+/* Fill in the processing time stats of the mSBC frames
+ * Args:
+ *    decode_stats - Output argument for the time spent decoding
+ *    encode_stats - Output argument for the time spent encoding
+ * Returns:
+ *    False for invalid arguments or when no frame was processed. True
+ *    otherwise.
+ */
+bool fill_frame_time_stats(tBTM_SCO_FRAME_TIME_STATS* decode_stats,
+                           tBTM_SCO_FRAME_TIME_STATS* encode_stats);
+
 /* Try to enqueue a packet to a buffer.
  * Args:
  *    data - Vector of received packet data bytes.
@@ -149,6 +183,17 @@ void cleanup();
  */
 bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio);
 
+/* Fill in the processing time stats of the LC3 frames
+ * Args:
+ *    decode_stats - Output argument for the time spent decoding
+ *    encode_stats - Output argument for the time spent encoding
+ * Returns:
+ *    False for invalid arguments or when no frame was processed. True
+ *    otherwise.
+ */
+bool fill_frame_time_stats(tBTM_SCO_FRAME_TIME_STATS* decode_stats,
+                           tBTM_SCO_FRAME_TIME_STATS* encode_stats);
+
 /* Try to enqueue a packet to a buffer.
  * Args:
  *    data - Vector of received packet data bytes.
@@ -27,6 +27,7 @@
 
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager_t.h"
+#include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_sco.h"
@@ -442,6 +443,9 @@ struct tBTM_MSBC_INFO {
 
   tBTM_MSBC_PLC* plc; /* PLC component to handle the packet loss of input */
   tBTM_SCO_PKT_STATUS* pkt_status; /* Record of mSBC packet status */
+
+  tBTM_SCO_FRAME_TIME_STATS decode_time; /* Time spent decoding the frames */
+  tBTM_SCO_FRAME_TIME_STATS encode_time; /* Time spent encoding the frames */
   static size_t get_supported_packet_size(size_t pkt_size,
                                           size_t* buffer_size) {
     int i;
@@ -705,6 +709,21 @@ bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio) {
   return true;
 }
 
+bool fill_frame_time_stats(tBTM_SCO_FRAME_TIME_STATS* decode_stats,
+                           tBTM_SCO_FRAME_TIME_STATS* encode_stats) {
+  if (msbc_info == nullptr || decode_stats == nullptr ||
+      encode_stats == nullptr)
+    return false;
+
+  if (msbc_info->decode_time.num_frames == 0 &&
+      msbc_info->encode_time.num_frames == 0)
+    return false;
+
+  *decode_stats = msbc_info->decode_time;
+  *encode_stats = msbc_info->encode_time;
+  return true;
+}
+
 bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
   if (msbc_info == nullptr) {
     log::warn("mSBC buffer uninitialized or cleaned");
@@ -729,6 +748,7 @@ bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
 
 size_t decode(const uint8_t** out_data) {
   const uint8_t* frame_head = nullptr;
+  uint64_t start_us;
 
   if (msbc_info == nullptr) {
     log::warn("mSBC buffer uninitialized or cleaned");
@@ -744,6 +764,7 @@ size_t decode(const uint8_t** out_data) {
     return 0;
   }
 
+  start_us = bluetooth::common::time_get_os_boottime_us();
   frame_head = msbc_info->find_msbc_pkt_head();
   if (frame_head == nullptr) {
     /* Done with parsing the raw bytes just read. If we couldn't find a valid
@@ -762,18 +783,23 @@ size_t decode(const uint8_t** out_data) {
   msbc_info->pkt_status->update(false);
   *out_data = (const uint8_t*)msbc_info->decoded_pcm_buf;
   msbc_info->mark_pkt_decoded();
+  msbc_info->decode_time.update(bluetooth::common::time_get_os_boottime_us() -
+                                start_us);
   return BTM_MSBC_CODE_SIZE;
 
 packet_loss:
   msbc_info->plc->handle_bad_frames(out_data);
   msbc_info->pkt_status->update(true);
   msbc_info->mark_pkt_decoded();
+  msbc_info->decode_time.update(bluetooth::common::time_get_os_boottime_us() -
+                                start_us);
   return BTM_MSBC_CODE_SIZE;
 }
 
 size_t encode(int16_t* data, size_t len) {
   uint8_t* pkt_body = nullptr;
   uint32_t encoded_size = 0;
+  uint64_t start_us;
   if (msbc_info == nullptr) {
     log::warn("mSBC buffer uninitialized or cleaned");
     return 0;
@@ -793,6 +819,7 @@ size_t encode(int16_t* data, size_t len) {
     return 0;
   }
 
+  start_us = bluetooth::common::time_get_os_boottime_us();
   encoded_size =
       GetInterfaceToProfiles()->msbcCodec->encodePacket(data, pkt_body);
   if (encoded_size != BTM_MSBC_PKT_FRAME_LEN) {
@@ -801,6 +828,8 @@ size_t encode(int16_t* data, size_t len) {
               std::end(btm_msbc_zero_packet), pkt_body);
   }
 
+  msbc_info->encode_time.update(bluetooth::common::time_get_os_boottime_us() -
+                                start_us);
   return BTM_MSBC_CODE_SIZE;
 }
 
@@ -892,6 +921,9 @@ struct tBTM_LC3_INFO {
 
   tBTM_SCO_PKT_STATUS* pkt_status; /* Record of LC3 packet status */
 
+  tBTM_SCO_FRAME_TIME_STATS decode_time; /* Time spent decoding the frames */
+  tBTM_SCO_FRAME_TIME_STATS encode_time; /* Time spent encoding the frames */
+
   static size_t get_supported_packet_size(size_t pkt_size,
                                           size_t* buffer_size) {
     int i;
@@ -1144,6 +1176,21 @@ bool fill_plc_stats(int* num_decoded_frames, double* packet_loss_ratio) {
   return true;
 }
 
+bool fill_frame_time_stats(tBTM_SCO_FRAME_TIME_STATS* decode_stats,
+                           tBTM_SCO_FRAME_TIME_STATS* encode_stats) {
+  if (lc3_info == nullptr || decode_stats == nullptr ||
+      encode_stats == nullptr)
+    return false;
+
+  if (lc3_info->decode_time.num_frames == 0 &&
+      lc3_info->encode_time.num_frames == 0)
+    return false;
+
+  *decode_stats = lc3_info->decode_time;
+  *encode_stats = lc3_info->encode_time;
+  return true;
+}
+
 bool enqueue_packet(const std::vector<uint8_t>& data, bool corrupted) {
   if (lc3_info == nullptr) {
     log::warn("LC3 buffer uninitialized or cleaned");
@@ -1183,6 +1230,7 @@ size_t decode(const uint8_t** out_data) {
     return 0;
   }
 
+  const uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
   frame_head = lc3_info->find_lc3_pkt_head();
 
   bool plc_conducted = !GetInterfaceToProfiles()->lc3Codec->decodePacket(
@@ -1195,6 +1243,8 @@ size_t decode(const uint8_t** out_data) {
 
   *out_data = (const uint8_t*)lc3_info->decoded_pcm_buf;
   lc3_info->mark_pkt_decoded();
+  lc3_info->decode_time.update(bluetooth::common::time_get_os_boottime_us() -
+                               start_us);
 
   return BTM_LC3_CODE_SIZE;
 }
@@ -1220,7 +1270,12 @@ size_t encode(int16_t* data, size_t len) {
     return 0;
   }
 
-  return GetInterfaceToProfiles()->lc3Codec->encodePacket(data, pkt_body);
+  const uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
+  size_t encoded =
+      GetInterfaceToProfiles()->lc3Codec->encodePacket(data, pkt_body);
+  lc3_info->encode_time.update(bluetooth::common::time_get_os_boottime_us() -
+                               start_us);
+  return encoded;
 }
 
 size_t dequeue_packet(const uint8_t** output) {
@@ -3667,7 +3667,7 @@ void btm_sec_connected(const RawAddress& bda, uint16_t handle,
 
     bit_shift = (handle == p_dev_rec->ble_hci_handle) ? 8 : 0;
     /* Update the timestamp for this device */
-    p_dev_rec->timestamp = btm_sec_cb.dev_rec_count++;
+    btm_sec_cb.TouchDevRec(p_dev_rec);
     if (p_dev_rec->sm4 & BTM_SM4_CONN_PEND) {
       if ((btm_sec_cb.pairing_state != BTM_PAIR_STATE_IDLE) &&
           (btm_sec_cb.pairing_bda == p_dev_rec->bd_addr) &&
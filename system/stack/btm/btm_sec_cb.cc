@@ -43,6 +43,7 @@ void tBTM_SEC_CB::Init(uint8_t initial_security_mode) {
   memset(&api, 0, sizeof(api));
   memset(&pin_code, 0, sizeof(pin_code));
   memset(sec_serv_rec, 0, sizeof(sec_serv_rec));
+  serv_rec_by_psm.clear();
   connecting_bda = RawAddress::kEmpty;
   connecting_dc = kDevClassEmpty;
 
@@ -53,6 +54,9 @@ void tBTM_SEC_CB::Init(uint8_t initial_security_mode) {
 
   security_mode = initial_security_mode;
   pairing_bda = RawAddress::kAny;
+  dev_rec_by_age.clear();
+  dev_rec_evictions = 0;
+  bonded_dev_rec_evictions = 0;
   sec_dev_rec = list_new([](void* ptr) {
     // Invoke destructor for all record objects and reset to default
     // initialized value so memory may be properly freed
@@ -65,6 +69,8 @@ void tBTM_SEC_CB::Free() {
   fixed_queue_free(sec_pending_q, nullptr);
   sec_pending_q = nullptr;
 
+  ClearDevRecIndexes();
+  dev_rec_by_age.clear();
   list_free(sec_dev_rec);
   sec_dev_rec = nullptr;
 
@@ -78,6 +84,25 @@ void tBTM_SEC_CB::Free() {
   execution_wait_timer = nullptr;
 }
 
+void tBTM_SEC_CB::ClearDevRecIndexes() {
+  dev_rec_by_addr.clear();
+  dev_rec_by_identity_addr.clear();
+  dev_rec_by_handle.clear();
+}
+
+void tBTM_SEC_CB::TouchDevRec(tBTM_SEC_DEV_REC* p_dev_rec) {
+  ForgetDevRecAge(p_dev_rec);
+  p_dev_rec->timestamp = dev_rec_count++;
+  dev_rec_by_age[p_dev_rec->timestamp] = p_dev_rec;
+}
+
+void tBTM_SEC_CB::ForgetDevRecAge(const tBTM_SEC_DEV_REC* p_dev_rec) {
+  auto it = dev_rec_by_age.find(p_dev_rec->timestamp);
+  if (it != dev_rec_by_age.end() && it->second == p_dev_rec) {
+    dev_rec_by_age.erase(it);
+  }
+}
+
 tBTM_SEC_CB btm_sec_cb;
 
 void BTM_Sec_Init() {
@@ -100,9 +125,6 @@ void BTM_Sec_Free() { btm_sec_cb.Free(); }
  ******************************************************************************/
 tBTM_SEC_SERV_REC* tBTM_SEC_CB::find_first_serv_rec(bool is_originator,
                                                     uint16_t psm) {
-  tBTM_SEC_SERV_REC* p_serv_rec = &sec_serv_rec[0];
-  int i;
-
   if (is_originator && p_out_serv && p_out_serv->psm == psm) {
     /* If this is outgoing connection and the PSM matches p_out_serv,
      * use it as the current service */
@@ -110,12 +132,31 @@ tBTM_SEC_SERV_REC* tBTM_SEC_CB::find_first_serv_rec(bool is_originator,
   }
 
   /* otherwise, just find the first record with the specified PSM */
+  auto it = serv_rec_by_psm.find(psm);
+  return (it != serv_rec_by_psm.end()) ? it->second : NULL;
+}
+
+/*******************************************************************************
+ *
+ * Function         IndexServRec
+ *
+ * Description      Point serv_rec_by_psm at the first record in the service
+ *                  database in use with specified PSM, or drop the PSM when
+ *                  there is none left
+ *
+ ******************************************************************************/
+void tBTM_SEC_CB::IndexServRec(uint16_t psm) {
+  tBTM_SEC_SERV_REC* p_serv_rec = &sec_serv_rec[0];
+  int i;
+
   for (i = 0; i < BTM_SEC_MAX_SERVICE_RECORDS; i++, p_serv_rec++) {
     if ((p_serv_rec->security_flags & BTM_SEC_IN_USE) &&
-        (p_serv_rec->psm == psm))
-      return (p_serv_rec);
+        (p_serv_rec->psm == psm)) {
+      serv_rec_by_psm[psm] = p_serv_rec;
+      return;
+    }
   }
-  return (NULL);
+  serv_rec_by_psm.erase(psm);
 }
 
 tBTM_SEC_REC* tBTM_SEC_CB::getSecRec(const RawAddress bd_addr) {
@@ -315,6 +356,7 @@ bool tBTM_SEC_CB::AddService(bool is_originator, const char* p_name,
   }
 
   p_srec->security_flags |= (uint16_t)(sec_level | BTM_SEC_IN_USE);
+  IndexServRec(psm);
 
   log::debug(
       "[{}]: id:{}, is_orig:{} psm:0x{:04x} proto_id:{} chan_id:{}  : "
@@ -337,6 +379,7 @@ uint8_t tBTM_SEC_CB::RemoveServiceById(uint8_t service_id) {
         (!service_id || (service_id == p_srec->service_id))) {
       log::verbose("BTM_SEC_CLR[{}]: id:{}", i, service_id);
       p_srec->security_flags = 0;
+      IndexServRec(p_srec->psm);
       num_freed++;
     }
   }
@@ -356,6 +399,7 @@ uint8_t tBTM_SEC_CB::RemoveServiceByPsm(uint16_t psm) {
       num_freed++;
     }
   }
+  if (num_freed) IndexServRec(psm);
   log::verbose("psm:0x{:x} num_freed:{}", psm, num_freed);
 
   return (num_freed);
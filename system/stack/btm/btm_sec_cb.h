@@ -18,6 +18,8 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
+#include <unordered_map>
 
 #include "internal_include/bt_target.h"
 #include "osi/include/alarm.h"
@@ -68,6 +70,19 @@ class tBTM_SEC_CB {
   alarm_t* pairing_timer{nullptr};        /* Timer for pairing process    */
   alarm_t* execution_wait_timer{nullptr}; /* To avoid concurrent auth request */
   list_t* sec_dev_rec{nullptr}; /* list of tBTM_SEC_DEV_REC */
+  /* Lookup hints into sec_dev_rec, filled by the btm_find_dev* functions.
+   * An entry is checked against the record before it is used, since record
+   * fields are written in place; records removed from the list must be
+   * dropped with ClearDevRecIndexes(). */
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> dev_rec_by_addr;
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> dev_rec_by_identity_addr;
+  std::unordered_map<uint16_t, tBTM_SEC_DEV_REC*> dev_rec_by_handle;
+  /* Records of sec_dev_rec by timestamp, oldest first, so that the record to
+   * evict is found without walking the list. Timestamps are assigned with
+   * TouchDevRec() to keep it in step. */
+  std::map<uint32_t, tBTM_SEC_DEV_REC*> dev_rec_by_age;
+  uint64_t dev_rec_evictions{0};        /* records evicted to make room */
+  uint64_t bonded_dev_rec_evictions{0}; /* of which were bonded */
   tBTM_SEC_SERV_REC* p_out_serv{nullptr};
   tBTM_MKEY_CALLBACK* mkey_cback{nullptr};
 
@@ -77,13 +92,25 @@ class tBTM_SEC_CB {
                                             tBTM_SEC_QUEUE_ENTRY format */
 
   tBTM_SEC_SERV_REC sec_serv_rec[BTM_SEC_MAX_SERVICE_RECORDS];
+  /* First in use record of sec_serv_rec for each PSM, so that the security
+   * of a channel is found without walking the records. Only AddService()
+   * and the RemoveService* functions change the records, and they keep it
+   * in step with IndexServRec(). */
+  std::unordered_map<uint16_t, tBTM_SEC_SERV_REC*> serv_rec_by_psm;
 
   DEV_CLASS connecting_dc;
 
   void Init(uint8_t initial_security_mode);
   void Free();
+  void ClearDevRecIndexes();
+  /* Mark |p_dev_rec| as the most recently used record */
+  void TouchDevRec(tBTM_SEC_DEV_REC* p_dev_rec);
+  /* Drop |p_dev_rec| from dev_rec_by_age, before it leaves sec_dev_rec */
+  void ForgetDevRecAge(const tBTM_SEC_DEV_REC* p_dev_rec);
 
   tBTM_SEC_SERV_REC* find_first_serv_rec(bool is_originator, uint16_t psm);
+  /* Update serv_rec_by_psm after the records with |psm| changed */
+  void IndexServRec(uint16_t psm);
 
   bool IsDeviceBonded(const RawAddress bd_addr);
   bool IsDeviceEncrypted(const RawAddress bd_addr, tBT_TRANSPORT transport);
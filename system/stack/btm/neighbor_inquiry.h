@@ -214,6 +214,7 @@ struct tBTM_INQUIRY_VAR_ST {
 
   alarm_t* remote_name_timer;
   alarm_t* classic_inquiry_timer;
+  alarm_t* expected_reconnect_timer;
 
   uint16_t discoverable_mode;
   uint16_t connectable_mode;
@@ -257,8 +258,10 @@ struct tBTM_INQUIRY_VAR_ST {
 
     alarm_free(remote_name_timer);
     alarm_free(classic_inquiry_timer);
+    alarm_free(expected_reconnect_timer);
     remote_name_timer = alarm_new("btm_inq.remote_name_timer");
     classic_inquiry_timer = alarm_new("btm_inq.classic_inquiry_timer");
+    expected_reconnect_timer = alarm_new("btm_inq.expected_reconnect_timer");
 
     discoverable_mode = BTM_NON_DISCOVERABLE;
     connectable_mode = BTM_NON_CONNECTABLE;
@@ -290,6 +293,7 @@ struct tBTM_INQUIRY_VAR_ST {
   void Free() {
     alarm_free(remote_name_timer);
     alarm_free(classic_inquiry_timer);
+    alarm_free(expected_reconnect_timer);
   }
 };
 
@@ -107,6 +107,10 @@ class FakeBtStack {
           ConsumeData((const uint8_t*)hdr, hdr->offset + hdr->len);
           osi_free(hdr);
         };
+    test::mock::stack_acl::acl_send_retained_data_packet_br_edr.body =
+        [](const RawAddress& bd_addr, const BT_HDR* hdr) {
+          ConsumeData((const uint8_t*)hdr, hdr->offset + hdr->len);
+        };
     test::mock::stack_acl::acl_send_data_packet_ble.body =
         [](const RawAddress& bd_addr, BT_HDR* hdr) {
           ConsumeData((const uint8_t*)hdr, hdr->offset + hdr->len);
@@ -136,6 +140,7 @@ class FakeBtStack {
     test::mock::stack_btm_devctl::BTM_IsDeviceUp = {};
     test::mock::stack_acl::acl_create_le_connection = {};
     test::mock::stack_acl::acl_send_data_packet_br_edr = {};
+    test::mock::stack_acl::acl_send_retained_data_packet_br_edr = {};
     test::mock::stack_acl::acl_send_data_packet_ble = {};
     bluetooth::hci::testing::mock_controller_ = nullptr;
   }
@@ -29,6 +29,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <string>
 
 #include "internal_include/bt_target.h"
@@ -45,6 +46,7 @@
 #include "stack/include/bt_uuid16.h"
 #include "stack/include/l2cap_acl_interface.h"
 #include "stack/include/l2cdefs.h"
+#include "stack/include/main_thread.h"
 #include "stack/include/sdp_api.h"
 #include "types/bluetooth/uuid.h"
 #include "types/bt_transport.h"
@@ -122,10 +124,10 @@ static uint16_t compute_service_size(btgatt_db_element_t* service, int count) {
 }
 
 static bool is_gatt_attr_type(const Uuid& uuid) {
-  if (uuid == Uuid::From16Bit(GATT_UUID_PRI_SERVICE) ||
-      uuid == Uuid::From16Bit(GATT_UUID_SEC_SERVICE) ||
-      uuid == Uuid::From16Bit(GATT_UUID_INCLUDE_SERVICE) ||
-      uuid == Uuid::From16Bit(GATT_UUID_CHAR_DECLARE)) {
+  if (uuid.Equals16Bit(GATT_UUID_PRI_SERVICE) ||
+      uuid.Equals16Bit(GATT_UUID_SEC_SERVICE) ||
+      uuid.Equals16Bit(GATT_UUID_INCLUDE_SERVICE) ||
+      uuid.Equals16Bit(GATT_UUID_CHAR_DECLARE)) {
     return true;
   }
   return false;
@@ -140,9 +142,9 @@ static void gatt_update_last_srv_info() {
   }
 }
 
-/** Update database hash and client status */
+/** Invalidate database hash and update client status */
 static void gatt_update_for_database_change() {
-  gatt_cb.database_hash = gatts_calculate_database_hash(gatt_cb.srv_list_info);
+  gatt_cb.database_hash_valid = false;
 
   uint8_t i = 0;
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
@@ -427,6 +429,117 @@ void GATTS_StopService(uint16_t service_handle) {
   gatt_cb.srv_list_info->erase(it);
   gatt_update_last_srv_info();
 }
+
+/** Send a single Handle Value Notification on |cid| */
+static tGATT_STATUS gatt_send_notification(tGATT_TCB& tcb, uint16_t cid,
+                                           const tGATT_VALUE& notif) {
+  tGATT_SR_MSG gatt_sr_msg;
+  gatt_sr_msg.attr_value = notif;
+
+  uint16_t payload_size = gatt_tcb_get_payload_size(tcb, cid);
+  BT_HDR* p_buf = attp_build_sr_msg(tcb, GATT_HANDLE_VALUE_NOTIF, &gatt_sr_msg,
+                                    payload_size);
+  if (p_buf == NULL) return GATT_NO_RESOURCES;
+
+  return attp_send_sr_msg(tcb, cid, p_buf);
+}
+
+/** Send |count| notifications from the front of |notifs| in one Multiple
+ * Handle Value Notification */
+static tGATT_STATUS gatt_send_multi_notification(
+    tGATT_TCB& tcb, uint16_t cid, const std::deque<tGATT_VALUE>& notifs,
+    size_t count) {
+  uint16_t payload_size = gatt_tcb_get_payload_size(tcb, cid);
+  BT_HDR* p_buf =
+      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+
+  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
+  p_buf->offset = L2CAP_MIN_OFFSET;
+  p_buf->len = 1;
+  for (size_t i = 0; i < count; i++) {
+    const tGATT_VALUE& notif = notifs[i];
+    UINT16_TO_STREAM(p, notif.handle);
+    UINT16_TO_STREAM(p, notif.len);
+    ARRAY_TO_STREAM(p, notif.value, notif.len);
+    p_buf->len += 4 + notif.len;
+  }
+
+  tcb.multi_notif_cnt++;
+  tcb.multi_notif_val_cnt += count;
+  return attp_send_sr_msg(tcb, cid, p_buf);
+}
+
+/** Send all notifications queued on |tcb_idx|. When the client supports it,
+ * consecutive notifications that fit in the MTU share one Multiple Handle
+ * Value Notification; the others are sent back to back. */
+static void gatt_flush_notifications(uint8_t tcb_idx) {
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+  if (p_tcb == NULL) return;
+
+  p_tcb->notif_flush_scheduled = false;
+  auto pending = std::move(p_tcb->pending_notif_q);
+  p_tcb->pending_notif_q.clear();
+
+  bool multi_supported =
+      gatt_sr_is_cl_multi_variable_len_notif_supported(*p_tcb);
+  for (auto& [cid, notifs] : pending) {
+    uint16_t payload_size = gatt_tcb_get_payload_size(*p_tcb, cid);
+
+    while (!notifs.empty()) {
+      /* Each value takes a handle and a length field, after the opcode */
+      size_t count = 0;
+      size_t len = 1;
+      while (multi_supported && count < notifs.size() &&
+             len + 4 + notifs[count].len <= payload_size) {
+        len += 4 + notifs[count].len;
+        count++;
+      }
+
+      tGATT_STATUS status;
+      if (count >= 2) {
+        status = gatt_send_multi_notification(*p_tcb, cid, notifs, count);
+      } else {
+        count = 1;
+        status = gatt_send_notification(*p_tcb, cid, notifs.front());
+      }
+
+      if (status != GATT_SUCCESS && status != GATT_CONGESTED) {
+        log::warn("Unable to send notification, cid=0x{:04x}, status={}", cid,
+                  gatt_status_text(status));
+      }
+      notifs.erase(notifs.begin(), notifs.begin() + count);
+    }
+  }
+}
+
+/** Queue a notification for the next flush of |tcb| */
+static tGATT_STATUS gatt_queue_notification(tGATT_TCB& tcb, uint16_t cid,
+                                            const tGATT_VALUE& notif) {
+  std::deque<tGATT_VALUE>& notifs = tcb.pending_notif_q[cid];
+  notifs.push_back(notif);
+  tcb.max_pending_notif = std::max(tcb.max_pending_notif, notifs.size());
+
+  if (!tcb.notif_flush_scheduled) {
+    /* Runs after the notifications already posted to the main thread */
+    if (do_in_main_thread(FROM_HERE, base::BindOnce(&gatt_flush_notifications,
+                                                    tcb.tcb_idx)) !=
+        BT_STATUS_SUCCESS) {
+      notifs.pop_back();
+      return gatt_send_notification(tcb, cid, notif);
+    }
+    tcb.notif_flush_scheduled = true;
+  }
+  return GATT_SUCCESS;
+}
+
+static bool gatt_notif_batching_is_enabled() {
+  static const bool sGATT_NOTIF_BATCHING =
+      bluetooth::os::GetSystemPropertyBool(
+          "bluetooth.gatt.server.notify_batching.enabled", true);
+  return sGATT_NOTIF_BATCHING;
+}
+
 /*******************************************************************************
  *
  * Function         GATTs_HandleValueIndication
@@ -458,6 +571,9 @@ tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
 
   if (!GATT_HANDLE_IS_VALID(attr_handle)) return GATT_ILLEGAL_PARAMETER;
 
+  /* Keep the order with notifications still waiting for their flush */
+  if (!p_tcb->pending_notif_q.empty()) gatt_flush_notifications(tcb_idx);
+
   tGATT_VALUE indication;
   indication.conn_id = conn_id;
   indication.handle = attr_handle;
@@ -606,21 +722,12 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   memcpy(notif.value, p_val, val_len);
   notif.auth_req = GATT_AUTH_REQ_NONE;
 
-  tGATT_STATUS cmd_sent;
-  tGATT_SR_MSG gatt_sr_msg;
-  gatt_sr_msg.attr_value = notif;
-
   uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
-  uint16_t payload_size = gatt_tcb_get_payload_size(*p_tcb, cid);
-  BT_HDR* p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF,
-                                    &gatt_sr_msg, payload_size);
-
-  if (p_buf != NULL) {
-    cmd_sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
-  } else {
-    cmd_sent = GATT_NO_RESOURCES;
+  if (gatt_notif_batching_is_enabled()) {
+    return gatt_queue_notification(*p_tcb, cid, notif);
   }
-  return cmd_sent;
+
+  return gatt_send_notification(*p_tcb, cid, notif);
 }
 
 /*******************************************************************************
@@ -27,6 +27,7 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include "common/time_util.h"
 #include "gatt_int.h"
 #include "hardware/bt_gatt_types.h"
 #include "internal_include/bt_target.h"
@@ -1183,6 +1184,8 @@ bool gatt_cl_send_next_cmd_inq(tGATT_TCB& tcb) {
 
     cmd.to_send = false;
     cmd.p_cmd = NULL;
+    cmd.sent_time_us = bluetooth::common::time_get_os_boottime_us();
+    gatt_latency_record(tcb.queue_wait, cmd.sent_time_us - cmd.enq_time_us);
 
     if (cmd.op_code == GATT_CMD_WRITE || cmd.op_code == GATT_SIGN_CMD_WRITE) {
       /* dequeue the request if is write command or sign write */
@@ -1226,7 +1229,8 @@ void gatt_client_handle_server_rsp(tGATT_TCB& tcb, uint16_t cid,
   }
 
   uint8_t cmd_code = 0;
-  tGATT_CLCB* p_clcb = gatt_cmd_dequeue(tcb, cid, &cmd_code);
+  uint64_t sent_time_us = 0;
+  tGATT_CLCB* p_clcb = gatt_cmd_dequeue(tcb, cid, &cmd_code, &sent_time_us);
   if (!p_clcb) {
     log::warn("ATT - clcb already not in use, ignoring response");
     gatt_cl_send_next_cmd_inq(tcb);
@@ -1251,6 +1255,12 @@ void gatt_client_handle_server_rsp(tGATT_TCB& tcb, uint16_t cid,
   gatt_stop_rsp_timer(p_clcb);
   p_clcb->retry_count = 0;
 
+  if (sent_time_us) {
+    gatt_latency_record(
+        tcb.rsp_latency[{cmd_code, cid != tcb.att_lcid}],
+        bluetooth::common::time_get_os_boottime_us() - sent_time_us);
+  }
+
   /* the size of the message may not be bigger than the local max PDU size*/
   /* The message has to be smaller than the agreed MTU, len does not count
    * op_code */
@@ -25,6 +25,8 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "gatt_int.h"
 #include "l2c_api.h"
 #include "osi/include/osi.h"
@@ -283,39 +285,47 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
   uint8_t* p = (uint8_t*)(p_rsp + 1) + p_rsp->len + L2CAP_MIN_OFFSET;
 
   if (p_db) {
-    for (tGATT_ATTR& attr : p_db->attr_list) {
-      if (attr.handle >= s_handle && type == attr.uuid) {
-        if (*p_len <= 2) {
-          status = GATT_NO_RESOURCES;
-          break;
-        }
+    auto by_type = p_db->attr_index_by_type.find(type);
+    if (by_type == p_db->attr_index_by_type.end()) return status;
+
+    const std::vector<uint16_t>& indices = by_type->second;
+    auto first = std::lower_bound(
+        indices.begin(), indices.end(), s_handle,
+        [p_db](uint16_t index, uint16_t handle) {
+          return p_db->attr_list[index].handle < handle;
+        });
+    for (auto it = first; it != indices.end(); it++) {
+      tGATT_ATTR& attr = p_db->attr_list[*it];
+      if (*p_len <= 2) {
+        status = GATT_NO_RESOURCES;
+        break;
+      }
 
-        UINT16_TO_STREAM(p, attr.handle);
+      UINT16_TO_STREAM(p, attr.handle);
 
-        status = read_attr_value(attr, 0, &p, false, (uint16_t)(*p_len - 2),
-                                 &len, sec_flag, key_size);
+      status = read_attr_value(attr, 0, &p, false, (uint16_t)(*p_len - 2),
+                               &len, sec_flag, key_size);
 
-        if (status == GATT_PENDING) {
-          status = gatts_send_app_read_request(tcb, cid, op_code, attr.handle,
-                                               0, trans_id, attr.gatt_type);
+      if (status == GATT_PENDING) {
+        status = gatts_send_app_read_request(tcb, cid, op_code, attr.handle,
+                                             0, trans_id, attr.gatt_type);
 
-          /* one callback at a time */
-          break;
-        } else if (status == GATT_SUCCESS) {
-          if (p_rsp->offset == 0) p_rsp->offset = len + 2;
-
-          if (p_rsp->offset == len + 2) {
-            p_rsp->len += (len + 2);
-            *p_len -= (len + 2);
-          } else {
-            log::error("format mismatch");
-            status = GATT_NO_RESOURCES;
-            break;
-          }
+        /* one callback at a time */
+        break;
+      } else if (status == GATT_SUCCESS) {
+        if (p_rsp->offset == 0) p_rsp->offset = len + 2;
+
+        if (p_rsp->offset == len + 2) {
+          p_rsp->len += (len + 2);
+          *p_len -= (len + 2);
         } else {
-          *p_cur_handle = attr.handle;
+          log::error("format mismatch");
+          status = GATT_NO_RESOURCES;
           break;
         }
+      } else {
+        *p_cur_handle = attr.handle;
+        break;
       }
     }
   }
@@ -442,14 +452,16 @@ uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
 /* Service Attribute Database Query Utility Functions */
 /******************************************************************************/
 tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
-  if (!p_db) return nullptr;
+  if (!p_db || p_db->attr_list.empty()) return nullptr;
 
-  for (auto& attr : p_db->attr_list) {
-    if (attr.handle == handle) return &attr;
-    if (attr.handle > handle) return nullptr;
-  }
+  /* handles are contiguous, see allocate_attr_in_db() */
+  uint16_t first_handle = p_db->attr_list.front().handle;
+  if (handle < first_handle) return nullptr;
+
+  size_t index = handle - first_handle;
+  if (index >= p_db->attr_list.size()) return nullptr;
 
-  return nullptr;
+  return &p_db->attr_list[index];
 }
 
 /*******************************************************************************
@@ -681,6 +693,7 @@ static tGATT_ATTR& allocate_attr_in_db(tGATT_SVC_DB& db, const Uuid& uuid,
                db.end_handle, db.next_handle);
   }
 
+  db.attr_index_by_type[uuid].push_back(db.attr_list.size());
   db.attr_list.emplace_back();
   tGATT_ATTR& attr = db.attr_list.back();
   attr.handle = db.next_handle++;
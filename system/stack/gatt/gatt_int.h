@@ -25,6 +25,8 @@
 
 #include <deque>
 #include <list>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -177,9 +179,15 @@ typedef struct {
 } tGATT_ATTR;
 
 /* Service Database definition
+ *
+ * Attribute handles are allocated contiguously from the service declaration,
+ * so attr_list[i].handle == attr_list[0].handle + i and lookups by handle are
+ * a direct index into attr_list.
 */
 typedef struct {
   std::vector<tGATT_ATTR> attr_list; /* pointer to the attributes */
+  /* attr_list indices of each attribute type, in handle order */
+  std::unordered_map<bluetooth::Uuid, std::vector<uint16_t>> attr_index_by_type;
   uint16_t end_handle;       /* Last handle number           */
   uint16_t next_handle;      /* Next usable handle value     */
 } tGATT_SVC_DB;
@@ -209,8 +217,20 @@ typedef struct {
   uint8_t op_code;
   bool to_send;
   uint16_t cid;
+  uint64_t enq_time_us;  /* when the command was queued */
+  uint64_t sent_time_us; /* when the command was sent, 0 if not yet */
 } tGATT_CMD_Q;
 
+/* Latency histogram with power of two buckets: bucket i counts samples below
+ * 2^i ms, the last bucket counts everything slower */
+#define GATT_LATENCY_HIST_BUCKETS 12
+typedef struct {
+  uint32_t buckets[GATT_LATENCY_HIST_BUCKETS];
+  uint32_t count;
+  uint64_t sum_us;
+  uint64_t max_us;
+} tGATT_LATENCY_HIST;
+
 #if GATT_MAX_SR_PROFILES <= 8
 typedef uint8_t tGATT_APP_MASK;
 #elif GATT_MAX_SR_PROFILES <= 16
@@ -321,6 +341,19 @@ typedef struct {
   std::deque<tGATT_CMD_Q> cl_cmd_q;
   alarm_t* ind_ack_timer; /* local app confirm to indication timer */
 
+  /* Notifications waiting for the next flush, per bearer cid. A burst of
+   * notifications from the apps is sent together when the flush runs */
+  std::unordered_map<uint16_t, std::deque<tGATT_VALUE>> pending_notif_q;
+  bool notif_flush_scheduled;
+  size_t max_pending_notif;     /* deepest notification queue seen */
+  uint32_t multi_notif_cnt;     /* Multiple Handle Value Notification PDUs */
+  uint32_t multi_notif_val_cnt; /* notifications sent in those PDUs */
+
+  /* Request to response time, by request opcode and bearer (true for EATT) */
+  std::map<std::pair<uint8_t, bool>, tGATT_LATENCY_HIST> rsp_latency;
+  /* Time requests spent queued behind an outstanding request */
+  tGATT_LATENCY_HIST queue_wait;
+
   // TODO(hylo): support byte array data
   /* Client supported feature*/
   uint8_t cl_supp_feat;
@@ -446,7 +479,11 @@ typedef struct {
   uint8_t gatt_cl_supported_feat_mask;
 
   uint16_t handle_of_database_hash;
+  /* Computed on first use after a change of the database, so that a burst of
+   * service registrations costs a single computation. Read it through
+   * gatts_get_database_hash(). */
   Octet16 database_hash;
+  bool database_hash_valid;
 
   tGATT_APPL_INFO cb_info;
 
@@ -638,9 +675,12 @@ void gatt_end_operation(tGATT_CLCB* p_clcb, tGATT_STATUS status, void* p_data);
 void gatt_act_discovery(tGATT_CLCB* p_clcb);
 void gatt_act_read(tGATT_CLCB* p_clcb, uint16_t offset);
 void gatt_act_write(tGATT_CLCB* p_clcb, uint8_t sec_act);
-tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_opcode);
+tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_opcode,
+                             uint64_t* p_sent_time_us = nullptr);
 bool gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
                   uint8_t op_code, BT_HDR* p_buf);
+void gatt_latency_record(tGATT_LATENCY_HIST& hist, uint64_t elapsed_us);
+void gatt_tcb_upload_latency_stats(tGATT_TCB& tcb);
 void gatt_client_handle_server_rsp(tGATT_TCB& tcb, uint16_t cid,
                                    uint8_t op_code, uint16_t len,
                                    uint8_t* p_data);
@@ -687,9 +727,11 @@ tGATT_STATUS gatts_read_attr_perm_check(tGATT_SVC_DB* p_db, bool is_long,
                                         tGATT_SEC_FLAG sec_flag,
                                         uint8_t key_size);
 bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
+tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle);
 
 /* gatt_sr_hash.cc */
 Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr);
+const Octet16& gatts_get_database_hash();
 
 namespace fmt {
 template <>
@@ -28,6 +28,7 @@
 #include "btif/include/btif_dm.h"
 #include "btif/include/btif_storage.h"
 #include "btif/include/stack_manager_t.h"
+#include "common/scope_profiler.h"
 #include "connection_manager.h"
 #include "device/include/interop.h"
 #include "internal_include/bt_target.h"
@@ -1016,6 +1017,7 @@ void gatt_consolidate(const RawAddress& identity_addr, const RawAddress& rpa) {
  *
  ******************************************************************************/
 void gatt_data_process(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_buf) {
+  BT_PROFILE_SCOPE(GATT_DATA_RX);
   uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   uint8_t op_code, pseudo_op_code;
 
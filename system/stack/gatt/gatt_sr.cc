@@ -27,6 +27,7 @@
 
 #include <algorithm>
 
+#include "common/scope_profiler.h"
 #include "gatt_int.h"
 #include "hardware/bt_gatt_types.h"
 #include "internal_include/bt_target.h"
@@ -622,12 +623,10 @@ static tGATT_STATUS gatt_build_find_info_rsp(tGATT_SRV_LIST_ELEM& el,
 
   uint8_t* p = (uint8_t*)(p_msg + 1) + L2CAP_MIN_OFFSET + p_msg->len;
 
-  for (auto& attr : el.p_db->attr_list) {
-    if (attr.handle > e_hdl) break;
-
-    if (attr.handle < s_hdl) continue;
-
-    uint8_t uuid_len = attr.uuid.GetShortestRepresentationSize();
+  /* first attribute of this service within [s_hdl, e_hdl] */
+  tGATT_ATTR* p_attr = find_attr_by_handle(el.p_db, std::max(s_hdl, el.s_hdl));
+  if (p_attr != nullptr && p_attr->handle <= e_hdl) {
+    uint8_t uuid_len = p_attr->uuid.GetShortestRepresentationSize();
     if (p_msg->offset == 0)
       p_msg->offset = (uuid_len == Uuid::kNumBytes16) ? GATT_INFO_TYPE_PAIR_16
                                                       : GATT_INFO_TYPE_PAIR_128;
@@ -636,16 +635,16 @@ static tGATT_STATUS gatt_build_find_info_rsp(tGATT_SRV_LIST_ELEM& el,
 
     if (p_msg->offset == GATT_INFO_TYPE_PAIR_16 &&
         uuid_len == Uuid::kNumBytes16) {
-      UINT16_TO_STREAM(p, attr.handle);
-      UINT16_TO_STREAM(p, attr.uuid.As16Bit());
+      UINT16_TO_STREAM(p, p_attr->handle);
+      UINT16_TO_STREAM(p, p_attr->uuid.As16Bit());
     } else if (p_msg->offset == GATT_INFO_TYPE_PAIR_128 &&
                uuid_len == Uuid::kNumBytes128) {
-      UINT16_TO_STREAM(p, attr.handle);
-      ARRAY_TO_STREAM(p, attr.uuid.To128BitLE(), (int)Uuid::kNumBytes128);
+      UINT16_TO_STREAM(p, p_attr->handle);
+      ARRAY_TO_STREAM(p, p_attr->uuid.To128BitLE(), (int)Uuid::kNumBytes128);
     } else if (p_msg->offset == GATT_INFO_TYPE_PAIR_128 &&
                uuid_len == Uuid::kNumBytes32) {
-      UINT16_TO_STREAM(p, attr.handle);
-      ARRAY_TO_STREAM(p, attr.uuid.To128BitLE(), (int)Uuid::kNumBytes128);
+      UINT16_TO_STREAM(p, p_attr->handle);
+      ARRAY_TO_STREAM(p, p_attr->uuid.To128BitLE(), (int)Uuid::kNumBytes128);
     } else {
       log::error("format mismatch");
       return GATT_NO_RESOURCES;
@@ -721,7 +720,7 @@ void gatts_process_primary_service_req(tGATT_TCB& tcb, uint16_t cid,
     return;
   }
 
-  if (uuid != Uuid::From16Bit(GATT_UUID_PRI_SERVICE)) {
+  if (!uuid.Equals16Bit(GATT_UUID_PRI_SERVICE)) {
     if (op_code == GATT_REQ_READ_BY_GRP_TYPE) {
       gatt_send_error_rsp(tcb, cid, GATT_UNSUPPORT_GRP_TYPE, op_code, s_hdl,
                           false);
@@ -1151,27 +1150,25 @@ void gatts_process_attribute_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
   if (GATT_HANDLE_IS_VALID(handle)) {
     for (auto& el : *gatt_cb.srv_list_info) {
       if (el.s_hdl <= handle && el.e_hdl >= handle) {
-        for (const auto& attr : el.p_db->attr_list) {
-          if (attr.handle == handle) {
-            switch (op_code) {
-              case GATT_REQ_READ: /* read char/char descriptor value */
-              case GATT_REQ_READ_BLOB:
-                gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
-                break;
-
-              case GATT_REQ_WRITE: /* write char/char descriptor value */
-              case GATT_CMD_WRITE:
-              case GATT_SIGN_CMD_WRITE:
-              case GATT_REQ_PREPARE_WRITE:
-                gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
-                                        attr.gatt_type);
-                break;
-              default:
-                break;
-            }
-            status = GATT_SUCCESS;
-            break;
+        const tGATT_ATTR* p_attr = find_attr_by_handle(el.p_db, handle);
+        if (p_attr != nullptr) {
+          switch (op_code) {
+            case GATT_REQ_READ: /* read char/char descriptor value */
+            case GATT_REQ_READ_BLOB:
+              gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
+              break;
+
+            case GATT_REQ_WRITE: /* write char/char descriptor value */
+            case GATT_CMD_WRITE:
+            case GATT_SIGN_CMD_WRITE:
+            case GATT_REQ_PREPARE_WRITE:
+              gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
+                                      p_attr->gatt_type);
+              break;
+            default:
+              break;
           }
+          status = GATT_SUCCESS;
         }
         break;
       }
@@ -1318,7 +1315,7 @@ static bool gatts_process_db_out_of_sync(tGATT_TCB& tcb, uint16_t cid,
                                                          &uuid, s_hdl, e_hdl);
       if (reason == GATT_SUCCESS &&
           (s_hdl <= db_hash_handle && db_hash_handle <= e_hdl) &&
-          (uuid == Uuid::From16Bit(GATT_UUID_DATABASE_HASH)))
+          uuid.Equals16Bit(GATT_UUID_DATABASE_HASH))
         should_ignore = false;
 
     } break;
@@ -1376,6 +1373,8 @@ static bool gatts_process_db_out_of_sync(tGATT_TCB& tcb, uint16_t cid,
 void gatt_server_handle_client_req(tGATT_TCB& tcb, uint16_t cid,
                                    uint8_t op_code, uint16_t len,
                                    uint8_t* p_data) {
+  BT_PROFILE_SCOPE(GATT_SERVER_REQ);
+
   /* there is pending command, discard this one */
   if (!gatt_sr_cmd_empty(tcb, cid) && op_code != GATT_HANDLE_VALUE_CONF) return;
 
@@ -130,3 +130,14 @@ Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr) {
 
   return db_hash;
 }
+
+/* Return the hash of the local database, computing it if the database changed
+ * since it was last read */
+const Octet16& gatts_get_database_hash() {
+  if (!gatt_cb.database_hash_valid) {
+    gatt_cb.database_hash =
+        gatts_calculate_database_hash(gatt_cb.srv_list_info);
+    gatt_cb.database_hash_valid = true;
+  }
+  return gatt_cb.database_hash;
+}
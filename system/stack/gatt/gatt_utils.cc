@@ -30,6 +30,7 @@
 #include <cstdint>
 #include <deque>
 
+#include "common/time_util.h"
 #include "hardware/bt_gatt_types.h"
 #include "internal_include/bt_target.h"
 #include "os/log.h"
@@ -46,6 +47,7 @@
 #include "stack/include/bt_uuid16.h"
 #include "stack/include/l2cdefs.h"
 #include "stack/include/sdp_api.h"
+#include "stack/include/stack_metrics_logging.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
@@ -446,6 +448,17 @@ tGATT_TCB* gatt_find_tcb_by_addr(const RawAddress& bda,
   return p_tcb;
 }
 
+static std::string gatt_latency_hist_text(const tGATT_LATENCY_HIST& hist) {
+  std::stringstream stream;
+  stream << "count: " << hist.count
+         << "  mean: " << (hist.count ? hist.sum_us / hist.count / 1000 : 0)
+         << "ms  max: " << hist.max_us / 1000 << "ms  buckets:";
+  for (int i = 0; i < GATT_LATENCY_HIST_BUCKETS; i++) {
+    stream << " " << hist.buckets[i];
+  }
+  return stream.str();
+}
+
 /*******************************************************************************
  *
  * Function     gatt_tcb_dump
@@ -468,6 +481,25 @@ void gatt_tcb_dump(int fd) {
              << "  address: " << ADDRESS_TO_LOGGABLE_STR(p_tcb->peer_bda)
              << "  transport: " << bt_transport_text(p_tcb->transport)
              << "  ch_state: " << gatt_channel_state_text(p_tcb->ch_state);
+      size_t pending_notif = 0;
+      for (const auto& [cid, notifs] : p_tcb->pending_notif_q) {
+        pending_notif += notifs.size();
+      }
+      stream << "\n    notification queue: " << pending_notif
+             << "  max: " << p_tcb->max_pending_notif
+             << "  multi notifications: " << p_tcb->multi_notif_cnt
+             << " (values: " << p_tcb->multi_notif_val_cnt << ")";
+      stream << "\n    mtu: " << p_tcb->payload_size
+             << "  eatt channels: " << +p_tcb->eatt;
+      if (p_tcb->queue_wait.count) {
+        stream << "\n    queue wait: "
+               << gatt_latency_hist_text(p_tcb->queue_wait);
+      }
+      for (const auto& [key, hist] : p_tcb->rsp_latency) {
+        stream << "\n    " << gatt_op_code_text(key.first)
+               << (key.second ? " (eatt): " : ": ")
+               << gatt_latency_hist_text(hist);
+      }
       stream << "\n";
     }
   }
@@ -1595,6 +1627,8 @@ bool gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
   cmd.p_cmd = p_buf;
   cmd.p_clcb = p_clcb;
   cmd.cid = p_clcb->cid;
+  cmd.enq_time_us = bluetooth::common::time_get_os_boottime_us();
+  cmd.sent_time_us = to_send ? 0 : cmd.enq_time_us;
 
   if (p_clcb->cid == tcb.att_lcid) {
     tcb.cl_cmd_q.push_back(cmd);
@@ -1612,7 +1646,8 @@ bool gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
 }
 
 /** dequeue the command in the client CCB command queue */
-tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_op_code) {
+tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_op_code,
+                             uint64_t* p_sent_time_us) {
   std::deque<tGATT_CMD_Q>* cl_cmd_q_p;
 
   if (cid == tcb.att_lcid) {
@@ -1633,6 +1668,7 @@ tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_op_code) {
   tGATT_CMD_Q cmd = cl_cmd_q_p->front();
   tGATT_CLCB* p_clcb = cmd.p_clcb;
   *p_op_code = cmd.op_code;
+  if (p_sent_time_us) *p_sent_time_us = cmd.sent_time_us;
 
   /* Note: If GATT client deregistered while the ATT request was on the way to
    * peer, device p_clcb will be null.
@@ -1647,6 +1683,32 @@ tGATT_CLCB* gatt_cmd_dequeue(tGATT_TCB& tcb, uint16_t cid, uint8_t* p_op_code) {
   return p_clcb;
 }
 
+/** Add a sample of |elapsed_us| to |hist| */
+void gatt_latency_record(tGATT_LATENCY_HIST& hist, uint64_t elapsed_us) {
+  uint64_t elapsed_ms = elapsed_us / 1000;
+  int bucket = 0;
+  while (bucket < GATT_LATENCY_HIST_BUCKETS - 1 &&
+         elapsed_ms >= (1ULL << bucket)) {
+    bucket++;
+  }
+  hist.buckets[bucket]++;
+  hist.count++;
+  hist.sum_us += elapsed_us;
+  hist.max_us = std::max(hist.max_us, elapsed_us);
+}
+
+/** Report the ATT request latencies collected on |tcb| to the metrics */
+void gatt_tcb_upload_latency_stats(tGATT_TCB& tcb) {
+  for (const auto& [key, hist] : tcb.rsp_latency) {
+    if (hist.count == 0) continue;
+    log_gatt_att_latency_stats(
+        tcb.peer_bda, key.first, key.second, static_cast<int>(hist.count),
+        hist.sum_us / hist.count / 1000.0,
+        static_cast<int>(hist.max_us / 1000), tcb.payload_size);
+  }
+  tcb.rsp_latency.clear();
+}
+
 /** Send out the ATT message for write */
 tGATT_STATUS gatt_send_write_msg(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
                                  uint8_t op_code, uint16_t handle, uint16_t len,
@@ -1801,6 +1863,8 @@ void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
 
   gatt_set_ch_state(p_tcb, GATT_CH_CLOSE);
 
+  gatt_tcb_upload_latency_stats(*p_tcb);
+
   /* Notify EATT about disconnection. */
   EattExtension::GetInstance()->Disconnect(p_tcb->peer_bda);
 
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Adaptive bitrate control for the A2DP encoders that have no adaptation of
+// their own.
+//
+
+#ifndef A2DP_BITRATE_CONTROLLER_H
+#define A2DP_BITRATE_CONTROLLER_H
+
+#include <stddef.h>
+
+// Steps the bitrate of an encoder down when the link does not keep up, and
+// back up once it has kept up for a while. The link is judged by the
+// transmit queue length that the A2DP source reports before each encoder
+// run through |set_transmit_queue_length|: packets pile up there when the
+// radio, or the ACL scheduler in front of it, cannot send them as fast as
+// they are encoded.
+//
+// The controller only picks a step between 0 (lowest bitrate) and
+// |kNumSteps| (configured bitrate); each codec maps the step to its own
+// parameter with Scale(). It has no constructor so that it may live in the
+// encoder control blocks, which are cleared with memset: a cleared controller
+// must be Reset() before use.
+struct A2dpBitrateController {
+  // Number of steps between the lowest and the configured bitrate.
+  static constexpr int kNumSteps = 4;
+  // Queue length, in packets, at which the link is congested.
+  static constexpr size_t kCongestedQueueLength = 3;
+  // Congested encoder runs in a row before stepping down.
+  static constexpr int kCongestedRunsToStepDown = 3;
+  // Encoder runs in a row with at most one packet queued before stepping
+  // up, 5 seconds with a 20 ms encoder interval.
+  static constexpr int kClearRunsToStepUp = 250;
+
+  // Starts at the configured bitrate.
+  void Reset() {
+    step = kNumSteps;
+    congested_runs = 0;
+    clear_runs = 0;
+  }
+
+  // Accounts for one encoder run with |queue_length| packets waiting to be
+  // sent. Returns true if the step changed.
+  bool OnTransmitQueueLength(size_t queue_length) {
+    if (queue_length >= kCongestedQueueLength) {
+      clear_runs = 0;
+      if (step == 0 || ++congested_runs < kCongestedRunsToStepDown) {
+        return false;
+      }
+      congested_runs = 0;
+      step--;
+      return true;
+    }
+
+    congested_runs = 0;
+    if (queue_length > 1) {
+      clear_runs = 0;
+      return false;
+    }
+    if (step == kNumSteps || ++clear_runs < kClearRunsToStepUp) return false;
+    clear_runs = 0;
+    step++;
+    return true;
+  }
+
+  // Returns the value of a parameter at the current step, going linearly
+  // from |lowest| at step 0 to |configured| at |kNumSteps|.
+  int Scale(int lowest, int configured) const {
+    return lowest + (configured - lowest) * step / kNumSteps;
+  }
+
+  int step;
+  int congested_runs;
+  int clear_runs;
+};
+
+#endif  // A2DP_BITRATE_CONTROLLER_H
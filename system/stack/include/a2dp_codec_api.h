@@ -499,6 +499,18 @@ typedef struct {
 // Returns the number of octets read.
 typedef uint32_t (*a2dp_source_read_callback_t)(uint8_t* p_buf, uint32_t len);
 
+// Prototype for a callback to access the audio data for encoding in place.
+// |p_buf| is set to up to |len| contiguous octets of audio data, which stay
+// valid until they are released with a2dp_source_consume_callback_t.
+// Returns the number of octets at |p_buf|, 0 if the data can only be read
+// with a2dp_source_read_callback_t.
+typedef uint32_t (*a2dp_source_peek_callback_t)(const uint8_t** p_buf,
+                                                uint32_t len);
+
+// Prototype for a callback to release |len| octets of audio data returned by
+// a2dp_source_peek_callback_t.
+typedef void (*a2dp_source_consume_callback_t)(uint32_t len);
+
 // Prototype for a callback to enqueue A2DP Source packets for transmission.
 // |p_buf| is the buffer with the audio data to enqueue. The callback is
 // responsible for freeing |p_buf|.
@@ -545,6 +557,14 @@ typedef struct {
 
   // Set transmit queue length for the A2DP encoder.
   void (*set_transmit_queue_length)(size_t transmit_queue_length);
+
+  // Set the callbacks for encoding the input audio data in place, optional.
+  // They are cleared by |encoder_init|.
+  // |peek_callback| is the callback for accessing the input audio data.
+  // |consume_callback| is the callback for releasing it.
+  void (*set_in_place_read_callbacks)(
+      a2dp_source_peek_callback_t peek_callback,
+      a2dp_source_consume_callback_t consume_callback);
 } tA2DP_ENCODER_INTERFACE;
 
 // Prototype for a callback to receive decoded audio data from a
@@ -575,6 +595,11 @@ typedef struct {
 
   // A2DP decoder configuration.
   void (*decoder_configure)(const uint8_t* p_codec_info);
+
+  // Conceals the loss of |num_packets| packets before the next one, calling
+  // |decode_callback| with the replacement audio. Optional, the lost packets
+  // are skipped when not set.
+  void (*decoder_conceal_packets)(size_t num_packets);
 } tA2DP_DECODER_INTERFACE;
 
 // Gets the A2DP codec type.
@@ -41,4 +41,9 @@ void a2dp_sbc_decoder_cleanup(void);
 // if decoded frames are available.
 bool a2dp_sbc_decoder_decode_packet(BT_HDR* p_buf);
 
+// Conceals the loss of |num_packets| packets by repeating the last decoded
+// packet with a decreasing level. Calls |decode_callback| passed into
+// |a2dp_sbc_decoder_init| for each concealed packet.
+void a2dp_sbc_decoder_conceal_packets(size_t num_packets);
+
 #endif  // A2DP_SBC_DECODER_H
@@ -65,6 +65,17 @@ int a2dp_sbc_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_sbc_send_frames(uint64_t timestamp_us);
 
+// Set transmit queue length for the A2DP SBC encoder, which lowers the
+// bitpool while the link is congested.
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length);
+
+// Set the callbacks for encoding the input audio data in place.
+// |peek_callback| is the callback for accessing the input audio data.
+// |consume_callback| is the callback for releasing it.
+void a2dp_sbc_set_in_place_read_callbacks(
+    a2dp_source_peek_callback_t peek_callback,
+    a2dp_source_consume_callback_t consume_callback);
+
 // Get SBC bitrate
 // Returns |uint32_t| bitrate in bits per second
 uint32_t a2dp_sbc_get_bitrate();
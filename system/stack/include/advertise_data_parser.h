@@ -19,6 +19,7 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include <cstdint>
 #include <vector>
 
@@ -143,3 +144,107 @@ class AdvertiseDataParser {
     return GetFieldByType(ad.data(), ad.size(), type, p_length);
   }
 };
+
+/**
+ * Offsets of all the fields of one advertising or EIR report, found in a single
+ * walk over its AD structures. Consumers looking up several types in the same
+ * report use the index instead of walking the report again for every lookup.
+ * The walk stops where AdvertiseDataParser::GetFieldByType would, so lookups
+ * return the same fields. The indexed data must outlive the index.
+ */
+class AdvertiseDataIndex {
+ public:
+  AdvertiseDataIndex(const uint8_t* ad, size_t ad_len) : ad_(ad) {
+    size_t position = 0;
+
+    while (position != ad_len) {
+      uint8_t len = ad[position];
+
+      if (len == 0) break;
+      if (position + len >= ad_len) break;
+
+      uint8_t adv_type = ad[position + 1];
+      types_.set(adv_type);
+      Field field{.type = adv_type,
+                  .length = static_cast<uint8_t>(len - 1),
+                  .offset = static_cast<uint16_t>(position + 2)};
+      if (num_fields_ < kInlineFields) {
+        inline_fields_[num_fields_] = field;
+      } else {
+        overflow_fields_.push_back(field);
+      }
+      num_fields_++;
+
+      position += len + 1; /* skip the length of data */
+    }
+  }
+
+  explicit AdvertiseDataIndex(std::vector<uint8_t> const& ad)
+      : AdvertiseDataIndex(ad.data(), ad.size()) {}
+
+  /**
+   * Return true if no well formed field was found.
+   */
+  bool IsEmpty() const { return num_fields_ == 0; }
+
+  /**
+   * Return true if the data has a field of |type|.
+   */
+  bool HasField(uint8_t type) const { return types_[type]; }
+
+  /**
+   * This function returns a pointer to the first field of |type|, together
+   * with its length in |p_length|, or NULL if there is none.
+   */
+  const uint8_t* GetFieldByType(uint8_t type, uint8_t* p_length) const {
+    if (types_[type]) {
+      for (size_t i = 0; i < num_fields_; i++) {
+        const Field& field = GetField(i);
+        if (field.type == type) {
+          *p_length = field.length;
+          return ad_ + field.offset;
+        }
+      }
+    }
+
+    *p_length = 0;
+    return NULL;
+  }
+
+  /**
+   * Call |callback| with a pointer to and the length of every field of |type|,
+   * in order, until it returns false.
+   */
+  template <typename Callback>
+  void ForEachFieldOfType(uint8_t type, Callback callback) const {
+    if (!types_[type]) return;
+
+    for (size_t i = 0; i < num_fields_; i++) {
+      const Field& field = GetField(i);
+      if (field.type != type) continue;
+      if (!callback(ad_ + field.offset, field.length)) return;
+    }
+  }
+
+ private:
+  struct Field {
+    uint8_t type;
+    uint8_t length;  /* length of the value, without the type */
+    uint16_t offset; /* offset of the value */
+  };
+
+  // Reports of up to 64 bytes, and most longer ones, fit in the inline storage
+  // so that indexing a report does not allocate.
+  static constexpr size_t kInlineFields = 32;
+
+  const Field& GetField(size_t i) const {
+    return i < kInlineFields ? inline_fields_[i]
+                             : overflow_fields_[i - kInlineFields];
+  }
+
+  const uint8_t* ad_;
+  std::bitset<256> types_;
+  size_t num_fields_{0};
+  std::array<Field, kInlineFields> inline_fields_;
+  std::vector<Field> overflow_fields_;
+};
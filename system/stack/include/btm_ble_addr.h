@@ -51,6 +51,17 @@ bool btm_identity_addr_to_random_pseudo_from_address_with_type(
 
 bool maybe_resolve_address(RawAddress* bda, tBLE_ADDR_TYPE* bda_type);
 
+/*******************************************************************************
+ *
+ * Function         btm_ble_invalidate_rpa_cache
+ *
+ * Description      This function drops the cached results of random address
+ *                  resolution. It must be called when a peer IRK is added or
+ *                  a device record is removed.
+ *
+ ******************************************************************************/
+void btm_ble_invalidate_rpa_cache();
+
 /* BLE address mapping with CS feature */
 bool btm_random_pseudo_to_identity_addr(RawAddress* random_pseudo,
                                         tBLE_ADDR_TYPE* p_identity_addr_type);
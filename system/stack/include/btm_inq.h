@@ -134,3 +134,25 @@ tBTM_STATUS BTM_SetInquiryMode(uint8_t mode);
 void BTM_EnableInterlacedInquiryScan();
 
 void BTM_EnableInterlacedPageScan();
+
+/*******************************************************************************
+ *
+ * Function         BTM_RegisterExpectedReconnect
+ *
+ * Description      This function is called by a profile that expects
+ *                  |bd_addr| to page us within |duration_ms|. Page scan is
+ *                  favoured while any such window is open.
+ *
+ ******************************************************************************/
+void BTM_RegisterExpectedReconnect(const RawAddress& bd_addr,
+                                   uint64_t duration_ms);
+
+/*******************************************************************************
+ *
+ * Function         BTM_CancelExpectedReconnect
+ *
+ * Description      This function closes the reconnect window of |bd_addr|,
+ *                  typically once it has connected.
+ *
+ ******************************************************************************/
+void BTM_CancelExpectedReconnect(const RawAddress& bd_addr);
@@ -160,7 +160,9 @@ class IsoManager {
   virtual void ReadIsoLinkQuality(uint16_t conn_handle);
 
   /**
-   * Sends iso data to the controller
+   * Sends iso data to the controller. When the controller runs out of
+   * credits, up to kIsoTxQueueMaxSdus SDUs are queued per connection and
+   * sent once the credits come back, unless they got stale meanwhile.
    *
    * @param conn_handle handle of BIS or CIS connection
    * @param data data buffer. The ownership of data is not being transferred.
@@ -59,6 +59,9 @@ constexpr uint8_t kIsoSca31To50Ppm = 0x05;
 constexpr uint8_t kIsoSca21To30Ppm = 0x06;
 constexpr uint8_t kIsoSca0To20Ppm = 0x07;
 
+/* SDUs queued per CIS or BIS while the controller has no credits */
+constexpr uint8_t kIsoTxQueueMaxSdus = 8;
+
 constexpr uint8_t kIsoEventCisDataAvailable = 0x00;
 constexpr uint8_t kIsoEventCisEstablishCmpl = 0x01;
 constexpr uint8_t kIsoEventCisDisconnected = 0x02;
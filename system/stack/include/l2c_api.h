@@ -138,6 +138,18 @@ constexpr tL2CAP_FCR_OPTS kDefaultErtmOptions = {
     1010   /* MPS segment size */
 };
 
+/* ERTM options for bulk transfers. The window is the largest the standard
+ * control field can carry, which also lets the receiver hold acks for a third
+ * of it, and each I-frame fills most of a BT_DEFAULT_BUFFER_SIZE buffer. */
+constexpr tL2CAP_FCR_OPTS kBulkErtmOptions = {
+    L2CAP_FCR_ERTM_MODE,
+    63,    /* Tx window size */
+    20,    /* Maximum transmissions before disconnecting */
+    2000,  /* Retransmission timeout (2 secs) */
+    12000, /* Monitor timeout (12 secs) */
+    4000   /* MPS segment size */
+};
+
 typedef struct {
   uint8_t qos_flags;          /* TBD */
   uint8_t service_type;       /* see below */
@@ -857,6 +869,36 @@ typedef struct {
                                             uint16_t min_ce_len,
                                             uint16_t max_ce_len);
 
+/* Profiles asking for LE connection parameters. Each keeps its own request
+ * on the link, see L2CA_UpdateBleConnParamsForClient(). */
+typedef enum : uint8_t {
+  /* L2CA_UpdateBleConnParams(), e.g. the connection priority of GATT apps */
+  L2CAP_CONN_PARAMS_CLIENT_OTHER = 0,
+  L2CAP_CONN_PARAMS_CLIENT_HID,
+  L2CAP_CONN_PARAMS_CLIENT_HEARING_AID,
+  L2CAP_CONN_PARAMS_CLIENT_MAX,
+} tL2CAP_CONN_PARAMS_CLIENT;
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_UpdateBleConnParamsForClient
+ *
+ *  Description     Record the connection parameters |client| needs on the LE
+ *                  link to |rem_bda|, and update the link with the result of
+ *                  the requests of all the clients: the shortest maximum
+ *                  interval, the lowest peripheral latency and the longest
+ *                  supervision timeout, so that the most demanding client is
+ *                  served. The request stays until the link goes down or the
+ *                  client replaces it.
+ *
+ *  Return value:   true if update started
+ *
+ ******************************************************************************/
+[[nodiscard]] bool L2CA_UpdateBleConnParamsForClient(
+    tL2CAP_CONN_PARAMS_CLIENT client, const RawAddress& rem_bda,
+    uint16_t min_int, uint16_t max_int, uint16_t latency, uint16_t timeout,
+    uint16_t min_ce_len, uint16_t max_ce_len);
+
 /* When called with lock=true, LE connection parameters will be locked on
  * fastest value, and we won't accept request to change it from remote. When
  * called with lock=false, parameters are relaxed.
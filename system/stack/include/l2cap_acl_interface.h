@@ -30,6 +30,10 @@ bool acl_create_le_connection_with_id(uint8_t id, const RawAddress& bd_addr);
 bool acl_create_le_connection_with_id(uint8_t id, const RawAddress& bd_addr,
                                       tBLE_ADDR_TYPE addr_type);
 void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf);
+// Send a BR/EDR packet that stays owned by the caller, e.g. an ERTM I-frame
+// kept for retransmission
+void acl_send_retained_data_packet_br_edr(const RawAddress& bd_addr,
+                                          const BT_HDR* p_buf);
 void acl_send_data_packet_ble(const RawAddress& bd_addr, BT_HDR* p_buf);
 void acl_write_automatic_flush_timeout(const RawAddress& bd_addr,
                                        uint16_t flush_timeout);
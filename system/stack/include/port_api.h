@@ -480,4 +480,16 @@ void RFCOMM_Init(void);
  ******************************************************************************/
 [[nodiscard]] int PORT_GetSecurityMask(uint16_t handle, uint16_t* sec_mask);
 
+/*******************************************************************************
+ *
+ * Function         RFCOMM_Dumpsys
+ *
+ * Description      This function dumps the state and the traffic counters of
+ *                  the RFCOMM ports in use.
+ *
+ * Parameters:      fd: Descriptor used to write the RFCOMM internals
+ *
+ ******************************************************************************/
+void RFCOMM_Dumpsys(int fd);
+
 #endif /* PORT_API_H */
@@ -139,6 +139,26 @@ struct tSdpApi {
     [[nodiscard]] bool (*SDP_ServiceSearchAttributeRequest2)(
         const RawAddress&, tSDP_DISCOVERY_DB*,
         base::RepeatingCallback<tSDP_DISC_CMPL_CB> complete_callback);
+
+    /*******************************************************************************
+
+      Function         SDP_ServiceSearchAttributeFromCache
+
+      Description      This function fills the discovery database with the
+                       cached service search attribute response of a bonded
+                       device to the same UUID and attribute filters. A cached
+                       response that is getting old is refreshed from the
+                       server in the background.
+
+      Parameters:      p_db        - (input) address of an initialized
+                                             discovery database.
+
+      Returns          true if the database was filled from the cache, false
+                       if the server has to be queried.
+
+     ******************************************************************************/
+    [[nodiscard]] bool (*SDP_ServiceSearchAttributeFromCache)(
+        const RawAddress&, tSDP_DISCOVERY_DB*);
   } service;
 
   struct {
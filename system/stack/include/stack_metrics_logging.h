@@ -61,3 +61,8 @@ void log_hfp_audio_packet_loss_stats(const RawAddress& address,
 
 void log_mmc_transcode_rtt_stats(int maximum_rtt, double mean_rtt,
                                  int num_requests, int codec_type);
+
+void log_gatt_att_latency_stats(const RawAddress& address, uint8_t op_code,
+                                bool is_eatt, int num_requests,
+                                double mean_latency_ms, int max_latency_ms,
+                                uint16_t mtu);
@@ -1786,6 +1786,16 @@ void L2CA_Dumpsys(int fd) {
     if (!lcb.in_use) continue;
     LOG_DUMPSYS(fd, "link_state:%s", link_state_text(lcb.link_state).c_str());
     LOG_DUMPSYS(fd, "handle:0x%04x", lcb.Handle());
+    if (lcb.is_transport_ble()) {
+      const auto& tuner = lcb.le_tuner;
+      LOG_DUMPSYS(fd,
+                  "  le tx_bytes:%llu rx_bytes:%llu peak_rate:%u B/s "
+                  "bulk:%s bulk_phases:%u tx_data_len:%u",
+                  static_cast<unsigned long long>(tuner.tx_bytes),
+                  static_cast<unsigned long long>(tuner.rx_bytes),
+                  tuner.peak_rate, tuner.bulk ? "true" : "false",
+                  tuner.bulk_phases, lcb.tx_data_len);
+    }
 
     const tL2C_CCB* ccb = lcb.ccb_queue.p_first_ccb;
     while (ccb != nullptr) {
@@ -1794,6 +1804,16 @@ void L2CA_Dumpsys(int fd) {
           ccb->local_cid, ccb->remote_cid,
           ccb->ecoc ? "true" : "false",
           ccb->in_use ? "true" : "false");
+      const auto& stats = ccb->xmit_stats;
+      LOG_DUMPSYS(
+          fd,
+          "    xmit queued:%zu max_queued:%u sent:%u avg_wait_us:%llu "
+          "max_wait_us:%llu",
+          fixed_queue_length(ccb->xmit_hold_q), stats.max_queue_depth,
+          stats.num_served,
+          static_cast<unsigned long long>(
+              stats.num_served ? stats.total_wait_us / stats.num_served : 0),
+          static_cast<unsigned long long>(stats.max_wait_us));
       ccb = ccb->p_next_ccb;
     }
   }
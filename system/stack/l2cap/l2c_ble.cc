@@ -32,8 +32,11 @@
 #include <android/sysprop/BluetoothProperties.sysprop.h>
 #endif
 
+#include <algorithm>
+
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager_t.h"
+#include "common/time_util.h"
 #include "hci/controller_interface.h"
 #include "hci/hci_layer.h"
 #include "internal_include/bt_target.h"
@@ -176,6 +179,7 @@ bool l2cble_conn_comp(uint16_t handle, tHCI_ROLE role, const RawAddress& bda,
   p_lcb->conn_update_mask = L2C_BLE_NOT_DEFAULT_PARAM;
   p_lcb->conn_update_blocked_by_profile_connection = false;
   p_lcb->conn_update_blocked_by_service_discovery = false;
+  p_lcb->conn_update_blocked_by_bulk_transfer = false;
 
   p_lcb->subrate_req_mask = 0;
   p_lcb->subrate_min = 1;
@@ -1099,6 +1103,108 @@ void l2cble_update_data_length(tL2C_LCB* p_lcb) {
     BTM_SetBleDataLength(p_lcb->remote_bd_addr, tx_mtu);
 }
 
+/* The LE link tuner watches the traffic of each LE link in one second
+ * windows. A link that moves more than kTunerBulkRate in a window is tuned
+ * for throughput: maximum data length, 2M PHY when both sides support it and
+ * the fastest connection parameters. Once it stays below kTunerIdleRate for
+ * kTunerIdleWindows windows the connection parameters are relaxed back to the
+ * requested ones. The data length and the PHY are kept: both shorten the
+ * radio time of each packet, so they save power rather than cost it. */
+constexpr uint64_t kTunerWindowMs = 1000;
+constexpr uint32_t kTunerBulkRate = 16000;
+constexpr uint32_t kTunerIdleRate = 2000;
+constexpr uint8_t kTunerIdleWindows = 5;
+
+static void l2cble_tuner_timeout(void* data);
+
+static void l2cble_tuner_enter_bulk(tL2C_LCB* p_lcb) {
+  p_lcb->le_tuner.bulk = true;
+  p_lcb->le_tuner.idle_windows = 0;
+  p_lcb->le_tuner.bulk_phases++;
+  log::info("{} bulk transfer, tuning the link for throughput",
+            p_lcb->remote_bd_addr);
+
+  if (bluetooth::shim::GetController()
+          ->SupportsBleDataPacketLengthExtension() &&
+      p_lcb->tx_data_len < BTM_BLE_DATA_SIZE_MAX) {
+    BTM_SetBleDataLength(p_lcb->remote_bd_addr, BTM_BLE_DATA_SIZE_MAX);
+  }
+  /* BTM_BleSetPhy reports unsupported PHYs to the GATT clients, check first */
+  if (bluetooth::shim::GetController()->SupportsBle2mPhy() &&
+      acl_peer_supports_ble_2m_phy(p_lcb->Handle())) {
+    BTM_BleSetPhy(p_lcb->remote_bd_addr, PHY_LE_2M, PHY_LE_2M, 0);
+  }
+  l2cble_lock_conn_params_for_bulk_transfer(p_lcb, true);
+
+  alarm_set_on_mloop(p_lcb->le_tuner_timer, kTunerWindowMs,
+                     l2cble_tuner_timeout, p_lcb);
+}
+
+static void l2cble_tuner_exit_bulk(tL2C_LCB* p_lcb) {
+  p_lcb->le_tuner.bulk = false;
+  log::info("{} idle, relaxing the link", p_lcb->remote_bd_addr);
+  l2cble_lock_conn_params_for_bulk_transfer(p_lcb, false);
+}
+
+static void l2cble_tuner_close_window(tL2C_LCB* p_lcb, uint64_t now_ms) {
+  auto& tuner = p_lcb->le_tuner;
+  uint64_t elapsed_ms = now_ms - tuner.window_start_ms;
+  uint32_t rate =
+      elapsed_ms ? static_cast<uint32_t>(uint64_t{tuner.window_bytes} * 1000 /
+                                          elapsed_ms)
+                 : 0;
+  tuner.peak_rate = std::max(tuner.peak_rate, rate);
+  tuner.window_start_ms = now_ms;
+  tuner.window_bytes = 0;
+
+  if (!tuner.bulk) return;
+  if (rate >= kTunerIdleRate) {
+    tuner.idle_windows = 0;
+  } else if (++tuner.idle_windows >= kTunerIdleWindows) {
+    l2cble_tuner_exit_bulk(p_lcb);
+  }
+}
+
+static void l2cble_tuner_timeout(void* data) {
+  tL2C_LCB* p_lcb = static_cast<tL2C_LCB*>(data);
+  l2cble_tuner_close_window(p_lcb, bluetooth::common::time_get_os_boottime_ms());
+  if (p_lcb->le_tuner.bulk) {
+    alarm_set_on_mloop(p_lcb->le_tuner_timer, kTunerWindowMs,
+                       l2cble_tuner_timeout, p_lcb);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         l2cble_tuner_count
+ *
+ * Description      Account for |bytes| of L2CAP data sent or received on an
+ *                  LE link, and tune the link when a bulk transfer starts
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void l2cble_tuner_count(tL2C_LCB* p_lcb, uint16_t bytes, bool is_tx) {
+  auto& tuner = p_lcb->le_tuner;
+  if (is_tx) {
+    tuner.tx_bytes += bytes;
+  } else {
+    tuner.rx_bytes += bytes;
+  }
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (now_ms - tuner.window_start_ms >= kTunerWindowMs) {
+    l2cble_tuner_close_window(p_lcb, now_ms);
+  }
+  tuner.window_bytes += bytes;
+
+  /* Tune as soon as the window crosses the rate, not at its end */
+  if (!tuner.bulk && tuner.window_bytes >= kTunerBulkRate &&
+      p_lcb->link_state == LST_CONNECTED) {
+    l2cble_tuner_enter_bulk(p_lcb);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         l2cble_process_data_length_change_evt
@@ -27,6 +27,8 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
 #include "hci/controller_interface.h"
 #include "internal_include/stack_config.h"
 #include "main/shim/acl_api.h"
@@ -58,6 +60,72 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
                               uint16_t max_int, uint16_t latency,
                               uint16_t timeout, uint16_t min_ce_len,
                               uint16_t max_ce_len) {
+  return L2CA_UpdateBleConnParamsForClient(L2CAP_CONN_PARAMS_CLIENT_OTHER,
+                                           rem_bda, min_int, max_int, latency,
+                                           timeout, min_ce_len, max_ce_len);
+}
+
+static const char* conn_params_client_text(tL2CAP_CONN_PARAMS_CLIENT client) {
+  switch (client) {
+    case L2CAP_CONN_PARAMS_CLIENT_OTHER:
+      return "other";
+    case L2CAP_CONN_PARAMS_CLIENT_HID:
+      return "hid";
+    case L2CAP_CONN_PARAMS_CLIENT_HEARING_AID:
+      return "hearing_aid";
+    default:
+      return "unknown";
+  }
+}
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_arbitrate_conn_params
+ *
+ *  Description     Combine the active requests of the link into the
+ *                  parameters to ask for: the shortest maximum interval and
+ *                  the lowest peripheral latency serve the most latency
+ *                  sensitive client, the minimum interval is the highest one
+ *                  asked for that still fits, and the longest supervision
+ *                  timeout stays valid for any of them.
+ *
+ *  Return value:   the client whose maximum interval was picked
+ *
+ ******************************************************************************/
+static tL2CAP_CONN_PARAMS_CLIENT l2cble_arbitrate_conn_params(
+    const tL2C_LCB* p_lcb, tL2C_CONN_PARAMS_REQ* p_result) {
+  tL2CAP_CONN_PARAMS_CLIENT interval_client = L2CAP_CONN_PARAMS_CLIENT_OTHER;
+  *p_result = {};
+
+  for (uint8_t i = 0; i < L2CAP_CONN_PARAMS_CLIENT_MAX; i++) {
+    const tL2C_CONN_PARAMS_REQ& req = p_lcb->conn_params_reqs[i];
+    if (!req.active) continue;
+    if (!p_result->active) {
+      *p_result = req;
+      interval_client = static_cast<tL2CAP_CONN_PARAMS_CLIENT>(i);
+      continue;
+    }
+    if (req.max_interval < p_result->max_interval) {
+      p_result->max_interval = req.max_interval;
+      interval_client = static_cast<tL2CAP_CONN_PARAMS_CLIENT>(i);
+    }
+    p_result->min_interval = std::max(p_result->min_interval, req.min_interval);
+    p_result->latency = std::min(p_result->latency, req.latency);
+    p_result->timeout = std::max(p_result->timeout, req.timeout);
+    p_result->min_ce_len = std::max(p_result->min_ce_len, req.min_ce_len);
+    p_result->max_ce_len = std::max(p_result->max_ce_len, req.max_ce_len);
+  }
+  p_result->min_interval =
+      std::min(p_result->min_interval, p_result->max_interval);
+  return interval_client;
+}
+
+bool L2CA_UpdateBleConnParamsForClient(tL2CAP_CONN_PARAMS_CLIENT client,
+                                       const RawAddress& rem_bda,
+                                       uint16_t min_int, uint16_t max_int,
+                                       uint16_t latency, uint16_t timeout,
+                                       uint16_t min_ce_len,
+                                       uint16_t max_ce_len) {
   tL2C_LCB* p_lcb;
 
   /* See if we have a link control block for the remote device */
@@ -74,17 +142,50 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
     return (false);
   }
 
+  if (client >= L2CAP_CONN_PARAMS_CLIENT_MAX) {
+    log::warn("- unknown client {}", static_cast<int>(client));
+    return (false);
+  }
+
   log::verbose(
-      "BD_ADDR={}, min_int={}, max_int={}, min_ce_len={}, max_ce_len={}",
-      rem_bda, min_int, max_int, min_ce_len, max_ce_len);
+      "BD_ADDR={}, client={}, min_int={}, max_int={}, min_ce_len={}, "
+      "max_ce_len={}",
+      rem_bda, conn_params_client_text(client), min_int, max_int, min_ce_len,
+      max_ce_len);
+
+  p_lcb->conn_params_reqs[client] = {
+      .active = true,
+      .min_interval = min_int,
+      .max_interval = max_int,
+      .latency = latency,
+      .timeout = timeout,
+      .min_ce_len = min_ce_len,
+      .max_ce_len = max_ce_len,
+  };
+
+  tL2C_CONN_PARAMS_REQ result;
+  tL2CAP_CONN_PARAMS_CLIENT interval_client =
+      l2cble_arbitrate_conn_params(p_lcb, &result);
+  if (interval_client != client) {
+    log::info(
+        "{} {} asked for interval {}-{} latency {}, keeping interval {}-{} "
+        "latency {} timeout {} of {}",
+        rem_bda, conn_params_client_text(client), min_int, max_int, latency,
+        result.min_interval, result.max_interval, result.latency,
+        result.timeout, conn_params_client_text(interval_client));
+  } else {
+    log::info("{} interval {}-{} latency {} timeout {} for {}", rem_bda,
+              result.min_interval, result.max_interval, result.latency,
+              result.timeout, conn_params_client_text(client));
+  }
 
-  p_lcb->min_interval = min_int;
-  p_lcb->max_interval = max_int;
-  p_lcb->latency = latency;
-  p_lcb->timeout = timeout;
+  p_lcb->min_interval = result.min_interval;
+  p_lcb->max_interval = result.max_interval;
+  p_lcb->latency = result.latency;
+  p_lcb->timeout = result.timeout;
   p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
-  p_lcb->min_ce_len = min_ce_len;
-  p_lcb->max_ce_len = max_ce_len;
+  p_lcb->min_ce_len = result.min_ce_len;
+  p_lcb->max_ce_len = result.max_ce_len;
 
   l2cble_start_conn_update(p_lcb);
 
@@ -125,6 +226,11 @@ void L2CA_LockBleConnParamsForServiceDiscovery(const RawAddress& rem_bda,
     return;
   }
 
+  if (p_lcb->conn_update_blocked_by_bulk_transfer) {
+    log::info("{} conn params stay locked because of bulk transfer", rem_bda);
+    return;
+  }
+
   log::info("{} Locking/unlocking conn params for service discovery: {}",
             rem_bda, lock);
   l2c_enable_update_ble_conn_params(p_lcb, !lock);
@@ -163,11 +269,39 @@ void L2CA_LockBleConnParamsForProfileConnection(const RawAddress& rem_bda,
     return;
   }
 
+  if (p_lcb->conn_update_blocked_by_bulk_transfer) {
+    log::info("{} conn params stay locked because of bulk transfer", rem_bda);
+    return;
+  }
+
   log::info("{} Locking/unlocking conn params for audio setup: {}", rem_bda,
             lock);
   l2c_enable_update_ble_conn_params(p_lcb, !lock);
 }
 
+/* When called with lock=true, LE connection parameters will be locked on
+ * fastest value while the link tuner sees a bulk transfer, see
+ * l2cble_tuner_count(). When called with lock=false, parameters are relaxed.
+ */
+void l2cble_lock_conn_params_for_bulk_transfer(tL2C_LCB* p_lcb, bool lock) {
+  if (stack_config_get_interface()->get_pts_conn_updates_disabled()) return;
+
+  if (lock == p_lcb->conn_update_blocked_by_bulk_transfer) return;
+
+  p_lcb->conn_update_blocked_by_bulk_transfer = lock;
+
+  if (p_lcb->conn_update_blocked_by_service_discovery ||
+      p_lcb->conn_update_blocked_by_profile_connection) {
+    log::info("{} conn params stay locked because of discovery or audio setup",
+              p_lcb->remote_bd_addr);
+    return;
+  }
+
+  log::info("{} Locking/unlocking conn params for bulk transfer: {}",
+            p_lcb->remote_bd_addr, lock);
+  l2c_enable_update_ble_conn_params(p_lcb, !lock);
+}
+
 static bool l2c_enable_update_ble_conn_params(tL2C_LCB* p_lcb, bool enable) {
   log::debug("{} enable {} current upd state 0x{:02x}", p_lcb->remote_bd_addr,
              enable, p_lcb->conn_update_mask);
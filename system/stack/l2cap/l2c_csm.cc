@@ -1754,6 +1754,12 @@ void l2c_enqueue_peer_data(tL2C_CCB* p_ccb, BT_HDR* p_buf) {
         p_ccb->remote_cid);
   } else {
     fixed_queue_enqueue(p_ccb->xmit_hold_q, p_buf);
+
+    size_t depth = fixed_queue_length(p_ccb->xmit_hold_q);
+    if (depth > p_ccb->xmit_stats.max_queue_depth) {
+      p_ccb->xmit_stats.max_queue_depth = static_cast<uint16_t>(depth);
+    }
+    l2cu_mark_ccb_ready(p_ccb);
   }
 
   l2cu_check_channel_congestion(p_ccb);
@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "internal_include/bt_target.h"
+#include "l2cap/fcs.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "stack/include/bt_hdr.h"
@@ -49,39 +50,6 @@ static const char* SAR_types[] = {"Unsegmented", "Start", "End",
                                   "Continuation"};
 static const char* SUP_types[] = {"RR", "REJ", "RNR", "SREJ"};
 
-/* Look-up table for the CRC calculation */
-static const unsigned short crctab[256] = {
-    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601,
-    0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440, 0xcc01, 0x0cc0,
-    0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81,
-    0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841, 0xd801, 0x18c0, 0x1980, 0xd941,
-    0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01,
-    0x1dc0, 0x1c80, 0xdc41, 0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0,
-    0x1680, 0xd641, 0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081,
-    0x1040, 0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
-    0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441, 0x3c00,
-    0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41, 0xfa01, 0x3ac0,
-    0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840, 0x2800, 0xe8c1, 0xe981,
-    0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41, 0xee01, 0x2ec0, 0x2f80, 0xef41,
-    0x2d00, 0xedc1, 0xec81, 0x2c40, 0xe401, 0x24c0, 0x2580, 0xe541, 0x2700,
-    0xe7c1, 0xe681, 0x2640, 0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0,
-    0x2080, 0xe041, 0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281,
-    0x6240, 0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
-    0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41, 0xaa01,
-    0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840, 0x7800, 0xb8c1,
-    0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41, 0xbe01, 0x7ec0, 0x7f80,
-    0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40, 0xb401, 0x74c0, 0x7580, 0xb541,
-    0x7700, 0xb7c1, 0xb681, 0x7640, 0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101,
-    0x71c0, 0x7080, 0xb041, 0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0,
-    0x5280, 0x9241, 0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481,
-    0x5440, 0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
-    0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841, 0x8801,
-    0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40, 0x4e00, 0x8ec1,
-    0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41, 0x4400, 0x84c1, 0x8581,
-    0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341,
-    0x4100, 0x81c1, 0x8081, 0x4040,
-};
-
 /*******************************************************************************
  *  Static local functions
 */
@@ -99,22 +67,14 @@ static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
  *
  * Function         l2c_fcr_updcrc
  *
- * Description      This function computes the CRC using the look-up table.
+ * Description      This function computes the CRC, using the same slicing-by-8
+ *                  implementation as the gd L2CAP packets.
  *
  * Returns          CRC
  *
  ******************************************************************************/
-static unsigned short l2c_fcr_updcrc(unsigned short icrc, unsigned char* icp,
-                                     int icnt) {
-  unsigned short crc = icrc;
-  unsigned char* cp = icp;
-  int cnt = icnt;
-
-  while (cnt--) {
-    crc = ((crc >> 8) & 0xff) ^ crctab[(crc & 0xff) ^ *cp++];
-  }
-
-  return (crc);
+static uint16_t l2c_fcr_updcrc(uint16_t icrc, const uint8_t* icp, int icnt) {
+  return bluetooth::l2cap::Fcs::Update(icrc, icp, icnt);
 }
 
 /*******************************************************************************
@@ -219,7 +179,8 @@ void l2c_fcr_cleanup(tL2C_CCB* p_ccb) {
   fixed_queue_free(p_fcrb->srej_rcv_hold_q, osi_free);
   p_fcrb->srej_rcv_hold_q = NULL;
 
-  fixed_queue_free(p_fcrb->retrans_q, osi_free);
+  /* The buffers of the retransmission queue belong to waiting_for_ack_q */
+  fixed_queue_free(p_fcrb->retrans_q, NULL);
   p_fcrb->retrans_q = NULL;
 
   memset(p_fcrb, 0, sizeof(tL2C_FCRB));
@@ -884,6 +845,10 @@ static bool process_reqseq(tL2C_CCB* p_ccb, uint16_t ctrl_word) {
       if ((ls == L2CAP_FCR_UNSEG_SDU) || (ls == L2CAP_FCR_END_SDU))
         full_sdus_xmitted++;
 
+      /* Do not retransmit a frame that got acked while queued */
+      while (fixed_queue_try_remove_from_queue(p_fcrb->retrans_q, p_tmp) !=
+             NULL) {
+      }
       osi_free(p_tmp);
     }
 
@@ -1338,8 +1303,7 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
     }
 
     /* Also flush our retransmission queue */
-    while (!fixed_queue_is_empty(p_ccb->fcrb.retrans_q))
-      osi_free(fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q));
+    fixed_queue_flush(p_ccb->fcrb.retrans_q, NULL);
 
     if (list_ack != NULL) node_ack = list_begin(list_ack);
   }
@@ -1349,17 +1313,16 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
       p_buf = (BT_HDR*)list_node(node_ack);
       node_ack = list_next(node_ack);
 
-      BT_HDR* p_buf2 = l2c_fcr_clone_buf(p_buf, p_buf->offset, p_buf->len);
-      if (p_buf2) {
-        p_buf2->layer_specific = p_buf->layer_specific;
+      /* The frame is retransmitted from the acknowledgement queue, see
+       * l2c_fcr_retained_xmit_done() */
+      fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf);
 
-        fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf2);
-      }
-
-      if ((tx_seq != L2C_FCR_RETX_ALL_PKTS) || (p_buf2 == NULL)) break;
+      if (tx_seq != L2C_FCR_RETX_ALL_PKTS) break;
     }
   }
 
+  if (!fixed_queue_is_empty(p_ccb->fcrb.retrans_q)) l2cu_mark_ccb_ready(p_ccb);
+
   l2c_link_check_send_pkts(p_ccb->p_lcb, 0, NULL);
 
   if (fixed_queue_length(p_ccb->fcrb.waiting_for_ack_q)) {
@@ -1490,34 +1453,36 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
 
   prepare_I_frame(p_ccb, p_xmit, false);
 
+  /* In eRTM mode the frame is kept until acked instead of being cloned, the
+   * lower layer only copies its content, see l2c_fcr_retained_xmit_done() */
   if (p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) {
-    BT_HDR* p_wack =
-        l2c_fcr_clone_buf(p_xmit, HCI_DATA_PREAMBLE_SIZE, p_xmit->len);
-
-    if (!p_wack) {
-      log::error(
-          "L2CAP - no buffer for xmit cloning, CID: 0x{:04x}  Length: {}",
-          p_ccb->local_cid, p_xmit->len);
-
-      /* We will not save the FCS in case we reconfigure and change options */
-      p_xmit->len -= L2CAP_FCS_LEN;
-
-      /* Pretend we sent it and it got lost */
-      fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_xmit);
-      return (NULL);
-    } else {
-      /* We will not save the FCS in case we reconfigure and change options */
-      p_wack->len -= L2CAP_FCS_LEN;
-
-      p_wack->layer_specific = p_xmit->layer_specific;
-      fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_wack);
-    }
-
+    fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_xmit);
   }
 
   return (p_xmit);
 }
 
+/*******************************************************************************
+ *
+ * Function         l2c_fcr_retained_xmit_done
+ *
+ * Description      This function is called once the lower layer has copied an
+ *                  eRTM I-frame, which stays in the acknowledgement queue. It
+ *                  strips the HCI header and the FCS added for transmission,
+ *                  so that the frame can be prepared again for a
+ *                  retransmission.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+void l2c_fcr_retained_xmit_done(BT_HDR* p_buf) {
+  log::assert_that(p_buf != NULL, "assert failed: p_buf != NULL");
+
+  p_buf->offset += HCI_DATA_PREAMBLE_SIZE;
+  /* We will not save the FCS in case we reconfigure and change options */
+  p_buf->len -= HCI_DATA_PREAMBLE_SIZE + L2CAP_FCS_LEN;
+}
+
 /** Get the next PDU to transmit for LE connection oriented channel. Returns
  * pointer to buffer with PDU. |last_piece_of_sdu| will be set to true, if
  * returned PDU is last piece from this SDU.*/
@@ -240,7 +240,8 @@ typedef struct {
   fixed_queue_t*
       waiting_for_ack_q;          /* Buffers sent and waiting for peer to ack */
   fixed_queue_t* srej_rcv_hold_q; /* Buffers rcvd but held pending SREJ rsp */
-  fixed_queue_t* retrans_q;       /* Buffers being retransmitted */
+  fixed_queue_t* retrans_q;       /* Buffers of waiting_for_ack_q queued for
+                                     retransmission, not owned */
 
   alarm_t* ack_timer;         /* Timer delaying RR */
   alarm_t* mon_retrans_timer; /* Timer Monitor or Retransmission */
@@ -291,6 +292,8 @@ typedef struct t_l2c_ccb {
   struct t_l2c_ccb* p_next_ccb; /* Next CCB in the chain */
   struct t_l2c_ccb* p_prev_ccb; /* Previous CCB in the chain */
   struct t_l2c_linkcb* p_lcb;   /* Link this CCB is assigned to */
+  struct t_l2c_ccb* p_next_ready; /* Next CCB in the priority ready ring */
+  bool in_ready_q;                /* Set while on the priority ready ring */
 
   uint16_t local_cid;  /* Local CID */
   uint16_t remote_cid; /* Remote CID */
@@ -321,6 +324,15 @@ typedef struct t_l2c_ccb {
   bool cong_sent;             /* Set when congested status sent */
   uint16_t buff_quota;        /* Buffer quota before sending congestion */
 
+  /* Transmit scheduling statistics, reported by L2CA_Dumpsys */
+  struct {
+    uint64_t waiting_since_us; /* Start of the current wait for a turn */
+    uint64_t total_wait_us;    /* Time spent waiting over all turns */
+    uint64_t max_wait_us;      /* Longest wait for a single turn */
+    uint32_t num_served;       /* Number of buffers sent */
+    uint16_t max_queue_depth;  /* Deepest xmit_hold_q depth seen */
+  } xmit_stats;
+
   tL2CAP_CHNL_PRIORITY ccb_priority;  /* Channel priority */
   tL2CAP_CHNL_DATA_RATE tx_data_rate; /* Channel Tx data rate */
   tL2CAP_CHNL_DATA_RATE rx_data_rate; /* Channel Rx data rate */
@@ -394,10 +406,15 @@ typedef struct {
  */
 
 typedef struct {
-  tL2C_CCB* p_serve_ccb; /* current serving ccb within priority group */
   tL2C_CCB* p_first_ccb; /* first ccb of priority group */
   uint8_t num_ccb;       /* number of channels in priority group */
   uint8_t quota;         /* burst transmission quota */
+  /* Ring of the channels of the group that have data queued, in service
+   * order. A channel joins at the back when data is queued to it, and leaves
+   * once its queues are found empty on its turn. */
+  tL2C_CCB* p_ready_first;
+  tL2C_CCB* p_ready_last;
+  uint8_t num_ready;
 } tL2C_RR_SERV;
 
 typedef enum : uint8_t {
@@ -411,6 +428,18 @@ typedef enum : uint8_t {
   L2C_BLE_NOT_DEFAULT_PARAM = (1u << 3),
 } tCONN_UPDATE_MASK;
 
+/* Connection parameters one client asked for, see
+ * L2CA_UpdateBleConnParamsForClient() */
+typedef struct {
+  bool active;
+  uint16_t min_interval;
+  uint16_t max_interval;
+  uint16_t latency;
+  uint16_t timeout;
+  uint16_t min_ce_len;
+  uint16_t max_ce_len;
+} tL2C_CONN_PARAMS_REQ;
+
 /* Define a link control block. There is one link control block between
  * this device and any other device (i.e. BD ADDR).
 */
@@ -521,6 +550,20 @@ typedef struct t_l2c_linkcb {
   bool is_transport_ble() const { return transport == BT_TRANSPORT_LE; }
 
   uint16_t tx_data_len; /* tx data length used in data length extension */
+
+  /* LE link tuner, see l2cble_tuner_count() */
+  struct {
+    uint64_t tx_bytes; /* since the link came up */
+    uint64_t rx_bytes;
+    uint64_t window_start_ms; /* start of the current rate window */
+    uint32_t window_bytes;    /* both ways in the current window */
+    uint32_t peak_rate;       /* highest rate of a window in bytes/s */
+    uint32_t bulk_phases;     /* times the link was tuned for bulk */
+    uint8_t idle_windows;     /* windows in a row below the idle rate */
+    bool bulk;                /* tuned for a bulk transfer */
+  } le_tuner;
+  alarm_t* le_tuner_timer; /* closes the rate windows of a bulk link */
+
   fixed_queue_t* le_sec_pending_q; /* LE coc channels waiting for security check
                                       completion */
   uint8_t sec_act;
@@ -529,6 +572,7 @@ typedef struct t_l2c_linkcb {
 
   bool conn_update_blocked_by_service_discovery;
   bool conn_update_blocked_by_profile_connection;
+  bool conn_update_blocked_by_bulk_transfer;
 
   uint16_t min_interval; /* parameters as requested by peripheral */
   uint16_t max_interval;
@@ -537,6 +581,9 @@ typedef struct t_l2c_linkcb {
   uint16_t min_ce_len;
   uint16_t max_ce_len;
 
+  /* requests the parameters above were arbitrated from */
+  tL2C_CONN_PARAMS_REQ conn_params_reqs[L2CAP_CONN_PARAMS_CLIENT_MAX];
+
 #define L2C_BLE_SUBRATE_REQ_DISABLE 0x1  // disable subrate req
 #define L2C_BLE_NEW_SUBRATE_PARAM 0x2    // new subrate req parameter to be set
 #define L2C_BLE_SUBRATE_REQ_PENDING 0x4  // waiting for subrate to be completed
@@ -678,6 +725,7 @@ typedef struct {
   uint16_t local_cid;
   uint16_t num_sdu;
   tL2CA_TX_COMPLETE_CB* cb;
+  bool is_retained; /* eRTM keeps the I-frame for retransmission */
 } tL2C_TX_COMPLETE_CB_INFO;
 
 /* The offset in a buffer that L2CAP will use when building commands.
@@ -718,6 +766,9 @@ bool l2cu_set_acl_latency(const RawAddress& bd_addr, tL2CAP_LATENCY latency);
 void l2cu_enqueue_ccb(tL2C_CCB* p_ccb);
 void l2cu_dequeue_ccb(tL2C_CCB* p_ccb);
 void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority);
+void l2cu_mark_ccb_ready(tL2C_CCB* p_ccb);
+void l2cu_remove_ready_ccb(tL2C_CCB* p_ccb);
+tL2C_CCB* l2cu_pop_ready_ccb(tL2C_RR_SERV* p_serv);
 
 tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid,
                             bool is_eatt = false);
@@ -848,6 +899,7 @@ BT_HDR* l2c_fcr_clone_buf(BT_HDR* p_buf, uint16_t new_offset,
 bool l2c_fcr_is_flow_controlled(tL2C_CCB* p_ccb);
 BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
                                       uint16_t max_packet_length);
+void l2c_fcr_retained_xmit_done(BT_HDR* p_buf);
 void l2c_fcr_start_timer(tL2C_CCB* p_ccb);
 void l2c_lcc_proc_pdu(tL2C_CCB* p_ccb, BT_HDR* p_buf);
 BT_HDR* l2c_lcc_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb, bool* last_piece_of_sdu);
@@ -878,6 +930,8 @@ tL2CAP_LE_RESULT_CODE l2ble_sec_access_req(const RawAddress& bd_addr,
                                            void* p_ref_data);
 
 void l2cble_update_data_length(tL2C_LCB* p_lcb);
+void l2cble_tuner_count(tL2C_LCB* p_lcb, uint16_t bytes, bool is_tx);
+void l2cble_lock_conn_params_for_bulk_transfer(tL2C_LCB* p_lcb, bool lock);
 
 void l2cu_process_fixed_disc_cback(tL2C_LCB* p_lcb);
 
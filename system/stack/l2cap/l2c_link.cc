@@ -30,6 +30,8 @@
 
 #include <cstdint>
 
+#include "common/latency_trace.h"
+#include "common/scope_profiler.h"
 #include "device/include/device_iot_config.h"
 #include "internal_include/bt_target.h"
 #include "os/log.h"
@@ -834,6 +836,7 @@ static bool l2c_link_check_power_mode(tL2C_LCB* p_lcb) {
  ******************************************************************************/
 void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
                               BT_HDR* p_buf) {
+  BT_PROFILE_SCOPE(L2CAP_SEND_PKTS);
   bool single_write = false;
 
   /* Save the channel ID for faster counting */
@@ -874,51 +877,61 @@ void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
       p_lcb++;
     }
 
-    /* Loop through, starting at the next */
-    for (int xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
-      /* Check for wraparound */
-      if (p_lcb == &l2cb.lcb_pool[MAX_L2CAP_LINKS]) p_lcb = &l2cb.lcb_pool[0];
-
-      /* If controller window is full, nothing to do */
-      if (((l2cb.controller_xmit_window == 0 ||
-            (l2cb.round_robin_unacked >= l2cb.round_robin_quota)) &&
-           (p_lcb->transport == BT_TRANSPORT_BR_EDR)) ||
-          (p_lcb->transport == BT_TRANSPORT_LE &&
-           (l2cb.ble_round_robin_unacked >= l2cb.ble_round_robin_quota ||
-            l2cb.controller_le_xmit_window == 0))) {
-        log::debug("Skipping lcb {} due to controller window full", xx);
-        continue;
-      }
+    /* Go around the links again as long as something was sent, so that a
+     * single wakeup uses up the window of the controller */
+    bool sent;
+    do {
+      sent = false;
+      /* Loop through, starting at the next */
+      for (int xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
+        /* Check for wraparound */
+        if (p_lcb == &l2cb.lcb_pool[MAX_L2CAP_LINKS])
+          p_lcb = &l2cb.lcb_pool[0];
+
+        /* If controller window is full, nothing to do */
+        if (((l2cb.controller_xmit_window == 0 ||
+              (l2cb.round_robin_unacked >= l2cb.round_robin_quota)) &&
+             (p_lcb->transport == BT_TRANSPORT_BR_EDR)) ||
+            (p_lcb->transport == BT_TRANSPORT_LE &&
+             (l2cb.ble_round_robin_unacked >= l2cb.ble_round_robin_quota ||
+              l2cb.controller_le_xmit_window == 0))) {
+          log::debug("Skipping lcb {} due to controller window full", xx);
+          continue;
+        }
 
-      if ((!p_lcb->in_use) || (p_lcb->link_state != LST_CONNECTED) ||
-          (p_lcb->link_xmit_quota != 0) || (l2c_link_check_power_mode(p_lcb))) {
-        log::debug("Skipping lcb {} due to quota", xx);
-        continue;
-      }
+        if ((!p_lcb->in_use) || (p_lcb->link_state != LST_CONNECTED) ||
+            (p_lcb->link_xmit_quota != 0) ||
+            (l2c_link_check_power_mode(p_lcb))) {
+          log::debug("Skipping lcb {} due to quota", xx);
+          continue;
+        }
 
-      /* See if we can send anything from the Link Queue */
-      if (p_lcb->link_xmit_data_q != NULL &&
-          !list_is_empty(p_lcb->link_xmit_data_q)) {
-        log::verbose("Sending to lower layer");
-        p_buf = (BT_HDR*)list_front(p_lcb->link_xmit_data_q);
-        list_remove(p_lcb->link_xmit_data_q, p_buf);
-        l2c_link_send_to_lower(p_lcb, p_buf, NULL);
-      } else if (single_write) {
-        /* If only doing one write, break out */
-        log::debug("single_write is true, skipping");
-        break;
-      }
-      /* If nothing on the link queue, check the channel queue */
-      else {
-        tL2C_TX_COMPLETE_CB_INFO cbi = {};
-        log::debug("Check next buffer");
-        p_buf = l2cu_get_next_buffer_to_send(p_lcb, &cbi);
-        if (p_buf != NULL) {
-          log::debug("Sending next buffer");
-          l2c_link_send_to_lower(p_lcb, p_buf, &cbi);
+        /* See if we can send anything from the Link Queue */
+        if (p_lcb->link_xmit_data_q != NULL &&
+            !list_is_empty(p_lcb->link_xmit_data_q)) {
+          log::verbose("Sending to lower layer");
+          p_buf = (BT_HDR*)list_front(p_lcb->link_xmit_data_q);
+          list_remove(p_lcb->link_xmit_data_q, p_buf);
+          l2c_link_send_to_lower(p_lcb, p_buf, NULL);
+          sent = true;
+        } else if (single_write) {
+          /* If only doing one write, break out */
+          log::debug("single_write is true, skipping");
+          break;
+        }
+        /* If nothing on the link queue, check the channel queue */
+        else {
+          tL2C_TX_COMPLETE_CB_INFO cbi = {};
+          log::debug("Check next buffer");
+          p_buf = l2cu_get_next_buffer_to_send(p_lcb, &cbi);
+          if (p_buf != NULL) {
+            log::debug("Sending next buffer");
+            l2c_link_send_to_lower(p_lcb, p_buf, &cbi);
+            sent = true;
+          }
         }
       }
-    }
+    } while (sent && !single_write);
 
     /* If we finished without using up our quota, no need for a safety check */
     if ((l2cb.controller_xmit_window > 0) &&
@@ -1013,17 +1026,27 @@ void l2c_OnHciModeChangeSendPendingPackets(RawAddress remote) {
  * Description      This function queues the buffer for HCI transmission
  *
  ******************************************************************************/
-static void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
+static void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf,
+                                          bool is_retained) {
   const uint16_t link_xmit_quota = p_lcb->link_xmit_quota;
 
   if (link_xmit_quota == 0) {
     l2cb.round_robin_unacked++;
   }
   p_lcb->sent_not_acked++;
-  p_buf->layer_specific = 0;
   l2cb.controller_xmit_window--;
 
-  acl_send_data_packet_br_edr(p_lcb->remote_bd_addr, p_buf);
+  if (is_retained) {
+    /* The SAR bits are still needed to retransmit the frame */
+    const uint16_t layer_specific = p_buf->layer_specific;
+    p_buf->layer_specific = 0;
+    acl_send_retained_data_packet_br_edr(p_lcb->remote_bd_addr, p_buf);
+    p_buf->layer_specific = layer_specific;
+    l2c_fcr_retained_xmit_done(p_buf);
+  } else {
+    p_buf->layer_specific = 0;
+    acl_send_data_packet_br_edr(p_lcb->remote_bd_addr, p_buf);
+  }
   log::verbose(
       "TotalWin={},Hndl=0x{:x},Quota={},Unack={},RRQuota={},RRUnack={}",
       l2cb.controller_xmit_window, p_lcb->Handle(), p_lcb->link_xmit_quota,
@@ -1039,6 +1062,7 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
   p_lcb->sent_not_acked++;
   p_buf->layer_specific = 0;
   l2cb.controller_le_xmit_window--;
+  l2cble_tuner_count(p_lcb, p_buf->len, true);
 
   acl_send_data_packet_ble(p_lcb->remote_bd_addr, p_buf);
   log::debug("TotalWin={},Hndl=0x{:x},Quota={},Unack={},RRQuota={},RRUnack={}",
@@ -1049,8 +1073,10 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
 
 static void l2c_link_send_to_lower(tL2C_LCB* p_lcb, BT_HDR* p_buf,
                                    tL2C_TX_COMPLETE_CB_INFO* p_cbi) {
+  BT_TRACE_LATENCY(LEGACY_L2CAP_TX, p_lcb->Handle(), p_buf->len);
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) {
-    l2c_link_send_to_lower_br_edr(p_lcb, p_buf);
+    l2c_link_send_to_lower_br_edr(p_lcb, p_buf,
+                                  p_cbi != NULL && p_cbi->is_retained);
   } else {
     l2c_link_send_to_lower_ble(p_lcb, p_buf);
   }
@@ -1166,6 +1192,43 @@ void l2cble_update_sec_act(const RawAddress& bd_addr, uint16_t sec_act) {
   lcb->sec_act = sec_act;
 }
 
+/******************************************************************************
+ *
+ * Function         l2cu_ccb_can_send
+ *
+ * Description      check whether a channel with queued data may send now,
+ *                  given its state, mode, and flow control.
+ *
+ * Returns          true if the channel can send
+ *
+ ******************************************************************************/
+static bool l2cu_ccb_can_send(tL2C_CCB* p_ccb) {
+  if (p_ccb->chnl_state != CST_OPEN) return false;
+
+  if (p_ccb->p_lcb->transport == BT_TRANSPORT_LE) {
+    log::debug("Connection oriented channel");
+    return !fixed_queue_is_empty(p_ccb->xmit_hold_q) &&
+           p_ccb->peer_conn_cfg.credits != 0;
+  }
+
+  /* eL2CAP option in use */
+  if (p_ccb->peer_cfg.fcr.mode != L2CAP_FCR_BASIC_MODE) {
+    if (p_ccb->fcrb.wait_ack || p_ccb->fcrb.remote_busy) return false;
+
+    if (fixed_queue_is_empty(p_ccb->fcrb.retrans_q)) {
+      if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) return false;
+
+      /* If in eRTM mode, check for window closure */
+      if ((p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) &&
+          (l2c_fcr_is_flow_controlled(p_ccb)))
+        return false;
+    }
+    return true;
+  }
+
+  return !fixed_queue_is_empty(p_ccb->xmit_hold_q);
+}
+
 /******************************************************************************
  *
  * Function         l2cu_get_next_channel_in_rr
@@ -1178,73 +1241,50 @@ void l2cble_update_sec_act(const RawAddress& bd_addr, uint16_t sec_act) {
  ******************************************************************************/
 tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
   tL2C_CCB* p_serve_ccb = NULL;
-  tL2C_CCB* p_ccb;
-
-  int i, j;
 
   /* scan all of priority until finding a channel to serve */
-  for (i = 0; (i < L2CAP_NUM_CHNL_PRIORITY) && (!p_serve_ccb); i++) {
-    /* scan all channel within serving priority group until finding a channel to
-     * serve */
-    for (j = 0; (j < p_lcb->rr_serv[p_lcb->rr_pri].num_ccb) && (!p_serve_ccb);
-         j++) {
-      /* scaning from next serving channel */
-      p_ccb = p_lcb->rr_serv[p_lcb->rr_pri].p_serve_ccb;
-
-      if (!p_ccb) {
-        log::error("p_serve_ccb is NULL, rr_pri={}", p_lcb->rr_pri);
-        return NULL;
-      }
+  for (int i = 0; (i < L2CAP_NUM_CHNL_PRIORITY) && (!p_serve_ccb); i++) {
+    tL2C_RR_SERV* p_serv = &p_lcb->rr_serv[p_lcb->rr_pri];
+
+    /* only channels with data queued are on the ready ring, visit each of
+     * them at most once */
+    for (int j = p_serv->num_ready; (j > 0) && (!p_serve_ccb); j--) {
+      tL2C_CCB* p_ccb = l2cu_pop_ready_ccb(p_serv);
 
       log::verbose("RR scan pri={}, lcid=0x{:04x}, q_cout={}",
                    p_ccb->ccb_priority, p_ccb->local_cid,
                    fixed_queue_length(p_ccb->xmit_hold_q));
 
-      /* store the next serving channel */
-      /* this channel is the last channel of its priority group */
-      if ((p_ccb->p_next_ccb == NULL) ||
-          (p_ccb->p_next_ccb->ccb_priority != p_ccb->ccb_priority)) {
-        /* next serving channel is set to the first channel in the group */
-        p_lcb->rr_serv[p_lcb->rr_pri].p_serve_ccb =
-            p_lcb->rr_serv[p_lcb->rr_pri].p_first_ccb;
-      } else {
-        /* next serving channel is set to the next channel in the group */
-        p_lcb->rr_serv[p_lcb->rr_pri].p_serve_ccb = p_ccb->p_next_ccb;
-      }
-
-      if (p_ccb->chnl_state != CST_OPEN) continue;
-
-      if (p_ccb->p_lcb->transport == BT_TRANSPORT_LE) {
-        log::debug("Connection oriented channel");
-        if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
-
-      } else {
-        /* eL2CAP option in use */
-        if (p_ccb->peer_cfg.fcr.mode != L2CAP_FCR_BASIC_MODE) {
-          if (p_ccb->fcrb.wait_ack || p_ccb->fcrb.remote_busy) continue;
+      /* the channel leaves the ring once it has nothing left to send */
+      if (fixed_queue_is_empty(p_ccb->xmit_hold_q) &&
+          fixed_queue_is_empty(p_ccb->fcrb.retrans_q))
+        continue;
 
-          if (fixed_queue_is_empty(p_ccb->fcrb.retrans_q)) {
-            if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
+      /* next turn of this channel is after the other ready channels */
+      bool waiting = !l2cu_ccb_can_send(p_ccb);
+      uint64_t waiting_since_us = p_ccb->xmit_stats.waiting_since_us;
+      l2cu_mark_ccb_ready(p_ccb);
+      if (waiting) {
+        p_ccb->xmit_stats.waiting_since_us = waiting_since_us;
+        continue;
+      }
 
-            /* If in eRTM mode, check for window closure */
-            if ((p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) &&
-                (l2c_fcr_is_flow_controlled(p_ccb)))
-              continue;
-          }
-        } else {
-          if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
-        }
+      uint64_t wait_us = p_ccb->xmit_stats.waiting_since_us - waiting_since_us;
+      p_ccb->xmit_stats.total_wait_us += wait_us;
+      if (wait_us > p_ccb->xmit_stats.max_wait_us) {
+        p_ccb->xmit_stats.max_wait_us = wait_us;
       }
+      p_ccb->xmit_stats.num_served++;
 
       /* found a channel to serve */
       p_serve_ccb = p_ccb;
       /* decrease quota of its priority group */
-      p_lcb->rr_serv[p_lcb->rr_pri].quota--;
+      p_serv->quota--;
     }
 
     /* if there is no more quota of the priority group or no channel to have
      * data to send */
-    if ((p_lcb->rr_serv[p_lcb->rr_pri].quota == 0) || (!p_serve_ccb)) {
+    if ((p_serv->quota == 0) || (!p_serve_ccb)) {
       /* serve next priority group */
       p_lcb->rr_pri = (p_lcb->rr_pri + 1) % L2CAP_NUM_CHNL_PRIORITY;
       /* initialize its quota */
@@ -1282,6 +1322,7 @@ BT_HDR* l2cu_get_next_buffer_to_send(tL2C_LCB* p_lcb,
   int xx;
 
   p_cbi->cb = NULL;
+  p_cbi->is_retained = false;
 
   for (xx = 0; xx < L2CAP_NUM_FIXED_CHNLS; xx++) {
     p_ccb = p_lcb->p_fixed_ccbs[xx];
@@ -1303,6 +1344,8 @@ BT_HDR* l2cu_get_next_buffer_to_send(tL2C_LCB* p_lcb,
 
       p_buf = l2c_fcr_get_next_xmit_sdu_seg(p_ccb, 0);
       if (p_buf != NULL) {
+        p_cbi->is_retained =
+            (p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE);
         l2cu_check_channel_congestion(p_ccb);
         l2cu_set_acl_hci_header(p_buf, p_ccb);
         return (p_buf);
@@ -1353,6 +1396,7 @@ BT_HDR* l2cu_get_next_buffer_to_send(tL2C_LCB* p_lcb,
     if (p_ccb->peer_cfg.fcr.mode != L2CAP_FCR_BASIC_MODE) {
       p_buf = l2c_fcr_get_next_xmit_sdu_seg(p_ccb, 0);
       if (p_buf == NULL) return (NULL);
+      p_cbi->is_retained = (p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE);
     } else {
       p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
       if (NULL == p_buf) {
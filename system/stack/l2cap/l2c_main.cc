@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "common/init_flags.h"
+#include "common/scope_profiler.h"
 #include "hal/snoop_logger.h"
 #include "hcimsgs.h"  // HCID_GET_
 #include "internal_include/bt_target.h"
@@ -65,6 +66,7 @@ tL2C_CB l2cb;
  *
  ******************************************************************************/
 void l2c_rcv_acl_data(BT_HDR* p_msg) {
+  BT_PROFILE_SCOPE(L2CAP_ACL_RX);
   uint8_t* p = (uint8_t*)(p_msg + 1) + p_msg->offset;
 
   /* Extract the handle */
@@ -114,6 +116,9 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
      * not in disconnecting mode */
     l2cble_notify_le_connection(p_lcb->remote_bd_addr);
   }
+  if (p_lcb->transport == BT_TRANSPORT_LE) {
+    l2cble_tuner_count(p_lcb, hci_len, false);
+  }
 
   /* Find the CCB for this CID */
   tL2C_CCB* p_ccb = NULL;
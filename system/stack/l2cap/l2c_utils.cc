@@ -26,12 +26,14 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include "common/time_util.h"
 #include "hal/snoop_logger.h"
 #include "hci/controller_interface.h"
 #include "internal_include/bt_target.h"
 #include "main/shim/acl_api.h"
 #include "main/shim/entry.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_budget.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_hdr.h"
@@ -68,6 +70,7 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
     if (!p_lcb->in_use) {
       alarm_free(p_lcb->l2c_lcb_timer);
       alarm_free(p_lcb->info_resp_timer);
+      alarm_free(p_lcb->le_tuner_timer);
       memset(p_lcb, 0, sizeof(tL2C_LCB));
 
       p_lcb->remote_bd_addr = p_bd_addr;
@@ -78,6 +81,7 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
       p_lcb->InvalidateHandle();
       p_lcb->l2c_lcb_timer = alarm_new("l2c_lcb.l2c_lcb_timer");
       p_lcb->info_resp_timer = alarm_new("l2c_lcb.info_resp_timer");
+      p_lcb->le_tuner_timer = alarm_new("l2c_lcb.le_tuner_timer");
       p_lcb->idle_timeout = l2cb.idle_timeout;
       p_lcb->signal_id = 1; /* spec does not allow '0' */
       if (is_bonding) {
@@ -158,6 +162,8 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   p_lcb->l2c_lcb_timer = NULL;
   alarm_free(p_lcb->info_resp_timer);
   p_lcb->info_resp_timer = NULL;
+  alarm_free(p_lcb->le_tuner_timer);
+  p_lcb->le_tuner_timer = NULL;
 
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) /* Release all SCO links */
     BTM_RemoveSco(p_lcb->remote_bd_addr);
@@ -1213,8 +1219,6 @@ void l2cu_enqueue_ccb(tL2C_CCB* p_ccb) {
     if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb == 0) {
       /* Set the first channel to this CCB */
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = p_ccb;
-      /* Set the next serving channel in this group to this CCB */
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = p_ccb;
       /* Initialize quota of this priority group based on its priority */
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].quota =
           L2CAP_GET_PRIORITY_QUOTA(p_ccb->ccb_priority);
@@ -1253,25 +1257,20 @@ void l2cu_dequeue_ccb(tL2C_CCB* p_ccb) {
 
   /* Removing CCB from round robin service table of its LCB */
   if (p_ccb->p_lcb != NULL) {
+    l2cu_remove_ready_ccb(p_ccb);
+
     /* decrease number of channels in this priority group */
     p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb--;
 
     /* if it was the last channel in the priority group */
     if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb == 0) {
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = NULL;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = NULL;
     } else {
       /* if it is the first channel of this group */
       if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb == p_ccb) {
         p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb =
             p_ccb->p_next_ccb;
       }
-      /* if it is the next serving channel of this group */
-      if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb == p_ccb) {
-        /* simply, start serving from the first channel */
-        p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb =
-            p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb;
-      }
     }
   }
 
@@ -1320,19 +1319,102 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
     else {
       /* If CCB is the only guy on the queue, no need to re-enqueue */
       /* update only round robin service data */
+      bool was_ready = p_ccb->in_ready_q;
+      l2cu_remove_ready_ccb(p_ccb);
+
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb = 0;
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = NULL;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = NULL;
 
       p_ccb->ccb_priority = priority;
 
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = p_ccb;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = p_ccb;
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].quota =
           L2CAP_GET_PRIORITY_QUOTA(p_ccb->ccb_priority);
       p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb = 1;
+
+      if (was_ready) l2cu_mark_ccb_ready(p_ccb);
+    }
+  }
+}
+
+/******************************************************************************
+ *
+ * Function         l2cu_mark_ccb_ready
+ *
+ * Description      Put a channel that has data queued at the back of the ready
+ *                  ring of its priority group, unless it is there already.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+void l2cu_mark_ccb_ready(tL2C_CCB* p_ccb) {
+  if (p_ccb->in_ready_q || p_ccb->p_lcb == NULL) return;
+
+  tL2C_RR_SERV* p_serv = &p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority];
+  p_ccb->p_next_ready = NULL;
+  if (p_serv->p_ready_last == NULL) {
+    p_serv->p_ready_first = p_ccb;
+  } else {
+    p_serv->p_ready_last->p_next_ready = p_ccb;
+  }
+  p_serv->p_ready_last = p_ccb;
+  p_serv->num_ready++;
+  p_ccb->in_ready_q = true;
+  p_ccb->xmit_stats.waiting_since_us =
+      bluetooth::common::time_get_os_boottime_us();
+}
+
+/******************************************************************************
+ *
+ * Function         l2cu_pop_ready_ccb
+ *
+ * Description      Take the channel at the front of a ready ring.
+ *
+ * Returns          pointer to CCB or NULL if the ring is empty
+ *
+ ******************************************************************************/
+tL2C_CCB* l2cu_pop_ready_ccb(tL2C_RR_SERV* p_serv) {
+  tL2C_CCB* p_ccb = p_serv->p_ready_first;
+  if (p_ccb == NULL) return NULL;
+
+  p_serv->p_ready_first = p_ccb->p_next_ready;
+  if (p_serv->p_ready_first == NULL) p_serv->p_ready_last = NULL;
+  p_serv->num_ready--;
+  p_ccb->p_next_ready = NULL;
+  p_ccb->in_ready_q = false;
+  return p_ccb;
+}
+
+/******************************************************************************
+ *
+ * Function         l2cu_remove_ready_ccb
+ *
+ * Description      Take a channel out of the ready ring of its priority group,
+ *                  wherever it is.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+void l2cu_remove_ready_ccb(tL2C_CCB* p_ccb) {
+  if (!p_ccb->in_ready_q || p_ccb->p_lcb == NULL) return;
+
+  tL2C_RR_SERV* p_serv = &p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority];
+  tL2C_CCB* p_prev = NULL;
+  for (tL2C_CCB* p = p_serv->p_ready_first; p != NULL; p = p->p_next_ready) {
+    if (p == p_ccb) {
+      if (p_prev == NULL) {
+        p_serv->p_ready_first = p_ccb->p_next_ready;
+      } else {
+        p_prev->p_next_ready = p_ccb->p_next_ready;
+      }
+      if (p_serv->p_ready_last == p_ccb) p_serv->p_ready_last = p_prev;
+      p_serv->num_ready--;
+      break;
     }
+    p_prev = p;
   }
+  p_ccb->p_next_ready = NULL;
+  p_ccb->in_ready_q = false;
 }
 
 /*******************************************************************************
@@ -1385,6 +1467,9 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid, bool is_eatt) {
   }
 
   p_ccb->p_next_ccb = p_ccb->p_prev_ccb = nullptr;
+  p_ccb->p_next_ready = nullptr;
+  p_ccb->in_ready_q = false;
+  p_ccb->xmit_stats = {};
 
   p_ccb->in_use = true;
 
@@ -1437,6 +1522,7 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid, bool is_eatt) {
   p_ccb->tx_mps = BT_DEFAULT_BUFFER_SIZE - 32;
 
   p_ccb->xmit_hold_q = fixed_queue_new(SIZE_MAX);
+  fixed_queue_set_buffer_owner(p_ccb->xmit_hold_q, BUFFER_OWNER_L2CAP_TX);
   p_ccb->fcrb.srej_rcv_hold_q = fixed_queue_new(SIZE_MAX);
   p_ccb->fcrb.retrans_q = fixed_queue_new(SIZE_MAX);
   p_ccb->fcrb.waiting_for_ack_q = fixed_queue_new(SIZE_MAX);
@@ -1572,6 +1658,9 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
   alarm_free(p_ccb->l2c_ccb_timer);
   p_ccb->l2c_ccb_timer = NULL;
 
+  /* Fixed channels are not dequeued from their LCB below */
+  l2cu_remove_ready_ccb(p_ccb);
+
   fixed_queue_free(p_ccb->xmit_hold_q, osi_free);
   p_ccb->xmit_hold_q = NULL;
 
@@ -3529,14 +3618,18 @@ void l2cu_check_channel_congestion(tL2C_CCB* p_ccb) {
   if (p_ccb->buff_quota == 0) return;
 
   size_t q_count = fixed_queue_length(p_ccb->xmit_hold_q);
+  /* A channel with data queued is also congested while the L2CAP transmit
+   * buffers are over budget, until it has sent all its data */
+  bool over_budget =
+      q_count > 0 && buffer_budget_is_exceeded(BUFFER_OWNER_L2CAP_TX);
 
   if (p_ccb->cong_sent) {
     /* if channel was congested, but is not congested now, tell the app */
-    if (q_count <= (p_ccb->buff_quota / 2))
+    if (q_count <= (p_ccb->buff_quota / 2) && !over_budget)
       send_congestion_status_to_all_clients(p_ccb, false);
   } else {
     /* if channel was not congested, but is congested now, tell the app */
-    if (q_count > p_ccb->buff_quota)
+    if (q_count > p_ccb->buff_quota || over_budget)
       send_congestion_status_to_all_clients(p_ccb, true);
   }
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <bluetooth/log.h>
 #include <frameworks/proto_logging/stats/enums/bluetooth/enums.pb.h>
 #include <frameworks/proto_logging/stats/enums/bluetooth/hci/enums.pb.h>
 
@@ -87,3 +88,16 @@ void log_mmc_transcode_rtt_stats(int maximum_rtt, double mean_rtt,
   bluetooth::shim::LogMetricMmcTranscodeRttStats(maximum_rtt, mean_rtt,
                                                  num_requests, codec_type);
 }
+
+// There is no statsd atom for ATT latencies yet, keep them in the log so they
+// can be collected from bug reports.
+void log_gatt_att_latency_stats(const RawAddress& address, uint8_t op_code,
+                                bool is_eatt, int num_requests,
+                                double mean_latency_ms, int max_latency_ms,
+                                uint16_t mtu) {
+  bluetooth::log::info(
+      "{} op_code=0x{:02x} eatt={} num_requests={} mean={:.1f}ms max={}ms "
+      "mtu={}",
+      address, op_code, is_eatt, num_requests, mean_latency_ms, max_latency_ms,
+      mtu);
+}
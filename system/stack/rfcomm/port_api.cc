@@ -39,6 +39,7 @@
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/bt_uuid16.h"
+#include "main/shim/dumpsys.h"
 #include "stack/include/btm_log_history.h"
 #include "stack/rfcomm/rfc_int.h"
 #include "types/raw_address.h"
@@ -929,8 +930,7 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
 
   while (available) {
     /* if we're over buffer high water mark, we're done */
-    if ((p_port->tx.queue_size > PORT_TX_HIGH_WM) ||
-        (fixed_queue_length(p_port->tx.queue) > PORT_TX_BUF_HIGH_WM)) {
+    if (port_tx_queue_is_full(p_port)) {
       port_flow_control_user(p_port);
       event |= PORT_EV_FC;
       log::verbose(
@@ -1059,9 +1059,7 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
 
   while (max_len) {
     /* if we're over buffer high water mark, we're done */
-    if ((p_port->tx.queue_size > PORT_TX_HIGH_WM) ||
-        (fixed_queue_length(p_port->tx.queue) > PORT_TX_BUF_HIGH_WM))
-      break;
+    if (port_tx_queue_is_full(p_port)) break;
 
     /* continue with rfcomm data write */
     p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
@@ -1155,3 +1153,33 @@ int PORT_GetSecurityMask(uint16_t handle, uint16_t* sec_mask) {
   *sec_mask = p_port->sec_mask;
   return (PORT_SUCCESS);
 }
+
+#define DUMPSYS_TAG "shim::legacy::rfcomm"
+void RFCOMM_Dumpsys(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  for (int i = 0; i < MAX_RFC_PORTS; i++) {
+    const tPORT* p_port = &rfc_cb.port.port[i];
+    if (!p_port->in_use) continue;
+    LOG_DUMPSYS(fd, "  handle:%hhu peer:%s scn:%hhu dlci:%hhu state:%s",
+                p_port->handle, ADDRESS_TO_LOGGABLE_CSTR(p_port->bd_addr),
+                p_port->scn, p_port->dlci,
+                port_connection_state_text(p_port->state).c_str());
+    LOG_DUMPSYS(fd,
+                "    mtu:%hu peer_mtu:%hu credit_tx:%hu credit_rx:%hu "
+                "credit_rx_max:%hu credit_rx_low:%hu",
+                p_port->mtu, p_port->peer_mtu, p_port->credit_tx,
+                p_port->credit_rx, p_port->credit_rx_max,
+                p_port->credit_rx_low);
+    LOG_DUMPSYS(fd,
+                "    tx_frames:%-6u tx_bytes:%-10llu credits_received:%-6u "
+                "tx_queue_size:%u",
+                p_port->tx_frames, (unsigned long long)p_port->tx_bytes,
+                p_port->credits_received, p_port->tx.queue_size);
+    LOG_DUMPSYS(fd,
+                "    rx_frames:%-6u rx_bytes:%-10llu credits_sent:%-6u "
+                "rx_queue_size:%u",
+                p_port->rx_frames, (unsigned long long)p_port->rx_bytes,
+                p_port->credits_sent, p_port->rx.queue_size);
+  }
+}
+#undef DUMPSYS_TAG
@@ -208,6 +208,13 @@ typedef struct {
       credit_rx_max; /* Max number of credits we will allow this guy to sent */
   uint16_t credit_rx_low;   /* Number of credits when we send credit update */
   uint16_t rx_buf_critical; /* port receive queue critical watermark level */
+  uint32_t tx_frames;        /* UIH data frames sent to the peer */
+  uint64_t tx_bytes;         /* Payload bytes sent to the peer */
+  uint32_t rx_frames;        /* UIH data frames received from the peer */
+  uint64_t rx_bytes;         /* Payload bytes received from the peer */
+  uint32_t credits_sent;     /* Credits returned to the peer after the */
+                             /* initial grant */
+  uint32_t credits_received; /* Credits returned by the peer */
   bool keep_port_handle;    /* true if port is not deallocated when closing */
   /* it is set to true for server when allocating port */
   uint16_t keep_mtu; /* Max MTU that port can receive by server */
@@ -235,6 +242,7 @@ tPORT* port_find_dlci_port(uint8_t dlci);
 tPORT* port_find_port(uint8_t dlci, const RawAddress& bd_addr);
 uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals,
                                  uint8_t signal);
+bool port_tx_queue_is_full(tPORT* p_port);
 uint32_t port_flow_control_user(tPORT* p_port);
 void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count);
 
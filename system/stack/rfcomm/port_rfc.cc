@@ -30,6 +30,7 @@
 #include <frameworks/proto_logging/stats/enums/bluetooth/enums.pb.h>
 
 #include <cstdint>
+#include <cstring>
 
 #include "hal/snoop_logger.h"
 #include "internal_include/bt_target.h"
@@ -779,6 +780,8 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
     osi_free(p_buf);
     return;
   }
+  p_port->rx_frames++;
+  p_port->rx_bytes += p_buf->len;
   /* If client registered callout callback with flow control we can just deliver
    * receive data */
   if (p_port->p_data_co_callback) {
@@ -900,6 +903,47 @@ void PORT_FlowInd(tRFC_MCB* p_mcb, uint8_t dlci, bool enable_data) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         port_rfc_coalesce_tx_data
+ *
+ * Description      Move data from the buffers queued after p_buf to the end
+ *                  of p_buf, so that the frame sent to the peer carries up to
+ *                  peer_mtu bytes.  Data queued while the peer was flow
+ *                  controlling us usually comes from writes of various sizes,
+ *                  and each frame costs a credit.  The tx queue must be
+ *                  locked by the caller.
+ *
+ ******************************************************************************/
+static void port_rfc_coalesce_tx_data(tPORT* p_port, BT_HDR* p_buf) {
+  /* Same limit as when PORT_WriteData appends to a queued buffer */
+  uint16_t max_len =
+      RFCOMM_DATA_BUF_SIZE -
+      (uint16_t)(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + RFCOMM_DATA_OVERHEAD);
+  if (max_len > p_port->peer_mtu) max_len = p_port->peer_mtu;
+
+  while (p_buf->len < max_len) {
+    BT_HDR* p_next = (BT_HDR*)fixed_queue_try_peek_first(p_port->tx.queue);
+    if (p_next == NULL) break;
+
+    uint16_t len = max_len - p_buf->len;
+    if (len > p_next->len) len = p_next->len;
+    memcpy((uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len,
+           (uint8_t*)(p_next + 1) + p_next->offset, len);
+    p_buf->len += len;
+    p_next->len -= len;
+
+    if (p_next->len == 0) {
+      osi_free(fixed_queue_try_dequeue(p_port->tx.queue));
+    } else {
+      /* PORT_WriteData may still append to this buffer, keep its data at the
+       * start */
+      memmove((uint8_t*)(p_next + 1) + p_next->offset,
+              (uint8_t*)(p_next + 1) + p_next->offset + len, p_next->len);
+    }
+  }
+}
+
 /*******************************************************************************
  *
  * Function         port_rfc_send_tx_data
@@ -921,6 +965,7 @@ uint32_t port_rfc_send_tx_data(tPORT* p_port) {
 
       p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue);
       if (p_buf != NULL) {
+        port_rfc_coalesce_tx_data(p_port, p_buf);
         p_port->tx.queue_size -= p_buf->len;
 
         mutex_global_unlock();
@@ -31,7 +31,9 @@
 
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_budget.h"
 #include "osi/include/mutex.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack/include/l2cdefs.h"
@@ -41,6 +43,11 @@
 
 using namespace bluetooth;
 
+/* Number of credits the peer must use before they are returned, 0 keeps the */
+/* PORT_RX_LOW_WM based watermark */
+static const char kPropertyCreditReturnThreshold[] =
+    "bluetooth.rfcomm.credit_return_threshold";
+
 static const tPORT_STATE default_port_pars = {
     PORT_BAUD_RATE_9600,
     PORT_8_BITS,
@@ -125,6 +132,8 @@ void port_set_defaults(tPORT* p_port) {
 
   p_port->tx.queue = fixed_queue_new(SIZE_MAX);
   p_port->rx.queue = fixed_queue_new(SIZE_MAX);
+  fixed_queue_set_buffer_owner(p_port->tx.queue, BUFFER_OWNER_RFCOMM_TX);
+  fixed_queue_set_buffer_owner(p_port->rx.queue, BUFFER_OWNER_RFCOMM_RX);
 }
 
 /*******************************************************************************
@@ -183,6 +192,15 @@ void port_select_mtu(tPORT* p_port) {
   p_port->credit_rx_low = (PORT_RX_LOW_WM / p_port->mtu);
   if (p_port->credit_rx_low > PORT_RX_BUF_LOW_WM)
     p_port->credit_rx_low = PORT_RX_BUF_LOW_WM;
+  /* Credits are returned in a single update once the peer used at least */
+  /* credit_return_threshold of them, unless they can go with our data */
+  int32_t credit_return_threshold =
+      osi_property_get_int32(kPropertyCreditReturnThreshold, 0);
+  if (credit_return_threshold > 0 && p_port->credit_rx_max > 0) {
+    if (credit_return_threshold > p_port->credit_rx_max)
+      credit_return_threshold = p_port->credit_rx_max;
+    p_port->credit_rx_low = p_port->credit_rx_max - credit_return_threshold;
+  }
   p_port->rx_buf_critical = (PORT_RX_CRITICAL_WM / p_port->mtu);
   if (p_port->rx_buf_critical > PORT_RX_BUF_CRITICAL_WM)
     p_port->rx_buf_critical = PORT_RX_BUF_CRITICAL_WM;
@@ -366,6 +384,24 @@ tPORT* port_find_port(uint8_t dlci, const RawAddress& bd_addr) {
   return nullptr;
 }
 
+/*******************************************************************************
+ *
+ * Function         port_tx_queue_is_full
+ *
+ * Description      Check if the transmit queue of the port is over its high
+ *                  water marks, or holds data while the RFCOMM transmit
+ *                  buffers are over budget.
+ *
+ * Returns          true if the user should stop writing to the port
+ *
+ ******************************************************************************/
+bool port_tx_queue_is_full(tPORT* p_port) {
+  return (p_port->tx.queue_size > PORT_TX_HIGH_WM) ||
+         (fixed_queue_length(p_port->tx.queue) > PORT_TX_BUF_HIGH_WM) ||
+         (p_port->tx.queue_size > 0 &&
+          buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_TX));
+}
+
 /*******************************************************************************
  *
  * Function         port_flow_control_user
@@ -384,9 +420,7 @@ uint32_t port_flow_control_user(tPORT* p_port) {
   /* (FlowInd, or flow control by the peer RFCOMM (Fcon) or internally if */
   /* tx_queue is full */
   bool fc = p_port->tx.peer_fc || !p_port->rfc.p_mcb ||
-            !p_port->rfc.p_mcb->peer_ready ||
-            (p_port->tx.queue_size > PORT_TX_HIGH_WM) ||
-            (fixed_queue_length(p_port->tx.queue) > PORT_TX_BUF_HIGH_WM);
+            !p_port->rfc.p_mcb->peer_ready || port_tx_queue_is_full(p_port);
 
   if (p_port->tx.user_fc == fc) return (0);
 
@@ -465,10 +499,15 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* If credit count is less than low credit watermark, and user */
       /* did not force flow control, send a credit update */
       /* There might be a special case when we just adjusted rx_max */
+      /* Credits are held back while the user has not read all the data and */
+      /* the RFCOMM receive buffers are over budget */
       if ((p_port->credit_rx <= p_port->credit_rx_low) && !p_port->rx.user_fc &&
-          (p_port->credit_rx_max > p_port->credit_rx)) {
+          (p_port->credit_rx_max > p_port->credit_rx) &&
+          (fixed_queue_is_empty(p_port->rx.queue) ||
+           !buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_RX))) {
         rfc_send_credit(p_port->rfc.p_mcb, p_port->dlci,
                         (uint8_t)(p_port->credit_rx_max - p_port->credit_rx));
+        p_port->credits_sent += p_port->credit_rx_max - p_port->credit_rx;
 
         p_port->credit_rx = p_port->credit_rx_max;
 
@@ -512,7 +551,8 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* Check the size of the rx queue.  If it exceeds certain */
       /* level and flow control has not been sent to the peer do it now */
       else if (((p_port->rx.queue_size > PORT_RX_HIGH_WM) ||
-                (fixed_queue_length(p_port->rx.queue) > PORT_RX_BUF_HIGH_WM)) &&
+                (fixed_queue_length(p_port->rx.queue) > PORT_RX_BUF_HIGH_WM) ||
+                buffer_budget_is_exceeded(BUFFER_OWNER_RFCOMM_RX)) &&
                !p_port->rx.peer_fc) {
         log::verbose("PORT_DataInd Data reached HW. Sending FC set.");
 
@@ -375,6 +375,7 @@ void rfc_port_closed(tPORT* p_port) {
 void rfc_inc_credit(tPORT* p_port, uint8_t credit) {
   if (p_port->rfc.p_mcb->flow == PORT_FC_CREDIT) {
     p_port->credit_tx += credit;
+    p_port->credits_received += credit;
 
     log::verbose("rfc_inc_credit:{}", p_port->credit_tx);
 
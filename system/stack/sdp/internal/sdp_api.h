@@ -100,6 +100,23 @@ bool SDP_ServiceSearchAttributeRequest2(
     const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db,
     base::RepeatingCallback<tSDP_DISC_CMPL_CB> complete_callback);
 
+/*******************************************************************************
+ *
+ * Function         SDP_ServiceSearchAttributeFromCache
+ *
+ * Description      This function fills the discovery database with the last
+ *                  service search attribute response of a bonded device to
+ *                  the same UUID and attribute filters, instead of querying
+ *                  the SDP server. A cached response that is getting old is
+ *                  refreshed from the server in the background.
+ *
+ * Returns          true if the database was filled from the cache, false if
+ *                  the server has to be queried.
+ *
+ ******************************************************************************/
+bool SDP_ServiceSearchAttributeFromCache(const RawAddress& p_bd_addr,
+                                         tSDP_DISCOVERY_DB* p_db);
+
 /* API of utilities to find data in the local discovery database */
 
 /*******************************************************************************
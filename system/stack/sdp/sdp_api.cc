@@ -26,13 +26,16 @@
 
 #include "stack/include/sdp_api.h"
 
+#include <base/functional/bind.h>
 #include <bluetooth/log.h>
 #include <string.h>
 
 #include <cstdint>
+#include <vector>
 
 #include "internal_include/bt_target.h"
 #include "os/log.h"
+#include "osi/include/allocator.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/bt_uuid16.h"
 #include "stack/include/sdp_api.h"
@@ -213,6 +216,86 @@ bool SDP_ServiceSearchAttributeRequest2(
   return (true);
 }
 
+/*******************************************************************************
+ *
+ * Function         sdp_refresh_cache
+ *
+ * Description      This function queries the SDP server of |bd_addr| again
+ *                  with the filters of |p_db|, so that the cache is updated
+ *                  when the response is received.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_refresh_cache(const RawAddress& bd_addr,
+                              const tSDP_DISCOVERY_DB* p_db) {
+  tSDP_DISCOVERY_DB* p_refresh_db =
+      (tSDP_DISCOVERY_DB*)osi_malloc(p_db->mem_size);
+  if (!SDP_InitDiscoveryDb(p_refresh_db, p_db->mem_size, p_db->num_uuid_filters,
+                           p_db->uuid_filters, p_db->num_attr_filters,
+                           p_db->attr_filters)) {
+    osi_free(p_refresh_db);
+    return;
+  }
+
+  /* The response only matters to the cache, which is updated before the
+   * completion callback is called */
+  if (!SDP_ServiceSearchAttributeRequest2(
+          bd_addr, p_refresh_db,
+          base::BindRepeating(
+              [](tSDP_DISCOVERY_DB* p_refresh_db, const RawAddress& bd_addr,
+                 tSDP_STATUS result) {
+                log::debug("SDP cache refresh of {} done, result:{}", bd_addr,
+                           sdp_status_text(result));
+                osi_free(p_refresh_db);
+              },
+              p_refresh_db))) {
+    log::warn("Unable to refresh the SDP cache of {}", bd_addr);
+    osi_free(p_refresh_db);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         SDP_ServiceSearchAttributeFromCache
+ *
+ * Description      This function fills the discovery database with the last
+ *                  service search attribute response of a bonded device to
+ *                  the same UUID and attribute filters, instead of querying
+ *                  the SDP server. A cached response that is getting old is
+ *                  refreshed from the server in the background.
+ *
+ * Returns          true if the database was filled from the cache, false if
+ *                  the server has to be queried.
+ *
+ ******************************************************************************/
+bool SDP_ServiceSearchAttributeFromCache(const RawAddress& bd_addr,
+                                         tSDP_DISCOVERY_DB* p_db) {
+  std::vector<uint8_t> attr_list;
+  uint64_t age_sec;
+  if (p_db == nullptr || !sdp_cache_load(bd_addr, *p_db, attr_list, age_sec)) {
+    return false;
+  }
+
+  /* Leave the database untouched if the cached response does not fit */
+  const tSDP_DISCOVERY_DB saved = *p_db;
+  tSDP_STATUS status =
+      sdp_disc_parse_attr_list(bd_addr, p_db, attr_list.data(), attr_list.size());
+  if (status != SDP_SUCCESS) {
+    log::warn("Ignoring SDP cache of {}, status:{}", bd_addr,
+              sdp_status_text(status));
+    *p_db = saved;
+    return false;
+  }
+
+  log::info("Using SDP cache of {}, age:{}s records:{}", bd_addr, age_sec,
+            sdp_get_num_records(*p_db));
+  if (age_sec > SDP_CACHE_REFRESH_AGE_SEC) {
+    sdp_refresh_cache(bd_addr, p_db);
+  }
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         SDP_FindAttributeInRec
@@ -1071,6 +1154,8 @@ bluetooth::legacy::stack::sdp::tSdpApi api_ = {
                 ::SDP_ServiceSearchAttributeRequest,
             .SDP_ServiceSearchAttributeRequest2 =
                 ::SDP_ServiceSearchAttributeRequest2,
+            .SDP_ServiceSearchAttributeFromCache =
+                ::SDP_ServiceSearchAttributeFromCache,
         },
     .db =
         {
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/******************************************************************************
+ *
+ *  This file contains the client side cache of the service search attribute
+ *  responses of the bonded devices.
+ *
+ *  An entry holds the attribute lists returned by the peer for one set of UUID
+ *  and attribute filters, stored in the device section of the config next to a
+ *  version byte and the time the response was received.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "sdp_cache"
+
+#include <bluetooth/log.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "btif/include/btif_config.h"
+#include "common/time_util.h"
+#include "osi/include/properties.h"
+#include "stack/sdp/sdp_discovery_db.h"
+#include "stack/sdp/sdpint.h"
+#include "storage/config_keys.h"
+#include "types/raw_address.h"
+
+using namespace bluetooth;
+
+namespace {
+
+constexpr uint8_t kSdpCacheVersion = 1;
+constexpr size_t kSdpCacheHeaderSize = sizeof(uint8_t) + sizeof(uint64_t);
+constexpr char kPropertySdpCacheEnabled[] = "bluetooth.sdp.cache.enabled";
+
+uint32_t fnv1a(uint32_t hash, const uint8_t* p, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    hash ^= p[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/* The responses to different requests are cached separately, the key is made
+ * of a hash of the filters of the discovery database */
+std::string sdp_cache_key(const tSDP_DISCOVERY_DB& db) {
+  uint32_t hash = 2166136261u;
+  for (uint16_t i = 0; i < db.num_uuid_filters; i++) {
+    const Uuid::UUID128Bit uuid = db.uuid_filters[i].To128BitBE();
+    hash = fnv1a(hash, uuid.data(), uuid.size());
+  }
+  /* Separate the UUIDs from the attributes */
+  const uint8_t separator = 0xff;
+  hash = fnv1a(hash, &separator, sizeof(separator));
+  for (uint16_t i = 0; i < db.num_attr_filters; i++) {
+    const uint8_t attr[2] = {(uint8_t)(db.attr_filters[i] >> 8),
+                             (uint8_t)db.attr_filters[i]};
+    hash = fnv1a(hash, attr, sizeof(attr));
+  }
+  return fmt::format("{}_{:08x}", BTIF_STORAGE_KEY_SDP_CACHE, hash);
+}
+
+uint64_t sdp_cache_now_sec() {
+  return common::time_gettimeofday_us() / 1000000;
+}
+
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_is_enabled
+ *
+ * Description      Whether the service search attribute responses are cached.
+ *
+ * Returns          bool
+ *
+ ******************************************************************************/
+bool sdp_cache_is_enabled() {
+  static const bool enabled =
+      osi_property_get_bool(kPropertySdpCacheEnabled, true);
+  return enabled;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_store
+ *
+ * Description      Save the attribute lists received from |bd_addr| for the
+ *                  filters of |db|. Only the sections of the bonded devices
+ *                  are persisted by the config, so nothing outlives the bond.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_store(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB& db,
+                     const uint8_t* p_attr_list, uint16_t attr_list_len) {
+  if (!sdp_cache_is_enabled() || p_attr_list == nullptr ||
+      attr_list_len == 0) {
+    return;
+  }
+
+  std::vector<uint8_t> value(kSdpCacheHeaderSize + attr_list_len);
+  const uint64_t now = sdp_cache_now_sec();
+  value[0] = kSdpCacheVersion;
+  memcpy(&value[1], &now, sizeof(now));
+  memcpy(&value[kSdpCacheHeaderSize], p_attr_list, attr_list_len);
+
+  if (!btif_config_set_bin(bd_addr.ToString(), sdp_cache_key(db), value.data(),
+                           value.size())) {
+    log::warn("Unable to cache the SDP response of {}", bd_addr);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_load
+ *
+ * Description      Read the attribute lists cached for |bd_addr| and the
+ *                  filters of |db| if they are younger than
+ *                  SDP_CACHE_MAX_AGE_SEC.
+ *
+ * Returns          true if a valid entry was copied to |attr_list|, with its
+ *                  age in |age_sec|
+ *
+ ******************************************************************************/
+bool sdp_cache_load(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB& db,
+                    std::vector<uint8_t>& attr_list, uint64_t& age_sec) {
+  if (!sdp_cache_is_enabled()) {
+    return false;
+  }
+
+  const std::string section = bd_addr.ToString();
+  const std::string key = sdp_cache_key(db);
+  size_t length = btif_config_get_bin_length(section, key);
+  if (length <= kSdpCacheHeaderSize ||
+      length > kSdpCacheHeaderSize + SDP_MAX_LIST_BYTE_COUNT) {
+    return false;
+  }
+
+  std::vector<uint8_t> value(length);
+  if (!btif_config_get_bin(section, key, value.data(), &length) ||
+      length != value.size()) {
+    return false;
+  }
+
+  uint64_t stored;
+  memcpy(&stored, &value[1], sizeof(stored));
+  const uint64_t now = sdp_cache_now_sec();
+  if (value[0] != kSdpCacheVersion || stored > now ||
+      now - stored > SDP_CACHE_MAX_AGE_SEC) {
+    log::debug("Dropping stale SDP cache entry {} of {}", key, bd_addr);
+    btif_config_remove(section, key);
+    return false;
+  }
+
+  attr_list.assign(value.begin() + kSdpCacheHeaderSize, value.end());
+  age_sec = now - stored;
+  return true;
+}
@@ -28,7 +28,9 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <bitset>
 #include <cstdint>
+#include <unordered_map>
 
 #include "internal_include/bt_target.h"
 #include "os/log.h"
@@ -38,27 +40,73 @@
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdp_discovery_db.h"
 #include "stack/sdp/sdpint.h"
+#include "types/bluetooth/uuid.h"
 
 using namespace bluetooth;
 
+/* Records of the server database holding each UUID, by record index. The
+ * index is rebuilt on the next search after the database changed. */
+static std::unordered_map<Uuid, std::bitset<SDP_MAX_RECORDS>> sdp_uuid_index;
+
+/*******************************************************************************
+ *
+ * Function         sdp_uuid_from_array
+ *
+ * Description      This function converts a BE UUID of 2, 4 or 16 bytes to
+ *                  its 128-bit form, as sdpu_compare_uuid_arrays does.
+ *
+ * Returns          true if the length is valid, else false
+ *
+ ******************************************************************************/
+static bool sdp_uuid_from_array(const uint8_t* p_uuid, uint32_t len,
+                                Uuid* p_out) {
+  switch (len) {
+    case Uuid::kNumBytes16:
+      *p_out = Uuid::From16Bit((p_uuid[0] << 8) | p_uuid[1]);
+      return true;
+    case Uuid::kNumBytes32:
+      *p_out = Uuid::From32Bit((p_uuid[0] << 24) | (p_uuid[1] << 16) |
+                               (p_uuid[2] << 8) | p_uuid[3]);
+      return true;
+    case Uuid::kNumBytes128:
+      *p_out = Uuid::From128BitBE(p_uuid);
+      return true;
+    default:
+      return false;
+  }
+}
+
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         sdp_index_uuid
+ *
+ * Description      This function adds a UUID found in a record to the index.
+ *
+ ******************************************************************************/
+static void sdp_index_uuid(const uint8_t* p_uuid, uint32_t len,
+                           uint16_t rec_index) {
+  Uuid uuid;
+  if (sdp_uuid_from_array(p_uuid, len, &uuid)) {
+    sdp_uuid_index[uuid].set(rec_index);
+  }
+}
+
+/*******************************************************************************
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Function         sdp_index_uuids_in_seq
  *
- * Returns          true if found, else false
+ * Description      This function adds the UUIDs of a data element sequence to
+ *                  the index, going into nested sequences.
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static void sdp_index_uuids_in_seq(uint8_t* p, uint32_t seq_len,
+                                   uint16_t rec_index, int nest_level) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
 
   /* A little safety check to avoid excessive recursion */
-  if (nest_level > 3) return (false);
+  if (nest_level > 3) return;
 
   while (p < p_end) {
     type = *p++;
@@ -69,16 +117,54 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) return (true);
+      sdp_index_uuid(p, len, rec_index);
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1))
-        return (true);
+      sdp_index_uuids_in_seq(p, len, rec_index, nest_level + 1);
     }
     p = p + len;
   }
+}
 
-  /* If here, failed to match */
-  return (false);
+/*******************************************************************************
+ *
+ * Function         sdp_db_build_uuid_index
+ *
+ * Description      This function indexes the UUIDs of all the records in the
+ *                  database, at the top level of an attribute or in a data
+ *                  element sequence.
+ *
+ ******************************************************************************/
+static void sdp_db_build_uuid_index() {
+  sdp_uuid_index.clear();
+  for (uint16_t xx = 0; xx < sdp_cb.server_db.num_records; xx++) {
+    const tSDP_RECORD* p_rec = &sdp_cb.server_db.record[xx];
+    const tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
+    for (uint16_t yy = 0; yy < p_rec->num_attributes; yy++, p_attr++) {
+      if (p_attr->type == UUID_DESC_TYPE) {
+        sdp_index_uuid(p_attr->value_ptr, p_attr->len, xx);
+      } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
+        sdp_index_uuids_in_seq(p_attr->value_ptr, p_attr->len, xx, 0);
+      }
+    }
+  }
+  sdp_cb.server_db.uuid_index_valid = true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_record_changed
+ *
+ * Description      This function is called when a record is added, removed
+ *                  or modified. Records that are not in the server database,
+ *                  such as the PBAP 1.2 copy made for a peer, are ignored.
+ *
+ ******************************************************************************/
+static void sdp_db_record_changed(const tSDP_RECORD* p_rec) {
+  tSDP_DB* p_db = &sdp_cb.server_db;
+  if (p_rec == NULL ||
+      (p_rec >= &p_db->record[0] && p_rec < &p_db->record[SDP_MAX_RECORDS])) {
+    p_db->uuid_index_valid = false;
+  }
 }
 
 /*******************************************************************************
@@ -94,41 +180,40 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
  ******************************************************************************/
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          const tSDP_UUID_SEQ* p_seq) {
-  uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+  tSDP_DB* p_db = &sdp_cb.server_db;
+  uint16_t xx;
 
   /* If NULL, start at the beginning, else start at the first specified record
    */
-  if (!p_rec)
-    p_rec = &sdp_cb.server_db.record[0];
-  else
-    p_rec++;
-
-  /* Look through the records. The spec says that a match occurs if */
-  /* the record contains all the passed UUIDs in it.                */
-  for (; p_rec < p_end; p_rec++) {
-    for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len))
-            break;
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len,
-                               &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0))
-            break;
-        }
-      }
-      /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) break;
+  if (!p_rec) {
+    xx = 0;
+  } else if (p_rec >= &p_db->record[0] &&
+             p_rec < &p_db->record[p_db->num_records]) {
+    xx = (uint16_t)(p_rec - &p_db->record[0]) + 1;
+  } else {
+    return (NULL);
+  }
+
+  if (!p_db->uuid_index_valid) sdp_db_build_uuid_index();
+
+  /* The spec says that a match occurs if the record contains all the passed
+   * UUIDs in it. */
+  std::bitset<SDP_MAX_RECORDS> matches;
+  matches.set();
+  for (uint16_t yy = 0; yy < p_seq->num_uids; yy++) {
+    Uuid uuid;
+    if (!sdp_uuid_from_array(&p_seq->uuid_entry[yy].value[0],
+                             p_seq->uuid_entry[yy].len, &uuid)) {
+      log::error("invalid length");
+      return (NULL);
     }
+    auto it = sdp_uuid_index.find(uuid);
+    if (it == sdp_uuid_index.end()) return (NULL);
+    matches &= it->second;
+  }
 
-    /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) return (p_rec);
+  for (; xx < p_db->num_records; xx++) {
+    if (matches.test(xx)) return (&p_db->record[xx]);
   }
 
   /* If here, no more records found */
@@ -359,6 +444,7 @@ uint32_t SDP_CreateRecord(void) {
     p_db->record[p_db->num_records].record_handle = handle;
 
     p_db->num_records++;
+    sdp_db_record_changed(NULL);
     log::verbose("SDP_CreateRecord ok, num_records:{}", p_db->num_records);
     /* Add the first attribute (the handle) automatically */
     UINT32_TO_BE_FIELD(buf, handle);
@@ -392,6 +478,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
   if (handle == 0 || sdp_cb.server_db.num_records == 0) {
     /* Delete all records in the database */
     sdp_cb.server_db.num_records = 0;
+    sdp_db_record_changed(NULL);
 
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
@@ -411,6 +498,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
         }
 
         sdp_cb.server_db.num_records--;
+        sdp_db_record_changed(NULL);
 
         log::verbose("SDP_DeleteRecord ok, num_records:{}",
                      sdp_cb.server_db.num_records);
@@ -447,6 +535,8 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id,
   uint16_t xx, yy;
   tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
 
+  sdp_db_record_changed(p_rec);
+
   /* Found the record. Now, see if the attribute already exists */
   for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
     /* The attribute exists. replace it */
@@ -866,6 +956,7 @@ bool SDP_DeleteAttributeFromRecord(tSDP_RECORD* p_rec, uint16_t attr_id) {
   for (uint16_t attribute_index = 0; attribute_index < p_rec->num_attributes;
        attribute_index++, p_attr++) {
     if (p_attr->id == attr_id) {
+      sdp_db_record_changed(p_rec);
       pad_ptr = p_attr->value_ptr;
       len = p_attr->len;
 
@@ -566,6 +566,79 @@ static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end) {
   return (p);
 }
 
+/*******************************************************************************
+ *
+ * Function         parse_service_search_attr_list
+ *
+ * Description      This function saves the attribute lists of a complete
+ *                  search attribute response into the discovery database.
+ *
+ * Returns          SDP_SUCCESS if the whole response was saved
+ *
+ ******************************************************************************/
+static tSDP_STATUS parse_service_search_attr_list(tCONN_CB* p_ccb) {
+  uint8_t *p, *p_end;
+  uint8_t type;
+  uint32_t seq_len;
+
+  if (!sdp_copy_raw_data(p_ccb, true)) {
+    log::error("sdp_copy_raw_data failed");
+    return SDP_ILLEGAL_PARAMETER;
+  }
+
+  p = &p_ccb->rsp_list[0];
+
+  /* The contents is a sequence of attribute sequences */
+  type = *p++;
+
+  if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
+    log::warn("Wrong element in attr_rsp type:0x{:02x}", type);
+    return SDP_ILLEGAL_PARAMETER;
+  }
+  p = sdpu_get_len_from_type(p, p + p_ccb->list_len, type, &seq_len);
+  if (p == NULL || (p + seq_len) > (p + p_ccb->list_len)) {
+    log::warn("Illegal search attribute length");
+    return SDP_ILLEGAL_PARAMETER;
+  }
+  p_end = &p_ccb->rsp_list[p_ccb->list_len];
+
+  if ((p + seq_len) != p_end) {
+    return SDP_INVALID_CONT_STATE;
+  }
+
+  while (p < p_end) {
+    p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
+    if (!p) {
+      return SDP_DB_FULL;
+    }
+  }
+
+  return SDP_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_attr_list
+ *
+ * Description      This function saves the attribute lists of a search
+ *                  attribute response received earlier from |bd_addr|, e.g.
+ *                  read from the cache, into the discovery database.
+ *
+ * Returns          SDP_SUCCESS if the whole response was saved
+ *
+ ******************************************************************************/
+tSDP_STATUS sdp_disc_parse_attr_list(const RawAddress& bd_addr,
+                                     tSDP_DISCOVERY_DB* p_db,
+                                     uint8_t* p_attr_list,
+                                     uint16_t attr_list_len) {
+  tCONN_CB ccb{};
+  ccb.device_address = bd_addr;
+  ccb.p_db = p_db;
+  ccb.rsp_list = p_attr_list;
+  ccb.list_len = attr_list_len;
+  return parse_service_search_attr_list(&ccb);
+}
+
 /*******************************************************************************
  *
  * Function         process_service_search_attr_rsp
@@ -578,9 +651,7 @@ static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end) {
  ******************************************************************************/
 static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                             uint8_t* p_reply_end) {
-  uint8_t *p, *p_start, *p_end, *p_param_len;
-  uint8_t type;
-  uint32_t seq_len;
+  uint8_t *p_start, *p_param_len;
   uint16_t param_len, lists_byte_count = 0;
   bool cont_request_needed = false;
 
@@ -703,46 +774,15 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 /* We now have the full response, which is a sequence of sequences */
 /*******************************************************************/
 
-  if (!sdp_copy_raw_data(p_ccb, true)) {
-    log::error("sdp_copy_raw_data failed");
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
-  }
-
-  p = &p_ccb->rsp_list[0];
-
-  /* The contents is a sequence of attribute sequences */
-  type = *p++;
-
-  if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
-    log::warn("Wrong element in attr_rsp type:0x{:02x}", type);
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
-  }
-  p = sdpu_get_len_from_type(p, p + p_ccb->list_len, type, &seq_len);
-  if (p == NULL || (p + seq_len) > (p + p_ccb->list_len)) {
-    log::warn("Illegal search attribute length");
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
-  }
-  p_end = &p_ccb->rsp_list[p_ccb->list_len];
-
-  if ((p + seq_len) != p_end) {
-    sdp_disconnect(p_ccb, SDP_INVALID_CONT_STATE);
-    return;
-  }
+  tSDP_STATUS status = parse_service_search_attr_list(p_ccb);
+  if (status == SDP_SUCCESS) {
+    sdp_cache_store(p_ccb->device_address, *p_ccb->p_db, p_ccb->rsp_list,
+                    p_ccb->list_len);
 
-  while (p < p_end) {
-    p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
-    if (!p) {
-      sdp_disconnect(p_ccb, SDP_DB_FULL);
-      return;
-    }
+    /* Since we got everything we need, disconnect the call */
+    sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
   }
-
-  /* Since we got everything we need, disconnect the call */
-  sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
-  sdp_disconnect(p_ccb, SDP_SUCCESS);
+  sdp_disconnect(p_ccb, status);
 }
 
 /*******************************************************************************
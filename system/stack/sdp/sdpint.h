@@ -29,6 +29,7 @@
 #include <base/strings/stringprintf.h>
 
 #include <cstdint>
+#include <vector>
 
 #include "internal_include/bt_target.h"
 #include "macros.h"
@@ -47,6 +48,11 @@
 /* Timeout definitions. */
 #define SDP_INACT_TIMEOUT_MS (30 * 1000) /* Inactivity timeout (in ms) */
 
+/* Age after which a cached response is discarded, and after which it is still
+ * used but refreshed in the background */
+#define SDP_CACHE_MAX_AGE_SEC (7 * 24 * 60 * 60)
+#define SDP_CACHE_REFRESH_AGE_SEC (24 * 60 * 60)
+
 /* Define the Protocol Data Unit (PDU) types.
  */
 #define SDP_PDU_ERROR_RESPONSE 0x01
@@ -113,6 +119,8 @@ typedef struct {
       di_primary_handle; /* Device ID Primary record or NULL if nonexistent */
   uint16_t num_records;
   tSDP_RECORD record[SDP_MAX_RECORDS];
+  bool uuid_index_valid; /* false when records changed since the UUID index
+                            was built */
 } tSDP_DB;
 
 /* Continuation information for the SDP server response */
@@ -323,6 +331,18 @@ void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
  */
 void sdp_disc_connected(tCONN_CB* p_ccb);
 void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
+tSDP_STATUS sdp_disc_parse_attr_list(const RawAddress& bd_addr,
+                                     tSDP_DISCOVERY_DB* p_db,
+                                     uint8_t* p_attr_list,
+                                     uint16_t attr_list_len);
+
+/* Functions provided by sdp_cache.cc
+ */
+bool sdp_cache_is_enabled();
+void sdp_cache_store(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB& db,
+                     const uint8_t* p_attr_list, uint16_t attr_list_len);
+bool sdp_cache_load(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB& db,
+                    std::vector<uint8_t>& attr_list, uint64_t& age_sec);
 
 void update_pce_entry_to_interop_database(RawAddress remote_addr);
 bool is_sdp_pbap_pce_disabled(RawAddress remote_addr);
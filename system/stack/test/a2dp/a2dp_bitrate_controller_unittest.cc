@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "a2dp_bitrate_controller.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace testing {
+
+class A2dpBitrateControllerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { controller_.Reset(); }
+
+  // Runs the encoder |runs| times with |queue_length| packets queued, and
+  // returns how many runs changed the step.
+  int Run(int runs, size_t queue_length) {
+    int changes = 0;
+    for (int i = 0; i < runs; i++) {
+      if (controller_.OnTransmitQueueLength(queue_length)) changes++;
+    }
+    return changes;
+  }
+
+  A2dpBitrateController controller_;
+};
+
+TEST_F(A2dpBitrateControllerTest, starts_at_configured_bitrate) {
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps);
+  ASSERT_EQ(controller_.Scale(20, 53), 53);
+  ASSERT_EQ(Run(1000, 0), 0);
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps);
+}
+
+TEST_F(A2dpBitrateControllerTest, steps_down_while_congested) {
+  constexpr size_t kQueueLength =
+      A2dpBitrateController::kCongestedQueueLength;
+  ASSERT_EQ(Run(A2dpBitrateController::kCongestedRunsToStepDown - 1,
+                kQueueLength),
+            0);
+  ASSERT_EQ(Run(1, kQueueLength), 1);
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps - 1);
+
+  // Runs that are not congested in a row do not count
+  Run(A2dpBitrateController::kCongestedRunsToStepDown - 1, kQueueLength);
+  Run(1, 2);
+  Run(A2dpBitrateController::kCongestedRunsToStepDown - 1, kQueueLength);
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps - 1);
+
+  ASSERT_EQ(Run(100, kQueueLength), A2dpBitrateController::kNumSteps - 1);
+  ASSERT_EQ(controller_.step, 0);
+  ASSERT_EQ(controller_.Scale(20, 53), 20);
+}
+
+TEST_F(A2dpBitrateControllerTest, steps_up_once_clear) {
+  Run(A2dpBitrateController::kCongestedRunsToStepDown * 2,
+      A2dpBitrateController::kCongestedQueueLength);
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps - 2);
+
+  // A busier queue holds the step
+  ASSERT_EQ(Run(A2dpBitrateController::kClearRunsToStepUp - 1, 1), 0);
+  ASSERT_EQ(Run(1, 2), 0);
+  ASSERT_EQ(Run(A2dpBitrateController::kClearRunsToStepUp - 1, 0), 0);
+  ASSERT_EQ(Run(1, 0), 1);
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps - 1);
+
+  ASSERT_EQ(Run(A2dpBitrateController::kClearRunsToStepUp * 10, 0), 1);
+  ASSERT_EQ(controller_.step, A2dpBitrateController::kNumSteps);
+}
+
+}  // namespace testing
+}  // namespace bluetooth
@@ -0,0 +1,342 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <malloc.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/init_flags.h"
+#include "osi/include/allocator.h"
+#include "osi/include/properties.h"
+#include "stack/include/a2dp_aac_constants.h"
+#include "stack/include/a2dp_codec_api.h"
+#include "stack/include/a2dp_constants.h"
+#include "stack/include/a2dp_sbc_constants.h"
+#include "stack/include/a2dp_vendor_aptx_constants.h"
+#include "stack/include/a2dp_vendor_aptx_hd_constants.h"
+#include "stack/include/a2dp_vendor_ldac_constants.h"
+#include "stack/include/a2dp_vendor_opus_constants.h"
+#include "stack/include/avdt_api.h"
+#include "stack/include/bt_hdr.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr uint16_t kPeerMtu = 1005;
+constexpr uint64_t kStreamStartUs = 1000 * 1000;
+constexpr double kToneHz = 1000.0;
+constexpr double kPi = 3.14159265358979323846;
+// Heap usage is sampled every that many ticks, mallinfo() is not free
+constexpr size_t kHeapSampleTicks = 64;
+
+#define VENDOR_ID_BYTES(id)                                  \
+  ((id)&0xFF), (((id) >> 8) & 0xFF), (((id) >> 16) & 0xFF), \
+      (((id) >> 24) & 0xFF)
+#define CODEC_ID_BYTES(id) ((id)&0xFF), (((id) >> 8) & 0xFF)
+
+// Capabilities of the peer sink for each benchmarked configuration. The local
+// source codecs select the configuration from them, as during the AVDTP
+// negotiation.
+constexpr uint8_t kSbc44JointStereo[AVDT_CODEC_SIZE] = {
+    A2DP_SBC_INFO_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_SBC,
+    A2DP_SBC_IE_SAMP_FREQ_44 | A2DP_SBC_IE_CH_MD_JOINT,
+    A2DP_SBC_IE_BLOCKS_16 | A2DP_SBC_IE_SUBBAND_8 | A2DP_SBC_IE_ALLOC_MD_L,
+    A2DP_SBC_IE_MIN_BITPOOL,
+    53};
+constexpr uint8_t kSbc48Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_SBC_INFO_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_SBC,
+    A2DP_SBC_IE_SAMP_FREQ_48 | A2DP_SBC_IE_CH_MD_STEREO,
+    A2DP_SBC_IE_BLOCKS_16 | A2DP_SBC_IE_SUBBAND_8 | A2DP_SBC_IE_ALLOC_MD_L,
+    A2DP_SBC_IE_MIN_BITPOOL,
+    51};
+// Constant bit rate of 320 kbps
+constexpr uint8_t kAac44Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_AAC_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_AAC,
+    A2DP_AAC_OBJECT_TYPE_MPEG2_LC,
+    A2DP_AAC_SAMPLING_FREQ_44100,
+    A2DP_AAC_CHANNEL_MODE_STEREO,
+    A2DP_AAC_VARIABLE_BIT_RATE_DISABLED | 0x04,
+    0xe2,
+    0x00};
+constexpr uint8_t kAac48Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_AAC_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_AAC,
+    A2DP_AAC_OBJECT_TYPE_MPEG2_LC,
+    0x00,
+    (A2DP_AAC_SAMPLING_FREQ_48000 >> 8) | A2DP_AAC_CHANNEL_MODE_STEREO,
+    A2DP_AAC_VARIABLE_BIT_RATE_DISABLED | 0x04,
+    0xe2,
+    0x00};
+constexpr uint8_t kAptx44Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_APTX_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_APTX_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_APTX_CODEC_ID_BLUETOOTH),
+    A2DP_APTX_SAMPLERATE_44100 | A2DP_APTX_CHANNELS_STEREO};
+constexpr uint8_t kAptx48Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_APTX_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_APTX_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_APTX_CODEC_ID_BLUETOOTH),
+    A2DP_APTX_SAMPLERATE_48000 | A2DP_APTX_CHANNELS_STEREO};
+constexpr uint8_t kAptxHd44Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_APTX_HD_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_APTX_HD_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_APTX_HD_CODEC_ID_BLUETOOTH),
+    A2DP_APTX_HD_SAMPLERATE_44100 | A2DP_APTX_HD_CHANNELS_STEREO,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED0,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED1,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED2,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED3};
+constexpr uint8_t kAptxHd48Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_APTX_HD_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_APTX_HD_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_APTX_HD_CODEC_ID_BLUETOOTH),
+    A2DP_APTX_HD_SAMPLERATE_48000 | A2DP_APTX_HD_CHANNELS_STEREO,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED0,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED1,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED2,
+    A2DP_APTX_HD_ACL_SPRINT_RESERVED3};
+constexpr uint8_t kLdac44Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_LDAC_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_LDAC_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_LDAC_CODEC_ID),
+    A2DP_LDAC_SAMPLING_FREQ_44100,
+    A2DP_LDAC_CHANNEL_MODE_STEREO};
+constexpr uint8_t kLdac96Stereo[AVDT_CODEC_SIZE] = {
+    A2DP_LDAC_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_LDAC_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_LDAC_CODEC_ID),
+    A2DP_LDAC_SAMPLING_FREQ_96000,
+    A2DP_LDAC_CHANNEL_MODE_STEREO};
+constexpr uint8_t kOpus48Stereo20Ms[AVDT_CODEC_SIZE] = {
+    A2DP_OPUS_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_OPUS_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_OPUS_CODEC_ID),
+    A2DP_OPUS_CHANNEL_MODE_STEREO | A2DP_OPUS_20MS_FRAMESIZE |
+        A2DP_OPUS_SAMPLING_FREQ_48000};
+constexpr uint8_t kOpus48Stereo10Ms[AVDT_CODEC_SIZE] = {
+    A2DP_OPUS_CODEC_LEN,
+    AVDT_MEDIA_TYPE_AUDIO << 4,
+    A2DP_MEDIA_CT_NON_A2DP,
+    VENDOR_ID_BYTES(A2DP_OPUS_VENDOR_ID),
+    CODEC_ID_BYTES(A2DP_OPUS_CODEC_ID),
+    A2DP_OPUS_CHANNEL_MODE_STEREO | A2DP_OPUS_10MS_FRAMESIZE |
+        A2DP_OPUS_SAMPLING_FREQ_48000};
+
+// State of the synthetic audio source and of the fake AVDTP sink. The encoder
+// callbacks carry no context, as in btif_a2dp_source.cc.
+struct {
+  std::vector<uint8_t> pcm;
+  size_t pcm_offset;
+  uint64_t pcm_bytes_per_second;
+  uint64_t pcm_bytes_sent;
+  uint64_t now_us;
+  uint64_t encoded_bytes;
+  uint64_t packets;
+  // Delay between the end of the audio of each packet and the tick that sent
+  // it, counted from the first tick
+  std::vector<double> lag_ms;
+} bench_cb;
+
+// One second of a stereo or mono tone in the PCM format of the codec, looped
+std::vector<uint8_t> MakeTone(int sample_rate, int bits_per_sample,
+                              int channels) {
+  size_t bytes_per_sample = bits_per_sample / 8;
+  std::vector<uint8_t> pcm(sample_rate * channels * bytes_per_sample);
+  double amplitude = std::ldexp(0.5, bits_per_sample - 1);
+  for (int i = 0; i < sample_rate; i++) {
+    int32_t value = static_cast<int32_t>(
+        amplitude * std::sin(2 * kPi * kToneHz * i / sample_rate));
+    for (int channel = 0; channel < channels; channel++) {
+      size_t offset = (i * channels + channel) * bytes_per_sample;
+      for (size_t byte = 0; byte < bytes_per_sample; byte++) {
+        pcm[offset + byte] = static_cast<uint8_t>(value >> (8 * byte));
+      }
+    }
+  }
+  return pcm;
+}
+
+// The audio HAL always has data: the benchmark measures the encoder, not
+// underflows
+uint32_t ReadCallback(uint8_t* p_buf, uint32_t len) {
+  for (uint32_t copied = 0; copied < len;) {
+    uint32_t chunk = std::min<size_t>(
+        len - copied, bench_cb.pcm.size() - bench_cb.pcm_offset);
+    memcpy(p_buf + copied, bench_cb.pcm.data() + bench_cb.pcm_offset, chunk);
+    copied += chunk;
+    bench_cb.pcm_offset = (bench_cb.pcm_offset + chunk) % bench_cb.pcm.size();
+  }
+  return len;
+}
+
+// Fake AVDTP sink: the link keeps up, every packet is sent as it is enqueued
+bool EnqueueCallback(BT_HDR* p_buf, size_t /* frames_n */,
+                     uint32_t num_bytes) {
+  bench_cb.pcm_bytes_sent += num_bytes;
+  double audio_ms =
+      1000.0 * bench_cb.pcm_bytes_sent / bench_cb.pcm_bytes_per_second;
+  bench_cb.lag_ms.push_back((bench_cb.now_us - kStreamStartUs) / 1000.0 -
+                            audio_ms);
+  bench_cb.encoded_bytes += p_buf->len;
+  bench_cb.packets++;
+  osi_free(p_buf);
+  return true;
+}
+
+size_t HeapInUse() { return mallinfo().uordblks; }
+
+std::chrono::nanoseconds ThreadCpuTime() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+double Percentile(std::vector<double>& values, double fraction) {
+  if (values.empty()) return 0;
+  size_t index = static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+// Run the encoder negotiated from |peer_sink_capability| once per iteration,
+// as the media tick of btif_a2dp_source.cc does, with a virtual clock so that
+// the ticks follow each other as fast as the encoder allows.
+void BM_A2dpEncode(State& state, const uint8_t* peer_sink_capability) {
+  bluetooth::common::InitFlags::SetAllForTesting();
+  osi_property_set("persist.bluetooth.opus.enabled", "true");
+  A2dpCodecs a2dp_codecs(std::vector<btav_a2dp_codec_config_t>{});
+  uint8_t codec_info[AVDT_CODEC_SIZE];
+  if (!a2dp_codecs.init() ||
+      !a2dp_codecs.setCodecConfig(peer_sink_capability, true, codec_info,
+                                  true)) {
+    state.SkipWithError("The codec configuration is not supported");
+    return;
+  }
+  A2dpCodecConfig* codec_config = a2dp_codecs.getCurrentCodecConfig();
+  const tA2DP_ENCODER_INTERFACE* encoder =
+      A2DP_GetEncoderInterface(codec_info);
+  if (codec_config == nullptr || encoder == nullptr) {
+    state.SkipWithError("The codec has no software encoder");
+    return;
+  }
+  state.SetLabel(codec_config->name());
+
+  int sample_rate = A2DP_GetTrackSampleRate(codec_info);
+  int channels = A2DP_GetTrackChannelCount(codec_info);
+  int bits_per_sample = codec_config->getAudioBitsPerSample();
+  bench_cb.pcm = MakeTone(sample_rate, bits_per_sample, channels);
+  bench_cb.pcm_offset = 0;
+  bench_cb.pcm_bytes_per_second = bench_cb.pcm.size();
+  bench_cb.pcm_bytes_sent = 0;
+  bench_cb.now_us = kStreamStartUs;
+  bench_cb.encoded_bytes = 0;
+  bench_cb.packets = 0;
+  bench_cb.lag_ms.clear();
+  bench_cb.lag_ms.reserve(state.max_iterations);
+
+  size_t heap_before = HeapInUse();
+  size_t peak_heap = 0;
+  tA2DP_ENCODER_INIT_PEER_PARAMS peer_params = {true, true, kPeerMtu};
+  encoder->encoder_init(&peer_params, codec_config, ReadCallback,
+                        EnqueueCallback);
+  encoder->feeding_reset();
+  uint64_t interval_us = encoder->get_encoder_interval_ms() * 1000;
+  std::vector<double> tick_us;
+  tick_us.reserve(state.max_iterations);
+
+  auto cpu_start = ThreadCpuTime();
+  size_t ticks = 0;
+  for (auto _ : state) {
+    if (encoder->set_transmit_queue_length != nullptr) {
+      encoder->set_transmit_queue_length(0);
+    }
+    auto tick_start = std::chrono::steady_clock::now();
+    encoder->send_frames(bench_cb.now_us);
+    tick_us.push_back(std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - tick_start)
+                          .count());
+    bench_cb.now_us += interval_us;
+    if (ticks++ % kHeapSampleTicks == 0) {
+      peak_heap = std::max(peak_heap, HeapInUse() - heap_before);
+    }
+  }
+  auto cpu_time = ThreadCpuTime() - cpu_start;
+  peak_heap = std::max(peak_heap, HeapInUse() - heap_before);
+  encoder->encoder_cleanup();
+
+  double audio_seconds = static_cast<double>(bench_cb.pcm_bytes_sent) /
+                         bench_cb.pcm_bytes_per_second;
+  if (audio_seconds > 0) {
+    state.counters["cpu_ms_per_audio_s"] =
+        std::chrono::duration<double, std::milli>(cpu_time).count() /
+        audio_seconds;
+    state.counters["kbps"] = bench_cb.encoded_bytes * 8 / audio_seconds / 1000;
+  }
+  state.counters["peak_heap_kB"] = peak_heap / 1024.0;
+  state.counters["tick_p50_us"] = Percentile(tick_us, 0.50);
+  state.counters["tick_p99_us"] = Percentile(tick_us, 0.99);
+  // Spread of the packet timing, a steady encoder stays within one frame
+  state.counters["jitter_ms"] = Percentile(bench_cb.lag_ms, 0.99) -
+                                Percentile(bench_cb.lag_ms, 0.01);
+  state.SetItemsProcessed(bench_cb.packets);
+  state.SetBytesProcessed(bench_cb.pcm_bytes_sent);
+}
+
+BENCHMARK_CAPTURE(BM_A2dpEncode, sbc_44k_joint_stereo, kSbc44JointStereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, sbc_48k_stereo, kSbc48Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, aac_44k_320kbps, kAac44Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, aac_48k_320kbps, kAac48Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, aptx_44k, kAptx44Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, aptx_48k, kAptx48Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, aptx_hd_44k, kAptxHd44Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, aptx_hd_48k, kAptxHd48Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, ldac_44k, kLdac44Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, ldac_96k, kLdac96Stereo);
+BENCHMARK_CAPTURE(BM_A2dpEncode, opus_48k_20ms, kOpus48Stereo20Ms);
+BENCHMARK_CAPTURE(BM_A2dpEncode, opus_48k_10ms, kOpus48Stereo10Ms);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <future>
 #include <string>
+#include <vector>
 
 #include "common/init_flags.h"
 #include "common/time_util.h"
@@ -191,6 +192,42 @@ TEST_F(A2dpSbcTest, a2dp_enqueue_cb_is_invoked) {
   promise.get_future().wait();
 }
 
+TEST_F(A2dpSbcTest, a2dp_source_reads_in_place) {
+  promise = {};
+  static uint32_t consumed_bytes;
+  consumed_bytes = 0;
+  auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t {
+    ADD_FAILURE() << "The audio data should not be copied";
+    return 0;
+  };
+  auto peek_cb = +[](const uint8_t** p_buf, uint32_t len) -> uint32_t {
+    alignas(int16_t) static const uint8_t pcm[kSbcReadSize] = {};
+    log::assert_that(kSbcReadSize == len, "assert failed: kSbcReadSize == len");
+    *p_buf = pcm;
+    return len;
+  };
+  auto consume_cb = +[](uint32_t len) { consumed_bytes += len; };
+  auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+    static bool first_invocation = true;
+    if (first_invocation) {
+      promise.set_value();
+    }
+    first_invocation = false;
+    osi_free(p_buf);
+    return false;
+  };
+  InitializeEncoder(true, read_cb, enqueue_cb);
+  encoder_iface_->set_in_place_read_callbacks(peek_cb, consume_cb);
+  uint64_t timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+  usleep(kA2dpTickUs);
+  timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+  promise.get_future().wait();
+  ASSERT_GT(consumed_bytes, 0u);
+  ASSERT_EQ(consumed_bytes % kSbcReadSize, 0u);
+}
+
 TEST_F(A2dpSbcTest, decoded_data_cb_not_invoked_when_empty_packet) {
   auto data_cb = +[](uint8_t* p_buf, uint32_t len) { FAIL(); };
   InitializeDecoder(data_cb);
@@ -237,6 +274,70 @@ TEST_F(A2dpSbcTest, decoded_data_cb_invoked) {
   osi_free(packet);
 }
 
+TEST_F(A2dpSbcTest, decoded_data_cb_not_invoked_when_nothing_to_conceal) {
+  auto data_cb = +[](uint8_t* p_buf, uint32_t len) { FAIL(); };
+  InitializeDecoder(data_cb);
+  decoder_iface_->decoder_conceal_packets(2);
+}
+
+static std::vector<int16_t> decoded_samples;
+static size_t decoded_count = 0;
+
+TEST_F(A2dpSbcTest, decoded_data_concealed_by_fading_last_packet) {
+  promise = {};
+  decoded_samples.clear();
+  decoded_count = 0;
+  auto data_cb = +[](uint8_t* p_buf, uint32_t len) {
+    const int16_t* samples = reinterpret_cast<const int16_t*>(p_buf);
+    size_t num_samples = len / sizeof(int16_t);
+    if (decoded_count > 0) {
+      ASSERT_EQ(num_samples, decoded_samples.size());
+      for (size_t i = 0; i < num_samples; i++) {
+        ASSERT_EQ(samples[i], decoded_samples[i] / 2);
+      }
+    }
+    decoded_samples.assign(samples, samples + num_samples);
+    decoded_count++;
+  };
+  InitializeDecoder(data_cb);
+
+  auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t {
+    static uint32_t counter = 0;
+    memcpy(p_buf, wav_reader.GetSamples() + counter, len);
+    counter += len;
+    return len;
+  };
+  auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+    static bool first_invocation = true;
+    if (first_invocation) {
+      packet = reinterpret_cast<BT_HDR*>(
+          osi_malloc(sizeof(*p_buf) + p_buf->len + 1));
+      memcpy(packet, p_buf, sizeof(*p_buf));
+      packet->offset = 0;
+      memcpy(packet->data + 1, p_buf->data + p_buf->offset, p_buf->len);
+      packet->data[0] = frames_n;
+      p_buf->len += 1;
+      promise.set_value();
+    }
+    first_invocation = false;
+    osi_free(p_buf);
+    return false;
+  };
+  InitializeEncoder(true, read_cb, enqueue_cb);
+
+  uint64_t timestamp_us = bluetooth::common::time_gettimeofday_us();
+  encoder_iface_->send_frames(timestamp_us);
+
+  promise.get_future().wait();
+  ASSERT_TRUE(decoder_iface_->decode_packet(packet));
+  osi_free(packet);
+  ASSERT_EQ(decoded_count, 1u);
+  ASSERT_FALSE(decoded_samples.empty());
+
+  decoder_iface_->decoder_conceal_packets(3);
+  ASSERT_EQ(decoded_count, 4u);
+}
+
 TEST_F(A2dpSbcTest, set_source_codec_config_works) {
   uint8_t codec_info_result[AVDT_CODEC_SIZE];
   ASSERT_TRUE(a2dp_codecs_->setCodecConfig(kCodecInfoSbcCapability, true, codec_info_result, true));
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "advertise_data_parser.h"
+#include "benchmark/benchmark.h"
+#include "discovery/device/eir_test_data_packets.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// Types looked up for every inquiry or advertising report: flags, complete
+// and shortened name, appearance, 16 bit service UUIDs and RSI.
+constexpr uint8_t kLookedUpTypes[] = {0x01, 0x09, 0x08, 0x19, 0x03, 0x2e};
+constexpr uint8_t kServiceDataType = 0x16;
+
+std::vector<std::vector<uint8_t>> EirCorpus() {
+  std::vector<std::vector<uint8_t>> corpus;
+  for (const unsigned char* pkt : data_packets) {
+    corpus.emplace_back(&pkt[kEirOffset], &pkt[kEirOffset] + kEirSize);
+  }
+  return corpus;
+}
+
+// Look every type up with a walk of the report each.
+void BM_GetFieldByType(State& state) {
+  const auto corpus = EirCorpus();
+  for (auto _ : state) {
+    for (const auto& eir : corpus) {
+      uint8_t len;
+      for (uint8_t type : kLookedUpTypes) {
+        benchmark::DoNotOptimize(
+            AdvertiseDataParser::GetFieldByType(eir, type, &len));
+      }
+      const uint8_t* p_service_data = eir.data();
+      uint8_t service_data_len = 0;
+      while ((p_service_data = AdvertiseDataParser::GetFieldByType(
+                  p_service_data + service_data_len,
+                  eir.size() - (p_service_data - eir.data()) - service_data_len,
+                  kServiceDataType, &service_data_len))) {
+        benchmark::DoNotOptimize(p_service_data);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * corpus.size());
+}
+BENCHMARK(BM_GetFieldByType);
+
+// Index the report once and do all the lookups on the index.
+void BM_AdvertiseDataIndex(State& state) {
+  const auto corpus = EirCorpus();
+  for (auto _ : state) {
+    for (const auto& eir : corpus) {
+      const AdvertiseDataIndex index(eir);
+      uint8_t len;
+      for (uint8_t type : kLookedUpTypes) {
+        benchmark::DoNotOptimize(index.GetFieldByType(type, &len));
+      }
+      index.ForEachFieldOfType(kServiceDataType,
+                               [](const uint8_t* p_service_data, uint8_t) {
+                                 benchmark::DoNotOptimize(p_service_data);
+                                 return true;
+                               });
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * corpus.size());
+}
+BENCHMARK(BM_AdvertiseDataIndex);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -210,4 +210,63 @@ TEST(AdvertiseDataParserTest, GetFieldByTypeInLoop) {
     match_no++;
   }
   EXPECT_EQ(match_no, 3);
-}
\ No newline at end of file
+}
+TEST(AdvertiseDataIndexTest, MatchesGetFieldByType) {
+  const std::vector<uint8_t> data0{
+    0x02, 0x01, 0x02,
+    0x07, 0x2e, 0x6a, 0xc1, 0x19, 0x52, 0x1e, 0x49,
+    0x09, 0x16, 0x4e, 0x18, 0x00, 0xff, 0x0f, 0x03, 0x00, 0x00,
+    0x02, 0x0a, 0x7f,
+    0x03, 0x16, 0x4f, 0x18,
+    0x04, 0x16, 0x53, 0x18, 0x00,
+    0x0f, 0x09, 0x48, 0x5f, 0x43, 0x33, 0x45, 0x41, 0x31, 0x36, 0x33, 0x46, 0x35, 0x36, 0x34, 0x46 };
+  // Truncated last field, the walk stops before it.
+  const std::vector<uint8_t> data1{0x02, 0x01, 0x02, 0x05, 0x09, 0x41};
+  // Zero padding, the walk stops at the first zero length.
+  const std::vector<uint8_t> data2{0x02, 0x01, 0x02, 0x00, 0x02, 0x0a, 0x7f};
+
+  for (const auto& data : {data0, data1, data2}) {
+    AdvertiseDataIndex index(data);
+    for (int type = 0; type <= 0xff; type++) {
+      uint8_t expected_len = 0xff;
+      uint8_t len = 0xff;
+      const uint8_t* expected = AdvertiseDataParser::GetFieldByType(
+          data, static_cast<uint8_t>(type), &expected_len);
+      EXPECT_EQ(expected,
+                index.GetFieldByType(static_cast<uint8_t>(type), &len));
+      EXPECT_EQ(expected_len, len);
+      EXPECT_EQ(expected != nullptr,
+                index.HasField(static_cast<uint8_t>(type)));
+    }
+  }
+
+  AdvertiseDataIndex empty(data2.data(), 0);
+  EXPECT_TRUE(empty.IsEmpty());
+}
+
+TEST(AdvertiseDataIndexTest, ForEachFieldOfType) {
+  const uint8_t AD_TYPE_SVC_DATA = 0x16;
+  const std::vector<uint8_t> data0{
+    0x02, 0x01, 0x02,
+    0x09, 0x16, 0x4e, 0x18, 0x00, 0xff, 0x0f, 0x03, 0x00, 0x00,
+    0x03, 0x16, 0x4f, 0x18,
+    0x04, 0x16, 0x53, 0x18, 0x00 };
+  AdvertiseDataIndex index(data0);
+
+  std::vector<std::pair<long, uint8_t>> fields;
+  index.ForEachFieldOfType(AD_TYPE_SVC_DATA,
+                           [&](const uint8_t* p_data, uint8_t len) {
+                             fields.emplace_back(p_data - data0.data(), len);
+                             return true;
+                           });
+  EXPECT_EQ(fields, (std::vector<std::pair<long, uint8_t>>{
+                        {5, 8}, {15, 2}, {19, 3}}));
+
+  // Returning false stops the iteration.
+  int calls = 0;
+  index.ForEachFieldOfType(AD_TYPE_SVC_DATA, [&](const uint8_t*, uint8_t) {
+    calls++;
+    return false;
+  });
+  EXPECT_EQ(calls, 1);
+}
@@ -524,6 +524,60 @@ TEST_F(ScoHciSwbWithInitCleanTest, SwbEncode) {
   ASSERT_EQ(bluetooth::audio::sco::swb::encode(data, sizeof(data)), size_t(0));
 }
 
+TEST_F(ScoHciWbsWithInitCleanTest, WbsFrameTimeStats) {
+  int16_t data[120] = {0};
+  const uint8_t* encoded = nullptr;
+  const uint8_t* decoded = nullptr;
+  tBTM_SCO_FRAME_TIME_STATS decode_time, encode_time;
+
+  // Return false if arguments are invalid or no frame was processed yet
+  ASSERT_FALSE(bluetooth::audio::sco::wbs::fill_frame_time_stats(nullptr,
+                                                                 nullptr));
+  ASSERT_FALSE(bluetooth::audio::sco::wbs::fill_frame_time_stats(
+      &decode_time, &encode_time));
+
+  ASSERT_EQ(bluetooth::audio::sco::wbs::encode(data, sizeof(data)),
+            sizeof(data));
+  ASSERT_EQ(bluetooth::audio::sco::wbs::dequeue_packet(&encoded), size_t(60));
+  ASSERT_TRUE(bluetooth::audio::sco::wbs::enqueue_packet(
+      std::vector<uint8_t>(encoded, encoded + 60), false));
+  ASSERT_EQ(bluetooth::audio::sco::wbs::decode(&decoded),
+            size_t(BTM_MSBC_CODE_SIZE));
+
+  ASSERT_TRUE(bluetooth::audio::sco::wbs::fill_frame_time_stats(&decode_time,
+                                                                &encode_time));
+  ASSERT_EQ(decode_time.num_frames, size_t(1));
+  ASSERT_EQ(encode_time.num_frames, size_t(1));
+  ASSERT_EQ(decode_time.average_us(), decode_time.max_us);
+  ASSERT_EQ(encode_time.average_us(), encode_time.max_us);
+}
+
+TEST_F(ScoHciSwbWithInitCleanTest, SwbFrameTimeStats) {
+  int16_t data[BTM_LC3_CODE_SIZE / 2] = {0};
+  const uint8_t* encoded = nullptr;
+  const uint8_t* decoded = nullptr;
+  tBTM_SCO_FRAME_TIME_STATS decode_time, encode_time;
+
+  // Return false if arguments are invalid or no frame was processed yet
+  ASSERT_FALSE(bluetooth::audio::sco::swb::fill_frame_time_stats(nullptr,
+                                                                 nullptr));
+  ASSERT_FALSE(bluetooth::audio::sco::swb::fill_frame_time_stats(
+      &decode_time, &encode_time));
+
+  ASSERT_EQ(bluetooth::audio::sco::swb::encode(data, sizeof(data)),
+            sizeof(data));
+  ASSERT_EQ(bluetooth::audio::sco::swb::dequeue_packet(&encoded), size_t(60));
+  ASSERT_TRUE(bluetooth::audio::sco::swb::enqueue_packet(
+      std::vector<uint8_t>(encoded, encoded + 60), false));
+  ASSERT_EQ(bluetooth::audio::sco::swb::decode(&decoded),
+            size_t(BTM_LC3_CODE_SIZE));
+
+  ASSERT_TRUE(bluetooth::audio::sco::swb::fill_frame_time_stats(&decode_time,
+                                                                &encode_time));
+  ASSERT_EQ(decode_time.num_frames, size_t(1));
+  ASSERT_EQ(encode_time.num_frames, size_t(1));
+}
+
 TEST_F(ScoHciWbsTest, WbsDequeuePacketWithoutInit) {
   const uint8_t* encoded = nullptr;
   // Return 0 if buffer is uninitialized
@@ -41,3 +41,25 @@ TEST_F(StackBtmDevTest, btm_sec_allocate_dev_rec__with_list) {
   ASSERT_NE(nullptr, btm_sec_allocate_dev_rec());
   ::btm_sec_cb.Free();
 }
+
+TEST_F(StackBtmDevTest, btm_sec_allocate_dev_rec__evicts_oldest_non_bonded) {
+  ::btm_sec_cb.Init(BTM_SEC_MODE_SC);
+
+  tBTM_SEC_DEV_REC* p_bonded = btm_sec_allocate_dev_rec();
+  p_bonded->sec_rec.sec_flags |= BTM_SEC_LINK_KEY_KNOWN;
+  tBTM_SEC_DEV_REC* p_transient = btm_sec_allocate_dev_rec();
+  for (int i = 2; i <= BTM_SEC_MAX_DEVICE_RECORDS; i++) {
+    ASSERT_NE(nullptr, btm_sec_allocate_dev_rec());
+  }
+  ASSERT_EQ(0u, ::btm_sec_cb.dev_rec_evictions);
+
+  ASSERT_NE(nullptr, btm_sec_allocate_dev_rec());
+  ASSERT_EQ(1u, ::btm_sec_cb.dev_rec_evictions);
+  ASSERT_EQ(0u, ::btm_sec_cb.bonded_dev_rec_evictions);
+  ASSERT_TRUE(list_contains(::btm_sec_cb.sec_dev_rec, p_bonded));
+  ASSERT_FALSE(list_contains(::btm_sec_cb.sec_dev_rec, p_transient));
+  ASSERT_EQ(list_length(::btm_sec_cb.sec_dev_rec),
+            ::btm_sec_cb.dev_rec_by_age.size());
+
+  ::btm_sec_cb.Free();
+}
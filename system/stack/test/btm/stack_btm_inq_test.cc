@@ -29,6 +29,18 @@
 
 extern tBTM_CB btm_cb;
 
+namespace bluetooth {
+namespace legacy {
+namespace testing {
+void btm_clr_inq_db(const RawAddress* p_bda);
+void btm_scan_policy_adjust(bool le_scan_active, unsigned le_links,
+                            unsigned br_edr_links, bool reconnect_expected,
+                            bool page_scan, uint16_t* interval,
+                            uint16_t* window);
+}  // namespace testing
+}  // namespace legacy
+}  // namespace bluetooth
+
 namespace {
 const RawAddress kRawAddress = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
 const RawAddress kRawAddress2 =
@@ -142,3 +154,92 @@ TEST_F(BtmInqActiveTest, btm_process_remote_name__different_address) {
 
   ASSERT_FALSE(gBTM_REMOTE_DEV_NAME_sent);
 }
+
+class BtmInqDbTest : public BtmInqTest {
+ protected:
+  void SetUp() override {
+    BtmInqTest::SetUp();
+    bluetooth::legacy::testing::btm_clr_inq_db(nullptr);
+  }
+
+  void TearDown() override {
+    bluetooth::legacy::testing::btm_clr_inq_db(nullptr);
+    BtmInqTest::TearDown();
+  }
+};
+
+TEST_F(BtmInqDbTest, btm_inq_db_find) {
+  ASSERT_EQ(nullptr, btm_inq_db_find(kRawAddress));
+
+  tINQ_DB_ENT* ent = btm_inq_db_new(kRawAddress, false);
+  tINQ_DB_ENT* ent2 = btm_inq_db_new(kRawAddress2, true);
+  ASSERT_EQ(ent, btm_inq_db_find(kRawAddress));
+  ASSERT_EQ(ent2, btm_inq_db_find(kRawAddress2));
+
+  bluetooth::legacy::testing::btm_clr_inq_db(&kRawAddress);
+  ASSERT_EQ(nullptr, btm_inq_db_find(kRawAddress));
+  ASSERT_EQ(ent2, btm_inq_db_find(kRawAddress2));
+
+  bluetooth::legacy::testing::btm_clr_inq_db(nullptr);
+  ASSERT_EQ(nullptr, btm_inq_db_find(kRawAddress2));
+}
+
+TEST_F(BtmInqDbTest, btm_inq_db_new__oldest_entry_is_replaced) {
+  // Fill the classic half of the database, the first entry is the oldest
+  for (uint8_t i = 0; i < BTM_INQ_DB_SIZE / 2; i++) {
+    RawAddress bda({0x11, 0x22, 0x33, 0x44, 0x00, i});
+    tINQ_DB_ENT* ent = btm_inq_db_new(bda, false);
+    ent->time_of_resp = i + 1;
+  }
+
+  tINQ_DB_ENT* ent = btm_inq_db_new(kRawAddress, false);
+
+  ASSERT_EQ(nullptr,
+            btm_inq_db_find(RawAddress({0x11, 0x22, 0x33, 0x44, 0x00, 0x00})));
+  ASSERT_NE(nullptr,
+            btm_inq_db_find(RawAddress({0x11, 0x22, 0x33, 0x44, 0x00, 0x01})));
+  ASSERT_EQ(ent, btm_inq_db_find(kRawAddress));
+}
+
+TEST_F(BtmInqTest, btm_scan_policy_adjust) {
+  using bluetooth::legacy::testing::btm_scan_policy_adjust;
+  uint16_t interval;
+  uint16_t window;
+
+  // Expected reconnect doubles the page scan duty cycle
+  interval = 0x0400, window = 0x0012;
+  btm_scan_policy_adjust(false, 0, 1, true, true, &interval, &window);
+  ASSERT_EQ(0x0200, interval);
+  ASSERT_EQ(0x0024, window);
+
+  // It leaves inquiry scan alone
+  interval = 0x0800, window = 0x0012;
+  btm_scan_policy_adjust(false, 0, 1, true, false, &interval, &window);
+  ASSERT_EQ(0x0800, interval);
+  ASSERT_EQ(0x0012, window);
+
+  // LE load widens the window, never beyond the interval
+  interval = 0x0400, window = 0x0012;
+  btm_scan_policy_adjust(true, 0, 1, false, true, &interval, &window);
+  ASSERT_EQ(0x0400, interval);
+  ASSERT_EQ(0x0024, window);
+  interval = 0x0020, window = 0x0012;
+  btm_scan_policy_adjust(false, 2, 0, false, true, &interval, &window);
+  ASSERT_EQ(0x0020, interval);
+  ASSERT_EQ(0x0020, window);
+
+  // Idle radio stretches the interval up to the spec default
+  interval = 0x0400, window = 0x0012;
+  btm_scan_policy_adjust(false, 0, 0, false, true, &interval, &window);
+  ASSERT_EQ(0x0800, interval);
+  ASSERT_EQ(0x0012, window);
+  interval = 0x0800, window = 0x0012;
+  btm_scan_policy_adjust(false, 0, 0, false, true, &interval, &window);
+  ASSERT_EQ(0x0800, interval);
+
+  // A single link with no LE activity keeps the configured parameters
+  interval = 0x0400, window = 0x0012;
+  btm_scan_policy_adjust(false, 1, 0, false, true, &interval, &window);
+  ASSERT_EQ(0x0400, interval);
+  ASSERT_EQ(0x0012, window);
+}
@@ -309,3 +309,28 @@ TEST_F(StackBtmSecWithInitFreeTest, btm_sec_rmt_name_request_complete) {
   }
   ASSERT_EQ(8U, history.size());
 }
+
+TEST_F(StackBtmSecWithInitFreeTest, find_first_serv_rec_follows_services) {
+  constexpr uint16_t kPsm = 0x1001;
+  constexpr uint8_t kFirstServiceId = 40;
+  constexpr uint8_t kSecondServiceId = 41;
+
+  ASSERT_EQ(btm_sec_cb.find_first_serv_rec(false, kPsm), nullptr);
+
+  ASSERT_TRUE(btm_sec_cb.AddService(false, "first", kFirstServiceId,
+                                    BTM_SEC_IN_AUTHENTICATE, kPsm, 0, 0));
+  ASSERT_TRUE(btm_sec_cb.AddService(false, "second", kSecondServiceId,
+                                    BTM_SEC_IN_ENCRYPT, kPsm, 0, 0));
+  tBTM_SEC_SERV_REC* p_serv_rec = btm_sec_cb.find_first_serv_rec(false, kPsm);
+  ASSERT_NE(p_serv_rec, nullptr);
+  ASSERT_EQ(p_serv_rec->service_id, kFirstServiceId);
+
+  // The next record with the PSM takes over
+  ASSERT_EQ(btm_sec_cb.RemoveServiceById(kFirstServiceId), 1);
+  p_serv_rec = btm_sec_cb.find_first_serv_rec(false, kPsm);
+  ASSERT_NE(p_serv_rec, nullptr);
+  ASSERT_EQ(p_serv_rec->service_id, kSecondServiceId);
+
+  ASSERT_EQ(btm_sec_cb.RemoveServiceByPsm(kPsm), 1);
+  ASSERT_EQ(btm_sec_cb.find_first_serv_rec(false, kPsm), nullptr);
+}
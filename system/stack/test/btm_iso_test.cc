@@ -17,6 +17,8 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "btm_iso_api.h"
 #include "hci/controller_interface_mock.h"
@@ -38,6 +40,7 @@ using testing::AnyNumber;
 using testing::AtLeast;
 using testing::Eq;
 using testing::Matcher;
+using testing::Mock;
 using testing::Return;
 using testing::SaveArg;
 using testing::StrictMock;
@@ -2217,18 +2220,23 @@ TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
       volatile_test_cig_create_cmpl_evt_.conn_handles[0],
       kDefaultIsoDataPathParams);
 
-  /* Try sending twice as much data as we can ignoring the credit limits and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
+  /* Try sending twice as much data as we have credits for, and expect the
+   * redundant packets to be queued and not propagated down to the HCI.
    */
-  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_cig_create_cmpl_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
+
+  // Return all credits for this one handle, the queued packets go down
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(
+      volatile_test_cig_create_cmpl_evt_.conn_handles[0], num_buffers);
+  Mock::VerifyAndClearExpectations(&iso_interface_);
 
-  // Return all credits for this one handle
   IsoManager::GetInstance()->HandleNumComplDataPkts(
       volatile_test_cig_create_cmpl_evt_.conn_handles[0], num_buffers);
 
@@ -2238,9 +2246,8 @@ TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
   IsoManager::GetInstance()->SetupIsoDataPath(
       volatile_test_big_params_evt_.conn_handles[0], kDefaultIsoDataPathParams);
 
-  /* Try sending twice as much data as we can ignoring the credit limits and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
+  /* Try sending twice as much data as we have credits for, and expect the
+   * redundant packets to be queued and not propagated down to the HCI.
    */
   EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
   for (uint8_t i = 0; i < (2 * num_buffers); i++) {
@@ -2248,6 +2255,12 @@ TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
         volatile_test_big_params_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
+
+  // Return all credits for this one handle, the queued packets go down
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(
+      volatile_test_big_params_evt_.conn_handles[0], num_buffers);
 }
 
 TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
@@ -2269,28 +2282,27 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
       volatile_test_cig_create_cmpl_evt_.conn_handles[0],
       kDefaultIsoDataPathParams);
 
-  /* Try sending twice as much data as we can, ignoring the credits limit and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
-   */
-  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
-  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+  // Use all the credits
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (uint8_t i = 0; i < num_buffers; i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_cig_create_cmpl_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
 
   // Return all credits for this one handle
   IsoManager::GetInstance()->HandleNumComplDataPkts(
       volatile_test_cig_create_cmpl_evt_.conn_handles[0], num_buffers);
 
   // Expect some more events go down the HCI
-  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
-  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (uint8_t i = 0; i < num_buffers; i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_cig_create_cmpl_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
 
   // Return all credits for this one handle
   IsoManager::GetInstance()->HandleNumComplDataPkts(
@@ -2302,30 +2314,148 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
   IsoManager::GetInstance()->SetupIsoDataPath(
       volatile_test_big_params_evt_.conn_handles[0], kDefaultIsoDataPathParams);
 
-  /* Try sending twice as much data as we can, ignoring the credits limit and
-   * expect the redundant packets to be ignored and not propagated down to the
-   * HCI.
-   */
-  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
-  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+  // Use all the credits
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (uint8_t i = 0; i < num_buffers; i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_big_params_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
 
   // Return all credits for this one handle
   IsoManager::GetInstance()->HandleNumComplDataPkts(
       volatile_test_big_params_evt_.conn_handles[0], num_buffers);
 
   // Expect some more events go down the HCI
-  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
-  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (uint8_t i = 0; i < num_buffers; i++) {
     IsoManager::GetInstance()->SendIsoData(
         volatile_test_big_params_evt_.conn_handles[0], data_vec.data(),
         data_vec.size());
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoDataQueueBounded) {
+  uint8_t num_buffers =
+      controller_.GetControllerIsoBufferSize().total_num_le_packets_;
+  std::vector<uint8_t> data_vec(108, 0);
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->EstablishCis({{{handle, 1}}});
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  // Use all the credits, then queue more packets than the queue holds
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (int i = 0;
+       i < num_buffers + bluetooth::hci::iso_manager::kIsoTxQueueMaxSdus + 2;
+       i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+  }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
+
+  // Only the newest queued packets go down once the credits are back
+  EXPECT_CALL(iso_interface_, HciSend)
+      .Times(bluetooth::hci::iso_manager::kIsoTxQueueMaxSdus);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(handle, num_buffers);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(handle, num_buffers);
+}
+
+TEST_F(IsoManagerTest, SendIsoDataDeadlineMissDumped) {
+  uint8_t num_buffers =
+      controller_.GetControllerIsoBufferSize().total_num_le_packets_;
+  std::vector<uint8_t> data_vec(108, 0);
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->EstablishCis({{{handle, 1}}});
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  // The two packets pushed out of the full queue missed their deadline
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (int i = 0;
+       i < num_buffers + bluetooth::hci::iso_manager::kIsoTxQueueMaxSdus + 2;
+       i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+  }
+
+  int sv[2];
+  ASSERT_EQ(0, socketpair(AF_LOCAL, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+  IsoManager::GetInstance()->Dump(sv[0]);
+  close(sv[0]);
+
+  std::string dump;
+  char buf[1024];
+  ssize_t len;
+  while ((len = read(sv[1], buf, sizeof(buf))) > 0) dump.append(buf, len);
+  close(sv[1]);
+
+  ASSERT_NE(dump.find("TX Stats:"), std::string::npos);
+  ASSERT_NE(dump.find("Deadline miss (count): 2\n"), std::string::npos);
+}
+
+TEST_F(IsoManagerTest, SendIsoDataQueuedFairly) {
+  uint8_t num_buffers =
+      controller_.GetControllerIsoBufferSize().total_num_le_packets_;
+  std::vector<uint8_t> data_vec(108, 0);
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  auto handle_0 = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  auto handle_1 = volatile_test_cig_create_cmpl_evt_.conn_handles[1];
+  IsoManager::GetInstance()->SetupIsoDataPath(handle_0,
+                                              kDefaultIsoDataPathParams);
+  IsoManager::GetInstance()->SetupIsoDataPath(handle_1,
+                                              kDefaultIsoDataPathParams);
+
+  // Use all the credits on the first CIS, then queue packets on both
+  EXPECT_CALL(iso_interface_, HciSend).Times(num_buffers);
+  for (uint8_t i = 0; i < num_buffers; i++) {
+    IsoManager::GetInstance()->SendIsoData(handle_0, data_vec.data(),
+                                           data_vec.size());
+  }
+  for (uint8_t i = 0; i < 3; i++) {
+    IsoManager::GetInstance()->SendIsoData(handle_0, data_vec.data(),
+                                           data_vec.size());
+    IsoManager::GetInstance()->SendIsoData(handle_1, data_vec.data(),
+                                           data_vec.size());
+  }
+  Mock::VerifyAndClearExpectations(&iso_interface_);
+
+  // The returned credits are shared by the CISes
+  std::vector<uint16_t> sent_handles;
+  EXPECT_CALL(iso_interface_, HciSend)
+      .Times(4)
+      .WillRepeatedly([&sent_handles](BT_HDR* p_msg) {
+        uint8_t* p = p_msg->data;
+        uint16_t msg_handle;
+        STREAM_TO_UINT16(msg_handle, p);
+        sent_handles.push_back(msg_handle);
+      });
+  IsoManager::GetInstance()->HandleNumComplDataPkts(handle_0, 2);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(handle_0, 2);
+
+  ASSERT_EQ(sent_handles.size(), 4u);
+  ASSERT_EQ(std::count(sent_handles.begin(), sent_handles.end(), handle_0), 2);
+  ASSERT_EQ(std::count(sent_handles.begin(), sent_handles.end(), handle_1), 2);
+}
+
 TEST_F(IsoManagerTest, SendIsoDataCreditsReturnedByDisconnection) {
   uint8_t num_buffers =
       controller_.GetControllerIsoBufferSize().total_num_le_packets_;
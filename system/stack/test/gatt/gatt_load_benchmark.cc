@@ -0,0 +1,609 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * GATT load benchmarks.
+ *
+ * The legacy GATT stack runs against a fake L2CAP that loops the ATT fixed
+ * channel of every link back to the stack itself: the requests of the client
+ * reach the server of the same link, and the responses and notifications of
+ * the server reach the client. Each link stands for one central, all of them
+ * share the server database registered by the benchmark.
+ *
+ * Everything runs on the benchmark thread: the tasks the stack posts to the
+ * main thread and the PDUs in flight are queued in order and run until the
+ * workload of an iteration completes.
+ */
+
+#include <base/functional/bind.h>
+#include <base/location.h>
+#include <time.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "osi/include/allocator.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/gatt_api.h"
+#include "stack/include/gattdefs.h"
+#include "test/fake/fake_osi.h"
+#include "test/mock/mock_stack_btm_dev.h"
+#include "test/mock/mock_stack_l2cap_api.h"
+#include "test/mock/mock_stack_l2cap_ble.h"
+
+using ::benchmark::State;
+using bluetooth::Uuid;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint16_t kMtu = 247;
+constexpr size_t kCharacteristicsPerService = 8;
+constexpr size_t kValueSize = 20;
+// Requests queued on each link at once by the read and write benchmark, the
+// GATT client sends them one after the other
+constexpr size_t kOpsPerLink = 4;
+constexpr size_t kNotifyServices = 4;
+
+// Main thread of the stack: the posted tasks and the PDUs on the loopback
+// links, in the order they were queued
+std::deque<base::OnceClosure> main_thread;
+size_t att_pdus;
+
+tL2CAP_FIXED_CHNL_REG fixed_chnl_reg;
+tBTM_SEC_DEV_REC btm_sec_dev_rec;
+
+void RunMainThread() {
+  while (!main_thread.empty()) {
+    base::OnceClosure task = std::move(main_thread.front());
+    main_thread.pop_front();
+    std::move(task).Run();
+  }
+}
+
+}  // namespace
+
+bt_status_t do_in_main_thread(const base::Location& /* from_here */,
+                              base::OnceCallback<void()> task) {
+  main_thread.push_back(std::move(task));
+  return BT_STATUS_SUCCESS;
+}
+
+// Delays are not simulated, the benchmark measures processing only
+bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
+                                      base::OnceCallback<void()> task,
+                                      std::chrono::microseconds /* delay */) {
+  return do_in_main_thread(from_here, std::move(task));
+}
+
+namespace bluetooth {
+namespace os {
+bool GetSystemPropertyBool(const std::string& /* property */,
+                           bool default_value) {
+  return default_value;
+}
+}  // namespace os
+}  // namespace bluetooth
+
+namespace {
+
+void DeliverPdu(RawAddress address, BT_HDR* p_buf) {
+  fixed_chnl_reg.pL2CA_FixedData_Cb(L2CAP_ATT_CID, address, p_buf);
+}
+
+// Fake L2CAP with one loopback ATT bearer per link
+class LoopbackL2cap {
+ public:
+  LoopbackL2cap() {
+    test::mock::stack_btm_dev::btm_find_dev.body = [](const RawAddress&) {
+      return &btm_sec_dev_rec;
+    };
+    test::mock::stack_l2cap_ble::L2CA_GetBleConnRole.body =
+        [](const RawAddress&) { return HCI_ROLE_CENTRAL; };
+    test::mock::stack_l2cap_api::L2CA_RegisterFixedChannel.body =
+        [](uint16_t /* fixed_cid */, tL2CAP_FIXED_CHNL_REG* p_freg) {
+          fixed_chnl_reg = *p_freg;
+          return true;
+        };
+    test::mock::stack_l2cap_api::L2CA_RegisterWithSecurity.body =
+        [](uint16_t psm, const tL2CAP_APPL_INFO&, bool, tL2CAP_ERTM_INFO*,
+           uint16_t, uint16_t, uint16_t) { return psm; };
+    test::mock::stack_l2cap_api::L2CA_RegisterLECoc.body =
+        [](uint16_t psm, const tL2CAP_APPL_INFO&, uint16_t,
+           tL2CAP_LE_CFG_INFO) { return psm; };
+    test::mock::stack_l2cap_api::L2CA_ConnectFixedChnl.body =
+        [](uint16_t, const RawAddress&) { return true; };
+    test::mock::stack_l2cap_api::L2CA_RemoveFixedChnl.body =
+        [](uint16_t, const RawAddress&) { return true; };
+    test::mock::stack_l2cap_api::L2CA_SetIdleTimeoutByBdAddr.body =
+        [](const RawAddress&, uint16_t, uint8_t) { return true; };
+    test::mock::stack_l2cap_api::L2CA_SetLeGattTimeout.body =
+        [](const RawAddress&, uint16_t) { return true; };
+    test::mock::stack_l2cap_api::L2CA_SendFixedChnlData.body =
+        [](uint16_t, const RawAddress& address, BT_HDR* p_buf) {
+          att_pdus++;
+          main_thread.push_back(base::BindOnce(&DeliverPdu, address, p_buf));
+          return L2CAP_DW_SUCCESS;
+        };
+  }
+
+  ~LoopbackL2cap() {
+    test::mock::stack_btm_dev::btm_find_dev = {};
+    test::mock::stack_l2cap_ble::L2CA_GetBleConnRole = {};
+    test::mock::stack_l2cap_api::L2CA_RegisterFixedChannel = {};
+    test::mock::stack_l2cap_api::L2CA_RegisterWithSecurity = {};
+    test::mock::stack_l2cap_api::L2CA_RegisterLECoc = {};
+    test::mock::stack_l2cap_api::L2CA_ConnectFixedChnl = {};
+    test::mock::stack_l2cap_api::L2CA_RemoveFixedChnl = {};
+    test::mock::stack_l2cap_api::L2CA_SetIdleTimeoutByBdAddr = {};
+    test::mock::stack_l2cap_api::L2CA_SetLeGattTimeout = {};
+    test::mock::stack_l2cap_api::L2CA_SendFixedChnlData = {};
+  }
+};
+
+enum class Op { READ, WRITE, SUBSCRIBE };
+
+struct Link {
+  RawAddress address;
+  uint16_t client_conn_id = 0;
+  uint16_t server_conn_id = 0;
+  bool subscribed = false;
+  // Client side
+  std::deque<Clock::time_point> op_starts;
+  size_t next_op = 0;
+  Clock::time_point discovery_start;
+  size_t discovered = 0;
+  bool discovery_done = false;
+};
+
+// State of the server and client applications. The GATT callbacks carry no
+// context.
+struct {
+  tGATT_IF server_if;
+  tGATT_IF client_if;
+  std::vector<uint16_t> value_handles;
+  std::vector<uint16_t> cccd_handles;
+  std::unordered_set<uint16_t> cccd_handle_set;
+  std::vector<Link> links;
+  std::unordered_map<uint16_t, Link*> link_by_conn_id;
+  size_t pending;
+  std::vector<double> latency_us;
+  // Send time of each notification, indexed by the sequence number it carries
+  std::vector<Clock::time_point> notif_sent;
+} load_cb;
+
+std::chrono::nanoseconds ThreadCpuTime() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+double Percentile(std::vector<double>& values, double fraction) {
+  if (values.empty()) return 0;
+  size_t index = static_cast<size_t>(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+void RecordLatency(Clock::time_point start) {
+  load_cb.latency_us.push_back(
+      std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+}
+
+Link* FindLink(uint16_t conn_id) {
+  auto it = load_cb.link_by_conn_id.find(conn_id);
+  return it == load_cb.link_by_conn_id.end() ? nullptr : it->second;
+}
+
+void OnConnection(tGATT_IF gatt_if, const RawAddress& bda, uint16_t conn_id,
+                  bool connected, tGATT_DISCONN_REASON, tBT_TRANSPORT) {
+  for (Link& link : load_cb.links) {
+    if (link.address != bda) continue;
+    if (!connected) {
+      load_cb.link_by_conn_id.erase(conn_id);
+    } else if (gatt_if == load_cb.client_if) {
+      link.client_conn_id = conn_id;
+      load_cb.link_by_conn_id[conn_id] = &link;
+    } else {
+      link.server_conn_id = conn_id;
+      load_cb.link_by_conn_id[conn_id] = &link;
+    }
+  }
+}
+
+/* Server application: values are not stored, reads return a fixed pattern and
+ * writes to a Client Characteristic Configuration subscribe the link */
+void OnServerRequest(uint16_t conn_id, uint32_t trans_id, tGATTS_REQ_TYPE type,
+                     tGATTS_DATA* p_data) {
+  tGATTS_RSP rsp = {};
+  switch (type) {
+    case GATTS_REQ_TYPE_READ_CHARACTERISTIC:
+    case GATTS_REQ_TYPE_READ_DESCRIPTOR:
+      rsp.attr_value.handle = p_data->read_req.handle;
+      rsp.attr_value.offset = p_data->read_req.offset;
+      rsp.attr_value.len = kValueSize;
+      memset(rsp.attr_value.value, 0x5a, kValueSize);
+      break;
+    case GATTS_REQ_TYPE_WRITE_CHARACTERISTIC:
+    case GATTS_REQ_TYPE_WRITE_DESCRIPTOR: {
+      Link* link = FindLink(conn_id);
+      if (link != nullptr &&
+          load_cb.cccd_handle_set.count(p_data->write_req.handle) > 0) {
+        link->subscribed =
+            p_data->write_req.value[0] & GATT_CLT_CONFIG_NOTIFICATION;
+      }
+      if (!p_data->write_req.need_rsp) return;
+      rsp.handle = p_data->write_req.handle;
+      break;
+    }
+    default:
+      return;
+  }
+  (void)GATTS_SendRsp(conn_id, trans_id, GATT_SUCCESS, &rsp);
+}
+
+void IssueOp(Link& link) {
+  size_t index = link.next_op++;
+  Op op = static_cast<Op>(index % 3);
+  size_t characteristic = (index / 3) % load_cb.value_handles.size();
+  tGATT_STATUS status;
+  if (op == Op::READ) {
+    tGATT_READ_PARAM param = {};
+    param.by_handle.handle = load_cb.value_handles[characteristic];
+    status = GATTC_Read(link.client_conn_id, GATT_READ_BY_HANDLE, &param);
+  } else {
+    tGATT_VALUE value = {};
+    value.len = op == Op::WRITE ? kValueSize : 2;
+    value.handle = op == Op::WRITE ? load_cb.value_handles[characteristic]
+                                   : load_cb.cccd_handles[characteristic];
+    value.value[0] = GATT_CLT_CONFIG_NOTIFICATION;
+    status = GATTC_Write(link.client_conn_id, GATT_WRITE, &value);
+  }
+  if (status != GATT_SUCCESS) return;
+  link.op_starts.push_back(Clock::now());
+  load_cb.pending++;
+}
+
+void StartDiscovery(Link* link, tGATT_DISC_TYPE type) {
+  if (GATTC_Discover(link->client_conn_id, type, 0x0001, 0xFFFF) !=
+      GATT_SUCCESS) {
+    link->discovery_done = true;
+    load_cb.pending--;
+  }
+}
+
+/* Client application */
+void OnClientComplete(uint16_t conn_id, tGATTC_OPTYPE op, tGATT_STATUS status,
+                      tGATT_CL_COMPLETE* p_data) {
+  Link* link = FindLink(conn_id);
+  if (link == nullptr) return;
+  switch (op) {
+    case GATTC_OPTYPE_CONFIG:
+      load_cb.pending--;
+      break;
+    case GATTC_OPTYPE_READ:
+    case GATTC_OPTYPE_WRITE:
+      if (link->op_starts.empty()) return;
+      RecordLatency(link->op_starts.front());
+      link->op_starts.pop_front();
+      load_cb.pending--;
+      break;
+    case GATTC_OPTYPE_NOTIFICATION: {
+      uint32_t seq;
+      if (p_data->att_value.len < sizeof(seq)) return;
+      memcpy(&seq, p_data->att_value.value, sizeof(seq));
+      if (seq >= load_cb.notif_sent.size()) return;
+      RecordLatency(load_cb.notif_sent[seq]);
+      load_cb.pending--;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void OnDiscoveryResult(uint16_t conn_id, tGATT_DISC_TYPE, tGATT_DISC_RES*) {
+  Link* link = FindLink(conn_id);
+  if (link != nullptr) link->discovered++;
+}
+
+/* Services, then characteristics, then descriptors, each over the whole
+ * database; the next step starts from the main thread once the GATT client
+ * is done with the current one */
+void OnDiscoveryComplete(uint16_t conn_id, tGATT_DISC_TYPE type,
+                         tGATT_STATUS) {
+  Link* link = FindLink(conn_id);
+  if (link == nullptr || link->discovery_done) return;
+  if (type == GATT_DISC_SRVC_ALL || type == GATT_DISC_CHAR) {
+    tGATT_DISC_TYPE next =
+        type == GATT_DISC_SRVC_ALL ? GATT_DISC_CHAR : GATT_DISC_CHAR_DSCPT;
+    main_thread.push_back(base::BindOnce(&StartDiscovery, link, next));
+    return;
+  }
+  RecordLatency(link->discovery_start);
+  link->discovery_done = true;
+  load_cb.pending--;
+}
+
+// A GATT stack with |num_services| services of kCharacteristicsPerService
+// notifiable characteristics in its server database, connected to itself over
+// |num_links| loopback links
+class GattLoad {
+ public:
+  GattLoad(size_t num_links, size_t num_services) {
+    main_thread.clear();
+    att_pdus = 0;
+    load_cb.value_handles.clear();
+    load_cb.cccd_handles.clear();
+    load_cb.cccd_handle_set.clear();
+    load_cb.links.clear();
+    load_cb.link_by_conn_id.clear();
+    load_cb.pending = 0;
+    load_cb.latency_us.clear();
+    load_cb.notif_sent.clear();
+
+    gatt_init();
+    tGATT_APPL_INFO appl_info = {
+        .p_nv_save_callback = [](bool, tGATTS_HNDL_RANGE*) {},
+        .p_srv_chg_callback = [](tGATTS_SRV_CHG_CMD, tGATTS_SRV_CHG_REQ*,
+                                 tGATTS_SRV_CHG_RSP*) { return true; },
+    };
+    (void)GATTS_NVRegister(&appl_info);
+
+    tGATT_CBACK server_cback = {
+        .p_conn_cb = OnConnection,
+        .p_req_cb = OnServerRequest,
+    };
+    load_cb.server_if = GATT_Register(AppUuid(0x01), "LoadServer",
+                                      &server_cback, false);
+    GATT_StartIf(load_cb.server_if);
+    tGATT_CBACK client_cback = {
+        .p_conn_cb = OnConnection,
+        .p_cmpl_cb = OnClientComplete,
+        .p_disc_res_cb = OnDiscoveryResult,
+        .p_disc_cmpl_cb = OnDiscoveryComplete,
+    };
+    load_cb.client_if = GATT_Register(AppUuid(0x02), "LoadClient",
+                                      &client_cback, false);
+    GATT_StartIf(load_cb.client_if);
+
+    for (size_t i = 0; i < num_services; i++) {
+      AddService(i);
+    }
+
+    load_cb.links.resize(num_links);
+    for (size_t i = 0; i < num_links; i++) {
+      load_cb.links[i].address =
+          RawAddress(std::array<uint8_t, RawAddress::kLength>{
+              0x00, 0x11, 0x22, 0x33, 0x44, static_cast<uint8_t>(i + 1)});
+      fixed_chnl_reg.pL2CA_FixedConn_Cb(L2CAP_ATT_CID,
+                                        load_cb.links[i].address, true, 0,
+                                        BT_TRANSPORT_LE);
+    }
+    RunMainThread();
+
+    for (Link& link : load_cb.links) {
+      if (GATTC_ConfigureMTU(link.client_conn_id, kMtu) == GATT_SUCCESS) {
+        load_cb.pending++;
+      }
+    }
+    Run();
+  }
+
+  ~GattLoad() {
+    for (Link& link : load_cb.links) {
+      fixed_chnl_reg.pL2CA_FixedConn_Cb(L2CAP_ATT_CID, link.address, false,
+                                        GATT_CONN_TERMINATE_LOCAL_HOST,
+                                        BT_TRANSPORT_LE);
+    }
+    RunMainThread();
+    GATT_Deregister(load_cb.client_if);
+    GATT_Deregister(load_cb.server_if);
+    gatt_free();
+    main_thread.clear();
+  }
+
+  bool IsReady() const {
+    for (const Link& link : load_cb.links) {
+      if (link.client_conn_id == 0 || link.server_conn_id == 0) return false;
+    }
+    return !load_cb.value_handles.empty();
+  }
+
+  // Runs the stack until the workload in flight completes. A request or a
+  // notification the stack dropped does not hold up the next iteration.
+  void Run() {
+    RunMainThread();
+    load_cb.pending = 0;
+  }
+
+ private:
+  static Uuid AppUuid(uint8_t id) {
+    std::array<uint8_t, Uuid::kNumBytes128> bytes;
+    bytes.fill(id);
+    return Uuid::From128BitBE(bytes);
+  }
+
+  static void AddService(size_t index) {
+    std::vector<btgatt_db_element_t> service(1 +
+                                             2 * kCharacteristicsPerService);
+    service[0].uuid = Uuid::From16Bit(0xA000 + index);
+    service[0].type = BTGATT_DB_PRIMARY_SERVICE;
+    for (size_t i = 0; i < kCharacteristicsPerService; i++) {
+      btgatt_db_element_t& characteristic = service[1 + 2 * i];
+      characteristic.uuid = Uuid::From16Bit(0xB000 + i);
+      characteristic.type = BTGATT_DB_CHARACTERISTIC;
+      characteristic.properties = GATT_CHAR_PROP_BIT_READ |
+                                  GATT_CHAR_PROP_BIT_WRITE |
+                                  GATT_CHAR_PROP_BIT_NOTIFY;
+      characteristic.permissions = GATT_PERM_READ | GATT_PERM_WRITE;
+      btgatt_db_element_t& cccd = service[2 + 2 * i];
+      cccd.uuid = Uuid::From16Bit(GATT_UUID_CHAR_CLIENT_CONFIG);
+      cccd.type = BTGATT_DB_DESCRIPTOR;
+      cccd.permissions = GATT_PERM_READ | GATT_PERM_WRITE;
+    }
+    if (GATTS_AddService(load_cb.server_if, service.data(), service.size()) !=
+        GATT_SUCCESS) {
+      return;
+    }
+    for (size_t i = 0; i < kCharacteristicsPerService; i++) {
+      load_cb.value_handles.push_back(service[1 + 2 * i].attribute_handle);
+      load_cb.cccd_handles.push_back(service[2 + 2 * i].attribute_handle);
+      load_cb.cccd_handle_set.insert(service[2 + 2 * i].attribute_handle);
+    }
+  }
+
+  test::fake::FakeOsi fake_osi_;
+  LoopbackL2cap l2cap_;
+};
+
+void ReportLoad(State& state, std::chrono::nanoseconds cpu_time,
+                size_t operations) {
+  double seconds = std::chrono::duration<double>(cpu_time).count();
+  state.counters["att_pdus_per_s"] = benchmark::Counter(
+      static_cast<double>(att_pdus), benchmark::Counter::kIsRate);
+  if (operations > 0) {
+    state.counters["cpu_us_per_op"] = seconds * 1e6 / operations;
+  }
+  state.counters["p50_us"] = Percentile(load_cb.latency_us, 0.50);
+  state.counters["p99_us"] = Percentile(load_cb.latency_us, 0.99);
+  state.SetItemsProcessed(operations);
+}
+
+// All the links discover the whole server database at the same time; the
+// latency is the discovery time of a link
+void BM_GattDiscovery(State& state) {
+  GattLoad load(state.range(0), state.range(1));
+  if (!load.IsReady()) {
+    state.SkipWithError("Unable to set up the GATT links");
+    return;
+  }
+  att_pdus = 0;
+  size_t discoveries = 0;
+  auto cpu_start = ThreadCpuTime();
+  for (auto _ : state) {
+    for (Link& link : load_cb.links) {
+      link.discovery_start = Clock::now();
+      link.discovery_done = false;
+      load_cb.pending++;
+      StartDiscovery(&link, GATT_DISC_SRVC_ALL);
+    }
+    load.Run();
+    discoveries += load_cb.links.size();
+  }
+  ReportLoad(state, ThreadCpuTime() - cpu_start, discoveries);
+  size_t discovered = 0;
+  for (const Link& link : load_cb.links) discovered += link.discovered;
+  if (discoveries > 0) {
+    state.counters["attributes"] = discovered / discoveries;
+  }
+}
+
+// Each link queues kOpsPerLink requests at a time, rotating between reads,
+// writes and subscriptions over the characteristics of the database
+void BM_GattReadWrite(State& state) {
+  GattLoad load(state.range(0), state.range(1));
+  if (!load.IsReady()) {
+    state.SkipWithError("Unable to set up the GATT links");
+    return;
+  }
+  att_pdus = 0;
+  size_t operations = 0;
+  auto cpu_start = ThreadCpuTime();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kOpsPerLink; i++) {
+      for (Link& link : load_cb.links) IssueOp(link);
+    }
+    operations += load_cb.pending;
+    load.Run();
+  }
+  ReportLoad(state, ThreadCpuTime() - cpu_start, operations);
+}
+
+// The server sends a burst of notifications to every subscribed link,
+// interleaved across the links; the latency is from the server API call to
+// the client callback
+void BM_GattNotify(State& state) {
+  GattLoad load(state.range(0), kNotifyServices);
+  if (!load.IsReady()) {
+    state.SkipWithError("Unable to set up the GATT links");
+    return;
+  }
+  for (Link& link : load_cb.links) {
+    tGATT_VALUE value = {};
+    value.handle = load_cb.cccd_handles.front();
+    value.len = 2;
+    value.value[0] = GATT_CLT_CONFIG_NOTIFICATION;
+    link.next_op = 0;
+    if (GATTC_Write(link.client_conn_id, GATT_WRITE, &value) == GATT_SUCCESS) {
+      link.op_starts.push_back(Clock::now());
+      load_cb.pending++;
+    }
+  }
+  load.Run();
+  load_cb.latency_us.clear();
+
+  size_t burst = state.range(1);
+  uint8_t value[kValueSize] = {};
+  att_pdus = 0;
+  size_t notifications = 0;
+  auto cpu_start = ThreadCpuTime();
+  for (auto _ : state) {
+    for (size_t i = 0; i < burst; i++) {
+      uint16_t handle =
+          load_cb.value_handles[i % load_cb.value_handles.size()];
+      for (Link& link : load_cb.links) {
+        if (!link.subscribed) continue;
+        uint32_t seq = load_cb.notif_sent.size();
+        memcpy(value, &seq, sizeof(seq));
+        load_cb.notif_sent.push_back(Clock::now());
+        if (GATTS_HandleValueNotification(link.server_conn_id, handle,
+                                          sizeof(value),
+                                          value) == GATT_SUCCESS) {
+          load_cb.pending++;
+          notifications++;
+        }
+      }
+    }
+    load.Run();
+    load_cb.notif_sent.clear();
+  }
+  ReportLoad(state, ThreadCpuTime() - cpu_start, notifications);
+}
+
+BENCHMARK(BM_GattDiscovery)
+    ->ArgNames({"links", "services"})
+    ->ArgsProduct({{1, 8, 14}, {4, 24}});
+BENCHMARK(BM_GattReadWrite)
+    ->ArgNames({"links", "services"})
+    ->ArgsProduct({{1, 8, 14}, {4, 24}});
+BENCHMARK(BM_GattNotify)
+    ->ArgNames({"links", "burst"})
+    ->ArgsProduct({{1, 8, 14}, {1, 16, 64}});
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -389,3 +389,21 @@ TEST_F(StackGattTest, attp_build_value_cmd_read_by_type_test_long_data) {
       payload_size, op_code, handle, offset_0, data_size, data);
   ASSERT_EQ(ret, nullptr);
 }
+
+TEST_F(StackGattTest, gatt_latency_record) {
+  tGATT_LATENCY_HIST hist{};
+
+  gatt_latency_record(hist, 500);      // 0.5ms
+  gatt_latency_record(hist, 1000);     // 1ms
+  gatt_latency_record(hist, 3000);     // 3ms
+  gatt_latency_record(hist, 3999);     // 3.999ms
+  gatt_latency_record(hist, 9000000);  // 9s
+
+  ASSERT_EQ(hist.count, 5u);
+  ASSERT_EQ(hist.sum_us, 9008499u);
+  ASSERT_EQ(hist.max_us, 9000000u);
+  ASSERT_EQ(hist.buckets[0], 1u);
+  ASSERT_EQ(hist.buckets[1], 1u);
+  ASSERT_EQ(hist.buckets[2], 2u);
+  ASSERT_EQ(hist.buckets[GATT_LATENCY_HIST_BUCKETS - 1], 1u);
+}
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include "stack/include/bt_uuid16.h"
 #include "stack/include/sdp_api.h"
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdpint.h"
@@ -23,6 +24,11 @@
 namespace {
 constexpr char service_name[] = "TestServiceName";
 constexpr uint32_t kFirstRecordHandle = 0x10000;
+
+tUID_ENT uuid16_entry(uint16_t uuid) {
+  tUID_ENT entry = {.len = 2, .value = {(uint8_t)(uuid >> 8), (uint8_t)uuid}};
+  return entry;
+}
 }  // namespace
 
 using bluetooth::legacy::stack::sdp::get_legacy_stack_sdp_api;
@@ -196,3 +202,70 @@ TEST_F(StackSdpDbTest, SDP_AddAttribute__three_attributes_replace_middle) {
   ASSERT_TRUE(
       get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(record_handle));
 }
+
+TEST_F(StackSdpDbTest, sdp_db_service_search__uuid_index) {
+  uint32_t spp_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  uint32_t a2dp_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  ASSERT_NE((uint32_t)0, spp_handle);
+  ASSERT_NE((uint32_t)0, a2dp_handle);
+
+  uint16_t spp_uuid = UUID_SERVCLASS_SERIAL_PORT;
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(
+      spp_handle, 1, &spp_uuid));
+  tSDP_PROTOCOL_ELEM spp_protocols[] = {
+      {.protocol_uuid = UUID_PROTOCOL_L2CAP, .num_params = 0},
+      {.protocol_uuid = UUID_PROTOCOL_RFCOMM, .num_params = 1, .params = {3}},
+  };
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddProtocolList(
+      spp_handle, 2, spp_protocols));
+
+  uint16_t a2dp_uuid = UUID_SERVCLASS_AUDIO_SOURCE;
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(
+      a2dp_handle, 1, &a2dp_uuid));
+  tSDP_PROTOCOL_ELEM a2dp_protocols[] = {
+      {.protocol_uuid = UUID_PROTOCOL_L2CAP, .num_params = 1, .params = {25}},
+  };
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddProtocolList(
+      a2dp_handle, 1, a2dp_protocols));
+
+  // Both records hold L2CAP in their protocol descriptor list
+  tSDP_UUID_SEQ l2cap_seq = {.num_uids = 1,
+                             .uuid_entry = {uuid16_entry(UUID_PROTOCOL_L2CAP)}};
+  const tSDP_RECORD* p_rec = sdp_db_service_search(nullptr, &l2cap_seq);
+  ASSERT_EQ(sdp_db_find_record(spp_handle), p_rec);
+  p_rec = sdp_db_service_search(p_rec, &l2cap_seq);
+  ASSERT_EQ(sdp_db_find_record(a2dp_handle), p_rec);
+  ASSERT_EQ(nullptr, sdp_db_service_search(p_rec, &l2cap_seq));
+
+  // All the UUIDs must be found, whatever their size
+  tSDP_UUID_SEQ spp_seq = {.num_uids = 2,
+                           .uuid_entry = {uuid16_entry(UUID_PROTOCOL_L2CAP)}};
+  spp_seq.uuid_entry[1].len = 16;
+  memcpy(spp_seq.uuid_entry[1].value,
+         bluetooth::Uuid::From16Bit(UUID_SERVCLASS_SERIAL_PORT)
+             .To128BitBE()
+             .data(),
+         16);
+  ASSERT_EQ(sdp_db_find_record(spp_handle),
+            sdp_db_service_search(nullptr, &spp_seq));
+  tSDP_UUID_SEQ rfcomm_a2dp_seq = {
+      .num_uids = 2,
+      .uuid_entry = {uuid16_entry(UUID_PROTOCOL_RFCOMM),
+                     uuid16_entry(UUID_SERVCLASS_AUDIO_SOURCE)}};
+  ASSERT_EQ(nullptr, sdp_db_service_search(nullptr, &rfcomm_a2dp_seq));
+
+  // The index follows the records moved by a deletion
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(spp_handle));
+  ASSERT_EQ(sdp_db_find_record(a2dp_handle),
+            sdp_db_service_search(nullptr, &l2cap_seq));
+  ASSERT_EQ(nullptr, sdp_db_service_search(nullptr, &spp_seq));
+
+  // and the attributes replaced in a record
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(
+      a2dp_handle, 1, &spp_uuid));
+  ASSERT_EQ(sdp_db_find_record(a2dp_handle),
+            sdp_db_service_search(nullptr, &spp_seq));
+
+  ASSERT_TRUE(
+      get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(a2dp_handle));
+}
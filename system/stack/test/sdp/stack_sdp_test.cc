@@ -19,6 +19,8 @@
 #include <stdlib.h>
 
 #include <cstddef>
+#include <map>
+#include <vector>
 
 #include "osi/include/allocator.h"
 #include "stack/include/bt_uuid16.h"
@@ -26,6 +28,7 @@
 #include "stack/sdp/internal/sdp_api.h"
 #include "stack/sdp/sdpint.h"
 #include "test/fake/fake_osi.h"
+#include "test/mock/mock_btif_config.h"
 #include "test/mock/mock_osi_allocator.h"
 #include "test/mock/mock_stack_l2cap_api.h"
 
@@ -189,6 +192,63 @@ TEST_F(StackSdpInitTest, sdp_service_search_request_queuing_race_condition) {
   sdp_disconnect(p_ccb2, SDP_SUCCESS);
 }
 
+TEST_F(StackSdpInitTest, sdp_service_search_attribute_from_cache) {
+  std::map<std::string, std::vector<uint8_t>> config;
+  test::mock::btif_config::btif_config_set_bin.body =
+      [&config](const std::string& section, const std::string& key,
+                const uint8_t* value, size_t length) {
+        config[section + "/" + key].assign(value, value + length);
+        return true;
+      };
+  test::mock::btif_config::btif_config_get_bin_length.body =
+      [&config](const std::string& section, const std::string& key) {
+        auto it = config.find(section + "/" + key);
+        return it == config.end() ? 0 : it->second.size();
+      };
+  test::mock::btif_config::btif_config_get_bin.body =
+      [&config](const std::string& section, const std::string& key,
+                uint8_t* value, size_t* length) {
+        auto it = config.find(section + "/" + key);
+        if (it == config.end() || *length < it->second.size()) {
+          return false;
+        }
+        std::copy(it->second.begin(), it->second.end(), value);
+        *length = it->second.size();
+        return true;
+      };
+
+  const bluetooth::Uuid uuid =
+      bluetooth::Uuid::From16Bit(UUID_SERVCLASS_HF_HANDSFREE);
+  uint16_t attr_id = ATTR_ID_SERVICE_CLASS_ID_LIST;
+  ASSERT_TRUE(SDP_InitDiscoveryDb(sdp_db, BT_DEFAULT_BUFFER_SIZE, 1, &uuid, 1,
+                                  &attr_id));
+  ASSERT_FALSE(SDP_ServiceSearchAttributeFromCache(addr, sdp_db));
+
+  // One record with a service class ID list holding the handsfree UUID
+  uint8_t attr_list[] = {0x35, 0x0a, 0x35, 0x08, 0x09, 0x00, 0x01,
+                         0x35, 0x03, 0x19, 0x11, 0x1e};
+  sdp_cache_store(addr, *sdp_db, attr_list, sizeof(attr_list));
+
+  const int cid = L2CA_ConnectReqWithSecurity_cid;
+  ASSERT_TRUE(SDP_ServiceSearchAttributeFromCache(addr, sdp_db));
+  ASSERT_NE(SDP_FindServiceInDb(sdp_db, UUID_SERVCLASS_HF_HANDSFREE, nullptr),
+            nullptr);
+  // A fresh entry is not refreshed
+  ASSERT_EQ(cid, L2CA_ConnectReqWithSecurity_cid);
+
+  // The response to other filters is not cached
+  uint16_t other_attr_ids[] = {ATTR_ID_SERVICE_CLASS_ID_LIST,
+                               ATTR_ID_PROTOCOL_DESC_LIST};
+  ASSERT_TRUE(SDP_InitDiscoveryDb(sdp_db, BT_DEFAULT_BUFFER_SIZE, 1, &uuid, 2,
+                                  other_attr_ids));
+  ASSERT_FALSE(SDP_ServiceSearchAttributeFromCache(addr, sdp_db));
+  ASSERT_EQ(sdp_db->p_first_rec, nullptr);
+
+  test::mock::btif_config::btif_config_set_bin = {};
+  test::mock::btif_config::btif_config_get_bin_length = {};
+  test::mock::btif_config::btif_config_get_bin = {};
+}
+
 TEST_F(StackSdpInitTest, sdp_disc_wait_text) {
   std::vector<std::pair<tSDP_DISC_WAIT, std::string>> states = {
       std::make_pair(SDP_DISC_WAIT_CONN, "SDP_DISC_WAIT_CONN"),
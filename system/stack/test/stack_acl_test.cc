@@ -115,3 +115,46 @@ TEST_F(StackAclTest, acl_process_extended_features) {
 
   btm_acl_removed(hci_handle);
 }
+
+TEST_F(StackAclTest, lookups_follow_connections_coming_and_going) {
+  const RawAddress kOtherRawAddress =
+      RawAddress({0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+  const uint16_t hci_handle = 0x123;
+  const uint16_t other_hci_handle = 0x456;
+
+  btm_acl_created(kRawAddress, hci_handle, HCI_ROLE_CENTRAL, BT_TRANSPORT_LE);
+  btm_acl_created(kOtherRawAddress, other_hci_handle, HCI_ROLE_CENTRAL,
+                  BT_TRANSPORT_LE);
+
+  tACL_CONN* p_acl = btm_acl_for_bda(kRawAddress, BT_TRANSPORT_LE);
+  tACL_CONN* p_other_acl = btm_acl_for_bda(kOtherRawAddress, BT_TRANSPORT_LE);
+  ASSERT_NE(nullptr, p_acl);
+  ASSERT_NE(nullptr, p_other_acl);
+  ASSERT_NE(p_acl, p_other_acl);
+  ASSERT_EQ(nullptr, btm_acl_for_bda(kRawAddress, BT_TRANSPORT_BR_EDR));
+  ASSERT_EQ(p_acl, btm_acl_for_bda(kRawAddress, BT_TRANSPORT_LE));
+
+  const uint8_t index = btm_handle_to_acl_index(hci_handle);
+  ASSERT_LT(index, MAX_L2CAP_LINKS);
+  ASSERT_EQ(index, btm_handle_to_acl_index(hci_handle));
+  ASSERT_NE(index, btm_handle_to_acl_index(other_hci_handle));
+
+  // A removed connection is not found again, even where it was found last
+  btm_acl_removed(hci_handle);
+  ASSERT_EQ(MAX_L2CAP_LINKS, btm_handle_to_acl_index(hci_handle));
+  ASSERT_EQ(nullptr, btm_acl_for_bda(kRawAddress, BT_TRANSPORT_LE));
+  ASSERT_EQ(p_other_acl, btm_acl_for_bda(kOtherRawAddress, BT_TRANSPORT_LE));
+
+  // Nor is its handle once reused for a connection to another address
+  btm_acl_removed(other_hci_handle);
+  btm_acl_created(kOtherRawAddress, hci_handle, HCI_ROLE_CENTRAL,
+                  BT_TRANSPORT_LE);
+  ASSERT_EQ(MAX_L2CAP_LINKS, btm_handle_to_acl_index(other_hci_handle));
+  ASSERT_EQ(nullptr, btm_acl_for_bda(kRawAddress, BT_TRANSPORT_LE));
+  ASSERT_LT(btm_handle_to_acl_index(hci_handle), MAX_L2CAP_LINKS);
+  p_other_acl = btm_acl_for_bda(kOtherRawAddress, BT_TRANSPORT_LE);
+  ASSERT_NE(nullptr, p_other_acl);
+  ASSERT_EQ(hci_handle, p_other_acl->hci_handle);
+
+  btm_acl_removed(hci_handle);
+}
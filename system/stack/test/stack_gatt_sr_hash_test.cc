@@ -83,3 +83,64 @@ TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
 
   ASSERT_EQ(result_hash, expected_hash);
 }
+
+TEST(GattDatabaseTest, findAttrByHandle) {
+  tGATT_SVC_DB db;
+  gatts_init_service_db(db, Uuid::From16Bit(0x180F), true, 0x0020, 5);
+  uint16_t char_handle = gatts_add_characteristic(
+      db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ, Uuid::From16Bit(0x2A19));
+  uint16_t descr_handle =
+      gatts_add_char_descr(db, GATT_PERM_READ, Uuid::From16Bit(0x2902));
+
+  ASSERT_EQ(find_attr_by_handle(&db, 0x001F), nullptr);
+  ASSERT_EQ(find_attr_by_handle(&db, 0x0020)->uuid,
+            Uuid::From16Bit(GATT_UUID_PRI_SERVICE));
+  ASSERT_EQ(find_attr_by_handle(&db, char_handle)->uuid,
+            Uuid::From16Bit(0x2A19));
+  ASSERT_EQ(find_attr_by_handle(&db, descr_handle)->uuid,
+            Uuid::From16Bit(0x2902));
+  ASSERT_EQ(find_attr_by_handle(&db, descr_handle + 1), nullptr);
+  ASSERT_EQ(find_attr_by_handle(nullptr, 0x0020), nullptr);
+}
+
+TEST(GattDatabaseTest, attrIndexByType) {
+  tGATT_SVC_DB db;
+  gatts_init_service_db(db, Uuid::From16Bit(0x1801), true, 0x0006, 8);
+  gatts_add_characteristic(db, 0, GATT_CHAR_PROP_BIT_INDICATE,
+                           Uuid::From16Bit(0x2A05));
+  gatts_add_char_descr(db, GATT_PERM_READ, Uuid::From16Bit(0x2902));
+  gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2B2A));
+
+  const auto& declarations =
+      db.attr_index_by_type.at(Uuid::From16Bit(GATT_UUID_CHAR_DECLARE));
+  ASSERT_EQ(declarations.size(), 2u);
+  ASSERT_EQ(db.attr_list[declarations[0]].handle, 0x0007);
+  ASSERT_EQ(db.attr_list[declarations[1]].handle, 0x000A);
+  ASSERT_EQ(db.attr_index_by_type.at(Uuid::From16Bit(0x2902)).size(), 1u);
+}
+
+TEST(GattDatabaseTest, databaseHashComputedOnRead) {
+  tGATT_SVC_DB db;
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  add_item_to_list(srv_list_info, &db, true);
+  gatts_init_service_db(db, Uuid::From16Bit(0x180F), true, 0x0001, 3);
+  gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A19));
+
+  gatt_cb.srv_list_info = &srv_list_info;
+  gatt_cb.database_hash_valid = false;
+  Octet16 first_hash = gatts_get_database_hash();
+  ASSERT_TRUE(gatt_cb.database_hash_valid);
+  ASSERT_EQ(first_hash, gatts_calculate_database_hash(&srv_list_info));
+
+  // Changes are only picked up once the cached hash is invalidated
+  gatts_add_char_descr(db, GATT_PERM_READ, Uuid::From16Bit(0x2902));
+  ASSERT_EQ(gatts_get_database_hash(), first_hash);
+  gatt_cb.database_hash_valid = false;
+  ASSERT_NE(gatts_get_database_hash(), first_hash);
+  ASSERT_EQ(gatts_get_database_hash(),
+            gatts_calculate_database_hash(&srv_list_info));
+
+  gatt_cb.srv_list_info = nullptr;
+}
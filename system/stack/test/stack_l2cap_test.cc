@@ -30,6 +30,7 @@
 #include "stack/include/l2cdefs.h"
 #include "stack/l2cap/l2c_int.h"
 #include "test/mock/mock_main_shim_entry.h"
+#include "test/mock/mock_stack_acl.h"
 
 tBTM_CB btm_cb;
 extern tL2C_CB l2cb;
@@ -90,6 +91,46 @@ TEST_F(StackL2capTest, l2cble_process_data_length_change_event) {
   ASSERT_EQ(0x001b, l2cb.lcb_pool[0].tx_data_len);
 }
 
+TEST_F(StackL2capTest, L2CA_UpdateBleConnParamsForClient) {
+  const RawAddress address({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+  test::mock::stack_acl::BTM_IsAclConnectionUp.body =
+      [](const RawAddress& /* remote_bda */, tBT_TRANSPORT /* transport */) {
+        return true;
+      };
+
+  // No link to the device
+  ASSERT_FALSE(L2CA_UpdateBleConnParamsForClient(
+      L2CAP_CONN_PARAMS_CLIENT_HID, address, 6, 12, 4, 300, 0, 0));
+
+  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  p_lcb->in_use = true;
+  p_lcb->remote_bd_addr = address;
+  p_lcb->transport = BT_TRANSPORT_LE;
+
+  ASSERT_TRUE(L2CA_UpdateBleConnParamsForClient(
+      L2CAP_CONN_PARAMS_CLIENT_HID, address, 6, 12, 4, 300, 0, 0));
+  ASSERT_EQ(6, p_lcb->min_interval);
+  ASSERT_EQ(12, p_lcb->max_interval);
+
+  // The shortest interval and latency, and the longest timeout, are kept
+  ASSERT_TRUE(L2CA_UpdateBleConnParamsForClient(
+      L2CAP_CONN_PARAMS_CLIENT_HEARING_AID, address, 16, 16, 10, 100, 2, 4));
+  ASSERT_EQ(12, p_lcb->min_interval);
+  ASSERT_EQ(12, p_lcb->max_interval);
+  ASSERT_EQ(4, p_lcb->latency);
+  ASSERT_EQ(300, p_lcb->timeout);
+  ASSERT_EQ(2, p_lcb->min_ce_len);
+  ASSERT_EQ(4, p_lcb->max_ce_len);
+
+  // A client relaxing its request gives way to the others
+  ASSERT_TRUE(L2CA_UpdateBleConnParamsForClient(
+      L2CAP_CONN_PARAMS_CLIENT_HID, address, 24, 40, 4, 300, 0, 0));
+  ASSERT_EQ(16, p_lcb->min_interval);
+  ASSERT_EQ(16, p_lcb->max_interval);
+
+  test::mock::stack_acl::BTM_IsAclConnectionUp = {};
+}
+
 class StackL2capChannelTest : public StackL2capTest {
  protected:
   void SetUp() override { StackL2capTest::SetUp(); }
@@ -213,6 +254,33 @@ TEST_F(StackL2capChannelTest, l2c_link_init) {
   ASSERT_EQ(kAclBufferCountClassic, l2cb.controller_xmit_window);
 }
 
+TEST_F(StackL2capTest, l2cu_ready_ring) {
+  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  tL2C_RR_SERV* p_serv = &p_lcb->rr_serv[L2CAP_CHNL_PRIORITY_LOW];
+  tL2C_CCB* p_ccb[3];
+  for (int i = 0; i < 3; i++) {
+    p_ccb[i] = &l2cb.ccb_pool[i];
+    p_ccb[i]->p_lcb = p_lcb;
+    p_ccb[i]->ccb_priority = L2CAP_CHNL_PRIORITY_LOW;
+    l2cu_mark_ccb_ready(p_ccb[i]);
+  }
+  // Already on the ring
+  l2cu_mark_ccb_ready(p_ccb[0]);
+  ASSERT_EQ(3, p_serv->num_ready);
+
+  l2cu_remove_ready_ccb(p_ccb[1]);
+  l2cu_remove_ready_ccb(p_ccb[2]);
+  ASSERT_FALSE(p_ccb[2]->in_ready_q);
+  l2cu_mark_ccb_ready(p_ccb[2]);
+  ASSERT_EQ(2, p_serv->num_ready);
+
+  ASSERT_EQ(p_ccb[0], l2cu_pop_ready_ccb(p_serv));
+  ASSERT_EQ(p_ccb[2], l2cu_pop_ready_ccb(p_serv));
+  ASSERT_EQ(nullptr, l2cu_pop_ready_ccb(p_serv));
+  ASSERT_EQ(0, p_serv->num_ready);
+  ASSERT_EQ(nullptr, p_serv->p_ready_last);
+}
+
 TEST_F(StackL2capTest, l2cap_result_code_text) {
   std::vector<std::pair<tL2CAP_CONN, std::string>> results = {
       std::make_pair(L2CAP_CONN_OK, "L2CAP_CONN_OK"),
@@ -101,6 +101,13 @@ FakeOsi::FakeOsi() {
         alarm->data = data;
       };
 
+  test::mock::osi_alarm::alarm_set_on_mloop_with_slack.body =
+      [](alarm_t* alarm, uint64_t /* interval_ms */, uint64_t /* slack_ms */,
+         alarm_callback_t cb, void* data) {
+        alarm->cb = cb;
+        alarm->data = data;
+      };
+
   test::mock::osi_alarm::alarm_cancel.body = [](alarm_t* alarm) {
     if (alarm) {
       alarm->cb = nullptr;
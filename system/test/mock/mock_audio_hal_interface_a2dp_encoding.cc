@@ -15,7 +15,7 @@
  */
 /*
  * Generated mock file from original source file
- *   Functions generated:21
+ *   Functions generated:24
  *
  *  mockcify.pl ver 0.7.0
  */
@@ -39,9 +39,11 @@ namespace audio_hal_interface_a2dp_encoding {
 // Function state capture and return values, if needed
 struct ack_stream_started ack_stream_started;
 struct ack_stream_suspended ack_stream_suspended;
+struct available_to_read available_to_read;
 struct cleanup cleanup;
 struct codec_index_str codec_index_str;
 struct codec_info codec_info;
+struct consume consume;
 struct end_session end_session;
 struct get_a2dp_configuration get_a2dp_configuration;
 struct init init;
@@ -49,6 +51,7 @@ struct is_hal_enabled is_hal_enabled;
 struct is_hal_offloading is_hal_offloading;
 struct is_opus_supported is_opus_supported;
 struct parse_a2dp_configuration parse_a2dp_configuration;
+struct peek peek;
 struct read read;
 struct set_audio_low_latency_mode_allowed set_audio_low_latency_mode_allowed;
 struct set_remote_delay set_remote_delay;
@@ -69,6 +72,7 @@ namespace test {
 namespace mock {
 namespace audio_hal_interface_a2dp_encoding {
 
+size_t available_to_read::return_value = 0;
 std::optional<const char*> codec_index_str::return_value = std::nullopt;
 bool codec_info::return_value = false;
 std::optional<a2dp_configuration> get_a2dp_configuration::return_value =
@@ -78,6 +82,7 @@ bool is_hal_enabled::return_value = false;
 bool is_hal_offloading::return_value = false;
 bool is_opus_supported::return_value = false;
 tA2DP_STATUS parse_a2dp_configuration::return_value = A2DP_SUCCESS;
+size_t peek::return_value = 0;
 size_t read::return_value = 0;
 bool setup_codec::return_value = false;
 std::optional<btav_a2dp_codec_index_t> sink_codec_index::return_value =
@@ -100,6 +105,10 @@ void ack_stream_suspended(const tA2DP_CTRL_ACK& status) {
   inc_func_call_count(__func__);
   test::mock::audio_hal_interface_a2dp_encoding::ack_stream_suspended(status);
 }
+size_t available_to_read() {
+  inc_func_call_count(__func__);
+  return test::mock::audio_hal_interface_a2dp_encoding::available_to_read();
+}
 void cleanup() {
   inc_func_call_count(__func__);
   test::mock::audio_hal_interface_a2dp_encoding::cleanup();
@@ -117,6 +126,10 @@ bool bluetooth::audio::a2dp::provider::codec_info(
   return test::mock::audio_hal_interface_a2dp_encoding::codec_info(
       codec_index, codec_id, codec_info, codec_config);
 }
+void consume(size_t len) {
+  inc_func_call_count(__func__);
+  test::mock::audio_hal_interface_a2dp_encoding::consume(len);
+}
 void end_session() {
   inc_func_call_count(__func__);
   test::mock::audio_hal_interface_a2dp_encoding::end_session();
@@ -155,6 +168,10 @@ tA2DP_STATUS bluetooth::audio::a2dp::provider::parse_a2dp_configuration(
       parse_a2dp_configuration(codec_index, codec_info, codec_parameters,
                                vendor_specific_parameters);
 }
+size_t peek(const uint8_t** p_buf, uint32_t len) {
+  inc_func_call_count(__func__);
+  return test::mock::audio_hal_interface_a2dp_encoding::peek(p_buf, len);
+}
 size_t read(uint8_t* p_buf, uint32_t len) {
   inc_func_call_count(__func__);
   return test::mock::audio_hal_interface_a2dp_encoding::read(p_buf, len);
@@ -64,6 +64,16 @@ struct ack_stream_suspended {
 };
 extern struct ack_stream_suspended ack_stream_suspended;
 
+// Name: available_to_read
+// Params:
+// Return: size_t
+struct available_to_read {
+  static size_t return_value;
+  std::function<size_t()> body{[]() { return return_value; }};
+  size_t operator()() { return body(); };
+};
+extern struct available_to_read available_to_read;
+
 // Name: cleanup
 // Params:
 // Return: void
@@ -108,6 +118,15 @@ struct codec_info {
 };
 extern struct codec_info codec_info;
 
+// Name: consume
+// Params: size_t len
+// Return: void
+struct consume {
+  std::function<void(size_t len)> body{[](size_t /* len */) {}};
+  void operator()(size_t len) { body(len); };
+};
+extern struct consume consume;
+
 // Name: end_session
 // Params:
 // Return: void
@@ -212,6 +231,21 @@ struct parse_a2dp_configuration {
 };
 extern struct parse_a2dp_configuration parse_a2dp_configuration;
 
+// Name: peek
+// Params: const uint8_t** p_buf, uint32_t len
+// Return: size_t
+struct peek {
+  static size_t return_value;
+  std::function<size_t(const uint8_t** p_buf, uint32_t len)> body{
+      [](const uint8_t** /* p_buf */, uint32_t /* len */) {
+        return return_value;
+      }};
+  size_t operator()(const uint8_t** p_buf, uint32_t len) {
+    return body(p_buf, len);
+  };
+};
+extern struct peek peek;
+
 // Name: read
 // Params: uint8_t* p_buf, uint32_t len
 // Return: size_t
@@ -43,6 +43,7 @@ struct btsock_rfc_cleanup btsock_rfc_cleanup;
 struct btsock_rfc_connect btsock_rfc_connect;
 struct btsock_rfc_control_req btsock_rfc_control_req;
 struct btsock_rfc_disconnect btsock_rfc_disconnect;
+struct btsock_rfc_dump btsock_rfc_dump;
 struct btsock_rfc_init btsock_rfc_init;
 struct btsock_rfc_listen btsock_rfc_listen;
 struct btsock_rfc_signaled btsock_rfc_signaled;
@@ -106,6 +107,10 @@ bt_status_t btsock_rfc_disconnect(const RawAddress* bd_addr) {
   inc_func_call_count(__func__);
   return test::mock::btif_sock_rfc::btsock_rfc_disconnect(bd_addr);
 }
+void btsock_rfc_dump(int fd) {
+  inc_func_call_count(__func__);
+  test::mock::btif_sock_rfc::btsock_rfc_dump(fd);
+}
 bt_status_t btsock_rfc_init(int poll_thread_handle, uid_set_t* set) {
   inc_func_call_count(__func__);
   return test::mock::btif_sock_rfc::btsock_rfc_init(poll_thread_handle, set);
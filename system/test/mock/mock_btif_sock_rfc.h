@@ -142,6 +142,15 @@ struct btsock_rfc_disconnect {
 };
 extern struct btsock_rfc_disconnect btsock_rfc_disconnect;
 
+// Name: btsock_rfc_dump
+// Params: int fd
+// Return: void
+struct btsock_rfc_dump {
+  std::function<void(int fd)> body{[](int /* fd */) {}};
+  void operator()(int fd) { body(fd); };
+};
+extern struct btsock_rfc_dump btsock_rfc_dump;
+
 // Name: btsock_rfc_init
 // Params: int poll_thread_handle, uid_set_t* set
 // Return: bt_status_t
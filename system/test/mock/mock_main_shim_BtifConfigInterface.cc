@@ -65,6 +65,11 @@ bool bluetooth::shim::BtifConfigInterface::GetBin(
     uint8_t* /* value */, size_t* /* length */) {
   return false;
 }
+std::optional<std::vector<uint8_t>>
+bluetooth::shim::BtifConfigInterface::GetBin(const std::string& /* section */,
+                                             const std::string& /* key */) {
+  return std::nullopt;
+}
 size_t bluetooth::shim::BtifConfigInterface::GetBinLength(
     const std::string& /* section */, const std::string& /* key */) {
   return 0;
@@ -84,5 +84,14 @@ char* osi_strndup(const char* str, size_t len) {
   inc_func_call_count(__func__);
   return test::mock::osi_allocator::osi_strndup(str, len);
 }
+bool osi_allocator_pool_enable(void) {
+  inc_func_call_count(__func__);
+  return false;
+}
+void osi_allocator_debug_dump(int /* fd */) { inc_func_call_count(__func__); }
+size_t osi_allocation_size(const void* /* ptr */) {
+  inc_func_call_count(__func__);
+  return 0;
+}
 // Mocked functions complete
 // END mockcify generation
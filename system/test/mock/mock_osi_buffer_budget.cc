@@ -0,0 +1,47 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "osi/include/buffer_budget.h"
+#include "test/common/mock_functions.h"
+
+const char* buffer_budget_owner_name(buffer_owner_t /* owner */) {
+  inc_func_call_count(__func__);
+  return "";
+}
+void buffer_budget_set(buffer_owner_t /* owner */, size_t /* budget */) {
+  inc_func_call_count(__func__);
+}
+void buffer_budget_set_total(size_t /* budget */) {
+  inc_func_call_count(__func__);
+}
+void buffer_budget_charge(buffer_owner_t /* owner */,
+                          const void* /* buffer */) {
+  inc_func_call_count(__func__);
+}
+void buffer_budget_release(buffer_owner_t /* owner */,
+                           const void* /* buffer */) {
+  inc_func_call_count(__func__);
+}
+bool buffer_budget_is_exceeded(buffer_owner_t /* owner */) {
+  inc_func_call_count(__func__);
+  return false;
+}
+void buffer_budget_get_stats(buffer_owner_t /* owner */,
+                             buffer_budget_stats_t* stats) {
+  inc_func_call_count(__func__);
+  *stats = {};
+}
+void buffer_budget_debug_dump(int /* fd */) { inc_func_call_count(__func__); }
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:18
+ *   Functions generated:19
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -43,6 +43,7 @@ struct fixed_queue_get_list fixed_queue_get_list;
 struct fixed_queue_is_empty fixed_queue_is_empty;
 struct fixed_queue_length fixed_queue_length;
 struct fixed_queue_new fixed_queue_new;
+struct fixed_queue_new_with_type fixed_queue_new_with_type;
 struct fixed_queue_register_dequeue fixed_queue_register_dequeue;
 struct fixed_queue_try_dequeue fixed_queue_try_dequeue;
 struct fixed_queue_try_enqueue fixed_queue_try_enqueue;
@@ -76,6 +77,10 @@ void fixed_queue_free(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
   inc_func_call_count(__func__);
   test::mock::osi_fixed_queue::fixed_queue_free(queue, free_cb);
 }
+void fixed_queue_set_buffer_owner(fixed_queue_t* /* queue */,
+                                  buffer_owner_t /* owner */) {
+  inc_func_call_count(__func__);
+}
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   inc_func_call_count(__func__);
   return test::mock::osi_fixed_queue::fixed_queue_get_dequeue_fd(queue);
@@ -100,6 +105,12 @@ fixed_queue_t* fixed_queue_new(size_t capacity) {
   inc_func_call_count(__func__);
   return test::mock::osi_fixed_queue::fixed_queue_new(capacity);
 }
+fixed_queue_t* fixed_queue_new_with_type(size_t capacity,
+                                         fixed_queue_type_t type) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_fixed_queue::fixed_queue_new_with_type(capacity,
+                                                                 type);
+}
 void fixed_queue_register_dequeue(fixed_queue_t* queue, reactor_t* reactor,
                                   fixed_queue_cb ready_cb, void* context) {
   inc_func_call_count(__func__);
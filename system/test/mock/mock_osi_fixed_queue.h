@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:18
+ *   Functions generated:19
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -160,6 +160,21 @@ struct fixed_queue_new {
 };
 extern struct fixed_queue_new fixed_queue_new;
 
+// Name: fixed_queue_new_with_type
+// Params: size_t capacity, fixed_queue_type_t type
+// Return: fixed_queue_t*
+struct fixed_queue_new_with_type {
+  fixed_queue_t* return_value{0};
+  std::function<fixed_queue_t*(size_t capacity, fixed_queue_type_t type)> body{
+      [this](size_t /* capacity */, fixed_queue_type_t /* type */) {
+        return return_value;
+      }};
+  fixed_queue_t* operator()(size_t capacity, fixed_queue_type_t type) {
+    return body(capacity, type);
+  };
+};
+extern struct fixed_queue_new_with_type fixed_queue_new_with_type;
+
 // Name: fixed_queue_register_dequeue
 // Params: fixed_queue_t* queue, reactor_t* reactor, fixed_queue_cb ready_cb,
 // void* context Return: void
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:2
+ *   Functions generated:4
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -33,7 +33,10 @@ namespace osi_thread_scheduler {
 
 // Function state capture and return values, if needed
 struct thread_scheduler_enable_real_time thread_scheduler_enable_real_time;
+struct thread_scheduler_enable_real_time_priority
+    thread_scheduler_enable_real_time_priority;
 struct thread_scheduler_get_priority_range thread_scheduler_get_priority_range;
+struct thread_scheduler_set_cpu_affinity thread_scheduler_set_cpu_affinity;
 
 }  // namespace osi_thread_scheduler
 }  // namespace mock
@@ -45,10 +48,21 @@ bool thread_scheduler_enable_real_time(pid_t linux_tid) {
   return test::mock::osi_thread_scheduler::thread_scheduler_enable_real_time(
       linux_tid);
 }
+bool thread_scheduler_enable_real_time_priority(pid_t linux_tid,
+                                                int priority) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_thread_scheduler::
+      thread_scheduler_enable_real_time_priority(linux_tid, priority);
+}
 bool thread_scheduler_get_priority_range(int& min, int& max) {
   inc_func_call_count(__func__);
   return test::mock::osi_thread_scheduler::thread_scheduler_get_priority_range(
       min, max);
 }
+bool thread_scheduler_set_cpu_affinity(pid_t linux_tid, uint64_t cpu_mask) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_thread_scheduler::thread_scheduler_set_cpu_affinity(
+      linux_tid, cpu_mask);
+}
 // Mocked functions complete
 // END mockcify generation
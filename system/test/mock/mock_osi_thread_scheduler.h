@@ -16,11 +16,12 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:2
+ *   Functions generated:4
  *
  *  mockcify.pl ver 0.3.0
  */
 
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <functional>
@@ -46,6 +47,22 @@ struct thread_scheduler_enable_real_time {
 extern struct thread_scheduler_enable_real_time
     thread_scheduler_enable_real_time;
 
+// Name: thread_scheduler_enable_real_time_priority
+// Params: pid_t linux_tid, int priority
+// Return: bool
+struct thread_scheduler_enable_real_time_priority {
+  bool return_value{false};
+  std::function<bool(pid_t linux_tid, int priority)> body{
+      [this](pid_t /* linux_tid */, int /* priority */) {
+        return return_value;
+      }};
+  bool operator()(pid_t linux_tid, int priority) {
+    return body(linux_tid, priority);
+  };
+};
+extern struct thread_scheduler_enable_real_time_priority
+    thread_scheduler_enable_real_time_priority;
+
 // Name: osi_fifo_scheduing_priority_range
 // Params: int& min, int& max
 // Return: bool
@@ -58,6 +75,22 @@ struct thread_scheduler_get_priority_range {
 extern struct thread_scheduler_get_priority_range
     thread_scheduler_get_priority_range;
 
+// Name: thread_scheduler_set_cpu_affinity
+// Params: pid_t linux_tid, uint64_t cpu_mask
+// Return: bool
+struct thread_scheduler_set_cpu_affinity {
+  bool return_value{false};
+  std::function<bool(pid_t linux_tid, uint64_t cpu_mask)> body{
+      [this](pid_t /* linux_tid */, uint64_t /* cpu_mask */) {
+        return return_value;
+      }};
+  bool operator()(pid_t linux_tid, uint64_t cpu_mask) {
+    return body(linux_tid, cpu_mask);
+  };
+};
+extern struct thread_scheduler_set_cpu_affinity
+    thread_scheduler_set_cpu_affinity;
+
 }  // namespace osi_thread_scheduler
 }  // namespace mock
 }  // namespace test
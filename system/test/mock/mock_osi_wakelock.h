@@ -95,6 +95,15 @@ struct wakelock_set_paths {
 };
 extern struct wakelock_set_paths wakelock_set_paths;
 
+// Name: wakelock_set_release_delay_ms
+// Params: uint64_t delay_ms
+// Return: void
+struct wakelock_set_release_delay_ms {
+  std::function<void(uint64_t delay_ms)> body{[](uint64_t /* delay_ms */) {}};
+  void operator()(uint64_t delay_ms) { body(delay_ms); };
+};
+extern struct wakelock_set_release_delay_ms wakelock_set_release_delay_ms;
+
 }  // namespace osi_wakelock
 }  // namespace mock
 }  // namespace test
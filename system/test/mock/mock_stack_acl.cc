@@ -56,6 +56,8 @@ struct acl_is_switch_role_idle acl_is_switch_role_idle;
 struct acl_peer_supports_ble_2m_phy acl_peer_supports_ble_2m_phy;
 struct acl_peer_supports_ble_coded_phy acl_peer_supports_ble_coded_phy;
 struct acl_send_data_packet_br_edr acl_send_data_packet_br_edr;
+struct acl_send_retained_data_packet_br_edr
+    acl_send_retained_data_packet_br_edr;
 struct acl_peer_supports_ble_connection_parameters_request
     acl_peer_supports_ble_connection_parameters_request;
 struct acl_ble_connection_parameters_request
@@ -287,6 +289,11 @@ void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf) {
   inc_func_call_count(__func__);
   test::mock::stack_acl::acl_send_data_packet_br_edr(bd_addr, p_buf);
 }
+void acl_send_retained_data_packet_br_edr(const RawAddress& bd_addr,
+                                          const BT_HDR* p_buf) {
+  inc_func_call_count(__func__);
+  test::mock::stack_acl::acl_send_retained_data_packet_br_edr(bd_addr, p_buf);
+}
 tACL_CONN* acl_get_connection_from_address(const RawAddress& bd_addr,
                                            tBT_TRANSPORT transport) {
   inc_func_call_count(__func__);
@@ -153,6 +153,18 @@ struct acl_send_data_packet_br_edr {
   };
 };
 extern struct acl_send_data_packet_br_edr acl_send_data_packet_br_edr;
+// Name: acl_send_retained_data_packet_br_edr
+// Params: const RawAddress& bd_addr, const BT_HDR* p_buf
+// Returns: void
+struct acl_send_retained_data_packet_br_edr {
+  std::function<void(const RawAddress& bd_addr, const BT_HDR* p_buf)> body{
+      [](const RawAddress& /* bd_addr */, const BT_HDR* /* p_buf */) {}};
+  void operator()(const RawAddress& bd_addr, const BT_HDR* p_buf) {
+    return body(bd_addr, p_buf);
+  };
+};
+extern struct acl_send_retained_data_packet_br_edr
+    acl_send_retained_data_packet_br_edr;
 // Name: acl_create_le_connection
 // Params: const RawAddress& bd_addr
 // Returns: bool
@@ -29,7 +29,6 @@
 // Mocked compile conditionals, if any
 // Mocked internal structures, if any
 struct BackgroundConnection {};
-struct BgConnHash {};
 
 namespace test {
 namespace mock {
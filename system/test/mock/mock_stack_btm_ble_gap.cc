@@ -24,6 +24,7 @@
 
 #include "stack/btm/btm_ble_int.h"
 #include "stack/btm/btm_ble_int_types.h"
+#include "stack/include/advertise_data_parser.h"
 #include "stack/include/bt_dev_class.h"
 #include "stack/include/btm_api_types.h"
 #include "stack/include/hci_error_code.h"
@@ -127,6 +128,10 @@ DEV_CLASS btm_ble_get_appearance_as_cod(
   inc_func_call_count(__func__);
   return kDevClassUnclassified;
 }
+DEV_CLASS btm_ble_get_appearance_as_cod(const AdvertiseDataIndex& /* data */) {
+  inc_func_call_count(__func__);
+  return kDevClassUnclassified;
+}
 void btm_ble_process_adv_addr(RawAddress& /* bda */,
                               tBLE_ADDR_TYPE* /* addr_type */) {
   inc_func_call_count(__func__);
@@ -41,6 +41,8 @@ struct BTM_CancelRemoteDeviceName BTM_CancelRemoteDeviceName;
 struct BTM_ClearInqDb BTM_ClearInqDb;
 struct BTM_EnableInterlacedInquiryScan BTM_EnableInterlacedInquiryScan;
 struct BTM_EnableInterlacedPageScan BTM_EnableInterlacedPageScan;
+struct BTM_RegisterExpectedReconnect BTM_RegisterExpectedReconnect;
+struct BTM_CancelExpectedReconnect BTM_CancelExpectedReconnect;
 struct BTM_GetEirSupportedServices BTM_GetEirSupportedServices;
 struct BTM_GetEirUuidList BTM_GetEirUuidList;
 struct BTM_HasEirService BTM_HasEirService;
@@ -66,6 +68,7 @@ struct btm_inq_remote_name_timer_timeout btm_inq_remote_name_timer_timeout;
 struct btm_inq_rmt_name_failed_cancelled btm_inq_rmt_name_failed_cancelled;
 struct btm_process_inq_complete btm_process_inq_complete;
 struct btm_process_remote_name btm_process_remote_name;
+struct btm_scan_policy_update btm_scan_policy_update;
 struct btm_set_eir_uuid btm_set_eir_uuid;
 struct btm_sort_inq_result btm_sort_inq_result;
 
@@ -126,6 +129,16 @@ void BTM_EnableInterlacedPageScan() {
   inc_func_call_count(__func__);
   test::mock::stack_btm_inq::BTM_EnableInterlacedPageScan();
 }
+void BTM_RegisterExpectedReconnect(const RawAddress& bd_addr,
+                                   uint64_t duration_ms) {
+  inc_func_call_count(__func__);
+  test::mock::stack_btm_inq::BTM_RegisterExpectedReconnect(bd_addr,
+                                                           duration_ms);
+}
+void BTM_CancelExpectedReconnect(const RawAddress& bd_addr) {
+  inc_func_call_count(__func__);
+  test::mock::stack_btm_inq::BTM_CancelExpectedReconnect(bd_addr);
+}
 uint8_t BTM_GetEirSupportedServices(uint32_t* p_eir_uuid, uint8_t** p,
                                     uint8_t max_num_uuid16,
                                     uint8_t* p_num_uuid16) {
@@ -239,6 +252,10 @@ void btm_process_remote_name(const RawAddress* bda, const BD_NAME bdn,
   test::mock::stack_btm_inq::btm_process_remote_name(bda, bdn, evt_len,
                                                      hci_status);
 }
+void btm_scan_policy_update(void) {
+  inc_func_call_count(__func__);
+  test::mock::stack_btm_inq::btm_scan_policy_update();
+}
 void btm_set_eir_uuid(const uint8_t* p_eir, tBTM_INQ_RESULTS* p_results) {
   inc_func_call_count(__func__);
   test::mock::stack_btm_inq::btm_set_eir_uuid(p_eir, p_results);
@@ -107,6 +107,28 @@ struct BTM_EnableInterlacedPageScan {
 };
 extern struct BTM_EnableInterlacedPageScan BTM_EnableInterlacedPageScan;
 
+// Name: BTM_RegisterExpectedReconnect
+// Params: const RawAddress& bd_addr, uint64_t duration_ms
+// Return: void
+struct BTM_RegisterExpectedReconnect {
+  std::function<void(const RawAddress& bd_addr, uint64_t duration_ms)> body{
+      [](const RawAddress& /* bd_addr */, uint64_t /* duration_ms */) {}};
+  void operator()(const RawAddress& bd_addr, uint64_t duration_ms) {
+    body(bd_addr, duration_ms);
+  };
+};
+extern struct BTM_RegisterExpectedReconnect BTM_RegisterExpectedReconnect;
+
+// Name: BTM_CancelExpectedReconnect
+// Params: const RawAddress& bd_addr
+// Return: void
+struct BTM_CancelExpectedReconnect {
+  std::function<void(const RawAddress& bd_addr)> body{
+      [](const RawAddress& /* bd_addr */) {}};
+  void operator()(const RawAddress& bd_addr) { body(bd_addr); };
+};
+extern struct BTM_CancelExpectedReconnect BTM_CancelExpectedReconnect;
+
 // Name: BTM_GetEirSupportedServices
 // Params: uint32_t* p_eir_uuid, uint8_t** p, uint8_t max_num_uuid16, uint8_t*
 // p_num_uuid16 Return: uint8_t
@@ -407,6 +429,15 @@ struct btm_process_remote_name {
 };
 extern struct btm_process_remote_name btm_process_remote_name;
 
+// Name: btm_scan_policy_update
+// Params: void
+// Return: void
+struct btm_scan_policy_update {
+  std::function<void(void)> body{[](void) {}};
+  void operator()(void) { body(); };
+};
+extern struct btm_scan_policy_update btm_scan_policy_update;
+
 // Name: btm_set_eir_uuid
 // Params: const uint8_t* p_eir, tBTM_INQ_RESULTS* p_results
 // Return: void
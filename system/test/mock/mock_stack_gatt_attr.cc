@@ -39,6 +39,10 @@ bool gatt_profile_get_eatt_support(
   inc_func_call_count(__func__);
   return false;
 }
+bool gatt_profile_get_eatt_support(const RawAddress& /* remote_bda */) {
+  inc_func_call_count(__func__);
+  return false;
+}
 bool gatt_sr_is_cl_change_aware(tGATT_TCB& /* tcb */) {
   inc_func_call_count(__func__);
   return false;
@@ -37,6 +37,7 @@ namespace stack_l2cap_ble {
 
 // Function state capture and return values, if needed
 struct L2CA_UpdateBleConnParams L2CA_UpdateBleConnParams;
+struct L2CA_UpdateBleConnParamsForClient L2CA_UpdateBleConnParamsForClient;
 struct L2CA_LockBleConnParamsForServiceDiscovery
     L2CA_LockBleConnParamsForServiceDiscovery;
 struct L2CA_LockBleConnParamsForProfileConnection
@@ -51,6 +52,9 @@ struct l2cble_create_conn l2cble_create_conn;
 struct l2c_link_processs_ble_num_bufs l2c_link_processs_ble_num_bufs;
 struct l2c_ble_link_adjust_allocation l2c_ble_link_adjust_allocation;
 struct l2cble_update_data_length l2cble_update_data_length;
+struct l2cble_tuner_count l2cble_tuner_count;
+struct l2cble_lock_conn_params_for_bulk_transfer
+    l2cble_lock_conn_params_for_bulk_transfer;
 struct l2cble_process_data_length_change_event
     l2cble_process_data_length_change_event;
 struct l2cble_credit_based_conn_req l2cble_credit_based_conn_req;
@@ -78,6 +82,17 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
   return test::mock::stack_l2cap_ble::L2CA_UpdateBleConnParams(
       rem_bda, min_int, max_int, latency, timeout, min_ce_len, max_ce_len);
 }
+bool L2CA_UpdateBleConnParamsForClient(tL2CAP_CONN_PARAMS_CLIENT client,
+                                       const RawAddress& rem_bda,
+                                       uint16_t min_int, uint16_t max_int,
+                                       uint16_t latency, uint16_t timeout,
+                                       uint16_t min_ce_len,
+                                       uint16_t max_ce_len) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_ble::L2CA_UpdateBleConnParamsForClient(
+      client, rem_bda, min_int, max_int, latency, timeout, min_ce_len,
+      max_ce_len);
+}
 void L2CA_LockBleConnParamsForServiceDiscovery(const RawAddress& rem_bda,
                                                bool enable) {
   inc_func_call_count(__func__);
@@ -136,6 +151,15 @@ void l2cble_update_data_length(tL2C_LCB* p_lcb) {
   inc_func_call_count(__func__);
   test::mock::stack_l2cap_ble::l2cble_update_data_length(p_lcb);
 }
+void l2cble_tuner_count(tL2C_LCB* p_lcb, uint16_t bytes, bool is_tx) {
+  inc_func_call_count(__func__);
+  test::mock::stack_l2cap_ble::l2cble_tuner_count(p_lcb, bytes, is_tx);
+}
+void l2cble_lock_conn_params_for_bulk_transfer(tL2C_LCB* p_lcb, bool lock) {
+  inc_func_call_count(__func__);
+  test::mock::stack_l2cap_ble::l2cble_lock_conn_params_for_bulk_transfer(
+      p_lcb, lock);
+}
 void l2cble_process_data_length_change_event(uint16_t handle,
                                              uint16_t tx_data_len,
                                              uint16_t rx_data_len) {
@@ -56,6 +56,30 @@ struct L2CA_UpdateBleConnParams {
   };
 };
 extern struct L2CA_UpdateBleConnParams L2CA_UpdateBleConnParams;
+// Name: L2CA_UpdateBleConnParamsForClient
+// Params: tL2CAP_CONN_PARAMS_CLIENT client, const RawAddress& rem_bda,
+// uint16_t min_int, uint16_t max_int, uint16_t latency, uint16_t timeout,
+// uint16_t min_ce_len, uint16_t max_ce_len
+// Returns: bool
+struct L2CA_UpdateBleConnParamsForClient {
+  std::function<bool(tL2CAP_CONN_PARAMS_CLIENT client,
+                     const RawAddress& rem_bda, uint16_t min_int,
+                     uint16_t max_int, uint16_t latency, uint16_t timeout,
+                     uint16_t min_ce_len, uint16_t max_ce_len)>
+      body{[](tL2CAP_CONN_PARAMS_CLIENT /* client */,
+              const RawAddress& /* rem_bda */, uint16_t /* min_int */,
+              uint16_t /* max_int */, uint16_t /* latency */,
+              uint16_t /* timeout */, uint16_t /* min_ce_len */,
+              uint16_t /* max_ce_len */) { return false; }};
+  bool operator()(tL2CAP_CONN_PARAMS_CLIENT client, const RawAddress& rem_bda,
+                  uint16_t min_int, uint16_t max_int, uint16_t latency,
+                  uint16_t timeout, uint16_t min_ce_len, uint16_t max_ce_len) {
+    return body(client, rem_bda, min_int, max_int, latency, timeout,
+                min_ce_len, max_ce_len);
+  };
+};
+extern struct L2CA_UpdateBleConnParamsForClient
+    L2CA_UpdateBleConnParamsForClient;
 // Name: L2CA_LockBleConnParamsForServiceDiscovery
 // Params: const RawAddress& rem_bda, bool enable
 // Returns: void
@@ -187,6 +211,27 @@ struct l2cble_update_data_length {
   void operator()(tL2C_LCB* p_lcb) { body(p_lcb); };
 };
 extern struct l2cble_update_data_length l2cble_update_data_length;
+// Name: l2cble_tuner_count
+// Params: tL2C_LCB* p_lcb, uint16_t bytes, bool is_tx
+// Returns: void
+struct l2cble_tuner_count {
+  std::function<void(tL2C_LCB* p_lcb, uint16_t bytes, bool is_tx)> body{
+      [](tL2C_LCB* /* p_lcb */, uint16_t /* bytes */, bool /* is_tx */) {}};
+  void operator()(tL2C_LCB* p_lcb, uint16_t bytes, bool is_tx) {
+    body(p_lcb, bytes, is_tx);
+  };
+};
+extern struct l2cble_tuner_count l2cble_tuner_count;
+// Name: l2cble_lock_conn_params_for_bulk_transfer
+// Params: tL2C_LCB* p_lcb, bool lock
+// Returns: void
+struct l2cble_lock_conn_params_for_bulk_transfer {
+  std::function<void(tL2C_LCB* p_lcb, bool lock)> body{
+      [](tL2C_LCB* /* p_lcb */, bool /* lock */) {}};
+  void operator()(tL2C_LCB* p_lcb, bool lock) { body(p_lcb, lock); };
+};
+extern struct l2cble_lock_conn_params_for_bulk_transfer
+    l2cble_lock_conn_params_for_bulk_transfer;
 // Name: l2cble_process_data_length_change_event
 // Params: uint16_t handle, uint16_t tx_data_len, uint16_t rx_data_len
 // Returns: void
@@ -48,6 +48,7 @@ struct log_manufacturer_info log_manufacturer_info;
 struct log_counter_metrics log_counter_metrics;
 struct log_hfp_audio_packet_loss_stats log_hfp_audio_packet_loss_stats;
 struct log_mmc_transcode_rtt_stats log_mmc_transcode_rtt_stats;
+struct log_gatt_att_latency_stats log_gatt_att_latency_stats;
 
 }  // namespace stack_metrics_logging
 }  // namespace mock
@@ -134,4 +135,14 @@ void log_mmc_transcode_rtt_stats(int maximum_rtt, double mean_rtt,
   test::mock::stack_metrics_logging::log_mmc_transcode_rtt_stats(
       maximum_rtt, mean_rtt, num_requests, codec_type);
 }
+
+void log_gatt_att_latency_stats(const RawAddress& address, uint8_t op_code,
+                                bool is_eatt, int num_requests,
+                                double mean_latency_ms, int max_latency_ms,
+                                uint16_t mtu) {
+  inc_func_call_count(__func__);
+  test::mock::stack_metrics_logging::log_gatt_att_latency_stats(
+      address, op_code, is_eatt, num_requests, mean_latency_ms, max_latency_ms,
+      mtu);
+}
 // END mockcify generation
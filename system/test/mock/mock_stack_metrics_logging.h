@@ -212,6 +212,24 @@ struct log_mmc_transcode_rtt_stats {
   };
 };
 extern struct log_mmc_transcode_rtt_stats log_mmc_transcode_rtt_stats;
+
+// Name: log_gatt_att_latency_stats
+struct log_gatt_att_latency_stats {
+  std::function<void(const RawAddress& address, uint8_t op_code, bool is_eatt,
+                     int num_requests, double mean_latency_ms,
+                     int max_latency_ms, uint16_t mtu)>
+      body{[](const RawAddress& /* address */, uint8_t /* op_code */,
+              bool /* is_eatt */, int /* num_requests */,
+              double /* mean_latency_ms */, int /* max_latency_ms */,
+              uint16_t /* mtu */) {}};
+  void operator()(const RawAddress& address, uint8_t op_code, bool is_eatt,
+                  int num_requests, double mean_latency_ms, int max_latency_ms,
+                  uint16_t mtu) {
+    body(address, op_code, is_eatt, num_requests, mean_latency_ms,
+         max_latency_ms, mtu);
+  };
+};
+extern struct log_gatt_att_latency_stats log_gatt_att_latency_stats;
 }  // namespace stack_metrics_logging
 }  // namespace mock
 }  // namespace test
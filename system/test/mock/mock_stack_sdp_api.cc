@@ -45,6 +45,7 @@ struct SDP_FindServiceUUIDInRec_128bit SDP_FindServiceUUIDInRec_128bit;
 struct SDP_InitDiscoveryDb SDP_InitDiscoveryDb;
 struct SDP_ServiceSearchAttributeRequest SDP_ServiceSearchAttributeRequest;
 struct SDP_ServiceSearchAttributeRequest2 SDP_ServiceSearchAttributeRequest2;
+struct SDP_ServiceSearchAttributeFromCache SDP_ServiceSearchAttributeFromCache;
 struct SDP_ServiceSearchRequest SDP_ServiceSearchRequest;
 struct SDP_FindAttributeInRec SDP_FindAttributeInRec;
 struct SDP_FindServiceInDb SDP_FindServiceInDb;
@@ -109,6 +110,12 @@ bool SDP_ServiceSearchAttributeRequest2(
   return test::mock::stack_sdp_api::SDP_ServiceSearchAttributeRequest2(
       p_bd_addr, p_db, complete_callback);
 }
+bool SDP_ServiceSearchAttributeFromCache(const RawAddress& p_bd_addr,
+                                         tSDP_DISCOVERY_DB* p_db) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_sdp_api::SDP_ServiceSearchAttributeFromCache(
+      p_bd_addr, p_db);
+}
 bool SDP_ServiceSearchRequest(const RawAddress& p_bd_addr,
                               tSDP_DISCOVERY_DB* p_db,
                               tSDP_DISC_CMPL_CB* p_cb) {
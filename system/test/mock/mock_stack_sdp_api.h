@@ -155,6 +155,19 @@ struct SDP_ServiceSearchAttributeRequest2 {
 };
 extern struct SDP_ServiceSearchAttributeRequest2
     SDP_ServiceSearchAttributeRequest2;
+// Name: SDP_ServiceSearchAttributeFromCache
+// Params: const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db
+// Returns: bool
+struct SDP_ServiceSearchAttributeFromCache {
+  std::function<bool(const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db)>
+      body{[](const RawAddress& /* p_bd_addr */,
+              tSDP_DISCOVERY_DB* /* p_db */) { return false; }};
+  bool operator()(const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db) {
+    return body(p_bd_addr, p_db);
+  };
+};
+extern struct SDP_ServiceSearchAttributeFromCache
+    SDP_ServiceSearchAttributeFromCache;
 // Name: SDP_ServiceSearchRequest
 // Params: const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db,
 // tSDP_DISC_CMPL_CB* p_cb Returns: bool
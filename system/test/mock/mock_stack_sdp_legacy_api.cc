@@ -35,6 +35,7 @@ bluetooth::legacy::stack::sdp::tSdpApi api_ = {
             .SDP_ServiceSearchRequest = nullptr,
             .SDP_ServiceSearchAttributeRequest = nullptr,
             .SDP_ServiceSearchAttributeRequest2 = nullptr,
+            .SDP_ServiceSearchAttributeFromCache = nullptr,
         },
     .db =
         {
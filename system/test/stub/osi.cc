@@ -286,6 +286,11 @@ fixed_queue_t* fixed_queue_new(size_t capacity) {
   inc_func_call_count(__func__);
   return nullptr;
 }
+fixed_queue_t* fixed_queue_new_with_type(size_t capacity,
+                                         fixed_queue_type_t type) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   inc_func_call_count(__func__);
   return 0;
@@ -302,6 +307,9 @@ size_t fixed_queue_capacity(fixed_queue_t* queue) {
   inc_func_call_count(__func__);
   return 0;
 }
+void fixed_queue_set_buffer_owner(fixed_queue_t* queue, buffer_owner_t owner) {
+  inc_func_call_count(__func__);
+}
 size_t fixed_queue_length(fixed_queue_t* queue) {
   inc_func_call_count(__func__);
   return 0;
@@ -386,6 +394,17 @@ void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
   fake_osi_alarm_set_on_mloop_.data = data;
 }
 
+void alarm_set_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                          uint64_t slack_ms, alarm_callback_t cb, void* data) {
+  inc_func_call_count(__func__);
+}
+
+void alarm_set_on_mloop_with_slack(alarm_t* alarm, uint64_t interval_ms,
+                                   uint64_t slack_ms, alarm_callback_t cb,
+                                   void* data) {
+  alarm_set_on_mloop(alarm, interval_ms, cb, data);
+}
+
 bool socket_listen(const socket_t* socket, port_t port) {
   inc_func_call_count(__func__);
   return false;
@@ -585,3 +604,6 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   inc_func_call_count(__func__);
 }
+void wakelock_set_release_delay_ms(uint64_t delay_ms) {
+  inc_func_call_count(__func__);
+}
@@ -38,13 +38,23 @@ namespace {
 constexpr Uuid kBase = Uuid::From128BitBE(
     UUID128Bit{{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
                 0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb}});
+
+// UUIDs are compared a word at a time rather than byte by byte
+uint64_t Load64(const uint8_t* p) {
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+uint32_t Load32(const uint8_t* p) {
+  uint32_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
 }  // namespace
 
 size_t Uuid::GetShortestRepresentationSize() const {
-  if (memcmp(uu.data() + kNumBytes32, kBase.uu.data() + kNumBytes32,
-             kNumBytes128 - kNumBytes32) != 0) {
-    return kNumBytes128;
-  }
+  if (!IsBaseDerived()) return kNumBytes128;
 
   if (uu[0] == 0 && uu[1] == 0) return kNumBytes16;
 
@@ -55,6 +65,15 @@ bool Uuid::Is16Bit() const {
   return GetShortestRepresentationSize() == kNumBytes16;
 }
 
+bool Uuid::IsBaseDerived() const {
+  return Load64(uu.data() + 8) == Load64(kBase.uu.data() + 8) &&
+         Load32(uu.data() + 4) == Load32(kBase.uu.data() + 4);
+}
+
+bool Uuid::Equals16Bit(uint16_t uuid16) const {
+  return uu[0] == 0 && uu[1] == 0 && As16Bit() == uuid16 && IsBaseDerived();
+}
+
 uint16_t Uuid::As16Bit() const { return (((uint16_t)uu[2]) << 8) + uu[3]; }
 
 uint32_t Uuid::As32Bit() const {
@@ -158,14 +177,53 @@ void Uuid::UpdateUuid(const Uuid& uuid) {
   uu = uuid.uu;
 }
 
+size_t Uuid::FindIn(const Uuid* uuids, size_t count) const {
+  const uint64_t high = Load64(uu.data());
+  const uint64_t low = Load64(uu.data() + 8);
+  size_t i = 0;
+
+  // Compare four UUIDs at a time without a branch per UUID, so the compiler
+  // can use vector compares, and only look for the match in a block that has
+  // one.
+  for (; i + 4 <= count; i += 4) {
+    uint64_t diff[4];
+    for (size_t j = 0; j < 4; j++) {
+      const uint8_t* other = uuids[i + j].uu.data();
+      diff[j] = (Load64(other) ^ high) | (Load64(other + 8) ^ low);
+    }
+    if (diff[0] == 0 || diff[1] == 0 || diff[2] == 0 || diff[3] == 0) {
+      for (size_t j = 0; j < 4; j++) {
+        if (diff[j] == 0) return i + j;
+      }
+    }
+  }
+
+  for (; i < count; i++) {
+    if (uuids[i] == *this) return i;
+  }
+  return count;
+}
+
+size_t Uuid::Hash() const {
+  // The UUIDs built on the Base UUID only differ in their first word: mix it
+  // into the high bits too so they spread over the buckets.
+  uint64_t hash = Load64(uu.data()) * 0x9e3779b97f4a7c15ull;
+  hash ^= Load64(uu.data() + 8);
+  hash ^= hash >> 32;
+  return static_cast<size_t>(hash);
+}
+
 bool Uuid::operator<(const Uuid& rhs) const {
   return std::lexicographical_compare(uu.begin(), uu.end(), rhs.uu.begin(),
                                       rhs.uu.end());
 }
 
-bool Uuid::operator==(const Uuid& rhs) const { return uu == rhs.uu; }
+bool Uuid::operator==(const Uuid& rhs) const {
+  return ((Load64(uu.data()) ^ Load64(rhs.uu.data())) |
+          (Load64(uu.data() + 8) ^ Load64(rhs.uu.data() + 8))) == 0;
+}
 
-bool Uuid::operator!=(const Uuid& rhs) const { return uu != rhs.uu; }
+bool Uuid::operator!=(const Uuid& rhs) const { return !(*this == rhs); }
 
 std::string Uuid::ToString() const {
   std::stringstream uuid;
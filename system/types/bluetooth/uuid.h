@@ -54,6 +54,14 @@ class Uuid final {
   // Returns true if this UUID can be represented as 16 bit.
   bool Is16Bit() const;
 
+  // Returns true if this UUID is built on the Bluetooth Base UUID, i.e. it can
+  // be represented as 16 or 32 bit.
+  bool IsBaseDerived() const;
+
+  // Returns true if this UUID is the 16 bit UUID |uuid16|. Cheaper than
+  // comparing with From16Bit(uuid16).
+  bool Equals16Bit(uint16_t uuid16) const;
+
   // Returns 16 bit Little Endian representation of this UUID. Use
   // GetShortestRepresentationSize() or Is16Bit() before using this method.
   uint16_t As16Bit() const;
@@ -110,6 +118,13 @@ class Uuid final {
   // Update UUID with new value
   void UpdateUuid(const Uuid& uuid);
 
+  // Returns the index of the first of the |count| UUIDs at |uuids| equal to
+  // this UUID, or |count| if there is none.
+  size_t FindIn(const Uuid* uuids, size_t count) const;
+
+  // Returns a hash of this UUID for the unordered containers.
+  size_t Hash() const;
+
   bool operator<(const Uuid& rhs) const;
   bool operator==(const Uuid& rhs) const;
   bool operator!=(const Uuid& rhs) const;
@@ -135,10 +150,7 @@ namespace std {
 template <>
 struct hash<bluetooth::Uuid> {
   std::size_t operator()(const bluetooth::Uuid& key) const {
-    const auto& uuid_bytes = key.To128BitBE();
-    std::hash<std::string> hash_fn;
-    return hash_fn(std::string(reinterpret_cast<const char*>(uuid_bytes.data()),
-                               uuid_bytes.size()));
+    return key.Hash();
   }
 };
 
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <initializer_list>
+#include <unordered_set>
+
+#include "bluetooth/uuid.h"
+
+namespace bluetooth {
+
+// A hashed set of UUIDs, for the filters and lookups that test many UUIDs
+// against the same set. Most UUIDs met over the air are 16 bit ones, so those
+// are kept apart as their 16 bit value: testing a 16 bit UUID or a UUID built
+// on the Base UUID hashes 2 bytes and never looks at the 128 bit ones.
+class UuidSet final {
+ public:
+  UuidSet() = default;
+  UuidSet(std::initializer_list<Uuid> uuids) {
+    for (const Uuid& uuid : uuids) Insert(uuid);
+  }
+
+  // Returns true if |uuid| was not in the set already.
+  bool Insert(const Uuid& uuid) {
+    if (uuid.Is16Bit()) return uuids16_.insert(uuid.As16Bit()).second;
+    return uuids_.insert(uuid).second;
+  }
+
+  // Returns true if |uuid| was in the set.
+  bool Erase(const Uuid& uuid) {
+    if (uuid.Is16Bit()) return uuids16_.erase(uuid.As16Bit()) != 0;
+    return uuids_.erase(uuid) != 0;
+  }
+
+  bool Contains(const Uuid& uuid) const {
+    if (uuid.Is16Bit()) return Contains16Bit(uuid.As16Bit());
+    return !uuids_.empty() && uuids_.count(uuid) != 0;
+  }
+
+  bool Contains16Bit(uint16_t uuid16) const {
+    return uuids16_.count(uuid16) != 0;
+  }
+
+  // Returns true if any of the |count| UUIDs at |uuids| is in the set.
+  bool ContainsAny(const Uuid* uuids, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+      if (Contains(uuids[i])) return true;
+    }
+    return false;
+  }
+
+  size_t size() const { return uuids16_.size() + uuids_.size(); }
+  bool empty() const { return uuids16_.empty() && uuids_.empty(); }
+  void clear() {
+    uuids16_.clear();
+    uuids_.clear();
+  }
+
+ private:
+  std::unordered_set<uint16_t> uuids16_;
+  std::unordered_set<Uuid> uuids_;
+};
+
+}  // namespace bluetooth
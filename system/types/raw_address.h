@@ -85,6 +85,9 @@ inline std::ostream& operator<<(std::ostream& os, const RawAddress& a) {
   return os;
 }
 
+// std::hash<uint64_t> is the identity in libc++ and libstdc++, which keeps
+// the first address byte in the low bits the buckets are picked from; mix
+// all the 48 bits in with the splitmix64 finalizer instead.
 template <>
 struct std::hash<RawAddress> {
   std::size_t operator()(const RawAddress& val) const {
@@ -92,7 +95,9 @@ struct std::hash<RawAddress> {
     uint64_t int_addr = 0;
     memcpy(reinterpret_cast<uint8_t*>(&int_addr), val.address,
            RawAddress::kLength);
-    return std::hash<uint64_t>{}(int_addr);
+    int_addr = (int_addr ^ (int_addr >> 30)) * 0xbf58476d1ce4e5b9ull;
+    int_addr = (int_addr ^ (int_addr >> 27)) * 0x94d049bb133111ebull;
+    return static_cast<std::size_t>(int_addr ^ (int_addr >> 31));
   }
 };
 
@@ -17,8 +17,12 @@
  ******************************************************************************/
 
 #include <bluetooth/uuid.h>
+#include <bluetooth/uuid_set.h>
 #include <gtest/gtest.h>
 
+#include <unordered_set>
+#include <vector>
+
 using bluetooth::Uuid;
 
 static const Uuid ONES = Uuid::From128BitBE(
@@ -68,6 +72,108 @@ TEST(UuidTest, Is16Bit) {
   EXPECT_TRUE(Uuid::FromString("1ae8").Is16Bit());
 }
 
+TEST(UuidTest, IsBaseDerived) {
+  EXPECT_TRUE(kBase.IsBaseDerived());
+  EXPECT_TRUE(Uuid::From16Bit(0x1ae8).IsBaseDerived());
+  EXPECT_TRUE(Uuid::From32Bit(0x01234567).IsBaseDerived());
+  EXPECT_FALSE(ONES.IsBaseDerived());
+  EXPECT_FALSE(SEQUENTIAL.IsBaseDerived());
+  EXPECT_FALSE(Uuid::kEmpty.IsBaseDerived());
+
+  // A single byte off the Base UUID in either word
+  auto bytes = kBase.To128BitBE();
+  bytes[5] = 0x01;
+  EXPECT_FALSE(Uuid::From128BitBE(bytes).IsBaseDerived());
+  bytes = kBase.To128BitBE();
+  bytes[15] = 0xfa;
+  EXPECT_FALSE(Uuid::From128BitBE(bytes).IsBaseDerived());
+}
+
+TEST(UuidTest, Equals16Bit) {
+  EXPECT_TRUE(Uuid::From16Bit(0x1ae8).Equals16Bit(0x1ae8));
+  EXPECT_TRUE(kBase.Equals16Bit(0x0000));
+  EXPECT_FALSE(Uuid::From16Bit(0x1ae8).Equals16Bit(0x1ae9));
+  EXPECT_FALSE(Uuid::From32Bit(0x00011ae8).Equals16Bit(0x1ae8));
+  // Same 16 bit value but not built on the Base UUID
+  EXPECT_EQ((uint16_t)0x1111, ONES.As16Bit());
+  EXPECT_FALSE(ONES.Equals16Bit(0x1111));
+}
+
+TEST(UuidTest, Equality) {
+  EXPECT_TRUE(ONES == ONES);
+  EXPECT_FALSE(ONES == SEQUENTIAL);
+  EXPECT_TRUE(ONES != SEQUENTIAL);
+  EXPECT_FALSE(kBase != Uuid::From16Bit(0x0000));
+
+  for (size_t i = 0; i < Uuid::kNumBytes128; i++) {
+    auto bytes = SEQUENTIAL.To128BitBE();
+    bytes[i] ^= 0x80;
+    EXPECT_NE(SEQUENTIAL, Uuid::From128BitBE(bytes)) << "byte " << i;
+  }
+}
+
+TEST(UuidTest, FindIn) {
+  std::vector<Uuid> uuids;
+  for (uint16_t i = 0; i < 11; i++) uuids.push_back(Uuid::From16Bit(i));
+  uuids.push_back(SEQUENTIAL);
+
+  for (size_t i = 0; i < uuids.size(); i++) {
+    EXPECT_EQ(i, uuids[i].FindIn(uuids.data(), uuids.size()));
+  }
+  EXPECT_EQ(uuids.size(), ONES.FindIn(uuids.data(), uuids.size()));
+  EXPECT_EQ(0u, ONES.FindIn(nullptr, 0));
+
+  // The first match is returned
+  uuids[7] = SEQUENTIAL;
+  EXPECT_EQ(7u, SEQUENTIAL.FindIn(uuids.data(), uuids.size()));
+}
+
+TEST(UuidTest, Hash) {
+  std::hash<Uuid> hash;
+  EXPECT_EQ(hash(SEQUENTIAL),
+            hash(Uuid::From128BitBE(SEQUENTIAL.To128BitBE())));
+
+  std::unordered_set<size_t> hashes;
+  for (uint32_t i = 0; i < 0x10000; i++) {
+    hashes.insert(hash(Uuid::From16Bit(i)));
+  }
+  EXPECT_EQ(0x10000u, hashes.size());
+}
+
+TEST(UuidSetTest, Contains) {
+  bluetooth::UuidSet set{Uuid::From16Bit(0x180f), Uuid::From32Bit(0x01234567),
+                         SEQUENTIAL};
+  EXPECT_EQ(3u, set.size());
+  EXPECT_TRUE(set.Contains(Uuid::From16Bit(0x180f)));
+  EXPECT_TRUE(set.Contains16Bit(0x180f));
+  EXPECT_TRUE(set.Contains(Uuid::From32Bit(0x01234567)));
+  EXPECT_TRUE(set.Contains(SEQUENTIAL));
+  EXPECT_FALSE(set.Contains(Uuid::From16Bit(0x180a)));
+  EXPECT_FALSE(set.Contains16Bit(0x4567));
+  EXPECT_FALSE(set.Contains(ONES));
+
+  EXPECT_FALSE(set.Insert(SEQUENTIAL));
+  EXPECT_TRUE(set.Insert(ONES));
+  EXPECT_TRUE(set.Contains(ONES));
+  EXPECT_TRUE(set.Erase(Uuid::From16Bit(0x180f)));
+  EXPECT_FALSE(set.Erase(Uuid::From16Bit(0x180f)));
+  EXPECT_FALSE(set.Contains16Bit(0x180f));
+  EXPECT_EQ(3u, set.size());
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.Contains(SEQUENTIAL));
+}
+
+TEST(UuidSetTest, ContainsAny) {
+  bluetooth::UuidSet set{Uuid::From16Bit(0x1812)};
+  const Uuid advertised[] = {Uuid::From16Bit(0x180f), ONES,
+                             Uuid::From16Bit(0x1812)};
+  EXPECT_TRUE(set.ContainsAny(advertised, 3));
+  EXPECT_FALSE(set.ContainsAny(advertised, 2));
+  EXPECT_FALSE(bluetooth::UuidSet{}.ContainsAny(advertised, 3));
+}
+
 TEST(UuidTest, From16Bit) {
   EXPECT_EQ(Uuid::From16Bit(0x0000), kBase);
 
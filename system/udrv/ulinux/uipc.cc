@@ -621,11 +621,32 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
   }
 
   while (n_read < (int)len) {
+    /* take what is already queued without waiting: the stack reads when data
+       is expected, so polling first would cost a syscall per read */
+    ssize_t n;
+    OSI_NO_INTR(n = recv(fd, p_buf + n_read, len - n_read, MSG_DONTWAIT));
+
+    if (n > 0) {
+      n_read += n;
+      continue;
+    }
+
+    if (n == 0) {
+      log::warn("UIPC_Read : channel detached remotely");
+      std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+      uipc_close_locked(uipc, ch_id);
+      return 0;
+    }
+
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      log::warn("UIPC_Read : read failed ({})", strerror(errno));
+      return 0;
+    }
+
     pfd.fd = fd;
     pfd.events = POLLIN | POLLHUP;
 
-    /* make sure there is data prior to attempting read to avoid blocking
-       a read for more than poll timeout */
+    /* wait for more data, for no more than the poll timeout */
 
     int poll_ret;
     OSI_NO_INTR(poll_ret = poll(&pfd, 1, uipc.ch[ch_id].read_poll_tmo_ms));
@@ -639,29 +660,12 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
       break;
     }
 
-    if (pfd.revents & (POLLHUP | POLLNVAL)) {
+    if ((pfd.revents & (POLLHUP | POLLNVAL)) && !(pfd.revents & POLLIN)) {
       log::warn("poll : channel detached remotely");
       std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
       uipc_close_locked(uipc, ch_id);
       return 0;
     }
-
-    ssize_t n;
-    OSI_NO_INTR(n = recv(fd, p_buf + n_read, len - n_read, 0));
-
-    if (n == 0) {
-      log::warn("UIPC_Read : channel detached remotely");
-      std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
-      uipc_close_locked(uipc, ch_id);
-      return 0;
-    }
-
-    if (n < 0) {
-      log::warn("UIPC_Read : read failed ({})", strerror(errno));
-      return 0;
-    }
-
-    n_read += n;
   }
 
   return n_read;
@@ -50,6 +50,12 @@ DEFINE_bool(enable_baseband_sniffer, false, "enable baseband sniffer");
 DEFINE_bool(enable_pcap_filter, false, "enable PCAP filter");
 DEFINE_bool(disable_address_reuse, false,
             "prevent rootcanal from reusing device addresses");
+DEFINE_uint32(tick_threads, 0,
+              "number of threads ticking the devices in parallel, packets "
+              "are then delivered in device order after each tick");
+DEFINE_uint32(fast_forward_idle_ms, 0,
+              "skip to the next scheduled event once no socket has been "
+              "active for this many milliseconds, 0 runs in real time");
 DEFINE_uint32(test_port, 6401, "test tcp port");
 DEFINE_uint32(hci_port, 6402, "hci server tcp port");
 DEFINE_uint32(link_port, 6403, "link server tcp port");
@@ -140,7 +146,8 @@ int main(int argc, char** argv) {
       static_cast<int>(FLAGS_link_port), static_cast<int>(FLAGS_link_ble_port),
       configuration_str, FLAGS_enable_hci_sniffer,
       FLAGS_enable_baseband_sniffer, FLAGS_enable_pcap_filter,
-      FLAGS_disable_address_reuse);
+      FLAGS_disable_address_reuse, static_cast<size_t>(FLAGS_tick_threads),
+      std::chrono::milliseconds(FLAGS_fast_forward_idle_ms));
 
   std::promise<void> barrier;
   std::future<void> barrier_future = barrier.get_future();
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <functional>
 #include <future>
 #include <memory>
@@ -56,7 +57,9 @@ class TestEnvironment {
       int test_port, int hci_port, int link_port, int link_ble_port,
       std::string const& config_str,
       bool enable_hci_sniffer = false, bool enable_baseband_sniffer = false,
-      bool enable_pcap_filter = false, bool disable_address_reuse = false);
+      bool enable_pcap_filter = false, bool disable_address_reuse = false,
+      size_t tick_threads = 0,
+      std::chrono::milliseconds fast_forward_idle_time = {});
 
   void initialize(std::promise<void> barrier);
   void close();
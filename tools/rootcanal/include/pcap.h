@@ -21,6 +21,8 @@
 #include <limits>
 #include <ostream>
 
+#include "simulation_clock.h"
+
 namespace rootcanal::pcap {
 
 using namespace std::literals;
@@ -44,7 +46,10 @@ static void WriteHeader(std::ostream& output, uint32_t linktype) {
 }
 
 static void WriteRecordHeader(std::ostream& output, uint32_t length) {
-  auto time = std::chrono::system_clock::now().time_since_epoch();
+  // Offset by the time skipped in fast-forward, so that the captures show the
+  // timeline of the simulation.
+  auto time = std::chrono::system_clock::now().time_since_epoch() +
+              SimulationClock::GetOffset();
 
   // https://tools.ietf.org/id/draft-gharris-opsawg-pcap-00.html#name-packet-record
   uint32_t seconds = time / 1s;
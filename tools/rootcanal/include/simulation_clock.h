@@ -0,0 +1,44 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+
+namespace rootcanal {
+
+// Clock of the simulated devices and of the tasks of the async manager.
+// The clock runs with std::chrono::steady_clock and shares its time points,
+// plus an offset that only grows when the async manager fast-forwards
+// to the next scheduled task while the simulation is idle.
+class SimulationClock {
+ public:
+  using duration = std::chrono::steady_clock::duration;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::steady_clock::time_point;
+  static constexpr bool is_steady = true;
+
+  static time_point now();
+
+  // Move the clock forward by |delay|, skipping the interval.
+  static void Advance(duration delay);
+
+  // Total time skipped since the start of the program.
+  static duration GetOffset();
+};
+
+}  // namespace rootcanal
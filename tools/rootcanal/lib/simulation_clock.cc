@@ -0,0 +1,39 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "simulation_clock.h"
+
+#include <atomic>
+
+namespace rootcanal {
+
+static std::atomic<SimulationClock::rep> offset{0};
+
+SimulationClock::time_point SimulationClock::now() {
+  return std::chrono::steady_clock::now() + GetOffset();
+}
+
+void SimulationClock::Advance(duration delay) {
+  if (delay > duration::zero()) {
+    offset += delay.count();
+  }
+}
+
+SimulationClock::duration SimulationClock::GetOffset() {
+  return duration(offset.load());
+}
+
+}  // namespace rootcanal
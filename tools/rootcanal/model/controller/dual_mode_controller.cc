@@ -74,9 +74,26 @@ void DualModeController::ReceiveLinkLayerPacket(
     model::packets::LinkLayerPacketView incoming, Phy::Type /*type*/,
     int8_t rssi) {
   link_layer_controller_.IncomingPacket(incoming, rssi);
+  UpdateLinkLayerInterests();
 }
 
-void DualModeController::Tick() { link_layer_controller_.Tick(); }
+void DualModeController::Tick() {
+  link_layer_controller_.Tick();
+  UpdateLinkLayerInterests();
+}
+
+void DualModeController::UpdateLinkLayerInterests() {
+  // The scanning, initiating and inquiry scan states only change on HCI
+  // commands, received packets and ticks.
+  uint8_t interests = 0;
+  if (link_layer_controller_.IsLeScanningOrInitiating()) {
+    interests |= LinkLayerInterestBit(LinkLayerInterest::kLeAdvertising);
+  }
+  if (link_layer_controller_.GetInquiryScanEnable()) {
+    interests |= LinkLayerInterestBit(LinkLayerInterest::kInquiry);
+  }
+  SetLinkLayerInterests(interests);
+}
 
 void DualModeController::Close() {
   link_layer_controller_.Close();
@@ -251,6 +268,8 @@ void DualModeController::HandleCommand(
     INFO(id_, "Unknown command, opcode: 0x{:04x}, OGF: 0x{:02x}, OCF: 0x{:03x}",
          raw_op_code, (raw_op_code & 0xFC00) >> 10, raw_op_code & 0x03FF);
   }
+
+  UpdateLinkLayerInterests();
 }
 
 void DualModeController::RegisterInvalidPacketHandler(
@@ -553,6 +553,10 @@ class DualModeController : public Device {
   void SendCommandCompleteUnknownOpCodeEvent(
       bluetooth::hci::OpCode op_code) const;
 
+  // Publish the kinds of link layer packets the controller is listening for
+  // in its current state.
+  void UpdateLinkLayerInterests();
+
   // Validate that a received packet is correctly formatted.
   // If the packet failed to be parsed, the function sends a
   // HCI Hardware Error event to the host and logs the packet to
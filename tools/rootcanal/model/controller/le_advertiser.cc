@@ -29,6 +29,7 @@
 #include "model/controller/link_layer_controller.h"
 #include "packets/hci_packets.h"
 #include "packets/link_layer_packets.h"
+#include "simulation_clock.h"
 
 using namespace bluetooth::hci;
 using namespace std::literals;
@@ -257,7 +258,7 @@ ErrorCode LinkLayerController::LeSetAdvertisingEnable(bool advertising_enable) {
       // The Link Layer shall exit the Advertising state no later than 1.28 s
       // after the Advertising state was entered.
       legacy_advertiser_.timeout =
-          std::chrono::steady_clock::now() + adv_direct_ind_high_timeout;
+          SimulationClock::now() + adv_direct_ind_high_timeout;
       [[fallthrough]];
 
     case AdvertisingType::ADV_DIRECT_IND_LOW: {
@@ -281,7 +282,7 @@ ErrorCode LinkLayerController::LeSetAdvertisingEnable(bool advertising_enable) {
   }
 
   legacy_advertiser_.advertising_enable = true;
-  legacy_advertiser_.next_event = std::chrono::steady_clock::now() +
+  legacy_advertiser_.next_event = SimulationClock::now() +
                                   legacy_advertiser_.advertising_interval;
   return ErrorCode::SUCCESS;
 }
@@ -1176,7 +1177,7 @@ ErrorCode LinkLayerController::LeSetExtendedAdvertisingEnable(
     if (set.duration_ > 0) {
       std::chrono::milliseconds duration =
           std::chrono::milliseconds(set.duration_ * 10);
-      advertiser.timeout = std::chrono::steady_clock::now() + duration;
+      advertiser.timeout = SimulationClock::now() + duration;
     } else {
       advertiser.timeout.reset();
     }
@@ -1631,7 +1632,7 @@ uint16_t ExtendedAdvertiser::GetMaxPeriodicAdvertisingDataLength(
 // =============================================================================
 
 void LinkLayerController::LeAdvertising() {
-  chrono::time_point now = std::chrono::steady_clock::now();
+  chrono::time_point now = SimulationClock::now();
 
   // Legacy Advertising Timeout
 
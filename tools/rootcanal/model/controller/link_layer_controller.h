@@ -285,6 +285,11 @@ class LinkLayerController {
   void Inquiry();
 
   bool GetInquiryScanEnable() const { return inquiry_scan_enable_; }
+
+  // Advertising PDUs are only processed while scanning or initiating.
+  bool IsLeScanningOrInitiating() const {
+    return scanner_.IsEnabled() || initiator_.IsEnabled();
+  }
   void SetInquiryScanEnable(bool enable);
 
   bool GetPageScanEnable() const { return page_scan_enable_; }
@@ -70,4 +70,19 @@ void Device::RegisterLinkLayerChannel(
   send_ll_ = send_ll;
 }
 
+void Device::RegisterLinkLayerInterestsCallback(
+    std::function<void()> interests_callback) {
+  interests_callback_ = interests_callback;
+}
+
+void Device::SetLinkLayerInterests(uint8_t interests) {
+  if (interests == link_layer_interests_) {
+    return;
+  }
+  link_layer_interests_ = interests;
+  if (interests_callback_ != nullptr) {
+    interests_callback_();
+  }
+}
+
 }  // namespace rootcanal
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -30,6 +31,22 @@ namespace rootcanal {
 
 using ::bluetooth::hci::Address;
 
+// Kinds of link layer packets that a device can stop listening for.
+// The packets of all other types are delivered to every device of the phy.
+enum class LinkLayerInterest : uint8_t {
+  // Legacy, extended and periodic advertising PDUs.
+  kLeAdvertising = 0,
+  // Inquiry packets.
+  kInquiry = 1,
+};
+
+constexpr size_t kNumLinkLayerInterests = 2;
+constexpr uint8_t kAllLinkLayerInterests = (1 << kNumLinkLayerInterests) - 1;
+
+constexpr uint8_t LinkLayerInterestBit(LinkLayerInterest interest) {
+  return 1 << static_cast<uint8_t>(interest);
+}
+
 // Represent a Bluetooth Device
 //  - Provide Get*() and Set*() functions for device attributes.
 class Device {
@@ -72,7 +89,18 @@ class Device {
 
   void RegisterCloseCallback(std::function<void()> close_callback);
 
+  // Return the mask of the LinkLayerInterest bits the device listens for.
+  uint8_t GetLinkLayerInterests() const { return link_layer_interests_; }
+
+  // Set the callback invoked when the interests of the device change.
+  void RegisterLinkLayerInterestsCallback(
+      std::function<void()> interests_callback);
+
  protected:
+  // Update the kinds of packets the device listens for. A device must keep
+  // listening for the packets it would not drop unconditionally.
+  void SetLinkLayerInterests(uint8_t interests);
+
   // Unique device address. Used as public device address for
   // Bluetooth activities.
   Address address_;
@@ -82,6 +110,10 @@ class Device {
 
   // Callback function to send link layer packets.
   std::function<void(std::vector<uint8_t> const&, Phy::Type, uint8_t)> send_ll_;
+
+ private:
+  uint8_t link_layer_interests_{kAllLinkLayerInterests};
+  std::function<void()> interests_callback_;
 };
 
 }  // namespace rootcanal
@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "log.h"
+#include "simulation_clock.h"
 
 #ifndef TEMP_FAILURE_RETRY
 /* Used to retry syscalls that can return EINTR. */
@@ -104,6 +105,9 @@ static const int kNotificationBufferSize = 10;
 // Async File Descriptor Watcher Implementation:
 class AsyncManager::AsyncFdWatcher {
  public:
+  explicit AsyncFdWatcher(std::function<void()> on_activity)
+      : on_activity_(std::move(on_activity)) {}
+
   int WatchFdForNonBlockingReads(
       int file_descriptor, const ReadCallback& on_read_fd_ready_callback) {
     // add file descriptor and callback
@@ -130,7 +134,6 @@ class AsyncManager::AsyncFdWatcher {
     watched_shared_fds_.erase(file_descriptor);
   }
 
-  AsyncFdWatcher() = default;
   AsyncFdWatcher(const AsyncFdWatcher&) = delete;
   AsyncFdWatcher& operator=(const AsyncFdWatcher&) = delete;
 
@@ -242,6 +245,9 @@ class AsyncManager::AsyncFdWatcher {
         fds.push_back(fdc);
       }
     }
+    if (!fds.empty()) {
+      on_activity_();
+    }
     for (auto& p : fds) {
       p.second(p.first);
     }
@@ -280,6 +286,9 @@ class AsyncManager::AsyncFdWatcher {
 
   std::map<int, ReadCallback> watched_shared_fds_;
 
+  // Invoked before running the callbacks of readable file descriptors.
+  std::function<void()> on_activity_;
+
   // A pair of FD to send information to the reading thread
   int notification_listen_fd_{};
   int notification_write_fd_{};
@@ -293,7 +302,7 @@ class AsyncManager::AsyncTaskManager {
   AsyncTaskId ExecAsync(AsyncUserId user_id, std::chrono::milliseconds delay,
                         const TaskCallback& callback) {
     return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, callback, user_id));
+        SimulationClock::now() + delay, callback, user_id));
   }
 
   AsyncTaskId ExecAsyncPeriodically(AsyncUserId user_id,
@@ -301,7 +310,7 @@ class AsyncManager::AsyncTaskManager {
                                     std::chrono::milliseconds period,
                                     const TaskCallback& callback) {
     return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, period, callback, user_id));
+        SimulationClock::now() + delay, period, callback, user_id));
   }
 
   bool CancelAsyncTask(AsyncTaskId async_task_id) {
@@ -328,6 +337,17 @@ class AsyncManager::AsyncTaskManager {
     critical();
   }
 
+  void SetFastForward(std::chrono::milliseconds idle_timeout) {
+    std::unique_lock<std::mutex> guard(internal_mutex_);
+    idle_timeout_ = idle_timeout;
+    internal_cond_var_.notify_one();
+  }
+
+  void NotifyActivity() {
+    last_activity_ =
+        std::chrono::steady_clock::now().time_since_epoch().count();
+  }
+
   AsyncTaskManager() = default;
   AsyncTaskManager(const AsyncTaskManager&) = delete;
   AsyncTaskManager& operator=(const AsyncTaskManager&) = delete;
@@ -454,6 +474,28 @@ class AsyncManager::AsyncTaskManager {
     return task->task_id;
   }
 
+  // Return the real time at which to wake up for the task scheduled at the
+  // simulation time |time|. In fast-forward mode, once the file descriptors
+  // have been idle for long enough, the simulation clock skips the wait and
+  // the task is due immediately.
+  std::chrono::steady_clock::time_point nextWakeupWithLockHeld(
+      SimulationClock::time_point time) const {
+    auto real_now = std::chrono::steady_clock::now();
+    auto wakeup = time - SimulationClock::GetOffset();
+    if (idle_timeout_ == std::chrono::milliseconds::zero()) {
+      return wakeup;
+    }
+    std::chrono::steady_clock::time_point idle_end =
+        std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(last_activity_.load())) +
+        idle_timeout_;
+    if (real_now < idle_end) {
+      return std::min(wakeup, idle_end);
+    }
+    SimulationClock::Advance(wakeup - real_now);
+    return real_now;
+  }
+
   bool isTaskIdInUse(const AsyncTaskId& task_id) const {
     return tasks_by_id_.count(task_id) != 0;
   }
@@ -484,7 +526,7 @@ class AsyncManager::AsyncTaskManager {
         std::unique_lock<std::mutex> guard(internal_mutex_);
         if (!task_queue_.empty()) {
           task_p = *(task_queue_.begin());
-          if (task_p->time < std::chrono::steady_clock::now()) {
+          if (task_p->time <= SimulationClock::now()) {
             run_it = true;
             callback = task_p->callback;
             task_queue_.erase(task_p);  // need to remove and add again if
@@ -515,8 +557,10 @@ class AsyncManager::AsyncTaskManager {
           // to it and may read it after waiting, by which time the task may
           // have been freed (e.g. via CancelAsyncTask).
           std::chrono::steady_clock::time_point time =
-              (*task_queue_.begin())->time;
-          internal_cond_var_.wait_until(guard, time);
+              nextWakeupWithLockHeld((*task_queue_.begin())->time);
+          if (time > std::chrono::steady_clock::now()) {
+            internal_cond_var_.wait_until(guard, time);
+          }
         } else {
           internal_cond_var_.wait(guard);
         }
@@ -535,11 +579,17 @@ class AsyncManager::AsyncTaskManager {
   std::map<AsyncTaskId, std::shared_ptr<Task>> tasks_by_id_;
   std::map<AsyncUserId, std::set<AsyncTaskId>> tasks_by_user_id_;
   std::set<std::shared_ptr<Task>, task_p_comparator> task_queue_;
+
+  // Fast-forward state, the wait for the next task is skipped when the file
+  // descriptors have been idle for idle_timeout_ since last_activity_.
+  std::chrono::milliseconds idle_timeout_{};
+  std::atomic<std::chrono::steady_clock::rep> last_activity_{0};
 };
 
 // Async Manager Implementation:
 AsyncManager::AsyncManager()
-    : fdWatcher_p_(new AsyncFdWatcher()),
+    : fdWatcher_p_(new AsyncFdWatcher(
+          [this]() { taskManager_p_->NotifyActivity(); })),
       taskManager_p_(new AsyncTaskManager()) {}
 
 AsyncManager::~AsyncManager() {
@@ -591,4 +641,8 @@ bool AsyncManager::CancelAsyncTasksFromUser(rootcanal::AsyncUserId user_id) {
 void AsyncManager::Synchronize(const CriticalCallback& critical) {
   taskManager_p_->Synchronize(critical);
 }
+
+void AsyncManager::SetFastForward(std::chrono::milliseconds idle_timeout) {
+  taskManager_p_->SetFastForward(idle_timeout);
+}
 }  // namespace rootcanal
@@ -116,6 +116,13 @@ class AsyncManager {
   // have very simple CriticalCallbacks, preferably using lambda expressions.
   void Synchronize(const CriticalCallback& critical_callback);
 
+  // Fast-forward the simulation clock to the next scheduled task once no
+  // watched file descriptor has been readable for |idle_timeout|, instead of
+  // waiting for the task in real time. The delays of the tasks are measured
+  // with the simulation clock. A zero timeout, the default, disables
+  // fast-forward.
+  void SetFastForward(std::chrono::milliseconds idle_timeout);
+
   AsyncManager();
   AsyncManager(const AsyncManager&) = delete;
   AsyncManager& operator=(const AsyncManager&) = delete;
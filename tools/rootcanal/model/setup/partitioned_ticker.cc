@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/partitioned_ticker.h"
+
+#include <algorithm>
+
+namespace rootcanal {
+
+PartitionedTicker::PartitionedTicker(size_t num_threads) {
+  for (size_t partition = 1; partition < std::max<size_t>(num_threads, 1);
+       partition++) {
+    workers_.emplace_back(&PartitionedTicker::WorkerLoop, this, partition);
+  }
+}
+
+PartitionedTicker::~PartitionedTicker() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void PartitionedTicker::Run(size_t count,
+                            std::function<void(size_t)> const& tick) {
+  if (workers_.empty()) {
+    for (size_t index = 0; index < count; index++) {
+      tick(index);
+    }
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    count_ = count;
+    tick_ = &tick;
+    pending_workers_ = workers_.size();
+    generation_++;
+  }
+  start_cv_.notify_all();
+
+  RunPartition(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return pending_workers_ == 0; });
+  tick_ = nullptr;
+}
+
+void PartitionedTicker::RunPartition(size_t partition) {
+  size_t num_partitions = workers_.size() + 1;
+  size_t begin = count_ * partition / num_partitions;
+  size_t end = count_ * (partition + 1) / num_partitions;
+  for (size_t index = begin; index < end; index++) {
+    (*tick_)(index);
+  }
+}
+
+void PartitionedTicker::WorkerLoop(size_t partition) {
+  uint64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock,
+                     [&] { return stopping_ || generation_ != generation; });
+      if (stopping_) {
+        return;
+      }
+      generation = generation_;
+    }
+
+    RunPartition(partition);
+
+    bool done;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done = --pending_workers_ == 0;
+    }
+    if (done) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rootcanal {
+
+// Runs a function over the indices [0, count) on a fixed pool of threads.
+// The indices are split in contiguous partitions, one per thread, and the
+// calling thread handles the first partition itself. Run() returns once every
+// index has been handled, so that the caller can then merge the results
+// in index order, independently of the number of threads.
+class PartitionedTicker {
+ public:
+  // Create a ticker running on |num_threads| threads, including the caller.
+  explicit PartitionedTicker(size_t num_threads);
+  ~PartitionedTicker();
+
+  PartitionedTicker(PartitionedTicker const&) = delete;
+  PartitionedTicker& operator=(PartitionedTicker const&) = delete;
+
+  size_t GetNumThreads() const { return workers_.size() + 1; }
+
+  // Call |tick| once for each index in [0, count) and wait for completion.
+  void Run(size_t count, std::function<void(size_t)> const& tick);
+
+ private:
+  void WorkerLoop(size_t partition);
+  void RunPartition(size_t partition);
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  uint64_t generation_{0};
+  size_t pending_workers_{0};
+  bool stopping_{false};
+
+  // Current run, only valid while pending_workers_ is non zero.
+  size_t count_{0};
+  std::function<void(size_t)> const* tick_{nullptr};
+};
+
+}  // namespace rootcanal
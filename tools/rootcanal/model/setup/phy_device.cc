@@ -28,6 +28,11 @@ PhyDevice::PhyDevice(std::string type, std::shared_ptr<Device> device)
   ASSERT(device_ != nullptr);
   device_->RegisterLinkLayerChannel(
       std::bind(&PhyDevice::Send, this, _1, _2, _3));
+  device_->RegisterLinkLayerInterestsCallback([this]() {
+    for (auto const& phy : phy_layers_) {
+      phy->InvalidateListeners();
+    }
+  });
 }
 
 void PhyDevice::Register(PhyLayer* phy) { phy_layers_.insert(phy); }
@@ -56,14 +61,23 @@ void PhyDevice::Receive(std::vector<uint8_t> const& packet, Phy::Type type,
       model::packets::LinkLayerPacketView::Create(
           pdl::packet::slice(packet_copy));
   if (packet_view.IsValid()) {
-    device_->ReceiveLinkLayerPacket(std::move(packet_view), type, rssi);
+    Receive(packet_view, type, rssi);
   } else {
     WARNING("received invalid LL packet");
   }
 }
 
+void PhyDevice::Receive(model::packets::LinkLayerPacketView const& packet,
+                        Phy::Type type, int8_t rssi) {
+  device_->ReceiveLinkLayerPacket(packet, type, rssi);
+}
+
 void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
                      int8_t tx_power) {
+  if (defer_send_) {
+    deferred_packets_.push_back(DeferredPacket{packet, type, tx_power});
+    return;
+  }
   for (auto const& phy : phy_layers_) {
     if (phy->type == type) {
       phy->Send(packet, tx_power, id);
@@ -71,6 +85,19 @@ void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
   }
 }
 
+void PhyDevice::FlushDeferredPackets() {
+  std::vector<DeferredPacket> packets;
+  packets.swap(deferred_packets_);
+  for (auto const& deferred : packets) {
+    Send(deferred.packet, deferred.type, deferred.tx_power);
+  }
+  // Keep the capacity for the next tick.
+  packets.clear();
+  if (deferred_packets_.empty()) {
+    deferred_packets_.swap(packets);
+  }
+}
+
 std::string PhyDevice::ToString() { return device_->ToString(); }
 
 }  // namespace rootcanal
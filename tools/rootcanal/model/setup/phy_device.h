@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 #include "model/devices/device.h"
 #include "phy.h"
@@ -40,9 +41,25 @@ class PhyDevice {
 
   void Tick();
   void Receive(std::vector<uint8_t> const& packet, Phy::Type type, int8_t rssi);
+  void Receive(model::packets::LinkLayerPacketView const& packet,
+               Phy::Type type, int8_t rssi);
   void Send(std::vector<uint8_t> const& packet, Phy::Type type,
             int8_t tx_power);
 
+  // While deferred, the packets sent by the device are queued instead of
+  // delivered, so that devices can be ticked concurrently without reaching
+  // into each other. FlushDeferredPackets delivers the queued packets in the
+  // order they were sent.
+  void SetDeferSend(bool defer_send) { defer_send_ = defer_send; }
+  void FlushDeferredPackets();
+
+  // Return true if the device listens for the packets of the kind
+  // |interest|.
+  bool IsListening(LinkLayerInterest interest) const {
+    return (device_->GetLinkLayerInterests() &
+            LinkLayerInterestBit(interest)) != 0;
+  }
+
   bluetooth::hci::Address GetAddress() const;
   std::shared_ptr<Device> GetDevice() const;
   void SetAddress(bluetooth::hci::Address address);
@@ -55,6 +72,15 @@ class PhyDevice {
  private:
   const std::shared_ptr<Device> device_;
   std::unordered_set<PhyLayer*> phy_layers_;
+
+  struct DeferredPacket {
+    std::vector<uint8_t> packet;
+    Phy::Type type;
+    int8_t tx_power;
+  };
+
+  bool defer_send_{false};
+  std::vector<DeferredPacket> deferred_packets_;
 };
 
 }  // namespace rootcanal
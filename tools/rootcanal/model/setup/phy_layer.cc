@@ -16,8 +16,12 @@
 
 #include "phy_layer.h"
 
+#include <optional>
 #include <sstream>
 
+#include "log.h"
+#include "packets/link_layer_packets.h"
+
 namespace rootcanal {
 
 PhyLayer::PhyLayer(Identifier id, Phy::Type type) : id(id), type(type) {}
@@ -25,6 +29,7 @@ PhyLayer::PhyLayer(Identifier id, Phy::Type type) : id(id), type(type) {}
 void PhyLayer::Register(std::shared_ptr<PhyDevice> device) {
   device->Register(this);
   phy_devices_.push_back(device);
+  listeners_.reset();
 }
 
 void PhyLayer::Unregister(PhyDevice::Identifier id) {
@@ -32,6 +37,7 @@ void PhyLayer::Unregister(PhyDevice::Identifier id) {
     if (device->id == id) {
       device->Unregister(this);
       phy_devices_.remove(device);
+      listeners_.reset();
       return;
     }
   }
@@ -42,6 +48,7 @@ void PhyLayer::UnregisterAll() {
     device->Unregister(this);
   }
   phy_devices_.clear();
+  listeners_.reset();
 }
 
 int8_t PhyLayer::ComputeRssi(PhyDevice::Identifier /*sender_id*/,
@@ -55,12 +62,65 @@ int8_t PhyLayer::ComputeRssi(PhyDevice::Identifier /*sender_id*/,
   return static_cast<int8_t>(-rssi);
 }
 
+// Return the kind of the packets of type |type| when devices can
+// stop listening for them.
+static std::optional<LinkLayerInterest> GetLinkLayerInterest(
+    model::packets::PacketType type) {
+  switch (type) {
+    case model::packets::PacketType::LE_LEGACY_ADVERTISING_PDU:
+    case model::packets::PacketType::LE_EXTENDED_ADVERTISING_PDU:
+    case model::packets::PacketType::LE_PERIODIC_ADVERTISING_PDU:
+      return LinkLayerInterest::kLeAdvertising;
+    case model::packets::PacketType::INQUIRY:
+      return LinkLayerInterest::kInquiry;
+    default:
+      return {};
+  }
+}
+
+std::shared_ptr<PhyLayer::Listeners const> PhyLayer::GetListeners() {
+  if (listeners_invalid_.exchange(false) || listeners_ == nullptr) {
+    auto listeners = std::make_shared<Listeners>();
+    for (auto const& device : phy_devices_) {
+      for (size_t index = 0; index < kNumLinkLayerInterests; index++) {
+        if (device->IsListening(static_cast<LinkLayerInterest>(index))) {
+          (*listeners)[index].push_back(device);
+        }
+      }
+    }
+    listeners_ = std::move(listeners);
+  }
+  return listeners_;
+}
+
 void PhyLayer::Send(std::vector<uint8_t> const& packet, int8_t tx_power,
                     PhyDevice::Identifier sender_id) {
-  for (const auto& device : phy_devices_) {
-    // Do not send the packet back to the sender.
+  // Parse the packet once, the receivers share the same immutable buffer.
+  model::packets::LinkLayerPacketView packet_view =
+      model::packets::LinkLayerPacketView::Create(pdl::packet::slice(
+          std::make_shared<std::vector<uint8_t>>(packet)));
+  if (!packet_view.IsValid()) {
+    WARNING("dropping invalid LL packet sent by device {}", sender_id);
+    return;
+  }
+
+  auto interest = GetLinkLayerInterest(packet_view.GetType());
+  if (!interest.has_value()) {
+    for (const auto& device : phy_devices_) {
+      // Do not send the packet back to the sender.
+      if (sender_id != device->id) {
+        device->Receive(packet_view, type,
+                        ComputeRssi(sender_id, device->id, tx_power));
+      }
+    }
+    return;
+  }
+
+  // Only deliver to the devices listening for this kind of packets.
+  std::shared_ptr<Listeners const> listeners = GetListeners();
+  for (const auto& device : (*listeners)[static_cast<size_t>(*interest)]) {
     if (sender_id != device->id) {
-      device->Receive(packet, type,
+      device->Receive(packet_view, type,
                       ComputeRssi(sender_id, device->id, tx_power));
     }
   }
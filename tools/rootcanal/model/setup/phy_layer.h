@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <list>
 #include <memory>
 #include <vector>
@@ -48,6 +50,11 @@ class PhyLayer {
   void Unregister(PhyDevice::Identifier device_id);
   void UnregisterAll();
 
+  // Rebuild the index of the devices listening for each kind of
+  // packets before the next delivery. Called when the interests
+  // of a device change, possibly from concurrent ticks.
+  void InvalidateListeners() { listeners_invalid_ = true; }
+
   std::string ToString() const;
 
   // Id and type are public but immutable.
@@ -57,6 +64,18 @@ class PhyLayer {
  protected:
   // List of devices currently connected to the phy.
   std::list<std::shared_ptr<rootcanal::PhyDevice>> phy_devices_;
+
+ private:
+  using Listeners = std::array<std::vector<std::shared_ptr<PhyDevice>>,
+                               kNumLinkLayerInterests>;
+
+  std::shared_ptr<Listeners const> GetListeners();
+
+  // Devices listening for each kind of packets, in registration order.
+  // Deliveries hold a reference to the index, which is replaced rather than
+  // modified when the devices or their interests change.
+  std::shared_ptr<Listeners const> listeners_;
+  std::atomic<bool> listeners_invalid_{false};
 };
 
 }  // namespace rootcanal
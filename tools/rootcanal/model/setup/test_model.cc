@@ -273,10 +273,40 @@ const std::string& TestModel::List() {
   return list_string_;
 }
 
+void TestModel::SetTickThreads(size_t num_threads) {
+  if (num_threads > 1) {
+    ticker_ = std::make_unique<PartitionedTicker>(num_threads);
+  } else {
+    ticker_.reset();
+  }
+}
+
 void TestModel::Tick() {
+  if (ticker_ == nullptr) {
+    for (auto& [_, device] : phy_devices_) {
+      device->Tick();
+    }
+    return;
+  }
+
+  // Hold the devices for the duration of the tick, a packet delivery can
+  // close a connection and remove its device from the model.
+  tick_devices_.clear();
   for (auto& [_, device] : phy_devices_) {
-    device->Tick();
+    device->SetDeferSend(true);
+    tick_devices_.push_back(device);
+  }
+
+  ticker_->Run(tick_devices_.size(),
+               [this](size_t index) { tick_devices_[index]->Tick(); });
+
+  for (auto& device : tick_devices_) {
+    device->SetDeferSend(false);
+  }
+  for (auto& device : tick_devices_) {
+    device->FlushDeferredPackets();
   }
+  tick_devices_.clear();
 }
 
 void TestModel::Reset() {
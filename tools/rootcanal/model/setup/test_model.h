@@ -28,6 +28,7 @@
 #include "hci/address.h"                       // for Address
 #include "model/devices/hci_device.h"          // for HciDevice
 #include "model/setup/async_manager.h"         // for AsyncUserId, AsyncTaskId
+#include "model/setup/partitioned_ticker.h"
 #include "phy.h"                               // for Phy, Phy::Type
 #include "phy_layer.h"
 #include "rootcanal/configuration.pb.h"
@@ -62,6 +63,13 @@ class TestModel {
     reuse_device_addresses_ = reuse_device_addresses;
   }
 
+  // Tick the devices on |num_threads| threads. With more than one thread,
+  // the packets sent during a tick are delivered after all devices have
+  // ticked, in the order of the device identifiers, so that the simulation
+  // does not depend on the number of threads. With zero or one thread
+  // the devices are ticked in sequence and their packets delivered as sent.
+  void SetTickThreads(size_t num_threads);
+
   // Allow derived classes to use custom phy layer.
   virtual std::unique_ptr<PhyLayer> CreatePhyLayer(PhyLayer::Identifier id,
                                                    Phy::Type type);
@@ -120,6 +128,10 @@ class TestModel {
   std::map<PhyDevice::Identifier, std::shared_ptr<PhyDevice>> phy_devices_;
   std::string list_string_;
 
+  // Ticker of the partitioned execution mode, null when ticking in sequence.
+  std::unique_ptr<PartitionedTicker> ticker_;
+  std::vector<std::shared_ptr<PhyDevice>> tick_devices_;
+
   // Generator for device identifiers.
   bool reuse_device_addresses_{true};
 
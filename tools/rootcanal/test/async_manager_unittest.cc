@@ -29,12 +29,15 @@
 #include <condition_variable>  // for condition_variable
 #include <cstdint>             // for uint16_t
 #include <cstring>             // for memset, strcmp, strcpy, strlen
+#include <memory>
 #include <mutex>               // for mutex
 #include <ratio>               // for ratio
 #include <string>              // for string
 #include <thread>
 #include <tuple>  // for tuple
 
+#include "simulation_clock.h"
+
 namespace rootcanal {
 
 class Event {
@@ -490,4 +493,23 @@ TEST_F(AsyncManagerTest, TestCancelAsyncTasksFromUser) {
   ASSERT_FALSE(async_manager_.CancelAsyncTask(task5_id));
 }
 
+TEST_F(AsyncManagerTest, TestFastForward) {
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  auto runs = std::make_shared<std::atomic<int>>(0);
+  auto start = std::chrono::steady_clock::now();
+  auto simulation_start = SimulationClock::now();
+  async_manager_.SetFastForward(std::chrono::milliseconds(1));
+  async_manager_.ExecAsyncPeriodically(user1, std::chrono::seconds(10),
+                                       std::chrono::seconds(10),
+                                       [runs]() { (*runs)++; });
+  while (*runs < 3)
+    ;
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto simulation_elapsed = SimulationClock::now() - simulation_start;
+  async_manager_.CancelAsyncTasksFromUser(user1);
+  // The tasks ran at their simulation time, without waiting for it.
+  ASSERT_GE(simulation_elapsed, std::chrono::seconds(30));
+  ASSERT_LT(elapsed, std::chrono::seconds(5));
+}
+
 }  // namespace rootcanal
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/partitioned_ticker.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace rootcanal {
+
+TEST(PartitionedTickerTest, TicksEachIndexOnce) {
+  for (size_t num_threads : {0, 1, 2, 3, 8}) {
+    PartitionedTicker ticker(num_threads);
+    for (size_t count : {0, 1, 5, 64}) {
+      std::vector<std::atomic<int>> ticks(count);
+      ticker.Run(count, [&](size_t index) { ticks[index]++; });
+      for (size_t index = 0; index < count; index++) {
+        EXPECT_EQ(ticks[index], 1)
+            << num_threads << " threads, index " << index;
+      }
+    }
+  }
+}
+
+TEST(PartitionedTickerTest, PartitionsAreContiguous) {
+  PartitionedTicker ticker(4);
+  EXPECT_EQ(ticker.GetNumThreads(), 4u);
+  std::vector<std::thread::id> thread_ids(16);
+  ticker.Run(thread_ids.size(), [&](size_t index) {
+    thread_ids[index] = std::this_thread::get_id();
+  });
+  // The caller ticks the first partition, each partition runs on one thread.
+  EXPECT_EQ(thread_ids[0], std::this_thread::get_id());
+  std::set<std::thread::id> distinct(thread_ids.begin(), thread_ids.end());
+  EXPECT_EQ(distinct.size(), 4u);
+  for (size_t index = 0; index < thread_ids.size(); index++) {
+    EXPECT_EQ(thread_ids[index], thread_ids[index - index % 4]);
+  }
+}
+
+TEST(PartitionedTickerTest, RunsRepeatedly) {
+  PartitionedTicker ticker(3);
+  std::atomic<size_t> total{0};
+  for (int run = 0; run < 1000; run++) {
+    ticker.Run(10, [&](size_t index) { total += index; });
+  }
+  EXPECT_EQ(total, 1000u * 45);
+}
+
+}  // namespace rootcanal